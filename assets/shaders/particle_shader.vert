@@ -13,12 +13,13 @@ layout(location = 8) in vec3 instance_velocity;
 layout(location = 9) in uint instance_is_atlas;    // 1 = Atlas-based, 0 = Full texture
 layout(location = 10) in uint instance_apply_camera_effects;
 
-layout(binding = 0) uniform UniformBufferObject
+// Mirrors UniformData, pushed with every pipeline bind
+layout(push_constant) uniform CameraConstants
 {
     mat4 wvp;
     mat4 wvp_no_camera_effects;
 }
-ubo;
+camera;
 
 layout(location = 0) out vec4 out_colour;
 layout(location = 1) out vec2 out_uv;
@@ -29,7 +30,7 @@ layout(location = 4) out flat uint out_is_atlas;
 void main()
 {
     vec3 world_position = position * vec3(instance_size, 1.0) + instance_position;
-    mat4 wvp_matrix = (instance_apply_camera_effects == 1) ? ubo.wvp : ubo.wvp_no_camera_effects;
+    mat4 wvp_matrix = (instance_apply_camera_effects == 1) ? camera.wvp : camera.wvp_no_camera_effects;
 
     gl_Position = wvp_matrix * vec4(world_position, 1.0);
 
@@ -1,4 +1,5 @@
 #version 460
+#extension GL_EXT_nonuniform_qualifier : require
 
 layout(location = 0) in vec2 uv;
 layout(location = 1) in vec4 colour;
@@ -6,118 +7,164 @@ layout(location = 1) in vec4 colour;
 layout(location = 2) in flat uint texture_index;
 layout(location = 3) in vec4 sprite_rect;
 layout(location = 4) in flat uint is_atlas;
+layout(location = 5) in vec2 world_position;
+layout(location = 6) in flat uint is_lit;
+layout(location = 7) in flat uint texture_layer;
+layout(location = 8) in flat float distance_range;
+layout(location = 9) in flat uint shape;
+layout(location = 10) in flat vec4 shape_params;
+layout(location = 11) in flat vec3 shape_extent;
 
 layout(location = 0) out vec4 out_colour;
 
-#define MAX_TEXTURES 32
-layout(binding = 3) uniform sampler2D texture_samplers[MAX_TEXTURES];
+// Bindless, sized by the engine and only partially bound
+layout(binding = 3) uniform sampler2D texture_samplers[];
+layout(binding = 9) uniform sampler2DArray texture_arrays[];
+
+// Mirrors PointLight
+struct PointLight {
+    vec2 position;
+    float radius;
+    float intensity;
+    vec4 colour;
+};
+
+// Mirrors the start of LightParams, the viewports that follow are only read by the cull pass
+layout(binding = 4) uniform LightParams {
+    vec2 framebuffer_size;
+    uint tile_size;
+    uint light_count;
+    uvec2 tile_count;
+    uint viewport_count;
+    vec4 ambient;
+} lighting;
+
+layout(std430, binding = 5) readonly buffer LightBuffer {
+    PointLight lights[];
+};
+
+// Filled by light_cull.comp, a light count and the light indices of each screen tile
+layout(std430, binding = 6) readonly buffer TileLightBuffer {
+    uint tile_lights[];
+};
+
+const uint TILE_STRIDE = 64;
+
+// Set by the alpha test pipeline only, the opaque pipeline never discards so early depth testing always applies
+layout(constant_id = 0) const int alpha_test = 0;
+
+// The vertex shader's forced flags, the atlas and camera flags they fix need no per fragment test either
+layout(constant_id = 1) const int forced_flag_mask = 0;
+layout(constant_id = 2) const int forced_flags = 0;
+
+const uint TEXTURE_ARRAY_FLAG = 0x1000u;
+const uint ATLAS_FLAG = 0x4000u;
+const uint CAMERA_FLAG = 0x8000u;
+
+float median(float r, float g, float b) { return max(min(r, g), min(max(r, g), b)); }
+
+// Mirrors QuadShape
+const uint SHAPE_CIRCLE = 2u;
+const uint SHAPE_LINE = 3u;
+const uint SHAPE_GRID = 4u;
+
+// Grid cells narrower than this many pixels are faded out, before their lines blur into a solid fill
+const float GRID_FADE_START = 8.0;
+const float GRID_FADE_END = 3.0;
+
+// Coverage of the lines along multiples of cell_size at the fragment, line_width pixels wide. The lines are found
+// from the world position alone, so any number of them cost one quad.
+float grid_lines(float cell_size, float line_width)
+{
+    vec2 cell = world_position / cell_size;
+    vec2 cell_per_pixel = max(fwidth(cell), vec2(1e-6));
+    vec2 pixels_to_line = abs(fract(cell + 0.5) - 0.5) / cell_per_pixel;
+    float coverage = clamp(line_width * 0.5 + 0.5 - min(pixels_to_line.x, pixels_to_line.y), 0.0, 1.0);
+    float cell_pixels = 1.0 / max(cell_per_pixel.x, cell_per_pixel.y);
+    return coverage * smoothstep(GRID_FADE_END, GRID_FADE_START, cell_pixels);
+}
+
+// Signed distance in the units of the quad's size, negative inside
+float shape_distance(vec2 p)
+{
+    float stroke_width = shape_extent.z;
+    if (shape == SHAPE_LINE) {
+        vec2 segment = shape_params.zw - shape_params.xy;
+        float t = clamp(dot(p - shape_params.xy, segment) / max(dot(segment, segment), 1e-6), 0.0, 1.0);
+        return length(p - shape_params.xy - segment * t) - stroke_width * 0.5;
+    }
+
+    // A rounded box, a circle is one whose radius is its smaller half extent
+    vec2 half_size = shape_extent.xy * 0.5;
+    float max_radius = min(half_size.x, half_size.y);
+    float radius = shape == SHAPE_CIRCLE ? max_radius : clamp(shape_params.x, 0.0, max_radius);
+    vec2 q = abs(p - half_size) - half_size + radius;
+    float d = length(max(q, 0.0)) + min(max(q.x, q.y), 0.0) - radius;
+    // Outlines are cut from the inside of the edge, so they cover the same bounds as the filled shape
+    return stroke_width > 0.0 ? abs(d + stroke_width * 0.5) - stroke_width * 0.5 : d;
+}
 
 void main()
 {
-    vec2 sampled_coord = uv;
-    if (is_atlas == 1) {
-        // Map uv from [0,1] to sprite rect [sprite_rect.xy, sprite_rect.zw]
-        sampled_coord = sprite_rect.xy + uv * (sprite_rect.zw - sprite_rect.xy);
+    bool atlas = (uint(forced_flag_mask) & ATLAS_FLAG) != 0u ? (uint(forced_flags) & ATLAS_FLAG) != 0u : is_atlas == 1;
+    bool lit = (uint(forced_flag_mask) & CAMERA_FLAG) != 0u ? (uint(forced_flags) & CAMERA_FLAG) != 0u : is_lit != 0u;
+
+    if (shape == SHAPE_GRID) {
+        // Major lines at full alpha, the others dimmer, either way a line fades with its own cells
+        float line_width = shape_extent.z;
+        float minor = grid_lines(shape_params.x, line_width) * 0.5;
+        float major = shape_params.y >= 1.0 ? grid_lines(shape_params.x * shape_params.y, line_width) : 0.0;
+        out_colour = vec4(colour.rgb, colour.a * max(minor, major));
+    }
+    else if (shape != 0u) {
+        // Analytic, no texture is sampled. Flat per quad, so the derivatives are taken in uniform control flow.
+        float d = shape_distance(uv * shape_extent.xy);
+        float coverage = clamp(0.5 - d / max(fwidth(d), 1e-6), 0.0, 1.0);
+        out_colour = vec4(colour.rgb, colour.a * coverage);
+    }
+    // Texture array layers are drawn whole
+    else if ((texture_index & TEXTURE_ARRAY_FLAG) != 0u) {
+        uint array_index = texture_index & (TEXTURE_ARRAY_FLAG - 1u);
+        out_colour = texture(texture_arrays[nonuniformEXT(array_index)], vec3(uv, float(texture_layer))) * colour;
+    }
+    else {
+        vec2 sampled_coord = uv;
+        if (atlas || distance_range > 0.0) {
+            // Map uv from [0,1] to sprite rect [sprite_rect.xy, sprite_rect.zw]
+            sampled_coord = sprite_rect.xy + uv * (sprite_rect.zw - sprite_rect.xy);
+        }
+        vec4 texel = texture(texture_samplers[nonuniformEXT(texture_index)], sampled_coord);
+        if (distance_range > 0.0) {
+            // An MSDF glyph, the median of the channels is the distance to the outline. Flat per quad, so the
+            // derivatives are taken in uniform control flow.
+            float glyph_distance = median(texel.r, texel.g, texel.b);
+            float screen_px_distance = distance_range * (glyph_distance - 0.5) / fwidth(glyph_distance);
+            float alpha = pow(clamp(screen_px_distance + 0.5, 0.0, 1.0), 1.0 / 2.2);
+            out_colour = vec4(colour.rgb, colour.a * alpha);
+        }
+        else {
+            out_colour = texel * colour;
+        }
+    }
+    if (alpha_test != 0 && out_colour.a < 0.5) {
+        discard;
     }
 
-    switch (texture_index) {
-        case 0:
-            out_colour = texture(texture_samplers[0], sampled_coord) * colour;
-            break;
-        case 1:
-            out_colour = texture(texture_samplers[1], sampled_coord) * colour;
-            break;
-        case 2:
-            out_colour = texture(texture_samplers[2], sampled_coord) * colour;
-            break;
-        case 3:
-            out_colour = texture(texture_samplers[3], sampled_coord) * colour;
-            break;
-        case 4:
-            out_colour = texture(texture_samplers[4], sampled_coord) * colour;
-            break;
-        case 5:
-            out_colour = texture(texture_samplers[5], sampled_coord) * colour;
-            break;
-        case 6:
-            out_colour = texture(texture_samplers[6], sampled_coord) * colour;
-            break;
-        case 7:
-            out_colour = texture(texture_samplers[7], sampled_coord) * colour;
-            break;
-        case 8:
-            out_colour = texture(texture_samplers[8], sampled_coord) * colour;
-            break;
-        case 9:
-            out_colour = texture(texture_samplers[9], sampled_coord) * colour;
-            break;
-        case 10:
-            out_colour = texture(texture_samplers[10], sampled_coord) * colour;
-            break;
-        case 11:
-            out_colour = texture(texture_samplers[11], sampled_coord) * colour;
-            break;
-        case 12:
-            out_colour = texture(texture_samplers[12], sampled_coord) * colour;
-            break;
-        case 13:
-            out_colour = texture(texture_samplers[13], sampled_coord) * colour;
-            break;
-        case 14:
-            out_colour = texture(texture_samplers[14], sampled_coord) * colour;
-            break;
-        case 15:
-            out_colour = texture(texture_samplers[15], sampled_coord) * colour;
-            break;
-        case 16:
-            out_colour = texture(texture_samplers[16], sampled_coord) * colour;
-            break;
-        case 17:
-            out_colour = texture(texture_samplers[17], sampled_coord) * colour;
-            break;
-        case 18:
-            out_colour = texture(texture_samplers[18], sampled_coord) * colour;
-            break;
-        case 19:
-            out_colour = texture(texture_samplers[19], sampled_coord) * colour;
-            break;
-        case 20:
-            out_colour = texture(texture_samplers[20], sampled_coord) * colour;
-            break;
-        case 21:
-            out_colour = texture(texture_samplers[21], sampled_coord) * colour;
-            break;
-        case 22:
-            out_colour = texture(texture_samplers[22], sampled_coord) * colour;
-            break;
-        case 23:
-            out_colour = texture(texture_samplers[23], sampled_coord) * colour;
-            break;
-        case 24:
-            out_colour = texture(texture_samplers[24], sampled_coord) * colour;
-            break;
-        case 25:
-            out_colour = texture(texture_samplers[25], sampled_coord) * colour;
-            break;
-        case 26:
-            out_colour = texture(texture_samplers[26], sampled_coord) * colour;
-            break;
-        case 27:
-            out_colour = texture(texture_samplers[27], sampled_coord) * colour;
-            break;
-        case 28:
-            out_colour = texture(texture_samplers[28], sampled_coord) * colour;
-            break;
-        case 29:
-            out_colour = texture(texture_samplers[29], sampled_coord) * colour;
-            break;
-        case 30:
-            out_colour = texture(texture_samplers[30], sampled_coord) * colour;
-            break;
-        case 31:
-            out_colour = texture(texture_samplers[31], sampled_coord) * colour;
-            break;
-        default:
-            out_colour = vec4(1, 0, 0, 1); // Red for error
+    // Only the lights the cull pass found touching this fragment's tile are summed. Without any lights the tile
+    // lists are not written this frame and only the ambient light applies.
+    if (lit) {
+        vec3 light = lighting.ambient.rgb;
+        if (lighting.light_count > 0u) {
+            uvec2 tile = min(uvec2(gl_FragCoord.xy) / lighting.tile_size, lighting.tile_count - 1u);
+            uint first = (tile.y * lighting.tile_count.x + tile.x) * TILE_STRIDE;
+            uint count = tile_lights[first];
+            for (uint i = 0u; i < count; ++i) {
+                PointLight point_light = lights[tile_lights[first + 1u + i]];
+                float falloff = clamp(1.0 - distance(world_position, point_light.position) / point_light.radius, 0.0,
+                                      1.0);
+                light += point_light.colour.rgb * (point_light.intensity * falloff * falloff);
+            }
+        }
+        out_colour.rgb *= light;
     }
 }
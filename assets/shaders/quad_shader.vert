@@ -1,45 +1,157 @@
 #version 460
 
-layout(location = 0) in vec3 position;
-layout(location = 1) in vec2 uv;
-
-layout(location = 2) in vec3 instance_position;
-layout(location = 3) in vec2 instance_size;
-layout(location = 4) in float instance_rotation;
-layout(location = 5) in uint instance_texture_index;
-layout(location = 6) in vec4 instance_colour;
-layout(location = 7) in vec4 instance_sprite_rect; // (offsetX, offsetY, sizeX, sizeY)
-layout(location = 8) in uint instance_is_atlas;    // 1 = Atlas-based, 0 = Full texture
-layout(location = 9) in uint instance_apply_camera_effects;
+// Packed QuadInstance, the vertex input unpacks the normalized and half float formats
+layout(location = 0) in vec3 instance_position;
+layout(location = 1) in vec2 instance_size;
+layout(location = 2) in float instance_rotation; // MSDF distance range or shape stroke width, neither is rotated
+layout(location = 3) in uint instance_texture_flags; // Texture index in bits 0..12, animated 13, is_atlas 14, camera 15
+layout(location = 4) in vec4 instance_colour;
+// (u_min, v_min, u_max, v_max), the clip and start time if animated or the layer if the index is a texture array's
+layout(location = 5) in vec4 instance_sprite_rect;
 
 layout(location = 0) out vec2 out_uv;
 layout(location = 1) out vec4 out_colour;
 layout(location = 2) out flat uint out_texture_index;
 layout(location = 3) out vec4 out_sprite_rect;
 layout(location = 4) out flat uint out_is_atlas;
+layout(location = 5) out vec2 out_world_position;
+layout(location = 6) out flat uint out_is_lit; // Quads fixed to the screen are never lit
+layout(location = 7) out flat uint out_texture_layer;
+layout(location = 8) out flat float out_distance_range; // 0 unless the quad is an MSDF glyph
+layout(location = 9) out flat uint out_shape; // QuadShape, 0 for a textured quad
+// A rect's corner radius in x, a line's endpoints, in the units of the quad's size
+layout(location = 10) out flat vec4 out_shape_params;
+layout(location = 11) out flat vec3 out_shape_extent; // The quad's size and the stroke width
 
-layout(binding = 0) uniform UniformBufferObject
+// Mirrors UniformData, pushed with every pipeline bind
+layout(push_constant) uniform CameraConstants
 {
     mat4 wvp;
     mat4 wvp_no_camera_effects;
 }
-ubo;
+camera;
+
+// Instance flags fixed by a pipeline variant for every quad it draws, see Renderer::GetPipelineVariant. Flags in the
+// mask are read from forced_flags instead of the instance, so their branches fold away once the pipeline is created.
+layout(constant_id = 1) const int forced_flag_mask = 0;
+layout(constant_id = 2) const int forced_flags = 0;
+
+// Mirrors AnimationClipData
+struct AnimationClip {
+    uint first_frame;
+    uint frame_count;
+    float duration;
+    uint next_clip;
+    uint looping;
+    uint _pad0[3];
+};
+
+// Mirrors AnimationFrameData
+struct AnimationFrame {
+    vec4 sprite_rect;
+    float end;
+    float _pad0[3];
+};
+
+// The clock animated instances started in, then the clips, see Renderer::SetAnimationClips
+layout(std430, binding = 7) readonly buffer AnimationClipBuffer {
+    float animation_time;
+    uint clip_count;
+    uint _pad0[2];
+    AnimationClip clips[];
+};
+
+layout(std430, binding = 8) readonly buffer AnimationFrameBuffer {
+    AnimationFrame frames[];
+};
+
+// Same rules as AnimationComponent::Update, a clip that ends hands over to its next clip at most once
+vec4 animated_sprite_rect(uint clip_index, float start_time) {
+    if (clip_index >= clip_count) {
+        return vec4(0.0, 0.0, 1.0, 1.0);
+    }
+
+    AnimationClip clip = clips[clip_index];
+    float time = max(animation_time - start_time, 0.0);
+    if (time >= clip.duration) {
+        if (clip.looping != 0u) {
+            time = mod(time, clip.duration);
+        }
+        else if (clip.next_clip < clip_count) {
+            time -= clip.duration;
+            clip = clips[clip.next_clip];
+            time = clip.looping != 0u ? mod(time, clip.duration) : min(time, clip.duration);
+        }
+        else {
+            time = clip.duration;
+        }
+    }
+
+    uint frame = 0u;
+    while (frame + 1u < clip.frame_count && time >= frames[clip.first_frame + frame].end) {
+        ++frame;
+    }
+    return frames[clip.first_frame + frame].sprite_rect;
+}
+
+// Set within the texture index, the bits below it are a texture array id, see QuadInstance
+const uint TEXTURE_ARRAY_FLAG = 0x1000u;
+// Arrays ignore is_atlas, the array and atlas flags together mark an MSDF glyph
+const uint MSDF_FLAGS = 0x5000u;
+// Arrays ignore animation too, the array and animated flags together mark a shape, its QuadShape in the index bits
+const uint SHAPE_FLAGS = 0x3000u;
+const uint SHAPE_LINE = 3u;
+
+// The quad has no vertex buffer, its two triangles are drawn as six vertices without indices
+const vec2 corners[6] = vec2[](vec2(0.0, 0.0), vec2(1.0, 0.0), vec2(1.0, 1.0), vec2(0.0, 0.0), vec2(1.0, 1.0),
+                               vec2(0.0, 1.0));
 
 void main()
 {
-    vec3 pos = position;
-    float cosR = cos(instance_rotation);
-    float sinR = sin(instance_rotation);
-    vec2 rotated_position = vec2(pos.x * cosR - pos.y * sinR, pos.x * sinR + pos.y * cosR);
+    vec2 corner = corners[gl_VertexIndex];
+    bool msdf = (instance_texture_flags & MSDF_FLAGS) == MSDF_FLAGS;
+    bool shape = (instance_texture_flags & SHAPE_FLAGS) == SHAPE_FLAGS;
+    float rotation = msdf || shape ? 0.0 : instance_rotation;
+    float cosR = cos(rotation);
+    float sinR = sin(rotation);
+    vec2 rotated_position = vec2(corner.x * cosR - corner.y * sinR, corner.x * sinR + corner.y * cosR);
     vec2 scaled_position = rotated_position * instance_size;
-    vec3 final_position = vec3(scaled_position + instance_position.xy, pos.z + instance_position.z);
-    mat4 wvp_matrix = (instance_apply_camera_effects == 1) ? ubo.wvp : ubo.wvp_no_camera_effects;
+    vec3 final_position = vec3(scaled_position + instance_position.xy, instance_position.z);
+    uint flags = (instance_texture_flags & ~uint(forced_flag_mask)) | (uint(forced_flags) & uint(forced_flag_mask));
+    bool apply_camera_effects = (flags & 0x8000u) != 0u;
+    mat4 wvp_matrix = apply_camera_effects ? camera.wvp : camera.wvp_no_camera_effects;
 
     gl_Position = wvp_matrix * vec4(final_position, 1.0);
 
-    out_uv = uv;
-    out_texture_index = instance_texture_index;
+    out_uv = corner;
+    out_texture_index = instance_texture_flags & (msdf ? TEXTURE_ARRAY_FLAG - 1u : 0x1FFFu);
     out_colour = instance_colour;
     out_sprite_rect = instance_sprite_rect;
-    out_is_atlas = instance_is_atlas;
+    out_texture_layer = 0u;
+    out_distance_range = msdf ? instance_rotation : 0.0;
+    out_shape = 0u;
+    out_shape_params = vec4(0.0);
+    out_shape_extent = vec3(instance_size, 0.0);
+    // Sixteen bit unorms hold the layer, the clip id and the halves of the start time's bits exactly
+    uvec4 packed_rect = uvec4(round(instance_sprite_rect * 65535.0));
+    if (msdf) {
+        // Glyphs are plain atlas sprites up to the fragment shader
+    }
+    else if (shape) {
+        out_shape = instance_texture_flags & (TEXTURE_ARRAY_FLAG - 1u);
+        out_texture_index = 0u;
+        out_shape_params = out_shape == SHAPE_LINE ? instance_sprite_rect * instance_size.xyxy
+                                                   : vec4(unpackHalf2x16(packed_rect.x).x,
+                                                          unpackHalf2x16(packed_rect.y).x, 0.0, 0.0);
+        out_shape_extent.z = instance_rotation;
+    }
+    else if ((instance_texture_flags & TEXTURE_ARRAY_FLAG) != 0u) {
+        out_texture_layer = packed_rect.x;
+    }
+    else if ((flags & 0x2000u) != 0u) {
+        out_sprite_rect = animated_sprite_rect(packed_rect.x, uintBitsToFloat(packed_rect.z | (packed_rect.w << 16)));
+    }
+    out_is_atlas = msdf ? 1u : shape ? 0u : (flags >> 14) & 1u;
+    out_world_position = final_position.xy;
+    out_is_lit = apply_camera_effects && !msdf ? 1u : 0u; // Text keeps its colour in the dark
 }
\ No newline at end of file
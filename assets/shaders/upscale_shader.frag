@@ -0,0 +1,29 @@
+#version 460
+
+layout(location = 0) in vec2 uv;
+
+layout(location = 0) out vec4 out_colour;
+
+// The world, rendered at the render scale
+layout(binding = 0) uniform sampler2D scene_colour;
+
+// Mirrors UpscaleParams
+layout(push_constant) uniform UpscaleParams {
+    vec2 texel_size;
+    float sharpness;
+} params;
+
+void main()
+{
+    vec3 centre = texture(scene_colour, uv).rgb;
+    vec3 north = texture(scene_colour, uv - vec2(0.0, params.texel_size.y)).rgb;
+    vec3 south = texture(scene_colour, uv + vec2(0.0, params.texel_size.y)).rgb;
+    vec3 west = texture(scene_colour, uv - vec2(params.texel_size.x, 0.0)).rgb;
+    vec3 east = texture(scene_colour, uv + vec2(params.texel_size.x, 0.0)).rgb;
+
+    // Bilinear filtering plus an unsharp mask, limited to the range of the neighbours so edges do not ring
+    vec3 neighbour_min = min(min(min(north, south), min(west, east)), centre);
+    vec3 neighbour_max = max(max(max(north, south), max(west, east)), centre);
+    vec3 sharpened = centre + (centre * 4.0 - (north + south + west + east)) * (0.25 * params.sharpness);
+    out_colour = vec4(clamp(sharpened, neighbour_min, neighbour_max), 1.0);
+}
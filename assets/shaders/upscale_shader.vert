@@ -0,0 +1,10 @@
+#version 460
+
+layout(location = 0) out vec2 out_uv;
+
+// One triangle covering the screen, drawn without vertex or instance buffers
+void main()
+{
+    out_uv = vec2((gl_VertexIndex << 1) & 2, gl_VertexIndex & 2);
+    gl_Position = vec4(out_uv * 2.0 - 1.0, 0.0, 1.0);
+}
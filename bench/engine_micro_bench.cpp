@@ -0,0 +1,713 @@
+/**
+ * @file engine_micro_bench.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Micro benchmarks of the engine's containers and math
+ *
+ * Covers the primitives on the frame's hot paths: SmallVector growth under each policy against std::vector, filling
+ * in place and unordered removal, FlatHashMap lookups against std::unordered_map, Mat4 products and the other
+ * kernels, Vec3 arithmetic, AABB2D::Intersects over batches against the sweep and prune broadphase, frustum culling,
+ * the RNGs with and without the lock, then the event bus and tween system. Arguments are element counts unless noted,
+ * items per second count elements, lookups, products or numbers.
+ */
+#include <array>
+#include <format>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "containers/flat_hash_map.hpp"
+#include "containers/small_vector.hpp"
+#include "math/collision.hpp"
+#include "math/math.hpp"
+#include "math/matrix4x4.hpp"
+#include "math/random.hpp"
+#include "math/simd_kernels.hpp"
+#include "math/sweep_and_prune.hpp"
+#include "math/vector.hpp"
+#include "utils/event_bus.hpp"
+#include "utils/hash.hpp"
+#include "utils/tween_system.hpp"
+
+#include "micro_bench.hpp"
+
+namespace internal {
+
+constexpr u32 SEED{0x9e3779b9}; // Fixed, so every run draws the same numbers
+
+// An instance sized record, for the growth benchmarks that move more than a word per element
+struct Record {
+    gouda::Vec3 position;
+    gouda::Vec2 size;
+    f32 rotation;
+    u32 texture_index;
+};
+
+// Deterministic values in [0, 1), cheaper and more repeatable than the RNG under test
+static f32 hash_to_unit(u32 value)
+{
+    value ^= value >> 16;
+    value *= 0x7feb352d;
+    value ^= value >> 15;
+    value *= 0x846ca68b;
+    value ^= value >> 16;
+    return static_cast<f32>(value >> 8) * (1.0f / 16777216.0f);
+}
+
+static std::vector<gouda::math::AABB2D> make_boxes(const size_t count)
+{
+    std::vector<gouda::math::AABB2D> boxes;
+    boxes.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        const auto seed{static_cast<u32>(i * 2)};
+        const gouda::Vec2 min{hash_to_unit(seed) * 1000.0f, hash_to_unit(seed + 1) * 1000.0f};
+        boxes.emplace_back(min, min + gouda::Vec2{16.0f, 16.0f});
+    }
+    return boxes;
+}
+
+static gouda::Mat4 make_model_matrix(const f32 seed)
+{
+    return gouda::Mat4::translation(gouda::Vec3{seed, seed * 2.0f, 0.5f}) * gouda::Mat4::rotationZ(seed) *
+           gouda::Mat4::scaling(gouda::Vec3{2.0f, 3.0f, 1.0f});
+}
+
+// SmallVector ---------------------------------------------------------------------------------------------------------
+
+template <typename GrowthPolicy, size_t InlineCapacity>
+static void small_vector_push_back(bench::State &state)
+{
+    const auto count{static_cast<size_t>(state.GetArgument())};
+    while (state.KeepRunning()) {
+        gouda::SmallVector<u32, InlineCapacity, GrowthPolicy> values;
+        for (size_t i = 0; i < count; ++i) {
+            values.push_back(static_cast<u32>(i));
+        }
+        bench::do_not_optimize(values.data());
+        bench::clobber_memory();
+    }
+    state.SetItemsProcessed(state.GetIterations() * count);
+}
+
+template <typename GrowthPolicy>
+static void small_vector_emplace_back(bench::State &state)
+{
+    const auto count{static_cast<size_t>(state.GetArgument())};
+    while (state.KeepRunning()) {
+        gouda::SmallVector<Record, 0, GrowthPolicy> records;
+        for (size_t i = 0; i < count; ++i) {
+            const auto value{static_cast<f32>(i)};
+            records.emplace_back(gouda::Vec3{value, value, 0.0f}, gouda::Vec2{1.0f, 1.0f}, 0.0f, static_cast<u32>(i));
+        }
+        bench::do_not_optimize(records.data());
+        bench::clobber_memory();
+    }
+    state.SetItemsProcessed(state.GetIterations() * count);
+}
+
+static void small_vector_push_back_reserved(bench::State &state)
+{
+    const auto count{static_cast<size_t>(state.GetArgument())};
+    while (state.KeepRunning()) {
+        gouda::Vector<u32> values;
+        values.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            values.push_back(static_cast<u32>(i));
+        }
+        bench::do_not_optimize(values.data());
+        bench::clobber_memory();
+    }
+    state.SetItemsProcessed(state.GetIterations() * count);
+}
+
+static void std_vector_push_back(bench::State &state)
+{
+    const auto count{static_cast<size_t>(state.GetArgument())};
+    while (state.KeepRunning()) {
+        std::vector<u32> values;
+        for (size_t i = 0; i < count; ++i) {
+            values.push_back(static_cast<u32>(i));
+        }
+        bench::do_not_optimize(values.data());
+        bench::clobber_memory();
+    }
+    state.SetItemsProcessed(state.GetIterations() * count);
+}
+
+static void std_vector_emplace_back(bench::State &state)
+{
+    const auto count{static_cast<size_t>(state.GetArgument())};
+    while (state.KeepRunning()) {
+        std::vector<Record> records;
+        for (size_t i = 0; i < count; ++i) {
+            const auto value{static_cast<f32>(i)};
+            records.emplace_back(gouda::Vec3{value, value, 0.0f}, gouda::Vec2{1.0f, 1.0f}, 0.0f, static_cast<u32>(i));
+        }
+        bench::do_not_optimize(records.data());
+        bench::clobber_memory();
+    }
+    state.SetItemsProcessed(state.GetIterations() * count);
+}
+
+// Fills a reused vector in place, against value initializing each element first
+template <bool Uninitialized>
+static void small_vector_fill(bench::State &state)
+{
+    const auto count{static_cast<size_t>(state.GetArgument())};
+    gouda::Vector<Record> records;
+    while (state.KeepRunning()) {
+        records.clear();
+        if constexpr (Uninitialized) {
+            records.resize_uninitialized(count);
+        }
+        else {
+            records.resize(count);
+        }
+        for (size_t i = 0; i < count; ++i) {
+            const auto value{static_cast<f32>(i)};
+            records[i] = {gouda::Vec3{value, value, 0.0f}, gouda::Vec2{1.0f, 1.0f}, 0.0f, static_cast<u32>(i)};
+        }
+        bench::do_not_optimize(records.data());
+        bench::clobber_memory();
+    }
+    state.SetItemsProcessed(state.GetIterations() * count);
+}
+
+// Removes every other element from the front half, erase shifts the tail down each time
+template <bool SwapRemove>
+static void small_vector_remove(bench::State &state)
+{
+    const auto count{static_cast<size_t>(state.GetArgument())};
+    gouda::Vector<Record> records;
+    while (state.KeepRunning()) {
+        records.resize(count);
+        for (size_t i = 0; i < count / 2; ++i) {
+            if constexpr (SwapRemove) {
+                records.swap_remove(records.begin() + static_cast<std::ptrdiff_t>(i));
+            }
+            else {
+                records.erase(records.begin() + static_cast<std::ptrdiff_t>(i));
+            }
+        }
+        bench::do_not_optimize(records.data());
+        bench::clobber_memory();
+    }
+    state.SetItemsProcessed(state.GetIterations() * (count / 2));
+}
+
+// Hash maps ----------------------------------------------------------------------------------------------------------
+
+// Looks up every key once per iteration in shuffled order, half of them present
+template <typename Map>
+static void hash_map_find_integer(bench::State &state)
+{
+    const auto count{static_cast<u32>(state.GetArgument())};
+    Map map;
+    std::vector<u64> keys(count * 2);
+    for (u32 i = 0; i < count * 2; ++i) {
+        keys[i] = gouda::utils::mix64(i);
+        if (i % 2 == 0) {
+            map[keys[i]] = i;
+        }
+    }
+
+    u64 sum{0};
+    while (state.KeepRunning()) {
+        for (const u64 key : keys) {
+            if (const auto it{map.find(key)}; it != map.end()) {
+                sum += it->second;
+            }
+        }
+        bench::do_not_optimize(sum);
+    }
+    state.SetItemsProcessed(state.GetIterations() * keys.size());
+}
+
+// Looks names up by StringView, as sprite and clip lookups do. std::unordered_map has to build a String to search.
+template <bool Flat>
+static void hash_map_find_string(bench::State &state)
+{
+    const auto count{static_cast<u32>(state.GetArgument())};
+    std::conditional_t<Flat, gouda::FlatHashMap<String, u32>, std::unordered_map<String, u32>> map;
+    std::vector<String> names(count);
+    for (u32 i = 0; i < count; ++i) {
+        names[i] = std::format("sprites/character_{}.walk_{}", i * 7919 % count, i);
+        map.emplace(names[i], i);
+    }
+
+    u64 sum{0};
+    while (state.KeepRunning()) {
+        for (const String &name : names) {
+            const StringView view{name};
+            if constexpr (Flat) {
+                sum += *map.get(view);
+            }
+            else {
+                sum += map.find(String{view})->second;
+            }
+        }
+        bench::do_not_optimize(sum);
+    }
+    state.SetItemsProcessed(state.GetIterations() * count);
+}
+
+// Mat4 and Vec3 -------------------------------------------------------------------------------------------------------
+
+static void mat4_multiply(bench::State &state)
+{
+    gouda::Mat4 lhs{make_model_matrix(0.5f)};
+    const gouda::Mat4 rhs{make_model_matrix(1.5f)};
+    while (state.KeepRunning()) {
+        bench::do_not_optimize(lhs);
+        const gouda::Mat4 product{lhs * rhs};
+        bench::do_not_optimize(product);
+    }
+    state.SetItemsProcessed(state.GetIterations());
+}
+
+static void mat4_model_matrix(bench::State &state)
+{
+    f32 seed{0.25f};
+    while (state.KeepRunning()) {
+        bench::do_not_optimize(seed);
+        const gouda::Mat4 model{make_model_matrix(seed)};
+        bench::do_not_optimize(model);
+    }
+    state.SetItemsProcessed(state.GetIterations());
+}
+
+static void mat4_transform_batch(bench::State &state)
+{
+    const auto count{static_cast<size_t>(state.GetArgument())};
+    const gouda::Mat4 matrix{make_model_matrix(0.75f)};
+    std::vector<gouda::Vec4> points(count, gouda::Vec4{1.0f, 2.0f, 3.0f, 1.0f});
+    std::vector<gouda::Vec4> transformed(count);
+    while (state.KeepRunning()) {
+        for (size_t i = 0; i < count; ++i) {
+            transformed[i] = matrix * points[i];
+        }
+        bench::do_not_optimize(transformed.data());
+        bench::clobber_memory();
+    }
+    state.SetItemsProcessed(state.GetIterations() * count);
+}
+
+static void mat4_transpose(bench::State &state)
+{
+    gouda::Mat4 matrix{make_model_matrix(0.5f)};
+    while (state.KeepRunning()) {
+        bench::do_not_optimize(matrix);
+        const gouda::Mat4 transposed{matrix.transpose()};
+        bench::do_not_optimize(transposed);
+    }
+    state.SetItemsProcessed(state.GetIterations());
+}
+
+static void mat4_inverse(bench::State &state)
+{
+    gouda::Mat4 matrix{make_model_matrix(0.5f)};
+    while (state.KeepRunning()) {
+        bench::do_not_optimize(matrix);
+        const gouda::Mat4 inverse{matrix.inverse()};
+        bench::do_not_optimize(inverse);
+    }
+    state.SetItemsProcessed(state.GetIterations());
+}
+
+static void vec3_arithmetic_batch(bench::State &state)
+{
+    const auto count{static_cast<size_t>(state.GetArgument())};
+    std::vector<gouda::Vec3> positions(count, gouda::Vec3{1.0f, 2.0f, 3.0f});
+    const gouda::Vec3 velocity{0.1f, -0.2f, 0.0f};
+    while (state.KeepRunning()) {
+        f32 total{0.0f};
+        for (gouda::Vec3 &position : positions) {
+            position += velocity * 0.016f;
+            total += position.dot(velocity);
+        }
+        bench::do_not_optimize(total);
+    }
+    state.SetItemsProcessed(state.GetIterations() * count);
+}
+
+static void vec3_normalize_batch(bench::State &state)
+{
+    const auto count{static_cast<size_t>(state.GetArgument())};
+    std::vector<gouda::Vec3> directions;
+    directions.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        const auto seed{static_cast<u32>(i * 3)};
+        directions.emplace_back(hash_to_unit(seed) + 0.1f, hash_to_unit(seed + 1), hash_to_unit(seed + 2));
+    }
+    std::vector<gouda::Vec3> normalized(count);
+    while (state.KeepRunning()) {
+        for (size_t i = 0; i < count; ++i) {
+            normalized[i] = directions[i].normalized();
+        }
+        bench::do_not_optimize(normalized.data());
+        bench::clobber_memory();
+    }
+    state.SetItemsProcessed(state.GetIterations() * count);
+}
+
+// AABB2D --------------------------------------------------------------------------------------------------------------
+
+// One query box against every box of the batch, as a broad phase without a grid would
+static void aabb2d_intersects_batch(bench::State &state)
+{
+    const auto count{static_cast<size_t>(state.GetArgument())};
+    const std::vector<gouda::math::AABB2D> boxes{make_boxes(count)};
+    gouda::math::AABB2D query{gouda::Vec2{400.0f, 400.0f}, gouda::Vec2{600.0f, 600.0f}};
+    while (state.KeepRunning()) {
+        bench::do_not_optimize(query);
+        u32 hits{0};
+        for (const gouda::math::AABB2D &box : boxes) {
+            hits += query.Intersects(box) ? 1u : 0u;
+        }
+        bench::do_not_optimize(hits);
+    }
+    state.SetItemsProcessed(state.GetIterations() * count);
+}
+
+// The same test through the structure of arrays kernel, compacting the hits into an index list
+static void aabb2d_intersect_indices_batch(bench::State &state)
+{
+    const auto count{static_cast<size_t>(state.GetArgument())};
+    gouda::math::AABB2DColumns columns;
+    columns.Reserve(count);
+    for (const gouda::math::AABB2D &box : make_boxes(count)) {
+        columns.PushBack(box);
+    }
+    gouda::Vector<u32> hits;
+    hits.reserve(count);
+    gouda::math::AABB2D query{gouda::Vec2{400.0f, 400.0f}, gouda::Vec2{600.0f, 600.0f}};
+    while (state.KeepRunning()) {
+        bench::do_not_optimize(query);
+        hits.clear();
+        gouda::math::intersect_aabbs(columns, query, hits);
+        bench::do_not_optimize(hits.data());
+        bench::clobber_memory();
+    }
+    state.SetItemsProcessed(state.GetIterations() * count);
+}
+
+// 3D boxes scattered in front of a perspective camera, about half inside its frustum
+static std::vector<gouda::math::AABB3D> make_boxes_3d(const size_t count)
+{
+    std::vector<gouda::math::AABB3D> boxes;
+    boxes.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        const auto seed{static_cast<u32>(i * 3)};
+        const gouda::Vec3 min{hash_to_unit(seed) * 200.0f - 100.0f, hash_to_unit(seed + 1) * 200.0f - 100.0f,
+                              hash_to_unit(seed + 2) * -100.0f};
+        boxes.emplace_back(min, min + gouda::Vec3{2.0f, 2.0f, 2.0f});
+    }
+    return boxes;
+}
+
+static gouda::math::Frustum make_frustum()
+{
+    const gouda::Mat4 view{gouda::math::lookAt(gouda::Vec3{0.0f}, gouda::Vec3{0.0f, 0.0f, -1.0f},
+                                               gouda::Vec3{0.0f, 1.0f, 0.0f})};
+    return gouda::math::extract_frustum(
+        gouda::math::perspective(gouda::math::radians(60.0f), 16.0f / 9.0f, 0.1f, 100.0f) * view);
+}
+
+// The scalar test per box against the dispatched kernels, which need the boxes contiguous
+static void frustum_cull_aabbs_scalar(bench::State &state)
+{
+    const auto count{static_cast<size_t>(state.GetArgument())};
+    const std::vector<gouda::math::AABB3D> boxes{make_boxes_3d(count)};
+    gouda::math::Frustum frustum{make_frustum()};
+    while (state.KeepRunning()) {
+        bench::do_not_optimize(frustum);
+        u32 visible{0};
+        for (const gouda::math::AABB3D &box : boxes) {
+            visible += frustum.Intersects(box) ? 1u : 0u;
+        }
+        bench::do_not_optimize(visible);
+    }
+    state.SetItemsProcessed(state.GetIterations() * count);
+}
+
+static void frustum_cull_aabbs_batch(bench::State &state)
+{
+    const auto count{static_cast<size_t>(state.GetArgument())};
+    const std::vector<gouda::math::AABB3D> boxes{make_boxes_3d(count)};
+    std::vector<u8> visible(count);
+    gouda::math::Frustum frustum{make_frustum()};
+    while (state.KeepRunning()) {
+        bench::do_not_optimize(frustum);
+        gouda::math::cull_frustum(frustum, boxes, visible);
+        bench::do_not_optimize(visible.data());
+        bench::clobber_memory();
+    }
+    state.SetItemsProcessed(state.GetIterations() * count);
+}
+
+static void frustum_cull_spheres_batch(bench::State &state)
+{
+    const auto count{static_cast<size_t>(state.GetArgument())};
+    std::vector<gouda::math::Sphere> spheres;
+    spheres.reserve(count);
+    for (const gouda::math::AABB3D &box : make_boxes_3d(count)) {
+        spheres.push_back({(box.min + box.max) * 0.5f, 1.0f});
+    }
+    std::vector<u8> visible(count);
+    gouda::math::Frustum frustum{make_frustum()};
+    while (state.KeepRunning()) {
+        bench::do_not_optimize(frustum);
+        gouda::math::cull_frustum(frustum, spheres, visible);
+        bench::do_not_optimize(visible.data());
+        bench::clobber_memory();
+    }
+    state.SetItemsProcessed(state.GetIterations() * count);
+}
+
+// Every pair of the batch once, items are the pairs tested
+static void aabb2d_intersects_all_pairs(bench::State &state)
+{
+    const auto count{static_cast<size_t>(state.GetArgument())};
+    const std::vector<gouda::math::AABB2D> boxes{make_boxes(count)};
+    while (state.KeepRunning()) {
+        u32 hits{0};
+        for (size_t i = 0; i < count; ++i) {
+            for (size_t j = i + 1; j < count; ++j) {
+                hits += boxes[i].Intersects(boxes[j]) ? 1u : 0u;
+            }
+        }
+        bench::do_not_optimize(hits);
+    }
+    state.SetItemsProcessed(state.GetIterations() * (count * (count - 1) / 2));
+}
+
+// Every box nudged a little each tick, then the overlapping pairs found, items are the boxes
+static void sweep_and_prune_find_pairs(bench::State &state)
+{
+    const auto count{static_cast<size_t>(state.GetArgument())};
+    std::vector<gouda::math::AABB2D> boxes{make_boxes(count)};
+    gouda::math::SweepAndPrune broadphase;
+    for (size_t i = 0; i < count; ++i) {
+        broadphase.Insert(static_cast<u32>(i), boxes[i]);
+    }
+
+    gouda::Vector<gouda::math::CollisionPair> pairs;
+    u32 tick{0};
+    while (state.KeepRunning()) {
+        ++tick;
+        for (size_t i = 0; i < count; ++i) {
+            const gouda::Vec2 offset{hash_to_unit(static_cast<u32>(i) + tick) - 0.5f, 0.0f};
+            boxes[i] = gouda::math::AABB2D{boxes[i].min + offset, boxes[i].max + offset};
+            broadphase.Move(static_cast<u32>(i), boxes[i]);
+        }
+        pairs.clear();
+        broadphase.FindPairs(pairs);
+        bench::do_not_optimize(pairs.data());
+        bench::clobber_memory();
+    }
+    state.SetItemsProcessed(state.GetIterations() * count);
+}
+
+// RNG -----------------------------------------------------------------------------------------------------------------
+
+template <typename RNG>
+static void rng_uint(bench::State &state)
+{
+    RNG rng{SEED};
+    while (state.KeepRunning()) {
+        bench::do_not_optimize(rng.GetUint());
+    }
+    state.SetItemsProcessed(state.GetIterations());
+}
+
+template <typename RNG>
+static void rng_float(bench::State &state)
+{
+    RNG rng{SEED};
+    while (state.KeepRunning()) {
+        bench::do_not_optimize(rng.GetFloat(-1.0f, 1.0f));
+    }
+    state.SetItemsProcessed(state.GetIterations());
+}
+
+template <typename RNG>
+static void rng_int(bench::State &state)
+{
+    RNG rng{SEED};
+    while (state.KeepRunning()) {
+        bench::do_not_optimize(rng.GetInt(0, 99));
+    }
+    state.SetItemsProcessed(state.GetIterations());
+}
+
+// Threads sharing one ThreadSafeRNG, the argument is the thread count and each draws the iteration count
+static void thread_safe_rng_shared(bench::State &state)
+{
+    const auto thread_count{static_cast<u32>(state.GetArgument())};
+    const u64 iterations{state.GetIterations()};
+    gouda::math::ThreadSafeRNG rng{SEED};
+    {
+        std::vector<std::jthread> threads;
+        for (u32 thread = 0; thread < thread_count; ++thread) {
+            threads.emplace_back([&rng, iterations] {
+                for (u64 i = 0; i < iterations; ++i) {
+                    bench::do_not_optimize(rng.GetUint());
+                }
+            });
+        }
+    }
+    state.SetItemsProcessed(iterations * thread_count);
+}
+
+// The same load with a BaseRNG per thread, what the lock and the shared cache line cost
+static void base_rng_per_thread(bench::State &state)
+{
+    const auto thread_count{static_cast<u32>(state.GetArgument())};
+    const u64 iterations{state.GetIterations()};
+    {
+        std::vector<std::jthread> threads;
+        for (u32 thread = 0; thread < thread_count; ++thread) {
+            threads.emplace_back([iterations, seed = SEED + thread] {
+                gouda::math::BaseRNG rng{seed};
+                for (u64 i = 0; i < iterations; ++i) {
+                    bench::do_not_optimize(rng.GetUint());
+                }
+            });
+        }
+    }
+    state.SetItemsProcessed(iterations * thread_count);
+}
+
+// Bulk float fills, the argument is the span length and items are the values written
+template <typename RNG>
+static void rng_fill_float(bench::State &state)
+{
+    std::vector<f32> values(static_cast<size_t>(state.GetArgument()));
+    RNG rng{SEED};
+    while (state.KeepRunning()) {
+        rng.Fill(values, -1.0f, 1.0f);
+        bench::do_not_optimize(values.data());
+        bench::clobber_memory();
+    }
+    state.SetItemsProcessed(state.GetIterations() * values.size());
+}
+
+// Event bus -----------------------------------------------------------------------------------------------------------
+
+struct DamageEvent {
+    u32 entity;
+    f32 amount;
+};
+
+// A tick's worth of events emitted and dispatched to one handler, the argument is the events per tick
+static void event_bus_emit_dispatch(bench::State &state)
+{
+    const auto count{static_cast<u32>(state.GetArgument())};
+    gouda::EventBus bus;
+    f32 total_damage{0.0f};
+    const auto add_damage{[&total_damage](const std::span<const DamageEvent> events) {
+        for (const DamageEvent &event : events) {
+            total_damage += event.amount;
+        }
+    }};
+    const gouda::EventSubscription subscription{bus.Subscribe<DamageEvent>(add_damage)};
+
+    while (state.KeepRunning()) {
+        for (u32 i = 0; i < count; ++i) {
+            bus.Emit(DamageEvent{i, 1.0f});
+        }
+        bus.Dispatch();
+        bench::do_not_optimize(total_damage);
+    }
+    bus.Unsubscribe(subscription);
+    state.SetItemsProcessed(state.GetIterations() * count);
+}
+
+// A frame of tweens spread over the polynomial easings, each writing its target, the argument is the tween count
+static void tween_system_update(bench::State &state)
+{
+    using gouda::math::easing::EasingType;
+    constexpr std::array<EasingType, 4> easings{EasingType::Linear, EasingType::EaseOutQuad, EasingType::SmoothStep,
+                                                EasingType::EaseInOutCubic};
+    const auto count{static_cast<u32>(state.GetArgument())};
+    std::vector<f32> targets(count);
+    gouda::TweenSystem tweens;
+    for (u32 i = 0; i < count; ++i) {
+        // Long enough that none finish while the benchmark runs
+        tweens.Add(hash_to_unit(i), hash_to_unit(i + count), 1.0e6f, easings[i % easings.size()], &targets[i]);
+    }
+
+    while (state.KeepRunning()) {
+        tweens.Update(1.0f / 60.0f);
+        bench::do_not_optimize(targets.data());
+    }
+    state.SetItemsProcessed(state.GetIterations() * count);
+}
+
+} // namespace internal
+
+// AddOne copies every element on each growth, so it stops at a smaller size
+MICRO_BENCHMARK("small_vector/push_back/double", internal::small_vector_push_back<gouda::GrowthPolicyDouble, 0>)
+    .Range(16, 65536);
+MICRO_BENCHMARK("small_vector/push_back/one_point_five",
+                internal::small_vector_push_back<gouda::GrowthPolicyOnePointFive, 0>)
+    .Range(16, 65536);
+MICRO_BENCHMARK("small_vector/push_back/add_one", internal::small_vector_push_back<gouda::GrowthPolicyAddOne, 0>)
+    .Range(16, 4096);
+MICRO_BENCHMARK("small_vector/push_back/inline_16",
+                internal::small_vector_push_back<gouda::GrowthPolicyOnePointFive, 16>)
+    .Arg(16)
+    .Arg(64);
+MICRO_BENCHMARK("small_vector/push_back/reserved", internal::small_vector_push_back_reserved).Range(16, 65536);
+MICRO_BENCHMARK("std_vector/push_back", internal::std_vector_push_back).Range(16, 65536);
+MICRO_BENCHMARK("small_vector/emplace_back/double", internal::small_vector_emplace_back<gouda::GrowthPolicyDouble>)
+    .Range(16, 65536);
+MICRO_BENCHMARK("small_vector/emplace_back/one_point_five",
+                internal::small_vector_emplace_back<gouda::GrowthPolicyOnePointFive>)
+    .Range(16, 65536);
+MICRO_BENCHMARK("std_vector/emplace_back", internal::std_vector_emplace_back).Range(16, 65536);
+MICRO_BENCHMARK("small_vector/fill/resize", internal::small_vector_fill<false>).Range(16, 65536);
+MICRO_BENCHMARK("small_vector/fill/resize_uninitialized", internal::small_vector_fill<true>).Range(16, 65536);
+MICRO_BENCHMARK("small_vector/remove/erase", internal::small_vector_remove<false>).Range(16, 4096);
+MICRO_BENCHMARK("small_vector/remove/swap_remove", internal::small_vector_remove<true>).Range(16, 65536);
+
+MICRO_BENCHMARK("hash_map/find_integer/flat", internal::hash_map_find_integer<gouda::FlatHashMap<u64, u32>>)
+    .Range(64, 65536);
+MICRO_BENCHMARK("hash_map/find_integer/std", internal::hash_map_find_integer<std::unordered_map<u64, u32>>)
+    .Range(64, 65536);
+MICRO_BENCHMARK("hash_map/find_string/flat", internal::hash_map_find_string<true>).Range(64, 16384);
+MICRO_BENCHMARK("hash_map/find_string/std", internal::hash_map_find_string<false>).Range(64, 16384);
+
+MICRO_BENCHMARK("mat4/multiply", internal::mat4_multiply);
+MICRO_BENCHMARK("mat4/model_matrix", internal::mat4_model_matrix);
+MICRO_BENCHMARK("mat4/transform_batch", internal::mat4_transform_batch).Arg(1024).Arg(16384);
+MICRO_BENCHMARK("mat4/transpose", internal::mat4_transpose);
+MICRO_BENCHMARK("mat4/inverse", internal::mat4_inverse);
+MICRO_BENCHMARK("vec3/arithmetic_batch", internal::vec3_arithmetic_batch).Arg(1024).Arg(16384);
+MICRO_BENCHMARK("vec3/normalize_batch", internal::vec3_normalize_batch).Arg(1024).Arg(16384);
+
+MICRO_BENCHMARK("aabb2d/intersects_batch", internal::aabb2d_intersects_batch).Range(64, 65536);
+MICRO_BENCHMARK("aabb2d/intersect_indices_batch", internal::aabb2d_intersect_indices_batch).Range(64, 65536);
+MICRO_BENCHMARK("aabb2d/intersects_all_pairs", internal::aabb2d_intersects_all_pairs).Arg(256).Arg(1024);
+MICRO_BENCHMARK("frustum/cull_aabbs_scalar", internal::frustum_cull_aabbs_scalar).Range(64, 65536);
+MICRO_BENCHMARK("frustum/cull_aabbs_batch", internal::frustum_cull_aabbs_batch).Range(64, 65536);
+MICRO_BENCHMARK("frustum/cull_spheres_batch", internal::frustum_cull_spheres_batch).Range(64, 65536);
+MICRO_BENCHMARK("sweep_and_prune/find_pairs", internal::sweep_and_prune_find_pairs).Arg(256).Arg(1024).Arg(16384);
+
+MICRO_BENCHMARK("rng/base/uint", internal::rng_uint<gouda::math::BaseRNG>);
+MICRO_BENCHMARK("rng/thread_safe/uint", internal::rng_uint<gouda::math::ThreadSafeRNG>);
+MICRO_BENCHMARK("rng/base/float", internal::rng_float<gouda::math::BaseRNG>);
+MICRO_BENCHMARK("rng/thread_safe/float", internal::rng_float<gouda::math::ThreadSafeRNG>);
+MICRO_BENCHMARK("rng/base/int", internal::rng_int<gouda::math::BaseRNG>);
+MICRO_BENCHMARK("rng/thread_safe/int", internal::rng_int<gouda::math::ThreadSafeRNG>);
+MICRO_BENCHMARK("rng/thread_safe/shared_threads", internal::thread_safe_rng_shared).Arg(1).Arg(2).Arg(4).Arg(8);
+MICRO_BENCHMARK("rng/base/thread_local", internal::base_rng_per_thread).Arg(1).Arg(2).Arg(4).Arg(8);
+MICRO_BENCHMARK("rng/base/fill_float", internal::rng_fill_float<gouda::math::BaseRNG>).Range(64, 65536);
+MICRO_BENCHMARK("rng/multi_stream/fill_float", internal::rng_fill_float<gouda::math::MultiStreamRNG>)
+    .Range(64, 65536);
+
+MICRO_BENCHMARK("event_bus/emit_dispatch", internal::event_bus_emit_dispatch).Range(64, 16384);
+MICRO_BENCHMARK("tween_system/update", internal::tween_system_update).Range(64, 16384);
+
+int main(const int argc, char **argv) { return bench::run_benchmarks(argc, argv); }
@@ -0,0 +1,233 @@
+/**
+ * @file micro_bench.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Micro benchmark harness implementation
+ */
+#include "micro_bench.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <deque>
+#include <format>
+#include <fstream>
+#include <optional>
+#include <print>
+
+#include <nlohmann/json.hpp>
+
+namespace bench {
+
+namespace internal {
+
+// Deque, so the references register_benchmark hands out stay valid as more are added
+static std::deque<Benchmark> &get_benchmarks()
+{
+    static std::deque<Benchmark> benchmarks;
+    return benchmarks;
+}
+
+struct RunOptions {
+    String filter;
+    f64 min_time{0.2}; // Seconds
+    u32 repetitions{5};
+    String output_filepath;
+};
+
+struct RunResult {
+    String name;
+    u64 iterations;
+    f64 median_time; // Nanoseconds per iteration, over the repetitions
+    f64 min_time;
+    f64 max_time;
+    f64 items_per_second; // Of the median repetition, zero when the benchmark reports no items
+};
+
+template <typename T>
+static bool parse_number(StringView text, T &value)
+{
+    const auto [end, error]{std::from_chars(text.data(), text.data() + text.size(), value)};
+    return error == std::errc{} && end == text.data() + text.size();
+}
+
+static std::optional<RunOptions> parse_options(const int argc, char **argv)
+{
+    RunOptions options;
+    for (int i = 1; i < argc; ++i) {
+        const StringView argument{argv[i]};
+        if (i + 1 >= argc) {
+            std::println(stderr, "Missing value for {}", argument);
+            return std::nullopt;
+        }
+
+        const StringView value{argv[++i]};
+        bool is_valid{true};
+        if (argument == "--filter") {
+            options.filter = value;
+        }
+        else if (argument == "--min-time") {
+            is_valid = parse_number(value, options.min_time) && options.min_time > 0.0;
+        }
+        else if (argument == "--repetitions") {
+            is_valid = parse_number(value, options.repetitions) && options.repetitions > 0;
+        }
+        else if (argument == "--output") {
+            options.output_filepath = value;
+        }
+        else {
+            std::println(stderr, "Unknown option {}", argument);
+            return std::nullopt;
+        }
+
+        if (!is_valid) {
+            std::println(stderr, "Invalid value '{}' for {}", value, argument);
+            return std::nullopt;
+        }
+    }
+    return options;
+}
+
+struct TimedRun {
+    f64 seconds;
+    u64 items_processed;
+};
+
+static TimedRun run_once(const BenchmarkFunction function, const u64 iterations, const s64 argument)
+{
+    State state{iterations, argument};
+    const SteadyClock::time_point start{SteadyClock::now()};
+    function(state);
+    const std::chrono::duration<f64> elapsed{SteadyClock::now() - start};
+    return {elapsed.count(), state.GetItemsProcessed()};
+}
+
+// Grows the iteration count until one run takes at least min_time, the same count is used for every repetition
+static u64 find_iteration_count(const BenchmarkFunction function, const s64 argument, const f64 min_time)
+{
+    constexpr u64 MAX_ITERATIONS{1'000'000'000};
+
+    u64 iterations{1};
+    while (iterations < MAX_ITERATIONS) {
+        const f64 seconds{run_once(function, iterations, argument).seconds};
+        if (seconds >= min_time) {
+            break;
+        }
+
+        // Aim a little past min_time, and grow by at most 10x while runs are too short to extrapolate from
+        const f64 multiplier{seconds > min_time * 0.1 ? min_time * 1.4 / seconds : 10.0};
+        iterations = std::min(MAX_ITERATIONS,
+                              std::max(iterations + 1, static_cast<u64>(static_cast<f64>(iterations) * multiplier)));
+    }
+    return iterations;
+}
+
+static RunResult run_benchmark(const Benchmark &benchmark, const s64 argument, const bool has_argument,
+                               const RunOptions &options)
+{
+    const u64 iterations{find_iteration_count(benchmark.GetFunction(), argument, options.min_time)};
+
+    std::vector<TimedRun> runs;
+    runs.reserve(options.repetitions);
+    for (u32 i = 0; i < options.repetitions; ++i) {
+        runs.push_back(run_once(benchmark.GetFunction(), iterations, argument));
+    }
+    std::ranges::sort(runs, {}, &TimedRun::seconds);
+
+    const TimedRun &median{runs[runs.size() / 2]};
+    const f64 to_nanoseconds{1.0e9 / static_cast<f64>(iterations)};
+    return {has_argument ? std::format("{}/{}", benchmark.GetName(), argument) : String{benchmark.GetName()},
+            iterations,
+            median.seconds * to_nanoseconds,
+            runs.front().seconds * to_nanoseconds,
+            runs.back().seconds * to_nanoseconds,
+            median.seconds > 0.0 ? static_cast<f64>(median.items_processed) / median.seconds : 0.0};
+}
+
+static String format_rate(const f64 items_per_second)
+{
+    if (items_per_second <= 0.0) {
+        return "";
+    }
+    if (items_per_second >= 1.0e9) {
+        return std::format("{:.2f}G/s", items_per_second / 1.0e9);
+    }
+    if (items_per_second >= 1.0e6) {
+        return std::format("{:.2f}M/s", items_per_second / 1.0e6);
+    }
+    return std::format("{:.2f}k/s", items_per_second / 1.0e3);
+}
+
+static bool write_results(const std::vector<RunResult> &results, StringView filepath)
+{
+    nlohmann::json benchmarks = nlohmann::json::array();
+    for (const RunResult &result : results) {
+        benchmarks.push_back({{"name", result.name},
+                              {"iterations", result.iterations},
+                              {"median_ns", result.median_time},
+                              {"min_ns", result.min_time},
+                              {"max_ns", result.max_time},
+                              {"items_per_second", result.items_per_second}});
+    }
+
+    std::ofstream file{String{filepath}};
+    if (!file) {
+        std::println(stderr, "Failed to write benchmark results: {}", filepath);
+        return false;
+    }
+    file << nlohmann::json{{"benchmarks", std::move(benchmarks)}}.dump(4) << '\n';
+    return true;
+}
+
+} // namespace internal
+
+Benchmark &Benchmark::Range(const s64 first, const s64 last, const s64 multiplier)
+{
+    for (s64 argument = first; argument < last; argument *= multiplier) {
+        m_arguments.push_back(argument);
+    }
+    m_arguments.push_back(last);
+    return *this;
+}
+
+Benchmark &register_benchmark(StringView name, const BenchmarkFunction function)
+{
+    return internal::get_benchmarks().emplace_back(name, function);
+}
+
+int run_benchmarks(const int argc, char **argv)
+{
+    const std::optional<internal::RunOptions> options{internal::parse_options(argc, argv)};
+    if (!options) {
+        std::println("Usage: {} [--filter text] [--min-time seconds] [--repetitions n] [--output results.json]",
+                     argc > 0 ? argv[0] : "gouda_micro_bench");
+        return 2;
+    }
+
+    std::println("{:<48} {:>12} {:>12} {:>12} {:>12} {:>10}", "benchmark", "iterations", "median ns", "min ns",
+                 "max ns", "items");
+
+    std::vector<internal::RunResult> results;
+    for (const Benchmark &benchmark : internal::get_benchmarks()) {
+        if (!options->filter.empty() && !benchmark.GetName().contains(options->filter)) {
+            continue;
+        }
+
+        const std::vector<s64> &arguments{benchmark.GetArguments()};
+        const bool has_argument{!arguments.empty()};
+        for (size_t i = 0; i < std::max(arguments.size(), size_t{1}); ++i) {
+            const internal::RunResult &result{results.emplace_back(
+                internal::run_benchmark(benchmark, has_argument ? arguments[i] : 0, has_argument, *options))};
+            std::println("{:<48} {:>12} {:>12.1f} {:>12.1f} {:>12.1f} {:>10}", result.name, result.iterations,
+                         result.median_time, result.min_time, result.max_time,
+                         internal::format_rate(result.items_per_second));
+        }
+    }
+
+    if (!options->output_filepath.empty() && !internal::write_results(results, options->output_filepath)) {
+        return 1;
+    }
+    return 0;
+}
+
+} // namespace bench
@@ -0,0 +1,135 @@
+#pragma once
+/**
+ * @file micro_bench.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Micro benchmark harness
+ *
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <vector>
+
+#include "core/types.hpp"
+
+namespace bench {
+
+/**
+ * @class State
+ * @brief Handed to a benchmark function, which repeats its work while KeepRunning returns true.
+ *
+ * Only the loop is timed, setup before it and checks after it are not. Functions that spread the work over threads
+ * can read GetIterations instead and run that many iterations on each thread.
+ */
+class State {
+public:
+    State(const u64 iterations, const s64 argument)
+        : m_iterations{iterations}, m_remaining{iterations}, m_argument{argument}, m_items_processed{0}
+    {
+    }
+
+    [[nodiscard]] bool KeepRunning()
+    {
+        if (m_remaining == 0) {
+            return false;
+        }
+        --m_remaining;
+        return true;
+    }
+
+    [[nodiscard]] u64 GetIterations() const noexcept { return m_iterations; }
+    [[nodiscard]] s64 GetArgument() const noexcept { return m_argument; }
+
+    // Items are reported per second next to the time per iteration, such as elements pushed or numbers generated
+    void SetItemsProcessed(const u64 items) noexcept { m_items_processed = items; }
+    [[nodiscard]] u64 GetItemsProcessed() const noexcept { return m_items_processed; }
+
+private:
+    u64 m_iterations;
+    u64 m_remaining;
+    s64 m_argument;
+    u64 m_items_processed;
+};
+
+using BenchmarkFunction = void (*)(State &state);
+
+/**
+ * @class Benchmark
+ * @brief A registered function and the arguments it is run with, once for each.
+ */
+class Benchmark {
+public:
+    Benchmark(StringView name, BenchmarkFunction function) : m_name{name}, p_function{function} {}
+
+    Benchmark &Arg(const s64 argument)
+    {
+        m_arguments.push_back(argument);
+        return *this;
+    }
+
+    // Every power of multiplier from first up to last, plus last itself
+    Benchmark &Range(s64 first, s64 last, s64 multiplier = 8);
+
+    [[nodiscard]] StringView GetName() const noexcept { return m_name; }
+    [[nodiscard]] BenchmarkFunction GetFunction() const noexcept { return p_function; }
+    [[nodiscard]] const std::vector<s64> &GetArguments() const noexcept { return m_arguments; }
+
+private:
+    String m_name;
+    BenchmarkFunction p_function;
+    std::vector<s64> m_arguments; // Runs once without an argument when empty
+};
+
+/**
+ * @brief Adds a benchmark to the ones run_benchmarks runs, in registration order. Use MICRO_BENCHMARK.
+ */
+Benchmark &register_benchmark(StringView name, BenchmarkFunction function);
+
+/**
+ * @brief Runs the registered benchmarks and prints the median of several repetitions for each.
+ *
+ * Options: --filter text, only benchmarks whose name contains it; --min-time seconds, the shortest a timed run may
+ * take; --repetitions n; --output results.json.
+ *
+ * @return The process exit code.
+ */
+int run_benchmarks(int argc, char **argv);
+
+/**
+ * @brief Makes the compiler assume the value is read, so the work producing it is not optimized out.
+ */
+template <typename T>
+inline void do_not_optimize(const T &value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static_cast<void>(*reinterpret_cast<const volatile char *>(&value));
+#endif
+}
+
+/**
+ * @brief Makes the compiler assume all memory is read and written, so pending stores are not optimized out.
+ */
+inline void clobber_memory()
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : : "memory");
+#endif
+}
+
+} // namespace bench
+
+#define MICRO_BENCHMARK_CONCAT_IMPL(a, b) a##b
+#define MICRO_BENCHMARK_CONCAT(a, b) MICRO_BENCHMARK_CONCAT_IMPL(a, b)
+
+/**
+ * @brief Registers a benchmark function under a name, arguments are chained on: MICRO_BENCHMARK("x", fn).Arg(64);
+ * Template instances are passed as they are, the function is taken variadically so their commas do not split it.
+ */
+#define MICRO_BENCHMARK(name, ...)                                                                                     \
+    [[maybe_unused]] static bench::Benchmark &MICRO_BENCHMARK_CONCAT(micro_benchmark_, __LINE__) =                     \
+        bench::register_benchmark(name, __VA_ARGS__)
@@ -0,0 +1,571 @@
+/**
+ * @file renderer_bench.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Headless renderer benchmark
+ *
+ * Drives the Vulkan renderer through fixed synthetic scenes in a hidden window with V-Sync off, then reports the
+ * distributions of the CPU and GPU frame times and the device memory in use for each scene. Results can be written
+ * as JSON and compared against a previous run, the exit code is non zero when a scene's median got slower than the
+ * tolerance allows, so a CI job can fail on regressions.
+ *
+ * Usage: gouda_bench [--scene name]... [--count n] [--textures n] [--frames n] [--warmup n] [--width n] [--height n]
+ *                    [--output results.json] [--baseline baseline.json] [--tolerance fraction]
+ *
+ * Scenes: quads, lit_quads, static_quads, glyphs, cpu_particles, compute_particles. All of them run when none is
+ * given.
+ */
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <print>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "backends/glfw/glfw_window.hpp"
+#include "cameras/orthographic_camera.hpp"
+#include "debug/frame_statistics.hpp"
+#include "debug/logger.hpp"
+#include "renderers/particle_store.hpp"
+#include "renderers/vulkan/vk_renderer.hpp"
+
+#include "core/constants.hpp"
+
+namespace internal {
+
+enum class Scene : u8 { Quads, LitQuads, StaticQuads, Glyphs, CpuParticles, ComputeParticles };
+constexpr std::array<Scene, 6> ALL_SCENES{Scene::Quads,  Scene::LitQuads,     Scene::StaticQuads,
+                                          Scene::Glyphs, Scene::CpuParticles, Scene::ComputeParticles};
+
+constexpr std::array<StringView, 4> TEXTURE_FILEPATHS{
+    "assets/textures/checkerboard.png", "assets/textures/checkerboard2.png", "assets/textures/checkerboard3.png",
+    "assets/textures/checkerboard4.png"};
+
+constexpr std::array<gouda::FrameMetric, 2> REPORTED_METRICS{gouda::FrameMetric::CpuFrameTime,
+                                                           gouda::FrameMetric::GpuFrameTime};
+
+constexpr StringView GLYPH_LINE{"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwx"}; // 50 glyphs, no spaces
+constexpr f32 PARTICLE_LIFETIME{1.0e6f};                                             // Outlives any run
+constexpr u32 LIGHT_COUNT{512};                                                      // Of the lit quads scene
+
+struct BenchOptions {
+    std::vector<Scene> scenes;
+    u32 count{0}; // Instances per scene, zero for each scene's capacity
+    u32 texture_count{4};
+    u32 frame_count{1000};
+    u32 warmup_frame_count{100}; // Not sampled, covers pipeline warmup and the GPU timer's latency
+    WindowSize window_size{1280, 720};
+    String output_filepath;
+    String baseline_filepath;
+    f32 tolerance{0.1f}; // Allowed median slowdown against the baseline, as a fraction
+};
+
+struct SceneResult {
+    Scene scene;
+    u32 count;
+    u32 frame_count;
+    std::array<gouda::FrameMetricSummary, gouda::FRAME_METRIC_COUNT> summaries;
+    gouda::vk::MemoryStatistics memory;
+};
+
+static StringView scene_name(const Scene scene)
+{
+    switch (scene) {
+        case Scene::Quads:
+            return "quads";
+        case Scene::LitQuads:
+            return "lit_quads";
+        case Scene::StaticQuads:
+            return "static_quads";
+        case Scene::Glyphs:
+            return "glyphs";
+        case Scene::CpuParticles:
+            return "cpu_particles";
+        case Scene::ComputeParticles:
+            return "compute_particles";
+    }
+    return "unknown";
+}
+
+static std::optional<Scene> parse_scene(StringView name)
+{
+    for (const Scene scene : ALL_SCENES) {
+        if (scene_name(scene) == name) {
+            return scene;
+        }
+    }
+    return std::nullopt;
+}
+
+template <typename T>
+static bool parse_number(StringView text, T &value)
+{
+    const auto [end, error]{std::from_chars(text.data(), text.data() + text.size(), value)};
+    return error == std::errc{} && end == text.data() + text.size();
+}
+
+static void print_usage()
+{
+    std::println("Usage: gouda_bench [--scene name]... [--count n] [--textures n] [--frames n] [--warmup n]");
+    std::println("                   [--width n] [--height n] [--output results.json] [--baseline baseline.json]");
+    std::println("                   [--tolerance fraction]");
+    std::println("Scenes: quads, lit_quads, static_quads, glyphs, cpu_particles, compute_particles");
+}
+
+static std::optional<BenchOptions> parse_options(const int argc, char **argv)
+{
+    BenchOptions options;
+    for (int i = 1; i < argc; ++i) {
+        const StringView argument{argv[i]};
+        if (argument == "--help") {
+            return std::nullopt;
+        }
+        if (i + 1 >= argc) {
+            std::println(stderr, "Missing value for {}", argument);
+            return std::nullopt;
+        }
+
+        const StringView value{argv[++i]};
+        bool is_valid{true};
+        if (argument == "--scene") {
+            const std::optional<Scene> scene{parse_scene(value)};
+            is_valid = scene.has_value();
+            if (is_valid) {
+                options.scenes.push_back(*scene);
+            }
+        }
+        else if (argument == "--count") {
+            is_valid = parse_number(value, options.count);
+        }
+        else if (argument == "--textures") {
+            is_valid = parse_number(value, options.texture_count) && options.texture_count > 0;
+        }
+        else if (argument == "--frames") {
+            is_valid = parse_number(value, options.frame_count) && options.frame_count > 0;
+        }
+        else if (argument == "--warmup") {
+            is_valid = parse_number(value, options.warmup_frame_count);
+        }
+        else if (argument == "--width") {
+            is_valid = parse_number(value, options.window_size.width) && options.window_size.width > 0;
+        }
+        else if (argument == "--height") {
+            is_valid = parse_number(value, options.window_size.height) && options.window_size.height > 0;
+        }
+        else if (argument == "--output") {
+            options.output_filepath = value;
+        }
+        else if (argument == "--baseline") {
+            options.baseline_filepath = value;
+        }
+        else if (argument == "--tolerance") {
+            is_valid = parse_number(value, options.tolerance) && options.tolerance >= 0.0f;
+        }
+        else {
+            std::println(stderr, "Unknown option {}", argument);
+            return std::nullopt;
+        }
+
+        if (!is_valid) {
+            std::println(stderr, "Invalid value '{}' for {}", value, argument);
+            return std::nullopt;
+        }
+    }
+
+    if (options.scenes.empty()) {
+        options.scenes.assign(ALL_SCENES.begin(), ALL_SCENES.end());
+    }
+    return options;
+}
+
+/**
+ * @class RendererBench
+ * @brief Owns the hidden window and the renderer, and runs one scene at a time on them.
+ */
+class RendererBench {
+public:
+    explicit RendererBench(const BenchOptions &options) : m_options{options}
+    {
+        gouda::WindowConfig window_config{};
+        window_config.size = options.window_size;
+        window_config.title = "Gouda bench";
+        window_config.resizable = false;
+        window_config.visible = false;
+        window_config.vsync = false;
+        window_config.renderer = gouda::Renderer::Vulkan;
+        p_window = std::make_unique<gouda::glfw::Window>(window_config);
+
+        m_renderer.Initialize(p_window->GetWindow(), "Gouda bench", SemVer{1, 4, 0, 0}, gouda::vk::VSyncMode::Disabled);
+        m_renderer.SetupPipelines(filepath::quad_vertex_shader, filepath::quad_frag_shader,
+                                  filepath::particle_vertex_shader, filepath::particle_frag_shader,
+                                  filepath::particle_compute_shader, filepath::particle_emit_shader,
+                                  filepath::quad_cull_shader, filepath::light_cull_shader,
+                                  filepath::upscale_vertex_shader, filepath::upscale_frag_shader,
+                                  filepath::radix_histogram_shader, filepath::radix_scan_shader,
+                                  filepath::radix_scatter_shader, filepath::particle_gather_shader);
+
+        // Texture 0 is the default texture, the scenes cycle through the first texture_count ids
+        for (const StringView texture_filepath : TEXTURE_FILEPATHS) {
+            m_renderer.LoadSingleTexture(texture_filepath);
+        }
+        m_font_id = m_renderer.LoadMSDFFont(filepath::primary_font_atlas, filepath::primary_font_metadata);
+
+        m_framebuffer_size = m_renderer.GetFramebufferSize();
+        const auto width{static_cast<f32>(m_framebuffer_size.width)};
+        const auto height{static_cast<f32>(m_framebuffer_size.height)};
+        const gouda::OrthographicCamera camera{0.0f, width, height, 0.0f, -1.0f, 1.0f, 1.0f, 0.0f, 0.0f};
+        m_uniform_data.wvp = camera.GetViewProjectionMatrix();
+        m_uniform_data.wvp_static = m_uniform_data.wvp;
+    }
+
+    ~RendererBench() { m_renderer.DeviceWait(); }
+
+    RendererBench(const RendererBench &) = delete;
+    RendererBench &operator=(const RendererBench &) = delete;
+
+    SceneResult Run(const Scene scene)
+    {
+        const u32 count{GetSceneCount(scene)};
+        APP_LOG_INFO("Running bench scene '{}' with {} instances", scene_name(scene), count);
+
+        m_quads.clear();
+        m_particles.clear();
+        m_particle_store.Clear();
+        SetupScene(scene, count);
+
+        gouda::FrameStatistics statistics{m_options.frame_count};
+        const u32 total_frame_count{m_options.warmup_frame_count + m_options.frame_count};
+        SteadyClock::time_point previous_start{SteadyClock::now()};
+        for (u32 frame = 0; frame < total_frame_count; ++frame) {
+            const SteadyClock::time_point start{SteadyClock::now()};
+            const f32 delta_time{std::chrono::duration<f32>(start - previous_start).count()};
+            previous_start = start;
+
+            p_window->PollEvents();
+            UpdateScene(scene, count, frame, delta_time);
+            m_renderer.Render(delta_time, m_uniform_data, m_quads, m_particles);
+
+            if (frame >= m_options.warmup_frame_count) {
+                const gouda::vk::RenderStatistics render_statistics{m_renderer.GetRenderStatistics()};
+                const FloatingPointMilliseconds cpu_frame_time{SteadyClock::now() - start};
+                statistics.AddFrame({static_cast<f32>(cpu_frame_time.count()),
+                                     render_statistics.gpu_timings.frame_time, render_statistics.present_latency,
+                                     render_statistics.fence_wait_time});
+            }
+        }
+
+        SceneResult result{scene, count, m_options.frame_count, {}, m_renderer.GetRenderStatistics().memory};
+        for (size_t i = 0; i < gouda::FRAME_METRIC_COUNT; ++i) {
+            result.summaries[i] = statistics.GetSummary(static_cast<gouda::FrameMetric>(i));
+        }
+
+        TeardownScene(scene);
+        return result;
+    }
+
+private:
+    // Dynamic instances are bounded by the renderer's per frame buffers
+    u32 GetSceneCount(const Scene scene) const
+    {
+        u32 capacity{0};
+        switch (scene) {
+            case Scene::Quads:
+            case Scene::LitQuads:
+            case Scene::Glyphs: // Glyphs are drawn as quads
+                capacity = static_cast<u32>(m_renderer.GetMaxQuadInstances());
+                break;
+            case Scene::StaticQuads:
+                capacity = m_renderer.GetMaxStaticQuadInstances();
+                break;
+            case Scene::CpuParticles:
+            case Scene::ComputeParticles:
+                capacity = m_renderer.GetMaxParticleInstances();
+                break;
+        }
+
+        if (m_options.count > capacity) {
+            APP_LOG_WARNING("Bench scene '{}' holds at most {} instances, not {}", scene_name(scene), capacity,
+                            m_options.count);
+        }
+        return m_options.count == 0 ? capacity : std::min(m_options.count, capacity);
+    }
+
+    u32 GetTextureIndex(const u32 instance) const
+    {
+        const u32 texture_count{std::min(m_options.texture_count, m_renderer.GetTextureCount())};
+        return instance % std::max(texture_count, 1u);
+    }
+
+    // Instances are laid out on a grid covering the framebuffer, so every scene draws the same area
+    gouda::Vec3 GetGridPosition(const u32 instance, const u32 count) const
+    {
+        const auto columns{static_cast<u32>(std::ceil(std::sqrt(static_cast<f32>(count))))};
+        const f32 cell_width{static_cast<f32>(m_framebuffer_size.width) / static_cast<f32>(columns)};
+        const f32 cell_height{static_cast<f32>(m_framebuffer_size.height) / static_cast<f32>(columns)};
+        return {static_cast<f32>(instance % columns) * cell_width, static_cast<f32>(instance / columns) * cell_height,
+                -0.5f};
+    }
+
+    gouda::ParticleData MakeParticle(const u32 instance, const u32 count) const
+    {
+        const f32 angle{static_cast<f32>(instance) * 2.399963f}; // Golden angle, spreads the velocities evenly
+        return {GetGridPosition(instance, count),
+                {4.0f, 4.0f},
+                PARTICLE_LIFETIME,
+                {std::cos(angle) * 10.0f, std::sin(angle) * 10.0f, 0.0f},
+                {1.0f, 1.0f, 1.0f, 1.0f},
+                GetTextureIndex(instance)};
+    }
+
+    void SetupScene(const Scene scene, const u32 count)
+    {
+        switch (scene) {
+            case Scene::Quads:
+            case Scene::LitQuads:
+            case Scene::Glyphs:
+                break;
+            case Scene::StaticQuads: {
+                std::vector<gouda::InstanceData> instances;
+                instances.reserve(count);
+                for (u32 i = 0; i < count; ++i) {
+                    instances.emplace_back(GetGridPosition(i, count), gouda::Vec2{8.0f, 8.0f}, 0.0f,
+                                           GetTextureIndex(i));
+                }
+                m_renderer.SetStaticQuadInstances(instances);
+                break;
+            }
+            case Scene::CpuParticles:
+                m_particle_store.Reserve(count);
+                for (u32 i = 0; i < count; ++i) {
+                    m_particle_store.Spawn(MakeParticle(i, count));
+                }
+                break;
+            case Scene::ComputeParticles: {
+                if (!m_renderer.UseComputeParticles()) {
+                    m_renderer.ToggleComputeParticles();
+                }
+                std::vector<gouda::ParticleData> particles;
+                particles.reserve(count);
+                for (u32 i = 0; i < count; ++i) {
+                    particles.push_back(MakeParticle(i, count));
+                }
+                m_renderer.EmitParticles(particles); // Uploaded over the first frames, within the warmup
+                break;
+            }
+        }
+    }
+
+    // Rebuilds the frame's dynamic instances, the CPU cost a game would pay for the same content
+    void UpdateScene(const Scene scene, const u32 count, const u32 frame, const f32 delta_time)
+    {
+        switch (scene) {
+            case Scene::Quads:
+            case Scene::LitQuads: {
+                m_quads.clear();
+                const f32 rotation{static_cast<f32>(frame) * 0.01f};
+                for (u32 i = 0; i < count; ++i) {
+                    m_quads.emplace_back(GetGridPosition(i, count), gouda::Vec2{8.0f, 8.0f}, rotation,
+                                         GetTextureIndex(i));
+                }
+                if (scene == Scene::LitQuads) {
+                    UpdateLights(frame);
+                }
+                break;
+            }
+            case Scene::Glyphs: {
+                m_quads.clear();
+                const auto line_count{static_cast<u32>((count + GLYPH_LINE.size() - 1) / GLYPH_LINE.size())};
+                for (u32 line = 0; line < line_count; ++line) {
+                    const size_t glyph_count{std::min(GLYPH_LINE.size(), count - line * GLYPH_LINE.size())};
+                    const gouda::Vec3 position{0.0f, static_cast<f32>(line) * 24.0f, -0.4f};
+                    m_renderer.DrawText(GLYPH_LINE.substr(0, glyph_count), position, {1.0f, 1.0f, 1.0f, 1.0f}, 20.0f,
+                                        m_font_id, m_quads);
+                }
+                break;
+            }
+            case Scene::CpuParticles:
+                m_particle_store.Update(delta_time, gouda::Vec3{0.0f});
+                m_particle_store.WriteRenderData(m_particles);
+                break;
+            case Scene::StaticQuads:
+            case Scene::ComputeParticles:
+                break;
+        }
+    }
+
+    // Lights circle their own spot on the grid, handed over every frame like a game moving torches and projectiles
+    void UpdateLights(const u32 frame)
+    {
+        m_lights.clear();
+        const f32 angle{static_cast<f32>(frame) * 0.02f};
+        const f32 radius{static_cast<f32>(m_framebuffer_size.width) * 0.05f};
+        for (u32 i = 0; i < LIGHT_COUNT; ++i) {
+            const gouda::Vec3 centre{GetGridPosition(i, LIGHT_COUNT)};
+            const f32 light_angle{angle + static_cast<f32>(i) * 2.399963f}; // Golden angle
+            m_lights.emplace_back(gouda::Vec2{centre.x + std::cos(light_angle) * radius,
+                                              centre.y + std::sin(light_angle) * radius},
+                                  radius * 2.0f, gouda::Colour<f32>{1.0f, 0.8f, 0.5f, 1.0f});
+        }
+        m_renderer.SetLights(m_lights);
+    }
+
+    void TeardownScene(const Scene scene)
+    {
+        switch (scene) {
+            case Scene::StaticQuads:
+                m_renderer.SetStaticQuadInstances({});
+                break;
+            case Scene::ComputeParticles:
+                m_renderer.ToggleComputeParticles(); // Back to the CPU path for the scenes after it
+                break;
+            case Scene::LitQuads:
+                m_renderer.SetLights({});
+                break;
+            case Scene::Quads:
+            case Scene::Glyphs:
+            case Scene::CpuParticles:
+                break;
+        }
+        m_renderer.DeviceWait();
+    }
+
+private:
+    const BenchOptions &m_options;
+    std::unique_ptr<gouda::glfw::Window> p_window; // Outlives the renderer's surface
+    gouda::vk::Renderer m_renderer;
+    FrameBufferSize m_framebuffer_size;
+    gouda::UniformData m_uniform_data;
+    u32 m_font_id{0};
+
+    std::vector<gouda::InstanceData> m_quads;
+    std::vector<gouda::ParticleData> m_particles;
+    std::vector<gouda::PointLight> m_lights;
+    gouda::ParticleStore m_particle_store;
+};
+
+static nlohmann::json summary_to_json(const gouda::FrameMetricSummary &summary)
+{
+    return nlohmann::json{{"p50", summary.p50},   {"p95", summary.p95},   {"p99", summary.p99},
+                          {"max", summary.max},   {"mean", summary.mean}, {"hitches", summary.hitch_count}};
+}
+
+static nlohmann::json results_to_json(const std::vector<SceneResult> &results)
+{
+    nlohmann::json scenes = nlohmann::json::object();
+    for (const SceneResult &result : results) {
+        nlohmann::json scene{{"count", result.count},
+                             {"frames", result.frame_count},
+                             {"memory_used_bytes", result.memory.used_bytes},
+                             {"memory_reserved_bytes", result.memory.reserved_bytes},
+                             {"memory_blocks", result.memory.block_count}};
+        for (size_t i = 0; i < gouda::FRAME_METRIC_COUNT; ++i) {
+            const auto metric{static_cast<gouda::FrameMetric>(i)};
+            scene[String{gouda::FrameStatistics::GetMetricName(metric)}] = summary_to_json(result.summaries[i]);
+        }
+        scenes[String{scene_name(result.scene)}] = std::move(scene);
+    }
+    return nlohmann::json{{"scenes", std::move(scenes)}};
+}
+
+static void print_results(const std::vector<SceneResult> &results)
+{
+    std::println("{:<18} {:>8} {:<16} {:>8} {:>8} {:>8} {:>8} {:>8} {:>10}", "scene", "count", "metric", "p50",
+                 "p95", "p99", "max", "mean", "memory");
+    for (const SceneResult &result : results) {
+        for (const gouda::FrameMetric metric : REPORTED_METRICS) {
+            const gouda::FrameMetricSummary &summary{result.summaries[static_cast<size_t>(metric)]};
+            std::println("{:<18} {:>8} {:<16} {:>8.3f} {:>8.3f} {:>8.3f} {:>8.3f} {:>8.3f} {:>7.1f}MiB",
+                         scene_name(result.scene), result.count, gouda::FrameStatistics::GetMetricName(metric),
+                         summary.p50, summary.p95, summary.p99, summary.max, summary.mean,
+                         static_cast<f64>(result.memory.used_bytes) / (1024.0 * 1024.0));
+        }
+    }
+}
+
+// Compares the medians of every scene found in both runs, scenes with a different instance count are skipped
+static bool check_baseline(const std::vector<SceneResult> &results, const BenchOptions &options)
+{
+    std::ifstream baseline_file{options.baseline_filepath};
+    if (!baseline_file) {
+        APP_LOG_ERROR("Failed to open bench baseline: {}", options.baseline_filepath);
+        return false;
+    }
+
+    const nlohmann::json baseline{nlohmann::json::parse(baseline_file, nullptr, false)};
+    if (baseline.is_discarded() || !baseline.contains("scenes")) {
+        APP_LOG_ERROR("Invalid bench baseline: {}", options.baseline_filepath);
+        return false;
+    }
+
+    bool passed{true};
+    for (const SceneResult &result : results) {
+        const String name{scene_name(result.scene)};
+        if (!baseline["scenes"].contains(name)) {
+            continue;
+        }
+
+        const nlohmann::json &baseline_scene{baseline["scenes"][name]};
+        if (baseline_scene.value("count", 0u) != result.count) {
+            std::println("{}: baseline has {} instances, not compared", name, baseline_scene.value("count", 0u));
+            continue;
+        }
+
+        for (const gouda::FrameMetric metric : REPORTED_METRICS) {
+            const String metric_name{gouda::FrameStatistics::GetMetricName(metric)};
+            const f32 baseline_p50{baseline_scene.contains(metric_name) ? baseline_scene[metric_name].value("p50", 0.0f)
+                                                                         : 0.0f};
+            const f32 p50{result.summaries[static_cast<size_t>(metric)].p50};
+            if (baseline_p50 <= 0.0f || p50 <= 0.0f) {
+                continue; // No GPU timings on devices without timestamp support
+            }
+
+            const f32 change{p50 / baseline_p50 - 1.0f};
+            const bool regressed{change > options.tolerance};
+            std::println("{}: {} p50 {:.3f} ms against {:.3f} ms ({:+.1f}%){}", name, metric_name, p50, baseline_p50,
+                         change * 100.0f, regressed ? ", REGRESSED" : "");
+            passed = passed && !regressed;
+        }
+    }
+    return passed;
+}
+
+} // namespace internal
+
+int main(const int argc, char **argv)
+{
+    const std::optional<internal::BenchOptions> options{internal::parse_options(argc, argv)};
+    if (!options) {
+        internal::print_usage();
+        return 2;
+    }
+
+    std::vector<internal::SceneResult> results;
+    {
+        internal::RendererBench bench{*options};
+        for (const internal::Scene scene : options->scenes) {
+            results.push_back(bench.Run(scene));
+        }
+    }
+
+    internal::print_results(results);
+
+    if (!options->output_filepath.empty()) {
+        std::ofstream output_file{options->output_filepath};
+        if (!output_file) {
+            APP_LOG_ERROR("Failed to write bench results: {}", options->output_filepath);
+            return 1;
+        }
+        output_file << internal::results_to_json(results).dump(4) << '\n';
+    }
+
+    if (!options->baseline_filepath.empty() && !internal::check_baseline(results, *options)) {
+        return 1;
+    }
+    return 0;
+}
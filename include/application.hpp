@@ -12,14 +12,25 @@
  * See <https://www.gnu.org/licenses/> for more information.
  */
 #include "audio/audio_manager.hpp"
+#include "audio/sound_bank.hpp"
 #include "backends/common.hpp"
 #include "backends/glfw/glfw_window.hpp"
 #include "backends/input_handler.hpp"
 #include "cameras/orthographic_camera.hpp"
+#include "debug/frame_statistics.hpp"
 #include "renderers/render_data.hpp"
 #include "renderers/vulkan/vk_renderer.hpp"
+#include "utils/asset_registry.hpp"
+#include "utils/event_bus.hpp"
+#include "utils/frame_pacer.hpp"
+#include "utils/job_system.hpp"
+#include "utils/quality_governor.hpp"
 #include "utils/timer.hpp"
+#include "utils/tween_system.hpp"
 
+#include "core/frame_draw_list.hpp"
+#include "core/headless_simulation.hpp"
+#include "core/render_thread.hpp"
 #include "core/settings_manager.hpp"
 #include "core/state_stack.hpp"
 
@@ -29,71 +40,110 @@ struct TimeSettings {
         : time_scale{1.0f},
           fixed_timestep{1.0f / 60.0f},
           max_accumulator{0.25f},
+          max_updates_per_frame{gouda::utils::FixedTimer::DEFAULT_MAX_STEPS},
           target_fps{144.0f},
-          vsync_mode{gouda::vk::VSyncMode::Enabled}
+          background_fps{15.0f},
+          vsync_mode{gouda::vk::VSyncMode::Enabled},
+          idle_frame_skipping{true},
+          pipelined_rendering{false}
     {
     }
 
     f32 time_scale;                  // Game speed modifier
     f32 fixed_timestep;              // Physics update rate
     f32 max_accumulator;             // Prevents physics explosion
+    u32 max_updates_per_frame;       // Fixed updates a frame may catch up with, the rest of the time is dropped
     f32 target_fps;                  // FPS limit (ignored if V-Sync is enabled)
+    f32 background_fps;              // FPS limit while unfocused, 0 keeps the full rate
     gouda::vk::VSyncMode vsync_mode; // Default to normal V-Sync
+    bool idle_frame_skipping;        // Frames nothing on screen changes in are not drawn
+    bool pipelined_rendering;        // Frames are drawn on a render thread while the next one is simulated
+};
+
+/**
+ * @struct LaunchOptions
+ * @brief Set from the command line.
+ */
+struct LaunchOptions {
+    String record_filepath;   // Records the session's input here, written on exit
+    String replay_filepath;   // Replays a recording instead of the live input, then exits
+    HeadlessOptions headless; // Simulates without a window instead when its tick count is set
 };
 
 class Application {
 public:
-    Application();
+    explicit Application(const LaunchOptions &options = {});
     ~Application();
 
     void Run();
 
 private:
     void Update(f32 delta_time);
+    void BuildFramePacket(f32 delta_time); // Pipelined, the next Run iteration submits it
+    void EndRenderedFrame(f32 frame_time, gouda::utils::FramePacer &frame_pacer); // Statistics and pacing
+    void ApplyQualitySettings(const gouda::utils::QualitySettings &quality);
+    [[nodiscard]] bool ShouldRenderFrame(SteadyClock::time_point now, bool is_replaying) const;
+    void WaitForRedraw(SteadyClock::time_point now) const; // Blocks on window events until a frame may be drawn
     void SetupTimerSettings(const ApplicationSettings &settings);
+    void SetupFramePacing(gouda::utils::FramePacer &frame_pacer);
     void SetupWindow(const ApplicationSettings &settings);
-    void SetupRenderer();
+    void SetupRenderer(const ApplicationSettings &settings);
     void SetupAudio(const ApplicationSettings &settings);
+    void LoadAudio(); // Main thread, the asset registry is not shared with the audio setup's worker
     void SetupCamera();
     void SetCameraProjections(const gouda::Vec2 &framebuffer_size) const;
-    void LoadTextures() const;
+    void LoadTextures();
     void LoadFonts();
     void CreateSharedContext();
     void LoadInitialState();
     void SetupInputSystem();
+    void SetupInputCapture();
+    void FinishReplay();
 
     void OnFramebufferResize(GLFWwindow *window, FrameBufferSize new_size);
     void OnWindowResize(GLFWwindow *window, WindowSize new_size);
     void OnWindowIconify(GLFWwindow *window, bool iconified);
 
 private:
+    LaunchOptions m_launch_options;
+    std::unique_ptr<gouda::JobSystem> p_job_system; // First in, last out, everything else may still hold jobs
     std::unique_ptr<gouda::glfw::Window> p_window;
     std::unique_ptr<gouda::InputHandler> p_input_handler;
     SettingsManager m_settings_manager;
     gouda::vk::Renderer m_renderer;
+    std::unique_ptr<RenderThread> p_render_thread; // Pipelined rendering only, stops before the renderer goes
+    FramePacket m_frame_packet;                    // Built after a frame's simulation, drawn during the next one
+    bool m_is_packet_pending;                      // Built and not yet submitted
+    bool m_is_packet_submitted;                    // Being drawn by the render thread
 
     std::unique_ptr<SharedContext> p_context;
     std::unique_ptr<StateStack> p_state_stack;
 
     bool m_is_iconified;
+    bool m_is_focused;
+    bool m_redraw_requested;                    // By changes the states cannot see, resizes, focus and stack changes
+    SteadyClock::time_point m_last_render_time; // Of the last frame drawn
     FrameBufferSize m_framebuffer_size;
 
     TimeSettings m_time_settings;
 
     std::unique_ptr<gouda::OrthographicCamera> p_scene_camera;
     std::unique_ptr<gouda::OrthographicCamera> p_ui_camera;
+    u64 m_scene_camera_version; // Camera versions m_uniform_data was last built from
+    u64 m_ui_camera_version;
 
     gouda::UniformData m_uniform_data;
+    gouda::FrameStatistics m_frame_statistics;
+    gouda::utils::QualityGovernor m_quality_governor; // Off unless enabled in the settings
+    f32 m_render_scale;                              // The one the user chose, the governor's scale applies to it
+    gouda::EventBus m_event_bus; // Gameplay events, the states unsubscribe before the stack is reset
+    gouda::TweenSystem m_tweens; // UI and camera easing, the states remove theirs before the stack is reset
 
     gouda::audio::AudioManager m_audio_manager;
-    gouda::audio::SoundEffect m_laser_1;
-    gouda::audio::SoundEffect m_laser_2;
-    gouda::audio::MusicTrack m_music;
-    gouda::audio::MusicTrack m_music2;
-    gouda::audio::MusicTrack m_music3;
-    gouda::audio::MusicTrack m_music4;
-    gouda::audio::MusicTrack m_music5;
-    gouda::audio::MusicTrack m_music6;
+    gouda::audio::SoundBank m_sound_bank; // After the audio manager, its buffers go before the context does
+    gouda::AssetRegistry m_asset_registry; // Owns the music tracks, so it goes before the audio manager as well
+    gouda::SoundHandle m_laser_1;
+    gouda::SoundHandle m_laser_2;
 
     // std::unique_ptr<Scene> p_current_scene;
 };
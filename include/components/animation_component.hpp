@@ -11,31 +11,110 @@
  * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
  * See <https://www.gnu.org/licenses/> for more information.
  */
-#include <unordered_map>
+#include <span>
 
+#include "containers/flat_hash_map.hpp"
 #include "containers/small_vector.hpp"
 #include "core/types.hpp"
 #include "renderers/render_data.hpp"
+#include "utils/string_id.hpp"
 
-struct Animation {
-    String name;
-    gouda::Vector<UVRect<f32>> frames{};  // List of UV rects
-    gouda::Vector<f32> frame_durations{}; // Seconds per frame
-    bool looping{true};
+using AnimationClipID = u32;
+inline constexpr AnimationClipID INVALID_ANIMATION_CLIP{constants::u32_max};
 
-    constexpr Animation() = default;
-    Animation(StringView name, gouda::Vector<UVRect<f32>> frames,
-              const gouda::Vector<f32> &frame_durations,
-              bool looping);
+/**
+ * @struct AnimationClip
+ * @brief A run of frames in the library's frame arrays.
+ */
+struct AnimationClip {
+    u32 first_frame;
+    u32 frame_count;
+    f32 duration;              // Seconds for one pass through the frames
+    AnimationClipID next_clip; // Played once a clip that does not loop ends, or INVALID to hold the last frame
+    bool looping;
 };
 
+/**
+ * @class AnimationLibrary
+ * @brief Clips shared by every animated entity, with their names interned to ids.
+ *
+ * Names are only looked up when a clip is chosen, updates index the clip and frame arrays directly. Frames of all
+ * clips sit back to back in two arrays, the rects and the time each frame ends at within its clip, so advancing an
+ * entity reads one clip and walks forward from its current frame.
+ */
+class AnimationLibrary {
+public:
+    AnimationLibrary() = default;
+
+    /**
+     * @brief Adds a clip, replacing the frames of a clip with the same name.
+     * @param frame_durations Seconds per frame, one per frame.
+     * @return The clip's id, or INVALID_ANIMATION_CLIP if the frames are empty or do not match the durations.
+     */
+    AnimationClipID AddClip(StringView name, std::span<const UVRect<f32>> frames, std::span<const f32> frame_durations,
+                            bool looping);
+
+    /**
+     * @brief Plays next once the clip ends, for clips that do not loop.
+     */
+    void SetNextClip(AnimationClipID clip, AnimationClipID next);
+
+    /**
+     * @param name Hashed clip name, a literal is hashed at compile time.
+     * @return The clip's id, or INVALID_ANIMATION_CLIP if there is none with that name.
+     */
+    [[nodiscard]] AnimationClipID FindClip(gouda::StringId name) const;
+
+    [[nodiscard]] const AnimationClip &GetClip(const AnimationClipID clip) const { return m_clips[clip]; }
+    [[nodiscard]] StringView GetClipName(const AnimationClipID clip) const { return m_clip_names[clip]; }
+    [[nodiscard]] const UVRect<f32> &GetFrameRect(const u32 frame) const { return m_frame_rects[frame]; }
+    [[nodiscard]] f32 GetFrameEnd(const u32 frame) const { return m_frame_ends[frame]; }
+    [[nodiscard]] size_t GetClipCount() const noexcept { return m_clips.size(); }
+    [[nodiscard]] u64 GetVersion() const noexcept { return m_version; } ///< Changes whenever a clip does
+
+    /**
+     * @brief Writes the clips in the layout of the renderer's animation tables, clip ids stay the same.
+     */
+    void WriteGpuTables(gouda::Vector<gouda::AnimationClipData> &clips,
+                        gouda::Vector<gouda::AnimationFrameData> &frames) const;
+
+    void Clear();
+
+private:
+    gouda::Vector<AnimationClip> m_clips;
+    gouda::Vector<String> m_clip_names;
+    gouda::FlatHashMap<gouda::StringId, AnimationClipID> m_clip_ids;
+
+    gouda::Vector<UVRect<f32>> m_frame_rects;
+    gouda::Vector<f32> m_frame_ends; // Seconds from the start of the clip to the end of each frame
+    u64 m_version{0};
+};
+
+/**
+ * @struct AnimationComponent
+ * @brief The clip an entity plays and how far through it the entity is.
+ *
+ * Looping clips can be handed to the quad vertex shader, which evaluates them from start_time. The time and frame
+ * are not advanced while on_gpu is set.
+ */
 struct AnimationComponent {
-    String current_animation{};
-    f32 animation_time{0.0f};
-    int current_frame{0};
-    std::unordered_map<String, Animation> animations{};
+    AnimationClipID clip{INVALID_ANIMATION_CLIP};
+    f32 time{0.0f};
+    u32 frame{0};         // Within the clip
+    f32 start_time{0.0f}; // In the scene's animation clock, when the clip started playing
+    bool on_gpu{false};
 
     constexpr AnimationComponent() = default;
+    constexpr explicit AnimationComponent(const AnimationClipID clip_) : clip{clip_} {}
+
+    /**
+     * @brief Switches clips, starting from the first frame. Playing the current clip again does nothing.
+     */
+    void Play(AnimationClipID next_clip);
 
-    void Update(f32 delta_time, gouda::InstanceData &render_data);
+    /**
+     * @brief Advances the clip and writes the frame's rect, non atlas textures always get the full texture.
+     */
+    void Update(f32 delta_time, const AnimationLibrary &library, UVRect<f32> &sprite_rect, bool is_atlas);
+    void Update(f32 delta_time, const AnimationLibrary &library, gouda::InstanceData &render_data);
 };
@@ -12,9 +12,11 @@
  * See <https://www.gnu.org/licenses/> for more information.
  */
 #include "core/types.hpp"
+#include "utils/string_id.hpp"
 
 namespace filepath {
 constexpr StringView application_icon{"assets/textures/gouda_icon.png"};
+constexpr StringView asset_archive{"assets.gpak"}; // Mounted over the loose assets when present
 
 // Textures
 constexpr StringView texture_atlas{"assets/textures/sprite_sheet.png"};
@@ -23,19 +25,33 @@ constexpr StringView texture_atlas_metadata{"assets/textures/sprite_sheet.json"}
 // Shaders
 constexpr StringView quad_vertex_shader{"assets/shaders/compiled/quad_shader.vert.spv"};
 constexpr StringView quad_frag_shader{"assets/shaders/compiled/quad_shader.frag.spv"};
-constexpr StringView text_vertex_shader{"assets/shaders/compiled/text_shader.vert.spv"};
-constexpr StringView text_frag_shader{"assets/shaders/compiled/text_shader.frag.spv"};
 constexpr StringView particle_vertex_shader{"assets/shaders/compiled/particle_shader.vert.spv"};
 constexpr StringView particle_frag_shader{"assets/shaders/compiled/particle_shader.frag.spv"};
 constexpr StringView particle_compute_shader{"assets/shaders/compiled/particle_shader.comp.spv"};
+constexpr StringView particle_emit_shader{"assets/shaders/compiled/particle_emit.comp.spv"};
+constexpr StringView quad_cull_shader{"assets/shaders/compiled/quad_cull.comp.spv"};
+constexpr StringView light_cull_shader{"assets/shaders/compiled/light_cull.comp.spv"};
+constexpr StringView radix_histogram_shader{"assets/shaders/compiled/radix_histogram.comp.spv"};
+constexpr StringView radix_scan_shader{"assets/shaders/compiled/radix_scan.comp.spv"};
+constexpr StringView radix_scatter_shader{"assets/shaders/compiled/radix_scatter.comp.spv"};
+constexpr StringView particle_gather_shader{"assets/shaders/compiled/particle_gather.comp.spv"};
+constexpr StringView upscale_vertex_shader{"assets/shaders/compiled/upscale_shader.vert.spv"};
+constexpr StringView upscale_frag_shader{"assets/shaders/compiled/upscale_shader.frag.spv"};
 
 // Fonts
 constexpr StringView primary_font_atlas{"assets/fonts/firacode_atlas.png"};
 constexpr StringView primary_font_metadata{"assets/fonts/firacode_atlas.json"};
 constexpr StringView secondary_font_atlas{"assets/fonts/roboto_atlas.png"};
 constexpr StringView secondary_font_metadata{"assets/fonts/roboto_atlas.json"};
+constexpr StringView primary_font_source{"assets/fonts/src/FiraCode.ttf"};
+constexpr StringView secondary_font_source{"assets/fonts/src/Roboto.ttf"};
 
 // Sounds
+
+// Debug
+constexpr StringView frame_statistics_directory{"debug/frame_statistics"};
+constexpr StringView screenshot_directory{"debug/screenshots"};
+constexpr StringView frame_capture_directory{"debug/captures"};
 } // namespace filepath
 
 namespace colours {
@@ -45,6 +61,9 @@ constexpr  gouda::Colour<f32> editor_panel_colour{0.1f, 0.1f, 0.1f, 1.0f};
 constexpr  gouda::Colour<f32> editor_panel_primary_font_colour{0.4f, 0.3f, 0.7f, 1.0f};
 constexpr  gouda::Colour<f32> editor_panel_secondary_font_colour{0.4f, 0.3f, 0.7f, 1.0f};
 constexpr  gouda::Colour<f32> editor_entity_selection_colour{0.3f, 0.9f, 0.3f, 1.0f};
+constexpr  gouda::Colour<f32> editor_grid_colour{0.6f, 0.6f, 0.6f, 0.35f};
+constexpr  gouda::Colour<f32> editor_x_axis_colour{0.9f, 0.3f, 0.3f, 0.8f};
+constexpr  gouda::Colour<f32> editor_y_axis_colour{0.3f, 0.5f, 0.9f, 0.8f};
 } // namespace colour
 
 // TODO: Move all constants here
@@ -52,5 +71,22 @@ namespace app_constants {
 constexpr u32 max_quads{1000};
 constexpr u32 max_particles{1000};
 constexpr u32 max_glyphs{1000};
+constexpr f32 editor_auto_save_interval{5.0f}; // Seconds, a save only writes the entities changed since the last
+constexpr size_t editor_undo_memory_budget{16 * constants::mb}; // Per scene, the oldest undo steps go beyond it
+constexpr f32 editor_grid_cell_size{32.0f};   // World units
+constexpr u32 editor_grid_major_interval{8}; // Cells between the brighter lines
+// Seconds an idle screen goes undrawn at most, so texture loads and hot reloads finish and timers still show
+constexpr f64 idle_redraw_interval{0.25};
 
 } // namespace app_constants
+
+// Hashed at compile time. Written once here, a misspelt constant fails to compile where a misspelt name would only
+// fail its lookup at run time.
+namespace sprite_ids {
+constexpr gouda::StringId player_walk{"player.walk"};
+} // namespace sprite_ids
+
+namespace animation_ids {
+constexpr gouda::StringId player_walk{"player.walk"};
+constexpr gouda::StringId player_idle{"player.idle"};
+} // namespace animation_ids
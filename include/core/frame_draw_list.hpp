@@ -0,0 +1,46 @@
+#pragma once
+/**
+ * @file core/frame_draw_list.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Application per frame draw list module
+ *
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <vector>
+
+#include "renderers/render_data.hpp"
+
+/**
+ * @struct FrameDrawList
+ * @brief Everything the visible states draw in a frame, handed to the renderer in one submission by the state stack.
+ *
+ * States append bottom of the stack first, so within each kind of instance an overlay follows, and draws over, the
+ * state under it. Text is laid out into the quads, after the panels it is drawn on. The lists keep their capacity
+ * from one frame to the next.
+ */
+struct FrameDrawList {
+    std::vector<gouda::InstanceData> quad_instances;
+    std::vector<gouda::ParticleData> particle_instances;
+
+    void Clear()
+    {
+        quad_instances.clear();
+        particle_instances.clear();
+    }
+};
+
+/**
+ * @struct FramePacket
+ * @brief A frame as the simulation left it, what the render thread draws while the next frame is simulated. Nothing
+ * writes to a packet between handing it to the render thread and that thread finishing it.
+ */
+struct FramePacket {
+    FrameDrawList draw_list;
+    gouda::UniformData uniform_data; // Both cameras, as of when the packet was built
+    f32 delta_time;
+};
@@ -0,0 +1,68 @@
+#pragma once
+/**
+ * @file core/headless_simulation.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Application headless simulation module
+ *
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <memory>
+
+#include "cameras/orthographic_camera.hpp"
+#include "containers/small_vector.hpp"
+#include "core/types.hpp"
+
+class Scene;
+
+/**
+ * @struct HeadlessOptions
+ * @brief Set from the command line, a tick count above zero runs headless instead of opening a window.
+ */
+struct HeadlessOptions {
+    u32 tick_count{0};
+    u32 entity_count{1000};     // Moving entities added on top of the level, they bounce around its area
+    u32 particles_per_tick{16}; // Simulated on the CPU
+    u16 update_rate{60};        // Fixed updates per second of simulated time, the ticks themselves are uncapped
+    String level_filepath;      // Loaded before the entities are added when set
+};
+
+/**
+ * @class HeadlessSimulation
+ * @brief Runs a scene's fixed updates back to back without a window, renderer or audio, then reports how many ticks a
+ * second it managed.
+ *
+ * For measuring how the simulation scales with entities, collisions and CPU particles on machines without a GPU, CI
+ * runners and dedicated servers. The scene gets no texture manager, asset registry or audio manager, so it neither
+ * draws nor plays anything, and the particles it spawns are handed to its CPU path after every tick. The states are
+ * not run, they draw through the renderer, as does the editor.
+ */
+class HeadlessSimulation {
+public:
+    explicit HeadlessSimulation(const HeadlessOptions &options);
+    ~HeadlessSimulation();
+
+    /**
+     * @brief Runs every tick as fast as it can and logs the throughput.
+     * @return The process exit code, nonzero if the level could not be loaded.
+     */
+    int Run();
+
+private:
+    void AddMovingEntities();
+    void MoveEntities(f32 delta_time);
+    void SpawnParticles(u32 tick);
+
+private:
+    HeadlessOptions m_options;
+    gouda::OrthographicCamera m_scene_camera;
+    gouda::OrthographicCamera m_ui_camera;
+    std::unique_ptr<Scene> p_scene;
+
+    gouda::Vector<size_t> m_moving_entities;
+    gouda::Vector<gouda::Vec2> m_velocities; // Of m_moving_entities, in order
+};
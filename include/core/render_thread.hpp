@@ -0,0 +1,57 @@
+#pragma once
+/**
+ * @file core/render_thread.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Application render thread module
+ *
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include "renderers/vulkan/vk_renderer.hpp"
+
+#include "core/frame_draw_list.hpp"
+
+/**
+ * @class RenderThread
+ * @brief Records and submits frame packets on a thread of its own, so the main thread can simulate the next frame
+ * meanwhile. One packet is in flight at a time.
+ *
+ * The renderer belongs to the render thread from Submit until Wait returns. The main thread keeps everything else,
+ * GLFW included, and only calls into the renderer in between, the debug UI is built there with BuildDebugUI.
+ */
+class RenderThread {
+public:
+    explicit RenderThread(gouda::vk::Renderer &renderer);
+    ~RenderThread(); // Lets a submitted packet finish
+
+    RenderThread(const RenderThread &) = delete;
+    RenderThread &operator=(const RenderThread &) = delete;
+
+    // The packet is drawn by reference, it must be left alone until Wait returns
+    void Submit(const FramePacket &packet);
+
+    // Blocks until the submitted packet is drawn, rethrows what drawing it threw
+    void Wait();
+
+private:
+    void Run(const std::stop_token &stop_token);
+
+private:
+    gouda::vk::Renderer &m_renderer;
+
+    std::mutex m_mutex;
+    std::condition_variable_any m_condition;
+    const FramePacket *p_packet; // Until it is drawn
+    std::exception_ptr m_exception;
+
+    std::jthread m_thread; // Last, started once the rest is set up
+};
@@ -12,7 +12,14 @@
  * See <https://www.gnu.org/licenses/> for more information.
  */
 
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <thread>
+
 #include "core/types.hpp"
+#include "utils/thread.hpp"
 
 #include <nlohmann/json.hpp>
 
@@ -26,11 +33,25 @@ struct ApplicationAudioSettings {
 struct ApplicationSettings {
     WindowSize size;
     u16 refresh_rate;
+    u16 update_rate; // Fixed updates per second, independent of the refresh rate since rendering interpolates
     bool fullscreen;
     bool vsync;
+    String gpu; // Picks the GPU whose name contains it, empty lets the renderer pick the best one
+    f32 render_scale;          // Of the world against the framebuffer, 1 renders it natively
+    bool dynamic_render_scale; // Lowers the scale below render_scale while the GPU cannot keep the refresh rate
+    bool quality_governor;     // Lowers resolution, particles, lights and animation rate to keep the refresh rate
+    bool idle_frame_skipping;  // Skips drawing frames in which nothing on screen would change
+    u16 background_frame_rate; // Frames drawn per second while the window is unfocused, 0 keeps the full rate
+    bool pipelined_rendering;  // Records and submits each frame on a render thread while the next one is simulated
     ApplicationAudioSettings audio_settings;
+    gouda::ThreadSettings thread_settings; // Affinity masks per thread class, stored by class name
 
-    ApplicationSettings() : size{800, 800}, refresh_rate{60}, fullscreen{false}, vsync{false} {}
+    ApplicationSettings()
+        : size{800, 800}, refresh_rate{60}, update_rate{60}, fullscreen{false}, vsync{false}, render_scale{1.0f},
+          dynamic_render_scale{false}, quality_governor{false}, idle_frame_skipping{true}, background_frame_rate{15},
+          pipelined_rendering{false}
+    {
+    }
 };
 
 void to_json(nlohmann::json &json_data, const WindowSize &window_size);
@@ -42,13 +63,30 @@ void from_json(const nlohmann::json &json_data, ApplicationAudioSettings &audio_
 void to_json(nlohmann::json &json_data, const ApplicationSettings &settings);
 void from_json(const nlohmann::json &json_data, ApplicationSettings &settings);
 
+/**
+ * @class SettingsManager
+ * @brief Loads the application settings and writes them back as they change.
+ *
+ * With auto save, changes are coalesced and written on a background thread once none came for SAVE_DEBOUNCE, or
+ * SAVE_MAX_DELAY after the first unsaved one while changes keep coming, as during a window resize drag. Files are
+ * written to a temporary beside the settings file and renamed over it, a crash mid write leaves the old settings.
+ * Changes still pending are written on destruction.
+ */
 class SettingsManager {
 public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr std::chrono::milliseconds SAVE_DEBOUNCE{500};
+    static constexpr std::chrono::milliseconds SAVE_MAX_DELAY{2000};
+
     explicit SettingsManager(FilePath filepath, bool auto_save = false, bool auto_load = true);
     ~SettingsManager();
 
+    SettingsManager(const SettingsManager &) = delete;
+    SettingsManager &operator=(const SettingsManager &) = delete;
+
     void Load();
-    void Save() const;
+    void Save(); // Writes now, on the calling thread, taking any pending change with it
 
     [[nodiscard]] ApplicationSettings GetSettings() const;
 
@@ -58,10 +96,29 @@ public:
     void SetFullScreen(bool enabled);
     void SetVsync(bool enabled);
     void SetRefreshRate(u16 rate);
+    void SetUpdateRate(u16 rate);
+    void SetRenderScale(f32 scale);
+    void SetDynamicRenderScale(bool enabled);
+    void SetQualityGovernor(bool enabled);
+    void SetIdleFrameSkipping(bool enabled);
+    void SetBackgroundFrameRate(u16 rate);
+
+private:
+    void ScheduleSave();
+    void Run(const std::stop_token &stop_token);
 
 private:
     ApplicationSettings m_settings;
     FilePath m_filepath;
     bool m_auto_save;
     bool m_is_valid;
+
+    std::mutex m_write_mutex; // Held across a file write, before m_mutex when both are
+    std::mutex m_mutex;
+    std::condition_variable_any m_condition;
+    std::optional<ApplicationSettings> m_pending_settings; // The latest unsaved snapshot
+    Clock::time_point m_first_change_time;
+    Clock::time_point m_last_change_time;
+
+    std::jthread m_thread; // Last, started once the rest is set up
 };
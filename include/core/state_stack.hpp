@@ -14,18 +14,28 @@
 #include <memory>
 #include <optional>
 
+#include "audio/audio_manager.hpp"
+#include "audio/sound_bank.hpp"
 #include "backends/input_handler.hpp"
 #include "backends/glfw/glfw_window.hpp"
 #include "cameras/orthographic_camera.hpp"
 #include "containers/small_vector.hpp"
+#include "core/frame_draw_list.hpp"
 #include "core/types.hpp"
+#include "debug/frame_statistics.hpp"
 #include "renderers/vulkan/vk_renderer.hpp"
 #include "renderers/vulkan/vk_texture_manager.hpp"
+#include "utils/asset_registry.hpp"
+#include "utils/event_bus.hpp"
+#include "utils/job_system.hpp"
+#include "utils/quality_governor.hpp"
+#include "utils/tween_system.hpp"
 
 #include "settings_manager.hpp"
 #include "states/state.hpp"
 
 struct SharedContext {
+    gouda::JobSystem *job_system;
     gouda::vk::Renderer *renderer;
     gouda::glfw::Window *window;
 
@@ -33,17 +43,27 @@ struct SharedContext {
     gouda::vk::TextureManager *texture_manager;
     SettingsManager *settings_manager;
 
+    gouda::audio::AudioManager *audio_manager;
+    gouda::audio::SoundBank *sound_bank; // Levels preload the sounds they play while they load
+    gouda::AssetRegistry *asset_registry;
+    gouda::EventBus *event_bus; // Dispatched once per frame, after the fixed updates and input handling
+    gouda::TweenSystem *tweens; // Updated once per frame with the frame's delta time, before the frame is drawn
+
     gouda::OrthographicCamera *scene_camera;
     gouda::OrthographicCamera *ui_camera;
 
     gouda::UniformData *uniform_data;
+    gouda::FrameStatistics *frame_statistics;
+    const gouda::utils::QualityGovernor *quality_governor; // Scenes follow its animation interval, off by default
+
+    f32 interpolation_factor; // How far past the last fixed update the frame is drawn, 0 to 1, set every frame
 };
 
 class StateStack {
 public:
     enum class Action : u8 { Push, Pop, Replace };
 
-    explicit StateStack() = default;
+    explicit StateStack();
 
     ~StateStack();
 
@@ -51,15 +71,35 @@ public:
     void Pop();
     void Replace(std::unique_ptr<State> state);
 
+    /**
+     * @brief Holds a state built ahead of its switch and starts loading its asset manifest, replacing any state
+     * preloaded before. Whatever the state starts loading itself also runs meanwhile, so by the time TakePreloaded
+     * hands it to Push or Replace there is nothing left to load inline.
+     */
+    void Preload(std::unique_ptr<State> state);
+
+    /**
+     * @return The preloaded state if it has the id, otherwise null and the state stays preloaded.
+     */
+    [[nodiscard]] std::unique_ptr<State> TakePreloaded(State::StateID id);
+
     void HandleInput();
     void Update(f32 delta_time);
-    void Render(f32 delta_time) const;
+    // Collects the visible states into one draw list, from the topmost opaque state up, and submits it once
+    void Render(f32 delta_time, gouda::vk::Renderer &renderer, const gouda::UniformData &uniform_data);
+    // Collects the visible states into draw_list without submitting it, for a render thread to draw later
+    void BuildDrawList(f32 delta_time, FrameDrawList &draw_list);
     void OnFrameBufferResize(const gouda::Vec2 &new_framebuffer_size);
     void ApplyPendingChanges();
 
     [[nodiscard]] bool IsEmpty() const { return m_states.empty(); }
+    [[nodiscard]] bool HasPendingChanges() const { return !m_pending_changes.empty(); }
+    [[nodiscard]] bool IsAnimating() const; // Any of the states Render draws is
     [[nodiscard]] State::StateID GetTopStateID() const;
 
+private:
+    [[nodiscard]] size_t GetFirstVisibleState() const; // The topmost opaque state, or 0
+
 private:
     struct PendingChange {
         Action action;
@@ -69,4 +109,6 @@ private:
 private:
     gouda::Vector<std::unique_ptr<State>> m_states;
     gouda::Vector<PendingChange> m_pending_changes;
+    std::unique_ptr<State> p_preloaded_state; // Built but never entered, so it is destroyed without an OnExit
+    FrameDrawList m_draw_list;
 };
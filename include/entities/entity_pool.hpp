@@ -0,0 +1,85 @@
+#pragma once
+/**
+ * @file entities/entity_pool.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Application pooled entity module
+ *
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <optional>
+
+#include "containers/small_vector.hpp"
+#include "core/types.hpp"
+
+#include "entities/entity.hpp"
+
+using EntityPoolID = u32;
+
+/**
+ * @class EntityPool
+ * @brief A run of entity store slots made from one prototype, handed out and taken back by short lived entities.
+ *
+ * Every slot and its components are created up front by EntityStore::AddParked, so spawning a projectile or pickup
+ * writes the prototype over a parked slot rather than growing every column of the store. Released slots are reused
+ * most recent first, while their columns are still in cache. The pool only tracks which slots are taken, the scene
+ * parks and respawns them, see Scene::SpawnPooledEntity.
+ */
+class EntityPool {
+public:
+    EntityPool(const Entity &prototype, u32 first, u32 capacity);
+
+    /**
+     * @return Index of a free slot in the store, empty when every slot is taken.
+     */
+    [[nodiscard]] std::optional<u32> Acquire();
+
+    /**
+     * @return False if the slot is not the pool's or is already free.
+     */
+    bool Release(size_t index);
+
+    [[nodiscard]] bool Owns(const size_t index) const noexcept
+    {
+        return index >= m_first && index < static_cast<size_t>(m_first) + m_capacity;
+    }
+    [[nodiscard]] bool IsActive(const size_t index) const { return Owns(index) && m_active[index - m_first] != 0; }
+
+    [[nodiscard]] const Entity &GetPrototype() const noexcept { return m_prototype; }
+    [[nodiscard]] u32 GetFirst() const noexcept { return m_first; }
+    [[nodiscard]] u32 GetCapacity() const noexcept { return m_capacity; }
+    [[nodiscard]] u32 GetActiveCount() const noexcept { return m_capacity - static_cast<u32>(m_free.size()); }
+
+    /**
+     * @brief Calls visitor with the arrays of free and active slots, which snapshots save and restore. The prototype
+     * and the slots' place in the store come from the scene's own pool.
+     */
+    template <typename Visitor>
+    void VisitColumns(Visitor &&visitor) const
+    {
+        visitor(m_free);
+        visitor(m_active);
+    }
+    template <typename Visitor>
+    void VisitColumns(Visitor &&visitor)
+    {
+        visitor(m_free);
+        visitor(m_active);
+    }
+
+    /**
+     * @brief Whether slots restored through VisitColumns fit the pool, each slot either free or active.
+     */
+    [[nodiscard]] bool IsConsistent() const;
+
+private:
+    Entity m_prototype;
+    u32 m_first; // Into the entity store, the pool's slots follow it
+    u32 m_capacity;
+    gouda::Vector<u32> m_free;  // Store indices, the last released is taken first
+    gouda::Vector<u8> m_active; // Per slot, nonzero while spawned
+};
@@ -0,0 +1,240 @@
+#pragma once
+/**
+ * @file entities/entity_store.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Application entity storage module
+ *
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <span>
+
+#include "containers/small_vector.hpp"
+#include "core/types.hpp"
+#include "math/collision.hpp"
+
+#include "entities/entity.hpp"
+
+/**
+ * @struct EntityAppearance
+ * @brief The parts of an entity's render data that only the instance builders read.
+ */
+struct EntityAppearance {
+    f32 rotation;
+    u32 texture_index;
+    gouda::Colour<f32> colour;
+    UVRect<f32> sprite_rect;
+    u32 is_atlas;
+    u32 apply_camera_effects;
+    gouda::BlendMode blend_mode;
+};
+
+/**
+ * @class EntityStore
+ * @brief Entities split into one array per field, indexed by the order they were added.
+ *
+ * Culling and collision only read positions, sizes and bounds, which are packed on their own so those loops stream
+ * through nothing else. Appearance and type are kept apart for the instance builders. Components most entities lack
+ * are stored densely per component type with a slot table alongside, so an entity without one costs a single index.
+ */
+class EntityStore {
+public:
+    EntityStore() = default;
+
+    /**
+     * @brief Splits an entity into the stores.
+     * @return Index of the entity.
+     */
+    size_t Add(const Entity &entity);
+
+    /**
+     * @brief Adds parked copies of an entity, with their components, for an EntityPool to respawn.
+     * @return Index of the first copy, the others follow it.
+     */
+    size_t AddParked(const Entity &prototype, size_t count);
+
+    /**
+     * @brief Writes a prototype over an entity at a position, assigning its components in place. The entity must have
+     * been added from the same prototype, it starts the step where it is so it is not drawn sliding from its old one.
+     */
+    void Respawn(size_t index, const Entity &prototype, const gouda::Vec3 &position);
+
+    /**
+     * @brief Gives an entity bounds no box intersects, so culling and collision pass over it without the others
+     * moving. The scene takes it out of its spatial index as well.
+     */
+    void Park(size_t index);
+    [[nodiscard]] bool IsParked(const size_t index) const { return m_bounds[index].min.x > m_bounds[index].max.x; }
+
+    /**
+     * @brief Replaces all entities with columns saved from another store, the entities get no components.
+     * @return False, leaving the store empty, if the columns differ in length.
+     */
+    [[nodiscard]] bool AssignColumns(gouda::Vector<gouda::Vec3> positions, gouda::Vector<gouda::Vec2> sizes,
+                                     gouda::Vector<gouda::math::AABB2D> bounds, gouda::Vector<EntityType> types,
+                                     gouda::Vector<EntityAppearance> appearances);
+
+    /**
+     * @brief Calls visitor with every array of the store, components and the step's moves included, always in the same
+     * order. Snapshots save and restore the store through it, see scenes/scene_snapshot.hpp.
+     */
+    template <typename Visitor>
+    void VisitColumns(Visitor &&visitor) const
+    {
+        VisitColumnsOf(*this, visitor);
+    }
+    template <typename Visitor>
+    void VisitColumns(Visitor &&visitor)
+    {
+        VisitColumnsOf(*this, visitor);
+    }
+
+    /**
+     * @brief Whether arrays restored through VisitColumns fit together, the store must not be used otherwise.
+     */
+    [[nodiscard]] bool IsConsistent() const;
+
+    void Reserve(size_t count);
+    void Clear();
+
+    /**
+     * @brief Moves an entity, keeping its bounds in step.
+     */
+    void SetPosition(size_t index, const gouda::Vec3 &position);
+
+    /**
+     * @brief Resizes an entity, keeping its bounds in step.
+     */
+    void SetSize(size_t index, const gouda::Vec2 &size);
+
+    void SetTextureIndex(const size_t index, const u32 texture_index)
+    {
+        m_appearances[index].texture_index = texture_index;
+    }
+    void SetColour(const size_t index, const gouda::Colour<f32> &colour) { m_appearances[index].colour = colour; }
+    void SetRotation(const size_t index, const f32 rotation) { m_appearances[index].rotation = rotation; }
+
+    /**
+     * @brief Starts a fixed update, the positions entities are drawn from are those they have now.
+     *
+     * Only the entities moved since the last call are touched, static levels cost nothing.
+     */
+    void BeginStep();
+
+    /**
+     * @brief Where an entity is drawn, between its position at the start of the step and its current one.
+     * @param interpolation_factor 0 at the start of the step, 1 at its end.
+     */
+    [[nodiscard]] gouda::Vec3 GetInterpolatedPosition(size_t index, f32 interpolation_factor) const;
+
+    /**
+     * @brief Advances every animated entity and writes its current frame into its appearance. Atlas entities playing
+     * a looping clip are handed to the GPU instead and skipped from then on, until they play another clip.
+     * @param time The scene's animation clock at the end of this step.
+     */
+    void UpdateAnimations(f32 delta_time, f32 time, const AnimationLibrary &library);
+
+    /**
+     * @brief Assembles the instance an entity is drawn with.
+     */
+    [[nodiscard]] gouda::InstanceData BuildInstance(size_t index) const;
+
+    /**
+     * @brief Assembles a copy of an entity with its components, for code that works on whole entities.
+     */
+    [[nodiscard]] Entity BuildEntity(size_t index) const;
+
+    [[nodiscard]] size_t Size() const noexcept { return m_positions.size(); }
+    [[nodiscard]] bool IsEmpty() const noexcept { return m_positions.empty(); }
+
+    [[nodiscard]] std::span<const gouda::Vec3> GetPositions() const noexcept { return m_positions; }
+    [[nodiscard]] std::span<const gouda::Vec2> GetSizes() const noexcept { return m_sizes; }
+    [[nodiscard]] std::span<const gouda::math::AABB2D> GetBounds() const noexcept { return m_bounds; }
+    [[nodiscard]] std::span<const EntityType> GetTypes() const noexcept { return m_types; }
+    [[nodiscard]] std::span<const EntityAppearance> GetAppearances() const noexcept { return m_appearances; }
+    [[nodiscard]] EntityType GetType(const size_t index) const { return m_types[index]; }
+    [[nodiscard]] const EntityAppearance &GetAppearance(const size_t index) const { return m_appearances[index]; }
+
+    [[nodiscard]] AnimationComponent *GetAnimation(const size_t index) { return m_animations.Get(index); }
+    [[nodiscard]] HealthComponent *GetHealth(const size_t index) { return m_health.Get(index); }
+
+private:
+    template <typename T>
+    struct SparseComponents {
+        static constexpr u32 NO_COMPONENT{constants::u32_max};
+
+        gouda::Vector<u32> slots; // Per entity index into values, NO_COMPONENT when absent
+        gouda::Vector<T> values;
+
+        void Add(const std::optional<T> &component)
+        {
+            if (!component.has_value()) {
+                slots.push_back(NO_COMPONENT);
+                return;
+            }
+            slots.push_back(static_cast<u32>(values.size()));
+            values.push_back(*component);
+        }
+
+        // Entities keep the components they were added with, only the value of one they have changes
+        void Reset(const size_t index, const std::optional<T> &component)
+        {
+            if (component.has_value() && slots[index] != NO_COMPONENT) {
+                values[slots[index]] = *component;
+            }
+        }
+
+        [[nodiscard]] T *Get(const size_t index)
+        {
+            return slots[index] == NO_COMPONENT ? nullptr : &values[slots[index]];
+        }
+
+        [[nodiscard]] const T *Get(const size_t index) const
+        {
+            return slots[index] == NO_COMPONENT ? nullptr : &values[slots[index]];
+        }
+
+        void Clear()
+        {
+            slots.clear();
+            values.clear();
+        }
+    };
+
+    template <typename Self, typename Visitor>
+    static void VisitColumnsOf(Self &self, Visitor &visitor)
+    {
+        visitor(self.m_positions);
+        visitor(self.m_sizes);
+        visitor(self.m_bounds);
+        visitor(self.m_previous_positions);
+        visitor(self.m_moved_entities);
+        visitor(self.m_types);
+        visitor(self.m_appearances);
+        visitor(self.m_animations.slots);
+        visitor(self.m_animations.values);
+        visitor(self.m_health.slots);
+        visitor(self.m_health.values);
+    }
+
+private:
+    // Hot, read every frame by culling and collision
+    gouda::Vector<gouda::Vec3> m_positions;
+    gouda::Vector<gouda::Vec2> m_sizes;
+    gouda::Vector<gouda::math::AABB2D> m_bounds;
+
+    // Read when drawing between steps, differs from m_positions only for the entities in m_moved_entities
+    gouda::Vector<gouda::Vec3> m_previous_positions;
+    gouda::Vector<u32> m_moved_entities; // Moved since BeginStep, an entity moved twice is listed twice
+
+    // Cold, read when building instances
+    gouda::Vector<EntityType> m_types;
+    gouda::Vector<EntityAppearance> m_appearances;
+
+    SparseComponents<AnimationComponent> m_animations;
+    SparseComponents<HealthComponent> m_health;
+};
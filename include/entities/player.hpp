@@ -17,6 +17,7 @@ struct Player : Entity {
     Player(const gouda::InstanceData &instance_data, gouda::Vec2 velocity_, f32 speed_);
     ~Player();
 
-    gouda::Vec2 velocity; ///< Movement velocity
-    f32 speed;            ///< Movement speed
+    gouda::Vec2 velocity;          ///< Movement velocity
+    f32 speed;                     ///< Movement speed
+    gouda::Vec3 previous_position; ///< Position at the start of the fixed update, drawn from between updates
 };
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+/**
+ * @file scenes/level_file.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Application binary level file module
+ *
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <span>
+
+#include "containers/small_vector.hpp"
+#include "core/types.hpp"
+#include "math/bvh.hpp"
+
+#include "entities/entity_store.hpp"
+
+/**
+ * Binary levels hold the entity columns and the level tree exactly as they sit in memory, so loading is a file
+ * mapping and one copy per section with no parsing. The file starts with a header and a table of sections, each
+ * section is one packed array starting on a 16 byte boundary. The layout follows the build's types, so files are
+ * only portable between builds with the same version and endianness, JSON stays the interchange format.
+ */
+constexpr u32 LEVEL_FILE_VERSION{2}; // Bump whenever a section or a type stored in one changes layout
+
+/**
+ * @brief Writes the entity columns and the tree built over them.
+ * @param texture_paths Textures the entities refer to, for files whose texture indices index this list rather than
+ * the texture manager. World chunks are stored this way, see WorldStreamer.
+ * @return False if the file could not be written.
+ */
+bool SaveLevelFile(StringView filepath, const EntityStore &entities, const gouda::math::BoundingVolumeHierarchy &tree,
+                   std::span<const String> texture_paths = {});
+
+/**
+ * @brief Replaces the entities and the tree with those of a level file.
+ * @param texture_paths Receives the texture paths stored with the level, may be null.
+ * @return False, leaving both empty, if the file is missing, from another version or malformed.
+ */
+bool LoadLevelFile(StringView filepath, EntityStore &entities, gouda::math::BoundingVolumeHierarchy &tree,
+                   gouda::Vector<String> *texture_paths = nullptr);
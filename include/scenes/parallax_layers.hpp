@@ -0,0 +1,99 @@
+#pragma once
+/**
+ * @file scenes/parallax_layers.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Application parallax background layer module
+ *
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <vector>
+
+#include "cameras/orthographic_camera.hpp"
+#include "containers/small_vector.hpp"
+#include "core/types.hpp"
+#include "math/collision.hpp"
+#include "math/simd_kernels.hpp"
+#include "renderers/render_data.hpp"
+
+using ParallaxLayerID = u32;
+
+/**
+ * @struct ParallaxLayerDesc
+ * @brief How a background layer follows the camera.
+ */
+struct ParallaxLayerDesc {
+    String name;
+    // Fraction of the camera's motion the layer scrolls by on each axis, 0 stays fixed on screen, 1 moves with the
+    // world. Distant layers sit between the two.
+    gouda::Vec2 scroll_factor{0.5f, 0.5f};
+    f32 depth{-0.05f};      // Z of the layer's tiles, see the bands in notes.txt
+    f32 repeat_width{0.0f}; // World units the tiles repeat every along x, 0 draws them once
+};
+
+// A layer's instances in the output of the last ParallaxLayers::CollectVisible
+struct ParallaxLayerRange {
+    size_t first{0};
+    size_t count{0};
+};
+
+/**
+ * @class ParallaxLayers
+ * @brief Background layers that scroll slower than the world, each culled against its own view of the camera.
+ *
+ * Tiles are placed in layer space, where a layer with a scroll factor of 1 matches the world. Every frame the camera
+ * view is moved back into each layer's space by the part of the camera's motion the layer does not follow, and only
+ * the tiles overlapping that rect are emitted, offset by the same amount so the shared scene camera matrix scrolls
+ * them at their layer's rate. Tile bounds are kept as columns per layer, so a layer is culled with one batched
+ * intersection per repeat of it on screen. Layers are drawn with the scene camera, their tiles should keep
+ * apply_camera_effects set.
+ */
+class ParallaxLayers {
+public:
+    ParallaxLayerID AddLayer(const ParallaxLayerDesc &desc);
+
+    /**
+     * @brief Adds a tile to a layer, its position is the top left corner in layer space.
+     *
+     * Repeating layers wrap the tile's x into one repeat, the layer's depth replaces the tile's z.
+     */
+    void AddTile(ParallaxLayerID layer, const gouda::InstanceData &tile);
+
+    void ClearTiles(ParallaxLayerID layer);
+    void Clear() { m_layers.clear(); }
+
+    /**
+     * @brief Appends the tiles of every layer visible from the camera, positioned for the scene camera matrix.
+     * @param view The scene camera's culling bounds, read in the same frame the instances are drawn.
+     * @param instances Output, each layer's tiles follow the last and their range is kept for GetRange.
+     */
+    void CollectVisible(const gouda::OrthographicCamera::FrustumData &view,
+                        std::vector<gouda::InstanceData> &instances);
+
+    [[nodiscard]] const ParallaxLayerDesc &GetDesc(const ParallaxLayerID layer) const
+    {
+        return m_layers[layer].desc;
+    }
+    [[nodiscard]] const ParallaxLayerRange &GetRange(const ParallaxLayerID layer) const
+    {
+        return m_layers[layer].range;
+    }
+    [[nodiscard]] size_t GetLayerCount() const noexcept { return m_layers.size(); }
+    [[nodiscard]] bool IsEmpty() const noexcept { return m_layers.empty(); }
+
+private:
+    struct Layer {
+        ParallaxLayerDesc desc;
+        std::vector<gouda::InstanceData> tiles;
+        gouda::math::AABB2DColumns bounds; // Of the tiles, in layer space
+        ParallaxLayerRange range;
+    };
+
+private:
+    gouda::Vector<Layer> m_layers; // Indexed by ParallaxLayerID, drawn back to front by depth
+    gouda::Vector<u32> m_hits;     // Scratch for culling, into a layer's tiles
+};
@@ -11,68 +11,234 @@
  * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
  * See <https://www.gnu.org/licenses/> for more information.
  */
+#include <algorithm>
+#include <optional>
+
+#include "audio/audio_manager.hpp"
 #include "cameras/orthographic_camera.hpp"
+#include "core/frame_draw_list.hpp"
+#include "math/bvh.hpp"
+#include "math/collision.hpp"
+#include "math/simd_kernels.hpp"
+#include "math/spatial_grid.hpp"
+#include "math/sweep_and_prune.hpp"
+#include "math/transform_hierarchy.hpp"
+#include "memory/allocators/tracking_allocator.hpp"
+#include "renderers/particle_store.hpp"
+#include "renderers/tilemap.hpp"
 #include "renderers/vulkan/vk_renderer.hpp"
 #include "renderers/vulkan/vk_texture_manager.hpp"
-
+#include "utils/asset_registry.hpp"
+#include "utils/frame_graph.hpp"
+#include "utils/job_system.hpp"
+#include "utils/system_scheduler.hpp"
+#include "utils/worker_pool.hpp"
+
+#include "entities/entity_pool.hpp"
+#include "entities/entity_store.hpp"
 #include "entities/player.hpp"
-
-struct GridPos {
-    s32 x;
-    s32 y;
-
-    bool operator==(const GridPos &other) const { return x == other.x && y == other.y; }
-    struct Hash {
-        size_t operator()(const GridPos &pos) const { return std::hash<int>()(pos.x) ^ std::hash<int>()(pos.y) << 1; }
-    };
+#include "scenes/parallax_layers.hpp"
+#include "scenes/scene_snapshot.hpp"
+#include "scenes/world_streamer.hpp"
+#include "ui/ui_batcher.hpp"
+
+// Counts of the last update's collision passes, for profiling
+struct CollisionStatistics {
+    u32 dynamic_body_count{0};     // Moved entities in the broadphase
+    u32 broadphase_pair_count{0};  // Pairs of them with overlapping bounds
+    u32 sort_swap_count{0};        // Moves the broadphase sort made, low while the order holds between ticks
+    u32 contact_count{0};          // Pairs the narrowphase pushed apart
+    u32 player_contact_count{0};   // Entities the player was pushed out of
+    u32 player_sweep_hit_count{0}; // Surfaces the player's swept move stopped at
 };
 
 class Scene {
 public:
-    explicit Scene(gouda::OrthographicCamera *scene_camera, gouda::OrthographicCamera *ui_camera, gouda::vk::TextureManager *texture_manager);
-    ~Scene() = default;
+    // The registry is optional, with it the sprites the scene copied follow hot reloads of their atlases. Without a
+    // texture manager the scene only simulates, see core/headless_simulation.hpp.
+    explicit Scene(gouda::OrthographicCamera *scene_camera, gouda::OrthographicCamera *ui_camera,
+                   gouda::vk::TextureManager *texture_manager, gouda::AssetRegistry *asset_registry = nullptr);
+    ~Scene();
 
     void Update(f32 delta_time);
-    void Render(f32 delta_time, gouda::vk::Renderer &renderer, gouda::UniformData &uniform_data);
+    // interpolation_factor blends moving entities from their positions at the start of the last update to the end
+    void Render(f32 delta_time, f32 interpolation_factor, gouda::vk::Renderer &renderer, FrameDrawList &draw_list);
 
-    void UpdateUI(f32 delta_time);
-    void DrawUI(gouda::vk::Renderer &renderer);
+    // Unchanged UI elements are not rebuilt, see UIBatcher
+    void DrawUI(gouda::vk::Renderer &renderer, FrameDrawList &draw_list);
 
+    // JSON is the editable interchange format, levels are the binary form the game loads, see scenes/level_file.hpp
     void LoadFromJSON(StringView filepath);
     void SaveToJSON(StringView filepath);
+    bool LoadLevel(StringView filepath);
+    bool SaveLevel(StringView filepath) const;
+
+    // Quick saves of the gameplay state on top of the loaded level, see scenes/scene_snapshot.hpp. Saving copies the
+    // arrays and returns, the file is compressed and written on a thread of its own. Loading needs the entity pools
+    // the snapshot was taken with and leaves the scene as it was when the snapshot does not fit.
+    void SaveSnapshot(StringView filepath, bool compress = true);
+    bool LoadSnapshot(StringView filepath);
+
+    // Streams the chunks of a world written by SaveWorldChunks around the camera, on top of the loaded level
+    void EnableStreaming(StringView directory, gouda::JobSystem *job_system,
+                         const WorldStreamingSettings &settings = {});
+    void DisableStreaming() { p_world_streamer.reset(); }
 
     // Particle methods
     void SpawnParticle(const gouda::Vec3 &position, const gouda::Vec2 &size, const gouda::Vec3 &velocity, f32 lifetime,
                        u32 texture_index = 0, const gouda::Vec4 &colour = {1.0f});
+    // Hands the particles spawned since the last render to the CPU simulation, as Render does without compute
+    // particles. Headless runs, which never render, call it after each update.
+    void SpawnPendingParticles();
+    [[nodiscard]] size_t GetParticleCount() const { return m_particles.Size(); }
+
+    // Entity methods, these keep the spatial grid in step so moving entities never need a rebuild
+    size_t AddEntity(const Entity &entity);
+    void MoveEntity(size_t index, const gouda::Vec3 &position);
+
+    // Pooled entities, for short lived ones spawned in bursts such as projectiles and pickups. A pool's slots and their
+    // components are created once and reused, they are not saved with the level and go away when another is loaded.
+    EntityPoolID CreateEntityPool(const Entity &prototype, u32 capacity);
+    // Empty when every slot of the pool is taken
+    std::optional<size_t> SpawnPooledEntity(EntityPoolID pool, const gouda::Vec3 &position);
+    void DespawnPooledEntity(EntityPoolID pool, size_t index);
+
+    // Keeps an entity at an offset from another, moved and rotated with it from the next update, see
+    // math/transform_hierarchy.hpp. Attached entities may have their own attached, they go when another level loads.
+    void AttachEntity(size_t entity, size_t parent, const gouda::Vec2 &offset, f32 rotation = 0.0f);
+    // The entity stays where it is and no longer follows its parent, the entities attached to it still follow it
+    void DetachEntity(size_t entity);
+    [[nodiscard]] const EntityPool &GetEntityPool(const EntityPoolID pool) const { return m_entity_pools[pool]; }
+
+    // The tile layer drawn under the entities, built into chunks and uploaded by the next render
+    void SetTilemap(gouda::Tilemap tilemap);
+    [[nodiscard]] const gouda::Tilemap &GetTilemap() const { return m_tilemap; }
+
+    // Backgrounds scrolled at a fraction of the camera's motion, culled and drawn every render. They are kept when
+    // another level is loaded.
+    ParallaxLayers &GetParallaxLayers() { return m_parallax_layers; }
 
     Player &GetPlayer() { return m_player; }
+    [[nodiscard]] const EntityStore &GetEntities() const { return m_entities; }
+    [[nodiscard]] const CollisionStatistics &GetCollisionStatistics() const { return m_collision_statistics; }
 
     void SetFontID(const u32 id) { m_font_id = id; }
 
+    // CPU animations advance every updates fixed updates by the time summed over them, see utils/quality_governor.hpp.
+    // The GPU animated entities run off m_animation_time, which still advances every update.
+    void SetAnimationInterval(const u32 updates) { m_animation_interval = std::max(updates, 1u); }
+
+    // Positioned sounds are then muffled by the entities between them and the listener, may be null to stop that
+    void SetAudioManager(gouda::audio::AudioManager *audio_manager) { p_audio_manager = audio_manager; }
+
+    // Render's independent stages then overlap on its workers, may be null to run them one after another
+    void SetJobSystem(gouda::JobSystem *job_system) { p_job_system = job_system; }
+
 private:
     void SetupEntities();
     void SetupPlayer();
+    void DerivePlayerClips();    // From the player's atlas sprite
+    void DeriveTilemapSprites(); // Palette entries named after atlas sprites
+    void WatchAtlas(gouda::AssetDependentID &dependent, u32 texture_id, std::function<void()> rederive);
     void SetupUI();
-    void BuildSpatialGrid();
+    void SetupSystems();
+    void SetupRenderGraph();
+    void DrawUIInstances(gouda::vk::Renderer &renderer, std::vector<gouda::InstanceData> &quad_instances);
+    void BuildSpatialIndex();
+    [[nodiscard]] bool IsPooledEntity(size_t index) const;
+    void QueryEntities(const gouda::math::AABB2D &bounds, gouda::Vector<u32> &entities);
     void UpdateVisibleInstances();
+    void UpdateAnimations(f32 delta_time);
+    [[nodiscard]] bool SweepEntities(const gouda::math::AABB2D &bounds, const gouda::Vec2 &displacement,
+                                     gouda::math::SweepHit &hit);
+    void UpdatePlayer(f32 delta_time);
+    void UpdateCollisions();
+    void UpdateAttachments();
+    void ClearAttachments();
+    [[nodiscard]] gouda::math::TransformID GetEntityTransform(size_t entity);
+    [[nodiscard]] bool ResolveEntityContact(u32 first, u32 second);
     void UpdateParticles(f32 delta_time);
+    void UpdateAudioOcclusion();
 
 private:
     gouda::OrthographicCamera *p_scene_camera;
     gouda::OrthographicCamera *p_ui_camera;
     gouda::vk::TextureManager *p_texture_manager;
+    gouda::AssetRegistry *p_asset_registry;
+    gouda::audio::AudioManager *p_audio_manager;
+    gouda::JobSystem *p_job_system;
+    gouda::AssetDependentID m_player_atlas_dependent;
+    gouda::AssetDependentID m_tilemap_atlas_dependent;
 
     Player m_player;
-    gouda::Vector<Entity> m_entities;
+    EntityStore m_entities;
+    gouda::Vector<EntityPool> m_entity_pools; // Each owns a run of m_entities, indexed by EntityPoolID
+    AnimationLibrary m_animations;  // Clips of the player and the entities
+    f32 m_animation_time;           // Seconds of updates, the clock GPU animated entities started in
+    u32 m_animation_interval;       // Fixed updates per CPU animation update
+    u32 m_animation_update_count;   // Since the last CPU animation update
+    f32 m_animation_delta_time;     // Summed over those updates
+    u64 m_animation_tables_version; // Of m_animations when the renderer was last given its tables
+    // Scratch for batched culling, gathered from m_entities. Hits index the candidates.
+    gouda::math::AABB2DColumns m_visible_candidate_bounds;
+    gouda::Vector<u32> m_visible_candidate_hits;
 
     std::vector<gouda::InstanceData> m_visible_quad_instances;
-    std::vector<gouda::TextData> m_text_instances;
-    std::vector<gouda::ParticleData> m_particles_instances;
+    gouda::Vector<u32> m_visible_entities;         // The m_entities drawn by the first instances, in order
+    std::optional<size_t> m_player_instance_index; // Into m_visible_quad_instances, empty when culled
+    gouda::ParticleStore m_particles;                   // CPU simulated particles
+    std::vector<gouda::ParticleData> m_particles_instances; // m_particles in the GPU layout, rebuilt every render
+    std::vector<gouda::ParticleData> m_particle_spawns; // Spawned since the last render
     bool m_instances_dirty;
+    bool m_particle_colliders_dirty; // Entity bounds changed since the renderer was last given them
+    gouda::Tilemap m_tilemap;
+    bool m_tilemap_dirty;                        // Changed since the renderer was last given it
+    gouda::Vector<String> m_tilemap_sprite_names; // Of each palette entry, empty for UV rects and set tilemaps
+    ParallaxLayers m_parallax_layers;
 
     u32 m_font_id;
 
-    std::unordered_map<GridPos, gouda::Vector<size_t>, GridPos::Hash> m_spatial_grid;
+    // Entity ids in both are indices into m_entities. Entities stay in the tree built at load until they are moved.
+    gouda::math::BoundingVolumeHierarchy m_level_bvh;
+    gouda::math::SpatialHashGrid m_spatial_grid; // Entities added or moved since the level loaded
+    gouda::TrackedVector<u8, gouda::MemoryTag::Scene> m_entity_in_grid; // Nonzero for entities the tree results skip
+    gouda::Vector<u32> m_nearby_entities;                               // Scratch for collision queries
+    gouda::math::AABB2DColumns m_nearby_bounds;                         // Of m_nearby_entities, in order
+    gouda::Vector<u32> m_nearby_hits;                                   // Into m_nearby_entities
+    // Attached entities and those they are attached to, the roots follow their entities and the rest are moved
+    gouda::math::TransformHierarchy m_transforms;
+    gouda::Vector<gouda::math::TransformID> m_entity_transforms; // Per entity, INVALID_TRANSFORM for most
+    gouda::Vector<u32> m_transform_entities;                     // Per transform id
+    gouda::Vector<u32> m_root_transform_entities;                // Entities at the roots, followed every update
+    gouda::math::SweepAndPrune m_broadphase; // Moved entities, which collide with each other as well as the player
+    gouda::Vector<gouda::math::CollisionPair> m_collision_pairs; // Scratch for the broadphase
+    CollisionStatistics m_collision_statistics;
+    gouda::Vector<u32> m_visible_candidates;                            // Scratch for culling queries
+    gouda::Vector<gouda::audio::OcclusionQuery> m_occlusion_queries;    // Batch taken from the audio manager
+    gouda::Vector<gouda::audio::OcclusionResult> m_occlusion_results;   // Answers to m_occlusion_queries
+    gouda::Vector<u32> m_occluder_candidates;                           // Scratch for occlusion queries
 
     std::vector<gouda::InstanceData> m_ui_elements;
+    UIBatcher m_ui_batcher;
+
+    std::unique_ptr<WorldStreamer> p_world_streamer; // Null unless streaming, updated on the main thread
+
+    SceneSnapshot m_snapshot;                          // Captured into and restored from, keeps its storage
+    std::unique_ptr<SnapshotWriter> p_snapshot_writer; // Created by the first SaveSnapshot
+
+    std::unique_ptr<gouda::WorkerPool> p_worker_pool; // Runs the update systems
+    gouda::SystemScheduler m_systems;                 // Everything Update does, see SetupSystems
+
+    // What the render graph's tasks draw with, set by Render for the frame being drawn
+    struct RenderFrame {
+        gouda::vk::Renderer *renderer{nullptr};
+        FrameDrawList *draw_list{nullptr};
+        f32 interpolation_factor{1.0f};
+        bool use_compute_particles{false};
+    };
+    RenderFrame m_render_frame;
+    gouda::FrameGraph m_render_graph; // Everything Render does, see SetupRenderGraph
+    // Each task's quads are gathered apart and appended in the order they were drawn before, overlays last
+    std::vector<gouda::InstanceData> m_parallax_instances;
+    std::vector<gouda::InstanceData> m_ui_instances;
 };
\ No newline at end of file
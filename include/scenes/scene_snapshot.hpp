@@ -0,0 +1,191 @@
+#pragma once
+/**
+ * @file scenes/scene_snapshot.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Application binary scene snapshot module
+ *
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <condition_variable>
+#include <cstddef>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <type_traits>
+
+#include "containers/small_vector.hpp"
+#include "core/types.hpp"
+
+/**
+ * Snapshots hold a scene's gameplay state, the entity and particle columns with their components, the player and the
+ * pools, as raw blocks copied straight out of the arrays. Like level files they follow the build's types and are only
+ * read back by builds with the same version and endianness, they are quick saves rather than an interchange format.
+ * The file is a header, a table of blocks and the blocks, each LZ4 compressed when asked and when that pays.
+ */
+constexpr u32 SCENE_SNAPSHOT_VERSION{1}; // Bump whenever a block is added, removed or a type stored in one changes
+
+/**
+ * @struct SceneSnapshot
+ * @brief Blocks in the order the scene visits its arrays, a snapshot is captured into and restored from in that order.
+ */
+struct SceneSnapshot {
+    struct Block {
+        u32 element_size; // Guards against a type changing size without a version bump
+        u64 count;
+        gouda::Vector<std::byte> bytes;
+    };
+
+    gouda::Vector<Block> blocks;
+    size_t block_count{0}; // In use, the blocks past it keep their storage for the next capture
+};
+
+/**
+ * @class SnapshotCapture
+ * @brief Visitor copying each array it is given into the next block of a snapshot, reusing the block's storage.
+ */
+class SnapshotCapture {
+public:
+    explicit SnapshotCapture(SceneSnapshot &snapshot) : m_snapshot{snapshot} { m_snapshot.block_count = 0; }
+
+    template <typename Container>
+    void operator()(const Container &values)
+    {
+        using T = typename Container::value_type;
+        static_assert(std::is_trivially_copyable_v<T>, "Snapshot blocks are copied as raw bytes");
+
+        SceneSnapshot::Block &block{NextBlock()};
+        block.element_size = static_cast<u32>(sizeof(T));
+        block.count = values.size();
+        block.bytes.resize_uninitialized(values.size() * sizeof(T));
+        if (!values.empty()) {
+            std::memcpy(block.bytes.data(), values.data(), values.size() * sizeof(T));
+        }
+    }
+
+    template <typename T>
+    void Value(const T &value)
+    {
+        (*this)(std::span<const T>{&value, 1});
+    }
+
+private:
+    SceneSnapshot::Block &NextBlock();
+
+private:
+    SceneSnapshot &m_snapshot;
+};
+
+/**
+ * @class SnapshotRestore
+ * @brief Visitor filling each array it is given from the next block of a snapshot. A block of another element size,
+ * or one missing, leaves the array empty and the restore failed.
+ */
+class SnapshotRestore {
+public:
+    explicit SnapshotRestore(const SceneSnapshot &snapshot) : m_snapshot{snapshot}, m_next_block{0}, m_is_failed{false}
+    {
+    }
+
+    template <typename Container>
+    void operator()(Container &values)
+    {
+        using T = typename Container::value_type;
+        static_assert(std::is_trivially_copyable_v<T>, "Snapshot blocks are copied as raw bytes");
+
+        values.clear();
+        const SceneSnapshot::Block *block{NextBlock(sizeof(T))};
+        if (block == nullptr) {
+            return;
+        }
+        values.resize_uninitialized(block->count);
+        if (block->count > 0) {
+            std::memcpy(values.data(), block->bytes.data(), block->count * sizeof(T));
+        }
+    }
+
+    // False, leaving value as it was, when the block does not hold exactly one
+    template <typename T>
+    bool Value(T &value)
+    {
+        const SceneSnapshot::Block *block{NextBlock(sizeof(T))};
+        if (block == nullptr || block->count != 1) {
+            m_is_failed = true;
+            return false;
+        }
+        std::memcpy(&value, block->bytes.data(), sizeof(T));
+        return true;
+    }
+
+    // Every block matched the array it was read into and none is left over
+    [[nodiscard]] bool IsComplete() const noexcept
+    {
+        return !m_is_failed && m_next_block == m_snapshot.block_count;
+    }
+
+private:
+    [[nodiscard]] const SceneSnapshot::Block *NextBlock(size_t element_size);
+
+private:
+    const SceneSnapshot &m_snapshot;
+    size_t m_next_block;
+    bool m_is_failed;
+};
+
+/**
+ * @brief Writes a snapshot through a temporary file renamed over filepath, a crash never leaves half a save.
+ * @param compress LZ4 compresses the blocks that shrink by an eighth or more.
+ * @return False if the file could not be written.
+ */
+bool WriteSnapshotFile(StringView filepath, const SceneSnapshot &snapshot, bool compress);
+
+/**
+ * @brief Reads a snapshot's blocks, decompressing them, into snapshot's storage.
+ * @return False if the file is missing, from another version or malformed.
+ */
+bool ReadSnapshotFile(StringView filepath, SceneSnapshot &snapshot);
+
+/**
+ * @class SnapshotWriter
+ * @brief Writes snapshots on a thread of its own, so a quick save only costs the main thread the copy of the arrays.
+ *
+ * Snapshots are written in the order they were queued. Queuing swaps the caller's snapshot for the storage of one
+ * already written, the next capture then fills that instead of allocating.
+ */
+class SnapshotWriter {
+public:
+    SnapshotWriter();
+    ~SnapshotWriter(); // Writes what is still queued
+
+    SnapshotWriter(const SnapshotWriter &) = delete;
+    SnapshotWriter &operator=(const SnapshotWriter &) = delete;
+
+    void Queue(String filepath, SceneSnapshot &snapshot, bool compress);
+
+    // Blocks until every queued snapshot is written
+    void Wait();
+
+private:
+    struct Job {
+        String filepath;
+        SceneSnapshot snapshot;
+        bool compress;
+    };
+
+    void Run(const std::stop_token &stop_token);
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable_any m_condition;
+    std::deque<Job> m_jobs;
+    bool m_is_writing;
+    SceneSnapshot m_spare; // Storage of the last snapshot written
+
+    std::jthread m_thread; // Last, started once the rest is set up
+};
@@ -0,0 +1,147 @@
+#pragma once
+/**
+ * @file scenes/world_streamer.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Application world chunk streaming module
+ *
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <memory>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "cameras/orthographic_camera.hpp"
+#include "containers/small_vector.hpp"
+#include "core/types.hpp"
+#include "math/bvh.hpp"
+#include "math/collision.hpp"
+#include "renderers/render_data.hpp"
+#include "renderers/vulkan/vk_texture_manager.hpp"
+#include "utils/job_system.hpp"
+
+#include "entities/entity_store.hpp"
+
+/**
+ * @struct WorldStreamingSettings
+ * @brief How far ahead of the camera chunks are loaded and how much chunk data may stay resident.
+ */
+struct WorldStreamingSettings {
+    f32 chunk_size{2048.0f};        // World units along each side, must match the size the chunks were written with
+    f32 prefetch_distance{1024.0f}; // Margin around the view that is kept loaded
+    f32 lookahead_time{0.75f};      // Seconds of camera motion the loaded area extends ahead by
+    size_t memory_budget{size_t{64} << 20}; // Bytes of chunk data kept resident, chunks near the view are always kept
+    u32 max_concurrent_loads{4};
+};
+
+/**
+ * @brief Splits entities into chunk files a WorldStreamer can load, replacing the chunks in the directory.
+ * @param directory Directory the chunks are written to, created if missing.
+ * @param entities Entities whose texture indices index texture_paths.
+ * @param texture_paths Textures the entities refer to, each chunk stores only the ones it uses.
+ * @param chunk_size World units along each side of a chunk, an entity goes to the chunk holding its position.
+ * @return False if a chunk could not be written.
+ */
+bool SaveWorldChunks(StringView directory, const EntityStore &entities, std::span<const String> texture_paths,
+                     f32 chunk_size);
+
+/**
+ * @class WorldStreamer
+ * @brief Keeps the chunks of a large world around the camera in memory and loads them in the background.
+ *
+ * A world is a directory of level files, one per square chunk, named after the chunk coordinates. Each update the
+ * view is grown by the prefetch distance and stretched along the camera's motion, and missing chunks overlapping
+ * that area are loaded on the job system, nearest first. A chunk is a complete level with its own tree and texture
+ * list, so a load needs no work on the main thread beyond requesting its textures once it arrives. Chunks that left
+ * the area stay cached until the memory budget is exceeded, then the farthest are dropped first, which also keeps a
+ * camera moving back and forth along a chunk edge from reloading it.
+ */
+class WorldStreamer {
+public:
+    /**
+     * @brief Indexes the chunks of a world, nothing is loaded until the first update.
+     * @param directory Directory the chunks were written to by SaveWorldChunks.
+     * @param settings Streaming distances and budget.
+     * @param job_system Runs the loads, loads run on the calling thread when null or without workers.
+     * @param texture_manager Loads the textures chunks refer to.
+     */
+    WorldStreamer(StringView directory, const WorldStreamingSettings &settings, gouda::JobSystem *job_system,
+                  gouda::vk::TextureManager *texture_manager);
+    ~WorldStreamer();
+
+    WorldStreamer(const WorldStreamer &) = delete;
+    WorldStreamer &operator=(const WorldStreamer &) = delete;
+
+    /**
+     * @brief Finishes arrived loads, then requests and evicts chunks for the camera. Runs on the main thread.
+     */
+    void Update(const gouda::OrthographicCamera &camera, f32 delta_time);
+
+    /**
+     * @brief Appends the instances of resident entities overlapping the bounds, chunk by chunk.
+     * @param bounds World bounds, either corner order is accepted like the tree queries do.
+     */
+    void CollectVisible(const gouda::math::AABB2D &bounds, std::vector<gouda::InstanceData> &instances);
+
+    [[nodiscard]] size_t GetChunkCount() const noexcept { return m_chunks.size(); }
+    [[nodiscard]] size_t GetResidentChunkCount() const noexcept { return m_resident_count; }
+    [[nodiscard]] u64 GetResidentBytes() const noexcept { return m_resident_bytes; }
+
+private:
+    enum class ChunkState : u8 {
+        Unloaded,
+        Loading,
+        Resident,
+        Failed, // The file could not be loaded, it is not retried
+    };
+
+    struct ChunkData {
+        EntityStore entities;
+        gouda::math::BoundingVolumeHierarchy tree;
+        gouda::Vector<String> texture_paths;
+        bool is_loaded{false};
+    };
+
+    struct Chunk {
+        String filepath;
+        s32 x;
+        s32 y;
+        ChunkState state;
+        u64 size_bytes;                    // Of the file, which maps one to one onto the loaded columns
+        gouda::math::AABB2D bounds;        // Of the entities once resident, which may overhang the chunk cell
+        std::unique_ptr<ChunkData> p_data; // Written by the load job until the counter is done
+        std::unique_ptr<gouda::JobCounter> p_counter;
+        gouda::Vector<u32> texture_ids; // Texture manager ids of the chunk's texture paths
+        u64 last_wanted_frame;
+    };
+
+    void IndexChunks(StringView directory);
+    void StartLoad(Chunk &chunk);
+    void FinishLoad(Chunk &chunk);
+    void Evict(Chunk &chunk);
+    [[nodiscard]] gouda::math::AABB2D GetStreamingArea(const gouda::OrthographicCamera &camera, f32 delta_time);
+    [[nodiscard]] u32 GetTextureID(const String &filepath);
+
+private:
+    WorldStreamingSettings m_settings;
+    gouda::JobSystem *p_job_system;
+    gouda::vk::TextureManager *p_texture_manager;
+
+    std::unordered_map<u64, Chunk> m_chunks; // Keyed by packed chunk coordinates, every chunk file found at startup
+    std::unordered_map<String, u32> m_texture_ids; // Shared between chunks, the texture manager handles residency
+    std::vector<Chunk *> m_load_order;             // Scratch for ordering requests by distance
+    gouda::Vector<u32> m_query_results;
+
+    gouda::Vec3 m_last_camera_position;
+    gouda::Vec2 m_camera_velocity; // Smoothed, world units per second
+    bool m_has_camera_position;
+    u64 m_frame;
+    size_t m_resident_count;
+    u64 m_resident_bytes;
+    u32 m_loads_in_flight;
+};
@@ -0,0 +1,110 @@
+#pragma once
+/**
+ * @file states/editor_history.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Application editor undo history module
+ *
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <array>
+#include <deque>
+#include <span>
+
+#include "containers/small_vector.hpp"
+#include "core/types.hpp"
+
+/**
+ * @enum EntityField
+ * @brief The entity fields an editor edit can change.
+ */
+enum class EntityField : u8 { Position, Size, TextureIndex, Colour };
+
+/**
+ * @struct EntityEdit
+ * @brief One field of one entity before and after an edit.
+ *
+ * Values are stored in four floats whatever the field, positions use three, sizes two and colours all four. Texture
+ * indices are bit cast into the first.
+ */
+struct EntityEdit {
+    u32 entity;
+    EntityField field;
+    std::array<f32, 4> before;
+    std::array<f32, 4> after;
+};
+
+/**
+ * @class EditorHistory
+ * @brief Undo and redo of entity edits, stored as the fields they changed rather than copies of the scene.
+ *
+ * Edits are grouped into commands, each undone as a whole. A command begun with the same nonzero merge key as the
+ * one before it, with nothing undone in between, extends that one instead, so a drag recorded a frame at a time undoes
+ * in one step. Extending a command updates the after value of the fields it already holds, a drag of n entities
+ * costs n edits however long it runs. Once the history outgrows its memory budget the oldest commands are dropped.
+ */
+class EditorHistory {
+public:
+    /**
+     * @param memory_budget Bytes the commands may take before the oldest are dropped, the newest is always kept.
+     */
+    explicit EditorHistory(size_t memory_budget);
+
+    /**
+     * @brief Opens a command, the edits recorded until EndCommand undo together.
+     * @param merge_key Nonzero to extend the last command if it was begun with the same key.
+     */
+    void BeginCommand(u64 merge_key = 0);
+    void EndCommand();
+
+    /**
+     * @brief Adds an edit to the open command, an edit recorded outside of one is a command on its own.
+     *
+     * Recording drops everything that was undone, it can no longer be redone.
+     */
+    void Record(const EntityEdit &edit);
+
+    /**
+     * @brief Steps back one command.
+     * @return Its edits, to be applied last to first with their before values. Empty if there is nothing to undo.
+     */
+    [[nodiscard]] std::span<const EntityEdit> Undo();
+
+    /**
+     * @brief Steps forward one command.
+     * @return Its edits, to be applied first to last with their after values. Empty if there is nothing to redo.
+     */
+    [[nodiscard]] std::span<const EntityEdit> Redo();
+
+    void Clear();
+
+    [[nodiscard]] bool CanUndo() const noexcept { return m_applied > 0; }
+    [[nodiscard]] bool CanRedo() const noexcept { return m_applied < m_commands.size(); }
+    [[nodiscard]] size_t GetMemoryUsed() const noexcept { return m_memory_used; }
+
+private:
+    struct Command {
+        gouda::Vector<EntityEdit> edits;
+        u64 merge_key;
+    };
+
+    [[nodiscard]] static size_t GetCommandMemory(const Command &command);
+    void DropRedo();
+    void EnforceBudget();
+
+private:
+    std::deque<Command> m_commands; // Oldest first, the ones from m_applied on are undone
+    size_t m_applied;
+    size_t m_memory_budget;
+    size_t m_memory_used;   // Of the commands not open, the open one is counted once it ends
+    u64 m_merge_key;        // Of the command begun last
+    size_t m_merge_cursor;  // Where the next edit of an extended command is expected to match
+    bool m_is_recording;    // Between BeginCommand and EndCommand
+    bool m_is_command_open; // The command has recorded an edit and is the last one
+    bool m_is_extending;    // The open command is the one before it, merged into
+    bool m_can_merge;       // Nothing was undone or redone since the last command ended
+};
@@ -11,31 +11,39 @@
  * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
  * See <https://www.gnu.org/licenses/> for more information.
  */
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
 #include "core/state_stack.hpp"
 
 #include "debug/logger.hpp"
 
 #include "core/constants.hpp"
 #include "entities/entity.hpp"
+#include "entities/entity_store.hpp"
+#include "math/bvh.hpp"
+#include "math/spatial_grid.hpp"
 #include "state.hpp"
+#include "states/editor_history.hpp"
 #include "states_common.hpp"
 #include "ui/debug_panel.hpp"
+#include "ui/selection_tool.hpp"
 #include "ui/side_panel.hpp"
 #include "ui/top_panel.hpp"
+#include "ui/ui_batcher.hpp"
 #include "ui/ui_manager.hpp"
 #include "utils/filesystem.hpp"
 
+// A ring around the entity, one stroked rect shape that leaves the entity itself uncovered
 struct SelectionOutline {
     explicit SelectionOutline(const gouda::InstanceData &selected_instance, const f32 outline_size = 2.0f)
+        : instance{gouda::make_rect_shape({selected_instance.position.x - outline_size,
+                                           selected_instance.position.y - outline_size,
+                                           selected_instance.position.z - 0.01f},
+                                          selected_instance.size + outline_size * 2.0f,
+                                          colours::editor_entity_selection_colour, 0.0f, outline_size, true)}
     {
-        // TODO: Fix layering here.
-        instance.size = selected_instance.size + outline_size * 2.0f;
-        instance.position.x = selected_instance.position.x - outline_size;
-        instance.position.y = selected_instance.position.y - outline_size;
-        instance.position.z = selected_instance.position.z - 0.01f;
-        instance.texture_index = 0;
-        instance.apply_camera_effects = true;
-        instance.colour = colours::editor_entity_selection_colour;
     }
 
     gouda::InstanceData instance;
@@ -53,11 +61,11 @@ struct EditorSceneTab {
         // TODO: Update based on mouse position.
     }
 
-    void Draw(gouda::vk::Renderer &renderer, std::vector<gouda::InstanceData> &quad_instances, std::vector<gouda::TextData> &text_instances)
+    void Draw(gouda::vk::Renderer &renderer, std::vector<gouda::InstanceData> &quad_instances)
     {
         quad_instances.emplace_back(instance);
         // TODO: Calc position with padding etc...
-        renderer.DrawText(scene_name, {}, colours::editor_panel_primary_font_colour, 20.0f, 1, text_instances);
+        renderer.DrawText(scene_name, {}, colours::editor_panel_primary_font_colour, 20.0f, 1, quad_instances);
     }
 
     gouda::InstanceData instance;
@@ -74,14 +82,14 @@ struct EditorSceneTabBar {
         }
     }
 
-    void Draw(std::vector<gouda::InstanceData> &quad_instances, std::vector<gouda::TextData> &text_instances)
+    void Draw(std::vector<gouda::InstanceData> &quad_instances)
     {
         // Draw the bar/panel itself
         quad_instances.emplace_back(instance);
 
         // Draw each tab and its text
         for (auto &tab : tabs) {
-            tab.Draw(*shared_context.renderer, quad_instances, text_instances);
+            tab.Draw(*shared_context.renderer, quad_instances);
         }
     }
 
@@ -107,67 +115,248 @@ struct EditorSceneTabBar {
 class EditorState final : public State {
 public:
     explicit EditorState(SharedContext &context, StateStack &state_stack);
+    ~EditorState() override;
 
     void HandleInput() override;
     void Update(f32 delta_time) override;
-    void Render(f32 delta_time) override;
+    void Render(f32 delta_time, FrameDrawList &draw_list) override;
     void OnFrameBufferResize(const gouda::Vec2 &new_framebuffer_size) override;
     [[nodiscard]] bool IsOpaque() const override { return false; }
+    [[nodiscard]] bool IsAnimating() const override { return p_scene_load != nullptr; } // The load's progress bar
 
     void OnEnter() override;
     void OnExit() override;
 
+    // Loads in the background on the job system, the scene replaces the current one at the start of the first
+    // update after it finished. The editor keeps running and shows the progress meanwhile.
     void LoadScene(StringView scene_file_path);
+    // Appends the entities changed since the last save to the scene's journal, so saving scales with the edit. The
+    // scene file is rewritten in full, folding the journal into it, when saving to another file or the journal grew
+    // as long as the scene.
     void SaveScene(StringView scene_file_path);
 
 private:
+    // Polled from the input handler's action snapshot, bound to keys in OnEnter
+    enum class EditorAction : u8 {
+        ConfirmExit,
+        CancelExit,
+        ToggleSidePanel,
+        ToggleEntityPopups,
+        ToggleDebugPanel,
+        ToggleDebugUI,
+        ToggleGrid,
+        ToggleCsvCapture,
+        ToggleProfilerFreeze,
+        CaptureProfilerFrame,
+        TakeScreenshot,
+        ToggleFrameCapture,
+        Select,
+        Drag,
+        Undo,
+        Redo,
+        Modifier
+    };
+
     struct EditorScene {
         explicit EditorScene(StringView scene_file_path)
-            : scene_file_path{scene_file_path}, selected_entity{nullptr}, scene_changed{false}
+            : scene_file_path{scene_file_path},
+              selected_entity{std::nullopt},
+              scene_changed{false},
+              gpu_instances_dirty{true},
+              gpu_dirty_begin{0},
+              gpu_dirty_end{0},
+              entity_tree_dirty{true},
+              entity_grid{ENTITY_GRID_CELL_SIZE},
+              grid_entity_count{0},
+              history{app_constants::editor_undo_memory_budget},
+              journal_records{0},
+              journal_generation{0},
+              has_saved_file{false}
         {
         }
 
+        static constexpr f32 ENTITY_GRID_CELL_SIZE{500.0f};
+        static constexpr size_t MIN_TREE_REBUILD_GRID_ENTITIES{1024};
+
         void AddEntity(const Entity &entity)
         {
-            editor_entities.emplace_back(entity);
+            const size_t index{editor_entities.Add(entity)};
             scene_changed = true;
+            if (!entity_tree_dirty) {
+                entity_in_grid.push_back(0);
+                MarkEntityMoved(index);
+            }
+            MarkEntityDirty(index);
+        }
+
+        void MoveEntity(const size_t index, const gouda::Vec3 &position)
+        {
+            EditEntity(index, EntityField::Position, {position.x, position.y, position.z, 0.0f});
+        }
+
+        // Changes one field of an entity and records it in the history
+        void EditEntity(size_t index, EntityField field, const std::array<f32, 4> &value);
+
+        // Writes a field without recording it, for the history to step through its edits
+        void ApplyEntityField(size_t index, EntityField field, const std::array<f32, 4> &value);
+
+        [[nodiscard]] std::array<f32, 4> GetEntityField(size_t index, EntityField field) const;
+
+        // Added and moved entities go to the grid, the tree keeps where the rest were when it was built
+        void MarkEntityMoved(const size_t index)
+        {
+            if (entity_in_grid[index] == 0) {
+                entity_in_grid[index] = 1;
+                ++grid_entity_count;
+            }
+            entity_grid.Move(static_cast<u32>(index), editor_entities.GetBounds()[index]);
+        }
+
+        // Grows the range of entities the renderer's static copy is missing and queues the entity for the next save
+        void MarkEntityDirty(const size_t index)
+        {
+            gpu_dirty_begin = gpu_dirty_begin == gpu_dirty_end ? index : std::min(gpu_dirty_begin, index);
+            gpu_dirty_end = std::max(gpu_dirty_end, index + 1);
+
+            if (index >= entity_unsaved.size()) {
+                entity_unsaved.resize(index + 1, 0);
+            }
+            if (entity_unsaved[index] == 0) {
+                entity_unsaved[index] = 1;
+                unsaved_entities.push_back(static_cast<u32>(index));
+            }
+        }
+
+        // Rebuilds the picking tree once it was never built or a sizeable part of the scene has moved to the grid
+        void UpdateEntityTree()
+        {
+            const size_t rebuild_threshold{std::max(editor_entities.Size() / 4, MIN_TREE_REBUILD_GRID_ENTITIES)};
+            if (!entity_tree_dirty && grid_entity_count < rebuild_threshold) {
+                return;
+            }
+
+            entity_tree.Build(editor_entities.GetBounds());
+            entity_grid.Clear();
+            entity_in_grid.assign(editor_entities.Size(), 0);
+            grid_entity_count = 0;
+            entity_tree_dirty = false;
+        }
+
+        // Appends the entities whose bounds overlap the query, each once and in no particular order
+        void QueryEntities(const gouda::math::AABB2D &bounds, gouda::Vector<u32> &entities)
+        {
+            UpdateEntityTree();
+
+            // Entities in the grid are still in the tree where they were when it was built
+            const size_t first{entities.size()};
+            entity_tree.Query(bounds, entities);
+            const auto moved{std::remove_if(entities.begin() + static_cast<std::ptrdiff_t>(first), entities.end(),
+                                            [this](const u32 entity) { return entity_in_grid[entity] != 0; })};
+            entities.erase(moved, entities.end());
+
+            // The grid only narrows down to cells, its candidates are tested against the query here
+            const gouda::math::AABB2D query{
+                {gouda::math::min(bounds.min.x, bounds.max.x), gouda::math::min(bounds.min.y, bounds.max.y)},
+                {gouda::math::max(bounds.min.x, bounds.max.x), gouda::math::max(bounds.min.y, bounds.max.y)}};
+            const size_t grid_first{entities.size()};
+            entity_grid.Query(query, entities);
+            const std::span<const gouda::math::AABB2D> entity_bounds{editor_entities.GetBounds()};
+            const auto missed{std::remove_if(entities.begin() + static_cast<std::ptrdiff_t>(grid_first),
+                                             entities.end(), [&](const u32 entity) {
+                                                 return !entity_bounds[entity].Intersects(query);
+                                             })};
+            entities.erase(missed, entities.end());
         }
 
         [[nodiscard]] String GetSceneName() const { return gouda::fs::GetFileName(scene_file_path); }
 
         String scene_file_path;
-        gouda::Vector<Entity> editor_entities;
-        Entity *selected_entity; // TODO: Change this to a size_t index into the editor entities.
+        EntityStore editor_entities;
+        std::optional<size_t> selected_entity; // Index into editor_entities
+        gouda::Vector<u32> marquee_selection;  // Indices into editor_entities of the last marquee selection
         bool scene_changed;
+        bool gpu_instances_dirty; // The renderer has none of the entities yet, upload all of them
+        size_t gpu_dirty_begin;   // Entities in [gpu_dirty_begin, gpu_dirty_end) changed since the last upload
+        size_t gpu_dirty_end;
+        gouda::math::BoundingVolumeHierarchy entity_tree; // Entity ids are indices into editor_entities
+        gouda::Vector<u32> query_results;                 // Scratch for tree queries
+        bool entity_tree_dirty;                           // Never built, the grid is unused until it is
+        gouda::math::SpatialHashGrid entity_grid;         // Entities added or moved since the tree was built
+        gouda::Vector<u8> entity_in_grid;                 // Per entity, nonzero while the grid has it
+        size_t grid_entity_count;
+        EditorHistory history;
+
+        gouda::Vector<u32> unsaved_entities; // Changed since the last save, each listed once
+        gouda::Vector<u8> entity_unsaved;    // Per entity, nonzero while it is in unsaved_entities
+        size_t journal_records;              // Appended to the journal since the scene file was written in full
+        u32 journal_generation;              // Written to the scene file, journal records of another are stale
+        bool has_saved_file;                 // scene_file_path and its journal hold this scene as last saved
     };
 
-private:
-    void DrawEntityPopup();
-    void DrawExitConfirmationPopup();
+    // A scene being loaded by a job, the main thread reads only the progress until the counter is done
+    struct SceneLoad {
+        enum class Stage : u8 { Reading, Parsing, Building };
+
+        explicit SceneLoad(StringView scene_file_path)
+            : scene{scene_file_path}, stage{Stage::Reading}, entities_built{0}, entity_count{0}, is_loaded{false}
+        {
+        }
 
-    [[nodiscard]] Entity *PickTopEntityAt(const gouda::Vec2 &mouse_position) const;
+        EditorScene scene;
+        gouda::JobCounter counter;
+        std::atomic<Stage> stage;
+        std::atomic<u32> entities_built;
+        std::atomic<u32> entity_count;
+        bool is_loaded; // Written by the job, read once the counter is done
+    };
+
+private:
+    [[nodiscard]] bool WasActionPressed(EditorAction action) const;
+    static void LoadSceneFile(SceneLoad &load, gouda::JobSystem *job_system);
+    void FinishSceneLoad();
+    void AddDefaultScene(StringView scene_file_path);
+    void DrawSceneLoadProgress(FrameDrawList &draw_list);
+    static void ReplaySceneJournal(EditorScene &scene, std::vector<gouda::InstanceData> &instances,
+                                   std::vector<EntityType> &types);
+    [[nodiscard]] static bool WriteSceneFile(EditorScene &scene, StringView scene_file_path);
+    [[nodiscard]] static bool AppendSceneJournal(EditorScene &scene);
+    void DrawEntityPopup(FrameDrawList &draw_list);
+    void DrawExitConfirmationPopup(FrameDrawList &draw_list);
+
+    [[nodiscard]] std::optional<size_t> PickTopEntityAt(const gouda::Vec2 &mouse_position) const;
+    void HandleMarqueeSelection();
+    void HandleSelectionDrag();
+    void UndoEdit();
+    void RedoEdit();
+    void DrawMarqueeSelection(FrameDrawList &draw_list);
+    void DrawGrid(FrameDrawList &draw_list, const gouda::OrthographicCamera::FrustumData &frustum) const;
     void AddEntity(const Entity &entity);
     void ToggleSelectedEntityPopups();
     void RequestExit();
     void ToggleExitRequested();
-    void ClearInstances();
+    void UploadStaticInstances();
 
 private:
-    std::vector<gouda::InstanceData> m_quad_instances;
-    std::vector<gouda::TextData> m_text_instances;
-    std::vector<gouda::ParticleData> m_particles_instances;
+    std::vector<gouda::InstanceData> m_static_instances; // Scratch for uploading entities to the renderer
 
-    EditorScene *p_current_scene;
+    EditorScene *p_current_scene; // Null until the first scene is loaded
     gouda::Vector<EditorScene> m_editor_scenes;
+    std::unique_ptr<SceneLoad> p_scene_load; // Null unless a load is running
 
     TopPanel m_top_menu;
     SidePanel m_side_panel;
     DebugPanel m_debug_panel;
+    UIBatcher m_ui_batcher;
+    SelectionTool m_selection_tool;
+    gouda::Vec2 m_drag_mouse_position; // Where the selection was last moved to
+    u64 m_drag_count;                  // Merge key of the drag in progress, each drag undoes as one step
 
     UIManager m_ui_manager;
 
     bool m_auto_save;
+    f32 m_auto_save_elapsed; // Seconds since the last auto save
     bool m_scene_modified; // TODO: Move scene modified to EditorScene struct.
     bool m_exit_requested;
     bool m_show_entity_popups;
+    bool m_show_grid;
 };
@@ -31,7 +31,7 @@ public:
 
     void HandleInput() override;
     void Update(f32 delta_time) override;
-    void Render(f32 delta_time) override;
+    void Render(f32 delta_time, FrameDrawList &draw_list) override;
     void OnFrameBufferResize(const gouda::Vec2 &new_framebuffer_size) override;
     [[nodiscard]] bool IsOpaque() const override { return false; }
 
@@ -40,7 +40,7 @@ public:
 
 private:
     std::vector<gouda::InstanceData> m_quad_instances;
-    std::vector<gouda::TextData> m_text_instances;
+    std::vector<gouda::InstanceData> m_text_instances;
     std::vector<gouda::ParticleData> m_particles_instances;
 
 };
@@ -17,11 +17,11 @@
 class IntroState final : public State {
 public:
     explicit IntroState(SharedContext &context, StateStack &state_stack);
-    ~IntroState() override = default;
+    ~IntroState() override;
 
     void HandleInput() override;
     void Update(f32 delta_time) override;
-    void Render(f32 delta_time) override;
+    void Render(f32 delta_time, FrameDrawList &draw_list) override;
     void OnFrameBufferResize(const gouda::Vec2 &new_framebuffer_size) override;
     [[nodiscard]] bool IsOpaque() const override { return false; }
 
@@ -29,12 +29,15 @@ public:
     void OnExit() override;
 
 private:
+    static constexpr u32 TITLE_FONT_ID{2};
+
     void TransitionToMainMenu() const;
+    void LayoutTitle(); // Again whenever its font is hot reloaded
 
 private:
     std::vector<gouda::InstanceData> m_quad_instances;
-    std::vector<gouda::TextData> m_text_instances;
-    std::vector<gouda::ParticleData> m_particles_instances;
+    std::vector<gouda::InstanceData> m_text_instances;
 
     f32 m_current_time;
+    gouda::AssetDependentID m_title_dependent;
 };
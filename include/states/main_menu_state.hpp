@@ -21,9 +21,10 @@ public:
 
     void HandleInput() override;
     void Update(f32 delta_time) override;
-    void Render(f32 delta_time) override;
+    void Render(f32 delta_time, FrameDrawList &draw_list) override;
     void OnFrameBufferResize(const gouda::Vec2 &new_framebuffer_size) override;
     [[nodiscard]] bool IsOpaque() const override { return false; }
+    [[nodiscard]] bool IsAnimating() const override { return false; }
 
     void OnEnter() override;
     void OnExit() override;
@@ -35,8 +36,7 @@ private:
 
 private:
     std::vector<gouda::InstanceData> m_quad_instances;
-    std::vector<gouda::TextData> m_text_instances;
-    std::vector<gouda::ParticleData> m_particles_instances;
+    std::vector<gouda::InstanceData> m_text_instances;
 
     std::vector<ButtonBounds> m_button_bounds; // For input detection
 };
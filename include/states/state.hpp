@@ -11,26 +11,44 @@
  * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
  * See <https://www.gnu.org/licenses/> for more information.
  */
+#include <vector>
+
 #include "core/types.hpp"
 #include "math/math.hpp"
+#include "utils/asset_registry.hpp"
 
+struct FrameDrawList;
 struct SharedContext;
 class StateStack;
 
+// Files a state loads, so the stack can start on them while the state before it is still running
+struct StateAssetManifest {
+    std::vector<String> textures; // Image files, loaded asynchronously
+    std::vector<String> sounds;   // Sound effects, decoded in the background by the sound bank
+};
+
 class State {
 public:
     using StateID = StringView;
 
     explicit State(SharedContext& context, StateStack &state_stack, StringView identifier);
-    virtual ~State() = default;
+    virtual ~State(); // Releases the manifest's assets
 
     virtual void HandleInput() = 0;
-    virtual void Update(f32 delta_time) = 0;
-    virtual void Render(f32 delta_time) = 0;
+    virtual void Update(f32 delta_time) = 0; // Fixed step, may run beside the render thread so leaves the renderer be
+    virtual void Render(f32 delta_time, FrameDrawList &draw_list) = 0; // Appends what the state draws this frame
     virtual void OnFrameBufferResize(const gouda::Vec2 &new_framebuffer_size) = 0;
 
     [[nodiscard]] virtual bool IsOpaque() const { return true; }
+    // Whether the state draws something different from one frame to the next without any input. While no visible
+    // state is, the application skips drawing the frames nothing else changed in.
+    [[nodiscard]] virtual bool IsAnimating() const { return true; }
     [[nodiscard]] virtual StringView GetID() const { return m_state_id; }
+    [[nodiscard]] virtual StateAssetManifest GetAssetManifest() const { return {}; }
+
+    // Starts loading the manifest in the background, called by StateStack::Preload before the state is entered. The
+    // state holds a reference to each asset until it is destroyed.
+    void PreloadAssets();
 
     virtual void OnEnter() {} // TODO: Implement debug logging here
     virtual void OnExit() {}
@@ -40,5 +58,9 @@ protected:
     StateStack &m_state_stack;
     gouda::Vec2 m_framebuffer_size;
     String m_state_id;
+
+private:
+    gouda::Vector<gouda::TextureHandle> m_manifest_textures;
+    gouda::Vector<gouda::SoundHandle> m_manifest_sounds;
 };
 
@@ -11,6 +11,7 @@
  * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
  * See <https://www.gnu.org/licenses/> for more information.
  */
+#include "containers/flat_hash_map.hpp"
 #include "containers/small_vector.hpp"
 #include "core/types.hpp"
 #include "math/collision.hpp"
@@ -26,7 +27,7 @@ struct GridPos {
     };
 };
 
-using SpatialGrid = std::unordered_map<GridPos, gouda::Vector<size_t>, GridPos::Hash>;
+using SpatialGrid = gouda::FlatHashMap<GridPos, gouda::Vector<size_t>, GridPos::Hash>;
 
 struct GridRange {
     s32 min_x;
@@ -11,15 +11,23 @@
  * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
  * See <https://www.gnu.org/licenses/> for more information.
  */
+#include <chrono>
+#include <format>
+
 #include "core/constants.hpp"
 #include "core/state_stack.hpp"
+#include "debug/frame_statistics.hpp"
+#include "memory/memory_tracker.hpp"
 #include "renderers/render_data.hpp"
+#include "ui/ui_batcher.hpp"
+#include "utils/hash.hpp"
 
 // TODO: Add padding to constructor
 struct DebugPanel {
     DebugPanel(SharedContext &shared_context, const gouda::Vec2 &size,
                const gouda::Colour<f32> &colour, const u32 font_id, const f32 font_scale)
-        : context{shared_context}, font_id{font_id}, font_scale{font_scale}, padding{5.0f}, display{false}
+        : context{shared_context}, font_id{font_id}, font_scale{font_scale}, padding{5.0f}, display{false},
+          screenshot_time{}, screenshot_index{0}
     {
         instance.size = size;
 
@@ -32,32 +40,101 @@ struct DebugPanel {
         instance.apply_camera_effects = false;
     }
 
-    void Draw(std::vector<gouda::InstanceData> &quad_instances,
-                        std::vector<gouda::TextData> &text_instances)
+    // Only the lines whose numbers changed since the last frame are laid out again
+    void Draw(UIBatcher &batcher)
     {
         if (!display) {
             return;
         }
 
         // Draw the panel
-        quad_instances.emplace_back(instance);
+        constexpr u64 panel_id{gouda::utils::fnv1a("debug_panel")};
+        batcher.AddQuad(panel_id, instance);
+
+        // Draw the text, frame time distributions over the statistics window in milliseconds
+        const gouda::FrameStatistics &statistics{*context.frame_statistics};
+        gouda::Vector<String> lines{"ms p50 p95 p99 max"};
+        for (size_t metric = 0; metric < gouda::FRAME_METRIC_COUNT; ++metric) {
+            const auto frame_metric{static_cast<gouda::FrameMetric>(metric)};
+            const gouda::FrameMetricSummary &summary{statistics.GetSummary(frame_metric)};
+            lines.push_back(String{gouda::FrameStatistics::GetMetricName(frame_metric)});
+            lines.push_back(std::format(" {:.2f} {:.2f} {:.2f} {:.2f}", summary.p50, summary.p95, summary.p99,
+                                        summary.max));
+        }
+        lines.push_back(std::format("Hitches {}/{}",
+                                    statistics.GetSummary(gouda::FrameMetric::CpuFrameTime).hitch_count,
+                                    statistics.GetSampleCount()));
+        if (statistics.IsCapturing()) {
+            lines.push_back("Capturing CSV");
+        }
+        if (const gouda::utils::QualityGovernor &governor{*context.quality_governor}; governor.IsEnabled()) {
+            lines.push_back(std::format("Quality CPU {} GPU {}", governor.GetCpuLevel(), governor.GetGpuLevel()));
+        }
 
-        // Draw the text
-        //gouda::vk::RenderStatistics render_statistics = context.renderer->GetRenderStatistics();
+        // Memory per tag in MiB and allocations during the last frame, tags over their budget are marked
+        const gouda::MemoryTracker &memory{gouda::MemoryTracker::Get()};
+        lines.push_back("MiB live peak allocs");
+        for (size_t tag = 0; tag < gouda::MEMORY_TAG_COUNT; ++tag) {
+            const auto memory_tag{static_cast<gouda::MemoryTag>(tag)};
+            const gouda::MemoryTagStats &stats{memory.GetStats(memory_tag)};
+            const bool is_over_budget{stats.budget_bytes != 0 && stats.live_bytes > stats.budget_bytes};
+            constexpr f64 bytes_per_mebibyte{1024.0 * 1024.0};
+            lines.push_back(std::format("{}{} {:.1f} {:.1f} {}", is_over_budget ? "!" : "",
+                                        gouda::MemoryTracker::GetTagName(memory_tag),
+                                        static_cast<f64>(stats.live_bytes) / bytes_per_mebibyte,
+                                        static_cast<f64>(stats.peak_bytes) / bytes_per_mebibyte,
+                                        stats.frame_allocations));
+        }
 
         f32 current_position_y{instance.position.y + instance.size.y};
-        gouda::Vector<String> lines = {"HELLO", "WORLD", "PIPE"};
 
-        for (const auto &line : lines) {
+        for (size_t i = 0; i < lines.size(); ++i) {
             current_position_y -= font_scale;
             const gouda::Vec3 position{instance.position.x + padding.x, current_position_y, -0.1f};
-            context.renderer->DrawText(line, position, colours::editor_panel_primary_font_colour, font_scale,
-                                              font_id, text_instances);
+            batcher.AddText(panel_id + 1 + i, *context.renderer, lines[i], position,
+                            colours::editor_panel_primary_font_colour, font_scale, font_id);
         }
     }
 
     void ToggleVisibility() { display = !display; }
 
+    // Each capture gets its own file, named after the time it started
+    void ToggleCsvCapture()
+    {
+        gouda::FrameStatistics &statistics{*context.frame_statistics};
+        if (statistics.IsCapturing()) {
+            statistics.StopCsvCapture();
+            return;
+        }
+
+        const auto now{std::chrono::floor<std::chrono::seconds>(std::chrono::system_clock::now())};
+        statistics.StartCsvCapture(std::format("{}/frames_{:%Y%m%d_%H%M%S}.csv", filepath::frame_statistics_directory,
+                                               now));
+    }
+
+    // Named after the time they were taken, like the CSV captures, a burst within one second gets its own index
+    void TakeScreenshot()
+    {
+        const auto now{std::chrono::floor<std::chrono::seconds>(std::chrono::system_clock::now())};
+        screenshot_index = now == screenshot_time ? screenshot_index + 1 : 0;
+        screenshot_time = now;
+        context.renderer->CaptureScreenshot(std::format("{}/screenshot_{:%Y%m%d_%H%M%S}_{}.png",
+                                                        filepath::screenshot_directory, now, screenshot_index));
+    }
+
+    // Every frame until toggled off, into a directory of numbered PNG files per capture
+    void ToggleFrameCapture()
+    {
+        gouda::vk::Renderer &renderer{*context.renderer};
+        if (renderer.IsCapturingFrames()) {
+            renderer.StopFrameCapture();
+            return;
+        }
+
+        const auto now{std::chrono::floor<std::chrono::seconds>(std::chrono::system_clock::now())};
+        renderer.StartFrameCapture(std::format("{}/capture_{:%Y%m%d_%H%M%S}", filepath::frame_capture_directory, now));
+    }
+
     SharedContext &context;
     gouda::InstanceData instance;
 
@@ -66,4 +143,6 @@ struct DebugPanel {
     gouda::Vec2 padding;
     gouda::Colour<f32> text_colour;
     bool display;
+    std::chrono::sys_seconds screenshot_time;
+    u32 screenshot_index;
 };
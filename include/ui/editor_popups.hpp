@@ -47,7 +47,7 @@ struct ExitConfirmationPopup : EditorPopUp {
                           const gouda::Colour<f32> &colour, u32 texture_index, const gouda::Vec2 &padding,
                           u32 font_id, f32 font_scale, const gouda::Colour<f32> &font_colour);
 
-    void Draw(std::vector<gouda::InstanceData> &quad_instances, std::vector<gouda::TextData> &text_instances);
+    void Draw(std::vector<gouda::InstanceData> &quad_instances);
 };
 
 class EntityPopup : EditorPopUp {
@@ -58,7 +58,7 @@ public:
 
     void HandleInput();
     void Update(f32 delta_time);
-    void Draw(std::vector<gouda::InstanceData> &quad_instances, std::vector<gouda::TextData> &text_instances);
+    void Draw(std::vector<gouda::InstanceData> &quad_instances);
 
 private:
     Entity *entity;
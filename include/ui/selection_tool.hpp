@@ -11,11 +11,11 @@
  * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
  * See <https://www.gnu.org/licenses/> for more information.
  */
+#include <vector>
+
+#include "math/collision.hpp"
 #include "math/math.hpp"
 #include "renderers/render_data.hpp"
-#include "containers/small_vector.hpp"
-
-struct Entity;
 
 class SelectionTool {
 public:
@@ -23,9 +23,10 @@ public:
 
     void BeginSelection(const gouda::Vec2 &start);
     void UpdateSelection(const gouda::Vec2 &end);
-    void EndSelection(const std::vector<Entity*>& all_entities);
+    // The dragged box with min <= max, for the caller to query its spatial index with
+    [[nodiscard]] gouda::math::AABB2D EndSelection();
 
-    void Draw(gouda::Vector<gouda::InstanceData>& quad_instances);
+    void Draw(std::vector<gouda::InstanceData> &quad_instances);
 
     void Reset();
 
@@ -33,10 +34,10 @@ public:
 
 private:
     gouda::InstanceData m_selection_box_instance;
+    gouda::InstanceData m_selection_outline_instance;
 
     gouda::Vec2 m_start;
     gouda::Vec2 m_end;
-    gouda::Vector<Entity *> m_selected;
 
     bool m_selecting;
 };
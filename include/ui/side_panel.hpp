@@ -15,6 +15,8 @@
 #include "core/state_stack.hpp"
 #include "core/types.hpp"
 #include "math/easing.hpp"
+#include "ui/ui_batcher.hpp"
+#include "utils/tween_system.hpp"
 
 enum class PanelSide : u8 { Left, Right };
 
@@ -24,6 +26,10 @@ public:
               const gouda::Colour<f32> &colour, StringView title, u32 font_id, const gouda::Colour<f32> &title_colour,
               f32 title_scale, PanelSide side = PanelSide::Right,
               gouda::math::easing::EasingType easing_type = gouda::math::easing::EasingType::Linear);
+    ~SidePanel();
+
+    SidePanel(const SidePanel &) = delete; // The slide tween writes into the panel
+    SidePanel &operator=(const SidePanel &) = delete;
 
     void ToggleVisibility();
     void SetSide(PanelSide side);
@@ -33,13 +39,28 @@ public:
         m_easing_type = type;
     }
 
-    void Update(f32 delta_time);
-    void Draw(std::vector<gouda::InstanceData> &quad_instances, std::vector<gouda::TextData> &text_instances) const;
+    // The title and an asset browser of every loaded texture and atlas sprite. Thumbnails are made in the background
+    // the first time they are drawn, a placeholder shows until they are ready.
+    void Draw(UIBatcher &batcher);
 
     void OnFramebufferResize(const gouda::Vec2 &new_size);
 
 private:
-    void UpdatePosition(f32 delta_time);
+    static constexpr f32 CORNER_RADIUS{8.0f};
+    static constexpr f32 THUMBNAIL_SLOT_SIZE{64.0f};
+    static constexpr f32 THUMBNAIL_SLOT_GAP{8.0f};
+
+    struct BrowserAsset {
+        String image_filepath;
+        gouda::UVRect<f32> source_rect; // A sprite's, {0, 0, 1, 1} for a whole texture
+    };
+
+    void RefreshAssets(); // Lists what the texture manager holds
+    void DrawAssets(UIBatcher &batcher, u64 first_id);
+
+    [[nodiscard]] f32 GetClosedX() const { return m_panel_side == PanelSide::Right ? m_screen_size.x : -m_size.x; }
+    [[nodiscard]] f32 GetOpenX() const { return m_panel_side == PanelSide::Right ? m_screen_size.x - m_size.x : 0.0f; }
+    [[nodiscard]] bool IsAnimating() const { return m_shared_context.tweens->IsActive(m_slide_tween); }
 
 private:
     SharedContext &m_shared_context;
@@ -48,10 +69,9 @@ private:
     gouda::math::easing::EasingType m_easing_type;
 
     // TODO: Set this in the constructor
-    f32 m_transition_time{0.5f}; // total time for open/close
-    f32 m_animation_timer{0.0f}; // tracks time in animation
-    bool m_is_open{false};       // target state
-    bool m_is_animating{false};  // whether animation is in progress
+    f32 m_transition_time{0.5f};      // total time for open/close
+    bool m_is_open{false};            // target state
+    gouda::TweenHandle m_slide_tween; // Of m_instance_data.position.x, stale once the slide ends
 
     gouda::Vec2 m_size; // fixed panel size
     gouda::Vec2 m_padding;
@@ -60,6 +80,9 @@ private:
     String m_title;
     u32 m_font_id;
     gouda::Colour<f32> m_text_colour;
-    gouda::Vec3 m_title_position;
+    gouda::Vec3 m_title_position; // x follows the panel, see Draw
     f32 m_text_scale;
+
+    gouda::Vector<BrowserAsset> m_assets;
+    u32 m_asset_texture_count{0}; // Textures loaded when m_assets was listed, it is listed again once that changes
 };
@@ -13,6 +13,9 @@
  */
 #include "core/state_stack.hpp"
 #include "renderers/render_data.hpp"
+#include "ui/ui_batcher.hpp"
+#include "utils/hash.hpp"
+#include "utils/tween_system.hpp"
 
 struct TopPanelButton {
     TopPanelButton() = default;
@@ -22,12 +25,11 @@ struct TopPanelButton {
         // Handle onclick etc... as buttons may handle a menu??
     }
 
-    void Render(gouda::vk::Renderer &renderer, std::vector<gouda::InstanceData> &quad_instances,
-                std::vector<gouda::TextData> &text_instances)
+    // Draws as the widgets id and id + 1
+    void Render(gouda::vk::Renderer &renderer, UIBatcher &batcher, const u64 id) const
     {
-        quad_instances.emplace_back(instance);
-
-        renderer.DrawText(button_text, {}, colours::editor_panel_primary_font_colour, 20.0f, 1, text_instances);
+        batcher.AddQuad(id, instance);
+        batcher.AddText(id + 1, renderer, button_text, {}, colours::editor_panel_primary_font_colour, 20.0f, 1);
     }
 
     gouda::InstanceData instance;
@@ -48,27 +50,30 @@ public:
           m_font_scale{font_scale},
           m_font_colour{font_colour},
           m_transition_time{0.5f},
-          m_animation_timer{0.0f},
           m_is_open{true},
-          m_is_animating{false},
           m_auto_hide{false}
     {
         m_window_size = {static_cast<f32>(context.window->GetWindowSize().width),
                          static_cast<f32>(context.window->GetWindowSize().height)};
 
-        m_instance.position = {0.0f, m_window_size.y - height, -0.9f};
-        m_instance.size = {m_window_size.x, height};
-        m_instance.colour = colour;
-        m_instance.apply_camera_effects = false;
+        m_instance = gouda::make_rect_shape({0.0f, m_window_size.y - height, -0.9f}, {m_window_size.x, height}, colour);
     }
 
+    ~TopPanel() { m_context.tweens->Remove(m_slide_tween); }
+
+    TopPanel(const TopPanel &) = delete; // The slide tween writes into the panel
+    TopPanel &operator=(const TopPanel &) = delete;
+
     void AddButton(const TopPanelButton &button) { m_buttons.emplace_back(button); }
 
     void Toggle()
     {
+        // Starts from wherever the panel is, so toggling mid slide turns it around
         m_is_open = !m_is_open;
-        m_is_animating = true;
-        m_animation_timer = 0.0f;
+        m_context.tweens->Remove(m_slide_tween);
+        const f32 target_y{m_is_open ? m_window_size.y - m_instance.size.y : m_window_size.y};
+        m_slide_tween = m_context.tweens->Add(m_instance.position.y, target_y, m_transition_time,
+                                              gouda::math::easing::EasingType::EaseInOutCubic, &m_instance.position.y);
     }
 
     void Open()
@@ -92,7 +97,7 @@ public:
 
         const bool is_hovered = mouse_position.y >= m_instance.position.y;
 
-        if (m_auto_hide && !m_is_animating) {
+        if (m_auto_hide && !m_context.tweens->IsActive(m_slide_tween)) {
             if (!m_is_open && is_hovered) {
                 Toggle(); // Slide down
             }
@@ -102,54 +107,23 @@ public:
         }
     }
 
-    void Update(const f32 delta_time)
-    {
-        if (!m_is_animating) {
-            return;
-        }
-
-        m_animation_timer += delta_time;
-
-        f32 t = gouda::math::min(m_animation_timer / m_transition_time, 1.0f);
-        t = gouda::math::easing::ApplyEasing(t, gouda::math::easing::EasingType::EaseInOutCubic);
-
-        UpdatePosition(t);
-
-        if (m_animation_timer >= m_transition_time) {
-            m_is_animating = false;
-            UpdatePosition(1.0f); // Snap to final position
-        }
-    }
-
-    void Draw(std::vector<gouda::InstanceData> &quad_instances, std::vector<gouda::TextData> &text_instances)
+    void Draw(UIBatcher &batcher) const
     {
-        if (!m_is_open) {
+        if (!m_is_open && !m_context.tweens->IsActive(m_slide_tween)) {
             return;
         }
 
         // Draw the panel
-        quad_instances.emplace_back(m_instance);
+        constexpr u64 panel_id{gouda::utils::fnv1a("top_panel")};
+        batcher.AddQuad(panel_id, m_instance);
 
-        for (auto &button : m_buttons) {
-            button.Render(*m_context.renderer, quad_instances, text_instances);
+        for (size_t i = 0; i < m_buttons.size(); ++i) {
+            m_buttons[i].Render(*m_context.renderer, batcher, panel_id + 1 + i * 2);
         }
     }
 
     [[nodiscard]] gouda::Vec2 GetSize() const { return m_instance.size; }
 
-private:
-    void UpdatePosition(const f32 t)
-    {
-        const f32 open_y = m_window_size.y - m_instance.size.y;
-        const f32 closed_y = m_window_size.y;
-
-        // Lerp between closed and open
-        const f32 target_y =
-            m_is_open ? gouda::math::lerp(closed_y, open_y, t) : gouda::math::lerp(open_y, closed_y, t);
-
-        m_instance.position.y = target_y;
-    }
-
 private:
     SharedContext &m_context;
     gouda::InstanceData m_instance;
@@ -162,9 +136,8 @@ private:
     f32 m_font_scale;
     gouda::Colour<f32> m_font_colour;
 
-    f32 m_transition_time; // Total time for open/close
-    f32 m_animation_timer; // Tracks time in animation
-    bool m_is_open;        // Target state
-    bool m_is_animating;   // Whether animation is in progress
-    bool m_auto_hide;      // Auto hide until hovered
+    f32 m_transition_time;            // Total time for open/close
+    bool m_is_open;                   // Target state
+    bool m_auto_hide;                 // Auto hide until hovered
+    gouda::TweenHandle m_slide_tween; // Of m_instance.position.y, stale once the slide ends
 };
@@ -0,0 +1,93 @@
+#pragma once
+/**
+ * @file ui/ui_batcher.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Application immediate mode ui batcher module
+ *
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <vector>
+
+#include "containers/small_vector.hpp"
+#include "core/types.hpp"
+#include "math/collision.hpp"
+#include "renderers/render_data.hpp"
+#include "renderers/text.hpp"
+
+namespace gouda::vk {
+class Renderer;
+}
+
+/**
+ * @class UIBatcher
+ * @brief Collects the UI a state draws every frame into one contiguous range of quads, glyphs included.
+ *
+ * Drawing is immediate mode: every frame the UI is submitted again, widget by widget, each under an id that stays the
+ * same from one frame to the next. The batcher keeps what every widget produced last frame along with a hash of what
+ * it was submitted with. A widget submitted as it was last frame costs the hash, its instances are reused where they
+ * are. Only the widgets whose inputs or clip rect changed are laid out and clipped again and spliced back into the
+ * range, so a panel whose text ticks over every frame rebuilds that one line. Glyphs are quads like the panels they
+ * are drawn on and stay after them in widget order, which the renderer keeps where their depths are equal.
+ *
+ * Clip rects nest, each pushed rect is intersected with the one around it. Quads are cut to the rect, atlas quads have
+ * their sprite rect cut with them. Shapes are cut like untextured quads and take their edge along the cut, so a line
+ * shape should not cross one. Glyphs are kept or dropped whole.
+ */
+class UIBatcher {
+public:
+    UIBatcher();
+
+    /**
+     * @brief Clips the widgets submitted until the matching PopClipRect.
+     * @param rect Screen space bounds with min <= max.
+     */
+    void PushClipRect(const gouda::math::AABB2D &rect);
+    void PopClipRect();
+
+    void AddQuad(u64 id, const gouda::InstanceData &quad);
+
+    // Laid out by the renderer, which is only called when the text or anything else about it changed
+    void AddText(u64 id, gouda::vk::Renderer &renderer, StringView text, const gouda::Vec3 &position,
+                 const gouda::Colour<f32> &colour, f32 scale, u32 font_id,
+                 gouda::TextAlign alignment = gouda::TextAlign::Left);
+
+    /**
+     * @brief Ends the frame, appending the UI to the list. Widgets that were not submitted this frame are dropped.
+     */
+    void Flush(std::vector<gouda::InstanceData> &quad_instances);
+
+    /**
+     * @brief Forgets every widget, for when the whole UI changes at once such as on a framebuffer resize.
+     */
+    void Clear();
+
+    [[nodiscard]] u32 GetRebuiltWidgetCount() const noexcept { return m_rebuilt_widget_count; } ///< Last frame
+
+private:
+    struct Widget {
+        u64 id;
+        u64 input_hash; // What it was submitted with, clip rect included
+        u32 quad_count;
+    };
+
+    // Finds or makes the widget for id at the cursor. False if its instances from last frame can be kept as they are.
+    [[nodiscard]] bool BeginWidget(u64 id, u64 input_hash);
+    void EndWidget();
+    void EraseWidgets(size_t first, size_t last);
+
+private:
+    gouda::Vector<Widget> m_widgets;                 // In submission order
+    std::vector<gouda::InstanceData> m_quads;        // Every widget's quads and glyphs in widget order
+    std::vector<gouda::InstanceData> m_widget_quads; // The widget being rebuilt
+    gouda::Vector<gouda::math::AABB2D> m_clip_rects;
+
+    size_t m_cursor;      // The next widget expected this frame
+    size_t m_quad_cursor; // Where its quads start
+    u32 m_rebuilding_widget_count;
+    u32 m_rebuilt_widget_count;
+};
@@ -3,8 +3,19 @@
 #include "AL/al.h"
 #include "sndfile.h"
 
+#include "core/types.hpp"
+
 namespace gouda::audio {
 
+/**
+ * @brief Represents a 3D vector used for sound positioning.
+ */
+struct Vec3 {
+    f32 x; ///< X-coordinate of the vector.
+    f32 y; ///< Y-coordinate of the vector.
+    f32 z; ///< Z-coordinate of the vector.
+};
+
 const char *FormatName(ALenum format);
 bool IsValidAudioExtension(std::string_view filepath);
 bool HandleError(SNDFILE *&p_file);
@@ -3,9 +3,22 @@
 #include <AL/al.h>
 #include <AL/alc.h>
 
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <thread>
+
 #include "core/types.hpp"
 #include "music_track.hpp"
 #include "sound_effect.hpp"
+#include "voice_manager.hpp"
+#include "containers/flat_hash_map.hpp"
+#include "containers/mpsc_queue.hpp"
 #include "containers/small_vector.hpp"
 
 // TODO: Add paused state m_music_paused
@@ -20,16 +33,52 @@
 
 namespace gouda::audio {
 
+enum class AudioEffectType : u8 { Reverb, Echo, Distortion, Chorus, Flanger, None };
+
+inline constexpr size_t AUDIO_EFFECT_COUNT{static_cast<size_t>(AudioEffectType::None)};
+inline constexpr size_t MAX_EFFECT_CHAIN_LENGTH{4};
+
 /**
- * @brief Represents a 3D vector used for sound positioning.
+ * @struct EffectChain
+ * @brief A precomposed set of effects sounds are sent through together, such as reverb and echo for a cave.
+ *
+ * A value packed into one integer, so any thread can build a chain once and every sound played with it carries it by
+ * copy. The audio thread resolves each chain to its effect slots the first time it is played and caches it, after
+ * which a sound only points the sends of its source at the slots, and not at all when the source last played the
+ * same chain. Each effect appears once, None and effects past MAX_EFFECT_CHAIN_LENGTH are dropped.
  */
-struct Vec3 {
-    f32 x; ///< X-coordinate of the vector.
-    f32 y; ///< Y-coordinate of the vector.
-    f32 z; ///< Z-coordinate of the vector.
-};
+struct EffectChain {
+    u32 key{0}; ///< Effect type plus one per byte, the first effect in the lowest byte, 0 for no effects.
 
-enum class AudioEffectType : u8 { Reverb, Echo, Distortion, Chorus, Flanger, None };
+    EffectChain() = default;
+    explicit EffectChain(const std::span<const AudioEffectType> effects)
+    {
+        size_t length{0};
+        for (const AudioEffectType effect : effects) {
+            if (effect != AudioEffectType::None && length < MAX_EFFECT_CHAIN_LENGTH && !Contains(effect)) {
+                key |= (static_cast<u32>(effect) + 1) << (length++ * 8);
+            }
+        }
+    }
+
+    [[nodiscard]] size_t GetLength() const noexcept { return (static_cast<size_t>(std::bit_width(key)) + 7) / 8; }
+    [[nodiscard]] bool IsEmpty() const noexcept { return key == 0; }
+
+    [[nodiscard]] AudioEffectType operator[](const size_t index) const noexcept
+    {
+        return static_cast<AudioEffectType>(((key >> (index * 8)) & 0xFF) - 1);
+    }
+
+    [[nodiscard]] bool Contains(const AudioEffectType effect) const noexcept
+    {
+        for (size_t i = 0; i < GetLength(); ++i) {
+            if ((*this)[i] == effect) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
 
 struct AudioEffects {
     struct EffectData {
@@ -65,6 +114,40 @@ struct AudioEffects {
     }
 };
 
+/**
+ * @struct OcclusionQuery
+ * @brief A positioned sound whose line to the listener the audio thread wants checked for obstacles.
+ */
+struct OcclusionQuery {
+    u64 voice;     ///< Identifies the play of the sound, handed back with its result.
+    Vec3 position; ///< Of the sound, in the coordinates sounds are played at.
+};
+
+struct OcclusionResult {
+    u64 voice;
+    f32 occlusion; ///< 0 for a clear line to the listener, 1 for a fully blocked one.
+};
+
+/**
+ * @struct MusicStreamSettings
+ * @brief How much decoded music is kept queued ahead of playback.
+ *
+ * More latency survives longer stalls of the audio thread, less makes track changes and seeks respond sooner. The
+ * latency is split evenly over the buffers, each refilled as soon as it finished playing, so more buffers keep the
+ * queue fuller between refills at the cost of more OpenAL calls.
+ *
+ * The start of the next track in the queue is decoded a buffer at a time while the current one plays, so a track
+ * change copies frames decoded already rather than decoding a whole queue of buffers at once. Tracks of the same
+ * format and sample rate follow each other on the same source without a gap, or crossfade over the last
+ * crossfade_time seconds of the first.
+ */
+struct MusicStreamSettings {
+    f32 target_latency{0.25f}; ///< Seconds of music queued per track.
+    u32 buffer_count{4};       ///< At least 2, so one buffer plays while another is refilled.
+    f32 prefetch_time{2.0f};   ///< Seconds of the next track decoded ahead, 0 decodes it when the current one ends.
+    f32 crossfade_time{0.0f};  ///< Seconds the end of a track overlaps the next, 0 cuts straight to it.
+};
+
 /**
  * @class AudioManager
  * @brief Manages audio playback including sound effects and music tracks.
@@ -72,9 +155,18 @@ struct AudioEffects {
  * The AudioManager class allows for playing sound effects, music tracks, and managing the audio settings.
  * It supports functionalities like volume control, pitch adjustments, music looping, and positioning of sound effects
  * in 3D space.
+ *
+ * Music is decoded and streamed by an audio thread started in Initialize, which wakes on its own cadence so a long
+ * frame on the main thread cannot starve the buffer queue. The music functions only post a command to a lock free
+ * queue the audio thread drains before each refill, so they never touch OpenAL and return immediately.
+ *
+ * Sound effects work the same way through a second queue, which any thread may post to, so gameplay jobs can fire
+ * sounds. The audio thread assigns sources to everything posted since its last wake and starts them with one call.
  */
 class AudioManager {
 public:
+    static constexpr size_t MAX_SOUND_EFFECT_SENDS = MAX_EFFECT_CHAIN_LENGTH; ///< Effects a sound can be played with.
+
     /**
      * @brief Default constructor for AudioManager.
      */
@@ -96,8 +188,12 @@ public:
      *
      * This function sets up the OpenAL device and context, prepares audio sources, and initializes buffers for music
      * streaming.
+     *
+     * @param stream_settings Buffering of the music stream, the buffers are sized for each track's sample rate.
+     * @param voice_settings Distance attenuation of positioned sounds and the gain below which sounds are dropped.
      */
-    void Initialize(f32 sound_volume = 1.0f, f32 music_volume = 1.0f);
+    void Initialize(f32 sound_volume = 1.0f, f32 music_volume = 1.0f, const MusicStreamSettings &stream_settings = {},
+                    const VoiceSettings &voice_settings = {});
 
     /**
      * @brief Plays a sound effect.
@@ -106,11 +202,22 @@ public:
      * @param effects Audio effects to apply to the sound (Default is empty).
      * @param volume Volume of the sound (default is 1.0f).
      * @param pitch Pitch of the sound (default is 1.0f).
+     * @param priority Rank against other sounds when sources run out, higher wins (default is 128).
      *
-     * @note This function plays the sound effect using a free audio source from the pool.
+     * @note This function plays the sound effect using a free audio source from the pool. Safe from any thread, the
+     * sound starts with the next batch the audio thread plays. Effects past MAX_SOUND_EFFECT_SENDS are ignored, and
+     * sounds without a buffer yet, such as ones a SoundBank is still decoding, are skipped.
      */
     void PlaySoundEffect(const SoundEffect &sound, const Vector<AudioEffectType> &effects = {}, f32 volume = 1.0f,
-                         f32 pitch = 1.0f);
+                         f32 pitch = 1.0f, u8 priority = DEFAULT_SOUND_PRIORITY);
+
+    /**
+     * @brief Plays a sound effect through a precomposed effect chain.
+     *
+     * @note Like PlaySoundEffect, which builds the same chain from its effect list on every call.
+     */
+    void PlayChainedSoundEffect(const SoundEffect &sound, EffectChain chain, f32 volume = 1.0f, f32 pitch = 1.0f,
+                                u8 priority = DEFAULT_SOUND_PRIORITY);
 
     /**
      * @brief Plays a sound effect at a specific 3D position.
@@ -121,17 +228,56 @@ public:
      * @param volume Volume of the sound (default is 1.0f).
      * @param pitch Pitch of the sound (default is 1.0f).
      * @param loop Whether the sound should loop (default is false).
+     * @param priority Rank against other sounds when sources run out, higher wins (default is 128).
      *
-     * @note This function plays the sound effect at the given position using a free audio source.
+     * @note This function plays the sound effect at the given position using a free audio source. Safe from any
+     * thread, like PlaySoundEffect. Sounds too far from the listener to be heard are dropped without taking a source.
      */
     void PlaySoundEffectAt(const SoundEffect &sound, const Vec3 &position,
                            const Vector<AudioEffectType> &effects = {}, f32 volume = 1.0f, f32 pitch = 1.0f,
-                           bool loop = false);
+                           bool loop = false, u8 priority = DEFAULT_SOUND_PRIORITY);
+
+    /**
+     * @brief Plays a sound effect at a specific 3D position through a precomposed effect chain.
+     */
+    void PlayChainedSoundEffectAt(const SoundEffect &sound, const Vec3 &position, EffectChain chain,
+                                  f32 volume = 1.0f, f32 pitch = 1.0f, bool loop = false,
+                                  u8 priority = DEFAULT_SOUND_PRIORITY);
+
+    /**
+     * @brief Keeps the effects of a chain running while nothing plays through it, such as for the length of a level.
+     *
+     * Effect slots no sound has used for a few seconds are detached from their effect, so the mixer stops running
+     * them. A retained chain keeps its slots attached, so the first sound played through it does not wait for the
+     * effect to start. Each retain is matched by a ReleaseEffectChain. Safe from any thread.
+     */
+    void RetainEffectChain(EffectChain chain);
+    void ReleaseEffectChain(EffectChain chain);
+
+    /**
+     * @brief Takes the latest batch of occlusion queries, if the audio thread posted one since the last call.
+     *
+     * Every OCCLUSION_PERIOD the audio thread posts the positioned sounds estimated loudest, at most
+     * MAX_OCCLUSION_QUERIES of them, so answering a batch costs the same however many sounds play. A batch is only
+     * posted once the previous one was taken. Safe from any thread, such as a worker reading the scene's spatial index.
+     *
+     * @param queries Replaced with the batch.
+     * @param listener Receives the listener position the queries are against.
+     * @return False if there is no new batch.
+     */
+    bool TakeOcclusionQueries(Vector<OcclusionQuery> &queries, Vec3 &listener);
+
+    /**
+     * @brief Hands back how occluded the queried sounds are. The audio thread applies each as a gain and low pass
+     * filter on the sound's source, see VoiceSettings, and ignores results for sounds that stopped since. Safe from
+     * any thread.
+     */
+    void SubmitOcclusionResults(std::span<const OcclusionResult> results);
 
     /**
      * @brief Queues a music track for playback.
      *
-     * @param track The music track to queue.
+     * @param track The music track to queue, it must stay alive until the music is stopped.
      * @param play_immediately Whether the music should start playing immediately (default is true).
      */
     void QueueMusic(MusicTrack &track, bool play_immediately = false);
@@ -169,7 +315,8 @@ public:
     /**
      * @brief Updates the audio system (should be called every frame).
      *
-     * This function updates the state of music playback and checks for buffer updates.
+     * This function wakes the audio thread, so the sound effects posted during the frame start together rather than
+     * on the thread's next periodic wake. Music does not depend on it, the audio thread streams it.
      */
     void Update();
 
@@ -184,6 +331,7 @@ public:
      * @brief Sets the master volume for sound effects.
      *
      * @param volume The master volume to set (range [0.0f, 1.0f]).
+     * @note Safe from any thread, ordered with the sound effects posted around it.
      */
     void SetMasterSoundVolume(f32 volume);
 
@@ -208,6 +356,14 @@ public:
      */
     void SetQueueLooping(bool loop);
 
+    /**
+     * @brief Sets how long the end of each track fades into the next.
+     *
+     * @param seconds Overlap of the two tracks, 0 follows one with the next without a gap or a fade.
+     * @note Only tracks of the same format and sample rate crossfade, anything else starts after the current one.
+     */
+    void SetMusicCrossfade(f32 seconds);
+
     /**
      * @brief Sets the listener's position in 3D space.
      *
@@ -260,19 +416,44 @@ private:
     void DestroyAudioEffects();
 
     /**
-     * @brief Sets audio effects on the given audio source.
-     *
-     * @param source The audio source to apply effects on.
-     * @param effects A vector of effects to apply to the source.
+     * @brief Points the sends of a source at the slots of a chain, only changing the sends that differ from the chain
+     * the source played last, and takes a reference on the chain for the sound playing on it.
      */
-    void ApplyAudioEffects(ALuint source, const Vector<AudioEffectType> &effects);
+    void BindEffectChain(ALuint source, EffectChain chain);
 
     /**
-     * @brief Gets a free audio source.
-     *
-     * @return A free audio source that can be used for sound effects.
+     * @brief Drops the reference the sound on a source holds on its chain, once the sound stopped or was stolen.
      */
-    ALuint GetFreeSource();
+    void UnbindEffectChain(ALuint source);
+
+    struct BoundEffectChain;
+
+    /**
+     * @return The chain resolved to its effect slots, resolved on first use.
+     */
+    BoundEffectChain &GetBoundEffectChain(EffectChain chain);
+
+    /**
+     * @brief Counts a reference to a chain, attaching the effects of its slots when they were detached.
+     */
+    void AddEffectChainReference(EffectChain chain);
+    void RemoveEffectChainReference(EffectChain chain);
+
+    /**
+     * @brief Detaches the effect of each slot no chain has referenced for EFFECT_SLOT_IDLE_TIME.
+     */
+    void DetachIdleEffectSlots();
+
+    /**
+     * @brief Applies the occlusion results submitted since the last wake, and posts the next batch of queries once
+     * OCCLUSION_PERIOD passed and the last batch was taken.
+     */
+    void UpdateOcclusion();
+
+    /**
+     * @brief Sets the direct filter of a source for an occlusion, skipping changes too small to hear.
+     */
+    void ApplyOcclusion(ALuint source, f32 occlusion);
 
     /**
      * @brief Plays the next track in the queue.
@@ -281,6 +462,158 @@ private:
      */
     void PlayNextTrack();
 
+    enum class MusicCommandType : u8 {
+        Queue,
+        Play,
+        Pause,
+        Resume,
+        Stop,
+        StopCurrentTrack,
+        Shuffle,
+        SetPitch,
+        SetVolume,
+        SetLooping,
+        SetQueueLooping,
+        SetCrossfade
+    };
+
+    struct MusicCommand {
+        MusicCommandType type{MusicCommandType::Play};
+        MusicTrack *p_track{nullptr}; ///< Track to queue.
+        f32 value{0.0f};              ///< Pitch, volume or crossfade time.
+        bool flag{false};             ///< Play immediately, shuffle or looping, depending on the type.
+    };
+
+    /**
+     * @brief Hands a music command to the audio thread and wakes it.
+     */
+    void PushMusicCommand(const MusicCommand &command);
+
+    /**
+     * @brief Body of the audio thread, drains the commands and refills the music buffers until stopped.
+     */
+    void AudioLoop(const std::stop_token &stop_token);
+
+    /**
+     * @brief Applies a music command. Audio thread only, as are all functions below.
+     */
+    void ExecuteMusicCommand(const MusicCommand &command);
+
+    /**
+     * @brief Refills the processed music buffers and moves on to the next track once one ends.
+     */
+    void StreamMusic();
+
+    /**
+     * @brief Decodes the next frames of the stream into a buffer, without queueing it.
+     * @return Frames decoded, 0 once the stream has ended.
+     */
+    size_t FillMusicBuffer(ALuint buffer);
+
+    /**
+     * @brief Decodes up to frames of the stream into the decode buffer, looping the current track or handing over to
+     * the next one when it ends, crossfading into it over the last frames if a crossfade is set.
+     * @return Frames decoded, less than asked once the stream cannot continue on the current source.
+     */
+    size_t DecodeMusic(size_t frames);
+
+    /**
+     * @brief Reads frames of a track, from its prefetched start first.
+     */
+    size_t ReadTrackFrames(MusicTrack &track, f32 *out, size_t frames);
+
+    /**
+     * @brief Decodes one more buffer of the next track's start, restarting the prefetch if the next track changed.
+     */
+    void PrefetchNextTrack();
+
+    /**
+     * @brief Rewinds the track at queue_index and makes it the one prefetched.
+     */
+    void BeginPrefetch(size_t queue_index);
+
+    /**
+     * @brief Checks the next track can continue the stream on the current source, beginning its prefetch if needed.
+     */
+    [[nodiscard]] bool PrepareHandOver();
+
+    /**
+     * @return Queue index of the track that follows the current one, empty if the queue ends or the track loops.
+     */
+    [[nodiscard]] std::optional<size_t> GetNextTrackIndex() const;
+
+    /**
+     * @return Frames of the track left to stream, prefetched ones included.
+     */
+    [[nodiscard]] size_t GetRemainingFrames(const MusicTrack &track) const;
+
+    /**
+     * @return True once every frame of the track was read, prefetched ones included.
+     */
+    [[nodiscard]] bool IsTrackFinished(const MusicTrack &track) const;
+
+    void ResetPrefetch();
+
+    void StopMusicStream();
+    void ReleaseMusicSource();
+    void ShuffleQueuedTracks();
+
+    enum class SoundCommandType : u8 {
+        Play,
+        SetVolume,
+        SetListenerPosition,
+        SetListenerVelocity,
+        RetainEffectChain,
+        ReleaseEffectChain
+    };
+
+    struct SoundCommand {
+        SoundCommandType type{SoundCommandType::Play};
+        ALuint buffer{0};
+        Vec3 position{0.0f, 0.0f, 0.0f}; ///< Of the sound, or the listener position or velocity.
+        f32 volume{1.0f};
+        f32 pitch{1.0f};
+        EffectChain effect_chain{};
+        SoundThrottle throttle{};
+        u8 priority{DEFAULT_SOUND_PRIORITY};
+        bool is_positional{false};
+        bool loop{false};
+    };
+
+    /**
+     * @brief Copies a sound command into the queue, from any thread. The audio thread is not woken, see Update.
+     */
+    void PushSoundCommand(const SoundCommand &command);
+
+    void WakeAudioThread();
+
+    /**
+     * @brief Releases the voices that finished, then hands the posted sounds to the voice manager in batches.
+     */
+    void ProcessSoundCommands();
+
+    /**
+     * @brief Ranks a batch of sounds, assigns them voices best first and starts them together.
+     */
+    void PlaySoundBatch(std::span<SoundCommand> commands);
+
+    /**
+     * @brief Folds a play into an earlier play of the same sound in the batch, raising its volume.
+     * @return False if the batch has no play to merge it with.
+     */
+    static bool MergeSoundCommand(std::span<SoundCommand> batch, const SoundCommand &command);
+
+    /**
+     * @return True if the sound plays its maximum instances already, or started too recently to start again.
+     */
+    [[nodiscard]] bool IsSoundThrottled(const SoundCommand &command, std::chrono::steady_clock::time_point now) const;
+
+    /**
+     * @brief Sets a source up for a sound without playing it.
+     * @return False if the sound could not be set up.
+     */
+    bool PrepareSoundSource(ALuint source, const SoundCommand &command);
+
 private:
     // Effect function pointers
     typedef void(AL_APIENTRY *LPALGENEFFECTS)(ALsizei, ALuint *);
@@ -294,6 +627,10 @@ private:
     typedef void(AL_APIENTRY *LPALAUXILIARYEFFECTSLOTF)(ALuint, ALenum, ALfloat);
     typedef void(AL_APIENTRY *LPALGETAUXILIARYEFFECTSLOTI)(ALuint, ALenum, ALint *);
     typedef void(AL_APIENTRY *LPALGETAUXILIARYEFFECTSLOTF)(ALuint, ALenum, ALfloat *);
+    typedef void(AL_APIENTRY *LPALGENFILTERS)(ALsizei, ALuint *);
+    typedef void(AL_APIENTRY *LPALDELETEFILTERS)(ALsizei, const ALuint *);
+    typedef void(AL_APIENTRY *LPALFILTERI)(ALuint, ALenum, ALint);
+    typedef void(AL_APIENTRY *LPALFILTERF)(ALuint, ALenum, ALfloat);
 
     LPALGENEFFECTS alGenEffects{nullptr};
     LPALDELETEEFFECTS alDeleteEffects{nullptr};
@@ -306,23 +643,49 @@ private:
     LPALAUXILIARYEFFECTSLOTF alAuxiliaryEffectSlotf{nullptr};
     LPALGETAUXILIARYEFFECTSLOTI alGetAuxiliaryEffectSloti{nullptr};
     LPALGETAUXILIARYEFFECTSLOTF alGetAuxiliaryEffectSlotf{nullptr};
+    LPALGENFILTERS alGenFilters{nullptr};
+    LPALDELETEFILTERS alDeleteFilters{nullptr};
+    LPALFILTERI alFilteri{nullptr};
+    LPALFILTERF alFilterf{nullptr};
 
 private:
     ALCdevice *p_device;   ///< OpenAL device for audio output.
     ALCcontext *p_context; ///< OpenAL context for controlling audio output.
 
-    // Sound effect members
-    Vector<ALuint> m_source_pool;    ///< Pool of available sources for sound effects.
-    Vector<ALuint> m_active_sources; ///< Sources currently playing sound effects.
+    // Sound effect members, owned by the audio thread once it started
+    VoiceManager m_voices; ///< Pool of sources for sound effects and the sounds playing on them.
 
-    // Music streaming members
+    // Music streaming members, owned by the audio thread once it started
     ALuint m_music_source;                            ///< Dedicated source for music playback.
     Vector<ALuint> m_music_buffers;              ///< Buffers for streaming music chunks.
     Vector<MusicTrack *> m_music_tracks;         ///< Queue of music tracks to be played.
     size_t m_current_index = 0;                       ///< Index of the next track to play in the queue.
     MusicTrack *p_current_track;                      ///< The current music track being streamed.
-    static constexpr size_t NUM_STREAM_BUFFERS = 3;   ///< Number of buffers for music streaming.
-    static constexpr size_t FRAMES_PER_BUFFER = 4096; ///< Number of frames per buffer (for streaming music).
+    MusicStreamSettings m_stream_settings;            ///< Buffer count and latency the buffers are sized for.
+    size_t m_frames_per_buffer;                       ///< Frames per buffer for the current track's sample rate.
+    Vector<f32> m_decode_buffer;                      ///< Scratch the track is decoded into, sized on track change.
+    Vector<f32> m_crossfade_buffer;                   ///< Scratch the next track is decoded into while fading to it.
+
+    /**
+     * @brief The start of the track after the current one, decoded ahead of its hand over.
+     *
+     * A first in first out of the track's decoder output, the decoder carries on after the last prefetched frame, so
+     * reads take the prefetched frames first and then decode the rest.
+     */
+    struct MusicPrefetch {
+        MusicTrack *p_track{nullptr}; ///< Null when nothing is prefetched.
+        size_t queue_index{0};        ///< Of the track in the queue.
+        Vector<f32> samples;          ///< Interleaved frames decoded ahead.
+        size_t frames{0};             ///< Decoded into samples.
+        size_t consumed{0};           ///< Of the frames, already handed to the stream.
+    };
+
+    MusicPrefetch m_prefetch; ///< Kept once the track is handed over, until its prefetched frames are streamed.
+    static constexpr size_t MIN_FRAMES_PER_BUFFER = 256; ///< Keeps tiny latencies from flooding OpenAL with calls.
+    static constexpr size_t MUSIC_COMMAND_CAPACITY = 64;         ///< Commands the main thread can post between wakes.
+    static constexpr size_t SOUND_COMMAND_CAPACITY = 256;        ///< Sounds all threads can post between wakes.
+    static constexpr size_t SOUND_BATCH_SIZE = 32;               ///< Sounds ranked and started together.
+    static constexpr std::chrono::milliseconds STREAM_PERIOD{5}; ///< How often the audio thread refills buffers.
 
     f32 m_master_sound_volume; ///< Master volume for sound effects.
     f32 m_master_music_volume; ///< Master volume for music.
@@ -333,6 +696,57 @@ private:
     AudioEffects m_effects;
     bool m_effects_loaded;
     bool m_effects_pointers_loaded;
+    size_t m_max_effect_sends; ///< Auxiliary sends per source, queried once and capped at MAX_EFFECT_CHAIN_LENGTH.
+
+    // Effect chain members, owned by the audio thread once it started
+    struct BoundEffectChain {
+        std::array<ALuint, MAX_EFFECT_CHAIN_LENGTH> slots{}; ///< Send i of a source goes to slots[i], 0 if unused.
+        u32 references{0};                                   ///< Sounds playing through the chain plus retains.
+    };
+
+    struct EffectSlotState {
+        u32 references{0};   ///< Chains with references sending to the slot.
+        bool attached{true}; ///< Whether the slot runs its effect, they start attached from InitializeAudioEffects.
+        std::chrono::steady_clock::time_point idle_since{}; ///< When the last reference was dropped.
+    };
+
+    struct SourceState {
+        EffectChain chain{};         ///< Bound to the source's sends, kept after the sound stops.
+        bool holds_reference{false}; ///< Whether a sound playing on the source counts towards the chain.
+        u32 play{0};                 ///< Counts the sounds started on the source, to match occlusion results.
+        f32 occlusion{0.0f};         ///< Applied to the source's direct filter.
+    };
+
+    FlatHashMap<u32, BoundEffectChain> m_effect_chains;             ///< By chain key, never emptied, chains are few.
+    FlatHashMap<ALuint, SourceState> m_source_states;               ///< By sound effect source.
+    std::array<EffectSlotState, AUDIO_EFFECT_COUNT> m_effect_slots; ///< By effect type.
+    static constexpr std::chrono::seconds EFFECT_SLOT_IDLE_TIME{3}; ///< Longer than the reverb and echo tails.
+
+    /// When each sound with a retrigger interval last started, by buffer.
+    FlatHashMap<ALuint, std::chrono::steady_clock::time_point> m_sound_last_started;
+
+    // Occlusion members, the batches are handed between threads under the mutex
+    std::mutex m_occlusion_mutex;
+    Vector<OcclusionQuery> m_occlusion_queries;           ///< Posted by the audio thread, emptied when taken.
+    Vec3 m_occlusion_listener{0.0f, 0.0f, 0.0f};          ///< Listener position of the posted batch.
+    std::atomic<bool> m_occlusion_queries_taken{true};    ///< Whether the last batch was taken.
+    Vector<OcclusionResult> m_occlusion_results;          ///< Submitted since the audio thread last applied them.
+    std::atomic<bool> m_occlusion_results_ready{false};   ///< Set with every submission.
+    Vector<OcclusionResult> m_applied_occlusion_results;  ///< Audio thread scratch the results are swapped into.
+    Vector<std::pair<f32, OcclusionQuery>> m_occlusion_candidates; ///< Audio thread scratch, by estimated gain.
+    std::chrono::steady_clock::time_point m_last_occlusion_post{}; ///< Audio thread only.
+    ALuint m_occlusion_filter{0}; ///< Low pass filter copied into occluded sources, 0 without EFX.
+    static constexpr std::chrono::milliseconds OCCLUSION_PERIOD{100}; ///< How often occlusion is queried.
+    static constexpr size_t MAX_OCCLUSION_QUERIES = 16;               ///< Loudest sounds queried per batch.
+    static constexpr f32 OCCLUSION_STEP = 1.0f / 32.0f;               ///< Smaller changes are not applied.
+
+    // Audio thread members
+    MPSCQueue<MusicCommand, MUSIC_COMMAND_CAPACITY> m_music_commands;
+    MPSCQueue<SoundCommand, SOUND_COMMAND_CAPACITY> m_sound_commands;
+    std::atomic<bool> m_wake_requested; ///< Set with every command so the thread skips the rest of its sleep.
+    std::mutex m_wake_mutex;
+    std::condition_variable_any m_wake_condition;
+    std::jthread m_audio_thread; ///< Last, so it stops before the state above is destroyed.
 };
 
 } // namespace audio end
@@ -1,6 +1,12 @@
 #pragma once
 
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <span>
+
 #include "audio_common.hpp"
+#include "utils/mapped_file.hpp"
 
 #include "sndfile.h"
 
@@ -12,7 +18,8 @@ namespace gouda::audio {
  *
  * This class is used for loading, reading, and managing a music track's audio data.
  * It interfaces with the `libsndfile` library to read audio files and prepares audio data
- * for playback through OpenAL.
+ * for playback through OpenAL. The encoded file is always read from memory through libsndfile's virtual IO, either a
+ * mapping of the file or a blob someone else owns, so streaming never makes a system call per read.
  */
 class MusicTrack {
 public:
@@ -56,13 +63,24 @@ public:
     /**
      * @brief Loads a music track from a file.
      *
-     * This function opens the music track file, retrieves its audio properties, and prepares it for streaming.
+     * This function maps the music track file, retrieves its audio properties, and prepares it for streaming.
      *
      * @param filepath The path to the music file to load.
      * @return True if the music track was loaded successfully, false otherwise.
      */
     bool Load(std::string_view filepath);
 
+    /**
+     * @brief Loads a music track from an encoded file already in memory, such as a blob in packed game data.
+     *
+     * The data is not copied, it has to stay valid until the track is destroyed or loads something else.
+     *
+     * @param data The encoded file contents.
+     * @param name Name of the track for logging, its extension has to be a supported audio type.
+     * @return True if the music track was loaded successfully, false otherwise.
+     */
+    bool LoadFromMemory(std::span<const std::byte> data, std::string_view name);
+
     /**
      * @brief Reads a chunk of audio data for streaming.
      *
@@ -129,12 +147,45 @@ public:
      */
     void SetFinished(const bool finished) { m_finished = finished; }
 
+    /**
+     * @brief Seeks back to the first frame, so the track can be streamed again.
+     *
+     * @return False if the track is not loaded or could not be seeked.
+     */
+    bool Rewind();
+
+    /**
+     * @brief Gets the length of the track in frames, as reported by the file header.
+     */
+    [[nodiscard]] size_t GetFrameCount() const { return static_cast<size_t>(m_sfinfo.frames); }
+
+    /**
+     * @brief Gets the number of frames decoded since the track was loaded or rewound.
+     */
+    [[nodiscard]] size_t GetFramePosition() const { return m_frame_position; }
+
 private:
+    /**
+     * @brief Encoded file contents libsndfile reads from, with the read position its virtual IO keeps.
+     */
+    struct MemoryStream {
+        std::optional<fs::MappedFile> file; ///< Owns the data when the track mapped the file itself.
+        std::span<const std::byte> data;
+        sf_count_t position{0};
+    };
+
+    bool Open(std::string_view name);
+    void Close();
+
+private:
+    std::unique_ptr<MemoryStream> p_stream; ///< Heap allocated, libsndfile keeps its address across moves.
+
     SNDFILE *p_sndfile; ///< The file handle for the audio file.
     SF_INFO m_sfinfo{};   ///< Information structure containing the file's metadata (e.g., sample rate, channels).
     ALenum m_format;    ///< The audio format used by OpenAL.
     int m_sample_rate;  ///< The sample rate of the audio track.
     int m_channels;     ///< The number of channels (mono or stereo).
+    size_t m_frame_position; ///< Frames read since the track was opened or rewound.
     bool m_finished;    ///< Whether the track has finished playing or streaming.
 };
 
@@ -0,0 +1,116 @@
+#pragma once
+/**
+ * @file audio/sound_bank.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine decoded sound effect cache
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "containers/flat_hash_map.hpp"
+#include "containers/small_vector.hpp"
+#include "core/types.hpp"
+#include "sound_effect.hpp"
+#include "utils/job_system.hpp"
+
+namespace gouda::audio {
+
+using SoundID = u32;
+inline constexpr SoundID INVALID_SOUND_ID{constants::u32_max};
+
+/**
+ * @class SoundBank
+ * @brief Sound effects keyed by file path, each decoded once in the background and shared by everything playing it.
+ *
+ * Asking for a path the bank already knows returns the same id, so a sound used by many entities has one decode and
+ * one OpenAL buffer. New paths are decoded on the job system, only the buffer upload is left for Update on the main
+ * thread. A sound played before its upload finished has no buffer yet and is skipped by the audio manager rather than
+ * stalling the frame, levels preload the sounds they use while they load so their first play is already resident.
+ * Every call belongs on the main thread, and the bank has to be destroyed before the audio manager shuts down.
+ */
+class SoundBank {
+public:
+    /**
+     * @param job_system Runs the decodes, decodes run on the calling thread when null or without workers.
+     */
+    explicit SoundBank(JobSystem *job_system);
+    ~SoundBank();
+
+    SoundBank(const SoundBank &) = delete;
+    SoundBank &operator=(const SoundBank &) = delete;
+
+    /**
+     * @brief Returns the id of the sound at a path, starting its decode the first time the path is asked for.
+     * @return The sound's id, also for files that failed to decode, whose sound never gets a buffer.
+     */
+    SoundID Load(StringView filepath);
+
+    /**
+     * @brief Starts decoding every sound a level uses that is not in the bank yet.
+     */
+    void Preload(std::span<const String> filepaths);
+
+    /**
+     * @brief Preloads the sounds listed in a manifest, one path per line. Blank lines and lines starting with # are
+     * skipped.
+     * @return False if the manifest could not be read.
+     */
+    bool PreloadManifest(StringView manifest_filepath);
+
+    /**
+     * @brief Uploads the sounds whose decodes finished, once per frame.
+     */
+    void Update();
+
+    /**
+     * @brief Blocks until every requested sound is decoded and uploaded, helping with the decodes meanwhile.
+     */
+    void WaitForLoads();
+
+    /**
+     * @return The sound, without a buffer until it is uploaded.
+     */
+    [[nodiscard]] const SoundEffect &Get(const SoundID sound) const { return m_sounds[sound].sound; }
+
+    /**
+     * @return The sound's id, or INVALID_SOUND_ID if the path was never loaded.
+     */
+    [[nodiscard]] SoundID Find(StringView filepath) const;
+
+    [[nodiscard]] bool IsLoaded(const SoundID sound) const { return m_sounds[sound].state == SoundState::Loaded; }
+    [[nodiscard]] size_t GetSoundCount() const noexcept { return m_sounds.size(); }
+    [[nodiscard]] size_t GetPendingCount() const noexcept { return m_pending.size(); }
+
+private:
+    enum class SoundState : u8 {
+        Decoding,
+        Loaded,
+        Failed, // The file could not be decoded or uploaded, it is not retried
+    };
+
+    struct Sound {
+        String filepath;
+        SoundState state;
+        SoundEffect sound;
+        std::unique_ptr<DecodedSound> p_decoded; // Written by the decode job until the counter is done, empty if failed
+        std::unique_ptr<JobCounter> p_counter;
+    };
+
+    void FinishLoad(Sound &sound);
+
+private:
+    JobSystem *p_job_system;
+
+    std::vector<Sound> m_sounds;
+    FlatHashMap<String, SoundID> m_sound_ids;
+    Vector<SoundID> m_pending; // Sounds still decoding, in the order they were requested
+};
+
+} // namespace gouda::audio
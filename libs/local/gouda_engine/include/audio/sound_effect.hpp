@@ -1,9 +1,48 @@
 #pragma once
 
+#include <cstddef>
+
 #include "audio_common.hpp"
+#include "containers/small_vector.hpp"
+#include "memory/allocators/tracking_allocator.hpp"
 
 namespace gouda::audio {
 
+/**
+ * @struct DecodedSound
+ * @brief Samples of a sound file in the layout OpenAL takes them, decoded but not yet in a buffer.
+ */
+struct DecodedSound {
+    TrackedVector<std::byte, MemoryTag::Audio> samples; ///< Interleaved 16 bit or float samples, as the format says.
+    ALenum format{AL_NONE};                             ///< OpenAL buffer format of the samples.
+    s32 sample_rate{0};                                 ///< Frames per second.
+};
+
+/**
+ * @brief Decodes a whole sound file into memory without touching OpenAL, safe to call from any thread.
+ *
+ * @param filepath The path to the sound file to decode.
+ * @param supports_float Whether float samples may be kept, AL_EXT_FLOAT32 has to be present to upload them.
+ * @param decoded Receives the samples and their format.
+ * @return True if the file was decoded, false otherwise.
+ */
+bool DecodeSound(std::string_view filepath, bool supports_float, DecodedSound &decoded);
+
+/**
+ * @struct SoundThrottle
+ * @brief Limits on how often and how many times at once a sound effect plays.
+ *
+ * A burst of the same sound, such as fifty coins collected in one frame, is heard as little more than a few of them,
+ * so past these limits the extra plays are merged or dropped rather than each taking a voice and mixer time. The
+ * defaults limit nothing.
+ */
+struct SoundThrottle {
+    f32 min_retrigger_interval{0.0f}; ///< Seconds after the sound started before it starts again, later plays drop.
+    f32 max_merged_volume{2.0f};      ///< Cap on the volume of plays merged into one, see merge_same_frame.
+    u8 max_instances{0};              ///< Plays of the sound at once, further plays drop, 0 for no limit.
+    bool merge_same_frame{false};     ///< Plays posted between two wakes of the audio thread play once, louder.
+};
+
 /**
  * @class SoundEffect
  * @brief Represents a sound effect that can be loaded and played using OpenAL.
@@ -60,6 +99,16 @@ public:
      */
     bool Load(std::string_view filename);
 
+    /**
+     * @brief Replaces the sound effect's buffer with already decoded samples.
+     *
+     * Needs a current OpenAL context, decoding is the slow part and can happen elsewhere beforehand.
+     *
+     * @param decoded Samples from DecodeSound.
+     * @return True if the buffer was created, false otherwise.
+     */
+    bool Upload(const DecodedSound &decoded);
+
     /**
      * @brief Gets the OpenAL buffer for the sound effect.
      *
@@ -69,8 +118,15 @@ public:
      */
     [[nodiscard]] ALuint GetBuffer() const { return m_buffer; }
 
+    /**
+     * @brief Sets the limits every play of the sound is held to, from the next play on.
+     */
+    void SetThrottle(const SoundThrottle &throttle) { m_throttle = throttle; }
+    [[nodiscard]] const SoundThrottle &GetThrottle() const { return m_throttle; }
+
 private:
-    ALuint m_buffer; ///< OpenAL buffer that stores the sound effect data.
+    ALuint m_buffer;          ///< OpenAL buffer that stores the sound effect data.
+    SoundThrottle m_throttle; ///< Copied into every play of the sound.
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,117 @@
+#pragma once
+/**
+ * @file audio/voice_manager.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine sound effect voice allocation
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <limits>
+#include <span>
+
+#include "audio_common.hpp"
+#include "containers/small_vector.hpp"
+#include "core/types.hpp"
+
+namespace gouda::audio {
+
+inline constexpr u8 DEFAULT_SOUND_PRIORITY{128};
+
+/**
+ * @struct VoiceSettings
+ * @brief Distance attenuation applied to positioned sounds and the gain below which a sound is not worth a voice.
+ *
+ * The distances follow OpenAL's clamped inverse distance model, which the voice manager mirrors to estimate how loud a
+ * sound will be before it is given a source. The defaults are OpenAL's own.
+ */
+struct VoiceSettings {
+    f32 reference_distance{1.0f}; ///< Distance at which a sound plays at its full volume.
+    f32 rolloff_factor{1.0f};     ///< How quickly sounds fade past the reference distance.
+    f32 max_distance{std::numeric_limits<f32>::max()}; ///< Distance past which a sound stops getting quieter.
+    f32 min_audible_gain{0.001f}; ///< Estimated gains below this, -60 dB, are dropped before taking a voice.
+    f32 occluded_gain{0.5f};      ///< Gain of a fully occluded sound, see AudioManager::SubmitOcclusionResults.
+    f32 occluded_gain_hf{0.1f};   ///< High frequency gain of a fully occluded sound, on top of occluded_gain.
+};
+
+/**
+ * @struct Voice
+ * @brief A sound playing on, or about to start on, one of the pooled sources.
+ */
+struct Voice {
+    ALuint source;
+    Vec3 position;
+    f32 volume; // Before the master volume
+    u8 priority;
+    bool is_positional; // Otherwise it plays at the listener
+    ALuint buffer;      // The sound, to count how many times it plays at once
+};
+
+/**
+ * @class VoiceManager
+ * @brief Hands the fixed pool of sound effect sources to the sounds that matter most.
+ *
+ * Sounds are ranked by priority first and by their estimated gain at the listener second, so a quiet sound far away
+ * loses to a loud one nearby of the same priority. Sounds too quiet to hear never take a source. When every source
+ * is in use a new sound takes over the lowest ranked voice, provided it outranks it, otherwise it is dropped. A burst
+ * of effects therefore never grows the number of sources the mixer has to run.
+ *
+ * The manager only keeps the books, stopping a stolen source and polling for finished ones is up to the caller.
+ */
+class VoiceManager {
+public:
+    VoiceManager() = default;
+
+    void SetSettings(const VoiceSettings &settings) { m_settings = settings; }
+    [[nodiscard]] const VoiceSettings &GetSettings() const noexcept { return m_settings; }
+
+    void SetListenerPosition(const Vec3 &position) { m_listener_position = position; }
+    [[nodiscard]] const Vec3 &GetListenerPosition() const noexcept { return m_listener_position; }
+
+    /**
+     * @brief Adds a source to the pool, the pool size is the number of sounds that can play at once.
+     */
+    void AddSource(ALuint source);
+
+    /**
+     * @brief Estimates a voice's gain at the listener, before effects and the source's own cone.
+     */
+    [[nodiscard]] f32 GetAudibleGain(const Voice &voice, f32 master_volume) const;
+
+    /**
+     * @brief Finds a source for a sound, taking over the lowest ranked voice when none is free.
+     * @param voice The sound, its source is ignored.
+     * @param is_stolen Set when the returned source was taken from a voice that may still be playing.
+     * @return The source the sound now owns, or 0 if it is inaudible or outranked by every voice.
+     */
+    [[nodiscard]] ALuint Acquire(const Voice &voice, f32 master_volume, bool &is_stolen);
+
+    /**
+     * @brief Returns a voice's source to the pool.
+     */
+    void Release(ALuint source);
+
+    /**
+     * @return Voices playing the buffer, including ones that finished since the caller last polled them.
+     */
+    [[nodiscard]] size_t CountVoices(ALuint buffer) const;
+
+    [[nodiscard]] std::span<const Voice> GetVoices() const noexcept { return m_voices; }
+    [[nodiscard]] std::span<const ALuint> GetFreeSources() const noexcept { return m_free_sources; }
+    [[nodiscard]] size_t GetSourceCount() const noexcept { return m_voices.size() + m_free_sources.size(); }
+    [[nodiscard]] u64 GetCulledCount() const noexcept { return m_culled_count; }
+    [[nodiscard]] u64 GetStolenCount() const noexcept { return m_stolen_count; }
+
+private:
+    VoiceSettings m_settings;
+    Vec3 m_listener_position{0.0f, 0.0f, 0.0f};
+    Vector<Voice> m_voices;
+    Vector<ALuint> m_free_sources;
+    u64 m_culled_count{0};
+    u64 m_stolen_count{0};
+};
+
+} // namespace gouda::audio
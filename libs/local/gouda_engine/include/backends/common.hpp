@@ -25,6 +25,7 @@ struct WindowConfig {
     std::string_view title;
     bool resizable;
     bool fullscreen;
+    bool visible; // Hidden windows still get a swapchain, for headless tools such as the benchmark
     bool vsync;
     int refresh_rate;
     Renderer renderer;
@@ -33,6 +34,7 @@ struct WindowConfig {
     WindowConfig()
         : resizable{true},
           fullscreen{false},
+          visible{true},
           vsync{false},
           refresh_rate{60},
           renderer{Renderer::Vulkan},
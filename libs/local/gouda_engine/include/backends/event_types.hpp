@@ -20,7 +20,6 @@
  * You should have received a copy of the GNU Affero General Public License
  * along with this program. If not, see <https://www.gnu.org/licenses/>.
  */
-#include <string>
 #include <variant>
 
 #include "backends/keycodes.hpp"
@@ -85,6 +84,6 @@ struct WindowIconifyEvent {
 
 using Event = std::variant<KeyEvent, MouseButtonEvent, MouseMoveEvent, MouseScrollEvent, WindowCloseEvent, CharEvent,
                            CursorEnterEvent, WindowFocusEvent, WindowFramebufferSizeEvent, WindowSizeEvent,
-                           WindowIconifyEvent, std::string>;
+                           WindowIconifyEvent>;
 
 } // namespace gouda
\ No newline at end of file
@@ -20,21 +20,43 @@
  * You should have received a copy of the GNU Affero General Public License
  * along with this program. If not, see <https://www.gnu.org/licenses/>.
  */
+#include <array>
+#include <bitset>
 #include <functional>
+#include <limits>
 #include <memory>
-#include <unordered_map>
+#include <utility>
 #include <variant>
 #include <vector>
 
 #include "backends/event_types.hpp"
 #include "backends/input_backend.hpp"
+#include "backends/input_recording.hpp"
+#include "containers/flat_hash_map.hpp"
 #include "core/types.hpp"
 #include "math/math.hpp"
+#include "utils/interned_string.hpp"
 
 struct GLFWwindow;
 
 namespace gouda {
 
+enum class InputMode : u8 { Live, Recording, Replaying };
+
+/**
+ * @class InputHandler
+ * @brief Polls the input backend, tracks held keys and buttons and drives the active state's bindings.
+ *
+ * States can react to input two ways. ActionBindings call a callback for every matching event. Actions are polled
+ * instead: each state maps inputs to up to MAX_ACTIONS action bits in a dense table, and event processing keeps a
+ * snapshot of which of the active state's actions are down and which were pressed or released this frame, so a
+ * query is a bit test with no string hashing or callback on the way.
+ *
+ * Events are timestamped as the backend hands them over. PumpEvents polls the backend between frames, while the
+ * frame pacer waits, so events carry close to the time they arrived instead of the next frame's start, and
+ * DispatchEvents then applies them in step with the fixed updates that simulate that time. GLFW only delivers events
+ * to the main thread on every platform it supports, so pumping takes the place of a polling thread.
+ */
 class InputHandler {
 public:
     explicit InputHandler(std::unique_ptr<InputBackend> backend, GLFWwindow *window);
@@ -55,10 +77,41 @@ public:
         ActionCallback callback;
     };
 
+    using StateID = u16;
+    using ActionID = u8;
+    using ActionMask = u64;
+
+    static constexpr size_t MAX_ACTIONS{std::numeric_limits<ActionMask>::digits};
+
     void LoadStateBindings(StringView state, const std::vector<ActionBinding> &bindings);
-    void UnloadStateBindings(const std::string &state);
-    void SetActiveState(const std::string &state);
-    void PushCustomEvent(const std::string &event);
+    void UnloadStateBindings(StringView state);
+    void SetActiveState(StringView state);
+
+    /**
+     * @brief The id of a state name, the same name always interns to the same id.
+     *
+     * Interning allocates the state's action table, so it belongs with a state's setup, not its per frame input.
+     */
+    [[nodiscard]] StateID InternState(StringView state);
+
+    /**
+     * @brief Makes an input drive an action while state is active. An action can have several inputs, it stays down
+     * while any of them is held.
+     */
+    void BindAction(StateID state, ActionID action, InputType input);
+    void UnbindActions(StateID state);
+    void SetActiveState(StateID state);
+
+    /// Polled actions of the active state. Pressed and released cover everything since the last EndFrame.
+    [[nodiscard]] bool IsActionDown(ActionID action) const noexcept { return test_action(m_actions_down, action); }
+    [[nodiscard]] bool WasActionPressed(ActionID action) const noexcept
+    {
+        return test_action(m_actions_pressed, action);
+    }
+    [[nodiscard]] bool WasActionReleased(ActionID action) const noexcept
+    {
+        return test_action(m_actions_released, action);
+    }
     void QueueEvent(const Event& event);
 
     // Standard callback setters
@@ -71,13 +124,13 @@ public:
     void SetWindowIconifyCallback(WindowIconifyCallback callback);
 
     // State-specific callback setters
-    void SetStateScrollCallback(const std::string &state, ScrollCallback callback);
-    void SetStateCharCallback(const std::string &state, CharCallback callback);
-    void SetStateCursorEnterCallback(const std::string &state, CursorEnterCallback callback);
-    void SetStateWindowFocusCallback(const std::string &state, WindowFocusCallback callback);
-    void SetStateFramebufferSizeCallback(const std::string &state, FramebufferSizeCallback callback);
-    void SetStateWindowSizeCallback(const std::string &state, WindowSizeCallback callback);
-    void SetStateWindowIconifyCallback(const std::string &state, WindowIconifyCallback callback);
+    void SetStateScrollCallback(StringView state, ScrollCallback callback);
+    void SetStateCharCallback(StringView state, CharCallback callback);
+    void SetStateCursorEnterCallback(StringView state, CursorEnterCallback callback);
+    void SetStateWindowFocusCallback(StringView state, WindowFocusCallback callback);
+    void SetStateFramebufferSizeCallback(StringView state, FramebufferSizeCallback callback);
+    void SetStateWindowSizeCallback(StringView state, WindowSizeCallback callback);
+    void SetStateWindowIconifyCallback(StringView state, WindowIconifyCallback callback);
 
     // Clear callback methods
     void ClearScrollCallback();
@@ -93,16 +146,100 @@ public:
     std::pair<double, double> GetMousePosition() const;
     Vec2 GetMousePositionFloat() const;
 
+    /**
+     * @brief Polls the backend and applies every queued event.
+     */
     void Update();
 
+    /**
+     * @brief Polls the backend and queues its events without applying them, recording or replaying as set.
+     */
+    void PollEvents();
+
+    /**
+     * @brief Polls the backend only, so events are timestamped as they arrive. Cheap enough to call every millisecond.
+     */
+    void PumpEvents();
+
+    /**
+     * @brief Applies the queued events timestamped no later than until, in order, and keeps the rest queued.
+     */
+    void DispatchEvents(SteadyClock::time_point until = SteadyClock::time_point::max());
+
+    /**
+     * @brief Starts recording the input polled by each following Update, frames close with EndFrame.
+     * @param fixed_timestep The step the loop's fixed updates run at, kept with the recording.
+     */
+    void StartRecording(f32 fixed_timestep);
+
+    /**
+     * @brief Stops recording, or replaying, and hands the recording over.
+     */
+    InputRecording StopRecording();
+
+    /**
+     * @brief Replaces the window's input with a recording's, one recorded frame per EndFrame.
+     *
+     * Keys and mouse buttons held live are released first. Window events still come from the window.
+     */
+    void StartReplay(InputRecording recording);
+
+    /**
+     * @brief Closes the frame, recording its timing or moving on to the next recorded frame.
+     * @param delta_time Unscaled seconds the frame advanced by.
+     * @param tick_count Fixed step updates run during the frame.
+     */
+    void EndFrame(f32 delta_time, u32 tick_count);
+
+    [[nodiscard]] InputMode GetMode() const noexcept { return m_mode; }
+
+    /**
+     * @brief Events applied since the last EndFrame, with held inputs whether the frame saw any input at all.
+     */
+    [[nodiscard]] u32 GetFrameEventCount() const noexcept { return m_frame_event_count; }
+    [[nodiscard]] bool IsAnyInputHeld() const noexcept { return m_held_inputs.any(); }
+
+    /**
+     * @brief The recorded frame being replayed, whose timing the loop should advance by, null unless replaying.
+     */
+    [[nodiscard]] const RecordedFrame *GetReplayFrame() const noexcept;
+
+    [[nodiscard]] bool IsReplayFinished() const noexcept;
+
 private:
-    void ProcessEvents();
-    void ApplyStateCallbacks(const std::string &state);
+    struct TimedEvent {
+        Event event;
+        SteadyClock::time_point time; // When the backend handed it over
+    };
+
+    static constexpr size_t KEY_COUNT{std::to_underlying(Key::Menu) + 1};
+    static constexpr size_t INPUT_COUNT{KEY_COUNT + std::to_underlying(MouseButton::None)};
+    static constexpr StateID NO_STATE{std::numeric_limits<StateID>::max()};
+
+    using ActionTable = std::array<ActionMask, INPUT_COUNT>; // The actions each input drives, keys then buttons
+
+    [[nodiscard]] static constexpr size_t input_index(const Key key) noexcept { return std::to_underlying(key); }
+    [[nodiscard]] static constexpr size_t input_index(const MouseButton button) noexcept
+    {
+        return KEY_COUNT + std::to_underlying(button);
+    }
+    [[nodiscard]] static constexpr bool test_action(const ActionMask mask, const ActionID action) noexcept
+    {
+        return action < MAX_ACTIONS && (mask >> action & 1) != 0;
+    }
+
+    void SetInputHeld(size_t input, bool held);
+    void RebuildActionSnapshot();
+    void ReplayEvents();
+    void ReleaseHeldInput();
+    void ProcessEvent(const Event &event);
+    void ApplyStateCallbacks(InternedString state);
 
     std::unique_ptr<InputBackend> p_backend;
-    std::unordered_map<std::string, std::vector<ActionBinding>> m_bindings;
-    std::string m_active_state;
-    std::vector<Event> m_events;
+    FlatHashMap<InternedString, std::vector<ActionBinding>> m_bindings;
+    const std::vector<ActionBinding> *p_active_bindings; // Into m_bindings, null if the active state has none
+    InternedString m_active_state;
+    std::vector<TimedEvent> m_events; // In the order they were queued, which is also the order of their times
     GLFWwindow *p_window;
 
     ScrollCallback m_scroll_callback;
@@ -114,20 +251,35 @@ private:
     WindowIconifyCallback m_window_iconify_callback;
 
     // State-specific callback maps
-    std::unordered_map<std::string, ScrollCallback> m_state_scroll_callbacks;
-    std::unordered_map<std::string, CharCallback> m_state_char_callbacks;
-    std::unordered_map<std::string, CursorEnterCallback> m_state_cursor_enter_callbacks;
-    std::unordered_map<std::string, WindowFocusCallback> m_state_window_focus_callbacks;
-    std::unordered_map<std::string, FramebufferSizeCallback> m_state_framebuffer_size_callbacks;
-    std::unordered_map<std::string, WindowSizeCallback> m_state_window_size_callbacks;
-    std::unordered_map<std::string, WindowIconifyCallback> m_state_window_iconify_callbacks;
+    FlatHashMap<InternedString, ScrollCallback> m_state_scroll_callbacks;
+    FlatHashMap<InternedString, CharCallback> m_state_char_callbacks;
+    FlatHashMap<InternedString, CursorEnterCallback> m_state_cursor_enter_callbacks;
+    FlatHashMap<InternedString, WindowFocusCallback> m_state_window_focus_callbacks;
+    FlatHashMap<InternedString, FramebufferSizeCallback> m_state_framebuffer_size_callbacks;
+    FlatHashMap<InternedString, WindowSizeCallback> m_state_window_size_callbacks;
+    FlatHashMap<InternedString, WindowIconifyCallback> m_state_window_iconify_callbacks;
 
     // Input state tracking
-    std::unordered_map<Key, bool> m_key_states;           // True if key is pressed
-    std::unordered_map<MouseButton, bool> m_mouse_states; // True if button is pressed
+    std::bitset<INPUT_COUNT> m_held_inputs; // Indexed by input_index
+
+    // Interned states and the active state's action snapshot
+    std::vector<InternedString> m_state_names; // Indexed by StateID
+    std::vector<ActionTable> m_action_tables;  // Indexed by StateID
+    StateID m_active_state_id;                 // NO_STATE until a state is activated
+    std::array<u8, MAX_ACTIONS> m_held_counts; // Held inputs driving each action
+    ActionMask m_actions_down;
+    ActionMask m_actions_pressed;
+    ActionMask m_actions_released;
 
     Vec2D m_mouse_position;
     Vec2 m_window_size;
+    u32 m_frame_event_count; // Since the last EndFrame
+
+    InputMode m_mode;
+    InputRecording m_recording;
+    SteadyClock::time_point m_recording_start;
+    size_t m_replay_frame;
+    bool m_replay_frame_injected; // Update runs more than once a frame while the window is iconified
 };
 
 } // namespace gouda
\ No newline at end of file
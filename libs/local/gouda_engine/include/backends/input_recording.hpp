@@ -0,0 +1,98 @@
+#pragma once
+/**
+ * @file backends/input_recording.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine input and frame timing recordings
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "backends/event_types.hpp"
+#include "containers/small_vector.hpp"
+#include "core/types.hpp"
+
+namespace gouda {
+
+inline constexpr u32 INPUT_RECORDING_VERSION{1}; // Bump whenever the file layout or a recorded event changes
+
+/**
+ * @struct RecordedEvent
+ * @brief An input event and when it was polled.
+ */
+struct RecordedEvent {
+    Event event;
+    f64 time; // Seconds since the recording started, the replay goes by frame and keeps it for inspection
+};
+
+/**
+ * @struct RecordedFrame
+ * @brief How far a frame advanced the loop, and the events polled at its start.
+ */
+struct RecordedFrame {
+    f32 delta_time;  // Unscaled seconds since the previous frame, the game clock scales it again on replay
+    u32 tick_count;  // Fixed step updates run during the frame
+    u32 first_event; // Into the recording's events
+    u32 event_count;
+};
+
+/**
+ * @class InputRecording
+ * @brief The input events and fixed step ticks of a run, frame by frame, for replaying it exactly.
+ *
+ * Only input is recorded: keys, mouse buttons, motion and scrolling, characters and the cursor entering the window.
+ * Window events such as resizes are left to the live window on replay, the recording cannot resize it. Files are the
+ * frames and the events packed back to back after a header and follow the build's layout like level files do, so
+ * they are only portable between builds of the same version and endianness.
+ */
+class InputRecording {
+public:
+    explicit InputRecording(f32 fixed_timestep = 0.0f);
+
+    /**
+     * @brief Whether an event is one recordings hold, the other events always come from the live window.
+     */
+    [[nodiscard]] static bool IsRecordedEvent(const Event &event) noexcept;
+
+    /**
+     * @brief Adds an event to the frame being recorded, events that are not recorded are ignored.
+     */
+    void AddEvent(const Event &event, f64 time);
+
+    /**
+     * @brief Closes the frame being recorded with the events added since the previous one.
+     */
+    void EndFrame(f32 delta_time, u32 tick_count);
+
+    void Clear();
+
+    [[nodiscard]] f32 GetFixedTimestep() const noexcept { return m_fixed_timestep; }
+    [[nodiscard]] std::span<const RecordedFrame> GetFrames() const noexcept { return m_frames; }
+    [[nodiscard]] size_t GetFrameCount() const noexcept { return m_frames.size(); }
+    [[nodiscard]] size_t GetEventCount() const noexcept { return m_events.size(); }
+    [[nodiscard]] std::span<const RecordedEvent> GetEvents(const RecordedFrame &frame) const noexcept;
+
+    /**
+     * @return False if the file could not be written.
+     */
+    bool Save(StringView filepath) const;
+
+    /**
+     * @return Nothing if the file is missing, from another version or malformed.
+     */
+    [[nodiscard]] static std::optional<InputRecording> Load(StringView filepath);
+
+private:
+    Vector<RecordedFrame> m_frames;
+    std::vector<RecordedEvent> m_events;
+    f32 m_fixed_timestep; // Of the run recorded, a replay at another step would not tick the same
+    u32 m_frame_first_event;
+};
+
+} // namespace gouda
@@ -20,7 +20,6 @@
 
 #include "core/types.hpp"
 #include "math/math.hpp"
-#include "math/random.hpp"
 
 namespace gouda {
 
@@ -184,6 +183,16 @@ public:
 
     bool IsDirty() const { return m_is_dirty; }
 
+    /**
+     * @brief Retrieves the camera's version, bumped every time its matrices change.
+     *
+     * Work derived from the camera, like the uniform matrices, can store the version it was built from and skip the
+     * rebuild while the version is unchanged. A camera that is not moving keeps its version from frame to frame.
+     *
+     * @return The current version, never 0.
+     */
+    u64 GetVersion() const { return m_version; }
+
 protected:
     /**
      * @brief Applies the various camera effects (e.g., shake, sway).
@@ -200,6 +209,22 @@ protected:
      */
     void ApplyFollow(f32 delta_time);
 
+    /**
+     * @brief Marks the cached matrices stale and bumps the version, call it on every change that moves the view.
+     */
+    void MarkChanged()
+    {
+        m_is_dirty = true;
+        ++m_version;
+    }
+
+    /**
+     * @brief Stores the shake and sway offset, marking the camera changed only when it differs from the last one.
+     *
+     * @param offset The offset returned by ApplyEffects.
+     */
+    void SetEffectOffset(const Vec3 &offset);
+
 protected:
     Vec3 m_position; ///< The position of the camera.
     Vec3 m_offset;   ///< Temporary offset for shake and sway effects.
@@ -213,10 +238,13 @@ protected:
     mutable Mat4 m_view_projection_matrix; ///< Cached view-projection matrix.
     mutable Mat4 m_view_matrix;            ///< Cached view matrix.
     mutable bool m_is_dirty;               ///< Flag indicating if the view matrix needs to be recomputed.
+    u64 m_version;                         ///< Bumped by MarkChanged, see GetVersion.
 
     // Shake effect parameters
     f32 m_shake_intensity; ///< Intensity of the shake effect.
     f32 m_shake_duration;  ///< Duration of the shake effect.
+    f32 m_shake_time;      ///< Time tracking for the shake noise.
+    u32 m_shake_seed;      ///< Noise seed, so cameras shaking together do not move in step.
 
     // Sway effect parameters
     f32 m_sway_amplitude; ///< Amplitude of the sway effect.
@@ -226,9 +254,6 @@ protected:
     // Follow effect parameters
     const Vec3 *p_follow_target; ///< Target that the camera should follow.
     f32 m_follow_speed;          ///< Speed at which the camera follows the target.
-
-private:
-    math::ThreadSafeRNG m_rng; ///< Thread-safe random number generator for effects.
 };
 
 } // namespace gouda
@@ -110,7 +110,7 @@ public:
         m_bottom = bottom;
         m_top = top;
         m_base_projection = math::ortho(left, right, bottom, top, m_near, m_far);
-        m_is_dirty = true;
+        MarkChanged();
     }
 
     struct FrustumData {
@@ -121,17 +121,12 @@ public:
         f32 top;       ///< The top boundary of the orthographic view, adjusted for zoom
     };
 
-    FrustumData GetFrustumData() const
-    {
-        FrustumData data{};
-        data.position = m_position;
-        data.left = m_left / m_zoom;
-        data.right = m_right / m_zoom;
-        data.bottom = m_bottom / m_zoom;
-        data.top = m_top / m_zoom;
-
-        return data;
-    }
+    /**
+     * @brief Retrieves the view bounds used for culling, cached alongside the matrices.
+     *
+     * @return The frustum data, valid until the camera next changes.
+     */
+    const FrustumData &GetFrustumData() const;
 
 private:
     /**
@@ -154,6 +149,7 @@ private:
     f32 m_zoom; ///< The current zoom level
 
     Mat4 m_base_projection; ///< The base projection matrix for the orthographic view.
+    mutable FrustumData m_frustum_data; ///< Cached culling bounds, rebuilt with the matrices.
 };
 
 } // namespace gouda
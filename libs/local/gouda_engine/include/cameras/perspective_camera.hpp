@@ -19,6 +19,7 @@
  */
 
 #include "cameras/camera.hpp"
+#include "math/collision.hpp"
 
 namespace gouda {
 
@@ -95,6 +96,16 @@ public:
      */
     void SetFOV(f32 fov);
 
+    /**
+     * @brief Retrieves the frustum planes used for culling, cached alongside the matrices.
+     *
+     * Batches of spheres and boxes are tested against it with math::cull_frustum, for 2.5D scenes and parallax layers
+     * where the orthographic camera's view rectangle does not apply.
+     *
+     * @return The frustum, valid until the camera next changes.
+     */
+    const math::Frustum &GetFrustum() const;
+
 private:
     /**
      * @brief Updates the camera's projection matrix.
@@ -109,6 +120,8 @@ private:
     f32 m_aspect; ///< The aspect ratio (width/height) of the camera's view.
     f32 m_near;   ///< The near clipping plane distance.
     f32 m_far;    ///< The far clipping plane distance.
+
+    mutable math::Frustum m_frustum; ///< Cached culling planes, rebuilt with the matrices.
 };
 
 } // namespace gouda
\ No newline at end of file
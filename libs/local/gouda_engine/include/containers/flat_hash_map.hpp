@@ -0,0 +1,718 @@
+#pragma once
+/**
+ * @file containers/flat_hash_map.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine open addressing hash map with group probing
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define GOUDA_FLAT_HASH_MAP_SSE2 1
+#endif
+
+#include "core/types.hpp"
+#include "debug/assert.hpp"
+#include "memory/allocators/default_allocator.hpp"
+#include "utils/hash.hpp"
+
+namespace gouda {
+
+/**
+ * @brief Default hash of FlatHashMap. Integers and enums are mixed, strings hashed from any string like type so
+ * String keyed maps can be searched with a StringView without building a String.
+ *
+ * Hashers that declare is_avalanching already spread every input bit over the result. The map mixes the result of
+ * any other hasher before using it, so a weak hash such as std::hash of an integer still probes well.
+ */
+template <typename K, typename = void>
+struct FlatHash {
+    [[nodiscard]] size_t operator()(const K &key) const noexcept(noexcept(std::hash<K>{}(key)))
+    {
+        return std::hash<K>{}(key);
+    }
+};
+
+template <typename K>
+struct FlatHash<K, std::enable_if_t<std::is_integral_v<K> || std::is_enum_v<K>>> {
+    using is_avalanching = void;
+
+    [[nodiscard]] size_t operator()(const K key) const noexcept { return utils::mix64(static_cast<u64>(key)); }
+};
+
+template <>
+struct FlatHash<String> {
+    using is_avalanching = void;
+    using is_transparent = void;
+
+    [[nodiscard]] size_t operator()(const StringView key) const noexcept { return utils::mix64(utils::fnv1a(key)); }
+};
+
+namespace internal {
+
+// Control byte of each slot: EMPTY and DELETED have the top bit set, a full slot holds the low 7 bits of its hash
+using ctrl_t = s8;
+inline constexpr ctrl_t CTRL_EMPTY{-128};
+inline constexpr ctrl_t CTRL_DELETED{-2};
+
+// Bit per slot of a group, iterated lowest slot first. Portable groups use the top bit of each byte, hence Shift.
+template <typename T, u32 Width, u32 Shift>
+class GroupMask {
+public:
+    explicit GroupMask(const T mask) noexcept : m_mask{mask} {}
+
+    [[nodiscard]] explicit operator bool() const noexcept { return m_mask != 0; }
+    [[nodiscard]] u32 Lowest() const noexcept { return static_cast<u32>(std::countr_zero(m_mask)) >> Shift; }
+    [[nodiscard]] u32 LeadingZeros() const noexcept
+    {
+        constexpr int unused_bits{static_cast<int>(sizeof(T) * 8 - (Width << Shift))};
+        return static_cast<u32>(std::countl_zero(m_mask) - unused_bits) >> Shift;
+    }
+    [[nodiscard]] u32 TrailingZeros() const noexcept
+    {
+        return static_cast<u32>(std::countr_zero(m_mask)) >> Shift;
+    }
+
+    void ClearLowest() noexcept { m_mask &= m_mask - 1; }
+
+private:
+    T m_mask;
+};
+
+#if defined(GOUDA_FLAT_HASH_MAP_SSE2)
+// Sixteen control bytes compared at once with SSE2
+class ControlGroup {
+public:
+    static constexpr size_t WIDTH{16};
+    using Mask = GroupMask<u32, WIDTH, 0>;
+
+    explicit ControlGroup(const ctrl_t *ctrl) noexcept
+        : m_ctrl{_mm_loadu_si128(reinterpret_cast<const __m128i *>(ctrl))}
+    {
+    }
+
+    [[nodiscard]] Mask Match(const ctrl_t h2) const noexcept
+    {
+        return Mask{static_cast<u32>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), m_ctrl)))};
+    }
+
+    [[nodiscard]] Mask MatchEmpty() const noexcept { return Match(CTRL_EMPTY); }
+
+    [[nodiscard]] Mask MatchEmptyOrDeleted() const noexcept
+    {
+        // EMPTY and DELETED are the only values below -1
+        return Mask{static_cast<u32>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), m_ctrl)))};
+    }
+
+private:
+    __m128i m_ctrl;
+};
+#else
+// Eight control bytes compared at once within a 64 bit word
+class ControlGroup {
+public:
+    static constexpr size_t WIDTH{8};
+    using Mask = GroupMask<u64, WIDTH, 3>;
+
+    explicit ControlGroup(const ctrl_t *ctrl) noexcept
+    {
+        std::memcpy(&m_ctrl, ctrl, sizeof(m_ctrl));
+        if constexpr (std::endian::native == std::endian::big) {
+            m_ctrl = std::byteswap(m_ctrl);
+        }
+    }
+
+    // May report a false match next to a true one, which the key comparison that follows filters out
+    [[nodiscard]] Mask Match(const ctrl_t h2) const noexcept
+    {
+        const u64 x{m_ctrl ^ (LSBS * static_cast<u8>(h2))};
+        return Mask{(x - LSBS) & ~x & MSBS};
+    }
+
+    [[nodiscard]] Mask MatchEmpty() const noexcept
+    {
+        return Mask{m_ctrl & ~(m_ctrl << 6) & MSBS};
+    }
+
+    [[nodiscard]] Mask MatchEmptyOrDeleted() const noexcept
+    {
+        return Mask{m_ctrl & ~(m_ctrl << 7) & MSBS};
+    }
+
+private:
+    static constexpr u64 LSBS{0x0101010101010101ull};
+    static constexpr u64 MSBS{0x8080808080808080ull};
+
+    u64 m_ctrl;
+};
+#endif
+
+template <typename Hash, typename = void>
+inline constexpr bool is_avalanching_v = false;
+
+template <typename Hash>
+inline constexpr bool is_avalanching_v<Hash, std::void_t<typename Hash::is_avalanching>> = true;
+
+template <typename Hash, typename Eq, typename = void>
+inline constexpr bool is_transparent_v = false;
+
+template <typename Hash, typename Eq>
+inline constexpr bool
+    is_transparent_v<Hash, Eq, std::void_t<typename Hash::is_transparent, typename Eq::is_transparent>> = true;
+
+} // namespace internal
+
+/**
+ * @class FlatHashMap
+ * @brief Hash map storing its entries inline in one array, probed a group of slots at a time.
+ *
+ * Every slot has a control byte holding 7 bits of its key's hash, or a marker for empty and erased slots. A lookup
+ * loads a group of control bytes (16 with SSE2, 8 otherwise), compares them all against the hash in one step and
+ * only compares keys where the bits match, so a probe usually costs one group load and one key comparison. Tables
+ * are a power of two in size and grow at 7/8 full. Erased slots become tombstones, unless no probe can have passed
+ * through them, and are dropped the next time the table is rebuilt.
+ *
+ * Entries live in the slot array, so insertion that grows the table and erasure invalidate iterators, pointers and
+ * references. Iteration order is unspecified. Keys must not be modified through an iterator.
+ *
+ * @tparam K Key type.
+ * @tparam V Mapped type.
+ * @tparam Hash Hasher. With Eq also transparent, lookups accept any type the hasher and Eq accept.
+ * @tparam Eq Key equality.
+ * @tparam Allocator Source of the slot array, with the interface of DefaultAllocator.
+ */
+template <typename K, typename V, typename Hash = FlatHash<K>, typename Eq = std::equal_to<>,
+          typename Allocator = DefaultAllocator<std::pair<K, V>>>
+class FlatHashMap {
+public:
+    using key_type = K;
+    using mapped_type = V;
+    using value_type = std::pair<K, V>;
+    using size_type = size_t;
+    using hasher = Hash;
+    using key_equal = Eq;
+    using allocator_type = Allocator;
+
+    static_assert(std::is_same_v<typename Allocator::value_type, value_type>, "Allocator must allocate the entry type");
+
+private:
+    using ctrl_t = internal::ctrl_t;
+    using Group = internal::ControlGroup;
+    using CtrlAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<ctrl_t>;
+
+    template <bool Const>
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = FlatHashMap::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<Const, const value_type *, value_type *>;
+        using reference = std::conditional_t<Const, const value_type &, value_type &>;
+
+        Iterator() noexcept : p_ctrl{nullptr}, p_slot{nullptr}, p_end{nullptr} {}
+        Iterator(const ctrl_t *ctrl, pointer slot, const ctrl_t *end) noexcept : p_ctrl{ctrl}, p_slot{slot}, p_end{end}
+        {
+        }
+        template <bool OtherConst, typename = std::enable_if_t<Const && !OtherConst>>
+        Iterator(const Iterator<OtherConst> &other) noexcept
+            : p_ctrl{other.p_ctrl}, p_slot{other.p_slot}, p_end{other.p_end}
+        {
+        }
+
+        reference operator*() const noexcept { return *p_slot; }
+        pointer operator->() const noexcept { return p_slot; }
+
+        Iterator &operator++() noexcept
+        {
+            ++p_ctrl;
+            ++p_slot;
+            SkipFree();
+            return *this;
+        }
+
+        Iterator operator++(int) noexcept
+        {
+            Iterator previous{*this};
+            ++*this;
+            return previous;
+        }
+
+        [[nodiscard]] bool operator==(const Iterator &other) const noexcept { return p_ctrl == other.p_ctrl; }
+
+    private:
+        friend class FlatHashMap;
+        template <bool>
+        friend class Iterator;
+
+        void SkipFree() noexcept
+        {
+            while (p_ctrl != p_end && *p_ctrl < 0) {
+                ++p_ctrl;
+                ++p_slot;
+            }
+        }
+
+        const ctrl_t *p_ctrl;
+        pointer p_slot;
+        const ctrl_t *p_end;
+    };
+
+public:
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+private:
+    // Iterators are excluded so erase(iterator) never resolves to erase by key on a transparent map
+    template <typename Q>
+    static constexpr bool is_lookup_key_v =
+        (std::is_convertible_v<const Q &, const K &> || internal::is_transparent_v<Hash, Eq>) &&
+        !std::is_convertible_v<const Q &, const_iterator>;
+
+public:
+
+    FlatHashMap() : p_ctrl{nullptr}, p_slots{nullptr}, m_capacity{0}, m_size{0}, m_growth_left{0} {}
+
+    explicit FlatHashMap(const Allocator &allocator)
+        : p_ctrl{nullptr}, p_slots{nullptr}, m_capacity{0}, m_size{0}, m_growth_left{0}, m_allocator{allocator}
+    {
+    }
+
+    FlatHashMap(const FlatHashMap &other)
+        : p_ctrl{nullptr}, p_slots{nullptr}, m_capacity{0}, m_size{0}, m_growth_left{0}, m_hash{other.m_hash},
+          m_eq{other.m_eq}, m_allocator{other.m_allocator}
+    {
+        reserve(other.m_size);
+        for (const value_type &entry : other) {
+            InsertUnique(HashOf(entry.first), entry);
+        }
+    }
+
+    FlatHashMap(FlatHashMap &&other) noexcept
+        : p_ctrl{std::exchange(other.p_ctrl, nullptr)}, p_slots{std::exchange(other.p_slots, nullptr)},
+          m_capacity{std::exchange(other.m_capacity, 0)}, m_size{std::exchange(other.m_size, 0)},
+          m_growth_left{std::exchange(other.m_growth_left, 0)}, m_hash{std::move(other.m_hash)},
+          m_eq{std::move(other.m_eq)}, m_allocator{std::move(other.m_allocator)}
+    {
+    }
+
+    FlatHashMap &operator=(const FlatHashMap &other)
+    {
+        if (this != &other) {
+            FlatHashMap copy{other};
+            swap(copy);
+        }
+        return *this;
+    }
+
+    FlatHashMap &operator=(FlatHashMap &&other) noexcept
+    {
+        if (this != &other) {
+            FlatHashMap moved{std::move(other)};
+            swap(moved);
+        }
+        return *this;
+    }
+
+    ~FlatHashMap() { ReleaseStorage(); }
+
+    // Lookup -----------------------------------------------------------------------------------------------------
+
+    template <typename Q = K, typename = std::enable_if_t<is_lookup_key_v<Q>>>
+    [[nodiscard]] iterator find(const Q &key)
+    {
+        const size_t index{FindIndex(key, HashOf(key))};
+        return index == m_capacity ? end() : MakeIterator(index);
+    }
+
+    template <typename Q = K, typename = std::enable_if_t<is_lookup_key_v<Q>>>
+    [[nodiscard]] const_iterator find(const Q &key) const
+    {
+        const size_t index{FindIndex(key, HashOf(key))};
+        return index == m_capacity ? end() : MakeIterator(index);
+    }
+
+    template <typename Q = K, typename = std::enable_if_t<is_lookup_key_v<Q>>>
+    [[nodiscard]] bool contains(const Q &key) const
+    {
+        return FindIndex(key, HashOf(key)) != m_capacity;
+    }
+
+    /**
+     * @return The mapped value, or nullptr if the key is not present.
+     */
+    template <typename Q = K, typename = std::enable_if_t<is_lookup_key_v<Q>>>
+    [[nodiscard]] V *get(const Q &key)
+    {
+        const size_t index{FindIndex(key, HashOf(key))};
+        return index == m_capacity ? nullptr : &p_slots[index].second;
+    }
+
+    template <typename Q = K, typename = std::enable_if_t<is_lookup_key_v<Q>>>
+    [[nodiscard]] const V *get(const Q &key) const
+    {
+        const size_t index{FindIndex(key, HashOf(key))};
+        return index == m_capacity ? nullptr : &p_slots[index].second;
+    }
+
+    template <typename Q = K, typename = std::enable_if_t<is_lookup_key_v<Q>>>
+    V &at(const Q &key)
+    {
+        V *value{get(key)};
+        ASSERT(value != nullptr, "Key not present in flat hash map.");
+        return *value;
+    }
+
+    template <typename Q = K, typename = std::enable_if_t<is_lookup_key_v<Q>>>
+    const V &at(const Q &key) const
+    {
+        const V *value{get(key)};
+        ASSERT(value != nullptr, "Key not present in flat hash map.");
+        return *value;
+    }
+
+    // Insertion --------------------------------------------------------------------------------------------------
+
+    /**
+     * @brief Inserts an entry built from args unless the key is present, in which case args are left untouched.
+     *
+     * With a transparent hasher, the key may be any type K is constructible from and is only converted to K when
+     * the entry is inserted, so a hit on a String keyed map with a StringView allocates nothing.
+     */
+    template <typename Q, typename... Args>
+    std::pair<iterator, bool> try_emplace(Q &&key, Args &&...args)
+    {
+        const size_t hash{HashOf(key)};
+        if (const size_t index{FindIndex(key, hash)}; index != m_capacity) {
+            return {MakeIterator(index), false};
+        }
+
+        const size_t index{PrepareInsert(hash)};
+        std::construct_at(p_slots + index, std::piecewise_construct, std::forward_as_tuple(std::forward<Q>(key)),
+                          std::forward_as_tuple(std::forward<Args>(args)...));
+        return {MakeIterator(index), true};
+    }
+
+    template <typename Q, typename U>
+    std::pair<iterator, bool> emplace(Q &&key, U &&value)
+    {
+        return try_emplace(std::forward<Q>(key), std::forward<U>(value));
+    }
+
+    std::pair<iterator, bool> insert(const value_type &entry) { return try_emplace(entry.first, entry.second); }
+    std::pair<iterator, bool> insert(value_type &&entry)
+    {
+        return try_emplace(std::move(entry.first), std::move(entry.second));
+    }
+
+    template <typename Q, typename U>
+    std::pair<iterator, bool> insert_or_assign(Q &&key, U &&value)
+    {
+        auto result{try_emplace(std::forward<Q>(key), std::forward<U>(value))};
+        if (!result.second) {
+            result.first->second = std::forward<U>(value);
+        }
+        return result;
+    }
+
+    template <typename Q>
+    V &operator[](Q &&key)
+    {
+        return try_emplace(std::forward<Q>(key)).first->second;
+    }
+
+    // Erasure ----------------------------------------------------------------------------------------------------
+
+    template <typename Q = K, typename = std::enable_if_t<is_lookup_key_v<Q>>>
+    size_t erase(const Q &key)
+    {
+        const size_t index{FindIndex(key, HashOf(key))};
+        if (index == m_capacity) {
+            return 0;
+        }
+        EraseIndex(index);
+        return 1;
+    }
+
+    /**
+     * @return Iterator to the entry after the erased one.
+     */
+    iterator erase(const const_iterator position)
+    {
+        const size_t index{static_cast<size_t>(position.p_ctrl - p_ctrl)};
+        EraseIndex(index);
+        iterator next{MakeIterator(index)};
+        next.SkipFree();
+        return next;
+    }
+
+    /**
+     * @brief Destroys every entry, keeping the table for reuse.
+     */
+    void clear() noexcept
+    {
+        if (m_capacity == 0) {
+            return;
+        }
+
+        if constexpr (!std::is_trivially_destructible_v<value_type>) {
+            for (size_t i = 0; i < m_capacity; ++i) {
+                if (p_ctrl[i] >= 0) {
+                    std::destroy_at(p_slots + i);
+                }
+            }
+        }
+        std::memset(p_ctrl, static_cast<u8>(internal::CTRL_EMPTY), m_capacity + Group::WIDTH);
+        m_size = 0;
+        m_growth_left = MaxLoad(m_capacity);
+    }
+
+    // Capacity ---------------------------------------------------------------------------------------------------
+
+    /**
+     * @brief Grows the table so count entries fit without rehashing.
+     */
+    void reserve(const size_t count)
+    {
+        if (count > m_size + m_growth_left) {
+            Rehash(CapacityFor(count));
+        }
+    }
+
+    [[nodiscard]] size_t size() const noexcept { return m_size; }
+    [[nodiscard]] bool empty() const noexcept { return m_size == 0; }
+    [[nodiscard]] size_t capacity() const noexcept { return m_capacity; }
+    [[nodiscard]] f32 load_factor() const noexcept
+    {
+        return m_capacity == 0 ? 0.0f : static_cast<f32>(m_size) / static_cast<f32>(m_capacity);
+    }
+
+    [[nodiscard]] allocator_type get_allocator() const noexcept { return m_allocator; }
+
+    // Iteration --------------------------------------------------------------------------------------------------
+
+    iterator begin() noexcept
+    {
+        iterator it{p_ctrl, p_slots, p_ctrl + m_capacity};
+        it.SkipFree();
+        return it;
+    }
+    iterator end() noexcept { return MakeIterator(m_capacity); }
+    const_iterator begin() const noexcept { return const_cast<FlatHashMap *>(this)->begin(); }
+    const_iterator end() const noexcept { return const_cast<FlatHashMap *>(this)->end(); }
+
+    void swap(FlatHashMap &other) noexcept
+    {
+        std::swap(p_ctrl, other.p_ctrl);
+        std::swap(p_slots, other.p_slots);
+        std::swap(m_capacity, other.m_capacity);
+        std::swap(m_size, other.m_size);
+        std::swap(m_growth_left, other.m_growth_left);
+        std::swap(m_hash, other.m_hash);
+        std::swap(m_eq, other.m_eq);
+        std::swap(m_allocator, other.m_allocator);
+    }
+
+private:
+    static constexpr size_t MIN_CAPACITY{Group::WIDTH};
+
+    [[nodiscard]] static constexpr size_t MaxLoad(const size_t capacity) noexcept { return capacity - capacity / 8; }
+
+    [[nodiscard]] static size_t CapacityFor(const size_t count) noexcept
+    {
+        // Smallest power of two whose 7/8 holds count
+        return std::max(MIN_CAPACITY, std::bit_ceil(count + (count + 6) / 7));
+    }
+
+    // High bits pick the first group, the low 7 bits are stored in the control byte
+    [[nodiscard]] static size_t H1(const size_t hash) noexcept { return hash >> 7; }
+    [[nodiscard]] static ctrl_t H2(const size_t hash) noexcept { return static_cast<ctrl_t>(hash & 0x7f); }
+
+    template <typename Q>
+    [[nodiscard]] size_t HashOf(const Q &key) const
+    {
+        if constexpr (internal::is_avalanching_v<Hash>) {
+            return m_hash(key);
+        }
+        else {
+            return static_cast<size_t>(utils::mix64(static_cast<u64>(m_hash(key))));
+        }
+    }
+
+    [[nodiscard]] iterator MakeIterator(const size_t index) noexcept
+    {
+        return {p_ctrl + index, p_slots + index, p_ctrl + m_capacity};
+    }
+
+    [[nodiscard]] const_iterator MakeIterator(const size_t index) const noexcept
+    {
+        return {p_ctrl + index, p_slots + index, p_ctrl + m_capacity};
+    }
+
+    // Writes a control byte and its copy past the end, which lets a group load starting near the end wrap round
+    void SetCtrl(const size_t index, const ctrl_t value) noexcept
+    {
+        p_ctrl[index] = value;
+        p_ctrl[((index - Group::WIDTH) & (m_capacity - 1)) + Group::WIDTH] = value;
+    }
+
+    // Slot holding the key, or m_capacity if it is not present. Groups are visited in triangular steps, which covers
+    // every group of a power of two table before repeating.
+    template <typename Q>
+    [[nodiscard]] size_t FindIndex(const Q &key, const size_t hash) const
+    {
+        if (m_size == 0) {
+            return m_capacity;
+        }
+
+        const size_t mask{m_capacity - 1};
+        const ctrl_t h2{H2(hash)};
+        size_t position{H1(hash) & mask};
+        size_t step{0};
+        while (true) {
+            const Group group{p_ctrl + position};
+            for (auto match{group.Match(h2)}; match; match.ClearLowest()) {
+                const size_t index{(position + match.Lowest()) & mask};
+                if (m_eq(p_slots[index].first, key)) [[likely]] {
+                    return index;
+                }
+            }
+            if (group.MatchEmpty()) [[likely]] {
+                return m_capacity;
+            }
+            step += Group::WIDTH;
+            position = (position + step) & mask;
+        }
+    }
+
+    // First empty or erased slot on the key's probe sequence
+    [[nodiscard]] size_t FindFreeIndex(const size_t hash) const noexcept
+    {
+        const size_t mask{m_capacity - 1};
+        size_t position{H1(hash) & mask};
+        size_t step{0};
+        while (true) {
+            if (const auto free{Group{p_ctrl + position}.MatchEmptyOrDeleted()}) {
+                return (position + free.Lowest()) & mask;
+            }
+            step += Group::WIDTH;
+            position = (position + step) & mask;
+        }
+    }
+
+    // Claims a slot for a key known to be absent, growing first if the table is full. The slot is left unconstructed.
+    [[nodiscard]] size_t PrepareInsert(const size_t hash)
+    {
+        size_t index{m_capacity == 0 ? 0 : FindFreeIndex(hash)};
+        if (m_capacity == 0 || (m_growth_left == 0 && p_ctrl[index] != internal::CTRL_DELETED)) {
+            // Rebuilding at the same size is enough when tombstones are what fills the table
+            Rehash(m_size * 2 < MaxLoad(m_capacity) ? m_capacity : CapacityFor(m_size + 1));
+            index = FindFreeIndex(hash);
+        }
+
+        if (p_ctrl[index] == internal::CTRL_EMPTY) {
+            --m_growth_left;
+        }
+        SetCtrl(index, H2(hash));
+        ++m_size;
+        return index;
+    }
+
+    void InsertUnique(const size_t hash, const value_type &entry)
+    {
+        std::construct_at(p_slots + PrepareInsert(hash), entry);
+    }
+
+    void EraseIndex(const size_t index)
+    {
+        std::destroy_at(p_slots + index);
+        --m_size;
+
+        // A slot can go back to empty when it never sat in a full group, as then no probe sequence continued past it
+        const size_t mask{m_capacity - 1};
+        const auto empty_before{Group{p_ctrl + ((index - Group::WIDTH) & mask)}.MatchEmpty()};
+        const auto empty_after{Group{p_ctrl + index}.MatchEmpty()};
+        const bool was_never_full{empty_before && empty_after &&
+                                  empty_before.LeadingZeros() + empty_after.TrailingZeros() < Group::WIDTH};
+        SetCtrl(index, was_never_full ? internal::CTRL_EMPTY : internal::CTRL_DELETED);
+        if (was_never_full) {
+            ++m_growth_left;
+        }
+    }
+
+    void Rehash(const size_t new_capacity)
+    {
+        ctrl_t *old_ctrl{p_ctrl};
+        value_type *old_slots{p_slots};
+        const size_t old_capacity{m_capacity};
+
+        CtrlAllocator ctrl_allocator{m_allocator};
+        p_ctrl = ctrl_allocator.allocate(new_capacity + Group::WIDTH);
+        try {
+            p_slots = m_allocator.allocate(new_capacity);
+        }
+        catch (...) {
+            ctrl_allocator.deallocate(p_ctrl, new_capacity + Group::WIDTH);
+            p_ctrl = old_ctrl;
+            throw;
+        }
+        std::memset(p_ctrl, static_cast<u8>(internal::CTRL_EMPTY), new_capacity + Group::WIDTH);
+        m_capacity = new_capacity;
+        m_growth_left = MaxLoad(new_capacity) - m_size;
+
+        for (size_t i = 0; i < old_capacity; ++i) {
+            if (old_ctrl[i] >= 0) {
+                const size_t hash{HashOf(old_slots[i].first)};
+                const size_t index{FindFreeIndex(hash)};
+                SetCtrl(index, H2(hash));
+                std::construct_at(p_slots + index, std::move(old_slots[i]));
+                std::destroy_at(old_slots + i);
+            }
+        }
+
+        if (old_capacity > 0) {
+            ctrl_allocator.deallocate(old_ctrl, old_capacity + Group::WIDTH);
+            m_allocator.deallocate(old_slots, old_capacity);
+        }
+    }
+
+    void ReleaseStorage() noexcept
+    {
+        if (m_capacity == 0) {
+            return;
+        }
+
+        clear();
+        CtrlAllocator ctrl_allocator{m_allocator};
+        ctrl_allocator.deallocate(p_ctrl, m_capacity + Group::WIDTH);
+        m_allocator.deallocate(p_slots, m_capacity);
+        p_ctrl = nullptr;
+        p_slots = nullptr;
+        m_capacity = 0;
+        m_growth_left = 0;
+    }
+
+private:
+    ctrl_t *p_ctrl;        // m_capacity control bytes, then a copy of the first group
+    value_type *p_slots;   // Constructed only where the control byte is full
+    size_t m_capacity;     // Power of two, or 0 before the first insertion
+    size_t m_size;
+    size_t m_growth_left;  // Empty slots that may still be filled before the table must grow
+    [[no_unique_address]] Hash m_hash;
+    [[no_unique_address]] Eq m_eq;
+    [[no_unique_address]] Allocator m_allocator;
+};
+
+} // namespace gouda
@@ -0,0 +1,195 @@
+#pragma once
+/**
+ * @file containers/mpsc_queue.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine bounded lock free multi producer single consumer queue
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <array>
+#include <atomic>
+#include <bit>
+#include <span>
+#include <utility>
+
+#include "core/types.hpp"
+
+namespace gouda {
+
+/**
+ * @class MPSCQueue
+ * @brief Fixed size ring any number of threads push to and one thread pops from, without locks or allocations.
+ *
+ * Every cell carries a sequence number telling producers whether the cell is free for their position and the
+ * consumer whether the value in it was published, so a producer only contends with other producers on a single
+ * compare exchange of the tail. Pushing to a full queue fails instead of blocking, the caller decides whether to
+ * drop or retry. Values are copied in and moved out, so they should be small and cheap to copy.
+ *
+ * @tparam T Value type, default constructible and copy assignable.
+ * @tparam Capacity Number of cells, a power of two.
+ */
+template <typename T, size_t Capacity>
+class MPSCQueue {
+    static_assert(std::has_single_bit(Capacity), "MPSCQueue capacity must be a power of two");
+
+public:
+    MPSCQueue() : m_tail{0}, m_head{0}, m_epoch{0}
+    {
+        for (size_t i = 0; i < Capacity; ++i) {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MPSCQueue(const MPSCQueue &) = delete;
+    MPSCQueue &operator=(const MPSCQueue &) = delete;
+
+    /**
+     * @brief Appends a value, safe from any thread.
+     * @return False, leaving the queue unchanged, if it is full.
+     */
+    [[nodiscard]] bool TryPush(const T &value)
+    {
+        size_t position{m_tail.load(std::memory_order_relaxed)};
+        while (true) {
+            Cell &cell{m_cells[position & MASK]};
+            const size_t sequence{cell.sequence.load(std::memory_order_acquire)};
+            if (sequence == position) {
+                if (m_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    cell.value = value;
+                    cell.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (sequence < position) {
+                return false; // The consumer has not popped the value a lap behind yet
+            }
+            else {
+                position = m_tail.load(std::memory_order_relaxed); // Another producer took this position
+            }
+        }
+    }
+
+    /**
+     * @brief Appends all of the values or none of them, safe from any thread. They take consecutive positions, so
+     *        they are popped together unless another producer's values were still being written before them.
+     * @return False, leaving the queue unchanged, if they do not all fit.
+     */
+    [[nodiscard]] bool TryPushBatch(const std::span<const T> values)
+    {
+        if (values.empty()) {
+            return true;
+        }
+        if (values.size() > Capacity) {
+            return false;
+        }
+
+        size_t position{m_tail.load(std::memory_order_relaxed)};
+        while (true) {
+            // The consumer frees cells in order, so the batch fits once its last cell is free
+            const size_t last{position + values.size() - 1};
+            const size_t sequence{m_cells[last & MASK].sequence.load(std::memory_order_acquire)};
+            if (sequence == last) {
+                if (m_tail.compare_exchange_weak(position, position + values.size(), std::memory_order_relaxed)) {
+                    break;
+                }
+            }
+            else if (sequence < last) {
+                return false;
+            }
+            else {
+                position = m_tail.load(std::memory_order_relaxed);
+            }
+        }
+
+        for (size_t i = 0; i < values.size(); ++i) {
+            Cell &cell{m_cells[(position + i) & MASK]};
+            cell.value = values[i];
+            cell.sequence.store(position + i + 1, std::memory_order_release);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Takes the oldest published value, only ever from the consumer thread.
+     * @return False if the queue is empty or the next value is still being written.
+     */
+    [[nodiscard]] bool TryPop(T &value)
+    {
+        Cell &cell{m_cells[m_head & MASK]};
+        if (cell.sequence.load(std::memory_order_acquire) != m_head + 1) {
+            return false;
+        }
+
+        value = std::move(cell.value);
+        cell.sequence.store(m_head + Capacity, std::memory_order_release);
+        ++m_head;
+        return true;
+    }
+
+    /**
+     * @brief Takes up to values.size() of the oldest published values, only ever from the consumer thread.
+     * @return How many were popped into the front of values.
+     */
+    [[nodiscard]] size_t TryPopBatch(const std::span<T> values)
+    {
+        size_t count{0};
+        while (count < values.size() && TryPop(values[count])) {
+            ++count;
+        }
+        return count;
+    }
+
+    /**
+     * @brief Whether the next value is not published yet, only ever from the consumer thread.
+     */
+    [[nodiscard]] bool IsEmpty() const noexcept
+    {
+        return m_cells[m_head & MASK].sequence.load(std::memory_order_acquire) != m_head + 1;
+    }
+
+    /**
+     * @brief Blocks the consumer until a value is published or Notify is called.
+     *
+     * Pushes alone do not wake it, so producers that want the consumer to sleep call Notify after the values they
+     * pushed. Spurious returns are possible, callers pop in a loop anyway.
+     */
+    void Wait() const
+    {
+        const u32 epoch{m_epoch.load(std::memory_order_acquire)};
+        if (IsEmpty()) {
+            m_epoch.wait(epoch, std::memory_order_acquire);
+        }
+    }
+
+    /**
+     * @brief Wakes a consumer blocked in Wait, from any thread. Also how a consumer is told to stop.
+     */
+    void Notify()
+    {
+        m_epoch.fetch_add(1, std::memory_order_release);
+        m_epoch.notify_one();
+    }
+
+    [[nodiscard]] static constexpr size_t GetCapacity() noexcept { return Capacity; }
+
+private:
+    static constexpr size_t MASK{Capacity - 1};
+    static constexpr size_t CACHE_LINE_SIZE{64};
+
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value{};
+    };
+
+    // Producers and the consumer each write their own index, kept on separate lines so they do not share one
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_tail;
+    alignas(CACHE_LINE_SIZE) size_t m_head;
+    alignas(CACHE_LINE_SIZE) std::atomic<u32> m_epoch; // Bumped by Notify, what Wait blocks on
+    alignas(CACHE_LINE_SIZE) std::array<Cell, Capacity> m_cells;
+};
+
+} // namespace gouda
@@ -0,0 +1,110 @@
+#pragma once
+/**
+ * @file containers/object_pool.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine fixed size object pool
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <memory>
+#include <utility>
+
+#include "containers/small_vector.hpp"
+#include "core/types.hpp"
+#include "debug/assert.hpp"
+
+namespace gouda {
+
+/**
+ * @class ObjectPool
+ * @brief Objects of one type carved out of fixed size chunks, reusing freed cells through an intrusive free list.
+ *
+ * Chunks are allocated as the pool grows and never move or shrink, so objects keep their address for as long as they
+ * live. Creating and destroying is O(1) and touches no allocator once the pool has reached its working size.
+ *
+ * @tparam T Object type.
+ * @tparam ChunkSize Objects per chunk.
+ */
+template <typename T, size_t ChunkSize = 256>
+class ObjectPool {
+    static_assert(ChunkSize > 0, "ObjectPool chunks must hold at least one object");
+
+public:
+    ObjectPool() : p_free{nullptr}, m_live_count{0} {}
+    ~ObjectPool() { ASSERT(m_live_count == 0, "Object pool destroyed with {} objects alive.", m_live_count); }
+
+    ObjectPool(const ObjectPool &) = delete;
+    ObjectPool &operator=(const ObjectPool &) = delete;
+
+    template <typename... Args>
+    [[nodiscard]] T *Create(Args &&...args)
+    {
+        if (p_free == nullptr) {
+            AddChunk();
+        }
+
+        Cell *cell{p_free};
+        p_free = cell->next;
+        T *object{std::construct_at(reinterpret_cast<T *>(cell->storage), std::forward<Args>(args)...)};
+        ++m_live_count;
+        return object;
+    }
+
+    /**
+     * @brief Destroys an object created by this pool and returns its cell to the free list.
+     */
+    void Destroy(T *object)
+    {
+        if (object == nullptr) {
+            return;
+        }
+
+        std::destroy_at(object);
+        Cell *cell{::new (static_cast<void *>(object)) Cell{}};
+        cell->next = p_free;
+        p_free = cell;
+        --m_live_count;
+    }
+
+    /**
+     * @brief Allocates chunks up front for at least count objects.
+     */
+    void Reserve(const size_t count)
+    {
+        while (GetCapacity() < count) {
+            AddChunk();
+        }
+    }
+
+    [[nodiscard]] size_t GetLiveCount() const noexcept { return m_live_count; }
+    [[nodiscard]] size_t GetCapacity() const noexcept { return m_chunks.size() * ChunkSize; }
+
+private:
+    // An object while in use, a link in the free list otherwise
+    union Cell {
+        Cell *next;
+        alignas(T) std::byte storage[sizeof(T)];
+    };
+
+    void AddChunk()
+    {
+        std::unique_ptr<Cell[]> chunk{std::make_unique<Cell[]>(ChunkSize)};
+        // Linked back to front so cells are handed out in address order
+        for (size_t i = ChunkSize; i-- > 0;) {
+            chunk[i].next = p_free;
+            p_free = &chunk[i];
+        }
+        m_chunks.push_back(std::move(chunk));
+    }
+
+private:
+    Vector<std::unique_ptr<Cell[]>> m_chunks;
+    Cell *p_free;
+    size_t m_live_count;
+};
+
+} // namespace gouda
@@ -0,0 +1,176 @@
+#pragma once
+/**
+ * @file containers/slot_map.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine dense slot map with generational handles
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <utility>
+
+#include "containers/small_vector.hpp"
+#include "core/types.hpp"
+#include "debug/assert.hpp"
+
+namespace gouda {
+
+/**
+ * @struct SlotHandle
+ * @brief Names a value in a SlotMap. A handle outlives its value safely, the generation tells it apart from whatever
+ * later reuses the slot.
+ */
+struct SlotHandle {
+    u32 index{constants::u32_max};
+    u32 generation{0};
+
+    [[nodiscard]] bool operator==(const SlotHandle &) const = default;
+};
+
+inline constexpr SlotHandle INVALID_SLOT_HANDLE{};
+
+/**
+ * @class SlotMap
+ * @brief Values kept contiguous and looked up through stable handles.
+ *
+ * Handles index a slot, which points at the value's position in the dense array. Erasing moves the last value into
+ * the gap, so insertion, erasure and lookup are O(1) and iteration walks packed memory, in no particular order.
+ * Pointers and references into the map are invalidated by any insertion or erasure, handles are not.
+ *
+ * @tparam T Value type, move assignable.
+ */
+template <typename T>
+class SlotMap {
+public:
+    using iterator = typename Vector<T>::iterator;
+    using const_iterator = typename Vector<T>::const_iterator;
+
+    SlotMap() : m_free_head{constants::u32_max} {}
+
+    template <typename... Args>
+    [[nodiscard]] SlotHandle Emplace(Args &&...args)
+    {
+        u32 slot_index{m_free_head};
+        if (slot_index != constants::u32_max) {
+            m_free_head = m_slots[slot_index].dense_index;
+        }
+        else {
+            slot_index = static_cast<u32>(m_slots.size());
+            m_slots.push_back({0, 0});
+        }
+
+        Slot &slot{m_slots[slot_index]};
+        slot.dense_index = static_cast<u32>(m_values.size());
+        m_values.emplace_back(std::forward<Args>(args)...);
+        m_dense_slots.push_back(slot_index);
+        return {slot_index, slot.generation};
+    }
+
+    [[nodiscard]] SlotHandle Insert(T value) { return Emplace(std::move(value)); }
+
+    /**
+     * @brief Destroys the value, its handle and every copy of it become stale.
+     * @return False if the handle was already stale.
+     */
+    bool Erase(const SlotHandle handle)
+    {
+        if (!Contains(handle)) {
+            return false;
+        }
+
+        Slot &slot{m_slots[handle.index]};
+        const u32 dense_index{slot.dense_index};
+        const u32 moved_slot{m_dense_slots.back()};
+        m_values.swap_remove(m_values.begin() + dense_index);
+        m_dense_slots.swap_remove(m_dense_slots.begin() + dense_index);
+        m_slots[moved_slot].dense_index = dense_index;
+
+        ++slot.generation;
+        slot.dense_index = m_free_head;
+        m_free_head = handle.index;
+        return true;
+    }
+
+    [[nodiscard]] bool Contains(const SlotHandle handle) const noexcept
+    {
+        return handle.index < m_slots.size() && m_slots[handle.index].generation == handle.generation;
+    }
+
+    /**
+     * @return The value, or nullptr if the handle is stale.
+     */
+    [[nodiscard]] T *Get(const SlotHandle handle) noexcept
+    {
+        return Contains(handle) ? &m_values[m_slots[handle.index].dense_index] : nullptr;
+    }
+
+    [[nodiscard]] const T *Get(const SlotHandle handle) const noexcept
+    {
+        return Contains(handle) ? &m_values[m_slots[handle.index].dense_index] : nullptr;
+    }
+
+    T &operator[](const SlotHandle handle)
+    {
+        ASSERT(Contains(handle), "Stale slot map handle {}:{}.", handle.index, handle.generation);
+        return m_values[m_slots[handle.index].dense_index];
+    }
+
+    const T &operator[](const SlotHandle handle) const
+    {
+        ASSERT(Contains(handle), "Stale slot map handle {}:{}.", handle.index, handle.generation);
+        return m_values[m_slots[handle.index].dense_index];
+    }
+
+    /**
+     * @brief Handle of the value at a position of the dense array, for iterations that need to name what they visit.
+     */
+    [[nodiscard]] SlotHandle GetHandle(const size_t dense_index) const noexcept
+    {
+        const u32 slot_index{m_dense_slots[dense_index]};
+        return {slot_index, m_slots[slot_index].generation};
+    }
+
+    /**
+     * @brief Destroys every value, all handles become stale.
+     */
+    void Clear()
+    {
+        while (!m_values.empty()) {
+            Erase(GetHandle(m_values.size() - 1));
+        }
+    }
+
+    void Reserve(const size_t capacity)
+    {
+        m_values.reserve(capacity);
+        m_dense_slots.reserve(capacity);
+        m_slots.reserve(capacity);
+    }
+
+    [[nodiscard]] size_t Size() const noexcept { return m_values.size(); }
+    [[nodiscard]] bool Empty() const noexcept { return m_values.empty(); }
+
+    [[nodiscard]] T *Data() noexcept { return m_values.data(); }
+    [[nodiscard]] const T *Data() const noexcept { return m_values.data(); }
+
+    iterator begin() { return m_values.begin(); }
+    iterator end() { return m_values.end(); }
+    const_iterator begin() const { return m_values.begin(); }
+    const_iterator end() const { return m_values.end(); }
+
+private:
+    struct Slot {
+        u32 dense_index; // Next free slot while the slot is free
+        u32 generation;  // Bumped on erase, so handles to the erased value go stale
+    };
+
+    Vector<T> m_values;
+    Vector<u32> m_dense_slots; // Slot of each value, parallel to m_values
+    Vector<Slot> m_slots;
+    u32 m_free_head;
+};
+
+} // namespace gouda
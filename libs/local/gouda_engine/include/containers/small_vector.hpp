@@ -12,10 +12,13 @@
  * See <https://www.gnu.org/licenses/> for more information.
  */
 #include "debug/assert.hpp"
+#include "memory/allocators/default_allocator.hpp"
 #include <algorithm> // For std::uninitialized_copy_n
+#include <cstring>   // For std::memcpy and std::memmove
 #include <iterator>
 #include <memory>
 #include <new> // For std::launder
+#include <type_traits>
 
 namespace gouda {
 
@@ -43,21 +46,51 @@ struct GrowthPolicyAddOne {
     static size_t next(const size_t current) { return current + 1; }
 };
 
+/**
+ * @brief Whether a T can be moved to other storage by copying its bytes, the original then being dead without its
+ *        destructor running. Specialize it for types that qualify without being trivially copyable.
+ */
+template <typename T>
+struct is_trivially_relocatable
+    : std::bool_constant<std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>> {};
+
+template <typename T>
+inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
 /**
  * @brief SmallVector is a dynamic array optimized for small sizes.
  *        It uses a statically allocated buffer for the first N elements
- *        and falls back to heap allocation beyond that.
+ *        and falls back to the allocator beyond that.
+ *
+ * The allocator moves with the storage it allocated: move construction, move assignment and swap carry it over,
+ * copies take the source's. Copy assignment keeps the current one.
+ *
+ * Growth, insertion and erasure move trivially relocatable elements with memcpy and memmove rather than one by one.
+ *
  * @tparam T Element type
  * @tparam N Stack capacity
  * @tparam GrowthPolicy Policy used to determine growth behavior
+ * @tparam Allocator Source of the storage beyond the stack capacity, with the interface of DefaultAllocator
  */
-template <typename T, size_t N, typename GrowthPolicy = GrowthPolicyOnePointFive>
+template <typename T, size_t N, typename GrowthPolicy = GrowthPolicyOnePointFive,
+          typename Allocator = DefaultAllocator<T>>
 class SmallVector {
+    static_assert(std::is_same_v<typename Allocator::value_type, T>, "Allocator must allocate the element type");
+
 public:
     /**
      * @brief Default constructor initializes with empty vector using stack storage.
      */
-    SmallVector() : m_data(stack_data()), m_size(0), m_capacity(N) {}
+    SmallVector() : m_size(0), m_capacity(N), m_data(stack_data()), m_allocator() {}
+
+    /**
+     * @brief Constructs an empty vector that grows into the given allocator.
+     * @param allocator The allocator to use beyond the stack capacity.
+     */
+    explicit SmallVector(const Allocator &allocator)
+        : m_size(0), m_capacity(N), m_data(stack_data()), m_allocator(allocator)
+    {
+    }
 
     /**
      * @brief Initializes the SmallVector with elements from an initializer list.
@@ -66,8 +99,10 @@ public:
      * Reserves capacity upfront to avoid multiple reallocations.
      *
      * @param init The initializer list of elements to populate the vector with.
+     * @param allocator The allocator to use (default: Allocator()).
      */
-    SmallVector(std::initializer_list<T> init) : m_data(stack_data()), m_size(0), m_capacity(N)
+    SmallVector(std::initializer_list<T> init, const Allocator &allocator = Allocator())
+        : m_size(0), m_capacity(N), m_data(stack_data()), m_allocator(allocator)
     {
         if (init.size() > N) {
             reserve(init.size()); // Use heap if needed
@@ -80,10 +115,11 @@ public:
     /**
      * @brief Constructs a SmallVector with count default-initialized elements.
      * @param count The number of elements to create.
-     * @param alloc The allocator to use (default: Allocator()).
+     * @param allocator The allocator to use (default: Allocator()).
      * @throws Any exception thrown by T's default constructor or allocator.
      */
-    explicit SmallVector(size_t count) : m_size(0), m_capacity(N), m_data(stack_data())
+    explicit SmallVector(size_t count, const Allocator &allocator = Allocator())
+        : m_size(0), m_capacity(N), m_data(stack_data()), m_allocator(allocator)
     {
         if (count > N) {
             reserve(count);
@@ -104,8 +140,10 @@ public:
      * @brief Constructs a SmallVector with count copies of a given value.
      * @param count The number of elements.
      * @param value The value to copy into each element.
+     * @param allocator The allocator to use (default: Allocator()).
      */
-    SmallVector(const size_t count, const T &value) : m_size(0), m_capacity(N), m_data(stack_data())
+    SmallVector(const size_t count, const T &value, const Allocator &allocator = Allocator())
+        : m_size(0), m_capacity(N), m_data(stack_data()), m_allocator(allocator)
     {
         if (count > N) {
             reserve(count);
@@ -123,63 +161,31 @@ public:
     ~SmallVector()
     {
         clear();
-        if (m_data != stack_data()) {
-            ::operator delete(m_data);
-        }
+        release_storage();
     }
 
     /**
      * @brief Move constructor transfers ownership from another SmallVector.
-     * @param other The SmallVector to move from.
+     * @param other The SmallVector to move from, left empty on its stack storage.
      */
-    SmallVector(SmallVector&& other) noexcept
-        : m_size(0), m_capacity(N), m_data(stack_data()) {
-        if (other.m_data == other.stack_data()) {
-            // Copy stack data to our stack
-            std::uninitialized_copy_n(other.m_data, other.m_size, m_data);
-            m_size = other.m_size;
-            // Clear other's elements
-            for (size_t i = 0; i < other.m_size; ++i) other.m_data[i].~T();
-            other.m_size = 0;
-        } else {
-            // Take heap data
-            m_data = other.m_data;
-            m_size = other.m_size;
-            m_capacity = other.m_capacity;
-            other.m_data = nullptr; // Prevent double-free
-            other.m_size = 0;
-            other.m_capacity = 0;
-        }
+    SmallVector(SmallVector &&other) noexcept
+        : m_size(0), m_capacity(N), m_data(stack_data()), m_allocator(other.m_allocator)
+    {
+        take_elements(other);
     }
 
     /**
      * @brief Move assignment operator transfers ownership and cleans up current data.
-     * @param other The SmallVector to move from.
+     * @param other The SmallVector to move from, left empty on its stack storage.
      * @return Reference to this SmallVector.
      */
-    SmallVector& operator=(SmallVector&& other) noexcept {
+    SmallVector &operator=(SmallVector &&other) noexcept
+    {
         if (this != &other) {
             clear();
-            if (m_data != stack_data()) ::operator delete(m_data);
-            m_data = stack_data();
-            m_size = 0;
-            m_capacity = N;
-            if (other.m_data == other.stack_data()) {
-                // Copy stack data to our stack
-                std::uninitialized_copy_n(other.m_data, other.m_size, m_data);
-                m_size = other.m_size;
-                // Clear other's elements
-                for (size_t i = 0; i < other.m_size; ++i) other.m_data[i].~T();
-                other.m_size = 0;
-            } else {
-                // Take heap data
-                m_data = other.m_data;
-                m_size = other.m_size;
-                m_capacity = other.m_capacity;
-                other.m_data = nullptr; // Prevent double-free
-                other.m_size = 0;
-                other.m_capacity = 0;
-            }
+            release_storage();
+            m_allocator = other.m_allocator;
+            take_elements(other);
         }
         return *this;
     }
@@ -188,7 +194,8 @@ public:
      * @brief Copy constructor duplicates the contents of another SmallVector.
      * @param other The SmallVector to copy from.
      */
-    SmallVector(const SmallVector &other) : m_size(0), m_capacity(N), m_data(stack_data())
+    SmallVector(const SmallVector &other)
+        : m_size(0), m_capacity(N), m_data(stack_data()), m_allocator(other.m_allocator)
     {
         reserve(other.m_size);
         try {
@@ -196,39 +203,46 @@ public:
             m_size = other.m_size;
         }
         catch (...) {
-            // Clean up partially constructed elements
-            clear();
-            if (m_data != stack_data()) {
-                ::operator delete(m_data);
-                m_data = stack_data();
-            }
+            // uninitialized_copy_n destroyed what it constructed, only the storage is left
+            release_storage();
             throw;
         }
     }
 
     /**
-     * @brief Copy assignment operator via copy-and-swap idiom.
+     * @brief Copy assignment operator, reusing the current storage when it is large enough.
      * @param other The SmallVector to copy from.
      * @return Reference to this SmallVector.
      */
     SmallVector &operator=(const SmallVector &other)
     {
+        // Swapping with a copy would hand this vector the copy's inline buffer, so elements are copied in place
         if (this != &other) {
-            SmallVector temp(other);
-            swap(temp);
+            clear();
+            reserve(other.m_size);
+            std::uninitialized_copy_n(other.m_data, other.m_size, m_data);
+            m_size = other.m_size;
         }
         return *this;
     }
 
     /**
-     * @brief Swaps this vector with another.
+     * @brief Swaps this vector with another, along with their allocators.
      * @param other The SmallVector to swap with.
      */
     void swap(SmallVector &other) noexcept
     {
+        if (m_data == stack_data() || other.m_data == other.stack_data()) {
+            // Elements on the stack cannot change hands by pointer
+            SmallVector temporary{std::move(other)};
+            other = std::move(*this);
+            *this = std::move(temporary);
+            return;
+        }
         std::swap(m_data, other.m_data);
         std::swap(m_size, other.m_size);
         std::swap(m_capacity, other.m_capacity);
+        std::swap(m_allocator, other.m_allocator);
     }
 
     /**
@@ -271,6 +285,23 @@ public:
         return *ptr;
     }
 
+    /**
+     * @brief Appends count elements without initializing them, for the caller to fill in place.
+     * @param count The number of elements to append.
+     * @return Pointer to the first appended element.
+     */
+    T *push_back_uninitialized(const size_t count = 1)
+    {
+        static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>,
+                      "Only trivial elements may be left uninitialized");
+        if (m_size + count > m_capacity) {
+            reserve(std::max(GrowthPolicy::next(m_capacity), m_size + count));
+        }
+        T *first = m_data + m_size;
+        m_size += count;
+        return first;
+    }
+
     /**
      * @brief Removes the last element from the vector.
      * @pre The vector must not be empty.
@@ -293,23 +324,26 @@ public:
         if (new_cap <= m_capacity) {
             return;
         }
-        T *new_data = static_cast<T *>(::operator new(new_cap * sizeof(T)));
-        try {
-            for (size_t i = 0; i < m_size; ++i) {
-                new (new_data + i) T(std::move_if_noexcept(m_data[i]));
-                m_data[i].~T();
-            }
+        T *new_data = m_allocator.allocate(new_cap);
+        if constexpr (is_trivially_relocatable_v<T>) {
+            relocate(new_data, m_data, m_size);
         }
-        catch (...) {
-            for (size_t i = 0; i < m_size; ++i) {
-                new_data[i].~T();
+        else {
+            try {
+                for (size_t i = 0; i < m_size; ++i) {
+                    new (new_data + i) T(std::move_if_noexcept(m_data[i]));
+                    m_data[i].~T();
+                }
+            }
+            catch (...) {
+                for (size_t i = 0; i < m_size; ++i) {
+                    new_data[i].~T();
+                }
+                m_allocator.deallocate(new_data, new_cap);
+                throw;
             }
-            ::operator delete(new_data);
-            throw;
-        }
-        if (m_data != stack_data()) {
-            ::operator delete(m_data);
         }
+        release_storage();
         m_data = new_data;
         m_capacity = new_cap;
     }
@@ -356,6 +390,29 @@ public:
         m_size = new_size;
     }
 
+    /**
+     * @brief Resizes the vector without initializing new elements, for the caller to fill in place.
+     * @param new_size New size of the vector.
+     */
+    void resize_uninitialized(const size_t new_size)
+    {
+        static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>,
+                      "Only trivial elements may be left uninitialized");
+        reserve(new_size);
+        m_size = new_size;
+    }
+
+    /**
+     * @brief Replaces the contents with count copies of a given value, keeping the capacity.
+     * @param count The number of elements.
+     * @param value The value to copy into each element.
+     */
+    void assign(size_t count, const T &value)
+    {
+        clear();
+        resize(count, value);
+    }
+
     /**
      * @brief Reduces capacity to match current size.
      */
@@ -365,22 +422,16 @@ public:
             if (m_size <= N) {
                 // Move back to stack
                 T *new_data = stack_data();
-                for (size_t i = 0; i < m_size; ++i) {
-                    new (new_data + i) T(std::move(m_data[i]));
-                    m_data[i].~T();
-                }
-                ::operator delete(m_data);
+                relocate(new_data, m_data, m_size);
+                release_storage();
                 m_data = new_data;
                 m_capacity = N;
             }
             else {
                 // Reallocate heap
-                T *new_data = static_cast<T *>(::operator new(m_size * sizeof(T)));
-                for (size_t i = 0; i < m_size; ++i) {
-                    new (new_data + i) T(std::move(m_data[i]));
-                    m_data[i].~T();
-                }
-                ::operator delete(m_data);
+                T *new_data = m_allocator.allocate(m_size);
+                relocate(new_data, m_data, m_size);
+                release_storage();
                 m_data = new_data;
                 m_capacity = m_size;
             }
@@ -536,12 +587,19 @@ public:
     const_reverse_iterator crend() const { return const_reverse_iterator(begin()); }
 
     using value_type = T;
+    using allocator_type = Allocator;
     using size_type = size_t;
     using reference = T &;
     using const_reference = const T &;
     using pointer = T *;
     using const_pointer = const T *;
 
+    /**
+     * @brief Returns the allocator used beyond the stack capacity.
+     * @return A copy of the allocator.
+     */
+    allocator_type get_allocator() const noexcept { return m_allocator; }
+
     /**
      * @brief Inserts an element at a specified position.
      * @param pos The position at which to insert the element.
@@ -554,10 +612,7 @@ public:
         if (m_size == m_capacity) {
             grow();
         }
-        for (size_t i = m_size; i > index; --i) {
-            new (m_data + i) T(std::move(m_data[i - 1]));
-            m_data[i - 1].~T();
-        }
+        shift(index, index + 1);
         new (m_data + index) T(value);
         ++m_size;
         return m_data + index;
@@ -575,10 +630,7 @@ public:
         if (m_size == m_capacity) {
             grow();
         }
-        for (size_t i = m_size; i > index; --i) {
-            new (m_data + i) T(std::move(m_data[i - 1]));
-            m_data[i - 1].~T();
-        }
+        shift(index, index + 1);
         new (m_data + index) T(std::move(value));
         ++m_size;
         return m_data + index;
@@ -600,10 +652,7 @@ public:
             const size_t new_capacity = GrowthPolicy::next(std::max(m_capacity, m_size + count));
             reserve(new_capacity);
         }
-        for (size_t i = m_size + count - 1; i >= index + count; --i) {
-            new (m_data + i) T(std::move(m_data[i - count]));
-            m_data[i - count].~T();
-        }
+        shift(index, index + count);
         size_t i = 0;
         for (; first != last; ++first, ++i) {
             new (m_data + index + i) T(*first);
@@ -623,10 +672,7 @@ public:
         m_data[index].~T(); // Destroy the element
 
         // Move elements to fill the gap
-        for (size_t i = index; i < m_size - 1; ++i) {
-            new (m_data + i) T(std::move(m_data[i + 1]));
-            m_data[i + 1].~T();
-        }
+        shift(index + 1, index);
 
         --m_size;
         return m_data + index;
@@ -650,16 +696,108 @@ public:
         }
 
         // Move elements to fill the gap
-        for (size_t i = end; i < m_size; ++i) {
-            new (m_data + i - count) T(std::move(m_data[i]));
-            m_data[i].~T();
-        }
+        shift(end, start);
 
         m_size -= count;
         return m_data + start;
     }
 
+    /**
+     * @brief Erases the element at the given position by moving the last element into its place.
+     *        Constant time, but the order of the elements is not kept.
+     * @param pos Iterator to the element to remove.
+     * @return Iterator to the element that took its place, or end() if it was the last.
+     */
+    iterator swap_remove(const_iterator pos)
+    {
+        const size_t index = pos - begin();
+        ASSERT(index < m_size, "swap_remove past the end of SmallVector");
+        if (index != m_size - 1) {
+            m_data[index] = std::move(m_data[m_size - 1]);
+        }
+        pop_back();
+        return m_data + index;
+    }
+
 private:
+    /**
+     * @brief Returns heap storage to the allocator. The caller has destroyed the elements or moved them out.
+     */
+    void release_storage() noexcept
+    {
+        if (m_data != stack_data()) {
+            m_allocator.deallocate(m_data, m_capacity);
+            m_data = stack_data();
+            m_capacity = N;
+        }
+    }
+
+    /**
+     * @brief Takes the elements of other into this empty vector on its stack storage, leaving other the same.
+     *        Heap storage changes hands, stack elements are moved one by one.
+     */
+    void take_elements(SmallVector &other) noexcept
+    {
+        if (other.m_data == other.stack_data()) {
+            relocate(m_data, other.m_data, other.m_size);
+            m_size = other.m_size;
+            other.m_size = 0;
+        }
+        else {
+            m_data = other.m_data;
+            m_size = other.m_size;
+            m_capacity = other.m_capacity;
+            other.m_data = other.stack_data();
+            other.m_size = 0;
+            other.m_capacity = N;
+        }
+    }
+
+    /**
+     * @brief Moves count elements into uninitialized storage that does not overlap them, ending the sources' lifetime.
+     */
+    static void relocate(T *destination, T *source, const size_t count) noexcept
+    {
+        if constexpr (is_trivially_relocatable_v<T>) {
+            if (count > 0) {
+                std::memcpy(static_cast<void *>(destination), static_cast<const void *>(source), count * sizeof(T));
+            }
+        }
+        else {
+            for (size_t i = 0; i < count; ++i) {
+                new (destination + i) T(std::move(source[i]));
+                source[i].~T();
+            }
+        }
+    }
+
+    /**
+     * @brief Moves the elements from index from to the end so they start at index to instead. The slots they leave
+     *        uncovered are left uninitialized, those they move onto must be uninitialized already.
+     */
+    void shift(const size_t from, const size_t to) noexcept
+    {
+        if (from >= m_size || from == to) {
+            return;
+        }
+        const size_t count = m_size - from;
+        if constexpr (is_trivially_relocatable_v<T>) {
+            std::memmove(static_cast<void *>(m_data + to), static_cast<const void *>(m_data + from), count * sizeof(T));
+        }
+        else if (to > from) {
+            for (size_t i = count; i-- > 0;) {
+                new (m_data + to + i) T(std::move(m_data[from + i]));
+                m_data[from + i].~T();
+            }
+        }
+        else {
+            for (size_t i = 0; i < count; ++i) {
+                new (m_data + to + i) T(std::move(m_data[from + i]));
+                m_data[from + i].~T();
+            }
+        }
+    }
+
     /**
      * @brief Grows the capacity using the selected GrowthPolicy.
      */
@@ -679,10 +817,11 @@ private:
     size_t m_size;
     size_t m_capacity;
     T *m_data;
+    [[no_unique_address]] Allocator m_allocator;
     alignas(T) char m_stack_buffer[sizeof(T) * N];
 };
 
-template <typename T>
-using Vector = SmallVector<T, 0>;
+template <typename T, typename Allocator = DefaultAllocator<T>>
+using Vector = SmallVector<T, 0, GrowthPolicyOnePointFive, Allocator>;
 
 } // namespace gouda
\ No newline at end of file
@@ -0,0 +1,179 @@
+#pragma once
+/**
+ * @file containers/spsc_queue.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine bounded lock free single producer single consumer queue
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <span>
+#include <utility>
+
+#include "core/types.hpp"
+
+namespace gouda {
+
+/**
+ * @class SPSCQueue
+ * @brief Fixed size ring one thread pushes to and one thread pops from, without locks, allocations or read-modify-
+ * write operations.
+ *
+ * Each side owns one index and keeps a cached copy of the other's, so it only reads the other side's cache line
+ * when the cached copy says the ring is full or empty. Batches are published with a single store. Pushing to a full
+ * queue fails instead of blocking. Values are copied or moved in and moved out.
+ *
+ * The producer and the consumer may be different threads over time, as long as something like a mutex orders the
+ * hand over from one to the next.
+ *
+ * @tparam T Value type, default constructible and move assignable.
+ * @tparam Capacity Number of cells, a power of two.
+ */
+template <typename T, size_t Capacity>
+class SPSCQueue {
+    static_assert(std::has_single_bit(Capacity), "SPSCQueue capacity must be a power of two");
+
+public:
+    SPSCQueue() : m_tail{0}, m_cached_head{0}, m_head{0}, m_cached_tail{0}, m_epoch{0} {}
+
+    SPSCQueue(const SPSCQueue &) = delete;
+    SPSCQueue &operator=(const SPSCQueue &) = delete;
+
+    /**
+     * @brief Appends a value, only ever from the producer thread.
+     * @return False, leaving the queue unchanged, if it is full.
+     */
+    [[nodiscard]] bool TryPush(const T &value) { return TryEmplace(value); }
+    [[nodiscard]] bool TryPush(T &&value) { return TryEmplace(std::move(value)); }
+
+    template <typename U>
+    [[nodiscard]] bool TryEmplace(U &&value)
+    {
+        const size_t tail{m_tail.load(std::memory_order_relaxed)};
+        if (tail - m_cached_head == Capacity) {
+            m_cached_head = m_head.load(std::memory_order_acquire);
+            if (tail - m_cached_head == Capacity) {
+                return false;
+            }
+        }
+
+        m_cells[tail & MASK] = std::forward<U>(value);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Appends as many of the values as fit, in order, published together.
+     * @return How many were pushed, from the front of values.
+     */
+    [[nodiscard]] size_t TryPushBatch(const std::span<const T> values)
+    {
+        const size_t tail{m_tail.load(std::memory_order_relaxed)};
+        if (Capacity - (tail - m_cached_head) < values.size()) {
+            m_cached_head = m_head.load(std::memory_order_acquire);
+        }
+
+        const size_t count{std::min(values.size(), Capacity - (tail - m_cached_head))};
+        for (size_t i = 0; i < count; ++i) {
+            m_cells[(tail + i) & MASK] = values[i];
+        }
+        if (count > 0) {
+            m_tail.store(tail + count, std::memory_order_release);
+        }
+        return count;
+    }
+
+    /**
+     * @brief Takes the oldest value, only ever from the consumer thread.
+     * @return False if the queue is empty.
+     */
+    [[nodiscard]] bool TryPop(T &value)
+    {
+        const size_t head{m_head.load(std::memory_order_relaxed)};
+        if (head == m_cached_tail) {
+            m_cached_tail = m_tail.load(std::memory_order_acquire);
+            if (head == m_cached_tail) {
+                return false;
+            }
+        }
+
+        value = std::move(m_cells[head & MASK]);
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Takes up to values.size() of the oldest values, their cells are handed back together.
+     * @return How many were popped into the front of values.
+     */
+    [[nodiscard]] size_t TryPopBatch(const std::span<T> values)
+    {
+        const size_t head{m_head.load(std::memory_order_relaxed)};
+        if (m_cached_tail - head < values.size()) {
+            m_cached_tail = m_tail.load(std::memory_order_acquire);
+        }
+
+        const size_t count{std::min(values.size(), m_cached_tail - head)};
+        for (size_t i = 0; i < count; ++i) {
+            values[i] = std::move(m_cells[(head + i) & MASK]);
+        }
+        if (count > 0) {
+            m_head.store(head + count, std::memory_order_release);
+        }
+        return count;
+    }
+
+    /**
+     * @brief Exact on the consumer thread, a hint anywhere else.
+     */
+    [[nodiscard]] bool IsEmpty() const noexcept
+    {
+        return m_head.load(std::memory_order_relaxed) == m_tail.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Blocks the consumer until the queue is not empty or Notify is called.
+     *
+     * Pushes alone do not wake it, so a producer that wants the consumer to sleep calls Notify after the values it
+     * pushed. Spurious returns are possible, callers pop in a loop anyway.
+     */
+    void Wait() const
+    {
+        const u32 epoch{m_epoch.load(std::memory_order_acquire)};
+        if (IsEmpty()) {
+            m_epoch.wait(epoch, std::memory_order_acquire);
+        }
+    }
+
+    /**
+     * @brief Wakes a consumer blocked in Wait, from any thread. Also how a consumer is told to stop.
+     */
+    void Notify()
+    {
+        m_epoch.fetch_add(1, std::memory_order_release);
+        m_epoch.notify_one();
+    }
+
+    [[nodiscard]] static constexpr size_t GetCapacity() noexcept { return Capacity; }
+
+private:
+    static constexpr size_t MASK{Capacity - 1};
+    static constexpr size_t CACHE_LINE_SIZE{64};
+
+    // Each side's index and its cached copy of the other's share a line, which the other side only reads
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_tail;
+    size_t m_cached_head;
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_head;
+    size_t m_cached_tail;
+    alignas(CACHE_LINE_SIZE) std::atomic<u32> m_epoch; // Bumped by Notify, what Wait blocks on
+    alignas(CACHE_LINE_SIZE) std::array<T, Capacity> m_cells{};
+};
+
+} // namespace gouda
@@ -81,6 +81,7 @@ using Seconds = std::chrono::seconds;
 using TimePoint = std::chrono::time_point<std::chrono::high_resolution_clock>;
 using DateTime = std::chrono::system_clock::time_point;
 using FloatingPointMicroseconds = std::chrono::duration<double, std::micro>;
+using FloatingPointMilliseconds = std::chrono::duration<double, std::milli>;
 
 using String = std::basic_string<char>;
 using StringView = std::basic_string_view<char>;
@@ -302,6 +303,11 @@ struct Colour {
     [[nodiscard]] constexpr T& operator[](std::size_t i) { return data[i]; }
     [[nodiscard]] constexpr const T& operator[](std::size_t i) const { return data[i]; }
 
+    [[nodiscard]] constexpr bool operator==(const Colour &other) const
+    {
+        return r == other.r && g == other.g && b == other.b && a == other.a;
+    }
+
     [[nodiscard]] constexpr std::span<T, 4> as_span() { return data; }
     [[nodiscard]] constexpr std::span<const T, 4> as_span() const { return data; }
 
@@ -0,0 +1,110 @@
+#pragma once
+/**
+ * @file debug/debug_draw.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine batched debug line, shape and text drawing
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "containers/small_vector.hpp"
+#include "core/types.hpp"
+#include "math/collision.hpp"
+#include "renderers/render_data.hpp"
+
+// Debug builds only, the DEBUG_DRAW macros expand to nothing otherwise and their arguments are never evaluated
+#ifndef NDEBUG
+#define ENGINE_DEBUG_DRAW
+#endif
+
+namespace gouda {
+
+// Laid out by the renderer on the main thread, the text cache is not thread safe
+struct DebugText {
+    String text;
+    Vec2 position;
+    Colour<f32> colour;
+    f32 scale;
+    bool screen_space;
+};
+
+/**
+ * @class DebugDraw
+ * @brief Collects the debug lines, boxes, circles and texts of a frame for the renderer to draw over everything.
+ *
+ * Every call appends an analytic shape instance, see QuadShape, to a buffer of the calling thread, so jobs draw
+ * without contending with each other. The renderer takes every thread's buffer once per frame and appends them to
+ * the frame's quads at DEPTH, in front of the UI overlay. They sort into the last alpha blended run, which they share
+ * with the UI, so the whole overlay costs no extra draw. Positions are in world space unless screen_space is set.
+ * Drawn for one frame only, calls made while a frame is collected land in the next.
+ */
+class DebugDraw {
+public:
+    static constexpr f32 DEPTH{-1.0f};
+    static constexpr f32 DEFAULT_WIDTH{1.5f};
+    static constexpr f32 DEFAULT_TEXT_SCALE{16.0f};
+
+    static DebugDraw &Get();
+
+    void Line(const Vec2 &from, const Vec2 &to, const Colour<f32> &colour, f32 width = DEFAULT_WIDTH,
+              bool screen_space = false);
+    void Box(const math::AABB2D &box, const Colour<f32> &colour, f32 width = DEFAULT_WIDTH, bool screen_space = false);
+    void FilledBox(const math::AABB2D &box, const Colour<f32> &colour, bool screen_space = false);
+    void Circle(const Vec2 &center, f32 radius, const Colour<f32> &colour, f32 width = DEFAULT_WIDTH,
+                bool screen_space = false);
+    void Text(StringView text, const Vec2 &position, const Colour<f32> &colour, f32 scale = DEFAULT_TEXT_SCALE,
+              bool screen_space = false);
+
+    /**
+     * @brief Font the texts are laid out with. Texts are dropped while it is 0, the default font has no glyphs.
+     */
+    void SetTextFont(const u32 font_id) { m_text_font_id = font_id; }
+    [[nodiscard]] u32 GetTextFont() const { return m_text_font_id; }
+
+    /**
+     * @brief Moves what every thread drew since the last flush to the end of the lists. Called by the renderer.
+     */
+    void Flush(std::vector<InstanceData> &shapes, Vector<DebugText> &texts);
+
+    void Clear();
+
+private:
+    struct ThreadBuffer {
+        std::mutex mutex; // Only contended while the buffer is flushed
+        std::vector<InstanceData> shapes;
+        Vector<DebugText> texts;
+    };
+
+    DebugDraw() = default;
+
+    ThreadBuffer &GetThreadBuffer();
+    void AddShape(InstanceData shape);
+
+private:
+    std::mutex m_buffers_mutex;
+    Vector<std::unique_ptr<ThreadBuffer>> m_buffers; // Never shrinks, buffers outlive the threads that drew into them
+    u32 m_text_font_id{0};
+};
+
+} // namespace gouda
+
+#ifdef ENGINE_DEBUG_DRAW
+#define DEBUG_DRAW_LINE(...) gouda::DebugDraw::Get().Line(__VA_ARGS__)
+#define DEBUG_DRAW_BOX(...) gouda::DebugDraw::Get().Box(__VA_ARGS__)
+#define DEBUG_DRAW_FILLED_BOX(...) gouda::DebugDraw::Get().FilledBox(__VA_ARGS__)
+#define DEBUG_DRAW_CIRCLE(...) gouda::DebugDraw::Get().Circle(__VA_ARGS__)
+#define DEBUG_DRAW_TEXT(...) gouda::DebugDraw::Get().Text(__VA_ARGS__)
+#else
+#define DEBUG_DRAW_LINE(...)
+#define DEBUG_DRAW_BOX(...)
+#define DEBUG_DRAW_FILLED_BOX(...)
+#define DEBUG_DRAW_CIRCLE(...)
+#define DEBUG_DRAW_TEXT(...)
+#endif
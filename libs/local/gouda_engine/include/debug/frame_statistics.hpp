@@ -0,0 +1,103 @@
+#pragma once
+/**
+ * @file debug/frame_statistics.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine rolling frame time statistics
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <array>
+#include <fstream>
+
+#include "containers/small_vector.hpp"
+#include "core/types.hpp"
+
+namespace gouda {
+
+enum class FrameMetric : u8 { CpuFrameTime, GpuFrameTime, PresentLatency, FenceWait };
+inline constexpr size_t FRAME_METRIC_COUNT{static_cast<size_t>(FrameMetric::FenceWait) + 1};
+
+/**
+ * @struct FrameSample
+ * @brief One frame's times in milliseconds, in FrameMetric order.
+ */
+struct FrameSample {
+    f32 cpu_frame_time;  // Unscaled time between the starts of two frames
+    f32 gpu_frame_time;  // From the renderer's GPU timer, a few frames late
+    f32 present_latency; // Blocked acquiring the swapchain image and presenting it
+    f32 fence_wait_time; // Blocked waiting for the GPU to release the frame's resources
+};
+
+/**
+ * @struct FrameMetricSummary
+ * @brief Distribution of one metric over the window, percentiles by nearest rank.
+ */
+struct FrameMetricSummary {
+    f32 p50{0.0f};
+    f32 p95{0.0f};
+    f32 p99{0.0f};
+    f32 max{0.0f};
+    f32 mean{0.0f};
+    u32 hitch_count{0}; // Samples above the hitch factor times the median
+};
+
+/**
+ * @class FrameStatistics
+ * @brief Rolling window of frame times with percentiles, hitch counts and an optional CSV capture.
+ *
+ * Samples overwrite the oldest once the window is full. Summaries are recomputed on the first query after a sample
+ * was added, so adding a frame stays a copy. While a capture is running every sample is also written as a CSV row,
+ * which keeps the whole session rather than the last window.
+ */
+class FrameStatistics {
+public:
+    static constexpr size_t DEFAULT_WINDOW_SIZE{1024};
+    static constexpr f32 DEFAULT_HITCH_FACTOR{2.0f};
+
+    explicit FrameStatistics(size_t window_size = DEFAULT_WINDOW_SIZE, f32 hitch_factor = DEFAULT_HITCH_FACTOR);
+    ~FrameStatistics();
+
+    FrameStatistics(const FrameStatistics &) = delete;
+    FrameStatistics &operator=(const FrameStatistics &) = delete;
+
+    void AddFrame(const FrameSample &sample);
+    void Clear();
+
+    [[nodiscard]] const FrameMetricSummary &GetSummary(FrameMetric metric) const;
+    [[nodiscard]] size_t GetSampleCount() const noexcept { return m_sample_count; }
+    [[nodiscard]] u64 GetFrameCount() const noexcept { return m_frame_count; }
+
+    /**
+     * @brief Starts writing every following frame to a CSV file, replacing a capture already running.
+     * @return False if the file could not be created.
+     */
+    bool StartCsvCapture(StringView filepath);
+    void StopCsvCapture();
+    [[nodiscard]] bool IsCapturing() const { return m_csv_stream.is_open(); }
+
+    [[nodiscard]] static StringView GetMetricName(FrameMetric metric);
+
+private:
+    void UpdateSummaries() const;
+
+private:
+    Vector<std::array<f32, FRAME_METRIC_COUNT>> m_samples; // Ring, m_next_sample is the oldest once full
+    size_t m_window_size;
+    size_t m_next_sample;
+    size_t m_sample_count;
+    u64 m_frame_count;
+    f32 m_hitch_factor;
+
+    mutable std::array<FrameMetricSummary, FRAME_METRIC_COUNT> m_summaries;
+    mutable Vector<f32> m_sorted; // Scratch for the percentiles
+    mutable bool m_summaries_dirty;
+
+    std::ofstream m_csv_stream;
+    u64 m_csv_first_frame;
+};
+
+} // namespace gouda
@@ -0,0 +1,100 @@
+#pragma once
+/**
+ * @file debug/log_file_sink.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine buffered, rotating log file
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+
+#include "core/types.hpp"
+
+namespace gouda {
+
+struct LogFileSettings {
+    size_t buffer_size{256 * 1024};         ///< Lines are held until this fills or the logger flushes.
+    Milliseconds sync_period{2000};         ///< How often written lines are synced to disk, 0 to leave it to the OS.
+    size_t max_file_size{64 * 1024 * 1024}; ///< The file is rotated before growing past this, 0 for no limit.
+    Seconds max_file_age{0};                ///< The file is rotated once it is this old, 0 for no limit.
+    u32 max_rotated_files{8};               ///< The oldest rotated files past this many are deleted.
+    bool compress_rotated{true};            ///< Rotated files are written as LZ4 frames, readable by the lz4 tool.
+};
+
+/**
+ * @class LogFileSink
+ * @brief Appends log lines to a file through one large buffer, rotating it by size or age.
+ *
+ * Lines are copied into the buffer and reach the file in one write when it fills or on Flush, rather than one write
+ * and flush per line. Syncing to disk, compressing rotated files and deleting old ones happen on a background thread,
+ * so none of them stall the thread that logs. Rotated files are renamed to the log's name with the time of the
+ * rotation, game.20261014-153000.log for game.log, then compressed to game.20261014-153000.log.lz4.
+ *
+ * Write and Flush are safe from any thread. The sink does not log, errors are printed to stderr.
+ */
+class LogFileSink {
+public:
+    explicit LogFileSink(StringView file_path, const LogFileSettings &settings = {});
+    ~LogFileSink(); ///< Writes and syncs what is buffered and finishes compressing rotated files.
+
+    LogFileSink(const LogFileSink &) = delete;
+    LogFileSink &operator=(const LogFileSink &) = delete;
+
+    [[nodiscard]] bool IsOpen() const noexcept { return m_file >= 0; }
+
+    void SetSettings(const LogFileSettings &settings);
+
+    /**
+     * @brief Appends a line, a newline is added.
+     */
+    void Write(StringView line);
+
+    /**
+     * @brief Writes the buffered lines to the file, rotating it if it got too old. Lines then survive the
+     * process crashing, a sync is requested every LogFileSettings::sync_period for them to survive the OS crashing.
+     */
+    void Flush();
+
+private:
+    // Background work, a sync of the file as it was or a rotated file to compress and prune after
+    struct Job {
+        int sync_file{-1}; ///< Duplicated descriptor, the sink may close or rotate its own meanwhile
+        std::filesystem::path rotated_path;
+    };
+
+    void WriteBuffer();
+    void Rotate();
+    void RequestSync();
+    void PushJob(Job job);
+    void BackgroundLoop(const std::stop_token &stop_token);
+    void CompressRotatedFile(const std::filesystem::path &path) const;
+    void PruneRotatedFiles(u32 max_rotated_files) const;
+
+private:
+    std::mutex m_mutex; // Guards everything below but the jobs
+    std::filesystem::path m_file_path;
+    LogFileSettings m_settings;
+    int m_file; // Descriptor, -1 when the file could not be opened
+    String m_buffer;
+    size_t m_file_size; // Written to the file, not counting the buffer
+    SteadyClock::time_point m_opened;
+    SteadyClock::time_point m_last_sync;
+    std::chrono::time_point<SystemClock, Seconds> m_last_rotation; // Names the rotated file, never goes back
+    bool m_unsynced; // Written since the last sync request
+
+    std::mutex m_jobs_mutex;
+    std::condition_variable_any m_jobs_condition;
+    std::deque<Job> m_jobs;
+    std::jthread m_background; // Last, so it stops before the state above is destroyed
+};
+
+} // namespace gouda
@@ -11,21 +11,37 @@
  * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
  * See <https://www.gnu.org/licenses/> for more information.
  */
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
 #include <chrono>
+#include <condition_variable>
+#include <cstring>
 #include <format>
 #include <fstream>
 #include <functional>
 #include <iostream>
+#include <iterator>
+#include <memory>
 #include <mutex>
+#include <shared_mutex>
 #include <source_location>
 #include <string>
 #include <string_view>
 #include <syncstream>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
 
+#include "containers/mpsc_queue.hpp"
 #include "containers/small_vector.hpp"
 #include "core/types.hpp"
 #include "debug/assert.hpp"
+#include "debug/log_file_sink.hpp"
 #include "debug/stacktrace.hpp"
+#include "utils/hash.hpp"
+#include "utils/thread.hpp"
 
 // TODO: REMOVE THIS!!
 #define APP_LOG_LEVEL_TRACE 1
@@ -41,43 +57,172 @@ namespace gouda {
 
 enum class LogLevel : u8 { Trace, Debug, Info, Warning, Error, Fatal };
 
+inline constexpr size_t LOG_FILTER_SLOTS{256};
+
+using LogFilterTable = std::array<std::atomic<u8>, LOG_FILTER_SLOTS>;
+
+/**
+ * @brief Slot of a tag in a logger's filter table, the macros hash their literal tags at compile time.
+ */
+[[nodiscard]] constexpr size_t log_tag_slot(StringView tag) noexcept
+{
+    return static_cast<size_t>(utils::fnv1a(tag) % LOG_FILTER_SLOTS);
+}
+
+/**
+ * @class Logger
+ * @brief Formats log lines and writes them to the console, the log file and any added sinks.
+ *
+ * By default every call formats and writes its line on the calling thread and flushes it. In async mode a call only
+ * formats its message into a compact record and pushes it to a lock free queue, a background thread adds the
+ * timestamp and prefixes and writes the records in batches. Output is then flushed when an error or fatal line was
+ * written, on Flush, or every ASYNC_FLUSH_PERIOD, instead of per line. Trace lines go further, when their arguments
+ * are plain values they are copied into the record as raw bytes next to the format string literal and nothing is
+ * formatted until the writer gets them.
+ *
+ * The log file is a LogFileSink, which holds lines in one large buffer until they are flushed and leaves syncing,
+ * rotation and compression of old logs to its own thread, see SetFileSettings.
+ *
+ * Levels can be set per tag at runtime. The log macros test a call against the filter table with one relaxed load
+ * before evaluating any argument. Each slot holds the lowest level any tag hashing to it may log at, so disabled
+ * calls stop there, and the rare call let through by another tag sharing its slot is settled by an exact lookup
+ * before formatting.
+ */
 class Logger {
 private:
     using Sink = std::function<void(StringView)>;
 
 protected:
-    explicit Logger(StringView file_path = "")
-        : m_file_path(file_path),
+    static constexpr size_t ASYNC_QUEUE_CAPACITY{1024};
+    static constexpr Milliseconds ASYNC_WRITE_PERIOD{10};  // How long records may wait in the queue
+    static constexpr Milliseconds ASYNC_FLUSH_PERIOD{500}; // How long written lines may wait in the stream buffers
+
+    struct LogRecord;
+    using DeferredFormat = void (*)(String &message, StringView format_str, const LogRecord &record);
+
+    /**
+     * @brief A log call as the async writer receives it, everything but the message is formatted by the writer.
+     *
+     * Deferred records carry their arguments' bytes in the message buffer instead of text, along with the function
+     * that formats them.
+     */
+    struct LogRecord {
+        SystemClock::time_point time;
+        std::source_location location;
+        StringView prefix;       // A literal of the derived logger
+        StringView format_str;   // A literal of the call, only set for deferred records
+        DeferredFormat p_format; // Null when the message is already formatted
+        char *p_long_message;    // Heap copy of messages that do not fit inline, freed by the writer
+        u32 message_size;
+        u8 tag_size; // Longer tags are cut
+        LogLevel level;
+        std::array<char, 22> tag;
+        std::array<char, 160> message;
+    };
+
+    // Values can be copied as bytes and formatted later, pointers and views would dangle by then
+    template <typename T>
+    static constexpr bool IS_DEFERRABLE_ARGUMENT{std::is_trivially_copyable_v<T> && !std::is_pointer_v<T> &&
+                                                 !std::is_convertible_v<T, StringView>};
+
+    template <typename... Args>
+    static constexpr bool IS_DEFERRABLE{(IS_DEFERRABLE_ARGUMENT<Args> && ...) &&
+                                        (sizeof(Args) + ... + 0) <= sizeof(LogRecord::message)};
+
+    using RecordQueue = MPSCQueue<LogRecord, ASYNC_QUEUE_CAPACITY>;
+
+    explicit Logger(LogFilterTable &filter_table, StringView file_path = "")
+        : m_filter_table{filter_table},
+          m_file_path(file_path),
           m_min_level{LogLevel::Trace},
           m_log_to_file(!file_path.empty()),
-          m_buffered{false}
+          m_buffered{false},
+          m_has_tag_levels{false},
+          p_records{nullptr},
+          m_records_pushed{0},
+          m_records_flushed{0},
+          m_flush_target{0},
+          m_async{false},
+          m_wake_requested{false}
     {
         if (m_log_to_file) {
-            m_file_stream.open(m_file_path, std::ios::out | std::ios::app);
-            if (!m_file_stream) {
-                std::print(std::cerr, "[Logger] Failed to open log file: {}\n", m_file_path);
+            p_file_sink = std::make_unique<LogFileSink>(m_file_path);
+            if (!p_file_sink->IsOpen()) {
+                p_file_sink.reset();
                 m_log_to_file = false;
             }
             else {
-                m_sinks.push_back(
-                    [this](StringView msg) { std::osyncstream(m_file_stream) << msg << std::endl; });
+                m_sinks.push_back([this](StringView msg) { p_file_sink->Write(msg); });
             }
         }
-        m_sinks.push_back([](StringView msg) { std::osyncstream(std::cout) << msg << std::endl; });
+        m_sinks.push_back([](StringView msg) { std::osyncstream(std::cout) << msg << '\n'; });
     }
 
     ~Logger()
     {
-        if (m_file_stream.is_open()) {
-            m_file_stream.close();
+        SetAsync(false); // Writes what is still queued
+        p_file_sink.reset();
+    }
+
+    // The date and time up to the second are formatted once a second per thread, the milliseconds by hand
+    static void AppendTimestamp(String &line, const SystemClock::time_point time)
+    {
+        struct TimestampCache {
+            SystemClock::time_point second{SystemClock::time_point::min()};
+            std::array<char, 19> text; // YYYY-mm-dd HH:MM:SS
+        };
+        thread_local TimestampCache t_cache;
+
+        const auto second{std::chrono::floor<Seconds>(time)};
+        if (second != t_cache.second) {
+            std::format_to(t_cache.text.data(), "{:%Y-%m-%d %H:%M:%S}", second);
+            t_cache.second = second;
         }
+
+        const auto milliseconds{std::chrono::duration_cast<Milliseconds>(time - second).count()};
+        const std::array<char, 5> fraction{'.',
+                                           static_cast<char>('0' + milliseconds / 100),
+                                           static_cast<char>('0' + milliseconds / 10 % 10),
+                                           static_cast<char>('0' + milliseconds % 10),
+                                           ' '};
+        line.append(t_cache.text.data(), t_cache.text.size());
+        line.append(fraction.data(), fraction.size());
     }
 
-    static std::string GetTimestamp()
+    // Everything before the message, appended without formatting
+    static void AppendLinePrefix(String &line, const SystemClock::time_point time, const LogLevel level,
+                                 StringView prefix, StringView tag)
     {
-        const auto now = SystemClock::now();
-        auto local_time = std::chrono::floor<Milliseconds>(now);
-        return std::format("{:%Y-%m-%d %H:%M:%S}", local_time);
+        static constexpr std::array<StringView, 6> level_strings{"[TRACE] ",   "[DEBUG] ", "[INFO] ",
+                                                                 "[WARNING] ", "[ERROR] ", "[FATAL] "};
+        // Set and Ensure level is within bounds
+        const u8 level_index{static_cast<u8>(level)};
+        ASSERT(level_index < static_cast<u8>(level_strings.size()), "Log level is out of bounds.");
+
+        AppendTimestamp(line, time);
+        line.append(prefix);
+        if (!tag.empty()) {
+            line.append(" [");
+            line.append(tag);
+            line.append("] ");
+        }
+        line.append(level_strings[level_index]);
+    }
+
+    static void AppendLineLocation(String &line, const LogLevel level, const std::source_location &loc)
+    {
+        if (level != LogLevel::Info && level != LogLevel::Debug) {
+            std::format_to(std::back_inserter(line), " ({}:{}:{})", loc.file_name(), loc.line(), loc.column());
+        }
+    }
+
+    // Common log format, optionally including source location
+    static void FormatLine(String &line, const SystemClock::time_point time, const LogLevel level, StringView prefix,
+                           StringView tag, StringView message, const std::source_location &loc)
+    {
+        AppendLinePrefix(line, time, level, prefix, tag);
+        line.append(message);
+        AppendLineLocation(line, level, loc);
     }
 
     // Variadic template for formatted Logging
@@ -85,8 +230,8 @@ protected:
     void Log(LogLevel level, StringView prefix, StringView format_str, StringView tag = "",
              const std::source_location &loc = std::source_location::current(), Args &&...args)
     {
-        // Create a tuple to store the arguments by value or move
-        auto args_tuple = std::tuple<std::decay_t<Args>...>(std::forward<Args>(args)...);
+        // References, the arguments are formatted before this returns so nothing needs copying
+        std::tuple<std::remove_reference_t<Args> &...> args_tuple{args...};
         Log_impl(level, prefix, format_str, tag, loc, args_tuple, std::index_sequence_for<Args...>{});
     }
 
@@ -95,30 +240,37 @@ protected:
     void Log_impl(LogLevel level, StringView prefix, StringView format_str, StringView tag,
                   const std::source_location &loc, std::tuple<TupleArgs...> &args_tuple, std::index_sequence<I...>)
     {
-        if (static_cast<u8>(level) < static_cast<u8>(m_min_level)) {
+        if (!IsLevelEnabled(level, tag)) {
             return;
         }
 
-        String timestamp{GetTimestamp()};
-        static constexpr std::array<StringView, 6> level_strings{"[TRACE] ", "[DEBUG] ", "[INFO] ", "[WARNING] ", "[ERROR] ",
-                                                                       "[FATAL] "};
-        // Set and Ensure level is within bounds
-        const u8 level_index{static_cast<u8>(level)};
-        ASSERT(level_index < static_cast<u8>(level_strings.size()), "Log level is out of bounds.");
+        if (m_async.load(std::memory_order_acquire)) {
+            // Reused per thread, so only the first long message on a thread allocates
+            thread_local String message_buffer;
+            message_buffer.clear();
+            std::vformat_to(std::back_inserter(message_buffer), format_str,
+                            std::make_format_args(std::get<I>(args_tuple)...));
+            PushRecord(level, prefix, tag, loc, message_buffer);
 
-        String full_prefix{tag.empty() ? String(prefix) : std::format("{} [{}] ", prefix, tag)};
-        String message{std::vformat(format_str, std::make_format_args(std::get<I>(args_tuple)...))};
+            if (level == LogLevel::Fatal) {
+                Flush(); // The line goes out before the stack trace
+                internal::print_stacktrace();
+            }
+            return;
+        }
 
-        // Common Log format, optionally including source location
-        String Log_message{
-            level == LogLevel::Info || level == LogLevel::Debug
-                ? std::format("{} {}{}{}", timestamp, full_prefix, level_strings[level_index], message)
-                : std::format("{} {}{}{} ({}:{}:{})", timestamp, full_prefix, level_strings[level_index], message,
-                              loc.file_name(), loc.line(), loc.column())};
+        // The whole line is formatted into one buffer reused per thread, so a line only allocates while the buffer
+        // grows to the longest line the thread wrote
+        thread_local String line_buffer;
+        line_buffer.clear();
+        AppendLinePrefix(line_buffer, SystemClock::now(), level, prefix, tag);
+        std::vformat_to(std::back_inserter(line_buffer), format_str, std::make_format_args(std::get<I>(args_tuple)...));
+        AppendLineLocation(line_buffer, level, loc);
+        const StringView Log_message{line_buffer};
 
         if (m_buffered) {
             std::lock_guard lock(m_buffer_mutex);
-            m_buffer.push_back({level, Log_message});
+            m_buffer.push_back({level, String{Log_message}});
         }
         else {
             //if (level == LogLevel::Trace) { // Trace does not need to set or reset console colour
@@ -134,6 +286,7 @@ protected:
                 sink(Log_message);
             }
             ResetConsoleColor();
+            FlushStreams();
         }
 
         if (level == LogLevel::Fatal) {
@@ -141,6 +294,170 @@ protected:
         }
     }
 
+    // Trace lines in async mode skip formatting on the calling thread when every argument is a plain value
+    template <size_t N, typename... Args>
+    void LogTrace(StringView prefix, const char (&format_str)[N], StringView tag, const std::source_location &loc,
+                  Args &&...args)
+    {
+        if constexpr (IS_DEFERRABLE<std::decay_t<Args>...>) {
+            if (m_async.load(std::memory_order_acquire) && IsLevelEnabled(LogLevel::Trace, tag)) {
+                LogRecord record;
+                FillRecord(record, LogLevel::Trace, prefix, tag, loc);
+                record.format_str = StringView{format_str, N - 1};
+                record.p_format = &FormatDeferred<std::decay_t<Args>...>;
+
+                size_t offset{0};
+                ((std::memcpy(record.message.data() + offset, &args, sizeof(args)), offset += sizeof(args)), ...);
+                record.message_size = static_cast<u32>(offset);
+                EnqueueRecord(record);
+                return;
+            }
+        }
+        Log(LogLevel::Trace, prefix, StringView{format_str, N - 1}, tag, loc, std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    static void FormatDeferred(String &message, StringView format_str, const LogRecord &record)
+    {
+        FormatDeferredImpl<Args...>(message, format_str, record, std::index_sequence_for<Args...>{});
+    }
+
+    template <typename... Args, std::size_t... I>
+    static void FormatDeferredImpl(String &message, StringView format_str, const LogRecord &record,
+                                   std::index_sequence<I...>)
+    {
+        // Same layout LogTrace copied the arguments in, back to back without padding
+        static constexpr std::array<size_t, sizeof...(Args)> offsets{[] {
+            std::array<size_t, sizeof...(Args)> result{};
+            size_t offset{0};
+            size_t index{0};
+            ((result[index++] = offset, offset += sizeof(Args)), ...);
+            return result;
+        }()};
+
+        std::tuple<Args...> values{LoadArgument<Args>(record.message.data() + offsets[I])...};
+        std::vformat_to(std::back_inserter(message), format_str, std::make_format_args(std::get<I>(values)...));
+    }
+
+    template <typename T>
+    static T LoadArgument(const char *bytes)
+    {
+        std::array<std::byte, sizeof(T)> raw;
+        std::memcpy(raw.data(), bytes, sizeof(T));
+        return std::bit_cast<T>(raw);
+    }
+
+    static void FillRecord(LogRecord &record, const LogLevel level, StringView prefix, StringView tag,
+                           const std::source_location &loc)
+    {
+        record.time = SystemClock::now();
+        record.location = loc;
+        record.prefix = prefix;
+        record.p_format = nullptr;
+        record.p_long_message = nullptr;
+        record.level = level;
+        record.tag_size = static_cast<u8>(std::min(tag.size(), record.tag.size()));
+        std::copy_n(tag.data(), record.tag_size, record.tag.data());
+    }
+
+    void PushRecord(const LogLevel level, StringView prefix, StringView tag, const std::source_location &loc,
+                    StringView message)
+    {
+        LogRecord record;
+        FillRecord(record, level, prefix, tag, loc);
+        record.message_size = static_cast<u32>(message.size());
+        record.p_long_message = message.size() > record.message.size() ? new char[message.size()] : nullptr;
+        std::copy_n(message.data(), message.size(),
+                    record.p_long_message != nullptr ? record.p_long_message : record.message.data());
+        EnqueueRecord(record);
+    }
+
+    void EnqueueRecord(const LogRecord &record)
+    {
+        // A full queue means the writer fell behind, waiting for room beats losing lines
+        while (!p_records->TryPush(record)) {
+            WakeWriter();
+            std::this_thread::yield();
+        }
+        m_records_pushed.fetch_add(1, std::memory_order_release);
+
+        if (record.level >= LogLevel::Error) {
+            WakeWriter(); // Written and flushed now rather than at the next period
+        }
+    }
+
+    void WakeWriter()
+    {
+        // Notified without the lock to stay lock free, a wake lost to the race costs at most one write period
+        m_wake_requested.store(true, std::memory_order_release);
+        m_wake_condition.notify_one();
+    }
+
+    void AsyncWriteLoop(const std::stop_token &stop_token)
+    {
+        String line;
+        String deferred_message;
+        LogRecord record;
+        auto last_flush{SteadyClock::now()};
+        u64 unflushed{0};
+
+        while (true) {
+            // Read before draining, so every record pushed before the stop is still written
+            const bool is_stopping{stop_token.stop_requested()};
+            bool is_urgent{false};
+            while (p_records->TryPop(record)) {
+                StringView message{record.p_long_message != nullptr ? record.p_long_message : record.message.data(),
+                                   record.message_size};
+                if (record.p_format != nullptr) {
+                    deferred_message.clear();
+                    record.p_format(deferred_message, record.format_str, record);
+                    message = deferred_message;
+                }
+                line.clear();
+                FormatLine(line, record.time, record.level, record.prefix, {record.tag.data(), record.tag_size},
+                           message, record.location);
+                delete[] record.p_long_message;
+
+                SetConsoleColor(record.level);
+                for (const auto &sink : m_sinks) {
+                    sink(line);
+                }
+                ResetConsoleColor();
+
+                is_urgent = is_urgent || record.level >= LogLevel::Error;
+                ++unflushed;
+            }
+
+            // Lines only count as written once flushed, which is what Flush waits for
+            const auto now{SteadyClock::now()};
+            const u64 flushed{m_records_flushed.load(std::memory_order_relaxed)};
+            const bool is_requested{m_flush_target.load(std::memory_order_acquire) > flushed};
+            if (unflushed > 0 && (is_urgent || is_requested || is_stopping || now - last_flush >= ASYNC_FLUSH_PERIOD)) {
+                FlushStreams();
+                last_flush = now;
+                m_records_flushed.store(flushed + unflushed, std::memory_order_release);
+                m_records_flushed.notify_all();
+                unflushed = 0;
+            }
+
+            if (is_stopping) {
+                break;
+            }
+
+            std::unique_lock lock{m_wake_mutex};
+            m_wake_condition.wait_for(lock, stop_token, ASYNC_WRITE_PERIOD,
+                                      [this] { return m_wake_requested.exchange(false, std::memory_order_acquire); });
+        }
+    }
+
+    void FlushStreams()
+    {
+        if (p_file_sink) {
+            p_file_sink->Flush();
+        }
+        std::osyncstream(std::cout) << std::flush;
+    }
+
     void SetConsoleColor(LogLevel level)
     {
 
@@ -210,7 +527,25 @@ protected:
 #endif
     }
 
-    std::ofstream m_file_stream;
+    // Rebuilds every slot from the default level and the tag levels, called with the filter mutex held
+    void UpdateFilterTable()
+    {
+        std::array<u8, LOG_FILTER_SLOTS> levels;
+        levels.fill(static_cast<u8>(m_min_level));
+        for (const auto &[tag, level] : m_tag_levels) {
+            u8 &slot_level{levels[log_tag_slot(tag)]};
+            slot_level = std::min(slot_level, static_cast<u8>(level));
+        }
+        for (size_t i = 0; i < LOG_FILTER_SLOTS; ++i) {
+            m_filter_table[i].store(levels[i], std::memory_order_relaxed);
+        }
+        m_has_tag_levels.store(!m_tag_levels.empty(), std::memory_order_release);
+    }
+
+    LogFilterTable &m_filter_table; // Owned by the derived logger, so the macros reach it without the instance
+    std::unordered_map<String, LogLevel> m_tag_levels;
+    mutable std::shared_mutex m_filter_mutex;
+    std::unique_ptr<LogFileSink> p_file_sink; // Null unless logging to a file
     String m_file_path;
     SmallVector<std::pair<LogLevel, String>, 1> m_buffer;
     SmallVector<Sink, 2, GrowthPolicyAddOne> m_sinks;
@@ -218,9 +553,64 @@ protected:
     LogLevel m_min_level;
     bool m_log_to_file;
     bool m_buffered;
+    std::atomic<bool> m_has_tag_levels;
+
+    std::unique_ptr<RecordQueue> p_records; // Created when async mode is first enabled and kept, callers may hold it
+    std::atomic<u64> m_records_pushed;
+    std::atomic<u64> m_records_flushed; // Only written by the writer
+    std::atomic<u64> m_flush_target;    // Highest record count a Flush waits for
+    std::atomic<bool> m_async;
+    std::atomic<bool> m_wake_requested;
+    std::mutex m_wake_mutex;
+    std::condition_variable_any m_wake_condition;
+    std::jthread m_async_writer; // Last, so it stops before the state above is destroyed
 
 public:
-    void SetLogLevel(const LogLevel level) { m_min_level = level; }
+    /**
+     * @brief Sets the level of untagged lines and of tags without a level of their own.
+     */
+    void SetLogLevel(const LogLevel level)
+    {
+        std::unique_lock lock{m_filter_mutex};
+        m_min_level = level;
+        UpdateFilterTable();
+    }
+
+    /**
+     * @brief Sets the lowest level lines with a tag are written at, such as Trace for "vk.upload" alone.
+     */
+    void SetTagLogLevel(StringView tag, const LogLevel level)
+    {
+        std::unique_lock lock{m_filter_mutex};
+        m_tag_levels.insert_or_assign(String{tag}, level);
+        UpdateFilterTable();
+    }
+
+    /**
+     * @brief Returns a tag to the default level.
+     */
+    void ClearTagLogLevel(StringView tag)
+    {
+        std::unique_lock lock{m_filter_mutex};
+        m_tag_levels.erase(String{tag});
+        UpdateFilterTable();
+    }
+
+    /**
+     * @brief Exact check of a line against the default and tag levels, the macros only get here past the table.
+     */
+    [[nodiscard]] bool IsLevelEnabled(const LogLevel level, StringView tag) const
+    {
+        if (!m_has_tag_levels.load(std::memory_order_acquire)) {
+            return static_cast<u8>(level) >= m_filter_table[log_tag_slot(tag)].load(std::memory_order_relaxed);
+        }
+
+        std::shared_lock lock{m_filter_mutex};
+        const auto it{tag.empty() ? m_tag_levels.end() : m_tag_levels.find(String{tag})};
+        const LogLevel min_level{it == m_tag_levels.end() ? m_min_level : it->second};
+        return static_cast<u8>(level) >= static_cast<u8>(min_level);
+    }
+
     void SetBuffered(const bool enabled)
     {
         std::lock_guard lock(m_buffer_mutex);
@@ -230,8 +620,47 @@ public:
         }
     }
 
+    /**
+     * @brief Moves logging off the calling threads onto a background writer, or back. Switch while other threads
+     * are not logging, such as at startup and shutdown, disabling writes and flushes everything still queued.
+     */
+    void SetAsync(const bool enabled)
+    {
+        if (enabled == m_async.load(std::memory_order_acquire)) {
+            return;
+        }
+
+        if (enabled) {
+            if (!p_records) {
+                p_records = std::make_unique<RecordQueue>();
+            }
+            m_async_writer = MakeThread("Log writer", ThreadPriority::Logging,
+                                        [this](const std::stop_token &stop_token) { AsyncWriteLoop(stop_token); });
+            m_async.store(true, std::memory_order_release);
+        }
+        else {
+            m_async.store(false, std::memory_order_release);
+            m_async_writer.request_stop();
+            m_async_writer.join();
+        }
+    }
+
     void Flush()
     {
+        if (m_async.load(std::memory_order_acquire)) {
+            // Waits until the writer flushed every record pushed so far
+            const u64 target{m_records_pushed.load(std::memory_order_acquire)};
+            u64 current_target{m_flush_target.load(std::memory_order_relaxed)};
+            while (current_target < target &&
+                   !m_flush_target.compare_exchange_weak(current_target, target, std::memory_order_release)) {
+            }
+            WakeWriter();
+            for (u64 flushed{m_records_flushed.load(std::memory_order_acquire)}; flushed < target;
+                 flushed = m_records_flushed.load(std::memory_order_acquire)) {
+                m_records_flushed.wait(flushed, std::memory_order_acquire);
+            }
+        }
+
         std::lock_guard lock(m_buffer_mutex);
         for (const auto &[level, msg] : m_buffer) {
             SetConsoleColor(level);
@@ -245,6 +674,16 @@ public:
         m_buffer.clear();
     }
 
+    /**
+     * @brief Sets how the log file is buffered, synced and rotated, see LogFileSink. Ignored without a log file.
+     */
+    void SetFileSettings(const LogFileSettings &settings)
+    {
+        if (p_file_sink) {
+            p_file_sink->SetSettings(settings);
+        }
+    }
+
     void AddSink(const Sink& sink)
     {
         std::lock_guard lock(m_buffer_mutex);
@@ -271,6 +710,15 @@ public:
         return *instance;
     }
 
+    /**
+     * @brief Whether a line may be written, the test the macros make before evaluating their arguments.
+     * @param tag_slot From log_tag_slot.
+     */
+    [[nodiscard]] static bool IsEnabled(const LogLevel level, const size_t tag_slot) noexcept
+    {
+        return static_cast<u8>(level) >= s_filter_table[tag_slot].load(std::memory_order_relaxed);
+    }
+
     // Variadic template for formatted Logging
     template <typename... Args>
     void Log(LogLevel level, StringView format_str, StringView tag = "",
@@ -286,9 +734,17 @@ public:
         Logger::Log(level, "[ENGINE]", message, tag, loc);
     }
 
+    // Trace lines, the format has to be a string literal as deferred records keep it by pointer
+    template <size_t N, typename... Args>
+    void LogTrace(const char (&format_str)[N], StringView tag, const std::source_location &loc, Args &&...args)
+    {
+        Logger::LogTrace("[ENGINE]", format_str, tag, loc, std::forward<Args>(args)...);
+    }
+
 private:
-    explicit EngineLogger(const String &file_path) : Logger(file_path) {}
+    explicit EngineLogger(const String &file_path) : Logger(s_filter_table, file_path) {}
     inline static EngineLogger *instance{nullptr};
+    inline static LogFilterTable s_filter_table{}; // Zeroed, everything from Trace up is written until levels are set
 };
 
 class AppLogger : public Logger {
@@ -309,6 +765,15 @@ public:
         return *instance;
     }
 
+    /**
+     * @brief Whether a line may be written, the test the macros make before evaluating their arguments.
+     * @param tag_slot From log_tag_slot.
+     */
+    [[nodiscard]] static bool IsEnabled(const LogLevel level, const size_t tag_slot) noexcept
+    {
+        return static_cast<u8>(level) >= s_filter_table[tag_slot].load(std::memory_order_relaxed);
+    }
+
     // Variadic template for formatted Logging
     template <typename... Args>
     void Log(LogLevel level, StringView format_str, StringView tag = "",
@@ -324,25 +789,63 @@ public:
         Logger::Log(level, "[APP]", message, tag, loc);
     }
 
+    // Trace lines, the format has to be a string literal as deferred records keep it by pointer
+    template <size_t N, typename... Args>
+    void LogTrace(const char (&format_str)[N], StringView tag, const std::source_location &loc, Args &&...args)
+    {
+        Logger::LogTrace("[APP]", format_str, tag, loc, std::forward<Args>(args)...);
+    }
+
 private:
-    explicit AppLogger(const String &file_path) : Logger(file_path) {}
+    explicit AppLogger(const String &file_path) : Logger(s_filter_table, file_path) {}
     inline static AppLogger *instance{nullptr};
+    inline static LogFilterTable s_filter_table{}; // Zeroed, everything from Trace up is written until levels are set
 };
 
 } // namespace gouda
 
 // Macros supporting both plain and formatted calls
 #ifdef ENABLE_ENGINE_LOGGING
-#define ENGINE_LOG_PLAIN(level, msg) gouda::EngineLogger::GetInstance().Log(level, msg)
-#define ENGINE_LOG_TAG_PLAIN(level, tag, msg) gouda::EngineLogger::GetInstance().Log(level, msg, tag)
+#define ENGINE_LOG_ENABLED(level, tag)                                                                                 \
+    gouda::EngineLogger::IsEnabled(level, std::integral_constant<size_t, gouda::log_tag_slot(tag)>::value)
+#define ENGINE_LOG_PLAIN(level, msg)                                                                                   \
+    do {                                                                                                               \
+        if (ENGINE_LOG_ENABLED(level, "")) {                                                                           \
+            gouda::EngineLogger::GetInstance().Log(level, msg);                                                        \
+        }                                                                                                              \
+    } while (0)
+#define ENGINE_LOG_TAG_PLAIN(level, tag, msg)                                                                          \
+    do {                                                                                                               \
+        if (ENGINE_LOG_ENABLED(level, tag)) {                                                                          \
+            gouda::EngineLogger::GetInstance().Log(level, msg, tag);                                                   \
+        }                                                                                                              \
+    } while (0)
 #define ENGINE_LOG(level, fmt, ...)                                                                                    \
-    gouda::EngineLogger::GetInstance().Log(level, fmt, "", std::source_location::current(), ##__VA_ARGS__)
+    do {                                                                                                               \
+        if (ENGINE_LOG_ENABLED(level, "")) {                                                                           \
+            gouda::EngineLogger::GetInstance().Log(level, fmt, "", std::source_location::current(), ##__VA_ARGS__);    \
+        }                                                                                                              \
+    } while (0)
 #define ENGINE_LOG_TAG(level, tag, fmt, ...)                                                                           \
-    gouda::EngineLogger::GetInstance().Log(level, fmt, tag, std::source_location::current(), ##__VA_ARGS__)
+    do {                                                                                                               \
+        if (ENGINE_LOG_ENABLED(level, tag)) {                                                                          \
+            gouda::EngineLogger::GetInstance().Log(level, fmt, tag, std::source_location::current(), ##__VA_ARGS__);   \
+        }                                                                                                              \
+    } while (0)
 
 #if defined(ENGINE_LOG_LEVEL_TRACE)
-#define ENGINE_LOG_TRACE(fmt, ...) ENGINE_LOG(gouda::LogLevel::Trace, fmt, ##__VA_ARGS__)
-#define ENGINE_LOG_TRACE_TAG(tag, fmt, ...) ENGINE_LOG_TAG(gouda::LogLevel::Trace, tag, fmt, ##__VA_ARGS__)
+#define ENGINE_LOG_TRACE(fmt, ...)                                                                                     \
+    do {                                                                                                               \
+        if (ENGINE_LOG_ENABLED(gouda::LogLevel::Trace, "")) {                                                          \
+            gouda::EngineLogger::GetInstance().LogTrace(fmt, "", std::source_location::current(), ##__VA_ARGS__);      \
+        }                                                                                                              \
+    } while (0)
+#define ENGINE_LOG_TRACE_TAG(tag, fmt, ...)                                                                            \
+    do {                                                                                                               \
+        if (ENGINE_LOG_ENABLED(gouda::LogLevel::Trace, tag)) {                                                         \
+            gouda::EngineLogger::GetInstance().LogTrace(fmt, tag, std::source_location::current(), ##__VA_ARGS__);     \
+        }                                                                                                              \
+    } while (0)
 #else
 #define ENGINE_LOG_TRACE(fmt, ...)                                                                                     \
 do {                                                                                                               \
@@ -462,16 +965,46 @@ do {
 #endif
 
 #ifdef ENABLE_APP_LOGGING
-#define APP_LOG_PLAIN(level, msg) gouda::AppLogger::GetInstance().Log(level, msg)
-#define APP_LOG_TAG_PLAIN(level, tag, msg) gouda::AppLogger::GetInstance().Log(level, msg, tag)
+#define APP_LOG_ENABLED(level, tag)                                                                                    \
+    gouda::AppLogger::IsEnabled(level, std::integral_constant<size_t, gouda::log_tag_slot(tag)>::value)
+#define APP_LOG_PLAIN(level, msg)                                                                                      \
+    do {                                                                                                               \
+        if (APP_LOG_ENABLED(level, "")) {                                                                              \
+            gouda::AppLogger::GetInstance().Log(level, msg);                                                           \
+        }                                                                                                              \
+    } while (0)
+#define APP_LOG_TAG_PLAIN(level, tag, msg)                                                                             \
+    do {                                                                                                               \
+        if (APP_LOG_ENABLED(level, tag)) {                                                                             \
+            gouda::AppLogger::GetInstance().Log(level, msg, tag);                                                      \
+        }                                                                                                              \
+    } while (0)
 #define APP_LOG(level, fmt, ...)                                                                                       \
-    gouda::AppLogger::GetInstance().Log(level, fmt, "", std::source_location::current(), ##__VA_ARGS__)
+    do {                                                                                                               \
+        if (APP_LOG_ENABLED(level, "")) {                                                                              \
+            gouda::AppLogger::GetInstance().Log(level, fmt, "", std::source_location::current(), ##__VA_ARGS__);       \
+        }                                                                                                              \
+    } while (0)
 #define APP_LOG_TAG(level, tag, fmt, ...)                                                                              \
-    gouda::AppLogger::GetInstance().Log(level, fmt, tag, std::source_location::current(), ##__VA_ARGS__)
+    do {                                                                                                               \
+        if (APP_LOG_ENABLED(level, tag)) {                                                                             \
+            gouda::AppLogger::GetInstance().Log(level, fmt, tag, std::source_location::current(), ##__VA_ARGS__);      \
+        }                                                                                                              \
+    } while (0)
 
 #if defined(APP_LOG_LEVEL_TRACE)
-#define APP_LOG_TRACE(fmt, ...) APP_LOG(gouda::LogLevel::Trace, fmt, ##__VA_ARGS__)
-#define APP_LOG_TRACE_TAG(tag, fmt, ...) APP_LOG_TAG(gouda::LogLevel::Trace, tag, fmt, ##__VA_ARGS__)
+#define APP_LOG_TRACE(fmt, ...)                                                                                        \
+    do {                                                                                                               \
+        if (APP_LOG_ENABLED(gouda::LogLevel::Trace, "")) {                                                             \
+            gouda::AppLogger::GetInstance().LogTrace(fmt, "", std::source_location::current(), ##__VA_ARGS__);         \
+        }                                                                                                              \
+    } while (0)
+#define APP_LOG_TRACE_TAG(tag, fmt, ...)                                                                               \
+    do {                                                                                                               \
+        if (APP_LOG_ENABLED(gouda::LogLevel::Trace, tag)) {                                                            \
+            gouda::AppLogger::GetInstance().LogTrace(fmt, tag, std::source_location::current(), ##__VA_ARGS__);        \
+        }                                                                                                              \
+    } while (0)
 #else
 #define APP_LOG_TRACE(fmt, ...)                                                                                        \
 do {                                                                                                               \
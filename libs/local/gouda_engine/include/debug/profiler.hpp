@@ -21,14 +21,23 @@
  * You should have received a copy of the GNU Affero General Public License
  * along with this program. If not, see <https://www.gnu.org/licenses/>.
  */
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <fstream>
+#include <memory>
 #include <mutex>
 #include <source_location>
 #include <string_view>
 #include <thread>
+#include <vector>
 
+#include "containers/flat_hash_map.hpp"
+#include "containers/small_vector.hpp"
+#include "containers/spsc_queue.hpp"
 #include "core/types.hpp"
+#include "debug/trace_file.hpp"
 
 namespace gouda::internal::profiler {
 
@@ -37,10 +46,90 @@ namespace gouda::internal::profiler {
  * @brief Holds information about a single profiling event.
  */
 struct ProfileResult {
-    std::string_view name;           // Name of the profiled function or scope
+    std::string_view name;           // Name of the profiled function or scope, a literal
     FloatingPointMicroseconds start; // Start time in microseconds
     Microseconds elapsed_time;       // Duration of the event
-    std::thread::id thread_id;       // ID of the thread executing the event
+};
+
+/**
+ * @struct ProfileCounter
+ * @brief One sample of a value plotted over time, such as the bytes a subsystem holds.
+ */
+struct ProfileCounter {
+    std::string_view name; // Name of the counter's track, a literal
+    FloatingPointMicroseconds timestamp;
+    f64 value;
+};
+
+/**
+ * @struct CapturedScope
+ * @brief A scope of a captured frame, in the frame's scope tree.
+ */
+struct CapturedScope {
+    std::string_view name;
+    FloatingPointMicroseconds start; // From the start of the frame, negative for scopes begun in the frame before
+    Microseconds elapsed_time;
+    u32 thread_index; // Matches the trace thread ids of a session
+    u32 depth;        // Nesting within the thread, zero for its outermost scopes
+    u32 subtree_end;  // Index one past the scope's last descendant
+};
+
+/**
+ * @struct CapturedFrame
+ * @brief Every scope that ended during one frame, grouped by thread and in pre-order within each thread.
+ */
+struct CapturedFrame {
+    u64 frame_number{0};
+    FloatingPointMicroseconds duration{0.0};
+    Vector<CapturedScope> scopes;
+};
+
+enum class CounterKind : u8 {
+    Count, ///< Summed over each frame and reset when sampled, such as bytes uploaded
+    Gauge, ///< Keeps the last value set, such as voices playing
+};
+
+/**
+ * @class FrameCounter
+ * @brief A named value any thread adds to or sets with one relaxed atomic operation, sampled once per frame.
+ *
+ * BeginFrame samples every counter, writes the samples as counter tracks while a session is open and keeps them for
+ * GetFrameCounterSample, so a frame that got slower can be matched with what it did more of. Counters are made once
+ * per name with Profiler::GetFrameCounter and live as long as the profiler, the ENGINE_PROFILE_COUNT and
+ * ENGINE_PROFILE_GAUGE macros keep theirs in a function static.
+ */
+class FrameCounter {
+public:
+    FrameCounter(const std::string_view name, const CounterKind kind)
+        : m_name{name}, m_value{0}, m_last_sample{0}, m_kind{kind}
+    {
+    }
+
+    void Add(const s64 amount) noexcept { m_value.fetch_add(amount, std::memory_order_relaxed); }
+    void Set(const s64 value) noexcept { m_value.store(value, std::memory_order_relaxed); }
+
+    [[nodiscard]] std::string_view GetName() const noexcept { return m_name; }
+    [[nodiscard]] CounterKind GetKind() const noexcept { return m_kind; }
+
+    /**
+     * @return The value taken by the last BeginFrame, read on the main thread.
+     */
+    [[nodiscard]] s64 GetLastSample() const noexcept { return m_last_sample; }
+
+private:
+    friend class Profiler;
+
+    void Sample() noexcept
+    {
+        m_last_sample = m_kind == CounterKind::Count ? m_value.exchange(0, std::memory_order_relaxed)
+                                                     : m_value.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::string_view m_name; // A literal
+    std::atomic<s64> m_value;
+    s64 m_last_sample; // Main thread only
+    CounterKind m_kind;
 };
 
 /**
@@ -54,16 +143,31 @@ struct ProfilingSession {
 /**
  * @class Profiler
  * @brief Singleton class to manage profiling sessions and write results.
+ *
+ * Every thread that records an event gets its own fixed size lock free buffer, so recording never takes a lock or
+ * touches the file. While a session is open a writer thread drains all buffers every WRITE_PERIOD and writes the
+ * events to the trace file in one batch. Sessions write Chrome trace JSON, or a compact binary trace when the file
+ * has TRACE_FILE_EXTENSION, see debug/trace_file.hpp, which suits captures of minutes. Events recorded while a
+ * thread's buffer is full are dropped and counted rather than waited for, profiling must not stall the code it
+ * measures. GPU results have a buffer of their own, shown as a track named GPU.
+ *
+ * Independently of sessions, frame capture keeps the scope trees of the last FRAME_HISTORY_SIZE frames in memory for
+ * the in-engine view. Each thread then also fills a second buffer, which BeginFrame drains on the main thread. The
+ * history can be frozen to inspect a stutter, and a single frame captured to keep it past the history. Everything
+ * about frames belongs to the main thread.
  */
 class Profiler {
 public:
+    static constexpr size_t FRAME_HISTORY_SIZE{120};
+
     Profiler(const Profiler &) = delete;
     Profiler(Profiler &&) = delete;
 
     /**
      * @brief Starts a new profiling session.
      * @param name Name of the session.
-     * @param filepath Path to the output file for profiling results.
+     * @param filepath Path to the output file for profiling results, a binary trace if it ends in
+     * TRACE_FILE_EXTENSION.
      */
     void BeginSession(std::string_view name, std::string_view filepath);
 
@@ -73,11 +177,80 @@ public:
     void EndSession();
 
     /**
-     * @brief Writes a profiling result to the output file.
+     * @brief Records a profiling result in the calling thread's buffer, the writer thread writes it out later.
      * @param result The profiling result to write.
      */
     void Write(const ProfileResult &result);
 
+    /**
+     * @brief Records a result measured on the GPU, written to the trace's GPU track instead of the calling thread's.
+     * @param result The profiling result to write, with its start already on the CPU timeline.
+     */
+    void WriteGpu(const ProfileResult &result);
+
+    /**
+     * @brief Records a counter sample at the current time, shown as its own track. Main thread only.
+     * @param name Name of the counter, a literal.
+     */
+    void WriteCounter(std::string_view name, f64 value);
+
+    /**
+     * @brief Names the calling thread's track in traces, see SetCurrentThread in utils/thread.hpp.
+     */
+    void SetThreadName(std::string_view name);
+
+    /**
+     * @brief Finds or makes the frame counter of a name, safe from any thread. Keep the reference, finding takes a
+     * lock.
+     * @param name Name of the counter, a literal.
+     * @param kind Only used when the counter is made.
+     */
+    [[nodiscard]] FrameCounter &GetFrameCounter(std::string_view name, CounterKind kind);
+
+    /**
+     * @return What the counter of a name was sampled at by the last BeginFrame, 0 if there is no such counter. Main
+     * thread only.
+     */
+    [[nodiscard]] s64 GetFrameCounterSample(std::string_view name);
+
+    /**
+     * @brief Ends the current frame and starts the next, once per frame on the main thread.
+     */
+    void BeginFrame();
+
+    /**
+     * @brief Starts or stops recording scopes for the frame history, the history is cleared when stopping.
+     */
+    void SetFrameCaptureEnabled(bool enabled);
+    [[nodiscard]] bool IsFrameCaptureEnabled() const { return m_is_capturing_frames.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Stops adding frames to the history while frozen, so the frames leading up to a stutter stay.
+     */
+    void SetFramesFrozen(const bool frozen) { m_frames_frozen = frozen; }
+    [[nodiscard]] bool AreFramesFrozen() const noexcept { return m_frames_frozen; }
+
+    /**
+     * @brief Keeps the last completed frame until the next capture and writes its scope tree to the log.
+     * @return False if there is no completed frame yet.
+     */
+    bool CaptureFrame();
+
+    /**
+     * @param age Zero for the last completed frame.
+     * @return The frame, or null if the history does not reach back that far.
+     */
+    [[nodiscard]] const CapturedFrame *GetFrame(size_t age) const;
+    [[nodiscard]] size_t GetFrameCount() const noexcept { return m_frame_count; }
+    [[nodiscard]] u64 GetDroppedFrameEventCount() const
+    {
+        return m_dropped_frame_events.load(std::memory_order_relaxed);
+    }
+    [[nodiscard]] const CapturedFrame *GetCapturedFrame() const
+    {
+        return m_has_captured_frame ? &m_captured_frame : nullptr;
+    }
+
     /**
      * @brief Gets the singleton instance of the Profiler.
      * @return Reference to the Profiler instance.
@@ -89,17 +262,76 @@ public:
     }
 
 private:
+    static constexpr size_t THREAD_BUFFER_CAPACITY{4096};
+    static constexpr size_t COUNTER_BUFFER_CAPACITY{1024};
+    static constexpr Milliseconds WRITE_PERIOD{50};
+    static constexpr u32 GPU_THREAD_INDEX{TRACE_GPU_THREAD_INDEX};
+
+    struct ThreadEvents {
+        SPSCQueue<ProfileResult, THREAD_BUFFER_CAPACITY> events;       // Pushed by its thread, popped by the writer
+        SPSCQueue<ProfileResult, THREAD_BUFFER_CAPACITY> frame_events; // Popped by BeginFrame, while capturing
+        u32 thread_index;                                              // Written as the trace thread id
+        String name;          // Empty until the thread is named, guarded by m_buffers_mutex like the list
+        bool is_name_written; // To the current session's file
+    };
+
+    struct FrameEvent {
+        ProfileResult result;
+        u32 thread_index;
+    };
+
     Profiler();
     ~Profiler() { EndSession(); }
 
     void WriteHeader();
     void WriteFooter();
     void InternalEndSession();
+    ThreadEvents &GetThreadEvents();
+    void WriteEvents(bool is_discarding = false);
+    void AppendThreadName(u32 thread_index, std::string_view name);
+    void AppendScope(u32 thread_index, const ProfileResult &result);
+    void AppendCounter(const ProfileCounter &counter);
+    u32 InternTraceName(std::string_view name);
+    void WriteLoop(const std::stop_token &stop_token);
+    void DrainFrameEvents();
+    void SampleFrameCounters();
+    void BuildFrame(CapturedFrame &frame, FloatingPointMicroseconds frame_end);
 
 private:
     std::mutex m_mutex;                                  // Protects session state and output stream
     std::unique_ptr<ProfilingSession> p_current_session; // Current session metadata
     std::ofstream m_output_stream;                       // Output stream for profiling data
+
+    std::mutex m_buffers_mutex; // Only taken when a thread records its first event and by the writer
+    std::vector<std::unique_ptr<ThreadEvents>> m_thread_events; // Kept until exit, exited threads may leave events
+    ThreadEvents m_gpu_events;
+    SPSCQueue<ProfileCounter, COUNTER_BUFFER_CAPACITY> m_counters; // Pushed by the main thread, popped by the writer
+    std::mutex m_frame_counters_mutex; // Taken when a counter is made and by BeginFrame
+    std::vector<std::unique_ptr<FrameCounter>> m_frame_counters;
+    std::atomic<bool> m_is_active;
+    std::atomic<u64> m_dropped_events;
+    String m_batch; // Only used by the writer, or by the session thread once the writer stopped
+    bool m_is_binary; // Binary trace state below, only used along with m_batch
+    FlatHashMap<const char *, u32> m_trace_names; // Names are literals, so one pointer is one name
+    Vector<s64> m_trace_thread_times;             // Previous scope start of each thread, in nanoseconds
+    u32 m_trace_thread;                           // Of the scopes last written
+    s64 m_trace_counter_time;
+    std::mutex m_wake_mutex;
+    std::condition_variable_any m_wake_condition;
+
+    std::atomic<bool> m_is_capturing_frames;
+    std::atomic<u64> m_dropped_frame_events;
+    Vector<FrameEvent> m_frame_events; // Drained but not yet part of a frame, ordered by thread
+    std::array<CapturedFrame, FRAME_HISTORY_SIZE> m_frames; // Ring, m_next_frame is the oldest once full
+    size_t m_next_frame;
+    size_t m_frame_count;
+    u64 m_frame_number;
+    FloatingPointMicroseconds m_frame_start;
+    CapturedFrame m_captured_frame;
+    bool m_has_captured_frame;
+    bool m_frames_frozen;
+
+    std::jthread m_writer; // Last, so it stops before the state above is destroyed
 };
 
 /**
@@ -114,7 +346,7 @@ public:
      * @param loc Source location for automatic function name retrieval.
      */
     ProfilingTimer(std::string_view name, std::source_location loc = std::source_location::current())
-        : m_name{loc.function_name()}, m_start_timepoint{SteadyClock::now()}, m_stopped{false}
+        : m_name{name.empty() ? loc.function_name() : name}, m_start_timepoint{SteadyClock::now()}, m_stopped{false}
     {
     }
 
@@ -134,7 +366,7 @@ public:
         auto elapsedTime = std::chrono::time_point_cast<Microseconds>(endTimepoint).time_since_epoch() -
                            std::chrono::time_point_cast<Microseconds>(m_start_timepoint).time_since_epoch();
 
-        Profiler::Get().Write({m_name, highResStart, elapsedTime, std::this_thread::get_id()});
+        Profiler::Get().Write({m_name, highResStart, elapsedTime});
         m_stopped = true;
     }
 
@@ -188,9 +420,76 @@ public:
  * @brief Profiles the current function using source location.
  */
 #define ENGINE_PROFILE_FUNCTION()                                                                                      \
-    gouda::internal::profiler::ProfilingTimer timer { std::source_location::current() }
+    gouda::internal::profiler::ProfilingTimer timer { "", std::source_location::current() }
+
+/**
+ * @brief Records a span measured on the GPU.
+ * @param name Name of the span, a literal.
+ * @param start Start on the CPU timeline, FloatingPointMicroseconds since the steady clock's epoch.
+ * @param elapsed_time Duration in Microseconds.
+ */
+#define ENGINE_PROFILE_GPU_EVENT(name, start, elapsed_time)                                                            \
+    gouda::internal::profiler::Profiler::Get().WriteGpu({name, start, elapsed_time})
+
+/**
+ * @brief Records a counter sample while a session is open.
+ * @param name Name of the counter, a literal.
+ * @param value The counter's value, converted to f64.
+ */
+#define ENGINE_PROFILE_COUNTER(name, value)                                                                            \
+    gouda::internal::profiler::Profiler::Get().WriteCounter(name, static_cast<f64>(value))
+
+/**
+ * @brief Adds to a counter summed per frame, from any thread.
+ * @param name Name of the counter, a literal.
+ * @param amount Converted to s64.
+ */
+#define ENGINE_PROFILE_COUNT(name, amount)                                                                             \
+    do {                                                                                                               \
+        static gouda::internal::profiler::FrameCounter &s_frame_counter{                                               \
+            gouda::internal::profiler::Profiler::Get().GetFrameCounter(                                                \
+                name, gouda::internal::profiler::CounterKind::Count)};                                                 \
+        s_frame_counter.Add(static_cast<s64>(amount));                                                                 \
+    } while (0)
+
+/**
+ * @brief Sets a counter that keeps its value between frames, from any thread.
+ * @param name Name of the counter, a literal.
+ * @param value Converted to s64.
+ */
+#define ENGINE_PROFILE_GAUGE(name, value)                                                                              \
+    do {                                                                                                               \
+        static gouda::internal::profiler::FrameCounter &s_frame_counter{                                               \
+            gouda::internal::profiler::Profiler::Get().GetFrameCounter(                                                \
+                name, gouda::internal::profiler::CounterKind::Gauge)};                                                 \
+        s_frame_counter.Set(static_cast<s64>(value));                                                                  \
+    } while (0)
+
+/**
+ * @brief Marks the start of a frame for the frame history, once per frame on the main thread.
+ */
+#define ENGINE_PROFILE_FRAME() gouda::internal::profiler::Profiler::Get().BeginFrame()
+
+/**
+ * @brief Freezes or unfreezes the frame history.
+ */
+#define ENGINE_PROFILE_TOGGLE_FREEZE()                                                                                 \
+    gouda::internal::profiler::Profiler::Get().SetFramesFrozen(                                                        \
+        !gouda::internal::profiler::Profiler::Get().AreFramesFrozen())
+
+/**
+ * @brief Keeps the last completed frame and logs its scope tree.
+ */
+#define ENGINE_PROFILE_CAPTURE_FRAME() gouda::internal::profiler::Profiler::Get().CaptureFrame()
 #else
 #define ENGINE_PROFILE_SESSION(name, filepath)
 #define ENGINE_PROFILE_SCOPE(name)
 #define ENGINE_PROFILE_FUNCTION()
+#define ENGINE_PROFILE_GPU_EVENT(name, start, elapsed_time)
+#define ENGINE_PROFILE_COUNTER(name, value)
+#define ENGINE_PROFILE_COUNT(name, amount)
+#define ENGINE_PROFILE_GAUGE(name, value)
+#define ENGINE_PROFILE_FRAME()
+#define ENGINE_PROFILE_TOGGLE_FREEZE()
+#define ENGINE_PROFILE_CAPTURE_FRAME()
 #endif
\ No newline at end of file
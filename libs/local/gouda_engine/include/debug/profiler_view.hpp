@@ -0,0 +1,24 @@
+#pragma once
+/**
+ * @file debug/profiler_view.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine ImGui view of the profiler's captured frames
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+
+namespace gouda::internal::profiler {
+
+/**
+ * @brief Draws the profiler window: frame capture controls, the frame time history and the scope tree of one frame.
+ *
+ * Only the newest frame is shown while frames are live, freezing them picks any frame of the history from the plot.
+ * Has to be called between ImGui::NewFrame and ImGui::Render.
+ */
+void DrawProfilerView();
+
+} // namespace gouda::internal::profiler
@@ -0,0 +1,80 @@
+#pragma once
+/**
+ * @file debug/trace_file.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine compact binary profiler trace
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <array>
+
+#include "core/types.hpp"
+#include "utils/filesystem.hpp"
+
+namespace gouda::internal::profiler {
+
+/**
+ * Sessions whose file has this extension are written as a binary trace instead of Chrome trace JSON. A binary trace
+ * is the magic and version followed by the process id as a varint, then records until the end of the file. Every
+ * record starts with its TraceRecord tag:
+ *
+ *  Name     the name's length as a varint and its bytes, the next name id counting from zero
+ *  Thread   a thread index as a varint, the scopes that follow are of that thread
+ *  Scope    name id, start as a zigzag delta from the thread's previous start in nanoseconds, duration in
+ *           microseconds, all varints
+ *  Counter  name id, timestamp as a zigzag delta from the previous counter in nanoseconds, the value as a
+ *           little endian f64
+ *  Integer  a Counter whose value is a zigzag varint, for values that are whole numbers
+ *  ThreadName  a thread index as a varint, then the name's length as a varint and its bytes
+ *
+ * Every stream starts from a time of zero. Records are only written whole, so the trace of a process that died is
+ * readable up to its last batch. ConvertTraceToJson turns a trace into the JSON the profiler would have written.
+ */
+inline constexpr StringView TRACE_FILE_EXTENSION{".gtrace"};
+inline constexpr std::array<char, 4> TRACE_MAGIC{'G', 'T', 'R', 'C'};
+inline constexpr u8 TRACE_VERSION{1};
+inline constexpr u32 TRACE_GPU_THREAD_INDEX{0}; // CPU threads are numbered from one
+
+enum class TraceRecord : u8 {
+    Name = 1,
+    Thread = 2,
+    Scope = 3,
+    Counter = 4,
+    Integer = 5,
+    ThreadName = 6,
+};
+
+inline void append_trace_varint(String &out, u64 value)
+{
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+inline void append_trace_zigzag(String &out, const s64 value)
+{
+    append_trace_varint(out, (static_cast<u64>(value) << 1) ^ static_cast<u64>(value >> 63));
+}
+
+// Chrome trace JSON, written by sessions that are not binary and by ConvertTraceToJson
+inline constexpr StringView JSON_TRACE_FOOTER{"]}"};
+void append_json_trace_header(String &out, int process_id);
+void append_json_trace_thread_name(String &out, int process_id, u32 thread_index, StringView name);
+void append_json_trace_scope(String &out, int process_id, u32 thread_index, StringView name,
+                             Microseconds elapsed_time, FloatingPointMicroseconds start);
+void append_json_trace_counter(String &out, int process_id, StringView name, FloatingPointMicroseconds timestamp,
+                               f64 value);
+
+/**
+ * @brief Writes a binary trace out as Chrome trace JSON, readable by Perfetto and chrome://tracing.
+ * @return Success or an Error code, a trace cut short is converted up to its last whole record.
+ */
+[[nodiscard]] Expect<void, fs::Error> ConvertTraceToJson(StringView trace_filepath, StringView json_filepath);
+
+} // namespace gouda::internal::profiler
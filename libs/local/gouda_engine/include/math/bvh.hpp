@@ -0,0 +1,107 @@
+#pragma once
+/**
+ * @file math/bvh.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine static bounding volume hierarchy
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <span>
+
+#include "containers/small_vector.hpp"
+#include "core/types.hpp"
+#include "math/collision.hpp"
+
+namespace gouda::math {
+
+/**
+ * @class BoundingVolumeHierarchy
+ * @brief Binary tree of bounding boxes over a fixed set of entities, built once and queried many times.
+ *
+ * Construction splits each node where the surface area heuristic, binned along the axis with the widest spread of
+ * entity centres, predicts the cheapest queries. Unlike a uniform grid the tree adapts to the entities, so a large
+ * platform costs one leaf entry and a cluster of small props does not pay for empty cells around it. Nodes are stored
+ * depth first in one array with siblings next to each other, and queries walk it with a fixed size stack.
+ */
+class BoundingVolumeHierarchy {
+public:
+    struct Node {
+        AABB2D bounds;
+        u32 first; // First entry in the entity order for leaves, the left child for interior nodes
+        u32 count; // Entries of a leaf, 0 for interior nodes whose right child follows the left one
+    };
+
+    BoundingVolumeHierarchy();
+
+    /**
+     * @brief Replaces the contents with a set of entities, the id of each is its index in bounds.
+     * @param bounds World bounds of the entities, either corner order is accepted.
+     */
+    void Build(std::span<const AABB2D> bounds);
+
+    /**
+     * @brief Replaces the contents with some of the entities, such as all but those parked in a pool.
+     * @param bounds World bounds indexed by entity id, either corner order is accepted.
+     * @param entities Ids of the entities to add, each at most once.
+     */
+    void Build(std::span<const AABB2D> bounds, std::span<const u32> entities);
+
+    /**
+     * @brief Replaces the contents with a tree built earlier, as returned by the getters below.
+     * @param nodes Nodes in depth first order, the root first.
+     * @param entity_order Entity ids grouped by leaf.
+     * @param entity_bounds Normalised bounds in entity_order order.
+     * @param entity_count Number of entities the ids refer to.
+     * @return False, leaving the tree empty, if the arrays do not describe a valid tree.
+     */
+    [[nodiscard]] bool Assign(gouda::Vector<Node> nodes, gouda::Vector<u32> entity_order,
+                              gouda::Vector<AABB2D> entity_bounds, size_t entity_count);
+
+    /**
+     * @brief Removes all entities.
+     */
+    void Clear();
+
+    /**
+     * @brief Appends the entities whose bounds overlap the query, touching edges count as overlapping.
+     * @param bounds World bounds to query, either corner order is accepted.
+     * @param entities Receives the entity ids, in no particular order.
+     */
+    void Query(const AABB2D &bounds, gouda::Vector<u32> &entities) const;
+
+    /**
+     * @brief Appends the entities whose bounds contain a point.
+     * @param point World position to query.
+     * @param entities Receives the entity ids, in no particular order.
+     */
+    void QueryPoint(const Vec2 &point, gouda::Vector<u32> &entities) const { Query(AABB2D{point, point}, entities); }
+
+    /**
+     * @brief Appends the entities whose bounds a line segment crosses or touches, such as for line of sight tests.
+     * @param entities Receives the entity ids, in no particular order.
+     */
+    void QuerySegment(const Vec2 &from, const Vec2 &to, gouda::Vector<u32> &entities) const;
+
+    [[nodiscard]] bool IsEmpty() const noexcept { return m_nodes.empty(); }
+    [[nodiscard]] size_t GetNodeCount() const noexcept { return m_nodes.size(); }
+
+    [[nodiscard]] std::span<const Node> GetNodes() const noexcept { return m_nodes; }
+    [[nodiscard]] std::span<const u32> GetEntityOrder() const noexcept { return m_entities; }
+    [[nodiscard]] std::span<const AABB2D> GetEntityBounds() const noexcept { return m_entity_bounds; }
+
+private:
+    void BuildEntities(std::span<const AABB2D> bounds);
+    void BuildNode(u32 node_index, u32 begin, u32 end, u32 depth);
+
+private:
+    gouda::Vector<Node> m_nodes;
+    gouda::Vector<u32> m_entities;         // Entity ids grouped by leaf
+    gouda::Vector<AABB2D> m_entity_bounds; // Normalised bounds in m_entities order, indexed by id while building
+    gouda::Vector<Vec2> m_centres;         // Build scratch indexed by id
+};
+
+} // namespace gouda::math
@@ -20,6 +20,10 @@
  * You should have received a copy of the GNU Affero General Public License
  * along with this program. If not, see <https://www.gnu.org/licenses/>.
  */
+#include <algorithm>
+#include <array>
+#include <cmath>
+
 #include "math/math.hpp"
 
 namespace gouda::math {
@@ -52,6 +56,167 @@ struct AABB3D {
     }
 };
 
+struct Sphere {
+    Vec3 center;
+    f32 radius;
+};
+
+// Points p with dot(normal, p) + distance >= 0 are in front of the plane
+struct Plane {
+    Vec3 normal;
+    f32 distance;
+};
+
+/**
+ * @struct Frustum
+ * @brief The six planes bounding what a view projection matrix sees, facing inwards.
+ *
+ * The tests are conservative, a box or sphere behind none of the planes counts as visible even when it is outside a
+ * corner of the frustum. The batched versions in math/simd_kernels.hpp give the same answers.
+ */
+struct Frustum {
+    enum PlaneIndex : u8 { LEFT_PLANE, RIGHT_PLANE, BOTTOM_PLANE, TOP_PLANE, NEAR_PLANE, FAR_PLANE, PLANE_COUNT };
+
+    std::array<Plane, PLANE_COUNT> planes;
+
+    [[nodiscard]] bool Intersects(const Sphere &sphere) const
+    {
+        for (const Plane &plane : planes) {
+            const f32 distance{plane.normal.x * sphere.center.x + plane.normal.y * sphere.center.y +
+                               plane.normal.z * sphere.center.z + plane.distance};
+            if (distance + sphere.radius < 0.0f) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    [[nodiscard]] bool Intersects(const AABB3D &box) const
+    {
+        const Vec3 center{(box.min.x + box.max.x) * 0.5f, (box.min.y + box.max.y) * 0.5f,
+                          (box.min.z + box.max.z) * 0.5f};
+        const Vec3 extent{(box.max.x - box.min.x) * 0.5f, (box.max.y - box.min.y) * 0.5f,
+                          (box.max.z - box.min.z) * 0.5f};
+        for (const Plane &plane : planes) {
+            // The box's reach towards the plane's normal, from its centre
+            const f32 distance{plane.normal.x * center.x + plane.normal.y * center.y + plane.normal.z * center.z +
+                               plane.distance};
+            const f32 radius{std::abs(plane.normal.x) * extent.x + std::abs(plane.normal.y) * extent.y +
+                             std::abs(plane.normal.z) * extent.z};
+            if (distance + radius < 0.0f) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+/**
+ * @brief Extracts the frustum planes of a view projection matrix by combining its rows (Gribb and Hartmann).
+ *
+ * Expects clip depth from -w to w, as math::perspective and math::ortho produce. The planes are normalised, so
+ * plane distances are in world units and sphere radii compare directly.
+ */
+[[nodiscard]] inline Frustum extract_frustum(const Mat4 &view_projection)
+{
+    const auto row = [&view_projection](const size_t index) {
+        return Vec4{view_projection(index, 0), view_projection(index, 1), view_projection(index, 2),
+                    view_projection(index, 3)};
+    };
+    const Vec4 x{row(0)};
+    const Vec4 y{row(1)};
+    const Vec4 z{row(2)};
+    const Vec4 w{row(3)};
+
+    const auto make_plane = [](const Vec4 &coefficients) {
+        const f32 length{std::sqrt(coefficients.x * coefficients.x + coefficients.y * coefficients.y +
+                                   coefficients.z * coefficients.z)};
+        const f32 inverse_length{length > 0.0f ? 1.0f / length : 0.0f};
+        return Plane{Vec3{coefficients.x, coefficients.y, coefficients.z} * inverse_length,
+                     coefficients.w * inverse_length};
+    };
+
+    Frustum frustum;
+    frustum.planes[Frustum::LEFT_PLANE] = make_plane(w + x);
+    frustum.planes[Frustum::RIGHT_PLANE] = make_plane(w - x);
+    frustum.planes[Frustum::BOTTOM_PLANE] = make_plane(w + y);
+    frustum.planes[Frustum::TOP_PLANE] = make_plane(w - y);
+    frustum.planes[Frustum::NEAR_PLANE] = make_plane(w + z);
+    frustum.planes[Frustum::FAR_PLANE] = make_plane(w - z);
+    return frustum;
+}
+
+// Where a box moving in a straight line first touches another, see sweep_aabb
+struct SweepHit {
+    f32 time;    // Fraction of the displacement travelled before the contact
+    Vec2 normal; // Of the face that was hit, pointing back towards the moving box
+};
+
+/**
+ * @brief Time of impact of a box moving by displacement against a static one, by slab tests on the two axes.
+ *
+ * The moving box is treated as a point against the target grown by its extent, so it never tunnels through the target
+ * however far it moves. Boxes already overlapping at the start, or that only meet at a corner, are not hits.
+ * @return Whether the boxes touch within the displacement, hit is only written when they do.
+ */
+inline bool sweep_aabb(const AABB2D &moving, const Vec2 &displacement, const AABB2D &target, SweepHit &hit)
+{
+    f32 entry[2]{-constants::f32_max, -constants::f32_max};
+    f32 exit[2]{constants::f32_max, constants::f32_max};
+    for (size_t axis = 0; axis < 2; ++axis) {
+        const f32 delta{displacement[axis]};
+        if (delta == 0.0f) {
+            // Without motion on an axis the boxes have to overlap on it for the whole move
+            if (moving.max[axis] <= target.min[axis] || moving.min[axis] >= target.max[axis]) {
+                return false;
+            }
+            continue;
+        }
+        const f32 near_gap{delta > 0.0f ? target.min[axis] - moving.max[axis] : target.max[axis] - moving.min[axis]};
+        const f32 far_gap{delta > 0.0f ? target.max[axis] - moving.min[axis] : target.min[axis] - moving.max[axis]};
+        entry[axis] = near_gap / delta;
+        exit[axis] = far_gap / delta;
+    }
+
+    const size_t axis{entry[0] > entry[1] ? 0u : 1u};
+    const f32 time{entry[axis]};
+    if (time < 0.0f || time > 1.0f || time >= std::min(exit[0], exit[1])) {
+        return false;
+    }
+
+    hit.time = time;
+    hit.normal = Vec2{0.0f};
+    hit.normal[axis] = displacement[axis] > 0.0f ? -1.0f : 1.0f;
+    return true;
+}
+
+/**
+ * @brief Whether a line segment crosses or touches a box, by slab tests on the two axes.
+ */
+inline bool segment_intersects_aabb(const Vec2 &from, const Vec2 &to, const AABB2D &box)
+{
+    f32 enter{0.0f};
+    f32 leave{1.0f};
+    for (size_t axis = 0; axis < 2; ++axis) {
+        const f32 delta{to[axis] - from[axis]};
+        if (delta == 0.0f) {
+            if (from[axis] < box.min[axis] || from[axis] > box.max[axis]) {
+                return false;
+            }
+            continue;
+        }
+        const f32 inverse{1.0f / delta};
+        const f32 near_time{(box.min[axis] - from[axis]) * inverse};
+        const f32 far_time{(box.max[axis] - from[axis]) * inverse};
+        enter = std::max(enter, std::min(near_time, far_time));
+        leave = std::min(leave, std::max(near_time, far_time));
+        if (enter > leave) {
+            return false;
+        }
+    }
+    return true;
+}
+
 inline bool check_collision(const Vec3 &pos1, const Vec2 &size1, const Vec3 &pos2, const Vec2 &size2)
 {
     const bool collision_x{pos1.x + size1.x >= pos2.x && pos2.x + size2.x >= pos1.x};
@@ -451,7 +451,7 @@ constexpr int floor(T x)
 // SIMD floor for Vec4
 inline Vec4 floor(const Vec4 &v)
 {
-    if (s_simd_level >= SIMDLevel::SSE2) {
+    if (s_simd_level >= SIMDLevel::SSE4_1) {
         __m128 val = _mm_loadu_ps(v.components.data());
         __m128 floored = _mm_floor_ps(val); // SSE4.1
         Vec4 result;
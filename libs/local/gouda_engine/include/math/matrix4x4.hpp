@@ -14,7 +14,6 @@
  */
 #include <array>
 #include <cmath>
-#include <immintrin.h>
 
 #include "core/types.hpp"
 #include "debug/assert.hpp"
@@ -22,6 +21,16 @@
 
 namespace gouda::math {
 
+namespace internal {
+
+// Column-major float matrices, forwarded to the kernels from math/simd_kernels.hpp in matrix4x4.cpp
+void mat4_multiply(const f32 *lhs, const f32 *rhs, f32 *out);
+void mat4_transform(const f32 *matrix, const f32 *vector, f32 *out);
+void mat4_transpose(const f32 *matrix, f32 *out);
+bool mat4_inverse(const f32 *matrix, f32 *out);
+
+} // namespace internal
+
 template <typename T>
 class Matrix4x4 {
     static_assert(std::is_same_v<T, float>, "Matrix4x4 only supports float for SIMD compatibility");
@@ -50,91 +59,31 @@ public:
         return data[row + col * 4];
     }
 
-    // Matrix multiplication (SIMD optimized)
+    // Matrix multiplication (SIMD dispatched)
     Matrix4x4 operator*(const Matrix4x4 &other) const {
         Matrix4x4 result;
-
-#if defined(__SSE4_1___)
-        // SSE4.1: Use _mm_dp_ps for dot products
-        for (size_t col = 0; col < 4; ++col) {
-            __m128 bcol = _mm_load_ps(&other.data[col * 4]); // Load column of other
-            for (size_t row = 0; row < 4; row += 4) {
-                // Load 4 rows of this matrix
-                __m128 arow0 = _mm_load_ps(&data[row * 4]);
-                __m128 arow1 = _mm_load_ps(&data[(row + 1) * 4]);
-                __m128 arow2 = _mm_load_ps(&data[(row + 2) * 4]);
-                __m128 arow3 = _mm_load_ps(&data[(row + 3) * 4]);
-
-                // Compute dot products
-                result.data[row * 4 + col] = _mm_cvtss_f32(_mm_dp_ps(arow0, bcol, 0xF1));
-                result.data[(row + 1) * 4 + col] = _mm_cvtss_f32(_mm_dp_ps(arow1, bcol, 0xF1));
-                result.data[(row + 2) * 4 + col] = _mm_cvtss_f32(_mm_dp_ps(arow2, bcol, 0xF1));
-                result.data[(row + 3) * 4 + col] = _mm_cvtss_f32(_mm_dp_ps(arow3, bcol, 0xF1));
-            }
-        }
-#elif defined(__SSE__)
-        // SSE: Manual summation
-        for (size_t col = 0; col < 4; ++col) {
-            __m128 bcol = _mm_load_ps(&other.data[col * 4]);
-            for (size_t row = 0; row < 4; ++row) {
-                // Load row of this matrix (transpose for correct access)
-                __m128 arow = _mm_load_ps(&data[row * 4]);
-                __m128 prod = _mm_mul_ps(arow, bcol);
-                // Sum: [x,y,z,w] -> x+y+z+w
-                __m128 shuf = _mm_shuffle_ps(prod, prod, _MM_SHUFFLE(2, 3, 0, 1));
-                __m128 sums = _mm_add_ps(prod, shuf);
-                __m128 shuf2 = _mm_shuffle_ps(sums, sums, _MM_SHUFFLE(0, 1, 2, 3));
-                __m128 final = _mm_add_ps(sums, shuf2);
-                result.data[row + col * 4] = _mm_cvtss_f32(final);
-            }
-        }
-#else
-        // Scalar: Unrolled for performance
-        for (size_t row = 0; row < 4; ++row) {
-            for (size_t col = 0; col < 4; ++col) {
-                T sum = T(0);
-                sum += data[row + 0 * 4] * other.data[0 + col * 4];
-                sum += data[row + 1 * 4] * other.data[1 + col * 4];
-                sum += data[row + 2 * 4] * other.data[2 + col * 4];
-                sum += data[row + 3 * 4] * other.data[3 + col * 4];
-                result.data[row + col * 4] = sum;
-            }
-        }
-#endif
+        internal::mat4_multiply(data.data(), other.data.data(), result.data.data());
         return result;
     }
 
-    // Transform a Vector<T, 4> (SIMD optimized)
+    // Transform a Vector<T, 4> (SIMD dispatched)
     Vector<T, 4> operator*(const Vector<T, 4> &vec) const {
         Vector<T, 4> result;
+        internal::mat4_transform(data.data(), vec.components.data(), result.components.data());
+        return result;
+    }
 
-#if defined(__SSE4_1__)
-        __m128 v = _mm_loadu_ps(vec.data()); // Unaligned load for vector
-        for (size_t row = 0; row < 4; ++row) {
-            __m128 mrow = _mm_load_ps(&data[row * 4]); // Load matrix row
-            result[row] = _mm_cvtss_f32(_mm_dp_ps(mrow, v, 0xF1));
-        }
-#elif defined(__SSE__)
-        __m128 v = _mm_loadu_ps(vec.data());
-        for (size_t row = 0; row < 4; ++row) {
-            __m128 mrow = _mm_load_ps(&data[row * 4]);
-            __m128 prod = _mm_mul_ps(mrow, v);
-            __m128 shuf = _mm_shuffle_ps(prod, prod, _MM_SHUFFLE(2, 3, 0, 1));
-            __m128 sums = _mm_add_ps(prod, shuf);
-            __m128 shuf2 = _mm_shuffle_ps(sums, sums, _MM_SHUFFLE(0, 1, 2, 3));
-            __m128 final = _mm_add_ps(sums, shuf2);
-            result[row] = _mm_cvtss_f32(final);
-        }
-#else
-        for (size_t row = 0; row < 4; ++row) {
-            T sum = T(0);
-            sum += data[row + 0 * 4] * vec[0];
-            sum += data[row + 1 * 4] * vec[1];
-            sum += data[row + 2 * 4] * vec[2];
-            sum += data[row + 3 * 4] * vec[3];
-            result[row] = sum;
-        }
-#endif
+    Matrix4x4 transpose() const {
+        Matrix4x4 result;
+        internal::mat4_transpose(data.data(), result.data.data());
+        return result;
+    }
+
+    // Returns the identity matrix when this matrix is singular
+    Matrix4x4 inverse() const {
+        Matrix4x4 result;
+        [[maybe_unused]] const bool invertible{internal::mat4_inverse(data.data(), result.data.data())};
+        ASSERT(invertible, "Matrix4x4 is singular and has no inverse");
         return result;
     }
 
@@ -0,0 +1,64 @@
+#pragma once
+/**
+ * @file math/noise.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine coherent 2D noise, single values and runtime dispatched SIMD batches
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <span>
+
+#include "core/types.hpp"
+
+namespace gouda::math {
+
+enum class NoiseType : u8 {
+    Value, // Random values at the lattice points blended between, blocky at low octave counts
+    Perlin // Random gradients at the lattice points, smoother and without the grid showing
+};
+
+/**
+ * @struct NoiseSettings
+ * @brief Fractal noise is octaves of the same noise summed, each at lacunarity times the frequency and gain times the
+ * amplitude of the one before.
+ */
+struct NoiseSettings {
+    NoiseType type{NoiseType::Perlin};
+    f32 frequency{1.0f}; // Lattice cells per unit of the first octave
+    u32 octaves{1};
+    f32 lacunarity{2.0f};
+    f32 gain{0.5f};
+    u32 seed{0}; // Each octave adds its index to it, so octaves do not repeat each other
+};
+
+// The lattice points are hashed with integer arithmetic rather than a permutation table, so SIMD lanes need no
+// gathers and particle_shader.comp computes the same noise on the GPU. It does not repeat, but float precision runs
+// out a few million cells from the origin, offsets such as time are best kept small.
+
+/**
+ * @brief Value noise at a point, in [-1, 1].
+ */
+[[nodiscard]] f32 value_noise(f32 x, f32 y, u32 seed = 0);
+
+/**
+ * @brief Perlin gradient noise at a point, in [-1, 1] and 0 at every lattice point.
+ */
+[[nodiscard]] f32 perlin_noise(f32 x, f32 y, u32 seed = 0);
+
+/**
+ * @brief Fractal noise at a point, normalised by the summed amplitudes so it stays in [-1, 1].
+ */
+[[nodiscard]] f32 fractal_noise(f32 x, f32 y, const NoiseSettings &settings);
+
+/**
+ * @brief Fractal noise at a batch of points given as coordinate columns, with the best available kernel. Matches the
+ * single point fractal_noise to within rounding.
+ * @param out Receives the noise of each point, must be as large as x and y.
+ */
+void fractal_noise(std::span<const f32> x, std::span<const f32> y, std::span<f32> out, const NoiseSettings &settings);
+
+} // namespace gouda::math
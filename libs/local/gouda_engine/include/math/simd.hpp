@@ -21,144 +21,138 @@
  * You should have received a copy of the GNU Affero General Public License
  * along with this program. If not, see <https://www.gnu.org/licenses/>.
  */
+#include <immintrin.h>
+
 #if defined(_MSC_VER)
 #include <intrin.h>
 #else // GCC / Clang
 #include <cpuid.h>
 #endif
 
-namespace gouda::math {
-
-// Enumeration to define available SIMD levels (NONE, SSE2, AVX, AVX2)
-enum class SIMDLevel : uint8_t { NONE, SSE2, AVX, AVX2 };
-
-// Function to detect available SIMD capabilities of the CPU
-inline SIMDLevel DetectSIMDLevel()
-{
-#if defined(_MSC_VER) // MSVC Version
-    int cpuInfo[4] = {};
-    __cpuid(cpuInfo, 0);
-    if (cpuInfo[0] >= 7) {
-        __cpuidex(cpuInfo, 7, 0);
-        if (cpuInfo[1] & (1 << 5))
-            return SIMDLevel::AVX2;
-    }
-    __cpuid(cpuInfo, 1);
-    if (cpuInfo[2] & (1 << 28))
-        return SIMDLevel::AVX;
-    if (cpuInfo[3] & (1 << 26))
-        return SIMDLevel::SSE2;
-
-#elif defined(__GNUC__) || defined(__clang__) // GCC / Clang
-    unsigned int eax, ebx, ecx, edx;
-    if (__get_cpuid(0, &eax, &ebx, &ecx, &edx)) {
-        if (eax >= 7) {
-            __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx);
-            if (ebx & 1 << 5)
-                return SIMDLevel::AVX2;
-        }
-        __get_cpuid(1, &eax, &ebx, &ecx, &edx);
-        if (ecx & 1 << 28)
-            return SIMDLevel::AVX;
-        if (edx & 1 << 26)
-            return SIMDLevel::SSE2;
-    }
-#endif
-
-    return SIMDLevel::NONE;
-}
-
-// Detect and store the SIMD level at compile-time
-static const SIMDLevel s_simd_level = DetectSIMDLevel();
-
-// TODO: Use the following to skip runtime checks
-/*#pragma once
-/**
- * @file math/simd.hpp
- * @author GoudaCheeseburgers
- * @date 2025-03-14
- * @brief SIMD utilities for math operations
- #1#
-#include <immintrin.h>
+#include "core/types.hpp"
 
+// Compiles a single function for a newer instruction set than the rest of the engine. MSVC accepts any intrinsic
+// without it.
 #if defined(_MSC_VER)
-#include <intrin.h>
+#define GOUDA_SIMD_TARGET(isa)
 #else
-#include <cpuid.h>
+#define GOUDA_SIMD_TARGET(isa) __attribute__((target(isa)))
 #endif
 
-#include "core/types.hpp"
-
 namespace gouda::math {
 
-enum class SIMDLevel : u8 { NONE, SSE2, AVX, AVX2 };
+// Enumeration to define available SIMD levels, ordered so later levels include the earlier ones
+enum class SIMDLevel : u8 { NONE, SSE2, SSE4_1, AVX, AVX2 };
 
-enum class SimdType { Scalar, SSE, SSE4_1, AVX };
+// Kernel implementations selected at runtime
+enum class SimdType : u8 { Scalar, SSE4_1, AVX2 };
 
-template <SimdType S> struct SimdTraits;
+template <SimdType S>
+struct SimdTraits;
 
 template <>
 struct SimdTraits<SimdType::Scalar> {
     static constexpr bool is_simd = false;
-    using vector_type = float; // No SIMD type
-};
-
-template <>
-struct SimdTraits<SimdType::SSE> {
-    static constexpr bool is_simd = true;
-    using vector_type = __m128;
+    static constexpr size_t lane_count = 1;
+    using vector_type = f32;
 };
 
 template <>
 struct SimdTraits<SimdType::SSE4_1> {
     static constexpr bool is_simd = true;
+    static constexpr size_t lane_count = 4;
     using vector_type = __m128;
 };
 
 template <>
-struct SimdTraits<SimdType::AVX> {
+struct SimdTraits<SimdType::AVX2> {
     static constexpr bool is_simd = true;
+    static constexpr size_t lane_count = 8;
     using vector_type = __m256;
 };
 
-inline SIMDLevel DetectSIMDLevel() {
-#if defined(_MSC_VER)
-    int cpuInfo[4] = {};
-    __cpuid(cpuInfo, 0);
-    if (cpuInfo[0] >= 7) {
-        __cpuidex(cpuInfo, 7, 0);
-        if (cpuInfo[1] & (1 << 5)) return SIMDLevel::AVX2;
+// Function to detect available SIMD capabilities of the CPU. AVX levels also require the OS to save the YMM registers.
+inline SIMDLevel DetectSIMDLevel()
+{
+    constexpr u32 sse2_bit{1u << 26};   // CPUID 1, EDX
+    constexpr u32 sse4_1_bit{1u << 19}; // CPUID 1, ECX
+    constexpr u32 osxsave_bit{1u << 27};
+    constexpr u32 avx_bit{1u << 28};
+    constexpr u32 avx2_bit{1u << 5};    // CPUID 7, EBX
+
+    u32 max_leaf{0};
+    u32 leaf1_ecx{0};
+    u32 leaf1_edx{0};
+    u32 leaf7_ebx{0};
+
+#if defined(_MSC_VER) // MSVC Version
+    int cpu_info[4] = {};
+    __cpuid(cpu_info, 0);
+    max_leaf = static_cast<u32>(cpu_info[0]);
+    if (max_leaf >= 1) {
+        __cpuid(cpu_info, 1);
+        leaf1_ecx = static_cast<u32>(cpu_info[2]);
+        leaf1_edx = static_cast<u32>(cpu_info[3]);
     }
-    __cpuid(cpuInfo, 1);
-    if (cpuInfo[2] & (1 << 28)) return SIMDLevel::AVX;
-    if (cpuInfo[3] & (1 << 26)) return SIMDLevel::SSE2;
-#else
+    if (max_leaf >= 7) {
+        __cpuidex(cpu_info, 7, 0);
+        leaf7_ebx = static_cast<u32>(cpu_info[1]);
+    }
+#elif defined(__GNUC__) || defined(__clang__) // GCC / Clang
     unsigned int eax, ebx, ecx, edx;
     if (__get_cpuid(0, &eax, &ebx, &ecx, &edx)) {
-        if (eax >= 7) {
-            __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx);
-            if (ebx & (1 << 5)) return SIMDLevel::AVX2;
-        }
-        __get_cpuid(1, &eax, &ebx, &ecx, &edx);
-        if (ecx & (1 << 28)) return SIMDLevel::AVX;
-        if (edx & (1 << 26)) return SIMDLevel::SSE2;
+        max_leaf = eax;
+    }
+    if (max_leaf >= 1 && __get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        leaf1_ecx = ecx;
+        leaf1_edx = edx;
+    }
+    if (max_leaf >= 7) {
+        __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx);
+        leaf7_ebx = ebx;
     }
 #endif
-    return SIMDLevel::NONE;
-}
 
-inline SimdType GetSimdType() {
-    static const SIMDLevel level = DetectSIMDLevel();
-    switch (level) {
-        case SIMDLevel::AVX2: // Fall through to AVX
-        case SIMDLevel::AVX: return SimdType::AVX;
-        case SIMDLevel::SSE2: return SimdType::SSE4_1; // Assume SSE4.1 for SSE2 CPUs
-        default: return SimdType::Scalar;
+    bool os_saves_ymm{false};
+    if (leaf1_ecx & osxsave_bit) {
+#if defined(_MSC_VER)
+        const u64 xcr0{_xgetbv(0)};
+#else
+        u32 xcr0_low, xcr0_high;
+        __asm__("xgetbv" : "=a"(xcr0_low), "=d"(xcr0_high) : "c"(0));
+        const u64 xcr0{(static_cast<u64>(xcr0_high) << 32) | xcr0_low};
+#endif
+        os_saves_ymm = (xcr0 & 0x6) == 0x6; // XMM and YMM state
+    }
+
+    if (os_saves_ymm && (leaf1_ecx & avx_bit)) {
+        return (leaf7_ebx & avx2_bit) ? SIMDLevel::AVX2 : SIMDLevel::AVX;
+    }
+    if (leaf1_ecx & sse4_1_bit) {
+        return SIMDLevel::SSE4_1;
     }
+    if (leaf1_edx & sse2_bit) {
+        return SIMDLevel::SSE2;
+    }
+
+    return SIMDLevel::NONE;
 }
 
-static const SimdType simd_type = GetSimdType();
+// Detect and store the SIMD level once at startup
+static const SIMDLevel s_simd_level = DetectSIMDLevel();
 
-} // namespace gouda::math*/
+// Kernel implementation to use on this CPU
+inline SimdType GetSimdType()
+{
+    switch (s_simd_level) {
+        case SIMDLevel::AVX2:
+            return SimdType::AVX2;
+        case SIMDLevel::AVX: // No integer AVX2, the 128 bit kernels are the better fit
+        case SIMDLevel::SSE4_1:
+            return SimdType::SSE4_1;
+        default:
+            return SimdType::Scalar;
+    }
+}
 
-}
\ No newline at end of file
+} // namespace gouda::math
@@ -0,0 +1,183 @@
+#pragma once
+/**
+ * @file math/simd_kernels.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine runtime dispatched SIMD batch kernels
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <span>
+
+#include "containers/small_vector.hpp"
+#include "core/types.hpp"
+#include "math/collision.hpp"
+#include "math/math.hpp"
+#include "math/simd.hpp"
+
+namespace gouda::math {
+
+/**
+ * @struct ParticleStreams
+ * @brief Structure of arrays view over particle state updated by the integration kernel.
+ */
+struct ParticleStreams {
+    f32 *position_x;
+    f32 *position_y;
+    f32 *position_z;
+    f32 *velocity_x;
+    f32 *velocity_y;
+    f32 *velocity_z;
+    f32 *lifetime;
+};
+
+/**
+ * @struct AABB2DStreams
+ * @brief Structure of arrays view over boxes tested by the batched intersection kernels, count floats each.
+ */
+struct AABB2DStreams {
+    const f32 *min_x;
+    const f32 *min_y;
+    const f32 *max_x;
+    const f32 *max_y;
+};
+
+/**
+ * @class AABB2DColumns
+ * @brief Boxes stored as four float columns, gathered by callers ahead of the batched intersection kernels.
+ */
+class AABB2DColumns {
+public:
+    void Clear()
+    {
+        m_min_x.clear();
+        m_min_y.clear();
+        m_max_x.clear();
+        m_max_y.clear();
+    }
+
+    void Reserve(const size_t count)
+    {
+        m_min_x.reserve(count);
+        m_min_y.reserve(count);
+        m_max_x.reserve(count);
+        m_max_y.reserve(count);
+    }
+
+    void PushBack(const AABB2D &box)
+    {
+        m_min_x.push_back(box.min.x);
+        m_min_y.push_back(box.min.y);
+        m_max_x.push_back(box.max.x);
+        m_max_y.push_back(box.max.y);
+    }
+
+    [[nodiscard]] size_t Size() const noexcept { return m_min_x.size(); }
+    [[nodiscard]] AABB2DStreams GetStreams() const noexcept
+    {
+        return {m_min_x.data(), m_min_y.data(), m_max_x.data(), m_max_y.data()};
+    }
+
+private:
+    gouda::Vector<f32> m_min_x;
+    gouda::Vector<f32> m_min_y;
+    gouda::Vector<f32> m_max_x;
+    gouda::Vector<f32> m_max_y;
+};
+
+/**
+ * @struct SimdKernels
+ * @brief Table of batch kernels compiled for one instruction set.
+ *
+ * Every kernel is built with its own target attribute, so all tables exist in the binary regardless of the flags
+ * the engine is compiled with. GetSimdKernels picks the best table for the CPU once, on first use.
+ */
+struct SimdKernels {
+    SimdType type;
+
+    /// out = lhs * rhs, all column-major 4x4 matrices. out may alias neither input.
+    void (*mat4_multiply)(const f32 *lhs, const f32 *rhs, f32 *out);
+
+    /// out = matrix * vector for a column-major matrix and a 4 component vector.
+    void (*mat4_transform)(const f32 *matrix, const f32 *vector, f32 *out);
+
+    /// out = transpose(matrix). out may not alias matrix.
+    void (*mat4_transpose)(const f32 *matrix, f32 *out);
+
+    /// out = inverse(matrix). Returns false and leaves out untouched when the matrix is singular.
+    bool (*mat4_inverse)(const f32 *matrix, f32 *out);
+
+    /// out[i] = matrix * (points[i], 1), the w component is dropped. out may alias points.
+    void (*transform_points)(const f32 *matrix, const Vec3 *points, Vec3 *out, size_t count);
+
+    /// out[i] = bounds of boxes[i] under the xy affine part of matrix. out may alias boxes.
+    void (*transform_aabbs)(const f32 *matrix, const AABB2D *boxes, AABB2D *out, size_t count);
+
+    /// visible[i] = 1 when boxes[i] intersects view, 0 otherwise. Matches AABB2D::Intersects.
+    void (*cull_aabbs)(const AABB2D *boxes, const AABB2D &view, u8 *visible, size_t count);
+
+    /// Bit i of mask is set when box i intersects query, mask holds (count + 63) / 64 words. Matches
+    /// AABB2D::Intersects, the bits past count are cleared.
+    void (*intersect_aabbs_mask)(const AABB2DStreams &boxes, const AABB2D &query, u64 *mask, size_t count);
+
+    /// Writes the indices of the boxes intersecting query in ascending order, indices holds count entries.
+    /// Matches AABB2D::Intersects. Returns the number written.
+    size_t (*intersect_aabbs_indices)(const AABB2DStreams &boxes, const AABB2D &query, u32 *indices, size_t count);
+
+    /// visible[i] = 1 when spheres[i] is behind none of the frustum's planes. Matches Frustum::Intersects.
+    void (*cull_spheres_frustum)(const Frustum &frustum, const Sphere *spheres, u8 *visible, size_t count);
+
+    /// visible[i] = 1 when boxes[i] is not wholly behind any of the frustum's planes. Matches Frustum::Intersects.
+    void (*cull_aabbs_frustum)(const Frustum &frustum, const AABB3D *boxes, u8 *visible, size_t count);
+
+    /// Applies gravity to velocity, then velocity to position, and decrements lifetime.
+    void (*integrate_particles)(const ParticleStreams &streams, size_t count, f32 delta_time, const Vec3 &gravity);
+};
+
+/**
+ * @brief Returns the kernels for the best instruction set supported by this CPU.
+ */
+[[nodiscard]] const SimdKernels &GetSimdKernels();
+
+/**
+ * @brief Returns the kernels for a specific instruction set, which must be supported by this CPU.
+ */
+[[nodiscard]] const SimdKernels &GetSimdKernels(SimdType type);
+
+[[nodiscard]] StringView ToString(SimdType type);
+
+/**
+ * @brief Transforms a batch of points by a matrix with the best available kernel.
+ * @param out Receives the transformed points, must be as large as points. May be the same span.
+ */
+void transform_points(const Mat4 &matrix, std::span<const Vec3> points, std::span<Vec3> out);
+
+/**
+ * @brief Computes the bounds of a batch of 2D boxes under the xy affine part of a matrix.
+ * @param out Receives the transformed boxes, must be as large as boxes. May be the same span.
+ */
+void transform_aabbs(const Mat4 &matrix, std::span<const AABB2D> boxes, std::span<AABB2D> out);
+
+/**
+ * @brief Tests a batch of spheres against a frustum with the best available kernel, see extract_frustum.
+ * @param visible Receives 1 for each sphere that may be seen and 0 for the rest, must be as large as spheres.
+ */
+void cull_frustum(const Frustum &frustum, std::span<const Sphere> spheres, std::span<u8> visible);
+
+/**
+ * @brief Tests a batch of boxes against a frustum with the best available kernel, see extract_frustum.
+ * @param visible Receives 1 for each box that may be seen and 0 for the rest, must be as large as boxes.
+ */
+void cull_frustum(const Frustum &frustum, std::span<const AABB3D> boxes, std::span<u8> visible);
+
+/**
+ * @brief Appends the indices of the boxes intersecting query with the best available kernel.
+ * @param indices Receives the indices in ascending order, what it held is kept.
+ * @return The number of indices appended.
+ */
+size_t intersect_aabbs(const AABB2DColumns &boxes, const AABB2D &query, gouda::Vector<u32> &indices);
+
+} // namespace gouda::math
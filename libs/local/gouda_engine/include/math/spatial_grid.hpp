@@ -0,0 +1,139 @@
+#pragma once
+/**
+ * @file math/spatial_grid.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine flat spatial hash grid
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <span>
+
+#include "containers/small_vector.hpp"
+#include "core/types.hpp"
+#include "math/collision.hpp"
+
+namespace gouda::math {
+
+/**
+ * @class SpatialHashGrid
+ * @brief Uniform grid over an unbounded plane that maps the cells an entity overlaps back to the entity.
+ *
+ * Only occupied cells are stored, in an open addressing table with linear probing keyed by a mixed hash of both
+ * coordinates. Entities given to Build are stored per cell as a contiguous run of ids in one shared array (compressed
+ * sparse row), so a query over static entities touches the table slots of the cells it covers and the ids behind
+ * them, nothing else. Entities added or moved afterwards go to per cell lists of pooled nodes instead, which keeps
+ * Insert, Remove and Move at O(cells touched). A Move that stays within the same cells costs nothing beyond the range
+ * check. Entities spanning several cells are reported once per query, deduplicated with per entity generation stamps.
+ */
+class SpatialHashGrid {
+public:
+    /**
+     * @brief Creates an empty grid.
+     * @param cell_size Width and height of a cell in world units, around the size of a typical entity or query.
+     */
+    explicit SpatialHashGrid(f32 cell_size);
+
+    /**
+     * @brief Replaces the contents with a set of entities, the id of each is its index in bounds.
+     * @param bounds World bounds of the entities.
+     */
+    void Build(std::span<const AABB2D> bounds);
+
+    /**
+     * @brief Removes all entities.
+     */
+    void Clear();
+
+    /**
+     * @brief Adds an entity, replacing it if the id is already indexed.
+     * @param entity Id of the entity, ids are indices so they should stay dense.
+     * @param bounds World bounds of the entity.
+     */
+    void Insert(u32 entity, const AABB2D &bounds);
+
+    /**
+     * @brief Removes an entity, ids that are not indexed are ignored.
+     * @param entity Id of the entity.
+     */
+    void Remove(u32 entity);
+
+    /**
+     * @brief Updates the bounds of an indexed entity, inserting it if it is not.
+     * @param entity Id of the entity.
+     * @param bounds New world bounds of the entity.
+     */
+    void Move(u32 entity, const AABB2D &bounds);
+
+    /**
+     * @brief Appends the entities sharing a cell with the bounds, each once. These are candidates, their bounds are
+     * not tested against the query.
+     * @param bounds World bounds to query.
+     * @param entities Receives the entity ids.
+     */
+    void Query(const AABB2D &bounds, gouda::Vector<u32> &entities);
+
+    [[nodiscard]] bool Contains(u32 entity) const noexcept
+    {
+        return entity < m_entities.size() && m_entities[entity].is_indexed;
+    }
+
+    [[nodiscard]] f32 GetCellSize() const noexcept { return m_cell_size; }
+    [[nodiscard]] u32 GetCellCount() const noexcept { return m_cell_count; } ///< Cells ever occupied since Build
+
+private:
+    struct Cell {
+        s32 x;
+        s32 y;
+        u32 first;        // Static run in m_cell_entities, EMPTY_SLOT marks an unused table slot
+        u32 count;
+        u32 dynamic_head; // First node in m_dynamic_nodes, INVALID_INDEX when there is none
+    };
+
+    struct DynamicNode {
+        u32 entity;
+        u32 next; // Next node of the same cell, or of the free list
+    };
+
+    struct CellRange {
+        s32 min_x;
+        s32 max_x;
+        s32 min_y;
+        s32 max_y;
+
+        bool operator==(const CellRange &other) const = default;
+    };
+
+    struct EntityRecord {
+        CellRange range;
+        bool is_indexed;
+        bool is_dynamic; // In the node lists rather than the static runs
+    };
+
+    [[nodiscard]] CellRange GetCellRange(const AABB2D &bounds) const;
+    [[nodiscard]] u32 FindCell(s32 x, s32 y) const; // Slot index, INVALID_INDEX if the cell was never occupied
+    [[nodiscard]] u32 FindOrInsertCell(s32 x, s32 y);
+    void ReserveCells(size_t cell_count); // Grows the table so cell_count cells keep it at most half full
+    [[nodiscard]] u32 AllocateNode(u32 entity, u32 next);
+
+private:
+    static constexpr u32 INVALID_INDEX{constants::u32_max};
+    static constexpr u32 EMPTY_SLOT{constants::u32_max};
+
+    f32 m_cell_size;
+    f32 m_inverse_cell_size;
+
+    gouda::Vector<Cell> m_cells; // Power of two slot count, at most half of the slots are occupied
+    u32 m_cell_count;
+    gouda::Vector<u32> m_cell_entities; // Static entity ids of all cells, each cell owns the run [first, first + count)
+    gouda::Vector<DynamicNode> m_dynamic_nodes;
+    u32 m_free_node; // Head of the free node list, INVALID_INDEX when empty
+    gouda::Vector<EntityRecord> m_entities; // Indexed by entity id
+    gouda::Vector<u32> m_entity_stamps;     // Query generation that last reported each entity
+    u32 m_query_stamp;
+};
+
+} // namespace gouda::math
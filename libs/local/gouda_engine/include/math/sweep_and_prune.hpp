@@ -0,0 +1,93 @@
+#pragma once
+/**
+ * @file math/sweep_and_prune.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine sort based collision broadphase
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include "containers/small_vector.hpp"
+#include "core/types.hpp"
+#include "math/collision.hpp"
+
+namespace gouda::math {
+
+// Two bodies whose bounds overlap, first < second
+struct CollisionPair {
+    u32 first;
+    u32 second;
+};
+
+/**
+ * @class SweepAndPrune
+ * @brief Finds every pair of overlapping bodies by sorting their bounds along the x axis and sweeping them.
+ *
+ * The bodies are kept in one array ordered by their minimum x, which is only restored by an insertion sort when the
+ * pairs are asked for. Bodies move little between ticks, so the order is almost right already and the sort is close
+ * to linear in the body count. The sweep then only tests each body against those starting before it ends on x, the
+ * y overlap is checked against bounds stored alongside so it never leaves the array. Pairs are candidates for a
+ * narrowphase, their bounds overlap but nothing finer is tested.
+ */
+class SweepAndPrune {
+public:
+    SweepAndPrune();
+
+    /**
+     * @brief Adds a body, replacing it if the id is already tracked.
+     * @param body Id of the body, ids are indices so they should stay dense.
+     * @param bounds World bounds of the body.
+     */
+    void Insert(u32 body, const AABB2D &bounds);
+
+    /**
+     * @brief Removes a body, ids that are not tracked are ignored.
+     */
+    void Remove(u32 body);
+
+    /**
+     * @brief Updates the bounds of a tracked body, inserting it if it is not. The order is fixed by FindPairs.
+     */
+    void Move(u32 body, const AABB2D &bounds);
+
+    /**
+     * @brief Removes all bodies.
+     */
+    void Clear();
+
+    /**
+     * @brief Appends every pair of bodies whose bounds overlap, each once.
+     */
+    void FindPairs(gouda::Vector<CollisionPair> &pairs);
+
+    [[nodiscard]] bool Contains(const u32 body) const noexcept
+    {
+        return body < m_bodies.size() && m_bodies[body] != INVALID_INDEX;
+    }
+
+    [[nodiscard]] u32 GetBodyCount() const noexcept { return static_cast<u32>(m_entries.size()); }
+    [[nodiscard]] u32 GetLastSwapCount() const noexcept { return m_swap_count; } ///< Moves the last sort made
+
+private:
+    struct Entry {
+        f32 min_x;
+        f32 max_x;
+        f32 min_y;
+        f32 max_y;
+        u32 body;
+    };
+
+    void SortEntries();
+
+private:
+    static constexpr u32 INVALID_INDEX{constants::u32_max};
+
+    gouda::Vector<Entry> m_entries; // Ordered by min_x after each sort
+    gouda::Vector<u32> m_bodies;    // Indexed by body id, the entry of the body or INVALID_INDEX
+    u32 m_swap_count;
+};
+
+} // namespace gouda::math
@@ -0,0 +1,127 @@
+#pragma once
+/**
+ * @file math/transform_hierarchy.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine 2D transform hierarchy
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <span>
+
+#include "containers/small_vector.hpp"
+#include "core/types.hpp"
+#include "math/math.hpp"
+
+namespace gouda::math {
+
+using TransformID = u32;
+inline constexpr TransformID INVALID_TRANSFORM{constants::u32_max};
+
+/**
+ * @struct Transform2D
+ * @brief Position, rotation and scale of a node, against its parent's or the world for roots.
+ */
+struct Transform2D {
+    Vec2 position{0.0f};
+    f32 rotation{0.0f}; // Radians
+    Vec2 scale{1.0f};
+};
+
+/**
+ * @class TransformHierarchy
+ * @brief Parented 2D transforms whose world transforms are recomputed only below the nodes that changed.
+ *
+ * Every field is kept in an array of its own, the nodes ordered so each parent comes before its children. Update is
+ * then one pass from the first changed node onwards: a node is recomputed when it changed or its parent was, from
+ * its parent's world transform computed earlier in the same pass. Static nodes and everything under them cost a
+ * flag test, and nothing at all when nothing changed. The world rotation's sine and cosine are kept beside it, so a
+ * parent's are computed once for all its children. Non uniform scale under a rotated parent is applied along the
+ * child's own axes, there is no shear, which is what sprites can be drawn with anyway.
+ *
+ * Ids stay valid until the node is removed and are reused after. Reparenting under a later node breaks the order,
+ * it is put back by the next Update, which also moves the node's array positions.
+ */
+class TransformHierarchy {
+public:
+    TransformHierarchy();
+
+    /**
+     * @brief Adds a node, dirty until the next Update.
+     * @param parent Node the local transform is relative to, INVALID_TRANSFORM for a root.
+     */
+    TransformID Add(const Transform2D &local, TransformID parent = INVALID_TRANSFORM);
+
+    /**
+     * @brief Removes a node and every node under it.
+     */
+    void Remove(TransformID id);
+
+    /**
+     * @brief Moves a node under another, keeping its local transform.
+     * @return False, leaving the node where it was, if parent is the node itself or one under it.
+     */
+    bool SetParent(TransformID id, TransformID parent);
+
+    void SetLocal(TransformID id, const Transform2D &local);
+    void SetLocalPosition(TransformID id, const Vec2 &position);
+    void SetLocalRotation(TransformID id, f32 rotation);
+
+    /**
+     * @brief Recomputes the world transforms of the changed nodes and everything under them.
+     */
+    void Update();
+
+    [[nodiscard]] bool IsValid(const TransformID id) const noexcept
+    {
+        return id < m_slots.size() && m_slots[id] != INVALID_SLOT;
+    }
+    [[nodiscard]] TransformID GetParent(TransformID id) const;
+    [[nodiscard]] Transform2D GetLocal(TransformID id) const;
+    [[nodiscard]] Transform2D GetWorld(TransformID id) const; ///< As of the last Update
+
+    /**
+     * @brief Nodes whose world transforms the last Update recomputed, parents before children. Those who copy world
+     * transforms out only need to copy these.
+     */
+    [[nodiscard]] std::span<const TransformID> GetUpdated() const noexcept { return m_updated; }
+
+    [[nodiscard]] size_t Size() const noexcept { return m_ids.size(); }
+    [[nodiscard]] bool IsEmpty() const noexcept { return m_ids.empty(); }
+
+    void Reserve(size_t count);
+    void Clear();
+
+private:
+    static constexpr u32 INVALID_SLOT{constants::u32_max};
+
+    void MarkDirty(u32 slot);
+    void SortNodes(); // Parents first, by depth, keeping the order of nodes at the same depth
+
+private:
+    // Per id
+    gouda::Vector<u32> m_slots; // Into the node arrays, INVALID_SLOT while free
+    gouda::Vector<TransformID> m_free_ids;
+
+    // Per node, parents first
+    gouda::Vector<TransformID> m_ids;
+    gouda::Vector<u32> m_parents; // Slots, INVALID_SLOT for roots
+    gouda::Vector<Vec2> m_local_positions;
+    gouda::Vector<f32> m_local_rotations;
+    gouda::Vector<Vec2> m_local_scales;
+    gouda::Vector<Vec2> m_world_positions;
+    gouda::Vector<f32> m_world_rotations;
+    gouda::Vector<f32> m_world_sines;
+    gouda::Vector<f32> m_world_cosines;
+    gouda::Vector<Vec2> m_world_scales;
+    gouda::Vector<u8> m_dirty;
+
+    gouda::Vector<TransformID> m_updated;
+    u32 m_first_dirty;     // Slot, Size() when nothing changed
+    bool m_is_order_dirty; // A node was moved under one after it
+};
+
+} // namespace gouda::math
@@ -20,6 +20,8 @@
  * You should have received a copy of the GNU Affero General Public License
  * along with this program. If not, see <https://www.gnu.org/licenses/>.
  */
+#include <new>
+
 #include "core/types.hpp"
 
 namespace gouda {
@@ -37,7 +39,7 @@ public:
 
     T *allocate(size_t n)
     {
-        if (n > Constants::size_t_max / sizeof(T)) {
+        if (n > constants::size_t_max / sizeof(T)) {
             throw std::bad_alloc();
         }
         return static_cast<T *>(::operator new[](n * sizeof(T)));
@@ -0,0 +1,198 @@
+#pragma once
+/**
+ * @file linear_allocator.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine linear allocator module
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <span>
+#include <type_traits>
+
+#include "containers/small_vector.hpp"
+#include "core/types.hpp"
+#include "memory/memory_tracker.hpp"
+
+namespace gouda {
+
+/**
+ * @class LinearAllocator
+ * @brief Bump allocator whose allocations are all released at once by Reset.
+ *
+ * Allocations that do not fit go to the heap and are freed on the next Reset, which then grows the buffer to the
+ * peak seen so the following cycles fit again. Destructors are never run, so only trivially destructible objects
+ * should be placed in it. The buffer and the overflow blocks are counted under the allocator's MemoryTag, what is
+ * allocated from the buffer is not.
+ */
+class LinearAllocator {
+public:
+    LinearAllocator() noexcept;
+    explicit LinearAllocator(size_t capacity, MemoryTag tag = MemoryTag::General);
+    ~LinearAllocator();
+
+    LinearAllocator(const LinearAllocator &) = delete;
+    LinearAllocator &operator=(const LinearAllocator &) = delete;
+
+    /**
+     * @brief Grows the buffer, only between cycles as it invalidates everything allocated from it.
+     */
+    void Reserve(size_t capacity);
+
+    /**
+     * @brief Changes the tag the buffer is counted under, only before anything was reserved.
+     */
+    void SetMemoryTag(MemoryTag tag);
+
+    [[nodiscard]] void *Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    /**
+     * @brief Uninitialized storage for count objects of T.
+     */
+    template <typename T>
+    [[nodiscard]] T *Allocate(const size_t count)
+    {
+        static_assert(std::is_trivially_destructible_v<T>, "Reset never runs destructors");
+        if (count > constants::size_t_max / sizeof(T)) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T *>(Allocate(count * sizeof(T), alignof(T)));
+    }
+
+    /**
+     * @brief count copies of value, valid until the next Reset.
+     */
+    template <typename T>
+    [[nodiscard]] std::span<T> AllocateSpan(const size_t count, const T &value = T{})
+    {
+        T *data{Allocate<T>(count)};
+        std::uninitialized_fill_n(data, count, value);
+        return {data, count};
+    }
+
+    /**
+     * @brief Gives the memory back when it was the most recent allocation, so a container growing at the top of the
+     * buffer reuses it. Anything else is released by Reset.
+     */
+    void Deallocate(void *pointer, size_t size) noexcept;
+
+    /**
+     * @brief Releases every allocation since the last Reset.
+     */
+    void Reset();
+
+    [[nodiscard]] size_t GetUsed() const noexcept { return m_offset + m_overflow_size; }
+    [[nodiscard]] size_t GetCapacity() const noexcept { return m_capacity; }
+    [[nodiscard]] size_t GetPeak() const noexcept { return m_peak; }
+    [[nodiscard]] u32 GetOverflowCount() const noexcept { return m_overflow_count; }
+
+private:
+    struct OverflowBlock {
+        OverflowBlock *next;
+        size_t alignment;
+        size_t size; // Header included
+    };
+
+    [[nodiscard]] void *AllocateOverflow(size_t size, size_t alignment);
+    void FreeOverflow() noexcept;
+
+private:
+    std::byte *p_buffer;
+    size_t m_capacity;
+    size_t m_offset;
+    size_t m_peak;             // Most used in any cycle, overflow included
+    OverflowBlock *p_overflow; // Heap blocks of the current cycle, newest first
+    size_t m_overflow_size;
+    u32 m_overflow_count; // Overflowing allocations since the last Reset
+    MemoryTag m_tag;
+};
+
+/**
+ * @class FrameAllocator
+ * @brief One LinearAllocator per frame, each reset when its frame comes round again.
+ *
+ * Memory allocated during a frame stays valid for frame_count - 1 frames after it, so data built for a frame can be
+ * handed on to the next while the current one already allocates.
+ */
+class FrameAllocator {
+public:
+    static constexpr size_t DEFAULT_CAPACITY{1024 * 1024};
+    static constexpr u32 DEFAULT_FRAME_COUNT{2};
+
+    explicit FrameAllocator(size_t capacity = DEFAULT_CAPACITY, u32 frame_count = DEFAULT_FRAME_COUNT,
+                            MemoryTag tag = MemoryTag::General);
+
+    /**
+     * @brief Moves on to the next frame's allocator and resets it.
+     */
+    void BeginFrame();
+
+    [[nodiscard]] LinearAllocator &Get() noexcept { return p_allocators[m_frame_index]; }
+    [[nodiscard]] u32 GetFrameCount() const noexcept { return m_frame_count; }
+
+private:
+    std::unique_ptr<LinearAllocator[]> p_allocators;
+    u32 m_frame_count;
+    u32 m_frame_index;
+};
+
+/**
+ * @class ArenaAllocator
+ * @brief Allocator with the interface of DefaultAllocator that draws from a LinearAllocator.
+ *
+ * Containers using it must not outlive the allocator's next Reset. Their destructors still run, so elements whose
+ * memory the container does not own need no special care.
+ */
+template <typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    ArenaAllocator() noexcept : p_arena{nullptr} {}
+    explicit ArenaAllocator(LinearAllocator &arena) noexcept : p_arena{&arena} {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U> &other) noexcept : p_arena{other.GetArena()}
+    {
+    }
+
+    T *allocate(size_t n)
+    {
+        if (n > constants::size_t_max / sizeof(T)) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T *>(p_arena->Allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T *p, const size_t n) noexcept { p_arena->Deallocate(p, n * sizeof(T)); }
+
+    [[nodiscard]] LinearAllocator *GetArena() const noexcept { return p_arena; }
+
+private:
+    LinearAllocator *p_arena;
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T> &a, const ArenaAllocator<U> &b) noexcept
+{
+    return a.GetArena() == b.GetArena();
+}
+
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T> &a, const ArenaAllocator<U> &b) noexcept
+{
+    return !(a == b);
+}
+
+/**
+ * @brief Vector whose storage comes from a LinearAllocator, for scratch that is dropped before the next Reset.
+ */
+template <typename T>
+using ArenaVector = Vector<T, ArenaAllocator<T>>;
+
+} // namespace gouda
@@ -0,0 +1,96 @@
+#pragma once
+/**
+ * @file memory/allocators/tracking_allocator.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine allocator that records its allocations with the memory tracker
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <functional>
+#include <memory>
+#include <type_traits>
+
+#include "containers/flat_hash_map.hpp"
+#include "containers/small_vector.hpp"
+#include "core/types.hpp"
+#include "memory/allocators/default_allocator.hpp"
+#include "memory/memory_tracker.hpp"
+
+namespace gouda {
+
+/**
+ * @class TrackingAllocator
+ * @brief Allocator with the interface of DefaultAllocator that counts what it hands out under a MemoryTag.
+ *
+ * The tag is part of the type, so a defaulted tracking allocator takes no space in the container holding it. Memory
+ * comes from Upstream, which may be an ArenaAllocator to see how much scratch a subsystem draws from its arena.
+ */
+template <typename T, MemoryTag Tag, typename Upstream = DefaultAllocator<T>>
+class TrackingAllocator {
+    static_assert(std::is_same_v<typename Upstream::value_type, T>, "Upstream must allocate the same type");
+
+public:
+    using value_type = T;
+
+    // Written out, the tag is not a type so std::allocator_traits cannot rebind on its own
+    template <typename U>
+    struct rebind {
+        using other = TrackingAllocator<U, Tag, typename std::allocator_traits<Upstream>::template rebind_alloc<U>>;
+    };
+
+    TrackingAllocator() noexcept = default;
+    explicit TrackingAllocator(const Upstream &upstream) noexcept : m_upstream{upstream} {}
+    template <typename U, typename OtherUpstream>
+    TrackingAllocator(const TrackingAllocator<U, Tag, OtherUpstream> &other) noexcept
+        : m_upstream{other.GetUpstream()}
+    {
+    }
+
+    T *allocate(const size_t n)
+    {
+        T *p{m_upstream.allocate(n)};
+        MemoryTracker::Get().RecordAllocation(Tag, n * sizeof(T));
+        return p;
+    }
+
+    void deallocate(T *p, const size_t n) noexcept
+    {
+        MemoryTracker::Get().RecordDeallocation(Tag, n * sizeof(T));
+        m_upstream.deallocate(p, n);
+    }
+
+    [[nodiscard]] const Upstream &GetUpstream() const noexcept { return m_upstream; }
+
+private:
+    [[no_unique_address]] Upstream m_upstream;
+};
+
+template <typename T, typename U, MemoryTag Tag, typename UpstreamT, typename UpstreamU>
+bool operator==(const TrackingAllocator<T, Tag, UpstreamT> &a, const TrackingAllocator<U, Tag, UpstreamU> &b) noexcept
+{
+    return a.GetUpstream() == b.GetUpstream();
+}
+
+template <typename T, typename U, MemoryTag Tag, typename UpstreamT, typename UpstreamU>
+bool operator!=(const TrackingAllocator<T, Tag, UpstreamT> &a, const TrackingAllocator<U, Tag, UpstreamU> &b) noexcept
+{
+    return !(a == b);
+}
+
+/**
+ * @brief Vector whose heap storage is counted under a MemoryTag.
+ */
+template <typename T, MemoryTag Tag>
+using TrackedVector = Vector<T, TrackingAllocator<T, Tag>>;
+
+/**
+ * @brief FlatHashMap whose table is counted under a MemoryTag.
+ */
+template <typename K, typename V, MemoryTag Tag, typename Hash = FlatHash<K>, typename Eq = std::equal_to<>>
+using TrackedFlatHashMap = FlatHashMap<K, V, Hash, Eq, TrackingAllocator<std::pair<K, V>, Tag>>;
+
+} // namespace gouda
@@ -0,0 +1,134 @@
+#pragma once
+/**
+ * @file memory/memory_tracker.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine per subsystem memory accounting
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <array>
+#include <atomic>
+
+#include "core/types.hpp"
+
+namespace gouda {
+
+enum class MemoryTag : u8 { General, Renderer, Textures, Audio, Scene };
+inline constexpr size_t MEMORY_TAG_COUNT{static_cast<size_t>(MemoryTag::Scene) + 1};
+
+/**
+ * @struct MemoryTagStats
+ * @brief What one tag held at the start of the frame, and what it allocated during the frame before.
+ */
+struct MemoryTagStats {
+    u64 live_bytes{0};
+    u64 peak_bytes{0}; // Highest live_bytes ever reached, between frames included
+    u64 live_allocations{0};
+    u64 frame_allocations{0};
+    u64 frame_bytes{0};
+    u64 budget_bytes{0}; // Zero without a budget
+};
+
+/**
+ * @class MemoryTracker
+ * @brief Counts the bytes allocated through tracking allocators and tagged arenas, per subsystem.
+ *
+ * Allocations are recorded from any thread with relaxed atomics, each tag on its own cache line. Once per frame the
+ * main thread takes a snapshot for the debug panel, sends the live bytes of every tag to the profiler as counters,
+ * and warns when a tag goes over its budget or has kept growing for GROWTH_WARNING_WINDOWS windows of
+ * GROWTH_WINDOW_FRAMES frames, which is how a slow leak shows up in a long session. Only memory that goes through a
+ * tracked allocator is counted, untagged containers and third party allocations are not.
+ *
+ * The tracker holds nothing but counters, so allocators destroyed during static destruction may still record into it.
+ */
+class MemoryTracker {
+public:
+    static constexpr u32 GROWTH_WINDOW_FRAMES{3600};
+    static constexpr u32 GROWTH_WARNING_WINDOWS{10};
+
+    MemoryTracker(const MemoryTracker &) = delete;
+    MemoryTracker &operator=(const MemoryTracker &) = delete;
+
+    static MemoryTracker &Get()
+    {
+        static MemoryTracker instance;
+        return instance;
+    }
+
+    void RecordAllocation(const MemoryTag tag, const size_t bytes) noexcept
+    {
+        TagCounters &counters{m_counters[static_cast<size_t>(tag)]};
+        const u64 live{counters.live_bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes};
+        counters.live_allocations.fetch_add(1, std::memory_order_relaxed);
+        counters.frame_allocations.fetch_add(1, std::memory_order_relaxed);
+        counters.frame_bytes.fetch_add(bytes, std::memory_order_relaxed);
+
+        u64 peak{counters.peak_bytes.load(std::memory_order_relaxed)};
+        while (live > peak && !counters.peak_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+        }
+    }
+
+    /**
+     * @param count Allocations released together, for arenas that free their overflow blocks at once.
+     */
+    void RecordDeallocation(const MemoryTag tag, const size_t bytes, const u64 count = 1) noexcept
+    {
+        TagCounters &counters{m_counters[static_cast<size_t>(tag)]};
+        counters.live_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+        counters.live_allocations.fetch_sub(count, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Warns whenever the tag's live bytes go above the budget, zero removes it. Main thread only.
+     */
+    void SetBudget(MemoryTag tag, u64 bytes);
+
+    /**
+     * @brief Snapshots every tag, checks budgets and growth and writes the profiler counters, once per frame on the
+     * main thread.
+     */
+    void BeginFrame();
+
+    /**
+     * @brief Logs every tag's live and peak bytes, at shutdown what is still live was leaked or is owned by globals.
+     */
+    void LogSummary() const;
+
+    [[nodiscard]] const MemoryTagStats &GetStats(const MemoryTag tag) const noexcept
+    {
+        return m_stats[static_cast<size_t>(tag)];
+    }
+    [[nodiscard]] u64 GetTotalLiveBytes() const noexcept;
+
+    [[nodiscard]] static StringView GetTagName(MemoryTag tag);
+
+private:
+    struct alignas(64) TagCounters {
+        std::atomic<u64> live_bytes{0};
+        std::atomic<u64> peak_bytes{0};
+        std::atomic<u64> live_allocations{0};
+        std::atomic<u64> frame_allocations{0}; // Reset by BeginFrame
+        std::atomic<u64> frame_bytes{0};
+    };
+
+    struct TagHealth {
+        bool is_over_budget{false};
+        bool has_warned_growth{false};
+        u32 growing_windows{0}; // Consecutive windows that ended with more live bytes than they started with
+        u64 window_start_bytes{0};
+    };
+
+    MemoryTracker() = default;
+
+private:
+    std::array<TagCounters, MEMORY_TAG_COUNT> m_counters;
+    std::array<MemoryTagStats, MEMORY_TAG_COUNT> m_stats{};
+    std::array<TagHealth, MEMORY_TAG_COUNT> m_health{};
+    u64 m_frame_number{0};
+};
+
+} // namespace gouda
@@ -0,0 +1,150 @@
+#pragma once
+/**
+ * @file renderers/particle_store.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine CPU particle simulation module
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <vector>
+
+#include "containers/small_vector.hpp"
+#include "core/types.hpp"
+#include "math/math.hpp"
+#include "renderers/render_data.hpp"
+
+namespace gouda {
+
+/**
+ * @class ParticleStore
+ * @brief Structure of arrays particle storage for the CPU simulation path.
+ *
+ * The attributes touched every step (position, velocity, lifetime) are kept in separate float arrays so the
+ * integration kernel from math/simd_kernels.hpp runs over full SIMD registers. Dead particles are removed by
+ * swapping in the last particle, so the order of particles is not preserved. Conversion to the GPU ParticleData
+ * layout only happens in WriteRenderData.
+ */
+class ParticleStore {
+public:
+    /**
+     * @brief Constructs an empty store.
+     * @param fade_time Lifetime in seconds at which a particle starts fading out.
+     */
+    explicit ParticleStore(f32 fade_time = DEFAULT_FADE_TIME);
+
+    /**
+     * @brief Reserves space for a number of particles in every attribute array.
+     */
+    void Reserve(size_t capacity);
+
+    /**
+     * @brief Adds a particle.
+     */
+    void Spawn(const ParticleData &particle);
+
+    /**
+     * @brief Integrates all particles and removes the ones whose lifetime ran out.
+     * @param delta_time Step in seconds.
+     * @param gravity Acceleration applied to every particle.
+     */
+    void Update(f32 delta_time, const Vec3 &gravity);
+
+    /**
+     * @brief Pushes the particles around by noise drifting over time, matching Renderer::SetParticleTurbulence.
+     * @param strength Acceleration at full noise, 0 turns it off.
+     * @param frequency Noise cells per world unit, 0 turns it off.
+     */
+    void SetTurbulence(f32 strength, f32 frequency);
+
+    /**
+     * @brief Writes the particles in the GPU instance layout, replacing the contents of out.
+     */
+    void WriteRenderData(std::vector<ParticleData> &out) const;
+
+    void Clear();
+
+    [[nodiscard]] size_t Size() const noexcept { return m_lifetime.size(); }
+    [[nodiscard]] bool IsEmpty() const noexcept { return m_lifetime.empty(); }
+    [[nodiscard]] f32 GetFadeTime() const noexcept { return m_fade_time; }
+
+    /**
+     * @brief Calls visitor with every attribute array, always in the same order, for saving and restoring the
+     * particles as they are.
+     */
+    template <typename Visitor>
+    void VisitColumns(Visitor &&visitor) const
+    {
+        VisitColumnsOf(*this, visitor);
+    }
+    template <typename Visitor>
+    void VisitColumns(Visitor &&visitor)
+    {
+        VisitColumnsOf(*this, visitor);
+    }
+
+    /**
+     * @brief Whether arrays restored through VisitColumns are all the same length, the store must not be used
+     * otherwise.
+     */
+    [[nodiscard]] bool IsConsistent() const;
+
+    static constexpr f32 DEFAULT_FADE_TIME{5.0f};
+
+private:
+    void ApplyTurbulence(f32 delta_time);
+    void Integrate(f32 delta_time, const Vec3 &gravity);
+    void RemoveDead();
+    void SwapRemove(size_t index);
+
+    template <typename Self, typename Visitor>
+    static void VisitColumnsOf(Self &self, Visitor &visitor)
+    {
+        visitor(self.m_position_x);
+        visitor(self.m_position_y);
+        visitor(self.m_position_z);
+        visitor(self.m_velocity_x);
+        visitor(self.m_velocity_y);
+        visitor(self.m_velocity_z);
+        visitor(self.m_lifetime);
+        visitor(self.m_size);
+        visitor(self.m_colour);
+        visitor(self.m_sprite_rect);
+        visitor(self.m_texture_index);
+        visitor(self.m_is_atlas);
+        visitor(self.m_apply_camera_effects);
+    }
+
+private:
+    f32 m_fade_time;
+
+    // Hot attributes, one array per component
+    Vector<f32> m_position_x;
+    Vector<f32> m_position_y;
+    Vector<f32> m_position_z;
+    Vector<f32> m_velocity_x;
+    Vector<f32> m_velocity_y;
+    Vector<f32> m_velocity_z;
+    Vector<f32> m_lifetime;
+
+    // Cold attributes, only read when writing render data
+    Vector<Vec2> m_size;
+    Vector<Vec4> m_colour;
+    Vector<UVRect<f32>> m_sprite_rect;
+    Vector<u32> m_texture_index;
+    Vector<u32> m_is_atlas;
+    Vector<u32> m_apply_camera_effects;
+
+    // Turbulence, the noise is sampled into scratch columns not saved with the particles
+    f32 m_turbulence_strength;
+    f32 m_turbulence_frequency;
+    f32 m_turbulence_time; // Wrapped like SimulationParams::turbulence_time
+    Vector<f32> m_noise_x;
+    Vector<f32> m_noise_y;
+    Vector<f32> m_noise;
+};
+
+} // namespace gouda
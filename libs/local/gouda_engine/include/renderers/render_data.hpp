@@ -16,6 +16,9 @@
 
 namespace gouda {
 
+// Regions of the window Renderer::SetViewports can split the world into, the cull shaders mirror it
+constexpr u32 MAX_VIEWPORTS{4};
+
 struct Vertex {
     Vertex(const Vec3 &pos, const Vec2 &tex_coords) : position{pos}, uv{tex_coords} {}
 
@@ -30,12 +33,32 @@ struct alignas(16) UniformData {
     Mat4 wvp_static; // World view matrix without camera effects applied.
 };
 
+/// Selects the quad pipeline an instance is drawn with, see RenderQueue
+enum class BlendMode : u32 {
+    Opaque,    // Depth tested and written, never discards so early depth testing always applies
+    AlphaTest, // Like Opaque, but texels with alpha below one half are discarded
+    Alpha,     // Blended over what is behind it, depth tested only
+};
+
+/// Analytic shape a quad is drawn as instead of a texture, its signed distance is evaluated per fragment
+enum class QuadShape : u32 {
+    None,   // Textured quad
+    Rect,   // The quad with rounded corners
+    Circle, // Of the quad's smaller half extent, centred, a capsule along the longer side of a quad that is no square
+    Line,   // Segment between two points inside the quad, with round caps
+    Grid,   // Lines along world multiples of a cell size, a hairline width in pixels at any zoom
+};
+
 struct InstanceData {
+    static constexpr u32 NO_ANIMATION{constants::u32_max};
+    static constexpr u32 NO_TEXTURE_LAYER{constants::u32_max};
+
     InstanceData();
     InstanceData(const Vec3 &position, const Vec2 &size, f32 rotation, u32 texture_index,
                  const Colour<f32> &colour = Colour(1.0f),
                  const UVRect<f32> &sprite_rect = UVRect{0.0f, 0.0f, 0.0f, 0.0f}, u32 is_atlas = 0,
-                 u32 apply_camera_effects_ = 1); // Default to true for camera effects
+                 u32 apply_camera_effects_ = 1, // Default to true for camera effects
+                 BlendMode blend_mode = BlendMode::Opaque);
 
     Vec3 position; // 12 bytes, VK_FORMAT_R32G32B32_SFLOAT
     f32 _pad0;     // 4 bytes padding for alignment
@@ -49,35 +72,170 @@ struct InstanceData {
 
     u32 is_atlas;             // 4 bytes, VK_FORMAT_R32_UINT
     u32 apply_camera_effects; // offset 100, total = 112
-    u32 _pad1[4];             // 12 bytes padding to align to 16-byte boundary
+    BlendMode blend_mode;     // 4 bytes, CPU side only, read by the render queue
+
+    // Clip of the frame tables given to Renderer::SetAnimationClips, evaluated by the quad vertex shader in place of
+    // sprite_rect. The start is in the clock given to Renderer::SetAnimationTime.
+    u32 animation_clip;       // 4 bytes, NO_ANIMATION draws sprite_rect
+    f32 animation_start_time; // 4 bytes
+
+    // Layer of the texture array given by texture_index, see Renderer::LoadTextureArray. The whole layer is drawn,
+    // sprite_rect, is_atlas and animation_clip are ignored. NO_TEXTURE_LAYER draws the texture texture_index.
+    u32 texture_layer; // 4 bytes
+
+    // Distance field range in atlas pixels of an MSDF glyph, as laid out by Renderer::DrawText. Glyphs are atlas
+    // quads whose texels are decoded as a signed distance, they are never rotated or animated. 0 for any other quad.
+    f32 distance_range; // 4 bytes
+
+    // Drawn without any texture fetch, edges are antialiased so shapes are usually alpha blended. Shapes are never
+    // rotated or animated, texture_index and is_atlas are ignored. Line endpoints are the sprite_rect's (u_min, v_min)
+    // and (u_max, v_max), as fractions of the quad. A Grid's cells per major line is the sprite_rect's u_min. See
+    // make_rect_shape and the others below.
+    QuadShape shape;    // 4 bytes
+    f32 corner_radius;  // 4 bytes, of a Rect, the cell size of a Grid
+    f32 stroke_width;   // 4 bytes, outline of a Rect or Circle inside its edge, 0 fills it. The width of a Line, in
+                        // pixels for a Grid.
 };
 
-struct alignas(16) TextData {
-    TextData();
+[[nodiscard]] InstanceData make_rect_shape(const Vec3 &position, const Vec2 &size, const Colour<f32> &colour,
+                                           f32 corner_radius = 0.0f, f32 stroke_width = 0.0f,
+                                           bool apply_camera_effects = false);
+[[nodiscard]] InstanceData make_circle_shape(const Vec3 &center, f32 radius, const Colour<f32> &colour,
+                                             f32 stroke_width = 0.0f, bool apply_camera_effects = false);
+// The quad is the segment's bounds grown by half the width, depth is its z
+[[nodiscard]] InstanceData make_line_shape(const Vec2 &from, const Vec2 &to, f32 depth, f32 width,
+                                           const Colour<f32> &colour, bool apply_camera_effects = false);
+// One quad for any number of lines, usually the camera's view. Cells too small to see fade out, every major_interval
+// lines are drawn brighter and stay once the others faded, 0 draws none. Positioned in the world, camera effects apply.
+[[nodiscard]] InstanceData make_grid_shape(const Vec3 &position, const Vec2 &size, f32 cell_size,
+                                           const Colour<f32> &colour, u32 major_interval = 0, f32 line_width = 1.0f);
 
-    Vec3 position; // 12 bytes, VK_FORMAT_R32G32B32_SFLOAT
-    f32 _pad0;     // 4 bytes padding
+/**
+ * @struct QuadInstance
+ * @brief A quad instance as the GPU reads it, packed from InstanceData by the renderer when it is uploaded.
+ *
+ * Sizes and rotations are half floats, sprite rects are 16 bit and colours 8 bit normalized, which the vertex input
+ * unpacks for free. The texture index shares its 16 bits with the three flags. Blend modes stay on the CPU.
+ *
+ * Animated instances carry their clip id in the first sprite rect component and the bits of their start time in the
+ * last two instead of a rect, the vertex shader looks the frame up. Texture array instances set texture_array_bit,
+ * the index bits below it are the array id and the first sprite rect component the layer. MSDF glyphs set msdf_bits,
+ * a combination arrays never use as they ignore is_atlas, and carry their distance range in the rotation. Shapes set
+ * shape_bits, as arrays ignore animation too, with the QuadShape in the index bits. Their stroke width is the rotation
+ * and the first sprite rect component the half float corner radius of a rect or cell size of a grid, the second the
+ * half float major interval of a grid. Lines keep their endpoints.
+ */
+struct QuadInstance {
+    static constexpr u16 texture_index_mask{0x1FFF};
+    static constexpr u16 texture_array_bit{1u << 12}; // Part of the index, textures and arrays use 12 bits each
+    static constexpr u16 is_animated_bit{1u << 13};
+    static constexpr u16 is_atlas_bit{1u << 14};
+    static constexpr u16 apply_camera_effects_bit{1u << 15};
+    static constexpr u16 msdf_bits{texture_array_bit | is_atlas_bit};
+    static constexpr u16 shape_bits{texture_array_bit | is_animated_bit};
 
-    Vec2 size;       // 8 bytes, VK_FORMAT_R32G32_SFLOAT
-    f32 _pad1;       // 4 bytes padding
-    u32 glyph_index; // 4 bytes, VK_FORMAT_R32_UINT
+    QuadInstance() = default;
+    explicit QuadInstance(const InstanceData &instance);
 
-    Colour<f32> colour;     // 16 bytes, VK_FORMAT_R32G32B32A32_SFLOAT
-    UVRect<f32> sdf_params; // 16 bytes, VK_FORMAT_R32G32B32A32_SFLOAT
+    Vec3 position;      // offset 0, VK_FORMAT_R32G32B32_SFLOAT
+    u16 size[2];        // offset 12, VK_FORMAT_R16G16_SFLOAT
+    u16 rotation;       // offset 16, VK_FORMAT_R16_SFLOAT, wrapped to [-pi, pi], MSDF distance range, stroke width
+    u16 texture_flags;  // offset 18, VK_FORMAT_R16_UINT, texture index and flags
+    u32 colour;         // offset 20, VK_FORMAT_R8G8B8A8_UNORM
+    u16 sprite_rect[4]; // offset 24, VK_FORMAT_R16G16B16A16_UNORM, total = 32
+};
 
-    u32 texture_index;        // 4 bytes, VK_FORMAT_R32_UINT
-    Vec2 atlas_size;          // 8 bytes, VK_FORMAT_R32G32_SFLOAT
-    f32 px_range;             // 4 bytes, VK_FORMAT_R32_SFLOAT
-    u32 apply_camera_effects; // offset 100, total = 112
+// A clip of the animation frame tables, mirrors the quad vertex shader
+struct AnimationClipData {
+    u32 first_frame; // offset 0, into the frame table
+    u32 frame_count; // offset 4
+    f32 duration;    // offset 8, seconds for one pass through the frames
+    u32 next_clip;   // offset 12, played once a clip that does not loop ends, u32 max holds the last frame
+    u32 looping;     // offset 16
+    u32 _pad0[3]{};  // offset 20 → pad to 32
+    // Total: 32 bytes
+};
+
+struct AnimationFrameData {
+    UVRect<f32> sprite_rect; // offset 0
+    f32 end;                 // offset 16, seconds from the start of the clip to the end of the frame
+    f32 _pad0[3]{};          // offset 20 → pad to 32
+    // Total: 32 bytes
 };
 
 struct SimulationParams {
     SimulationParams();
     SimulationParams(const Vec3 &gravity, f32 delta_time);
 
-    Vec3 gravity;   // 12 bytes, VK_FORMAT_R32G32B32_SFLOAT
-    f32 delta_time; // 4 bytes, VK_FORMAT_R32_SFLOAT
-    // Total: 16 bytes
+    Vec3 gravity;       // 12 bytes, VK_FORMAT_R32G32B32_SFLOAT
+    f32 delta_time;     // 4 bytes, VK_FORMAT_R32_SFLOAT
+    u32 spawn_count;    // offset 16, particles in this frame's spawn buffer
+    u32 sort_by_depth;  // offset 20, live particles are radix sorted back to front before they are drawn
+    u32 collider_count; // offset 24, static colliders the particles bounce off, 0 skips collision
+    f32 restitution;    // offset 28, of the velocity into a collider's face kept after a bounce
+
+    Vec2 collision_origin;      // offset 32, world space minimum of the collision grid
+    UVec2 collision_cell_count; // offset 40
+    f32 collision_cell_size;    // offset 48
+    f32 turbulence_strength;    // offset 52, acceleration at full noise, 0 skips the noise
+    f32 turbulence_frequency;   // offset 56, noise cells per world unit
+    f32 turbulence_time;        // offset 60, seconds the noise drifted for, wrapped at PARTICLE_TURBULENCE_TIME_WRAP
+    // Total: 64 bytes
+};
+
+// Particle turbulence is fractal Perlin noise, see math/noise.hpp, scrolled along x over time. One sample per axis
+// with its own seed pushes the particles, the same on the CPU path and in particle_shader.comp.
+constexpr u32 PARTICLE_TURBULENCE_OCTAVES{2};
+constexpr u32 PARTICLE_TURBULENCE_SEED_X{0};
+constexpr u32 PARTICLE_TURBULENCE_SEED_Y{16};
+constexpr f32 PARTICLE_TURBULENCE_SCROLL_RATE{0.5f}; // Noise cells a second
+constexpr f32 PARTICLE_TURBULENCE_TIME_WRAP{1024.0f}; // Keeps the scrolled coordinates precise
+
+struct CullParams {
+    CullParams();
+
+    Vec4 views[MAX_VIEWPORTS]; // offset 0, world space bounds of each viewport's camera, min xy then max xy
+    u32 instance_count;        // offset 64, static quads resident on the GPU
+    u32 viewport_count;        // offset 68
+    u32 visible_capacity;      // offset 72, instances in each viewport's region of the visible buffer
+    u32 _pad0{};               // offset 76 → pad to 80
+    // Total: 80 bytes
+};
+
+// A light in world space, lighting the quads drawn with camera effects within radius of it
+struct PointLight {
+    PointLight();
+    PointLight(const Vec2 &position_, f32 radius_, const Colour<f32> &colour_, f32 intensity_ = 1.0f);
+
+    Vec2 position;      // offset 0
+    f32 radius;         // offset 8, falls off to nothing here
+    f32 intensity;      // offset 12
+    Colour<f32> colour; // offset 16, alpha is ignored
+    // Total: 32 bytes
+};
+
+struct alignas(16) LightParams {
+    LightParams();
+
+    Vec2 framebuffer_size; // offset 0
+    u32 tile_size;         // offset 8, in pixels
+    u32 light_count;       // offset 12
+    UVec2 tile_count;      // offset 16
+    u32 viewport_count;    // offset 24
+    u32 _pad0{};           // offset 28 → pad to 32
+    Colour<f32> ambient;   // offset 32, what lit quads get with no light on them
+    // Each viewport's scene camera and its pixels in the world target, x, y, width and height. Lights move with
+    // camera effects, a tile collects the lights of every viewport it overlaps.
+    Mat4 viewport_wvps[MAX_VIEWPORTS];  // offset 48
+    Vec4 viewport_rects[MAX_VIEWPORTS]; // offset 304
+    // Total: 368 bytes
+};
+
+// Push constants of the upscale pass
+struct UpscaleParams {
+    Vec2 texel_size; // offset 0, of the image the world was rendered to
+    f32 sharpness;   // offset 8, 0 leaves plain bilinear filtering
+    // Total: 12 bytes
 };
 
 struct alignas(16) ParticleData {
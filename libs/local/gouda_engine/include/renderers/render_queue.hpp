@@ -0,0 +1,88 @@
+#pragma once
+/**
+ * @file renderers/render_queue.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine sorted quad submission module
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <span>
+
+#include "containers/small_vector.hpp"
+#include "core/types.hpp"
+#include "renderers/render_data.hpp"
+
+namespace gouda {
+
+/**
+ * @struct DrawBatch
+ * @brief A run of sorted instances drawn with one pipeline in a single instanced draw.
+ */
+struct DrawBatch {
+    BlendMode blend_mode;
+    u32 first_instance;
+    u32 instance_count;
+};
+
+/**
+ * @class RenderQueue
+ * @brief Sorts quad instances by a packed key and splits them into the fewest draws.
+ *
+ * The key orders by layer band (the Z ranges in notes.txt, back to front), then pipeline, then texture and depth.
+ * Opaque and alpha tested instances go front to back within a band to let the depth test reject overdraw, alpha
+ * blended instances go back to front so they composite correctly, in submission order where their depths are equal.
+ * Textures are bindless, so only a pipeline change ends a batch. Text glyphs are alpha blended quads like any other,
+ * UI panels and their labels sort into one run.
+ *
+ * Instances tinted with an alpha below one are blended whatever blend mode they were submitted with, see Classify.
+ */
+class RenderQueue {
+public:
+    static constexpr u32 LAYER_BAND_COUNT{8};
+    static constexpr u32 PIPELINE_COUNT{3}; // One per BlendMode
+    // A band holds at most one run per pipeline, so this bounds the batches of any frame
+    static constexpr u32 MAX_BATCH_COUNT{LAYER_BAND_COUNT * PIPELINE_COUNT};
+
+    /**
+     * @brief Computes the sort keys for this frame's instances, sorts them and builds the draw batches.
+     */
+    void Build(std::span<const InstanceData> instances);
+
+    /**
+     * @brief Packs the instances passed to Build and writes them in sorted order.
+     * @param out Destination with room for instances.size() elements, usually the mapped instance buffer.
+     */
+    void WriteInstances(std::span<const InstanceData> instances, QuadInstance *out) const;
+
+    [[nodiscard]] std::span<const DrawBatch> GetBatches() const noexcept { return m_batches; }
+
+    /**
+     * @brief Packs the ordering of an instance into a 64 bit key. Smaller keys are drawn first.
+     */
+    [[nodiscard]] static u64 MakeSortKey(const InstanceData &instance);
+
+    /**
+     * @brief The blend mode an instance is drawn with, its own unless a translucent tint forces blending.
+     */
+    [[nodiscard]] static BlendMode Classify(const InstanceData &instance);
+
+    /**
+     * @brief Maps a Z value to its layer band, 0 for the deepest background up to the UI overlay.
+     */
+    [[nodiscard]] static u32 GetLayerBand(f32 z);
+
+private:
+    struct SortEntry {
+        u64 key;
+        u32 index;
+    };
+
+    Vector<SortEntry> m_entries;
+    Vector<DrawBatch> m_batches;
+};
+
+} // namespace gouda
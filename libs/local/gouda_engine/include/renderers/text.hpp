@@ -20,10 +20,11 @@
  * You should have received a copy of the GNU Affero General Public License
  * along with this program. If not, see <https://www.gnu.org/licenses/>.
  */
-#include "containers/small_vector.hpp"
-
-#include <unordered_map>
+#include <array>
+#include <span>
 
+#include "containers/flat_hash_map.hpp"
+#include "containers/small_vector.hpp"
 #include "core/types.hpp"
 #include "math/math.hpp"
 
@@ -39,8 +40,6 @@ struct MSDFGlyph {
     Rect<f32> atlas_bounds;
 };
 
-using MSDFGlyphMap = std::unordered_map<char, MSDFGlyph>;
-
 struct alignas(16) MSDFKerningPair {
     MSDFKerningPair();
 
@@ -50,6 +49,52 @@ struct alignas(16) MSDFKerningPair {
     f32 _padding1;
 };
 
+// Glyphs by codepoint. ASCII lives in a dense array so the common lookup is a single index, anything above it falls
+// back to a hash map. Kerning pairs are hashed by codepoint pair when the font is loaded.
+class MSDFGlyphTable {
+public:
+    static constexpr u32 DENSE_GLYPH_COUNT{128};
+
+    MSDFGlyphTable();
+
+    void Insert(u32 codepoint, const MSDFGlyph &glyph);
+    void SetKerning(std::span<const MSDFKerningPair> pairs);
+
+    [[nodiscard]] const MSDFGlyph *Find(const u32 codepoint) const
+    {
+        if (codepoint < DENSE_GLYPH_COUNT) {
+            return m_dense_present[codepoint] ? &m_dense_glyphs[codepoint] : nullptr;
+        }
+        return m_sparse_glyphs.get(codepoint);
+    }
+
+    // Advance adjustment in em units between two consecutive codepoints, zero for pairs without kerning
+    [[nodiscard]] f32 GetKerning(const u32 first, const u32 second) const
+    {
+        if (m_kerning.empty()) {
+            return 0.0f;
+        }
+        const f32 *advance{m_kerning.get(KerningKey(first, second))};
+        return advance != nullptr ? *advance : 0.0f;
+    }
+
+    [[nodiscard]] size_t Size() const noexcept { return m_dense_count + m_sparse_glyphs.size(); }
+    [[nodiscard]] bool IsEmpty() const noexcept { return Size() == 0; }
+
+private:
+    [[nodiscard]] static constexpr u64 KerningKey(const u32 first, const u32 second) noexcept
+    {
+        return (static_cast<u64>(first) << 32) | second;
+    }
+
+private:
+    std::array<MSDFGlyph, DENSE_GLYPH_COUNT> m_dense_glyphs;
+    std::array<bool, DENSE_GLYPH_COUNT> m_dense_present;
+    FlatHashMap<u32, MSDFGlyph> m_sparse_glyphs;
+    FlatHashMap<u64, f32> m_kerning;
+    size_t m_dense_count;
+};
+
 struct alignas(16) MSDFAtlasParams {
     MSDFAtlasParams();
 
@@ -76,7 +121,7 @@ struct alignas(16) MSDFAtlasParams {
     u32 _padding2;   // pad to next 16-byte boundary
 };
 
-std::unordered_map<char, MSDFGlyph> load_msdf_glyphs(StringView json_path);
+MSDFGlyphTable load_msdf_glyphs(StringView json_path);
 
 MSDFAtlasParams load_msdf_atlas_params(StringView json_path);
 
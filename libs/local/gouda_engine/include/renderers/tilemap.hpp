@@ -0,0 +1,92 @@
+#pragma once
+/**
+ * @file renderers/tilemap.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine chunked tilemap module
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <span>
+#include <vector>
+
+#include "containers/small_vector.hpp"
+#include "core/types.hpp"
+#include "math/collision.hpp"
+#include "math/math.hpp"
+#include "renderers/render_data.hpp"
+
+namespace gouda {
+
+namespace vk {
+struct Sprite;
+}
+
+// A square block of tiles drawn as one contiguous range of instances
+struct TilemapChunk {
+    math::AABB2D bounds; // World space, of the whole chunk cell
+    u32 first_instance;  // Into the instances the chunks were built with
+    u32 instance_count;  // Of the chunk's non empty tiles
+};
+
+/**
+ * @class Tilemap
+ * @brief A grid of tiles from one texture atlas, each a sprite of the map's palette or empty.
+ *
+ * Tiles are stored row major as palette indices, so a map costs two bytes per tile until it is built. BuildChunks
+ * splits it into square chunks and writes the instances of every chunk contiguously, chunks in row major order, which
+ * the renderer uploads once and culls chunk by chunk. Tile (0, 0) has its minimum corner at the origin.
+ */
+class Tilemap {
+public:
+    static constexpr u16 EMPTY_TILE{0xFFFF};
+    static constexpr u32 DEFAULT_CHUNK_SIZE{32};
+
+    Tilemap();
+    Tilemap(u32 width, u32 height, const Vec2 &tile_size, const Vec3 &origin, u32 texture_index);
+
+    /**
+     * @brief Adds a sprite tiles can refer to, atlas sprites with several frames use their first.
+     * @return Palette index of the sprite, EMPTY_TILE when the palette is full.
+     */
+    u16 AddSprite(const vk::Sprite &sprite);
+    u16 AddSprite(const UVRect<f32> &sprite_rect);
+    void SetSprite(u16 sprite, const UVRect<f32> &sprite_rect); // For a reloaded atlas, the chunks need building again
+
+    // Out of range tiles are ignored by SetTile and read as empty by GetTile
+    void SetTile(u32 x, u32 y, u16 sprite);
+    [[nodiscard]] u16 GetTile(u32 x, u32 y) const;
+    void Fill(u16 sprite);
+
+    /**
+     * @brief Writes the instances of every chunk holding a tile, replacing the contents of instances and chunks.
+     * @param chunk_size Tiles along each side of a chunk.
+     */
+    void BuildChunks(u32 chunk_size, std::vector<InstanceData> &instances, Vector<TilemapChunk> &chunks) const;
+
+    [[nodiscard]] u32 GetWidth() const noexcept { return m_width; }
+    [[nodiscard]] u32 GetHeight() const noexcept { return m_height; }
+    [[nodiscard]] const Vec2 &GetTileSize() const noexcept { return m_tile_size; }
+    [[nodiscard]] const Vec3 &GetOrigin() const noexcept { return m_origin; }
+    [[nodiscard]] u32 GetTextureIndex() const noexcept { return m_texture_index; }
+    [[nodiscard]] std::span<const UVRect<f32>> GetSprites() const noexcept
+    {
+        return {m_sprites.data(), m_sprites.size()};
+    }
+    [[nodiscard]] std::span<const u16> GetTiles() const noexcept { return m_tiles; } // Row major
+    [[nodiscard]] bool IsEmpty() const noexcept { return m_tiles.empty(); }
+
+private:
+    u32 m_width;
+    u32 m_height;
+    Vec2 m_tile_size;
+    Vec3 m_origin; // The z is the depth every tile is drawn at
+    u32 m_texture_index;
+    Vector<UVRect<f32>> m_sprites;
+    std::vector<u16> m_tiles;
+};
+
+} // namespace gouda
@@ -7,6 +7,10 @@ namespace gouda::vk {
 
 void BeginCommandBuffer(VkCommandBuffer command_buffer, VkCommandBufferUsageFlags usage_flags);
 
+// Begins a secondary command buffer that continues a dynamic rendering pass described by rendering_info
+void BeginSecondaryCommandBuffer(VkCommandBuffer command_buffer,
+                                 const VkCommandBufferInheritanceRenderingInfo &rendering_info);
+
 void EndCommandBuffer(VkCommandBuffer command_buffer);
 
 void CreateSemaphore(VkDevice device, VkSemaphore &semaphore);
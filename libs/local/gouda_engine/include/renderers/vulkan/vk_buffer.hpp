@@ -12,17 +12,28 @@
  */
 #include <vulkan/vulkan.h>
 
+#include "renderers/vulkan/vk_memory_allocator.hpp"
+
 namespace gouda::vk {
 
+/**
+ * @struct Buffer
+ * @brief A buffer and its memory. Host visible memory stays mapped for the buffer's whole lifetime.
+ *
+ * Writes through the mapping are flushed with Flush, reads of device writes are preceded by Invalidate. Both only
+ * reach the driver for memory types that are not host coherent.
+ */
 struct Buffer {
     Buffer();
 
-    void *MapPersistent(VkDevice device) const;
-    void Update(VkDevice device, const void *data, size_t size) const;
+    [[nodiscard]] void *GetMapped() const noexcept { return m_allocation.p_mapped; } ///< Null unless host visible
+    void Update(const void *data, size_t size, VkDeviceSize offset = 0) const;       ///< Copies and flushes
+    void Flush(VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE) const;
+    void Invalidate(VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE) const;
     void Destroy(VkDevice device);
 
     VkBuffer p_buffer;
-    VkDeviceMemory p_memory;
+    MemoryAllocation m_allocation;
     VkDeviceSize m_allocation_size;
 };
 
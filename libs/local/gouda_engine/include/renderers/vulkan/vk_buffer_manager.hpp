@@ -11,49 +11,88 @@
  * See <https://www.gnu.org/licenses/> for more information.
  */
 #include <memory>
+#include <span>
+#include <variant>
 
 #include <vulkan/vulkan.h>
 
+#include "containers/small_vector.hpp"
 #include "core/types.hpp"
+#include "renderers/vulkan/vk_buffer.hpp"
+#include "renderers/vulkan/vk_ktx2.hpp"
+#include "renderers/vulkan/vk_sampler_cache.hpp"
+#include "renderers/vulkan/vk_staging_ring.hpp"
+#include "utils/image.hpp"
 
 namespace gouda::vk {
 
-class Buffer;
 class CommandBufferManager;
-class Fence;
 class Texture;
 class Device;
 class Queue;
 
+// Pass as the mip count of a texture to get every level down to 1x1
+constexpr u32 FULL_MIP_CHAIN{0};
+
+// Identifies the batch an upload was recorded into, all uploads in a batch complete together
+struct UploadHandle {
+    u64 m_batch_id{0};
+};
+
+// Texture data read from disk and ready for upload, RGBA8 pixels or a GPU ready (block compressed) KTX2 container
+using TextureSource = std::variant<Image, KTX2File>;
+
 class BufferManager {
 public:
-    BufferManager(Device* device, Queue* queue, CommandBufferManager* command_buffer_manager);
+    // When a transfer queue is given, staged copies run on it and ownership is handed to the graphics queue
+    BufferManager(Device* device, Queue* queue, CommandBufferManager* command_buffer_manager,
+                  Queue *transfer_queue = nullptr, CommandBufferManager *transfer_command_buffer_manager = nullptr);
     ~BufferManager();
 
-    // Create a generic buffer with specified usage and properties
-    [[nodiscard]] Buffer CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties) const;
+    // Create a generic buffer with specified usage and properties. Passing more than one queue family makes the buffer
+    // shared concurrently between them, so it can be used on several queues without ownership transfers. Preferred
+    // properties are dropped when no memory type has them on top of the required ones.
+    [[nodiscard]] Buffer CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties,
+                                      std::span<const u32> queue_families = {},
+                                      VkMemoryPropertyFlags preferred_properties = 0) const;
 
     // Create a vertex buffer with staging
     [[nodiscard]] Buffer CreateVertexBuffer(const void *data, VkDeviceSize size) const;
 
+    // The dynamic, uniform and storage buffers are written by the CPU every frame. They live in device local memory
+    // when the whole of it is host visible (resizable BAR or a unified memory device), in system memory otherwise.
     [[nodiscard]] Buffer CreateDynamicVertexBuffer(VkDeviceSize size) const;
+    [[nodiscard]] Buffer CreateDynamicIndirectBuffer(VkDeviceSize size) const;
 
     // Create a uniform buffer
-    [[nodiscard]] Buffer CreateUniformBuffer(size_t size) const;
+    [[nodiscard]] Buffer CreateUniformBuffer(size_t size, std::span<const u32> queue_families = {}) const;
 
     // Create an index buffer
     [[nodiscard]] Buffer CreateIndexBuffer(const void *data, VkDeviceSize size) const;
 
     // Create a storage buffer
-    [[nodiscard]] Buffer CreateStorageBuffer(VkDeviceSize size, VkBufferUsageFlags additional_usage = 0) const;
+    [[nodiscard]] Buffer CreateStorageBuffer(VkDeviceSize size, VkBufferUsageFlags additional_usage = 0,
+                                             std::span<const u32> queue_families = {}) const;
 
     // Create and allocate memory for an image
     void CreateImage(Texture &texture, const VkImageCreateInfo &image_info, VkMemoryPropertyFlags memory_properties) const;
 
     void CreateDepthImage(Texture &texture, ImageSize size, VkFormat format) const;
 
-    // Utility to copy data between buffers
-    void CopyBufferToBuffer(VkBuffer destination, VkBuffer source, VkDeviceSize size, VkCommandBuffer command_buffer) const;
+    // Utility to copy data between buffers, recorded into the current upload batch
+    void CopyBufferToBuffer(VkBuffer destination, VkBuffer source, VkDeviceSize size, VkDeviceSize source_offset = 0,
+                            VkDeviceSize destination_offset = 0) const;
+
+    // Async uploads. Data is copied into the staging ring immediately, the GPU copy is recorded into the current
+    // batch and submitted by FlushUploads. Work submitted to the graphics queue afterwards sees the uploaded data.
+    // With a transfer queue the copy waits for the graphics work submitted before the flush, as image re-uploads do,
+    // so the destination range may still be in use.
+    UploadHandle UploadBufferData(VkBuffer destination, const void *data, VkDeviceSize size,
+                                  VkDeviceSize destination_offset = 0) const;
+    UploadHandle FlushUploads() const;
+    [[nodiscard]] bool IsUploadComplete(UploadHandle handle) const;
+    void WaitForUpload(UploadHandle handle) const;
+    void RetireUploads() const;
 
     void CreateTextureImageFromData(Texture &texture, const void *pixels_ptr, ImageSize image_size,
                                     VkFormat texture_format, u32 layer_count, VkImageCreateFlags create_flags) const;
@@ -62,37 +101,125 @@ public:
     [[nodiscard]] std::unique_ptr<Texture> CreateTexture(StringView file_name, u32 mips = 1, u32 layers = 1) const;
     [[nodiscard]] std::unique_ptr<Texture> CreateTexture(StringView file_name, u32 mips, u32 layers, VkImageCreateFlags create_flags,
                                            VkFilter filter) const;
+    // Reads a texture without touching the GPU, so it can run on worker threads. A KTX2 file whose format the
+    // device cannot sample falls back to the file with the same name and a .png extension.
+    [[nodiscard]] Expect<TextureSource, String> LoadTextureSource(StringView file_name) const;
+    // mips only applies to decoded images, KTX2 files bring their own levels
+    [[nodiscard]] std::unique_ptr<Texture> CreateTextureFromSource(const TextureSource &source, u32 mips = 1) const;
+    // Uploads an already decoded image, lets the decode happen off the render thread. Levels past the first are
+    // generated on the GPU, FULL_MIP_CHAIN generates all of them.
+    [[nodiscard]] std::unique_ptr<Texture> CreateTextureFromImage(const Image &image, u32 mips = 1,
+                                                                  u32 layers = 1) const;
+    // Packs images of one size and channel count into the layers of a 2D array texture, in order, mips are
+    // generated as for CreateTextureFromImage
+    [[nodiscard]] std::unique_ptr<Texture> CreateTextureArray(std::span<const Image> layers, u32 mips = 1) const;
+    // Uploads every level and layer of the container as is, the format must pass Device::IsFormatSupported
+    [[nodiscard]] std::unique_ptr<Texture> CreateTextureFromKTX2(const KTX2File &file) const;
     [[nodiscard]] std::unique_ptr<Texture> CreateDefaultTexture() const;
+    // A colour attachment that is sampled afterwards, its contents are undefined until it is first rendered to
+    [[nodiscard]] std::unique_ptr<Texture> CreateRenderTargetTexture(ImageSize size, VkFormat format) const;
 
     void CreateTextureImage(Texture &texture, ImageSize size, VkFormat format, u32 mipLevels, u32 layerCount,
                             VkImageCreateFlags flags) const;
-    void UpdateTextureImage(const Texture &texture, ImageSize size, VkFormat format, u32 layerCount, const void *data,
-                            VkImageLayout initialLayout) const;
-    void CopyBufferToImage(VkBuffer source, VkImage destination, ImageSize imageSize, u32 layerCount) const;
+    // data holds every layer, one after the other
+    UploadHandle UpdateTextureImage(const Texture &texture, ImageSize size, VkFormat format, u32 layerCount,
+                                    const void *data, VkImageLayout initialLayout) const;
+    // Overwrites row_count rows of the first level and layer of a sampled texture from first_row on, keeping the
+    // others. data holds the rows only. Recorded on the graphics queue even with a transfer queue, which would have to
+    // take the whole image over to keep its other rows.
+    UploadHandle UpdateTextureRows(const Texture &texture, ImageSize size, VkFormat format, u32 first_row,
+                                   u32 row_count, const void *data) const;
+    void CopyBufferToImage(VkBuffer source, VkImage destination, ImageSize imageSize, u32 layerCount,
+                           VkDeviceSize source_offset = 0) const;
     void TransitionImageLayout(VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout,
                                u32 layerCount, u32 mipLevels) const;
     [[nodiscard]] VkImageView CreateImageView(VkImage image, VkFormat format, VkImageAspectFlags aspectFlags,
                                 VkImageViewType viewType, u32 layerCount, u32 mipLevels) const;
-    [[nodiscard]] VkSampler CreateTextureSampler(VkFilter minFilter, VkFilter magFilter, VkSamplerAddressMode addressMode) const;
+    // Shared by every texture with the same state and owned by the cache, callers must not destroy it. The LOD range
+    // is unclamped, so the sampler reaches every level of whichever image it is used with.
+    [[nodiscard]] VkSampler GetTextureSampler(VkFilter min_filter, VkFilter mag_filter,
+                                              VkSamplerAddressMode address_mode) const;
+    [[nodiscard]] const SamplerCache &GetSamplerCache() const noexcept { return *p_sampler_cache; }
 
-private:
     // Helper to find suitable memory type
-    [[nodiscard]] Expect<u32, String> GetMemoryTypeIndex(u32 memory_type_bits, VkMemoryPropertyFlags required_properties) const;
+    [[nodiscard]] Expect<u32, String> GetMemoryTypeIndex(u32 memory_type_bits,
+                                                         VkMemoryPropertyFlags required_properties,
+                                                         VkMemoryPropertyFlags preferred_properties = 0) const;
 
-    // Command buffer management for staging
-    void BeginCommandBuffer(VkCommandBuffer command_buffer, VkCommandBufferUsageFlags usage) const;
-    void SubmitCopyCommand(VkCommandBuffer command_buffer) const;
+private:
+    // Image whose first level was uploaded and whose remaining levels are blitted from it
+    struct MipGeneration {
+        VkImage p_image;
+        ImageSize m_size;
+        u32 m_layer_count;
+        u32 m_mip_levels;
+    };
+
+    struct UploadBatch {
+        VkCommandBuffer p_command_buffer;         // Submitted to the upload queue
+        VkCommandBuffer p_acquire_command_buffer; // Graphics queue side of the batch, only used with a transfer queue
+        u64 m_batch_id;
+        u64 m_timeline_value;                     // Upload queue value, NO_TIMELINE_VALUE until submitted
+        u64 m_acquire_timeline_value;             // Graphics queue value of the acquire submission
+        bool m_waits_for_graphics;                // Overwrites resources the graphics queue may still be reading
+        bool m_graphics_reads_staging;            // The acquire submission copies from the staging ring
+        Vector<Buffer> m_dedicated_staging_buffers; // Uploads too large for the staging ring
+        Vector<VkBufferMemoryBarrier> m_buffer_releases;
+        Vector<VkImageMemoryBarrier> m_image_releases;
+        Vector<MipGeneration> m_mip_generations; // Blits recorded on the graphics side once the images are acquired
+    };
 
-    [[nodiscard]] Buffer CreateAndUploadStagingBuffer(const void *data, VkDeviceSize size) const;
+    // Command buffer management for staging
+    [[nodiscard]] VkCommandBuffer GetUploadCommandBuffer() const;
+    [[nodiscard]] VkCommandBuffer GetGraphicsCommandBuffer() const;
+    [[nodiscard]] const UploadBatch *FindUploadBatch(UploadHandle handle) const;
+    [[nodiscard]] bool IsBatchComplete(const UploadBatch &batch) const;
+    [[nodiscard]] u64 GetReclaimableStagingValue() const;
+    void WaitForBatch(const UploadBatch &batch) const;
+    void RecycleUploadBatch(UploadBatch &batch) const;
+    void RecordAcquireBarriers(const UploadBatch &batch) const;
+
+    // Records layout transitions and the copy of a full image, handing it to the graphics queue when needed
+    void RecordImageUpload(VkImage image, VkFormat format, VkImageLayout initial_layout,
+                           const StagingAllocation &staging, ImageSize size, u32 layer_count) const;
+    // Same for images with several mip levels, regions covers every level the image has
+    void RecordImageUpload(VkImage image, VkFormat format, VkImageLayout initial_layout, VkBuffer source,
+                           std::span<const VkBufferImageCopy> regions, u32 layer_count, u32 mip_levels) const;
+    // Creates, uploads and views a sampled texture, pixels holds every layer one after the other
+    [[nodiscard]] std::unique_ptr<Texture> CreateSampledTexture(const void *pixels, ImageSize size, VkFormat format,
+                                                                u32 mips, u32 layers, VkImageViewType view_type) const;
+    // Uploads the first level of a new image and generates the others, blits need a graphics queue command buffer
+    void RecordMipmappedImageUpload(VkImage image, VkFormat format, const StagingAllocation &staging, ImageSize size,
+                                    u32 layer_count, u32 mip_levels) const;
+    // Expects every level in TRANSFER_DST_OPTIMAL, leaves them all in SHADER_READ_ONLY_OPTIMAL
+    void RecordMipGeneration(VkCommandBuffer command_buffer, const MipGeneration &mip_generation) const;
+
+    // Copies data into staging memory. May flush the current batch, so call before GetUploadCommandBuffer.
+    [[nodiscard]] StagingAllocation StageData(const void *data, VkDeviceSize size) const;
 
 private:
+    static constexpr VkDeviceSize STAGING_RING_SIZE{32 * 1024 * 1024};
+    static constexpr VkDeviceSize STAGING_ALIGNMENT{16};
+    static constexpr u32 UPLOAD_BATCH_COUNT{4};
+    static constexpr VkPipelineStageFlags UPLOAD_CONSUMER_STAGES{
+        VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT};
+
     Device *p_device;
     Queue *p_queue;
     CommandBufferManager *p_command_buffer_manager;
+    Queue *p_transfer_queue;                          // Null when uploads go through the graphics queue
+    CommandBufferManager *p_transfer_command_buffer_manager;
+    Queue *p_upload_queue;                            // Transfer queue if present, graphics queue otherwise
+    // Preferred for the buffers the CPU writes every frame
+    VkMemoryPropertyFlags m_host_write_preferred_properties;
 
-    VkCommandBuffer p_copy_command_buffer;
     VkCommandPool p_command_pool;
-    std::unique_ptr<Fence> p_copy_fence;
+    std::unique_ptr<StagingRing> p_staging_ring;
+    std::unique_ptr<SamplerCache> p_sampler_cache;
+    mutable SmallVector<UploadBatch, UPLOAD_BATCH_COUNT> m_upload_batches;
+    mutable u32 m_recording_batch; // Index into m_upload_batches or u32_max when no batch is open
+    mutable u64 m_next_batch_id;
 };
 
 } // namespace gouda::vk
\ No newline at end of file
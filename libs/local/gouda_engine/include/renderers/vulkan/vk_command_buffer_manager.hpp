@@ -12,6 +12,7 @@
  */
 #include <vulkan/vulkan.h>
 
+#include "containers/small_vector.hpp"
 #include "core/types.hpp"
 
 namespace gouda::vk {
@@ -28,11 +29,28 @@ public:
     void AllocateBuffers(u32 count, VkCommandBuffer *buffers) const;
     void FreeBuffers(u32 count, const VkCommandBuffer *buffers) const;
 
+    // Secondary command buffers are recorded from worker threads. Command pools need external synchronization and
+    // are reset whole once the GPU retired their frame, so there is one pool per recording thread per frame in flight.
+    void CreateThreadPools(u32 thread_count, u32 frames_in_flight);
+    void DestroyThreadPools();
+    void AllocateSecondaryBuffers(u32 thread_index, u32 frame_index, u32 count, VkCommandBuffer *buffers) const;
+    // Resets every secondary buffer allocated for frame_index, the frame must no longer be in use by the GPU
+    void ResetThreadPools(u32 frame_index) const;
+    [[nodiscard]] u32 GetThreadPoolCount() const noexcept { return m_thread_count; }
+
+private:
+    [[nodiscard]] VkCommandPool GetThreadPool(u32 thread_index, u32 frame_index) const;
+
 private:
     Device *p_device;
     Queue *p_queue;
     u32 m_queue_family;
     VkCommandPool p_pool;
+
+    // Indexed by frame_index * m_thread_count + thread_index
+    Vector<VkCommandPool> m_thread_pools;
+    u32 m_thread_count;
+    u32 m_thread_pool_frames;
 };
 
 } // namespace gouda::vk
\ No newline at end of file
@@ -10,6 +10,9 @@
  * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
  * See <https://www.gnu.org/licenses/> for more information.
  */
+#include <cstddef>
+#include <span>
+
 #include <vulkan/vulkan.h>
 
 #include "core/types.hpp"
@@ -23,25 +26,46 @@ class Renderer;
 class Shader;
 class Device;
 
+// One descriptor binding of the compute set, bound to buffers[i] in descriptor set i. A single buffer is shared by
+// every set. The binding number and descriptor type come from the shader.
+struct ComputeBufferBinding {
+    std::span<const Buffer> buffers;
+    VkDeviceSize range;
+};
+
+/**
+ * @class ComputePipeline
+ * @brief A compute shader with its descriptor sets, laid out from the shader's reflection.
+ *
+ * Any compute shader whose set 0 holds only uniform and storage buffers can be used. The bindings are given in the
+ * order of the shader's binding numbers, their types are reflected. A push constant block declared by the shader is
+ * added to the layout, and dispatches can be sized in invocations from the reflected workgroup size.
+ */
 class ComputePipeline {
 public:
-    ComputePipeline(Renderer &renderer, Device *device,  const Shader *compute_shader, const Vector<Buffer> &storage_buffers,
-                    const Vector<Buffer> &uniform_buffers, VkDeviceSize storage_buffer_size,
-                    VkDeviceSize uniform_buffer_size);
+    // The set count is the largest buffer count of any binding
+    ComputePipeline(Renderer &renderer, Device *device, const Shader *compute_shader,
+                    std::span<const ComputeBufferBinding> bindings);
     ~ComputePipeline();
 
     void Bind(VkCommandBuffer command_buffer) const;
     void BindDescriptors(VkCommandBuffer command_buffer, u32 image_index) const;
+    void PushConstants(VkCommandBuffer command_buffer, const void *data, u32 size) const;
     void Dispatch(VkCommandBuffer command_buffer, const UVec3 &group_counts) const;
     void Destroy();
 
     [[nodiscard]] VkPipeline GetPipeline() const { return p_pipeline; }
     [[nodiscard]] VkPipelineLayout GetPipelineLayout() const { return p_pipeline_layout; }
-    [[nodiscard]] u32 CalculateWorkGroupCount(u32 particle_count) const;
+    [[nodiscard]] UVec3 GetLocalSize() const { return m_local_size; }
+    // Workgroups covering invocation_count invocations along each axis
+    [[nodiscard]] UVec3 CalculateWorkGroupCount(const UVec3 &invocation_count) const;
+    [[nodiscard]] u32 CalculateWorkGroupCount(u32 invocation_count) const;
 
 private:
     Renderer &m_renderer;
     Device *p_device;
+    UVec3 m_local_size;
+    u32 m_push_constant_size; // 0 when the shader declares no push constants
 
     VkPipeline p_pipeline{VK_NULL_HANDLE};
     VkPipelineLayout p_pipeline_layout{VK_NULL_HANDLE};
@@ -51,4 +75,23 @@ private:
     VkDescriptorPool p_descriptor_pool{VK_NULL_HANDLE};
 };
 
+/// One dispatch of a chain, push_constants is empty when the pipeline takes none
+struct ComputeDispatch {
+    const ComputePipeline *pipeline;
+    u32 set_index;
+    UVec3 group_counts;
+    std::span<const std::byte> push_constants;
+};
+
+/**
+ * @brief Records the dispatches in order, each waiting for the writes of the one before.
+ *
+ * Only the barriers between the dispatches are recorded. What the chain reads and writes is ordered against the rest
+ * of the frame by the render graph pass it is recorded in.
+ */
+void record_compute_chain(VkCommandBuffer command_buffer, std::span<const ComputeDispatch> dispatches);
+
+/// Makes the shader writes of the compute work recorded so far visible to the compute work recorded after
+void record_compute_barrier(VkCommandBuffer command_buffer);
+
 } // namespace gouda::vk
\ No newline at end of file
@@ -26,7 +26,8 @@ public:
     ~DepthResources();
 
     void Create();
-    void Recreate();
+    // Creates images of the swapchain's new size, the old ones are handed back for frames in flight to finish with
+    [[nodiscard]] Vector<Texture> Recreate();
     void Destroy();
 
     [[nodiscard]] const Vector<Texture> &GetDepthImages() const { return m_depth_images; }
@@ -0,0 +1,86 @@
+#pragma once
+/**
+ * @file vk_descriptor_allocator.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine vulkan growable descriptor pool allocator module
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <mutex>
+#include <span>
+
+#include <vulkan/vulkan.h>
+
+#include "containers/small_vector.hpp"
+#include "core/types.hpp"
+
+namespace gouda::vk {
+
+/**
+ * @class DescriptorAllocator
+ * @brief Allocates descriptor sets from a list of pools that grows whenever the pools run out.
+ *
+ * A new pool holds twice the sets of the one before, up to MAX_SETS_PER_POOL, with descriptors of each type in a
+ * fixed ratio to its sets. A request larger than those ratios, such as a bindless texture array, gets a pool sized
+ * for it instead. Pools are never destroyed before the allocator, sets are either freed one by one, which needs
+ * VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT, or all at once by Reset. Safe to call from the threads that build
+ * pipelines.
+ */
+class DescriptorAllocator {
+public:
+    static constexpr u32 INITIAL_SETS_PER_POOL{32};
+    static constexpr u32 MAX_SETS_PER_POOL{4096};
+
+    /**
+     * @param device Vulkan device handle.
+     * @param pool_flags Flags of every pool, update after bind for bindless sets, free descriptor set for Free.
+     */
+    DescriptorAllocator(VkDevice device, VkDescriptorPoolCreateFlags pool_flags);
+
+    /**
+     * @brief Destroys every pool and with them the sets. Callers must make sure the GPU no longer uses them.
+     */
+    ~DescriptorAllocator();
+
+    DescriptorAllocator(const DescriptorAllocator &) = delete;
+    DescriptorAllocator &operator=(const DescriptorAllocator &) = delete;
+
+    /**
+     * @brief Allocates sets.size() sets of one layout, all from the same pool.
+     * @param set_sizes Descriptors one set of the layout takes, by type. Sizes the pool when a new one is needed.
+     * @return The pool the sets came from, to be passed to Free.
+     */
+    VkDescriptorPool Allocate(VkDescriptorSetLayout layout, std::span<const VkDescriptorPoolSize> set_sizes,
+                              std::span<VkDescriptorSet> sets);
+
+    void Free(VkDescriptorPool pool, std::span<const VkDescriptorSet> sets);
+
+    /**
+     * @brief Returns every set of every pool, the sets handed out so far are invalid afterwards.
+     */
+    void Reset();
+
+    [[nodiscard]] size_t GetPoolCount() const;
+    [[nodiscard]] u32 GetAllocatedSetCount() const; ///< Since creation or the last reset
+
+private:
+    [[nodiscard]] VkResult TryAllocate(VkDescriptorPool pool, VkDescriptorSetLayout layout,
+                                       std::span<VkDescriptorSet> sets) const;
+    [[nodiscard]] VkDescriptorPool CreatePool(std::span<const VkDescriptorPoolSize> set_sizes, u32 set_count);
+
+private:
+    VkDevice p_device;
+    VkDescriptorPoolCreateFlags m_pool_flags;
+
+    mutable std::mutex m_mutex;
+    SmallVector<VkDescriptorPool, 4> m_pools;
+    u32 m_current_pool;   // The one allocations try first, the last that had room
+    u32 m_sets_per_pool;  // Of the next pool created
+    u32 m_allocated_sets; // Since creation or the last reset
+};
+
+} // namespace gouda::vk
@@ -10,25 +10,32 @@
  * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
  * See <https://www.gnu.org/licenses/> for more information.
  */
+#include <memory>
 #include <vector>
 
 #include <vulkan/vulkan.h>
 
 #include "core/types.hpp"
 #include "renderers/vulkan/vk_instance.hpp"
+#include "renderers/vulkan/vk_memory_allocator.hpp"
 #include "containers/small_vector.hpp"
 
 // TODO: Change this ish to Vector
 
 namespace gouda::vk {
 
-constexpr u32 MAX_TEXTURES{32};
+constexpr u32 MAX_TEXTURES{4096}; ///< Upper bound for the bindless texture arrays, lowered to the device limits
+constexpr u32 BINDLESS_ARRAYS{2};  ///< Bindless arrays of MAX_TEXTURES a shader stage may declare
 
 struct PhysicalDevice {
     VkPhysicalDevice m_physical_device;
     VkPhysicalDeviceProperties m_device_properties;
     VkPhysicalDeviceMemoryProperties m_memory_properties;
     VkPhysicalDeviceFeatures m_features;
+    VkPhysicalDeviceVulkan12Features m_vulkan_12_features; ///< Queried with a null pNext, zeroed below Vulkan 1.3
+    VkPhysicalDeviceVulkan13Features m_vulkan_13_features;
+    bool m_supports_present_wait; ///< VK_KHR_present_id and VK_KHR_present_wait, with both features
+    bool m_supports_fast_pipeline_linking; ///< VK_EXT_graphics_pipeline_library with the feature and fast linking
     VkSurfaceCapabilitiesKHR m_surface_capabilities;
     VkFormat m_depth_format;
 
@@ -36,16 +43,24 @@ struct PhysicalDevice {
     std::vector<VkBool32> m_queue_supports_present;
     std::vector<VkSurfaceFormatKHR> m_surface_formats;
     std::vector<VkPresentModeKHR> m_present_modes;
+    std::vector<VkExtensionProperties> m_extensions;
 
     PhysicalDevice()
         : m_physical_device{VK_NULL_HANDLE},
           m_device_properties{},
           m_memory_properties{},
           m_features{},
+          m_vulkan_12_features{},
+          m_vulkan_13_features{},
+          m_supports_present_wait{false},
+          m_supports_fast_pipeline_linking{false},
           m_surface_capabilities{},
           m_depth_format{VK_FORMAT_UNDEFINED}
     {
     }
+
+    [[nodiscard]] bool SupportsExtension(StringView extension_name) const;
+    [[nodiscard]] VkDeviceSize GetDeviceLocalMemorySize() const; ///< Summed over the device local heaps
 };
 
 class VulkanPhysicalDevices {
@@ -53,7 +68,17 @@ public:
     VulkanPhysicalDevices() : m_dev_index{-1} {}
 
     void Initialize(const Instance &instance, const VkSurfaceKHR &surface);
-    u32 SelectDevice(VkQueueFlags required_queue_type, bool supports_present);
+
+    /**
+     * @brief Selects the best scoring device that can run the renderer, returning its queue family.
+     *
+     * Devices without Vulkan 1.3, the required extensions and features or a presenting queue family with the required
+     * flags are never picked. The rest are ranked discrete, integrated, virtual then CPU, and by device local memory
+     * within a type, so hybrid laptops land on their discrete GPU.
+     *
+     * @param preferred_device Picks the first suitable device whose name contains it instead, empty to score.
+     */
+    u32 SelectDevice(VkQueueFlags required_queue_type, bool supports_present, StringView preferred_device = {});
     [[nodiscard]] const PhysicalDevice &Selected() const;
 
 private:
@@ -61,28 +86,91 @@ private:
     int m_dev_index;
 };
 
+/**
+ * @struct MemoryBudget
+ * @brief Device local memory summed over all device local heaps, as reported by VK_EXT_memory_budget.
+ */
+struct MemoryBudget {
+    VkDeviceSize budget; ///< What the process can allocate before the driver starts paging or failing allocations
+    VkDeviceSize usage;  ///< What the process currently has allocated
+};
+
+/**
+ * @struct DeviceCapabilities
+ * @brief What the created device has enabled, for the renderer to pick its paths from instead of querying Vulkan.
+ */
+struct DeviceCapabilities {
+    bool descriptor_indexing;       ///< Bindless texture arrays, required
+    bool timeline_semaphores;       ///< Required
+    bool dynamic_rendering;         ///< Required
+    bool memory_budget;             ///< VK_EXT_memory_budget, texture residency follows the real VRAM budget
+    bool present_wait;              ///< VK_KHR_present_wait, frame pacing waits for frames to reach the screen
+    bool bc_textures;               ///< BC compressed KTX2 textures
+    bool astc_textures;             ///< ASTC LDR compressed KTX2 textures
+    bool dedicated_transfer_queue;  ///< Uploads run beside rendering
+    bool async_compute_queue;       ///< Particle simulation can run beside rendering
+    bool multi_draw_indirect;       ///< Indirect draws of many commands, with a first instance other than 0
+    bool host_visible_vram;         ///< Resizable BAR or UMA, CPU written buffers can live in device local memory
+    bool graphics_pipeline_library; ///< VK_EXT_graphics_pipeline_library with fast linking, pipelines are linked from
+                                    ///< separately compiled parts
+
+    DeviceCapabilities();
+};
+
 class Device {
 public:
-    Device(const Instance &instance, VkQueueFlags required_queue_flags);
+    // preferred_device overrides the scored device selection, see VulkanPhysicalDevices::SelectDevice
+    Device(const Instance &instance, VkQueueFlags required_queue_flags, StringView preferred_device = {});
     ~Device();
 
     [[nodiscard]] VkDevice GetDevice() const { return p_device; }
     [[nodiscard]] VkPhysicalDevice GetPhysicalDevice() const { return m_physical_devices.Selected().m_physical_device; }
     [[nodiscard]] u32 GetQueueFamily() const { return m_queue_family; }
+    [[nodiscard]] u32 GetTransferQueueFamily() const { return m_transfer_queue_family; }
+    [[nodiscard]] bool HasDedicatedTransferQueue() const { return m_capabilities.dedicated_transfer_queue; }
+    [[nodiscard]] u32 GetComputeQueueFamily() const { return m_compute_queue_family; }
+    [[nodiscard]] u32 GetComputeQueueIndex() const { return m_compute_queue_index; }
+    [[nodiscard]] bool HasAsyncComputeQueue() const { return m_capabilities.async_compute_queue; }
     [[nodiscard]] const PhysicalDevice &GetSelectedPhysicalDevice() const { return m_physical_devices.Selected(); }
+    [[nodiscard]] const DeviceCapabilities &GetCapabilities() const { return m_capabilities; }
     [[nodiscard]] u32 GetMaxTextures() const { return m_max_textures;}
+    [[nodiscard]] MemoryAllocator *GetAllocator() const { return p_allocator.get(); }
+
+    // Block compressed texture families, enabled at device creation whenever the device offers them
+    [[nodiscard]] bool SupportsBCTextures() const { return m_capabilities.bc_textures; }
+    [[nodiscard]] bool SupportsASTCTextures() const { return m_capabilities.astc_textures; }
+
+    [[nodiscard]] bool HasMemoryBudget() const { return m_capabilities.memory_budget; }
+    // Zero budget and usage when VK_EXT_memory_budget is not available
+    [[nodiscard]] MemoryBudget GetMemoryBudget() const;
+
+    [[nodiscard]] bool HasPresentWait() const { return m_capabilities.present_wait; }
+    // Blocks until the present with the id is on screen, false without VK_KHR_present_wait or on timeout
+    [[nodiscard]] bool WaitForPresent(VkSwapchainKHR swapchain, u64 present_id, u64 timeout) const;
+
+    // Checks the optimal tiling features of format, by default whether it can be uploaded to and sampled
+    [[nodiscard]] bool IsFormatSupported(VkFormat format,
+                                         VkFormatFeatureFlags features = VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT |
+                                                                         VK_FORMAT_FEATURE_TRANSFER_DST_BIT) const;
 
     void Wait() const { vkDeviceWaitIdle(p_device); };
 
 private:
     void CreateDevice();
+    void LogCapabilities() const;
+    [[nodiscard]] u32 FindQueueFamily(VkQueueFlags required_flags, VkQueueFlags avoided_flags) const;
 
 private:
     VkDevice p_device;
     VulkanPhysicalDevices m_physical_devices;
     u32 m_queue_family;
-    u32 m_max_textures;
-
+    u32 m_transfer_queue_family; ///< u32_max when the device has no transfer family separate from graphics
+    u32 m_compute_queue_family;  ///< u32_max when the device has no compute family separate from graphics
+    u32 m_compute_queue_index;   ///< Queue index within the compute family, non zero when sharing with transfer
+    u32 m_max_textures;          ///< Size of the bindless texture arrays, MAX_TEXTURES clamped to device limits
+    DeviceCapabilities m_capabilities;
+    PFN_vkWaitForPresentKHR p_wait_for_present;
+    std::unique_ptr<MemoryAllocator> p_allocator;
 };
 
 } // namespace gouda::vk
\ No newline at end of file
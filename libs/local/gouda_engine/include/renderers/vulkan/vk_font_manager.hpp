@@ -10,6 +10,8 @@
  * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
  * See <https://www.gnu.org/licenses/> for more information.
  */
+#include <unordered_map>
+
 #include "containers/small_vector.hpp"
 #include "core/types.hpp"
 #include "renderers/text.hpp"
@@ -22,7 +24,7 @@ class Texture;
 
 enum class FontType : u8 { MSDF, BITMAP };
 
-using Glyphs = std::unordered_map<char, MSDFGlyph>;
+using Glyphs = MSDFGlyphTable;
 
 class FontManager {
 public:
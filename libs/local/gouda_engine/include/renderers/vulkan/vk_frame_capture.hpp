@@ -0,0 +1,118 @@
+#pragma once
+/**
+ * @file vk_frame_capture.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine vulkan screenshot and frame capture module
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include <vulkan/vulkan.h>
+
+#include "containers/small_vector.hpp"
+#include "core/types.hpp"
+#include "renderers/vulkan/vk_buffer.hpp"
+
+namespace gouda::vk {
+
+class Device;
+class BufferManager;
+class Queue;
+
+/**
+ * @class FrameCapture
+ * @brief Reads presented frames back through a ring of host visible buffers and writes them out as PNG files, without
+ * the frame ever waiting on the copy.
+ *
+ * A captured frame's image is copied into a free slot at the end of its command buffer. The slot is handed to the
+ * encoder thread once the queue timeline shows the copy done, frames later, and is free again when the file is
+ * written. A frame that finds every slot busy is not captured, a continuous capture counts those as dropped.
+ *
+ * Collect, BeginFrame, RecordCopy and EndFrame are called by the renderer on its thread, once per frame and in that
+ * order. Only 8 bit RGBA and BGRA images are read back.
+ */
+class FrameCapture {
+public:
+    static constexpr u32 SLOT_COUNT{4};
+
+    FrameCapture(Device *device, BufferManager *buffer_manager);
+    ~FrameCapture(); // Finishes the files being written, Collect after the queue went idle writes the rest
+
+    FrameCapture(const FrameCapture &) = delete;
+    FrameCapture &operator=(const FrameCapture &) = delete;
+
+    // Writes the next frame that gets a slot to filepath, several requests are taken one per frame
+    void RequestScreenshot(String filepath);
+
+    // Writes every frame to directory/frame_000000.png onwards until StopCapture, a burst of screenshots or the frames
+    // of a video to assemble afterwards
+    void StartCapture(String directory);
+    void StopCapture();
+    [[nodiscard]] bool IsCapturing() const noexcept { return m_is_capturing; }
+    [[nodiscard]] u32 GetDroppedFrameCount() const noexcept { return m_dropped_frame_count; }
+
+    // Hands the slots whose copy completed to the encoder thread
+    void Collect(const Queue &queue);
+
+    // Reserves a slot for this frame. False when no capture is due, the ring is full or the format is not supported.
+    [[nodiscard]] bool BeginFrame(VkExtent2D extent, VkFormat format);
+
+    // Copies the image, in TRANSFER_SRC_OPTIMAL, into the reserved slot and makes the copy visible to the host
+    void RecordCopy(VkCommandBuffer command_buffer, VkImage image) const;
+
+    // The reserved slot waits for the submission that copies into it
+    void EndFrame(u64 timeline_value);
+
+private:
+    enum class SlotState : u8 {
+        Free,
+        Reserved, // Copied into by the frame being recorded
+        Recorded, // Submitted, waiting for the timeline
+        Encoding  // Owned by the encoder thread, which frees it
+    };
+
+    struct Slot {
+        Buffer buffer;
+        VkExtent2D extent{};
+        VkFormat format{VK_FORMAT_UNDEFINED};
+        String filepath;
+        u64 timeline_value{0};
+        std::atomic<SlotState> state{SlotState::Free};
+    };
+
+    [[nodiscard]] Slot *FindFreeSlot();
+    void Encode(Slot &slot) const;
+    void Run(const std::stop_token &stop_token);
+
+private:
+    Device *p_device;
+    BufferManager *p_buffer_manager;
+
+    std::array<Slot, SLOT_COUNT> m_slots;
+    Slot *p_reserved_slot; // This frame's, until EndFrame
+
+    std::deque<String> m_screenshot_paths;
+    String m_capture_directory;
+    bool m_is_capturing;
+    u32 m_capture_frame_index;
+    u32 m_dropped_frame_count;
+    bool m_is_format_warned;
+
+    std::mutex m_mutex;
+    std::condition_variable_any m_condition;
+    SmallVector<Slot *, SLOT_COUNT> m_encode_queue;
+
+    std::jthread m_thread; // Last, started once the rest is set up
+};
+
+} // namespace gouda::vk
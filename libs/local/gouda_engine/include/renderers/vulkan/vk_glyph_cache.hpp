@@ -0,0 +1,149 @@
+#pragma once
+/**
+ * @file vk_glyph_cache.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine vulkan on demand glyph rasterization module
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <array>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "containers/flat_hash_map.hpp"
+#include "containers/small_vector.hpp"
+#include "core/types.hpp"
+#include "renderers/text.hpp"
+
+namespace gouda::vk {
+
+class BufferManager;
+class TextureManager;
+
+/**
+ * @class GlyphCache
+ * @brief Glyphs a font's baked atlas lacks, rasterized from the font's TrueType file while the text waits for them.
+ *
+ * A glyph looked up for the first time is queued for the rasterizer thread and the text is laid out without it. Once
+ * rasterized it is placed in a cell of a page texture, the next Update uploads the rows it changed and reports its
+ * font, whose layouts are then redone. Cells are all CELL_SIZE squares, so with every page full the glyph drawn the
+ * longest ago gives its cell up. Glyphs drawn since the last Update are never evicted, a glyph finding no cell waits
+ * for one. Memory stays at MAX_PAGE_COUNT pages whatever the text.
+ *
+ * Glyphs are single channel signed distance fields written to all three channels, the MSDF decode of the quad shader
+ * reads them as they are, with rounded rather than sharp corners at large sizes.
+ *
+ * Everything but the rasterizer is called by the renderer on its thread.
+ */
+class GlyphCache {
+public:
+    static constexpr u32 PAGE_SIZE{1024};
+    static constexpr u32 CELL_SIZE{64};
+    static constexpr u32 MAX_PAGE_COUNT{2};
+    static constexpr u32 CELLS_PER_ROW{PAGE_SIZE / CELL_SIZE};
+    static constexpr u32 CELLS_PER_PAGE{CELLS_PER_ROW * CELLS_PER_ROW};
+    static constexpr u32 NO_CELL{constants::u32_max};
+
+    struct Glyph {
+        MSDFGlyph metrics; // Atlas bounds in pixels of the page, from its bottom left
+        u32 texture_id;    // Of the page, 0 for glyphs that draw nothing
+        u32 cell;          // NO_CELL for glyphs that draw nothing
+    };
+
+    GlyphCache(BufferManager *buffer_manager, TextureManager *texture_manager);
+    ~GlyphCache(); // Drops the glyphs still queued
+
+    GlyphCache(const GlyphCache &) = delete;
+    GlyphCache &operator=(const GlyphCache &) = delete;
+
+    // Rasterizes the glyphs of font_id its atlas lacks from the TrueType file, at the atlas's distance range
+    bool AddFont(u32 font_id, StringView font_filepath, const MSDFAtlasParams &atlas_params);
+    [[nodiscard]] bool HasFont(const u32 font_id) const
+    {
+        return font_id < m_fonts.size() && m_fonts[font_id] != nullptr;
+    }
+
+    // The glyph once it is placed, null while it is rasterized or when the font has none. Queues it the first time.
+    // The pointer is valid until the next Find or Update.
+    [[nodiscard]] const Glyph *Find(u32 font_id, u32 codepoint);
+
+    // Keeps the cells of glyphs drawn this frame from being evicted
+    void Touch(std::span<const u32> cells);
+
+    // Places the glyphs rasterized since the last call and uploads what changed. Fonts whose glyphs were placed or
+    // evicted are appended to changed_font_ids, once each.
+    void Update(Vector<u32> &changed_font_ids);
+
+    [[nodiscard]] u32 GetGlyphCount() const noexcept { return m_used_cell_count; }
+
+private:
+    struct SourceFont; // The TrueType file and its stb_truetype state
+
+    struct Rasterized {
+        u64 key;
+        Glyph glyph;
+        Vector<u8> distances; // width * height bytes, top row first
+        u32 width;
+        u32 height;
+        bool is_missing; // The font has no such glyph
+    };
+
+    enum class GlyphState : u8 { Queued, Placed, Missing };
+
+    struct Entry {
+        Glyph glyph;
+        GlyphState state;
+    };
+
+    struct Cell {
+        u64 key{0};
+        u64 last_used{0}; // Placed glyphs count as drawn in the frame they were placed in
+    };
+
+    struct Page {
+        Vector<u8> pixels; // RGBA, bottom row first like the texture coordinates
+        u32 texture_id{0};
+        u32 dirty_first_row{PAGE_SIZE};
+        u32 dirty_last_row{0}; // Exclusive
+    };
+
+    [[nodiscard]] static constexpr u64 GlyphKey(const u32 font_id, const u32 codepoint) noexcept
+    {
+        return (static_cast<u64>(font_id) << 32) | codepoint;
+    }
+
+    // A free cell or the coldest one, NO_CELL while every cell was drawn since the last Update
+    [[nodiscard]] u32 AllocateCell(Vector<u32> &changed_font_ids);
+    void Place(const Rasterized &rasterized, u32 cell, Glyph &glyph); // Into the page's pixels, sets the atlas bounds
+    void UploadPages();
+    [[nodiscard]] static Rasterized Rasterize(const SourceFont &font, u64 key);
+    void Run(const std::stop_token &stop_token);
+
+private:
+    BufferManager *p_buffer_manager;
+    TextureManager *p_texture_manager;
+
+    Vector<std::unique_ptr<SourceFont>> m_fonts; // By font id, null for fonts without a file
+    FlatHashMap<u64, Entry> m_glyphs;
+    std::array<Cell, CELLS_PER_PAGE * MAX_PAGE_COUNT> m_cells;
+    SmallVector<Page, MAX_PAGE_COUNT> m_pages; // Created as the cells before them fill up
+    Vector<Rasterized> m_unplaced;             // Waiting for a cell
+    u32 m_used_cell_count;
+    u64 m_frame;
+    bool m_is_full_warned;
+
+    std::mutex m_mutex;
+    std::condition_variable_any m_condition;
+    Vector<std::pair<const SourceFont *, u64>> m_requests;
+    Vector<Rasterized> m_results;
+
+    std::jthread m_thread; // Last, started once the rest is set up
+};
+
+} // namespace gouda::vk
@@ -0,0 +1,101 @@
+#pragma once
+/**
+ * @file vk_gpu_timer.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine vulkan GPU timestamp query module
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <array>
+
+#include <vulkan/vulkan.h>
+
+#include "containers/small_vector.hpp"
+#include "core/types.hpp"
+
+namespace gouda::vk {
+
+class Device;
+
+/**
+ * @brief Parts of a frame timed on the GPU, the draw passes in the renderer's DrawPass order after the compute work.
+ */
+enum class GpuScope : u32 { Compute, StaticQuads, Quads, Particles, ImGui, Upscale };
+inline constexpr u32 GPU_SCOPE_COUNT{static_cast<u32>(GpuScope::Upscale) + 1};
+
+/**
+ * @struct GpuTimings
+ * @brief GPU time of one frame in milliseconds, scopes that did not run that frame read zero.
+ */
+struct GpuTimings {
+    std::array<f32, GPU_SCOPE_COUNT> scope_times{};
+    f32 frame_time{0.0f}; // From the first scope starting to the last one ending
+};
+
+/**
+ * @class GpuTimer
+ * @brief Timestamp queries around the parts of a frame, read back when the frame slot comes round again.
+ *
+ * Every frame in flight owns a begin and an end query per scope. They are reset at the start of the slot's command
+ * buffer and read without waiting once the renderer has waited for the slot's previous submission anyway, so the
+ * results are frames_in_flight frames old and never stall the CPU. Scopes skipped in a frame stay unavailable and are
+ * left out. With a profiling session open the scopes are also written to the trace on its GPU track, placed on the
+ * CPU timeline from the time their frame was submitted.
+ */
+class GpuTimer {
+public:
+    GpuTimer(const Device *device, u32 frames_in_flight);
+    ~GpuTimer();
+
+    GpuTimer(const GpuTimer &) = delete;
+    GpuTimer &operator=(const GpuTimer &) = delete;
+
+    /**
+     * @brief Reads the slot's queries from its previous use, called once that submission has completed.
+     */
+    void CollectResults(u32 frame_index);
+
+    /**
+     * @brief Resets the slot's queries, recorded outside a render pass before any scope of the frame.
+     */
+    void RecordReset(VkCommandBuffer command_buffer, u32 frame_index);
+
+    /**
+     * @brief Writes a scope's begin or end timestamp, also from secondary command buffers on other threads.
+     */
+    void RecordBegin(VkCommandBuffer command_buffer, u32 frame_index, GpuScope scope) const;
+    void RecordEnd(VkCommandBuffer command_buffer, u32 frame_index, GpuScope scope) const;
+
+    /**
+     * @brief Remembers when the slot's commands were submitted, the CPU time its first timestamp is placed at.
+     */
+    void MarkSubmitted(u32 frame_index);
+
+    [[nodiscard]] bool IsSupported() const noexcept { return p_query_pool != VK_NULL_HANDLE; }
+    [[nodiscard]] const GpuTimings &GetTimings() const noexcept { return m_timings; }
+
+    [[nodiscard]] static StringView GetScopeName(GpuScope scope);
+
+private:
+    static constexpr u32 QUERIES_PER_FRAME{GPU_SCOPE_COUNT * 2};
+
+    [[nodiscard]] u32 GetQuery(const u32 frame_index, const GpuScope scope) const noexcept
+    {
+        return frame_index * QUERIES_PER_FRAME + static_cast<u32>(scope) * 2;
+    }
+
+    VkDevice p_device;
+    VkQueryPool p_query_pool; // Null when the graphics queue cannot write timestamps
+    f64 m_timestamp_period;   // Nanoseconds per tick
+    u64 m_timestamp_mask;     // Bits the queue writes, higher bits wrap
+
+    Vector<FloatingPointMicroseconds> m_submit_times;
+    Vector<bool> m_has_results; // Reset and submitted since the slot's results were last collected
+    GpuTimings m_timings;
+};
+
+} // namespace gouda::vk
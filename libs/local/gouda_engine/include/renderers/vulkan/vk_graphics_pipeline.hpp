@@ -11,6 +11,9 @@
  * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
  * See <https://www.gnu.org/licenses/> for more information.
  */
+#include <optional>
+#include <span>
+
 #include <vulkan/vulkan.h>
 
 #include "containers/small_vector.hpp"
@@ -21,17 +24,54 @@ struct GLFWwindow;
 namespace gouda::vk {
 
 struct Buffer;
+class DescriptorAllocator;
+class PipelineLibraryCache;
 struct Texture;
 class Renderer;
 class Shader;
+struct ShaderDescriptorBinding;
+
+// QuadAlphaTest and QuadTransparent share the quad shaders and instance layout. QuadAlphaTest sets the fragment
+// shader's alpha_test constant, QuadTransparent turns blending on and depth writes off. Upscale draws a full screen
+// triangle without vertex input, depth testing or blending.
+enum class PipelineType : u8 { Quad, QuadAlphaTest, QuadTransparent, Particle, Upscale };
+
+// Values for the shaders' integer specialization constants by name, in place of the defaults the shaders declare.
+// Constants a stage does not declare are ignored, so one set specializes both stages of a pipeline.
+class SpecializationConstants {
+public:
+    SpecializationConstants &Set(StringView name, s32 value);
+    [[nodiscard]] std::optional<s32> Find(StringView name) const;
+    [[nodiscard]] bool IsEmpty() const noexcept { return m_values.empty(); }
+
+    bool operator==(const SpecializationConstants &other) const;
+
+private:
+    struct Value {
+        String name;
+        s32 value;
+    };
+    SmallVector<Value, 4> m_values; // Sorted by name, so sets compare equal whatever order they were given in
+};
 
-enum class PipelineType : u8 { Quad, Text, Particle };
+// What a command buffer being recorded last bound, one per command buffer. Pipelines built from the same shaders are
+// written the same descriptors by the renderer, and those sharing a pipeline layout find their sets already bound.
+struct BoundDescriptorSets {
+    VkPipelineLayout layout{VK_NULL_HANDLE};
+    const Shader *vertex_shader{nullptr};
+    const Shader *fragment_shader{nullptr};
+    size_t image_index{0};
+};
 
 class GraphicsPipeline {
 public:
-    GraphicsPipeline(Renderer &renderer, VkRenderPass render_pass, Shader *vertex_shader,
-                     Shader *fragment_shader, int number_of_images, Vector<Buffer> &uniform_buffers,
-                     int uniform_data_size, PipelineType type);
+    // Pipelines target dynamic rendering, rendering_info describes the attachment formats of the pass. Pipelines built
+    // off the main thread pass write_texture_descriptors = false, since the renderer's textures may change meanwhile,
+    // and write them with the Update*TextureDescriptors functions before the first bind. The type's own constants,
+    // such as QuadAlphaTest's alpha_test, apply unless constants sets them too.
+    GraphicsPipeline(Renderer &renderer, const VkPipelineRenderingCreateInfo &rendering_info, Shader *vertex_shader,
+                     Shader *fragment_shader, int number_of_images, PipelineType type,
+                     bool write_texture_descriptors = true, const SpecializationConstants &constants = {});
 
     ~GraphicsPipeline();
 
@@ -40,23 +80,60 @@ public:
     GraphicsPipeline(GraphicsPipeline &&) = default;
     GraphicsPipeline &operator=(GraphicsPipeline &&) = delete;
 
-    void Bind(VkCommandBuffer command_buffer_ptr, size_t image_index) const;
+    // Binds the pipeline and its descriptor sets of image_index. With bound, the sets are left as they are when the
+    // command buffer already holds sets with the same descriptors under the same layout.
+    void Bind(VkCommandBuffer command_buffer_ptr, size_t image_index, BoundDescriptorSets *bound = nullptr) const;
+
+    // Camera data is a push constant rather than a uniform buffer, written into the command buffer after each bind
+    void PushConstants(VkCommandBuffer command_buffer_ptr, const void *data, u32 size) const;
     void Destroy();
 
+    // Texture arrays are bindless (partially bound, update after bind), so only the changed ids need writing and
+    // elements no frame in flight reads can be written at any time. Writes every image's set, for new pipelines.
     void UpdateTextureDescriptors(size_t number_of_images, const Vector<std::unique_ptr<Texture>> &textures);
-    void UpdateFontTextureDescriptors(size_t number_of_images, const Vector<std::unique_ptr<Texture>> &font_textures);
+    void UpdateTextureDescriptors(size_t number_of_images, const Vector<std::unique_ptr<Texture>> &textures,
+                                  std::span<const u32> texture_ids);
+    // Texture arrays are immutable once loaded, a new array id is read by no frame and is written into every set
+    void UpdateTextureArrayDescriptors(size_t number_of_images, const Vector<std::unique_ptr<Texture>> &texture_arrays,
+                                       std::span<const u32> array_ids);
+
+    // The same for the descriptor set of image_index only. Elements in use by a frame in flight must not be rewritten,
+    // so the renderer writes changed ids into each frame's set once that frame has retired.
+    void UpdateFrameTextureDescriptors(size_t image_index, const Vector<std::unique_ptr<Texture>> &textures,
+                                       std::span<const u32> texture_ids);
+
+    // Writes buffers[i] into descriptor set i, or a single buffer into every set. Leaves pipelines whose shaders do not
+    // declare a buffer of that type at binding_index as they are.
+    void UpdateBufferDescriptors(size_t number_of_images, u32 binding_index, VkDescriptorType type,
+                                 std::span<const Buffer> buffers, VkDeviceSize range);
+
+    // Writes one sampled image into the descriptor set of image_index only, for images that change between frames.
+    // Image bindings are update after bind, so this may follow recording the commands that bind the set.
+    void UpdateImageDescriptor(size_t image_index, u32 binding_index, VkImageView view, VkSampler sampler);
 
     [[nodiscard]] constexpr VkPipeline GetPipeline() const noexcept { return p_pipeline; }
     [[nodiscard]] constexpr VkPipelineLayout GetLayout() const noexcept { return p_pipeline_layout; }
+    [[nodiscard]] constexpr PipelineType GetType() const noexcept { return m_type; }
+    [[nodiscard]] const SpecializationConstants &GetConstants() const noexcept { return m_constants; }
+    [[nodiscard]] Shader *GetVertexShader() const noexcept { return p_vertex_shader; }
+    [[nodiscard]] Shader *GetFragmentShader() const noexcept { return p_fragment_shader; }
 
 private:
-    void CreateDescriptorPool(int number_of_images);
-    void CreateDescriptorSets(int number_of_images, const Vector<Buffer> &uniform_buffers, int uniform_data_size);
+    void CreateDescriptorSets(int number_of_images, bool write_texture_descriptors);
     void CreateDescriptorSetLayout();
     void AllocateDescriptorSets(int number_of_images);
-    void UpdateDescriptorSets(int number_of_images, const Vector<Buffer> &uniform_buffers, int uniform_data_size);
-
-    [[nodiscard]] std::array<VkPipelineShaderStageCreateInfo, 2> SetupShaderStages() const;
+    void WriteImageDescriptors(size_t first_image, size_t image_count, u32 binding_index,
+                               const Vector<std::unique_ptr<Texture>> &textures, std::span<const u32> texture_ids);
+    [[nodiscard]] u32 GetDescriptorCount(const ShaderDescriptorBinding &binding) const;
+
+    // The map entries and values a stage's specialization info points at, kept until the pipeline is created
+    struct StageSpecialization {
+        SmallVector<VkSpecializationMapEntry, 4> entries;
+        SmallVector<u8, 16> data;
+        VkSpecializationInfo info;
+    };
+    void SetupSpecialization(const Shader &shader, StageSpecialization &specialization) const;
+    [[nodiscard]] std::array<VkPipelineShaderStageCreateInfo, 2> SetupShaderStages();
     [[nodiscard]] VkPipelineVertexInputStateCreateInfo SetupVertexInput();
 
     /**
@@ -76,21 +153,35 @@ private:
     [[nodiscard]] PipelineStates SetupPipelineStates() const;
     [[nodiscard]] Vector<VkPushConstantRange> SetupPushConstants();
 
+    // Links the pipeline from library parts, compiling only those no earlier pipeline built. VK_NULL_HANDLE if a part
+    // or the link failed, for the constructor to create the pipeline whole instead.
+    [[nodiscard]] VkPipeline CreateLinkedPipeline(PipelineLibraryCache &libraries,
+                                                  const VkPipelineRenderingCreateInfo &rendering_info,
+                                                  std::span<const VkPipelineShaderStageCreateInfo, 2> shader_stages,
+                                                  const VkPipelineVertexInputStateCreateInfo &vertex_input,
+                                                  const PipelineStates &states) const;
+
     void PrintReflection() const;
 
 private:
     Renderer &m_renderer;
     VkDevice p_device;
     VkPipeline p_pipeline;
-    VkPipelineLayout p_pipeline_layout;
+    VkPipelineLayout p_pipeline_layout; // From the renderer's layout cache, as are the set layouts
 
-    VkDescriptorPool p_descriptor_pool;
+    DescriptorAllocator *p_descriptor_allocator; // The renderer's, shared by every pipeline
     Vector<VkDescriptorSetLayout> m_descriptor_set_layouts;
     Vector<Vector<VkDescriptorSet>> m_descriptor_sets;
+    Vector<VkDescriptorPool> m_descriptor_pools; // The pool each set's descriptor sets came from
+    Vector<VkPushConstantRange> m_push_constant_ranges;
     Vector<VkVertexInputBindingDescription> m_binding_descriptions;
     Vector<VkVertexInputAttributeDescription> m_attribute_descriptions;
 
     PipelineType m_type;
+    SpecializationConstants m_constants; ///< Including the type's own
+    StageSpecialization m_vertex_specialization;
+    StageSpecialization m_fragment_specialization;
+    u32 m_max_textures; ///< Size given to runtime sized texture arrays
 
     Shader *p_vertex_shader;
     Shader *p_fragment_shader;
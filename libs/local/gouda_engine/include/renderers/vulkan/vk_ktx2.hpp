@@ -0,0 +1,73 @@
+#pragma once
+/**
+ * @file vk_ktx2.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine KTX2 texture container loading
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <optional>
+#include <span>
+
+#include <vulkan/vulkan.h>
+
+#include "containers/small_vector.hpp"
+#include "core/types.hpp"
+#include "utils/mapped_file.hpp"
+
+namespace gouda::vk {
+
+/**
+ * @struct KTX2Level
+ * @brief Location of one mip level inside the file data, level 0 is the full resolution image.
+ */
+struct KTX2Level {
+    u64 offset;
+    u64 size;
+};
+
+/**
+ * @class KTX2File
+ * @brief A KTX2 container holding GPU ready, typically block compressed (BCn, ASTC), image data.
+ *
+ * The data is uploaded as is, there is no CPU decode. Only files without supercompression are accepted, Basis
+ * Universal and Zstandard payloads need transcoding first (e.g. `ktx create --encode` without `--zstd`). Cube maps and
+ * 3D textures are rejected as well, array layers and mip levels are supported.
+ */
+class KTX2File {
+public:
+    /**
+     * @brief Reads and validates a KTX2 file.
+     * @param filepath Path to the .ktx2 file.
+     * @return The parsed file or a description of why it was rejected.
+     */
+    static Expect<KTX2File, String> Load(StringView filepath);
+
+    /**
+     * @brief Checks the file extension only, the contents are validated by Load.
+     */
+    [[nodiscard]] static bool IsKTX2Path(StringView filepath);
+
+    [[nodiscard]] VkFormat GetFormat() const noexcept { return m_format; }
+    [[nodiscard]] ImageSize GetSize() const noexcept { return m_size; }
+    [[nodiscard]] u32 GetLayerCount() const noexcept { return m_layer_count; }
+    [[nodiscard]] u32 GetLevelCount() const noexcept { return static_cast<u32>(m_levels.size()); }
+    [[nodiscard]] std::span<const KTX2Level> GetLevels() const noexcept { return m_levels; }
+    [[nodiscard]] std::span<const std::byte> GetData() const noexcept { return m_file->GetData(); }
+
+private:
+    KTX2File() = default;
+
+private:
+    VkFormat m_format{VK_FORMAT_UNDEFINED};
+    ImageSize m_size{0, 0};
+    u32 m_layer_count{1};
+    Vector<KTX2Level> m_levels;
+    std::optional<fs::MappedFile> m_file; ///< The whole file, level offsets index into it
+};
+
+} // namespace gouda::vk
@@ -0,0 +1,90 @@
+#pragma once
+/**
+ * @file vk_layout_cache.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine vulkan descriptor set and pipeline layout cache module
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <mutex>
+#include <span>
+
+#include <vulkan/vulkan.h>
+
+#include "containers/small_vector.hpp"
+#include "core/types.hpp"
+
+namespace gouda::vk {
+
+// One binding of a descriptor set layout as reflected from the shaders, what set layouts are told apart by
+struct DescriptorLayoutBinding {
+    u32 binding;
+    VkDescriptorType type;
+    u32 count;
+    VkShaderStageFlags stage_flags;
+    VkDescriptorBindingFlags flags;
+
+    constexpr bool operator==(const DescriptorLayoutBinding &) const noexcept = default;
+};
+
+/**
+ * @class LayoutCache
+ * @brief Creates one descriptor set layout per binding signature and one pipeline layout per set of those layouts and
+ * push constant ranges, handing the same one to every pipeline that asks for it.
+ *
+ * The quad pipelines, their variants and the pipelines rebuilt by a shader reload all reflect the same bindings, so
+ * they end up with the same pipeline layout. Descriptor sets bound under it stay bound when the command buffer
+ * switches between them. Layouts stay alive until the cache is destroyed, those it hands out must not be destroyed by
+ * their users. Safe to call from the threads that build pipelines.
+ */
+class LayoutCache {
+public:
+    explicit LayoutCache(VkDevice device);
+
+    /**
+     * @brief Destroys every layout. Callers must make sure no pipeline or descriptor set still uses them.
+     */
+    ~LayoutCache();
+
+    LayoutCache(const LayoutCache &) = delete;
+    LayoutCache &operator=(const LayoutCache &) = delete;
+
+    /**
+     * @brief Returns the set layout of bindings, update after bind when any binding has a flag set.
+     * @param bindings Sorted by binding number, so the same bindings reflected in another order find the same layout.
+     */
+    [[nodiscard]] VkDescriptorSetLayout GetSetLayout(std::span<const DescriptorLayoutBinding> bindings);
+
+    [[nodiscard]] VkPipelineLayout GetPipelineLayout(std::span<const VkDescriptorSetLayout> set_layouts,
+                                                     std::span<const VkPushConstantRange> push_constant_ranges);
+
+    [[nodiscard]] size_t GetSetLayoutCount() const;
+    [[nodiscard]] size_t GetPipelineLayoutCount() const;
+    [[nodiscard]] u64 GetHitCount() const; ///< Requests that found their layout created already
+
+private:
+    struct SetLayoutEntry {
+        u64 hash;
+        SmallVector<DescriptorLayoutBinding, 8> bindings;
+        VkDescriptorSetLayout p_layout;
+    };
+
+    struct PipelineLayoutEntry {
+        u64 hash;
+        SmallVector<VkDescriptorSetLayout, 4> set_layouts;
+        SmallVector<VkPushConstantRange, 2> push_constant_ranges;
+        VkPipelineLayout p_layout;
+    };
+
+    VkDevice p_device;
+    mutable std::mutex m_mutex;
+    SmallVector<SetLayoutEntry, 8> m_set_layouts; // Few, searched in order
+    SmallVector<PipelineLayoutEntry, 8> m_pipeline_layouts;
+    u64 m_hit_count;
+};
+
+} // namespace gouda::vk
@@ -0,0 +1,173 @@
+#pragma once
+/**
+ * @file vk_memory_allocator.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine vulkan device memory sub-allocator module
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <memory>
+#include <mutex>
+#include <optional>
+
+#include <vulkan/vulkan.h>
+
+#include "containers/small_vector.hpp"
+#include "core/types.hpp"
+
+namespace gouda::vk {
+
+class MemoryAllocator;
+
+/**
+ * @enum MemoryResourceKind
+ * @brief Linear resources (buffers) and optimal-tiling images are placed in separate blocks, so the
+ * bufferImageGranularity rule never has to be applied between neighbouring allocations.
+ */
+enum class MemoryResourceKind : u8 { Linear, Optimal };
+
+/**
+ * @struct MemoryAllocation
+ * @brief A region of device memory handed out by the MemoryAllocator.
+ */
+struct MemoryAllocation {
+    MemoryAllocation();
+
+    [[nodiscard]] bool IsValid() const noexcept { return p_memory != VK_NULL_HANDLE; }
+    [[nodiscard]] bool IsDedicated() const noexcept { return m_block_index == constants::u32_max; }
+
+    VkDeviceMemory p_memory;
+    VkDeviceSize m_offset;
+    VkDeviceSize m_size;
+    void *p_mapped; ///< Host pointer to m_offset, null unless the memory type is host visible.
+    MemoryAllocator *p_allocator;
+    u32 m_block_index;
+    u32 m_memory_type;
+};
+
+/**
+ * @struct MemoryStatistics
+ * @brief Snapshot of the allocator state.
+ */
+struct MemoryStatistics {
+    MemoryStatistics();
+
+    u32 block_count;
+    u32 dedicated_allocation_count;
+    u32 allocation_count;
+    VkDeviceSize reserved_bytes; ///< Total device memory allocated from the driver.
+    VkDeviceSize used_bytes;
+    VkDeviceSize free_bytes;     ///< Unused bytes inside blocks.
+    VkDeviceSize largest_free_range;
+    f32 fragmentation;           ///< 0 when all free block memory is contiguous, approaching 1 when it is scattered.
+};
+
+/**
+ * @class MemoryAllocator
+ * @brief Sub-allocates buffers and images from large per-memory-type blocks.
+ *
+ * Each block keeps an offset sorted free list that is coalesced on free. Host visible blocks are mapped once for
+ * their whole lifetime. Requests larger than half a block get their own dedicated allocation.
+ */
+class MemoryAllocator {
+public:
+    /**
+     * @brief Constructs the allocator.
+     * @param device Logical device to allocate from.
+     * @param memory_properties Memory properties of the physical device.
+     * @param non_coherent_atom_size Granularity of flushes and invalidations of non coherent memory.
+     * @param block_size Size of each block in bytes.
+     */
+    MemoryAllocator(VkDevice device, const VkPhysicalDeviceMemoryProperties &memory_properties,
+                    VkDeviceSize non_coherent_atom_size, VkDeviceSize block_size = DEFAULT_BLOCK_SIZE);
+
+    /**
+     * @brief Frees all blocks. Any allocation still alive is reported as a leak.
+     */
+    ~MemoryAllocator();
+
+    MemoryAllocator(const MemoryAllocator &) = delete;
+    MemoryAllocator &operator=(const MemoryAllocator &) = delete;
+
+    /**
+     * @brief Allocates memory satisfying the given requirements.
+     * @param requirements Size, alignment and memory type bits of the resource.
+     * @param memory_type_index Memory type to allocate from.
+     * @param kind Whether the resource is linear or optimally tiled.
+     * @return The allocation, or an error message if the driver is out of memory.
+     */
+    [[nodiscard]] Expect<MemoryAllocation, String> Allocate(const VkMemoryRequirements &requirements,
+                                                            u32 memory_type_index, MemoryResourceKind kind);
+
+    /**
+     * @brief Returns an allocation to its block and resets it.
+     * @param allocation Allocation to free.
+     */
+    void Free(MemoryAllocation &allocation);
+
+    /**
+     * @brief Makes host writes to a mapped allocation visible to the device. Nothing to do for coherent memory.
+     * @param offset Start of the written range, relative to the allocation.
+     * @param size Bytes written, or VK_WHOLE_SIZE for the rest of the allocation.
+     */
+    void Flush(const MemoryAllocation &allocation, VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE) const;
+
+    /**
+     * @brief Makes device writes to a mapped allocation visible to the host. Nothing to do for coherent memory.
+     */
+    void Invalidate(const MemoryAllocation &allocation, VkDeviceSize offset = 0,
+                    VkDeviceSize size = VK_WHOLE_SIZE) const;
+
+    /**
+     * @brief Gathers statistics across all blocks.
+     */
+    [[nodiscard]] MemoryStatistics GetStatistics() const;
+
+    static constexpr VkDeviceSize DEFAULT_BLOCK_SIZE{64 * 1024 * 1024};
+
+private:
+    struct FreeRange {
+        VkDeviceSize m_offset;
+        VkDeviceSize m_size;
+    };
+
+    struct MemoryBlock {
+        VkDeviceMemory p_memory;
+        VkDeviceSize m_size;
+        VkDeviceSize m_used;
+        void *p_mapped;
+        u32 m_memory_type;
+        u32 m_allocation_count;
+        MemoryResourceKind m_kind;
+        Vector<FreeRange> m_free_ranges; ///< Sorted by offset, never adjacent.
+    };
+
+    [[nodiscard]] bool IsHostVisible(u32 memory_type_index) const;
+    [[nodiscard]] bool IsHostCoherent(u32 memory_type_index) const;
+    [[nodiscard]] std::optional<VkMappedMemoryRange> GetMappedRange(const MemoryAllocation &allocation,
+                                                                    VkDeviceSize offset, VkDeviceSize size) const;
+    [[nodiscard]] Expect<VkDeviceMemory, String> AllocateDeviceMemory(VkDeviceSize size, u32 memory_type_index,
+                                                                      void **mapped) const;
+    [[nodiscard]] std::optional<VkDeviceSize> AllocateFromBlock(MemoryBlock &block, VkDeviceSize size,
+                                                                VkDeviceSize alignment) const;
+    void FreeToBlock(MemoryBlock &block, VkDeviceSize offset, VkDeviceSize size) const;
+    void DestroyBlock(u32 block_index);
+
+private:
+    VkDevice p_device;
+    VkPhysicalDeviceMemoryProperties m_memory_properties;
+    VkDeviceSize m_non_coherent_atom_size;
+    VkDeviceSize m_block_size;
+
+    Vector<std::unique_ptr<MemoryBlock>> m_blocks; ///< Destroyed blocks leave a null slot that is reused.
+    u32 m_dedicated_allocation_count;
+    VkDeviceSize m_dedicated_bytes;
+
+    mutable std::mutex m_mutex;
+};
+
+} // namespace gouda::vk
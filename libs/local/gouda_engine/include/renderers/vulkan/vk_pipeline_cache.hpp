@@ -0,0 +1,62 @@
+#pragma once
+/**
+ * @file vk_pipeline_cache.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine vulkan pipeline cache module
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <span>
+
+#include <vulkan/vulkan.h>
+
+#include "core/types.hpp"
+
+namespace gouda::vk {
+
+class Device;
+
+/**
+ * @class PipelineCache
+ * @brief VkPipelineCache that is loaded from and saved to disk, so pipelines compiled on one run are reused on the
+ * next.
+ *
+ * The file starts with an engine header keyed by vendor, device, driver version and pipeline cache UUID, followed by
+ * the driver's cache data. A file that does not match the current device and driver, or whose data fails the size,
+ * checksum or Vulkan cache header checks, is ignored and the cache starts out empty.
+ */
+class PipelineCache {
+public:
+    /**
+     * @brief Creates the cache, seeded from filepath when the file holds a valid cache for this device.
+     * @param device Device the cache and all pipelines created with it belong to.
+     * @param filepath File the cache is loaded from and saved to.
+     */
+    PipelineCache(Device *device, StringView filepath);
+    ~PipelineCache();
+
+    PipelineCache(const PipelineCache &) = delete;
+    PipelineCache &operator=(const PipelineCache &) = delete;
+
+    /**
+     * @brief Writes the current cache contents to the file, creating its directory if needed.
+     * @return False if the data could not be retrieved or written, the cache itself stays valid.
+     */
+    bool Save() const;
+
+    [[nodiscard]] VkPipelineCache GetCache() const noexcept { return p_cache; }
+
+private:
+    [[nodiscard]] bool IsValid(std::span<const std::byte> file_data) const;
+
+private:
+    Device *p_device;
+    String m_filepath;
+    VkPipelineCache p_cache;
+};
+
+} // namespace gouda::vk
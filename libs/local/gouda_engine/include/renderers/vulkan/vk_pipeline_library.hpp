@@ -0,0 +1,66 @@
+#pragma once
+/**
+ * @file vk_pipeline_library.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine vulkan graphics pipeline library module
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <array>
+#include <mutex>
+
+#include <vulkan/vulkan.h>
+
+#include "containers/flat_hash_map.hpp"
+#include "core/types.hpp"
+
+namespace gouda::vk {
+
+/// The four parts VK_EXT_graphics_pipeline_library splits a graphics pipeline into
+enum class PipelineLibraryPart : u8 { VertexInput, PreRasterization, FragmentShader, FragmentOutput };
+
+inline constexpr size_t PIPELINE_LIBRARY_PART_COUNT{static_cast<size_t>(PipelineLibraryPart::FragmentOutput) + 1};
+
+/**
+ * @class PipelineLibraryCache
+ * @brief Pipeline library parts shared between graphics pipelines, so a new pipeline or variant compiles only the
+ * parts no earlier pipeline had and links the rest.
+ *
+ * Parts are keyed by what they were built from, with shaders identified by their code hash, so a hot reload that
+ * leaves a file unchanged reuses its parts. Parts live until the cache is destroyed, a linked pipeline does not need
+ * them but any later pipeline may. Safe to use from several threads, parts are created outside the lock.
+ */
+class PipelineLibraryCache {
+public:
+    /**
+     * @param pipeline_cache Cache the parts are compiled through, may be VK_NULL_HANDLE.
+     */
+    PipelineLibraryCache(VkDevice device, VkPipelineCache pipeline_cache);
+    ~PipelineLibraryCache();
+
+    PipelineLibraryCache(const PipelineLibraryCache &) = delete;
+    PipelineLibraryCache &operator=(const PipelineLibraryCache &) = delete;
+
+    /**
+     * @brief Returns the part built for key, compiling it from create_info the first time the key is asked for.
+     * @param create_info The graphics pipeline state of the part, the library flags and structure are added here.
+     * @return VK_NULL_HANDLE if the part could not be created, for the caller to fall back to a whole pipeline.
+     */
+    [[nodiscard]] VkPipeline GetOrCreate(PipelineLibraryPart part, u64 key,
+                                         const VkGraphicsPipelineCreateInfo &create_info);
+
+    [[nodiscard]] size_t GetPartCount() const;
+
+private:
+    VkDevice p_device;
+    VkPipelineCache p_pipeline_cache;
+
+    mutable std::mutex m_mutex;
+    std::array<FlatHashMap<u64, VkPipeline>, PIPELINE_LIBRARY_PART_COUNT> m_parts;
+};
+
+} // namespace gouda::vk
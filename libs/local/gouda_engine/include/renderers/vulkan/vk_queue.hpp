@@ -10,6 +10,9 @@
  * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
  * See <https://www.gnu.org/licenses/> for more information.
  */
+#include <deque>
+#include <memory>
+
 #include <vulkan/vulkan.h>
 
 #include "containers/small_vector.hpp"
@@ -18,40 +21,83 @@
 namespace gouda::vk {
 
 class Device;
-class Fence;
+class Semaphore;
 class Swapchain;
 
+/**
+ * @brief Timeline value meaning "no GPU work to wait for". Timeline semaphores start at zero.
+ */
+inline constexpr u64 NO_TIMELINE_VALUE{0};
+
 class Queue {
 
 public:
     Queue();
     ~Queue();
 
-    void Initialize(Device *device, Swapchain *swapchain, u32 queue_family, u32 queue_index);
+    void Initialize(Device *device, Swapchain *swapchain, u32 queue_family, u32 queue_index, u32 frames_in_flight);
+    void Initialize(Device *device, u32 queue_family, u32 queue_index); // For queues that never present
     void Destroy();
 
     [[nodiscard]] u32 AcquireNextImage(u32 frame_index);
 
-    void Submit(VkCommandBuffer command_buffer, u32 frame_index, const Fence *fence = nullptr); // For render loop
-    void Submit(VkCommandBuffer command_buffer, const Fence *fence = nullptr) const;                  // For standalone ops
-    void SetSwapchain(Swapchain *swapchain) { p_swapchain = swapchain; }
-    void Present(u32 image_index, u32 frame_index);
+    // Both submits signal the queue timeline semaphore and return the value it will reach once the work completes
+    [[nodiscard]] u64 Submit(VkCommandBuffer command_buffer, u32 frame_index, u32 image_index); // For render loop
+    [[nodiscard]] u64 Submit(VkCommandBuffer command_buffer, u32 frame_index, u32 image_index,
+                             VkSemaphore wait_semaphore, u64 wait_value,
+                             VkPipelineStageFlags wait_stage); // Render loop waiting on another queue
+    [[nodiscard]] u64 Submit(VkCommandBuffer command_buffer);                                  // For standalone ops
+    [[nodiscard]] u64 Submit(VkCommandBuffer command_buffer, VkSemaphore wait_semaphore, u64 wait_value,
+                             VkPipelineStageFlags wait_stage); // Standalone op waiting on another queue's timeline
+    // Semaphores of the previous swapchain that have to be replaced are destroyed once its last frame completes
+    void SetSwapchain(Swapchain *swapchain);
+    void Present(u32 image_index);
+    // Presents are numbered from one when the device supports present wait, zero before the first
+    [[nodiscard]] u64 GetLastPresentId() const noexcept { return m_present_id; }
+
+    // Timeline progress, these only block on the exact submission they are given rather than the whole queue
+    void WaitForValue(u64 value, u64 timeout = constants::u64_max) const;
+    [[nodiscard]] bool IsComplete(u64 value) const;
+    [[nodiscard]] u64 GetCompletedValue() const;
+    [[nodiscard]] u64 GetLastSubmittedValue() const noexcept { return m_timeline_value; }
+    [[nodiscard]] VkSemaphore GetTimelineSemaphore() const noexcept;
 
     void WaitIdle() const;
 
+    [[nodiscard]] u32 GetQueueFamily() const noexcept { return m_queue_family; }
+    [[nodiscard]] u32 GetFramesInFlight() const noexcept { return m_frames_in_flight; }
     [[nodiscard]] static u32 GetMaxFramesInFlight() noexcept { return MAX_FRAMES_IN_FLIGHT; }
 
 private:
     void CreateSemaphores();
+    void CreateRenderCompleteSemaphores();
+    void DestroyRenderCompleteSemaphores();
+    void DestroyRetiredSemaphores(bool destroy_all);
 
 private:
     Device *p_device;
     Swapchain *p_swapchain;
     VkQueue p_queue;
+    u32 m_queue_family;
 
     static constexpr u32 MAX_FRAMES_IN_FLIGHT = 4;
+    u32 m_frames_in_flight;
+
+    std::unique_ptr<Semaphore> p_timeline_semaphore;
+    u64 m_timeline_value;
+    u64 m_present_id;
+    bool m_reported_suboptimal; // Suboptimal swapchains are logged once each, some stay suboptimal for good
+
+    // Acquire semaphores are owned by a frame in flight, render complete semaphores by the swapchain image they are
+    // presented with, so a semaphore is never re-signalled while the presentation engine may still be waiting on it.
     SmallVector<VkSemaphore, MAX_FRAMES_IN_FLIGHT> p_present_complete_semaphores;
     SmallVector<VkSemaphore, MAX_FRAMES_IN_FLIGHT> p_render_complete_semaphores;
+
+    struct RetiredSemaphores {
+        u64 timeline_value; // The last submission that may signal them, their presents follow it
+        SmallVector<VkSemaphore, MAX_FRAMES_IN_FLIGHT> semaphores;
+    };
+    std::deque<RetiredSemaphores> m_retired_semaphores;
 };
 
 } // namespace gouda::vk
\ No newline at end of file
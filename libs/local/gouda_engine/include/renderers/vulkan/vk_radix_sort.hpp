@@ -0,0 +1,101 @@
+#pragma once
+/**
+ * @file vk_radix_sort.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine vulkan GPU radix sort module
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <array>
+#include <memory>
+#include <span>
+
+#include <vulkan/vulkan.h>
+
+#include "containers/small_vector.hpp"
+#include "core/types.hpp"
+#include "renderers/vulkan/vk_buffer.hpp"
+#include "renderers/vulkan/vk_compute_pipeline.hpp"
+
+namespace gouda::vk {
+
+class BufferManager;
+class Device;
+class Renderer;
+class Shader;
+
+// Push constants of the radix sort shaders
+struct RadixSortParams {
+    u32 shift;        // Of the digit sorted by this pass
+    u32 count_offset; // In u32s, of the element count within the count buffer
+    u32 block_count;  // Workgroups of the histogram and scatter dispatches
+};
+
+/**
+ * @class GpuRadixSort
+ * @brief Sorts up to max_count key and value pairs by their 32 bit keys on the GPU, smallest key first.
+ *
+ * A least significant digit radix sort of RADIX_BITS per pass. Every pass counts the digits of each block of keys,
+ * scans the counts into offsets in a single workgroup and scatters the pairs, keeping the order of equal digits so the
+ * sort is stable. The pass count is even, the sorted pairs end up in the buffers they were written to.
+ *
+ * The element count is read on the GPU from a count buffer, such as the instance count of an indirect draw written by
+ * an earlier pass, so the CPU never needs to know it. Every frame slot has its own buffers and descriptor sets.
+ */
+class GpuRadixSort {
+public:
+    static constexpr u32 RADIX_BITS{4};
+    static constexpr u32 PASS_COUNT{32 / RADIX_BITS};
+    static constexpr u32 BLOCK_SIZE{4096}; // Keys per workgroup, mirrors the shaders
+    static_assert(PASS_COUNT % 2 == 0, "The sorted pairs have to end up in the front buffers");
+
+    // count_buffers holds one buffer per frame slot or one shared one, the count is the u32 at count_offset in it
+    GpuRadixSort(Renderer &renderer, Device *device, const BufferManager *buffer_manager,
+                 const Shader *histogram_shader, const Shader *scan_shader, const Shader *scatter_shader, u32 max_count,
+                 u32 frame_count, std::span<const Buffer> count_buffers, u32 count_offset,
+                 std::span<const u32> queue_families = {});
+    ~GpuRadixSort();
+
+    GpuRadixSort(const GpuRadixSort &) = delete;
+    GpuRadixSort &operator=(const GpuRadixSort &) = delete;
+
+    // Written by the caller's own passes before Record, and read back sorted after it
+    [[nodiscard]] std::span<const Buffer> GetKeyBuffers() const
+    {
+        return {m_key_buffers[0].data(), m_key_buffers[0].size()};
+    }
+    [[nodiscard]] std::span<const Buffer> GetValueBuffers() const
+    {
+        return {m_value_buffers[0].data(), m_value_buffers[0].size()};
+    }
+    [[nodiscard]] VkDeviceSize GetBufferSize() const { return sizeof(u32) * static_cast<VkDeviceSize>(m_max_count); }
+
+    /**
+     * @brief Records the sort of a frame slot's pairs. Writes to the pairs and the count before it have to be made
+     * visible to compute shaders by the caller, as do the sorted pairs to whatever reads them after it.
+     */
+    void Record(VkCommandBuffer command_buffer, u32 frame_index) const;
+
+private:
+    Device *p_device;
+    u32 m_max_count;
+    u32 m_block_count;
+
+    // Front and back buffers per frame slot, the passes ping-pong between them
+    std::array<Vector<Buffer>, 2> m_key_buffers;
+    std::array<Vector<Buffer>, 2> m_value_buffers;
+    Vector<Buffer> m_histogram_buffers; // Digit counts of every block, digit major, scanned in place
+
+    // Descriptor set 2 * frame + parity reads the front buffers when parity is 0 and the back buffers when it is 1
+    std::unique_ptr<ComputePipeline> p_histogram_pipeline;
+    std::unique_ptr<ComputePipeline> p_scan_pipeline;
+    std::unique_ptr<ComputePipeline> p_scatter_pipeline;
+
+    std::array<RadixSortParams, PASS_COUNT> m_pass_params;
+};
+
+} // namespace gouda::vk
@@ -0,0 +1,281 @@
+#pragma once
+/**
+ * @file vk_render_graph.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine vulkan render graph module
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <deque>
+#include <functional>
+
+#include <vulkan/vulkan.h>
+
+#include "containers/small_vector.hpp"
+#include "core/types.hpp"
+#include "memory/allocators/linear_allocator.hpp"
+#include "renderers/vulkan/vk_memory_allocator.hpp"
+
+namespace gouda::vk {
+
+class Device;
+class BufferManager;
+class Queue;
+
+using RenderGraphResource = u32;
+inline constexpr RenderGraphResource INVALID_RENDER_GRAPH_RESOURCE{constants::u32_max};
+
+/**
+ * @enum ResourceUsage
+ * @brief How a pass touches a resource, each one maps to the stages, accesses and image layout synchronized against.
+ */
+enum class ResourceUsage : u8 {
+    None,
+    TransferRead,
+    TransferWrite,
+    ComputeRead,     // Storage buffer or image read in a compute shader
+    ComputeWrite,    // Storage buffer or image read and written in a compute shader
+    ComputeSampled,
+    IndirectRead,    // Indirect draw or dispatch arguments
+    VertexRead,      // Vertex or instance attributes
+    FragmentRead,    // Storage buffer read in a fragment shader
+    FragmentSampled,
+    ColourAttachment,
+    DepthAttachment,
+    Present
+};
+
+/**
+ * @struct ImportedImage
+ * @brief An image owned outside the graph, such as a swapchain image, and the states it enters and leaves it in.
+ */
+struct ImportedImage {
+    VkImage image;
+    VkImageView view;
+    VkFormat format;
+    VkExtent2D extent;
+    ResourceUsage initial_usage; // Last use before the graph runs, its stages are waited on before the first one
+    ResourceUsage final_usage;   // Transitioned to after the last pass, None leaves the image as the last pass did
+    bool keep_contents;          // Otherwise the first use starts from an undefined layout and discards them
+};
+
+/**
+ * @class RenderGraph
+ * @brief Passes that declare what they read and write, recorded in order with the barriers between them derived.
+ *
+ * The graph is rebuilt every frame: Reset, import the persistent resources and declare the transient ones, add the
+ * passes, then Compile and Execute. Compile culls passes whose results nothing uses. A pass survives when it has side
+ * effects, writes an imported resource, which outlives the frame, or writes something a surviving pass reads.
+ *
+ * Barriers are placed before the pass that needs them. Memory dependencies share one global memory barrier and layout
+ * transitions are batched into a second vkCmdPipelineBarrier, so a pass records at most two. Reads already made
+ * visible to a stage since the last write get none. Imported buffers start untracked, work on them from earlier
+ * submissions is for the importer to synchronize.
+ *
+ * Transient images are created by the graph and only live between their first and last pass. Those whose lifetimes
+ * do not overlap share memory, each starting from an undefined layout after the previous occupant's last access. The
+ * same declarations next frame reuse the images, a change retires them until the frames using them complete.
+ */
+class RenderGraph {
+public:
+    using RecordFunction = std::function<void(VkCommandBuffer)>;
+
+    class PassBuilder {
+    public:
+        PassBuilder &Read(RenderGraphResource resource, ResourceUsage usage);
+        PassBuilder &Write(RenderGraphResource resource, ResourceUsage usage);
+
+        /**
+         * @brief Renders to the image, the graph begins and ends dynamic rendering around the pass.
+         * The store op is derived, results nothing reads afterwards are not stored.
+         */
+        PassBuilder &SetColourAttachment(RenderGraphResource resource, VkAttachmentLoadOp load_op,
+                                         VkClearColorValue clear_colour = {});
+        PassBuilder &SetDepthAttachment(RenderGraphResource resource, VkAttachmentLoadOp load_op,
+                                        VkClearDepthStencilValue clear_value = {1.0f, 0});
+
+        /**
+         * @brief Flags passed to vkCmdBeginRendering, such as recording the contents in secondary command buffers.
+         */
+        PassBuilder &SetRenderingFlags(VkRenderingFlags flags);
+
+        /**
+         * @brief Keeps the pass even when nothing reads what it writes.
+         */
+        PassBuilder &SetSideEffects();
+
+        PassBuilder &SetRecord(RecordFunction record);
+
+    private:
+        friend class RenderGraph;
+        PassBuilder(RenderGraph *graph, u32 pass_index) : p_graph{graph}, m_pass_index{pass_index} {}
+
+        RenderGraph *p_graph;
+        u32 m_pass_index;
+    };
+
+    RenderGraph(Device *device, BufferManager *buffer_manager, const Queue *queue);
+    ~RenderGraph();
+
+    RenderGraph(const RenderGraph &) = delete;
+    RenderGraph &operator=(const RenderGraph &) = delete;
+
+    /**
+     * @brief Clears the passes and resources of the previous frame, its transient images are kept for reuse.
+     */
+    void Reset();
+
+    [[nodiscard]] RenderGraphResource ImportBuffer(StringView name, VkBuffer buffer);
+    [[nodiscard]] RenderGraphResource ImportImage(StringView name, const ImportedImage &image);
+    [[nodiscard]] RenderGraphResource CreateTransientImage(StringView name, VkFormat format, VkExtent2D extent);
+
+    [[nodiscard]] PassBuilder AddPass(StringView name);
+
+    /**
+     * @brief Culls unused passes, places the transient images and plans the barriers.
+     * @param scratch Working memory for the compile, only needed until it returns.
+     */
+    void Compile(LinearAllocator &scratch);
+
+    /**
+     * @brief Records the surviving passes and their barriers, then the final transitions of imported images.
+     */
+    void Execute(VkCommandBuffer command_buffer);
+
+    /**
+     * @brief Destroys transient images retired by a change in declarations once the frames using them completed.
+     * @param destroy_all Also those still in use, only once the device is idle.
+     */
+    void DestroyRetired(bool destroy_all);
+
+    /**
+     * @brief Transient images are only valid once the graph has been compiled, passes look them up when recording.
+     */
+    [[nodiscard]] VkImage GetImage(RenderGraphResource resource) const;
+    [[nodiscard]] VkImageView GetImageView(RenderGraphResource resource) const;
+
+    [[nodiscard]] u32 GetCulledPassCount() const noexcept { return m_culled_pass_count; }
+    [[nodiscard]] u32 GetBarrierCount() const noexcept { return m_barrier_count; }
+    [[nodiscard]] VkDeviceSize GetTransientMemorySize() const noexcept { return m_transient_memory_size; }
+
+private:
+    enum class ResourceKind : u8 { Buffer, Image };
+
+    // Synchronization state of a resource while the passes are planned
+    struct ResourceState {
+        VkImageLayout layout;
+        VkPipelineStageFlags write_stages; // Of the last write, or layout transition
+        VkAccessFlags write_access;
+        VkPipelineStageFlags read_stages;  // Reads since the last write, each already synchronized with it
+        VkAccessFlags read_access;
+    };
+
+    struct Resource {
+        String name;
+        ResourceKind kind;
+        bool imported;
+        VkBuffer buffer;
+        VkImage image;
+        VkImageView view;
+        VkFormat format;
+        VkExtent2D extent;
+        VkImageUsageFlags usage;   // Transient images, gathered from the passes
+        ResourceUsage final_usage; // Imported images
+        ResourceState state;
+        u32 first_pass;            // Lifetime over the surviving passes, transient images only
+        u32 last_pass;
+        u32 last_read_pass;        // Last surviving pass that needs the contents, decides attachment store ops
+        u32 transient_index;       // Into m_transients once placed
+    };
+
+    struct Access {
+        RenderGraphResource resource;
+        ResourceUsage usage;
+        bool write;
+    };
+
+    struct Attachment {
+        RenderGraphResource resource{INVALID_RENDER_GRAPH_RESOURCE};
+        VkAttachmentLoadOp load_op{VK_ATTACHMENT_LOAD_OP_DONT_CARE};
+        VkAttachmentStoreOp store_op{VK_ATTACHMENT_STORE_OP_STORE};
+        VkClearValue clear_value{};
+    };
+
+    struct Pass {
+        String name;
+        SmallVector<Access, 8> accesses;
+        Attachment colour_attachment;
+        Attachment depth_attachment;
+        VkRenderingFlags rendering_flags;
+        RecordFunction record;
+        bool side_effects;
+        bool culled;
+
+        // Planned by Compile, layout transitions apart so they do not widen the stages buffers wait on
+        VkPipelineStageFlags memory_src_stages;
+        VkPipelineStageFlags memory_dst_stages;
+        VkMemoryBarrier memory_barrier;
+        VkPipelineStageFlags image_src_stages;
+        VkPipelineStageFlags image_dst_stages;
+        SmallVector<VkImageMemoryBarrier, 4> image_barriers;
+    };
+
+    // An image the graph created and the memory range it is bound to, which aliasing images share
+    struct TransientImage {
+        VkFormat format;
+        VkExtent2D extent;
+        VkImageUsageFlags usage;
+        u32 first_pass;
+        u32 last_pass;
+        VkImage image;
+        VkImageView view;
+        u32 memory_slot;
+    };
+
+    struct MemorySlot {
+        MemoryAllocation allocation;
+        VkPipelineStageFlags last_stages; // Of the last occupant's last accesses, carried into the next frame
+        VkAccessFlags last_access;
+    };
+
+    struct RetiredTransients {
+        u64 timeline_value;
+        Vector<TransientImage> images;
+        Vector<MemorySlot> memory_slots;
+    };
+
+    [[nodiscard]] u32 AddResource(Resource &&resource);
+    void CullPasses(LinearAllocator &scratch);
+    void PlaceTransients(LinearAllocator &scratch);
+    void CreateTransients(LinearAllocator &scratch);
+    void PlanBarriers();
+    void PlanAccess(Pass &pass, u32 pass_index, const Access &access);
+    void RecordPass(VkCommandBuffer command_buffer, Pass &pass) const;
+    void DestroyTransients(Vector<TransientImage> &images, Vector<MemorySlot> &memory_slots) const;
+
+private:
+    Device *p_device;
+    BufferManager *p_buffer_manager;
+    const Queue *p_queue;
+
+    Vector<Resource> m_resources;
+    Vector<Pass> m_passes;
+    Vector<TransientImage> m_transients; // Persist from frame to frame while the declarations stay the same
+    Vector<MemorySlot> m_memory_slots;
+    std::deque<RetiredTransients> m_retired_transients;
+
+    VkPipelineStageFlags m_final_src_stages;
+    VkPipelineStageFlags m_final_dst_stages;
+    SmallVector<VkImageMemoryBarrier, 2> m_final_barriers;
+
+    u32 m_culled_pass_count;
+    u32 m_barrier_count;
+    VkDeviceSize m_transient_memory_size;
+    bool m_is_compiled;
+};
+
+} // namespace gouda::vk
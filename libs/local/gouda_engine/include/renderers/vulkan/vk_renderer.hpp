@@ -10,188 +10,802 @@
  * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
  * See <https://www.gnu.org/licenses/> for more information.
  */
+#include <deque>
+#include <array>
+#include <future>
+#include <optional>
+#include <span>
+#include <utility>
+
 #define GLFW_INCLUDE_VULKAN
 #include <GLFW/glfw3.h>
 
 #include "imgui.h"
 
+#include "cameras/orthographic_camera.hpp"
+#include "containers/flat_hash_map.hpp"
+#include "containers/slot_map.hpp"
+#include "debug/debug_draw.hpp"
+#include "math/collision.hpp"
 #include "math/math.hpp"
+#include "memory/allocators/linear_allocator.hpp"
+#include "memory/allocators/tracking_allocator.hpp"
 #include "renderers/render_data.hpp"
+#include "renderers/render_queue.hpp"
 #include "renderers/text.hpp"
+#include "renderers/tilemap.hpp"
 #include "renderers/vulkan/vk_buffer.hpp"
 #include "renderers/vulkan/vk_device.hpp"
+#include "renderers/vulkan/vk_gpu_timer.hpp"
 #include "renderers/vulkan/vk_queue.hpp"
 #include "renderers/vulkan/vk_swapchain.hpp"
 #include "renderers/vulkan/vk_texture_manager.hpp"
+#include "utils/file_watcher.hpp"
+#include "utils/worker_pool.hpp"
 
 namespace gouda::vk {
 
 class Device;
-class Fence;
 struct Texture;
 class Instance;
 class Shader;
 class DepthResources;
 class GraphicsPipeline;
+class SpecializationConstants;
 class ComputePipeline;
+class GpuRadixSort;
 class CommandBufferManager;
+class PipelineCache;
+class PipelineLibraryCache;
+class RenderGraph;
+class FrameCapture;
+class GlyphCache;
+class ThumbnailCache;
+struct Thumbnail;
+class DescriptorAllocator;
+class LayoutCache;
+enum class PipelineType : u8;
 
 struct RenderStatistics {
     RenderStatistics();
 
     f32 delta_time;
+    f32 fence_wait_time; // Milliseconds blocked on the frame slot and its swapchain image becoming free
+    f32 present_latency; // Milliseconds blocked acquiring and presenting the swapchain image
     u32 quad_count;
+    u32 quad_draw_count;          // Batches the render queue split the quads into, one indirect draw per pipeline
+    u32 static_quad_count;        // Quads resident on the GPU, the visible count is never read back
+    u32 static_quad_update_count; // Static quads uploaded this frame
+    u32 tile_count;               // Tiles of the tilemap resident on the GPU
+    u32 tile_chunk_count;
+    u32 visible_tile_chunk_count; // Chunks that survived the CPU cull this frame, summed over the viewports
+    u32 viewport_count;
     u32 vertex_count;
     u32 index_count;
-    u32 particle_count;
+    u32 particle_count;       // CPU simulated particles, GPU particles are never read back
+    u32 particle_spawn_count; // Particles handed to the GPU emitter this frame
+    u32 light_count;
+    u32 render_target_update_count; // Targets redrawn this frame
+    f32 render_scale;               // The world's resolution relative to the framebuffer this frame
     u32 glyph_count;
+    u32 debug_draw_count; // Shapes and glyphs of the DebugDraw overlay, included in the quad and glyph counts
     u32 total_instances;
     u32 texture_count;
     u32 font_count;
+    u32 cached_glyph_count;    // Rasterized at runtime and resident in the glyph cache's pages
+    u32 thumbnail_count;       // Resident in the thumbnail cache's pages
+    u32 barrier_count;         // Pipeline barriers the render graph recorded
+    u32 culled_pass_count;     // Render graph passes nothing used the results of
+    u32 sampler_count;         // Distinct samplers, shared by every texture with the same state
+    u32 descriptor_pool_count; // Pipeline and per frame pools together
+    u32 pipeline_layout_count; // Distinct layouts, shared by every graphics pipeline with the same bindings
+    u64 transient_memory;      // Bytes bound to the render graph's transient images
+    u64 uploaded_bytes;        // Staged for upload during the last frame
+    u32 descriptor_write_count; // Descriptors updated during the last frame
+    bool is_command_buffer_reused; // Submitted as recorded for an earlier frame of the same structure
+    MemoryStatistics memory;
+    GpuTimings gpu_timings; // Of the frame that last used this frame's slot, frames in flight frames back
+};
+
+// A region of the window the world is drawn into from its own camera, see Renderer::SetViewports
+struct RenderViewport {
+    UniformData camera;                             // wvp_static places the quads drawn without camera effects
+    OrthographicCamera::FrustumData cull_frustum{}; // Static quads and tile chunks are culled against it
+    Vec2 offset{0.0f};                              // Top left corner, as fractions of the window
+    Vec2 size{1.0f};                                // Fractions of the window
 };
 
 class Renderer {
 public:
+    static constexpr u32 DEFAULT_FRAMES_IN_FLIGHT{2};
+    static constexpr StringView DEFAULT_PIPELINE_CACHE_PATH{"cache/pipeline_cache.bin"};
+    static constexpr u32 MAX_PARTICLE_SPAWNS_PER_FRAME{4096};
+    static constexpr u32 MAX_STATIC_QUAD_UPDATES_PER_FRAME{4096};
+    static constexpr u32 QUAD_VERTEX_COUNT{6}; // Quads are drawn without a vertex or index buffer
+    static constexpr u64 NO_FRAME_STRUCTURE{0};
+    static constexpr u32 MAX_PARTICLE_COLLIDERS{4096};
+    static constexpr u32 MAX_PARTICLE_COLLISION_CELLS{16384};
+    static constexpr u32 MAX_PARTICLE_COLLISION_ENTRIES{32768}; // Collider indices over all cells
+    static constexpr u32 MAX_ANIMATION_CLIPS{1024};
+    static constexpr u32 MAX_ANIMATION_FRAMES{16384};
+    static constexpr u32 MAX_LIGHTS{1024};
+    static constexpr u32 LIGHT_TILE_SIZE{16};  // Pixels, doubled until the screen fits in MAX_LIGHT_TILES tiles
+    static constexpr u32 MAX_LIGHT_TILES{16384};
+    static constexpr u32 LIGHT_TILE_STRIDE{64}; // A light count and up to 63 light indices, mirrors the shaders
+    static constexpr u32 MAX_RENDER_TARGET_QUADS_PER_FRAME{16384};
+    static constexpr f32 MIN_RENDER_SCALE{0.25f};
+    static constexpr Milliseconds DEBUG_UI_REFRESH_INTERVAL{50};
+    // Each pass is recorded into its own secondary command buffer, the primary executes them in this order. With a
+    // render scale below one the world passes go first in a pass of their own, Upscale leads the native ones.
+    enum class DrawPass : u32 { StaticQuads, Quads, Particles, ImGui, Upscale };
+    static constexpr u32 DRAW_PASS_COUNT{static_cast<u32>(DrawPass::Upscale) + 1};
+    using TextHandle = SlotHandle; // Goes stale once its text is destroyed, even if the slot is reused
+
     Renderer();
     ~Renderer();
 
+    // The pipeline cache is loaded from pipeline_cache_path here and saved back to it on destruction. A non empty
+    // preferred_device picks the GPU whose name contains it over the best scoring one.
     void Initialize(GLFWwindow *window_ptr, StringView app_name, SemVer vulkan_api_version = SemVer{1, 4, 0, 0},
-                    VSyncMode vsync_mode = VSyncMode::Enabled);
-
-    void RecordCommandBuffer(VkCommandBuffer command_buffer, u32 image_index, u32 quad_instance_count,
-                             u32 text_instance_count, u32 particle_instance_count, ImDrawData *draw_data) const;
-
+                    VSyncMode vsync_mode = VSyncMode::Enabled, u32 frames_in_flight = DEFAULT_FRAMES_IN_FLIGHT,
+                    StringView pipeline_cache_path = DEFAULT_PIPELINE_CACHE_PATH, StringView preferred_device = {});
+
+    void RecordCommandBuffer(VkCommandBuffer command_buffer, u32 frame_index, u32 image_index,
+                             std::span<const RenderViewport> viewports, u32 quad_instance_count,
+                             u32 particle_instance_count, ImDrawData *draw_data, bool capture_frame = false) const;
+
+    // Everything RecordCommandBuffer bakes into the command buffer rather than reading from memory at execution:
+    // counts, pipelines, attachments, camera push constants and CPU culled ranges. Render submits the slot's command
+    // buffers as they are when the structure is the one they were recorded for, only buffer contents differ then.
+    // NO_FRAME_STRUCTURE for frames that record one off work, such as uploads, ImGui or a capture.
+    [[nodiscard]] u64 HashFrameStructure(u32 image_index, std::span<const RenderViewport> viewports,
+                                         u32 quad_instance_count, u32 particle_instance_count,
+                                         const ImDrawData *draw_data, bool capture_frame) const;
+
+    // quad_instances include the glyphs of DrawText, retained texts are added to them. particle_instances are only
+    // drawn on the CPU path, compute particles are added with EmitParticles.
     void Render(f32 delta_time, const UniformData &uniform_data, const std::vector<InstanceData> &quad_instances,
-                const std::vector<TextData> &text_instances, const std::vector<ParticleData> &particle_instances);
-
-    void UpdateComputeUniformBuffer(u32 image_index, f32 delta_time);
-    void UpdateParticleStorageBuffer(u32 image_index, const std::vector<ParticleData> &particle_instances) const;
-    void ClearParticleBuffers(u32 image_index) const;
+                const std::vector<ParticleData> &particle_instances);
+
+    // Builds the debug UI on the calling thread for the next Render to draw, so Render can run on another thread.
+    // GLFW's ImGui backend reads the window, which only the main thread may do. Shows the frame before's statistics.
+    void BuildDebugUI();
+
+    // Queues particles for the GPU emitter. Up to MAX_PARTICLE_SPAWNS_PER_FRAME are uploaded per frame and the rest
+    // carry over, spawns are dropped on the GPU while the particle pool is full.
+    void EmitParticles(std::span<const ParticleData> particles);
+    // Lower limits for slower hardware, see utils/quality_governor.hpp. Below MAX_PARTICLE_SPAWNS_PER_FRAME the spawns
+    // taken off the queue each frame are thinned evenly down to the limit, the queue still drains at the full rate so
+    // effects get sparser rather than late. Below MAX_LIGHTS only the first lights given are drawn.
+    void SetParticleSpawnLimit(const u32 limit)
+    {
+        m_particle_spawn_limit = math::min(limit, MAX_PARTICLE_SPAWNS_PER_FRAME);
+    }
+    void SetLightLimit(const u32 limit) { m_light_limit = math::min(limit, MAX_LIGHTS); }
+
+    void UpdateComputeUniformBuffer(u32 frame_index, f32 delta_time, u32 spawn_count);
+    void UpdateParticleStorageBuffer(u32 frame_index, const std::vector<ParticleData> &particle_instances) const;
+    void ClearParticleBuffers(u32 frame_index) const;
 
     void ToggleComputeParticles();
     bool UseComputeParticles() const { return m_use_compute_particles; }
 
+    // Radix sorts the compute particles back to front on the GPU before they are drawn, so blending composites them
+    // in order. Off, they are drawn in whatever order the compaction appended them.
+    void SetParticleDepthSort(bool enabled);
+    bool UseParticleDepthSort() const { return m_sort_particles; }
+
+    // Static level bounds the compute particles bounce off, kept until replaced. They are binned into a uniform grid
+    // of cell_size cells, doubled until the grid fits in MAX_PARTICLE_COLLISION_CELLS cells and
+    // MAX_PARTICLE_COLLISION_ENTRIES indices, and each frame slot copies it once after a change. A particle's centre
+    // is tested against the colliders of its own cell only. Up to MAX_PARTICLE_COLLIDERS are used.
+    void SetParticleColliders(std::span<const math::AABB2D> colliders, f32 cell_size, f32 restitution = 0.5f);
+
+    // Pushes the compute particles around by noise drifting over time, as ParticleStore::SetTurbulence does the CPU
+    // ones. strength is the acceleration at full noise, frequency the noise cells per world unit. Either at 0 turns
+    // it off.
+    void SetParticleTurbulence(f32 strength, f32 frequency);
+
+    // Runs the particle simulation on the async compute queue when the device has one
+    void SetAsyncCompute(bool enabled);
+    bool UseAsyncCompute() const { return m_use_async_compute; }
+    bool SupportsAsyncCompute() const { return p_device && p_device->HasAsyncComputeQueue(); }
+
+    // Static quads stay resident in a device local buffer and are drawn every frame, before the dynamic quads passed
+    // to Render, with the opaque quad pipeline in no particular order. With GPU culling on, a compute pass culls them
+    // against the frustum given to SetCullFrustum first, so the CPU only touches them when they change.
+    // SetStaticQuadInstances replaces the whole set and waits for frames in flight, use it when loading a level.
+    void SetStaticQuadInstances(std::span<const InstanceData> instances);
+    // Overwrites instances from first_instance on, growing the set when the range ends past it. Only the changed
+    // ranges are uploaded, up to MAX_STATIC_QUAD_UPDATES_PER_FRAME instances per frame with the rest carried over.
+    void UpdateStaticQuadInstances(u32 first_instance, std::span<const InstanceData> instances);
+    void SetCullFrustum(const OrthographicCamera::FrustumData &frustum);
+
+    // Split screen, each viewport draws the world into its part of the window from its own camera and scissor. Quads
+    // and particles are uploaded once per frame and every viewport draws them from the same buffers and indirect
+    // commands, its scissor clips the rest. Static quads are culled on the GPU for all viewports in one dispatch, each
+    // into its own indirect command, and tile chunks on the CPU into each viewport's own ranges, so N viewports cost
+    // N sets of draws rather than N frames. Up to MAX_VIEWPORTS, kept until replaced. While set, the uniform data
+    // given to Render and the frustum given to SetCullFrustum are ignored, ImGui still covers the whole window. An
+    // empty span goes back to a single viewport over the window.
+    void SetViewports(std::span<const RenderViewport> viewports);
+    u32 GetViewportCount() const { return m_viewports.empty() ? 1u : static_cast<u32>(m_viewports.size()); }
+
+    // A tilemap is built into chunks of chunk_size by chunk_size tiles and uploaded once to a device local buffer.
+    // Every frame its chunks are culled on the CPU against the frustum given to SetCullFrustum and the visible ones
+    // drawn after the static quads, one draw per run of adjacent chunks, so the cost is per chunk rather than per
+    // tile. Replacing or clearing it waits for frames in flight, use it when loading a level.
+    void SetTilemap(const Tilemap &tilemap, u32 chunk_size = Tilemap::DEFAULT_CHUNK_SIZE);
+    void ClearTilemap();
+    void ToggleGpuCulling();
+    bool UseGpuCulling() const { return m_use_gpu_culling; }
+
+    // Frame tables quads with an animation clip are animated from, kept until replaced and copied once into each
+    // frame slot after a change. The quad vertex shader picks the frame from the clip, the instance's start time and
+    // the time last given to SetAnimationTime, so looping instances never need rebuilding. Up to MAX_ANIMATION_CLIPS
+    // clips and MAX_ANIMATION_FRAMES frames, a table that does not fit is dropped.
+    void SetAnimationClips(std::span<const AnimationClipData> clips, std::span<const AnimationFrameData> frames);
+    void SetAnimationTime(const f32 time) { m_animation_time = time; }
+
+    // Point lights on every quad drawn with camera effects, kept until replaced. Each frame a compute pass sorts them
+    // into screen tiles and a fragment only sums the lights of its own tile, so the cost follows the lights that
+    // actually overlap it. Up to MAX_LIGHTS are used, and up to LIGHT_TILE_STRIDE - 1 per tile.
+    void SetLights(std::span<const PointLight> lights);
+    // What lit quads get with no light on them. Full white by default, so quads look unlit until this is changed.
+    void SetAmbientLight(const Colour<f32> &colour);
+
+    // Offscreen targets for layers that rarely change, such as parallax backgrounds, a minimap or UI panels. A target
+    // is a texture slot drawn like any other texture, through its id, that keeps its contents until it is updated.
+    // Updates are drawn at the next Render with the quad pipelines, ahead of the scene, so a target left alone costs
+    // one sampled quad per frame wherever it is drawn. Targets live as long as the renderer.
+    [[nodiscard]] u32 CreateRenderTarget(u32 width, u32 height);
+    // Replaces a target's contents with quads seen through view_projection, they are never lit. Only the last update
+    // before a Render is drawn. Up to MAX_RENDER_TARGET_QUADS_PER_FRAME quads are drawn per frame, the targets that do
+    // not fit wait for the next one. Textures still loading are drawn as their placeholder. Sampling a target while
+    // drawing another in the same frame is not ordered.
+    void UpdateRenderTarget(u32 texture_id, const Mat4 &view_projection, std::span<const InstanceData> quads,
+                            const Colour<f32> &clear_colour = Colour(0.0f));
+
+    // For fill rate bound scenes. The world (static quads, quads and particles) is rendered at scale times the
+    // framebuffer size and upscaled to it with a sharpening filter, text included as it is drawn as quads. ImGui stays
+    // at native resolution. Clamped to [MIN_RENDER_SCALE, 1], 1 renders everything natively in one pass.
+    void SetRenderScale(f32 scale);
+    [[nodiscard]] f32 GetRenderScale() const { return m_render_scale; }
+    // From 0, plain bilinear filtering, to 1
+    void SetUpscaleSharpness(f32 sharpness);
+    // Lowers the scale used while the GPU frame time is above target_gpu_time milliseconds and raises it again while
+    // there is room, up to the scale given to SetRenderScale. 0 turns it off.
+    void SetDynamicRenderScale(f32 target_gpu_time);
+
+    // Shader and texture hot reload, enabled by default in debug builds. A watcher thread reports written files and
+    // Render drains its queue, so nothing is polled on the main thread. Changed graphics shaders are rebuilt into new
+    // pipelines off the main thread and swapped in at the next frame boundary, the replaced pipelines are destroyed
+    // once the frames recorded with them have completed. Changed textures are reloaded through the async path.
+    void SetShaderHotReload(bool enabled);
+    bool UseShaderHotReload() const { return m_shader_hot_reload; }
+    bool CheckShadersForUpdate(); // Returns true if a rebuild was started
+
+    // The ImGui stats and profiler windows, shown by default in debug builds. Hidden, no ImGui frame is built or
+    // drawn. Shown, the frame is rebuilt every DEBUG_UI_REFRESH_INTERVAL or while ImGui has input, the frames between
+    // draw the last one again.
+    void SetDebugUIVisible(bool visible) { m_debug_ui_visible = visible; }
+    [[nodiscard]] bool IsDebugUIVisible() const { return m_debug_ui_visible; }
+    void ToggleDebugUI() { m_debug_ui_visible = !m_debug_ui_visible; }
+
+    // Appends a glyph quad per visible character, alpha blended MSDF sprites of the font's atlas texture. They sort
+    // with the other quads, behind what was appended before them at the same depth.
     void DrawText(StringView text, const Vec3 &position, const Colour<f32> &colour, f32 scale, u32 font_id,
-                  std::vector<TextData> &text_instances, TextAlign alignment = TextAlign::Left, bool apply_camera_effects = false);
-
+                  std::vector<InstanceData> &quad_instances, TextAlign alignment = TextAlign::Left,
+                  bool apply_camera_effects = false);
+
+    // Retained text for strings that rarely change, such as HUD labels. Glyphs are laid out when a text is created or
+    // changed and appended to every frame's quads, so unchanged texts are never laid out again. Retained texts are
+    // drawn every frame until destroyed or hidden, after the quads passed to Render at the same depth.
+    [[nodiscard]] TextHandle CreateText(StringView text, const Vec3 &position, const Colour<f32> &colour, f32 scale,
+                                        u32 font_id, TextAlign alignment = TextAlign::Left,
+                                        bool apply_camera_effects = false);
+    void UpdateText(TextHandle handle, StringView text, const Vec3 &position, const Colour<f32> &colour, f32 scale,
+                    u32 font_id, TextAlign alignment = TextAlign::Left, bool apply_camera_effects = false);
+    void SetTextVisible(TextHandle handle, bool visible);
+    void DestroyText(TextHandle handle);
+
+    // Compiles all shaders, then creates all pipelines, each stage as parallel jobs on the worker pool. Returns once
+    // everything exists, the first shader or pipeline failure is rethrown here.
     void SetupPipelines(StringView quad_vertex_shader_path, StringView quad_fragment_shader_path,
-                        StringView text_vertex_shader_path, StringView text_fragment_shader_path,
                         StringView particle_vertex_shader_path, StringView particle_fragment_shader_path,
-                        StringView particle_compute_shader_path);
+                        StringView particle_compute_shader_path, StringView particle_emit_shader_path,
+                        StringView quad_cull_shader_path, StringView light_cull_shader_path,
+                        StringView upscale_vertex_shader_path, StringView upscale_fragment_shader_path,
+                        StringView radix_histogram_shader_path, StringView radix_scan_shader_path,
+                        StringView radix_scatter_shader_path, StringView particle_gather_shader_path);
 
-    void CreateFramebuffers();
-    void DestroyFramebuffers();
     void CreateCommandBuffers();
-    void CreateUniformBuffers(size_t data_size);
 
     BufferManager *GetBufferManager() const { return p_buffer_manager.get(); }
     FrameBufferSize GetFramebufferSize() const { return m_framebuffer_size; }
     VkDevice GetDevice() const { return p_device->GetDevice(); }
+    u32 GetMaxTextures() const { return p_device->GetMaxTextures(); }
+    VkPipelineCache GetPipelineCache() const;
+    // Null without VK_EXT_graphics_pipeline_library, pipelines are then created whole
+    PipelineLibraryCache *GetPipelineLibraries() const { return p_pipeline_libraries.get(); }
+
+    // Pipeline sets come from the shared pools and are freed with their pipeline, their pools allow update after bind.
+    // Sets of the frame allocator last until the frame slot comes round again, after its fence wait.
+    DescriptorAllocator &GetDescriptorAllocator() const { return *p_descriptor_allocator; }
+    DescriptorAllocator &GetFrameDescriptorAllocator() const
+    {
+        return *m_frame_descriptor_allocators[m_current_frame];
+    }
+    LayoutCache &GetLayoutCache() const { return *p_layout_cache; }
+
+    // The pipeline of a type specialized with constants, shared once built. The first request starts the build on a
+    // background job and returns the type's own pipeline as the fallback until the variant is swapped in at the start
+    // of a later frame, so a new variant never stalls the frame. Main thread only, pass recording reads the pointers
+    // resolved before it starts. Shader reloads retire the variants of the reloaded types, they are built again with
+    // the new shaders when next asked for.
+    GraphicsPipeline &GetPipelineVariant(PipelineType type, const SpecializationConstants &constants);
     Buffer *GetStaticVertexBuffer() const { return p_quad_vertex_buffer.get(); }
     const std::vector<Buffer> &GetInstanceBuffers() { return m_quad_instance_buffers; }
+    u32 GetFramesInFlight() const { return m_frames_in_flight; }
+    size_t GetMaxQuadInstances() const { return m_max_quad_instances; } // Text glyphs and retained texts included
+    u32 GetMaxParticleInstances() const { return m_max_particle_instances; }
+    u32 GetMaxStaticQuadInstances() const { return m_max_static_quad_instances; }
 
     // Texture functions
     u32 LoadTexture(StringView filepath, const std::optional<StringView> &json_filepath = std::nullopt) const;
     u32 LoadSingleTexture(StringView filepath) const;
     u32 LoadAtlasTexture(StringView image_filepath, StringView json_filepath) const;
-    const Sprite *GetSprite(u32 texture_id, StringView sprite_name) const;
+    // Return immediately with the id bound to a default texture, the real one is swapped in once decoded
+    u32 LoadSingleTextureAsync(StringView filepath) const;
+    u32 LoadAtlasTextureAsync(StringView image_filepath, StringView json_filepath) const;
+    // For coroutines, resumes on the main thread once the texture is swapped in
+    Task<u32> LoadTextureAsync(JobSystem &job_system, String filepath) const;
+    // Packs small images into shared pages, each image a sprite named after its file, see FindSpriteTexture
+    Vector<u32> LoadPackedAtlas(std::span<const String> image_filepaths,
+                                u32 page_size = DEFAULT_ATLAS_PAGE_SIZE) const;
+    // Same sized images as the layers of one array texture, drawn whole through InstanceData::texture_layer. The set
+    // takes one descriptor and the quads drawing it batch together whichever layer they use.
+    u32 LoadTextureArray(std::span<const String> image_filepaths);
+    const Vector<std::unique_ptr<Texture>> &GetTextureArrays() const { return p_texture_manager->GetTextureArrays(); }
+    const Sprite *GetSprite(u32 texture_id, StringId sprite_id) const;
+    u32 FindSpriteTexture(StringId sprite_id) const;
     const TextureMetadata &GetTextureMetadata(u32 texture_id) const;
     u32 GetTextureCount() const;
     const Vector<std::unique_ptr<Texture>> &GetTextures() const { return p_texture_manager->GetTextures(); }
     TextureManager *GetTextureManager() const { return p_texture_manager.get(); }
     RenderStatistics GetRenderStatistics() const { return m_render_statistics; }
 
+    /**
+     * @brief Scratch memory for the current frame, which Render moves on from. What was allocated before a Render stays
+     * valid through it and the frame after.
+     */
+    LinearAllocator &GetFrameAllocator() noexcept { return m_frame_allocator.Get(); }
+
     // Text functions
-    u32 LoadMSDFFont(StringView image_filepath, StringView json_filepath);
-    const Vector<std::unique_ptr<Texture>> &GetFontTextures() { return m_font_textures; }
+    u32 LoadMSDFFont(StringView image_filepath, StringView json_filepath); // The atlas is loaded as a texture
+    // Glyphs the font's atlas lacks are rasterized from the TrueType file on a worker thread, text drawn with them
+    // leaves them out until they are ready. See GlyphCache.
+    bool SetFontGlyphSource(u32 font_id, StringView font_filepath);
+    u32 GetFontTexture(u32 font_id) const { return m_font_texture_ids[font_id]; }
+
+    /**
+     * @brief A thumbnail of an image or of a sprite of an atlas, for browsing assets without drawing their textures.
+     * Null until a worker has made it, the first call queues it. See ThumbnailCache.
+     * @param source_rect Of the image as its texture is loaded, a sprite's uv rect or {0, 0, 1, 1} for all of it.
+     */
+    [[nodiscard]] const Thumbnail *FindThumbnail(StringView image_filepath, const UVRect<f32> &source_rect);
+
+    /**
+     * @brief Hands over the files the watcher reported since the last call, after the renderer reloaded its own.
+     * Textures and fonts are reloaded by then, what was derived from them is left to the caller.
+     */
+    [[nodiscard]] Vector<String> TakeChangedFiles() { return std::exchange(m_changed_files, {}); }
 
     void SetClearColour(const Colour<f32> &colour);
     void ReCreateSwapchain();
     void DeviceWait() const { p_device->Wait(); }
 
+    // False from the swapchain going out of date until it is recreated, Render draws nothing in between
+    [[nodiscard]] bool IsSwapchainValid() const { return p_swapchain->IsValid(); }
+
+    // Whether WaitForLastPresent can block on the display, VK_KHR_present_wait
+    [[nodiscard]] bool SupportsPresentWait() const { return p_device->HasPresentWait(); }
+
+    // Everything the selected GPU has enabled, valid once Initialize has returned
+    [[nodiscard]] const DeviceCapabilities &GetDeviceCapabilities() const { return p_device->GetCapabilities(); }
+
+    /**
+     * @brief Blocks until the frame presented last is on screen, for pacing the next one against the display.
+     * @param timeout Nanoseconds.
+     * @return False without present wait, before anything was presented, or when the timeout passed.
+     */
+    bool WaitForLastPresent(u64 timeout) const;
+
+    // Presented frames are copied into a ring of host visible buffers, read back a few frames later and written as PNG
+    // files on a thread of their own, so capturing never stalls a frame. A frame that finds the ring full is skipped.
+    // Nothing is captured on surfaces whose images cannot be copied from.
+    void CaptureScreenshot(StringView filepath);
+    void StartFrameCapture(StringView directory); // Every frame until StopFrameCapture, as numbered PNG files
+    void StopFrameCapture();
+    [[nodiscard]] bool IsCapturingFrames() const;
+
 
 private:
-    void InitializeCore(GLFWwindow *window_ptr, StringView app_name, SemVer vulkan_api_version);
+    struct TextLayout;
+    struct RetainedText;
+
+    void InitializeCore(GLFWwindow *window_ptr, StringView app_name, SemVer vulkan_api_version,
+                        StringView pipeline_cache_path, StringView preferred_device);
     void InitializeSwapchainAndQueue(VSyncMode vsync_mode);
     void InitializeDefaultResources();
     void InitializeRenderResources();
-    VkRenderPass CreateRenderPass() const;
-    void CreateFences();
+    // The main pass uses dynamic rendering, pipelines are built against these formats instead of a render pass
+    [[nodiscard]] VkPipelineRenderingCreateInfo GetPipelineRenderingInfo() const;
+    [[nodiscard]] VkCommandBufferInheritanceRenderingInfo GetInheritanceRenderingInfo() const;
+    void CreateFrameSyncValues();
+    [[nodiscard]] u32 UploadParticleSpawns(u32 frame_index);
+    void UploadParticleColliders(u32 frame_index);
+    void RecordParticleCompute(VkCommandBuffer command_buffer, u32 frame_index) const;
+    [[nodiscard]] u64 SubmitParticleCompute(u32 frame_index);
+    void WriteQuadDrawCommands(u32 frame_index);
+    void RecordQuadDraws(VkCommandBuffer command_buffer, u32 frame_index, BlendMode blend_mode, u32 first_command,
+                         u32 command_count) const;
+    [[nodiscard]] u32 UploadStaticQuadUpdates(u32 frame_index);
+    void RecordStaticQuadUpdates(VkCommandBuffer command_buffer, u32 frame_index) const;
+    void RecordQuadCull(VkCommandBuffer command_buffer, u32 frame_index) const;
+    void CullTileChunks();
+    void UpdateLights(u32 frame_index, std::span<const RenderViewport> viewports);
+    [[nodiscard]] VkRect2D GetViewportRect(const RenderViewport &viewport) const; // In the world target
+    void RecordLightCull(VkCommandBuffer command_buffer, u32 frame_index) const;
+    void WriteLightDescriptors(GraphicsPipeline &pipeline) const;
+    void UploadAnimationTables(u32 frame_index);
+    void WriteAnimationDescriptors(GraphicsPipeline &pipeline) const;
+    void WriteTextureArrayDescriptors(GraphicsPipeline &pipeline, u32 first_array) const; // Arrays from first_array on
+    [[nodiscard]] u32 UploadRenderTargetUpdates(u32 frame_index);
+    void RecordRenderTargetDraws(VkCommandBuffer command_buffer, u32 frame_index, u32 draw_index) const;
+    void UpdateRenderScale(); // Follows the GPU timings collected for this frame slot, then sizes the world
+    void ResetImageSyncValues();
     void CacheFrameBufferSize();
     void CreateInstanceBuffers();
     void InitializeImGUIIfEnabled();
-    ImDrawData *RenderImGUI() const;
-    void UpdateTextureDescriptors();
+    ImDrawData *RenderImGUI(); // Null while the debug UI is hidden
+    void UpdateTextureDescriptors(u32 frame_index); // Writes the ids queued for the slot, once it has retired
+    void StartFileWatcher();
+    void ProcessFileChanges(); // Drains the file watcher, then starts a shader rebuild when one is due
+    void ApplyShaderReload();
+    void ApplyPipelineVariants(); // Swaps in the variants whose build job finished
+    void DiscardRecordedFrames(); // After replacing anything a recorded command buffer refers to
+    void ReloadFont(u32 font_id); // Glyphs and the text laid out with them, the atlas is a watched texture
+    void UpdateGlyphCache();      // Places the rasterized glyphs and lays out again the text waiting for them
+    [[nodiscard]] const TextLayout &GetTextLayout(StringView text, f32 scale, u32 font_id, TextAlign alignment);
+    void LayoutRetainedText(RetainedText &retained);
+    // The frame's quads followed by the retained glyphs, packed again first if a retained text changed, and the
+    // DebugDraw overlay
+    [[nodiscard]] std::span<const InstanceData> GatherQuadInstances(const std::vector<InstanceData> &quad_instances);
+    [[nodiscard]] bool IsValidTextHandle(TextHandle handle) const;
+    void DestroyRetiredPipelines();
+    void DestroyRetiredSwapchains(bool destroy_all);
+    [[nodiscard]] std::unique_ptr<GraphicsPipeline> &GetGraphicsPipeline(PipelineType type);
     void DestroyImGUI() const;
     void DestroyBuffers();
 
 private:
     std::unique_ptr<Instance> p_instance;
     std::unique_ptr<Device> p_device;
+    std::unique_ptr<PipelineCache> p_pipeline_cache;
+    std::unique_ptr<PipelineLibraryCache> p_pipeline_libraries;
+    std::unique_ptr<DescriptorAllocator> p_descriptor_allocator; // Outlives the pipelines declared below
+    Vector<std::unique_ptr<DescriptorAllocator>> m_frame_descriptor_allocators; // Per frame in flight
+    std::unique_ptr<LayoutCache> p_layout_cache; // Outlives the pipelines declared below
     std::unique_ptr<BufferManager> p_buffer_manager;
     std::unique_ptr<Swapchain> p_swapchain;
     std::unique_ptr<DepthResources> p_depth_resources;
     std::unique_ptr<CommandBufferManager> p_command_buffer_manager;
+    std::unique_ptr<CommandBufferManager> p_transfer_command_buffer_manager;
+    std::unique_ptr<CommandBufferManager> p_compute_command_buffer_manager;
     std::unique_ptr<TextureManager> p_texture_manager;
+    std::unique_ptr<GpuTimer> p_gpu_timer;
+    std::unique_ptr<RenderGraph> p_render_graph; // Rebuilt every frame by RecordCommandBuffer
+    std::unique_ptr<FrameCapture> p_frame_capture;
+    std::unique_ptr<GlyphCache> p_glyph_cache; // Glyphs of fonts given a TrueType file that their atlas lacks
+    std::unique_ptr<ThumbnailCache> p_thumbnail_cache; // Asset browser thumbnails, pages made once first asked for
+    std::unique_ptr<WorkerPool> p_worker_pool; // Startup shader/pipeline jobs and per frame draw pass recording
+    std::unique_ptr<fs::FileWatcher> p_file_watcher; // Shader and texture files, only while hot reload is on
 
     std::unique_ptr<GraphicsPipeline> p_quad_pipeline;
-    std::unique_ptr<GraphicsPipeline> p_text_pipeline;
+    std::unique_ptr<GraphicsPipeline> p_quad_alpha_test_pipeline;
+    std::unique_ptr<GraphicsPipeline> p_quad_transparent_pipeline;
     std::unique_ptr<GraphicsPipeline> p_particle_pipeline;
+    std::unique_ptr<GraphicsPipeline> p_upscale_pipeline;
+    Vector<std::unique_ptr<GraphicsPipeline>> m_pipeline_variants; // Few, searched in order
+
+    // A variant being built, or that failed to and is drawn with the fallback until its shaders are reloaded
+    struct PendingVariant {
+        PipelineType type;
+        SpecializationConstants constants;
+        std::future<std::unique_ptr<GraphicsPipeline>> pipeline; // Invalid once the build failed
+    };
+    Vector<PendingVariant> m_pending_variants;
+    GraphicsPipeline *p_tile_pipeline; // Variant the tilemap is drawn with, null without tiles
     std::unique_ptr<ComputePipeline> p_particle_compute_pipeline;
+    std::unique_ptr<ComputePipeline> p_particle_emit_pipeline;
+    std::unique_ptr<ComputePipeline> p_quad_cull_pipeline;
+    std::unique_ptr<ComputePipeline> p_light_cull_pipeline;
+    std::unique_ptr<ComputePipeline> p_particle_gather_pipeline; // Copies the depth sorted particles out of the pool
+    std::unique_ptr<GpuRadixSort> p_particle_sort;               // Live particle depths and pool indices
 
     std::unique_ptr<Buffer> p_quad_vertex_buffer;
     std::unique_ptr<Buffer> p_quad_index_buffer;
 
     std::unique_ptr<Shader> p_quad_vertex_shader;
     std::unique_ptr<Shader> p_quad_fragment_shader;
-    std::unique_ptr<Shader> p_text_vertex_shader;
-    std::unique_ptr<Shader> p_text_fragment_shader;
     std::unique_ptr<Shader> p_particle_vertex_shader;
     std::unique_ptr<Shader> p_particle_fragment_shader;
     std::unique_ptr<Shader> p_particle_compute_shader;
+    std::unique_ptr<Shader> p_particle_emit_shader;
+    std::unique_ptr<Shader> p_quad_cull_shader;
+    std::unique_ptr<Shader> p_light_cull_shader;
+    std::unique_ptr<Shader> p_upscale_vertex_shader;
+    std::unique_ptr<Shader> p_upscale_fragment_shader;
+    std::unique_ptr<Shader> p_radix_histogram_shader;
+    std::unique_ptr<Shader> p_radix_scan_shader;
+    std::unique_ptr<Shader> p_radix_scatter_shader;
+    std::unique_ptr<Shader> p_particle_gather_shader;
 
     GLFWwindow *p_window;
-    VkRenderPass p_render_pass;
+    VkFormat m_colour_attachment_format;
+    VkFormat m_depth_attachment_format;
     VkCommandBuffer p_copy_command_buffer;
     VkDescriptorPool p_imgui_pool;
+    VkSampler p_upscale_sampler; // Owned by the sampler cache
     Queue m_queue;
+    Queue m_transfer_queue; // Only initialized when the device exposes a dedicated transfer family
+    Queue m_compute_queue;  // Only initialized when the device exposes an async compute family
 
-    std::vector<Fence> m_frame_fences;
-    Vector<VkFramebuffer> m_framebuffers;
+    // Per frame in flight resources are indexed by m_current_frame, per swapchain image resources by image index.
+    // Queue timeline values that signal completion of the last submission using each frame slot / swapchain image
+    Vector<u64> m_frame_timeline_values;
+    Vector<u64> m_image_timeline_values;
     Vector<VkCommandBuffer> m_command_buffers;
+    Vector<VkCommandBuffer> m_secondary_command_buffers; // DRAW_PASS_COUNT per frame in flight
+    // The structure each slot's command buffers were last recorded for, NO_FRAME_STRUCTURE when they must be recorded
+    Vector<u64> m_recorded_frame_structures;
+    Vector<VkCommandBuffer> m_compute_command_buffers;
 
-    Vector<Buffer> m_uniform_buffers;
     Vector<Buffer> m_compute_uniform_buffers;
     std::vector<Buffer> m_quad_instance_buffers;
-    std::vector<Buffer> m_text_instance_buffers;
+    Vector<Buffer> m_quad_indirect_buffers; // A VkDrawIndirectCommand per batch, the opaque batches first
 
     std::vector<ParticleData> m_particles_instances;
-    Vector<Buffer> m_particle_storage_buffers;
+    Vector<Buffer> m_particle_storage_buffers; // CPU path instance data
     std::vector<void *> m_mapped_particle_storage_data;
 
+    // GPU particles live in a single pool, its free list of dead slots is kept in the pool state buffer
+    Buffer m_particle_pool_buffer;
+    Buffer m_particle_pool_state_buffer;
+    Vector<Buffer> m_particle_spawn_buffers;
+    std::vector<void *> m_mapped_particle_spawn_data;
+    std::vector<ParticleData> m_pending_particle_spawns;
+    Vector<Buffer> m_compacted_particle_buffers; // Live particles appended by the compute pass, drawn as instances
+    Vector<Buffer> m_particle_indirect_buffers;  // VkDrawIndexedIndirectCommand whose instance count the GPU fills in
+
+    // The collision grid is rebuilt on the CPU when the colliders change, versions tell which frame buffers are stale
+    std::vector<math::AABB2D> m_particle_colliders;
+    Vector<u32> m_particle_collision_cells; // Cell offsets, then the collider indices of every cell
+    Vector<Buffer> m_particle_collider_buffers;
+    Vector<Buffer> m_particle_collision_cell_buffers;
+    Vector<u64> m_particle_collider_frame_versions;
+    u64 m_particle_collider_version;
+
+    // Static quads live in a single device local buffer mirrored in m_static_quad_instances. Changed ranges are
+    // staged per frame and copied on the graphics queue, the cull pass appends the visible ones.
+    struct InstanceRange {
+        u32 begin;
+        u32 end;
+    };
+
+    Buffer m_static_quad_buffer;
+    std::vector<InstanceData> m_static_quad_instances;
+    Vector<InstanceRange> m_dirty_static_quad_ranges; // Sorted and disjoint
+    Vector<Buffer> m_static_quad_staging_buffers;
+    std::vector<void *> m_mapped_static_quad_staging_data;
+    Vector<VkBufferCopy> m_static_quad_copies; // Copies out of the staging buffer of the frame being recorded
+    Vector<Buffer> m_culled_quad_visible_buffers;
+    Vector<Buffer> m_cull_indirect_buffers; // VkDrawIndexedIndirectCommand whose instance count the GPU fills in
+    Vector<Buffer> m_cull_uniform_buffers;
+
+    // Tiles are uploaded once per tilemap and never change, only which chunk ranges are drawn does
+    Buffer m_tile_buffer;
+    u32 m_tile_buffer_capacity; // Instances
+    u32 m_tile_count;
+    u32 m_tile_texture_index;
+    Vector<TilemapChunk> m_tile_chunks;
+    Vector<InstanceRange> m_visible_tile_ranges; // Merged runs of the chunks visible this frame
+    std::array<InstanceRange, MAX_VIEWPORTS> m_viewport_tile_ranges; // Each viewport's runs in m_visible_tile_ranges
+
+    // Lights are uploaded every frame, the tile lists the cull pass builds from them never leave the GPU
+    std::vector<PointLight> m_lights;
+    Vector<Buffer> m_light_uniform_buffers;
+    Vector<Buffer> m_light_buffers;
+    Vector<Buffer> m_light_tile_buffers;
+
+    // Animation tables are replaced whole, versions tell which frame buffers still hold older ones. The clip buffer
+    // leads with the time, written every frame.
+    struct AnimationHeader {
+        f32 time;
+        u32 clip_count;
+        u32 _pad0[2]{};
+    };
+
+    Vector<AnimationClipData> m_animation_clips;
+    Vector<AnimationFrameData> m_animation_frames;
+    Vector<Buffer> m_animation_clip_buffers;
+    Vector<Buffer> m_animation_frame_buffers;
+    Vector<u64> m_animation_frame_versions;
+    u64 m_animation_version;
+    f32 m_animation_time;
+
+    // Render targets own their depth, the colour image is a texture slot. Pending updates are drawn at the next Render.
+    struct RenderTarget {
+        u32 texture_id;
+        VkExtent2D extent;
+        Texture depth_image;
+        UniformData camera;
+        VkClearColorValue clear_colour;
+        std::vector<InstanceData> quads; // Of the pending update, without camera effects so they are never lit
+        bool update_pending;
+    };
+
+    // A target drawn by the frame being recorded, its sorted batches are in m_render_target_batches
+    struct RenderTargetDraw {
+        u32 target_index;
+        u32 first_batch;
+        u32 batch_count;
+    };
+
+    Vector<RenderTarget> m_render_targets;
+    Vector<RenderTargetDraw> m_render_target_draws;
+    Vector<DrawBatch> m_render_target_batches; // First instances are offsets into the frame's instance buffer
+    Vector<Buffer> m_render_target_instance_buffers;
+    RenderQueue m_render_target_queue;
+
     std::vector<void *> m_mapped_quad_instance_data;
-    std::vector<void *> m_mapped_text_instance_data;
 
-    Vector<std::unique_ptr<Texture>> m_font_textures;
-    std::unordered_map<u32, MSDFAtlasParams> m_font_atlas_params;
-    std::unordered_map<u32, MSDFGlyphMap> m_fonts;
+    Vector<u32> m_font_texture_ids; // Atlas texture of each font id, the default texture for the default font
+    // Per frame slot, the texture ids whose descriptors the slot's sets still have to be written with
+    Vector<Vector<u32>> m_pending_texture_descriptors;
+    std::vector<MSDFAtlasParams> m_font_atlas_params; // Indexed by font id, like m_font_texture_ids
+    std::vector<MSDFGlyphTable> m_fonts;              // Empty for font ids without glyphs (the default font)
+
+    // Files a font was loaded from, indexed by font id, empty for the default font
+    struct FontSource {
+        String image_filepath;
+        String json_filepath;
+    };
+    std::vector<FontSource> m_font_sources;
+
+    // Glyph runs laid out relative to the text origin. DrawText only offsets and colours a cached run, so strings that
+    // do not change between frames are laid out once.
+    struct TextLayout {
+        String text;
+        u32 font_id;
+        f32 scale;
+        TextAlign alignment;
+        Vector<InstanceData> glyphs;
+        Vector<u32> glyph_cells; // Of the glyph cache's glyphs among them, touched whenever the layout is drawn
+        bool has_queued_glyphs;  // Laid out without glyphs the glyph cache was still rasterizing
+    };
+    static constexpr size_t MAX_CACHED_TEXT_LAYOUTS{1024};
+    // Keyed by a hash of text, font, scale and alignment
+    TrackedFlatHashMap<u64, TextLayout, MemoryTag::Renderer> m_text_layouts;
+
+    struct RetainedText {
+        String text;
+        Vec3 position;
+        Colour<f32> colour;
+        f32 scale;
+        u32 font_id;
+        TextAlign alignment;
+        bool apply_camera_effects;
+        bool visible;
+        std::vector<InstanceData> glyphs;
+        Vector<u32> glyph_cells; // As the layout's
+    };
+
+    // Retained glyphs of all visible texts are packed again after any change, then appended to each frame's quads
+    SlotMap<RetainedText> m_retained_texts;
+    std::vector<InstanceData> m_retained_text_instances;
+    std::vector<InstanceData> m_frame_quad_instances; // Reused, the quads of a frame with retained text or debug draws
+    std::vector<InstanceData> m_debug_draw_instances;
+    Vector<DebugText> m_debug_texts;
+    bool m_retained_text_dirty;
+
+    // A shader pair and the graphics pipelines built from it
+    struct ShaderWatch {
+        String vertex_path;
+        String fragment_path;
+        FileTimeType vertex_last_modified;
+        FileTimeType fragment_last_modified;
+        std::unique_ptr<Shader> Renderer::*vertex_shader;
+        std::unique_ptr<Shader> Renderer::*fragment_shader;
+        SmallVector<PipelineType, 3> pipeline_types;
+    };
+
+    // Built by the reload job, pipelines are in the order of the watch's pipeline_types
+    struct ShaderReload {
+        size_t watch_index;
+        std::unique_ptr<Shader> vertex_shader;
+        std::unique_ptr<Shader> fragment_shader;
+        SmallVector<std::unique_ptr<GraphicsPipeline>, 3> pipelines;
+    };
+
+    // Swapped out objects, destroyed once the queue timeline reaches the last submission that could use them
+    struct RetiredPipelines {
+        u64 timeline_value;
+        Vector<std::unique_ptr<Shader>> shaders;
+        Vector<std::unique_ptr<GraphicsPipeline>> pipelines;
+    };
+
+    Vector<ShaderWatch> m_shader_watches;
+    std::future<ShaderReload> m_shader_reload; // At most one rebuild in flight
+    std::deque<RetiredPipelines> m_retired_pipelines;
+    Vector<String> m_changed_files; // Reported by the watcher and not taken yet, each path once
+
+    // Replaced on resize, destroyed the same way so recreating the swapchain never waits for the device
+    struct RetiredSwapchainResources {
+        u64 timeline_value;
+        RetiredSwapchain swapchain;
+        Vector<Texture> depth_images;
+    };
+
+    std::deque<RetiredSwapchainResources> m_retired_swapchains;
+    bool m_shader_change_pending; // A watched shader file was written and has not been checked yet
 
     FrameBufferSize m_framebuffer_size;
+    u32 m_frames_in_flight;
     u32 m_current_frame;
 
     SimulationParams m_simulation_params;
     RenderStatistics m_render_statistics;
+    FrameAllocator m_frame_allocator; // CPU scratch, double buffered so data built ahead of Render outlives it
+    RenderQueue m_quad_queue;
+    CullParams m_cull_params;
+    Vector<RenderViewport> m_viewports; // Empty draws one viewport from the uniform data given to Render
+    LightParams m_light_params; // Of the frame being recorded
+
+    VkExtent2D m_scene_extent;   // The world's size this frame, the swapchain's unless scaled
+    f32 m_render_scale;          // As set, the upper bound of the dynamic scale
+    f32 m_current_render_scale;  // Used this frame
+    f32 m_upscale_sharpness;
+    f32 m_target_gpu_time;       // Milliseconds, 0 while the scale is not dynamic
+    u32 m_render_scale_cooldown; // Frames until the dynamic scale may change again
 
     VkClearColorValue m_clear_colour;
     size_t m_max_quad_instances;
-    size_t m_max_text_instances;
+    std::array<u32, RenderQueue::PIPELINE_COUNT> m_quad_draw_counts; // Per BlendMode, in this frame's indirect buffer
     u32 m_max_particle_instances;
+    u32 m_max_static_quad_instances;
+    u32 m_particle_spawn_count; // Spawns uploaded for the frame being recorded
+    u32 m_particle_spawn_limit; // Per frame, up to MAX_PARTICLE_SPAWNS_PER_FRAME
+    u32 m_light_limit;          // Up to MAX_LIGHTS
     VSyncMode m_vsync_mode;
     u32 m_vertex_count;
     u32 m_index_count;
     bool m_is_initialized;
     bool m_use_compute_particles;
-    bool m_font_textures_dirty;
+    bool m_sort_particles;
+    bool m_use_async_compute;
+    bool m_use_gpu_culling;
+    bool m_reset_particle_pool;  // Empty the pool before the next simulation step
+    bool m_particle_pool_active; // Something was emitted since the last reset
+    bool m_static_quad_textures_dirty; // Static quad textures are pinned resident, recomputed when the set changes
+    bool m_shader_hot_reload;
+    bool m_debug_ui_visible;
+    bool m_imgui_dirty;            // Rebuild the ImGui frame even if the interval has not passed
+    ImDrawData *p_imgui_draw_data; // Built last, valid until the next ImGui frame
+    ImDrawData *p_prebuilt_imgui_draw_data; // By BuildDebugUI, null while the debug UI is hidden
+    bool m_is_imgui_prebuilt;               // The next Render draws p_prebuilt_imgui_draw_data
+    SteadyClock::time_point m_imgui_build_time;
 };
 
 } // namespace gouda::vk
\ No newline at end of file
@@ -0,0 +1,69 @@
+#pragma once
+/**
+ * @file vk_sampler_cache.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine vulkan sampler cache module
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <mutex>
+
+#include <vulkan/vulkan.h>
+
+#include "containers/small_vector.hpp"
+#include "core/types.hpp"
+
+namespace gouda::vk {
+
+// Everything a texture sampler differs in, the other sampler parameters are the same for all of them
+struct SamplerState {
+    VkFilter min_filter;
+    VkFilter mag_filter;
+    VkSamplerAddressMode address_mode;
+
+    constexpr bool operator==(const SamplerState &) const noexcept = default;
+};
+
+/**
+ * @class SamplerCache
+ * @brief Creates one sampler per sampler state and hands the same one to every texture using that state.
+ *
+ * Samplers do not depend on the image they are used with, the LOD range is left unclamped so the view's mip levels
+ * decide it. Nearly every texture samples linearly and clamps, so a handful of samplers cover the whole renderer.
+ * Samplers stay alive until the cache is destroyed, those it hands out must not be destroyed by their users. Safe to
+ * call from the threads that build pipelines and textures.
+ */
+class SamplerCache {
+public:
+    explicit SamplerCache(VkDevice device);
+
+    /**
+     * @brief Destroys every sampler. Callers must make sure the GPU no longer uses them.
+     */
+    ~SamplerCache();
+
+    SamplerCache(const SamplerCache &) = delete;
+    SamplerCache &operator=(const SamplerCache &) = delete;
+
+    [[nodiscard]] VkSampler Get(const SamplerState &state);
+
+    [[nodiscard]] size_t GetSamplerCount() const;
+    [[nodiscard]] u64 GetHitCount() const; ///< Requests that found their sampler created already
+
+private:
+    struct Entry {
+        SamplerState state;
+        VkSampler p_sampler;
+    };
+
+    VkDevice p_device;
+    mutable std::mutex m_mutex;
+    SmallVector<Entry, 8> m_samplers; // Few, searched in order
+    u64 m_hit_count;
+};
+
+} // namespace gouda::vk
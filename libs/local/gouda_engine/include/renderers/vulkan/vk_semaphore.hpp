@@ -12,6 +12,8 @@
  */
 #include <vulkan/vulkan.h>
 
+#include "core/types.hpp"
+
 namespace gouda::vk {
 
 class Device;
@@ -22,14 +24,22 @@ public:
 
     ~Semaphore();
 
-    bool Create();
+    // Creates a binary semaphore or, with VK_SEMAPHORE_TYPE_TIMELINE, a timeline semaphore starting at initial_value
+    bool Create(VkSemaphoreType type = VK_SEMAPHORE_TYPE_BINARY, u64 initial_value = 0);
     void Destroy();
 
+    // Timeline semaphore operations
+    [[nodiscard]] u64 GetCounterValue() const;
+    [[nodiscard]] bool Wait(u64 value, u64 timeout = constants::u64_max) const;
+    void Signal(u64 value) const;
+
+    [[nodiscard]] bool IsTimeline() const noexcept { return m_type == VK_SEMAPHORE_TYPE_TIMELINE; }
     [[nodiscard]] VkSemaphore Get() const noexcept { return p_semaphore; }
 
 private:
     VkSemaphore p_semaphore;
     Device *p_device;
+    VkSemaphoreType m_type;
 };
 
 } // namespace gouda::vk
\ No newline at end of file
@@ -11,6 +11,7 @@
  * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
  * See <https://www.gnu.org/licenses/> for more information.
  */
+#include <array>
 #include <string_view>
 #include <vector>
 
@@ -36,7 +37,8 @@ struct ShaderDescriptorBinding {
     u32 binding;                    ///< Binding number
     VkDescriptorType type;          ///< Descriptor type (e.g., uniform buffer, sampler)
     VkShaderStageFlags stage_flags; ///< Shader stages using this binding
-    u32 count;                      ///< Number of elements (e.g., array size)
+    u32 count;                      ///< Number of elements (e.g., array size), 0 for runtime arrays
+    bool is_runtime_array;          ///< Unsized array, sized by the pipeline that binds it
 };
 
 /// Represents a push constant range in a shader
@@ -68,6 +70,7 @@ struct ShaderReflection {
     std::vector<ShaderPushConstantRange> push_constants;                ///< Push constant ranges
     std::vector<ShaderSpecializationConstant> specialization_constants; ///< Specialization constants
     std::vector<ShaderVertexInput> vertex_inputs;                       ///< Vertex input attributes
+    std::array<u32, 3> local_size{1, 1, 1};                             ///< Workgroup size of a compute shader
     std::string entry_point;
 };
 
@@ -127,6 +130,12 @@ public:
      */
     [[nodiscard]] constexpr const ShaderReflection &Reflection() const noexcept { return m_reflection; }
 
+    /**
+     * @brief Hash of the stage and SPIR-V, equal for shaders built from the same code.
+     * @return FNV-1a hash, stable across reloads of an unchanged file.
+     */
+    [[nodiscard]] constexpr u64 GetCodeHash() const noexcept { return m_code_hash; }
+
     /**
      * @brief Indicates whether the shader was successfully loaded.
      * @return true if shader is valid; false otherwise.
@@ -157,6 +166,7 @@ private:
     ShaderFormat m_format{};         ///< Original shader format (binary or text)
     VkShaderStageFlagBits m_stage{}; ///< Shader stage (vertex, fragment, etc.)
     ShaderReflection m_reflection{}; ///< Parsed shader reflection data
+    u64 m_code_hash{0};              ///< Hash of the stage and SPIR-V
 };
 
 /**
@@ -210,6 +220,16 @@ private:
         case VK_FORMAT_B8G8R8A8_UNORM:
             return "vec4";
 
+        // Packed instance attributes
+        case VK_FORMAT_R16_SFLOAT:
+            return "float (half)";
+        case VK_FORMAT_R16G16_SFLOAT:
+            return "vec2 (half)";
+        case VK_FORMAT_R16_UINT:
+            return "uint (16 bit)";
+        case VK_FORMAT_R16G16B16A16_UNORM:
+            return "vec4 (unorm16)";
+
         // Depth formats
         case VK_FORMAT_D32_SFLOAT:
             return "float (depth)";
@@ -0,0 +1,107 @@
+#pragma once
+/**
+ * @file vk_staging_ring.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine vulkan staging ring buffer module
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <deque>
+#include <optional>
+
+#include <vulkan/vulkan.h>
+
+#include "core/types.hpp"
+#include "renderers/vulkan/vk_buffer.hpp"
+
+namespace gouda::vk {
+
+/**
+ * @struct StagingAllocation
+ * @brief A mapped region of the staging ring that can be used as a transfer source.
+ */
+struct StagingAllocation {
+    VkBuffer p_buffer;
+    VkDeviceSize m_offset;
+    VkDeviceSize m_size;
+    void *p_mapped;
+};
+
+/**
+ * @class StagingRing
+ * @brief Persistently mapped, host visible ring buffer used as the source of all staged uploads.
+ *
+ * Allocations made between two calls to Retire belong to one submission. Their space is handed back by Reclaim once
+ * the queue timeline reaches the value they were retired with, so the CPU never waits on an individual upload.
+ */
+class StagingRing {
+public:
+    /**
+     * @brief Takes ownership of a host visible, host coherent transfer source buffer and maps it.
+     * @param device Vulkan device handle the buffer was created on.
+     * @param buffer Buffer backing the ring.
+     */
+    StagingRing(VkDevice device, Buffer buffer);
+
+    /**
+     * @brief Destroys the backing buffer. Callers must make sure all uploads have retired.
+     */
+    ~StagingRing();
+
+    StagingRing(const StagingRing &) = delete;
+    StagingRing &operator=(const StagingRing &) = delete;
+
+    /**
+     * @brief Allocates a region of the ring.
+     * @param size Size in bytes.
+     * @param alignment Required alignment of the region offset.
+     * @return The allocation, or std::nullopt if the ring does not have enough free space.
+     */
+    [[nodiscard]] std::optional<StagingAllocation> Allocate(VkDeviceSize size, VkDeviceSize alignment);
+
+    /**
+     * @brief Marks every allocation since the last retire as used by the submission signalling timeline_value.
+     * @param timeline_value Queue timeline value of the submission reading the allocations.
+     */
+    void Retire(u64 timeline_value);
+
+    /**
+     * @brief Frees all retired regions whose submission has completed.
+     * @param completed_value Current completed queue timeline value.
+     */
+    void Reclaim(u64 completed_value);
+
+    /**
+     * @brief Returns the timeline value of the oldest retired region, or NO_TIMELINE_VALUE when nothing is pending.
+     */
+    [[nodiscard]] u64 GetOldestPendingValue() const;
+
+    [[nodiscard]] bool HasUnretiredAllocations() const noexcept { return m_unretired_bytes > 0; }
+    [[nodiscard]] VkDeviceSize GetCapacity() const noexcept { return m_capacity; }
+    [[nodiscard]] VkDeviceSize GetUsedBytes() const noexcept { return m_used_bytes; }
+
+private:
+    struct RetiredRegion {
+        VkDeviceSize m_end;
+        VkDeviceSize m_bytes;
+        u64 m_timeline_value;
+    };
+
+    VkDevice p_device;
+    Buffer m_buffer;
+    u8 *p_mapped;
+
+    VkDeviceSize m_capacity;
+    VkDeviceSize m_head;
+    VkDeviceSize m_tail;
+    VkDeviceSize m_used_bytes;
+    VkDeviceSize m_unretired_bytes;
+
+    std::deque<RetiredRegion> m_retired_regions;
+};
+
+} // namespace gouda::vk
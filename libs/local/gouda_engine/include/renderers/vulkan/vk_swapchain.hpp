@@ -30,6 +30,15 @@ enum class VSyncMode : u8 {
     Mailbox   // Adaptive V-Sync (triple-buffering, minimizes lag & tearing)
 };
 
+/**
+ * @struct RetiredSwapchain
+ * @brief A swapchain replaced by Recreate and its image views, which frames still in flight may be using.
+ */
+struct RetiredSwapchain {
+    VkSwapchainKHR swapchain;
+    std::vector<VkImageView> image_views;
+};
+
 class Swapchain {
 public:
     Swapchain(GLFWwindow *window, Device *device, Instance *instance, BufferManager *buffer_manager,
@@ -42,7 +51,12 @@ public:
     void DestroySwapchain();
     void DestroySwapchainImageViews();
 
-    void Recreate();
+    /**
+     * @brief Replaces the swapchain with one for the window's current size, handing the old one over to the new.
+     * @return The old swapchain, to be given to DestroyRetired once the frames that used it have completed.
+     */
+    [[nodiscard]] RetiredSwapchain Recreate();
+    void DestroyRetired(RetiredSwapchain &retired) const;
 
     [[nodiscard]] VkSwapchainKHR *Get() { return &p_swap_chain; }
     [[nodiscard]] const std::vector<VkImage> &GetImages() const { return m_images; }
@@ -54,6 +68,7 @@ public:
         return FrameBufferSize(static_cast<int>(m_extent.width), static_cast<int>(m_extent.height));
     }
     [[nodiscard]] VkSurfaceFormatKHR GetSurfaceFormat() const { return m_surface_format; }
+    [[nodiscard]] bool CanReadBack() const { return (m_image_usage & VK_IMAGE_USAGE_TRANSFER_SRC_BIT) != 0; }
 
     void SetInvalid() noexcept { m_is_valid.store(false, std::memory_order_release); }
     void SetValid() noexcept { m_is_valid.store(true, std::memory_order_release); }
@@ -78,6 +93,7 @@ private:
     std::vector<VkImageView> m_image_views;
 
     VkExtent2D m_extent;
+    VkImageUsageFlags m_image_usage;
 
     std::atomic<bool> m_is_valid;
 };
@@ -10,13 +10,15 @@
  * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
  * See <https://www.gnu.org/licenses/> for more information.
  */
-#include <unordered_map>
 #include <vector>
 #include <optional>
 
 #include <vulkan/vulkan.h>
 
 #include "core/types.hpp"
+#include "memory/allocators/tracking_allocator.hpp"
+#include "renderers/vulkan/vk_memory_allocator.hpp"
+#include "utils/string_id.hpp"
 
 // TODO: Update this to use Vector
 
@@ -44,9 +46,9 @@ struct Texture {
     void Destroy(const Device *device);
 
     VkImage p_image;
-    VkDeviceMemory p_memory;
+    MemoryAllocation m_allocation;
     VkImageView p_view;
-    VkSampler p_sampler;
+    VkSampler p_sampler; // From the buffer manager's sampler cache, not owned
 };
 
 // TODO: Sort out the ordering and padding of this
@@ -55,8 +57,9 @@ struct TextureMetadata {
     ~TextureMetadata();
 
     bool is_atlas;
+    bool is_packed; // Atlas page packed or texture made at runtime, it has no image file to reload from
     Texture* texture;
-    std::unordered_map<String, Sprite> sprites;
+    TrackedFlatHashMap<StringId, Sprite, MemoryTag::Textures> sprites; // Names registered, see StringId::GetName
     SemVer version;
     String image_filepath;
     std::optional<String> json_filepath;
@@ -88,6 +91,18 @@ struct TextureMetadata {
     }
 }
 
+// Levels of a full mip chain, the larger side is halved until it reaches one texel
+[[nodiscard]] constexpr u32 mip_level_count(const ImageSize size) noexcept
+{
+    u32 largest_side{static_cast<u32>(size.width > size.height ? size.width : size.height)};
+    u32 level_count{1};
+    while (largest_side > 1) {
+        largest_side >>= 1;
+        ++level_count;
+    }
+    return level_count;
+}
+
 [[nodiscard]] constexpr u32 vk_format_to_channel_count(const VkFormat format)
 {
     switch (format) {
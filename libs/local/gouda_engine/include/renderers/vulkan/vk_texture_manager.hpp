@@ -10,15 +10,26 @@
  * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
  * See <https://www.gnu.org/licenses/> for more information.
  */
+#include <deque>
+#include <future>
+#include <span>
+
 #include "vk_texture.hpp"
 #include "containers/small_vector.hpp"
 #include "core/types.hpp"
+#include "renderers/vulkan/vk_buffer_manager.hpp"
+#include "utils/task.hpp"
+
+namespace gouda::fs {
+class FileWatcher;
+}
 
 namespace gouda::vk {
 
-class BufferManager;
 class Device;
 
+constexpr u32 DEFAULT_ATLAS_PAGE_SIZE{2048}; ///< Width and height of runtime packed atlas pages
+
 /**
  * @class TextureManager
  * @brief Manages Vulkan textures and texture atlases, including loading, reloading, and metadata management.
@@ -52,6 +63,140 @@ public:
      */
     u32 LoadAtlasTexture(StringView image_filepath, StringView json_filepath);
 
+    /**
+     * @brief Packs individual images into shared atlas pages, so sprites drawn together share one texture.
+     *
+     * Each image becomes a single frame sprite named after its file name without the extension, looked up with
+     * GetSprite like the sprites of a JSON atlas. Images are packed tallest first with a skyline packer and padded
+     * with their own edge pixels against filtering bleed. An image larger than a page gets a page of its own size.
+     * @param image_filepaths Paths to the image files.
+     * @param page_size Width and height of a page.
+     * @return IDs of the page textures, in the order they were filled.
+     */
+    Vector<u32> LoadPackedAtlas(std::span<const String> image_filepaths, u32 page_size = DEFAULT_ATLAS_PAGE_SIZE);
+
+    /**
+     * @brief Packs images of one size into the layers of a single 2D array texture, drawn by setting
+     * InstanceData::texture_layer. The whole set takes one descriptor, arrays are never reloaded or evicted.
+     *
+     * Array ids are separate from texture ids, array 0 is a single blank layer the failed loads return. Images that
+     * fail to load or differ in size from the first one that loaded leave their layer blank, so layer i is always
+     * image i.
+     * @param image_filepaths Paths to the image files, one layer each.
+     * @return ID of the texture array, 0 if no image loaded or no array slot is left.
+     */
+    u32 LoadTextureArray(std::span<const String> image_filepaths);
+
+    /**
+     * @brief Takes over a texture created elsewhere, such as a render target. It has no image file, so it is never
+     * reloaded or evicted.
+     * @param texture Texture to store in the new slot.
+     * @return ID of the texture, 0 if no slot is left.
+     */
+    u32 AddTexture(std::unique_ptr<Texture> texture);
+
+    /**
+     * @brief Queues a single texture for loading on a worker thread.
+     * @param filepath Path to the texture file.
+     * @return ID of the texture, bound to a default texture until ProcessAsyncLoads swaps the real one in.
+     */
+    u32 LoadSingleTextureAsync(StringView filepath);
+
+    /**
+     * @brief Queues a texture atlas for loading on a worker thread. The JSON metadata is parsed immediately, so sprites
+     * can be looked up right away.
+     * @param image_filepath Path to the atlas image file.
+     * @param json_filepath Path to the JSON file describing sprite regions.
+     * @return ID of the atlas texture, bound to a default texture until ProcessAsyncLoads swaps the real one in.
+     */
+    u32 LoadAtlasTextureAsync(StringView image_filepath, StringView json_filepath);
+
+    /**
+     * @brief Loads a single texture like LoadSingleTextureAsync, for coroutines awaiting the real texture. The slot
+     * is touched on the main thread only, the task moves there first and resumes there once the texture is swapped in.
+     * @param job_system Job system whose main thread drives the renderer.
+     * @param filepath Path to the texture file.
+     * @return ID of the texture, still bound to the default texture if the load failed.
+     */
+    Task<u32> LoadTextureAsync(JobSystem &job_system, String filepath);
+
+    /**
+     * @brief Records the uploads of finished decodes, swaps them into their slots and destroys replaced placeholders.
+     * Called once per frame before the texture descriptors are written and the uploads are flushed.
+     * @param submitted_value Last timeline value submitted to the graphics queue, placeholders replaced now may be in
+     * use up to it.
+     * @param completed_value Timeline value the graphics queue has completed.
+     */
+    void ProcessAsyncLoads(u64 submitted_value, u64 completed_value);
+
+    /**
+     * @brief Records that a texture is drawn this frame. Evicted textures are streamed back in by UpdateResidency.
+     * @param texture_id ID of the drawn texture, out of range IDs are ignored.
+     */
+    void MarkTextureUsed(const u32 texture_id)
+    {
+        if (texture_id < m_residency.size()) {
+            m_residency[texture_id].last_used_frame = m_residency_frame;
+        }
+    }
+
+    /**
+     * @brief Replaces the set of textures that are never evicted, for instances drawn without the CPU seeing them
+     * (GPU culled static quads).
+     * @param texture_ids IDs to pin, may contain duplicates.
+     */
+    void SetPinnedTextures(std::span<const u32> texture_ids);
+
+    /**
+     * @brief Evicts a texture nothing holds anymore at the next UpdateResidency, unless it is drawn by then. The slot
+     * keeps its file, so drawing it later streams it back in like any evicted texture.
+     * @param texture_id ID of the texture, pinned, packed and still loading textures are left resident.
+     */
+    void ReleaseTexture(u32 texture_id);
+
+    /**
+     * @brief Sets how much device memory the textures may occupy before idle ones are evicted.
+     * @param budget Budget in bytes, 0 derives it from VK_EXT_memory_budget (no eviction without the extension).
+     */
+    void SetTextureMemoryBudget(const VkDeviceSize budget) { m_texture_memory_budget = budget; }
+
+    /**
+     * @brief Streams in evicted textures drawn this frame and, when over budget, evicts the least recently drawn
+     * ones. Called once per frame after all MarkTextureUsed calls and before ProcessAsyncLoads.
+     * @param submitted_value Last timeline value submitted to the graphics queue, evicted textures may be in use up to
+     * it.
+     */
+    void UpdateResidency(u64 submitted_value);
+
+    /**
+     * @brief Returns the device memory held by the textures in their slots, placeholders included.
+     * @return Size in bytes.
+     */
+    [[nodiscard]] VkDeviceSize GetTextureMemoryUsage() const;
+
+    /**
+     * @brief Checks if a texture was evicted and its slot holds a placeholder.
+     * @param texture_id ID of the texture to check.
+     * @return True while evicted, streaming back in counts as loading, not as evicted.
+     */
+    [[nodiscard]] bool IsEvicted(const u32 texture_id) const
+    {
+        return texture_id < m_residency.size() && m_residency[texture_id].evicted;
+    }
+
+    /**
+     * @brief Checks if a texture is still waiting for its asynchronous load.
+     * @param texture_id ID of the texture to check.
+     * @return True while the slot is bound to its placeholder.
+     */
+    [[nodiscard]] bool IsLoading(u32 texture_id) const;
+
+    /**
+     * @brief Returns the number of asynchronous loads that have not been swapped in yet.
+     * @return Pending load count.
+     */
+    [[nodiscard]] u32 GetPendingLoadCount() const { return static_cast<u32>(m_async_loads.size()); }
+
     /**
      * @brief Reloads a specific texture.
      * @param texture_id ID of the texture to reload.
@@ -73,13 +218,35 @@ public:
      */
     bool CheckTextureForUpdate(u32 texture_id);
 
+    /**
+     * @brief Registers the files of every texture, and of those loaded later, with a watcher.
+     * @param file_watcher Watcher whose changes are passed to ReloadChangedTextures, nullptr stops registering.
+     */
+    void SetFileWatcher(fs::FileWatcher *file_watcher);
+
+    /**
+     * @brief Reloads the textures whose image or atlas JSON is among the changed files. Images go through the async
+     * path, so the current texture stays bound until the new one is uploaded and frames in flight are unaffected.
+     * @param changed_files Paths as returned by FileWatcher::PollChanges.
+     * @return Number of textures reloaded.
+     */
+    u32 ReloadChangedTextures(std::span<const String> changed_files);
+
     /**
      * @brief Retrieves a specific sprite from a texture atlas.
      * @param texture_id ID of the texture containing the sprite.
-     * @param sprite_name Name of the sprite to retrieve.
-     * @return Pointer to the Sprite if found, nullptr otherwise.
+     * @param sprite_id Hashed name of the sprite, a literal such as "player.walk" is hashed at compile time.
+     * @return Pointer to the Sprite if found, nullptr otherwise. Invalidated when the atlas JSON is reloaded, data
+     * copied out of it has to be derived again, see AssetRegistry::AddDependent.
+     */
+    [[nodiscard]] const Sprite* GetSprite(u32 texture_id, StringId sprite_id) const;
+
+    /**
+     * @brief Finds the atlas that holds a sprite, useful for the pages of LoadPackedAtlas.
+     * @param sprite_id Hashed name of the sprite.
+     * @return ID of the first texture holding the sprite, 0 if none does.
      */
-    [[nodiscard]] const Sprite* GetSprite(u32 texture_id, StringView sprite_name) const;
+    [[nodiscard]] u32 FindSpriteTexture(StringId sprite_id) const;
 
     /**
      * @brief Retrieves metadata associated with a texture.
@@ -100,16 +267,38 @@ public:
      */
     const Vector<std::unique_ptr<Texture>> &GetTextures() { return m_textures; }
 
+    /**
+     * @brief Returns the texture arrays of LoadTextureArray, indexed by array id.
+     * @return Vector of unique pointers to Texture objects, empty until the first array was loaded.
+     */
+    const Vector<std::unique_ptr<Texture>> &GetTextureArrays() const { return m_texture_arrays; }
+
+    /**
+     * @brief Returns the number of layers of a texture array.
+     * @param array_id ID of the texture array.
+     * @return Layer count, 0 for an invalid ID.
+     */
+    [[nodiscard]] u32 GetTextureArrayLayerCount(const u32 array_id) const
+    {
+        return array_id < m_texture_array_layer_counts.size() ? m_texture_array_layer_counts[array_id] : 0;
+    }
+
     /**
      * @brief Checks whether any texture has been modified or reloaded.
      * @return True if textures are marked dirty.
      */
-    [[nodiscard]] bool IsDirty() const { return m_textures_dirty; }
+    [[nodiscard]] bool IsDirty() const { return !m_dirty_texture_ids.empty(); }
+
+    /**
+     * @brief Returns the ids of the textures loaded or reloaded since the last SetClean.
+     * @return Texture ids, may contain duplicates.
+     */
+    [[nodiscard]] std::span<const u32> GetDirtyTextureIds() const { return m_dirty_texture_ids; }
 
     /**
      * @brief Marks all textures as clean (not dirty).
      */
-    void SetClean() { m_textures_dirty = false; }
+    void SetClean() { m_dirty_texture_ids.clear(); }
 
     /**
      * @brief Checks if a texture ID is valid.
@@ -141,13 +330,74 @@ private:
      */
     void CreateDefaultTexture();
 
+    /**
+     * @brief Reserves a slot bound to a fresh placeholder texture and queues its image for decoding.
+     * @param metadata Metadata of the texture, its texture pointer is set here.
+     * @return ID of the reserved slot, 0 if no slot is left.
+     */
+    u32 QueueAsyncLoad(TextureMetadata metadata);
+
+    /**
+     * @brief Starts decodes for queued loads until the concurrency limit is reached.
+     */
+    void StartAsyncDecodes();
+
+    /**
+     * @brief Registers the image and atlas JSON of a texture with the file watcher, if there is one.
+     * @param metadata Metadata of the texture.
+     */
+    void WatchTextureFiles(const TextureMetadata &metadata);
+
+    /**
+     * @brief Returns the budget eviction works against, the configured one or one derived from the device budget.
+     * @param texture_usage Current GetTextureMemoryUsage.
+     * @return Budget in bytes, 0 when there is none.
+     */
+    [[nodiscard]] VkDeviceSize GetEffectiveTextureBudget(VkDeviceSize texture_usage) const;
+
+    /**
+     * @brief Binds a slot to a placeholder and retires its texture, the data is reloaded from disk on the next use.
+     * @param texture_id ID of the texture to evict.
+     * @param submitted_value Timeline value after which the old texture is no longer referenced.
+     */
+    void EvictTexture(u32 texture_id, u64 submitted_value);
+
 private:
+    struct AsyncTextureLoad {
+        u32 texture_id;
+        String filepath;
+        std::future<Expect<TextureSource, String>> source; ///< Not valid until the decode was started
+    };
+
+    struct TextureResidency {
+        u64 last_used_frame; ///< Residency frame of the last MarkTextureUsed
+        bool pinned;         ///< Never evicted
+        bool evicted;        ///< Slot holds a placeholder until the texture is drawn again
+    };
+
+    struct RetiredTexture {
+        u64 timeline_value; ///< Graphics timeline value after which the texture is no longer referenced
+        std::unique_ptr<Texture> texture;
+    };
+
     BufferManager *p_buffer_manager;
     Device *p_device;
+    fs::FileWatcher *p_file_watcher; ///< Not owned, nullptr while hot reload is off
 
     Vector<std::unique_ptr<Texture>> m_textures;
     Vector<TextureMetadata> m_metadata;
-    bool m_textures_dirty;
+    Vector<u32> m_dirty_texture_ids; ///< Textures whose descriptors need writing
+
+    Vector<std::unique_ptr<Texture>> m_texture_arrays;
+    Vector<u32> m_texture_array_layer_counts; ///< Parallel to m_texture_arrays
+
+    std::deque<AsyncTextureLoad> m_async_loads; ///< In request order, the first ones are the ones decoding
+    std::deque<RetiredTexture> m_retired_textures;
+
+    Vector<TextureResidency> m_residency; ///< Parallel to m_textures
+    Vector<u32> m_released_texture_ids;   ///< Evicted by the next UpdateResidency
+    u64 m_residency_frame;
+    VkDeviceSize m_texture_memory_budget; ///< 0 follows the device budget
 };
 
 } // namespace gouda::vk
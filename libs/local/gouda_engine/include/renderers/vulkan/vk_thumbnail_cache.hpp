@@ -0,0 +1,129 @@
+#pragma once
+/**
+ * @file vk_thumbnail_cache.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine vulkan background thumbnail generation module
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "containers/flat_hash_map.hpp"
+#include "containers/small_vector.hpp"
+#include "core/types.hpp"
+
+namespace gouda::vk {
+
+class BufferManager;
+class TextureManager;
+
+/**
+ * @struct Thumbnail
+ * @brief A small copy of an image or of a sprite of it, in a cell of a thumbnail page.
+ */
+struct Thumbnail {
+    u32 texture_id;      // Of the page, drawn as an atlas quad with uv_rect
+    UVRect<f32> uv_rect; // Of the page, bottom row first like the textures
+    ImageSize size;      // In pixels, the source's aspect within THUMBNAIL_SIZE on either side
+};
+
+/**
+ * @class ThumbnailCache
+ * @brief Thumbnails of images and atlas sprites, made on a worker thread for browsing assets at a fraction of the
+ * memory and descriptors of their textures.
+ *
+ * A thumbnail looked up for the first time is queued for the worker, which crops the source rect out of the image and
+ * halves it with Image::Downsample, the SIMD box filter, until it fits THUMBNAIL_SIZE. What it made is stored under
+ * cache/thumbnails by a hash of the image file and the rect, so later runs only read the file to hash it and map the
+ * small cached pixels instead of decoding it. The next Update places what the worker finished in a cell of a page
+ * texture and uploads the rows it changed, so any number of thumbnails take MAX_PAGE_COUNT descriptors at most. Cells
+ * are never given up, once they are all taken further thumbnails are not made.
+ *
+ * A thumbnail is made once per run from the file as it was then, hot reloaded images keep their old one. Everything
+ * but the worker is called by the renderer on its thread.
+ */
+class ThumbnailCache {
+public:
+    static constexpr u32 PAGE_SIZE{1024};
+    static constexpr u32 THUMBNAIL_SIZE{64};
+    static constexpr u32 MAX_PAGE_COUNT{4};
+    static constexpr u32 CELLS_PER_ROW{PAGE_SIZE / THUMBNAIL_SIZE};
+    static constexpr u32 CELLS_PER_PAGE{CELLS_PER_ROW * CELLS_PER_ROW};
+
+    ThumbnailCache(BufferManager *buffer_manager, TextureManager *texture_manager);
+    ~ThumbnailCache(); // Drops the thumbnails still queued
+
+    ThumbnailCache(const ThumbnailCache &) = delete;
+    ThumbnailCache &operator=(const ThumbnailCache &) = delete;
+
+    // The thumbnail once it is placed, null while it is made or when the image could not be read. Queues it the first
+    // time. source_rect is of the image as textures are loaded, {0, 0, 1, 1} for all of it. The pointer is valid
+    // until the next Find or Update.
+    [[nodiscard]] const Thumbnail *Find(StringView image_filepath, const UVRect<f32> &source_rect);
+
+    // Places the thumbnails made since the last call and uploads what changed
+    void Update();
+
+    [[nodiscard]] u32 GetThumbnailCount() const noexcept { return m_used_cell_count; }
+
+private:
+    struct Request {
+        u64 key;
+        String image_filepath;
+        UVRect<f32> source_rect;
+    };
+
+    struct Generated {
+        u64 key;
+        Vector<u8> pixels; // RGBA, width * height, bottom row first
+        ImageSize size;
+        bool is_failed;
+    };
+
+    enum class ThumbnailState : u8 { Queued, Placed, Failed };
+
+    struct Entry {
+        Thumbnail thumbnail;
+        u32 cell;
+        ThumbnailState state;
+    };
+
+    struct Page {
+        Vector<u8> pixels; // RGBA, bottom row first like the texture coordinates
+        u32 texture_id{0};
+        u32 dirty_first_row{PAGE_SIZE};
+        u32 dirty_last_row{0}; // Exclusive
+    };
+
+    // What the worker reused from the last request, consecutive sprites of one atlas read and decode it once
+    struct SourceImage;
+
+    void Place(const Generated &generated, u32 cell, Thumbnail &thumbnail); // Into the page's pixels
+    void UploadPages();
+    [[nodiscard]] static Generated Generate(const Request &request, SourceImage &source);
+    void Run(const std::stop_token &stop_token);
+
+private:
+    BufferManager *p_buffer_manager;
+    TextureManager *p_texture_manager;
+
+    FlatHashMap<u64, Entry> m_thumbnails; // By a hash of the file path and source rect
+    SmallVector<Page, MAX_PAGE_COUNT> m_pages; // Created as the cells before them fill up
+    u32 m_used_cell_count;
+    bool m_is_full_warned;
+
+    std::mutex m_mutex;
+    std::condition_variable_any m_condition;
+    Vector<Request> m_requests;
+    Vector<Generated> m_results;
+
+    std::jthread m_thread; // Last, started once the rest is set up
+};
+
+} // namespace gouda::vk
@@ -16,6 +16,10 @@
 
 namespace gouda::vk {
 
+// Frame counters the Vulkan code adds to, see ENGINE_PROFILE_COUNT. RenderStatistics reports their last samples.
+inline constexpr StringView UPLOADED_BYTES_COUNTER{"Uploaded bytes"};
+inline constexpr StringView DESCRIPTOR_WRITES_COUNTER{"Descriptor writes"};
+
 inline void check_vk_result(const VkResult res, const char *msg, const char *file, int line)
 {
     if (res != VK_SUCCESS) {
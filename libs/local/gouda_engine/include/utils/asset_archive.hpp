@@ -0,0 +1,123 @@
+#pragma once
+/**
+ * @file utils/asset_archive.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine packed asset archive and the archives mounted over the loose files
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <array>
+#include <span>
+
+#include "core/types.hpp"
+#include "utils/filesystem.hpp"
+#include "utils/mapped_file.hpp"
+
+namespace gouda::fs {
+
+/**
+ * @struct ArchiveSource
+ * @brief A file to pack and the path it is found under once the archive is mounted.
+ */
+struct ArchiveSource {
+    String path; ///< As the loaders ask for it, e.g. "assets/textures/sprite_sheet.png"
+    FilePath filepath;
+};
+
+/**
+ * @class AssetArchive
+ * @brief Read only pack of many files in one, opened with a single mapping.
+ *
+ * The index is a table of path hashes sorted for binary search, read in place from the mapping, so opening an
+ * archive allocates nothing and a lookup touches a handful of cache lines. Entries start on ENTRY_ALIGNMENT byte
+ * boundaries. Each entry is stored as is or LZ4 compressed, whichever the packer found worth it. Stored entries are
+ * read as views into the mapping, compressed ones are decompressed into a buffer on every read.
+ *
+ * Paths are matched after NormalizePath, so "assets/./fonts/a.json" and "assets\\fonts\\a.json" find the same entry.
+ */
+class AssetArchive {
+public:
+    static constexpr u32 ENTRY_ALIGNMENT{16};
+
+    /**
+     * @brief Maps an archive and validates its index.
+     * @param filepath Path to the .gpak file.
+     * @return The archive or an Error code.
+     */
+    [[nodiscard]] static Expect<AssetArchive, Error> Open(StringView filepath);
+
+    /**
+     * @brief Packs files into a new archive, replacing any file at output_filepath.
+     * @param sources Files to pack, a path given twice keeps the first. Empty files are skipped.
+     * @param compress Whether to try LZ4 on every entry, entries it shrinks by less than an eighth stay uncompressed.
+     * @return Success or an Error code.
+     */
+    [[nodiscard]] static Expect<void, Error> Write(StringView output_filepath, std::span<const ArchiveSource> sources,
+                                                   bool compress);
+
+    /**
+     * @brief Forward slashes and no "." or ".." components, the form the archive stores paths in.
+     */
+    [[nodiscard]] static String NormalizePath(StringView path);
+
+    [[nodiscard]] bool Contains(StringView path) const { return Find(NormalizePath(path)) != nullptr; }
+
+    /**
+     * @brief Opens an entry like MappedFile::Open opens a file, the archive has to outlive the result.
+     * @return The entry's contents, FileNotFound if the archive does not hold the path.
+     */
+    [[nodiscard]] Expect<MappedFile, Error> Read(StringView path) const;
+
+    [[nodiscard]] u32 GetEntryCount() const noexcept { return static_cast<u32>(m_entries.size()); }
+    [[nodiscard]] StringView GetFilepath() const noexcept { return m_filepath; }
+
+private:
+    // The index as stored in the file, read in place
+    struct Entry {
+        u64 path_hash; // FNV-1a of the normalized path
+        u64 offset;    // From the start of the archive
+        u64 stored_size;
+        u64 size; // Once decompressed
+        u32 path_offset;
+        u32 path_length;
+        u8 compression;
+        std::array<u8, 7> reserved;
+    };
+
+    AssetArchive(MappedFile file, StringView filepath, std::span<const Entry> entries, StringView paths);
+
+    [[nodiscard]] const Entry *Find(StringView normalized_path) const;
+    [[nodiscard]] StringView GetPath(const Entry &entry) const;
+
+private:
+    MappedFile m_file;
+    String m_filepath;
+    std::span<const Entry> m_entries; // Into the mapping, sorted by path hash
+    StringView m_paths;               // Into the mapping, the entries' paths back to back
+};
+
+/**
+ * @brief Mounts an archive over the loose files, MappedFile::Open, ReadFile and ReadBinaryFile then look in it first.
+ *
+ * Archives mounted later take precedence, so a patch archive can override single files. Mount and unmount only when
+ * no load is running, the list of mounted archives is not synchronized.
+ *
+ * @return Success or the Error AssetArchive::Open failed with.
+ */
+[[nodiscard]] Expect<void, Error> MountArchive(StringView filepath);
+
+/**
+ * @brief Unmounts every archive, views read from them must not be used afterwards.
+ */
+void UnmountArchives();
+
+/**
+ * @brief The most recently mounted archive holding the path, null if none does.
+ */
+[[nodiscard]] const AssetArchive *FindMountedArchive(StringView path);
+
+} // namespace gouda::fs
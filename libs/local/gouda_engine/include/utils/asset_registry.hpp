@@ -0,0 +1,229 @@
+#pragma once
+/**
+ * @file utils/asset_registry.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine deduplicated, reference counted asset handles
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <functional>
+#include <initializer_list>
+#include <memory>
+
+#include "audio/music_track.hpp"
+#include "audio/sound_bank.hpp"
+#include "containers/flat_hash_map.hpp"
+#include "containers/slot_map.hpp"
+#include "containers/small_vector.hpp"
+#include "core/types.hpp"
+
+namespace gouda {
+
+namespace vk {
+class Renderer;
+}
+
+enum class AssetType : u8 {
+    Texture,
+    Atlas,
+    Font,
+    Sound,
+    Music,
+};
+
+/**
+ * @class AssetHandle
+ * @brief An entry of the AssetRegistry, typed so a font handle cannot be passed where a texture is expected.
+ */
+template <AssetType Type>
+class AssetHandle {
+public:
+    static constexpr u32 INVALID_INDEX{constants::u32_max};
+
+    constexpr AssetHandle() noexcept : m_index{INVALID_INDEX} {}
+    constexpr explicit AssetHandle(const u32 index) noexcept : m_index{index} {}
+
+    [[nodiscard]] constexpr bool IsValid() const noexcept { return m_index != INVALID_INDEX; }
+    [[nodiscard]] constexpr u32 GetIndex() const noexcept { return m_index; }
+
+    constexpr bool operator==(const AssetHandle &) const noexcept = default;
+
+private:
+    u32 m_index;
+};
+
+using TextureHandle = AssetHandle<AssetType::Texture>;
+using AtlasHandle = AssetHandle<AssetType::Atlas>;
+using FontHandle = AssetHandle<AssetType::Font>;
+using SoundHandle = AssetHandle<AssetType::Sound>;
+using MusicHandle = AssetHandle<AssetType::Music>;
+
+using AssetDependentID = SlotHandle;
+
+/**
+ * @class AssetRegistry
+ * @brief One place textures, atlases, fonts, sounds and music are loaded through, each file loaded once.
+ *
+ * Assets are keyed by a hash of their type and normalized paths, so "assets/./a.png" and "assets\\a.png" are the
+ * same texture and take one slot. Every Load adds a reference that Release drops. An asset nothing references is
+ * unloaded once it has stayed that way for the unload delay, so a state switch that releases and reloads the same
+ * files keeps them resident. Unloaded textures keep their slot and are evicted rather than destroyed, loading them
+ * again or drawing them streams them back. Fonts, sounds and music have no unload in their owners and stay resident
+ * until shutdown. Every call belongs on the main thread.
+ *
+ * Whatever copies data out of an asset, sprite rects into instances or a tilemap palette, glyphs laid out once,
+ * registers as a dependent of the assets it reads. The renderer hot reloads textures and fonts itself, then Update
+ * matches the files it reports against the assets and calls each affected dependent once, so only what was derived
+ * from a changed file is derived again. Sprite pointers from GetSprite do not survive their atlas JSON being reloaded
+ * and have to be looked up again by the dependent.
+ */
+class AssetRegistry {
+public:
+    static constexpr u32 DEFAULT_UNLOAD_DELAY_FRAMES{120};
+
+    /**
+     * @param renderer Loads textures and fonts.
+     * @param sound_bank Decodes sounds, already deduplicated by path, the registry adds the reference counts.
+     */
+    AssetRegistry(vk::Renderer *renderer, audio::SoundBank *sound_bank);
+    ~AssetRegistry();
+
+    AssetRegistry(const AssetRegistry &) = delete;
+    AssetRegistry &operator=(const AssetRegistry &) = delete;
+
+    // Each adds a reference, the file is only loaded the first time, textures and atlases asynchronously
+    [[nodiscard]] TextureHandle LoadTexture(StringView filepath);
+    [[nodiscard]] AtlasHandle LoadAtlas(StringView image_filepath, StringView json_filepath);
+    [[nodiscard]] FontHandle LoadFont(StringView image_filepath, StringView json_filepath);
+    [[nodiscard]] SoundHandle LoadSound(StringView filepath);
+    [[nodiscard]] MusicHandle LoadMusic(StringView filepath);
+
+    template <AssetType Type>
+    void AddReference(const AssetHandle<Type> handle)
+    {
+        AddReference(handle.GetIndex(), Type);
+    }
+
+    // The asset is unloaded once nothing has referenced it for the unload delay, invalid handles are ignored
+    template <AssetType Type>
+    void Release(const AssetHandle<Type> handle)
+    {
+        Release(handle.GetIndex(), Type);
+    }
+
+    /**
+     * @brief Registers a callback that derives data from assets, called whenever any of them changed.
+     * @return ID for RemoveDependent, the callback may add and remove dependents itself.
+     */
+    template <AssetType... Types>
+    AssetDependentID AddDependent(std::function<void()> rederive, const AssetHandle<Types>... assets)
+    {
+        return AddDependentOf(std::move(rederive), {GetEntryIndex(assets)...});
+    }
+
+    void RemoveDependent(AssetDependentID dependent);
+
+    /**
+     * @brief Calls the asset's dependents at the next Update, for changes the renderer does not see.
+     */
+    template <AssetType Type>
+    void MarkChanged(const AssetHandle<Type> asset)
+    {
+        m_changed_entries.push_back(GetEntryIndex(asset));
+    }
+
+    /**
+     * @brief Calls the dependents of the assets whose files changed, then unloads the assets whose delay ran out. Once
+     * per frame.
+     */
+    void Update();
+
+    // Ids as the renderer and sound bank take them
+    [[nodiscard]] u32 GetTextureID(TextureHandle handle) const;
+    [[nodiscard]] u32 GetTextureID(AtlasHandle handle) const;
+    [[nodiscard]] u32 GetFontID(FontHandle handle) const;
+    [[nodiscard]] audio::SoundID GetSoundID(SoundHandle handle) const;
+    [[nodiscard]] audio::MusicTrack &GetMusic(MusicHandle handle) const;
+
+    // For data that only knows the id it is drawn with, no reference is added. Invalid if the registry did not load it.
+    [[nodiscard]] AtlasHandle FindAtlas(const u32 texture_id) const
+    {
+        return AtlasHandle{FindEntry(AssetType::Atlas, texture_id)};
+    }
+    [[nodiscard]] FontHandle FindFont(const u32 font_id) const
+    {
+        return FontHandle{FindEntry(AssetType::Font, font_id)};
+    }
+
+    template <AssetType Type>
+    [[nodiscard]] u32 GetReferenceCount(const AssetHandle<Type> handle) const
+    {
+        return GetEntry(handle.GetIndex(), Type).reference_count;
+    }
+
+    void SetUnloadDelay(const u32 frame_count) noexcept { m_unload_delay_frames = frame_count; }
+    [[nodiscard]] size_t GetAssetCount() const noexcept { return m_entries.size(); }
+    [[nodiscard]] u32 GetDeduplicatedLoadCount() const noexcept { return m_deduplicated_load_count; }
+    [[nodiscard]] size_t GetDependentCount() const noexcept { return m_dependents.Size(); }
+
+private:
+    struct Entry {
+        String filepath;      // Normalized, the image for atlases and fonts
+        String json_filepath; // Normalized, empty for textures, sounds and music
+        AssetType type;
+        u32 id; // Texture, font or sound id, index into m_music for music
+        u32 reference_count;
+        u64 released_frame; // Frame the count last dropped to zero
+        bool resident;      // False once unloaded, until it is loaded again
+    };
+
+    struct Dependent {
+        std::function<void()> rederive;
+        SmallVector<u32, 2> entry_indices;
+    };
+
+    // Returns the entry's index, with a reference added, or INVALID_INDEX if the path is not registered yet
+    [[nodiscard]] u32 Acquire(u64 key);
+    u32 Register(u64 key, StringView filepath, StringView json_filepath, AssetType type, u32 id);
+
+    template <AssetType Type>
+    [[nodiscard]] u32 GetEntryIndex(const AssetHandle<Type> asset) const
+    {
+        GetEntry(asset.GetIndex(), Type);
+        return asset.GetIndex();
+    }
+
+    AssetDependentID AddDependentOf(std::function<void()> rederive, std::initializer_list<u32> entry_indices);
+    void FindChangedEntries(); // From the files the renderer reloaded
+    void RederiveDependents();
+
+    void AddReference(u32 index, AssetType type);
+    void Release(u32 index, AssetType type);
+    void Unload(Entry &entry);
+
+    const Entry &GetEntry(u32 index, AssetType type) const; // Asserts the handle is of the type
+    [[nodiscard]] u32 FindEntry(AssetType type, u32 id) const;
+
+private:
+    static constexpr u32 INVALID_INDEX{constants::u32_max};
+
+    vk::Renderer *p_renderer;
+    audio::SoundBank *p_sound_bank;
+
+    Vector<Entry> m_entries;                            // Indexed by handle
+    FlatHashMap<u64, u32> m_entry_indices;              // Keyed by type and normalized paths
+    Vector<u32> m_released_entries;                     // Unreferenced and resident, checked by Update
+    Vector<std::unique_ptr<audio::MusicTrack>> m_music; // Boxed, the audio manager queues tracks by reference
+    SlotMap<Dependent> m_dependents;
+    Vector<u32> m_changed_entries; // Whose dependents the next Update calls, may repeat
+
+    u64 m_frame;
+    u32 m_unload_delay_frames;
+    u32 m_deduplicated_load_count; // Loads that found their asset registered
+};
+
+} // namespace gouda
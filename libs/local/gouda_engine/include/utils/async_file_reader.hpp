@@ -0,0 +1,113 @@
+#pragma once
+/**
+ * @file utils/async_file_reader.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine asynchronous whole file reads
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "containers/small_vector.hpp"
+#include "core/types.hpp"
+#include "utils/filesystem.hpp"
+
+namespace gouda::fs {
+
+enum class AsyncReadBackend : u8 { IoUring, CompletionPort, ThreadPool };
+inline constexpr size_t ASYNC_READ_BACKEND_COUNT{static_cast<size_t>(AsyncReadBackend::ThreadPool) + 1};
+
+[[nodiscard]] StringView GetAsyncReadBackendName(AsyncReadBackend backend);
+
+using AsyncReadResult = Expect<std::vector<std::byte>, Error>;
+
+/**
+ * @class AsyncFileReader
+ * @brief Reads whole files off the calling thread, keeping many reads in flight at once.
+ *
+ * Reads are queued from any thread and handed to the kernel as soon as a slot is free: through io_uring on Linux
+ * and an I/O completion port on Windows, both driven by one service thread. Where neither is available, or the
+ * kernel refuses to set one up (io_uring is often disabled in containers), a few threads do blocking reads instead.
+ * The results are the same as fs::ReadBinaryFile's, an empty file is a FileReadError.
+ *
+ * Callbacks run on the reader's thread and should only hand the data on, e.g. to a job or a queue the main thread
+ * drains. Destroying the reader waits for the reads already handed to the kernel, the ones still queued complete
+ * with ReadCancelled.
+ */
+class AsyncFileReader {
+public:
+    using Callback = std::function<void(AsyncReadResult result)>;
+
+    static constexpr u32 DEFAULT_MAX_READS_IN_FLIGHT{64};
+    static constexpr u32 DEFAULT_FALLBACK_THREAD_COUNT{2};
+
+    /**
+     * @brief Sets up the platform queue and starts the reader's threads.
+     * @param max_reads_in_flight Reads handed to the kernel at once, the rest wait in a queue.
+     * @param fallback_thread_count Threads doing blocking reads when there is no platform queue.
+     */
+    explicit AsyncFileReader(u32 max_reads_in_flight = DEFAULT_MAX_READS_IN_FLIGHT,
+                             u32 fallback_thread_count = DEFAULT_FALLBACK_THREAD_COUNT);
+    ~AsyncFileReader();
+
+    AsyncFileReader(const AsyncFileReader &) = delete;
+    AsyncFileReader &operator=(const AsyncFileReader &) = delete;
+
+    /**
+     * @brief Queues a read of the whole file, callback is called with the contents or the error once it is done.
+     */
+    void Read(StringView filepath, Callback callback);
+
+    /**
+     * @brief Queues a read of the whole file, the future becomes ready once it is done.
+     */
+    [[nodiscard]] std::future<AsyncReadResult> Read(StringView filepath);
+
+    [[nodiscard]] AsyncReadBackend GetBackend() const noexcept { return m_backend; }
+
+    /**
+     * @brief Reads queued or in flight, whose callbacks have not returned yet.
+     */
+    [[nodiscard]] u32 GetPendingCount() const noexcept { return m_pending_count.load(std::memory_order_relaxed); }
+
+private:
+    struct Request {
+        String filepath;
+        Callback callback;
+    };
+
+    struct PlatformQueue; // io_uring or completion port state, only defined where the platform has one
+
+    void ServiceLoop();
+    void PoolLoop(const std::stop_token &stop_token);
+    void Wake();
+    [[nodiscard]] bool TakeRequest(Request &request);
+    void Complete(Request &request, AsyncReadResult result);
+
+private:
+    AsyncReadBackend m_backend;
+    u32 m_max_reads_in_flight;
+    std::unique_ptr<PlatformQueue> p_queue;
+
+    std::mutex m_mutex;
+    std::condition_variable_any m_request_condition; // Pool threads sleep on it
+    std::deque<Request> m_requests;                  // Not handed to the kernel or a pool thread yet
+    std::atomic<u32> m_pending_count;
+    std::atomic<bool> m_is_stopping;
+
+    Vector<std::jthread> m_threads;
+};
+
+} // namespace gouda::fs
@@ -0,0 +1,230 @@
+#pragma once
+/**
+ * @file utils/event_bus.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine typed event bus
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#include "containers/flat_hash_map.hpp"
+#include "containers/small_vector.hpp"
+#include "core/types.hpp"
+#include "debug/assert.hpp"
+#include "utils/hash.hpp"
+
+namespace gouda {
+
+using EventTypeId = u64;
+
+namespace internal {
+
+// The compiler's signature of the instantiation names the type, so it tells event types apart without RTTI
+template <typename T>
+[[nodiscard]] consteval StringView event_type_signature() noexcept
+{
+#if defined(_MSC_VER)
+    return __FUNCSIG__;
+#else
+    return __PRETTY_FUNCTION__;
+#endif
+}
+
+} // namespace internal
+
+/// Fixed at compile time, the same in every translation unit and build of one compiler
+template <typename T>
+inline constexpr EventTypeId EVENT_TYPE_ID{utils::fnv1a(internal::event_type_signature<std::remove_cvref_t<T>>())};
+
+// Identifies one handler, for EventBus::Unsubscribe
+struct EventSubscription {
+    EventTypeId type;
+    u32 id;
+};
+
+/**
+ * @class EventBus
+ * @brief Queues gameplay events by type and hands each type's events to its handlers in one batch per frame.
+ *
+ * Every event type has its own contiguous queue, found by a compile time hash of the type, so emitting copies the
+ * event into a vector that keeps its capacity from frame to frame and neither allocates nor compares strings once the
+ * queues have grown. Types are dispatched in the order they were first used, handlers of a type in the order they
+ * subscribed. Each queue is swapped out before its handlers run, so an event a handler emits reaches the handlers of
+ * a later type in the same Dispatch and those of its own or an earlier type in the next. Not thread safe, jobs hand
+ * their events to the main thread first.
+ */
+class EventBus {
+public:
+    template <typename T>
+    using Handler = std::function<void(std::span<const T> events)>;
+
+    EventBus() = default;
+    ~EventBus();
+
+    EventBus(const EventBus &) = delete;
+    EventBus &operator=(const EventBus &) = delete;
+
+    template <typename T>
+    void Emit(const T &event)
+    {
+        GetQueue<T>().pending.push_back(event);
+    }
+
+    template <typename T, typename... Args>
+    T &Emplace(Args &&...args)
+    {
+        return GetQueue<T>().pending.emplace_back(std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Adds a handler called with every event of the type emitted since the last Dispatch. Not allowed from
+     * the type's own handlers.
+     * @return Subscription to pass to Unsubscribe, which subscribers outliving the handler's captures must call.
+     */
+    template <typename T>
+    EventSubscription Subscribe(Handler<T> handler)
+    {
+        Queue<T> &queue{GetQueue<T>()};
+        ASSERT(!queue.is_dispatching, "Handlers cannot subscribe to the event type they are handling.");
+        const u32 id{queue.next_subscription_id++};
+        queue.subscribers.push_back({std::move(handler), id});
+        return {EVENT_TYPE_ID<T>, id};
+    }
+
+    /**
+     * @brief Removes a handler. Safe to call from a handler, the removed one is not called again.
+     */
+    void Unsubscribe(EventSubscription subscription);
+
+    /**
+     * @brief Returns the events of a type emitted since the last Dispatch, for code polling rather than subscribing.
+     * Invalidated by the next Emit of the type.
+     */
+    template <typename T>
+    [[nodiscard]] std::span<const T> GetPendingEvents() const
+    {
+        const Queue<T> *queue{FindQueue<T>()};
+        return queue ? std::span<const T>{queue->pending.data(), queue->pending.size()} : std::span<const T>{};
+    }
+
+    /**
+     * @brief Hands every queued event to its type's handlers and empties the queues, called once per frame.
+     */
+    void Dispatch();
+
+    /**
+     * @brief Drops every queued event without calling any handler, e.g. when the states they were meant for are gone.
+     */
+    void Clear();
+
+    [[nodiscard]] size_t GetPendingCount() const; ///< Queued events of every type
+
+private:
+    class QueueBase {
+    public:
+        virtual ~QueueBase() = default;
+
+        virtual void Dispatch() = 0;
+        virtual void Clear() = 0;
+        virtual void Unsubscribe(u32 id) = 0;
+        [[nodiscard]] virtual size_t GetPendingCount() const = 0;
+    };
+
+    template <typename T>
+    struct Queue final : QueueBase {
+        struct Subscriber {
+            Handler<T> handler; // Null once unsubscribed until the queue is done dispatching
+            u32 id;
+        };
+
+        void Dispatch() override
+        {
+            if (pending.empty()) {
+                return;
+            }
+
+            std::swap(pending, dispatching);
+            is_dispatching = true;
+            const std::span<const T> events{dispatching.data(), dispatching.size()};
+            for (size_t i = 0; i < subscribers.size(); ++i) {
+                if (subscribers[i].handler) {
+                    subscribers[i].handler(events);
+                }
+            }
+            is_dispatching = false;
+            dispatching.clear();
+
+            if (has_removed_subscribers) {
+                const auto removed{std::ranges::remove_if(subscribers, [](const Subscriber &subscriber) {
+                    return !subscriber.handler;
+                })};
+                subscribers.erase(removed.begin(), removed.end());
+                has_removed_subscribers = false;
+            }
+        }
+
+        void Clear() override { pending.clear(); }
+
+        void Unsubscribe(const u32 id) override
+        {
+            for (size_t i = 0; i < subscribers.size(); ++i) {
+                if (subscribers[i].id != id) {
+                    continue;
+                }
+                if (is_dispatching) {
+                    subscribers[i].handler = nullptr;
+                    has_removed_subscribers = true;
+                }
+                else {
+                    subscribers.erase(subscribers.begin() + i);
+                }
+                return;
+            }
+        }
+
+        [[nodiscard]] size_t GetPendingCount() const override { return pending.size(); }
+
+        Vector<T> pending;
+        Vector<T> dispatching; // The events handed to the handlers, kept for its capacity
+        Vector<Subscriber> subscribers;
+        u32 next_subscription_id{0};
+        bool is_dispatching{false};
+        bool has_removed_subscribers{false};
+    };
+
+    template <typename T>
+    [[nodiscard]] Queue<T> &GetQueue()
+    {
+        static_assert(std::is_same_v<T, std::remove_cvref_t<T>>, "Events are emitted and handled by value type.");
+        if (const u32 *index{m_queue_indices.get(EVENT_TYPE_ID<T>)}) {
+            return static_cast<Queue<T> &>(*m_queues[*index]);
+        }
+
+        m_queue_indices.emplace(EVENT_TYPE_ID<T>, static_cast<u32>(m_queues.size()));
+        m_queues.push_back(std::make_unique<Queue<T>>());
+        return static_cast<Queue<T> &>(*m_queues.back());
+    }
+
+    template <typename T>
+    [[nodiscard]] const Queue<T> *FindQueue() const
+    {
+        const u32 *index{m_queue_indices.get(EVENT_TYPE_ID<T>)};
+        return index ? static_cast<const Queue<T> *>(m_queues[*index].get()) : nullptr;
+    }
+
+private:
+    FlatHashMap<EventTypeId, u32> m_queue_indices;
+    Vector<std::unique_ptr<QueueBase>> m_queues; // In the order the types were first used
+};
+
+} // namespace gouda
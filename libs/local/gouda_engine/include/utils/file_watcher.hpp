@@ -0,0 +1,82 @@
+#pragma once
+/**
+ * @file utils/file_watcher.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine background file change watcher
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "containers/small_vector.hpp"
+#include "core/types.hpp"
+
+namespace gouda::fs {
+
+/**
+ * @class FileWatcher
+ * @brief Watches a set of files on a background thread and queues the ones that were written.
+ *
+ * On Linux the parent directories are watched with inotify, so a file saved by writing it in place or by renaming a
+ * temporary over it is reported once it was closed. Elsewhere, or when inotify is unavailable, the thread polls the
+ * last write times instead. Either way the owner only pays for an atomic load per PollChanges while nothing changed.
+ */
+class FileWatcher {
+public:
+    FileWatcher();
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher &) = delete;
+    FileWatcher &operator=(const FileWatcher &) = delete;
+    FileWatcher(FileWatcher &&) = delete;
+    FileWatcher &operator=(FileWatcher &&) = delete;
+
+    /**
+     * @brief Starts watching a file, watching the same path twice has no effect.
+     * @param filepath Path to the file, reported back by PollChanges exactly as given here.
+     * @return False if the file's directory could not be watched.
+     */
+    bool Watch(StringView filepath);
+
+    /**
+     * @brief Returns the watched files written since the last call, each at most once.
+     */
+    [[nodiscard]] Vector<String> PollChanges();
+
+    /**
+     * @brief Checks whether changes come from OS notifications rather than polling.
+     */
+    [[nodiscard]] bool IsNative() const noexcept { return m_notify_handle >= 0; }
+
+private:
+    void WatchLoop(const std::stop_token &stop_token);
+    void ReadNotifications();
+    void PollWriteTimes();
+    void PushChange(const String &filepath); // Expects m_mutex to be held
+
+private:
+    struct WatchedFile {
+        String filepath;  // As passed to Watch
+        String file_name; // Name inside the watched directory
+        FileTimeType last_write_time;
+        int watch_handle; // Directory watch the file belongs to, -1 when polled
+    };
+
+    std::mutex m_mutex;
+    std::condition_variable_any m_stop_condition;
+    Vector<WatchedFile> m_files;
+    Vector<String> m_changes;
+    std::atomic<bool> m_has_changes;
+    int m_notify_handle; // inotify instance, -1 when polling
+
+    std::jthread m_thread; // Last, so it starts after and stops before the state above
+};
+
+} // namespace gouda::fs
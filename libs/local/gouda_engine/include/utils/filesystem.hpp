@@ -46,18 +46,19 @@ enum class Error : u8 {
     DirectoryNotFound,       ///< Directory not found
     DirectoryInvalid,        ///< Invalid directory path
     FileDeleteFailed,        ///< Failed to delete file
-    DirectoryDeleteFailed    ///< Failed to delete directory
+    DirectoryDeleteFailed,   ///< Failed to delete directory
+    ReadCancelled            ///< Asynchronous read dropped before it started
 };
 
 constexpr StringView error_to_string(Error error) noexcept
 {
-    constexpr std::array<StringView, 11> error_strings{
+    constexpr std::array<StringView, 12> error_strings{
         "No error occurred",           "Path exists but is not a directory",
         "Failed to create directory",  "File not found",
         "Error reading file",          "Error writing to file",
         "Provided file name is empty", "Directory not found",
         "Invalid directory path",      "Failed to delete file",
-        "Failed to delete directory"};
+        "Failed to delete directory",  "Read cancelled before it started"};
 
     const auto index = static_cast<std::size_t>(error);
     return index < error_strings.size() ? error_strings[index] : "Unknown error";
@@ -86,6 +87,14 @@ constexpr StringView error_to_string(Error error) noexcept
  */
 [[nodiscard]] Expect<void, Error> WriteFile(StringView file_name, const String &data);
 
+/**
+ * @brief Appends a string to the end of a file, creating the file if it does not exist.
+ * @param file_name Name of the file.
+ * @param data Data to append.
+ * @return Success or an Error code, FileWriteError if the data could not be written in full.
+ */
+[[nodiscard]] Expect<void, Error> AppendFile(StringView file_name, const String &data);
+
 /**
  * @brief Reads an entire binary file into a vector of bytes.
  * @param file_name Name of the file to read.
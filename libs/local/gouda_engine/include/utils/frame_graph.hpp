@@ -0,0 +1,92 @@
+#pragma once
+/**
+ * @file utils/frame_graph.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine per frame task dependency graph
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <initializer_list>
+#include <mutex>
+
+#include "containers/small_vector.hpp"
+#include "core/types.hpp"
+
+namespace gouda {
+
+class JobSystem;
+
+/**
+ * @class FrameGraph
+ * @brief The stages of a frame as a graph built once and run every frame, each task as soon as the tasks it depends
+ * on finished.
+ *
+ * Where StartupGraph runs once and logs its timeline, a frame graph keeps its tasks and only resets their counts at
+ * the start of every Run, which allocates nothing. Stages with nothing in common, such as culling separate layers and
+ * building particle instances, then overlap on the job system's workers without the caller splitting them up. Tasks
+ * that have to stay on the main thread, anything calling into the renderer, run on the thread calling Run in the
+ * order they become ready, alongside the workers. Tasks can only depend on tasks added before them, so the order
+ * they were added in is always one they can run in, and every task is profiled under its name.
+ */
+class FrameGraph {
+public:
+    using Task = std::function<void()>;
+    using TaskId = u32;
+
+    enum class TaskThread : u8 { Any, Main };
+
+    FrameGraph();
+
+    /**
+     * @brief Adds a task, run every frame once the tasks it depends on finished.
+     * @param name Name the task is profiled under, a literal.
+     * @param dependencies Tasks added earlier that have to finish first.
+     * @return Id to depend on the task by.
+     */
+    TaskId AddTask(StringView name, Task task, std::initializer_list<TaskId> dependencies = {},
+                   TaskThread thread = TaskThread::Any);
+
+    /**
+     * @brief Runs every task once, returning when all finished. Must be called from the job system's main thread.
+     * @param job_system Runs the tasks not bound to the main thread, null runs every task on the caller in the order
+     * they were added.
+     *
+     * A task that throws still counts as finished so the rest of the frame drains, the first exception thrown is
+     * rethrown once it has.
+     */
+    void Run(JobSystem *job_system);
+
+    [[nodiscard]] size_t GetTaskCount() const noexcept { return m_tasks.size(); }
+
+private:
+    struct TaskEntry {
+        StringView name;
+        Task task;
+        TaskThread thread;
+        SmallVector<TaskId, 4> dependants;
+        u32 dependency_count;
+        u32 pending_dependencies; // Counted down while the graph runs, reset from dependency_count
+    };
+
+    void Dispatch(TaskId id);
+    void Execute(TaskId id);
+
+private:
+    Vector<TaskEntry> m_tasks;
+
+    JobSystem *p_job_system; // Of the running frame
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    Vector<TaskId> m_main_thread_ready; // Guarded by m_mutex, like everything the tasks count down
+    u32 m_remaining_tasks;
+    std::exception_ptr m_exception;
+};
+
+} // namespace gouda
@@ -0,0 +1,107 @@
+#pragma once
+/**
+ * @file utils/frame_pacer.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine frame pacing
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <functional>
+#include <utility>
+
+#include "core/types.hpp"
+
+namespace gouda::utils {
+
+enum class PacingMode : u8 {
+    Uncapped,   // Frames start as soon as the previous one is submitted, the swapchain alone throttles them
+    FrameRate,  // Frames start a fixed period apart
+    PresentWait // Frames start as late after the previous one reached the screen as still makes the next refresh
+};
+
+/**
+ * @class FramePacer
+ * @brief Decides when a frame starts, called right before input is sampled so each frame starts from fresh input.
+ *
+ * Waits sleep until close to the deadline and spin the rest, since a sleep can overshoot by the scheduler's
+ * granularity. The overshoot is measured as it sleeps, so the spin stays as short as the system allows.
+ *
+ * With a present wait the pacer blocks until the previous frame is on screen instead of letting the CPU run frames
+ * ahead into the swapchain queue, then delays the next start by whatever the CPU and GPU work is not expected to
+ * need of the refresh period. Input then reaches the screen within about one refresh rather than several.
+ */
+class FramePacer {
+public:
+    /**
+     * @brief Blocks until the last presented frame is on screen.
+     * @return False when it could not tell, the pacer then starts the frame straight away.
+     */
+    using PresentWait = std::function<bool()>;
+
+    /**
+     * @brief Runs between the sleep slices of a wait, at most once a slice.
+     */
+    using IdleCallback = std::function<void()>;
+
+    static constexpr FloatingPointMilliseconds DEFAULT_SAFETY_MARGIN{1.0};
+
+    FramePacer();
+
+    /**
+     * @brief Starts frames a fixed period apart, zero uncaps them. Replaces a present wait.
+     */
+    void SetTargetFrameRate(f32 target_fps);
+
+    /**
+     * @brief Paces frames to the display's refresh. Replaces a target frame rate.
+     * @param refresh_rate Refreshes per second of the display presented to.
+     */
+    void SetPresentWait(PresentWait present_wait, f32 refresh_rate);
+
+    /**
+     * @brief Time left unused before each expected refresh, so a frame running slightly long still makes it.
+     */
+    void SetSafetyMargin(FloatingPointMilliseconds margin) noexcept { m_safety_margin = margin; }
+
+    /**
+     * @brief Work to do while waiting, such as pumping input so events are timestamped as they arrive. It has to
+     * return well within a slice, the time it takes is not made up.
+     */
+    void SetIdleCallback(IdleCallback idle_callback) { m_idle_callback = std::move(idle_callback); }
+
+    /**
+     * @brief Blocks until the next frame should start.
+     */
+    void WaitForFrameStart();
+
+    /**
+     * @brief Marks the frame's CPU work done, call once it has been presented.
+     * @param gpu_time Milliseconds a recent frame took on the GPU, zero if unknown.
+     */
+    void EndFrame(f32 gpu_time);
+
+    [[nodiscard]] PacingMode GetMode() const noexcept { return m_mode; }
+    [[nodiscard]] FloatingPointMilliseconds GetLastWaitTime() const noexcept { return m_last_wait_time; }
+    [[nodiscard]] FloatingPointMilliseconds GetWorkEstimate() const noexcept { return m_work_estimate; }
+
+private:
+    void WaitUntil(SteadyClock::time_point deadline);
+
+private:
+    PacingMode m_mode;
+    PresentWait m_present_wait;
+    IdleCallback m_idle_callback;
+    SteadyClock::duration m_period; // Between frame starts, or between refreshes with a present wait
+    SteadyClock::time_point m_next_frame_start;
+    SteadyClock::time_point m_frame_start;
+    FloatingPointMilliseconds m_safety_margin;
+    FloatingPointMilliseconds m_work_estimate;   // CPU and GPU time of a frame, rises at once and falls slowly
+    FloatingPointMilliseconds m_sleep_overshoot; // How late sleeps have been waking up
+    FloatingPointMilliseconds m_last_wait_time;
+};
+
+} // namespace gouda::utils
@@ -0,0 +1,57 @@
+#pragma once
+/**
+ * @file utils/hash.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine non cryptographic hashing utilities
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <span>
+
+#include "core/types.hpp"
+
+namespace gouda::utils {
+
+constexpr u64 FNV1A_OFFSET_BASIS{0xcbf29ce484222325ull};
+constexpr u64 FNV1A_PRIME{0x100000001b3ull};
+
+/**
+ * @brief 64 bit FNV-1a hash, used for cache keys and file checksums.
+ * @param seed Previous hash to continue from, so several inputs can be hashed as one.
+ */
+[[nodiscard]] constexpr u64 fnv1a(const std::span<const std::byte> data, u64 seed = FNV1A_OFFSET_BASIS) noexcept
+{
+    for (const std::byte byte : data) {
+        seed ^= static_cast<u64>(byte);
+        seed *= FNV1A_PRIME;
+    }
+    return seed;
+}
+
+[[nodiscard]] constexpr u64 fnv1a(const StringView text, u64 seed = FNV1A_OFFSET_BASIS) noexcept
+{
+    for (const char character : text) {
+        seed ^= static_cast<u64>(static_cast<unsigned char>(character));
+        seed *= FNV1A_PRIME;
+    }
+    return seed;
+}
+
+/**
+ * @brief 64 bit integer finalizer (MurmurHash3 fmix64), every input bit affects every bit of the result.
+ */
+[[nodiscard]] constexpr u64 mix64(u64 value) noexcept
+{
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccdull;
+    value ^= value >> 33;
+    value *= 0xc4ceb9fe1a85ec53ull;
+    value ^= value >> 33;
+    return value;
+}
+
+} // namespace gouda::utils
@@ -20,12 +20,14 @@
  * along with this program. If not, see <https://www.gnu.org/licenses/>.
  */
 #include <expected>
+#include <optional>
 #include <span>
 #include <vector>
 
 #include "stb_image.h"
 
 #include "core/types.hpp"
+#include "utils/mapped_file.hpp"
 
 namespace gouda {
 
@@ -36,7 +38,8 @@ enum class ImageChannels { RGB, RGBA };
  */
 class Image {
 public:
-    /// Loads an image from file.
+    /// Loads an image from file. Decoded pixels are cached under cache/images by a hash of the file and the load
+    /// settings, later loads of the same file map the cached pixels instead of decoding and flipping it again.
     static Expect<Image, String> Load(StringView filename, int desired_channels = STBI_rgb_alpha, bool flip_horizontally = true);
 
     /// Saves the image to a file.
@@ -45,15 +48,36 @@ public:
     /// Converts the image to grayscale.
     [[nodiscard]] Image ToGrayscale() const;
 
-    /// Flips the image horizontally.
+    /// Flips the image horizontally, reversing the pixels of each row.
     void FlipHorizontal();
 
+    /// Flips the image vertically, swapping whole rows.
+    void FlipVertical();
+
+    /// Swaps the first and third channels, RGBA to BGRA and back. Images of fewer than 3 channels are left as they are.
+    void SwapRedBlue();
+
+    /// Multiplies the colour channels of a 4 channel image by its alpha, for premultiplied blending. Other images are
+    /// left as they are.
+    void PremultiplyAlpha();
+
     /// Rotates the image 90 degrees clockwise.
     [[nodiscard]] Image Rotate90() const;
 
+    /// Halves both dimensions with a 2x2 box filter, the next level of a CPU built mip chain. Odd dimensions round
+    /// down, a dimension of one stays one.
+    [[nodiscard]] Image Downsample() const;
+
     /// Resizes the image.
     [[nodiscard]] Expect<Image, String> Resize(int new_width, int new_height) const;
 
+    /// Creates an image with every channel of every pixel set to zero.
+    [[nodiscard]] static Image Blank(ImageSize size, int channels = STBI_rgb_alpha);
+
+    /// Copies an image with the same channel count into this one, its first row and column landing at x, y. The
+    /// source edge pixels are repeated border times around it, anything outside this image is clipped.
+    void Blit(const Image &source, int x, int y, int border = 0);
+
     /// Returns raw pixel data.
     [[nodiscard]] std::span<const stbi_uc> data() const;
 
@@ -83,12 +107,20 @@ private:
     /// Private constructor for internal use.
     explicit Image(std::vector<stbi_uc> data, ImageSize size, int channels);
 
+    /// Pixels read in place from a decode cache file.
+    explicit Image(fs::MappedFile cache_file, std::span<const stbi_uc> pixels, ImageSize size, int channels);
+
+    /// Copies mapped pixels into p_data before they are modified.
+    void own_pixels();
+
     /// Clears image data.
     void reset();
 
-    std::vector<stbi_uc> p_data; ///< Pixel data.
-    ImageSize m_size;            ///< Image dimensions.
-    int m_channels;              ///< Number of color channels.
+    std::vector<stbi_uc> p_data;                ///< Pixel data, unless mapped from the decode cache.
+    std::optional<fs::MappedFile> m_cache_file; ///< Decode cache file holding the pixels.
+    std::span<const stbi_uc> m_mapped_pixels;   ///< Into m_cache_file, empty when the pixels are in p_data.
+    ImageSize m_size;                           ///< Image dimensions.
+    int m_channels;                             ///< Number of color channels.
 };
 
 } // namespace gouda
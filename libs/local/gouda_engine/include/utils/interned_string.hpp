@@ -0,0 +1,64 @@
+#pragma once
+/**
+ * @file utils/interned_string.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine global string interning pool
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include "containers/flat_hash_map.hpp"
+#include "core/types.hpp"
+#include "utils/hash.hpp"
+
+namespace gouda {
+
+/**
+ * @class InternedString
+ * @brief A name stored once in a global pool, compared and hashed as a 32 bit id.
+ *
+ * StringId hashes a name and only keeps the text in debug builds. An interned string always keeps it: GetView returns
+ * the text in every build, and the view stays valid for the rest of the program. Interning the same text again, from
+ * any thread, returns the same id, so equal names are equal ids and a thousand copies of a name cost one. Interning
+ * hashes the text and takes a lock, so it belongs where names are first read, from files or a state's setup, and the
+ * ids are what per frame code keeps. GetView only reads, it takes no lock.
+ *
+ * The pool only grows, which suits the few thousand distinct names of states, entities and assets rather than
+ * arbitrary text. Ids are handed out in the order names are first interned, they differ between runs.
+ */
+class InternedString {
+public:
+    constexpr InternedString() noexcept : m_id{0} {} // The empty string
+
+    /**
+     * @brief Interns text, returning the id it already had if it was interned before. Thread safe.
+     */
+    explicit InternedString(StringView text);
+
+    [[nodiscard]] StringView GetView() const noexcept;
+    [[nodiscard]] constexpr u32 GetId() const noexcept { return m_id; }
+    [[nodiscard]] constexpr bool IsEmpty() const noexcept { return m_id == 0; }
+
+    constexpr bool operator==(const InternedString &) const noexcept = default;
+
+    /**
+     * @brief Distinct strings in the pool and the bytes their text takes, for the memory statistics.
+     */
+    [[nodiscard]] static size_t GetPoolCount();
+    [[nodiscard]] static size_t GetPoolBytes();
+
+private:
+    u32 m_id; // 0 for the empty string, which is never stored
+};
+
+template <>
+struct FlatHash<InternedString> {
+    using is_avalanching = void;
+
+    [[nodiscard]] size_t operator()(const InternedString text) const noexcept { return utils::mix64(text.GetId()); }
+};
+
+} // namespace gouda
@@ -0,0 +1,154 @@
+#pragma once
+/**
+ * @file utils/job_system.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine work stealing job system
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "containers/small_vector.hpp"
+#include "core/types.hpp"
+
+namespace gouda {
+
+class JobSystem;
+
+/**
+ * @class JobCounter
+ * @brief Counts the unfinished jobs scheduled against it, jobs can be held back until a counter reaches zero.
+ *
+ * A counter has to stay alive until JobSystem::Wait on it returned, or until it is otherwise known that no job
+ * scheduled against it is still running.
+ */
+class JobCounter {
+public:
+    JobCounter();
+
+    JobCounter(const JobCounter &) = delete;
+    JobCounter &operator=(const JobCounter &) = delete;
+
+    [[nodiscard]] bool IsDone() const noexcept { return m_pending.load(std::memory_order_acquire) == 0; }
+
+private:
+    friend class JobSystem;
+
+    struct Continuation {
+        std::function<void()> job;
+        JobCounter *counter;
+    };
+
+    std::atomic<u32> m_pending;
+    std::mutex m_mutex;                   // Guards the drop to zero and the continuations
+    Vector<Continuation> m_continuations; // Jobs scheduled once the count reaches zero
+};
+
+/**
+ * @class JobSystem
+ * @brief Worker threads running small jobs from per thread queues, idle workers steal from the busy ones.
+ *
+ * Every worker owns a queue it pushes to and pops from at the back, so a job spawning jobs keeps working on fresh,
+ * cache warm data, while other workers steal the oldest jobs from the front. The thread that created the system is
+ * the main thread. Its queue takes the jobs scheduled from outside the workers and it only runs jobs itself while
+ * waiting on a counter. Jobs that must run on the main thread, such as GLFW calls, go to a separate queue drained by
+ * RunMainThreadJobs once per frame. Exceptions escaping a job are logged, the job still counts as finished.
+ */
+class JobSystem {
+public:
+    using Job = std::function<void()>;
+    using RangeJob = std::function<void(u32 begin, u32 end)>;
+
+    /**
+     * @brief Starts the workers, the calling thread becomes the main thread.
+     * @param worker_count Threads besides the main thread, 0 runs every job on the main thread while it waits.
+     */
+    explicit JobSystem(u32 worker_count);
+    ~JobSystem();
+
+    JobSystem(const JobSystem &) = delete;
+    JobSystem &operator=(const JobSystem &) = delete;
+
+    /**
+     * @brief Queues a job to run on any thread.
+     * @param job Work to run.
+     * @param counter Counter the job is counted against while it is unfinished, may be null.
+     */
+    void Schedule(Job job, JobCounter *counter = nullptr);
+
+    /**
+     * @brief Queues a job once every job counted against a dependency finished.
+     * @param dependency Counter to wait for, the job is queued straight away if it is already done.
+     * @param job Work to run.
+     * @param counter Counter the job is counted against from now on, may be null.
+     */
+    void ScheduleAfter(JobCounter &dependency, Job job, JobCounter *counter = nullptr);
+
+    /**
+     * @brief Queues a job for the next RunMainThreadJobs.
+     * @param job Work to run.
+     * @param counter Counter the job is counted against while it is unfinished, may be null.
+     */
+    void ScheduleOnMainThread(Job job, JobCounter *counter = nullptr);
+
+    /**
+     * @brief Runs the jobs queued for the main thread, only has an effect on the main thread.
+     */
+    void RunMainThreadJobs();
+
+    /**
+     * @brief Runs queued jobs on the calling thread until every job counted against the counter finished.
+     */
+    void Wait(JobCounter &counter);
+
+    /**
+     * @brief Splits [0, count) into ranges of at most grain_size and runs them in parallel, returning once all
+     * finished. The range functor is shared by all ranges.
+     */
+    void ParallelFor(u32 count, u32 grain_size, const RangeJob &job);
+
+    [[nodiscard]] bool IsMainThread() const noexcept { return std::this_thread::get_id() == m_main_thread_id; }
+    [[nodiscard]] u32 GetWorkerCount() const noexcept { return static_cast<u32>(m_threads.size()); }
+
+private:
+    struct QueuedJob {
+        Job job;
+        JobCounter *counter;
+    };
+
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<QueuedJob> jobs;
+    };
+
+    void WorkerLoop(const std::stop_token &stop_token, u32 queue_index);
+    void Push(QueuedJob job);
+    [[nodiscard]] bool TryTake(QueuedJob &job);
+    void Execute(QueuedJob &job);
+    void Finish(JobCounter &counter);
+
+private:
+    std::thread::id m_main_thread_id;
+
+    Vector<std::unique_ptr<WorkQueue>> m_queues; // The main thread's first, then one per worker
+    std::atomic<u32> m_queued_jobs;              // Jobs in m_queues, written under m_sleep_mutex when growing
+    std::mutex m_sleep_mutex;
+    std::condition_variable_any m_wake_condition;
+
+    std::mutex m_main_thread_mutex;
+    Vector<QueuedJob> m_main_thread_jobs;
+
+    Vector<std::jthread> m_threads;
+};
+
+} // namespace gouda
@@ -0,0 +1,42 @@
+#pragma once
+/**
+ * @file utils/lz4.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine LZ4 block compression
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <cstddef>
+#include <span>
+
+#include "core/types.hpp"
+
+namespace gouda::utils {
+
+/**
+ * @brief Largest output lz4_compress can produce for an input of size bytes.
+ */
+[[nodiscard]] constexpr size_t lz4_compress_bound(const size_t size) noexcept { return size + size / 255 + 16; }
+
+/**
+ * @brief Compresses data into the LZ4 block format, readable by any LZ4 decoder.
+ *
+ * Greedy single pass matching, close to the reference implementation's fast mode. Decompression speed is what asset
+ * archives care about, and that does not depend on how hard the compressor tried.
+ *
+ * @return Bytes written to output, 0 if they do not fit.
+ */
+[[nodiscard]] size_t lz4_compress(std::span<const std::byte> data, std::span<std::byte> output);
+
+/**
+ * @brief Decompresses one LZ4 block, every read and write is bounds checked so corrupt input fails cleanly.
+ * @param output Exactly the decompressed size, which the block format does not store.
+ * @return False if data is not a valid block or does not decompress to exactly output.size() bytes.
+ */
+[[nodiscard]] bool lz4_decompress(std::span<const std::byte> data, std::span<std::byte> output);
+
+} // namespace gouda::utils
@@ -0,0 +1,69 @@
+#pragma once
+/**
+ * @file utils/mapped_file.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine read only memory mapped file
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include "core/types.hpp"
+#include "utils/filesystem.hpp"
+
+namespace gouda::fs {
+
+/**
+ * @class MappedFile
+ * @brief Read only view of a whole file, mapped into memory where the platform allows it.
+ *
+ * Pages are only read from disk when first touched, so opening a large file costs next to nothing and unused parts
+ * of it are never loaded. The data is at least 16 byte aligned, so SPIR-V and other u32 data can be read from it in
+ * place. Files are mapped with mmap or MapViewOfFile, elsewhere or when mapping fails they are read into a buffer
+ * instead, the view behaves the same either way. The contents are not null terminated.
+ *
+ * Paths found in a mounted AssetArchive open the archive's entry instead of the loose file, as a view into the
+ * archive's own mapping or, for compressed entries, a decompressed buffer.
+ */
+class MappedFile {
+public:
+    /**
+     * @brief Maps a file, from a mounted archive if one holds it.
+     * @param filepath Path to the file.
+     * @return The mapped file or an Error code.
+     */
+    [[nodiscard]] static Expect<MappedFile, Error> Open(StringView filepath);
+
+    MappedFile(MappedFile &&other) noexcept;
+    MappedFile &operator=(MappedFile &&other) noexcept;
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    ~MappedFile();
+
+    [[nodiscard]] std::span<const std::byte> GetData() const noexcept { return {p_data, m_size}; }
+    [[nodiscard]] StringView GetText() const noexcept { return {reinterpret_cast<const char *>(p_data), m_size}; }
+    [[nodiscard]] size_t GetSize() const noexcept { return m_size; }
+    [[nodiscard]] bool IsMapped() const noexcept { return m_buffer.empty() && p_data != nullptr; }
+
+private:
+    friend class AssetArchive;
+
+    MappedFile();
+    [[nodiscard]] static MappedFile FromView(std::span<const std::byte> data);
+    [[nodiscard]] static MappedFile FromBuffer(std::vector<std::byte> buffer);
+    void Release() noexcept;
+
+private:
+    const std::byte *p_data;
+    size_t m_size;
+    std::vector<std::byte> m_buffer; // Holds the contents when the file could not be mapped
+    bool m_is_view;                  // Points into memory someone else mapped, an archive's
+};
+
+} // namespace gouda::fs
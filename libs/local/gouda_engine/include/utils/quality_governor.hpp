@@ -0,0 +1,112 @@
+#pragma once
+/**
+ * @file utils/quality_governor.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine adaptive quality governor
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <array>
+
+#include "core/types.hpp"
+
+namespace gouda::utils {
+
+/**
+ * @struct QualitySettings
+ * @brief What the governor scales, as fractions of what the application asked for.
+ */
+struct QualitySettings {
+    f32 render_scale{1.0f};         // Of the render scale the user chose
+    f32 particle_spawn_scale{1.0f}; // Of the particle spawns uploaded each frame, the rest are dropped
+    f32 light_scale{1.0f};          // Of the lights drawn
+    u32 animation_interval{1};      // Fixed updates per CPU animation update, 1 animates every update
+
+    constexpr bool operator==(const QualitySettings &) const noexcept = default;
+};
+
+/**
+ * @class QualityGovernor
+ * @brief Steps quality down while frames run over their budget and back up while they have room to spare.
+ *
+ * The CPU and GPU times are governed apart, each along a ladder of levels from full quality down. A GPU bound frame
+ * lowers the render scale, particle spawns and lights, a CPU bound one how often animations update. Each axis keeps a
+ * rolling mean of its last WINDOW_SIZE frames and moves between levels with hysteresis: one level down once the mean
+ * has been over the budget for LOWER_FRAMES frames in a row, one level up once it has been under RAISE_THRESHOLD of the
+ * budget for the raise delay. The frames right after a change are ignored, the GPU timings arrive frames late and the
+ * change has to show in them before it is judged. A raise undone soon after doubles the raise delay of its axis, so
+ * a scene that sits on the edge of a level settles on the lower one instead of flipping between them.
+ */
+class QualityGovernor {
+public:
+    static constexpr size_t WINDOW_SIZE{30};
+    static constexpr f32 RAISE_THRESHOLD{0.75f};
+    static constexpr u32 LOWER_FRAMES{15};
+    static constexpr u32 RAISE_FRAMES{180};
+    static constexpr u32 MAX_RAISE_FRAMES{RAISE_FRAMES * 16};
+    static constexpr u32 SETTLE_FRAMES{30};
+
+    QualityGovernor();
+
+    /**
+     * @brief Milliseconds a frame may take on the CPU and on the GPU, one refresh period for a steady frame rate.
+     * Zero turns the governor off and restores full quality.
+     */
+    void SetFrameBudget(f32 budget);
+    [[nodiscard]] bool IsEnabled() const noexcept { return m_budget > 0.0f; }
+
+    /**
+     * @brief Feeds one frame's times in milliseconds.
+     * @param cpu_time Time the CPU spent on the frame, without waiting for the GPU, the swapchain or the pacer.
+     * @param gpu_time Zero while unknown, the GPU axis then holds its level.
+     * @return True if the settings changed.
+     */
+    bool AddFrame(f32 cpu_time, f32 gpu_time);
+
+    // Back to full quality, with the windows emptied
+    void Reset();
+
+    [[nodiscard]] const QualitySettings &GetSettings() const noexcept { return m_settings; }
+    [[nodiscard]] u32 GetGpuLevel() const noexcept { return m_gpu.level; }
+    [[nodiscard]] u32 GetCpuLevel() const noexcept { return m_cpu.level; }
+    [[nodiscard]] f32 GetGpuMean() const noexcept { return m_gpu.GetMean(); }
+    [[nodiscard]] f32 GetCpuMean() const noexcept { return m_cpu.GetMean(); }
+
+private:
+    struct Axis {
+        std::array<f32, WINDOW_SIZE> samples{};
+        f32 sum{0.0f};
+        size_t next_sample{0};
+        size_t sample_count{0};
+        u32 level{0};
+        u32 level_count{1};
+        u32 over_frames{0};
+        u32 under_frames{0};
+        u32 settle_frames{0};
+        u32 raise_frames{RAISE_FRAMES}; // Doubled by each raise undone within the raise delay
+        u32 frames_since_raise{0};
+        bool was_raised{false};
+
+        [[nodiscard]] f32 GetMean() const noexcept
+        {
+            return sample_count > 0 ? sum / static_cast<f32>(sample_count) : 0.0f;
+        }
+        void ClearWindow(); // The samples and the frame counts over and under the budget
+    };
+
+    // True if the axis changed level
+    bool UpdateAxis(Axis &axis, f32 sample) const;
+    void ApplyLevels();
+
+private:
+    f32 m_budget; // Milliseconds, 0 while off
+    Axis m_cpu;
+    Axis m_gpu;
+    QualitySettings m_settings;
+};
+
+} // namespace gouda::utils
@@ -0,0 +1,85 @@
+#pragma once
+/**
+ * @file utils/rect_packer.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine skyline rectangle packer
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <optional>
+
+#include "containers/small_vector.hpp"
+#include "core/types.hpp"
+
+namespace gouda {
+
+/**
+ * @struct PackedRect
+ * @brief Position of a packed rectangle, measured from the first row and column of the area.
+ */
+struct PackedRect {
+    int x;
+    int y;
+    int width;
+    int height;
+};
+
+/**
+ * @class RectPacker
+ * @brief Packs rectangles into a fixed area with the skyline bottom-left heuristic.
+ *
+ * The free space is tracked as a skyline, the top edge of everything placed so far, so an insert only walks the
+ * skyline segments. Each rectangle goes where its top edge ends lowest. Inserting in order of decreasing height
+ * gives the tightest packing.
+ */
+class RectPacker {
+public:
+    /**
+     * @brief Creates an empty packer.
+     * @param size Width and height of the area to pack into.
+     */
+    explicit RectPacker(ImageSize size);
+
+    /**
+     * @brief Places a rectangle.
+     * @param width Width of the rectangle.
+     * @param height Height of the rectangle.
+     * @return Where it was placed, or nothing if there is no room left for it.
+     */
+    [[nodiscard]] std::optional<PackedRect> Insert(int width, int height);
+
+    /**
+     * @brief Removes all rectangles.
+     */
+    void Reset();
+
+    [[nodiscard]] ImageSize GetSize() const noexcept { return m_size; }
+
+    /**
+     * @brief Returns the fraction of the area covered by rectangles.
+     */
+    [[nodiscard]] f32 GetOccupancy() const noexcept;
+
+private:
+    struct SkylineSegment {
+        int x;
+        int y; // Top edge of the space used below the segment
+        int width;
+    };
+
+    /**
+     * @brief Returns the lowest y a rectangle starting at a segment can be placed at, or -1 if it does not fit there.
+     */
+    [[nodiscard]] int FitAt(size_t segment_index, int width, int height) const;
+
+private:
+    ImageSize m_size;
+    Vector<SkylineSegment> m_skyline; // Sorted by x, covering the full width
+    s64 m_used_area;
+};
+
+} // namespace gouda
@@ -0,0 +1,92 @@
+#pragma once
+/**
+ * @file utils/startup_graph.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine startup task dependency graph
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <initializer_list>
+#include <mutex>
+
+#include "containers/small_vector.hpp"
+#include "core/types.hpp"
+
+namespace gouda {
+
+class JobSystem;
+
+/**
+ * @class StartupGraph
+ * @brief Runs a set of startup tasks once, each as soon as every task it depends on finished.
+ *
+ * Tasks that have to stay on the main thread, such as anything touching GLFW or the renderer, run on the thread
+ * calling Run in the order they become ready. The others run on the job system's workers alongside them. Tasks can
+ * only depend on tasks added before them, so the graph never has a cycle. Run logs the boot timeline, when each task
+ * ran and on which thread, with the longest chain of dependent tasks. That chain is as fast as startup can get
+ * however many threads there are.
+ */
+class StartupGraph {
+public:
+    using Task = std::function<void()>;
+    using TaskId = u32;
+
+    enum class TaskThread : u8 { Any, Main };
+
+    StartupGraph();
+
+    /**
+     * @brief Adds a task, to run once the tasks it depends on finished.
+     * @param name Name shown in the timeline.
+     * @param dependencies Tasks added earlier that have to finish first.
+     * @return Id to depend on the task by.
+     */
+    TaskId AddTask(StringView name, Task task, std::initializer_list<TaskId> dependencies = {},
+                   TaskThread thread = TaskThread::Any);
+
+    /**
+     * @brief Runs every task, returning once all finished. Must be called from the job system's main thread.
+     *
+     * A task that throws still counts as finished so the rest of the graph drains, the first exception thrown is
+     * rethrown once it has.
+     */
+    void Run(JobSystem &job_system);
+
+    [[nodiscard]] size_t GetTaskCount() const noexcept { return m_tasks.size(); }
+
+private:
+    struct TaskEntry {
+        String name;
+        Task task;
+        TaskThread thread;
+        SmallVector<TaskId, 4> dependencies;
+        SmallVector<TaskId, 4> dependants;
+        u32 pending_dependencies; // Counted down while the graph runs
+        FloatingPointMilliseconds start;
+        FloatingPointMilliseconds end;
+        bool ran_on_main_thread;
+    };
+
+    void Dispatch(JobSystem &job_system, TaskId id);
+    void Execute(JobSystem &job_system, TaskId id);
+    void LogTimeline() const;
+
+private:
+    Vector<TaskEntry> m_tasks;
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    Vector<TaskId> m_main_thread_ready; // Guarded by m_mutex, like everything the tasks count down
+    u32 m_remaining_tasks;
+    std::exception_ptr m_exception;
+    SteadyClock::time_point m_start_time;
+};
+
+} // namespace gouda
@@ -0,0 +1,76 @@
+#pragma once
+/**
+ * @file utils/string_id.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine hashed string identifiers
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <cstddef>
+
+#include "containers/flat_hash_map.hpp"
+#include "core/types.hpp"
+#include "utils/hash.hpp"
+
+namespace gouda {
+
+/**
+ * @class StringId
+ * @brief The 64 bit FNV-1a hash of a name, for sprites, animation clips and assets looked up on hot paths.
+ *
+ * A string literal converts implicitly and is hashed at compile time, so `GetSprite(atlas, "player.walk")` costs an
+ * integer compare. Names only known at run time, from files, are hashed with the explicit constructor, or with
+ * Register where the name should show up in logs. Declaring the ids a module uses as named constants turns a typo
+ * into a compile error rather than a failed lookup.
+ *
+ * Debug builds keep a table of registered names for GetName, release builds only have the hash.
+ */
+class StringId {
+public:
+    constexpr StringId() noexcept : m_hash{0} {}
+
+    template <size_t N>
+    consteval StringId(const char (&text)[N]) noexcept : m_hash{utils::fnv1a(StringView{text, N - 1})}
+    {
+    }
+
+    constexpr explicit StringId(const StringView text) noexcept : m_hash{utils::fnv1a(text)} {}
+
+    /**
+     * @brief Hashes a name at run time and, in debug builds, records it for GetName. Thread safe.
+     */
+    static StringId Register(StringView name);
+
+    [[nodiscard]] static constexpr StringId FromHash(const u64 hash) noexcept
+    {
+        StringId id;
+        id.m_hash = hash;
+        return id;
+    }
+
+    [[nodiscard]] constexpr u64 GetHash() const noexcept { return m_hash; }
+    [[nodiscard]] constexpr bool IsValid() const noexcept { return m_hash != 0; }
+
+    /**
+     * @brief Returns the registered name, empty in release builds or when the name was never registered.
+     */
+    [[nodiscard]] StringView GetName() const;
+
+    constexpr bool operator==(const StringId &) const noexcept = default;
+
+private:
+    u64 m_hash; // 0 for none, the hash of the empty string is the FNV offset basis
+};
+
+template <>
+struct FlatHash<StringId> {
+    using is_avalanching = void;
+
+    [[nodiscard]] size_t operator()(const StringId id) const noexcept { return utils::mix64(id.GetHash()); }
+};
+
+} // namespace gouda
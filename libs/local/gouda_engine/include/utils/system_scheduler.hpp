@@ -0,0 +1,89 @@
+#pragma once
+/**
+ * @file utils/system_scheduler.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine parallel system update scheduler
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <functional>
+
+#include "containers/small_vector.hpp"
+#include "core/types.hpp"
+
+namespace gouda {
+
+class WorkerPool;
+
+/// Bit set of the resources a system touches, each bit is a resource the caller defines
+using SystemResources = u64;
+
+/**
+ * @class SystemScheduler
+ * @brief Runs per tick update systems in parallel wherever their declared resource accesses allow it.
+ *
+ * Systems run in the order they were added unless two of them do not conflict, a conflict being one writing a
+ * resource the other reads or writes. Each system lands in the earliest stage after every earlier system it conflicts
+ * with, and the systems of a stage run together on the worker pool. The stages are worked out again only when a
+ * system is added, so a tick costs one pool batch per stage.
+ *
+ * A system may run every few ticks instead of every one, such as AI at 20 Hz beside physics at 60 Hz, and is then
+ * given the time of the ticks since it last ran. Systems of the same interval are staggered by the order they were
+ * added in, so they do not all land on the same tick.
+ */
+class SystemScheduler {
+public:
+    using System = std::function<void(f32 delta_time)>;
+
+    /**
+     * @brief Creates an empty scheduler.
+     * @param worker_pool Pool the stages run on, it must outlive the scheduler.
+     */
+    explicit SystemScheduler(WorkerPool *worker_pool);
+
+    /**
+     * @brief Adds a system after the existing ones.
+     * @param name Name shown when the stages are logged.
+     * @param reads Resources the system only reads.
+     * @param writes Resources the system writes, these are also considered read.
+     * @param system Update function, called with the tick delta time.
+     * @param interval Ticks per run, 1 runs it every tick. The delta time is then summed over the ticks.
+     */
+    void AddSystem(StringView name, SystemResources reads, SystemResources writes, System system, u32 interval = 1);
+
+    /**
+     * @brief Runs every system once, returning when all of them finished.
+     */
+    void Run(f32 delta_time);
+
+    [[nodiscard]] size_t GetSystemCount() const noexcept { return m_systems.size(); }
+    [[nodiscard]] size_t GetStageCount();
+
+private:
+    struct SystemEntry {
+        String name;
+        SystemResources reads;
+        SystemResources writes;
+        System system;
+        u32 interval;
+        u32 elapsed_ticks;      // Since the system last ran
+        f32 elapsed_delta_time; // Summed over those ticks
+        bool is_due;            // Runs this tick
+    };
+
+    void BuildStages();
+
+private:
+    WorkerPool *p_worker_pool;
+
+    Vector<SystemEntry> m_systems;
+    Vector<u32> m_stage_systems; // System indices grouped by stage, in stage order
+    Vector<u32> m_stage_ends;    // End of each stage in m_stage_systems
+    bool m_stages_dirty;
+};
+
+} // namespace gouda
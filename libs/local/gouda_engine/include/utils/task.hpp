@@ -0,0 +1,419 @@
+#pragma once
+/**
+ * @file utils/task.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine coroutine tasks running on the job system
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "containers/small_vector.hpp"
+#include "core/types.hpp"
+#include "debug/logger.hpp"
+#include "utils/async_file_reader.hpp"
+#include "utils/job_system.hpp"
+
+namespace gouda {
+
+template <typename T = void>
+class Task;
+
+namespace internal {
+
+struct TaskPromiseBase {
+    // Hands the thread over to the awaiting coroutine, so long co_await chains do not grow the stack
+    struct FinalAwaiter {
+        [[nodiscard]] bool await_ready() const noexcept { return false; }
+
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(const std::coroutine_handle<Promise> handle) const noexcept
+        {
+            const std::coroutine_handle<> continuation{handle.promise().continuation};
+            return continuation ? continuation : std::noop_coroutine();
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+    [[nodiscard]] std::suspend_always initial_suspend() const noexcept { return {}; }
+    [[nodiscard]] FinalAwaiter final_suspend() const noexcept { return {}; }
+    void unhandled_exception() noexcept { exception = std::current_exception(); }
+
+    void RethrowIfFailed() const
+    {
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+    }
+
+    std::coroutine_handle<> continuation;
+    std::exception_ptr exception;
+};
+
+template <typename T>
+struct TaskPromise : TaskPromiseBase {
+    Task<T> get_return_object() noexcept;
+
+    template <typename U>
+    void return_value(U &&value)
+    {
+        result.emplace(std::forward<U>(value));
+    }
+
+    T TakeResult()
+    {
+        RethrowIfFailed();
+        return std::move(*result);
+    }
+
+    std::optional<T> result;
+};
+
+template <>
+struct TaskPromise<void> : TaskPromiseBase {
+    Task<void> get_return_object() noexcept;
+    void return_void() const noexcept {}
+    void TakeResult() const { RethrowIfFailed(); }
+};
+
+// Starts on creation and frees its own frame on completion, nothing may escape it
+struct DetachedTask {
+    struct promise_type {
+        [[nodiscard]] DetachedTask get_return_object() const noexcept { return {}; }
+        [[nodiscard]] std::suspend_never initial_suspend() const noexcept { return {}; }
+        [[nodiscard]] std::suspend_never final_suspend() const noexcept { return {}; }
+        void return_void() const noexcept {}
+        void unhandled_exception() const noexcept { std::terminate(); }
+    };
+};
+
+} // namespace internal
+
+/**
+ * @class Task
+ * @brief A coroutine producing a T, or an exception, to the coroutine awaiting it.
+ *
+ * Tasks are lazy: the body starts when the task is first awaited, on the awaiting thread, and the awaiting coroutine
+ * resumes on whichever thread the task finished on. The awaitables below move a coroutine between threads, so that
+ * a loader reads on the I/O service, decodes on a worker and only resumes on the main thread for GPU work:
+ *
+ *     Task<u32> LoadLevel(JobSystem &jobs, TextureManager &textures, Vector<String> paths)
+ *     {
+ *         Vector<Task<u32>> loads;
+ *         for (String &path : paths) {
+ *             loads.push_back(textures.LoadTextureAsync(jobs, std::move(path)));
+ *         }
+ *         const Vector<u32> texture_ids{co_await WhenAll(jobs, std::move(loads))};
+ *         co_await SwitchToMainThread(jobs);
+ *         ...
+ *     }
+ *
+ * A task is awaited once, destroying one that has not finished destroys its frame without running the rest of it.
+ * The root of a chain is handed to StartDetached. Coroutine parameters are copied into the frame, so tasks take
+ * String rather than StringView and whatever they point to has to outlive them.
+ */
+template <typename T>
+class [[nodiscard]] Task {
+public:
+    using promise_type = internal::TaskPromise<T>;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    Task() noexcept : m_handle{nullptr} {}
+    explicit Task(const Handle handle) noexcept : m_handle{handle} {}
+
+    Task(Task &&other) noexcept : m_handle{std::exchange(other.m_handle, nullptr)} {}
+    Task &operator=(Task &&other) noexcept
+    {
+        if (this != &other) {
+            Destroy();
+            m_handle = std::exchange(other.m_handle, nullptr);
+        }
+        return *this;
+    }
+
+    Task(const Task &) = delete;
+    Task &operator=(const Task &) = delete;
+
+    ~Task() { Destroy(); }
+
+    [[nodiscard]] bool IsValid() const noexcept { return m_handle != nullptr; }
+    [[nodiscard]] bool IsDone() const noexcept { return m_handle && m_handle.done(); }
+
+    auto operator co_await() noexcept
+    {
+        struct Awaiter {
+            Handle handle;
+
+            [[nodiscard]] bool await_ready() const noexcept { return !handle || handle.done(); }
+
+            std::coroutine_handle<> await_suspend(const std::coroutine_handle<> awaiting) const noexcept
+            {
+                handle.promise().continuation = awaiting;
+                return handle;
+            }
+
+            T await_resume() const { return handle.promise().TakeResult(); }
+        };
+        return Awaiter{m_handle};
+    }
+
+private:
+    void Destroy() noexcept
+    {
+        if (m_handle) {
+            m_handle.destroy();
+            m_handle = nullptr;
+        }
+    }
+
+private:
+    Handle m_handle;
+};
+
+template <typename T>
+Task<T> internal::TaskPromise<T>::get_return_object() noexcept
+{
+    return Task<T>{std::coroutine_handle<TaskPromise>::from_promise(*this)};
+}
+
+inline Task<void> internal::TaskPromise<void>::get_return_object() noexcept
+{
+    return Task<void>{std::coroutine_handle<TaskPromise>::from_promise(*this)};
+}
+
+namespace internal {
+
+inline DetachedTask RunDetached(Task<void> task)
+{
+    try {
+        co_await task;
+    }
+    catch (const std::exception &error) {
+        ENGINE_LOG_ERROR("Detached task failed: {}", error.what());
+    }
+    catch (...) {
+        ENGINE_LOG_ERROR("Detached task failed with an unknown exception.");
+    }
+}
+
+} // namespace internal
+
+/**
+ * @brief Starts a task on the calling thread without anything awaiting it. Its frame is freed once it finishes,
+ * exceptions escaping it are logged like those of jobs.
+ */
+inline void StartDetached(Task<void> task) { internal::RunDetached(std::move(task)); }
+
+/**
+ * @brief Resumes the awaiting coroutine as a job on any thread. Without workers it keeps running where it is, since
+ * their jobs would only run while the main thread waits.
+ */
+[[nodiscard]] inline auto SwitchToWorker(JobSystem &job_system) noexcept
+{
+    struct Awaiter {
+        JobSystem *p_job_system;
+
+        [[nodiscard]] bool await_ready() const noexcept { return p_job_system->GetWorkerCount() == 0; }
+        void await_suspend(const std::coroutine_handle<> handle) const
+        {
+            p_job_system->Schedule([handle] { handle.resume(); });
+        }
+        void await_resume() const noexcept {}
+    };
+    return Awaiter{&job_system};
+}
+
+/**
+ * @brief Resumes the awaiting coroutine in the next RunMainThreadJobs, or straight away when already on the main
+ * thread.
+ */
+[[nodiscard]] inline auto SwitchToMainThread(JobSystem &job_system) noexcept
+{
+    struct Awaiter {
+        JobSystem *p_job_system;
+
+        [[nodiscard]] bool await_ready() const noexcept { return p_job_system->IsMainThread(); }
+        void await_suspend(const std::coroutine_handle<> handle) const
+        {
+            p_job_system->ScheduleOnMainThread([handle] { handle.resume(); });
+        }
+        void await_resume() const noexcept {}
+    };
+    return Awaiter{&job_system};
+}
+
+/**
+ * @brief Resumes the awaiting coroutine on the main thread one frame later, for polling work the main thread
+ * finishes once per frame.
+ */
+[[nodiscard]] inline auto NextFrame(JobSystem &job_system) noexcept
+{
+    struct Awaiter {
+        JobSystem *p_job_system;
+
+        [[nodiscard]] bool await_ready() const noexcept { return false; }
+        void await_suspend(const std::coroutine_handle<> handle) const
+        {
+            p_job_system->ScheduleOnMainThread([handle] { handle.resume(); });
+        }
+        void await_resume() const noexcept {}
+    };
+    return Awaiter{&job_system};
+}
+
+/**
+ * @brief Reads a whole file through the reader and resumes as a job once it is done, without workers on the main
+ * thread, rather than on the reader's own thread.
+ */
+[[nodiscard]] inline auto ReadFileAsync(fs::AsyncFileReader &reader, JobSystem &job_system, String filepath)
+{
+    class Awaiter {
+    public:
+        Awaiter(fs::AsyncFileReader &file_reader, JobSystem &jobs, String path)
+            : p_reader{&file_reader}, p_job_system{&jobs}, m_filepath{std::move(path)}
+        {
+        }
+
+        [[nodiscard]] bool await_ready() const noexcept { return false; }
+
+        // Nothing of the awaiter is touched after Read, the coroutine may already run on another thread by then
+        void await_suspend(const std::coroutine_handle<> handle)
+        {
+            p_reader->Read(m_filepath, [this, handle](fs::AsyncReadResult result) {
+                m_result.emplace(std::move(result));
+                if (p_job_system->GetWorkerCount() == 0) {
+                    p_job_system->ScheduleOnMainThread([handle] { handle.resume(); });
+                }
+                else {
+                    p_job_system->Schedule([handle] { handle.resume(); });
+                }
+            });
+        }
+
+        fs::AsyncReadResult await_resume() { return std::move(*m_result); }
+
+    private:
+        fs::AsyncFileReader *p_reader;
+        JobSystem *p_job_system;
+        String m_filepath;
+        std::optional<fs::AsyncReadResult> m_result;
+    };
+    return Awaiter{reader, job_system, std::move(filepath)};
+}
+
+namespace internal {
+
+// Resumes the awaiting coroutine once every child counted down, whoever comes last, the awaiting one included
+class WhenAllLatch {
+public:
+    explicit WhenAllLatch(const u32 count) : m_remaining{count + 1} {}
+
+    [[nodiscard]] bool await_ready() const noexcept { return m_remaining.load(std::memory_order_acquire) == 1; }
+    bool await_suspend(const std::coroutine_handle<> handle) noexcept
+    {
+        m_continuation = handle;
+        return m_remaining.fetch_sub(1, std::memory_order_acq_rel) > 1;
+    }
+    void await_resume() const noexcept {}
+
+    void CountDown() noexcept
+    {
+        if (m_remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            m_continuation.resume();
+        }
+    }
+
+private:
+    std::atomic<u32> m_remaining;
+    std::coroutine_handle<> m_continuation;
+};
+
+template <typename T>
+DetachedTask RunWhenAllChild(JobSystem &job_system, Task<T> &task, std::optional<T> &result, std::exception_ptr &error,
+                             WhenAllLatch &latch)
+{
+    try {
+        co_await SwitchToWorker(job_system);
+        result.emplace(co_await task);
+    }
+    catch (...) {
+        error = std::current_exception();
+    }
+    latch.CountDown();
+}
+
+inline DetachedTask RunWhenAllChild(JobSystem &job_system, Task<void> &task, std::exception_ptr &error,
+                                    WhenAllLatch &latch)
+{
+    try {
+        co_await SwitchToWorker(job_system);
+        co_await task;
+    }
+    catch (...) {
+        error = std::current_exception();
+    }
+    latch.CountDown();
+}
+
+} // namespace internal
+
+/**
+ * @brief Starts every task as its own job and resumes once all of them finished, on the thread of the last one.
+ * @return The results in the order of the tasks. The first exception among them is rethrown after all finished.
+ */
+template <typename T>
+Task<Vector<T>> WhenAll(JobSystem &job_system, Vector<Task<T>> tasks)
+{
+    Vector<std::optional<T>> results(tasks.size());
+    Vector<std::exception_ptr> errors(tasks.size());
+    internal::WhenAllLatch latch{static_cast<u32>(tasks.size())};
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        internal::RunWhenAllChild(job_system, tasks[i], results[i], errors[i], latch);
+    }
+    co_await latch;
+
+    for (const std::exception_ptr &error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    Vector<T> values;
+    values.reserve(results.size());
+    for (std::optional<T> &result : results) {
+        values.push_back(std::move(*result));
+    }
+    co_return values;
+}
+
+/**
+ * @brief Starts every task as its own job and resumes once all of them finished, on the thread of the last one.
+ * The first exception among them is rethrown after all finished.
+ */
+inline Task<void> WhenAll(JobSystem &job_system, Vector<Task<void>> tasks)
+{
+    Vector<std::exception_ptr> errors(tasks.size());
+    internal::WhenAllLatch latch{static_cast<u32>(tasks.size())};
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        internal::RunWhenAllChild(job_system, tasks[i], errors[i], latch);
+    }
+    co_await latch;
+
+    for (const std::exception_ptr &error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+} // namespace gouda
@@ -0,0 +1,83 @@
+#pragma once
+/**
+ * @file utils/thread.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine named threads with priority classes and core affinity
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <array>
+#include <stop_token>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "core/types.hpp"
+
+namespace gouda {
+
+/**
+ * @brief What a thread does, from the most to the least urgent. Each class maps to an OS priority and to the cores
+ * ThreadSettings lets it run on.
+ */
+enum class ThreadPriority : u8 {
+    Render,  ///< The main thread and the renderer's workers, which the frame waits on
+    Audio,   ///< Refills streams and mixes, a late wake is an audible gap
+    Jobs,    ///< Job system workers
+    IO,      ///< File reads and watching
+    Logging, ///< Log and profiler writers, which only have to keep up on average
+};
+
+inline constexpr size_t THREAD_PRIORITY_COUNT{static_cast<size_t>(ThreadPriority::Logging) + 1};
+
+struct ThreadSettings {
+    static constexpr u32 RESERVED_CORE_MAX_CORES{4};
+
+    std::array<u64, THREAD_PRIORITY_COUNT> affinity_masks{}; ///< Bit per core each class may run on, 0 for any core.
+    bool reserve_main_core{true}; ///< On RESERVED_CORE_MAX_CORES cores or fewer, pins the main thread to the first core
+                                  ///< and keeps the jobs, IO and logging classes off it unless their mask says so.
+};
+
+/**
+ * @brief Replaces the settings and applies their affinities to every thread already set up, on the main thread.
+ */
+void SetThreadSettings(const ThreadSettings &settings);
+[[nodiscard]] ThreadSettings GetThreadSettings();
+
+/**
+ * @brief Sets up the calling thread as the main thread, of the Render class and the one reserve_main_core is for.
+ */
+void SetMainThread(StringView name = "Main");
+
+/**
+ * @brief Names the calling thread for debuggers, OS tools and the profiler's trace, and gives it its class's priority
+ * and cores. The thread stays registered until it exits, so later settings reach it. Platforms that refuse a
+ * priority or affinity leave the thread as it was, raising a priority usually needs privileges on Linux.
+ * @param name Shown truncated to 15 characters where the OS limits it.
+ */
+void SetCurrentThread(StringView name, ThreadPriority priority);
+
+/**
+ * @brief Starts a thread that calls SetCurrentThread before anything else.
+ * @param function Called with the thread's stop token if it takes one.
+ */
+template <typename Function>
+[[nodiscard]] std::jthread MakeThread(String name, const ThreadPriority priority, Function &&function)
+{
+    return std::jthread{[name = std::move(name), priority, function = std::forward<Function>(function)](
+                            const std::stop_token &stop_token) mutable {
+        SetCurrentThread(name, priority);
+        if constexpr (std::is_invocable_v<std::decay_t<Function> &, const std::stop_token &>) {
+            function(stop_token);
+        }
+        else {
+            function();
+        }
+    }};
+}
+
+} // namespace gouda
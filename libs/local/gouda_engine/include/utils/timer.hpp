@@ -19,7 +19,10 @@
  * You should have received a copy of the GNU Affero General Public License
  * along with this program. If not, see <https://www.gnu.org/licenses/>.
  */
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <cstdint>
 #include <iostream>
 #include <thread>
 
@@ -27,6 +30,7 @@ namespace gouda {
 namespace utils {
 
 using SteadyClock = std::chrono::steady_clock;
+using u32 = uint32_t;
 using f32 = float;
 using f64 = double;
 
@@ -68,12 +72,26 @@ private:
     f32 delta_time;
 };
 
+/**
+ * @enum CatchUpPolicy
+ * @brief What FixedTimer does with the time left over once a frame has run all the updates it may.
+ */
+enum class CatchUpPolicy : uint8_t {
+    Drop,       ///< Dropped, the simulation runs slower for that frame and then keeps up with the clock again
+    SlowMotion, ///< Kept and simulated over the next frames, the simulation runs slower until it has caught up
+};
+
 /**
  * @class FixedTimer
  * @brief Ensures fixed timestep updates for physics simulations.
  *
  * Fixed timesteps prevent instability and make physics simulations consistent across different frame rates.
  *
+ * A long frame leaves more time to simulate, and every update run to catch up makes the next frame longer still. So a
+ * frame runs at most the max steps, and no more once its updates have taken the step budget, what they leave over is
+ * handled by the catch up policy. The first update of a frame always runs, the simulation never stops. The time
+ * carried over is capped at the max debt either way, anything past it is dropped.
+ *
  * @example
  * @code
  * FixedTimer physicsTimer(1.0f / 60.0f);
@@ -84,33 +102,123 @@ private:
  *         PhysicsUpdate(1.0f / 60.0f);
  *         physicsTimer.Advance();
  *     }
+ *     RenderScene(physicsTimer.GetInterpolationFactor()); // Blends the last two physics states
  * }
  * @endcode
  */
 class FixedTimer {
 public:
-    explicit FixedTimer(f32 timestep) : fixed_timestep(timestep), accumulator(0.0f) {}
+    static constexpr u32 DEFAULT_MAX_STEPS{5};
+    static constexpr f32 DEFAULT_MAX_DEBT{0.25f}; // Seconds
+    static constexpr f32 STEP_COST_SMOOTHING{0.1f};
 
-    /// Adds the delta time to the accumulator.
+    explicit FixedTimer(f32 timestep, u32 steps = DEFAULT_MAX_STEPS,
+                        CatchUpPolicy catch_up_policy = CatchUpPolicy::Drop)
+        : fixed_timestep(timestep), accumulator(0.0f), max_steps(std::max(steps, 1u)), policy(catch_up_policy),
+          max_debt(DEFAULT_MAX_DEBT), step_budget(0.0f), frame_steps(0), step_count(0), dropped_time(0.0f),
+          step_cost(0.0f), last_step_cost(0.0f), frame_start(SteadyClock::now()), step_start(frame_start)
+    {
+    }
+
+    /// Sets the most updates a frame may run, at least one.
+    void SetMaxStepsPerFrame(u32 steps) { max_steps = std::max(steps, 1u); }
+
+    /// Sets what happens to the time a frame could not simulate.
+    void SetCatchUpPolicy(CatchUpPolicy catch_up_policy) { policy = catch_up_policy; }
+
+    /// Sets the most time in seconds carried from frame to frame.
+    void SetMaxDebt(f32 seconds) { max_debt = std::max(seconds, fixed_timestep); }
+
+    /// Sets the seconds the updates of a frame may take, an update that would run past it waits. 0 leaves the cap.
+    void SetStepBudget(f32 seconds) { step_budget = std::max(seconds, 0.0f); }
+
+    /// Adds the delta time to the accumulator and starts the frame's updates.
     void UpdateAccumulator(f32 delta_time)
     {
         accumulator += delta_time;
-        if (accumulator > 0.25f)
-            accumulator = 0.25f; // Prevents physics explosions
+        if (accumulator > max_debt) {
+            dropped_time += accumulator - max_debt;
+            accumulator = max_debt; // Prevents physics explosions
+        }
+
+        frame_steps = 0;
+        frame_start = SteadyClock::now();
+        step_start = frame_start;
+    }
+
+    /// Checks if enough time has accumulated for another update this frame. Once the frame may run no more, a Drop
+    /// policy drops what it could not simulate, leaving the part of an update the render interpolates.
+    bool ShouldUpdate()
+    {
+        if (accumulator < fixed_timestep) {
+            return false;
+        }
+
+        const bool is_over_budget{step_budget > 0.0f && frame_steps > 0 &&
+                                  std::chrono::duration<f32>(SteadyClock::now() - frame_start).count() + step_cost >
+                                      step_budget};
+        if (frame_steps < max_steps && !is_over_budget) {
+            return true;
+        }
+
+        if (policy == CatchUpPolicy::Drop) {
+            const f32 kept{std::fmod(accumulator, fixed_timestep)};
+            dropped_time += accumulator - kept;
+            accumulator = kept;
+        }
+        return false;
     }
 
-    /// Checks if enough time has accumulated for a physics update.
-    bool ShouldUpdate() const { return accumulator >= fixed_timestep; }
+    /// Advances the accumulator after a physics update, timing the update.
+    void Advance()
+    {
+        accumulator -= fixed_timestep;
+        ++frame_steps;
+        ++step_count;
 
-    /// Advances the accumulator after a physics update.
-    void Advance() { accumulator -= fixed_timestep; }
+        const SteadyClock::time_point now{SteadyClock::now()};
+        last_step_cost = std::chrono::duration<f32>(now - step_start).count();
+        step_cost = step_count == 1 ? last_step_cost : step_cost + (last_step_cost - step_cost) * STEP_COST_SMOOTHING;
+        step_start = now;
+    }
 
     /// Returns the fixed time step value.
     f32 GetFixedTimeStep() const { return fixed_timestep; }
 
+    /// Returns the time accumulated but not yet simulated, how far the simulation lags behind.
+    f32 GetAccumulator() const { return accumulator; }
+
+    /// Returns how far between the last two updates the frame falls (between 0 and 1), for interpolating the render.
+    /// While a SlowMotion policy carries debt the frame is drawn at the last update.
+    f32 GetInterpolationFactor() const { return std::min(accumulator / fixed_timestep, 1.0f); }
+
+    /// Returns the updates run this frame.
+    u32 GetFrameSteps() const { return frame_steps; }
+
+    /// Returns the updates run since the timer was created.
+    uint64_t GetStepCount() const { return step_count; }
+
+    /// Returns the seconds of time dropped since the timer was created, never simulated.
+    f32 GetDroppedTime() const { return dropped_time; }
+
+    /// Returns the smoothed and the last wall time in seconds an update took.
+    f32 GetStepCost() const { return step_cost; }
+    f32 GetLastStepCost() const { return last_step_cost; }
+
 private:
     f32 fixed_timestep;
     f32 accumulator;
+    u32 max_steps;
+    CatchUpPolicy policy;
+    f32 max_debt;
+    f32 step_budget; // 0 while unbounded
+    u32 frame_steps;
+    uint64_t step_count;
+    f32 dropped_time;
+    f32 step_cost; // Exponential mean
+    f32 last_step_cost;
+    SteadyClock::time_point frame_start; // Of the frame's updates
+    SteadyClock::time_point step_start;  // Of the update being run
 };
 
 /**
@@ -220,37 +328,5 @@ private:
     bool paused;
 };
 
-/**
- * @class InterpolationTimer
- * @brief Computes interpolation factor for smooth rendering.
- *
- * Allows interpolation between physics updates for smoother visual representation.
- *
- * @example
- * @code
- * InterpolationTimer interp(1.0f / 60.0f);
- * while (running) {
- *     float deltaTime = frameTimer.GetDeltaTime();
- *     interp.Update(deltaTime);
- *     float alpha = interp.GetInterpolationFactor();
- *     RenderScene(alpha);
- * }
- * @endcode
- */
-class InterpolationTimer {
-public:
-    explicit InterpolationTimer(f32 timestep) : fixed_timestep(timestep), accumulator(0.0f) {}
-
-    /// Adds the delta time to the accumulator.
-    void Update(f32 delta_time) { accumulator += delta_time; }
-
-    /// Returns the interpolation factor (between 0 and 1).
-    f32 GetInterpolationFactor() const { return accumulator / fixed_timestep; }
-
-private:
-    f32 fixed_timestep;
-    f32 accumulator;
-};
-
 } // namespace utils end
 } // namespace gouda end
\ No newline at end of file
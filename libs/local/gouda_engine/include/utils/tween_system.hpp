@@ -0,0 +1,103 @@
+#pragma once
+/**
+ * @file utils/tween_system.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine batched tweens
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <array>
+#include <optional>
+
+#include "containers/slot_map.hpp"
+#include "containers/small_vector.hpp"
+#include "core/types.hpp"
+#include "math/easing.hpp"
+
+namespace gouda {
+
+using TweenHandle = SlotHandle;
+
+/**
+ * @class TweenSystem
+ * @brief Eases values from one number to another over time, every active tween in one pass per frame.
+ *
+ * Tweens are stored as columns, one set per easing type, so Update runs a loop per type that reads and writes packed
+ * floats and calls its easing function directly, which the compiler inlines and vectorises for the polynomial
+ * easings. Each result is then written to the tween's target, if it has one, where UI and camera code read it like
+ * any other member. A finished tween writes its end value and is removed. Handles stay valid until then, a stale one
+ * is ignored by every call. Not thread safe.
+ */
+class TweenSystem {
+public:
+    TweenSystem();
+
+    /**
+     * @param target Written with the value after every Update, may be null to read it with GetValue instead. Must
+     * outlive the tween, owners remove their tweens before they are destroyed.
+     * @param duration Seconds, a duration of 0 or less jumps to the end value on the next Update.
+     */
+    TweenHandle Add(f32 from, f32 to, f32 duration, math::easing::EasingType easing, f32 *target = nullptr);
+
+    /**
+     * @brief Stops a tween where it is, its target keeps the last value written.
+     * @return False if the handle was stale.
+     */
+    bool Remove(TweenHandle handle);
+
+    /**
+     * @brief Advances every tween and writes their targets.
+     */
+    void Update(f32 delta_time);
+
+    void Clear();
+
+    [[nodiscard]] bool IsActive(const TweenHandle handle) const noexcept
+    {
+        return handle.index < m_slots.size() && m_slots[handle.index].generation == handle.generation &&
+               m_slots[handle.index].group != NO_GROUP;
+    }
+
+    /**
+     * @return The value written by the last Update, empty once the tween finished or was removed.
+     */
+    [[nodiscard]] std::optional<f32> GetValue(TweenHandle handle) const;
+
+    [[nodiscard]] size_t GetActiveCount() const noexcept { return m_active_count; }
+    [[nodiscard]] bool IsEmpty() const noexcept { return m_active_count == 0; }
+
+private:
+    static constexpr size_t EASING_TYPE_COUNT{static_cast<size_t>(math::easing::EasingType::EaseOutBounce) + 1};
+    static constexpr u8 NO_GROUP{constants::u8_max};
+
+    // The tweens of one easing type, value is lerp(from, to, ease(elapsed * inverse_duration)), exactly to at the end
+    struct TweenGroup {
+        Vector<f32> elapsed;
+        Vector<f32> inverse_duration;
+        Vector<f32> from;
+        Vector<f32> to;
+        Vector<f32> value;
+        Vector<f32 *> targets;
+        Vector<u32> slots; // Of each tween, to find its handle when another is swapped into its place
+    };
+
+    struct Slot {
+        u32 generation;
+        u32 dense_index; // Into the group's columns, or the next free slot while free
+        u8 group;        // NO_GROUP while free
+    };
+
+    void RemoveAt(u8 group, u32 dense_index);
+
+private:
+    std::array<TweenGroup, EASING_TYPE_COUNT> m_groups;
+    Vector<Slot> m_slots;
+    u32 m_free_head;
+    size_t m_active_count;
+};
+
+} // namespace gouda
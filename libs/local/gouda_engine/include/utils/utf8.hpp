@@ -0,0 +1,85 @@
+#pragma once
+/**
+ * @file utils/utf8.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine UTF-8 decoding utilities
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include "core/types.hpp"
+
+namespace gouda::utils {
+
+constexpr u32 UTF8_REPLACEMENT_CHARACTER{0xFFFD};
+
+/**
+ * @brief Decodes the UTF-8 sequence starting at offset and advances offset past it.
+ *
+ * Invalid, overlong, surrogate or truncated sequences decode to U+FFFD and consume a single byte, so decoding always
+ * makes progress and resynchronizes on the next lead byte.
+ *
+ * @param offset Byte offset into text, must be less than text.size().
+ */
+[[nodiscard]] constexpr u32 decode_utf8(const StringView text, size_t &offset) noexcept
+{
+    const auto byte_at = [text](const size_t index) {
+        return static_cast<u32>(static_cast<unsigned char>(text[index]));
+    };
+
+    const u32 lead{byte_at(offset)};
+    if (lead < 0x80) {
+        ++offset;
+        return lead;
+    }
+
+    size_t length{0};
+    u32 codepoint{0};
+    u32 min_codepoint{0};
+    if ((lead & 0xE0) == 0xC0) {
+        length = 2;
+        codepoint = lead & 0x1F;
+        min_codepoint = 0x80;
+    }
+    else if ((lead & 0xF0) == 0xE0) {
+        length = 3;
+        codepoint = lead & 0x0F;
+        min_codepoint = 0x800;
+    }
+    else if ((lead & 0xF8) == 0xF0) {
+        length = 4;
+        codepoint = lead & 0x07;
+        min_codepoint = 0x10000;
+    }
+    else {
+        ++offset;
+        return UTF8_REPLACEMENT_CHARACTER;
+    }
+
+    if (length > text.size() - offset) {
+        ++offset;
+        return UTF8_REPLACEMENT_CHARACTER;
+    }
+
+    for (size_t i = 1; i < length; ++i) {
+        const u32 continuation{byte_at(offset + i)};
+        if ((continuation & 0xC0) != 0x80) {
+            ++offset;
+            return UTF8_REPLACEMENT_CHARACTER;
+        }
+        codepoint = (codepoint << 6) | (continuation & 0x3F);
+    }
+
+    if (codepoint < min_codepoint || codepoint > 0x10FFFF || (codepoint >= 0xD800 && codepoint <= 0xDFFF)) {
+        ++offset;
+        return UTF8_REPLACEMENT_CHARACTER;
+    }
+
+    offset += length;
+    return codepoint;
+}
+
+} // namespace gouda::utils
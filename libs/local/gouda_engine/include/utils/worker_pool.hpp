@@ -0,0 +1,79 @@
+#pragma once
+/**
+ * @file utils/worker_pool.hpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine fixed size worker thread pool
+ * @copyright
+ * Copyright (c) 2025 GoudaCheeseburgers <https://github.com/Cheeseborgers>
+ *
+ * This file is part of the Gouda engine and licensed under the GNU Affero General Public License v3.0 or later.
+ * See <https://www.gnu.org/licenses/> for more information.
+ */
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "containers/small_vector.hpp"
+#include "core/types.hpp"
+#include "utils/thread.hpp"
+
+namespace gouda {
+
+/**
+ * @class WorkerPool
+ * @brief Persistent threads that run a batch of indexed tasks and block the caller until all of them finished.
+ *
+ * The calling thread takes part in every batch, so a pool created with a thread count of one runs everything
+ * inline. Each task index is handed out exactly once per batch, which lets callers key per-task resources that need
+ * external synchronization (command pools, scratch buffers) by task index instead of by thread. An exception thrown
+ * by a task is rethrown from Run once the whole batch finished, the remaining tasks still run.
+ */
+class WorkerPool {
+public:
+    using Task = std::function<void(u32 task_index)>;
+
+    /**
+     * @brief Starts the workers.
+     * @param thread_count Threads taking part in a batch, including the caller. Clamped to at least one.
+     * @param name Of the workers, numbered from one.
+     */
+    explicit WorkerPool(u32 thread_count, StringView name = "Worker", ThreadPriority priority = ThreadPriority::Jobs);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool &) = delete;
+    WorkerPool &operator=(const WorkerPool &) = delete;
+    WorkerPool(WorkerPool &&) = delete;
+    WorkerPool &operator=(WorkerPool &&) = delete;
+
+    /**
+     * @brief Runs task for every index in [0, task_count) and returns once all of them finished.
+     */
+    void Run(u32 task_count, const Task &task);
+
+    [[nodiscard]] u32 GetThreadCount() const noexcept { return static_cast<u32>(m_threads.size()) + 1; }
+
+private:
+    void WorkerLoop(const std::stop_token &stop_token);
+    void RunTasks();
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable_any m_start_condition;
+    std::condition_variable m_done_condition;
+
+    // Current batch, only written by Run while no worker is inside RunTasks
+    const Task *p_task;
+    u32 m_task_count;
+    u64 m_generation;
+    u32 m_active_workers;
+    std::atomic<u32> m_next_task;
+    std::exception_ptr m_exception; // First exception thrown by a task of the current batch
+
+    Vector<std::jthread> m_threads;
+};
+
+} // namespace gouda
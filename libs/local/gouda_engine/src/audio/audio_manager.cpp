@@ -1,6 +1,8 @@
 #include "audio/audio_manager.hpp"
 
 #include <algorithm> // for std::shuffle
+#include <cmath>
+#include <numbers>
 #include <stdexcept>
 #include <utility> // for std::exchange
 
@@ -8,6 +10,7 @@
 
 #include "debug/debug.hpp"
 #include "math/random.hpp"
+#include "utils/thread.hpp"
 
 namespace gouda::audio {
 
@@ -16,29 +19,39 @@ AudioManager::AudioManager()
       p_context{nullptr},
       m_music_source{0},
       p_current_track{nullptr},
+      m_frames_per_buffer{0},
       m_master_sound_volume{1.0f},
       m_master_music_volume{1.0f},
       m_music_looping{false},
       m_queue_looping{false},
       m_effects_loaded{false},
-      m_effects_pointers_loaded{false}
+      m_effects_pointers_loaded{false},
+      m_max_effect_sends{0},
+      m_wake_requested{false}
 {
     // Default constructor initializes to "unloaded" state
 }
 
 AudioManager::~AudioManager()
 {
+    // Joined first, everything below uses state the audio thread owns
+    if (m_audio_thread.joinable()) {
+        m_audio_thread.request_stop();
+        m_wake_condition.notify_all();
+        m_audio_thread.join();
+    }
+
     // Stop and delete sound effect sources
-    for (ALuint source : m_active_sources) {
-        alSourceStop(source);
-        alDeleteSources(1, &source);
+    for (const Voice &voice : m_voices.GetVoices()) {
+        alSourceStop(voice.source);
+        alDeleteSources(1, &voice.source);
     }
-    for (ALuint source : m_source_pool) {
+    for (ALuint source : m_voices.GetFreeSources()) {
         alDeleteSources(1, &source);
     }
 
     // Stop and delete music resources
-    StopMusic();
+    StopMusicStream();
 
     DestroyAudioEffects();
 
@@ -54,7 +67,8 @@ AudioManager::~AudioManager()
     ENGINE_LOG_DEBUG("Audio manager destroyed");
 }
 
-void AudioManager::Initialize(const f32 sound_volume, const f32 music_volume)
+void AudioManager::Initialize(const f32 sound_volume, const f32 music_volume,
+                              const MusicStreamSettings &stream_settings, const VoiceSettings &voice_settings)
 {
     p_device = alcOpenDevice(nullptr); // Default device
     if (!p_device) {
@@ -70,6 +84,7 @@ void AudioManager::Initialize(const f32 sound_volume, const f32 music_volume)
         ENGINE_THROW("Failed to create or set audio context");
     }
 
+    m_voices.SetSettings(voice_settings);
     InitializeSources();
 
     if (!alcIsExtensionPresent(alcGetContextsDevice(alcGetCurrentContext()), "ALC_EXT_EFX")) {
@@ -88,330 +103,185 @@ void AudioManager::Initialize(const f32 sound_volume, const f32 music_volume)
         }
     }
 
-    SetMasterSoundVolume(sound_volume);
-    SetMasterMusicVolume(music_volume);
-
-    ENGINE_LOG_DEBUG("Audio manager initialized");
-}
+    // Queried once, sounds only bind the sends of their chain
+    if (m_effects_loaded) {
+        ALCint max_sends{0};
+        alcGetIntegerv(p_device, ALC_MAX_AUXILIARY_SENDS, 1, &max_sends);
+        m_max_effect_sends = std::min(static_cast<size_t>(std::max(max_sends, 0)), MAX_EFFECT_CHAIN_LENGTH);
+        if (m_max_effect_sends == 0) {
+            ENGINE_LOG_WARNING("No auxiliary sends supported; effects will not be applied");
+        }
 
-void AudioManager::PlaySoundEffect(const SoundEffect &sound, const Vector<AudioEffectType> &effects,
-                                   const f32 volume, const f32 pitch)
-{
-    ALuint buffer{sound.GetBuffer()};
-    if (!alIsBuffer(buffer)) {
-        ENGINE_LOG_ERROR("Invalid buffer ID {}", buffer);
-        return;
-    }
+        // Each slot runs its effect from initialization until nothing has used it for a while
+        const auto now{std::chrono::steady_clock::now()};
+        for (EffectSlotState &slot : m_effect_slots) {
+            slot.idle_since = now;
+        }
 
-    ALuint source{GetFreeSource()};
-    if (source == 0) {
-        ENGINE_LOG_WARNING("No sources available to play sound effect");
-        return;
+        // One low pass filter for every occluded source, a source copies the filter's values when it is bound
+        if (alGenFilters && alDeleteFilters && alFilteri && alFilterf) {
+            alGenFilters(1, &m_occlusion_filter);
+            alFilteri(m_occlusion_filter, AL_FILTER_TYPE, AL_FILTER_LOWPASS);
+            if (const ALenum result{alGetError()}; result != AL_NO_ERROR) {
+                ENGINE_LOG_WARNING("Failed to create occlusion filter; occlusion will not be applied: {}",
+                                   alGetString(result));
+                alDeleteFilters(1, &m_occlusion_filter);
+                m_occlusion_filter = 0;
+            }
+        }
     }
 
-    const f32 effective_volume{volume * m_master_sound_volume};
-
-    ENGINE_LOG_DEBUG("Attaching buffer {} to source {}", buffer, source);
-    alSourcei(source, AL_BUFFER, static_cast<ALint>(buffer));
-    alSourcef(source, AL_GAIN, effective_volume);
-    alSourcef(source, AL_PITCH, pitch);
-    alSource3f(source, AL_POSITION, 0.0f, 0.0f, 0.0f); // Center
-    alSourcei(source, AL_LOOPING, AL_FALSE);           // One-shot
+    SetMasterSoundVolume(sound_volume);
+    SetMasterMusicVolume(music_volume);
 
-    if (!effects.empty()) {
-        ApplyAudioEffects(source, effects);
-        ENGINE_LOG_DEBUG("EFFECTS APPLIED");
+    m_stream_settings = stream_settings;
+    if (m_stream_settings.buffer_count < 2 || !(m_stream_settings.target_latency > 0.0f) ||
+        m_stream_settings.prefetch_time < 0.0f || m_stream_settings.crossfade_time < 0.0f) {
+        ENGINE_LOG_WARNING("Invalid music stream settings ({} buffers, {}s), using the defaults",
+                           m_stream_settings.buffer_count, m_stream_settings.target_latency);
+        m_stream_settings = MusicStreamSettings{};
     }
 
-    alSourcePlay(source);
-    if (const ALenum result{alGetError()}; result != AL_NO_ERROR) {
-        ENGINE_LOG_ERROR("Failed to play sound effect: {}", alGetString(result));
-        alDeleteSources(1, &source);
-        return;
-    }
+    m_audio_thread = MakeThread("Audio", ThreadPriority::Audio,
+                                [this](const std::stop_token &stop_token) { AudioLoop(stop_token); });
 
-    ALint state{0};
-    alGetSourcei(source, AL_SOURCE_STATE, &state);
-    ENGINE_LOG_DEBUG("Source {} state: {}", source, state == AL_PLAYING ? "PLAYING" : "NOT PLAYING");
-    m_active_sources.push_back(source);
+    ENGINE_LOG_DEBUG("Audio manager initialized");
 }
 
-void AudioManager::PlaySoundEffectAt(const SoundEffect &sound, const Vec3 &position,
-                                     const Vector<AudioEffectType> &effects, const f32 volume, const f32 pitch,
-                                     const bool loop)
+void AudioManager::PlaySoundEffect(const SoundEffect &sound, const Vector<AudioEffectType> &effects,
+                                   const f32 volume, const f32 pitch, const u8 priority)
 {
-    const ALuint source{GetFreeSource()};
-    if (source == 0)
-        return;
-
-    ALuint buffer{sound.GetBuffer()};
-    if (!alIsBuffer(buffer)) {
-        ENGINE_LOG_ERROR("Invalid buffer ID {}", buffer);
-        return;
-    }
-
-    const f32 effective_volume{volume * m_master_sound_volume};
-    alSourcei(source, AL_BUFFER, static_cast<ALint>(buffer));
-    alSourcef(source, AL_GAIN, effective_volume);
-    alSourcef(source, AL_PITCH, pitch);
-    alSource3f(source, AL_POSITION, position.x, position.y, position.z);
-    alSourcei(source, AL_LOOPING, loop ? AL_TRUE : AL_FALSE);
-
-    if (!effects.empty()) {
-        ApplyAudioEffects(source, effects);
-    }
-
-    alSourcePlay(source);
-    if (const ALenum result{alGetError()}; result != AL_NO_ERROR) {
-        ENGINE_LOG_ERROR("Failed to play sound effect: {}", alGetString(result));
-        alDeleteSources(1, &source);
-        return;
-    }
-    m_active_sources.push_back(source);
+    PlayChainedSoundEffect(sound, EffectChain{std::span{effects.data(), effects.size()}}, volume, pitch, priority);
 }
 
-void AudioManager::QueueMusic(MusicTrack &track, const bool play_immediately)
+void AudioManager::PlayChainedSoundEffect(const SoundEffect &sound, const EffectChain chain, const f32 volume,
+                                          const f32 pitch, const u8 priority)
 {
-    m_music_tracks.push_back(&track);
-    ENGINE_LOG_DEBUG("Queued music track");
-    if (play_immediately && !p_current_track) {
-        PlayNextTrack();
-    }
+    PushSoundCommand({.buffer = sound.GetBuffer(),
+                      .volume = volume,
+                      .pitch = pitch,
+                      .effect_chain = chain,
+                      .throttle = sound.GetThrottle(),
+                      .priority = priority});
 }
 
-void AudioManager::PlayMusic(const bool shuffle)
+void AudioManager::PlaySoundEffectAt(const SoundEffect &sound, const Vec3 &position,
+                                     const Vector<AudioEffectType> &effects, const f32 volume, const f32 pitch,
+                                     const bool loop, const u8 priority)
 {
-    if (!p_current_track && !m_music_tracks.empty()) {
-        if (shuffle) {
-            ShuffleTracks();
-        }
-
-        PlayNextTrack();
-    }
+    PlayChainedSoundEffectAt(sound, position, EffectChain{std::span{effects.data(), effects.size()}}, volume, pitch,
+                             loop, priority);
 }
 
-void AudioManager::PauseMusic()
+void AudioManager::PlayChainedSoundEffectAt(const SoundEffect &sound, const Vec3 &position, const EffectChain chain,
+                                            const f32 volume, const f32 pitch, const bool loop, const u8 priority)
 {
-    if (m_music_source) {
-        alSourcePause(m_music_source);
-        if (const ALenum result{alGetError()}; result != AL_NO_ERROR) {
-            ENGINE_LOG_ERROR("Failed to pause music: {}", alGetString(result));
-        }
-        else {
-            ENGINE_LOG_DEBUG("Paused music on source {}", m_music_source);
-        }
-    }
+    PushSoundCommand({.buffer = sound.GetBuffer(),
+                      .position = position,
+                      .volume = volume,
+                      .pitch = pitch,
+                      .effect_chain = chain,
+                      .throttle = sound.GetThrottle(),
+                      .priority = priority,
+                      .is_positional = true,
+                      .loop = loop});
 }
 
-void AudioManager::ResumeMusic()
+void AudioManager::RetainEffectChain(const EffectChain chain)
 {
-    if (m_music_source) {
-        alSourcePlay(m_music_source);
-        if (const ALenum result{alGetError()}; result != AL_NO_ERROR) {
-            ENGINE_LOG_ERROR("Failed to resume music: {}", alGetString(result));
-        }
-        else {
-            ENGINE_LOG_DEBUG("Resumed music on source {}", m_music_source);
-        }
-    }
+    PushSoundCommand({.type = SoundCommandType::RetainEffectChain, .effect_chain = chain});
 }
 
-void AudioManager::StopMusic()
+void AudioManager::ReleaseEffectChain(const EffectChain chain)
 {
-    if (m_music_source) {
-        StopCurrentTrack();
-    }
-
-    p_current_track = nullptr;
-    m_music_looping = false;
-    m_music_tracks.clear();
-    m_current_index = 0;
-
-    ENGINE_LOG_DEBUG("Stopped music and cleared queue");
+    PushSoundCommand({.type = SoundCommandType::ReleaseEffectChain, .effect_chain = chain});
 }
 
-void AudioManager::StopCurrentTrack()
+void AudioManager::QueueMusic(MusicTrack &track, const bool play_immediately)
 {
-    if (m_music_source) {
-
-        ALuint source_to_log{m_music_source};
-        alSourceStop(m_music_source);
-
-        ALenum result{alGetError()};
-        if (result != AL_NO_ERROR) {
-            ENGINE_LOG_ERROR("Failed to stop music source {}: {}", source_to_log, alGetString(result));
-        }
-        alDeleteSources(1, &m_music_source);
-        result = alGetError();
-        if (result != AL_NO_ERROR) {
-            ENGINE_LOG_ERROR("Failed to delete music source {}: {}", source_to_log, alGetString(result));
-        }
-        m_music_source = 0;
-        for (ALuint buffer : m_music_buffers) {
-            alDeleteBuffers(1, &buffer);
-            result = alGetError();
-            if (result != AL_NO_ERROR) {
-                ENGINE_LOG_ERROR("Failed to delete buffer {}: {}", buffer, alGetString(result));
-            }
-        }
-        m_music_buffers.clear();
-        ENGINE_LOG_DEBUG("Stopped current track on source {}", source_to_log);
-    }
+    PushMusicCommand({MusicCommandType::Queue, &track, 0.0f, play_immediately});
 }
 
-void AudioManager::ShuffleTracks()
-{
-    if (m_current_index < m_music_tracks.size()) {
-        std::shuffle(m_music_tracks.begin() + m_current_index, m_music_tracks.end(), math::GetGlobalRNG());
-    }
+void AudioManager::PlayMusic(const bool shuffle) { PushMusicCommand({MusicCommandType::Play, nullptr, 0.0f, shuffle}); }
 
-    ENGINE_LOG_DEBUG("Shuffled music queue with {} tracks", m_music_tracks.size());
-}
+void AudioManager::PauseMusic() { PushMusicCommand({MusicCommandType::Pause}); }
 
-void AudioManager::Update()
-{
-    // Clean up sound m_effects
-    for (auto it = m_active_sources.begin(); it != m_active_sources.end();) {
-        ALint state;
-        alGetSourcei(*it, AL_SOURCE_STATE, &state);
-        if (state != AL_PLAYING) {
-            m_source_pool.push_back(*it);
-            ENGINE_LOG_DEBUG("Returned source {} to pool", *it);
-            it = m_active_sources.erase(it);
-        }
-        else {
-            ++it;
-        }
-    }
+void AudioManager::ResumeMusic() { PushMusicCommand({MusicCommandType::Resume}); }
 
-    // Stream music
-    if (m_music_source && p_current_track) {
-        ALint processed{0};
-        alGetSourcei(m_music_source, AL_BUFFERS_PROCESSED, &processed);
-        while (processed--) {
-            ALuint buffer{0};
-            alSourceUnqueueBuffers(m_music_source, 1, &buffer);
-            if (const ALenum result{alGetError()}; result != AL_NO_ERROR) {
-                ENGINE_LOG_ERROR("alSourceUnqueueBuffers failed: {}", alGetString(result));
-                continue;
-            }
+void AudioManager::StopMusic() { PushMusicCommand({MusicCommandType::Stop}); }
 
-            Vector<f32> temp(FRAMES_PER_BUFFER * p_current_track->GetChannels());
-            if (size_t frames_read{p_current_track->ReadFrames(temp.data(), FRAMES_PER_BUFFER)}; frames_read > 0) {
-                alBufferData(buffer, p_current_track->GetFormat(), temp.data(),
-                             static_cast<ALsizei>(frames_read * p_current_track->GetChannels() * sizeof(f32)),
-                             p_current_track->GetSampleRate());
-                alSourceQueueBuffers(m_music_source, 1, &buffer);
-            }
-            else if (p_current_track->IsFinished()) {
-
-                if (m_music_looping) {
-                    sf_seek(p_current_track->GetFile(), 0, SEEK_SET); // Reset to start
-                    p_current_track->SetFinished(false);
-                    frames_read = p_current_track->ReadFrames(temp.data(), FRAMES_PER_BUFFER);
-                    if (frames_read > 0) {
-                        alBufferData(buffer, p_current_track->GetFormat(), temp.data(),
-                                     static_cast<ALsizei>(frames_read * p_current_track->GetChannels() * sizeof(f32)),
-                                     p_current_track->GetSampleRate());
-                        alSourceQueueBuffers(m_music_source, 1, &buffer);
-                    }
-                }
-                else {
-                    ENGINE_LOG_DEBUG("Music track finished");
-                    PlayNextTrack();
-                    break;
-                }
-            }
-        }
+void AudioManager::StopCurrentTrack() { PushMusicCommand({MusicCommandType::StopCurrentTrack}); }
 
-        ALint state{0};
-        alGetSourcei(m_music_source, AL_SOURCE_STATE, &state);
-        if (state != AL_PLAYING && !m_music_buffers.empty()) {
-            alSourcePlay(m_music_source);
-            ENGINE_LOG_DEBUG("Restarted music playback");
-        }
-    }
-}
+void AudioManager::ShuffleTracks() { PushMusicCommand({MusicCommandType::Shuffle}); }
 
-void AudioManager::SetMusicPitch(f32 pitch)
-{
-    if (m_music_source) {
-        alSourcef(m_music_source, AL_PITCH, pitch);
-        if (const ALenum result{alGetError()}; result != AL_NO_ERROR) {
-            ENGINE_LOG_ERROR("Failed to set music pitch: {}", alGetString(result));
-        }
-        else {
-            ENGINE_LOG_DEBUG("Set music pitch to {} for source {}", pitch, m_music_source);
-        }
-    }
-    else {
-        ENGINE_LOG_WARNING("No music source active to set pitch");
-    }
-}
+void AudioManager::Update() { WakeAudioThread(); }
+
+void AudioManager::SetMusicPitch(const f32 pitch) { PushMusicCommand({MusicCommandType::SetPitch, nullptr, pitch}); }
 
 static f32 ClampVolume(const f32 volume) { return std::clamp(volume, 0.0f, 1.0f); }
 
 void AudioManager::SetMasterSoundVolume(const f32 volume)
 {
-    m_master_sound_volume = ClampVolume(volume);
+    PushSoundCommand({.type = SoundCommandType::SetVolume, .volume = volume});
+}
 
-    for (const ALuint source : m_active_sources) {
-        ALint buffer{0};
-        alGetSourcei(source, AL_BUFFER, &buffer);
-        f32 current_volume{0.0f};
-        alGetSourcef(source, AL_GAIN, &current_volume);
-        alSourcef(source, AL_GAIN, current_volume * m_master_sound_volume);
-    }
+void AudioManager::SetMasterMusicVolume(const f32 volume)
+{
+    PushMusicCommand({MusicCommandType::SetVolume, nullptr, volume});
+}
 
-    ENGINE_LOG_DEBUG("Set master sound volume to {}", m_master_sound_volume);
+void AudioManager::SetMusicLooping(const bool loop)
+{
+    PushMusicCommand({MusicCommandType::SetLooping, nullptr, 0.0f, loop});
 }
 
-void AudioManager::SetMasterMusicVolume(f32 volume)
+void AudioManager::SetQueueLooping(const bool loop)
 {
-    m_master_music_volume = ClampVolume(volume);
-    if (m_music_source) {
-        f32 current_volume{0.0f};
-        alGetSourcef(m_music_source, AL_GAIN, &current_volume);
-        alSourcef(m_music_source, AL_GAIN, current_volume * volume);
-    }
+    PushMusicCommand({MusicCommandType::SetQueueLooping, nullptr, 0.0f, loop});
+}
 
-    ENGINE_LOG_DEBUG("Set master music volume to {} (volume): {}", m_master_music_volume, volume);
+void AudioManager::SetMusicCrossfade(const f32 seconds)
+{
+    PushMusicCommand({MusicCommandType::SetCrossfade, nullptr, seconds});
 }
 
-void AudioManager::SetMusicLooping(const bool loop)
+void AudioManager::SetListenerPosition(const Vec3 &position)
 {
-    m_music_looping = loop; // Update state even if no source active
-    if (m_music_source) {
-        alSourcei(m_music_source, AL_LOOPING, loop ? AL_TRUE : AL_FALSE);
-        if (const ALenum result{alGetError()}; result != AL_NO_ERROR) {
-            ENGINE_LOG_ERROR("Failed to set music looping: {}", alGetString(result));
-        }
-        else {
-            ENGINE_LOG_DEBUG("Set music looping to {}", loop ? "true" : "false");
-        }
-    }
+    PushSoundCommand({.type = SoundCommandType::SetListenerPosition, .position = position});
 }
 
-void AudioManager::SetQueueLooping(bool loop)
+void AudioManager::SetListenerVelocity(const Vec3 &velocity)
 {
-    m_queue_looping = loop;
-    ENGINE_LOG_DEBUG("Set queue looping to {}", loop ? "true" : "false");
+    PushSoundCommand({.type = SoundCommandType::SetListenerVelocity, .position = velocity});
 }
 
-void AudioManager::SetListenerPosition(const Vec3 &position)
+bool AudioManager::TakeOcclusionQueries(Vector<OcclusionQuery> &queries, Vec3 &listener)
 {
-    alListener3f(AL_POSITION, position.x, position.y, position.z);
-    if (const ALenum result{alGetError()}; result != AL_NO_ERROR) {
-        ENGINE_LOG_ERROR("Failed to set listener position: {}", alGetString(result));
+    std::lock_guard lock{m_occlusion_mutex};
+    if (m_occlusion_queries_taken.load(std::memory_order_relaxed)) {
+        return false;
     }
+
+    // Swapped, the audio thread clears whatever the caller's vector held before it posts into it
+    std::swap(queries, m_occlusion_queries);
+    listener = m_occlusion_listener;
+    m_occlusion_queries_taken.store(true, std::memory_order_relaxed);
+    return true;
 }
 
-void AudioManager::SetListenerVelocity(const Vec3 &velocity)
+void AudioManager::SubmitOcclusionResults(const std::span<const OcclusionResult> results)
 {
-    alListener3f(AL_VELOCITY, velocity.x, velocity.y, velocity.z);
-    if (const ALenum result{alGetError()}; result != AL_NO_ERROR) {
-        ENGINE_LOG_ERROR("Failed to set listener velocity: {}", alGetString(result));
+    if (results.empty()) {
+        return;
+    }
+
+    {
+        std::lock_guard lock{m_occlusion_mutex};
+        for (const OcclusionResult &result : results) {
+            m_occlusion_results.push_back(result);
+        }
     }
+    m_occlusion_results_ready.store(true, std::memory_order_release);
 }
 
 // Private functions --------------------------------------------------------------------------
@@ -429,6 +299,10 @@ void AudioManager::LoadAudioEffectFunctions()
     LOAD_PROC(LPALAUXILIARYEFFECTSLOTF, alAuxiliaryEffectSlotf); // Ensure this is loaded
     LOAD_PROC(LPALGETAUXILIARYEFFECTSLOTI, alGetAuxiliaryEffectSloti);
     LOAD_PROC(LPALGETAUXILIARYEFFECTSLOTF, alGetAuxiliaryEffectSlotf);
+    LOAD_PROC(LPALGENFILTERS, alGenFilters);
+    LOAD_PROC(LPALDELETEFILTERS, alDeleteFilters);
+    LOAD_PROC(LPALFILTERI, alFilteri);
+    LOAD_PROC(LPALFILTERF, alFilterf);
 
     ENGINE_LOG_DEBUG("Effects functions loaded");
 
@@ -485,12 +359,9 @@ void AudioManager::InitializeSources()
             temp_sources.push_back(source);
             detected_max_sources++;
         }
-        // Transfer successful sources to pool
-        m_source_pool = std::move(temp_sources);
-        for (ALuint source : m_source_pool) {
+        for (ALuint source : temp_sources) {
             alDeleteSources(1, &source); // Clean up temporary sources
         }
-        m_source_pool.clear();
     }
     else {
         detected_max_sources = max_mono_sources;
@@ -504,14 +375,13 @@ void AudioManager::InitializeSources()
     ENGINE_LOG_DEBUG("Audio device supports up to {} sources; setting pool size to {}", detected_max_sources,
                      initial_pool_size);
 
-    // Allocate the pool
-    m_source_pool.reserve(initial_pool_size);
+    // Allocate the pool, its size is the voice limit
     int sources_created{0};
     for (int i = 0; i < initial_pool_size; ++i) {
         ALuint source;
         alGenSources(1, &source);
         if (alGetError() == AL_NO_ERROR) {
-            m_source_pool.push_back(source);
+            m_voices.AddSource(source);
             sources_created++;
         }
         else {
@@ -875,89 +745,14 @@ void AudioManager::DestroyAudioEffects()
     CleanupEffect(m_effects.chorus.effect_id, m_effects.chorus.slot_id, "chorus");
     CleanupEffect(m_effects.flanger.effect_id, m_effects.flanger.slot_id, "flanger");
 
-    m_effects_loaded = false;
-
-    ENGINE_LOG_DEBUG("Audio effects destroyed");
-}
-
-void AudioManager::ApplyAudioEffects(ALuint source, const Vector<AudioEffectType> &effects)
-{
-
-    if (source == 0) {
-        ENGINE_LOG_ERROR("Could not apply audio effects. Invalid source provided");
-        return;
-    }
-
-    if (!m_effects_pointers_loaded) {
-        ENGINE_LOG_ERROR("Could not apply audio effects. Audio effects pointers not loaded");
-        return;
-    }
-
-    if (!m_effects_loaded) {
-        ENGINE_LOG_ERROR("Could not apply audio effects. No audio effects are loaded");
-        return;
-    }
-
-    ALenum result{alGetError()}; // Clear any prior errors
-    ALCint max_sends{0};
-    alcGetIntegerv(p_device, ALC_MAX_AUXILIARY_SENDS, 1, &max_sends);
-    ENGINE_LOG_DEBUG("Max auxiliary sends supported: {}", max_sends);
-    if (max_sends <= 0) {
-        ENGINE_LOG_WARNING("No auxiliary sends supported; effects will not be applied");
-        return;
-    }
-
-    size_t num_effects{std::min(effects.size(), static_cast<size_t>(max_sends))};
-    ENGINE_LOG_DEBUG("Applying {} effects to source {}", num_effects, source);
-    for (size_t i = 0; i < num_effects; ++i) {
-
-        AudioEffectType effect_type{effects[i]};
-        ALuint slot_id{m_effects[effect_type].slot_id};
-        ALuint effect_id{m_effects[effect_type].effect_id};
-
-        ENGINE_LOG_DEBUG("Effect {}: slot_id={}, effect_id={}", static_cast<int>(effect_type), slot_id, effect_id);
-
-        if (slot_id == 0 || effect_id == 0) {
-            ENGINE_LOG_WARNING("Effect {} not initialized (slot_id={}, effect_id={}); skipping",
-                               static_cast<int>(effect_type), slot_id, effect_id);
-            continue;
-        }
-
-        // Check slot state
-        ALint slot_gain{0};
-        alGetAuxiliaryEffectSloti(slot_id, AL_EFFECTSLOT_GAIN, &slot_gain);
-        ENGINE_LOG_DEBUG("Slot {} gain: {}", slot_id, slot_gain);
-
-        alSource3i(source, AL_AUXILIARY_SEND_FILTER, static_cast<ALint>(slot_id), static_cast<ALint>(i), AL_FILTER_NULL);
-        result = alGetError();
-        if (result != AL_NO_ERROR) {
-            ENGINE_LOG_ERROR("Failed to attach effect {} to source {} on send {}: {}", static_cast<int>(effect_type),
-                             source, i, alGetString(result));
-        }
-        else {
-            ENGINE_LOG_DEBUG("Attached effect {} (slot {}) to source {} on send {}", static_cast<int>(effect_type),
-                             slot_id, source, i);
-        }
+    if (m_occlusion_filter != 0 && alDeleteFilters) {
+        alDeleteFilters(1, &m_occlusion_filter);
+        m_occlusion_filter = 0;
     }
-}
 
-ALuint AudioManager::GetFreeSource()
-{
-    if (!m_source_pool.empty()) {
-        ALuint source{m_source_pool.back()};
-        m_source_pool.pop_back();
-        ENGINE_LOG_DEBUG("Reusing source {}", source);
-        return source;
-    }
+    m_effects_loaded = false;
 
-    ALuint source{0};
-    alGenSources(1, &source);
-    if (alGetError() != AL_NO_ERROR) {
-        ENGINE_LOG_ERROR("No free sources available");
-        return 0;
-    }
-    ENGINE_LOG_DEBUG("Created new source {}", source);
-    return source;
+    ENGINE_LOG_DEBUG("Audio effects destroyed");
 }
 
 void AudioManager::PlayNextTrack()
@@ -968,18 +763,27 @@ void AudioManager::PlayNextTrack()
         }
         else {
             ENGINE_LOG_DEBUG("No more tracks to play");
-            StopMusic();
+            StopMusicStream();
             return;
         }
     }
 
     if (m_music_source) {
-        StopCurrentTrack(); // Stop and clean up the current track
+        ReleaseMusicSource(); // Stop and clean up the current track
     }
 
     p_current_track = m_music_tracks[m_current_index];
     m_current_index++;
 
+    // A prefetched start is the track's decoder output so far, anything else may have been played or prefetched before
+    if (m_prefetch.p_track != p_current_track) {
+        ResetPrefetch();
+        if (!p_current_track->Rewind()) {
+            StopMusicStream();
+            return;
+        }
+    }
+
     alGenSources(1, &m_music_source);
     ALenum result{alGetError()};
     if (result != AL_NO_ERROR) {
@@ -988,8 +792,15 @@ void AudioManager::PlayNextTrack()
         return;
     }
 
-    m_music_buffers.resize(NUM_STREAM_BUFFERS);
-    alGenBuffers(NUM_STREAM_BUFFERS, m_music_buffers.data());
+    // Sized once per track, so streaming it reuses the same buffers and scratch throughout
+    const auto channels{static_cast<size_t>(p_current_track->GetChannels())};
+    const f32 frames_per_buffer{m_stream_settings.target_latency * static_cast<f32>(p_current_track->GetSampleRate()) /
+                                static_cast<f32>(m_stream_settings.buffer_count)};
+    m_frames_per_buffer = std::max(MIN_FRAMES_PER_BUFFER, static_cast<size_t>(frames_per_buffer));
+    m_decode_buffer.resize(m_frames_per_buffer * channels);
+
+    m_music_buffers.resize(m_stream_settings.buffer_count);
+    alGenBuffers(static_cast<ALsizei>(m_stream_settings.buffer_count), m_music_buffers.data());
     result = alGetError();
     if (result != AL_NO_ERROR) {
         ENGINE_LOG_ERROR("Failed to create music buffers: {}", alGetString(result));
@@ -998,25 +809,22 @@ void AudioManager::PlayNextTrack()
         return;
     }
 
-    Vector<f32> temp(FRAMES_PER_BUFFER * p_current_track->GetChannels());
     int buffers_queued{0};
     for (ALuint buffer : m_music_buffers) {
-        size_t frames_read{p_current_track->ReadFrames(temp.data(), FRAMES_PER_BUFFER)};
+        const size_t frames_read{FillMusicBuffer(buffer)};
         ENGINE_LOG_DEBUG("Read {} frames for buffer {}", frames_read, buffer);
         if (frames_read > 0) {
-            alBufferData(buffer, p_current_track->GetFormat(), temp.data(),
-                         static_cast<ALsizei>(frames_read * p_current_track->GetChannels() * sizeof(f32)), p_current_track->GetSampleRate());
             result = alGetError();
             if (result != AL_NO_ERROR) {
                 ENGINE_LOG_ERROR("alBufferData failed: {}", alGetString(result));
-                StopMusic();
+                StopMusicStream();
                 return;
             }
             alSourceQueueBuffers(m_music_source, 1, &buffer);
             result = alGetError();
             if (result != AL_NO_ERROR) {
                 ENGINE_LOG_ERROR("alSourceQueueBuffers failed: {}", alGetString(result));
-                StopMusic();
+                StopMusicStream();
                 return;
             }
             buffers_queued++;
@@ -1025,21 +833,880 @@ void AudioManager::PlayNextTrack()
 
     if (buffers_queued == 0) {
         ENGINE_LOG_ERROR("No buffers queued; cannot play music");
-        StopMusic();
+        StopMusicStream();
         return;
     }
 
     alSourcef(m_music_source, AL_GAIN, m_master_music_volume);
-    alSourcei(m_music_source, AL_LOOPING, m_music_looping ? AL_TRUE : AL_FALSE);
     alSourcePlay(m_music_source);
     result = alGetError();
     if (result != AL_NO_ERROR) {
         ENGINE_LOG_ERROR("Failed to start music playback: {}", alGetString(result));
-        StopMusic();
+        StopMusicStream();
     }
     else {
         ENGINE_LOG_DEBUG("Started music playback on source {} with {} buffers", m_music_source, buffers_queued);
     }
 }
 
+
+void AudioManager::PushMusicCommand(const MusicCommand &command)
+{
+    if (!m_music_commands.TryPush(command)) {
+        ENGINE_LOG_WARNING("Music command queue is full, dropping command {}", static_cast<int>(command.type));
+        return;
+    }
+
+    WakeAudioThread();
+}
+
+void AudioManager::PushSoundCommand(const SoundCommand &command)
+{
+    if (command.type == SoundCommandType::Play && command.buffer == 0) {
+        return; // Not loaded, or a sound bank is still decoding it, the sound is skipped rather than waited for
+    }
+
+    if (!m_sound_commands.TryPush(command)) {
+        ENGINE_LOG_WARNING("Sound command queue is full, dropping sound");
+    }
+}
+
+void AudioManager::WakeAudioThread()
+{
+    // Notified without the lock to stay lock free, a wake lost to the race costs at most one stream period
+    m_wake_requested.store(true, std::memory_order_release);
+    m_wake_condition.notify_one();
+}
+
+void AudioManager::AudioLoop(const std::stop_token &stop_token)
+{
+    ENGINE_LOG_DEBUG("Audio thread started");
+    while (!stop_token.stop_requested()) {
+        MusicCommand command;
+        while (m_music_commands.TryPop(command)) {
+            ExecuteMusicCommand(command);
+        }
+
+        ProcessSoundCommands();
+        UpdateOcclusion();
+        StreamMusic();
+
+        std::unique_lock lock{m_wake_mutex};
+        m_wake_condition.wait_for(lock, stop_token, STREAM_PERIOD,
+                                  [this] { return m_wake_requested.exchange(false, std::memory_order_acquire); });
+    }
+}
+
+void AudioManager::ExecuteMusicCommand(const MusicCommand &command)
+{
+    switch (command.type) {
+        case MusicCommandType::Queue:
+            m_music_tracks.push_back(command.p_track);
+            ENGINE_LOG_DEBUG("Queued music track");
+            if (command.flag && !p_current_track) {
+                PlayNextTrack();
+            }
+            break;
+        case MusicCommandType::Play:
+            if (!p_current_track && !m_music_tracks.empty()) {
+                if (command.flag) {
+                    ShuffleQueuedTracks();
+                }
+
+                PlayNextTrack();
+            }
+            break;
+        case MusicCommandType::Pause:
+            if (m_music_source) {
+                alSourcePause(m_music_source);
+                if (const ALenum result{alGetError()}; result != AL_NO_ERROR) {
+                    ENGINE_LOG_ERROR("Failed to pause music: {}", alGetString(result));
+                }
+                else {
+                    ENGINE_LOG_DEBUG("Paused music on source {}", m_music_source);
+                }
+            }
+            break;
+        case MusicCommandType::Resume:
+            if (m_music_source) {
+                alSourcePlay(m_music_source);
+                if (const ALenum result{alGetError()}; result != AL_NO_ERROR) {
+                    ENGINE_LOG_ERROR("Failed to resume music: {}", alGetString(result));
+                }
+                else {
+                    ENGINE_LOG_DEBUG("Resumed music on source {}", m_music_source);
+                }
+            }
+            break;
+        case MusicCommandType::Stop:
+            StopMusicStream();
+            break;
+        case MusicCommandType::StopCurrentTrack:
+            ReleaseMusicSource();
+            break;
+        case MusicCommandType::Shuffle:
+            ShuffleQueuedTracks();
+            break;
+        case MusicCommandType::SetPitch:
+            if (m_music_source) {
+                alSourcef(m_music_source, AL_PITCH, command.value);
+                if (const ALenum result{alGetError()}; result != AL_NO_ERROR) {
+                    ENGINE_LOG_ERROR("Failed to set music pitch: {}", alGetString(result));
+                }
+                else {
+                    ENGINE_LOG_DEBUG("Set music pitch to {} for source {}", command.value, m_music_source);
+                }
+            }
+            else {
+                ENGINE_LOG_WARNING("No music source active to set pitch");
+            }
+            break;
+        case MusicCommandType::SetVolume:
+            m_master_music_volume = ClampVolume(command.value);
+            if (m_music_source) {
+                f32 current_volume{0.0f};
+                alGetSourcef(m_music_source, AL_GAIN, &current_volume);
+                alSourcef(m_music_source, AL_GAIN, current_volume * command.value);
+            }
+
+            ENGINE_LOG_DEBUG("Set master music volume to {} (volume): {}", m_master_music_volume, command.value);
+            break;
+        case MusicCommandType::SetLooping:
+            // The decoder rewinds at the end of the track, AL_LOOPING would replay only the buffers queued
+            m_music_looping = command.flag;
+            ENGINE_LOG_DEBUG("Set music looping to {}", command.flag ? "true" : "false");
+            break;
+        case MusicCommandType::SetQueueLooping:
+            m_queue_looping = command.flag;
+            ENGINE_LOG_DEBUG("Set queue looping to {}", command.flag ? "true" : "false");
+            break;
+        case MusicCommandType::SetCrossfade:
+            m_stream_settings.crossfade_time = std::max(command.value, 0.0f);
+            ENGINE_LOG_DEBUG("Set music crossfade to {}s", m_stream_settings.crossfade_time);
+            break;
+    }
+}
+
+void AudioManager::ProcessSoundCommands()
+{
+    // Voices that finished since the last wake are free for this batch
+    for (size_t i = m_voices.GetVoices().size(); i-- > 0;) {
+        const ALuint source{m_voices.GetVoices()[i].source};
+        ALint state{0};
+        alGetSourcei(source, AL_SOURCE_STATE, &state);
+        if (state != AL_PLAYING) {
+            UnbindEffectChain(source);
+            m_voices.Release(source);
+        }
+    }
+    DetachIdleEffectSlots();
+    ENGINE_PROFILE_GAUGE("Audio voices", m_voices.GetVoices().size());
+
+    std::array<SoundCommand, SOUND_BATCH_SIZE> batch;
+    size_t batch_size{0};
+    SoundCommand command;
+    while (m_sound_commands.TryPop(command)) {
+        if (command.type == SoundCommandType::Play) {
+            if (command.throttle.merge_same_frame && MergeSoundCommand(std::span{batch.data(), batch_size}, command)) {
+                continue;
+            }
+
+            batch[batch_size++] = command;
+            if (batch_size == batch.size()) {
+                PlaySoundBatch(batch);
+                batch_size = 0;
+            }
+            continue;
+        }
+
+        // Sounds posted before the change start first, so it applies to them like to the ones already playing
+        PlaySoundBatch(std::span{batch.data(), batch_size});
+        batch_size = 0;
+
+        switch (command.type) {
+            case SoundCommandType::SetVolume:
+                m_master_sound_volume = ClampVolume(command.volume);
+                for (const Voice &voice : m_voices.GetVoices()) {
+                    f32 current_volume{0.0f};
+                    alGetSourcef(voice.source, AL_GAIN, &current_volume);
+                    alSourcef(voice.source, AL_GAIN, current_volume * m_master_sound_volume);
+                }
+                ENGINE_LOG_DEBUG("Set master sound volume to {}", m_master_sound_volume);
+                break;
+            case SoundCommandType::SetListenerPosition:
+                m_voices.SetListenerPosition(command.position);
+                alListener3f(AL_POSITION, command.position.x, command.position.y, command.position.z);
+                if (const ALenum result{alGetError()}; result != AL_NO_ERROR) {
+                    ENGINE_LOG_ERROR("Failed to set listener position: {}", alGetString(result));
+                }
+                break;
+            case SoundCommandType::SetListenerVelocity:
+                alListener3f(AL_VELOCITY, command.position.x, command.position.y, command.position.z);
+                if (const ALenum result{alGetError()}; result != AL_NO_ERROR) {
+                    ENGINE_LOG_ERROR("Failed to set listener velocity: {}", alGetString(result));
+                }
+                break;
+            case SoundCommandType::RetainEffectChain:
+                AddEffectChainReference(command.effect_chain);
+                break;
+            case SoundCommandType::ReleaseEffectChain:
+                RemoveEffectChainReference(command.effect_chain);
+                break;
+            case SoundCommandType::Play:
+                break;
+        }
+    }
+    PlaySoundBatch(std::span{batch.data(), batch_size});
+}
+
+void AudioManager::PlaySoundBatch(const std::span<SoundCommand> commands)
+{
+    if (commands.empty()) {
+        return;
+    }
+
+    // Best first, so when voices run out it is the least important sounds of the batch that miss out
+    const auto to_voice = [](const SoundCommand &command) {
+        return Voice{0, command.position, command.volume, command.priority, command.is_positional, command.buffer};
+    };
+    std::ranges::stable_sort(commands, [&](const SoundCommand &a, const SoundCommand &b) {
+        if (a.priority != b.priority) {
+            return a.priority > b.priority;
+        }
+        return m_voices.GetAudibleGain(to_voice(a), 1.0f) > m_voices.GetAudibleGain(to_voice(b), 1.0f);
+    });
+
+    std::array<ALuint, SOUND_BATCH_SIZE> sources;
+    size_t source_count{0};
+    const auto now{std::chrono::steady_clock::now()};
+    for (const SoundCommand &command : commands) {
+        if (IsSoundThrottled(command, now)) {
+            continue;
+        }
+
+        bool is_stolen{false};
+        const ALuint source{m_voices.Acquire(to_voice(command), m_master_sound_volume, is_stolen)};
+        if (source == 0) {
+            continue; // Inaudible, or every voice matters more
+        }
+        if (is_stolen) {
+            alSourceStop(source);
+            UnbindEffectChain(source);
+        }
+
+        if (!PrepareSoundSource(source, command)) {
+            m_voices.Release(source);
+            continue;
+        }
+        sources[source_count++] = source;
+
+        if (command.throttle.min_retrigger_interval > 0.0f) {
+            m_sound_last_started[command.buffer] = now;
+        }
+    }
+
+    if (source_count == 0) {
+        return;
+    }
+
+    alSourcePlayv(static_cast<ALsizei>(source_count), sources.data());
+    if (const ALenum result{alGetError()}; result != AL_NO_ERROR) {
+        ENGINE_LOG_ERROR("Failed to play {} sound effects: {}", source_count, alGetString(result));
+        for (size_t i = 0; i < source_count; ++i) {
+            UnbindEffectChain(sources[i]);
+            m_voices.Release(sources[i]);
+        }
+    }
+}
+
+bool AudioManager::MergeSoundCommand(const std::span<SoundCommand> batch, const SoundCommand &command)
+{
+    if (command.loop) {
+        return false;
+    }
+
+    for (SoundCommand &merged : batch) {
+        if (merged.buffer != command.buffer || merged.loop || merged.is_positional != command.is_positional ||
+            merged.effect_chain.key != command.effect_chain.key) {
+            continue;
+        }
+
+        // Added by energy rather than amplitude, so a burst sounds bigger without growing with the count. Positioned
+        // plays merge at the first one's position.
+        const f32 volume{std::sqrt(merged.volume * merged.volume + command.volume * command.volume)};
+        merged.volume = std::max(merged.volume, std::min(volume, command.throttle.max_merged_volume));
+        merged.priority = std::max(merged.priority, command.priority);
+        return true;
+    }
+    return false;
+}
+
+bool AudioManager::IsSoundThrottled(const SoundCommand &command, const std::chrono::steady_clock::time_point now) const
+{
+    const SoundThrottle &throttle{command.throttle};
+    if (throttle.max_instances > 0 && m_voices.CountVoices(command.buffer) >= throttle.max_instances) {
+        return true;
+    }
+
+    if (throttle.min_retrigger_interval > 0.0f) {
+        const auto it{m_sound_last_started.find(command.buffer)};
+        return it != m_sound_last_started.end() &&
+               now - it->second < std::chrono::duration<f32>{throttle.min_retrigger_interval};
+    }
+    return false;
+}
+
+bool AudioManager::PrepareSoundSource(const ALuint source, const SoundCommand &command)
+{
+    if (!alIsBuffer(command.buffer)) {
+        ENGINE_LOG_ERROR("Invalid buffer ID {}", command.buffer);
+        return false;
+    }
+
+    // Sounds without a position follow the listener, positioned ones use the attenuation the voices are ranked by
+    const VoiceSettings &settings{m_voices.GetSettings()};
+    const f32 effective_volume{command.volume * m_master_sound_volume};
+    alSourcei(source, AL_BUFFER, static_cast<ALint>(command.buffer));
+    alSourcef(source, AL_GAIN, effective_volume);
+    alSourcef(source, AL_MAX_GAIN, std::max(effective_volume, 1.0f)); // Merged plays may be louder than unity
+    alSourcef(source, AL_PITCH, command.pitch);
+    alSourcei(source, AL_SOURCE_RELATIVE, command.is_positional ? AL_FALSE : AL_TRUE);
+    alSource3f(source, AL_POSITION, command.position.x, command.position.y, command.position.z);
+    alSourcef(source, AL_REFERENCE_DISTANCE, settings.reference_distance);
+    alSourcef(source, AL_ROLLOFF_FACTOR, settings.rolloff_factor);
+    alSourcef(source, AL_MAX_DISTANCE, settings.max_distance);
+    alSourcei(source, AL_LOOPING, command.loop ? AL_TRUE : AL_FALSE);
+
+    // A new play on the source, results queried for the last one no longer apply
+    SourceState &state{m_source_states[source]};
+    ++state.play;
+    if (state.occlusion > 0.0f) {
+        ApplyOcclusion(source, 0.0f);
+    }
+
+    BindEffectChain(source, command.effect_chain);
+    return true;
+}
+
+void AudioManager::BindEffectChain(const ALuint source, const EffectChain chain)
+{
+    SourceState &bound{m_source_states[source]};
+    if (bound.chain.key != chain.key && m_max_effect_sends > 0) {
+        // A source keeps its sends between sounds, so only the sends that differ from its last chain are changed
+        const std::array<ALuint, MAX_EFFECT_CHAIN_LENGTH> previous_slots{
+            bound.chain.IsEmpty() ? std::array<ALuint, MAX_EFFECT_CHAIN_LENGTH>{}
+                                  : GetBoundEffectChain(bound.chain).slots};
+        const std::array<ALuint, MAX_EFFECT_CHAIN_LENGTH> slots{
+            chain.IsEmpty() ? std::array<ALuint, MAX_EFFECT_CHAIN_LENGTH>{} : GetBoundEffectChain(chain).slots};
+        for (size_t send = 0; send < m_max_effect_sends; ++send) {
+            if (slots[send] != previous_slots[send]) {
+                const ALint slot{slots[send] != 0 ? static_cast<ALint>(slots[send]) : AL_EFFECTSLOT_NULL};
+                alSource3i(source, AL_AUXILIARY_SEND_FILTER, slot, static_cast<ALint>(send), AL_FILTER_NULL);
+            }
+        }
+        if (const ALenum result{alGetError()}; result != AL_NO_ERROR) {
+            ENGINE_LOG_ERROR("Failed to bind effect chain {:x} to source {}: {}", chain.key, source,
+                             alGetString(result));
+        }
+    }
+
+    if (bound.holds_reference) {
+        RemoveEffectChainReference(bound.chain);
+    }
+    bound.chain = chain;
+    bound.holds_reference = !chain.IsEmpty();
+    if (bound.holds_reference) {
+        AddEffectChainReference(chain);
+    }
+}
+
+void AudioManager::UnbindEffectChain(const ALuint source)
+{
+    const auto it{m_source_states.find(source)};
+    if (it == m_source_states.end() || !it->second.holds_reference) {
+        return;
+    }
+
+    // The sends stay pointed at the chain, the next sound on the source may well use it again
+    it->second.holds_reference = false;
+    RemoveEffectChainReference(it->second.chain);
+}
+
+AudioManager::BoundEffectChain &AudioManager::GetBoundEffectChain(const EffectChain chain)
+{
+    const auto [it, inserted]{m_effect_chains.try_emplace(chain.key)};
+    if (inserted) {
+        // Resolved once, effects that failed to initialize leave their send unused
+        BoundEffectChain &bound{it->second};
+        for (size_t i = 0; i < std::min(chain.GetLength(), m_max_effect_sends); ++i) {
+            const AudioEffects::EffectData &effect{m_effects[chain[i]]};
+            if (effect.slot_id == 0 || effect.effect_id == 0) {
+                ENGINE_LOG_WARNING("Effect {} not initialized; skipping it in chain {:x}", static_cast<int>(chain[i]),
+                                   chain.key);
+                continue;
+            }
+            bound.slots[i] = effect.slot_id;
+        }
+        ENGINE_LOG_DEBUG("Bound effect chain {:x} with {} effects", chain.key, chain.GetLength());
+    }
+    return it->second;
+}
+
+void AudioManager::AddEffectChainReference(const EffectChain chain)
+{
+    if (chain.IsEmpty() || m_max_effect_sends == 0) {
+        return;
+    }
+
+    BoundEffectChain &bound{GetBoundEffectChain(chain)};
+    if (bound.references++ > 0) {
+        return;
+    }
+
+    for (size_t i = 0; i < std::min(chain.GetLength(), m_max_effect_sends); ++i) {
+        const AudioEffectType type{chain[i]};
+        EffectSlotState &slot{m_effect_slots[static_cast<size_t>(type)]};
+        if (slot.references++ == 0 && !slot.attached && bound.slots[i] != 0) {
+            alAuxiliaryEffectSloti(bound.slots[i], AL_EFFECTSLOT_EFFECT, static_cast<ALint>(m_effects[type].effect_id));
+            slot.attached = alGetError() == AL_NO_ERROR;
+        }
+    }
+}
+
+void AudioManager::RemoveEffectChainReference(const EffectChain chain)
+{
+    if (chain.IsEmpty() || m_max_effect_sends == 0) {
+        return;
+    }
+
+    BoundEffectChain &bound{GetBoundEffectChain(chain)};
+    if (bound.references == 0) {
+        ENGINE_LOG_WARNING("Effect chain {:x} released more often than it was used", chain.key);
+        return;
+    }
+    if (--bound.references > 0) {
+        return;
+    }
+
+    const auto now{std::chrono::steady_clock::now()};
+    for (size_t i = 0; i < std::min(chain.GetLength(), m_max_effect_sends); ++i) {
+        EffectSlotState &slot{m_effect_slots[static_cast<size_t>(chain[i])]};
+        if (--slot.references == 0) {
+            slot.idle_since = now;
+        }
+    }
+}
+
+void AudioManager::DetachIdleEffectSlots()
+{
+    if (!m_effects_loaded || !alAuxiliaryEffectSloti) {
+        return;
+    }
+
+    // A slot keeps mixing its effect with no sends, detaching it stops that once the tails rang out
+    std::optional<std::chrono::steady_clock::time_point> now;
+    for (size_t type = 0; type < AUDIO_EFFECT_COUNT; ++type) {
+        EffectSlotState &slot{m_effect_slots[type]};
+        if (slot.references > 0 || !slot.attached) {
+            continue;
+        }
+
+        const ALuint slot_id{m_effects[static_cast<AudioEffectType>(type)].slot_id};
+        if (slot_id == 0) {
+            slot.attached = false;
+            continue;
+        }
+
+        if (!now) {
+            now = std::chrono::steady_clock::now();
+        }
+        if (*now - slot.idle_since >= EFFECT_SLOT_IDLE_TIME) {
+            alAuxiliaryEffectSloti(slot_id, AL_EFFECTSLOT_EFFECT, AL_EFFECT_NULL);
+            slot.attached = alGetError() != AL_NO_ERROR;
+        }
+    }
+}
+
+void AudioManager::UpdateOcclusion()
+{
+    if (m_occlusion_results_ready.exchange(false, std::memory_order_acquire)) {
+        {
+            std::lock_guard lock{m_occlusion_mutex};
+            std::swap(m_occlusion_results, m_applied_occlusion_results);
+        }
+
+        // Results for a source that started another sound since it was queried are dropped
+        for (const OcclusionResult &result : m_applied_occlusion_results) {
+            const ALuint source{static_cast<ALuint>(result.voice & constants::u32_max)};
+            const auto it{m_source_states.find(source)};
+            if (it != m_source_states.end() && it->second.play == static_cast<u32>(result.voice >> 32)) {
+                ApplyOcclusion(source, result.occlusion);
+            }
+        }
+        m_applied_occlusion_results.clear();
+    }
+
+    const auto now{std::chrono::steady_clock::now()};
+    if (now - m_last_occlusion_post < OCCLUSION_PERIOD || !m_occlusion_queries_taken.load(std::memory_order_relaxed)) {
+        return;
+    }
+    m_last_occlusion_post = now;
+
+    // Only the loudest sounds are queried, the cost of a batch does not grow with the number of voices
+    m_occlusion_candidates.clear();
+    for (const Voice &voice : m_voices.GetVoices()) {
+        if (!voice.is_positional) {
+            continue;
+        }
+
+        const auto it{m_source_states.find(voice.source)};
+        const u64 play{it != m_source_states.end() ? it->second.play : 0u};
+        m_occlusion_candidates.push_back({m_voices.GetAudibleGain(voice, m_master_sound_volume),
+                                          {(play << 32) | voice.source, voice.position}});
+    }
+    if (m_occlusion_candidates.empty()) {
+        return;
+    }
+
+    const size_t count{std::min(m_occlusion_candidates.size(), MAX_OCCLUSION_QUERIES)};
+    std::partial_sort(m_occlusion_candidates.begin(), m_occlusion_candidates.begin() + count,
+                      m_occlusion_candidates.end(),
+                      [](const auto &lhs, const auto &rhs) { return lhs.first > rhs.first; });
+
+    std::lock_guard lock{m_occlusion_mutex};
+    m_occlusion_queries.clear();
+    for (size_t i = 0; i < count; ++i) {
+        m_occlusion_queries.push_back(m_occlusion_candidates[i].second);
+    }
+    m_occlusion_listener = m_voices.GetListenerPosition();
+    m_occlusion_queries_taken.store(false, std::memory_order_relaxed);
+}
+
+void AudioManager::ApplyOcclusion(const ALuint source, f32 occlusion)
+{
+    occlusion = std::clamp(occlusion, 0.0f, 1.0f);
+    SourceState &state{m_source_states[source]};
+    if (std::abs(occlusion - state.occlusion) < OCCLUSION_STEP && (occlusion > 0.0f || state.occlusion == 0.0f)) {
+        return;
+    }
+    state.occlusion = occlusion;
+
+    if (m_occlusion_filter == 0) {
+        return;
+    }
+
+    if (occlusion == 0.0f) {
+        alSourcei(source, AL_DIRECT_FILTER, AL_FILTER_NULL);
+    }
+    else {
+        const VoiceSettings &settings{m_voices.GetSettings()};
+        const f32 gain{1.0f + (settings.occluded_gain - 1.0f) * occlusion};
+        const f32 gain_hf{1.0f + (settings.occluded_gain_hf - 1.0f) * occlusion};
+        alFilterf(m_occlusion_filter, AL_LOWPASS_GAIN, std::clamp(gain, 0.0f, 1.0f));
+        alFilterf(m_occlusion_filter, AL_LOWPASS_GAINHF, std::clamp(gain_hf, 0.0f, 1.0f));
+        alSourcei(source, AL_DIRECT_FILTER, static_cast<ALint>(m_occlusion_filter));
+    }
+
+    if (const ALenum result{alGetError()}; result != AL_NO_ERROR) {
+        ENGINE_LOG_ERROR("Failed to apply occlusion {} to source {}: {}", occlusion, source, alGetString(result));
+    }
+}
+
+void AudioManager::StreamMusic()
+{
+    if (!m_music_source || !p_current_track) {
+        return;
+    }
+
+    ALint processed{0};
+    alGetSourcei(m_music_source, AL_BUFFERS_PROCESSED, &processed);
+    while (processed--) {
+        ALuint buffer{0};
+        alSourceUnqueueBuffers(m_music_source, 1, &buffer);
+        if (const ALenum result{alGetError()}; result != AL_NO_ERROR) {
+            ENGINE_LOG_ERROR("alSourceUnqueueBuffers failed: {}", alGetString(result));
+            continue;
+        }
+
+        if (FillMusicBuffer(buffer) > 0) {
+            alSourceQueueBuffers(m_music_source, 1, &buffer);
+        }
+    }
+
+    // Spread over the current track, so the hand over copies frames rather than decoding a queue of buffers at once
+    PrefetchNextTrack();
+
+    // The next track could not continue the stream on this source, it starts on its own once the queue played out
+    if (IsTrackFinished(*p_current_track)) {
+        ALint queued{0};
+        alGetSourcei(m_music_source, AL_BUFFERS_QUEUED, &queued);
+        if (queued == 0) {
+            ENGINE_LOG_DEBUG("Music track finished");
+            PlayNextTrack();
+        }
+        return;
+    }
+
+    ALint state{0};
+    alGetSourcei(m_music_source, AL_SOURCE_STATE, &state);
+    if (state != AL_PLAYING && !m_music_buffers.empty()) {
+        alSourcePlay(m_music_source);
+        ENGINE_LOG_DEBUG("Restarted music playback");
+    }
+}
+
+size_t AudioManager::FillMusicBuffer(const ALuint buffer)
+{
+    const size_t frames_read{DecodeMusic(m_frames_per_buffer)};
+    if (frames_read > 0) {
+        const auto channels{static_cast<size_t>(p_current_track->GetChannels())};
+        alBufferData(buffer, p_current_track->GetFormat(), m_decode_buffer.data(),
+                     static_cast<ALsizei>(frames_read * channels * sizeof(f32)), p_current_track->GetSampleRate());
+    }
+    return frames_read;
+}
+
+void AudioManager::StopMusicStream()
+{
+    if (m_music_source) {
+        ReleaseMusicSource();
+    }
+
+    ResetPrefetch();
+    p_current_track = nullptr;
+    m_music_looping = false;
+    m_music_tracks.clear();
+    m_current_index = 0;
+
+    ENGINE_LOG_DEBUG("Stopped music and cleared queue");
+}
+
+void AudioManager::ReleaseMusicSource()
+{
+    if (m_music_source) {
+
+        ALuint source_to_log{m_music_source};
+        alSourceStop(m_music_source);
+
+        ALenum result{alGetError()};
+        if (result != AL_NO_ERROR) {
+            ENGINE_LOG_ERROR("Failed to stop music source {}: {}", source_to_log, alGetString(result));
+        }
+        alDeleteSources(1, &m_music_source);
+        result = alGetError();
+        if (result != AL_NO_ERROR) {
+            ENGINE_LOG_ERROR("Failed to delete music source {}: {}", source_to_log, alGetString(result));
+        }
+        m_music_source = 0;
+        for (ALuint buffer : m_music_buffers) {
+            alDeleteBuffers(1, &buffer);
+            result = alGetError();
+            if (result != AL_NO_ERROR) {
+                ENGINE_LOG_ERROR("Failed to delete buffer {}: {}", buffer, alGetString(result));
+            }
+        }
+        m_music_buffers.clear();
+        ENGINE_LOG_DEBUG("Stopped current track on source {}", source_to_log);
+    }
+}
+
+size_t AudioManager::DecodeMusic(const size_t frames)
+{
+    const auto channels{static_cast<size_t>(p_current_track->GetChannels())};
+    size_t written{0};
+    while (written < frames) {
+        f32 *out{m_decode_buffer.data() + written * channels};
+        const size_t wanted{frames - written};
+        const size_t remaining{GetRemainingFrames(*p_current_track)};
+        const auto crossfade_frames{static_cast<size_t>(m_stream_settings.crossfade_time *
+                                                        static_cast<f32>(p_current_track->GetSampleRate()))};
+
+        size_t read{0};
+        if (crossfade_frames > 0 && remaining > 0 && remaining <= crossfade_frames && PrepareHandOver()) {
+            read = ReadTrackFrames(*p_current_track, out, std::min(wanted, remaining));
+
+            // Equal power, so the loudness holds through the fade rather than dipping halfway
+            m_crossfade_buffer.resize(read * channels);
+            const size_t next_read{ReadTrackFrames(*m_prefetch.p_track, m_crossfade_buffer.data(), read)};
+            for (size_t frame = 0; frame < read; ++frame) {
+                const f32 progress{1.0f -
+                                   static_cast<f32>(remaining - frame) / static_cast<f32>(crossfade_frames)};
+                const f32 out_gain{std::cos(progress * std::numbers::pi_v<f32> * 0.5f)};
+                const f32 in_gain{std::sin(progress * std::numbers::pi_v<f32> * 0.5f)};
+                for (size_t channel = 0; channel < channels; ++channel) {
+                    const size_t sample{frame * channels + channel};
+                    out[sample] *= out_gain;
+                    if (frame < next_read) {
+                        out[sample] += m_crossfade_buffer[sample] * in_gain;
+                    }
+                }
+            }
+        }
+        else {
+            // Stops where the fade starts, so the fade begins on the exact frame
+            const bool fade_ahead{crossfade_frames > 0 && remaining > crossfade_frames};
+            read = ReadTrackFrames(*p_current_track, out,
+                                   fade_ahead ? std::min(wanted, remaining - crossfade_frames) : wanted);
+        }
+        written += read;
+
+        if (!IsTrackFinished(*p_current_track)) {
+            if (read == 0) {
+                break;
+            }
+            continue;
+        }
+
+        // Repeats of the current track, from looping it or a queue of one, rewind rather than restart the source
+        const std::optional<size_t> next{GetNextTrackIndex()};
+        if (m_music_looping || (next && m_music_tracks[*next] == p_current_track)) {
+            if (!p_current_track->Rewind()) {
+                break;
+            }
+            if (!m_music_looping) {
+                m_current_index = *next + 1;
+            }
+            continue;
+        }
+
+        if (!PrepareHandOver()) {
+            break;
+        }
+        p_current_track = m_prefetch.p_track;
+        m_current_index = m_prefetch.queue_index + 1;
+        ENGINE_LOG_DEBUG("Handed music over to the next track on source {}", m_music_source);
+    }
+    return written;
+}
+
+size_t AudioManager::ReadTrackFrames(MusicTrack &track, f32 *out, const size_t frames)
+{
+    const auto channels{static_cast<size_t>(track.GetChannels())};
+    size_t read{0};
+    if (m_prefetch.p_track == &track) {
+        read = std::min(frames, m_prefetch.frames - m_prefetch.consumed);
+        std::copy_n(m_prefetch.samples.data() + m_prefetch.consumed * channels, read * channels, out);
+        m_prefetch.consumed += read;
+
+        // Drained once the track is playing, so the track after it can be prefetched
+        if (m_prefetch.consumed == m_prefetch.frames && &track == p_current_track) {
+            ResetPrefetch();
+        }
+    }
+
+    if (read < frames && !track.IsFinished()) {
+        read += track.ReadFrames(out + read * channels, frames - read);
+    }
+    return read;
+}
+
+void AudioManager::PrefetchNextTrack()
+{
+    // The current track's own prefetched start is still streaming
+    if (m_prefetch.p_track == p_current_track) {
+        return;
+    }
+
+    const std::optional<size_t> next{GetNextTrackIndex()};
+    if (!next || m_music_tracks[*next] == p_current_track) {
+        ResetPrefetch();
+        return;
+    }
+    if (m_prefetch.p_track != m_music_tracks[*next] || m_prefetch.queue_index != *next) {
+        BeginPrefetch(*next);
+    }
+
+    // A buffer per wake, so the decode is spread over the current track rather than stalling the stream
+    MusicTrack &track{*m_prefetch.p_track};
+    const auto capacity{
+        static_cast<size_t>(m_stream_settings.prefetch_time * static_cast<f32>(track.GetSampleRate()))};
+    if (m_prefetch.frames >= capacity || track.IsFinished()) {
+        return;
+    }
+
+    const auto channels{static_cast<size_t>(track.GetChannels())};
+    const size_t count{std::min(m_frames_per_buffer, capacity - m_prefetch.frames)};
+    m_prefetch.samples.resize((m_prefetch.frames + count) * channels);
+    m_prefetch.frames += track.ReadFrames(m_prefetch.samples.data() + m_prefetch.frames * channels, count);
+    m_prefetch.samples.resize(m_prefetch.frames * channels);
+}
+
+void AudioManager::BeginPrefetch(const size_t queue_index)
+{
+    ResetPrefetch();
+    MusicTrack *p_track{m_music_tracks[queue_index]};
+    if (!p_track->Rewind()) {
+        return;
+    }
+
+    m_prefetch.p_track = p_track;
+    m_prefetch.queue_index = queue_index;
+}
+
+bool AudioManager::PrepareHandOver()
+{
+    const std::optional<size_t> next{GetNextTrackIndex()};
+    if (!next) {
+        return false;
+    }
+
+    // Buffers queued on one source share their format, and the current track's prefetch has to drain first
+    MusicTrack *p_next{m_music_tracks[*next]};
+    if (p_next == p_current_track || m_prefetch.p_track == p_current_track ||
+        p_next->GetFormat() != p_current_track->GetFormat() ||
+        p_next->GetSampleRate() != p_current_track->GetSampleRate()) {
+        return false;
+    }
+
+    if (m_prefetch.p_track != p_next || m_prefetch.queue_index != *next) {
+        BeginPrefetch(*next);
+    }
+    return m_prefetch.p_track == p_next;
+}
+
+std::optional<size_t> AudioManager::GetNextTrackIndex() const
+{
+    if (m_music_looping || m_music_tracks.empty()) {
+        return std::nullopt;
+    }
+    if (m_current_index < m_music_tracks.size()) {
+        return m_current_index;
+    }
+    if (m_queue_looping) {
+        return 0;
+    }
+    return std::nullopt;
+}
+
+size_t AudioManager::GetRemainingFrames(const MusicTrack &track) const
+{
+    const size_t prefetched{m_prefetch.p_track == &track ? m_prefetch.frames - m_prefetch.consumed : 0};
+    const size_t position{track.GetFramePosition()};
+    const size_t frame_count{track.GetFrameCount()};
+    return prefetched + (track.IsFinished() || position >= frame_count ? 0 : frame_count - position);
+}
+
+bool AudioManager::IsTrackFinished(const MusicTrack &track) const
+{
+    return track.IsFinished() && (m_prefetch.p_track != &track || m_prefetch.consumed == m_prefetch.frames);
+}
+
+void AudioManager::ResetPrefetch()
+{
+    m_prefetch.p_track = nullptr;
+    m_prefetch.queue_index = 0;
+    m_prefetch.samples.clear();
+    m_prefetch.frames = 0;
+    m_prefetch.consumed = 0;
+}
+
+void AudioManager::ShuffleQueuedTracks()
+{
+    if (m_current_index < m_music_tracks.size()) {
+        std::shuffle(m_music_tracks.begin() + m_current_index, m_music_tracks.end(), math::GetGlobalRNG());
+    }
+
+    ENGINE_LOG_DEBUG("Shuffled music queue with {} tracks", m_music_tracks.size());
+}
+
 }
\ No newline at end of file
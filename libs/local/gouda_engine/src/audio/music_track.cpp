@@ -1,29 +1,31 @@
 #include "audio/music_track.hpp"
 
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
 #include <alext.h>
 
 #include "debug/logger.hpp"
 
 namespace gouda::audio {
 
-MusicTrack::MusicTrack() : p_sndfile{nullptr}, m_format{AL_NONE}, m_sample_rate{0}, m_channels{0}, m_finished{true}
+MusicTrack::MusicTrack()
+    : p_sndfile{nullptr}, m_format{AL_NONE}, m_sample_rate{0}, m_channels{0}, m_frame_position{0}, m_finished{true}
 {
     // Default constructor initializes to "unloaded" state
 }
 
-MusicTrack::~MusicTrack()
-{
-    if (p_sndfile) {
-        sf_close(p_sndfile);
-    }
-}
+MusicTrack::~MusicTrack() { Close(); }
 
 MusicTrack::MusicTrack(MusicTrack &&other) noexcept
-    : p_sndfile{other.p_sndfile},
+    : p_stream{std::move(other.p_stream)},
+      p_sndfile{other.p_sndfile},
       m_sfinfo{other.m_sfinfo},
       m_format{other.m_format},
       m_sample_rate{other.m_sample_rate},
       m_channels{other.m_channels},
+      m_frame_position{other.m_frame_position},
       m_finished{other.m_finished}
 {
     other.p_sndfile = nullptr;
@@ -33,14 +35,14 @@ MusicTrack::MusicTrack(MusicTrack &&other) noexcept
 MusicTrack &MusicTrack::operator=(MusicTrack &&other) noexcept
 {
     if (this != &other) {
-        if (p_sndfile) {
-            sf_close(p_sndfile);
-        }
+        Close();
+        p_stream = std::move(other.p_stream);
         p_sndfile = other.p_sndfile;
         m_sfinfo = other.m_sfinfo;
         m_format = other.m_format;
         m_sample_rate = other.m_sample_rate;
         m_channels = other.m_channels;
+        m_frame_position = other.m_frame_position;
         m_finished = other.m_finished;
         other.p_sndfile = nullptr;
         other.m_finished = true;
@@ -62,20 +64,86 @@ bool MusicTrack::Load(std::string_view filepath)
         return false;
     }
 
-    if (p_sndfile) {
-        sf_close(p_sndfile);
-        p_sndfile = nullptr;
+    Close();
+
+    auto file{fs::MappedFile::Open(filepath)};
+    if (!file) {
+        ENGINE_LOG_ERROR("Could not open music file {}: {}", filepath, fs::error_to_string(file.error()));
+        return false;
+    }
+
+    p_stream = std::make_unique<MemoryStream>();
+    p_stream->file.emplace(std::move(*file));
+    p_stream->data = p_stream->file->GetData();
+    return Open(filepath);
+}
+
+bool MusicTrack::LoadFromMemory(const std::span<const std::byte> data, std::string_view name)
+{
+    ENGINE_LOG_DEBUG("Attempting to load music track from memory: {}", name);
+
+    if (data.empty()) {
+        ENGINE_LOG_ERROR("Empty music data provided for {}", name);
+        return false;
+    }
+
+    if (!IsValidAudioExtension(name)) {
+        ENGINE_LOG_ERROR("Unsupported audio type: {}", name);
+        return false;
     }
 
-    p_sndfile = sf_open(filepath.data(), SFM_READ, &m_sfinfo);
+    Close();
+
+    p_stream = std::make_unique<MemoryStream>();
+    p_stream->data = data;
+    return Open(name);
+}
+
+bool MusicTrack::Open(std::string_view name)
+{
+    // Captureless lambdas, libsndfile calls them with the stream as user data
+    static SF_VIRTUAL_IO memory_io{
+        .get_filelen = [](void *user_data) -> sf_count_t {
+            return static_cast<sf_count_t>(static_cast<MemoryStream *>(user_data)->data.size());
+        },
+        .seek = [](const sf_count_t offset, const int whence, void *user_data) -> sf_count_t {
+            auto *stream{static_cast<MemoryStream *>(user_data)};
+            const auto size{static_cast<sf_count_t>(stream->data.size())};
+            sf_count_t position{offset};
+            if (whence == SEEK_CUR) {
+                position += stream->position;
+            }
+            else if (whence == SEEK_END) {
+                position += size;
+            }
+            if (position < 0 || position > size) {
+                return -1;
+            }
+            stream->position = position;
+            return position;
+        },
+        .read = [](void *buffer, const sf_count_t count, void *user_data) -> sf_count_t {
+            auto *stream{static_cast<MemoryStream *>(user_data)};
+            const sf_count_t read{std::min(count, static_cast<sf_count_t>(stream->data.size()) - stream->position)};
+            std::memcpy(buffer, stream->data.data() + stream->position, static_cast<size_t>(read));
+            stream->position += read;
+            return read;
+        },
+        .write = nullptr, // Tracks are only read
+        .tell = [](void *user_data) -> sf_count_t { return static_cast<MemoryStream *>(user_data)->position; },
+    };
+
+    p_sndfile = sf_open_virtual(&memory_io, SFM_READ, &m_sfinfo, p_stream.get());
     if (!p_sndfile) {
-        ENGINE_LOG_ERROR("Could not open music file {}: {}", filepath, sf_strerror(nullptr));
+        ENGINE_LOG_ERROR("Could not open music file {}: {}", name, sf_strerror(nullptr));
+        p_stream.reset();
         return false;
     }
 
     if (m_sfinfo.frames < 1) {
         ENGINE_LOG_ERROR("Invalid frame count: {}", m_sfinfo.frames);
-        return HandleError(p_sndfile);
+        Close();
+        return false;
     }
 
     // Format detection
@@ -89,22 +157,35 @@ bool MusicTrack::Load(std::string_view filepath)
         }
         else {
             ENGINE_LOG_ERROR("Unsupported channel count: {}", m_sfinfo.channels);
-            return HandleError(p_sndfile);
+            Close();
+            return false;
         }
     }
     else {
         ENGINE_LOG_ERROR("Unsupported audio format: {:x}", m_sfinfo.format);
-        return HandleError(p_sndfile);
+        Close();
+        return false;
     }
 
     m_sample_rate = m_sfinfo.samplerate;
     m_channels = m_sfinfo.channels;
+    m_frame_position = 0;
     m_finished = false;
     ENGINE_LOG_DEBUG("Loaded music track: format={}, rate={}, channels={}", FormatName(m_format), m_sample_rate,
                      m_channels);
     return true;
 }
 
+void MusicTrack::Close()
+{
+    if (p_sndfile) {
+        sf_close(p_sndfile);
+        p_sndfile = nullptr;
+    }
+    p_stream.reset(); // After the file, closing may still read through the stream
+    m_finished = true;
+}
+
 size_t MusicTrack::ReadFrames(float *buffer, size_t frames)
 {
     if (!p_sndfile || m_finished) {
@@ -113,6 +194,7 @@ size_t MusicTrack::ReadFrames(float *buffer, size_t frames)
     }
 
     const sf_count_t read{sf_readf_float(p_sndfile, buffer, frames)};
+    m_frame_position += static_cast<size_t>(read);
     if (read < static_cast<sf_count_t>(frames)) {
         m_finished = true;
         ENGINE_LOG_DEBUG("Reached end of music track");
@@ -121,4 +203,16 @@ size_t MusicTrack::ReadFrames(float *buffer, size_t frames)
     return static_cast<size_t>(read);
 }
 
+bool MusicTrack::Rewind()
+{
+    if (!p_sndfile || sf_seek(p_sndfile, 0, SEEK_SET) < 0) {
+        ENGINE_LOG_ERROR("Could not rewind music track");
+        return false;
+    }
+
+    m_frame_position = 0;
+    m_finished = false;
+    return true;
+}
+
 } // namespace gouda::audio
\ No newline at end of file
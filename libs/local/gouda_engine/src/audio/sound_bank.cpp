@@ -0,0 +1,133 @@
+/**
+ * @file audio/sound_bank.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine decoded sound effect cache implementation
+ */
+#include "audio/sound_bank.hpp"
+
+#include <AL/al.h>
+
+#include "debug/logger.hpp"
+#include "utils/filesystem.hpp"
+
+namespace gouda::audio {
+
+SoundBank::SoundBank(JobSystem *job_system) : p_job_system{job_system} {}
+
+SoundBank::~SoundBank()
+{
+    WaitForLoads(); // Jobs still write into the decode buffers
+}
+
+SoundID SoundBank::Load(StringView filepath)
+{
+    if (const auto it{m_sound_ids.find(filepath)}; it != m_sound_ids.end()) {
+        return it->second;
+    }
+
+    const auto id{static_cast<SoundID>(m_sounds.size())};
+    Sound &sound{m_sounds.emplace_back(String{filepath}, SoundState::Decoding, SoundEffect{},
+                                       std::make_unique<DecodedSound>(), std::make_unique<JobCounter>())};
+    m_sound_ids.emplace(sound.filepath, id);
+
+    // Extensions are queried here, the job only decodes into its own buffer, which stays untouched until it is done
+    auto decode = [decoded = sound.p_decoded.get(), filepath = sound.filepath,
+                   supports_float = alIsExtensionPresent("AL_EXT_FLOAT32") == AL_TRUE] {
+        if (!DecodeSound(filepath, supports_float, *decoded)) {
+            decoded->samples.clear();
+        }
+    };
+
+    if (p_job_system == nullptr || p_job_system->GetWorkerCount() == 0) {
+        decode();
+        FinishLoad(sound);
+        return id;
+    }
+
+    p_job_system->Schedule(std::move(decode), sound.p_counter.get());
+    m_pending.push_back(id);
+    return id;
+}
+
+void SoundBank::Preload(const std::span<const String> filepaths)
+{
+    for (const String &filepath : filepaths) {
+        Load(filepath);
+    }
+}
+
+bool SoundBank::PreloadManifest(StringView manifest_filepath)
+{
+    const auto manifest{fs::ReadFile(manifest_filepath)};
+    if (!manifest) {
+        ENGINE_LOG_ERROR("Failed to read sound manifest '{}': {}", manifest_filepath,
+                         fs::error_to_string(manifest.error()));
+        return false;
+    }
+
+    StringView remaining{*manifest};
+    while (!remaining.empty()) {
+        const size_t line_end{remaining.find('\n')};
+        StringView line{remaining.substr(0, line_end)};
+        remaining = line_end == StringView::npos ? StringView{} : remaining.substr(line_end + 1);
+
+        const size_t first{line.find_first_not_of(" \t\r")};
+        if (first == StringView::npos || line[first] == '#') {
+            continue;
+        }
+        line = line.substr(first, line.find_last_not_of(" \t\r") - first + 1);
+        Load(line);
+    }
+
+    return true;
+}
+
+void SoundBank::Update()
+{
+    // Pending sounds are kept in request order, so a level's first sounds are uploaded first
+    size_t kept{0};
+    for (const SoundID id : m_pending) {
+        Sound &sound{m_sounds[id]};
+        if (!sound.p_counter->IsDone()) {
+            m_pending[kept++] = id;
+            continue;
+        }
+        FinishLoad(sound);
+    }
+    m_pending.resize(kept);
+}
+
+void SoundBank::WaitForLoads()
+{
+    for (const SoundID id : m_pending) {
+        FinishLoad(m_sounds[id]);
+    }
+    m_pending.clear();
+}
+
+SoundID SoundBank::Find(StringView filepath) const
+{
+    const SoundID *id{m_sound_ids.get(filepath)};
+    return id == nullptr ? INVALID_SOUND_ID : *id;
+}
+
+void SoundBank::FinishLoad(Sound &sound)
+{
+    if (p_job_system != nullptr) {
+        p_job_system->Wait(*sound.p_counter); // Also covers a job that is done but still releasing the counter
+    }
+    sound.p_counter.reset();
+
+    if (sound.p_decoded->samples.empty() || !sound.sound.Upload(*sound.p_decoded)) {
+        ENGINE_LOG_ERROR("Failed to load sound effect: {}", sound.filepath);
+        sound.state = SoundState::Failed;
+    }
+    else {
+        ENGINE_LOG_DEBUG("Loaded sound effect: {}, format: {}", sound.filepath, FormatName(sound.p_decoded->format));
+        sound.state = SoundState::Loaded;
+    }
+    sound.p_decoded.reset(); // The samples live in the buffer now
+}
+
+} // namespace gouda::audio
@@ -23,7 +23,10 @@ SoundEffect::SoundEffect() : m_buffer{0}
 
 SoundEffect::~SoundEffect() { alDeleteBuffers(1, &m_buffer); }
 
-SoundEffect::SoundEffect(SoundEffect &&other) noexcept : m_buffer{other.m_buffer} { other.m_buffer = 0; }
+SoundEffect::SoundEffect(SoundEffect &&other) noexcept : m_buffer{other.m_buffer}, m_throttle{other.m_throttle}
+{
+    other.m_buffer = 0;
+}
 
 SoundEffect &SoundEffect::operator=(SoundEffect &&other) noexcept
 {
@@ -35,15 +38,14 @@ SoundEffect &SoundEffect::operator=(SoundEffect &&other) noexcept
 
         // Move ownership
         m_buffer = other.m_buffer;
+        m_throttle = other.m_throttle;
         other.m_buffer = 0; // Reset other
     }
     return *this;
 }
 
-bool SoundEffect::Load(std::string_view filepath)
+bool DecodeSound(std::string_view filepath, const bool supports_float, DecodedSound &decoded)
 {
-    ENGINE_LOG_DEBUG("Attempting to load sound effect: {}", filepath);
-
     if (filepath.empty()) {
         ENGINE_LOG_ERROR("Empty filename provided");
         return false;
@@ -54,12 +56,6 @@ bool SoundEffect::Load(std::string_view filepath)
         return false;
     }
 
-    if (m_buffer) {
-        alDeleteBuffers(1, &m_buffer);
-        m_buffer = 0;
-    }
-
-    ALenum format;
     SF_INFO sfinfo;
     SNDFILE *p_sndfile{sf_open(filepath.data(), SFM_READ, &sfinfo)};
     if (!p_sndfile) {
@@ -67,11 +63,6 @@ bool SoundEffect::Load(std::string_view filepath)
         return false;
     }
 
-    if (!alcGetCurrentContext()) {
-        ENGINE_LOG_ERROR("No OpenAL context current before buffer creation");
-        return HandleError(p_sndfile);
-    }
-
     ENGINE_LOG_DEBUG("File info: frames={}, channels={}, samplerate={}, format={:x}", sfinfo.frames, sfinfo.channels,
                      sfinfo.samplerate, sfinfo.format);
 
@@ -92,7 +83,7 @@ bool SoundEffect::Load(std::string_view filepath)
              (sfinfo.format & SF_FORMAT_SUBMASK) == SF_FORMAT_OPUS ||
              (sfinfo.format & SF_FORMAT_SUBMASK) == SF_FORMAT_MPEG_LAYER_III) {
         // Float format
-        if (alIsExtensionPresent("AL_EXT_FLOAT32")) {
+        if (supports_float) {
             is_float_format = true;
         }
         else {
@@ -107,10 +98,10 @@ bool SoundEffect::Load(std::string_view filepath)
 
     // Determine the OpenAL format based on channels and sample format
     if (sfinfo.channels == 1) {
-        format = is_float_format ? AL_FORMAT_MONO_FLOAT32 : AL_FORMAT_MONO16;
+        decoded.format = is_float_format ? AL_FORMAT_MONO_FLOAT32 : AL_FORMAT_MONO16;
     }
     else if (sfinfo.channels == 2) {
-        format = is_float_format ? AL_FORMAT_STEREO_FLOAT32 : AL_FORMAT_STEREO16;
+        decoded.format = is_float_format ? AL_FORMAT_STEREO_FLOAT32 : AL_FORMAT_STEREO16;
     }
     else {
         ENGINE_LOG_ERROR("Unsupported channel count: {}", sfinfo.channels);
@@ -121,42 +112,74 @@ bool SoundEffect::Load(std::string_view filepath)
     size_t alloc_size{static_cast<size_t>(sfinfo.frames) * sfinfo.channels * sample_size};
     ENGINE_LOG_DEBUG("Allocating {} bytes ({}kb) for audio data", alloc_size, math::bytes_to_kb(alloc_size));
 
-    auto membuf{std::unique_ptr<void, void (*)(void *)>(malloc(alloc_size), free)};
-    if (!membuf) {
-        ENGINE_LOG_ERROR("Memory allocation failed for audio buffer (size: {})", alloc_size);
-        return HandleError(p_sndfile);
-    }
+    decoded.samples.resize(alloc_size);
 
     sf_count_t num_frames = 0;
     if (is_float_format) {
-        num_frames = sf_readf_float(p_sndfile, static_cast<f32 *>(membuf.get()), sfinfo.frames);
+        num_frames = sf_readf_float(p_sndfile, reinterpret_cast<f32 *>(decoded.samples.data()), sfinfo.frames);
     }
     else {
-        num_frames = sf_readf_short(p_sndfile, static_cast<short *>(membuf.get()), sfinfo.frames);
+        num_frames = sf_readf_short(p_sndfile, reinterpret_cast<short *>(decoded.samples.data()), sfinfo.frames);
     }
 
     if (num_frames < 1) {
         ENGINE_LOG_ERROR("Failed to read samples in {} ({} frames returned)", filepath, num_frames);
+        decoded.samples.clear();
         return HandleError(p_sndfile);
     }
 
-    ALsizei num_bytes = static_cast<ALsizei>(num_frames * sfinfo.channels * sample_size);
+    const size_t num_bytes{static_cast<size_t>(num_frames) * sfinfo.channels * sample_size};
     ENGINE_LOG_DEBUG("Read {} frames, {} bytes ({}kb)", num_frames, num_bytes, math::bytes_to_kb(num_bytes));
 
+    decoded.samples.resize(num_bytes); // The file may hold fewer frames than its header claims
+    decoded.sample_rate = sfinfo.samplerate;
+
+    sf_close(p_sndfile);
+
+    return true;
+}
+
+bool SoundEffect::Load(std::string_view filepath)
+{
+    ENGINE_LOG_DEBUG("Attempting to load sound effect: {}", filepath);
+
+    if (!alcGetCurrentContext()) {
+        ENGINE_LOG_ERROR("No OpenAL context current before buffer creation");
+        return false;
+    }
+
+    DecodedSound decoded;
+    if (!DecodeSound(filepath, alIsExtensionPresent("AL_EXT_FLOAT32"), decoded)) {
+        return false;
+    }
+
+    if (!Upload(decoded)) {
+        return false;
+    }
+
+    ENGINE_LOG_DEBUG("Created sound effect from: {}, format: {}", filepath, FormatName(decoded.format));
+
+    return true;
+}
+
+bool SoundEffect::Upload(const DecodedSound &decoded)
+{
+    if (m_buffer) {
+        alDeleteBuffers(1, &m_buffer);
+        m_buffer = 0;
+    }
+
     alGenBuffers(1, &m_buffer);
-    alBufferData(m_buffer, format, membuf.get(), num_bytes, sfinfo.samplerate);
+    alBufferData(m_buffer, decoded.format, decoded.samples.data(), static_cast<ALsizei>(decoded.samples.size()),
+                 decoded.sample_rate);
 
     ALenum result{alGetError()};
     if (result != AL_NO_ERROR) {
         ENGINE_LOG_ERROR("OpenAL Error: {}", alGetString(result));
         alDeleteBuffers(1, &m_buffer);
         m_buffer = 0;
+        return false;
     }
-    else {
-        ENGINE_LOG_DEBUG("Created sound effect from: {}, format: {}", filepath, FormatName(format));
-    }
-
-    sf_close(p_sndfile);
 
     return true;
 }
@@ -0,0 +1,105 @@
+/**
+ * @file audio/voice_manager.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine sound effect voice allocation implementation
+ */
+#include "audio/voice_manager.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace gouda::audio {
+
+namespace internal {
+
+// Priority decides first, gain only breaks ties, so a whisper of an important sound beats a loud unimportant one
+static bool Outranks(const u8 priority, const f32 gain, const u8 other_priority, const f32 other_gain)
+{
+    return priority != other_priority ? priority > other_priority : gain > other_gain;
+}
+
+} // namespace internal
+
+void VoiceManager::AddSource(const ALuint source) { m_free_sources.push_back(source); }
+
+f32 VoiceManager::GetAudibleGain(const Voice &voice, const f32 master_volume) const
+{
+    const f32 gain{voice.volume * master_volume};
+    if (!voice.is_positional) {
+        return gain;
+    }
+
+    const f32 dx{voice.position.x - m_listener_position.x};
+    const f32 dy{voice.position.y - m_listener_position.y};
+    const f32 dz{voice.position.z - m_listener_position.z};
+    const f32 reference{m_settings.reference_distance};
+    const f32 distance{std::clamp(std::sqrt(dx * dx + dy * dy + dz * dz), reference, m_settings.max_distance)};
+
+    // AL_INVERSE_DISTANCE_CLAMPED, the model OpenAL uses unless told otherwise
+    const f32 falloff{reference + m_settings.rolloff_factor * (distance - reference)};
+    return falloff > 0.0f ? gain * reference / falloff : gain;
+}
+
+ALuint VoiceManager::Acquire(const Voice &voice, const f32 master_volume, bool &is_stolen)
+{
+    is_stolen = false;
+
+    const f32 gain{GetAudibleGain(voice, master_volume)};
+    if (gain < m_settings.min_audible_gain) {
+        ++m_culled_count;
+        return 0;
+    }
+
+    if (!m_free_sources.empty()) {
+        Voice &claimed{m_voices.emplace_back(voice)};
+        claimed.source = m_free_sources.back();
+        m_free_sources.pop_back();
+        return claimed.source;
+    }
+
+    // Gains are re-estimated since the listener may have moved since the voices started
+    Voice *weakest{nullptr};
+    f32 weakest_gain{0.0f};
+    for (Voice &candidate : m_voices) {
+        const f32 candidate_gain{GetAudibleGain(candidate, master_volume)};
+        if (weakest == nullptr ||
+            internal::Outranks(weakest->priority, weakest_gain, candidate.priority, candidate_gain)) {
+            weakest = &candidate;
+            weakest_gain = candidate_gain;
+        }
+    }
+
+    if (weakest == nullptr || !internal::Outranks(voice.priority, gain, weakest->priority, weakest_gain)) {
+        ++m_culled_count;
+        return 0;
+    }
+
+    const ALuint source{weakest->source};
+    *weakest = voice;
+    weakest->source = source;
+    is_stolen = true;
+    ++m_stolen_count;
+    return source;
+}
+
+void VoiceManager::Release(const ALuint source)
+{
+    const auto it{std::find_if(m_voices.begin(), m_voices.end(),
+                               [source](const Voice &voice) { return voice.source == source; })};
+    if (it == m_voices.end()) {
+        return;
+    }
+
+    *it = m_voices.back();
+    m_voices.pop_back();
+    m_free_sources.push_back(source);
+}
+
+size_t VoiceManager::CountVoices(const ALuint buffer) const
+{
+    return static_cast<size_t>(
+        std::ranges::count_if(m_voices, [buffer](const Voice &voice) { return voice.buffer == buffer; }));
+}
+
+} // namespace gouda::audio
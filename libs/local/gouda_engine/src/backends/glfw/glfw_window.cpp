@@ -98,8 +98,9 @@ Window::Window(const WindowConfig &config) : p_window{nullptr}
             break;
     }
 
-    // Set window resizable
+    // Set window resizable and visible
     glfwWindowHint(GLFW_RESIZABLE, config.resizable);
+    glfwWindowHint(GLFW_VISIBLE, config.visible);
 
     // Determine monitor for fullscreen mode
 
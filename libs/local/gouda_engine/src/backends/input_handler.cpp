@@ -7,6 +7,10 @@
 
 #include "backends/input_handler.hpp"
 
+#include <algorithm>
+#include <bit>
+#include <utility>
+
 #include "debug/logger.hpp"
 
 // TODO: Remove this!
@@ -18,6 +22,7 @@ namespace gouda {
 
 InputHandler::InputHandler(std::unique_ptr<InputBackend> backend, GLFWwindow *window)
     : p_backend(std::move(backend)),
+      p_active_bindings(nullptr),
       p_window(window),
       m_scroll_callback(nullptr),
       m_char_callback(nullptr),
@@ -26,8 +31,17 @@ InputHandler::InputHandler(std::unique_ptr<InputBackend> backend, GLFWwindow *wi
       m_frame_buffer_size_callback(nullptr),
       m_window_size_callback(nullptr),
       m_window_iconify_callback(nullptr),
+      m_active_state_id{NO_STATE},
+      m_held_counts{},
+      m_actions_down{0},
+      m_actions_pressed{0},
+      m_actions_released{0},
       m_mouse_position{0.0, 0.0},
-      m_window_size{0.0f, 0.0f}
+      m_window_size{0.0f, 0.0f},
+      m_frame_event_count{0},
+      m_mode{InputMode::Live},
+      m_replay_frame{0},
+      m_replay_frame_injected{false}
 {
     p_backend->RegisterCallbacks(p_window);
 
@@ -39,27 +53,91 @@ InputHandler::InputHandler(std::unique_ptr<InputBackend> backend, GLFWwindow *wi
 
 void InputHandler::LoadStateBindings(StringView state, const std::vector<ActionBinding> &bindings)
 {
-    m_bindings.erase(state.data());
-    m_bindings.emplace(state, bindings);
+    // Inserting can move every entry, so the active state's bindings are looked up again whichever state this is
+    m_bindings.insert_or_assign(InternedString{state}, bindings);
+    p_active_bindings = m_bindings.get(m_active_state);
     ENGINE_LOG_DEBUG("Loaded {} bindings for state '{}'", bindings.size(), state);
 }
 
-void InputHandler::UnloadStateBindings(const std::string &state)
+void InputHandler::UnloadStateBindings(const StringView state)
 {
-    m_bindings.erase(state);
+    m_bindings.erase(InternedString{state});
+    p_active_bindings = m_bindings.get(m_active_state);
     ENGINE_LOG_DEBUG("Unloaded bindings for state '{}'", state);
 }
 
-void InputHandler::SetActiveState(const std::string &state)
+void InputHandler::SetActiveState(const StringView state) { SetActiveState(InternState(state)); }
+
+InputHandler::StateID InputHandler::InternState(StringView state)
 {
-    m_active_state = state;
-    ApplyStateCallbacks(state); // Apply state-specific callbacks when switching states
-    ENGINE_LOG_DEBUG("Set active state to '{}'", state);
+    // The names compare as ids, the text is only hashed to intern it
+    const InternedString name{state};
+    if (const auto it{std::ranges::find(m_state_names, name)}; it != m_state_names.end()) {
+        return static_cast<StateID>(it - m_state_names.begin());
+    }
+
+    m_state_names.push_back(name);
+    m_action_tables.emplace_back(); // Value initialized, no input drives any action yet
+    return static_cast<StateID>(m_state_names.size() - 1);
 }
 
-void InputHandler::PushCustomEvent(const std::string &event) { m_events.emplace_back(event); }
+void InputHandler::BindAction(const StateID state, const ActionID action, const InputType input)
+{
+    if (state >= m_action_tables.size() || action >= MAX_ACTIONS) {
+        ENGINE_LOG_ERROR("Cannot bind action {} to state {}, {} states and {} actions exist.", action, state,
+                         m_action_tables.size(), MAX_ACTIONS);
+        return;
+    }
 
-void InputHandler::QueueEvent(const Event &event) { m_events.push_back(event); }
+    const size_t index{std::visit([](const auto value) { return input_index(value); }, input)};
+    if (index >= INPUT_COUNT) {
+        ENGINE_LOG_ERROR("Cannot bind action {} to input {}, it is out of range.", action, index);
+        return;
+    }
+
+    m_action_tables[state][index] |= ActionMask{1} << action;
+    if (state == m_active_state_id) {
+        RebuildActionSnapshot();
+    }
+}
+
+void InputHandler::UnbindActions(const StateID state)
+{
+    if (state >= m_action_tables.size()) {
+        return;
+    }
+
+    m_action_tables[state] = {};
+    if (state == m_active_state_id) {
+        RebuildActionSnapshot();
+    }
+}
+
+void InputHandler::SetActiveState(const StateID state)
+{
+    if (state >= m_state_names.size()) {
+        ENGINE_LOG_ERROR("Cannot activate state {}, only {} states are interned.", state, m_state_names.size());
+        return;
+    }
+
+    m_active_state_id = state;
+    m_active_state = m_state_names[state];
+    p_active_bindings = m_bindings.get(m_active_state);
+    RebuildActionSnapshot();
+
+    ApplyStateCallbacks(m_active_state); // Apply state-specific callbacks when switching states
+    ENGINE_LOG_DEBUG("Set active state to '{}'", m_active_state.GetView());
+}
+
+// Recorded as they are queued, so pumped events keep the time they arrived at rather than the next poll's
+void InputHandler::QueueEvent(const Event &event)
+{
+    const SteadyClock::time_point time{SteadyClock::now()};
+    if (m_mode == InputMode::Recording) {
+        m_recording.AddEvent(event, std::chrono::duration<f64>(time - m_recording_start).count());
+    }
+    m_events.push_back({event, time});
+}
 
 // Standard callback setters
 void InputHandler::SetScrollCallback(ScrollCallback callback) { m_scroll_callback = std::move(callback); }
@@ -89,59 +167,66 @@ void InputHandler::SetWindowIconifyCallback(WindowIconifyCallback callback)
 }
 
 // State-specific callback setters
-void InputHandler::SetStateScrollCallback(const std::string &state, ScrollCallback callback)
+void InputHandler::SetStateScrollCallback(const StringView state, ScrollCallback callback)
 {
-    m_state_scroll_callbacks[state] = std::move(callback);
-    if (m_active_state == state) {
-        m_scroll_callback = m_state_scroll_callbacks[state];
+    const InternedString name{state};
+    m_state_scroll_callbacks[name] = std::move(callback);
+    if (m_active_state == name) {
+        m_scroll_callback = m_state_scroll_callbacks[name];
     }
 }
 
-void InputHandler::SetStateCharCallback(const std::string &state, CharCallback callback)
+void InputHandler::SetStateCharCallback(const StringView state, CharCallback callback)
 {
-    m_state_char_callbacks[state] = std::move(callback);
-    if (m_active_state == state) {
-        m_char_callback = m_state_char_callbacks[state];
+    const InternedString name{state};
+    m_state_char_callbacks[name] = std::move(callback);
+    if (m_active_state == name) {
+        m_char_callback = m_state_char_callbacks[name];
     }
 }
 
-void InputHandler::SetStateCursorEnterCallback(const std::string &state, CursorEnterCallback callback)
+void InputHandler::SetStateCursorEnterCallback(const StringView state, CursorEnterCallback callback)
 {
-    m_state_cursor_enter_callbacks[state] = std::move(callback);
-    if (m_active_state == state) {
-        m_cursor_enter_callback = m_state_cursor_enter_callbacks[state];
+    const InternedString name{state};
+    m_state_cursor_enter_callbacks[name] = std::move(callback);
+    if (m_active_state == name) {
+        m_cursor_enter_callback = m_state_cursor_enter_callbacks[name];
     }
 }
 
-void InputHandler::SetStateWindowFocusCallback(const std::string &state, WindowFocusCallback callback)
+void InputHandler::SetStateWindowFocusCallback(const StringView state, WindowFocusCallback callback)
 {
-    m_state_window_focus_callbacks[state] = std::move(callback);
-    if (m_active_state == state) {
-        m_window_focus_callback = m_state_window_focus_callbacks[state];
+    const InternedString name{state};
+    m_state_window_focus_callbacks[name] = std::move(callback);
+    if (m_active_state == name) {
+        m_window_focus_callback = m_state_window_focus_callbacks[name];
     }
 }
 
-void InputHandler::SetStateFramebufferSizeCallback(const std::string &state, FramebufferSizeCallback callback)
+void InputHandler::SetStateFramebufferSizeCallback(const StringView state, FramebufferSizeCallback callback)
 {
-    m_state_framebuffer_size_callbacks[state] = std::move(callback);
-    if (m_active_state == state) {
-        m_frame_buffer_size_callback = m_state_framebuffer_size_callbacks[state];
+    const InternedString name{state};
+    m_state_framebuffer_size_callbacks[name] = std::move(callback);
+    if (m_active_state == name) {
+        m_frame_buffer_size_callback = m_state_framebuffer_size_callbacks[name];
     }
 }
 
-void InputHandler::SetStateWindowSizeCallback(const std::string &state, WindowSizeCallback callback)
+void InputHandler::SetStateWindowSizeCallback(const StringView state, WindowSizeCallback callback)
 {
-    m_state_window_size_callbacks[state] = std::move(callback);
-    if (m_active_state == state) {
-        m_window_size_callback = m_state_window_size_callbacks[state];
+    const InternedString name{state};
+    m_state_window_size_callbacks[name] = std::move(callback);
+    if (m_active_state == name) {
+        m_window_size_callback = m_state_window_size_callbacks[name];
     }
 }
 
-void InputHandler::SetStateWindowIconifyCallback(const std::string &state, WindowIconifyCallback callback)
+void InputHandler::SetStateWindowIconifyCallback(const StringView state, WindowIconifyCallback callback)
 {
-    m_state_window_iconify_callbacks[state] = std::move(callback);
-    if (m_active_state == state) {
-        m_window_iconify_callback = m_state_window_iconify_callbacks[state];
+    const InternedString name{state};
+    m_state_window_iconify_callbacks[name] = std::move(callback);
+    if (m_active_state == name) {
+        m_window_iconify_callback = m_state_window_iconify_callbacks[name];
     }
 }
 
@@ -190,14 +275,14 @@ void InputHandler::ClearWindowIconifyCallback()
 
 bool InputHandler::IsKeyPressed(const Key key) const
 {
-    const auto it = m_key_states.find(key);
-    return it != m_key_states.end() ? it->second : false;
+    const size_t index{input_index(key)};
+    return index < INPUT_COUNT && m_held_inputs.test(index);
 }
 
 bool InputHandler::IsMouseButtonPressed(const MouseButton button) const
 {
-    const auto it = m_mouse_states.find(button);
-    return it != m_mouse_states.end() ? it->second : false;
+    const size_t index{input_index(button)};
+    return index < INPUT_COUNT && m_held_inputs.test(index);
 }
 
 std::pair<double, double> InputHandler::GetMousePosition() const { return {m_mouse_position.x, m_mouse_position.y}; }
@@ -208,112 +293,262 @@ Vec2 InputHandler::GetMousePositionFloat() const
 }
 
 void InputHandler::Update()
+{
+    PollEvents();
+    DispatchEvents();
+}
+
+void InputHandler::PollEvents()
 {
     p_backend->PollEvents();
-    ProcessEvents();
-}
-
-void InputHandler::ProcessEvents()
-{
-    for (auto &event : m_events) {
-        std::visit(
-            [this](auto &&arg) {
-                using T = std::decay_t<decltype(arg)>;
-                if constexpr (std::is_same_v<T, KeyEvent>) {
-                    // ENGINE_LOG_DEBUG("Processing KeyEvent: key={}, state={}", static_cast<int>(arg.key),
-                    //                 static_cast<int>(arg.state));
-                    m_key_states[arg.key] = (arg.state != ActionState::Released);
-                    if (auto it = m_bindings.find(m_active_state); it != m_bindings.end()) {
-                        for (const auto &binding : it->second) {
-                            if (auto *key = std::get_if<Key>(&binding.input)) {
-                                if (*key == arg.key && binding.trigger_state == arg.state) {
-                                    // ENGINE_LOG_DEBUG("Triggering Key binding: key={}", static_cast<int>(*key));
-                                    binding.callback();
-                                }
+
+    if (m_mode == InputMode::Replaying) {
+        ReplayEvents();
+    }
+}
+
+void InputHandler::PumpEvents() { p_backend->PollEvents(); }
+
+void InputHandler::DispatchEvents(const SteadyClock::time_point until)
+{
+    // Callbacks may queue events while they run, so the queue is indexed rather than iterated
+    size_t dispatched{0};
+    while (dispatched < m_events.size() && m_events[dispatched].time <= until) {
+        const Event event{std::move(m_events[dispatched].event)};
+        ++dispatched;
+        ProcessEvent(event);
+    }
+    m_events.erase(m_events.begin(), m_events.begin() + static_cast<std::ptrdiff_t>(dispatched));
+}
+
+void InputHandler::StartRecording(const f32 fixed_timestep)
+{
+    m_recording = InputRecording{fixed_timestep};
+    m_recording_start = SteadyClock::now();
+    m_mode = InputMode::Recording;
+
+    // Replays start from wherever the live cursor is, so the first frame puts it where it was when recording began
+    m_recording.AddEvent(MouseMoveEvent{m_mouse_position.x, m_mouse_position.y}, 0.0);
+    ENGINE_LOG_INFO("Started recording input");
+}
+
+InputRecording InputHandler::StopRecording()
+{
+    if (m_mode == InputMode::Replaying) {
+        ReleaseHeldInput();
+    }
+
+    m_mode = InputMode::Live;
+    return std::exchange(m_recording, InputRecording{});
+}
+
+void InputHandler::StartReplay(InputRecording recording)
+{
+    m_recording = std::move(recording);
+    m_replay_frame = 0;
+    m_replay_frame_injected = false;
+    m_mode = InputMode::Replaying;
+
+    ReleaseHeldInput();
+    ENGINE_LOG_INFO("Replaying {} frames of input", m_recording.GetFrameCount());
+}
+
+void InputHandler::EndFrame(const f32 delta_time, const u32 tick_count)
+{
+    m_actions_pressed = 0;
+    m_actions_released = 0;
+    m_frame_event_count = 0;
+
+    if (m_mode == InputMode::Recording) {
+        m_recording.EndFrame(delta_time, tick_count);
+    }
+    else if (m_mode == InputMode::Replaying && m_replay_frame < m_recording.GetFrameCount()) {
+        ++m_replay_frame;
+        m_replay_frame_injected = false;
+    }
+}
+
+const RecordedFrame *InputHandler::GetReplayFrame() const noexcept
+{
+    if (m_mode != InputMode::Replaying || m_replay_frame >= m_recording.GetFrameCount()) {
+        return nullptr;
+    }
+    return &m_recording.GetFrames()[m_replay_frame];
+}
+
+bool InputHandler::IsReplayFinished() const noexcept
+{
+    return m_mode == InputMode::Replaying && m_replay_frame >= m_recording.GetFrameCount();
+}
+
+void InputHandler::ReplayEvents()
+{
+    // The live input is dropped for the whole replay, even after the last frame, so nothing but the recording drives it
+    std::erase_if(m_events, [](const TimedEvent &queued) { return InputRecording::IsRecordedEvent(queued.event); });
+
+    const RecordedFrame *frame{GetReplayFrame()};
+    if (frame == nullptr || m_replay_frame_injected) {
+        return;
+    }
+
+    const SteadyClock::time_point now{SteadyClock::now()};
+    for (const RecordedEvent &recorded : m_recording.GetEvents(*frame)) {
+        m_events.push_back({recorded.event, now});
+    }
+    m_replay_frame_injected = true;
+}
+
+// Bindings are not fired, the input goes away without a release reaching the states
+void InputHandler::ReleaseHeldInput()
+{
+    m_held_inputs.reset();
+    RebuildActionSnapshot();
+}
+
+// Counting the held inputs behind each action keeps it down until the last of them is released
+void InputHandler::SetInputHeld(const size_t input, const bool held)
+{
+    if (input >= INPUT_COUNT || m_held_inputs.test(input) == held) {
+        return; // Repeats change nothing
+    }
+    m_held_inputs.set(input, held);
+
+    if (m_active_state_id == NO_STATE) {
+        return;
+    }
+
+    for (ActionMask actions{m_action_tables[m_active_state_id][input]}; actions != 0; actions &= actions - 1) {
+        const int action{std::countr_zero(actions)};
+        const ActionMask bit{ActionMask{1} << action};
+        if (held && m_held_counts[action]++ == 0) {
+            m_actions_down |= bit;
+            m_actions_pressed |= bit;
+        }
+        else if (!held && --m_held_counts[action] == 0) {
+            m_actions_down &= ~bit;
+            m_actions_released |= bit;
+        }
+    }
+}
+
+// Inputs already held when the table changes count as down with no press, the same as a held key across a state change
+void InputHandler::RebuildActionSnapshot()
+{
+    m_held_counts.fill(0);
+    m_actions_down = 0;
+    if (m_active_state_id == NO_STATE) {
+        return;
+    }
+
+    const ActionTable &table{m_action_tables[m_active_state_id]};
+    for (size_t input = 0; input < INPUT_COUNT; ++input) {
+        if (!m_held_inputs.test(input)) {
+            continue;
+        }
+        for (ActionMask actions{table[input]}; actions != 0; actions &= actions - 1) {
+            const int action{std::countr_zero(actions)};
+            ++m_held_counts[action];
+            m_actions_down |= ActionMask{1} << action;
+        }
+    }
+}
+
+void InputHandler::ProcessEvent(const Event &event)
+{
+    ++m_frame_event_count;
+    std::visit(
+        [this](auto &&arg) {
+            using T = std::decay_t<decltype(arg)>;
+            if constexpr (std::is_same_v<T, KeyEvent>) {
+                // ENGINE_LOG_DEBUG("Processing KeyEvent: key={}, state={}", static_cast<int>(arg.key),
+                //                 static_cast<int>(arg.state));
+                SetInputHeld(input_index(arg.key), arg.state != ActionState::Released);
+                if (p_active_bindings) {
+                    for (const auto &binding : *p_active_bindings) {
+                        if (auto *key = std::get_if<Key>(&binding.input)) {
+                            if (*key == arg.key && binding.trigger_state == arg.state) {
+                                // ENGINE_LOG_DEBUG("Triggering Key binding: key={}", static_cast<int>(*key));
+                                binding.callback();
                             }
                         }
                     }
                 }
-                else if constexpr (std::is_same_v<T, MouseButtonEvent>) {
-                    // ENGINE_LOG_DEBUG("Processing MouseButtonEvent: button={}, state={}",
-                    // static_cast<int>(arg.button),
-                    //                  static_cast<int>(arg.state));
-                    m_mouse_states[arg.button] = (arg.state != ActionState::Released);
-                    if (auto it = m_bindings.find(m_active_state); it != m_bindings.end()) {
-                        for (const auto &binding : it->second) {
-                            if (auto *button = std::get_if<MouseButton>(&binding.input)) {
-                                if (*button == arg.button && binding.trigger_state == arg.state) {
-                                    // ENGINE_LOG_DEBUG("Triggering Mouse binding: button={}",
-                                    // static_cast<int>(*button));
-                                    binding.callback();
-                                }
+            }
+            else if constexpr (std::is_same_v<T, MouseButtonEvent>) {
+                // ENGINE_LOG_DEBUG("Processing MouseButtonEvent: button={}, state={}",
+                // static_cast<int>(arg.button),
+                //                  static_cast<int>(arg.state));
+                SetInputHeld(input_index(arg.button), arg.state != ActionState::Released);
+                if (p_active_bindings) {
+                    for (const auto &binding : *p_active_bindings) {
+                        if (auto *button = std::get_if<MouseButton>(&binding.input)) {
+                            if (*button == arg.button && binding.trigger_state == arg.state) {
+                                // ENGINE_LOG_DEBUG("Triggering Mouse binding: button={}",
+                                // static_cast<int>(*button));
+                                binding.callback();
                             }
                         }
                     }
                 }
-                else if constexpr (std::is_same_v<T, MouseScrollEvent>) {
-                    // APP_LOG_DEBUG("Processing MouseScrollEvent: xOffset={}, yOffset={}", arg.xOffset, arg.yOffset);
-                    if (m_scroll_callback) {
-                        m_scroll_callback(arg.xOffset, arg.yOffset);
-                    }
-                }
-                else if constexpr (std::is_same_v<T, MouseMoveEvent>) {
-                    m_mouse_position.x = arg.x;
-                    m_mouse_position.y = arg.y;
-                }
-                else if constexpr (std::is_same_v<T, CharEvent>) {
-                    // APP_LOG_DEBUG("Processing CharEvent: codepoint={}", arg.codepoint);
-                    if (m_char_callback) {
-                        m_char_callback(arg.codepoint);
-                    }
-                }
-                else if constexpr (std::is_same_v<T, CursorEnterEvent>) {
-                    // APP_LOG_DEBUG("Processing CursorEnterEvent: entered={}", arg.entered);
-                    if (m_cursor_enter_callback) {
-                        m_cursor_enter_callback(arg.entered);
-                    }
+            }
+            else if constexpr (std::is_same_v<T, MouseScrollEvent>) {
+                // APP_LOG_DEBUG("Processing MouseScrollEvent: xOffset={}, yOffset={}", arg.xOffset, arg.yOffset);
+                if (m_scroll_callback) {
+                    m_scroll_callback(arg.xOffset, arg.yOffset);
                 }
-                else if constexpr (std::is_same_v<T, WindowFocusEvent>) {
-                    // APP_LOG_DEBUG("Processing WindowFocusEvent: focused={}", arg.focused);
-                    if (m_window_focus_callback) {
-                        m_window_focus_callback(arg.focused);
-                    }
+            }
+            else if constexpr (std::is_same_v<T, MouseMoveEvent>) {
+                m_mouse_position.x = arg.x;
+                m_mouse_position.y = arg.y;
+            }
+            else if constexpr (std::is_same_v<T, CharEvent>) {
+                // APP_LOG_DEBUG("Processing CharEvent: codepoint={}", arg.codepoint);
+                if (m_char_callback) {
+                    m_char_callback(arg.codepoint);
                 }
-                else if constexpr (std::is_same_v<T, WindowFramebufferSizeEvent>) {
-                    // APP_LOG_DEBUG("Processing WindowFramebufferSizeEvent: width={}, height={}", arg.width,
-                    // arg.height);
-                    m_window_size.x = arg.width;
-                    m_window_size.y = arg.height;
-
-                    if (m_frame_buffer_size_callback) {
-                        m_frame_buffer_size_callback(arg.width, arg.height);
-                    }
+            }
+            else if constexpr (std::is_same_v<T, CursorEnterEvent>) {
+                // APP_LOG_DEBUG("Processing CursorEnterEvent: entered={}", arg.entered);
+                if (m_cursor_enter_callback) {
+                    m_cursor_enter_callback(arg.entered);
                 }
-                else if constexpr (std::is_same_v<T, WindowSizeEvent>) {
-                    // APP_LOG_DEBUG("Processing WindowSizeEvent: width={}, height={}", arg.width, arg.height);
-                    if (m_window_size_callback) {
-                        m_window_size_callback(arg.width, arg.height);
-                    }
+            }
+            else if constexpr (std::is_same_v<T, WindowFocusEvent>) {
+                // APP_LOG_DEBUG("Processing WindowFocusEvent: focused={}", arg.focused);
+                if (m_window_focus_callback) {
+                    m_window_focus_callback(arg.focused);
                 }
-                else if constexpr (std::is_same_v<T, WindowIconifyEvent>) {
-                    // APP_LOG_DEBUG("Processing WindowIconifyEvent: iconified={}", arg.iconified);
-                    if (m_window_iconify_callback) {
-                        m_window_iconify_callback(arg.iconified);
-                    }
+            }
+            else if constexpr (std::is_same_v<T, WindowFramebufferSizeEvent>) {
+                // APP_LOG_DEBUG("Processing WindowFramebufferSizeEvent: width={}, height={}", arg.width,
+                // arg.height);
+                m_window_size.x = arg.width;
+                m_window_size.y = arg.height;
+
+                if (m_frame_buffer_size_callback) {
+                    m_frame_buffer_size_callback(arg.width, arg.height);
                 }
-                else if constexpr (std::is_same_v<T, WindowCloseEvent>) {
-                    // APP_LOG_DEBUG("WindowCloseEvent received");
+            }
+            else if constexpr (std::is_same_v<T, WindowSizeEvent>) {
+                // APP_LOG_DEBUG("Processing WindowSizeEvent: width={}, height={}", arg.width, arg.height);
+                if (m_window_size_callback) {
+                    m_window_size_callback(arg.width, arg.height);
                 }
-                else if constexpr (std::is_same_v<T, std::string>) {
-                    // APP_LOG_DEBUG("Custom event: {}", arg);
+            }
+            else if constexpr (std::is_same_v<T, WindowIconifyEvent>) {
+                // APP_LOG_DEBUG("Processing WindowIconifyEvent: iconified={}", arg.iconified);
+                if (m_window_iconify_callback) {
+                    m_window_iconify_callback(arg.iconified);
                 }
-            },
-            event);
-    }
-    m_events.clear();
+            }
+            else if constexpr (std::is_same_v<T, WindowCloseEvent>) {
+                // APP_LOG_DEBUG("WindowCloseEvent received");
+            }
+        },
+        event);
 }
 
-void InputHandler::ApplyStateCallbacks(const std::string &state)
+void InputHandler::ApplyStateCallbacks(const InternedString state)
 {
     if (auto it = m_state_scroll_callbacks.find(state); it != m_state_scroll_callbacks.end())
         m_scroll_callback = it->second;
@@ -329,7 +564,7 @@ void InputHandler::ApplyStateCallbacks(const std::string &state)
         m_window_size_callback = it->second;
     if (auto it = m_state_window_iconify_callbacks.find(state); it != m_state_window_iconify_callbacks.end())
         m_window_iconify_callback = it->second;
-    ENGINE_LOG_DEBUG("Applied state-specific callbacks for '{}'", state);
+    ENGINE_LOG_DEBUG("Applied state-specific callbacks for '{}'", state.GetView());
 }
 
 } // namespace gouda
\ No newline at end of file
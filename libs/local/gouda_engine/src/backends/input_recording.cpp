@@ -0,0 +1,253 @@
+/**
+ * @file backends/input_recording.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine input and frame timing recordings implementation
+ */
+#include "backends/input_recording.hpp"
+
+#include <array>
+#include <cstring>
+#include <type_traits>
+
+#include "debug/logger.hpp"
+#include "utils/filesystem.hpp"
+
+namespace gouda {
+
+namespace internal {
+
+constexpr std::array<char, 4> INPUT_RECORDING_MAGIC{'G', 'I', 'N', 'P'};
+
+enum class RecordedEventType : u32 { Key = 0, MouseButton, MouseMove, MouseScroll, Char, CursorEnter };
+
+struct InputRecordingHeader {
+    std::array<char, 4> magic;
+    u32 version;
+    u32 frame_count;
+    u32 event_count;
+    f32 fixed_timestep;
+    u32 reserved;
+};
+
+// An event as it is stored, the fields each type uses are those it is written with in to_record
+struct EventRecord {
+    f64 time;
+    f64 x;
+    f64 y;
+    u32 type;
+    s32 code;
+    s32 state;
+    s32 mods;
+};
+
+static_assert(std::is_trivially_copyable_v<RecordedFrame> && std::is_trivially_copyable_v<EventRecord>);
+
+static EventRecord to_record(const RecordedEvent &recorded)
+{
+    EventRecord record{recorded.time, 0.0, 0.0, 0, 0, 0, 0};
+    std::visit(
+        [&record](const auto &event) {
+            using T = std::decay_t<decltype(event)>;
+            if constexpr (std::is_same_v<T, KeyEvent>) {
+                record.type = static_cast<u32>(RecordedEventType::Key);
+                record.code = static_cast<s32>(event.key);
+                record.state = static_cast<s32>(event.state);
+                record.mods = event.mods;
+            }
+            else if constexpr (std::is_same_v<T, MouseButtonEvent>) {
+                record.type = static_cast<u32>(RecordedEventType::MouseButton);
+                record.code = static_cast<s32>(event.button);
+                record.state = static_cast<s32>(event.state);
+                record.mods = event.mods;
+            }
+            else if constexpr (std::is_same_v<T, MouseMoveEvent>) {
+                record.type = static_cast<u32>(RecordedEventType::MouseMove);
+                record.x = event.x;
+                record.y = event.y;
+            }
+            else if constexpr (std::is_same_v<T, MouseScrollEvent>) {
+                record.type = static_cast<u32>(RecordedEventType::MouseScroll);
+                record.x = event.xOffset;
+                record.y = event.yOffset;
+            }
+            else if constexpr (std::is_same_v<T, CharEvent>) {
+                record.type = static_cast<u32>(RecordedEventType::Char);
+                record.code = static_cast<s32>(event.codepoint);
+            }
+            else if constexpr (std::is_same_v<T, CursorEnterEvent>) {
+                record.type = static_cast<u32>(RecordedEventType::CursorEnter);
+                record.code = event.entered ? 1 : 0;
+            }
+        },
+        recorded.event);
+    return record;
+}
+
+static std::optional<RecordedEvent> from_record(const EventRecord &record)
+{
+    if (record.state < 0 || record.state > static_cast<s32>(ActionState::Repeated)) {
+        return std::nullopt;
+    }
+    const ActionState state{static_cast<ActionState>(record.state)};
+
+    switch (static_cast<RecordedEventType>(record.type)) {
+        case RecordedEventType::Key:
+            return RecordedEvent{KeyEvent{static_cast<Key>(record.code), state, record.mods}, record.time};
+        case RecordedEventType::MouseButton:
+            return RecordedEvent{MouseButtonEvent{static_cast<MouseButton>(record.code), state, record.mods},
+                                 record.time};
+        case RecordedEventType::MouseMove:
+            return RecordedEvent{MouseMoveEvent{record.x, record.y}, record.time};
+        case RecordedEventType::MouseScroll:
+            return RecordedEvent{MouseScrollEvent{record.x, record.y}, record.time};
+        case RecordedEventType::Char:
+            return RecordedEvent{CharEvent{static_cast<unsigned int>(record.code)}, record.time};
+        case RecordedEventType::CursorEnter:
+            return RecordedEvent{CursorEnterEvent{record.code != 0}, record.time};
+    }
+    return std::nullopt;
+}
+
+} // namespace internal
+
+InputRecording::InputRecording(const f32 fixed_timestep) : m_fixed_timestep{fixed_timestep}, m_frame_first_event{0} {}
+
+bool InputRecording::IsRecordedEvent(const Event &event) noexcept
+{
+    return std::holds_alternative<KeyEvent>(event) || std::holds_alternative<MouseButtonEvent>(event) ||
+           std::holds_alternative<MouseMoveEvent>(event) || std::holds_alternative<MouseScrollEvent>(event) ||
+           std::holds_alternative<CharEvent>(event) || std::holds_alternative<CursorEnterEvent>(event);
+}
+
+void InputRecording::AddEvent(const Event &event, const f64 time)
+{
+    if (IsRecordedEvent(event)) {
+        m_events.push_back({event, time});
+    }
+}
+
+void InputRecording::EndFrame(const f32 delta_time, const u32 tick_count)
+{
+    const u32 event_count{static_cast<u32>(m_events.size()) - m_frame_first_event};
+    m_frames.push_back({delta_time, tick_count, m_frame_first_event, event_count});
+    m_frame_first_event = static_cast<u32>(m_events.size());
+}
+
+void InputRecording::Clear()
+{
+    m_frames.clear();
+    m_events.clear();
+    m_frame_first_event = 0;
+}
+
+std::span<const RecordedEvent> InputRecording::GetEvents(const RecordedFrame &frame) const noexcept
+{
+    return std::span<const RecordedEvent>{m_events}.subspan(frame.first_event, frame.event_count);
+}
+
+bool InputRecording::Save(StringView filepath) const
+{
+    // Events of a frame never closed are left out, a replay has no timing to run them with
+    const size_t event_count{m_frame_first_event};
+    const size_t frames_size{m_frames.size() * sizeof(RecordedFrame)};
+
+    std::vector<std::byte> bytes(sizeof(internal::InputRecordingHeader) + frames_size +
+                                 event_count * sizeof(internal::EventRecord));
+
+    const internal::InputRecordingHeader header{internal::INPUT_RECORDING_MAGIC, INPUT_RECORDING_VERSION,
+                                                static_cast<u32>(m_frames.size()), static_cast<u32>(event_count),
+                                                m_fixed_timestep, 0};
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    if (!m_frames.empty()) {
+        std::memcpy(bytes.data() + sizeof(header), m_frames.data(), frames_size);
+    }
+
+    std::byte *events{bytes.data() + sizeof(header) + frames_size};
+    for (size_t i = 0; i < event_count; ++i) {
+        const internal::EventRecord record{internal::to_record(m_events[i])};
+        std::memcpy(events + i * sizeof(record), &record, sizeof(record));
+    }
+
+    if (const auto result{fs::WriteBinaryFile(filepath, bytes)}; !result) {
+        ENGINE_LOG_ERROR("Failed to write input recording '{}': {}", filepath, fs::error_to_string(result.error()));
+        return false;
+    }
+
+    ENGINE_LOG_INFO("Saved input recording '{}': {} frames, {} events", filepath, m_frames.size(), event_count);
+    return true;
+}
+
+std::optional<InputRecording> InputRecording::Load(StringView filepath)
+{
+    const auto bytes{fs::ReadBinaryFile(filepath)};
+    if (!bytes) {
+        ENGINE_LOG_ERROR("Failed to read input recording '{}': {}", filepath, fs::error_to_string(bytes.error()));
+        return std::nullopt;
+    }
+
+    internal::InputRecordingHeader header;
+    if (bytes->size() < sizeof(header)) {
+        ENGINE_LOG_ERROR("Input recording '{}' is truncated.", filepath);
+        return std::nullopt;
+    }
+
+    std::memcpy(&header, bytes->data(), sizeof(header));
+    if (header.magic != internal::INPUT_RECORDING_MAGIC) {
+        ENGINE_LOG_ERROR("'{}' is not an input recording.", filepath);
+        return std::nullopt;
+    }
+    if (header.version != INPUT_RECORDING_VERSION) {
+        ENGINE_LOG_ERROR("Input recording '{}' is version {}, expected {}.", filepath, header.version,
+                         INPUT_RECORDING_VERSION);
+        return std::nullopt;
+    }
+
+    const size_t frames_size{static_cast<size_t>(header.frame_count) * sizeof(RecordedFrame)};
+    const size_t events_size{static_cast<size_t>(header.event_count) * sizeof(internal::EventRecord)};
+    if (bytes->size() != sizeof(header) + frames_size + events_size) {
+        ENGINE_LOG_ERROR("Input recording '{}' does not match its header.", filepath);
+        return std::nullopt;
+    }
+
+    InputRecording recording{header.fixed_timestep};
+    recording.m_frames.resize(header.frame_count);
+    if (header.frame_count > 0) {
+        std::memcpy(recording.m_frames.data(), bytes->data() + sizeof(header), frames_size);
+    }
+
+    // Frames have to cover the events in order, each starting where the previous one ended
+    u32 next_event{0};
+    for (const RecordedFrame &frame : recording.m_frames) {
+        if (frame.first_event != next_event || frame.event_count > header.event_count - next_event) {
+            ENGINE_LOG_ERROR("Input recording '{}' has frames out of order.", filepath);
+            return std::nullopt;
+        }
+        next_event += frame.event_count;
+    }
+    if (next_event != header.event_count) {
+        ENGINE_LOG_ERROR("Input recording '{}' has events outside its frames.", filepath);
+        return std::nullopt;
+    }
+
+    recording.m_events.reserve(header.event_count);
+    const std::byte *events{bytes->data() + sizeof(header) + frames_size};
+    for (size_t i = 0; i < header.event_count; ++i) {
+        internal::EventRecord record;
+        std::memcpy(&record, events + i * sizeof(record), sizeof(record));
+
+        std::optional<RecordedEvent> event{internal::from_record(record)};
+        if (!event) {
+            ENGINE_LOG_ERROR("Input recording '{}' has an unknown event.", filepath);
+            return std::nullopt;
+        }
+        recording.m_events.push_back(std::move(*event));
+    }
+    recording.m_frame_first_event = header.event_count;
+
+    ENGINE_LOG_INFO("Loaded input recording '{}': {} frames, {} events", filepath, header.frame_count,
+                    header.event_count);
+    return recording;
+}
+
+} // namespace gouda
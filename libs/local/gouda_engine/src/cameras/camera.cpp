@@ -6,30 +6,39 @@
  */
 #include "cameras/camera.hpp"
 
+#include <cmath>
+
 #include "debug/logger.hpp"
+#include "math/noise.hpp"
+#include "math/random.hpp"
 
 namespace gouda {
 
+// Noise cells a second a shake passes through, and the seconds after which its time wraps to stay precise
+constexpr f32 SHAKE_FREQUENCY{25.0f};
+constexpr f32 SHAKE_TIME_WRAP{256.0f};
+
 Camera::Camera(const f32 speed, const f32 sensitivity)
     : m_speed{speed},
       m_sensitivity{sensitivity},
       m_movement_flags(CameraMovement::None),
       m_is_dirty{true},
+      m_version{1},
       m_shake_intensity{0.0f},
       m_shake_duration{0.0f},
+      m_shake_time{0.0f},
+      m_shake_seed{math::GenerateSeed()},
       m_sway_amplitude{0.0f},
       m_sway_frequency{0.0f},
       m_sway_time{0.0f},
       p_follow_target{nullptr},
-      m_follow_speed{0.0f},
-      m_rng{math::GenerateSeed()}
+      m_follow_speed{0.0f}
 {
 }
 
 void Camera::SetMovementFlag(CameraMovement flag)
 {
-    m_movement_flags |= flag;
-    m_is_dirty = true;
+    m_movement_flags |= flag; // Update applies the movement and marks the change
 }
 
 void Camera::ClearMovementFlag(CameraMovement flag)
@@ -39,14 +48,18 @@ void Camera::ClearMovementFlag(CameraMovement flag)
 
 void Camera::SetPosition(const Vec3 &position)
 {
-    m_position = position;
-    // m_is_dirty = true;
+    if (position != m_position) {
+        m_position = position;
+        MarkChanged();
+    }
 }
 
 void Camera::SetRotation(const Vec2 &rotation)
 {
-    m_rotation = rotation;
-    // m_is_dirty = true;
+    if (rotation != m_rotation) {
+        m_rotation = rotation;
+        MarkChanged();
+    }
 }
 
 void Camera::Shake(const f32 intensity, const f32 duration)
@@ -73,9 +86,12 @@ Vec3 Camera::ApplyEffects(const f32 delta_time)
     Vec3 offset{};
 
     // Apply shake if active
+    // Noise rather than a random offset each frame, so the shake moves the same at any frame rate instead of jumping
     if (m_shake_duration > 0.0f) {
-        offset.x += m_rng.GetFloat(-m_shake_intensity, m_shake_intensity);
-        offset.y += m_rng.GetFloat(-m_shake_intensity, m_shake_intensity);
+        const f32 shake_x{m_shake_time * SHAKE_FREQUENCY};
+        offset.x += math::perlin_noise(shake_x, 0.5f, m_shake_seed) * m_shake_intensity;
+        offset.y += math::perlin_noise(shake_x, 0.5f, m_shake_seed + 1) * m_shake_intensity;
+        m_shake_time = std::fmod(m_shake_time + delta_time, SHAKE_TIME_WRAP);
         m_shake_duration -= delta_time;
     }
 
@@ -91,8 +107,21 @@ Vec3 Camera::ApplyEffects(const f32 delta_time)
 void Camera::ApplyFollow(const f32 delta_time)
 {
     if (p_follow_target && m_follow_speed > 0.0f) {
-        m_position += (*p_follow_target - m_position) * m_follow_speed * delta_time;
-        m_is_dirty = true;
+        // Once the camera has caught up with a still target the step is zero and nothing changes
+        const Vec3 step{(*p_follow_target - m_position) * m_follow_speed * delta_time};
+        if (step != Vec3{}) {
+            m_position += step;
+            MarkChanged();
+        }
+    }
+}
+
+void Camera::SetEffectOffset(const Vec3 &offset)
+{
+    // Ending a shake returns the offset to zero, which is a change as well
+    if (offset != m_offset) {
+        m_offset = offset;
+        MarkChanged();
     }
 }
 
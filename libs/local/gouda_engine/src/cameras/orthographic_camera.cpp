@@ -30,8 +30,8 @@ OrthographicCamera::OrthographicCamera(f32 left, f32 right, f32 bottom, f32 top,
 
 void OrthographicCamera::Update(const f32 delta_time)
 {
+    // A static camera only changes through SetProjection and the setters, which mark the change themselves
     if (m_speed == 0.0f && m_sensitivity == 0.0f) {
-        m_is_dirty = false;
         return;
     }
 
@@ -59,23 +59,18 @@ void OrthographicCamera::Update(const f32 delta_time)
         m_position.x += movement.x;
         m_position.y += movement.y;
         m_zoom = math::max(0.1f, m_zoom + zoom_delta);
-        m_is_dirty = true;
+        MarkChanged();
     }
 
     // Apply shake and sway effects
-    m_offset = ApplyEffects(delta_time); // Store offset
-
-    // Set m_is_dirty if effects are active
-    if (m_shake_duration > 0.0f || m_sway_amplitude > 0.0f) {
-        m_is_dirty = true;
-    }
+    SetEffectOffset(ApplyEffects(delta_time));
 }
 
 void OrthographicCamera::AdjustZoom(float delta)
 {
     m_zoom += delta;
     m_zoom = math::max(0.1f, m_zoom); // Prevent zoom from going too small
-    m_is_dirty = true;
+    MarkChanged();
 }
 
 Mat4 OrthographicCamera::GetViewProjectionMatrix() const
@@ -87,6 +82,15 @@ Mat4 OrthographicCamera::GetViewProjectionMatrix() const
     return m_view_projection_matrix;
 }
 
+const OrthographicCamera::FrustumData &OrthographicCamera::GetFrustumData() const
+{
+    if (m_is_dirty) {
+        UpdateMatrix();
+    }
+
+    return m_frustum_data;
+}
+
 Mat4 OrthographicCamera::GetViewMatrixNoEffects() const
 {
     //if (m_speed == 0.0f && m_sensitivity == 0.0f) {
@@ -109,12 +113,15 @@ void OrthographicCamera::UpdateMatrix() const
     // Create the view matrix by translating the world opposite to the camera's position
     const Mat4 view_matrix{math::translate(-camera_position)};
 
-    // Create the projection matrix with zoom scaling
-    const Mat4 projection{m_base_projection * math::scale(Vec3(m_zoom, m_zoom, 1.0f))};
+    // Create the projection matrix with zoom scaling, applied in clip space so zoom is centred on the screen
+    const Mat4 projection{math::scale(Vec3(m_zoom, m_zoom, 1.0f)) * m_base_projection};
 
     // Combine projection and view matrices
     m_view_projection_matrix = projection * view_matrix;
 
+    // The culling bounds follow the position without the effect offset, so shakes do not pop entities in and out
+    m_frustum_data = {m_position, m_left / m_zoom, m_right / m_zoom, m_bottom / m_zoom, m_top / m_zoom};
+
     // Mark as updated
     m_is_dirty = false;
 }
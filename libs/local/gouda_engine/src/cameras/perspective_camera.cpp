@@ -39,16 +39,11 @@ void PerspectiveCamera::Update(f32 delta_time)
 
         m_position += movement;
         m_rotation += rotation_delta;
-        m_is_dirty = true;
+        MarkChanged();
     }
 
     // Apply shake and sway effects
-    m_offset = ApplyEffects(delta_time); // Store offset
-
-    // Set m_is_dirty if effects are active
-    if (m_shake_duration > 0.0f || m_sway_amplitude > 0.0f) {
-        m_is_dirty = true;
-    }
+    SetEffectOffset(ApplyEffects(delta_time));
 }
 
 Mat4 PerspectiveCamera::GetViewProjectionMatrix() const
@@ -60,10 +55,19 @@ Mat4 PerspectiveCamera::GetViewProjectionMatrix() const
     return m_view_projection_matrix;
 }
 
+const math::Frustum &PerspectiveCamera::GetFrustum() const
+{
+    if (m_is_dirty) {
+        UpdateMatrix();
+    }
+
+    return m_frustum;
+}
+
 void PerspectiveCamera::SetFOV(f32 fov)
 {
     m_fov = fov;
-    m_is_dirty = true;
+    MarkChanged();
 }
 
 // Private functions ----------------------------------------------------------------------------------
@@ -84,6 +88,7 @@ void PerspectiveCamera::UpdateMatrix() const
     Mat4 view{math::lookAt(total_position, total_position + forward, up)};
     Mat4 projection{math::perspective(math::radians(m_fov), m_aspect, m_near, m_far)};
     m_view_projection_matrix = projection * view;
+    m_frustum = math::extract_frustum(m_view_projection_matrix);
     m_is_dirty = false;
 }
 
@@ -0,0 +1,98 @@
+/**
+ * @file debug/debug_draw.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine batched debug line, shape and text drawing implementation
+ */
+#include "debug/debug_draw.hpp"
+
+namespace gouda {
+
+DebugDraw &DebugDraw::Get()
+{
+    static DebugDraw instance;
+    return instance;
+}
+
+void DebugDraw::Line(const Vec2 &from, const Vec2 &to, const Colour<f32> &colour, const f32 width,
+                     const bool screen_space)
+{
+    AddShape(make_line_shape(from, to, DEPTH, width, colour, !screen_space));
+}
+
+void DebugDraw::Box(const math::AABB2D &box, const Colour<f32> &colour, const f32 width, const bool screen_space)
+{
+    // Shape outlines lie inside their bounds, growing them by half the width centres the outline on the box edges
+    const f32 half_width{width * 0.5f};
+    AddShape(make_rect_shape({box.min.x - half_width, box.min.y - half_width, DEPTH},
+                             {box.max.x - box.min.x + width, box.max.y - box.min.y + width}, colour, 0.0f, width,
+                             !screen_space));
+}
+
+void DebugDraw::FilledBox(const math::AABB2D &box, const Colour<f32> &colour, const bool screen_space)
+{
+    AddShape(make_rect_shape({box.min.x, box.min.y, DEPTH}, {box.max.x - box.min.x, box.max.y - box.min.y}, colour,
+                             0.0f, 0.0f, !screen_space));
+}
+
+void DebugDraw::Circle(const Vec2 &center, const f32 radius, const Colour<f32> &colour, const f32 width,
+                       const bool screen_space)
+{
+    AddShape(make_circle_shape({center.x, center.y, DEPTH}, radius + width * 0.5f, colour, width, !screen_space));
+}
+
+void DebugDraw::Text(StringView text, const Vec2 &position, const Colour<f32> &colour, const f32 scale,
+                     const bool screen_space)
+{
+    if (m_text_font_id == 0 || text.empty()) {
+        return;
+    }
+
+    ThreadBuffer &buffer{GetThreadBuffer()};
+    std::lock_guard lock{buffer.mutex};
+    buffer.texts.push_back({String{text}, position, colour, scale, screen_space});
+}
+
+void DebugDraw::Flush(std::vector<InstanceData> &shapes, Vector<DebugText> &texts)
+{
+    std::lock_guard lock{m_buffers_mutex};
+    for (const std::unique_ptr<ThreadBuffer> &buffer : m_buffers) {
+        std::lock_guard buffer_lock{buffer->mutex};
+        shapes.insert(shapes.end(), buffer->shapes.begin(), buffer->shapes.end());
+        for (DebugText &text : buffer->texts) {
+            texts.push_back(std::move(text));
+        }
+        buffer->shapes.clear();
+        buffer->texts.clear();
+    }
+}
+
+void DebugDraw::Clear()
+{
+    std::lock_guard lock{m_buffers_mutex};
+    for (const std::unique_ptr<ThreadBuffer> &buffer : m_buffers) {
+        std::lock_guard buffer_lock{buffer->mutex};
+        buffer->shapes.clear();
+        buffer->texts.clear();
+    }
+}
+
+// Private functions -------------------------------------------------------------------------------------
+DebugDraw::ThreadBuffer &DebugDraw::GetThreadBuffer()
+{
+    thread_local ThreadBuffer *t_buffer{nullptr}; // Owned by the instance, which outlives every thread
+    if (t_buffer == nullptr) {
+        std::lock_guard lock{m_buffers_mutex};
+        t_buffer = m_buffers.emplace_back(std::make_unique<ThreadBuffer>()).get();
+    }
+    return *t_buffer;
+}
+
+void DebugDraw::AddShape(const InstanceData shape)
+{
+    ThreadBuffer &buffer{GetThreadBuffer()};
+    std::lock_guard lock{buffer.mutex};
+    buffer.shapes.push_back(shape);
+}
+
+} // namespace gouda
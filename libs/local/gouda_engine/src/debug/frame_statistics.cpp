@@ -0,0 +1,159 @@
+/**
+ * @file debug/frame_statistics.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine rolling frame time statistics implementation
+ */
+#include "debug/frame_statistics.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <format>
+
+#include "debug/assert.hpp"
+#include "debug/logger.hpp"
+#include "utils/filesystem.hpp"
+
+namespace gouda {
+
+namespace internal {
+
+// Nearest rank, values sorted ascending and not empty
+static f32 percentile(const Vector<f32> &values, const f32 fraction)
+{
+    const auto rank{static_cast<size_t>(std::ceil(fraction * static_cast<f32>(values.size())))};
+    return values[std::clamp(rank, size_t{1}, values.size()) - 1];
+}
+
+} // namespace internal
+
+FrameStatistics::FrameStatistics(const size_t window_size, const f32 hitch_factor)
+    : m_window_size{window_size},
+      m_next_sample{0},
+      m_sample_count{0},
+      m_frame_count{0},
+      m_hitch_factor{hitch_factor},
+      m_summaries{},
+      m_summaries_dirty{false},
+      m_csv_first_frame{0}
+{
+    ASSERT(window_size > 0, "Frame statistics window cannot be empty.");
+    m_samples.resize(window_size);
+    m_sorted.reserve(window_size);
+}
+
+FrameStatistics::~FrameStatistics() { StopCsvCapture(); }
+
+void FrameStatistics::AddFrame(const FrameSample &sample)
+{
+    m_samples[m_next_sample] = {sample.cpu_frame_time, sample.gpu_frame_time, sample.present_latency,
+                                sample.fence_wait_time};
+    m_next_sample = (m_next_sample + 1) % m_window_size;
+    m_sample_count = std::min(m_sample_count + 1, m_window_size);
+    ++m_frame_count;
+    m_summaries_dirty = true;
+
+    if (m_csv_stream.is_open()) {
+        m_csv_stream << std::format("{},{:.4f},{:.4f},{:.4f},{:.4f}\n", m_frame_count - m_csv_first_frame,
+                                    sample.cpu_frame_time, sample.gpu_frame_time, sample.present_latency,
+                                    sample.fence_wait_time);
+    }
+}
+
+void FrameStatistics::Clear()
+{
+    m_next_sample = 0;
+    m_sample_count = 0;
+    m_summaries = {};
+    m_summaries_dirty = false;
+}
+
+const FrameMetricSummary &FrameStatistics::GetSummary(const FrameMetric metric) const
+{
+    if (m_summaries_dirty) {
+        UpdateSummaries();
+    }
+    return m_summaries[static_cast<size_t>(metric)];
+}
+
+bool FrameStatistics::StartCsvCapture(StringView filepath)
+{
+    StopCsvCapture();
+
+    if (const auto result{fs::EnsureDirectoryExists(FilePath(filepath).parent_path(), true)}; !result) {
+        ENGINE_LOG_ERROR("Error creating frame statistics directory: {}.", fs::error_to_string(result.error()));
+        return false;
+    }
+
+    m_csv_stream.open(String{filepath});
+    if (!m_csv_stream.is_open()) {
+        ENGINE_LOG_ERROR("Could not open frame statistics file '{}'.", filepath);
+        return false;
+    }
+
+    m_csv_stream << "frame,cpu_frame_time_ms,gpu_frame_time_ms,present_latency_ms,fence_wait_ms\n";
+    m_csv_first_frame = m_frame_count;
+    ENGINE_LOG_INFO("Capturing frame statistics to '{}'.", filepath);
+    return true;
+}
+
+void FrameStatistics::StopCsvCapture()
+{
+    if (m_csv_stream.is_open()) {
+        ENGINE_LOG_INFO("Captured {} frames of frame statistics.", m_frame_count - m_csv_first_frame);
+        m_csv_stream.close();
+    }
+}
+
+StringView FrameStatistics::GetMetricName(const FrameMetric metric)
+{
+    switch (metric) {
+        case FrameMetric::CpuFrameTime:
+            return "CPU frame";
+        case FrameMetric::GpuFrameTime:
+            return "GPU frame";
+        case FrameMetric::PresentLatency:
+            return "Present";
+        case FrameMetric::FenceWait:
+            return "Fence wait";
+    }
+    return "Unknown";
+}
+
+void FrameStatistics::UpdateSummaries() const
+{
+    m_summaries_dirty = false;
+    if (m_sample_count == 0) {
+        m_summaries = {};
+        return;
+    }
+
+    for (size_t metric = 0; metric < FRAME_METRIC_COUNT; ++metric) {
+        // Sample order does not matter once sorted, so the ring is read from the start whether it wrapped or not
+        m_sorted.clear();
+        f64 sum{0.0};
+        for (size_t i = 0; i < m_sample_count; ++i) {
+            m_sorted.push_back(m_samples[i][metric]);
+            sum += m_sorted.back();
+        }
+        std::ranges::sort(m_sorted);
+
+        FrameMetricSummary &summary{m_summaries[metric]};
+        summary.p50 = internal::percentile(m_sorted, 0.50f);
+        summary.p95 = internal::percentile(m_sorted, 0.95f);
+        summary.p99 = internal::percentile(m_sorted, 0.99f);
+        summary.max = m_sorted.back();
+        summary.mean = static_cast<f32>(sum / static_cast<f64>(m_sample_count));
+
+        // A metric that is mostly zero, such as the fence wait of a CPU bound frame, has no meaningful median
+        if (summary.p50 > 0.0f) {
+            const auto first_hitch{std::ranges::upper_bound(m_sorted, summary.p50 * m_hitch_factor)};
+            summary.hitch_count = static_cast<u32>(m_sorted.end() - first_hitch);
+        }
+        else {
+            summary.hitch_count = 0;
+        }
+    }
+}
+
+} // namespace gouda
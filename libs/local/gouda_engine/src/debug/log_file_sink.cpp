@@ -0,0 +1,419 @@
+/**
+ * @file debug/log_file_sink.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine buffered, rotating log file implementation
+ */
+#include "debug/log_file_sink.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <print>
+#include <vector>
+
+#include "utils/lz4.hpp"
+#include "utils/thread.hpp"
+
+#if defined(_WIN32)
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace gouda {
+
+namespace internal {
+
+// Lines are appended with O_APPEND, so the file may be appended to by another process without overwriting its lines
+static int open_log_file(const std::filesystem::path &path)
+{
+#if defined(_WIN32)
+    return _wopen(path.c_str(), _O_WRONLY | _O_CREAT | _O_APPEND | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+    return ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+#endif
+}
+
+static bool write_log_file(const int file, const char *data, size_t size)
+{
+    while (size > 0) {
+#if defined(_WIN32)
+        const int written{_write(file, data, static_cast<unsigned>(std::min<size_t>(size, 1u << 30)))};
+#else
+        const ssize_t written{::write(file, data, size)};
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+#endif
+        if (written <= 0) {
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+static void sync_log_file(const int file)
+{
+#if defined(_WIN32)
+    _commit(file);
+#else
+    ::fsync(file);
+#endif
+}
+
+static int duplicate_log_file(const int file)
+{
+#if defined(_WIN32)
+    return _dup(file);
+#else
+    return ::dup(file);
+#endif
+}
+
+static void close_log_file(const int file)
+{
+#if defined(_WIN32)
+    _close(file);
+#else
+    ::close(file);
+#endif
+}
+
+// XXH32 of inputs under 16 bytes, all the LZ4 frame header checksum needs
+static u32 xxh32_short(const std::span<const u8> data)
+{
+    constexpr u32 PRIME_1{2654435761u};
+    constexpr u32 PRIME_2{2246822519u};
+    constexpr u32 PRIME_3{3266489917u};
+    constexpr u32 PRIME_4{668265263u};
+    constexpr u32 PRIME_5{374761393u};
+
+    u32 hash{PRIME_5 + static_cast<u32>(data.size())};
+    size_t i{0};
+    for (; i + 4 <= data.size(); i += 4) {
+        u32 lane;
+        std::memcpy(&lane, data.data() + i, sizeof(lane));
+        hash = std::rotl(hash + lane * PRIME_3, 17) * PRIME_4;
+    }
+    for (; i < data.size(); ++i) {
+        hash = std::rotl(hash + data[i] * PRIME_5, 11) * PRIME_1;
+    }
+
+    hash ^= hash >> 15;
+    hash *= PRIME_2;
+    hash ^= hash >> 13;
+    hash *= PRIME_3;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+static void write_u32_le(std::ofstream &stream, const u32 value)
+{
+    const std::array<char, 4> bytes{static_cast<char>(value), static_cast<char>(value >> 8),
+                                    static_cast<char>(value >> 16), static_cast<char>(value >> 24)};
+    stream.write(bytes.data(), bytes.size());
+}
+
+constexpr size_t LZ4_FRAME_BLOCK_SIZE{4 * 1024 * 1024}; // The largest the frame format allows
+constexpr u32 LZ4_FRAME_MAGIC{0x184D2204};
+constexpr u8 LZ4_FRAME_FLAGS{0x60};            // Version 1, independent blocks, no checksums or content size
+constexpr u8 LZ4_FRAME_BLOCK_DESCRIPTOR{0x70}; // 4 MiB blocks
+constexpr u32 LZ4_FRAME_UNCOMPRESSED_BLOCK{0x80000000u};
+
+} // namespace internal
+
+LogFileSink::LogFileSink(StringView file_path, const LogFileSettings &settings)
+    : m_file_path{std::filesystem::path{String{file_path}}},
+      m_settings{settings},
+      m_file{internal::open_log_file(m_file_path)},
+      m_file_size{0},
+      m_opened{SteadyClock::now()},
+      m_last_sync{m_opened},
+      m_last_rotation{},
+      m_unsynced{false}
+{
+    if (m_file < 0) {
+        std::print(std::cerr, "[Logger] Failed to open log file: {}\n", m_file_path.string());
+        return;
+    }
+
+    std::error_code error;
+    const uintmax_t size{std::filesystem::file_size(m_file_path, error)};
+    m_file_size = error ? 0 : static_cast<size_t>(size);
+    m_buffer.reserve(m_settings.buffer_size);
+    m_background = MakeThread("Log file", ThreadPriority::Logging,
+                              [this](const std::stop_token &stop_token) { BackgroundLoop(stop_token); });
+}
+
+LogFileSink::~LogFileSink()
+{
+    {
+        std::lock_guard lock{m_mutex};
+        if (m_file >= 0) {
+            WriteBuffer();
+            internal::sync_log_file(m_file);
+            internal::close_log_file(m_file);
+            m_file = -1;
+        }
+    }
+
+    // The background thread finishes the jobs already pushed before it stops
+    m_background.request_stop();
+    if (m_background.joinable()) {
+        m_background.join();
+    }
+}
+
+void LogFileSink::SetSettings(const LogFileSettings &settings)
+{
+    std::lock_guard lock{m_mutex};
+    m_settings = settings;
+    m_buffer.reserve(m_settings.buffer_size);
+}
+
+void LogFileSink::Write(StringView line)
+{
+    std::lock_guard lock{m_mutex};
+    if (m_file < 0) {
+        return;
+    }
+
+    const size_t size{line.size() + 1};
+    const size_t pending{m_file_size + m_buffer.size()};
+    if (m_settings.max_file_size > 0 && pending > 0 && pending + size > m_settings.max_file_size) {
+        Rotate();
+    }
+    if (!m_buffer.empty() && m_buffer.size() + size > m_settings.buffer_size) {
+        WriteBuffer();
+    }
+
+    m_buffer.append(line);
+    m_buffer.push_back('\n');
+}
+
+void LogFileSink::Flush()
+{
+    std::lock_guard lock{m_mutex};
+    if (m_file < 0) {
+        return;
+    }
+
+    WriteBuffer();
+
+    const auto now{SteadyClock::now()};
+    if (m_settings.max_file_age > Seconds{0} && m_file_size > 0 && now - m_opened >= m_settings.max_file_age) {
+        Rotate();
+    }
+    else if (m_unsynced && m_settings.sync_period > Milliseconds{0} && now - m_last_sync >= m_settings.sync_period) {
+        RequestSync();
+    }
+}
+
+// Private functions -------------------------------------------------------------------------------------
+void LogFileSink::WriteBuffer()
+{
+    if (m_buffer.empty()) {
+        return;
+    }
+
+    if (!internal::write_log_file(m_file, m_buffer.data(), m_buffer.size())) {
+        std::print(std::cerr, "[Logger] Failed to write {} bytes to log file: {}\n", m_buffer.size(),
+                   m_file_path.string());
+    }
+    m_file_size += m_buffer.size();
+    m_unsynced = true;
+    m_buffer.clear();
+}
+
+void LogFileSink::Rotate()
+{
+    WriteBuffer();
+    RequestSync(); // The rotated file's last lines, the descriptor is duplicated so closing ours does not matter
+    internal::close_log_file(m_file);
+
+    // Named by the time of the rotation, so names sort oldest first and never need renaming again. Rotations within
+    // a second move on a second rather than adding a suffix, which would sort out of order.
+    const String stem{m_file_path.stem().string()};
+    const String extension{m_file_path.extension().string()};
+    std::filesystem::path rotated_path;
+    m_last_rotation = std::max(std::chrono::floor<Seconds>(SystemClock::now()), m_last_rotation + Seconds{1});
+    for (;; m_last_rotation += Seconds{1}) {
+        rotated_path =
+            m_file_path.parent_path() / std::format("{}.{:%Y%m%d-%H%M%S}{}", stem, m_last_rotation, extension);
+        if (!std::filesystem::exists(rotated_path) &&
+            !std::filesystem::exists(String{rotated_path.string()} + ".lz4")) {
+            break; // Files of an earlier run may have the name
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(m_file_path, rotated_path, error);
+    if (error) {
+        std::print(std::cerr, "[Logger] Failed to rotate log file {}: {}\n", m_file_path.string(), error.message());
+    }
+
+    m_file = internal::open_log_file(m_file_path);
+    if (m_file < 0) {
+        std::print(std::cerr, "[Logger] Failed to reopen log file after rotating it: {}\n", m_file_path.string());
+    }
+    m_file_size = 0;
+    m_opened = SteadyClock::now();
+
+    if (!error) {
+        PushJob({.rotated_path = std::move(rotated_path)});
+    }
+}
+
+void LogFileSink::RequestSync()
+{
+    m_last_sync = SteadyClock::now();
+    m_unsynced = false;
+    if (const int file{internal::duplicate_log_file(m_file)}; file >= 0) {
+        PushJob({.sync_file = file});
+    }
+}
+
+void LogFileSink::PushJob(Job job)
+{
+    {
+        std::lock_guard lock{m_jobs_mutex};
+        m_jobs.push_back(std::move(job));
+    }
+    m_jobs_condition.notify_one();
+}
+
+void LogFileSink::BackgroundLoop(const std::stop_token &stop_token)
+{
+    while (true) {
+        Job job;
+        u32 max_rotated_files;
+        bool compress;
+        {
+            std::unique_lock lock{m_jobs_mutex};
+            m_jobs_condition.wait(lock, stop_token, [this] { return !m_jobs.empty(); });
+            if (m_jobs.empty()) {
+                return; // Stopped with nothing left to do
+            }
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+        }
+        {
+            std::lock_guard lock{m_mutex};
+            max_rotated_files = m_settings.max_rotated_files;
+            compress = m_settings.compress_rotated;
+        }
+
+        if (job.sync_file >= 0) {
+            internal::sync_log_file(job.sync_file);
+            internal::close_log_file(job.sync_file);
+        }
+        if (!job.rotated_path.empty()) {
+            if (compress) {
+                CompressRotatedFile(job.rotated_path);
+            }
+            PruneRotatedFiles(max_rotated_files);
+        }
+    }
+}
+
+void LogFileSink::CompressRotatedFile(const std::filesystem::path &path) const
+{
+    std::ifstream input{path, std::ios::binary | std::ios::ate};
+    if (!input) {
+        return;
+    }
+    std::vector<std::byte> contents(static_cast<size_t>(input.tellg()));
+    input.seekg(0);
+    input.read(reinterpret_cast<char *>(contents.data()), static_cast<std::streamsize>(contents.size()));
+    if (!input) {
+        std::print(std::cerr, "[Logger] Failed to read rotated log file: {}\n", path.string());
+        return;
+    }
+    input.close();
+
+    // Written beside the file and renamed over once complete, so an interrupted compression leaves the original
+    const std::filesystem::path compressed_path{String{path.string()} + ".lz4"};
+    const std::filesystem::path temporary_path{String{compressed_path.string()} + ".tmp"};
+    std::ofstream output{temporary_path, std::ios::binary | std::ios::trunc};
+    internal::write_u32_le(output, internal::LZ4_FRAME_MAGIC);
+    const std::array<u8, 2> descriptor{internal::LZ4_FRAME_FLAGS, internal::LZ4_FRAME_BLOCK_DESCRIPTOR};
+    const std::array<char, 3> header{static_cast<char>(descriptor[0]), static_cast<char>(descriptor[1]),
+                                     static_cast<char>((internal::xxh32_short(descriptor) >> 8) & 0xFF)};
+    output.write(header.data(), header.size());
+
+    std::vector<std::byte> block(utils::lz4_compress_bound(internal::LZ4_FRAME_BLOCK_SIZE));
+    for (size_t offset = 0; offset < contents.size(); offset += internal::LZ4_FRAME_BLOCK_SIZE) {
+        const std::span<const std::byte> data{
+            std::span{contents}.subspan(offset, std::min(internal::LZ4_FRAME_BLOCK_SIZE, contents.size() - offset))};
+        const size_t compressed_size{utils::lz4_compress(data, block)};
+        if (compressed_size == 0 || compressed_size >= data.size()) {
+            internal::write_u32_le(output, static_cast<u32>(data.size()) | internal::LZ4_FRAME_UNCOMPRESSED_BLOCK);
+            output.write(reinterpret_cast<const char *>(data.data()), static_cast<std::streamsize>(data.size()));
+        }
+        else {
+            internal::write_u32_le(output, static_cast<u32>(compressed_size));
+            output.write(reinterpret_cast<const char *>(block.data()), static_cast<std::streamsize>(compressed_size));
+        }
+    }
+    internal::write_u32_le(output, 0); // End mark
+    output.close();
+
+    std::error_code error;
+    if (!output) {
+        std::print(std::cerr, "[Logger] Failed to compress rotated log file: {}\n", path.string());
+        std::filesystem::remove(temporary_path, error);
+        return;
+    }
+    std::filesystem::rename(temporary_path, compressed_path, error);
+    if (!error) {
+        std::filesystem::remove(path, error);
+    }
+}
+
+void LogFileSink::PruneRotatedFiles(const u32 max_rotated_files) const
+{
+    // Rotated files are the log's stem, a dot and a digit, ending in its extension with or without .lz4
+    const String prefix{m_file_path.stem().string() + "."};
+    const String extension{m_file_path.extension().string()};
+    const String compressed_extension{extension + ".lz4"};
+    std::filesystem::path directory{m_file_path.parent_path()};
+    if (directory.empty()) {
+        directory = ".";
+    }
+
+    std::vector<std::filesystem::path> rotated;
+    std::error_code error;
+    for (const std::filesystem::directory_entry &entry : std::filesystem::directory_iterator{directory, error}) {
+        const String name{entry.path().filename().string()};
+        if (name.size() <= prefix.size() || !name.starts_with(prefix) ||
+            !std::isdigit(static_cast<unsigned char>(name[prefix.size()])) ||
+            (!name.ends_with(extension) && !name.ends_with(compressed_extension))) {
+            continue;
+        }
+        rotated.push_back(entry.path());
+    }
+    if (rotated.size() <= max_rotated_files) {
+        return;
+    }
+
+    // A file and its compressed copy sort together, the names start with the time they were rotated
+    std::ranges::sort(rotated);
+    for (size_t i = 0; i < rotated.size() - max_rotated_files; ++i) {
+        std::filesystem::remove(rotated[i], error);
+    }
+}
+
+} // namespace gouda
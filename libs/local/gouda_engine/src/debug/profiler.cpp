@@ -1,9 +1,13 @@
 #include "debug/profiler.hpp"
 
-#include <iomanip>
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <tuple>
 
 #include "debug/logger.hpp"
 #include "utils/filesystem.hpp"
+#include "utils/thread.hpp"
 
 namespace gouda::internal::profiler {
 
@@ -15,7 +19,24 @@ inline int get_process_id() { return static_cast<int>(GetCurrentProcessId()); }
 inline int get_process_id() { return static_cast<int>(getpid()); }
 #endif
 
-Profiler::Profiler() : p_current_session(nullptr) {}
+Profiler::Profiler()
+    : p_current_session(nullptr),
+      m_gpu_events{{}, {}, GPU_THREAD_INDEX, {}, true},
+      m_is_active{false},
+      m_dropped_events{0},
+      m_is_binary{false},
+      m_trace_thread{0},
+      m_trace_counter_time{0},
+      m_is_capturing_frames{false},
+      m_dropped_frame_events{0},
+      m_next_frame{0},
+      m_frame_count{0},
+      m_frame_number{0},
+      m_frame_start{0.0},
+      m_has_captured_frame{false},
+      m_frames_frozen{false}
+{
+}
 
 void Profiler::BeginSession(std::string_view name, std::string_view filepath)
 {
@@ -33,7 +54,8 @@ void Profiler::BeginSession(std::string_view name, std::string_view filepath)
         return;
     }
 
-    m_output_stream.open(filepath.data());
+    m_is_binary = FilePath{filepath}.extension() == TRACE_FILE_EXTENSION;
+    m_output_stream.open(filepath.data(), std::ios::binary);
     if (!m_output_stream.is_open()) {
         ENGINE_LOG_ERROR("Could not open profiler results file '{}'.", filepath);
         return;
@@ -42,6 +64,18 @@ void Profiler::BeginSession(std::string_view name, std::string_view filepath)
     p_current_session = std::make_unique<ProfilingSession>();
     p_current_session->name = name;
     WriteHeader();
+
+    WriteEvents(true); // Recorded after the last session ended
+    {
+        std::lock_guard buffers_lock{m_buffers_mutex};
+        for (const auto &thread_events : m_thread_events) {
+            thread_events->is_name_written = false;
+        }
+    }
+    m_dropped_events.store(0, std::memory_order_relaxed);
+    m_is_active.store(true, std::memory_order_release);
+    m_writer = MakeThread("Profiler writer", ThreadPriority::Logging,
+                          [this](const std::stop_token &stop_token) { WriteLoop(stop_token); });
 }
 
 void Profiler::EndSession()
@@ -52,39 +86,402 @@ void Profiler::EndSession()
 
 void Profiler::Write(const ProfileResult &result)
 {
-    std::lock_guard lock{m_mutex};
-    if (!p_current_session || !m_output_stream.is_open()) {
+    const bool is_active{m_is_active.load(std::memory_order_acquire)};
+    const bool is_capturing_frames{m_is_capturing_frames.load(std::memory_order_acquire)};
+    if (!is_active && !is_capturing_frames) {
+        return;
+    }
+
+    ThreadEvents &thread_events{GetThreadEvents()};
+    if (is_active && !thread_events.events.TryPush(result)) {
+        m_dropped_events.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (is_capturing_frames && !thread_events.frame_events.TryPush(result)) {
+        m_dropped_frame_events.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void Profiler::WriteGpu(const ProfileResult &result)
+{
+    if (!m_is_active.load(std::memory_order_acquire)) {
         return;
     }
 
-    m_output_stream << ",{\"cat\":\"function\","
-                    << "\"dur\":" << result.elapsed_time.count() << ',' << "\"name\":\"" << result.name << "\","
-                    << "\"ph\":\"X\","
-                    << "\"pid\":" << get_process_id() << ',' << "\"tid\":" << result.thread_id << ','
-                    << "\"ts\":" << std::fixed << std::setprecision(3) << result.start.count() << "}";
+    if (!m_gpu_events.events.TryPush(result)) {
+        m_dropped_events.fetch_add(1, std::memory_order_relaxed);
+    }
+}
 
-    m_output_stream.flush();
+void Profiler::WriteCounter(const std::string_view name, const f64 value)
+{
+    if (!m_is_active.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    const FloatingPointMicroseconds now{SteadyClock::now().time_since_epoch()};
+    if (!m_counters.TryPush({name, now, value})) {
+        m_dropped_events.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void Profiler::SetThreadName(const std::string_view name)
+{
+    ThreadEvents &thread_events{GetThreadEvents()};
+    std::lock_guard lock{m_buffers_mutex};
+    thread_events.name = name;
+    thread_events.is_name_written = false;
+}
+
+FrameCounter &Profiler::GetFrameCounter(const std::string_view name, const CounterKind kind)
+{
+    std::lock_guard lock{m_frame_counters_mutex};
+    const auto it{std::ranges::find_if(m_frame_counters, [name](const std::unique_ptr<FrameCounter> &counter) {
+        return counter->GetName() == name;
+    })};
+    if (it != m_frame_counters.end()) {
+        return **it;
+    }
+    return *m_frame_counters.emplace_back(std::make_unique<FrameCounter>(name, kind));
+}
+
+s64 Profiler::GetFrameCounterSample(const std::string_view name)
+{
+    std::lock_guard lock{m_frame_counters_mutex};
+    const auto it{std::ranges::find_if(m_frame_counters, [name](const std::unique_ptr<FrameCounter> &counter) {
+        return counter->GetName() == name;
+    })};
+    return it != m_frame_counters.end() ? (*it)->GetLastSample() : 0;
+}
+
+void Profiler::BeginFrame()
+{
+    const FloatingPointMicroseconds frame_end{SteadyClock::now().time_since_epoch()};
+    ++m_frame_number;
+    SampleFrameCounters();
+    if (!m_is_capturing_frames.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    DrainFrameEvents();
+    if (m_frame_start.count() == 0.0 || m_frames_frozen) {
+        // The first frame since capture started is incomplete, and a frozen history keeps its frames
+        const auto [first, last] = std::ranges::remove_if(m_frame_events, [frame_end](const FrameEvent &event) {
+            return event.result.start + event.result.elapsed_time <= frame_end;
+        });
+        m_frame_events.erase(first, last);
+    }
+    else {
+        BuildFrame(m_frames[m_next_frame], frame_end);
+        m_next_frame = (m_next_frame + 1) % FRAME_HISTORY_SIZE;
+        m_frame_count = std::min(m_frame_count + 1, FRAME_HISTORY_SIZE);
+    }
+    m_frame_start = frame_end;
+}
+
+void Profiler::SetFrameCaptureEnabled(const bool enabled)
+{
+    if (enabled == m_is_capturing_frames.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    m_is_capturing_frames.store(enabled, std::memory_order_release);
+    DrainFrameEvents(); // Left over from an earlier capture, or recorded by threads that had not seen it stop
+    m_frame_events.clear();
+    m_next_frame = 0;
+    m_frame_count = 0;
+    m_frame_start = FloatingPointMicroseconds{0.0};
+    m_dropped_frame_events.store(0, std::memory_order_relaxed);
+}
+
+bool Profiler::CaptureFrame()
+{
+    const CapturedFrame *frame{GetFrame(0)};
+    if (frame == nullptr) {
+        ENGINE_LOG_WARNING("No frame to capture, frame capture is {}.",
+                           IsFrameCaptureEnabled() ? "still warming up" : "disabled");
+        return false;
+    }
+
+    m_captured_frame = *frame;
+    m_has_captured_frame = true;
+
+    ENGINE_LOG_INFO("Captured frame {} ({:.3f} ms, {} scopes):", frame->frame_number, frame->duration.count() / 1000.0,
+                    frame->scopes.size());
+    for (const CapturedScope &scope : frame->scopes) {
+        ENGINE_LOG_INFO("  {:{}}{} [thread {}] {:.3f} ms at {:.3f} ms", "", scope.depth * 2, scope.name,
+                        scope.thread_index, static_cast<f64>(scope.elapsed_time.count()) / 1000.0,
+                        scope.start.count() / 1000.0);
+    }
+    return true;
+}
+
+const CapturedFrame *Profiler::GetFrame(const size_t age) const
+{
+    if (age >= m_frame_count) {
+        return nullptr;
+    }
+    return &m_frames[(m_next_frame + FRAME_HISTORY_SIZE - 1 - age) % FRAME_HISTORY_SIZE];
 }
 
 void Profiler::WriteHeader()
 {
-    m_output_stream << "{\"other_data\": {},\"trace_events\":[{}";
+    m_batch.clear();
+    if (m_is_binary) {
+        m_batch.append(TRACE_MAGIC.data(), TRACE_MAGIC.size());
+        m_batch.push_back(static_cast<char>(TRACE_VERSION));
+        append_trace_varint(m_batch, static_cast<u64>(get_process_id()));
+
+        // Every stream of a binary trace starts from zero
+        m_trace_names.clear();
+        m_trace_thread_times.clear();
+        m_trace_thread = constants::u32_max;
+        m_trace_counter_time = 0;
+    }
+    else {
+        append_json_trace_header(m_batch, get_process_id());
+    }
+    m_output_stream.write(m_batch.data(), static_cast<std::streamsize>(m_batch.size()));
     m_output_stream.flush();
 }
 
 void Profiler::WriteFooter()
 {
-    m_output_stream << "]}";
+    if (!m_is_binary) {
+        m_output_stream << JSON_TRACE_FOOTER;
+    }
     m_output_stream.flush();
 }
 
 void Profiler::InternalEndSession()
 {
     if (p_current_session) {
+        m_is_active.store(false, std::memory_order_release);
+        if (m_writer.joinable()) {
+            m_writer.request_stop();
+            m_writer.join();
+        }
+        WriteEvents(); // What the writer had not reached, only this thread pops now
+
+        if (const u64 dropped{m_dropped_events.load(std::memory_order_relaxed)}; dropped > 0) {
+            ENGINE_LOG_WARNING("Profiling session '{}' dropped {} events, a thread's buffer of {} was full.",
+                               p_current_session->name, dropped, THREAD_BUFFER_CAPACITY);
+        }
+
         WriteFooter();
         m_output_stream.close();
         p_current_session.reset();
     }
 }
 
+Profiler::ThreadEvents &Profiler::GetThreadEvents()
+{
+    thread_local ThreadEvents *t_thread_events{nullptr}; // Owned by the profiler, which outlives every thread
+    if (t_thread_events == nullptr) {
+        std::lock_guard lock{m_buffers_mutex};
+        auto events{std::make_unique<ThreadEvents>()};
+        events->thread_index = static_cast<u32>(m_thread_events.size()) + 1;
+        t_thread_events = m_thread_events.emplace_back(std::move(events)).get();
+    }
+    return *t_thread_events;
+}
+
+void Profiler::WriteEvents(const bool is_discarding)
+{
+    m_batch.clear();
+    {
+        std::lock_guard lock{m_buffers_mutex};
+        const auto drain = [&](ThreadEvents &thread_events) {
+            if (!is_discarding && !thread_events.is_name_written && !thread_events.name.empty()) {
+                AppendThreadName(thread_events.thread_index, thread_events.name);
+                thread_events.is_name_written = true;
+            }
+
+            ProfileResult result;
+            while (thread_events.events.TryPop(result)) {
+                if (!is_discarding) {
+                    AppendScope(thread_events.thread_index, result);
+                }
+            }
+        };
+
+        drain(m_gpu_events);
+        for (const auto &thread_events : m_thread_events) {
+            drain(*thread_events);
+        }
+
+        ProfileCounter counter;
+        while (m_counters.TryPop(counter)) {
+            if (!is_discarding) {
+                AppendCounter(counter);
+            }
+        }
+    }
+
+    if (!m_batch.empty()) {
+        m_output_stream.write(m_batch.data(), static_cast<std::streamsize>(m_batch.size()));
+        m_output_stream.flush();
+    }
+}
+
+void Profiler::AppendThreadName(const u32 thread_index, const std::string_view name)
+{
+    static const int process_id{get_process_id()};
+    if (!m_is_binary) {
+        append_json_trace_thread_name(m_batch, process_id, thread_index, name);
+        return;
+    }
+
+    m_batch.push_back(static_cast<char>(TraceRecord::ThreadName));
+    append_trace_varint(m_batch, thread_index);
+    append_trace_varint(m_batch, name.size());
+    m_batch.append(name);
+}
+
+void Profiler::AppendScope(const u32 thread_index, const ProfileResult &result)
+{
+    static const int process_id{get_process_id()};
+    if (!m_is_binary) {
+        append_json_trace_scope(m_batch, process_id, thread_index, result.name, result.elapsed_time, result.start);
+        return;
+    }
+
+    const u32 name{InternTraceName(result.name)};
+    if (thread_index != m_trace_thread) {
+        m_batch.push_back(static_cast<char>(TraceRecord::Thread));
+        append_trace_varint(m_batch, thread_index);
+        m_trace_thread = thread_index;
+        if (thread_index >= m_trace_thread_times.size()) {
+            m_trace_thread_times.resize(thread_index + 1, 0);
+        }
+    }
+
+    // Scopes are recorded as they end, so a parent starts before the child written ahead of it and deltas go both ways
+    const s64 start{std::llround(result.start.count() * 1000.0)};
+    m_batch.push_back(static_cast<char>(TraceRecord::Scope));
+    append_trace_varint(m_batch, name);
+    append_trace_zigzag(m_batch, start - m_trace_thread_times[thread_index]);
+    append_trace_varint(m_batch, static_cast<u64>(std::max<s64>(result.elapsed_time.count(), 0)));
+    m_trace_thread_times[thread_index] = start;
+}
+
+void Profiler::AppendCounter(const ProfileCounter &counter)
+{
+    static const int process_id{get_process_id()};
+    if (!m_is_binary) {
+        append_json_trace_counter(m_batch, process_id, counter.name, counter.timestamp, counter.value);
+        return;
+    }
+
+    const u32 name{InternTraceName(counter.name)};
+    const s64 timestamp{std::llround(counter.timestamp.count() * 1000.0)};
+
+    // Most counters are byte sizes and frame counts, which take a byte or two as integers rather than eight
+    const bool is_integer{std::abs(counter.value) < 0x1p62 && std::trunc(counter.value) == counter.value};
+    m_batch.push_back(static_cast<char>(is_integer ? TraceRecord::Integer : TraceRecord::Counter));
+    append_trace_varint(m_batch, name);
+    append_trace_zigzag(m_batch, timestamp - m_trace_counter_time);
+    if (is_integer) {
+        append_trace_zigzag(m_batch, static_cast<s64>(counter.value));
+    }
+    else {
+        const u64 bits{std::bit_cast<u64>(counter.value)};
+        for (size_t i = 0; i < sizeof(u64); ++i) {
+            m_batch.push_back(static_cast<char>(bits >> (i * 8)));
+        }
+    }
+    m_trace_counter_time = timestamp;
+}
+
+u32 Profiler::InternTraceName(const std::string_view name)
+{
+    const auto [it, inserted] = m_trace_names.try_emplace(name.data(), static_cast<u32>(m_trace_names.size()));
+    if (inserted) {
+        m_batch.push_back(static_cast<char>(TraceRecord::Name));
+        append_trace_varint(m_batch, name.size());
+        m_batch.append(name);
+    }
+    return it->second;
+}
+
+void Profiler::WriteLoop(const std::stop_token &stop_token)
+{
+    while (!stop_token.stop_requested()) {
+        WriteEvents();
+
+        std::unique_lock lock{m_wake_mutex};
+        m_wake_condition.wait_for(lock, stop_token, WRITE_PERIOD, [] { return false; });
+    }
+}
+
+void Profiler::DrainFrameEvents()
+{
+    std::lock_guard lock{m_buffers_mutex};
+    ProfileResult result;
+    for (const auto &thread_events : m_thread_events) {
+        while (thread_events->frame_events.TryPop(result)) {
+            m_frame_events.push_back({result, thread_events->thread_index});
+        }
+    }
+}
+
+void Profiler::SampleFrameCounters()
+{
+    // Written as counter samples whether or not they changed, so the tracks show every frame
+    std::lock_guard lock{m_frame_counters_mutex};
+    for (const std::unique_ptr<FrameCounter> &counter : m_frame_counters) {
+        counter->Sample();
+        WriteCounter(counter->GetName(), static_cast<f64>(counter->GetLastSample()));
+    }
+}
+
+void Profiler::BuildFrame(CapturedFrame &frame, const FloatingPointMicroseconds frame_end)
+{
+    // Scopes still running at the end of the frame were not recorded yet, ones recorded since belong to the next
+    const auto first_pending{std::stable_partition(m_frame_events.begin(), m_frame_events.end(),
+                                                   [frame_end](const FrameEvent &event) {
+                                                       return event.result.start + event.result.elapsed_time <=
+                                                              frame_end;
+                                                   })};
+
+    // Scopes are recorded as they end, children before their parents. Sorted by start with the longer first, every
+    // scope follows the scope enclosing it.
+    std::sort(m_frame_events.begin(), first_pending, [](const FrameEvent &lhs, const FrameEvent &rhs) {
+        return std::tuple{lhs.thread_index, lhs.result.start, rhs.result.elapsed_time} <
+               std::tuple{rhs.thread_index, rhs.result.start, lhs.result.elapsed_time};
+    });
+
+    frame.frame_number = m_frame_number - 1;
+    frame.duration = frame_end - m_frame_start;
+    frame.scopes.clear();
+
+    SmallVector<u32, 32> open_scopes; // Enclosing the next scope of the same thread, innermost last
+    const auto close_scopes = [&frame, &open_scopes](const FloatingPointMicroseconds before) {
+        while (!open_scopes.empty()) {
+            CapturedScope &scope{frame.scopes[open_scopes.back()]};
+            if (before < scope.start + scope.elapsed_time) {
+                return;
+            }
+            scope.subtree_end = static_cast<u32>(frame.scopes.size());
+            open_scopes.pop_back();
+        }
+    };
+
+    u32 thread_index{constants::u32_max};
+    for (auto it = m_frame_events.begin(); it != first_pending; ++it) {
+        const FloatingPointMicroseconds start{it->result.start - m_frame_start};
+        if (it->thread_index != thread_index) {
+            close_scopes(FloatingPointMicroseconds::max());
+            thread_index = it->thread_index;
+        }
+        close_scopes(start);
+
+        frame.scopes.push_back({it->result.name, start, it->result.elapsed_time, thread_index,
+                                static_cast<u32>(open_scopes.size()), 0});
+        open_scopes.push_back(static_cast<u32>(frame.scopes.size() - 1));
+    }
+    close_scopes(FloatingPointMicroseconds::max());
+
+    m_frame_events.erase(m_frame_events.begin(), first_pending);
+}
+
 } // namespace gouda::internal::profiler
\ No newline at end of file
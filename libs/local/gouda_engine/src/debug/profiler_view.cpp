@@ -0,0 +1,142 @@
+/**
+ * @file debug/profiler_view.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine ImGui view of the profiler's captured frames implementation
+ */
+#include "debug/profiler_view.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cfloat>
+
+#include "imgui.h"
+
+#include "debug/profiler.hpp"
+
+namespace gouda::internal::profiler {
+
+namespace internal {
+
+static f64 to_milliseconds(const FloatingPointMicroseconds time)
+{
+    return FloatingPointMilliseconds{time}.count();
+}
+
+// Siblings from begin up to end, each followed by its own subtree when expanded
+static void draw_scopes(const Vector<CapturedScope> &scopes, const u32 begin, const u32 end)
+{
+    for (u32 i = begin; i < end; i = scopes[i].subtree_end) {
+        const CapturedScope &scope{scopes[i]};
+        const bool is_leaf{scope.subtree_end == i + 1};
+        const ImGuiTreeNodeFlags flags{is_leaf ? ImGuiTreeNodeFlags_Leaf | ImGuiTreeNodeFlags_NoTreePushOnOpen
+                                               : ImGuiTreeNodeFlags_None};
+
+        const bool is_open{ImGui::TreeNodeEx(reinterpret_cast<void *>(static_cast<intptr_t>(i)), flags,
+                                             "%.*s  %.3f ms (at %.3f ms)", static_cast<int>(scope.name.size()),
+                                             scope.name.data(), to_milliseconds(scope.elapsed_time),
+                                             to_milliseconds(scope.start))};
+        if (!is_leaf && is_open) {
+            draw_scopes(scopes, i + 1, scope.subtree_end);
+            ImGui::TreePop();
+        }
+    }
+}
+
+} // namespace internal
+
+void DrawProfilerView()
+{
+    static int selected_age{0};
+    static bool show_captured{false};
+
+    Profiler &profiler{Profiler::Get()};
+
+    ImGui::SetNextWindowSize(ImVec2{460.0f, 520.0f}, ImGuiCond_FirstUseEver);
+    if (!ImGui::Begin("Profiler")) {
+        ImGui::End();
+        return;
+    }
+
+    bool is_capturing{profiler.IsFrameCaptureEnabled()};
+    if (ImGui::Checkbox("Capture frames", &is_capturing)) {
+        profiler.SetFrameCaptureEnabled(is_capturing);
+    }
+    ImGui::SameLine();
+    bool is_frozen{profiler.AreFramesFrozen()};
+    if (ImGui::Checkbox("Freeze (F5)", &is_frozen)) {
+        profiler.SetFramesFrozen(is_frozen);
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Capture (F6)")) {
+        profiler.CaptureFrame();
+    }
+
+    // Oldest frame on the left, as the history scrolls
+    const size_t frame_count{profiler.GetFrameCount()};
+    std::array<f32, Profiler::FRAME_HISTORY_SIZE> durations{};
+    for (size_t i = 0; i < frame_count; ++i) {
+        durations[i] = static_cast<f32>(internal::to_milliseconds(profiler.GetFrame(frame_count - 1 - i)->duration));
+    }
+    ImGui::PlotHistogram("##frame_times", durations.data(), static_cast<int>(frame_count), 0, "Frame time (ms)", 0.0f,
+                         FLT_MAX, ImVec2{-1.0f, 60.0f});
+
+    if (is_frozen && frame_count > 0) {
+        // The history is held still, so an age keeps pointing at the same frame
+        selected_age = std::min(selected_age, static_cast<int>(frame_count) - 1);
+        if (ImGui::IsItemClicked()) {
+            const ImVec2 plot_min{ImGui::GetItemRectMin()};
+            const f32 fraction{(ImGui::GetMousePos().x - plot_min.x) / ImGui::GetItemRectSize().x};
+            const auto index{static_cast<int>(fraction * static_cast<f32>(frame_count))};
+            selected_age = std::clamp(static_cast<int>(frame_count) - 1 - index, 0, static_cast<int>(frame_count) - 1);
+        }
+        ImGui::SliderInt("Frames back", &selected_age, 0, static_cast<int>(frame_count) - 1);
+    }
+    else {
+        selected_age = 0;
+    }
+
+    const CapturedFrame *captured_frame{profiler.GetCapturedFrame()};
+    if (captured_frame != nullptr) {
+        ImGui::Checkbox("Show captured frame", &show_captured);
+    }
+
+    const CapturedFrame *frame{show_captured && captured_frame != nullptr
+                                   ? captured_frame
+                                   : profiler.GetFrame(static_cast<size_t>(selected_age))};
+    if (frame == nullptr) {
+        ImGui::TextUnformatted(is_capturing ? "No frames yet." : "Frame capture is off.");
+        ImGui::End();
+        return;
+    }
+
+    ImGui::Text("Frame %llu: %.3f ms, %u scopes", static_cast<unsigned long long>(frame->frame_number),
+                internal::to_milliseconds(frame->duration), static_cast<u32>(frame->scopes.size()));
+    if (const u64 dropped{profiler.GetDroppedFrameEventCount()}; dropped > 0) {
+        ImGui::Text("Dropped scopes: %llu", static_cast<unsigned long long>(dropped));
+    }
+    ImGui::Separator();
+
+    // Scopes are grouped by thread, each thread's run is its own tree
+    const Vector<CapturedScope> &scopes{frame->scopes};
+    const auto scope_count{static_cast<u32>(scopes.size())};
+    u32 thread_begin{0};
+    while (thread_begin < scope_count) {
+        const u32 thread_index{scopes[thread_begin].thread_index};
+        u32 thread_end{thread_begin};
+        while (thread_end < scope_count && scopes[thread_end].thread_index == thread_index) {
+            ++thread_end;
+        }
+
+        if (ImGui::TreeNodeEx(reinterpret_cast<void *>(static_cast<intptr_t>(thread_index)),
+                              ImGuiTreeNodeFlags_DefaultOpen, "Thread %u", thread_index)) {
+            internal::draw_scopes(scopes, thread_begin, thread_end);
+            ImGui::TreePop();
+        }
+        thread_begin = thread_end;
+    }
+
+    ImGui::End();
+}
+
+} // namespace gouda::internal::profiler
@@ -0,0 +1,257 @@
+/**
+ * @file debug/trace_file.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine compact binary profiler trace implementation
+ */
+#include "debug/trace_file.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <optional>
+
+#include "containers/small_vector.hpp"
+#include "debug/logger.hpp"
+#include "utils/mapped_file.hpp"
+
+namespace gouda::internal::profiler {
+
+namespace {
+
+constexpr size_t JSON_WRITE_SIZE{1024 * 1024};
+
+// Reads the records of a trace, every read fails once the data runs out
+class TraceReader {
+public:
+    explicit TraceReader(const std::span<const std::byte> data) : m_data{data}, m_offset{0} {}
+
+    [[nodiscard]] bool IsAtEnd() const noexcept { return m_offset == m_data.size(); }
+
+    [[nodiscard]] std::optional<u8> ReadByte()
+    {
+        if (m_offset == m_data.size()) {
+            return std::nullopt;
+        }
+        return static_cast<u8>(m_data[m_offset++]);
+    }
+
+    [[nodiscard]] std::optional<u64> ReadVarint()
+    {
+        u64 value{0};
+        for (u32 shift = 0; shift < 64; shift += 7) {
+            const std::optional<u8> byte{ReadByte()};
+            if (!byte) {
+                return std::nullopt;
+            }
+            value |= static_cast<u64>(*byte & 0x7F) << shift;
+            if ((*byte & 0x80) == 0) {
+                return value;
+            }
+        }
+        return std::nullopt;
+    }
+
+    [[nodiscard]] std::optional<s64> ReadZigzag()
+    {
+        const std::optional<u64> value{ReadVarint()};
+        if (!value) {
+            return std::nullopt;
+        }
+        return static_cast<s64>((*value >> 1) ^ (0 - (*value & 1)));
+    }
+
+    [[nodiscard]] std::optional<f64> ReadF64()
+    {
+        if (m_data.size() - m_offset < sizeof(u64)) {
+            return std::nullopt;
+        }
+        u64 bits{0};
+        for (size_t i = 0; i < sizeof(u64); ++i) {
+            bits |= static_cast<u64>(m_data[m_offset + i]) << (i * 8);
+        }
+        m_offset += sizeof(u64);
+        return std::bit_cast<f64>(bits);
+    }
+
+    [[nodiscard]] std::optional<StringView> ReadBytes(const u64 size)
+    {
+        if (m_data.size() - m_offset < size) {
+            return std::nullopt;
+        }
+        const StringView bytes{reinterpret_cast<const char *>(m_data.data() + m_offset), static_cast<size_t>(size)};
+        m_offset += static_cast<size_t>(size);
+        return bytes;
+    }
+
+private:
+    std::span<const std::byte> m_data;
+    size_t m_offset;
+};
+
+FloatingPointMicroseconds from_trace_time(const s64 nanoseconds)
+{
+    return FloatingPointMicroseconds{static_cast<f64>(nanoseconds) / 1000.0};
+}
+
+} // namespace
+
+void append_json_trace_header(String &out, const int process_id)
+{
+    out.append("{\"otherData\":{},\"traceEvents\":[{}");
+    append_json_trace_thread_name(out, process_id, TRACE_GPU_THREAD_INDEX, "GPU");
+}
+
+void append_json_trace_thread_name(String &out, const int process_id, const u32 thread_index, const StringView name)
+{
+    std::format_to(std::back_inserter(out),
+                   ",{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":{},\"tid\":{},\"args\":{{\"name\":\"{}\"}}}}",
+                   process_id, thread_index, name);
+}
+
+void append_json_trace_scope(String &out, const int process_id, const u32 thread_index, const StringView name,
+                             const Microseconds elapsed_time, const FloatingPointMicroseconds start)
+{
+    std::format_to(std::back_inserter(out),
+                   ",{{\"cat\":\"function\",\"dur\":{},\"name\":\"{}\",\"ph\":\"X\",\"pid\":{},\"tid\":{},"
+                   "\"ts\":{:.3f}}}",
+                   elapsed_time.count(), name, process_id, thread_index, start.count());
+}
+
+void append_json_trace_counter(String &out, const int process_id, const StringView name,
+                               const FloatingPointMicroseconds timestamp, const f64 value)
+{
+    std::format_to(std::back_inserter(out),
+                   ",{{\"name\":\"{}\",\"ph\":\"C\",\"pid\":{},\"ts\":{:.3f},\"args\":{{\"value\":{}}}}}", name,
+                   process_id, timestamp.count(), value);
+}
+
+Expect<void, fs::Error> ConvertTraceToJson(const StringView trace_filepath, const StringView json_filepath)
+{
+    auto trace{fs::MappedFile::Open(trace_filepath)};
+    if (!trace) {
+        return std::unexpected(trace.error());
+    }
+
+    TraceReader reader{trace->GetData()};
+    const std::optional<StringView> magic{reader.ReadBytes(TRACE_MAGIC.size())};
+    if (!magic || !std::ranges::equal(*magic, TRACE_MAGIC) || reader.ReadByte() != TRACE_VERSION) {
+        return std::unexpected(fs::Error::FileReadError);
+    }
+    const std::optional<u64> process_id{reader.ReadVarint()};
+    if (!process_id) {
+        return std::unexpected(fs::Error::FileReadError);
+    }
+
+    std::ofstream output{FilePath{json_filepath}, std::ios::binary};
+    if (!output.is_open()) {
+        return std::unexpected(fs::Error::FileWriteError);
+    }
+
+    const int pid{static_cast<int>(*process_id)};
+    String batch;
+    batch.reserve(JSON_WRITE_SIZE + 4096);
+    append_json_trace_header(batch, pid);
+
+    Vector<StringView> names; // Views into the mapping
+    Vector<s64> thread_times; // Previous scope start of each thread
+    u32 thread_index{TRACE_GPU_THREAD_INDEX};
+    s64 counter_time{0};
+
+    // A record cut short, as the last one of a process that died is, ends the conversion and keeps what came before
+    const auto read_record = [&](const TraceRecord tag) -> bool {
+        switch (tag) {
+            case TraceRecord::Name: {
+                const std::optional<u64> size{reader.ReadVarint()};
+                const std::optional<StringView> name{size ? reader.ReadBytes(*size) : std::nullopt};
+                if (!name) {
+                    return false;
+                }
+                names.push_back(*name);
+                return true;
+            }
+            case TraceRecord::Thread: {
+                const std::optional<u64> index{reader.ReadVarint()};
+                if (!index) {
+                    return false;
+                }
+                thread_index = static_cast<u32>(*index);
+                if (thread_index >= thread_times.size()) {
+                    thread_times.resize(thread_index + 1, 0);
+                }
+                return true;
+            }
+            case TraceRecord::ThreadName: {
+                const std::optional<u64> index{reader.ReadVarint()};
+                const std::optional<u64> size{index ? reader.ReadVarint() : std::nullopt};
+                const std::optional<StringView> name{size ? reader.ReadBytes(*size) : std::nullopt};
+                if (!name) {
+                    return false;
+                }
+                append_json_trace_thread_name(batch, pid, static_cast<u32>(*index), *name);
+                return true;
+            }
+            case TraceRecord::Scope: {
+                const std::optional<u64> name{reader.ReadVarint()};
+                const std::optional<s64> start_delta{reader.ReadZigzag()};
+                const std::optional<u64> elapsed{reader.ReadVarint()};
+                if (!name || !start_delta || !elapsed || *name >= names.size() ||
+                    thread_index >= thread_times.size()) {
+                    return false;
+                }
+                thread_times[thread_index] += *start_delta;
+                append_json_trace_scope(batch, pid, thread_index, names[*name],
+                                        Microseconds{static_cast<s64>(*elapsed)},
+                                        from_trace_time(thread_times[thread_index]));
+                return true;
+            }
+            case TraceRecord::Counter:
+            case TraceRecord::Integer: {
+                const std::optional<u64> name{reader.ReadVarint()};
+                const std::optional<s64> time_delta{reader.ReadZigzag()};
+                std::optional<f64> value;
+                if (tag == TraceRecord::Counter) {
+                    value = reader.ReadF64();
+                }
+                else if (const std::optional<s64> integer{reader.ReadZigzag()}) {
+                    value = static_cast<f64>(*integer);
+                }
+                if (!name || !time_delta || !value || *name >= names.size()) {
+                    return false;
+                }
+                counter_time += *time_delta;
+                append_json_trace_counter(batch, pid, names[*name], from_trace_time(counter_time), *value);
+                return true;
+            }
+        }
+        return false;
+    };
+
+    bool is_complete{true};
+    while (!reader.IsAtEnd()) {
+        if (!read_record(static_cast<TraceRecord>(*reader.ReadByte()))) {
+            is_complete = false;
+            break;
+        }
+        if (batch.size() >= JSON_WRITE_SIZE) {
+            output.write(batch.data(), static_cast<std::streamsize>(batch.size()));
+            batch.clear();
+        }
+    }
+
+    batch.append(JSON_TRACE_FOOTER);
+    output.write(batch.data(), static_cast<std::streamsize>(batch.size()));
+    output.close();
+    if (output.fail()) {
+        return std::unexpected(fs::Error::FileWriteError);
+    }
+
+    if (!is_complete) {
+        ENGINE_LOG_WARNING("Trace '{}' ends in a partial record, converted up to it.", trace_filepath);
+    }
+    return {};
+}
+
+} // namespace gouda::internal::profiler
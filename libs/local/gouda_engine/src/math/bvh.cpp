@@ -0,0 +1,278 @@
+/**
+ * @file math/bvh.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine static bounding volume hierarchy implementation
+ */
+#include "math/bvh.hpp"
+
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <utility>
+
+namespace gouda::math {
+
+namespace internal {
+
+constexpr u32 MAX_LEAF_SIZE{4};
+constexpr u32 MAX_DEPTH{48}; // Deeper ranges become leaves, which bounds the query stack
+constexpr size_t SPLIT_BIN_COUNT{16};
+
+static AABB2D normalise(const AABB2D &bounds)
+{
+    return {{math::min(bounds.min.x, bounds.max.x), math::min(bounds.min.y, bounds.max.y)},
+            {math::max(bounds.min.x, bounds.max.x), math::max(bounds.min.y, bounds.max.y)}};
+}
+
+static AABB2D merge(const AABB2D &a, const AABB2D &b)
+{
+    return {{math::min(a.min.x, b.min.x), math::min(a.min.y, b.min.y)},
+            {math::max(a.max.x, b.max.x), math::max(a.max.y, b.max.y)}};
+}
+
+// The 2D surface area heuristic weighs a box by its half perimeter, how likely a random query is to hit it
+static f32 half_perimeter(const AABB2D &bounds) { return bounds.max.x - bounds.min.x + bounds.max.y - bounds.min.y; }
+
+static AABB2D empty_bounds() { return {Vec2{constants::f32_max}, Vec2{-constants::f32_max}}; }
+
+} // namespace internal
+
+BoundingVolumeHierarchy::BoundingVolumeHierarchy() = default;
+
+void BoundingVolumeHierarchy::Build(const std::span<const AABB2D> bounds)
+{
+    Clear();
+    m_entities.resize(bounds.size());
+    std::iota(m_entities.begin(), m_entities.end(), 0u);
+    BuildEntities(bounds);
+}
+
+void BoundingVolumeHierarchy::Build(const std::span<const AABB2D> bounds, const std::span<const u32> entities)
+{
+    Clear();
+    m_entities.resize(entities.size());
+    std::ranges::copy(entities, m_entities.begin());
+    BuildEntities(bounds);
+}
+
+void BoundingVolumeHierarchy::BuildEntities(const std::span<const AABB2D> bounds)
+{
+    if (m_entities.empty()) {
+        return;
+    }
+
+    m_entity_bounds.resize(bounds.size());
+    m_centres.resize(bounds.size());
+    for (const u32 entity : m_entities) {
+        const AABB2D entity_bounds{internal::normalise(bounds[entity])};
+        m_entity_bounds[entity] = entity_bounds;
+        m_centres[entity] = (entity_bounds.min + entity_bounds.max) * 0.5f;
+    }
+
+    // A binary tree with leaves of one or more entities never has more than 2n - 1 nodes
+    m_nodes.reserve(m_entities.size() * 2 - 1);
+    m_nodes.push_back(Node{});
+    BuildNode(0, 0, static_cast<u32>(m_entities.size()), 0);
+
+    gouda::Vector<AABB2D> leaf_bounds(m_entities.size());
+    for (size_t i = 0; i < m_entities.size(); ++i) {
+        leaf_bounds[i] = m_entity_bounds[m_entities[i]];
+    }
+    m_entity_bounds = std::move(leaf_bounds);
+    m_centres.clear();
+}
+
+bool BoundingVolumeHierarchy::Assign(gouda::Vector<Node> nodes, gouda::Vector<u32> entity_order,
+                                     gouda::Vector<AABB2D> entity_bounds, const size_t entity_count)
+{
+    Clear();
+    if (nodes.empty()) {
+        return entity_order.empty() && entity_bounds.empty();
+    }
+    if (entity_order.size() != entity_bounds.size()) {
+        return false;
+    }
+
+    // Queries trust the tree, so every node must be the child of exactly one earlier node, leaves must stay inside
+    // the entity order and the depth must fit the query stack
+    constexpr u32 unreached{constants::u32_max};
+    gouda::Vector<u32> depths(nodes.size(), unreached);
+    depths[0] = 0;
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        const Node &node{nodes[i]};
+        if (depths[i] == unreached) {
+            return false;
+        }
+        if (node.count > 0) {
+            if (node.first > entity_order.size() || node.count > entity_order.size() - node.first) {
+                return false;
+            }
+            continue;
+        }
+        if (node.first <= i || node.first >= nodes.size() - 1 || depths[i] >= internal::MAX_DEPTH ||
+            depths[node.first] != unreached || depths[node.first + 1] != unreached) {
+            return false;
+        }
+        depths[node.first] = depths[i] + 1;
+        depths[node.first + 1] = depths[i] + 1;
+    }
+    if (std::ranges::any_of(entity_order, [&](const u32 entity) { return entity >= entity_count; })) {
+        return false;
+    }
+
+    m_nodes = std::move(nodes);
+    m_entities = std::move(entity_order);
+    m_entity_bounds = std::move(entity_bounds);
+    return true;
+}
+
+void BoundingVolumeHierarchy::Clear()
+{
+    m_nodes.clear();
+    m_entities.clear();
+    m_entity_bounds.clear();
+    m_centres.clear();
+}
+
+void BoundingVolumeHierarchy::Query(const AABB2D &bounds, gouda::Vector<u32> &entities) const
+{
+    if (m_nodes.empty()) {
+        return;
+    }
+
+    const AABB2D query{internal::normalise(bounds)};
+
+    // The left child is visited first, so the stack never holds more than one pending sibling per level
+    std::array<u32, internal::MAX_DEPTH + 2> stack;
+    size_t stack_size{0};
+    stack[stack_size++] = 0;
+
+    while (stack_size > 0) {
+        const Node &node{m_nodes[stack[--stack_size]]};
+        if (!node.bounds.Intersects(query)) {
+            continue;
+        }
+
+        if (node.count == 0) {
+            stack[stack_size++] = node.first + 1;
+            stack[stack_size++] = node.first;
+            continue;
+        }
+
+        for (u32 i = node.first; i < node.first + node.count; ++i) {
+            if (m_entity_bounds[i].Intersects(query)) {
+                entities.push_back(m_entities[i]);
+            }
+        }
+    }
+}
+
+void BoundingVolumeHierarchy::QuerySegment(const Vec2 &from, const Vec2 &to, gouda::Vector<u32> &entities) const
+{
+    if (m_nodes.empty()) {
+        return;
+    }
+
+    std::array<u32, internal::MAX_DEPTH + 2> stack;
+    size_t stack_size{0};
+    stack[stack_size++] = 0;
+
+    while (stack_size > 0) {
+        const Node &node{m_nodes[stack[--stack_size]]};
+        if (!segment_intersects_aabb(from, to, node.bounds)) {
+            continue;
+        }
+
+        if (node.count == 0) {
+            stack[stack_size++] = node.first + 1;
+            stack[stack_size++] = node.first;
+            continue;
+        }
+
+        for (u32 i = node.first; i < node.first + node.count; ++i) {
+            if (segment_intersects_aabb(from, to, m_entity_bounds[i])) {
+                entities.push_back(m_entities[i]);
+            }
+        }
+    }
+}
+
+void BoundingVolumeHierarchy::BuildNode(const u32 node_index, const u32 begin, const u32 end, const u32 depth)
+{
+    AABB2D node_bounds{internal::empty_bounds()};
+    Vec2 centre_min{constants::f32_max};
+    Vec2 centre_max{-constants::f32_max};
+    for (u32 i = begin; i < end; ++i) {
+        const u32 entity{m_entities[i]};
+        node_bounds = internal::merge(node_bounds, m_entity_bounds[entity]);
+        centre_min = {math::min(centre_min.x, m_centres[entity].x), math::min(centre_min.y, m_centres[entity].y)};
+        centre_max = {math::max(centre_max.x, m_centres[entity].x), math::max(centre_max.y, m_centres[entity].y)};
+    }
+
+    m_nodes[node_index] = Node{node_bounds, begin, end - begin};
+
+    const Vec2 centre_extent{centre_max - centre_min};
+    const int axis{centre_extent.y > centre_extent.x ? 1 : 0};
+    const f32 extent{axis == 0 ? centre_extent.x : centre_extent.y};
+    if (end - begin <= internal::MAX_LEAF_SIZE || depth >= internal::MAX_DEPTH || extent <= 0.0f) {
+        return;
+    }
+
+    const f32 axis_min{axis == 0 ? centre_min.x : centre_min.y};
+    const f32 bin_scale{static_cast<f32>(internal::SPLIT_BIN_COUNT) / extent};
+    const auto bin_of = [&](const u32 entity) {
+        const f32 centre{axis == 0 ? m_centres[entity].x : m_centres[entity].y};
+        return math::min(static_cast<size_t>((centre - axis_min) * bin_scale), internal::SPLIT_BIN_COUNT - 1);
+    };
+
+    std::array<AABB2D, internal::SPLIT_BIN_COUNT> bin_bounds;
+    std::array<u32, internal::SPLIT_BIN_COUNT> bin_counts{};
+    bin_bounds.fill(internal::empty_bounds());
+    for (u32 i = begin; i < end; ++i) {
+        const size_t bin{bin_of(m_entities[i])};
+        bin_bounds[bin] = internal::merge(bin_bounds[bin], m_entity_bounds[m_entities[i]]);
+        ++bin_counts[bin];
+    }
+
+    // Sweeping from the right first leaves the cost of each split's right side ready for the left sweep
+    std::array<f32, internal::SPLIT_BIN_COUNT> right_costs{};
+    AABB2D right_bounds{internal::empty_bounds()};
+    u32 right_count{0};
+    for (size_t bin = internal::SPLIT_BIN_COUNT - 1; bin > 0; --bin) {
+        right_bounds = internal::merge(right_bounds, bin_bounds[bin]);
+        right_count += bin_counts[bin];
+        right_costs[bin] = right_count > 0 ? static_cast<f32>(right_count) * internal::half_perimeter(right_bounds)
+                                           : 0.0f;
+    }
+
+    // The lowest and highest centres fall in the first and last bins, so every split leaves both sides non empty
+    size_t best_split{1};
+    f32 best_cost{constants::f32_max};
+    AABB2D left_bounds{internal::empty_bounds()};
+    u32 left_count{0};
+    for (size_t split = 1; split < internal::SPLIT_BIN_COUNT; ++split) {
+        left_bounds = internal::merge(left_bounds, bin_bounds[split - 1]);
+        left_count += bin_counts[split - 1];
+        const f32 cost{static_cast<f32>(left_count) * internal::half_perimeter(left_bounds) + right_costs[split]};
+        if (cost < best_cost) {
+            best_cost = cost;
+            best_split = split;
+        }
+    }
+
+    const auto middle{std::partition(m_entities.begin() + begin, m_entities.begin() + end,
+                                     [&](const u32 entity) { return bin_of(entity) < best_split; })};
+    const u32 split_index{static_cast<u32>(middle - m_entities.begin())};
+
+    const u32 left_index{static_cast<u32>(m_nodes.size())};
+    m_nodes.push_back(Node{});
+    m_nodes.push_back(Node{});
+    m_nodes[node_index].first = left_index;
+    m_nodes[node_index].count = 0;
+
+    BuildNode(left_index, begin, split_index, depth + 1);
+    BuildNode(left_index + 1, split_index, end, depth + 1);
+}
+
+} // namespace gouda::math
@@ -2,6 +2,23 @@
  * @file math/matrix4x4.cpp
  * @author GoudaCheeseburgers
  * @date 2025-03-13
- * @brief Empty implementation
+ * @brief 4x4 Matrix SIMD dispatch implementation
  */
-#include "math/matrix4x4.hpp"
\ No newline at end of file
+#include "math/matrix4x4.hpp"
+
+#include "math/simd_kernels.hpp"
+
+namespace gouda::math::internal {
+
+void mat4_multiply(const f32 *lhs, const f32 *rhs, f32 *out) { GetSimdKernels().mat4_multiply(lhs, rhs, out); }
+
+void mat4_transform(const f32 *matrix, const f32 *vector, f32 *out)
+{
+    GetSimdKernels().mat4_transform(matrix, vector, out);
+}
+
+void mat4_transpose(const f32 *matrix, f32 *out) { GetSimdKernels().mat4_transpose(matrix, out); }
+
+bool mat4_inverse(const f32 *matrix, f32 *out) { return GetSimdKernels().mat4_inverse(matrix, out); }
+
+} // namespace gouda::math::internal
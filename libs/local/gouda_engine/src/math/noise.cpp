@@ -0,0 +1,396 @@
+/**
+ * @file math/noise.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine coherent 2D noise implementation
+ */
+#include "math/noise.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "debug/assert.hpp"
+#include "math/simd.hpp"
+
+namespace gouda::math {
+
+namespace internal {
+
+// Lattice coordinates are multiplied by these and the sum mixed like MurmurHash3's finalizer. particle_shader.comp
+// uses the same constants.
+static constexpr u32 NOISE_PRIME_X{0x27d4eb2du};
+static constexpr u32 NOISE_PRIME_Y{0x165667b1u};
+static constexpr u32 NOISE_MIX_1{0x85ebca6bu};
+static constexpr u32 NOISE_MIX_2{0xc2b2ae35u};
+static constexpr f32 NOISE_SQRT_2{1.41421356f};
+static constexpr f32 VALUE_NOISE_SCALE{1.0f / 8388608.0f}; // The top 24 bits of a hash to [0, 2)
+
+using FractalNoiseKernel = void (*)(const f32 *x, const f32 *y, f32 *out, size_t count, const NoiseSettings &settings);
+
+static f32 amplitude_sum(const NoiseSettings &settings)
+{
+    f32 sum{0.0f};
+    f32 amplitude{1.0f};
+    for (u32 octave = 0; octave < settings.octaves; ++octave) {
+        sum += amplitude;
+        amplitude *= settings.gain;
+    }
+    return sum;
+}
+
+// Scalar ----------------------------------------------------------------------------------------------------------
+static u32 hash_lattice(const u32 seed, const u32 hash_x, const u32 hash_y)
+{
+    u32 hash{seed + hash_x + hash_y};
+    hash ^= hash >> 15;
+    hash *= NOISE_MIX_1;
+    hash ^= hash >> 13;
+    hash *= NOISE_MIX_2;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+static f32 fade(const f32 t) { return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f); }
+
+// One of the four diagonals, or one of the four axes scaled to the same length, by the low three bits of the hash
+static f32 gradient(const u32 hash, const f32 dx, const f32 dy)
+{
+    if ((hash & 4u) != 0) {
+        const f32 axis{(hash & 2u) != 0 ? dx : dy};
+        return ((hash & 1u) != 0 ? -axis : axis) * NOISE_SQRT_2;
+    }
+    return ((hash & 1u) != 0 ? -dx : dx) + ((hash & 2u) != 0 ? -dy : dy);
+}
+
+static f32 lattice_value(const u32 hash) { return static_cast<f32>(hash >> 8) * VALUE_NOISE_SCALE - 1.0f; }
+
+static f32 noise_scalar(const bool is_perlin, const f32 x, const f32 y, const u32 seed)
+{
+    const f32 floor_x{std::floor(x)};
+    const f32 floor_y{std::floor(y)};
+    const u32 hash_x0{static_cast<u32>(static_cast<s32>(floor_x)) * NOISE_PRIME_X};
+    const u32 hash_y0{static_cast<u32>(static_cast<s32>(floor_y)) * NOISE_PRIME_Y};
+    const u32 hash_x1{hash_x0 + NOISE_PRIME_X};
+    const u32 hash_y1{hash_y0 + NOISE_PRIME_Y};
+    const u32 hash_00{hash_lattice(seed, hash_x0, hash_y0)};
+    const u32 hash_10{hash_lattice(seed, hash_x1, hash_y0)};
+    const u32 hash_01{hash_lattice(seed, hash_x0, hash_y1)};
+    const u32 hash_11{hash_lattice(seed, hash_x1, hash_y1)};
+
+    const f32 dx{x - floor_x};
+    const f32 dy{y - floor_y};
+    f32 n00, n10, n01, n11;
+    if (is_perlin) {
+        n00 = gradient(hash_00, dx, dy);
+        n10 = gradient(hash_10, dx - 1.0f, dy);
+        n01 = gradient(hash_01, dx, dy - 1.0f);
+        n11 = gradient(hash_11, dx - 1.0f, dy - 1.0f);
+    }
+    else {
+        n00 = lattice_value(hash_00);
+        n10 = lattice_value(hash_10);
+        n01 = lattice_value(hash_01);
+        n11 = lattice_value(hash_11);
+    }
+
+    const f32 u{fade(dx)};
+    const f32 v{fade(dy)};
+    const f32 bottom{n00 + (n10 - n00) * u};
+    const f32 top{n01 + (n11 - n01) * u};
+    return bottom + (top - bottom) * v;
+}
+
+static f32 fractal_noise_scalar_point(const f32 x, const f32 y, const NoiseSettings &settings, const f32 normalisation)
+{
+    const bool is_perlin{settings.type == NoiseType::Perlin};
+    f32 sum{0.0f};
+    f32 frequency{settings.frequency};
+    f32 amplitude{1.0f};
+    for (u32 octave = 0; octave < settings.octaves; ++octave) {
+        sum += noise_scalar(is_perlin, x * frequency, y * frequency, settings.seed + octave) * amplitude;
+        frequency *= settings.lacunarity;
+        amplitude *= settings.gain;
+    }
+    return sum * normalisation;
+}
+
+static void fractal_noise_scalar_range(const f32 *x, const f32 *y, f32 *out, const size_t begin, const size_t end,
+                                       const NoiseSettings &settings)
+{
+    const f32 normalisation{1.0f / amplitude_sum(settings)};
+    for (size_t i = begin; i < end; ++i) {
+        out[i] = fractal_noise_scalar_point(x[i], y[i], settings, normalisation);
+    }
+}
+
+static void fractal_noise_scalar(const f32 *x, const f32 *y, f32 *out, const size_t count,
+                                 const NoiseSettings &settings)
+{
+    fractal_noise_scalar_range(x, y, out, 0, count, settings);
+}
+
+// SSE4.1 ----------------------------------------------------------------------------------------------------------
+GOUDA_SIMD_TARGET("sse4.1")
+static __m128i hash_lattice_sse41(const __m128i seed, const __m128i hash_x, const __m128i hash_y)
+{
+    __m128i hash{_mm_add_epi32(_mm_add_epi32(seed, hash_x), hash_y)};
+    hash = _mm_xor_si128(hash, _mm_srli_epi32(hash, 15));
+    hash = _mm_mullo_epi32(hash, _mm_set1_epi32(static_cast<int>(NOISE_MIX_1)));
+    hash = _mm_xor_si128(hash, _mm_srli_epi32(hash, 13));
+    hash = _mm_mullo_epi32(hash, _mm_set1_epi32(static_cast<int>(NOISE_MIX_2)));
+    return _mm_xor_si128(hash, _mm_srli_epi32(hash, 16));
+}
+
+GOUDA_SIMD_TARGET("sse4.1")
+static __m128 fade_sse41(const __m128 t)
+{
+    const __m128 inner{_mm_add_ps(
+        _mm_mul_ps(t, _mm_sub_ps(_mm_mul_ps(t, _mm_set1_ps(6.0f)), _mm_set1_ps(15.0f))), _mm_set1_ps(10.0f))};
+    return _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(t, t), t), inner);
+}
+
+// The hash bits are shifted into the sign bit, which both negates by xor and selects by blend
+GOUDA_SIMD_TARGET("sse4.1")
+static __m128 gradient_sse41(const __m128i hash, const __m128 dx, const __m128 dy)
+{
+    const __m128 sign_x{_mm_castsi128_ps(_mm_slli_epi32(hash, 31))};
+    const __m128 bit_1{_mm_castsi128_ps(_mm_slli_epi32(hash, 30))};
+    const __m128 sign_y{_mm_and_ps(bit_1, _mm_set1_ps(-0.0f))};
+    const __m128 diagonal{_mm_add_ps(_mm_xor_ps(dx, sign_x), _mm_xor_ps(dy, sign_y))};
+    const __m128 axis{_mm_mul_ps(_mm_xor_ps(_mm_blendv_ps(dy, dx, bit_1), sign_x), _mm_set1_ps(NOISE_SQRT_2))};
+    return _mm_blendv_ps(diagonal, axis, _mm_castsi128_ps(_mm_slli_epi32(hash, 29)));
+}
+
+GOUDA_SIMD_TARGET("sse4.1")
+static __m128 lattice_value_sse41(const __m128i hash)
+{
+    return _mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(hash, 8)), _mm_set1_ps(VALUE_NOISE_SCALE)),
+                      _mm_set1_ps(1.0f));
+}
+
+GOUDA_SIMD_TARGET("sse4.1")
+static __m128 noise_sse41(const bool is_perlin, const __m128 x, const __m128 y, const __m128i seed)
+{
+    const __m128 floor_x{_mm_floor_ps(x)};
+    const __m128 floor_y{_mm_floor_ps(y)};
+    const __m128i prime_x{_mm_set1_epi32(static_cast<int>(NOISE_PRIME_X))};
+    const __m128i prime_y{_mm_set1_epi32(static_cast<int>(NOISE_PRIME_Y))};
+    const __m128i hash_x0{_mm_mullo_epi32(_mm_cvttps_epi32(floor_x), prime_x)};
+    const __m128i hash_y0{_mm_mullo_epi32(_mm_cvttps_epi32(floor_y), prime_y)};
+    const __m128i hash_x1{_mm_add_epi32(hash_x0, prime_x)};
+    const __m128i hash_y1{_mm_add_epi32(hash_y0, prime_y)};
+    const __m128i hash_00{hash_lattice_sse41(seed, hash_x0, hash_y0)};
+    const __m128i hash_10{hash_lattice_sse41(seed, hash_x1, hash_y0)};
+    const __m128i hash_01{hash_lattice_sse41(seed, hash_x0, hash_y1)};
+    const __m128i hash_11{hash_lattice_sse41(seed, hash_x1, hash_y1)};
+
+    const __m128 dx{_mm_sub_ps(x, floor_x)};
+    const __m128 dy{_mm_sub_ps(y, floor_y)};
+    __m128 n00, n10, n01, n11;
+    if (is_perlin) {
+        const __m128 one{_mm_set1_ps(1.0f)};
+        const __m128 dx1{_mm_sub_ps(dx, one)};
+        const __m128 dy1{_mm_sub_ps(dy, one)};
+        n00 = gradient_sse41(hash_00, dx, dy);
+        n10 = gradient_sse41(hash_10, dx1, dy);
+        n01 = gradient_sse41(hash_01, dx, dy1);
+        n11 = gradient_sse41(hash_11, dx1, dy1);
+    }
+    else {
+        n00 = lattice_value_sse41(hash_00);
+        n10 = lattice_value_sse41(hash_10);
+        n01 = lattice_value_sse41(hash_01);
+        n11 = lattice_value_sse41(hash_11);
+    }
+
+    const __m128 u{fade_sse41(dx)};
+    const __m128 v{fade_sse41(dy)};
+    const __m128 bottom{_mm_add_ps(n00, _mm_mul_ps(_mm_sub_ps(n10, n00), u))};
+    const __m128 top{_mm_add_ps(n01, _mm_mul_ps(_mm_sub_ps(n11, n01), u))};
+    return _mm_add_ps(bottom, _mm_mul_ps(_mm_sub_ps(top, bottom), v));
+}
+
+// Every octave of four points at a time, so the coordinates are read and the sums written once
+GOUDA_SIMD_TARGET("sse4.1")
+static void fractal_noise_sse41(const f32 *x, const f32 *y, f32 *out, const size_t count,
+                                const NoiseSettings &settings)
+{
+    const bool is_perlin{settings.type == NoiseType::Perlin};
+    const __m128 normalisation{_mm_set1_ps(1.0f / amplitude_sum(settings))};
+
+    size_t i{0};
+    for (; i + 4 <= count; i += 4) {
+        const __m128 point_x{_mm_loadu_ps(x + i)};
+        const __m128 point_y{_mm_loadu_ps(y + i)};
+        __m128 sum{_mm_setzero_ps()};
+        f32 frequency{settings.frequency};
+        f32 amplitude{1.0f};
+        for (u32 octave = 0; octave < settings.octaves; ++octave) {
+            const __m128 scale{_mm_set1_ps(frequency)};
+            const __m128i seed{_mm_set1_epi32(static_cast<int>(settings.seed + octave))};
+            const __m128 noise{noise_sse41(is_perlin, _mm_mul_ps(point_x, scale), _mm_mul_ps(point_y, scale), seed)};
+            sum = _mm_add_ps(sum, _mm_mul_ps(noise, _mm_set1_ps(amplitude)));
+            frequency *= settings.lacunarity;
+            amplitude *= settings.gain;
+        }
+        _mm_storeu_ps(out + i, _mm_mul_ps(sum, normalisation));
+    }
+
+    fractal_noise_scalar_range(x, y, out, i, count, settings);
+}
+
+// AVX2 ------------------------------------------------------------------------------------------------------------
+GOUDA_SIMD_TARGET("avx2")
+static __m256i hash_lattice_avx2(const __m256i seed, const __m256i hash_x, const __m256i hash_y)
+{
+    __m256i hash{_mm256_add_epi32(_mm256_add_epi32(seed, hash_x), hash_y)};
+    hash = _mm256_xor_si256(hash, _mm256_srli_epi32(hash, 15));
+    hash = _mm256_mullo_epi32(hash, _mm256_set1_epi32(static_cast<int>(NOISE_MIX_1)));
+    hash = _mm256_xor_si256(hash, _mm256_srli_epi32(hash, 13));
+    hash = _mm256_mullo_epi32(hash, _mm256_set1_epi32(static_cast<int>(NOISE_MIX_2)));
+    return _mm256_xor_si256(hash, _mm256_srli_epi32(hash, 16));
+}
+
+GOUDA_SIMD_TARGET("avx2")
+static __m256 fade_avx2(const __m256 t)
+{
+    const __m256 inner{_mm256_add_ps(
+        _mm256_mul_ps(t, _mm256_sub_ps(_mm256_mul_ps(t, _mm256_set1_ps(6.0f)), _mm256_set1_ps(15.0f))),
+        _mm256_set1_ps(10.0f))};
+    return _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(t, t), t), inner);
+}
+
+GOUDA_SIMD_TARGET("avx2")
+static __m256 gradient_avx2(const __m256i hash, const __m256 dx, const __m256 dy)
+{
+    const __m256 sign_x{_mm256_castsi256_ps(_mm256_slli_epi32(hash, 31))};
+    const __m256 bit_1{_mm256_castsi256_ps(_mm256_slli_epi32(hash, 30))};
+    const __m256 sign_y{_mm256_and_ps(bit_1, _mm256_set1_ps(-0.0f))};
+    const __m256 diagonal{_mm256_add_ps(_mm256_xor_ps(dx, sign_x), _mm256_xor_ps(dy, sign_y))};
+    const __m256 axis{
+        _mm256_mul_ps(_mm256_xor_ps(_mm256_blendv_ps(dy, dx, bit_1), sign_x), _mm256_set1_ps(NOISE_SQRT_2))};
+    return _mm256_blendv_ps(diagonal, axis, _mm256_castsi256_ps(_mm256_slli_epi32(hash, 29)));
+}
+
+GOUDA_SIMD_TARGET("avx2")
+static __m256 lattice_value_avx2(const __m256i hash)
+{
+    return _mm256_sub_ps(
+        _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(hash, 8)), _mm256_set1_ps(VALUE_NOISE_SCALE)),
+        _mm256_set1_ps(1.0f));
+}
+
+GOUDA_SIMD_TARGET("avx2")
+static __m256 noise_avx2(const bool is_perlin, const __m256 x, const __m256 y, const __m256i seed)
+{
+    const __m256 floor_x{_mm256_floor_ps(x)};
+    const __m256 floor_y{_mm256_floor_ps(y)};
+    const __m256i prime_x{_mm256_set1_epi32(static_cast<int>(NOISE_PRIME_X))};
+    const __m256i prime_y{_mm256_set1_epi32(static_cast<int>(NOISE_PRIME_Y))};
+    const __m256i hash_x0{_mm256_mullo_epi32(_mm256_cvttps_epi32(floor_x), prime_x)};
+    const __m256i hash_y0{_mm256_mullo_epi32(_mm256_cvttps_epi32(floor_y), prime_y)};
+    const __m256i hash_x1{_mm256_add_epi32(hash_x0, prime_x)};
+    const __m256i hash_y1{_mm256_add_epi32(hash_y0, prime_y)};
+    const __m256i hash_00{hash_lattice_avx2(seed, hash_x0, hash_y0)};
+    const __m256i hash_10{hash_lattice_avx2(seed, hash_x1, hash_y0)};
+    const __m256i hash_01{hash_lattice_avx2(seed, hash_x0, hash_y1)};
+    const __m256i hash_11{hash_lattice_avx2(seed, hash_x1, hash_y1)};
+
+    const __m256 dx{_mm256_sub_ps(x, floor_x)};
+    const __m256 dy{_mm256_sub_ps(y, floor_y)};
+    __m256 n00, n10, n01, n11;
+    if (is_perlin) {
+        const __m256 one{_mm256_set1_ps(1.0f)};
+        const __m256 dx1{_mm256_sub_ps(dx, one)};
+        const __m256 dy1{_mm256_sub_ps(dy, one)};
+        n00 = gradient_avx2(hash_00, dx, dy);
+        n10 = gradient_avx2(hash_10, dx1, dy);
+        n01 = gradient_avx2(hash_01, dx, dy1);
+        n11 = gradient_avx2(hash_11, dx1, dy1);
+    }
+    else {
+        n00 = lattice_value_avx2(hash_00);
+        n10 = lattice_value_avx2(hash_10);
+        n01 = lattice_value_avx2(hash_01);
+        n11 = lattice_value_avx2(hash_11);
+    }
+
+    const __m256 u{fade_avx2(dx)};
+    const __m256 v{fade_avx2(dy)};
+    const __m256 bottom{_mm256_add_ps(n00, _mm256_mul_ps(_mm256_sub_ps(n10, n00), u))};
+    const __m256 top{_mm256_add_ps(n01, _mm256_mul_ps(_mm256_sub_ps(n11, n01), u))};
+    return _mm256_add_ps(bottom, _mm256_mul_ps(_mm256_sub_ps(top, bottom), v));
+}
+
+GOUDA_SIMD_TARGET("avx2")
+static void fractal_noise_avx2(const f32 *x, const f32 *y, f32 *out, const size_t count, const NoiseSettings &settings)
+{
+    const bool is_perlin{settings.type == NoiseType::Perlin};
+    const __m256 normalisation{_mm256_set1_ps(1.0f / amplitude_sum(settings))};
+
+    size_t i{0};
+    for (; i + 8 <= count; i += 8) {
+        const __m256 point_x{_mm256_loadu_ps(x + i)};
+        const __m256 point_y{_mm256_loadu_ps(y + i)};
+        __m256 sum{_mm256_setzero_ps()};
+        f32 frequency{settings.frequency};
+        f32 amplitude{1.0f};
+        for (u32 octave = 0; octave < settings.octaves; ++octave) {
+            const __m256 scale{_mm256_set1_ps(frequency)};
+            const __m256i seed{_mm256_set1_epi32(static_cast<int>(settings.seed + octave))};
+            const __m256 noise{
+                noise_avx2(is_perlin, _mm256_mul_ps(point_x, scale), _mm256_mul_ps(point_y, scale), seed)};
+            sum = _mm256_add_ps(sum, _mm256_mul_ps(noise, _mm256_set1_ps(amplitude)));
+            frequency *= settings.lacunarity;
+            amplitude *= settings.gain;
+        }
+        _mm256_storeu_ps(out + i, _mm256_mul_ps(sum, normalisation));
+    }
+
+    fractal_noise_scalar_range(x, y, out, i, count, settings);
+}
+
+static FractalNoiseKernel get_fractal_noise_kernel()
+{
+    static const FractalNoiseKernel kernel{[]() -> FractalNoiseKernel {
+        switch (GetSimdType()) {
+            case SimdType::AVX2:
+                return fractal_noise_avx2;
+            case SimdType::SSE4_1:
+                return fractal_noise_sse41;
+            default:
+                return fractal_noise_scalar;
+        }
+    }()};
+    return kernel;
+}
+
+// Without an octave there is nothing to normalise by
+static NoiseSettings with_octave(const NoiseSettings &settings)
+{
+    NoiseSettings clamped{settings};
+    clamped.octaves = std::max(settings.octaves, 1u);
+    return clamped;
+}
+
+} // namespace internal
+
+f32 value_noise(const f32 x, const f32 y, const u32 seed) { return internal::noise_scalar(false, x, y, seed); }
+
+f32 perlin_noise(const f32 x, const f32 y, const u32 seed) { return internal::noise_scalar(true, x, y, seed); }
+
+f32 fractal_noise(const f32 x, const f32 y, const NoiseSettings &settings)
+{
+    const NoiseSettings clamped{internal::with_octave(settings)};
+    return internal::fractal_noise_scalar_point(x, y, clamped, 1.0f / internal::amplitude_sum(clamped));
+}
+
+void fractal_noise(const std::span<const f32> x, const std::span<const f32> y, const std::span<f32> out,
+                   const NoiseSettings &settings)
+{
+    ASSERT(x.size() == y.size(), "Noise coordinate columns differ in length.");
+    ASSERT(out.size() >= x.size(), "Output span is smaller than the points to sample.");
+    internal::get_fractal_noise_kernel()(x.data(), y.data(), out.data(), x.size(), internal::with_octave(settings));
+}
+
+} // namespace gouda::math
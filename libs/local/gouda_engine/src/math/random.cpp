@@ -6,6 +6,7 @@
  */
 #include "math/random.hpp"
 
+#include <algorithm>
 #include <array>
 #include <numeric> // For std::accumulate
 #include <random>
@@ -13,6 +14,23 @@
 namespace gouda {
 namespace math {
 
+namespace {
+
+// PCG32's multiplier and output permutation (XSH RR), the same as pcg32 uses
+constexpr u64 PCG_MULTIPLIER{6364136223846793005ull};
+
+u32 PcgOutput(const u64 state)
+{
+    const auto xor_shifted{static_cast<u32>(((state >> 18u) ^ state) >> 27u)};
+    const auto rotation{static_cast<u32>(state >> 59u)};
+    return (xor_shifted >> rotation) | (xor_shifted << ((0u - rotation) & 31u));
+}
+
+// The top 24 bits fit a float's mantissa exactly, so every value is equally likely and below 1
+f32 ToUnitFloat(const u32 value) { return static_cast<f32>(value >> 8u) * 0x1.0p-24f; }
+
+} // namespace
+
 u32 GenerateSeed()
 {
     std::random_device rd;
@@ -36,6 +54,21 @@ f32 BaseRNG::GetFloat(f32 min, f32 max)
     return dist(rng);
 }
 
+void BaseRNG::Fill(const std::span<u32> values)
+{
+    for (u32 &value : values) {
+        value = rng();
+    }
+}
+
+void BaseRNG::Fill(const std::span<f32> values, const f32 min, const f32 max)
+{
+    const f32 range{max - min};
+    for (f32 &value : values) {
+        value = min + range * ToUnitFloat(rng());
+    }
+}
+
 ThreadSafeRNG::ThreadSafeRNG(u32 seed) : BaseRNG(seed) {}
 
 u32 ThreadSafeRNG::operator()()
@@ -58,6 +91,62 @@ f32 ThreadSafeRNG::GetFloat(f32 min, f32 max)
     return WithLock([this, min, max] { return BaseRNG::GetFloat(min, max); });
 }
 
+void ThreadSafeRNG::Fill(const std::span<u32> values)
+{
+    WithLock([this, values] { BaseRNG::Fill(values); });
+}
+
+void ThreadSafeRNG::Fill(const std::span<f32> values, const f32 min, const f32 max)
+{
+    WithLock([this, values, min, max] { BaseRNG::Fill(values, min, max); });
+}
+
+MultiStreamRNG::MultiStreamRNG(const u32 seed)
+{
+    // Seeded like pcg32, each stream on its own increment
+    for (size_t stream = 0; stream < STREAM_COUNT; ++stream) {
+        m_increment[stream] = (static_cast<u64>(stream) << 1u) | 1u;
+        m_state[stream] = m_increment[stream] + seed;
+        m_state[stream] = m_state[stream] * PCG_MULTIPLIER + m_increment[stream];
+    }
+}
+
+void MultiStreamRNG::NextBlock(u32 *values)
+{
+    for (size_t stream = 0; stream < STREAM_COUNT; ++stream) {
+        const u64 state{m_state[stream]};
+        m_state[stream] = state * PCG_MULTIPLIER + m_increment[stream];
+        values[stream] = PcgOutput(state);
+    }
+}
+
+void MultiStreamRNG::Fill(const std::span<u32> values)
+{
+    // Whole blocks straight into the span, a partial one at the end goes through a copy and the rest is dropped
+    size_t i{0};
+    for (; i + STREAM_COUNT <= values.size(); i += STREAM_COUNT) {
+        NextBlock(values.data() + i);
+    }
+    if (i < values.size()) {
+        std::array<u32, STREAM_COUNT> block{};
+        NextBlock(block.data());
+        std::copy_n(block.begin(), values.size() - i, values.begin() + static_cast<std::ptrdiff_t>(i));
+    }
+}
+
+void MultiStreamRNG::Fill(const std::span<f32> values, const f32 min, const f32 max)
+{
+    const f32 range{max - min};
+    std::array<u32, STREAM_COUNT> block{};
+    for (size_t i = 0; i < values.size(); i += STREAM_COUNT) {
+        NextBlock(block.data());
+        const size_t count{std::min(STREAM_COUNT, values.size() - i)};
+        for (size_t lane = 0; lane < count; ++lane) {
+            values[i + lane] = min + range * ToUnitFloat(block[lane]);
+        }
+    }
+}
+
 BaseRNG &GetGlobalRNG()
 {
     static BaseRNG rng(GenerateSeed());
@@ -70,5 +159,17 @@ ThreadSafeRNG &GetGlobalThreadSafeRNG()
     return rng;
 }
 
+BaseRNG &GetThreadRNG()
+{
+    thread_local BaseRNG rng(GenerateSeed());
+    return rng;
+}
+
+MultiStreamRNG &GetThreadMultiStreamRNG()
+{
+    thread_local MultiStreamRNG rng(GenerateSeed());
+    return rng;
+}
+
 } // namespace math
 } // namespace gouda
\ No newline at end of file
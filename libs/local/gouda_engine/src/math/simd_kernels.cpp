@@ -0,0 +1,980 @@
+/**
+ * @file math/simd_kernels.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine runtime dispatched SIMD batch kernels implementation
+ */
+#include "math/simd_kernels.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace gouda::math {
+
+static_assert(sizeof(Vec3) == 3 * sizeof(f32), "Batched kernels expect tightly packed Vec3");
+static_assert(sizeof(AABB2D) == 4 * sizeof(f32), "Batched kernels expect AABB2D as min.x, min.y, max.x, max.y");
+static_assert(sizeof(Sphere) == 4 * sizeof(f32), "Batched kernels expect Sphere as center.x, .y, .z, radius");
+
+namespace internal {
+
+// Scalar ----------------------------------------------------------------------------------------------------------
+static void Mat4MultiplyScalar(const f32 *lhs, const f32 *rhs, f32 *out)
+{
+    for (size_t col = 0; col < 4; ++col) {
+        for (size_t row = 0; row < 4; ++row) {
+            out[row + col * 4] = lhs[row + 0 * 4] * rhs[0 + col * 4] + lhs[row + 1 * 4] * rhs[1 + col * 4] +
+                                 lhs[row + 2 * 4] * rhs[2 + col * 4] + lhs[row + 3 * 4] * rhs[3 + col * 4];
+        }
+    }
+}
+
+static void TransformPointsScalar(const f32 *matrix, const Vec3 *points, Vec3 *out, const size_t count)
+{
+    for (size_t i = 0; i < count; ++i) {
+        const Vec3 point{points[i]};
+        for (size_t row = 0; row < 3; ++row) {
+            out[i][row] = matrix[row] * point.x + matrix[row + 4] * point.y + matrix[row + 8] * point.z +
+                          matrix[row + 12];
+        }
+    }
+}
+
+static void CullAABBsScalar(const AABB2D *boxes, const AABB2D &view, u8 *visible, const size_t count)
+{
+    for (size_t i = 0; i < count; ++i) {
+        visible[i] = boxes[i].Intersects(view) ? 1 : 0;
+    }
+}
+
+static void CullSpheresFrustumScalar(const Frustum &frustum, const Sphere *spheres, u8 *visible, const size_t count)
+{
+    for (size_t i = 0; i < count; ++i) {
+        visible[i] = frustum.Intersects(spheres[i]) ? 1 : 0;
+    }
+}
+
+static void CullAABBsFrustumScalar(const Frustum &frustum, const AABB3D *boxes, u8 *visible, const size_t count)
+{
+    for (size_t i = 0; i < count; ++i) {
+        visible[i] = frustum.Intersects(boxes[i]) ? 1 : 0;
+    }
+}
+
+// The planes as columns, for the kernels that test one box against several planes at once. Padded to eight lanes
+// with planes everything is in front of.
+struct FrustumPlaneColumns {
+    static constexpr size_t LANE_COUNT{8};
+
+    alignas(32) f32 normal_x[LANE_COUNT];
+    alignas(32) f32 normal_y[LANE_COUNT];
+    alignas(32) f32 normal_z[LANE_COUNT];
+    alignas(32) f32 distance[LANE_COUNT];
+    alignas(32) f32 abs_normal_x[LANE_COUNT];
+    alignas(32) f32 abs_normal_y[LANE_COUNT];
+    alignas(32) f32 abs_normal_z[LANE_COUNT];
+};
+
+static FrustumPlaneColumns MakeFrustumPlaneColumns(const Frustum &frustum)
+{
+    FrustumPlaneColumns columns{};
+    for (size_t lane = 0; lane < FrustumPlaneColumns::LANE_COUNT; ++lane) {
+        const Plane plane{lane < frustum.planes.size() ? frustum.planes[lane] : Plane{Vec3{0.0f}, 1.0f}};
+        columns.normal_x[lane] = plane.normal.x;
+        columns.normal_y[lane] = plane.normal.y;
+        columns.normal_z[lane] = plane.normal.z;
+        columns.distance[lane] = plane.distance;
+        columns.abs_normal_x[lane] = std::abs(plane.normal.x);
+        columns.abs_normal_y[lane] = std::abs(plane.normal.y);
+        columns.abs_normal_z[lane] = std::abs(plane.normal.z);
+    }
+    return columns;
+}
+
+static bool IntersectsScalar(const AABB2DStreams &boxes, const AABB2D &query, const size_t i)
+{
+    return !(boxes.max_x[i] < query.min.x || boxes.min_x[i] > query.max.x || boxes.max_y[i] < query.min.y ||
+             boxes.min_y[i] > query.max.y);
+}
+
+static void IntersectAABBsMaskScalarRange(const AABB2DStreams &boxes, const AABB2D &query, u64 *mask,
+                                          const size_t begin, const size_t end)
+{
+    for (size_t i = begin; i < end; ++i) {
+        if (IntersectsScalar(boxes, query, i)) {
+            mask[i / 64] |= u64{1} << (i % 64);
+        }
+    }
+}
+
+static void IntersectAABBsMaskScalar(const AABB2DStreams &boxes, const AABB2D &query, u64 *mask, const size_t count)
+{
+    std::fill_n(mask, (count + 63) / 64, u64{0});
+    IntersectAABBsMaskScalarRange(boxes, query, mask, 0, count);
+}
+
+static size_t IntersectAABBsIndicesScalarRange(const AABB2DStreams &boxes, const AABB2D &query, u32 *indices,
+                                               const size_t begin, const size_t end)
+{
+    size_t written{0};
+    for (size_t i = begin; i < end; ++i) {
+        indices[written] = static_cast<u32>(i);
+        written += IntersectsScalar(boxes, query, i) ? 1 : 0; // Branchless, the slot is overwritten on a miss
+    }
+    return written;
+}
+
+static size_t IntersectAABBsIndicesScalar(const AABB2DStreams &boxes, const AABB2D &query, u32 *indices,
+                                          const size_t count)
+{
+    return IntersectAABBsIndicesScalarRange(boxes, query, indices, 0, count);
+}
+
+static void Mat4TransformScalar(const f32 *matrix, const f32 *vector, f32 *out)
+{
+    for (size_t row = 0; row < 4; ++row) {
+        out[row] = matrix[row] * vector[0] + matrix[row + 4] * vector[1] + matrix[row + 8] * vector[2] +
+                   matrix[row + 12] * vector[3];
+    }
+}
+
+static void Mat4TransposeScalar(const f32 *matrix, f32 *out)
+{
+    for (size_t col = 0; col < 4; ++col) {
+        for (size_t row = 0; row < 4; ++row) {
+            out[col + row * 4] = matrix[row + col * 4];
+        }
+    }
+}
+
+static bool Mat4InverseScalar(const f32 *m, f32 *out)
+{
+    // Cofactor expansion, the layout does not matter since inverse(transpose(M)) == transpose(inverse(M))
+    f32 inv[16];
+    inv[0] = m[5] * m[10] * m[15] - m[5] * m[11] * m[14] - m[9] * m[6] * m[15] + m[9] * m[7] * m[14] +
+             m[13] * m[6] * m[11] - m[13] * m[7] * m[10];
+    inv[4] = -m[4] * m[10] * m[15] + m[4] * m[11] * m[14] + m[8] * m[6] * m[15] - m[8] * m[7] * m[14] -
+             m[12] * m[6] * m[11] + m[12] * m[7] * m[10];
+    inv[8] = m[4] * m[9] * m[15] - m[4] * m[11] * m[13] - m[8] * m[5] * m[15] + m[8] * m[7] * m[13] +
+             m[12] * m[5] * m[11] - m[12] * m[7] * m[9];
+    inv[12] = -m[4] * m[9] * m[14] + m[4] * m[10] * m[13] + m[8] * m[5] * m[14] - m[8] * m[6] * m[13] -
+              m[12] * m[5] * m[10] + m[12] * m[6] * m[9];
+    inv[1] = -m[1] * m[10] * m[15] + m[1] * m[11] * m[14] + m[9] * m[2] * m[15] - m[9] * m[3] * m[14] -
+             m[13] * m[2] * m[11] + m[13] * m[3] * m[10];
+    inv[5] = m[0] * m[10] * m[15] - m[0] * m[11] * m[14] - m[8] * m[2] * m[15] + m[8] * m[3] * m[14] +
+             m[12] * m[2] * m[11] - m[12] * m[3] * m[10];
+    inv[9] = -m[0] * m[9] * m[15] + m[0] * m[11] * m[13] + m[8] * m[1] * m[15] - m[8] * m[3] * m[13] -
+             m[12] * m[1] * m[11] + m[12] * m[3] * m[9];
+    inv[13] = m[0] * m[9] * m[14] - m[0] * m[10] * m[13] - m[8] * m[1] * m[14] + m[8] * m[2] * m[13] +
+              m[12] * m[1] * m[10] - m[12] * m[2] * m[9];
+    inv[2] = m[1] * m[6] * m[15] - m[1] * m[7] * m[14] - m[5] * m[2] * m[15] + m[5] * m[3] * m[14] +
+             m[13] * m[2] * m[7] - m[13] * m[3] * m[6];
+    inv[6] = -m[0] * m[6] * m[15] + m[0] * m[7] * m[14] + m[4] * m[2] * m[15] - m[4] * m[3] * m[14] -
+             m[12] * m[2] * m[7] + m[12] * m[3] * m[6];
+    inv[10] = m[0] * m[5] * m[15] - m[0] * m[7] * m[13] - m[4] * m[1] * m[15] + m[4] * m[3] * m[13] +
+              m[12] * m[1] * m[7] - m[12] * m[3] * m[5];
+    inv[14] = -m[0] * m[5] * m[14] + m[0] * m[6] * m[13] + m[4] * m[1] * m[14] - m[4] * m[2] * m[13] -
+              m[12] * m[1] * m[6] + m[12] * m[2] * m[5];
+    inv[3] = -m[1] * m[6] * m[11] + m[1] * m[7] * m[10] + m[5] * m[2] * m[11] - m[5] * m[3] * m[10] -
+             m[9] * m[2] * m[7] + m[9] * m[3] * m[6];
+    inv[7] = m[0] * m[6] * m[11] - m[0] * m[7] * m[10] - m[4] * m[2] * m[11] + m[4] * m[3] * m[10] +
+             m[8] * m[2] * m[7] - m[8] * m[3] * m[6];
+    inv[11] = -m[0] * m[5] * m[11] + m[0] * m[7] * m[9] + m[4] * m[1] * m[11] - m[4] * m[3] * m[9] -
+              m[8] * m[1] * m[7] + m[8] * m[3] * m[5];
+    inv[15] = m[0] * m[5] * m[10] - m[0] * m[6] * m[9] - m[4] * m[1] * m[10] + m[4] * m[2] * m[9] +
+              m[8] * m[1] * m[6] - m[8] * m[2] * m[5];
+
+    const f32 determinant{m[0] * inv[0] + m[1] * inv[4] + m[2] * inv[8] + m[3] * inv[12]};
+    if (determinant == 0.0f) {
+        return false;
+    }
+
+    const f32 inverse_determinant{1.0f / determinant};
+    for (size_t i = 0; i < 16; ++i) {
+        out[i] = inv[i] * inverse_determinant;
+    }
+    return true;
+}
+
+static void TransformAABBsScalar(const f32 *matrix, const AABB2D *boxes, AABB2D *out, const size_t count)
+{
+    for (size_t i = 0; i < count; ++i) {
+        const f32 center_x{(boxes[i].min.x + boxes[i].max.x) * 0.5f};
+        const f32 center_y{(boxes[i].min.y + boxes[i].max.y) * 0.5f};
+        const f32 extent_x{(boxes[i].max.x - boxes[i].min.x) * 0.5f};
+        const f32 extent_y{(boxes[i].max.y - boxes[i].min.y) * 0.5f};
+
+        const f32 new_center_x{matrix[0] * center_x + matrix[4] * center_y + matrix[12]};
+        const f32 new_center_y{matrix[1] * center_x + matrix[5] * center_y + matrix[13]};
+        const f32 new_extent_x{std::abs(matrix[0]) * extent_x + std::abs(matrix[4]) * extent_y};
+        const f32 new_extent_y{std::abs(matrix[1]) * extent_x + std::abs(matrix[5]) * extent_y};
+
+        out[i] = {{new_center_x - new_extent_x, new_center_y - new_extent_y},
+                  {new_center_x + new_extent_x, new_center_y + new_extent_y}};
+    }
+}
+
+static void IntegrateParticlesScalarRange(const ParticleStreams &streams, const size_t begin, const size_t end,
+                                          const f32 delta_time, const Vec3 &gravity)
+{
+    for (size_t i = begin; i < end; ++i) {
+        streams.velocity_x[i] += gravity.x * delta_time;
+        streams.velocity_y[i] += gravity.y * delta_time;
+        streams.velocity_z[i] += gravity.z * delta_time;
+        streams.position_x[i] += streams.velocity_x[i] * delta_time;
+        streams.position_y[i] += streams.velocity_y[i] * delta_time;
+        streams.position_z[i] += streams.velocity_z[i] * delta_time;
+        streams.lifetime[i] -= delta_time;
+    }
+}
+
+static void IntegrateParticlesScalar(const ParticleStreams &streams, const size_t count, const f32 delta_time,
+                                     const Vec3 &gravity)
+{
+    IntegrateParticlesScalarRange(streams, 0, count, delta_time, gravity);
+}
+
+// SSE4.1 ----------------------------------------------------------------------------------------------------------
+GOUDA_SIMD_TARGET("sse4.1")
+static void Mat4MultiplySSE41(const f32 *lhs, const f32 *rhs, f32 *out)
+{
+    const __m128 column0{_mm_loadu_ps(lhs + 0)};
+    const __m128 column1{_mm_loadu_ps(lhs + 4)};
+    const __m128 column2{_mm_loadu_ps(lhs + 8)};
+    const __m128 column3{_mm_loadu_ps(lhs + 12)};
+
+    // Each result column is the lhs columns weighted by the matching rhs column
+    for (size_t col = 0; col < 4; ++col) {
+        const f32 *weights{rhs + col * 4};
+        __m128 result{_mm_mul_ps(column0, _mm_set1_ps(weights[0]))};
+        result = _mm_add_ps(result, _mm_mul_ps(column1, _mm_set1_ps(weights[1])));
+        result = _mm_add_ps(result, _mm_mul_ps(column2, _mm_set1_ps(weights[2])));
+        result = _mm_add_ps(result, _mm_mul_ps(column3, _mm_set1_ps(weights[3])));
+        _mm_storeu_ps(out + col * 4, result);
+    }
+}
+
+GOUDA_SIMD_TARGET("sse4.1")
+static void TransformPointsSSE41(const f32 *matrix, const Vec3 *points, Vec3 *out, const size_t count)
+{
+    const __m128 column0{_mm_loadu_ps(matrix + 0)};
+    const __m128 column1{_mm_loadu_ps(matrix + 4)};
+    const __m128 column2{_mm_loadu_ps(matrix + 8)};
+    const __m128 column3{_mm_loadu_ps(matrix + 12)};
+
+    for (size_t i = 0; i < count; ++i) {
+        const Vec3 point{points[i]};
+        __m128 result{_mm_add_ps(_mm_mul_ps(column0, _mm_set1_ps(point.x)), column3)};
+        result = _mm_add_ps(result, _mm_mul_ps(column1, _mm_set1_ps(point.y)));
+        result = _mm_add_ps(result, _mm_mul_ps(column2, _mm_set1_ps(point.z)));
+
+        alignas(16) f32 transformed[4];
+        _mm_store_ps(transformed, result);
+        out[i] = Vec3{transformed[0], transformed[1], transformed[2]};
+    }
+}
+
+GOUDA_SIMD_TARGET("sse4.1")
+static void CullAABBsSSE41(const AABB2D *boxes, const AABB2D &view, u8 *visible, const size_t count)
+{
+    const __m128 view_min_x{_mm_set1_ps(view.min.x)};
+    const __m128 view_min_y{_mm_set1_ps(view.min.y)};
+    const __m128 view_max_x{_mm_set1_ps(view.max.x)};
+    const __m128 view_max_y{_mm_set1_ps(view.max.y)};
+    const f32 *data{reinterpret_cast<const f32 *>(boxes)};
+
+    size_t i{0};
+    for (; i + 4 <= count; i += 4) {
+        // Rows become min_x, min_y, max_x, max_y of four boxes
+        __m128 min_x{_mm_loadu_ps(data + i * 4 + 0)};
+        __m128 min_y{_mm_loadu_ps(data + i * 4 + 4)};
+        __m128 max_x{_mm_loadu_ps(data + i * 4 + 8)};
+        __m128 max_y{_mm_loadu_ps(data + i * 4 + 12)};
+        _MM_TRANSPOSE4_PS(min_x, min_y, max_x, max_y);
+
+        __m128 inside{_mm_cmpge_ps(max_x, view_min_x)};
+        inside = _mm_and_ps(inside, _mm_cmple_ps(min_x, view_max_x));
+        inside = _mm_and_ps(inside, _mm_cmpge_ps(max_y, view_min_y));
+        inside = _mm_and_ps(inside, _mm_cmple_ps(min_y, view_max_y));
+
+        const u32 mask{static_cast<u32>(_mm_movemask_ps(inside))};
+        for (u32 lane = 0; lane < 4; ++lane) {
+            visible[i + lane] = static_cast<u8>((mask >> lane) & 1u);
+        }
+    }
+
+    CullAABBsScalar(boxes + i, view, visible + i, count - i);
+}
+
+// Four spheres per step, each plane is broadcast and tested against all four
+GOUDA_SIMD_TARGET("sse4.1")
+static void CullSpheresFrustumSSE41(const Frustum &frustum, const Sphere *spheres, u8 *visible, const size_t count)
+{
+    __m128 normal_x[Frustum::PLANE_COUNT];
+    __m128 normal_y[Frustum::PLANE_COUNT];
+    __m128 normal_z[Frustum::PLANE_COUNT];
+    __m128 distance[Frustum::PLANE_COUNT];
+    for (size_t plane = 0; plane < Frustum::PLANE_COUNT; ++plane) {
+        normal_x[plane] = _mm_set1_ps(frustum.planes[plane].normal.x);
+        normal_y[plane] = _mm_set1_ps(frustum.planes[plane].normal.y);
+        normal_z[plane] = _mm_set1_ps(frustum.planes[plane].normal.z);
+        distance[plane] = _mm_set1_ps(frustum.planes[plane].distance);
+    }
+    const __m128 zero{_mm_setzero_ps()};
+    const f32 *data{reinterpret_cast<const f32 *>(spheres)};
+
+    size_t i{0};
+    for (; i + 4 <= count; i += 4) {
+        // Rows become x, y, z and radius of four spheres
+        __m128 x{_mm_loadu_ps(data + i * 4 + 0)};
+        __m128 y{_mm_loadu_ps(data + i * 4 + 4)};
+        __m128 z{_mm_loadu_ps(data + i * 4 + 8)};
+        __m128 radius{_mm_loadu_ps(data + i * 4 + 12)};
+        _MM_TRANSPOSE4_PS(x, y, z, radius);
+
+        __m128 outside{zero};
+        for (size_t plane = 0; plane < Frustum::PLANE_COUNT; ++plane) {
+            __m128 signed_distance{_mm_mul_ps(normal_x[plane], x)};
+            signed_distance = _mm_add_ps(signed_distance, _mm_mul_ps(normal_y[plane], y));
+            signed_distance = _mm_add_ps(signed_distance, _mm_mul_ps(normal_z[plane], z));
+            signed_distance = _mm_add_ps(signed_distance, distance[plane]);
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(signed_distance, radius), zero));
+        }
+
+        const u32 mask{static_cast<u32>(_mm_movemask_ps(outside))};
+        for (u32 lane = 0; lane < 4; ++lane) {
+            visible[i + lane] = static_cast<u8>(((mask >> lane) & 1u) ^ 1u);
+        }
+    }
+
+    CullSpheresFrustumScalar(frustum, spheres + i, visible + i, count - i);
+}
+
+// One box per step against four planes at a time, a box has too few components to fill the lanes on its own
+GOUDA_SIMD_TARGET("sse4.1")
+static void CullAABBsFrustumSSE41(const Frustum &frustum, const AABB3D *boxes, u8 *visible, const size_t count)
+{
+    const FrustumPlaneColumns planes{MakeFrustumPlaneColumns(frustum)};
+    const __m128 zero{_mm_setzero_ps()};
+    const __m128 half{_mm_set1_ps(0.5f)};
+
+    for (size_t i = 0; i < count; ++i) {
+        const AABB3D &box{boxes[i]};
+        const __m128 box_min{_mm_setr_ps(box.min.x, box.min.y, box.min.z, 0.0f)};
+        const __m128 box_max{_mm_setr_ps(box.max.x, box.max.y, box.max.z, 0.0f)};
+        const __m128 center{_mm_mul_ps(_mm_add_ps(box_min, box_max), half)};
+        const __m128 extent{_mm_mul_ps(_mm_sub_ps(box_max, box_min), half)};
+        const __m128 center_x{_mm_shuffle_ps(center, center, _MM_SHUFFLE(0, 0, 0, 0))};
+        const __m128 center_y{_mm_shuffle_ps(center, center, _MM_SHUFFLE(1, 1, 1, 1))};
+        const __m128 center_z{_mm_shuffle_ps(center, center, _MM_SHUFFLE(2, 2, 2, 2))};
+        const __m128 extent_x{_mm_shuffle_ps(extent, extent, _MM_SHUFFLE(0, 0, 0, 0))};
+        const __m128 extent_y{_mm_shuffle_ps(extent, extent, _MM_SHUFFLE(1, 1, 1, 1))};
+        const __m128 extent_z{_mm_shuffle_ps(extent, extent, _MM_SHUFFLE(2, 2, 2, 2))};
+
+        u32 outside{0};
+        for (size_t lane = 0; lane < FrustumPlaneColumns::LANE_COUNT; lane += 4) {
+            __m128 signed_distance{_mm_mul_ps(_mm_load_ps(planes.normal_x + lane), center_x)};
+            signed_distance = _mm_add_ps(signed_distance, _mm_mul_ps(_mm_load_ps(planes.normal_y + lane), center_y));
+            signed_distance = _mm_add_ps(signed_distance, _mm_mul_ps(_mm_load_ps(planes.normal_z + lane), center_z));
+            signed_distance = _mm_add_ps(signed_distance, _mm_load_ps(planes.distance + lane));
+
+            __m128 radius{_mm_mul_ps(_mm_load_ps(planes.abs_normal_x + lane), extent_x)};
+            radius = _mm_add_ps(radius, _mm_mul_ps(_mm_load_ps(planes.abs_normal_y + lane), extent_y));
+            radius = _mm_add_ps(radius, _mm_mul_ps(_mm_load_ps(planes.abs_normal_z + lane), extent_z));
+
+            outside |= static_cast<u32>(_mm_movemask_ps(_mm_cmplt_ps(_mm_add_ps(signed_distance, radius), zero)));
+        }
+        visible[i] = outside == 0 ? 1 : 0;
+    }
+}
+
+// Lane mask of the four boxes from i on that intersect the query, bit n for box i + n
+GOUDA_SIMD_TARGET("sse4.1")
+static u32 IntersectLanesSSE41(const AABB2DStreams &boxes, const __m128 query_min_x, const __m128 query_min_y,
+                               const __m128 query_max_x, const __m128 query_max_y, const size_t i)
+{
+    __m128 inside{_mm_cmpge_ps(_mm_loadu_ps(boxes.max_x + i), query_min_x)};
+    inside = _mm_and_ps(inside, _mm_cmple_ps(_mm_loadu_ps(boxes.min_x + i), query_max_x));
+    inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_loadu_ps(boxes.max_y + i), query_min_y));
+    inside = _mm_and_ps(inside, _mm_cmple_ps(_mm_loadu_ps(boxes.min_y + i), query_max_y));
+    return static_cast<u32>(_mm_movemask_ps(inside));
+}
+
+GOUDA_SIMD_TARGET("sse4.1")
+static void IntersectAABBsMaskSSE41(const AABB2DStreams &boxes, const AABB2D &query, u64 *mask, const size_t count)
+{
+    const __m128 query_min_x{_mm_set1_ps(query.min.x)};
+    const __m128 query_min_y{_mm_set1_ps(query.min.y)};
+    const __m128 query_max_x{_mm_set1_ps(query.max.x)};
+    const __m128 query_max_y{_mm_set1_ps(query.max.y)};
+    std::fill_n(mask, (count + 63) / 64, u64{0});
+
+    // Groups of four never straddle a word, 64 is a multiple of the lane count
+    size_t i{0};
+    for (; i + 4 <= count; i += 4) {
+        const u64 lanes{IntersectLanesSSE41(boxes, query_min_x, query_min_y, query_max_x, query_max_y, i)};
+        mask[i / 64] |= lanes << (i % 64);
+    }
+
+    IntersectAABBsMaskScalarRange(boxes, query, mask, i, count);
+}
+
+GOUDA_SIMD_TARGET("sse4.1")
+static size_t IntersectAABBsIndicesSSE41(const AABB2DStreams &boxes, const AABB2D &query, u32 *indices,
+                                         const size_t count)
+{
+    const __m128 query_min_x{_mm_set1_ps(query.min.x)};
+    const __m128 query_min_y{_mm_set1_ps(query.min.y)};
+    const __m128 query_max_x{_mm_set1_ps(query.max.x)};
+    const __m128 query_max_y{_mm_set1_ps(query.max.y)};
+
+    size_t written{0};
+    size_t i{0};
+    for (; i + 4 <= count; i += 4) {
+        u32 lanes{IntersectLanesSSE41(boxes, query_min_x, query_min_y, query_max_x, query_max_y, i)};
+        while (lanes != 0) {
+            indices[written++] = static_cast<u32>(i) + static_cast<u32>(std::countr_zero(lanes));
+            lanes &= lanes - 1;
+        }
+    }
+
+    return written + IntersectAABBsIndicesScalarRange(boxes, query, indices + written, i, count);
+}
+
+GOUDA_SIMD_TARGET("sse4.1")
+static void Mat4TransformSSE41(const f32 *matrix, const f32 *vector, f32 *out)
+{
+    __m128 result{_mm_mul_ps(_mm_loadu_ps(matrix + 0), _mm_set1_ps(vector[0]))};
+    result = _mm_add_ps(result, _mm_mul_ps(_mm_loadu_ps(matrix + 4), _mm_set1_ps(vector[1])));
+    result = _mm_add_ps(result, _mm_mul_ps(_mm_loadu_ps(matrix + 8), _mm_set1_ps(vector[2])));
+    result = _mm_add_ps(result, _mm_mul_ps(_mm_loadu_ps(matrix + 12), _mm_set1_ps(vector[3])));
+    _mm_storeu_ps(out, result);
+}
+
+GOUDA_SIMD_TARGET("sse4.1")
+static void Mat4TransposeSSE41(const f32 *matrix, f32 *out)
+{
+    __m128 column0{_mm_loadu_ps(matrix + 0)};
+    __m128 column1{_mm_loadu_ps(matrix + 4)};
+    __m128 column2{_mm_loadu_ps(matrix + 8)};
+    __m128 column3{_mm_loadu_ps(matrix + 12)};
+    _MM_TRANSPOSE4_PS(column0, column1, column2, column3);
+    _mm_storeu_ps(out + 0, column0);
+    _mm_storeu_ps(out + 4, column1);
+    _mm_storeu_ps(out + 8, column2);
+    _mm_storeu_ps(out + 12, column3);
+}
+
+// 2x2 matrices packed as (m00, m01, m10, m11)
+GOUDA_SIMD_TARGET("sse4.1")
+static __m128 Mat2Multiply(const __m128 lhs, const __m128 rhs)
+{
+    return _mm_add_ps(_mm_mul_ps(lhs, _mm_shuffle_ps(rhs, rhs, _MM_SHUFFLE(3, 0, 3, 0))),
+                      _mm_mul_ps(_mm_shuffle_ps(lhs, lhs, _MM_SHUFFLE(2, 3, 0, 1)),
+                                 _mm_shuffle_ps(rhs, rhs, _MM_SHUFFLE(1, 2, 1, 2))));
+}
+
+// adjugate(lhs) * rhs
+GOUDA_SIMD_TARGET("sse4.1")
+static __m128 Mat2AdjugateMultiply(const __m128 lhs, const __m128 rhs)
+{
+    return _mm_sub_ps(_mm_mul_ps(_mm_shuffle_ps(lhs, lhs, _MM_SHUFFLE(0, 0, 3, 3)), rhs),
+                      _mm_mul_ps(_mm_shuffle_ps(lhs, lhs, _MM_SHUFFLE(2, 2, 1, 1)),
+                                 _mm_shuffle_ps(rhs, rhs, _MM_SHUFFLE(1, 0, 3, 2))));
+}
+
+// lhs * adjugate(rhs)
+GOUDA_SIMD_TARGET("sse4.1")
+static __m128 Mat2MultiplyAdjugate(const __m128 lhs, const __m128 rhs)
+{
+    return _mm_sub_ps(_mm_mul_ps(lhs, _mm_shuffle_ps(rhs, rhs, _MM_SHUFFLE(0, 3, 0, 3))),
+                      _mm_mul_ps(_mm_shuffle_ps(lhs, lhs, _MM_SHUFFLE(2, 3, 0, 1)),
+                                 _mm_shuffle_ps(rhs, rhs, _MM_SHUFFLE(1, 2, 1, 2))));
+}
+
+GOUDA_SIMD_TARGET("sse4.1")
+static bool Mat4InverseSSE41(const f32 *matrix, f32 *out)
+{
+    // Block inversion over the four 2x2 sub matrices. Like the scalar version it does not depend on the layout.
+    const __m128 row0{_mm_loadu_ps(matrix + 0)};
+    const __m128 row1{_mm_loadu_ps(matrix + 4)};
+    const __m128 row2{_mm_loadu_ps(matrix + 8)};
+    const __m128 row3{_mm_loadu_ps(matrix + 12)};
+
+    const __m128 a{_mm_movelh_ps(row0, row1)};
+    const __m128 b{_mm_movehl_ps(row1, row0)};
+    const __m128 c{_mm_movelh_ps(row2, row3)};
+    const __m128 d{_mm_movehl_ps(row3, row2)};
+
+    // Determinants of a, b, c and d
+    const __m128 sub_determinants{
+        _mm_sub_ps(_mm_mul_ps(_mm_shuffle_ps(row0, row2, _MM_SHUFFLE(2, 0, 2, 0)),
+                              _mm_shuffle_ps(row1, row3, _MM_SHUFFLE(3, 1, 3, 1))),
+                   _mm_mul_ps(_mm_shuffle_ps(row0, row2, _MM_SHUFFLE(3, 1, 3, 1)),
+                              _mm_shuffle_ps(row1, row3, _MM_SHUFFLE(2, 0, 2, 0))))};
+    const __m128 determinant_a{_mm_shuffle_ps(sub_determinants, sub_determinants, _MM_SHUFFLE(0, 0, 0, 0))};
+    const __m128 determinant_b{_mm_shuffle_ps(sub_determinants, sub_determinants, _MM_SHUFFLE(1, 1, 1, 1))};
+    const __m128 determinant_c{_mm_shuffle_ps(sub_determinants, sub_determinants, _MM_SHUFFLE(2, 2, 2, 2))};
+    const __m128 determinant_d{_mm_shuffle_ps(sub_determinants, sub_determinants, _MM_SHUFFLE(3, 3, 3, 3))};
+
+    const __m128 d_c{Mat2AdjugateMultiply(d, c)};
+    const __m128 a_b{Mat2AdjugateMultiply(a, b)};
+    __m128 x{_mm_sub_ps(_mm_mul_ps(determinant_d, a), Mat2Multiply(b, d_c))};
+    __m128 w{_mm_sub_ps(_mm_mul_ps(determinant_a, d), Mat2Multiply(c, a_b))};
+    __m128 y{_mm_sub_ps(_mm_mul_ps(determinant_b, c), Mat2MultiplyAdjugate(d, a_b))};
+    __m128 z{_mm_sub_ps(_mm_mul_ps(determinant_c, b), Mat2MultiplyAdjugate(a, d_c))};
+
+    // |M| = |A||D| + |B||C| - tr((A#B)(D#C))
+    __m128 trace{_mm_mul_ps(a_b, _mm_shuffle_ps(d_c, d_c, _MM_SHUFFLE(3, 1, 2, 0)))};
+    trace = _mm_hadd_ps(trace, trace);
+    trace = _mm_hadd_ps(trace, trace);
+    const __m128 determinant{_mm_sub_ps(
+        _mm_add_ps(_mm_mul_ps(determinant_a, determinant_d), _mm_mul_ps(determinant_b, determinant_c)), trace)};
+    if (_mm_cvtss_f32(determinant) == 0.0f) {
+        return false;
+    }
+
+    const __m128 inverse_determinant{_mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), determinant)};
+    x = _mm_mul_ps(x, inverse_determinant);
+    y = _mm_mul_ps(y, inverse_determinant);
+    z = _mm_mul_ps(z, inverse_determinant);
+    w = _mm_mul_ps(w, inverse_determinant);
+
+    // Applies the final adjugate while storing
+    _mm_storeu_ps(out + 0, _mm_shuffle_ps(x, y, _MM_SHUFFLE(1, 3, 1, 3)));
+    _mm_storeu_ps(out + 4, _mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 2, 0, 2)));
+    _mm_storeu_ps(out + 8, _mm_shuffle_ps(z, w, _MM_SHUFFLE(1, 3, 1, 3)));
+    _mm_storeu_ps(out + 12, _mm_shuffle_ps(z, w, _MM_SHUFFLE(0, 2, 0, 2)));
+    return true;
+}
+
+GOUDA_SIMD_TARGET("sse4.1")
+static void TransformAABBsSSE41(const f32 *matrix, const AABB2D *boxes, AABB2D *out, const size_t count)
+{
+    const __m128 half{_mm_set1_ps(0.5f)};
+    const __m128 sign_mask{_mm_set1_ps(-0.0f)};
+    const __m128 m00{_mm_set1_ps(matrix[0])};
+    const __m128 m10{_mm_set1_ps(matrix[1])};
+    const __m128 m01{_mm_set1_ps(matrix[4])};
+    const __m128 m11{_mm_set1_ps(matrix[5])};
+    const __m128 m03{_mm_set1_ps(matrix[12])};
+    const __m128 m13{_mm_set1_ps(matrix[13])};
+    const __m128 abs_m00{_mm_andnot_ps(sign_mask, m00)};
+    const __m128 abs_m10{_mm_andnot_ps(sign_mask, m10)};
+    const __m128 abs_m01{_mm_andnot_ps(sign_mask, m01)};
+    const __m128 abs_m11{_mm_andnot_ps(sign_mask, m11)};
+    const f32 *data{reinterpret_cast<const f32 *>(boxes)};
+    f32 *out_data{reinterpret_cast<f32 *>(out)};
+
+    size_t i{0};
+    for (; i + 4 <= count; i += 4) {
+        __m128 min_x{_mm_loadu_ps(data + i * 4 + 0)};
+        __m128 min_y{_mm_loadu_ps(data + i * 4 + 4)};
+        __m128 max_x{_mm_loadu_ps(data + i * 4 + 8)};
+        __m128 max_y{_mm_loadu_ps(data + i * 4 + 12)};
+        _MM_TRANSPOSE4_PS(min_x, min_y, max_x, max_y);
+
+        // Transform the centre and grow the extent by the absolute linear part
+        const __m128 center_x{_mm_mul_ps(_mm_add_ps(min_x, max_x), half)};
+        const __m128 center_y{_mm_mul_ps(_mm_add_ps(min_y, max_y), half)};
+        const __m128 extent_x{_mm_mul_ps(_mm_sub_ps(max_x, min_x), half)};
+        const __m128 extent_y{_mm_mul_ps(_mm_sub_ps(max_y, min_y), half)};
+
+        const __m128 new_center_x{_mm_add_ps(_mm_add_ps(_mm_mul_ps(m00, center_x), _mm_mul_ps(m01, center_y)), m03)};
+        const __m128 new_center_y{_mm_add_ps(_mm_add_ps(_mm_mul_ps(m10, center_x), _mm_mul_ps(m11, center_y)), m13)};
+        const __m128 new_extent_x{_mm_add_ps(_mm_mul_ps(abs_m00, extent_x), _mm_mul_ps(abs_m01, extent_y))};
+        const __m128 new_extent_y{_mm_add_ps(_mm_mul_ps(abs_m10, extent_x), _mm_mul_ps(abs_m11, extent_y))};
+
+        min_x = _mm_sub_ps(new_center_x, new_extent_x);
+        min_y = _mm_sub_ps(new_center_y, new_extent_y);
+        max_x = _mm_add_ps(new_center_x, new_extent_x);
+        max_y = _mm_add_ps(new_center_y, new_extent_y);
+        _MM_TRANSPOSE4_PS(min_x, min_y, max_x, max_y);
+        _mm_storeu_ps(out_data + i * 4 + 0, min_x);
+        _mm_storeu_ps(out_data + i * 4 + 4, min_y);
+        _mm_storeu_ps(out_data + i * 4 + 8, max_x);
+        _mm_storeu_ps(out_data + i * 4 + 12, max_y);
+    }
+
+    TransformAABBsScalar(matrix, boxes + i, out + i, count - i);
+}
+
+GOUDA_SIMD_TARGET("sse4.1")
+static void IntegrateParticlesSSE41(const ParticleStreams &streams, const size_t count, const f32 delta_time,
+                                    const Vec3 &gravity)
+{
+    const __m128 dt{_mm_set1_ps(delta_time)};
+    const __m128 gravity_x{_mm_set1_ps(gravity.x * delta_time)};
+    const __m128 gravity_y{_mm_set1_ps(gravity.y * delta_time)};
+    const __m128 gravity_z{_mm_set1_ps(gravity.z * delta_time)};
+
+    size_t i{0};
+    for (; i + 4 <= count; i += 4) {
+        const __m128 vx{_mm_add_ps(_mm_loadu_ps(streams.velocity_x + i), gravity_x)};
+        const __m128 vy{_mm_add_ps(_mm_loadu_ps(streams.velocity_y + i), gravity_y)};
+        const __m128 vz{_mm_add_ps(_mm_loadu_ps(streams.velocity_z + i), gravity_z)};
+        _mm_storeu_ps(streams.velocity_x + i, vx);
+        _mm_storeu_ps(streams.velocity_y + i, vy);
+        _mm_storeu_ps(streams.velocity_z + i, vz);
+
+        _mm_storeu_ps(streams.position_x + i, _mm_add_ps(_mm_loadu_ps(streams.position_x + i), _mm_mul_ps(vx, dt)));
+        _mm_storeu_ps(streams.position_y + i, _mm_add_ps(_mm_loadu_ps(streams.position_y + i), _mm_mul_ps(vy, dt)));
+        _mm_storeu_ps(streams.position_z + i, _mm_add_ps(_mm_loadu_ps(streams.position_z + i), _mm_mul_ps(vz, dt)));
+        _mm_storeu_ps(streams.lifetime + i, _mm_sub_ps(_mm_loadu_ps(streams.lifetime + i), dt));
+    }
+
+    IntegrateParticlesScalarRange(streams, i, count, delta_time, gravity);
+}
+
+// AVX2 ------------------------------------------------------------------------------------------------------------
+GOUDA_SIMD_TARGET("avx2")
+static void Mat4MultiplyAVX2(const f32 *lhs, const f32 *rhs, f32 *out)
+{
+    // Both 128 bit lanes hold the same lhs column, so two result columns are built per iteration
+    const __m256 column0{_mm256_broadcast_ps(reinterpret_cast<const __m128 *>(lhs + 0))};
+    const __m256 column1{_mm256_broadcast_ps(reinterpret_cast<const __m128 *>(lhs + 4))};
+    const __m256 column2{_mm256_broadcast_ps(reinterpret_cast<const __m128 *>(lhs + 8))};
+    const __m256 column3{_mm256_broadcast_ps(reinterpret_cast<const __m128 *>(lhs + 12))};
+
+    for (size_t col = 0; col < 4; col += 2) {
+        const __m256 weights{_mm256_loadu_ps(rhs + col * 4)};
+        const __m256 weight0{_mm256_shuffle_ps(weights, weights, _MM_SHUFFLE(0, 0, 0, 0))};
+        const __m256 weight1{_mm256_shuffle_ps(weights, weights, _MM_SHUFFLE(1, 1, 1, 1))};
+        const __m256 weight2{_mm256_shuffle_ps(weights, weights, _MM_SHUFFLE(2, 2, 2, 2))};
+        const __m256 weight3{_mm256_shuffle_ps(weights, weights, _MM_SHUFFLE(3, 3, 3, 3))};
+
+        __m256 result{_mm256_mul_ps(column0, weight0)};
+        result = _mm256_add_ps(result, _mm256_mul_ps(column1, weight1));
+        result = _mm256_add_ps(result, _mm256_mul_ps(column2, weight2));
+        result = _mm256_add_ps(result, _mm256_mul_ps(column3, weight3));
+        _mm256_storeu_ps(out + col * 4, result);
+    }
+}
+
+GOUDA_SIMD_TARGET("avx2")
+static void TransformPointsAVX2(const f32 *matrix, const Vec3 *points, Vec3 *out, const size_t count)
+{
+    const __m256 column0{_mm256_broadcast_ps(reinterpret_cast<const __m128 *>(matrix + 0))};
+    const __m256 column1{_mm256_broadcast_ps(reinterpret_cast<const __m128 *>(matrix + 4))};
+    const __m256 column2{_mm256_broadcast_ps(reinterpret_cast<const __m128 *>(matrix + 8))};
+    const __m256 column3{_mm256_broadcast_ps(reinterpret_cast<const __m128 *>(matrix + 12))};
+
+    size_t i{0};
+    for (; i + 2 <= count; i += 2) {
+        const Vec3 first{points[i]};
+        const Vec3 second{points[i + 1]};
+        const __m256 x{_mm256_set_m128(_mm_set1_ps(second.x), _mm_set1_ps(first.x))};
+        const __m256 y{_mm256_set_m128(_mm_set1_ps(second.y), _mm_set1_ps(first.y))};
+        const __m256 z{_mm256_set_m128(_mm_set1_ps(second.z), _mm_set1_ps(first.z))};
+
+        __m256 result{_mm256_add_ps(_mm256_mul_ps(column0, x), column3)};
+        result = _mm256_add_ps(result, _mm256_mul_ps(column1, y));
+        result = _mm256_add_ps(result, _mm256_mul_ps(column2, z));
+
+        alignas(32) f32 transformed[8];
+        _mm256_store_ps(transformed, result);
+        out[i] = Vec3{transformed[0], transformed[1], transformed[2]};
+        out[i + 1] = Vec3{transformed[4], transformed[5], transformed[6]};
+    }
+
+    TransformPointsSSE41(matrix, points + i, out + i, count - i);
+}
+
+GOUDA_SIMD_TARGET("avx2")
+static void CullAABBsAVX2(const AABB2D *boxes, const AABB2D &view, u8 *visible, const size_t count)
+{
+    const __m256 view_min_x{_mm256_set1_ps(view.min.x)};
+    const __m256 view_min_y{_mm256_set1_ps(view.min.y)};
+    const __m256 view_max_x{_mm256_set1_ps(view.max.x)};
+    const __m256 view_max_y{_mm256_set1_ps(view.max.y)};
+    const f32 *data{reinterpret_cast<const f32 *>(boxes)};
+
+    size_t i{0};
+    for (; i + 8 <= count; i += 8) {
+        // Register r holds boxes 2r and 2r + 1. Transposing each 128 bit lane leaves boxes 0, 2, 4, 6 in the low
+        // lane and 1, 3, 5, 7 in the high lane of every component register.
+        const __m256 r0{_mm256_loadu_ps(data + i * 4 + 0)};
+        const __m256 r1{_mm256_loadu_ps(data + i * 4 + 8)};
+        const __m256 r2{_mm256_loadu_ps(data + i * 4 + 16)};
+        const __m256 r3{_mm256_loadu_ps(data + i * 4 + 24)};
+
+        const __m256 t0{_mm256_unpacklo_ps(r0, r1)};
+        const __m256 t1{_mm256_unpackhi_ps(r0, r1)};
+        const __m256 t2{_mm256_unpacklo_ps(r2, r3)};
+        const __m256 t3{_mm256_unpackhi_ps(r2, r3)};
+        const __m256 min_x{_mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0))};
+        const __m256 min_y{_mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2))};
+        const __m256 max_x{_mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0))};
+        const __m256 max_y{_mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2))};
+
+        __m256 inside{_mm256_cmp_ps(max_x, view_min_x, _CMP_GE_OQ)};
+        inside = _mm256_and_ps(inside, _mm256_cmp_ps(min_x, view_max_x, _CMP_LE_OQ));
+        inside = _mm256_and_ps(inside, _mm256_cmp_ps(max_y, view_min_y, _CMP_GE_OQ));
+        inside = _mm256_and_ps(inside, _mm256_cmp_ps(min_y, view_max_y, _CMP_LE_OQ));
+
+        const u32 mask{static_cast<u32>(_mm256_movemask_ps(inside))};
+        for (u32 lane = 0; lane < 4; ++lane) {
+            visible[i + lane * 2] = static_cast<u8>((mask >> lane) & 1u);
+            visible[i + lane * 2 + 1] = static_cast<u8>((mask >> (lane + 4)) & 1u);
+        }
+    }
+
+    CullAABBsSSE41(boxes + i, view, visible + i, count - i);
+}
+
+GOUDA_SIMD_TARGET("avx2")
+static void CullSpheresFrustumAVX2(const Frustum &frustum, const Sphere *spheres, u8 *visible, const size_t count)
+{
+    __m256 normal_x[Frustum::PLANE_COUNT];
+    __m256 normal_y[Frustum::PLANE_COUNT];
+    __m256 normal_z[Frustum::PLANE_COUNT];
+    __m256 distance[Frustum::PLANE_COUNT];
+    for (size_t plane = 0; plane < Frustum::PLANE_COUNT; ++plane) {
+        normal_x[plane] = _mm256_set1_ps(frustum.planes[plane].normal.x);
+        normal_y[plane] = _mm256_set1_ps(frustum.planes[plane].normal.y);
+        normal_z[plane] = _mm256_set1_ps(frustum.planes[plane].normal.z);
+        distance[plane] = _mm256_set1_ps(frustum.planes[plane].distance);
+    }
+    const __m256 zero{_mm256_setzero_ps()};
+    const f32 *data{reinterpret_cast<const f32 *>(spheres)};
+
+    size_t i{0};
+    for (; i + 8 <= count; i += 8) {
+        // Transposed as in CullAABBsAVX2, spheres 0, 2, 4, 6 end up in the low lane and 1, 3, 5, 7 in the high lane
+        const __m256 r0{_mm256_loadu_ps(data + i * 4 + 0)};
+        const __m256 r1{_mm256_loadu_ps(data + i * 4 + 8)};
+        const __m256 r2{_mm256_loadu_ps(data + i * 4 + 16)};
+        const __m256 r3{_mm256_loadu_ps(data + i * 4 + 24)};
+
+        const __m256 t0{_mm256_unpacklo_ps(r0, r1)};
+        const __m256 t1{_mm256_unpackhi_ps(r0, r1)};
+        const __m256 t2{_mm256_unpacklo_ps(r2, r3)};
+        const __m256 t3{_mm256_unpackhi_ps(r2, r3)};
+        const __m256 x{_mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0))};
+        const __m256 y{_mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2))};
+        const __m256 z{_mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0))};
+        const __m256 radius{_mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2))};
+
+        __m256 outside{zero};
+        for (size_t plane = 0; plane < Frustum::PLANE_COUNT; ++plane) {
+            __m256 signed_distance{_mm256_mul_ps(normal_x[plane], x)};
+            signed_distance = _mm256_add_ps(signed_distance, _mm256_mul_ps(normal_y[plane], y));
+            signed_distance = _mm256_add_ps(signed_distance, _mm256_mul_ps(normal_z[plane], z));
+            signed_distance = _mm256_add_ps(signed_distance, distance[plane]);
+            outside = _mm256_or_ps(outside,
+                                   _mm256_cmp_ps(_mm256_add_ps(signed_distance, radius), zero, _CMP_LT_OQ));
+        }
+
+        const u32 mask{static_cast<u32>(_mm256_movemask_ps(outside))};
+        for (u32 lane = 0; lane < 4; ++lane) {
+            visible[i + lane * 2] = static_cast<u8>(((mask >> lane) & 1u) ^ 1u);
+            visible[i + lane * 2 + 1] = static_cast<u8>(((mask >> (lane + 4)) & 1u) ^ 1u);
+        }
+    }
+
+    CullSpheresFrustumSSE41(frustum, spheres + i, visible + i, count - i);
+}
+
+// All six planes, and the two padding ones, in one register per component
+GOUDA_SIMD_TARGET("avx2")
+static void CullAABBsFrustumAVX2(const Frustum &frustum, const AABB3D *boxes, u8 *visible, const size_t count)
+{
+    const FrustumPlaneColumns planes{MakeFrustumPlaneColumns(frustum)};
+    const __m256 normal_x{_mm256_load_ps(planes.normal_x)};
+    const __m256 normal_y{_mm256_load_ps(planes.normal_y)};
+    const __m256 normal_z{_mm256_load_ps(planes.normal_z)};
+    const __m256 distance{_mm256_load_ps(planes.distance)};
+    const __m256 abs_normal_x{_mm256_load_ps(planes.abs_normal_x)};
+    const __m256 abs_normal_y{_mm256_load_ps(planes.abs_normal_y)};
+    const __m256 abs_normal_z{_mm256_load_ps(planes.abs_normal_z)};
+    const __m256 zero{_mm256_setzero_ps()};
+
+    for (size_t i = 0; i < count; ++i) {
+        const AABB3D &box{boxes[i]};
+        const __m256 center_x{_mm256_set1_ps((box.min.x + box.max.x) * 0.5f)};
+        const __m256 center_y{_mm256_set1_ps((box.min.y + box.max.y) * 0.5f)};
+        const __m256 center_z{_mm256_set1_ps((box.min.z + box.max.z) * 0.5f)};
+        const __m256 extent_x{_mm256_set1_ps((box.max.x - box.min.x) * 0.5f)};
+        const __m256 extent_y{_mm256_set1_ps((box.max.y - box.min.y) * 0.5f)};
+        const __m256 extent_z{_mm256_set1_ps((box.max.z - box.min.z) * 0.5f)};
+
+        __m256 signed_distance{_mm256_mul_ps(normal_x, center_x)};
+        signed_distance = _mm256_add_ps(signed_distance, _mm256_mul_ps(normal_y, center_y));
+        signed_distance = _mm256_add_ps(signed_distance, _mm256_mul_ps(normal_z, center_z));
+        signed_distance = _mm256_add_ps(signed_distance, distance);
+
+        __m256 radius{_mm256_mul_ps(abs_normal_x, extent_x)};
+        radius = _mm256_add_ps(radius, _mm256_mul_ps(abs_normal_y, extent_y));
+        radius = _mm256_add_ps(radius, _mm256_mul_ps(abs_normal_z, extent_z));
+
+        const __m256 outside{_mm256_cmp_ps(_mm256_add_ps(signed_distance, radius), zero, _CMP_LT_OQ)};
+        visible[i] = _mm256_movemask_ps(outside) == 0 ? 1 : 0;
+    }
+}
+
+// Lane mask of the eight boxes from i on that intersect the query, bit n for box i + n
+GOUDA_SIMD_TARGET("avx2")
+static u32 IntersectLanesAVX2(const AABB2DStreams &boxes, const __m256 query_min_x, const __m256 query_min_y,
+                              const __m256 query_max_x, const __m256 query_max_y, const size_t i)
+{
+    __m256 inside{_mm256_cmp_ps(_mm256_loadu_ps(boxes.max_x + i), query_min_x, _CMP_GE_OQ)};
+    inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_loadu_ps(boxes.min_x + i), query_max_x, _CMP_LE_OQ));
+    inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_loadu_ps(boxes.max_y + i), query_min_y, _CMP_GE_OQ));
+    inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_loadu_ps(boxes.min_y + i), query_max_y, _CMP_LE_OQ));
+    return static_cast<u32>(_mm256_movemask_ps(inside));
+}
+
+GOUDA_SIMD_TARGET("avx2")
+static void IntersectAABBsMaskAVX2(const AABB2DStreams &boxes, const AABB2D &query, u64 *mask, const size_t count)
+{
+    const __m256 query_min_x{_mm256_set1_ps(query.min.x)};
+    const __m256 query_min_y{_mm256_set1_ps(query.min.y)};
+    const __m256 query_max_x{_mm256_set1_ps(query.max.x)};
+    const __m256 query_max_y{_mm256_set1_ps(query.max.y)};
+    std::fill_n(mask, (count + 63) / 64, u64{0});
+
+    size_t i{0};
+    for (; i + 8 <= count; i += 8) {
+        const u64 lanes{IntersectLanesAVX2(boxes, query_min_x, query_min_y, query_max_x, query_max_y, i)};
+        mask[i / 64] |= lanes << (i % 64);
+    }
+
+    IntersectAABBsMaskScalarRange(boxes, query, mask, i, count);
+}
+
+GOUDA_SIMD_TARGET("avx2")
+static size_t IntersectAABBsIndicesAVX2(const AABB2DStreams &boxes, const AABB2D &query, u32 *indices,
+                                        const size_t count)
+{
+    const __m256 query_min_x{_mm256_set1_ps(query.min.x)};
+    const __m256 query_min_y{_mm256_set1_ps(query.min.y)};
+    const __m256 query_max_x{_mm256_set1_ps(query.max.x)};
+    const __m256 query_max_y{_mm256_set1_ps(query.max.y)};
+
+    size_t written{0};
+    size_t i{0};
+    for (; i + 8 <= count; i += 8) {
+        u32 lanes{IntersectLanesAVX2(boxes, query_min_x, query_min_y, query_max_x, query_max_y, i)};
+        while (lanes != 0) {
+            indices[written++] = static_cast<u32>(i) + static_cast<u32>(std::countr_zero(lanes));
+            lanes &= lanes - 1;
+        }
+    }
+
+    return written + IntersectAABBsIndicesScalarRange(boxes, query, indices + written, i, count);
+}
+
+GOUDA_SIMD_TARGET("avx2")
+static void IntegrateParticlesAVX2(const ParticleStreams &streams, const size_t count, const f32 delta_time,
+                                   const Vec3 &gravity)
+{
+    const __m256 dt{_mm256_set1_ps(delta_time)};
+    const __m256 gravity_x{_mm256_set1_ps(gravity.x * delta_time)};
+    const __m256 gravity_y{_mm256_set1_ps(gravity.y * delta_time)};
+    const __m256 gravity_z{_mm256_set1_ps(gravity.z * delta_time)};
+
+    size_t i{0};
+    for (; i + 8 <= count; i += 8) {
+        const __m256 vx{_mm256_add_ps(_mm256_loadu_ps(streams.velocity_x + i), gravity_x)};
+        const __m256 vy{_mm256_add_ps(_mm256_loadu_ps(streams.velocity_y + i), gravity_y)};
+        const __m256 vz{_mm256_add_ps(_mm256_loadu_ps(streams.velocity_z + i), gravity_z)};
+        _mm256_storeu_ps(streams.velocity_x + i, vx);
+        _mm256_storeu_ps(streams.velocity_y + i, vy);
+        _mm256_storeu_ps(streams.velocity_z + i, vz);
+
+        _mm256_storeu_ps(streams.position_x + i,
+                         _mm256_add_ps(_mm256_loadu_ps(streams.position_x + i), _mm256_mul_ps(vx, dt)));
+        _mm256_storeu_ps(streams.position_y + i,
+                         _mm256_add_ps(_mm256_loadu_ps(streams.position_y + i), _mm256_mul_ps(vy, dt)));
+        _mm256_storeu_ps(streams.position_z + i,
+                         _mm256_add_ps(_mm256_loadu_ps(streams.position_z + i), _mm256_mul_ps(vz, dt)));
+        _mm256_storeu_ps(streams.lifetime + i, _mm256_sub_ps(_mm256_loadu_ps(streams.lifetime + i), dt));
+    }
+
+    IntegrateParticlesScalarRange(streams, i, count, delta_time, gravity);
+}
+
+static constexpr SimdKernels scalar_kernels{
+    SimdType::Scalar, Mat4MultiplyScalar, Mat4TransformScalar, Mat4TransposeScalar, Mat4InverseScalar,
+    TransformPointsScalar, TransformAABBsScalar, CullAABBsScalar, IntersectAABBsMaskScalar,
+    IntersectAABBsIndicesScalar, CullSpheresFrustumScalar, CullAABBsFrustumScalar, IntegrateParticlesScalar};
+static constexpr SimdKernels sse41_kernels{
+    SimdType::SSE4_1, Mat4MultiplySSE41, Mat4TransformSSE41, Mat4TransposeSSE41, Mat4InverseSSE41,
+    TransformPointsSSE41, TransformAABBsSSE41, CullAABBsSSE41, IntersectAABBsMaskSSE41,
+    IntersectAABBsIndicesSSE41, CullSpheresFrustumSSE41, CullAABBsFrustumSSE41, IntegrateParticlesSSE41};
+// Single matrix operations gain nothing from 256 bit registers, those reuse the SSE4.1 kernels
+static constexpr SimdKernels avx2_kernels{
+    SimdType::AVX2, Mat4MultiplyAVX2, Mat4TransformSSE41, Mat4TransposeSSE41, Mat4InverseSSE41,
+    TransformPointsAVX2, TransformAABBsSSE41, CullAABBsAVX2, IntersectAABBsMaskAVX2,
+    IntersectAABBsIndicesAVX2, CullSpheresFrustumAVX2, CullAABBsFrustumAVX2, IntegrateParticlesAVX2};
+
+} // namespace internal
+
+const SimdKernels &GetSimdKernels()
+{
+    static const SimdKernels &kernels{GetSimdKernels(GetSimdType())};
+    return kernels;
+}
+
+const SimdKernels &GetSimdKernels(const SimdType type)
+{
+    ASSERT(type <= GetSimdType(), "Requested SIMD kernels are not supported by this CPU.");
+
+    switch (type) {
+        case SimdType::AVX2:
+            return internal::avx2_kernels;
+        case SimdType::SSE4_1:
+            return internal::sse41_kernels;
+        default:
+            return internal::scalar_kernels;
+    }
+}
+
+StringView ToString(const SimdType type)
+{
+    switch (type) {
+        case SimdType::AVX2:
+            return "AVX2";
+        case SimdType::SSE4_1:
+            return "SSE4.1";
+        default:
+            return "Scalar";
+    }
+}
+
+void transform_points(const Mat4 &matrix, const std::span<const Vec3> points, const std::span<Vec3> out)
+{
+    ASSERT(out.size() >= points.size(), "Output span is smaller than the points to transform.");
+    GetSimdKernels().transform_points(matrix.getData(), points.data(), out.data(), points.size());
+}
+
+void transform_aabbs(const Mat4 &matrix, const std::span<const AABB2D> boxes, const std::span<AABB2D> out)
+{
+    ASSERT(out.size() >= boxes.size(), "Output span is smaller than the boxes to transform.");
+    GetSimdKernels().transform_aabbs(matrix.getData(), boxes.data(), out.data(), boxes.size());
+}
+
+void cull_frustum(const Frustum &frustum, const std::span<const Sphere> spheres, const std::span<u8> visible)
+{
+    ASSERT(visible.size() >= spheres.size(), "Output span is smaller than the spheres to cull.");
+    GetSimdKernels().cull_spheres_frustum(frustum, spheres.data(), visible.data(), spheres.size());
+}
+
+void cull_frustum(const Frustum &frustum, const std::span<const AABB3D> boxes, const std::span<u8> visible)
+{
+    ASSERT(visible.size() >= boxes.size(), "Output span is smaller than the boxes to cull.");
+    GetSimdKernels().cull_aabbs_frustum(frustum, boxes.data(), visible.data(), boxes.size());
+}
+
+size_t intersect_aabbs(const AABB2DColumns &boxes, const AABB2D &query, gouda::Vector<u32> &indices)
+{
+    // Room for every box, then trimmed to the hits
+    const size_t first{indices.size()};
+    indices.resize_uninitialized(first + boxes.Size());
+    const size_t count{
+        GetSimdKernels().intersect_aabbs_indices(boxes.GetStreams(), query, indices.data() + first, boxes.Size())};
+    indices.resize_uninitialized(first + count);
+    return count;
+}
+
+} // namespace gouda::math
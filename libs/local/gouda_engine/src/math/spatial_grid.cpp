@@ -0,0 +1,287 @@
+/**
+ * @file math/spatial_grid.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine flat spatial hash grid implementation
+ */
+#include "math/spatial_grid.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <utility>
+
+#include "utils/hash.hpp"
+
+namespace gouda::math {
+
+namespace internal {
+
+constexpr size_t MIN_CELL_SLOTS{16};
+
+static u64 hash_cell(const s32 x, const s32 y)
+{
+    const u64 key{(u64{static_cast<u32>(x)} << 32) | u64{static_cast<u32>(y)}};
+    return utils::mix64(key);
+}
+
+static size_t cell_range_area(const s32 min_x, const s32 max_x, const s32 min_y, const s32 max_y)
+{
+    return static_cast<size_t>(max_x - min_x + 1) * static_cast<size_t>(max_y - min_y + 1);
+}
+
+} // namespace internal
+
+SpatialHashGrid::SpatialHashGrid(const f32 cell_size)
+    : m_cell_size{cell_size},
+      m_inverse_cell_size{1.0f / cell_size},
+      m_cell_count{0},
+      m_free_node{INVALID_INDEX},
+      m_query_stamp{0}
+{
+}
+
+void SpatialHashGrid::Build(const std::span<const AABB2D> bounds)
+{
+    m_entities.resize(bounds.size());
+
+    // Every entity/cell pair could be a cell of its own, which bounds the table size
+    size_t pair_count{0};
+    for (size_t entity = 0; entity < bounds.size(); ++entity) {
+        const CellRange range{GetCellRange(bounds[entity])};
+        m_entities[entity] = EntityRecord{range, true, false};
+        pair_count += internal::cell_range_area(range.min_x, range.max_x, range.min_y, range.max_y);
+    }
+
+    m_cells.assign(std::bit_ceil(std::max(pair_count * 2, internal::MIN_CELL_SLOTS)),
+                   Cell{0, 0, EMPTY_SLOT, 0, INVALID_INDEX});
+    m_cell_count = 0;
+    m_dynamic_nodes.clear();
+    m_free_node = INVALID_INDEX;
+    m_entity_stamps.assign(bounds.size(), 0);
+    m_query_stamp = 0;
+
+    for (const EntityRecord &record : m_entities) {
+        const auto [min_x, max_x, min_y, max_y] = record.range;
+        for (s32 y = min_y; y <= max_y; ++y) {
+            for (s32 x = min_x; x <= max_x; ++x) {
+                ++m_cells[FindOrInsertCell(x, y)].count;
+            }
+        }
+    }
+
+    // Each cell starts out pointing at the end of its run and is filled backwards, walking the entities in reverse
+    // leaves the ids ascending
+    u32 run_end{0};
+    for (Cell &cell : m_cells) {
+        if (cell.first != EMPTY_SLOT) {
+            run_end += cell.count;
+            cell.first = run_end;
+        }
+    }
+    m_cell_entities.resize(run_end);
+
+    for (size_t entity = bounds.size(); entity-- > 0;) {
+        const auto [min_x, max_x, min_y, max_y] = m_entities[entity].range;
+        for (s32 y = min_y; y <= max_y; ++y) {
+            for (s32 x = min_x; x <= max_x; ++x) {
+                m_cell_entities[--m_cells[FindCell(x, y)].first] = static_cast<u32>(entity);
+            }
+        }
+    }
+}
+
+void SpatialHashGrid::Clear()
+{
+    m_cells.clear();
+    m_cell_count = 0;
+    m_cell_entities.clear();
+    m_dynamic_nodes.clear();
+    m_free_node = INVALID_INDEX;
+    m_entities.clear();
+    m_entity_stamps.clear();
+    m_query_stamp = 0;
+}
+
+void SpatialHashGrid::Insert(const u32 entity, const AABB2D &bounds)
+{
+    Remove(entity);
+
+    if (entity >= m_entities.size()) {
+        m_entities.resize(entity + 1, EntityRecord{{}, false, false});
+        m_entity_stamps.resize(entity + 1, 0);
+    }
+
+    const CellRange range{GetCellRange(bounds)};
+    ReserveCells(m_cell_count + internal::cell_range_area(range.min_x, range.max_x, range.min_y, range.max_y));
+
+    for (s32 y = range.min_y; y <= range.max_y; ++y) {
+        for (s32 x = range.min_x; x <= range.max_x; ++x) {
+            const u32 cell_index{FindOrInsertCell(x, y)};
+            // Allocating can grow the node pool but never the table, so the cell is looked up only once
+            const u32 node{AllocateNode(entity, m_cells[cell_index].dynamic_head)};
+            m_cells[cell_index].dynamic_head = node;
+        }
+    }
+
+    m_entities[entity] = EntityRecord{range, true, true};
+}
+
+void SpatialHashGrid::Remove(const u32 entity)
+{
+    if (!Contains(entity)) {
+        return;
+    }
+
+    EntityRecord &record{m_entities[entity]};
+    const auto [min_x, max_x, min_y, max_y] = record.range;
+    for (s32 y = min_y; y <= max_y; ++y) {
+        for (s32 x = min_x; x <= max_x; ++x) {
+            Cell &cell{m_cells[FindCell(x, y)]};
+
+            if (!record.is_dynamic) {
+                // Order within a run does not matter to queries, so the last id fills the hole
+                const auto run{m_cell_entities.begin() + cell.first};
+                const auto found{std::find(run, run + cell.count, entity)};
+                *found = m_cell_entities[cell.first + --cell.count];
+                continue;
+            }
+
+            for (u32 *link = &cell.dynamic_head; *link != INVALID_INDEX; link = &m_dynamic_nodes[*link].next) {
+                if (m_dynamic_nodes[*link].entity == entity) {
+                    const u32 node{*link};
+                    *link = m_dynamic_nodes[node].next;
+                    m_dynamic_nodes[node].next = m_free_node;
+                    m_free_node = node;
+                    break;
+                }
+            }
+        }
+    }
+
+    record.is_indexed = false;
+}
+
+void SpatialHashGrid::Move(const u32 entity, const AABB2D &bounds)
+{
+    // Most frames a moving entity stays inside the cells it already covers
+    if (Contains(entity) && m_entities[entity].range == GetCellRange(bounds)) {
+        return;
+    }
+
+    Insert(entity, bounds);
+}
+
+void SpatialHashGrid::Query(const AABB2D &bounds, gouda::Vector<u32> &entities)
+{
+    if (m_cell_count == 0) {
+        return;
+    }
+
+    if (++m_query_stamp == 0) {
+        std::ranges::fill(m_entity_stamps, 0u);
+        m_query_stamp = 1;
+    }
+
+    const auto report = [&](const u32 entity) {
+        if (m_entity_stamps[entity] != m_query_stamp) {
+            m_entity_stamps[entity] = m_query_stamp;
+            entities.push_back(entity);
+        }
+    };
+
+    const auto [min_x, max_x, min_y, max_y] = GetCellRange(bounds);
+    for (s32 y = min_y; y <= max_y; ++y) {
+        for (s32 x = min_x; x <= max_x; ++x) {
+            const u32 cell_index{FindCell(x, y)};
+            if (cell_index == INVALID_INDEX) {
+                continue;
+            }
+
+            const Cell &cell{m_cells[cell_index]};
+            for (u32 i = cell.first; i < cell.first + cell.count; ++i) {
+                report(m_cell_entities[i]);
+            }
+            for (u32 node = cell.dynamic_head; node != INVALID_INDEX; node = m_dynamic_nodes[node].next) {
+                report(m_dynamic_nodes[node].entity);
+            }
+        }
+    }
+}
+
+SpatialHashGrid::CellRange SpatialHashGrid::GetCellRange(const AABB2D &bounds) const
+{
+    // Either corner order is accepted, the camera frustum bounds put the top edge in min
+    return {floor(math::min(bounds.min.x, bounds.max.x) * m_inverse_cell_size),
+            floor(math::max(bounds.min.x, bounds.max.x) * m_inverse_cell_size),
+            floor(math::min(bounds.min.y, bounds.max.y) * m_inverse_cell_size),
+            floor(math::max(bounds.min.y, bounds.max.y) * m_inverse_cell_size)};
+}
+
+u32 SpatialHashGrid::FindCell(const s32 x, const s32 y) const
+{
+    if (m_cells.empty()) {
+        return INVALID_INDEX;
+    }
+
+    const u64 mask{m_cells.size() - 1};
+    for (u64 slot = internal::hash_cell(x, y) & mask;; slot = (slot + 1) & mask) {
+        const Cell &cell{m_cells[slot]};
+        if (cell.first == EMPTY_SLOT) {
+            return INVALID_INDEX;
+        }
+        if (cell.x == x && cell.y == y) {
+            return static_cast<u32>(slot);
+        }
+    }
+}
+
+u32 SpatialHashGrid::FindOrInsertCell(const s32 x, const s32 y)
+{
+    // Build and ReserveCells keep the table at most half full, so there always is an empty slot to stop at. Cells are
+    // never removed, an empty cell stays behind to keep the probe chains through it intact.
+    const u64 mask{m_cells.size() - 1};
+    for (u64 slot = internal::hash_cell(x, y) & mask;; slot = (slot + 1) & mask) {
+        Cell &cell{m_cells[slot]};
+        if (cell.first == EMPTY_SLOT) {
+            cell = Cell{x, y, 0, 0, INVALID_INDEX};
+            ++m_cell_count;
+            return static_cast<u32>(slot);
+        }
+        if (cell.x == x && cell.y == y) {
+            return static_cast<u32>(slot);
+        }
+    }
+}
+
+void SpatialHashGrid::ReserveCells(const size_t cell_count)
+{
+    if (cell_count * 2 <= m_cells.size()) {
+        return;
+    }
+
+    gouda::Vector<Cell> old_cells{std::exchange(m_cells, {})};
+    m_cells.assign(std::bit_ceil(std::max(cell_count * 2, internal::MIN_CELL_SLOTS)),
+                   Cell{0, 0, EMPTY_SLOT, 0, INVALID_INDEX});
+    m_cell_count = 0;
+
+    for (const Cell &cell : old_cells) {
+        if (cell.first != EMPTY_SLOT) {
+            m_cells[FindOrInsertCell(cell.x, cell.y)] = cell;
+        }
+    }
+}
+
+u32 SpatialHashGrid::AllocateNode(const u32 entity, const u32 next)
+{
+    if (m_free_node == INVALID_INDEX) {
+        m_dynamic_nodes.push_back(DynamicNode{entity, next});
+        return static_cast<u32>(m_dynamic_nodes.size() - 1);
+    }
+
+    const u32 node{m_free_node};
+    m_free_node = m_dynamic_nodes[node].next;
+    m_dynamic_nodes[node] = DynamicNode{entity, next};
+    return node;
+}
+
+} // namespace gouda::math
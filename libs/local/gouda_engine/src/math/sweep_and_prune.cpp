@@ -0,0 +1,104 @@
+/**
+ * @file math/sweep_and_prune.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine sort based collision broadphase implementation
+ */
+#include "math/sweep_and_prune.hpp"
+
+#include <algorithm>
+
+namespace gouda::math {
+
+SweepAndPrune::SweepAndPrune() : m_swap_count{0} {}
+
+void SweepAndPrune::Insert(const u32 body, const AABB2D &bounds)
+{
+    if (Contains(body)) {
+        Move(body, bounds);
+        return;
+    }
+    if (body >= m_bodies.size()) {
+        m_bodies.resize(body + 1, INVALID_INDEX);
+    }
+
+    // Appended out of order, the next sort moves it into place
+    m_bodies[body] = static_cast<u32>(m_entries.size());
+    m_entries.push_back(Entry{0.0f, 0.0f, 0.0f, 0.0f, body});
+    Move(body, bounds);
+}
+
+void SweepAndPrune::Remove(const u32 body)
+{
+    if (!Contains(body)) {
+        return;
+    }
+
+    // Erased rather than swapped with the last entry, which keeps the rest in order
+    const u32 entry{m_bodies[body]};
+    m_entries.erase(m_entries.begin() + entry);
+    for (u32 i = entry; i < m_entries.size(); ++i) {
+        m_bodies[m_entries[i].body] = i;
+    }
+    m_bodies[body] = INVALID_INDEX;
+}
+
+void SweepAndPrune::Move(const u32 body, const AABB2D &bounds)
+{
+    if (!Contains(body)) {
+        Insert(body, bounds);
+        return;
+    }
+
+    // Either corner order is accepted like the tree queries do
+    Entry &entry{m_entries[m_bodies[body]]};
+    entry.min_x = std::min(bounds.min.x, bounds.max.x);
+    entry.max_x = std::max(bounds.min.x, bounds.max.x);
+    entry.min_y = std::min(bounds.min.y, bounds.max.y);
+    entry.max_y = std::max(bounds.min.y, bounds.max.y);
+}
+
+void SweepAndPrune::Clear()
+{
+    m_entries.clear();
+    m_bodies.clear();
+    m_swap_count = 0;
+}
+
+void SweepAndPrune::FindPairs(gouda::Vector<CollisionPair> &pairs)
+{
+    SortEntries();
+
+    // Every body after this one in the order starts to its right, the sweep stops at the first that starts past its end
+    for (size_t i = 0; i < m_entries.size(); ++i) {
+        const Entry &entry{m_entries[i]};
+        for (size_t j = i + 1; j < m_entries.size() && m_entries[j].min_x <= entry.max_x; ++j) {
+            const Entry &other{m_entries[j]};
+            if (other.max_y < entry.min_y || other.min_y > entry.max_y) {
+                continue;
+            }
+            pairs.push_back(CollisionPair{std::min(entry.body, other.body), std::max(entry.body, other.body)});
+        }
+    }
+}
+
+void SweepAndPrune::SortEntries()
+{
+    // Insertion sort, close to linear while the order from the last sort still mostly holds
+    m_swap_count = 0;
+    for (u32 i = 1; i < m_entries.size(); ++i) {
+        const Entry entry{m_entries[i]};
+        u32 j{i};
+        for (; j > 0 && m_entries[j - 1].min_x > entry.min_x; --j) {
+            m_entries[j] = m_entries[j - 1];
+            m_bodies[m_entries[j].body] = j;
+        }
+        if (j != i) {
+            m_entries[j] = entry;
+            m_bodies[entry.body] = j;
+            m_swap_count += i - j;
+        }
+    }
+}
+
+} // namespace gouda::math
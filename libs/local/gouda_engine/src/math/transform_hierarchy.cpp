@@ -0,0 +1,334 @@
+/**
+ * @file math/transform_hierarchy.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine 2D transform hierarchy implementation
+ */
+#include "math/transform_hierarchy.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include "debug/logger.hpp"
+
+namespace gouda::math {
+
+namespace internal {
+
+// Moves the values of the kept nodes down over the removed ones, remap holds the new slots
+template <typename T>
+static void compact_nodes(gouda::Vector<T> &values, const gouda::Vector<u32> &remap, const size_t first,
+                          const size_t kept_count)
+{
+    for (size_t i = first; i < values.size(); ++i) {
+        if (remap[i] != constants::u32_max) {
+            values[remap[i]] = values[i];
+        }
+    }
+    values.resize(kept_count);
+}
+
+template <typename T>
+static void permute_nodes(gouda::Vector<T> &values, const gouda::Vector<u32> &order)
+{
+    gouda::Vector<T> sorted;
+    sorted.reserve(values.size());
+    for (const u32 slot : order) {
+        sorted.push_back(values[slot]);
+    }
+    std::swap(values, sorted);
+}
+
+} // namespace internal
+
+TransformHierarchy::TransformHierarchy() : m_first_dirty{0}, m_is_order_dirty{false} {}
+
+TransformID TransformHierarchy::Add(const Transform2D &local, const TransformID parent)
+{
+    u32 parent_slot{INVALID_SLOT};
+    if (parent != INVALID_TRANSFORM) {
+        if (IsValid(parent)) {
+            parent_slot = m_slots[parent];
+        }
+        else {
+            ENGINE_LOG_WARNING("Transform parent {} does not exist, the node is added as a root.", parent);
+        }
+    }
+
+    TransformID id;
+    if (!m_free_ids.empty()) {
+        id = m_free_ids.back();
+        m_free_ids.pop_back();
+    }
+    else {
+        id = static_cast<TransformID>(m_slots.size());
+        m_slots.push_back(INVALID_SLOT);
+    }
+
+    // Appended after its parent, so the order holds
+    const auto slot{static_cast<u32>(m_ids.size())};
+    m_slots[id] = slot;
+    m_ids.push_back(id);
+    m_parents.push_back(parent_slot);
+    m_local_positions.push_back(local.position);
+    m_local_rotations.push_back(local.rotation);
+    m_local_scales.push_back(local.scale);
+    m_world_positions.push_back(local.position);
+    m_world_rotations.push_back(local.rotation);
+    m_world_sines.push_back(0.0f);
+    m_world_cosines.push_back(1.0f);
+    m_world_scales.push_back(local.scale);
+    m_dirty.push_back(0);
+    MarkDirty(slot);
+    return id;
+}
+
+void TransformHierarchy::Remove(const TransformID id)
+{
+    if (!IsValid(id)) {
+        return;
+    }
+    if (m_is_order_dirty) {
+        SortNodes(); // The subtree is found in one pass only while parents come first
+    }
+
+    // Everything after the node is either under it, and removed, or moved down over the gap
+    const u32 first{m_slots[id]};
+    gouda::Vector<u32> remap(m_ids.size(), INVALID_SLOT);
+    for (u32 i = 0; i < first; ++i) {
+        remap[i] = i;
+    }
+
+    u32 kept_count{first};
+    for (size_t i = first; i < m_ids.size(); ++i) {
+        const u32 parent{m_parents[i]};
+        if (i == first || (parent != INVALID_SLOT && parent >= first && remap[parent] == INVALID_SLOT)) {
+            m_slots[m_ids[i]] = INVALID_SLOT;
+            m_free_ids.push_back(m_ids[i]);
+            continue;
+        }
+        remap[i] = kept_count++;
+    }
+
+    const auto compact{[&](auto &values) { internal::compact_nodes(values, remap, first, kept_count); }};
+    compact(m_ids);
+    compact(m_parents);
+    compact(m_local_positions);
+    compact(m_local_rotations);
+    compact(m_local_scales);
+    compact(m_world_positions);
+    compact(m_world_rotations);
+    compact(m_world_sines);
+    compact(m_world_cosines);
+    compact(m_world_scales);
+    compact(m_dirty);
+
+    for (u32 i = first; i < kept_count; ++i) {
+        m_slots[m_ids[i]] = i;
+        if (m_parents[i] != INVALID_SLOT) {
+            m_parents[i] = remap[m_parents[i]];
+        }
+    }
+    m_first_dirty = std::min(m_first_dirty, first);
+}
+
+bool TransformHierarchy::SetParent(const TransformID id, const TransformID parent)
+{
+    if (!IsValid(id) || (parent != INVALID_TRANSFORM && !IsValid(parent))) {
+        ENGINE_LOG_WARNING("Cannot parent transform {} to {}, one of them does not exist.", id, parent);
+        return false;
+    }
+
+    const u32 slot{m_slots[id]};
+    const u32 parent_slot{parent == INVALID_TRANSFORM ? INVALID_SLOT : m_slots[parent]};
+    for (u32 ancestor = parent_slot; ancestor != INVALID_SLOT; ancestor = m_parents[ancestor]) {
+        if (ancestor == slot) {
+            ENGINE_LOG_WARNING("Cannot parent transform {} to {}, it is under the node.", id, parent);
+            return false;
+        }
+    }
+
+    m_parents[slot] = parent_slot;
+    m_is_order_dirty |= parent_slot != INVALID_SLOT && parent_slot > slot;
+    MarkDirty(slot);
+    return true;
+}
+
+void TransformHierarchy::SetLocal(const TransformID id, const Transform2D &local)
+{
+    const u32 slot{m_slots[id]};
+    m_local_positions[slot] = local.position;
+    m_local_rotations[slot] = local.rotation;
+    m_local_scales[slot] = local.scale;
+    MarkDirty(slot);
+}
+
+void TransformHierarchy::SetLocalPosition(const TransformID id, const Vec2 &position)
+{
+    const u32 slot{m_slots[id]};
+    m_local_positions[slot] = position;
+    MarkDirty(slot);
+}
+
+void TransformHierarchy::SetLocalRotation(const TransformID id, const f32 rotation)
+{
+    const u32 slot{m_slots[id]};
+    m_local_rotations[slot] = rotation;
+    MarkDirty(slot);
+}
+
+void TransformHierarchy::Update()
+{
+    if (m_is_order_dirty) {
+        SortNodes();
+    }
+
+    m_updated.clear();
+    const auto count{static_cast<u32>(m_ids.size())};
+    for (u32 i = m_first_dirty; i < count; ++i) {
+        const u32 parent{m_parents[i]};
+        if (m_dirty[i] == 0 && (parent == INVALID_SLOT || m_dirty[parent] == 0)) {
+            continue;
+        }
+        m_dirty[i] = 1; // Its children follow it
+
+        if (parent == INVALID_SLOT) {
+            m_world_positions[i] = m_local_positions[i];
+            m_world_rotations[i] = m_local_rotations[i];
+            m_world_scales[i] = m_local_scales[i];
+        }
+        else {
+            const Vec2 &parent_scale{m_world_scales[parent]};
+            const f32 x{m_local_positions[i].x * parent_scale.x};
+            const f32 y{m_local_positions[i].y * parent_scale.y};
+            const f32 sine{m_world_sines[parent]};
+            const f32 cosine{m_world_cosines[parent]};
+            m_world_positions[i] = m_world_positions[parent] + Vec2{x * cosine - y * sine, x * sine + y * cosine};
+            m_world_rotations[i] = m_world_rotations[parent] + m_local_rotations[i];
+            m_world_scales[i] = Vec2{parent_scale.x * m_local_scales[i].x, parent_scale.y * m_local_scales[i].y};
+        }
+        m_world_sines[i] = std::sin(m_world_rotations[i]);
+        m_world_cosines[i] = std::cos(m_world_rotations[i]);
+        m_updated.push_back(m_ids[i]);
+    }
+
+    if (m_first_dirty < count) {
+        std::fill(m_dirty.begin() + m_first_dirty, m_dirty.end(), u8{0});
+    }
+    m_first_dirty = count;
+}
+
+TransformID TransformHierarchy::GetParent(const TransformID id) const
+{
+    const u32 parent{m_parents[m_slots[id]]};
+    return parent == INVALID_SLOT ? INVALID_TRANSFORM : m_ids[parent];
+}
+
+Transform2D TransformHierarchy::GetLocal(const TransformID id) const
+{
+    const u32 slot{m_slots[id]};
+    return {m_local_positions[slot], m_local_rotations[slot], m_local_scales[slot]};
+}
+
+Transform2D TransformHierarchy::GetWorld(const TransformID id) const
+{
+    const u32 slot{m_slots[id]};
+    return {m_world_positions[slot], m_world_rotations[slot], m_world_scales[slot]};
+}
+
+void TransformHierarchy::Reserve(const size_t count)
+{
+    m_slots.reserve(count);
+    m_ids.reserve(count);
+    m_parents.reserve(count);
+    m_local_positions.reserve(count);
+    m_local_rotations.reserve(count);
+    m_local_scales.reserve(count);
+    m_world_positions.reserve(count);
+    m_world_rotations.reserve(count);
+    m_world_sines.reserve(count);
+    m_world_cosines.reserve(count);
+    m_world_scales.reserve(count);
+    m_dirty.reserve(count);
+    m_updated.reserve(count);
+}
+
+void TransformHierarchy::Clear()
+{
+    m_slots.clear();
+    m_free_ids.clear();
+    m_ids.clear();
+    m_parents.clear();
+    m_local_positions.clear();
+    m_local_rotations.clear();
+    m_local_scales.clear();
+    m_world_positions.clear();
+    m_world_rotations.clear();
+    m_world_sines.clear();
+    m_world_cosines.clear();
+    m_world_scales.clear();
+    m_dirty.clear();
+    m_updated.clear();
+    m_first_dirty = 0;
+    m_is_order_dirty = false;
+}
+
+void TransformHierarchy::MarkDirty(const u32 slot)
+{
+    m_dirty[slot] = 1;
+    m_first_dirty = std::min(m_first_dirty, slot);
+}
+
+void TransformHierarchy::SortNodes()
+{
+    // Depths are filled in walking up from each node to the first ancestor whose depth is known
+    const size_t count{m_ids.size()};
+    gouda::Vector<u32> depths(count, INVALID_SLOT);
+    gouda::Vector<u32> chain;
+    for (u32 i = 0; i < count; ++i) {
+        u32 slot{i};
+        while (slot != INVALID_SLOT && depths[slot] == INVALID_SLOT) {
+            chain.push_back(slot);
+            slot = m_parents[slot];
+        }
+        u32 depth{slot == INVALID_SLOT ? 0 : depths[slot] + 1};
+        while (!chain.empty()) {
+            depths[chain.back()] = depth++;
+            chain.pop_back();
+        }
+    }
+
+    gouda::Vector<u32> order(count);
+    std::iota(order.begin(), order.end(), u32{0});
+    std::ranges::stable_sort(order, {}, [&](const u32 slot) { return depths[slot]; });
+
+    gouda::Vector<u32> remap(count);
+    for (u32 i = 0; i < count; ++i) {
+        remap[order[i]] = i;
+    }
+
+    const auto permute{[&](auto &values) { internal::permute_nodes(values, order); }};
+    permute(m_ids);
+    permute(m_parents);
+    permute(m_local_positions);
+    permute(m_local_rotations);
+    permute(m_local_scales);
+    permute(m_world_positions);
+    permute(m_world_rotations);
+    permute(m_world_sines);
+    permute(m_world_cosines);
+    permute(m_world_scales);
+    permute(m_dirty);
+
+    for (u32 i = 0; i < count; ++i) {
+        m_slots[m_ids[i]] = i;
+        if (m_parents[i] != INVALID_SLOT) {
+            m_parents[i] = remap[m_parents[i]];
+        }
+    }
+    m_first_dirty = 0; // The dirty nodes moved, the pass checks them all once
+    m_is_order_dirty = false;
+}
+
+} // namespace gouda::math
@@ -0,0 +1,166 @@
+/**
+ * @file linear_allocator.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine linear allocator module implementation
+ */
+#include "memory/allocators/linear_allocator.hpp"
+
+#include <algorithm>
+
+#include "debug/assert.hpp"
+#include "debug/logger.hpp"
+
+namespace gouda {
+
+namespace internal {
+
+// The buffer starts on a cache line
+constexpr size_t BUFFER_ALIGNMENT{64};
+
+static size_t align_up(const size_t value, const size_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+} // namespace internal
+
+// LinearAllocator implementation ----------------------------------------------------------------------
+
+LinearAllocator::LinearAllocator() noexcept
+    : p_buffer{nullptr},
+      m_capacity{0},
+      m_offset{0},
+      m_peak{0},
+      p_overflow{nullptr},
+      m_overflow_size{0},
+      m_overflow_count{0},
+      m_tag{MemoryTag::General}
+{
+}
+
+LinearAllocator::LinearAllocator(const size_t capacity, const MemoryTag tag) : LinearAllocator()
+{
+    m_tag = tag;
+    Reserve(capacity);
+}
+
+LinearAllocator::~LinearAllocator()
+{
+    FreeOverflow();
+    if (p_buffer != nullptr) {
+        ::operator delete(p_buffer, std::align_val_t{internal::BUFFER_ALIGNMENT});
+        MemoryTracker::Get().RecordDeallocation(m_tag, m_capacity);
+    }
+}
+
+void LinearAllocator::Reserve(const size_t capacity)
+{
+    if (capacity <= m_capacity) {
+        return;
+    }
+    ASSERT(m_offset == 0 && p_overflow == nullptr, "Linear allocator grown with {} bytes still allocated.", GetUsed());
+
+    if (p_buffer != nullptr) {
+        ::operator delete(p_buffer, std::align_val_t{internal::BUFFER_ALIGNMENT});
+        p_buffer = nullptr;
+        MemoryTracker::Get().RecordDeallocation(m_tag, m_capacity);
+    }
+    p_buffer = static_cast<std::byte *>(::operator new(capacity, std::align_val_t{internal::BUFFER_ALIGNMENT}));
+    m_capacity = capacity;
+    MemoryTracker::Get().RecordAllocation(m_tag, m_capacity);
+}
+
+void LinearAllocator::SetMemoryTag(const MemoryTag tag)
+{
+    ASSERT(p_buffer == nullptr && p_overflow == nullptr, "Linear allocator retagged after reserving memory.");
+    m_tag = tag;
+}
+
+void *LinearAllocator::Allocate(const size_t size, const size_t alignment)
+{
+    ASSERT(alignment != 0 && (alignment & (alignment - 1)) == 0, "Alignment {} is not a power of two.", alignment);
+
+    if (p_buffer != nullptr) {
+        // Aligned by address rather than offset, alignments above the buffer's own still hold
+        const uintptr_t base{reinterpret_cast<uintptr_t>(p_buffer)};
+        const size_t offset{internal::align_up(base + m_offset, alignment) - base};
+        if (offset <= m_capacity && size <= m_capacity - offset) {
+            m_offset = offset + size;
+            m_peak = std::max(m_peak, GetUsed());
+            return p_buffer + offset;
+        }
+    }
+
+    return AllocateOverflow(size, alignment);
+}
+
+void LinearAllocator::Deallocate(void *pointer, const size_t size) noexcept
+{
+    std::byte *const bytes{static_cast<std::byte *>(pointer)};
+    if (p_buffer != nullptr && bytes >= p_buffer && bytes + size == p_buffer + m_offset) {
+        m_offset = static_cast<size_t>(bytes - p_buffer);
+    }
+}
+
+void LinearAllocator::Reset()
+{
+    FreeOverflow();
+    m_offset = 0;
+    if (m_overflow_count > 0) {
+        // The same allocations next cycle need the peak plus whatever alignment padding they land on
+        const size_t capacity{m_peak + m_peak / 4};
+        ENGINE_LOG_DEBUG("Linear allocator of {} bytes overflowed {} times, growing it to {} bytes.", m_capacity,
+                         m_overflow_count, capacity);
+        Reserve(capacity);
+    }
+
+    m_overflow_size = 0;
+    m_overflow_count = 0;
+}
+
+void *LinearAllocator::AllocateOverflow(const size_t size, const size_t alignment)
+{
+    // The block header sits in front of the allocation, padded so the allocation keeps its alignment
+    const size_t block_alignment{std::max(alignment, alignof(OverflowBlock))};
+    const size_t header_size{internal::align_up(sizeof(OverflowBlock), block_alignment)};
+    void *memory{::operator new(header_size + size, std::align_val_t{block_alignment})};
+    MemoryTracker::Get().RecordAllocation(m_tag, header_size + size);
+
+    p_overflow = ::new (memory) OverflowBlock{p_overflow, block_alignment, header_size + size};
+    m_overflow_size += size;
+    ++m_overflow_count;
+    m_peak = std::max(m_peak, GetUsed());
+
+    return static_cast<std::byte *>(memory) + header_size;
+}
+
+void LinearAllocator::FreeOverflow() noexcept
+{
+    while (p_overflow != nullptr) {
+        OverflowBlock *const block{p_overflow};
+        p_overflow = block->next;
+        MemoryTracker::Get().RecordDeallocation(m_tag, block->size);
+        ::operator delete(block, std::align_val_t{block->alignment});
+    }
+}
+
+// FrameAllocator implementation -----------------------------------------------------------------------
+
+FrameAllocator::FrameAllocator(const size_t capacity, const u32 frame_count, const MemoryTag tag)
+    : p_allocators{std::make_unique<LinearAllocator[]>(frame_count)}, m_frame_count{frame_count}, m_frame_index{0}
+{
+    ASSERT(frame_count > 0, "A frame allocator needs at least one frame.");
+    for (u32 i = 0; i < m_frame_count; ++i) {
+        p_allocators[i].SetMemoryTag(tag);
+        p_allocators[i].Reserve(capacity);
+    }
+}
+
+void FrameAllocator::BeginFrame()
+{
+    m_frame_index = (m_frame_index + 1) % m_frame_count;
+    p_allocators[m_frame_index].Reset();
+}
+
+} // namespace gouda
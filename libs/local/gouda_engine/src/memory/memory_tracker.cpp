@@ -0,0 +1,112 @@
+/**
+ * @file memory_tracker.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine per subsystem memory accounting implementation
+ */
+#include "memory/memory_tracker.hpp"
+
+#include "debug/logger.hpp"
+#include "debug/profiler.hpp"
+
+namespace gouda {
+
+namespace internal {
+
+// Profiler track names, literals as the profiler keeps the views
+constexpr std::array<StringView, MEMORY_TAG_COUNT> MEMORY_COUNTER_NAMES{
+    "Memory General", "Memory Renderer", "Memory Textures", "Memory Audio", "Memory Scene"};
+
+static f64 to_mebibytes(const u64 bytes) { return static_cast<f64>(bytes) / (1024.0 * 1024.0); }
+
+} // namespace internal
+
+// MemoryTracker implementation ------------------------------------------------------------------------
+
+void MemoryTracker::SetBudget(const MemoryTag tag, const u64 bytes)
+{
+    m_stats[static_cast<size_t>(tag)].budget_bytes = bytes;
+    m_health[static_cast<size_t>(tag)].is_over_budget = false; // Checked against the new budget next frame
+}
+
+void MemoryTracker::BeginFrame()
+{
+    ++m_frame_number;
+    const bool is_window_end{m_frame_number % GROWTH_WINDOW_FRAMES == 0};
+
+    for (size_t i = 0; i < MEMORY_TAG_COUNT; ++i) {
+        const auto tag{static_cast<MemoryTag>(i)};
+        TagCounters &counters{m_counters[i]};
+        MemoryTagStats &stats{m_stats[i]};
+        TagHealth &health{m_health[i]};
+
+        stats.live_bytes = counters.live_bytes.load(std::memory_order_relaxed);
+        stats.peak_bytes = counters.peak_bytes.load(std::memory_order_relaxed);
+        stats.live_allocations = counters.live_allocations.load(std::memory_order_relaxed);
+        stats.frame_allocations = counters.frame_allocations.exchange(0, std::memory_order_relaxed);
+        stats.frame_bytes = counters.frame_bytes.exchange(0, std::memory_order_relaxed);
+
+        const bool is_over_budget{stats.budget_bytes != 0 && stats.live_bytes > stats.budget_bytes};
+        if (is_over_budget && !health.is_over_budget) {
+            ENGINE_LOG_WARNING("{} memory over budget: {:.2f} MiB of {:.2f} MiB.", GetTagName(tag),
+                               internal::to_mebibytes(stats.live_bytes), internal::to_mebibytes(stats.budget_bytes));
+        }
+        health.is_over_budget = is_over_budget;
+
+        if (is_window_end) {
+            health.growing_windows = stats.live_bytes > health.window_start_bytes ? health.growing_windows + 1 : 0;
+            health.window_start_bytes = stats.live_bytes;
+            if (health.growing_windows == 0) {
+                health.has_warned_growth = false;
+            }
+            else if (health.growing_windows >= GROWTH_WARNING_WINDOWS && !health.has_warned_growth) {
+                ENGINE_LOG_WARNING("{} memory has grown for {} frames in a row, now {:.2f} MiB in {} allocations.",
+                                   GetTagName(tag), GROWTH_WARNING_WINDOWS * GROWTH_WINDOW_FRAMES,
+                                   internal::to_mebibytes(stats.live_bytes), stats.live_allocations);
+                health.has_warned_growth = true;
+            }
+        }
+
+        ENGINE_PROFILE_COUNTER(internal::MEMORY_COUNTER_NAMES[i], stats.live_bytes);
+    }
+}
+
+void MemoryTracker::LogSummary() const
+{
+    for (size_t i = 0; i < MEMORY_TAG_COUNT; ++i) {
+        const TagCounters &counters{m_counters[i]};
+        ENGINE_LOG_INFO("{} memory: {:.2f} MiB live in {} allocations, {:.2f} MiB peak.",
+                        GetTagName(static_cast<MemoryTag>(i)),
+                        internal::to_mebibytes(counters.live_bytes.load(std::memory_order_relaxed)),
+                        counters.live_allocations.load(std::memory_order_relaxed),
+                        internal::to_mebibytes(counters.peak_bytes.load(std::memory_order_relaxed)));
+    }
+}
+
+u64 MemoryTracker::GetTotalLiveBytes() const noexcept
+{
+    u64 total{0};
+    for (const MemoryTagStats &stats : m_stats) {
+        total += stats.live_bytes;
+    }
+    return total;
+}
+
+StringView MemoryTracker::GetTagName(const MemoryTag tag)
+{
+    switch (tag) {
+        case MemoryTag::General:
+            return "General";
+        case MemoryTag::Renderer:
+            return "Renderer";
+        case MemoryTag::Textures:
+            return "Textures";
+        case MemoryTag::Audio:
+            return "Audio";
+        case MemoryTag::Scene:
+            return "Scene";
+    }
+    return "Unknown";
+}
+
+} // namespace gouda
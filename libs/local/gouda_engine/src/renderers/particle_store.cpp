@@ -0,0 +1,205 @@
+/**
+ * @file particle_store.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine CPU particle simulation module implementation
+ */
+#include "renderers/particle_store.hpp"
+
+#include <cmath>
+
+#include "math/noise.hpp"
+#include "math/simd_kernels.hpp"
+
+namespace gouda {
+
+ParticleStore::ParticleStore(const f32 fade_time)
+    : m_fade_time{fade_time}, m_turbulence_strength{0.0f}, m_turbulence_frequency{0.0f}, m_turbulence_time{0.0f}
+{
+}
+
+void ParticleStore::Reserve(const size_t capacity)
+{
+    m_position_x.reserve(capacity);
+    m_position_y.reserve(capacity);
+    m_position_z.reserve(capacity);
+    m_velocity_x.reserve(capacity);
+    m_velocity_y.reserve(capacity);
+    m_velocity_z.reserve(capacity);
+    m_lifetime.reserve(capacity);
+    m_size.reserve(capacity);
+    m_colour.reserve(capacity);
+    m_sprite_rect.reserve(capacity);
+    m_texture_index.reserve(capacity);
+    m_is_atlas.reserve(capacity);
+    m_apply_camera_effects.reserve(capacity);
+}
+
+void ParticleStore::Spawn(const ParticleData &particle)
+{
+    m_position_x.push_back(particle.position.x);
+    m_position_y.push_back(particle.position.y);
+    m_position_z.push_back(particle.position.z);
+    m_velocity_x.push_back(particle.velocity.x);
+    m_velocity_y.push_back(particle.velocity.y);
+    m_velocity_z.push_back(particle.velocity.z);
+    m_lifetime.push_back(particle.lifetime);
+    m_size.push_back(particle.size);
+    m_colour.push_back(particle.colour);
+    m_sprite_rect.push_back(particle.sprite_rect);
+    m_texture_index.push_back(particle.texture_index);
+    m_is_atlas.push_back(particle.is_atlas);
+    m_apply_camera_effects.push_back(particle.apply_camera_effects);
+}
+
+void ParticleStore::Update(const f32 delta_time, const Vec3 &gravity)
+{
+    ApplyTurbulence(delta_time);
+    Integrate(delta_time, gravity);
+    RemoveDead();
+}
+
+void ParticleStore::SetTurbulence(const f32 strength, const f32 frequency)
+{
+    const bool is_enabled{strength != 0.0f && frequency > 0.0f};
+    m_turbulence_strength = is_enabled ? strength : 0.0f;
+    m_turbulence_frequency = is_enabled ? frequency : 0.0f;
+}
+
+void ParticleStore::WriteRenderData(std::vector<ParticleData> &out) const
+{
+    const f32 inverse_fade_time{1.0f / m_fade_time};
+
+    out.clear();
+    out.reserve(Size());
+    for (size_t i = 0; i < Size(); ++i) {
+        Vec4 colour{m_colour[i]};
+        colour.w = m_lifetime[i] * inverse_fade_time;
+        out.emplace_back(Vec3{m_position_x[i], m_position_y[i], m_position_z[i]}, m_size[i], m_lifetime[i],
+                         Vec3{m_velocity_x[i], m_velocity_y[i], m_velocity_z[i]}, colour, m_texture_index[i],
+                         m_sprite_rect[i], m_is_atlas[i], m_apply_camera_effects[i]);
+    }
+}
+
+bool ParticleStore::IsConsistent() const
+{
+    const size_t count{Size()};
+    return m_position_x.size() == count && m_position_y.size() == count && m_position_z.size() == count &&
+           m_velocity_x.size() == count && m_velocity_y.size() == count && m_velocity_z.size() == count &&
+           m_size.size() == count && m_colour.size() == count && m_sprite_rect.size() == count &&
+           m_texture_index.size() == count && m_is_atlas.size() == count && m_apply_camera_effects.size() == count;
+}
+
+void ParticleStore::Clear()
+{
+    m_position_x.clear();
+    m_position_y.clear();
+    m_position_z.clear();
+    m_velocity_x.clear();
+    m_velocity_y.clear();
+    m_velocity_z.clear();
+    m_lifetime.clear();
+    m_size.clear();
+    m_colour.clear();
+    m_sprite_rect.clear();
+    m_texture_index.clear();
+    m_is_atlas.clear();
+    m_apply_camera_effects.clear();
+}
+
+// Private ---------------------------------------------------------------------------------
+void ParticleStore::ApplyTurbulence(const f32 delta_time)
+{
+    if (m_turbulence_strength == 0.0f) {
+        return;
+    }
+    m_turbulence_time = std::fmod(m_turbulence_time + delta_time, PARTICLE_TURBULENCE_TIME_WRAP);
+    if (IsEmpty()) {
+        return;
+    }
+
+    // Scaled and scrolled into noise space once, both axes sample the same points with their own seeds
+    const size_t count{Size()};
+    m_noise_x.resize_uninitialized(count);
+    m_noise_y.resize_uninitialized(count);
+    m_noise.resize_uninitialized(count);
+    const f32 scroll{m_turbulence_time * PARTICLE_TURBULENCE_SCROLL_RATE};
+    for (size_t i = 0; i < count; ++i) {
+        m_noise_x[i] = m_position_x[i] * m_turbulence_frequency + scroll;
+        m_noise_y[i] = m_position_y[i] * m_turbulence_frequency;
+    }
+
+    math::NoiseSettings settings{.type = math::NoiseType::Perlin,
+                                 .frequency = 1.0f,
+                                 .octaves = PARTICLE_TURBULENCE_OCTAVES,
+                                 .lacunarity = 2.0f,
+                                 .gain = 0.5f,
+                                 .seed = PARTICLE_TURBULENCE_SEED_X};
+    const f32 impulse{m_turbulence_strength * delta_time};
+    math::fractal_noise(m_noise_x, m_noise_y, m_noise, settings);
+    for (size_t i = 0; i < count; ++i) {
+        m_velocity_x[i] += m_noise[i] * impulse;
+    }
+    settings.seed = PARTICLE_TURBULENCE_SEED_Y;
+    math::fractal_noise(m_noise_x, m_noise_y, m_noise, settings);
+    for (size_t i = 0; i < count; ++i) {
+        m_velocity_y[i] += m_noise[i] * impulse;
+    }
+}
+
+void ParticleStore::Integrate(const f32 delta_time, const Vec3 &gravity)
+{
+    const math::ParticleStreams streams{m_position_x.data(), m_position_y.data(), m_position_z.data(),
+                                        m_velocity_x.data(), m_velocity_y.data(), m_velocity_z.data(),
+                                        m_lifetime.data()};
+    math::GetSimdKernels().integrate_particles(streams, Size(), delta_time, gravity);
+}
+
+void ParticleStore::RemoveDead()
+{
+    size_t i{0};
+    while (i < Size()) {
+        if (m_lifetime[i] <= 0.0f) {
+            SwapRemove(i); // The swapped in particle is checked on the next iteration
+        }
+        else {
+            ++i;
+        }
+    }
+}
+
+void ParticleStore::SwapRemove(const size_t index)
+{
+    const size_t last{Size() - 1};
+    if (index != last) {
+        m_position_x[index] = m_position_x[last];
+        m_position_y[index] = m_position_y[last];
+        m_position_z[index] = m_position_z[last];
+        m_velocity_x[index] = m_velocity_x[last];
+        m_velocity_y[index] = m_velocity_y[last];
+        m_velocity_z[index] = m_velocity_z[last];
+        m_lifetime[index] = m_lifetime[last];
+        m_size[index] = m_size[last];
+        m_colour[index] = m_colour[last];
+        m_sprite_rect[index] = m_sprite_rect[last];
+        m_texture_index[index] = m_texture_index[last];
+        m_is_atlas[index] = m_is_atlas[last];
+        m_apply_camera_effects[index] = m_apply_camera_effects[last];
+    }
+
+    m_position_x.pop_back();
+    m_position_y.pop_back();
+    m_position_z.pop_back();
+    m_velocity_x.pop_back();
+    m_velocity_y.pop_back();
+    m_velocity_z.pop_back();
+    m_lifetime.pop_back();
+    m_size.pop_back();
+    m_colour.pop_back();
+    m_sprite_rect.pop_back();
+    m_texture_index.pop_back();
+    m_is_atlas.pop_back();
+    m_apply_camera_effects.pop_back();
+}
+
+} // namespace gouda
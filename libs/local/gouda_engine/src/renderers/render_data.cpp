@@ -6,8 +6,63 @@
  */
 #include "renderers/render_data.hpp"
 
+#include <bit>
+#include <cmath>
+
 namespace gouda {
 
+static_assert(sizeof(QuadInstance) == 32, "The quad vertex input mirrors the QuadInstance layout");
+static_assert(sizeof(UpscaleParams) == 12, "The upscale shader's push constant block mirrors UpscaleParams");
+static_assert(sizeof(AnimationClipData) == 32 && sizeof(AnimationFrameData) == 32,
+              "The quad vertex shader mirrors the animation tables");
+
+namespace internal {
+// Rounds to nearest even like the GPU conversions. Out of range values become infinity, tiny ones subnormals or zero.
+static u16 float_to_half(const f32 value)
+{
+    const u32 bits{std::bit_cast<u32>(value)};
+    const u32 sign{(bits >> 16) & 0x8000u};
+    const u32 exponent{(bits >> 23) & 0xFFu};
+    u32 mantissa{bits & 0x7FFFFFu};
+
+    if (exponent == 0xFFu) {
+        return static_cast<u16>(sign | 0x7C00u | (mantissa != 0 ? 0x200u : 0u)); // NaNs stay NaN
+    }
+
+    const s32 half_exponent{static_cast<s32>(exponent) - 127 + 15};
+    if (half_exponent >= 31) {
+        return static_cast<u16>(sign | 0x7C00u);
+    }
+    if (half_exponent <= 0) {
+        if (half_exponent < -10) {
+            return static_cast<u16>(sign);
+        }
+        mantissa |= 0x800000u; // The implicit one is stored in a subnormal
+        const u32 shift{static_cast<u32>(14 - half_exponent)};
+        const u32 halfway{1u << (shift - 1)};
+        const u32 remainder{mantissa & ((1u << shift) - 1)};
+        u32 half{mantissa >> shift};
+        if (remainder > halfway || (remainder == halfway && (half & 1u) != 0)) {
+            ++half;
+        }
+        return static_cast<u16>(sign | half);
+    }
+
+    // A carry out of the mantissa correctly rounds up into the exponent
+    u32 half{sign | static_cast<u32>(half_exponent) << 10 | mantissa >> 13};
+    const u32 remainder{mantissa & 0x1FFFu};
+    if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u) != 0)) {
+        ++half;
+    }
+    return static_cast<u16>(half);
+}
+
+static u32 float_to_unorm(const f32 value, const f32 max_value)
+{
+    return static_cast<u32>(math::clamp(value, 0.0f, 1.0f) * max_value + 0.5f);
+}
+} // namespace internal
+
 InstanceData::InstanceData()
     : position{0.0f, 0.0f, 0.0f},
       _pad0{0.0f},
@@ -18,13 +73,20 @@ InstanceData::InstanceData()
       sprite_rect{0.0f, 0.0f, 0.0f, 0.0f},
       is_atlas{0},
       apply_camera_effects{1}, // Default to true
-      _pad1{}
+      blend_mode{BlendMode::Opaque},
+      animation_clip{NO_ANIMATION},
+      animation_start_time{0.0f},
+      texture_layer{NO_TEXTURE_LAYER},
+      distance_range{0.0f},
+      shape{QuadShape::None},
+      corner_radius{0.0f},
+      stroke_width{0.0f}
 {
 }
 
 InstanceData::InstanceData(const Vec3 &position_, const Vec2 &size_, const f32 rotation_, const u32 texture_index_,
                            const Colour<f32> &colour_, const UVRect<f32> &sprite_rect_, const u32 is_atlas_,
-                           const u32 apply_camera_effects_)
+                           const u32 apply_camera_effects_, const BlendMode blend_mode_)
     : position{position_},
       _pad0{0.0f},
       size{size_},
@@ -34,29 +96,151 @@ InstanceData::InstanceData(const Vec3 &position_, const Vec2 &size_, const f32 r
       sprite_rect{sprite_rect_},
       is_atlas{is_atlas_},
       apply_camera_effects{apply_camera_effects_},
-      _pad1{}
+      blend_mode{blend_mode_},
+      animation_clip{NO_ANIMATION},
+      animation_start_time{0.0f},
+      texture_layer{NO_TEXTURE_LAYER},
+      distance_range{0.0f},
+      shape{QuadShape::None},
+      corner_radius{0.0f},
+      stroke_width{0.0f}
 {
 
 }
 
-TextData::TextData()
-    : position{0.0f, 0.0f, 0.0f},
-      _pad0{0.0f},
-      size{1.0f, 1.0f},
-      _pad1{0.0f},
-      glyph_index{0},
-      colour{1.0f, 0.0f, 0.0f, 1.0f}, // Default to red
-      sdf_params{0.0f, 0.0f, 0.0f, 0.0f},
-      texture_index{0},
-      atlas_size{0.0f, 0.0f},
-      px_range{0.0f},
-      apply_camera_effects{1} // Default to false
+QuadInstance::QuadInstance(const InstanceData &instance)
+    : position{instance.position},
+      size{internal::float_to_half(instance.size.x), internal::float_to_half(instance.size.y)},
+      rotation{internal::float_to_half(std::remainder(instance.rotation, constants::double_pi))},
+      texture_flags{static_cast<u16>((instance.texture_index & texture_index_mask) |
+                                     (instance.animation_clip != InstanceData::NO_ANIMATION ? is_animated_bit : 0u) |
+                                     (instance.is_atlas != 0 ? is_atlas_bit : 0u) |
+                                     (instance.apply_camera_effects == 1 ? apply_camera_effects_bit : 0u))},
+      colour{internal::float_to_unorm(instance.colour.r, 255.0f) |
+             internal::float_to_unorm(instance.colour.g, 255.0f) << 8 |
+             internal::float_to_unorm(instance.colour.b, 255.0f) << 16 |
+             internal::float_to_unorm(instance.colour.a, 255.0f) << 24},
+      sprite_rect{static_cast<u16>(internal::float_to_unorm(instance.sprite_rect.u_min, 65535.0f)),
+                  static_cast<u16>(internal::float_to_unorm(instance.sprite_rect.v_min, 65535.0f)),
+                  static_cast<u16>(internal::float_to_unorm(instance.sprite_rect.u_max, 65535.0f)),
+                  static_cast<u16>(internal::float_to_unorm(instance.sprite_rect.v_max, 65535.0f))}
+{
+    if (instance.texture_layer != InstanceData::NO_TEXTURE_LAYER) {
+        texture_flags = static_cast<u16>((instance.texture_index & (texture_array_bit - 1u)) | texture_array_bit |
+                                         (texture_flags & apply_camera_effects_bit));
+        sprite_rect[0] = static_cast<u16>(instance.texture_layer);
+        sprite_rect[1] = 0;
+        sprite_rect[2] = 0;
+        sprite_rect[3] = 0;
+    }
+    else if (instance.shape != QuadShape::None) {
+        texture_flags = static_cast<u16>(static_cast<u32>(instance.shape) | shape_bits |
+                                         (texture_flags & apply_camera_effects_bit));
+        rotation = internal::float_to_half(instance.stroke_width);
+        if (instance.shape != QuadShape::Line) {
+            const bool has_radius{instance.shape == QuadShape::Rect || instance.shape == QuadShape::Grid};
+            sprite_rect[0] = has_radius ? internal::float_to_half(instance.corner_radius) : u16{0};
+            sprite_rect[1] = instance.shape == QuadShape::Grid ? internal::float_to_half(instance.sprite_rect.u_min)
+                                                                : u16{0};
+            sprite_rect[2] = 0;
+            sprite_rect[3] = 0;
+        }
+    }
+    else if (instance.distance_range > 0.0f) {
+        texture_flags = static_cast<u16>((instance.texture_index & (texture_array_bit - 1u)) | msdf_bits |
+                                         (texture_flags & apply_camera_effects_bit));
+        rotation = internal::float_to_half(instance.distance_range);
+    }
+    else if (instance.animation_clip != InstanceData::NO_ANIMATION) {
+        const u32 start_bits{std::bit_cast<u32>(instance.animation_start_time)};
+        sprite_rect[0] = static_cast<u16>(instance.animation_clip);
+        sprite_rect[1] = 0;
+        sprite_rect[2] = static_cast<u16>(start_bits & 0xFFFF);
+        sprite_rect[3] = static_cast<u16>(start_bits >> 16);
+    }
+}
+
+InstanceData make_rect_shape(const Vec3 &position, const Vec2 &size, const Colour<f32> &colour, const f32 corner_radius,
+                             const f32 stroke_width, const bool apply_camera_effects)
 {
+    InstanceData instance{position, size, 0.0f, 0, colour, UVRect{0.0f, 0.0f, 0.0f, 0.0f}, 0,
+                          apply_camera_effects ? 1u : 0u, BlendMode::Alpha};
+    instance.shape = QuadShape::Rect;
+    instance.corner_radius = corner_radius;
+    instance.stroke_width = stroke_width;
+    return instance;
 }
 
-SimulationParams::SimulationParams() : gravity{0.0f}, delta_time{0.0f} {}
+InstanceData make_circle_shape(const Vec3 &center, const f32 radius, const Colour<f32> &colour, const f32 stroke_width,
+                               const bool apply_camera_effects)
+{
+    InstanceData instance{Vec3{center.x - radius, center.y - radius, center.z}, Vec2{radius * 2.0f}, 0.0f, 0, colour,
+                          UVRect{0.0f, 0.0f, 0.0f, 0.0f}, 0, apply_camera_effects ? 1u : 0u, BlendMode::Alpha};
+    instance.shape = QuadShape::Circle;
+    instance.stroke_width = stroke_width;
+    return instance;
+}
+
+InstanceData make_line_shape(const Vec2 &from, const Vec2 &to, const f32 depth, const f32 width,
+                             const Colour<f32> &colour, const bool apply_camera_effects)
+{
+    const f32 half_width{width * 0.5f};
+    const Vec2 min{math::min(from.x, to.x) - half_width, math::min(from.y, to.y) - half_width};
+    const Vec2 size{math::abs(to.x - from.x) + width, math::abs(to.y - from.y) + width};
+    const auto fraction{[&](const Vec2 &point) {
+        return Vec2{(point.x - min.x) / size.x, (point.y - min.y) / size.y};
+    }};
+    const Vec2 start{fraction(from)};
+    const Vec2 end{fraction(to)};
+
+    InstanceData instance{Vec3{min.x, min.y, depth}, size, 0.0f, 0, colour,
+                          UVRect{start.x, start.y, end.x, end.y}, 0, apply_camera_effects ? 1u : 0u,
+                          BlendMode::Alpha};
+    instance.shape = QuadShape::Line;
+    instance.stroke_width = width;
+    return instance;
+}
+
+InstanceData make_grid_shape(const Vec3 &position, const Vec2 &size, const f32 cell_size, const Colour<f32> &colour,
+                             const u32 major_interval, const f32 line_width)
+{
+    InstanceData instance{position, size, 0.0f, 0, colour,
+                          UVRect{static_cast<f32>(major_interval), 0.0f, 0.0f, 0.0f}, 0, 1, BlendMode::Alpha};
+    instance.shape = QuadShape::Grid;
+    instance.corner_radius = cell_size;
+    instance.stroke_width = line_width;
+    return instance;
+}
+
+SimulationParams::SimulationParams() : SimulationParams{Vec3{0.0f}, 0.0f} {}
 SimulationParams::SimulationParams(const Vec3 &gravity_, const f32 delta_time_)
-    : gravity{gravity_}, delta_time{delta_time_}
+    : gravity{gravity_},
+      delta_time{delta_time_},
+      spawn_count{0},
+      sort_by_depth{0},
+      collider_count{0},
+      restitution{0.5f},
+      collision_origin{0.0f},
+      collision_cell_count{0u},
+      collision_cell_size{1.0f},
+      turbulence_strength{0.0f},
+      turbulence_frequency{0.0f},
+      turbulence_time{0.0f}
+{
+}
+
+CullParams::CullParams() : views{}, instance_count{0}, viewport_count{1}, visible_capacity{0} {}
+
+PointLight::PointLight() : position{0.0f}, radius{0.0f}, intensity{0.0f}, colour{1.0f} {}
+PointLight::PointLight(const Vec2 &position_, const f32 radius_, const Colour<f32> &colour_, const f32 intensity_)
+    : position{position_}, radius{radius_}, intensity{intensity_}, colour{colour_}
+{
+}
+
+// Full white ambient leaves quads as they are without lights
+LightParams::LightParams()
+    : framebuffer_size{0.0f}, tile_size{0}, light_count{0}, tile_count{0u}, viewport_count{1}, ambient{1.0f},
+      viewport_wvps{}, viewport_rects{}
 {
 }
 
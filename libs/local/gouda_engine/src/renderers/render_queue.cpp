@@ -0,0 +1,109 @@
+/**
+ * @file render_queue.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine sorted quad submission module implementation
+ */
+#include "renderers/render_queue.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+
+#include "debug/assert.hpp"
+
+namespace gouda {
+
+namespace internal {
+
+// Midpoints between the Z ranges in notes.txt, from the skybox (Z = 0.0) up to the UI overlay (Z = -1.0)
+static constexpr std::array<f32, 7> layer_band_limits{-0.025f, -0.125f, -0.25f, -0.4f, -0.55f, -0.7f, -0.9f};
+static_assert(layer_band_limits.size() + 1 == RenderQueue::LAYER_BAND_COUNT);
+static_assert(static_cast<u32>(BlendMode::Alpha) + 1 == RenderQueue::PIPELINE_COUNT);
+
+static constexpr u64 texture_mask{(1ull << 23) - 1};
+static constexpr u64 texture_array_bit{1ull << 23}; // Arrays sort apart from textures with the same id
+
+// Maps a float to an unsigned integer with the same ordering
+static u32 ordered_float_bits(const f32 value)
+{
+    const u32 bits{std::bit_cast<u32>(value)};
+    return (bits & 0x80000000u) != 0 ? ~bits : bits | 0x80000000u;
+}
+
+} // namespace internal
+
+void RenderQueue::Build(const std::span<const InstanceData> instances)
+{
+    m_entries.resize(instances.size());
+    for (size_t i = 0; i < instances.size(); ++i) {
+        m_entries[i] = {MakeSortKey(instances[i]), static_cast<u32>(i)};
+    }
+
+    // The index breaks ties so equal keys keep their submission order
+    std::ranges::sort(m_entries, [](const SortEntry &lhs, const SortEntry &rhs) {
+        return lhs.key != rhs.key ? lhs.key < rhs.key : lhs.index < rhs.index;
+    });
+
+    m_batches.clear();
+    for (size_t i = 0; i < m_entries.size(); ++i) {
+        const BlendMode blend_mode{Classify(instances[m_entries[i].index])};
+        if (m_batches.empty() || m_batches.back().blend_mode != blend_mode) {
+            m_batches.push_back({blend_mode, static_cast<u32>(i), 0});
+        }
+        ++m_batches.back().instance_count;
+    }
+}
+
+void RenderQueue::WriteInstances(const std::span<const InstanceData> instances, QuadInstance *out) const
+{
+    ASSERT(instances.size() == m_entries.size(), "Render queue was built from a different instance set.");
+
+    for (size_t i = 0; i < m_entries.size(); ++i) {
+        out[i] = QuadInstance{instances[m_entries[i].index]};
+    }
+}
+
+u64 RenderQueue::MakeSortKey(const InstanceData &instance)
+{
+    const u64 band{GetLayerBand(instance.position.z)};
+    const BlendMode blend_mode{Classify(instance)};
+    const u64 pipeline{static_cast<u64>(blend_mode)};
+
+    // Bits 63..60 band, 59..56 pipeline, the remaining 56 bits differ by pipeline
+    u64 key{band << 60 | pipeline << 56};
+    if (blend_mode == BlendMode::Alpha) {
+        // Back to front, equal depths keep their submission order so text stays over the panel under it
+        const u64 depth{~internal::ordered_float_bits(instance.position.z)};
+        key |= (depth & 0xFFFFFFFFull) << 24;
+    }
+    else {
+        // Group by texture, then front to back
+        const u64 texture{(instance.texture_index & internal::texture_mask) |
+                          (instance.texture_layer != InstanceData::NO_TEXTURE_LAYER ? internal::texture_array_bit : 0)};
+        const u64 depth{internal::ordered_float_bits(instance.position.z)};
+        key |= texture << 32 | depth;
+    }
+
+    return key;
+}
+
+BlendMode RenderQueue::Classify(const InstanceData &instance)
+{
+    // Without blending a translucent tint would come out solid
+    return instance.colour.a < 1.0f ? BlendMode::Alpha : instance.blend_mode;
+}
+
+u32 RenderQueue::GetLayerBand(const f32 z)
+{
+    u32 band{0};
+    for (const f32 limit : internal::layer_band_limits) {
+        if (z < limit) {
+            ++band;
+        }
+    }
+
+    return band;
+}
+
+} // namespace gouda
@@ -6,17 +6,145 @@
  */
 #include "renderers/text.hpp"
 
-#include <fstream>
+#include <algorithm>
+#include <cstring>
+#include <format>
 #include <nlohmann/json.hpp>
+#include <optional>
+#include <type_traits>
 
 #include "debug/logger.hpp"
 #include "debug/throw.hpp"
+#include "utils/filesystem.hpp"
+#include "utils/hash.hpp"
+#include "utils/mapped_file.hpp"
+#include "utils/utf8.hpp"
 
 namespace gouda {
 
+namespace internal {
+
+// Glyphs and atlas params are cached by a hash of the font JSON, one entry each as they are loaded separately.
+// Entries are never evicted, deleting the directory is safe.
+
+// "GGLY" and "GFNT", bump FONT_CACHE_VERSION whenever the file layout or the parser output changes
+constexpr u32 GLYPH_CACHE_MAGIC{0x594C4747};
+constexpr u32 FONT_PARAMS_CACHE_MAGIC{0x544E4647};
+constexpr u32 FONT_CACHE_VERSION{1};
+constexpr StringView FONT_CACHE_DIRECTORY{"cache/fonts"};
+
+// Followed by a fixed size body, then count records
+struct FontCacheHeader {
+    u32 magic;
+    u32 version;
+    u64 key;
+    u32 count;
+    u32 reserved;
+};
+
+struct GlyphCacheRecord {
+    u32 codepoint;
+    MSDFGlyph glyph;
+};
+
+// MSDFAtlasParams without the kerning vector, the pairs follow as records
+struct FontParamsCacheBody {
+    f32 distance_range;
+    f32 distance_range_middle;
+    f32 font_size;
+    f32 atlas_width;
+    f32 atlas_height;
+    f32 em_size;
+    f32 line_height;
+    f32 ascender;
+    f32 descender;
+    f32 underline_y;
+    f32 underline_thickness;
+    u32 y_origin_is_bottom;
+};
+
+static_assert(sizeof(FontCacheHeader) == 24 && std::is_trivially_copyable_v<FontCacheHeader>);
+static_assert(std::is_trivially_copyable_v<GlyphCacheRecord> && std::is_trivially_copyable_v<FontParamsCacheBody>);
+static_assert(std::is_trivially_copyable_v<MSDFKerningPair>);
+
+static u64 font_cache_key(const std::span<const std::byte> json, const u32 magic)
+{
+    const String settings{std::format("magic={:08x};version={}", magic, FONT_CACHE_VERSION)};
+    return utils::fnv1a(json, utils::fnv1a(settings));
+}
+
+static String font_cache_path(const u64 key) { return std::format("{}/{:016x}.bin", FONT_CACHE_DIRECTORY, key); }
+
+static std::optional<fs::MappedFile> find_cached_font(const u64 key, const u32 magic, const size_t body_size,
+                                                      const size_t record_size)
+{
+    auto file{fs::MappedFile::Open(font_cache_path(key))};
+    FontCacheHeader header{};
+    if (!file || file->GetSize() < sizeof(header)) {
+        return std::nullopt;
+    }
+    std::memcpy(&header, file->GetData().data(), sizeof(header));
+
+    if (header.magic != magic || header.version != FONT_CACHE_VERSION || header.key != key ||
+        file->GetSize() != sizeof(header) + body_size + static_cast<u64>(header.count) * record_size) {
+        ENGINE_LOG_WARNING("Ignoring invalid font cache entry '{}'", font_cache_path(key));
+        return std::nullopt;
+    }
+    return std::move(*file);
+}
+
+static void store_cached_font(const u64 key, const u32 magic, const std::span<const std::byte> body,
+                              const std::span<const std::byte> records, const u32 count)
+{
+    const FontCacheHeader header{
+        .magic = magic, .version = FONT_CACHE_VERSION, .key = key, .count = count, .reserved = 0};
+
+    std::vector<std::byte> file_data(sizeof(header) + body.size() + records.size());
+    std::memcpy(file_data.data(), &header, sizeof(header));
+    std::memcpy(file_data.data() + sizeof(header), body.data(), body.size());
+    std::memcpy(file_data.data() + sizeof(header) + body.size(), records.data(), records.size());
+
+    if (auto directory_result = fs::EnsureDirectoryExists(FilePath{FONT_CACHE_DIRECTORY}, true); !directory_result) {
+        ENGINE_LOG_WARNING("Failed to create font cache directory: {}", fs::error_to_string(directory_result.error()));
+        return;
+    }
+
+    if (!fs::WriteBinaryFile(font_cache_path(key), std::span<const std::byte>{file_data})) {
+        ENGINE_LOG_WARNING("Failed to write font cache entry '{}'", font_cache_path(key));
+    }
+}
+
+} // namespace internal
+
 // MSDFGlyph implementation  ----------------------------------------------
 MSDFGlyph::MSDFGlyph() : advance{0.0f}, plane_bounds{0.0f}, atlas_bounds{0.0f} {}
 
+// MSDFGlyphTable implementation  ----------------------------------------------
+MSDFGlyphTable::MSDFGlyphTable() : m_dense_glyphs{}, m_dense_present{}, m_dense_count{0} {}
+
+void MSDFGlyphTable::Insert(const u32 codepoint, const MSDFGlyph &glyph)
+{
+    if (codepoint >= DENSE_GLYPH_COUNT) {
+        m_sparse_glyphs[codepoint] = glyph;
+        return;
+    }
+
+    if (!m_dense_present[codepoint]) {
+        m_dense_present[codepoint] = true;
+        ++m_dense_count;
+    }
+    m_dense_glyphs[codepoint] = glyph;
+}
+
+void MSDFGlyphTable::SetKerning(const std::span<const MSDFKerningPair> pairs)
+{
+    m_kerning.clear();
+    m_kerning.reserve(pairs.size());
+    for (const MSDFKerningPair &pair : pairs) {
+        m_kerning[KerningKey(pair.unicode1, pair.unicode2)] = pair.advance;
+    }
+}
+
 // MSDFKerningPair implementation  ----------------------------------------------
 MSDFKerningPair::MSDFKerningPair() : unicode1{0}, unicode2{0}, advance{0}, _padding1{0} {}
 
@@ -48,21 +176,35 @@ std::string MSDFAtlasParams::ToString() const
 }
 
 // Functions --------------------------------------------------------------------
-std::unordered_map<char, MSDFGlyph> load_msdf_glyphs(std::string_view json_path)
+MSDFGlyphTable load_msdf_glyphs(std::string_view json_path)
 {
-    std::ifstream file(json_path.data());
-    if (!file.is_open()) {
+    const auto file{fs::MappedFile::Open(json_path)};
+    if (!file) {
         throw std::runtime_error("Failed to open JSON file: " + std::string(json_path));
     }
 
-    nlohmann::json data;
-    file >> data;
+    MSDFGlyphTable glyph_table;
+    const u64 cache_key{internal::font_cache_key(file->GetData(), internal::GLYPH_CACHE_MAGIC)};
+    if (const auto cache_file{internal::find_cached_font(cache_key, internal::GLYPH_CACHE_MAGIC, 0,
+                                                         sizeof(internal::GlyphCacheRecord))}) {
+        const std::span<const std::byte> records{cache_file->GetData().subspan(sizeof(internal::FontCacheHeader))};
+        for (size_t offset = 0; offset < records.size(); offset += sizeof(internal::GlyphCacheRecord)) {
+            internal::GlyphCacheRecord record{};
+            std::memcpy(&record, records.data() + offset, sizeof(record));
+            glyph_table.Insert(record.codepoint, record.glyph);
+        }
+        ENGINE_LOG_DEBUG("Loaded {} characters from the font cache: {}", glyph_table.Size(), json_path);
+        return glyph_table;
+    }
+
+    nlohmann::json data = nlohmann::json::parse(file->GetText());
 
     if (!data.contains("glyphs") || !data.contains("atlas")) {
         throw std::runtime_error("JSON file missing 'glyphs' or 'atlas' field");
     }
 
-    MSDFGlyphMap glyph_map;
+    Vector<internal::GlyphCacheRecord> cache_records;
+    cache_records.reserve(data["glyphs"].size());
     for (auto &[key, val] : data["glyphs"].items()) {
         MSDFGlyph glyph;
         if (!val.contains("advance") || !val.contains("planeBounds") || !val.contains("atlasBounds")) {
@@ -78,45 +220,85 @@ std::unordered_map<char, MSDFGlyph> load_msdf_glyphs(std::string_view json_path)
         glyph.atlas_bounds =
             Rect<f32>{ab["left"].get<f32>(), ab["right"].get<f32>(), ab["bottom"].get<f32>(), ab["top"].get<f32>()};
 
-        char c{0};
-        try {
-            c = key.length() == 1 ? key[0] : static_cast<char>(std::stoi(key));
+        // Keys are either the character itself (UTF-8) or its decimal codepoint
+        u32 codepoint{0};
+        if (key.length() > 1 && std::ranges::all_of(key, [](const char c) { return c >= '0' && c <= '9'; })) {
+            try {
+                codepoint = static_cast<u32>(std::stoul(key));
+            }
+            catch (const std::exception &e) {
+                ENGINE_LOG_WARNING("Invalid unicode key '{}': {}", key, e.what());
+                continue;
+            }
         }
-        catch (const std::exception &e) {
-            ENGINE_LOG_WARNING("Invalid unicode key '{}': {}", key, e.what());
-            continue;
+        else {
+            size_t offset{0};
+            codepoint = key.empty() ? utils::UTF8_REPLACEMENT_CHARACTER : utils::decode_utf8(key, offset);
+            if (codepoint == utils::UTF8_REPLACEMENT_CHARACTER || offset != key.length()) {
+                ENGINE_LOG_WARNING("Invalid unicode key '{}'", key);
+                continue;
+            }
         }
 
-        glyph_map[c] = glyph; // Add the glyph for the map
+        glyph_table.Insert(codepoint, glyph);
+        cache_records.push_back({codepoint, glyph});
 
         /*
         ENGINE_LOG_DEBUG(
             "Loaded glyph '{}'(unicode={}): advance={}, plane_bounds=({}, {}, {}, {}), atlas_bounds=({}, {}, {}, {})",
-            c, static_cast<int>(c), glyph.advance, glyph.plane_bounds.left, glyph.plane_bounds.bottom,
+            codepoint, codepoint, glyph.advance, glyph.plane_bounds.left, glyph.plane_bounds.bottom,
             glyph.plane_bounds.right, glyph.plane_bounds.top, glyph.atlas_bounds.left, glyph.atlas_bounds.bottom,
             glyph.atlas_bounds.right, glyph.atlas_bounds.top);
             */
     }
 
-    ENGINE_LOG_DEBUG("Loaded {} characters from {}", glyph_map.size(), json_path);
-    return glyph_map;
+    internal::store_cached_font(cache_key, internal::GLYPH_CACHE_MAGIC, {},
+                                std::as_bytes(std::span<const internal::GlyphCacheRecord>{cache_records}),
+                                static_cast<u32>(cache_records.size()));
+
+    ENGINE_LOG_DEBUG("Loaded {} characters from {}", glyph_table.Size(), json_path);
+    return glyph_table;
 }
 
 MSDFAtlasParams load_msdf_atlas_params(StringView json_path)
 {
-    std::ifstream file(json_path.data());
-    if (!file.is_open()) {
+    const auto file{fs::MappedFile::Open(json_path)};
+    if (!file) {
         throw std::runtime_error("Failed to open JSON file: " + String(json_path));
     }
 
-    nlohmann::json data;
-    file >> data;
+    MSDFAtlasParams atlas_params{};
+    const u64 cache_key{internal::font_cache_key(file->GetData(), internal::FONT_PARAMS_CACHE_MAGIC)};
+    if (const auto cache_file{internal::find_cached_font(cache_key, internal::FONT_PARAMS_CACHE_MAGIC,
+                                                         sizeof(internal::FontParamsCacheBody),
+                                                         sizeof(MSDFKerningPair))}) {
+        const std::span<const std::byte> data{cache_file->GetData().subspan(sizeof(internal::FontCacheHeader))};
+        internal::FontParamsCacheBody body{};
+        std::memcpy(&body, data.data(), sizeof(body));
+        atlas_params.distance_range = body.distance_range;
+        atlas_params.distance_range_middle = body.distance_range_middle;
+        atlas_params.font_size = body.font_size;
+        atlas_params.atlas_size = {body.atlas_width, body.atlas_height};
+        atlas_params.em_size = body.em_size;
+        atlas_params.line_height = body.line_height;
+        atlas_params.ascender = body.ascender;
+        atlas_params.descender = body.descender;
+        atlas_params.underline_y = body.underline_y;
+        atlas_params.underline_thickness = body.underline_thickness;
+        atlas_params.y_origin_is_bottom = body.y_origin_is_bottom != 0;
+
+        const std::span<const std::byte> pairs{data.subspan(sizeof(body))};
+        atlas_params.kerning.resize(pairs.size() / sizeof(MSDFKerningPair));
+        std::memcpy(atlas_params.kerning.data(), pairs.data(), pairs.size());
+        return atlas_params;
+    }
+
+    nlohmann::json data = nlohmann::json::parse(file->GetText());
 
     if (!data.contains("atlas") || !data.contains("metrics") || !data.contains("kerning")) {
         throw std::runtime_error("JSON file missing 'atlas', 'metrics' or 'kerning' field");
     }
 
-    MSDFAtlasParams atlas_params{};
     const auto &atlas = data["atlas"];
     const auto &metrics = data["metrics"];
 
@@ -148,6 +330,22 @@ MSDFAtlasParams load_msdf_atlas_params(StringView json_path)
         }
     }
 
+    const internal::FontParamsCacheBody body{.distance_range = atlas_params.distance_range,
+                                             .distance_range_middle = atlas_params.distance_range_middle,
+                                             .font_size = atlas_params.font_size,
+                                             .atlas_width = atlas_params.atlas_size.x,
+                                             .atlas_height = atlas_params.atlas_size.y,
+                                             .em_size = atlas_params.em_size,
+                                             .line_height = atlas_params.line_height,
+                                             .ascender = atlas_params.ascender,
+                                             .descender = atlas_params.descender,
+                                             .underline_y = atlas_params.underline_y,
+                                             .underline_thickness = atlas_params.underline_thickness,
+                                             .y_origin_is_bottom = atlas_params.y_origin_is_bottom ? 1u : 0u};
+    internal::store_cached_font(cache_key, internal::FONT_PARAMS_CACHE_MAGIC, std::as_bytes(std::span{&body, 1}),
+                                std::as_bytes(std::span<const MSDFKerningPair>{atlas_params.kerning}),
+                                static_cast<u32>(atlas_params.kerning.size()));
+
     return atlas_params;
 }
 
@@ -0,0 +1,121 @@
+/**
+ * @file tilemap.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine chunked tilemap module implementation
+ */
+#include "renderers/tilemap.hpp"
+
+#include <algorithm>
+
+#include "debug/assert.hpp"
+#include "debug/logger.hpp"
+#include "renderers/vulkan/vk_texture.hpp"
+
+namespace gouda {
+
+Tilemap::Tilemap() : Tilemap{0, 0, Vec2{0.0f}, Vec3{0.0f}, 0} {}
+
+Tilemap::Tilemap(const u32 width, const u32 height, const Vec2 &tile_size, const Vec3 &origin, const u32 texture_index)
+    : m_width{width},
+      m_height{height},
+      m_tile_size{tile_size},
+      m_origin{origin},
+      m_texture_index{texture_index},
+      m_sprites{},
+      m_tiles(static_cast<size_t>(width) * height, EMPTY_TILE)
+{
+}
+
+u16 Tilemap::AddSprite(const vk::Sprite &sprite)
+{
+    if (sprite.frames.empty()) {
+        ENGINE_LOG_WARNING("Tilemap sprite has no frames, it was not added.");
+        return EMPTY_TILE;
+    }
+    return AddSprite(sprite.frames.front().uv_rect);
+}
+
+u16 Tilemap::AddSprite(const UVRect<f32> &sprite_rect)
+{
+    if (m_sprites.size() >= EMPTY_TILE) {
+        ENGINE_LOG_WARNING("Tilemap palette is full at {} sprites.", m_sprites.size());
+        return EMPTY_TILE;
+    }
+    m_sprites.push_back(sprite_rect);
+    return static_cast<u16>(m_sprites.size() - 1);
+}
+
+void Tilemap::SetSprite(const u16 sprite, const UVRect<f32> &sprite_rect)
+{
+    ASSERT(sprite < m_sprites.size(), "Tile sprite is not in the tilemap's palette.");
+    m_sprites[sprite] = sprite_rect;
+}
+
+void Tilemap::SetTile(const u32 x, const u32 y, const u16 sprite)
+{
+    if (x >= m_width || y >= m_height) {
+        return;
+    }
+    ASSERT(sprite == EMPTY_TILE || sprite < m_sprites.size(), "Tile sprite is not in the tilemap's palette.");
+    m_tiles[static_cast<size_t>(y) * m_width + x] = sprite;
+}
+
+u16 Tilemap::GetTile(const u32 x, const u32 y) const
+{
+    if (x >= m_width || y >= m_height) {
+        return EMPTY_TILE;
+    }
+    return m_tiles[static_cast<size_t>(y) * m_width + x];
+}
+
+void Tilemap::Fill(const u16 sprite)
+{
+    ASSERT(sprite == EMPTY_TILE || sprite < m_sprites.size(), "Tile sprite is not in the tilemap's palette.");
+    std::ranges::fill(m_tiles, sprite);
+}
+
+void Tilemap::BuildChunks(const u32 chunk_size, std::vector<InstanceData> &instances,
+                          Vector<TilemapChunk> &chunks) const
+{
+    ASSERT(chunk_size > 0, "Tilemap chunks need at least one tile along each side.");
+    instances.clear();
+    chunks.clear();
+
+    const u32 chunk_count_x{(m_width + chunk_size - 1) / chunk_size};
+    const u32 chunk_count_y{(m_height + chunk_size - 1) / chunk_size};
+    const Vec2 chunk_extent{m_tile_size.x * static_cast<f32>(chunk_size), m_tile_size.y * static_cast<f32>(chunk_size)};
+    for (u32 chunk_y = 0; chunk_y < chunk_count_y; ++chunk_y) {
+        for (u32 chunk_x = 0; chunk_x < chunk_count_x; ++chunk_x) {
+            TilemapChunk chunk{};
+            chunk.first_instance = static_cast<u32>(instances.size());
+
+            const u32 end_x{math::min((chunk_x + 1) * chunk_size, m_width)};
+            const u32 end_y{math::min((chunk_y + 1) * chunk_size, m_height)};
+            for (u32 y = chunk_y * chunk_size; y < end_y; ++y) {
+                for (u32 x = chunk_x * chunk_size; x < end_x; ++x) {
+                    const u16 sprite{m_tiles[static_cast<size_t>(y) * m_width + x]};
+                    if (sprite == EMPTY_TILE) {
+                        continue;
+                    }
+                    const Vec3 position{m_origin.x + m_tile_size.x * static_cast<f32>(x),
+                                        m_origin.y + m_tile_size.y * static_cast<f32>(y), m_origin.z};
+                    instances.emplace_back(position, m_tile_size, 0.0f, m_texture_index, Colour(1.0f),
+                                           m_sprites[sprite], 1);
+                }
+            }
+
+            // Chunks without a tile are never drawn, so they are left out
+            chunk.instance_count = static_cast<u32>(instances.size()) - chunk.first_instance;
+            if (chunk.instance_count == 0) {
+                continue;
+            }
+            const Vec2 chunk_min{m_origin.x + chunk_extent.x * static_cast<f32>(chunk_x),
+                                 m_origin.y + chunk_extent.y * static_cast<f32>(chunk_y)};
+            chunk.bounds = math::AABB2D{chunk_min, chunk_min + chunk_extent};
+            chunks.push_back(chunk);
+        }
+    }
+}
+
+} // namespace gouda
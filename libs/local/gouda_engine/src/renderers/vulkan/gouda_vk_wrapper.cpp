@@ -23,6 +23,24 @@ void BeginCommandBuffer(VkCommandBuffer command_buffer_ptr, VkCommandBufferUsage
     }
 }
 
+void BeginSecondaryCommandBuffer(VkCommandBuffer command_buffer_ptr,
+                                 const VkCommandBufferInheritanceRenderingInfo &rendering_info)
+{
+    const VkCommandBufferInheritanceInfo inheritance_info{.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+                                                          .pNext = &rendering_info};
+
+    VkCommandBufferBeginInfo begin_info{};
+    begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    begin_info.pNext = nullptr;
+    // Not one time submit, the renderer executes unchanged passes again in later frames
+    begin_info.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+    begin_info.pInheritanceInfo = &inheritance_info;
+
+    if (const VkResult result{vkBeginCommandBuffer(command_buffer_ptr, &begin_info)}; result != VK_SUCCESS) {
+        CHECK_VK_RESULT(result, "vkBeginCommandBuffer");
+    }
+}
+
 void EndCommandBuffer(VkCommandBuffer command_buffer_ptr)
 {
     if (const VkResult result{vkEndCommandBuffer(command_buffer_ptr)}; result != VK_SUCCESS) {
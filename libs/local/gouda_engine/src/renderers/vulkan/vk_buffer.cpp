@@ -2,28 +2,34 @@
 
 #include <cstring> // For memcpy
 
-#include "renderers/vulkan/vk_utils.hpp"
+#include "debug/throw.hpp"
 
 namespace gouda::vk {
 
-Buffer::Buffer() : p_buffer{nullptr}, p_memory{nullptr}, m_allocation_size{0} {}
+Buffer::Buffer() : p_buffer{nullptr}, m_allocation{}, m_allocation_size{0} {}
 
-void *Buffer::MapPersistent(const VkDevice device) const
+void Buffer::Update(const void *data, const size_t size, const VkDeviceSize offset) const
 {
-    void *data{nullptr};
-    vkMapMemory(device, p_memory, 0, m_allocation_size, 0, &data);
-    return data;
+    if (!m_allocation.p_mapped) {
+        ENGINE_THROW("Cannot update a buffer that is not host visible.");
+    }
+
+    memcpy(static_cast<u8 *>(m_allocation.p_mapped) + offset, data, size);
+    Flush(offset, size);
 }
 
-void Buffer::Update(const VkDevice device, const void *data, const size_t size) const
+void Buffer::Flush(const VkDeviceSize offset, const VkDeviceSize size) const
 {
-    void *mapped{nullptr};
-    if (const VkResult result{vkMapMemory(device, p_memory, 0, size, 0, &mapped)}; result != VK_SUCCESS) {
-        CHECK_VK_RESULT(result, "vkMapMemory");
+    if (m_allocation.p_allocator) {
+        m_allocation.p_allocator->Flush(m_allocation, offset, size);
     }
+}
 
-    memcpy(mapped, data, size);
-    vkUnmapMemory(device, p_memory);
+void Buffer::Invalidate(const VkDeviceSize offset, const VkDeviceSize size) const
+{
+    if (m_allocation.p_allocator) {
+        m_allocation.p_allocator->Invalidate(m_allocation, offset, size);
+    }
 }
 
 void Buffer::Destroy(const VkDevice device)
@@ -33,9 +39,8 @@ void Buffer::Destroy(const VkDevice device)
         p_buffer = VK_NULL_HANDLE;
     }
 
-    if (p_memory != VK_NULL_HANDLE) {
-        vkFreeMemory(device, p_memory, nullptr);
-        p_memory = VK_NULL_HANDLE;
+    if (m_allocation.p_allocator) {
+        m_allocation.p_allocator->Free(m_allocation);
     }
 }
 
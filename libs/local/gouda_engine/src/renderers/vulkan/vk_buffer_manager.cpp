@@ -6,61 +6,120 @@
  */
 #include "renderers/vulkan/vk_buffer_manager.hpp"
 
+#include <algorithm>
+#include <cstring>
+#include <optional>
+#include <utility>
+
+#include "debug/assert.hpp"
 #include "debug/logger.hpp"
+#include "debug/profiler.hpp"
 #include "debug/throw.hpp"
+#include "math/math.hpp"
 #include "renderers/vulkan/vk_buffer.hpp"
 #include "renderers/vulkan/vk_command_buffer_manager.hpp"
 #include "renderers/vulkan/vk_device.hpp"
-#include "renderers/vulkan/vk_fence.hpp"
 #include "renderers/vulkan/vk_queue.hpp"
 #include "renderers/vulkan/vk_texture.hpp"
 #include "renderers/vulkan/vk_utils.hpp"
-#include "utils/defer.hpp"
 #include "utils/image.hpp"
 
 namespace gouda::vk {
 
-BufferManager::BufferManager(Device* device, Queue* queue, CommandBufferManager* command_buffer_manager)
+BufferManager::BufferManager(Device* device, Queue* queue, CommandBufferManager* command_buffer_manager,
+                             Queue *transfer_queue, CommandBufferManager *transfer_command_buffer_manager)
     : p_device(device),
       p_queue{queue},
       p_command_buffer_manager{command_buffer_manager},
-      p_copy_command_buffer{VK_NULL_HANDLE},
+      p_transfer_queue{transfer_queue},
+      p_transfer_command_buffer_manager{transfer_command_buffer_manager},
+      p_upload_queue{transfer_queue ? transfer_queue : queue},
+      m_host_write_preferred_properties{VK_MEMORY_PROPERTY_HOST_COHERENT_BIT},
       p_command_pool{VK_NULL_HANDLE},
-      p_copy_fence{nullptr}
+      p_staging_ring{nullptr},
+      p_sampler_cache{nullptr},
+      m_recording_batch{constants::u32_max},
+      m_next_batch_id{1}
 {
     if (!p_device || !p_queue || !p_command_buffer_manager) {
         ENGINE_THROW("Invalid device, queue, or command buffer manager in BufferManager");
     }
 
-    p_command_buffer_manager->AllocateBuffers(1, &p_copy_command_buffer);
-    if (p_copy_command_buffer == VK_NULL_HANDLE) {
-        ENGINE_THROW("Failed to allocate copy command buffer in BufferManager");
+    if (p_transfer_queue && !p_transfer_command_buffer_manager) {
+        ENGINE_THROW("Transfer queue given to BufferManager without a transfer command buffer manager");
+    }
+
+    CommandBufferManager *upload_command_buffer_manager{p_transfer_queue ? p_transfer_command_buffer_manager
+                                                                         : p_command_buffer_manager};
+
+    p_sampler_cache = std::make_unique<SamplerCache>(p_device->GetDevice());
+
+    m_upload_batches.resize(UPLOAD_BATCH_COUNT);
+    for (auto &batch : m_upload_batches) {
+        batch.p_command_buffer = VK_NULL_HANDLE;
+        batch.p_acquire_command_buffer = VK_NULL_HANDLE;
+        batch.m_batch_id = 0;
+        batch.m_timeline_value = NO_TIMELINE_VALUE;
+        batch.m_acquire_timeline_value = NO_TIMELINE_VALUE;
+        batch.m_waits_for_graphics = false;
+        batch.m_graphics_reads_staging = false;
+
+        upload_command_buffer_manager->AllocateBuffers(1, &batch.p_command_buffer);
+        if (batch.p_command_buffer == VK_NULL_HANDLE) {
+            ENGINE_THROW("Failed to allocate upload command buffer in BufferManager");
+        }
+
+        if (p_transfer_queue) {
+            p_command_buffer_manager->AllocateBuffers(1, &batch.p_acquire_command_buffer);
+            if (batch.p_acquire_command_buffer == VK_NULL_HANDLE) {
+                ENGINE_THROW("Failed to allocate upload acquire command buffer in BufferManager");
+            }
+        }
     }
 
-    p_copy_fence = std::make_unique<Fence>(p_device);
-    if (!p_copy_fence->Create(VK_FENCE_CREATE_SIGNALED_BIT)) {
-        ENGINE_THROW("Failed to create copy fence.");
+    if (p_transfer_queue) {
+        ENGINE_LOG_DEBUG("Buffer manager uploading through transfer queue family {}.",
+                         p_transfer_queue->GetQueueFamily());
     }
+
+    // Writes into the BAR window cross the bus once instead of being copied or read over it by the GPU
+    if (p_device->GetCapabilities().host_visible_vram) {
+        m_host_write_preferred_properties |= VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+        ENGINE_LOG_DEBUG("Host visible VRAM available, per frame buffers placed in device local memory.");
+    }
+
+    p_staging_ring = std::make_unique<StagingRing>(
+        p_device->GetDevice(),
+        CreateBuffer(STAGING_RING_SIZE, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                     VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT));
 }
 
 BufferManager::~BufferManager()
 {
-    if (p_device != VK_NULL_HANDLE) {
-        p_copy_fence.reset(); // Ensure fence is destroyed
+    FlushUploads();
+
+    // Pending copies still reference the command buffers and staging memory
+    for (auto &batch : m_upload_batches) {
+        WaitForBatch(batch);
+        RecycleUploadBatch(batch);
+
+        if (p_transfer_queue) {
+            p_transfer_command_buffer_manager->FreeBuffers(1, &batch.p_command_buffer);
+            p_command_buffer_manager->FreeBuffers(1, &batch.p_acquire_command_buffer);
+        }
+        else {
+            p_command_buffer_manager->FreeBuffers(1, &batch.p_command_buffer);
+        }
     }
-}
 
-Buffer BufferManager::CreateAndUploadStagingBuffer(const void *data, const VkDeviceSize size) const
-{
-    const Buffer staging_buffer{
-        CreateBuffer(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                     VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)};
-    staging_buffer.Update(p_device->GetDevice(), data, size);
-    return staging_buffer;
+    p_staging_ring.reset();
+    p_sampler_cache.reset();
 }
 
 Buffer BufferManager::CreateBuffer(const VkDeviceSize size, const VkBufferUsageFlags usage,
-                                   const VkMemoryPropertyFlags properties) const
+                                   const VkMemoryPropertyFlags properties,
+                                   const std::span<const u32> queue_families,
+                                   const VkMemoryPropertyFlags preferred_properties) const
 {
     VkBufferCreateInfo buffer_info{};
     buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
@@ -68,6 +127,12 @@ Buffer BufferManager::CreateBuffer(const VkDeviceSize size, const VkBufferUsageF
     buffer_info.usage = usage;
     buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
+    if (queue_families.size() > 1) {
+        buffer_info.sharingMode = VK_SHARING_MODE_CONCURRENT;
+        buffer_info.queueFamilyIndexCount = static_cast<u32>(queue_families.size());
+        buffer_info.pQueueFamilyIndices = queue_families.data();
+    }
+
     Buffer buffer{};
     VkResult result{vkCreateBuffer(p_device->GetDevice(), &buffer_info, nullptr, &buffer.p_buffer)};
     if (result != VK_SUCCESS) {
@@ -78,39 +143,37 @@ Buffer BufferManager::CreateBuffer(const VkDeviceSize size, const VkBufferUsageF
     vkGetBufferMemoryRequirements(p_device->GetDevice(), buffer.p_buffer, &mem_requirements);
     buffer.m_allocation_size = mem_requirements.size;
 
-    auto memory_type_index = GetMemoryTypeIndex(mem_requirements.memoryTypeBits, properties);
+    auto memory_type_index = GetMemoryTypeIndex(mem_requirements.memoryTypeBits, properties, preferred_properties);
     if (!memory_type_index) {
         ENGINE_THROW("Memory type selection failed: {}", memory_type_index.error());
     }
 
-    VkMemoryAllocateInfo alloc_info{};
-    alloc_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    alloc_info.allocationSize = mem_requirements.size;
-    alloc_info.memoryTypeIndex = *memory_type_index;
+    auto allocation = p_device->GetAllocator()->Allocate(mem_requirements, *memory_type_index,
+                                                         MemoryResourceKind::Linear);
+    if (!allocation) {
+        ENGINE_THROW("Buffer memory allocation failed: {}", allocation.error());
+    }
+    buffer.m_allocation = *allocation;
 
-    result = vkAllocateMemory(p_device->GetDevice(), &alloc_info, nullptr, &buffer.p_memory);
+    result = vkBindBufferMemory(p_device->GetDevice(), buffer.p_buffer, buffer.m_allocation.p_memory,
+                                buffer.m_allocation.m_offset);
     if (result != VK_SUCCESS) {
-        CHECK_VK_RESULT(result, "vkAllocateMemory");
+        CHECK_VK_RESULT(result, "vkBindBufferMemory");
     }
 
-    vkBindBufferMemory(p_device->GetDevice(), buffer.p_buffer, buffer.p_memory, 0);
     return buffer;
 }
 
 Buffer BufferManager::CreateVertexBuffer(const void *data, const VkDeviceSize size) const
 {
-    // Create a staging buffer and defer its destruction
-    Buffer staging_buffer{CreateAndUploadStagingBuffer(data, size)};
-    DEFER { staging_buffer.Destroy(p_device->GetDevice()); });
-
     const Buffer vertex_buffer{CreateBuffer(
         size, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)};
 
-    CopyBufferToBuffer(vertex_buffer.p_buffer, staging_buffer.p_buffer, size, p_copy_command_buffer);
-
-    // Wait for the copy to complete
-    p_copy_fence->WaitFor(constants::u64_max);
+    // The copy is ordered before any later submission, no need to wait for it here. Nothing can be reading a buffer
+    // just created, so unlike UploadBufferData the transfer does not wait for the graphics queue.
+    const StagingAllocation staging{StageData(data, size)};
+    CopyBufferToBuffer(vertex_buffer.p_buffer, staging.p_buffer, size, staging.m_offset, 0);
 
     return vertex_buffer;
 }
@@ -118,35 +181,37 @@ Buffer BufferManager::CreateVertexBuffer(const void *data, const VkDeviceSize si
 Buffer BufferManager::CreateDynamicVertexBuffer(const VkDeviceSize size) const
 {
     constexpr VkBufferUsageFlags usage{VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT};
-    return CreateBuffer(size, usage, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    return CreateBuffer(size, usage, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, {}, m_host_write_preferred_properties);
 }
 
-Buffer BufferManager::CreateUniformBuffer(const size_t size) const
+Buffer BufferManager::CreateDynamicIndirectBuffer(const VkDeviceSize size) const
 {
-    return CreateBuffer(size, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-                        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    return CreateBuffer(size, VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, {},
+                        m_host_write_preferred_properties);
 }
 
-Buffer BufferManager::CreateIndexBuffer(const void *data, const VkDeviceSize size) const
+Buffer BufferManager::CreateUniformBuffer(const size_t size, const std::span<const u32> queue_families) const
 {
-    // Create a staging buffer and defer its destruction
-    Buffer staging_buffer{CreateAndUploadStagingBuffer(data, size)};
-    DEFER { staging_buffer.Destroy(p_device->GetDevice()); });
+    return CreateBuffer(size, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, queue_families,
+                        m_host_write_preferred_properties);
+}
 
+Buffer BufferManager::CreateIndexBuffer(const void *data, const VkDeviceSize size) const
+{
     const Buffer index_buffer{CreateBuffer(size, VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
                                            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)};
 
-    CopyBufferToBuffer(index_buffer.p_buffer, staging_buffer.p_buffer, size, p_copy_command_buffer);
-
-    // Wait for the copy to complete
-    p_copy_fence->WaitFor(constants::u64_max);
+    // The copy is ordered before any later submission, no need to wait for it here
+    UploadBufferData(index_buffer.p_buffer, data, size);
 
     return index_buffer;
 }
 
-Buffer BufferManager::CreateStorageBuffer(VkDeviceSize size, VkBufferUsageFlags additional_usage) const {
+Buffer BufferManager::CreateStorageBuffer(VkDeviceSize size, VkBufferUsageFlags additional_usage,
+                                          const std::span<const u32> queue_families) const {
     const VkBufferUsageFlags usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | additional_usage;
-    return CreateBuffer(size, usage, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    return CreateBuffer(size, usage, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, queue_families,
+                        m_host_write_preferred_properties);
 }
 
 void BufferManager::CreateImage(Texture &texture, const VkImageCreateInfo &image_info,
@@ -165,16 +230,21 @@ void BufferManager::CreateImage(Texture &texture, const VkImageCreateInfo &image
         ENGINE_THROW("Memory type selection failed: {}", memory_type_index.error());
     }
 
-    const VkMemoryAllocateInfo memory_allocate_info{.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-                                                    .allocationSize = memory_requirements.size,
-                                                    .memoryTypeIndex = *memory_type_index};
+    // Linear images share blocks with buffers, optimal ones get their own so granularity never applies
+    const MemoryResourceKind kind{image_info.tiling == VK_IMAGE_TILING_OPTIMAL ? MemoryResourceKind::Optimal
+                                                                                : MemoryResourceKind::Linear};
 
-    result = vkAllocateMemory(p_device->GetDevice(), &memory_allocate_info, nullptr, &texture.p_memory);
-    if (result != VK_SUCCESS) {
-        CHECK_VK_RESULT(result, "vkAllocateMemory");
+    auto allocation = p_device->GetAllocator()->Allocate(memory_requirements, *memory_type_index, kind);
+    if (!allocation) {
+        ENGINE_THROW("Image memory allocation failed: {}", allocation.error());
     }
+    texture.m_allocation = *allocation;
 
-    vkBindImageMemory(p_device->GetDevice(), texture.p_image, texture.p_memory, 0);
+    result = vkBindImageMemory(p_device->GetDevice(), texture.p_image, texture.m_allocation.p_memory,
+                               texture.m_allocation.m_offset);
+    if (result != VK_SUCCESS) {
+        CHECK_VK_RESULT(result, "vkBindImageMemory");
+    }
 }
 
 void BufferManager::CreateDepthImage(Texture &texture, const ImageSize size, const VkFormat format) const
@@ -196,14 +266,136 @@ void BufferManager::CreateDepthImage(Texture &texture, const ImageSize size, con
 }
 
 void BufferManager::CopyBufferToBuffer(VkBuffer destination, VkBuffer source, const VkDeviceSize size,
-                                       VkCommandBuffer command_buffer) const
+                                       const VkDeviceSize source_offset, const VkDeviceSize destination_offset) const
 {
-    BeginCommandBuffer(command_buffer, VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+    const VkBufferCopy copy_region{.srcOffset = source_offset, .dstOffset = destination_offset, .size = size};
+    vkCmdCopyBuffer(GetUploadCommandBuffer(), source, destination, 1, &copy_region);
+
+    if (p_transfer_queue) {
+        // Released to the graphics queue once the batch is flushed
+        m_upload_batches[m_recording_batch].m_buffer_releases.push_back(
+            VkBufferMemoryBarrier{.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+                                  .pNext = nullptr,
+                                  .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+                                  .dstAccessMask = 0,
+                                  .srcQueueFamilyIndex = p_device->GetTransferQueueFamily(),
+                                  .dstQueueFamilyIndex = p_device->GetQueueFamily(),
+                                  .buffer = destination,
+                                  .offset = destination_offset,
+                                  .size = size});
+    }
+}
 
-    const VkBufferCopy copy_region{.srcOffset = 0, .dstOffset = 0, .size = size};
-    vkCmdCopyBuffer(command_buffer, source, destination, 1, &copy_region);
+UploadHandle BufferManager::UploadBufferData(VkBuffer destination, const void *data, const VkDeviceSize size,
+                                             const VkDeviceSize destination_offset) const
+{
+    const StagingAllocation staging{StageData(data, size)};
+    CopyBufferToBuffer(destination, staging.p_buffer, size, staging.m_offset, destination_offset);
+    if (p_transfer_queue) {
+        // The range may be read by graphics work already submitted, which the transfer queue is not ordered after
+        m_upload_batches[m_recording_batch].m_waits_for_graphics = true;
+    }
+
+    return UploadHandle{m_upload_batches[m_recording_batch].m_batch_id};
+}
 
-    SubmitCopyCommand(command_buffer);
+UploadHandle BufferManager::FlushUploads() const
+{
+    if (m_recording_batch == constants::u32_max) {
+        return UploadHandle{m_next_batch_id - 1};
+    }
+
+    UploadBatch &batch{m_upload_batches[m_recording_batch]};
+
+    if (p_transfer_queue) {
+        // Release everything written by this batch, the matching acquires are recorded on the graphics side
+        if (!batch.m_buffer_releases.empty() || !batch.m_image_releases.empty()) {
+            vkCmdPipelineBarrier(batch.p_command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                 VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr,
+                                 static_cast<u32>(batch.m_buffer_releases.size()), batch.m_buffer_releases.data(),
+                                 static_cast<u32>(batch.m_image_releases.size()), batch.m_image_releases.data());
+        }
+    }
+    else {
+        // Make all transfer writes of this batch visible to whatever the following submissions read them with
+        const VkMemoryBarrier barrier{.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+                                      .pNext = nullptr,
+                                      .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+                                      .dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT |
+                                                       VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_SHADER_READ_BIT};
+        vkCmdPipelineBarrier(batch.p_command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, UPLOAD_CONSUMER_STAGES, 0, 1,
+                             &barrier, 0, nullptr, 0, nullptr);
+    }
+
+    if (const VkResult result{vkEndCommandBuffer(batch.p_command_buffer)}; result != VK_SUCCESS) {
+        CHECK_VK_RESULT(result, "vkEndCommandBuffer");
+    }
+
+    if (p_transfer_queue) {
+        // Re-uploads must not overwrite a buffer or image the graphics queue may still be reading
+        batch.m_timeline_value =
+            batch.m_waits_for_graphics
+                ? p_transfer_queue->Submit(batch.p_command_buffer, p_queue->GetTimelineSemaphore(),
+                                           p_queue->GetLastSubmittedValue(), VK_PIPELINE_STAGE_TRANSFER_BIT)
+                : p_transfer_queue->Submit(batch.p_command_buffer);
+
+        RecordAcquireBarriers(batch);
+        for (const MipGeneration &mip_generation : batch.m_mip_generations) {
+            RecordMipGeneration(batch.p_acquire_command_buffer, mip_generation);
+        }
+        if (const VkResult result{vkEndCommandBuffer(batch.p_acquire_command_buffer)}; result != VK_SUCCESS) {
+            CHECK_VK_RESULT(result, "vkEndCommandBuffer");
+        }
+
+        // Only the consumer stages wait, so graphics work already queued keeps running alongside the copies
+        batch.m_acquire_timeline_value =
+            p_queue->Submit(batch.p_acquire_command_buffer, p_transfer_queue->GetTimelineSemaphore(),
+                            batch.m_timeline_value, UPLOAD_CONSUMER_STAGES);
+    }
+    else {
+        batch.m_timeline_value = p_queue->Submit(batch.p_command_buffer);
+    }
+
+    p_staging_ring->Retire(batch.m_timeline_value);
+    m_recording_batch = constants::u32_max;
+
+    return UploadHandle{batch.m_batch_id};
+}
+
+bool BufferManager::IsUploadComplete(const UploadHandle handle) const
+{
+    if (m_recording_batch != constants::u32_max &&
+        m_upload_batches[m_recording_batch].m_batch_id == handle.m_batch_id) {
+        return false;
+    }
+
+    // Batches are only recycled once complete, so a handle without a batch has finished
+    const UploadBatch *batch{FindUploadBatch(handle)};
+    return !batch || IsBatchComplete(*batch);
+}
+
+void BufferManager::WaitForUpload(const UploadHandle handle) const
+{
+    if (m_recording_batch != constants::u32_max &&
+        m_upload_batches[m_recording_batch].m_batch_id == handle.m_batch_id) {
+        FlushUploads();
+    }
+
+    if (const UploadBatch *batch{FindUploadBatch(handle)}) {
+        WaitForBatch(*batch);
+    }
+}
+
+void BufferManager::RetireUploads() const
+{
+    p_staging_ring->Reclaim(GetReclaimableStagingValue());
+
+    for (u32 i = 0; i < m_upload_batches.size(); ++i) {
+        UploadBatch &batch{m_upload_batches[i]};
+        if (i != m_recording_batch && batch.m_timeline_value != NO_TIMELINE_VALUE && IsBatchComplete(batch)) {
+            RecycleUploadBatch(batch);
+        }
+    }
 }
 
 void BufferManager::CreateTextureImageFromData(Texture &texture, const void *pixels_ptr, const ImageSize image_size,
@@ -216,24 +408,78 @@ void BufferManager::CreateTextureImageFromData(Texture &texture, const void *pix
 
 std::unique_ptr<Texture> BufferManager::CreateTexture(StringView file_name, const u32 mips, const u32 layers) const
 {
-    const auto image_result = Image::Load(file_name, 4);
-    if (!image_result) {
-        ENGINE_LOG_ERROR("Failed to load texture: {}. Using default texture instead.", file_name);
+    const auto source_result = LoadTextureSource(file_name);
+    if (!source_result) {
+        ENGINE_LOG_ERROR("Failed to load texture: {} ({}). Using default texture instead.", file_name,
+                         source_result.error());
         return CreateDefaultTexture(); // Fallback to default texture
     }
 
-    const auto &image = image_result.value();
-    auto texture = std::make_unique<Texture>();
-    const VkFormat format{image_channels_to_vk_format(image.GetChannels())};
+    if (const auto *image = std::get_if<Image>(&source_result.value())) {
+        return CreateTextureFromImage(*image, mips, layers);
+    }
+    return CreateTextureFromKTX2(std::get<KTX2File>(source_result.value()));
+}
 
-    CreateTextureImage(*texture, image.GetSize(), format, mips, layers, 0);
-    UpdateTextureImage(*texture, image.GetSize(), format, layers, image.data().data(), VK_IMAGE_LAYOUT_UNDEFINED);
-    texture->p_view =
-        CreateImageView(texture->p_image, format, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_VIEW_TYPE_2D, layers, mips);
-    texture->p_sampler =
-        CreateTextureSampler(VK_FILTER_LINEAR, VK_FILTER_LINEAR, VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE);
+Expect<TextureSource, String> BufferManager::LoadTextureSource(StringView file_name) const
+{
+    String image_filepath{file_name};
+    if (KTX2File::IsKTX2Path(file_name)) {
+        auto ktx2_result = KTX2File::Load(file_name);
+        if (ktx2_result && p_device->IsFormatSupported(ktx2_result->GetFormat())) {
+            return TextureSource{std::move(ktx2_result.value())};
+        }
 
-    return texture;
+        if (!ktx2_result) {
+            ENGINE_LOG_WARNING("Failed to load KTX2 texture '{}': {}", file_name, ktx2_result.error());
+        }
+        else {
+            ENGINE_LOG_WARNING("Device cannot sample format {} of KTX2 texture '{}'",
+                               std::to_underlying(ktx2_result->GetFormat()), file_name);
+        }
+
+        image_filepath = FilePath{file_name}.replace_extension(".png").string();
+        ENGINE_LOG_DEBUG("Falling back to uncompressed texture '{}'", image_filepath);
+    }
+
+    auto image_result = Image::Load(image_filepath, 4);
+    if (!image_result) {
+        return std::unexpected(std::move(image_result.error()));
+    }
+    return TextureSource{std::move(image_result.value())};
+}
+
+std::unique_ptr<Texture> BufferManager::CreateTextureFromSource(const TextureSource &source, const u32 mips) const
+{
+    if (const auto *image = std::get_if<Image>(&source)) {
+        return CreateTextureFromImage(*image, mips);
+    }
+    return CreateTextureFromKTX2(std::get<KTX2File>(source));
+}
+
+std::unique_ptr<Texture> BufferManager::CreateTextureFromImage(const Image &image, const u32 mips,
+                                                               const u32 layers) const
+{
+    return CreateSampledTexture(image.data().data(), image.GetSize(), image_channels_to_vk_format(image.GetChannels()),
+                                mips, layers, VK_IMAGE_VIEW_TYPE_2D);
+}
+
+std::unique_ptr<Texture> BufferManager::CreateTextureArray(const std::span<const Image> layers, const u32 mips) const
+{
+    ASSERT(!layers.empty(), "Texture array created without layers.");
+
+    const Image &first{layers.front()};
+    const size_t layer_bytes{first.data().size()};
+    Vector<stbi_uc> pixels;
+    pixels.resize_uninitialized(layer_bytes * layers.size());
+    for (size_t layer = 0; layer < layers.size(); ++layer) {
+        ASSERT(layers[layer].GetSize() == first.GetSize() && layers[layer].GetChannels() == first.GetChannels(),
+               "Texture array layer {} differs in size or channels from the first layer.", layer);
+        std::ranges::copy(layers[layer].data(), pixels.data() + layer * layer_bytes);
+    }
+
+    return CreateSampledTexture(pixels.data(), first.GetSize(), image_channels_to_vk_format(first.GetChannels()), mips,
+                                static_cast<u32>(layers.size()), VK_IMAGE_VIEW_TYPE_2D_ARRAY);
 }
 
 std::unique_ptr<Texture> BufferManager::CreateTexture(StringView file_name, const u32 mips, const u32 layers,
@@ -253,7 +499,55 @@ std::unique_ptr<Texture> BufferManager::CreateTexture(StringView file_name, cons
     UpdateTextureImage(*texture, image.GetSize(), format, layers, image.data().data(), VK_IMAGE_LAYOUT_UNDEFINED);
     texture->p_view =
         CreateImageView(texture->p_image, format, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_VIEW_TYPE_2D, layers, mips);
-    texture->p_sampler = CreateTextureSampler(filter, filter, VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE);
+    texture->p_sampler = GetTextureSampler(filter, filter, VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE);
+
+    return texture;
+}
+
+std::unique_ptr<Texture> BufferManager::CreateTextureFromKTX2(const KTX2File &file) const
+{
+    const VkFormat format{file.GetFormat()};
+    const ImageSize size{file.GetSize()};
+    const u32 layer_count{file.GetLayerCount()};
+    const u32 level_count{file.GetLevelCount()};
+
+    // All levels go through one staging allocation, the copy regions point into it with the file's level offsets
+    const std::span<const std::byte> data{file.GetData()};
+    u64 data_begin{file.GetLevels().front().offset};
+    u64 data_end{0};
+    for (const KTX2Level &level : file.GetLevels()) {
+        data_begin = math::min(data_begin, level.offset);
+        data_end = math::max(data_end, level.offset + level.size);
+    }
+
+    const StagingAllocation staging{StageData(data.data() + data_begin, data_end - data_begin)};
+
+    Vector<VkBufferImageCopy> regions;
+    regions.reserve(level_count);
+    for (u32 level = 0; level < level_count; ++level) {
+        const KTX2Level &level_data{file.GetLevels()[level]};
+        regions.push_back(VkBufferImageCopy{
+            .bufferOffset = staging.m_offset + (level_data.offset - data_begin),
+            .bufferRowLength = 0,
+            .bufferImageHeight = 0,
+            .imageSubresource = VkImageSubresourceLayers{VK_IMAGE_ASPECT_COLOR_BIT, level, 0, layer_count},
+            .imageOffset = {0, 0, 0},
+            .imageExtent = {math::max(static_cast<u32>(size.width) >> level, 1u),
+                            math::max(static_cast<u32>(size.height) >> level, 1u), 1}});
+    }
+
+    auto texture = std::make_unique<Texture>();
+    CreateTextureImage(*texture, size, format, level_count, layer_count, 0);
+    RecordImageUpload(texture->p_image, format, VK_IMAGE_LAYOUT_UNDEFINED, staging.p_buffer, regions, layer_count,
+                      level_count);
+
+    const VkImageViewType view_type{layer_count > 1 ? VK_IMAGE_VIEW_TYPE_2D_ARRAY : VK_IMAGE_VIEW_TYPE_2D};
+    texture->p_view =
+        CreateImageView(texture->p_image, format, VK_IMAGE_ASPECT_COLOR_BIT, view_type, layer_count, level_count);
+    texture->p_sampler = GetTextureSampler(VK_FILTER_LINEAR, VK_FILTER_LINEAR, VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE);
+
+    ENGINE_LOG_DEBUG("KTX2 texture created: {}x{}, format {}, {} levels, {} layers, {} bytes", size.width,
+                     size.height, std::to_underlying(format), level_count, layer_count, data_end - data_begin);
 
     return texture;
 }
@@ -264,9 +558,7 @@ std::unique_ptr<Texture> BufferManager::CreateDefaultTexture() const
     constexpr u32 white_pixel{0xFFFFFFFF}; // RGBA white
     constexpr VkDeviceSize image_size{sizeof(u32)};
 
-    // Create a staging buffer and defer its destruction
-    Buffer staging_buffer{CreateAndUploadStagingBuffer(&white_pixel, image_size)};
-    DEFER { staging_buffer.Destroy(p_device->GetDevice()); });
+    const StagingAllocation staging{StageData(&white_pixel, image_size)};
 
     VkImageCreateInfo image_info{};
     image_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
@@ -285,18 +577,41 @@ std::unique_ptr<Texture> BufferManager::CreateDefaultTexture() const
     CreateImage(*texture, image_info, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 
     // Transition layout and copy data
-    TransitionImageLayout(texture->p_image, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_LAYOUT_UNDEFINED,
-                          VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, 1);
-    CopyBufferToImage(staging_buffer.p_buffer, texture->p_image, ImageSize{1, 1}, 1);
-    TransitionImageLayout(texture->p_image, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                          VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, 1, 1);
+    RecordImageUpload(texture->p_image, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_LAYOUT_UNDEFINED, staging, ImageSize{1, 1},
+                      1);
 
     // Create view and sampler
     texture->p_view = CreateImageView(texture->p_image, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_ASPECT_COLOR_BIT,
                                       VK_IMAGE_VIEW_TYPE_2D, 1, 1);
-    texture->p_sampler = CreateTextureSampler(VK_FILTER_LINEAR, VK_FILTER_LINEAR, VK_SAMPLER_ADDRESS_MODE_REPEAT);
+    texture->p_sampler = GetTextureSampler(VK_FILTER_LINEAR, VK_FILTER_LINEAR, VK_SAMPLER_ADDRESS_MODE_REPEAT);
+
+    return texture;
+}
+
+std::unique_ptr<Texture> BufferManager::CreateRenderTargetTexture(const ImageSize size, const VkFormat format) const
+{
+    VkImageCreateInfo image_info{};
+    image_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    image_info.imageType = VK_IMAGE_TYPE_2D;
+    image_info.format = format;
+    image_info.extent = {static_cast<u32>(size.width), static_cast<u32>(size.height), 1};
+    image_info.mipLevels = 1;
+    image_info.arrayLayers = 1;
+    image_info.samples = VK_SAMPLE_COUNT_1_BIT;
+    image_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+    image_info.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    image_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    image_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 
-    staging_buffer.Destroy(p_device->GetDevice());
+    auto texture = std::make_unique<Texture>();
+    CreateImage(*texture, image_info, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+    // No layout transition, the render graph discards the undefined contents when the target is first drawn
+    texture->p_view =
+        CreateImageView(texture->p_image, format, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_VIEW_TYPE_2D, 1, 1);
+    texture->p_sampler = GetTextureSampler(VK_FILTER_LINEAR, VK_FILTER_LINEAR, VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE);
+
+    ENGINE_LOG_DEBUG("Render target texture created: {}x{}", size.width, size.height);
 
     return texture;
 }
@@ -314,6 +629,10 @@ void BufferManager::CreateTextureImage(Texture &texture, const ImageSize size, c
     image_info.samples = VK_SAMPLE_COUNT_1_BIT;
     image_info.tiling = VK_IMAGE_TILING_OPTIMAL;
     image_info.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    if (mip_levels > 1) {
+        // Generated mips are blitted from the level above, which needs the image as a transfer source
+        image_info.usage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    }
     image_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
     image_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
     image_info.flags = flags;
@@ -321,46 +640,67 @@ void BufferManager::CreateTextureImage(Texture &texture, const ImageSize size, c
     CreateImage(texture, image_info, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 }
 
-void BufferManager::UpdateTextureImage(const Texture &texture, const ImageSize size, const VkFormat format,
-                                       const u32 layer_count, const void *data, const VkImageLayout initial_layout) const
+UploadHandle BufferManager::UpdateTextureImage(const Texture &texture, const ImageSize size, const VkFormat format,
+                                               const u32 layer_count, const void *data,
+                                               const VkImageLayout initial_layout) const
 {
     const u32 image_channel_count{vk_format_to_channel_count(format)};
-    const VkDeviceSize image_size{size.area() * image_channel_count};
+    const VkDeviceSize image_size{static_cast<VkDeviceSize>(size.area()) * image_channel_count * layer_count};
+
+    const StagingAllocation staging{StageData(data, image_size)};
+    RecordImageUpload(texture.p_image, format, initial_layout, staging, size, layer_count);
 
-    // Create a staging buffer and defer its destruction
-    Buffer staging_buffer{CreateAndUploadStagingBuffer(data, image_size)};
-    DEFER { staging_buffer.Destroy(p_device->GetDevice()); });
+    return UploadHandle{m_upload_batches[m_recording_batch].m_batch_id};
+}
 
-    TransitionImageLayout(texture.p_image, format, initial_layout, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, layer_count,
-                          1);
-    CopyBufferToImage(staging_buffer.p_buffer, texture.p_image, size, layer_count);
+UploadHandle BufferManager::UpdateTextureRows(const Texture &texture, const ImageSize size, const VkFormat format,
+                                              const u32 first_row, const u32 row_count, const void *data) const
+{
+    const VkDeviceSize row_size{static_cast<VkDeviceSize>(size.width) * vk_format_to_channel_count(format)};
+    const StagingAllocation staging{StageData(data, row_size * row_count)};
+
+    const VkBufferImageCopy region{
+        .bufferOffset = staging.m_offset,
+        .bufferRowLength = 0,
+        .bufferImageHeight = 0,
+        .imageSubresource = VkImageSubresourceLayers{VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1},
+        .imageOffset = {0, static_cast<s32>(first_row), 0},
+        .imageExtent = {static_cast<u32>(size.width), row_count, 1}};
+
+    // Leaving SHADER_READ_ONLY keeps the contents, the barrier waits for the frames still sampling the texture
+    TransitionImageLayout(texture.p_image, format, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                          VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, 1);
+    vkCmdCopyBufferToImage(GetGraphicsCommandBuffer(), staging.p_buffer, texture.p_image,
+                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+    if (p_transfer_queue) {
+        // The rows are read by the acquire submission, their ring space is held until it finishes as well
+        m_upload_batches[m_recording_batch].m_graphics_reads_staging = true;
+    }
     TransitionImageLayout(texture.p_image, format, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                          VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, layer_count, 1);
+                          VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, 1, 1);
+
+    return UploadHandle{m_upload_batches[m_recording_batch].m_batch_id};
 }
 
 void BufferManager::CopyBufferToImage(VkBuffer source, VkImage destination, const ImageSize image_size,
-                                      const u32 layer_count) const
+                                      const u32 layer_count, const VkDeviceSize source_offset) const
 {
-    BeginCommandBuffer(p_copy_command_buffer, VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
     const VkBufferImageCopy region{
-        .bufferOffset = 0,
+        .bufferOffset = source_offset,
         .bufferRowLength = 0,
         .bufferImageHeight = 0,
         .imageSubresource = VkImageSubresourceLayers{VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, layer_count},
         .imageOffset = {0, 0, 0},
         .imageExtent = {static_cast<u32>(image_size.width), static_cast<u32>(image_size.height), 1}};
 
-    vkCmdCopyBufferToImage(p_copy_command_buffer, source, destination, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1,
+    vkCmdCopyBufferToImage(GetUploadCommandBuffer(), source, destination, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1,
                            &region);
-    SubmitCopyCommand(p_copy_command_buffer);
 }
 
 void BufferManager::TransitionImageLayout(VkImage image, const VkFormat format, const VkImageLayout old_layout,
                                           const VkImageLayout new_layout, const u32 layer_count,
                                           const u32 mip_levels) const
 {
-    BeginCommandBuffer(p_copy_command_buffer, VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
-
     VkImageMemoryBarrier barrier{};
     barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
     barrier.oldLayout = old_layout;
@@ -489,9 +829,9 @@ void BufferManager::TransitionImageLayout(VkImage image, const VkFormat format,
         destination_stage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
     }
 
-    vkCmdPipelineBarrier(p_copy_command_buffer, source_stage, destination_stage, 0, 0, nullptr, 0, nullptr, 1,
+    // Graphics and fragment stages are not available on a transfer queue
+    vkCmdPipelineBarrier(GetGraphicsCommandBuffer(), source_stage, destination_stage, 0, 0, nullptr, 0, nullptr, 1,
                          &barrier);
-    SubmitCopyCommand(p_copy_command_buffer);
 }
 
 VkImageView BufferManager::CreateImageView(VkImage image, const VkFormat format, const VkImageAspectFlags aspect_flags,
@@ -523,64 +863,407 @@ VkImageView BufferManager::CreateImageView(VkImage image, const VkFormat format,
     return image_view;
 }
 
-VkSampler BufferManager::CreateTextureSampler(const VkFilter minFilter, const VkFilter magFilter,
-                                              const VkSamplerAddressMode addressMode) const
-{
-    VkSamplerCreateInfo samplerInfo{};
-    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
-    samplerInfo.magFilter = magFilter;
-    samplerInfo.minFilter = minFilter;
-    samplerInfo.addressModeU = addressMode;
-    samplerInfo.addressModeV = addressMode;
-    samplerInfo.addressModeW = addressMode;
-    samplerInfo.anisotropyEnable = VK_FALSE; // Disable anisotropy for simplicity
-    samplerInfo.maxAnisotropy = 1.0f;
-    samplerInfo.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
-    samplerInfo.unnormalizedCoordinates = VK_FALSE;
-    samplerInfo.compareEnable = VK_FALSE;
-    samplerInfo.compareOp = VK_COMPARE_OP_ALWAYS;
-    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
-    samplerInfo.mipLodBias = 0.0f;
-    samplerInfo.minLod = 0.0f;
-    samplerInfo.maxLod = 0.0f;
-
-    VkSampler sampler{VK_NULL_HANDLE};
-    if (const VkResult result{vkCreateSampler(p_device->GetDevice(), &samplerInfo, nullptr, &sampler)};
-        result != VK_SUCCESS) {
-        ENGINE_THROW("Failed to create texture sampler in BufferManager");
-    }
-
-    return sampler;
+VkSampler BufferManager::GetTextureSampler(const VkFilter min_filter, const VkFilter mag_filter,
+                                           const VkSamplerAddressMode address_mode) const
+{
+    return p_sampler_cache->Get(SamplerState{min_filter, mag_filter, address_mode});
 }
 
 // Private functions -----------------------------------------------------------------------------------
 Expect<u32, String> BufferManager::GetMemoryTypeIndex(const u32 memory_type_bits,
-                                                           const VkMemoryPropertyFlags required_properties) const
+                                                           const VkMemoryPropertyFlags required_properties,
+                                                           const VkMemoryPropertyFlags preferred_properties) const
 {
     const VkPhysicalDeviceMemoryProperties &mem_properties{p_device->GetSelectedPhysicalDevice().m_memory_properties};
-    for (u32 i = 0; i < mem_properties.memoryTypeCount; i++) {
-        if ((memory_type_bits & (1 << i)) &&
-            (mem_properties.memoryTypes[i].propertyFlags & required_properties) == required_properties) {
-            return i;
+    const auto find{[&](const VkMemoryPropertyFlags properties) -> std::optional<u32> {
+        for (u32 i = 0; i < mem_properties.memoryTypeCount; i++) {
+            if ((memory_type_bits & (1 << i)) &&
+                (mem_properties.memoryTypes[i].propertyFlags & properties) == properties) {
+                return i;
+            }
+        }
+        return std::nullopt;
+    }};
+
+    if (preferred_properties != 0) {
+        if (const std::optional<u32> index{find(required_properties | preferred_properties)}) {
+            return *index;
         }
     }
+    if (const std::optional<u32> index{find(required_properties)}) {
+        return *index;
+    }
     return std::unexpected("Cannot find memory type for type: " + std::to_string(memory_type_bits));
 }
 
-void BufferManager::BeginCommandBuffer(VkCommandBuffer command_buffer, const VkCommandBufferUsageFlags usage) const
+VkCommandBuffer BufferManager::GetUploadCommandBuffer() const
 {
-    p_copy_fence->WaitFor(constants::u64_max);
-    const VkCommandBufferBeginInfo begin_info{.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO, .flags = usage};
-    vkBeginCommandBuffer(command_buffer, &begin_info);
+    if (m_recording_batch != constants::u32_max) {
+        return m_upload_batches[m_recording_batch].p_command_buffer;
+    }
+
+    // Reuse the oldest batch, only blocking if the GPU has not finished with any of them yet
+    u32 batch_index{0};
+    for (u32 i = 1; i < m_upload_batches.size(); ++i) {
+        if (m_upload_batches[i].m_timeline_value < m_upload_batches[batch_index].m_timeline_value) {
+            batch_index = i;
+        }
+    }
+
+    UploadBatch &batch{m_upload_batches[batch_index]};
+    WaitForBatch(batch);
+    RecycleUploadBatch(batch);
+
+    batch.m_batch_id = m_next_batch_id++;
+
+    const VkCommandBufferBeginInfo begin_info{.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+                                              .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT};
+    if (const VkResult result{vkBeginCommandBuffer(batch.p_command_buffer, &begin_info)}; result != VK_SUCCESS) {
+        CHECK_VK_RESULT(result, "vkBeginCommandBuffer");
+    }
+
+    if (p_transfer_queue) {
+        if (const VkResult result{vkBeginCommandBuffer(batch.p_acquire_command_buffer, &begin_info)};
+            result != VK_SUCCESS) {
+            CHECK_VK_RESULT(result, "vkBeginCommandBuffer");
+        }
+    }
+
+    m_recording_batch = batch_index;
+    return batch.p_command_buffer;
+}
+
+VkCommandBuffer BufferManager::GetGraphicsCommandBuffer() const
+{
+    const VkCommandBuffer upload_command_buffer{GetUploadCommandBuffer()};
+    return p_transfer_queue ? m_upload_batches[m_recording_batch].p_acquire_command_buffer : upload_command_buffer;
 }
 
-void BufferManager::SubmitCopyCommand(VkCommandBuffer command_buffer) const
+const BufferManager::UploadBatch *BufferManager::FindUploadBatch(const UploadHandle handle) const
 {
-    vkEndCommandBuffer(command_buffer);
-    p_copy_fence->Reset();
+    for (const auto &batch : m_upload_batches) {
+        if (batch.m_batch_id == handle.m_batch_id) {
+            return &batch;
+        }
+    }
+
+    return nullptr;
+}
+
+bool BufferManager::IsBatchComplete(const UploadBatch &batch) const
+{
+    return p_upload_queue->IsComplete(batch.m_timeline_value) && p_queue->IsComplete(batch.m_acquire_timeline_value);
+}
+
+u64 BufferManager::GetReclaimableStagingValue() const
+{
+    // Ring space is retired against the upload queue, but a batch whose acquire submission copies from the ring keeps
+    // its space, and that of every batch after it, until the graphics queue is done with it
+    u64 reclaimable_value{p_upload_queue->GetCompletedValue()};
+    for (const UploadBatch &batch : m_upload_batches) {
+        if (batch.m_graphics_reads_staging && batch.m_timeline_value != NO_TIMELINE_VALUE &&
+            !p_queue->IsComplete(batch.m_acquire_timeline_value)) {
+            reclaimable_value = std::min(reclaimable_value, batch.m_timeline_value - 1);
+        }
+    }
+    return reclaimable_value;
+}
+
+void BufferManager::WaitForBatch(const UploadBatch &batch) const
+{
+    p_upload_queue->WaitForValue(batch.m_timeline_value);
+    p_queue->WaitForValue(batch.m_acquire_timeline_value);
+}
+
+void BufferManager::RecycleUploadBatch(UploadBatch &batch) const
+{
+    for (auto &buffer : batch.m_dedicated_staging_buffers) {
+        buffer.Destroy(p_device->GetDevice());
+    }
+
+    batch.m_dedicated_staging_buffers.clear();
+    batch.m_buffer_releases.clear();
+    batch.m_image_releases.clear();
+    batch.m_mip_generations.clear();
+    batch.m_timeline_value = NO_TIMELINE_VALUE;
+    batch.m_acquire_timeline_value = NO_TIMELINE_VALUE;
+    batch.m_waits_for_graphics = false;
+    batch.m_graphics_reads_staging = false;
+}
+
+void BufferManager::RecordAcquireBarriers(const UploadBatch &batch) const
+{
+    if (batch.m_buffer_releases.empty() && batch.m_image_releases.empty()) {
+        return;
+    }
+
+    // Acquires mirror the releases, only the access masks differ
+    Vector<VkBufferMemoryBarrier> buffer_acquires{batch.m_buffer_releases};
+    for (auto &barrier : buffer_acquires) {
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT |
+                                VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+    }
+
+    // Images still awaiting mip generation stay transfer destinations, the blits read and write them next
+    Vector<VkImageMemoryBarrier> image_acquires{batch.m_image_releases};
+    for (auto &barrier : image_acquires) {
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = barrier.newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
+                                    ? VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT
+                                    : VK_ACCESS_SHADER_READ_BIT;
+    }
+
+    const VkPipelineStageFlags destination_stages{
+        batch.m_mip_generations.empty() ? UPLOAD_CONSUMER_STAGES
+                                        : UPLOAD_CONSUMER_STAGES | VK_PIPELINE_STAGE_TRANSFER_BIT};
+
+    // The source stages match the semaphore wait stages so the acquire is ordered after the transfer submission
+    vkCmdPipelineBarrier(batch.p_acquire_command_buffer, UPLOAD_CONSUMER_STAGES, destination_stages, 0, 0, nullptr,
+                         static_cast<u32>(buffer_acquires.size()), buffer_acquires.data(),
+                         static_cast<u32>(image_acquires.size()), image_acquires.data());
+}
+
+void BufferManager::RecordImageUpload(VkImage image, const VkFormat format, const VkImageLayout initial_layout,
+                                      const StagingAllocation &staging, const ImageSize size,
+                                      const u32 layer_count) const
+{
+    const VkBufferImageCopy region{
+        .bufferOffset = staging.m_offset,
+        .bufferRowLength = 0,
+        .bufferImageHeight = 0,
+        .imageSubresource = VkImageSubresourceLayers{VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, layer_count},
+        .imageOffset = {0, 0, 0},
+        .imageExtent = {static_cast<u32>(size.width), static_cast<u32>(size.height), 1}};
 
-    if (p_queue) {
-        p_queue->Submit(command_buffer, p_copy_fence.get()); // Wait for completion
+    RecordImageUpload(image, format, initial_layout, staging.p_buffer, std::span{&region, 1}, layer_count, 1);
+}
+
+void BufferManager::RecordImageUpload(VkImage image, const VkFormat format, const VkImageLayout initial_layout,
+                                      VkBuffer source, const std::span<const VkBufferImageCopy> regions,
+                                      const u32 layer_count, const u32 mip_levels) const
+{
+    if (!p_transfer_queue) {
+        TransitionImageLayout(image, format, initial_layout, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, layer_count,
+                              mip_levels);
+        vkCmdCopyBufferToImage(GetUploadCommandBuffer(), source, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                               static_cast<u32>(regions.size()), regions.data());
+        TransitionImageLayout(image, format, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                              VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, layer_count, mip_levels);
+        return;
+    }
+
+    const VkCommandBuffer command_buffer{GetUploadCommandBuffer()};
+    UploadBatch &batch{m_upload_batches[m_recording_batch]};
+
+    // The whole image is overwritten, so previous contents are discarded instead of transferring ownership back.
+    // Reads of those contents on the graphics queue still have to finish before the copy starts.
+    if (initial_layout != VK_IMAGE_LAYOUT_UNDEFINED) {
+        batch.m_waits_for_graphics = true;
+    }
+
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = image;
+    barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, mip_levels, 0, layer_count};
+
+    vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0,
+                         nullptr, 0, nullptr, 1, &barrier);
+
+    vkCmdCopyBufferToImage(command_buffer, source, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                           static_cast<u32>(regions.size()), regions.data());
+
+    // The final layout transition happens as part of the ownership transfer
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = 0;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    barrier.srcQueueFamilyIndex = p_device->GetTransferQueueFamily();
+    barrier.dstQueueFamilyIndex = p_device->GetQueueFamily();
+    batch.m_image_releases.push_back(barrier);
+}
+
+std::unique_ptr<Texture> BufferManager::CreateSampledTexture(const void *pixels, const ImageSize size,
+                                                             const VkFormat format, const u32 mips, const u32 layers,
+                                                             const VkImageViewType view_type) const
+{
+    auto texture = std::make_unique<Texture>();
+
+    u32 mip_levels{mips == FULL_MIP_CHAIN ? mip_level_count(size) : math::min(mips, mip_level_count(size))};
+    constexpr VkFormatFeatureFlags blit_features{VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT |
+                                                 VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT};
+    if (mip_levels > 1 && !p_device->IsFormatSupported(format, blit_features)) {
+        ENGINE_LOG_WARNING("Format {} does not support linear blits, creating the texture without mips.",
+                           std::to_underlying(format));
+        mip_levels = 1;
+    }
+
+    CreateTextureImage(*texture, size, format, mip_levels, layers, 0);
+    if (mip_levels > 1) {
+        const VkDeviceSize image_size{static_cast<VkDeviceSize>(size.area()) * vk_format_to_channel_count(format) *
+                                      layers};
+        const StagingAllocation staging{StageData(pixels, image_size)};
+        RecordMipmappedImageUpload(texture->p_image, format, staging, size, layers, mip_levels);
+    }
+    else {
+        UpdateTextureImage(*texture, size, format, layers, pixels, VK_IMAGE_LAYOUT_UNDEFINED);
+    }
+    texture->p_view = CreateImageView(texture->p_image, format, VK_IMAGE_ASPECT_COLOR_BIT, view_type, layers,
+                                      mip_levels);
+    texture->p_sampler = GetTextureSampler(VK_FILTER_LINEAR, VK_FILTER_LINEAR, VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE);
+
+    return texture;
+}
+
+void BufferManager::RecordMipmappedImageUpload(VkImage image, const VkFormat format, const StagingAllocation &staging,
+                                               const ImageSize size, const u32 layer_count,
+                                               const u32 mip_levels) const
+{
+    const VkBufferImageCopy region{
+        .bufferOffset = staging.m_offset,
+        .bufferRowLength = 0,
+        .bufferImageHeight = 0,
+        .imageSubresource = VkImageSubresourceLayers{VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, layer_count},
+        .imageOffset = {0, 0, 0},
+        .imageExtent = {static_cast<u32>(size.width), static_cast<u32>(size.height), 1}};
+    const MipGeneration mip_generation{image, size, layer_count, mip_levels};
+
+    if (!p_transfer_queue) {
+        // The upload queue is the graphics queue, so the blits go straight behind the copy
+        TransitionImageLayout(image, format, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                              layer_count, mip_levels);
+        const VkCommandBuffer command_buffer{GetUploadCommandBuffer()};
+        vkCmdCopyBufferToImage(command_buffer, staging.p_buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1,
+                               &region);
+        RecordMipGeneration(command_buffer, mip_generation);
+        return;
+    }
+
+    const VkCommandBuffer command_buffer{GetUploadCommandBuffer()};
+    UploadBatch &batch{m_upload_batches[m_recording_batch]};
+
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = image;
+    barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, mip_levels, 0, layer_count};
+
+    vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0,
+                         nullptr, 0, nullptr, 1, &barrier);
+
+    vkCmdCopyBufferToImage(command_buffer, staging.p_buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+    // Transfer queues cannot blit, the graphics side acquires the image as it is and generates the mips there
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = 0;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.srcQueueFamilyIndex = p_device->GetTransferQueueFamily();
+    barrier.dstQueueFamilyIndex = p_device->GetQueueFamily();
+    batch.m_image_releases.push_back(barrier);
+    batch.m_mip_generations.push_back(mip_generation);
+}
+
+void BufferManager::RecordMipGeneration(VkCommandBuffer command_buffer, const MipGeneration &mip_generation) const
+{
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = mip_generation.p_image;
+    barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, mip_generation.m_layer_count};
+
+    int level_width{mip_generation.m_size.width};
+    int level_height{mip_generation.m_size.height};
+    for (u32 level = 1; level < mip_generation.m_mip_levels; ++level) {
+        // Each level is blitted from the one above, which is read only from then on
+        barrier.subresourceRange.baseMipLevel = level - 1;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0,
+                             nullptr, 0, nullptr, 1, &barrier);
+
+        const int next_width{math::max(level_width / 2, 1)};
+        const int next_height{math::max(level_height / 2, 1)};
+        const VkImageBlit blit{
+            .srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, level - 1, 0, mip_generation.m_layer_count},
+            .srcOffsets = {{0, 0, 0}, {level_width, level_height, 1}},
+            .dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, level, 0, mip_generation.m_layer_count},
+            .dstOffsets = {{0, 0, 0}, {next_width, next_height, 1}}};
+        vkCmdBlitImage(command_buffer, mip_generation.p_image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                       mip_generation.p_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, VK_FILTER_LINEAR);
+
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, UPLOAD_CONSUMER_STAGES, 0, 0, nullptr, 0,
+                             nullptr, 1, &barrier);
+
+        level_width = next_width;
+        level_height = next_height;
+    }
+
+    // The smallest level was only ever written
+    barrier.subresourceRange.baseMipLevel = mip_generation.m_mip_levels - 1;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, UPLOAD_CONSUMER_STAGES, 0, 0, nullptr, 0,
+                         nullptr, 1, &barrier);
+}
+
+StagingAllocation BufferManager::StageData(const void *data, const VkDeviceSize size) const
+{
+    ENGINE_PROFILE_COUNT(UPLOADED_BYTES_COUNTER, size);
+    if (size > p_staging_ring->GetCapacity()) {
+        // Too large for the ring, give it a buffer that lives as long as the batch it is recorded into
+        Buffer staging_buffer{CreateBuffer(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                           VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)};
+        staging_buffer.Update(data, size);
+
+        [[maybe_unused]] const VkCommandBuffer command_buffer{GetUploadCommandBuffer()};
+        m_upload_batches[m_recording_batch].m_dedicated_staging_buffers.push_back(staging_buffer);
+
+        ENGINE_LOG_DEBUG("Upload of {} bytes exceeds the staging ring, using a dedicated staging buffer.", size);
+        return StagingAllocation{staging_buffer.p_buffer, 0, size, nullptr};
+    }
+
+    while (true) {
+        p_staging_ring->Reclaim(GetReclaimableStagingValue());
+
+        if (const auto allocation{p_staging_ring->Allocate(size, STAGING_ALIGNMENT)}) {
+            memcpy(allocation->p_mapped, data, size);
+            return *allocation;
+        }
+
+        // The ring is full. Submit what is recorded so its space can retire, then wait for the oldest region.
+        if (p_staging_ring->HasUnretiredAllocations()) {
+            FlushUploads();
+        }
+
+        const u64 oldest_value{p_staging_ring->GetOldestPendingValue()};
+        p_upload_queue->WaitForValue(oldest_value);
+        // Rows copied by an acquire submission keep the oldest region until the graphics queue has run it
+        for (const UploadBatch &batch : m_upload_batches) {
+            if (batch.m_graphics_reads_staging && batch.m_timeline_value == oldest_value) {
+                p_queue->WaitForValue(batch.m_acquire_timeline_value);
+            }
+        }
     }
 }
 
@@ -9,19 +9,27 @@
 #include "renderers/vulkan/vk_device.hpp"
 #include "renderers/vulkan/vk_queue.hpp"
 
+#include "debug/assert.hpp"
 #include "debug/logger.hpp"
 #include "renderers/vulkan/vk_utils.hpp"
 
 namespace gouda::vk {
 
 CommandBufferManager::CommandBufferManager(Device *device, Queue *queue, u32 queue_family)
-    : p_device{device}, p_queue{queue}, m_queue_family{queue_family}, p_pool{VK_NULL_HANDLE}
+    : p_device{device},
+      p_queue{queue},
+      m_queue_family{queue_family},
+      p_pool{VK_NULL_HANDLE},
+      m_thread_count{0},
+      m_thread_pool_frames{0}
 {
     CreatePool();
 }
 
 CommandBufferManager::~CommandBufferManager()
 {
+    DestroyThreadPools();
+
     if (p_pool != VK_NULL_HANDLE && p_device != nullptr) {
         vkDestroyCommandPool(p_device->GetDevice(), p_pool, nullptr);
         ENGINE_LOG_DEBUG("Command pool destroyed.");
@@ -68,4 +76,73 @@ void CommandBufferManager::FreeBuffers(u32 count, const VkCommandBuffer *buffers
     }
 }
 
+void CommandBufferManager::CreateThreadPools(const u32 thread_count, const u32 frames_in_flight)
+{
+    DestroyThreadPools();
+
+    // Buffers are re-recorded every frame and only ever reset with their pool
+    const VkCommandPoolCreateInfo pool_info{.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+                                           .pNext = nullptr,
+                                           .flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+                                           .queueFamilyIndex = m_queue_family};
+
+    m_thread_pools.resize(static_cast<size_t>(thread_count) * frames_in_flight, VK_NULL_HANDLE);
+    m_thread_count = thread_count;
+    m_thread_pool_frames = frames_in_flight;
+
+    for (auto &pool : m_thread_pools) {
+        if (const VkResult result{vkCreateCommandPool(p_device->GetDevice(), &pool_info, nullptr, &pool)};
+            result != VK_SUCCESS) {
+            CHECK_VK_RESULT(result, "vkCreateCommandPool");
+        }
+    }
+
+    ENGINE_LOG_DEBUG("Thread command pools created: {} threads, {} frames.", thread_count, frames_in_flight);
+}
+
+void CommandBufferManager::DestroyThreadPools()
+{
+    if (m_thread_pools.empty() || p_device == nullptr) {
+        return;
+    }
+
+    for (const auto pool : m_thread_pools) {
+        vkDestroyCommandPool(p_device->GetDevice(), pool, nullptr);
+    }
+
+    m_thread_pools.clear();
+    m_thread_count = 0;
+    m_thread_pool_frames = 0;
+
+    ENGINE_LOG_DEBUG("Thread command pools destroyed.");
+}
+
+void CommandBufferManager::AllocateSecondaryBuffers(const u32 thread_index, const u32 frame_index, const u32 count,
+                                                    VkCommandBuffer *buffers) const
+{
+    const VkCommandBufferAllocateInfo alloc_info{.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+                                                 .pNext = nullptr,
+                                                 .commandPool = GetThreadPool(thread_index, frame_index),
+                                                 .level = VK_COMMAND_BUFFER_LEVEL_SECONDARY,
+                                                 .commandBufferCount = count};
+
+    if (const VkResult result{vkAllocateCommandBuffers(p_device->GetDevice(), &alloc_info, buffers)};
+        result != VK_SUCCESS) {
+        CHECK_VK_RESULT(result, "vkAllocateCommandBuffers");
+    }
+}
+
+void CommandBufferManager::ResetThreadPools(const u32 frame_index) const
+{
+    for (u32 thread_index = 0; thread_index < m_thread_count; ++thread_index) {
+        vkResetCommandPool(p_device->GetDevice(), GetThreadPool(thread_index, frame_index), 0);
+    }
+}
+
+VkCommandPool CommandBufferManager::GetThreadPool(const u32 thread_index, const u32 frame_index) const
+{
+    ASSERT(thread_index < m_thread_count && frame_index < m_thread_pool_frames, "Thread command pool out of range");
+    return m_thread_pools[static_cast<size_t>(frame_index) * m_thread_count + thread_index];
+}
+
 } // namespace gouda::vk
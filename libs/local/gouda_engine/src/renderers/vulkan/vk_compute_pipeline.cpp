@@ -6,7 +6,11 @@
  */
 #include "renderers/vulkan/vk_compute_pipeline.hpp"
 
+#include <algorithm>
+
+#include "debug/assert.hpp"
 #include "debug/logger.hpp"
+#include "debug/profiler.hpp"
 #include "renderers/vulkan/vk_buffer.hpp"
 #include "renderers/vulkan/vk_renderer.hpp"
 #include "renderers/vulkan/vk_shader.hpp"
@@ -15,18 +19,41 @@
 namespace gouda::vk {
 
 ComputePipeline::ComputePipeline(Renderer &renderer, Device *device, const Shader *compute_shader,
-                                 const Vector<Buffer> &storage_buffers, const Vector<Buffer> &uniform_buffers,
-                                 const VkDeviceSize storage_buffer_size, const VkDeviceSize uniform_buffer_size)
-    : m_renderer{renderer}, p_device{device}
+                                 const std::span<const ComputeBufferBinding> bindings)
+    : m_renderer{renderer}, p_device{device}, m_local_size{1, 1, 1}, m_push_constant_size{0}
 {
+    ASSERT(!bindings.empty(), "Compute pipeline needs at least one buffer binding.");
+    const ShaderReflection &reflection{compute_shader->Reflection()};
+    m_local_size = {reflection.local_size[0], reflection.local_size[1], reflection.local_size[2]};
+
+    // The shader's bindings in binding order, the given buffers are matched to them by position
+    std::vector<ShaderDescriptorBinding> shader_bindings{reflection.descriptor_bindings};
+    std::ranges::sort(shader_bindings, {}, &ShaderDescriptorBinding::binding);
+    ASSERT(shader_bindings.size() == bindings.size(), "Compute shader declares {} bindings, {} were given.",
+           shader_bindings.size(), bindings.size());
+    for (const ShaderDescriptorBinding &binding : shader_bindings) {
+        ASSERT(binding.type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER || binding.type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+               "Compute binding '{}' is not a buffer.", binding.name);
+    }
+
+    u32 set_count{0};
+    for (const ComputeBufferBinding &binding : bindings) {
+        set_count = math::max(set_count, static_cast<u32>(binding.buffers.size()));
+    }
+
     // Create descriptor pool
-    Vector<VkDescriptorPoolSize> pool_sizes{
-        {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, static_cast<u32>(storage_buffers.size())},
-        {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, static_cast<u32>(uniform_buffers.size())},
-    };
+    Vector<VkDescriptorPoolSize> pool_sizes;
+    pool_sizes.reserve(bindings.size());
+    for (const ComputeBufferBinding &binding : bindings) {
+        ASSERT(binding.buffers.size() == 1 || binding.buffers.size() == set_count,
+               "Compute bindings must provide one shared buffer or one buffer per descriptor set.");
+    }
+    for (const ShaderDescriptorBinding &binding : shader_bindings) {
+        pool_sizes.push_back({binding.type, set_count});
+    }
     const VkDescriptorPoolCreateInfo pool_info{
         .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
-        .maxSets = static_cast<u32>(storage_buffers.size()),
+        .maxSets = set_count,
         .poolSizeCount = static_cast<u32>(pool_sizes.size()),
         .pPoolSizes = pool_sizes.data(),
     };
@@ -36,24 +63,20 @@ ComputePipeline::ComputePipeline(Renderer &renderer, Device *device, const Shade
     }
 
     // Create descriptor set layout
-    Vector<VkDescriptorSetLayoutBinding> bindings{
-        {
-            .binding = 0,
-            .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+    Vector<VkDescriptorSetLayoutBinding> layout_bindings;
+    layout_bindings.reserve(bindings.size());
+    for (const ShaderDescriptorBinding &binding : shader_bindings) {
+        layout_bindings.push_back({
+            .binding = binding.binding,
+            .descriptorType = binding.type,
             .descriptorCount = 1,
             .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
-        },
-        {
-            .binding = 1,
-            .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
-            .descriptorCount = 1,
-            .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
-        },
-    };
+        });
+    }
     const VkDescriptorSetLayoutCreateInfo layout_info{
         .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
-        .bindingCount = static_cast<u32>(bindings.size()),
-        .pBindings = bindings.data(),
+        .bindingCount = static_cast<u32>(layout_bindings.size()),
+        .pBindings = layout_bindings.data(),
     };
 
     result = vkCreateDescriptorSetLayout(p_device->GetDevice(), &layout_info, nullptr, &p_descriptor_set_layout);
@@ -61,11 +84,18 @@ ComputePipeline::ComputePipeline(Renderer &renderer, Device *device, const Shade
         CHECK_VK_RESULT(result, "vkCreateDescriptorSetLayout");
     }
 
-    // Create pipeline layout
+    // Create pipeline layout, with the shader's push constant block if it has one
+    VkPushConstantRange push_constant_range{VK_SHADER_STAGE_COMPUTE_BIT, 0, 0};
+    for (const ShaderPushConstantRange &range : reflection.push_constants) {
+        push_constant_range.size = math::max(push_constant_range.size, range.offset + range.size);
+    }
+    m_push_constant_size = push_constant_range.size;
     const VkPipelineLayoutCreateInfo pipeline_layout_info{
         .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
         .setLayoutCount = 1,
         .pSetLayouts = &p_descriptor_set_layout,
+        .pushConstantRangeCount = m_push_constant_size > 0 ? 1u : 0u,
+        .pPushConstantRanges = &push_constant_range,
     };
     result = vkCreatePipelineLayout(p_device->GetDevice(), &pipeline_layout_info, nullptr, &p_pipeline_layout);
     if (result != VK_SUCCESS) {
@@ -85,20 +115,22 @@ ComputePipeline::ComputePipeline(Renderer &renderer, Device *device, const Shade
         .layout = p_pipeline_layout,
     };
 
-    result = vkCreateComputePipelines(p_device->GetDevice(), VK_NULL_HANDLE, 1, &pipeline_info, nullptr, &p_pipeline);
+    result = vkCreateComputePipelines(p_device->GetDevice(), m_renderer.GetPipelineCache(), 1, &pipeline_info, nullptr,
+                                      &p_pipeline);
     if (result != VK_SUCCESS) {
         CHECK_VK_RESULT(result, "vkCreateComputePipelines");
     }
 
-    ENGINE_LOG_DEBUG("Compute pipeline created");
+    ENGINE_LOG_DEBUG("Compute pipeline created, workgroup size {}x{}x{}.", m_local_size.x, m_local_size.y,
+                     m_local_size.z);
 
     // Allocate descriptor sets
-    m_descriptor_sets.resize(storage_buffers.size());
-    Vector<VkDescriptorSetLayout> layouts(storage_buffers.size(), p_descriptor_set_layout);
+    m_descriptor_sets.resize(set_count);
+    Vector<VkDescriptorSetLayout> layouts(set_count, p_descriptor_set_layout);
     const VkDescriptorSetAllocateInfo alloc_info{
         .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
         .descriptorPool = p_descriptor_pool,
-        .descriptorSetCount = static_cast<u32>(storage_buffers.size()),
+        .descriptorSetCount = set_count,
         .pSetLayouts = layouts.data(),
     };
     result = vkAllocateDescriptorSets(p_device->GetDevice(), &alloc_info, m_descriptor_sets.data());
@@ -107,39 +139,27 @@ ComputePipeline::ComputePipeline(Renderer &renderer, Device *device, const Shade
     }
 
     // Update descriptor sets
-    for (size_t i = 0; i < storage_buffers.size(); ++i) {
-        VkDescriptorBufferInfo storage_info{
-            .buffer = storage_buffers[i].p_buffer,
-            .offset = 0,
-            .range = storage_buffer_size,
-        };
-        VkDescriptorBufferInfo uniform_info{
-            .buffer = uniform_buffers[i].p_buffer,
-            .offset = 0,
-            .range = uniform_buffer_size,
-        };
-
-        Vector<VkWriteDescriptorSet> writes{
-            {
-                .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-                .dstSet = m_descriptor_sets[i],
-                .dstBinding = 0,
-                .dstArrayElement = 0,
-                .descriptorCount = 1,
-                .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
-                .pBufferInfo = &storage_info,
-            },
-            {
+    Vector<VkDescriptorBufferInfo> buffer_infos(bindings.size());
+    Vector<VkWriteDescriptorSet> writes(bindings.size());
+    for (u32 set = 0; set < set_count; ++set) {
+        for (size_t i = 0; i < bindings.size(); ++i) {
+            buffer_infos[i] = {
+                .buffer = bindings[i].buffers[bindings[i].buffers.size() == 1 ? 0 : set].p_buffer,
+                .offset = 0,
+                .range = bindings[i].range,
+            };
+            writes[i] = {
                 .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-                .dstSet = m_descriptor_sets[i],
-                .dstBinding = 1,
+                .dstSet = m_descriptor_sets[set],
+                .dstBinding = shader_bindings[i].binding,
                 .dstArrayElement = 0,
                 .descriptorCount = 1,
-                .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
-                .pBufferInfo = &uniform_info,
-            },
-        };
+                .descriptorType = shader_bindings[i].type,
+                .pBufferInfo = &buffer_infos[i],
+            };
+        }
         vkUpdateDescriptorSets(p_device->GetDevice(), static_cast<u32>(writes.size()), writes.data(), 0, nullptr);
+        ENGINE_PROFILE_COUNT(DESCRIPTOR_WRITES_COUNTER, writes.size());
     }
 }
 
@@ -161,15 +181,28 @@ void ComputePipeline::BindDescriptors(VkCommandBuffer command_buffer, const u32
     );
 }
 
-u32 ComputePipeline::CalculateWorkGroupCount(const u32 particle_count) const
+void ComputePipeline::PushConstants(VkCommandBuffer command_buffer, const void *data, const u32 size) const
+{
+    ASSERT(size <= m_push_constant_size, "Push constants of {} bytes exceed the shader's {}.", size,
+           m_push_constant_size);
+    vkCmdPushConstants(command_buffer, p_pipeline_layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, size, data);
+}
+
+UVec3 ComputePipeline::CalculateWorkGroupCount(const UVec3 &invocation_count) const
+{
+    return {(invocation_count.x + m_local_size.x - 1) / m_local_size.x,
+            (invocation_count.y + m_local_size.y - 1) / m_local_size.y,
+            (invocation_count.z + m_local_size.z - 1) / m_local_size.z};
+}
+
+u32 ComputePipeline::CalculateWorkGroupCount(const u32 invocation_count) const
 {
-    constexpr u32 local_size_x{256};                           // Matches shader's local_size_x
-    return (particle_count + local_size_x - 1) / local_size_x; // Ceiling division
+    return (invocation_count + m_local_size.x - 1) / m_local_size.x; // Ceiling division
 }
 
 void ComputePipeline::Dispatch(VkCommandBuffer command_buffer, const UVec3 &group_counts) const
 {
-    vkCmdDispatch(command_buffer, group_counts.x, group_counts.y, group_counts.z); // Simplify for 1D dispatch
+    vkCmdDispatch(command_buffer, group_counts.x, group_counts.y, group_counts.z);
 }
 
 void ComputePipeline::Destroy()
@@ -194,4 +227,38 @@ void ComputePipeline::Destroy()
     ENGINE_LOG_DEBUG("Compute pipeline destroyed");
 }
 
-} // namespace gouda::vk
\ No newline at end of file
+void record_compute_chain(VkCommandBuffer command_buffer, const std::span<const ComputeDispatch> dispatches)
+{
+    for (size_t i = 0; i < dispatches.size(); ++i) {
+        const ComputeDispatch &dispatch{dispatches[i]};
+        if (i > 0) {
+            record_compute_barrier(command_buffer);
+        }
+
+        if (i == 0 || dispatch.pipeline != dispatches[i - 1].pipeline) {
+            dispatch.pipeline->Bind(command_buffer);
+            dispatch.pipeline->BindDescriptors(command_buffer, dispatch.set_index);
+        }
+        else if (dispatch.set_index != dispatches[i - 1].set_index) {
+            dispatch.pipeline->BindDescriptors(command_buffer, dispatch.set_index);
+        }
+        if (!dispatch.push_constants.empty()) {
+            dispatch.pipeline->PushConstants(command_buffer, dispatch.push_constants.data(),
+                                             static_cast<u32>(dispatch.push_constants.size()));
+        }
+        dispatch.pipeline->Dispatch(command_buffer, dispatch.group_counts);
+    }
+}
+
+void record_compute_barrier(VkCommandBuffer command_buffer)
+{
+    const VkMemoryBarrier barrier{
+        .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+    };
+    vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+                         1, &barrier, 0, nullptr, 0, nullptr);
+}
+
+} // namespace gouda::vk
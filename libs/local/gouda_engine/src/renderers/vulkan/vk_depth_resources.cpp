@@ -55,10 +55,12 @@ void DepthResources::Create()
     ENGINE_LOG_DEBUG("Depth resources created of size: {}x{}.", image_size.width, image_size.height);
 }
 
-void DepthResources::Recreate()
+Vector<Texture> DepthResources::Recreate()
 {
-    Destroy();
+    Vector<Texture> retired{std::move(m_depth_images)};
+    m_depth_images.clear();
     Create();
+    return retired;
 }
 
 void DepthResources::Destroy()
@@ -0,0 +1,169 @@
+/**
+ * @file vk_descriptor_allocator.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine vulkan growable descriptor pool allocator implementation
+ */
+#include "renderers/vulkan/vk_descriptor_allocator.hpp"
+
+#include <algorithm>
+
+#include "debug/assert.hpp"
+#include "debug/logger.hpp"
+#include "math/math.hpp"
+#include "renderers/vulkan/vk_utils.hpp"
+
+namespace gouda::vk {
+
+namespace internal {
+
+// Descriptors of each type per set in a new pool, roughly what the engine's shaders declare
+struct DescriptorRatio {
+    VkDescriptorType type;
+    u32 per_set;
+};
+
+static constexpr DescriptorRatio descriptor_ratios[]{
+    {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 4},
+    {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 2},
+    {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2},
+    {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1},
+};
+
+} // namespace internal
+
+DescriptorAllocator::DescriptorAllocator(const VkDevice device, const VkDescriptorPoolCreateFlags pool_flags)
+    : p_device{device},
+      m_pool_flags{pool_flags},
+      m_current_pool{0},
+      m_sets_per_pool{INITIAL_SETS_PER_POOL},
+      m_allocated_sets{0}
+{
+}
+
+DescriptorAllocator::~DescriptorAllocator()
+{
+    for (const VkDescriptorPool pool : m_pools) {
+        vkDestroyDescriptorPool(p_device, pool, nullptr);
+    }
+}
+
+VkDescriptorPool DescriptorAllocator::Allocate(const VkDescriptorSetLayout layout,
+                                               const std::span<const VkDescriptorPoolSize> set_sizes,
+                                               const std::span<VkDescriptorSet> sets)
+{
+    ASSERT(!sets.empty(), "Descriptor allocation of no sets.");
+    std::scoped_lock lock{m_mutex};
+
+    // The current pool first, then the others, which may have room again after sets were freed or reset
+    const u32 pool_count{static_cast<u32>(m_pools.size())};
+    for (u32 i = 0; i < pool_count; ++i) {
+        const u32 pool_index{(m_current_pool + i) % pool_count};
+        const VkResult result{TryAllocate(m_pools[pool_index], layout, sets)};
+        if (result == VK_SUCCESS) {
+            m_current_pool = pool_index;
+            m_allocated_sets += static_cast<u32>(sets.size());
+            return m_pools[pool_index];
+        }
+        if (result != VK_ERROR_OUT_OF_POOL_MEMORY && result != VK_ERROR_FRAGMENTED_POOL) {
+            CHECK_VK_RESULT(result, "vkAllocateDescriptorSets");
+        }
+    }
+
+    const VkDescriptorPool pool{CreatePool(set_sizes, static_cast<u32>(sets.size()))};
+    if (const VkResult result{TryAllocate(pool, layout, sets)}; result != VK_SUCCESS) {
+        ENGINE_LOG_ERROR("Failed to allocate {} descriptor sets from a new pool. Error: {}", sets.size(),
+                         vk_result_to_string(result));
+        CHECK_VK_RESULT(result, "vkAllocateDescriptorSets");
+    }
+    m_current_pool = static_cast<u32>(m_pools.size() - 1);
+    m_allocated_sets += static_cast<u32>(sets.size());
+    return pool;
+}
+
+void DescriptorAllocator::Free(const VkDescriptorPool pool, const std::span<const VkDescriptorSet> sets)
+{
+    ASSERT((m_pool_flags & VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT) != 0,
+           "Descriptor sets freed from pools that cannot free them.");
+    if (sets.empty()) {
+        return;
+    }
+
+    std::scoped_lock lock{m_mutex};
+    vkFreeDescriptorSets(p_device, pool, static_cast<u32>(sets.size()), sets.data());
+    m_allocated_sets -= math::min(m_allocated_sets, static_cast<u32>(sets.size()));
+}
+
+void DescriptorAllocator::Reset()
+{
+    std::scoped_lock lock{m_mutex};
+    for (const VkDescriptorPool pool : m_pools) {
+        vkResetDescriptorPool(p_device, pool, 0);
+    }
+    m_current_pool = 0;
+    m_allocated_sets = 0;
+}
+
+size_t DescriptorAllocator::GetPoolCount() const
+{
+    std::scoped_lock lock{m_mutex};
+    return m_pools.size();
+}
+
+u32 DescriptorAllocator::GetAllocatedSetCount() const
+{
+    std::scoped_lock lock{m_mutex};
+    return m_allocated_sets;
+}
+
+// Private functions -------------------------------------------------------------------------------------
+VkResult DescriptorAllocator::TryAllocate(const VkDescriptorPool pool, const VkDescriptorSetLayout layout,
+                                          const std::span<VkDescriptorSet> sets) const
+{
+    const SmallVector<VkDescriptorSetLayout, 4> layouts(sets.size(), layout);
+    const VkDescriptorSetAllocateInfo alloc_info{.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+                                                 .descriptorPool = pool,
+                                                 .descriptorSetCount = static_cast<u32>(sets.size()),
+                                                 .pSetLayouts = layouts.data()};
+    return vkAllocateDescriptorSets(p_device, &alloc_info, sets.data());
+}
+
+VkDescriptorPool DescriptorAllocator::CreatePool(const std::span<const VkDescriptorPoolSize> set_sizes,
+                                                 const u32 set_count)
+{
+    // Room for the request twice over, so a pipeline rebuilt for a reload usually lands in the same pool
+    const u32 max_sets{math::max(m_sets_per_pool, set_count * 2)};
+    SmallVector<VkDescriptorPoolSize, 8> pool_sizes;
+    for (const internal::DescriptorRatio &ratio : internal::descriptor_ratios) {
+        pool_sizes.push_back({ratio.type, ratio.per_set * max_sets});
+    }
+    for (const VkDescriptorPoolSize &size : set_sizes) {
+        const u32 required{size.descriptorCount * set_count * 2};
+        const auto pool_size{std::ranges::find(pool_sizes, size.type, &VkDescriptorPoolSize::type)};
+        if (pool_size == pool_sizes.end()) {
+            pool_sizes.push_back({size.type, required});
+        }
+        else {
+            pool_size->descriptorCount = math::max(pool_size->descriptorCount, required);
+        }
+    }
+
+    const VkDescriptorPoolCreateInfo pool_info{.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+                                               .flags = m_pool_flags,
+                                               .maxSets = max_sets,
+                                               .poolSizeCount = static_cast<u32>(pool_sizes.size()),
+                                               .pPoolSizes = pool_sizes.data()};
+    VkDescriptorPool pool{VK_NULL_HANDLE};
+    if (const VkResult result{vkCreateDescriptorPool(p_device, &pool_info, nullptr, &pool)}; result != VK_SUCCESS) {
+        ENGINE_LOG_ERROR("Failed to create descriptor pool. Error: {}", vk_result_to_string(result));
+        CHECK_VK_RESULT(result, "vkCreateDescriptorPool");
+    }
+    m_pools.push_back(pool);
+    m_sets_per_pool = math::min(m_sets_per_pool * 2, MAX_SETS_PER_POOL);
+
+    ENGINE_LOG_DEBUG("Created descriptor pool {} with {} sets and {} pool sizes", m_pools.size(), max_sets,
+                     pool_sizes.size());
+    return pool;
+}
+
+} // namespace gouda::vk
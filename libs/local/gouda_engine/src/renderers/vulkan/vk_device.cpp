@@ -6,9 +6,14 @@
  */
 #include "renderers/vulkan/vk_device.hpp"
 
+#include <algorithm>
+#include <array>
+#include <optional>
 #include <ranges>
+#include <utility>
 
 #include "debug/debug.hpp"
+#include "math/math.hpp"
 #include "renderers/vulkan/vk_utils.hpp"
 
 template <>
@@ -30,6 +35,11 @@ struct std::formatter<VkColorSpaceKHR> : std::formatter<std::string> {
 namespace gouda::vk {
 
 namespace internal {
+
+// Every device extension the renderer cannot run without, optional ones are enabled where CreateDevice checks for them
+static constexpr std::array<const char *, 2> required_device_extensions{VK_KHR_SWAPCHAIN_EXTENSION_NAME,
+                                                                        VK_KHR_SHADER_DRAW_PARAMETERS_EXTENSION_NAME};
+
 static VkFormat find_depth_format(VkPhysicalDevice device_ptr)
 {
     const Vector<VkFormat> candidates{VK_FORMAT_D32_SFLOAT, VK_FORMAT_D32_SFLOAT_S8_UINT,
@@ -145,8 +155,135 @@ static void PrintMemoryProperty(const VkMemoryPropertyFlags PropertyFlags)
     std::cout << std::endl; // Ensures the output ends with a newline
 }
 
+static bool has_required_features(const PhysicalDevice &device)
+{
+    // Descriptor indexing backs the bindless texture arrays, timeline semaphores all queue synchronization and
+    // dynamic rendering replaces render pass and framebuffer objects
+    const VkPhysicalDeviceVulkan12Features &vulkan_12{device.m_vulkan_12_features};
+    return vulkan_12.timelineSemaphore == VK_TRUE && vulkan_12.runtimeDescriptorArray == VK_TRUE &&
+           vulkan_12.shaderSampledImageArrayNonUniformIndexing == VK_TRUE &&
+           vulkan_12.descriptorBindingPartiallyBound == VK_TRUE &&
+           vulkan_12.descriptorBindingSampledImageUpdateAfterBind == VK_TRUE &&
+           vulkan_12.descriptorBindingUpdateUnusedWhilePending == VK_TRUE &&
+           device.m_vulkan_13_features.dynamicRendering == VK_TRUE;
+}
+
+static u32 find_queue_family(const PhysicalDevice &device, const VkQueueFlags required_queue_type,
+                             const bool supports_present)
+{
+    for (u32 i = 0; i < device.m_queue_family_properties.size(); ++i) {
+        if (device.m_queue_family_properties[i].queueFlags & required_queue_type &&
+            static_cast<bool>(device.m_queue_supports_present[i]) == supports_present) {
+            return i;
+        }
+    }
+    return constants::u32_max;
+}
+
+// Higher is better, nullopt when the device cannot run the renderer at all
+static std::optional<u64> score_physical_device(const PhysicalDevice &device, const VkQueueFlags required_queue_type,
+                                                const bool supports_present)
+{
+    const StringView name{device.m_device_properties.deviceName};
+    if (device.m_device_properties.apiVersion < VK_API_VERSION_1_3) {
+        ENGINE_LOG_DEBUG("Device {} skipped, it does not support Vulkan 1.3.", name);
+        return std::nullopt;
+    }
+
+    for (const char *extension : required_device_extensions) {
+        if (!device.SupportsExtension(extension)) {
+            ENGINE_LOG_DEBUG("Device {} skipped, it does not support {}.", name, extension);
+            return std::nullopt;
+        }
+    }
+
+    if (!has_required_features(device)) {
+        ENGINE_LOG_DEBUG("Device {} skipped, it lacks timeline semaphores, descriptor indexing or dynamic rendering.",
+                         name);
+        return std::nullopt;
+    }
+
+    if (find_queue_family(device, required_queue_type, supports_present) == constants::u32_max) {
+        ENGINE_LOG_DEBUG("Device {} skipped, no queue family with the required flags and presentation.", name);
+        return std::nullopt;
+    }
+
+    // The type always wins, memory only ranks devices of the same type
+    u64 type_rank{0};
+    switch (device.m_device_properties.deviceType) {
+        case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:
+            type_rank = 4;
+            break;
+        case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU:
+            type_rank = 3;
+            break;
+        case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:
+            type_rank = 2;
+            break;
+        case VK_PHYSICAL_DEVICE_TYPE_CPU:
+            type_rank = 1;
+            break;
+        default:
+            break;
+    }
+
+    const u64 memory_mib{device.GetDeviceLocalMemorySize() / (1024 * 1024)};
+    return (type_rank << 32) | math::min<u64>(memory_mib, constants::u32_max);
+}
+
+// A device local and host visible heap any larger than the legacy 256 MiB BAR window is resizable BAR or UMA
+static bool has_host_visible_vram(const PhysicalDevice &device)
+{
+    constexpr VkDeviceSize legacy_bar_size{256 * 1024 * 1024};
+    constexpr VkMemoryPropertyFlags bar_properties{VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT |
+                                                   VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT};
+    const VkPhysicalDeviceMemoryProperties &memory_properties{device.m_memory_properties};
+    for (u32 i = 0; i < memory_properties.memoryTypeCount; ++i) {
+        const VkMemoryType &type{memory_properties.memoryTypes[i]};
+        if ((type.propertyFlags & bar_properties) == bar_properties &&
+            memory_properties.memoryHeaps[type.heapIndex].size > legacy_bar_size) {
+            return true;
+        }
+    }
+    return false;
+}
+
 } // namespace internal
 
+bool PhysicalDevice::SupportsExtension(const StringView extension_name) const
+{
+    return std::ranges::any_of(m_extensions, [extension_name](const VkExtensionProperties &extension) {
+        return extension_name == extension.extensionName;
+    });
+}
+
+VkDeviceSize PhysicalDevice::GetDeviceLocalMemorySize() const
+{
+    VkDeviceSize size{0};
+    for (u32 i = 0; i < m_memory_properties.memoryHeapCount; ++i) {
+        if (m_memory_properties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) {
+            size += m_memory_properties.memoryHeaps[i].size;
+        }
+    }
+    return size;
+}
+
+DeviceCapabilities::DeviceCapabilities()
+    : descriptor_indexing{false},
+      timeline_semaphores{false},
+      dynamic_rendering{false},
+      memory_budget{false},
+      present_wait{false},
+      bc_textures{false},
+      astc_textures{false},
+      dedicated_transfer_queue{false},
+      async_compute_queue{false},
+      multi_draw_indirect{false},
+      host_visible_vram{false},
+      graphics_pipeline_library{false}
+{
+}
+
 void VulkanPhysicalDevices::Initialize(const Instance &instance, const VkSurfaceKHR &surface)
 {
     u32 number_of_devices{0};
@@ -264,38 +401,114 @@ void VulkanPhysicalDevices::Initialize(const Instance &instance, const VkSurface
 
         ENGINE_LOG_DEBUG("Memory heap types count: {}", device_info.m_memory_properties.memoryHeapCount);
 
+        // Extensions --------------------------------------------------------------------------------------------
+        u32 extension_count{0};
+        vkEnumerateDeviceExtensionProperties(physical_device, nullptr, &extension_count, nullptr);
+        device_info.m_extensions.resize(extension_count);
+        vkEnumerateDeviceExtensionProperties(physical_device, nullptr, &extension_count,
+                                             device_info.m_extensions.data());
+
         // Device Features ---------------------------------------------------------------------------------------
         vkGetPhysicalDeviceFeatures(device_info.m_physical_device, &device_info.m_features);
 
+        // The 1.3 structure may only be chained on 1.3 devices, those of extensions only when they are supported
+        if (api_version >= VK_API_VERSION_1_3) {
+            device_info.m_vulkan_12_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+            device_info.m_vulkan_13_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+            device_info.m_vulkan_12_features.pNext = &device_info.m_vulkan_13_features;
+
+            VkPhysicalDevicePresentWaitFeaturesKHR present_wait_features{};
+            present_wait_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+            VkPhysicalDevicePresentIdFeaturesKHR present_id_features{};
+            present_id_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+            present_id_features.pNext = &present_wait_features;
+            const bool has_present_wait_extensions{device_info.SupportsExtension(VK_KHR_PRESENT_ID_EXTENSION_NAME) &&
+                                                   device_info.SupportsExtension(VK_KHR_PRESENT_WAIT_EXTENSION_NAME)};
+            if (has_present_wait_extensions) {
+                device_info.m_vulkan_13_features.pNext = &present_id_features;
+            }
+
+            VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT pipeline_library_features{};
+            pipeline_library_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT;
+            VkPhysicalDeviceGraphicsPipelineLibraryPropertiesEXT pipeline_library_properties{};
+            pipeline_library_properties.sType =
+                VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_PROPERTIES_EXT;
+            const bool has_pipeline_library_extensions{
+                device_info.SupportsExtension(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME) &&
+                device_info.SupportsExtension(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME)};
+            if (has_pipeline_library_extensions) {
+                pipeline_library_features.pNext = std::exchange(device_info.m_vulkan_13_features.pNext,
+                                                                &pipeline_library_features);
+
+                VkPhysicalDeviceProperties2 properties{};
+                properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+                properties.pNext = &pipeline_library_properties;
+                vkGetPhysicalDeviceProperties2(physical_device, &properties);
+            }
+
+            VkPhysicalDeviceFeatures2 features{};
+            features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+            features.pNext = &device_info.m_vulkan_12_features;
+            vkGetPhysicalDeviceFeatures2(physical_device, &features);
+
+            // The chain pointed at locals, nothing reads it past here
+            device_info.m_vulkan_12_features.pNext = nullptr;
+            device_info.m_vulkan_13_features.pNext = nullptr;
+            device_info.m_supports_present_wait = has_present_wait_extensions &&
+                                                  present_id_features.presentId == VK_TRUE &&
+                                                  present_wait_features.presentWait == VK_TRUE;
+            // Without fast linking, linking may compile as much as creating the whole pipeline does
+            device_info.m_supports_fast_pipeline_linking =
+                has_pipeline_library_extensions && pipeline_library_features.graphicsPipelineLibrary == VK_TRUE &&
+                pipeline_library_properties.graphicsPipelineLibraryFastLinking == VK_TRUE;
+        }
+
         // Depth format ------------------------------------------------------------------------------------------
         device_info.m_depth_format = internal::find_depth_format(physical_device);
     }
 }
 
-u32 VulkanPhysicalDevices::SelectDevice(VkQueueFlags required_queue_type, bool supports_present)
+u32 VulkanPhysicalDevices::SelectDevice(const VkQueueFlags required_queue_type, const bool supports_present,
+                                        const StringView preferred_device)
 {
+    int best_index{-1};
+    u64 best_score{0};
+    int preferred_index{-1};
     for (u32 i = 0; i < m_devices.size(); i++) {
+        const std::optional<u64> score{
+            internal::score_physical_device(m_devices[i], required_queue_type, supports_present)};
+        if (!score) {
+            continue;
+        }
 
-        for (u32 j = 0; j < m_devices[i].m_queue_family_properties.size(); j++) {
-
-            if (const VkQueueFamilyProperties &queue_family_properties = m_devices[i].m_queue_family_properties[j];
-                queue_family_properties.queueFlags & required_queue_type &&
-                static_cast<bool>(m_devices[i].m_queue_supports_present[j]) == supports_present) {
+        const StringView name{m_devices[i].m_device_properties.deviceName};
+        ENGINE_LOG_DEBUG("Device {}: {} scored {:#x}", i, name, *score);
 
-                m_dev_index = static_cast<int>(i);
-                u32 queue_family{j};
+        if (best_index < 0 || *score > best_score) {
+            best_index = static_cast<int>(i);
+            best_score = *score;
+        }
+        if (preferred_index < 0 && !preferred_device.empty() && name.contains(preferred_device)) {
+            preferred_index = static_cast<int>(i);
+        }
+    }
 
-                ENGINE_LOG_DEBUG("Using GFX device: {} and queue family: {}", m_dev_index, queue_family);
+    if (best_index < 0) {
+        ENGINE_THROW("No physical device supports the renderer, required queue type: {} and support presents: {}",
+                     required_queue_type, supports_present);
+    }
 
-                return queue_family;
-            }
-        }
+    if (!preferred_device.empty() && preferred_index < 0) {
+        ENGINE_LOG_WARNING("No suitable device matches the preferred device \"{}\", using the best scoring one.",
+                           preferred_device);
     }
 
-    ENGINE_LOG_ERROR("Required queue type: {} and support presents: {} not found", required_queue_type,
-                     supports_present);
+    m_dev_index = preferred_index >= 0 ? preferred_index : best_index;
+    const u32 queue_family{internal::find_queue_family(Selected(), required_queue_type, supports_present)};
+    ENGINE_LOG_DEBUG("Using GFX device: {} ({}) and queue family: {}", m_dev_index,
+                     Selected().m_device_properties.deviceName, queue_family);
 
-    return 0;
+    return queue_family;
 }
 
 const PhysicalDevice &VulkanPhysicalDevices::Selected() const
@@ -309,27 +522,60 @@ const PhysicalDevice &VulkanPhysicalDevices::Selected() const
 }
 
 // Device implementation ------------------------------------------------------------------------------
-Device::Device(const Instance &instance, const VkQueueFlags required_queue_flags)
-    : p_device{VK_NULL_HANDLE}, m_queue_family{0}, m_max_textures{MAX_TEXTURES}
+Device::Device(const Instance &instance, const VkQueueFlags required_queue_flags, const StringView preferred_device)
+    : p_device{VK_NULL_HANDLE},
+      m_queue_family{0},
+      m_transfer_queue_family{constants::u32_max},
+      m_compute_queue_family{constants::u32_max},
+      m_compute_queue_index{0},
+      m_max_textures{MAX_TEXTURES},
+      m_capabilities{},
+      p_wait_for_present{nullptr},
+      p_allocator{nullptr}
 {
     m_physical_devices.Initialize(instance, instance.GetSurface());
-    m_queue_family = m_physical_devices.SelectDevice(required_queue_flags, true);
-
-    u32 max_samplers{m_physical_devices.Selected().m_device_properties.limits.maxPerStageDescriptorSamplers};
-    ENGINE_LOG_DEBUG("Max samplers per stage: {}", max_samplers);
-    if (max_samplers < MAX_TEXTURES) {
-        ENGINE_LOG_ERROR("MAX_TEXTURES ({}) exceeds maxPerStageDescriptorSamplers ({}) on this device", MAX_TEXTURES,
-                         max_samplers);
-        ENGINE_THROW("Device does not support required number of texture samplers");
+    m_queue_family = m_physical_devices.SelectDevice(required_queue_flags, true, preferred_device);
+    // Transfer prefers a DMA only family, compute any family with compute but no graphics
+    m_transfer_queue_family = FindQueueFamily(VK_QUEUE_TRANSFER_BIT, VK_QUEUE_COMPUTE_BIT);
+    m_compute_queue_family = FindQueueFamily(VK_QUEUE_COMPUTE_BIT, 0);
+    m_capabilities.dedicated_transfer_queue = m_transfer_queue_family != constants::u32_max;
+    m_capabilities.async_compute_queue = m_compute_queue_family != constants::u32_max;
+    m_capabilities.host_visible_vram = internal::has_host_visible_vram(m_physical_devices.Selected());
+
+    // Texture arrays are bound with update after bind, which has its own, usually much larger, limits
+    VkPhysicalDeviceVulkan12Properties vulkan_12_properties{};
+    vulkan_12_properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES;
+
+    VkPhysicalDeviceProperties2 properties{};
+    properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    properties.pNext = &vulkan_12_properties;
+    vkGetPhysicalDeviceProperties2(m_physical_devices.Selected().m_physical_device, &properties);
+
+    // The quad fragment shader declares two of them, the textures and the texture arrays
+    const u32 sampler_limit{vulkan_12_properties.maxPerStageDescriptorUpdateAfterBindSamplers / BINDLESS_ARRAYS};
+    const u32 image_limit{vulkan_12_properties.maxPerStageDescriptorUpdateAfterBindSampledImages / BINDLESS_ARRAYS};
+    m_max_textures = math::min(MAX_TEXTURES, math::min(sampler_limit, image_limit));
+    if (m_max_textures == 0) {
+        ENGINE_THROW("Device does not support update after bind texture samplers");
     }
 
-    ENGINE_LOG_DEBUG("MAX_TEXTURES ({}) is supported (maxPerStageDescriptorSamplers: {})", MAX_TEXTURES, max_samplers);
+    ENGINE_LOG_DEBUG("Bindless texture capacity: {} (maxPerStageDescriptorUpdateAfterBindSamplers: {})",
+                     m_max_textures, vulkan_12_properties.maxPerStageDescriptorUpdateAfterBindSamplers);
 
     CreateDevice();
+
+    const PhysicalDevice &selected{m_physical_devices.Selected()};
+    p_allocator = std::make_unique<MemoryAllocator>(p_device, selected.m_memory_properties,
+                                                    selected.m_device_properties.limits.nonCoherentAtomSize);
+
+    LogCapabilities();
 }
 
 Device::~Device()
 {
+    // All blocks must be released before the device goes away
+    p_allocator.reset();
+
     if (p_device != VK_NULL_HANDLE) {
         vkDestroyDevice(p_device, nullptr);
         ENGINE_LOG_DEBUG("Device destroyed");
@@ -339,42 +585,234 @@ Device::~Device()
 void Device::CreateDevice()
 {
     constexpr f32 queue_priorities[]{1.0f};
+    SmallVector<VkDeviceQueueCreateInfo, 2> device_queue_create_infos;
+
     VkDeviceQueueCreateInfo device_queue_create_info{};
     device_queue_create_info.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
     device_queue_create_info.queueFamilyIndex = m_queue_family;
     device_queue_create_info.queueCount = 1;
     device_queue_create_info.pQueuePriorities = queue_priorities;
+    device_queue_create_infos.push_back(device_queue_create_info);
+
+    if (HasDedicatedTransferQueue()) {
+        device_queue_create_info.queueFamilyIndex = m_transfer_queue_family;
+        device_queue_create_infos.push_back(device_queue_create_info);
+    }
 
-    const std::vector<const char *> device_extensions{VK_KHR_SWAPCHAIN_EXTENSION_NAME,
-                                                VK_KHR_SHADER_DRAW_PARAMETERS_EXTENSION_NAME};
+    constexpr f32 shared_queue_priorities[]{1.0f, 1.0f};
+    if (HasAsyncComputeQueue()) {
+        if (m_compute_queue_family == m_transfer_queue_family) {
+            // Same family as the transfer queue, take a second queue from it if there is one
+            const u32 queue_count{
+                m_physical_devices.Selected().m_queue_family_properties[m_compute_queue_family].queueCount};
+            if (queue_count > 1) {
+                device_queue_create_infos.back().queueCount = 2;
+                device_queue_create_infos.back().pQueuePriorities = shared_queue_priorities;
+                m_compute_queue_index = 1;
+            }
+        }
+        else {
+            device_queue_create_info.queueFamilyIndex = m_compute_queue_family;
+            device_queue_create_infos.push_back(device_queue_create_info);
+        }
+    }
+
+    const PhysicalDevice &selected{m_physical_devices.Selected()};
+    std::vector<const char *> device_extensions{internal::required_device_extensions.begin(),
+                                                internal::required_device_extensions.end()};
+
+    // Optional, lets texture residency follow the real VRAM budget instead of a fixed one
+    m_capabilities.memory_budget = selected.SupportsExtension(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+    if (m_capabilities.memory_budget) {
+        device_extensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+    }
 
+    // Only what the device offers is enabled, asking for anything else fails device creation
+    const VkPhysicalDeviceFeatures &available_features{selected.m_features};
     VkPhysicalDeviceFeatures physical_device_features{};
-    physical_device_features.geometryShader = VK_TRUE;
-    physical_device_features.tessellationShader = VK_TRUE;
+    physical_device_features.geometryShader = available_features.geometryShader;
+    physical_device_features.tessellationShader = available_features.tessellationShader;
+
+    // Block compressed texture families are optional, enable whatever the device offers so KTX2 files can use them
+    physical_device_features.textureCompressionBC = available_features.textureCompressionBC;
+    physical_device_features.textureCompressionASTC_LDR = available_features.textureCompressionASTC_LDR;
+    physical_device_features.textureCompressionETC2 = available_features.textureCompressionETC2;
+    m_capabilities.bc_textures = available_features.textureCompressionBC == VK_TRUE;
+    m_capabilities.astc_textures = available_features.textureCompressionASTC_LDR == VK_TRUE;
+
+    // Lets each sprite pipeline draw all of its batches with one call
+    m_capabilities.multi_draw_indirect = available_features.multiDrawIndirect == VK_TRUE &&
+                                         available_features.drawIndirectFirstInstance == VK_TRUE;
+    physical_device_features.multiDrawIndirect = available_features.multiDrawIndirect;
+    physical_device_features.drawIndirectFirstInstance = available_features.drawIndirectFirstInstance;
+
+    // Device selection only picks devices with all of these
+    m_capabilities.descriptor_indexing = true;
+    m_capabilities.timeline_semaphores = true;
+    m_capabilities.dynamic_rendering = true;
+
+    VkPhysicalDeviceVulkan13Features vulkan_13_features{};
+    vulkan_13_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+    vulkan_13_features.dynamicRendering = VK_TRUE;
+
+    // Optional, lets frame pacing wait for a frame to reach the screen rather than queueing frames ahead of it
+    m_capabilities.present_wait = selected.m_supports_present_wait;
+
+    VkPhysicalDevicePresentWaitFeaturesKHR present_wait_features{};
+    present_wait_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+    present_wait_features.presentWait = VK_TRUE;
+    VkPhysicalDevicePresentIdFeaturesKHR present_id_features{};
+    present_id_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+    present_id_features.presentId = VK_TRUE;
+    present_id_features.pNext = &present_wait_features;
+    if (m_capabilities.present_wait) {
+        device_extensions.push_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+        device_extensions.push_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+        vulkan_13_features.pNext = &present_id_features;
+    }
+
+    // Optional, new pipelines and variants link separately compiled parts rather than compiling everything again
+    m_capabilities.graphics_pipeline_library = selected.m_supports_fast_pipeline_linking;
+
+    VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT pipeline_library_features{};
+    pipeline_library_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT;
+    pipeline_library_features.graphicsPipelineLibrary = VK_TRUE;
+    if (m_capabilities.graphics_pipeline_library) {
+        device_extensions.push_back(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME);
+        device_extensions.push_back(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME);
+        pipeline_library_features.pNext = std::exchange(vulkan_13_features.pNext, &pipeline_library_features);
+    }
+
+    VkPhysicalDeviceVulkan12Features vulkan_12_features{};
+    vulkan_12_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    vulkan_12_features.timelineSemaphore = VK_TRUE;
+    vulkan_12_features.runtimeDescriptorArray = VK_TRUE;
+    vulkan_12_features.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+    vulkan_12_features.descriptorBindingPartiallyBound = VK_TRUE;
+    vulkan_12_features.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+    vulkan_12_features.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+    vulkan_12_features.pNext = &vulkan_13_features;
 
     VkDeviceCreateInfo device_create_info{};
     device_create_info.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
-    device_create_info.queueCreateInfoCount = 1;
-    device_create_info.pQueueCreateInfos = &device_queue_create_info;
+    device_create_info.pNext = &vulkan_12_features;
+    device_create_info.queueCreateInfoCount = static_cast<u32>(device_queue_create_infos.size());
+    device_create_info.pQueueCreateInfos = device_queue_create_infos.data();
     device_create_info.enabledExtensionCount = static_cast<u32>(device_extensions.size());
     device_create_info.ppEnabledExtensionNames = device_extensions.data();
     device_create_info.pEnabledFeatures = &physical_device_features;
 
-    const VkResult result{
-        vkCreateDevice(m_physical_devices.Selected().m_physical_device, &device_create_info, nullptr, &p_device)};
+    const VkResult result{vkCreateDevice(selected.m_physical_device, &device_create_info, nullptr, &p_device)};
     if (result != VK_SUCCESS) {
         CHECK_VK_RESULT(result, "vkCreateDevice");
     }
 
+    // Extension commands are not exported by the loader
+    if (m_capabilities.present_wait) {
+        p_wait_for_present =
+            reinterpret_cast<PFN_vkWaitForPresentKHR>(vkGetDeviceProcAddr(p_device, "vkWaitForPresentKHR"));
+        m_capabilities.present_wait = p_wait_for_present != nullptr;
+    }
+
     // Log feature support for debugging
-    if (m_physical_devices.Selected().m_features.geometryShader == VK_FALSE) {
+    if (selected.m_features.geometryShader == VK_FALSE) {
         ENGINE_LOG_ERROR("The Geometry Shader is not supported!");
     }
-    if (m_physical_devices.Selected().m_features.tessellationShader == VK_FALSE) {
+    if (selected.m_features.tessellationShader == VK_FALSE) {
         ENGINE_LOG_ERROR("The Tessellation Shader is not supported!");
     }
 
+    ENGINE_LOG_DEBUG("Texture compression support: BC={}, ASTC LDR={}, ETC2={}",
+                     available_features.textureCompressionBC == VK_TRUE,
+                     available_features.textureCompressionASTC_LDR == VK_TRUE,
+                     available_features.textureCompressionETC2 == VK_TRUE);
     ENGINE_LOG_DEBUG("Device created with queue family index: {}", m_queue_family);
+    if (HasDedicatedTransferQueue()) {
+        ENGINE_LOG_DEBUG("Dedicated transfer queue family index: {}", m_transfer_queue_family);
+    }
+    if (HasAsyncComputeQueue()) {
+        ENGINE_LOG_DEBUG("Async compute queue family index: {} (queue {})", m_compute_queue_family,
+                         m_compute_queue_index);
+    }
+}
+
+void Device::LogCapabilities() const
+{
+    const PhysicalDevice &selected{GetSelectedPhysicalDevice()};
+    ENGINE_LOG_INFO("GPU: {} with {} MiB of device local memory", selected.m_device_properties.deviceName,
+                    selected.GetDeviceLocalMemorySize() / (1024 * 1024));
+    ENGINE_LOG_DEBUG("Capabilities: memory budget={}, present wait={}, BC={}, ASTC={}, transfer queue={}, "
+                     "async compute={}, multi draw indirect={}, host visible VRAM={}, pipeline library={}",
+                     m_capabilities.memory_budget, m_capabilities.present_wait, m_capabilities.bc_textures,
+                     m_capabilities.astc_textures, m_capabilities.dedicated_transfer_queue,
+                     m_capabilities.async_compute_queue, m_capabilities.multi_draw_indirect,
+                     m_capabilities.host_visible_vram, m_capabilities.graphics_pipeline_library);
+}
+
+MemoryBudget Device::GetMemoryBudget() const
+{
+    if (!m_capabilities.memory_budget) {
+        return MemoryBudget{0, 0};
+    }
+
+    VkPhysicalDeviceMemoryBudgetPropertiesEXT budget_properties{};
+    budget_properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+
+    VkPhysicalDeviceMemoryProperties2 memory_properties{};
+    memory_properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+    memory_properties.pNext = &budget_properties;
+    vkGetPhysicalDeviceMemoryProperties2(GetPhysicalDevice(), &memory_properties);
+
+    MemoryBudget budget{0, 0};
+    for (u32 i = 0; i < memory_properties.memoryProperties.memoryHeapCount; ++i) {
+        if (memory_properties.memoryProperties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) {
+            budget.budget += budget_properties.heapBudget[i];
+            budget.usage += budget_properties.heapUsage[i];
+        }
+    }
+
+    return budget;
+}
+
+bool Device::WaitForPresent(const VkSwapchainKHR swapchain, const u64 present_id, const u64 timeout) const
+{
+    if (!m_capabilities.present_wait || present_id == 0) {
+        return false;
+    }
+
+    // Timeouts and an out of date swapchain are expected while resizing or minimized, callers just stop waiting
+    return p_wait_for_present(p_device, swapchain, present_id, timeout) == VK_SUCCESS;
+}
+
+bool Device::IsFormatSupported(const VkFormat format, const VkFormatFeatureFlags features) const
+{
+    VkFormatProperties properties{};
+    vkGetPhysicalDeviceFormatProperties(GetPhysicalDevice(), format, &properties);
+    return (properties.optimalTilingFeatures & features) == features;
+}
+
+u32 Device::FindQueueFamily(const VkQueueFlags required_flags, const VkQueueFlags avoided_flags) const
+{
+    const auto &queue_families{m_physical_devices.Selected().m_queue_family_properties};
+
+    // Never the graphics family. Prefer one without the avoided flags, then any non graphics family that fits.
+    u32 fallback{constants::u32_max};
+    for (u32 i = 0; i < queue_families.size(); ++i) {
+        const VkQueueFlags flags{queue_families[i].queueFlags};
+        if (i == m_queue_family || (flags & required_flags) != required_flags || (flags & VK_QUEUE_GRAPHICS_BIT)) {
+            continue;
+        }
+
+        if (!(flags & avoided_flags)) {
+            return i;
+        }
+
+        if (fallback == constants::u32_max) {
+            fallback = i;
+        }
+    }
+
+    return fallback;
 }
 
 } // namespace gouda::vk
\ No newline at end of file
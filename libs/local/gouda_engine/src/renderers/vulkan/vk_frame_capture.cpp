@@ -0,0 +1,270 @@
+/**
+ * @file vk_frame_capture.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine vulkan screenshot and frame capture module implementation
+ */
+#include "renderers/vulkan/vk_frame_capture.hpp"
+
+#include <algorithm>
+#include <format>
+#include <utility>
+#include <vector>
+
+#include "stb_image_write.h"
+
+#include "debug/logger.hpp"
+#include "debug/profiler.hpp"
+#include "renderers/vulkan/vk_buffer_manager.hpp"
+#include "renderers/vulkan/vk_device.hpp"
+#include "renderers/vulkan/vk_queue.hpp"
+#include "utils/filesystem.hpp"
+#include "utils/thread.hpp"
+
+namespace gouda::vk {
+
+namespace internal {
+
+constexpr u32 CAPTURE_PIXEL_SIZE{4};
+
+static bool is_capture_format(const VkFormat format)
+{
+    return format == VK_FORMAT_B8G8R8A8_SRGB || format == VK_FORMAT_B8G8R8A8_UNORM ||
+           format == VK_FORMAT_R8G8B8A8_SRGB || format == VK_FORMAT_R8G8B8A8_UNORM;
+}
+
+static bool is_bgra_format(const VkFormat format)
+{
+    return format == VK_FORMAT_B8G8R8A8_SRGB || format == VK_FORMAT_B8G8R8A8_UNORM;
+}
+
+} // namespace internal
+
+FrameCapture::FrameCapture(Device *device, BufferManager *buffer_manager)
+    : p_device{device},
+      p_buffer_manager{buffer_manager},
+      m_slots{},
+      p_reserved_slot{nullptr},
+      m_screenshot_paths{},
+      m_capture_directory{},
+      m_is_capturing{false},
+      m_capture_frame_index{0},
+      m_dropped_frame_count{0},
+      m_is_format_warned{false},
+      m_encode_queue{},
+      m_thread{MakeThread("Frame capture", ThreadPriority::IO,
+                          [this](const std::stop_token &stop_token) { Run(stop_token); })}
+{
+}
+
+FrameCapture::~FrameCapture()
+{
+    {
+        std::unique_lock lock{m_mutex};
+        m_condition.wait(lock, [this] {
+            return m_encode_queue.empty() && std::ranges::none_of(m_slots, [](const Slot &slot) {
+                       return slot.state.load(std::memory_order_acquire) == SlotState::Encoding;
+                   });
+        });
+    }
+    m_thread.request_stop();
+    m_thread.join();
+
+    for (Slot &slot : m_slots) {
+        slot.buffer.Destroy(p_device->GetDevice());
+    }
+}
+
+void FrameCapture::RequestScreenshot(String filepath)
+{
+    if (const FilePath directory{FilePath{filepath}.parent_path()}; !directory.empty()) {
+        if (const auto result{fs::EnsureDirectoryExists(directory, true)}; !result) {
+            ENGINE_LOG_ERROR("Cannot take screenshot '{}': {}", filepath, fs::error_to_string(result.error()));
+            return;
+        }
+    }
+    m_screenshot_paths.push_back(std::move(filepath));
+}
+
+void FrameCapture::StartCapture(String directory)
+{
+    if (const auto result{fs::EnsureDirectoryExists(FilePath{directory}, true)}; !result) {
+        ENGINE_LOG_ERROR("Cannot capture frames to '{}': {}", directory, fs::error_to_string(result.error()));
+        return;
+    }
+
+    m_capture_directory = std::move(directory);
+    m_is_capturing = true;
+    m_capture_frame_index = 0;
+    m_dropped_frame_count = 0;
+    ENGINE_LOG_INFO("Capturing frames to '{}'.", m_capture_directory);
+}
+
+void FrameCapture::StopCapture()
+{
+    if (!m_is_capturing) {
+        return;
+    }
+
+    m_is_capturing = false;
+    ENGINE_LOG_INFO("Captured {} frame(s) to '{}', {} dropped while every slot was busy.", m_capture_frame_index,
+                    m_capture_directory, m_dropped_frame_count);
+}
+
+void FrameCapture::Collect(const Queue &queue)
+{
+    bool is_queued{false};
+    for (Slot &slot : m_slots) {
+        if (slot.state.load(std::memory_order_acquire) == SlotState::Recorded &&
+            queue.IsComplete(slot.timeline_value)) {
+            slot.state.store(SlotState::Encoding, std::memory_order_release);
+            std::lock_guard lock{m_mutex};
+            m_encode_queue.push_back(&slot);
+            is_queued = true;
+        }
+    }
+    if (is_queued) {
+        m_condition.notify_all();
+    }
+}
+
+bool FrameCapture::BeginFrame(const VkExtent2D extent, const VkFormat format)
+{
+    if (m_screenshot_paths.empty() && !m_is_capturing) {
+        return false;
+    }
+
+    if (!internal::is_capture_format(format)) {
+        if (!m_is_format_warned) {
+            ENGINE_LOG_WARNING("Cannot capture frames of format {}, only 8 bit RGBA and BGRA are read back.",
+                               static_cast<u32>(format));
+            m_is_format_warned = true;
+        }
+        m_screenshot_paths.clear();
+        return false;
+    }
+
+    // A screenshot waits for a free slot, a continuous capture moves on without this frame
+    Slot *slot{FindFreeSlot()};
+    if (!slot) {
+        if (m_is_capturing) {
+            ++m_dropped_frame_count;
+        }
+        return false;
+    }
+
+    // Slots only grow, a free slot is read by no submission and no encode
+    const VkDeviceSize size{static_cast<VkDeviceSize>(extent.width) * extent.height * internal::CAPTURE_PIXEL_SIZE};
+    if (slot->buffer.p_buffer == VK_NULL_HANDLE || slot->buffer.m_allocation_size < size) {
+        slot->buffer.Destroy(p_device->GetDevice());
+        slot->buffer = p_buffer_manager->CreateBuffer(size, VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                                      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, {},
+                                                      VK_MEMORY_PROPERTY_HOST_CACHED_BIT);
+    }
+
+    if (!m_screenshot_paths.empty()) {
+        slot->filepath = std::move(m_screenshot_paths.front());
+        m_screenshot_paths.pop_front();
+        if (m_is_capturing) {
+            ++m_dropped_frame_count;
+        }
+    }
+    else {
+        slot->filepath = std::format("{}/frame_{:06}.png", m_capture_directory, m_capture_frame_index++);
+    }
+    slot->extent = extent;
+    slot->format = format;
+    slot->state.store(SlotState::Reserved, std::memory_order_release);
+    p_reserved_slot = slot;
+    return true;
+}
+
+void FrameCapture::RecordCopy(const VkCommandBuffer command_buffer, const VkImage image) const
+{
+    const VkBufferImageCopy region{.bufferOffset = 0,
+                                   .bufferRowLength = 0,
+                                   .bufferImageHeight = 0,
+                                   .imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1},
+                                   .imageOffset = {0, 0, 0},
+                                   .imageExtent = {p_reserved_slot->extent.width, p_reserved_slot->extent.height, 1}};
+    vkCmdCopyImageToBuffer(command_buffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                           p_reserved_slot->buffer.p_buffer, 1, &region);
+
+    // The timeline wait on the host then covers the reads of the mapping
+    const VkMemoryBarrier barrier{.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+                                  .pNext = nullptr,
+                                  .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+                                  .dstAccessMask = VK_ACCESS_HOST_READ_BIT};
+    vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &barrier, 0,
+                         nullptr, 0, nullptr);
+}
+
+void FrameCapture::EndFrame(const u64 timeline_value)
+{
+    if (p_reserved_slot) {
+        p_reserved_slot->timeline_value = timeline_value;
+        p_reserved_slot->state.store(SlotState::Recorded, std::memory_order_release);
+        p_reserved_slot = nullptr;
+    }
+}
+
+FrameCapture::Slot *FrameCapture::FindFreeSlot()
+{
+    const auto it{std::ranges::find_if(m_slots, [](const Slot &slot) {
+        return slot.state.load(std::memory_order_acquire) == SlotState::Free;
+    })};
+    return it != m_slots.end() ? &*it : nullptr;
+}
+
+void FrameCapture::Encode(Slot &slot) const
+{
+    ENGINE_PROFILE_SCOPE("Encode frame capture");
+
+    // Swapchain images are opaque, whatever their alpha holds is written as fully opaque
+    slot.buffer.Invalidate();
+    const u32 pixel_count{slot.extent.width * slot.extent.height};
+    const auto *pixels{static_cast<const u8 *>(slot.buffer.GetMapped())};
+    const size_t red_offset{internal::is_bgra_format(slot.format) ? 2u : 0u};
+    std::vector<u8> rgba(static_cast<size_t>(pixel_count) * internal::CAPTURE_PIXEL_SIZE);
+    for (size_t i = 0; i < rgba.size(); i += internal::CAPTURE_PIXEL_SIZE) {
+        rgba[i] = pixels[i + red_offset];
+        rgba[i + 1] = pixels[i + 1];
+        rgba[i + 2] = pixels[i + 2 - red_offset];
+        rgba[i + 3] = 0xFF;
+    }
+
+    const int width{static_cast<int>(slot.extent.width)};
+    if (stbi_write_png(slot.filepath.c_str(), width, static_cast<int>(slot.extent.height),
+                       static_cast<int>(internal::CAPTURE_PIXEL_SIZE), rgba.data(),
+                       width * static_cast<int>(internal::CAPTURE_PIXEL_SIZE)) == 0) {
+        ENGINE_LOG_ERROR("Failed to write the captured frame to '{}'.", slot.filepath);
+    }
+    else {
+        ENGINE_LOG_DEBUG("Wrote the captured frame to '{}'.", slot.filepath);
+    }
+}
+
+void FrameCapture::Run(const std::stop_token &stop_token)
+{
+    while (true) {
+        Slot *slot{nullptr};
+        {
+            std::unique_lock lock{m_mutex};
+            if (!m_condition.wait(lock, stop_token, [this] { return !m_encode_queue.empty(); })) {
+                return;
+            }
+            slot = m_encode_queue.front();
+            m_encode_queue.erase(m_encode_queue.begin());
+        }
+
+        Encode(*slot);
+
+        {
+            std::lock_guard lock{m_mutex};
+            slot->state.store(SlotState::Free, std::memory_order_release);
+        }
+        m_condition.notify_all();
+    }
+}
+
+} // namespace gouda::vk
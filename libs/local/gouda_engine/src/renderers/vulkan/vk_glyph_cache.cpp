@@ -0,0 +1,384 @@
+/**
+ * @file vk_glyph_cache.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine vulkan on demand glyph rasterization module implementation
+ */
+#include "renderers/vulkan/vk_glyph_cache.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+#define STB_TRUETYPE_IMPLEMENTATION
+#define STBTT_STATIC
+#include "stb_truetype.h"
+
+#include "debug/logger.hpp"
+#include "debug/profiler.hpp"
+#include "renderers/vulkan/vk_buffer_manager.hpp"
+#include "renderers/vulkan/vk_texture.hpp"
+#include "renderers/vulkan/vk_texture_manager.hpp"
+#include "utils/filesystem.hpp"
+#include "utils/mapped_file.hpp"
+#include "utils/thread.hpp"
+
+namespace gouda::vk {
+
+namespace internal {
+
+constexpr VkFormat GLYPH_PAGE_FORMAT{VK_FORMAT_R8G8B8A8_UNORM};
+constexpr u32 GLYPH_PAGE_PIXEL_SIZE{4};
+constexpr u8 GLYPH_OUTLINE_VALUE{128}; // 0.5, where the quad shader puts the edge
+
+static void add_changed_font(Vector<u32> &changed_font_ids, const u32 font_id)
+{
+    if (std::ranges::find(changed_font_ids, font_id) == changed_font_ids.end()) {
+        changed_font_ids.push_back(font_id);
+    }
+}
+
+} // namespace internal
+
+struct GlyphCache::SourceFont {
+    explicit SourceFont(fs::MappedFile mapped_file)
+        : file{std::move(mapped_file)}, info{}, scale{0.0f}, em_scale{0.0f}, distance_range{0.0f}, padding{0}
+    {
+    }
+
+    fs::MappedFile file; // Read by stb_truetype in place
+    stbtt_fontinfo info;
+    f32 scale;          // Font units to cell pixels, the line height fills a cell
+    f32 em_scale;       // Font units to ems
+    f32 distance_range; // In pixels, as the baked atlas's
+    int padding;        // Around the outline, for the distances outside it
+};
+
+GlyphCache::GlyphCache(BufferManager *buffer_manager, TextureManager *texture_manager)
+    : p_buffer_manager{buffer_manager},
+      p_texture_manager{texture_manager},
+      m_fonts{},
+      m_glyphs{},
+      m_cells{},
+      m_pages{},
+      m_unplaced{},
+      m_used_cell_count{0},
+      m_frame{1},
+      m_is_full_warned{false},
+      m_requests{},
+      m_results{},
+      m_thread{MakeThread("Glyph raster", ThreadPriority::Jobs,
+                          [this](const std::stop_token &stop_token) { Run(stop_token); })}
+{
+}
+
+GlyphCache::~GlyphCache()
+{
+    m_thread.request_stop();
+    m_thread.join();
+}
+
+bool GlyphCache::AddFont(const u32 font_id, StringView font_filepath, const MSDFAtlasParams &atlas_params)
+{
+    // Queued glyphs point at the font, so it is never replaced
+    if (HasFont(font_id)) {
+        ENGINE_LOG_WARNING("Font {} already rasterizes its glyphs, '{}' is not used.", font_id, font_filepath);
+        return false;
+    }
+
+    auto file{fs::MappedFile::Open(font_filepath)};
+    if (!file) {
+        ENGINE_LOG_ERROR("Cannot rasterize the glyphs of font {} from '{}': {}", font_id, font_filepath,
+                         fs::error_to_string(file.error()));
+        return false;
+    }
+
+    auto font{std::make_unique<SourceFont>(std::move(*file))};
+    const auto *data{reinterpret_cast<const unsigned char *>(font->file.GetData().data())};
+    const int offset{font->file.GetSize() > 0 ? stbtt_GetFontOffsetForIndex(data, 0) : -1};
+    if (offset < 0 || stbtt_InitFont(&font->info, data, offset) == 0) {
+        ENGINE_LOG_ERROR("Cannot rasterize the glyphs of font {}, '{}' is no TrueType font.", font_id, font_filepath);
+        return false;
+    }
+
+    int ascent{0};
+    int descent{0};
+    int line_gap{0};
+    stbtt_GetFontVMetrics(&font->info, &ascent, &descent, &line_gap);
+    font->distance_range = std::max(atlas_params.distance_range, 1.0f);
+    font->padding = static_cast<int>(std::ceil(font->distance_range * 0.5f)) + 1;
+    font->scale = static_cast<f32>(CELL_SIZE - 2 * static_cast<u32>(font->padding)) /
+                  static_cast<f32>(std::max(ascent - descent, 1));
+    font->em_scale = stbtt_ScaleForMappingEmToPixels(&font->info, 1.0f);
+
+    if (font_id >= m_fonts.size()) {
+        m_fonts.resize(font_id + 1);
+    }
+    m_fonts[font_id] = std::move(font);
+    ENGINE_LOG_DEBUG("Glyphs missing from font {} are rasterized from '{}'.", font_id, font_filepath);
+    return true;
+}
+
+const GlyphCache::Glyph *GlyphCache::Find(const u32 font_id, const u32 codepoint)
+{
+    if (!HasFont(font_id)) {
+        return nullptr;
+    }
+
+    const u64 key{GlyphKey(font_id, codepoint)};
+    if (Entry *entry{m_glyphs.get(key)}) {
+        if (entry->state != GlyphState::Placed) {
+            return nullptr;
+        }
+        if (entry->glyph.cell != NO_CELL) {
+            // A page whose texture could not be added draws nothing
+            entry->glyph.texture_id = m_pages[entry->glyph.cell / CELLS_PER_PAGE].texture_id;
+            if (entry->glyph.texture_id == 0) {
+                return nullptr;
+            }
+        }
+        return &entry->glyph;
+    }
+
+    m_glyphs.try_emplace(key, Entry{Glyph{MSDFGlyph{}, 0, NO_CELL}, GlyphState::Queued});
+    {
+        std::lock_guard lock{m_mutex};
+        m_requests.emplace_back(m_fonts[font_id].get(), key);
+    }
+    m_condition.notify_one();
+    return nullptr;
+}
+
+void GlyphCache::Touch(const std::span<const u32> cells)
+{
+    for (const u32 cell : cells) {
+        if (cell < m_cells.size()) {
+            m_cells[cell].last_used = m_frame;
+        }
+    }
+}
+
+void GlyphCache::Update(Vector<u32> &changed_font_ids)
+{
+    {
+        std::lock_guard lock{m_mutex};
+        for (Rasterized &rasterized : m_results) {
+            m_unplaced.push_back(std::move(rasterized));
+        }
+        m_results.clear();
+    }
+
+    // Queued glyphs are in no cell, so evictions never take the entries of those below
+    size_t placed_count{0};
+    for (; placed_count < m_unplaced.size(); ++placed_count) {
+        const Rasterized &rasterized{m_unplaced[placed_count]};
+        const u32 font_id{static_cast<u32>(rasterized.key >> 32)};
+        if (rasterized.is_missing) {
+            m_glyphs.get(rasterized.key)->state = GlyphState::Missing;
+            continue;
+        }
+
+        // Blank glyphs, such as the ideographic space, only advance the pen
+        u32 cell{NO_CELL};
+        if (!rasterized.distances.empty()) {
+            cell = AllocateCell(changed_font_ids);
+            if (cell == NO_CELL) {
+                if (!m_is_full_warned) {
+                    ENGINE_LOG_WARNING("Every one of the {} glyph cells was drawn this frame, new glyphs wait for one.",
+                                       m_cells.size());
+                    m_is_full_warned = true;
+                }
+                break;
+            }
+        }
+
+        // After the allocation, erasing the evicted glyph leaves the other entries where they are
+        Entry &entry{*m_glyphs.get(rasterized.key)};
+        entry.glyph = rasterized.glyph;
+        entry.glyph.cell = cell;
+        entry.state = GlyphState::Placed;
+        if (cell != NO_CELL) {
+            Place(rasterized, cell, entry.glyph);
+        }
+        internal::add_changed_font(changed_font_ids, font_id);
+    }
+    m_unplaced.erase(m_unplaced.begin(), m_unplaced.begin() + placed_count);
+
+    UploadPages();
+    ++m_frame;
+}
+
+u32 GlyphCache::AllocateCell(Vector<u32> &changed_font_ids)
+{
+    // Cells are only ever taken over once all are used, so the free ones are those past the count
+    if (m_used_cell_count < m_cells.size()) {
+        const u32 cell{m_used_cell_count++};
+        if (cell / CELLS_PER_PAGE >= m_pages.size()) {
+            Page &page{m_pages.emplace_back()};
+            page.pixels.resize(static_cast<size_t>(PAGE_SIZE) * PAGE_SIZE * internal::GLYPH_PAGE_PIXEL_SIZE, 0);
+        }
+        return cell;
+    }
+
+    u32 coldest{NO_CELL};
+    for (u32 i = 0; i < m_cells.size(); ++i) {
+        const u64 last_used{m_cells[i].last_used};
+        if (last_used < m_frame && (coldest == NO_CELL || last_used < m_cells[coldest].last_used)) {
+            coldest = i;
+        }
+    }
+    if (coldest == NO_CELL) {
+        return NO_CELL;
+    }
+
+    const u64 evicted_key{m_cells[coldest].key};
+    m_glyphs.erase(evicted_key);
+    internal::add_changed_font(changed_font_ids, static_cast<u32>(evicted_key >> 32));
+    return coldest;
+}
+
+void GlyphCache::Place(const Rasterized &rasterized, const u32 cell, Glyph &glyph)
+{
+    Page &page{m_pages[cell / CELLS_PER_PAGE]};
+    const u32 cell_x{cell % CELLS_PER_PAGE % CELLS_PER_ROW * CELL_SIZE};
+    const u32 cell_y{cell % CELLS_PER_PAGE / CELLS_PER_ROW * CELL_SIZE};
+    constexpr size_t pixel_size{internal::GLYPH_PAGE_PIXEL_SIZE};
+
+    // What the last glyph left would be filtered in at the edges
+    for (u32 row = cell_y; row < cell_y + CELL_SIZE; ++row) {
+        std::memset(page.pixels.data() + (static_cast<size_t>(row) * PAGE_SIZE + cell_x) * pixel_size, 0,
+                    CELL_SIZE * pixel_size);
+    }
+
+    // Flipped, page rows go up from the bottom
+    for (u32 row = 0; row < rasterized.height; ++row) {
+        const u8 *source{rasterized.distances.data() + static_cast<size_t>(row) * rasterized.width};
+        u8 *destination{page.pixels.data() +
+                        (static_cast<size_t>(cell_y + rasterized.height - 1 - row) * PAGE_SIZE + cell_x) * pixel_size};
+        for (u32 x = 0; x < rasterized.width; ++x) {
+            destination[x * pixel_size] = source[x];
+            destination[x * pixel_size + 1] = source[x];
+            destination[x * pixel_size + 2] = source[x];
+            destination[x * pixel_size + 3] = 0xFF;
+        }
+    }
+    page.dirty_first_row = std::min(page.dirty_first_row, cell_y);
+    page.dirty_last_row = std::max(page.dirty_last_row, cell_y + CELL_SIZE);
+
+    m_cells[cell] = Cell{rasterized.key, m_frame};
+    glyph.metrics.atlas_bounds =
+        Rect<f32>{static_cast<f32>(cell_x), static_cast<f32>(cell_x + rasterized.width), static_cast<f32>(cell_y),
+                  static_cast<f32>(cell_y + rasterized.height)};
+}
+
+void GlyphCache::UploadPages()
+{
+    const ImageSize page_size{static_cast<int>(PAGE_SIZE), static_cast<int>(PAGE_SIZE)};
+    for (Page &page : m_pages) {
+        if (page.dirty_first_row >= page.dirty_last_row) {
+            continue;
+        }
+
+        if (page.texture_id == 0) {
+            // A new page goes up whole with its first glyphs, rows are only updated in later batches
+            auto texture{std::make_unique<Texture>()};
+            p_buffer_manager->CreateTextureImageFromData(*texture, page.pixels.data(), page_size,
+                                                         internal::GLYPH_PAGE_FORMAT, 1, 0);
+            texture->p_view = p_buffer_manager->CreateImageView(texture->p_image, internal::GLYPH_PAGE_FORMAT,
+                                                                VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_VIEW_TYPE_2D, 1, 1);
+            texture->p_sampler = p_buffer_manager->GetTextureSampler(VK_FILTER_LINEAR, VK_FILTER_LINEAR,
+                                                                     VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE);
+            page.texture_id = p_texture_manager->AddTexture(std::move(texture));
+        }
+        else {
+            const size_t row_offset{static_cast<size_t>(page.dirty_first_row) * PAGE_SIZE *
+                                    internal::GLYPH_PAGE_PIXEL_SIZE};
+            p_buffer_manager->UpdateTextureRows(*p_texture_manager->GetTextures()[page.texture_id], page_size,
+                                                internal::GLYPH_PAGE_FORMAT, page.dirty_first_row,
+                                                page.dirty_last_row - page.dirty_first_row,
+                                                page.pixels.data() + row_offset);
+        }
+        page.dirty_first_row = PAGE_SIZE;
+        page.dirty_last_row = 0;
+    }
+}
+
+GlyphCache::Rasterized GlyphCache::Rasterize(const SourceFont &font, const u64 key)
+{
+    ENGINE_PROFILE_SCOPE("Rasterize glyph");
+
+    Rasterized rasterized{.key = key,
+                          .glyph = Glyph{MSDFGlyph{}, 0, NO_CELL},
+                          .distances = {},
+                          .width = 0,
+                          .height = 0,
+                          .is_missing = false};
+    const int glyph_index{stbtt_FindGlyphIndex(&font.info, static_cast<int>(key & 0xFFFFFFFF))};
+    if (glyph_index == 0) {
+        rasterized.is_missing = true;
+        return rasterized;
+    }
+
+    int advance{0};
+    int left_side_bearing{0};
+    stbtt_GetGlyphHMetrics(&font.info, glyph_index, &advance, &left_side_bearing);
+    rasterized.glyph.metrics.advance = static_cast<f32>(advance) * font.em_scale;
+
+    // Distances span the atlas's range across the outline, as msdf-atlas-gen writes them
+    int width{0};
+    int height{0};
+    int x_offset{0};
+    int y_offset{0};
+    u8 *distances{stbtt_GetGlyphSDF(&font.info, font.scale, glyph_index, font.padding, internal::GLYPH_OUTLINE_VALUE,
+                                    255.0f / font.distance_range, &width, &height, &x_offset, &y_offset)};
+    if (distances == nullptr) {
+        return rasterized;
+    }
+    if (width > static_cast<int>(CELL_SIZE) || height > static_cast<int>(CELL_SIZE)) {
+        stbtt_FreeSDF(distances, nullptr);
+        ENGINE_LOG_WARNING("Glyph U+{:04X} is larger than a {} pixel glyph cell, it is not drawn.",
+                           static_cast<u32>(key & 0xFFFFFFFF), CELL_SIZE);
+        rasterized.is_missing = true;
+        return rasterized;
+    }
+
+    rasterized.width = static_cast<u32>(width);
+    rasterized.height = static_cast<u32>(height);
+    rasterized.distances.resize_uninitialized(static_cast<size_t>(width) * static_cast<size_t>(height));
+    std::memcpy(rasterized.distances.data(), distances, rasterized.distances.size());
+    stbtt_FreeSDF(distances, nullptr);
+
+    // Offsets are of the top left corner with y down, plane bounds are in ems with y up
+    const f32 pixels_per_em{font.scale / font.em_scale};
+    rasterized.glyph.metrics.plane_bounds =
+        Rect<f32>{static_cast<f32>(x_offset) / pixels_per_em, static_cast<f32>(x_offset + width) / pixels_per_em,
+                  static_cast<f32>(-(y_offset + height)) / pixels_per_em, static_cast<f32>(-y_offset) / pixels_per_em};
+    return rasterized;
+}
+
+void GlyphCache::Run(const std::stop_token &stop_token)
+{
+    Vector<std::pair<const SourceFont *, u64>> requests;
+    while (true) {
+        {
+            std::unique_lock lock{m_mutex};
+            if (!m_condition.wait(lock, stop_token, [this] { return !m_requests.empty(); })) {
+                return;
+            }
+            requests.swap(m_requests);
+        }
+
+        for (const auto &[font, key] : requests) {
+            if (stop_token.stop_requested()) {
+                return;
+            }
+            Rasterized rasterized{Rasterize(*font, key)};
+            std::lock_guard lock{m_mutex};
+            m_results.push_back(std::move(rasterized));
+        }
+        requests.clear();
+    }
+}
+
+} // namespace gouda::vk
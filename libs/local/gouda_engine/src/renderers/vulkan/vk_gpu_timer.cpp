@@ -0,0 +1,164 @@
+/**
+ * @file vk_gpu_timer.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine vulkan GPU timestamp query implementation
+ */
+#include "renderers/vulkan/vk_gpu_timer.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+#include "debug/logger.hpp"
+#include "debug/profiler.hpp"
+#include "renderers/vulkan/vk_device.hpp"
+#include "renderers/vulkan/vk_utils.hpp"
+
+namespace gouda::vk {
+
+GpuTimer::GpuTimer(const Device *device, const u32 frames_in_flight)
+    : p_device{device->GetDevice()},
+      p_query_pool{VK_NULL_HANDLE},
+      m_timestamp_period{0.0},
+      m_timestamp_mask{0},
+      m_submit_times(frames_in_flight, FloatingPointMicroseconds{0.0}),
+      m_has_results(frames_in_flight, false),
+      m_timings{}
+{
+    const PhysicalDevice &physical_device{device->GetSelectedPhysicalDevice()};
+    const u32 valid_bits{physical_device.m_queue_family_properties[device->GetQueueFamily()].timestampValidBits};
+    m_timestamp_period = static_cast<f64>(physical_device.m_device_properties.limits.timestampPeriod);
+    if (valid_bits == 0 || m_timestamp_period <= 0.0) {
+        ENGINE_LOG_WARNING("Graphics queue does not support timestamps, GPU timings are disabled.");
+        return;
+    }
+    m_timestamp_mask = valid_bits >= 64 ? constants::u64_max : (u64{1} << valid_bits) - 1;
+
+    const VkQueryPoolCreateInfo create_info{.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+                                            .queryType = VK_QUERY_TYPE_TIMESTAMP,
+                                            .queryCount = frames_in_flight * QUERIES_PER_FRAME};
+    if (const VkResult result{vkCreateQueryPool(p_device, &create_info, nullptr, &p_query_pool)};
+        result != VK_SUCCESS) {
+        CHECK_VK_RESULT(result, "vkCreateQueryPool");
+    }
+
+    ENGINE_LOG_DEBUG("GPU timer created with {} timestamp queries.", create_info.queryCount);
+}
+
+GpuTimer::~GpuTimer()
+{
+    if (p_query_pool != VK_NULL_HANDLE) {
+        vkDestroyQueryPool(p_device, p_query_pool, nullptr);
+    }
+}
+
+void GpuTimer::CollectResults(const u32 frame_index)
+{
+    if (!IsSupported() || !m_has_results[frame_index]) {
+        return;
+    }
+    m_has_results[frame_index] = false;
+
+    // Value and availability per query, skipped scopes were reset but never written and read as unavailable
+    std::array<u64, QUERIES_PER_FRAME * 2> results{};
+    const VkResult result{vkGetQueryPoolResults(p_device, p_query_pool, GetQuery(frame_index, GpuScope::Compute),
+                                                QUERIES_PER_FRAME, sizeof(results), results.data(), sizeof(u64) * 2,
+                                                VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT)};
+    if (result != VK_SUCCESS && result != VK_NOT_READY) {
+        CHECK_VK_RESULT(result, "vkGetQueryPoolResults");
+    }
+
+    const auto ticks_to_microseconds = [this](const u64 ticks) {
+        return FloatingPointMicroseconds{static_cast<f64>(ticks & m_timestamp_mask) * m_timestamp_period / 1000.0};
+    };
+
+    const auto is_available = [&results](const u32 scope) {
+        return results[scope * 4 + 1] != 0 && results[scope * 4 + 3] != 0;
+    };
+
+    m_timings = {};
+    u64 frame_start{constants::u64_max};
+    u64 frame_end{0};
+    for (u32 scope = 0; scope < GPU_SCOPE_COUNT; ++scope) {
+        if (!is_available(scope)) {
+            continue;
+        }
+        const u64 begin{results[scope * 4] & m_timestamp_mask};
+        const u64 end{results[scope * 4 + 2] & m_timestamp_mask};
+        m_timings.scope_times[scope] = static_cast<f32>(ticks_to_microseconds(end - begin).count() / 1000.0);
+        frame_start = std::min(frame_start, begin);
+        frame_end = std::max(frame_end, end);
+    }
+
+    if (frame_start == constants::u64_max) {
+        return;
+    }
+    m_timings.frame_time = static_cast<f32>(ticks_to_microseconds(frame_end - frame_start).count() / 1000.0);
+
+    // GPU ticks share no epoch with the CPU clock, the frame's first scope is placed at its submission
+    for (u32 scope = 0; scope < GPU_SCOPE_COUNT; ++scope) {
+        if (!is_available(scope)) {
+            continue;
+        }
+        const u64 begin{results[scope * 4] & m_timestamp_mask};
+        const FloatingPointMicroseconds start{m_submit_times[frame_index] + ticks_to_microseconds(begin - frame_start)};
+        const FloatingPointMicroseconds elapsed{ticks_to_microseconds(results[scope * 4 + 2] - results[scope * 4])};
+        ENGINE_PROFILE_GPU_EVENT(GetScopeName(static_cast<GpuScope>(scope)), start,
+                                 std::chrono::round<Microseconds>(elapsed));
+    }
+}
+
+void GpuTimer::RecordReset(VkCommandBuffer command_buffer, const u32 frame_index)
+{
+    if (!IsSupported()) {
+        return;
+    }
+    vkCmdResetQueryPool(command_buffer, p_query_pool, GetQuery(frame_index, GpuScope::Compute), QUERIES_PER_FRAME);
+}
+
+void GpuTimer::RecordBegin(VkCommandBuffer command_buffer, const u32 frame_index, const GpuScope scope) const
+{
+    if (!IsSupported()) {
+        return;
+    }
+    vkCmdWriteTimestamp(command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, p_query_pool, GetQuery(frame_index, scope));
+}
+
+void GpuTimer::RecordEnd(VkCommandBuffer command_buffer, const u32 frame_index, const GpuScope scope) const
+{
+    if (!IsSupported()) {
+        return;
+    }
+    vkCmdWriteTimestamp(command_buffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, p_query_pool,
+                        GetQuery(frame_index, scope) + 1);
+}
+
+void GpuTimer::MarkSubmitted(const u32 frame_index)
+{
+    if (!IsSupported()) {
+        return;
+    }
+    m_submit_times[frame_index] = FloatingPointMicroseconds{SteadyClock::now().time_since_epoch()};
+    m_has_results[frame_index] = true;
+}
+
+StringView GpuTimer::GetScopeName(const GpuScope scope)
+{
+    switch (scope) {
+        case GpuScope::Compute:
+            return "GPU compute";
+        case GpuScope::StaticQuads:
+            return "GPU static quads";
+        case GpuScope::Quads:
+            return "GPU quads";
+        case GpuScope::Particles:
+            return "GPU particles";
+        case GpuScope::ImGui:
+            return "GPU ImGui";
+        case GpuScope::Upscale:
+            return "GPU upscale";
+    }
+    return "GPU unknown";
+}
+
+} // namespace gouda::vk
@@ -6,6 +6,11 @@
  */
 #include "renderers/vulkan/vk_graphics_pipeline.hpp"
 
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <optional>
+#include <unordered_map>
 #include <unordered_set>
 
 #include <GLFW/glfw3.h>
@@ -15,11 +20,15 @@
 #include "debug/debug.hpp"
 #include "math/math.hpp"
 #include "renderers/vulkan/vk_buffer.hpp"
+#include "renderers/vulkan/vk_descriptor_allocator.hpp"
 #include "renderers/vulkan/vk_device.hpp"
+#include "renderers/vulkan/vk_layout_cache.hpp"
+#include "renderers/vulkan/vk_pipeline_library.hpp"
 #include "renderers/vulkan/vk_renderer.hpp"
 #include "renderers/vulkan/vk_shader.hpp"
 #include "renderers/vulkan/vk_texture.hpp"
 #include "renderers/vulkan/vk_utils.hpp"
+#include "utils/hash.hpp"
 
 namespace gouda::vk {
 
@@ -35,24 +44,6 @@ u32 get_struct_offset(StringView name, const VkFormat format, bool &success)
         if (name == "uv" && format == VK_FORMAT_R32G32_SFLOAT)
             return offsetof(Vertex, uv);
     }
-    else if constexpr (std::is_same_v<T, InstanceData>) {
-        if (name == "instance_position" && format == VK_FORMAT_R32G32B32_SFLOAT)
-            return offsetof(InstanceData, position);
-        if (name == "instance_size" && format == VK_FORMAT_R32G32_SFLOAT)
-            return offsetof(InstanceData, size);
-        if (name == "instance_rotation" && format == VK_FORMAT_R32_SFLOAT)
-            return offsetof(InstanceData, rotation);
-        if (name == "instance_texture_index" && format == VK_FORMAT_R32_UINT)
-            return offsetof(InstanceData, texture_index);
-        if (name == "instance_colour" && format == VK_FORMAT_R32G32B32A32_SFLOAT)
-            return offsetof(InstanceData, colour);
-        if (name == "instance_sprite_rect" && format == VK_FORMAT_R32G32B32A32_SFLOAT)
-            return offsetof(InstanceData, sprite_rect);
-        if (name == "instance_is_atlas" && format == VK_FORMAT_R32_UINT)
-            return offsetof(InstanceData, is_atlas);
-        if (name == "instance_apply_camera_effects" && format == VK_FORMAT_R32_UINT)
-            return offsetof(InstanceData, apply_camera_effects);
-    }
     else if constexpr (std::is_same_v<T, ParticleData>) {
         if (name == "instance_position" && format == VK_FORMAT_R32G32B32_SFLOAT)
             return offsetof(ParticleData, position);
@@ -73,29 +64,88 @@ u32 get_struct_offset(StringView name, const VkFormat format, bool &success)
         if (name == "instance_apply_camera_effects" && format == VK_FORMAT_R32_UINT)
             return offsetof(ParticleData, apply_camera_effects);
     }
-    else if constexpr (std::is_same_v<T, TextData>) {
-        if (name == "instance_position" && format == VK_FORMAT_R32G32B32_SFLOAT)
-            return offsetof(TextData, position);
-        if (name == "instance_size" && format == VK_FORMAT_R32G32_SFLOAT)
-            return offsetof(TextData, size);
-        if (name == "instance_colour" && format == VK_FORMAT_R32G32B32A32_SFLOAT)
-            return offsetof(TextData, colour);
-        if (name == "instance_glyph_index" && format == VK_FORMAT_R32_UINT)
-            return offsetof(TextData, glyph_index);
-        if (name == "instance_sdf_params" && format == VK_FORMAT_R32G32B32A32_SFLOAT)
-            return offsetof(TextData, sdf_params);
-        if (name == "instance_texture_index" && format == VK_FORMAT_R32_UINT)
-            return offsetof(TextData, texture_index);
-        if (name == "instance_atlas_size" && format == VK_FORMAT_R32G32_SFLOAT)
-            return offsetof(TextData, atlas_size);
-        if (name == "instance_px_range" && format == VK_FORMAT_R32_SFLOAT)
-            return offsetof(TextData, px_range);
-        if (name == "instance_apply_camera_effects" && format == VK_FORMAT_R32_UINT)
-            return offsetof(TextData, apply_camera_effects);
+    success = false;
+    return 0;
+}
+
+// Quad instances are packed, their attributes are read in narrower formats than the shader types they unpack to
+static u32 get_quad_instance_offset(StringView name, VkFormat &format, bool &success)
+{
+    success = true;
+    if (name == "instance_position" && format == VK_FORMAT_R32G32B32_SFLOAT)
+        return offsetof(QuadInstance, position);
+    if (name == "instance_size" && format == VK_FORMAT_R32G32_SFLOAT) {
+        format = VK_FORMAT_R16G16_SFLOAT;
+        return offsetof(QuadInstance, size);
+    }
+    if (name == "instance_rotation" && format == VK_FORMAT_R32_SFLOAT) {
+        format = VK_FORMAT_R16_SFLOAT;
+        return offsetof(QuadInstance, rotation);
+    }
+    if (name == "instance_texture_flags" && format == VK_FORMAT_R32_UINT) {
+        format = VK_FORMAT_R16_UINT;
+        return offsetof(QuadInstance, texture_flags);
+    }
+    if (name == "instance_colour" && format == VK_FORMAT_R32G32B32A32_SFLOAT) {
+        format = VK_FORMAT_R8G8B8A8_UNORM;
+        return offsetof(QuadInstance, colour);
+    }
+    if (name == "instance_sprite_rect" && format == VK_FORMAT_R32G32B32A32_SFLOAT) {
+        format = VK_FORMAT_R16G16B16A16_UNORM;
+        return offsetof(QuadInstance, sprite_rect);
     }
     success = false;
     return 0;
 }
+
+// Texture arrays are bindless: slots may stay unwritten and new slots can be written while frames are in flight
+static constexpr VkDescriptorBindingFlags bindless_binding_flags{VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
+                                                                 VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+                                                                 VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT};
+
+static bool is_bindless(const ShaderDescriptorBinding &binding)
+{
+    return binding.type == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+}
+
+static constexpr bool is_quad_pipeline(const PipelineType type)
+{
+    return type == PipelineType::Quad || type == PipelineType::QuadAlphaTest || type == PipelineType::QuadTransparent;
+}
+
+// Int constants a pipeline type sets over the shader's default, matched by name
+// Constants a pipeline type always sets, the shaders' defaults are what the other types use
+static void add_type_constants(const PipelineType type, SpecializationConstants &constants)
+{
+    if (type == PipelineType::QuadAlphaTest && !constants.Find("alpha_test")) {
+        constants.Set("alpha_test", 1);
+    }
+}
+
+// Folds values into a pipeline library part key, only for types without padding bytes
+template <typename T>
+    requires std::has_unique_object_representations_v<T>
+static u64 hash_library_key(const std::span<const T> values, const u64 seed)
+{
+    return utils::fnv1a(std::as_bytes(values), utils::mix64(seed ^ values.size()));
+}
+
+template <typename T>
+    requires std::has_unique_object_representations_v<T>
+static u64 hash_library_key(const T &value, const u64 seed)
+{
+    return hash_library_key(std::span<const T>{&value, 1}, seed);
+}
+
+// The attachments and view mask, what the parts that take the rendering info are compiled against
+static u64 hash_rendering_info(const VkPipelineRenderingCreateInfo &rendering_info)
+{
+    const std::array<u32, 4> values{rendering_info.viewMask, static_cast<u32>(rendering_info.depthAttachmentFormat),
+                                    static_cast<u32>(rendering_info.stencilAttachmentFormat),
+                                    rendering_info.colorAttachmentCount};
+    return hash_library_key(std::span{rendering_info.pColorAttachmentFormats, rendering_info.colorAttachmentCount},
+                            hash_library_key(std::span<const u32>{values}, 0));
+}
 } // namespace internal
 
 static constexpr std::string_view pipeline_type_to_string(const PipelineType type)
@@ -103,52 +153,94 @@ static constexpr std::string_view pipeline_type_to_string(const PipelineType typ
     switch (type) {
         case PipelineType::Quad:
             return "Quad/Sprite";
-        case PipelineType::Text:
-            return "Text";
+        case PipelineType::QuadAlphaTest:
+            return "Quad/Sprite (alpha test)";
+        case PipelineType::QuadTransparent:
+            return "Quad/Sprite (transparent)";
         case PipelineType::Particle:
             return "Particle";
+        case PipelineType::Upscale:
+            return "Upscale";
         default:
             return "Unknown graphics pipeline type! How did we get here?";
     }
 }
 
+// SpecializationConstants implementation ----------------------------------------------------------
+SpecializationConstants &SpecializationConstants::Set(const StringView name, const s32 value)
+{
+    const auto it{std::ranges::lower_bound(m_values, name, {}, [](const Value &entry) -> StringView {
+        return entry.name;
+    })};
+    if (it != m_values.end() && it->name == name) {
+        it->value = value;
+    }
+    else {
+        m_values.insert(it, Value{String{name}, value});
+    }
+    return *this;
+}
+
+std::optional<s32> SpecializationConstants::Find(const StringView name) const
+{
+    const auto it{std::ranges::lower_bound(m_values, name, {}, [](const Value &entry) -> StringView {
+        return entry.name;
+    })};
+    if (it != m_values.end() && it->name == name) {
+        return it->value;
+    }
+    return std::nullopt;
+}
+
+bool SpecializationConstants::operator==(const SpecializationConstants &other) const
+{
+    return std::ranges::equal(m_values, other.m_values, [](const Value &a, const Value &b) {
+        return a.value == b.value && a.name == b.name;
+    });
+}
+
 // GraphicsPipeline implementation -----------------------------------------------------------------
-GraphicsPipeline::GraphicsPipeline(Renderer &renderer, VkRenderPass p_render_pass,
+GraphicsPipeline::GraphicsPipeline(Renderer &renderer, const VkPipelineRenderingCreateInfo &rendering_info,
                                    Shader *vertex_shader, Shader *fragment_shader, int number_of_images,
-                                   Vector<Buffer> &uniform_buffers, int uniform_data_size, PipelineType type)
+                                   PipelineType type, const bool write_texture_descriptors,
+                                   const SpecializationConstants &constants)
     : m_renderer{renderer},
       p_device{renderer.GetDevice()},
       p_pipeline{VK_NULL_HANDLE},
       p_pipeline_layout{VK_NULL_HANDLE},
-      p_descriptor_pool{VK_NULL_HANDLE},
+      p_descriptor_allocator{&renderer.GetDescriptorAllocator()},
       m_type{type},
+      m_constants{constants},
+      m_vertex_specialization{},
+      m_fragment_specialization{},
+      m_max_textures{renderer.GetMaxTextures()},
       p_vertex_shader{vertex_shader},
       p_fragment_shader{fragment_shader}
 {
     ASSERT(vertex_shader, "Vertex shader is a null pointer");
     ASSERT(fragment_shader, "Fragment shader is a null pointer");
 
-    CreateDescriptorSets(number_of_images, uniform_buffers, uniform_data_size);
+    internal::add_type_constants(type, m_constants);
+    CreateDescriptorSets(number_of_images, write_texture_descriptors);
 
     auto shader_stages = SetupShaderStages();
     auto vertex_input = SetupVertexInput();
     auto pipeline_states = SetupPipelineStates();
-    auto push_constants = SetupPushConstants();
+    m_push_constant_ranges = SetupPushConstants();
 
-    VkPipelineLayoutCreateInfo layout_info{
-        .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
-        .setLayoutCount = static_cast<u32>(m_descriptor_set_layouts.size()),
-        .pSetLayouts = m_descriptor_set_layouts.empty() ? nullptr : m_descriptor_set_layouts.data(),
-        .pushConstantRangeCount = static_cast<u32>(push_constants.size()),
-        .pPushConstantRanges = push_constants.empty() ? nullptr : push_constants.data()};
+    // Shared with every pipeline reflecting the same bindings and push constants, the cache owns it
+    p_pipeline_layout = m_renderer.GetLayoutCache().GetPipelineLayout(m_descriptor_set_layouts, m_push_constant_ranges);
 
-    VkResult result{vkCreatePipelineLayout(p_device, &layout_info, nullptr, &p_pipeline_layout)};
-    if (result != VK_SUCCESS) {
-        ENGINE_LOG_ERROR("Failed to create graphics pipeline layout. Error code: {}", vk_result_to_string(result));
-        CHECK_VK_RESULT(result, "vkCreatePipelineLayout");
+    if (PipelineLibraryCache *libraries{m_renderer.GetPipelineLibraries()}) {
+        p_pipeline = CreateLinkedPipeline(*libraries, rendering_info, shader_stages, vertex_input, pipeline_states);
+        if (p_pipeline != VK_NULL_HANDLE) {
+            ENGINE_LOG_DEBUG("Graphics pipeline linked for type: {}", pipeline_type_to_string(type));
+            return;
+        }
     }
 
     VkGraphicsPipelineCreateInfo pipeline_info{.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+                                               .pNext = &rendering_info,
                                                .stageCount = static_cast<u32>(shader_stages.size()),
                                                .pStages = shader_stages.data(),
                                                .pVertexInputState = &vertex_input,
@@ -160,10 +252,11 @@ GraphicsPipeline::GraphicsPipeline(Renderer &renderer, VkRenderPass p_render_pas
                                                .pColorBlendState = &pipeline_states.color_blend,
                                                .pDynamicState = &pipeline_states.dynamic,
                                                .layout = p_pipeline_layout,
-                                               .renderPass = p_render_pass,
+                                               .renderPass = VK_NULL_HANDLE,
                                                .subpass = 0};
 
-    result = vkCreateGraphicsPipelines(p_device, VK_NULL_HANDLE, 1, &pipeline_info, nullptr, &p_pipeline);
+    const VkResult result{vkCreateGraphicsPipelines(p_device, m_renderer.GetPipelineCache(), 1, &pipeline_info,
+                                                    nullptr, &p_pipeline)};
     if (result != VK_SUCCESS) {
         ENGINE_LOG_ERROR("Failed to create graphics pipeline. Error code: {}", vk_result_to_string(result));
         CHECK_VK_RESULT(result, "vkCreateGraphicsPipelines");
@@ -175,9 +268,23 @@ GraphicsPipeline::GraphicsPipeline(Renderer &renderer, VkRenderPass p_render_pas
 
 GraphicsPipeline::~GraphicsPipeline() { Destroy(); }
 
-void GraphicsPipeline::Bind(VkCommandBuffer command_buffer_ptr, const size_t image_index) const
+void GraphicsPipeline::Bind(VkCommandBuffer command_buffer_ptr, const size_t image_index,
+                            BoundDescriptorSets *bound) const
 {
     vkCmdBindPipeline(command_buffer_ptr, VK_PIPELINE_BIND_POINT_GRAPHICS, p_pipeline);
+
+    // Sets bound under an identical layout stay bound across the pipeline switch
+    if (bound != nullptr) {
+        if (bound->layout == p_pipeline_layout && bound->vertex_shader == p_vertex_shader &&
+            bound->fragment_shader == p_fragment_shader && bound->image_index == image_index) {
+            return;
+        }
+        *bound = {.layout = p_pipeline_layout,
+                  .vertex_shader = p_vertex_shader,
+                  .fragment_shader = p_fragment_shader,
+                  .image_index = image_index};
+    }
+
     if (!m_descriptor_sets.empty()) {
         Vector<VkDescriptorSet> sets;
         for (const auto &set : m_descriptor_sets) {
@@ -192,29 +299,41 @@ void GraphicsPipeline::Bind(VkCommandBuffer command_buffer_ptr, const size_t ima
     }
 }
 
-void GraphicsPipeline::Destroy()
+void GraphicsPipeline::PushConstants(VkCommandBuffer command_buffer_ptr, const void *data, const u32 size) const
 {
-    for (auto &layout : m_descriptor_set_layouts) {
-        if (layout != VK_NULL_HANDLE) {
-            vkDestroyDescriptorSetLayout(p_device, layout, nullptr);
-            layout = VK_NULL_HANDLE;
+    // Every stage that declared the block from offset 0 gets it, the engine's shaders all share the camera block
+    VkShaderStageFlags stage_flags{0};
+    for (const auto &range : m_push_constant_ranges) {
+        if (range.offset == 0 && range.size >= size) {
+            stage_flags |= range.stageFlags;
         }
     }
-    m_descriptor_set_layouts.clear();
-    if (p_pipeline_layout != VK_NULL_HANDLE) {
-        vkDestroyPipelineLayout(p_device, p_pipeline_layout, nullptr);
-        p_pipeline_layout = VK_NULL_HANDLE;
+    if (stage_flags != 0) {
+        vkCmdPushConstants(command_buffer_ptr, p_pipeline_layout, stage_flags, 0, size, data);
     }
-    if (p_descriptor_pool != VK_NULL_HANDLE) {
-        vkDestroyDescriptorPool(p_device, p_descriptor_pool, nullptr);
-        p_descriptor_pool = VK_NULL_HANDLE;
+}
+
+void GraphicsPipeline::Destroy()
+{
+    // Sets go back to the shared pools
+    for (size_t set = 0; set < m_descriptor_sets.size(); ++set) {
+        if (!m_descriptor_sets[set].empty()) {
+            p_descriptor_allocator->Free(m_descriptor_pools[set], m_descriptor_sets[set]);
+        }
     }
+    m_descriptor_sets.clear();
+    m_descriptor_pools.clear();
+
+    // The layouts belong to the renderer's layout cache, other pipelines may share them
+    m_descriptor_set_layouts.clear();
+    p_pipeline_layout = VK_NULL_HANDLE;
     if (p_pipeline != VK_NULL_HANDLE) {
         vkDestroyPipeline(p_device, p_pipeline, nullptr);
         p_pipeline = VK_NULL_HANDLE;
     }
 
     m_descriptor_sets.clear();
+    m_push_constant_ranges.clear();
     m_binding_descriptions.clear();
     m_attribute_descriptions.clear();
 
@@ -224,209 +343,130 @@ void GraphicsPipeline::Destroy()
 void GraphicsPipeline::UpdateTextureDescriptors(const size_t number_of_images,
                                                 const Vector<std::unique_ptr<Texture>> &textures)
 {
-    ASSERT(!textures.empty(), "Texture vector must contain at least the default texture");
-    const Texture *default_texture{textures[0].get()};
-    if (textures.size() > MAX_TEXTURES) {
-        ENGINE_LOG_WARNING("Texture count ({}) exceeds MAX_TEXTURES ({}); capping at MAX_TEXTURES", textures.size(),
-                           MAX_TEXTURES);
-    }
+    Vector<u32> texture_ids(textures.size());
+    std::iota(texture_ids.begin(), texture_ids.end(), 0u);
+    UpdateTextureDescriptors(number_of_images, textures, texture_ids);
+}
 
-    Vector<VkDescriptorImageInfo> image_infos{MAX_TEXTURES};
-    for (size_t i = 0; i < MAX_TEXTURES; ++i) {
-        const Texture *texture{i < textures.size() ? textures[i].get() : default_texture};
-        image_infos[i] = {.sampler = texture->p_sampler,
-                          .imageView = texture->p_view,
-                          .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+void GraphicsPipeline::UpdateTextureDescriptors(const size_t number_of_images,
+                                                const Vector<std::unique_ptr<Texture>> &textures,
+                                                const std::span<const u32> texture_ids)
+{
+    ASSERT(!textures.empty(), "Texture vector must contain at least the default texture");
+    if (!internal::is_quad_pipeline(m_type) && m_type != PipelineType::Particle) {
+        return;
     }
 
-    Vector<VkWriteDescriptorSet> write_descriptor_sets;
-    write_descriptor_sets.reserve(m_descriptor_sets.size() * number_of_images);
-
-    for (u32 set = 0; set < m_descriptor_sets.size(); ++set) {
-        if (m_descriptor_sets[set].empty()) {
-            continue;
-        }
-        bool binding_exists{false};
-        for (const auto &binding : p_fragment_shader->Reflection().descriptor_bindings) {
-            if (binding.set == set && binding.type == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER &&
-                binding.binding == 3) {
-                binding_exists = true;
-                ENGINE_LOG_DEBUG("Found texture binding: set={}, binding=3, count={}", set, binding.count);
-                break;
-            }
-        }
-        if (!binding_exists) {
-            continue;
-        }
+    WriteImageDescriptors(0, number_of_images, 3, textures, texture_ids);
+}
 
-        for (int i = 0; i < number_of_images; ++i) {
-            if (m_type != PipelineType::Quad && m_type != PipelineType::Particle) {
-                continue;
-            }
-            for (const auto &binding : p_fragment_shader->Reflection().descriptor_bindings) {
-                if (binding.set != set || binding.type != VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER ||
-                    binding.binding != 3) {
-                    continue;
-                }
-                VkWriteDescriptorSet write_descriptor_set{.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-                                                          .dstSet = m_descriptor_sets[set][i],
-                                                          .dstBinding = binding.binding,
-                                                          .dstArrayElement = 0,
-                                                          .descriptorCount = binding.count,
-                                                          .descriptorType = binding.type,
-                                                          .pImageInfo = image_infos.data()};
-                if (binding.count > MAX_TEXTURES) {
-                    ENGINE_LOG_WARNING(
-                        "Texture descriptor set {}, binding {} requests {} samplers, but MAX_TEXTURES is {}",
-                        binding.set, binding.binding, binding.count, MAX_TEXTURES);
-                    write_descriptor_set.descriptorCount = MAX_TEXTURES;
-                }
-                write_descriptor_sets.push_back(write_descriptor_set);
-            }
-        }
+void GraphicsPipeline::UpdateFrameTextureDescriptors(const size_t image_index,
+                                                     const Vector<std::unique_ptr<Texture>> &textures,
+                                                     const std::span<const u32> texture_ids)
+{
+    ASSERT(!textures.empty(), "Texture vector must contain at least the default texture");
+    if (!internal::is_quad_pipeline(m_type) && m_type != PipelineType::Particle) {
+        return;
     }
 
-    if (!write_descriptor_sets.empty()) {
-        vkUpdateDescriptorSets(p_device, static_cast<u32>(write_descriptor_sets.size()), write_descriptor_sets.data(),
-                               0, nullptr);
-        ENGINE_LOG_DEBUG("Updated {} texture descriptor writes for pipeline type: {}", write_descriptor_sets.size(),
-                         pipeline_type_to_string(m_type));
-    }
-    else {
-        ENGINE_LOG_WARNING(
-            "No texture descriptor writes generated for pipeline type: {}. Expected binding=3 in fragment shader.",
-            pipeline_type_to_string(m_type));
-    }
+    WriteImageDescriptors(image_index, 1, 3, textures, texture_ids);
 }
 
-void GraphicsPipeline::UpdateFontTextureDescriptors(const size_t number_of_images,
-                                                    const Vector<std::unique_ptr<Texture>> &font_textures)
+void GraphicsPipeline::UpdateTextureArrayDescriptors(const size_t number_of_images,
+                                                     const Vector<std::unique_ptr<Texture>> &texture_arrays,
+                                                     const std::span<const u32> array_ids)
 {
-    ASSERT(!font_textures.empty(), "Font texture vector must contain at least the default font texture");
-    const Texture *default_texture{(font_textures[0].get())};
-    if (font_textures.size() > MAX_TEXTURES) {
-        ENGINE_LOG_WARNING("Font texture count ({}) exceeds MAX_TEXTURES ({}); capping at MAX_TEXTURES",
-                           font_textures.size(), MAX_TEXTURES);
+    if (!internal::is_quad_pipeline(m_type)) {
+        return;
     }
 
-    Vector<VkDescriptorImageInfo> image_infos{MAX_TEXTURES};
-    for (size_t i = 0; i < MAX_TEXTURES; ++i) {
-        const Texture *texture{i < font_textures.size() ? font_textures[i].get() : default_texture};
-        image_infos[i] = {.sampler = texture->p_sampler,
-                          .imageView = texture->p_view,
-                          .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
-    }
+    WriteImageDescriptors(0, number_of_images, 9, texture_arrays, array_ids);
+}
 
-    Vector<VkWriteDescriptorSet> write_descriptor_sets;
-    write_descriptor_sets.reserve(m_descriptor_sets.size() * number_of_images);
+void GraphicsPipeline::UpdateBufferDescriptors(const size_t number_of_images, const u32 binding_index,
+                                               const VkDescriptorType type, const std::span<const Buffer> buffers,
+                                               const VkDeviceSize range)
+{
+    ASSERT(buffers.size() == 1 || buffers.size() >= number_of_images,
+           "Buffer descriptors need one shared buffer or one buffer per descriptor set.");
 
-    for (u32 set = 0; set < m_descriptor_sets.size(); ++set) {
-        if (m_descriptor_sets[set].empty()) {
-            continue;
-        }
-        bool binding_exists{false};
-        for (const auto &binding : p_fragment_shader->Reflection().descriptor_bindings) {
-            if (binding.set == set && binding.type == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER &&
-                binding.binding == 4) {
-                binding_exists = true;
-                ENGINE_LOG_DEBUG("Found font texture binding: set={}, binding=4, count={}", set, binding.count);
+    const ShaderDescriptorBinding *buffer_binding{nullptr};
+    for (const auto &shader : {p_vertex_shader, p_fragment_shader}) {
+        for (const auto &binding : shader->Reflection().descriptor_bindings) {
+            if (binding.type == type && binding.binding == binding_index && binding.set < m_descriptor_sets.size() &&
+                !m_descriptor_sets[binding.set].empty()) {
+                buffer_binding = &binding;
                 break;
             }
         }
-        if (!binding_exists) {
-            continue;
-        }
-
-        for (int i = 0; i < number_of_images; ++i) {
-            if (m_type != PipelineType::Text) {
-                continue;
-            }
-            for (const auto &binding : p_fragment_shader->Reflection().descriptor_bindings) {
-                if (binding.set != set || binding.type != VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER ||
-                    binding.binding != 4) {
-                    continue;
-                }
-                VkWriteDescriptorSet write_descriptor_set{.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-                                                          .dstSet = m_descriptor_sets[set][i],
-                                                          .dstBinding = binding.binding,
-                                                          .dstArrayElement = 0,
-                                                          .descriptorCount = binding.count,
-                                                          .descriptorType = binding.type,
-                                                          .pImageInfo = image_infos.data()};
-                if (binding.count > MAX_TEXTURES) {
-                    ENGINE_LOG_WARNING(
-                        "Font descriptor set {}, binding {} requests {} samplers, but MAX_TEXTURES is {}", binding.set,
-                        binding.binding, binding.count, MAX_TEXTURES);
-                    write_descriptor_set.descriptorCount = MAX_TEXTURES;
-                }
-                write_descriptor_sets.push_back(write_descriptor_set);
-            }
+        if (buffer_binding != nullptr) {
+            break;
         }
     }
-
-    if (!write_descriptor_sets.empty()) {
-        vkUpdateDescriptorSets(p_device, static_cast<u32>(write_descriptor_sets.size()), write_descriptor_sets.data(),
-                               0, nullptr);
-        ENGINE_LOG_DEBUG("Updated {} font texture descriptor writes for pipeline type: {}",
-                         write_descriptor_sets.size(), pipeline_type_to_string(m_type));
-    }
-    else {
-        ENGINE_LOG_WARNING(
-            "No font texture descriptor writes generated for pipeline type: {}. Expected binding=4 in fragment shader.",
-            pipeline_type_to_string(m_type));
-    }
+    if (buffer_binding == nullptr) {
+        return;
+    }
+
+    Vector<VkDescriptorBufferInfo> buffer_infos(number_of_images);
+    Vector<VkWriteDescriptorSet> write_descriptor_sets(number_of_images);
+    for (size_t i = 0; i < number_of_images; ++i) {
+        buffer_infos[i] = {.buffer = buffers[buffers.size() == 1 ? 0 : i].p_buffer, .offset = 0, .range = range};
+        write_descriptor_sets[i] = {.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                                    .dstSet = m_descriptor_sets[buffer_binding->set][i],
+                                    .dstBinding = buffer_binding->binding,
+                                    .dstArrayElement = 0,
+                                    .descriptorCount = 1,
+                                    .descriptorType = type,
+                                    .pBufferInfo = &buffer_infos[i]};
+    }
+    vkUpdateDescriptorSets(p_device, static_cast<u32>(write_descriptor_sets.size()), write_descriptor_sets.data(), 0,
+                           nullptr);
+    ENGINE_PROFILE_COUNT(DESCRIPTOR_WRITES_COUNTER, write_descriptor_sets.size());
+    ENGINE_LOG_DEBUG("Updated {} buffer descriptor writes at binding {} for pipeline type: {}",
+                     write_descriptor_sets.size(), binding_index, pipeline_type_to_string(m_type));
 }
 
-// Private functions ---------------------------------------------------------------
-void GraphicsPipeline::CreateDescriptorPool(const int number_of_images)
+void GraphicsPipeline::UpdateImageDescriptor(const size_t image_index, const u32 binding_index, VkImageView view,
+                                             VkSampler sampler)
 {
-    std::unordered_map<VkDescriptorType, u32> pool_size_counts;
-    for (const auto &shader : {p_vertex_shader, p_fragment_shader}) {
-        for (const auto &binding : shader->Reflection().descriptor_bindings) {
-            pool_size_counts[binding.type] += binding.count * number_of_images;
-        }
-    }
-
-    Vector<VkDescriptorPoolSize> pool_sizes;
-    for (const auto &[type, count] : pool_size_counts) {
-        pool_sizes.push_back({.type = type, .descriptorCount = count});
-    }
-    if (pool_sizes.empty()) {
-        ENGINE_LOG_WARNING("No descriptor bindings found; creating minimal descriptor pool");
-        pool_sizes.push_back({.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, .descriptorCount = 1});
-    }
-
-    u32 max_set{0};
-    for (const auto &shader : {p_vertex_shader, p_fragment_shader}) {
-        for (const auto &binding : shader->Reflection().descriptor_bindings) {
-            max_set = math::max(max_set, binding.set);
+    const ShaderDescriptorBinding *image_binding{nullptr};
+    for (const auto &binding : p_fragment_shader->Reflection().descriptor_bindings) {
+        if (binding.type == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER && binding.binding == binding_index &&
+            binding.set < m_descriptor_sets.size() && image_index < m_descriptor_sets[binding.set].size()) {
+            image_binding = &binding;
+            break;
         }
     }
-    u32 total_sets{(max_set + 1) * number_of_images};
-
-    const VkDescriptorPoolCreateInfo pool_info{.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
-                                         .maxSets = total_sets,
-                                         .poolSizeCount = static_cast<u32>(pool_sizes.size()),
-                                         .pPoolSizes = pool_sizes.data()};
-
-    if (const VkResult result{vkCreateDescriptorPool(p_device, &pool_info, nullptr, &p_descriptor_pool)};
-        result != VK_SUCCESS) {
-        ENGINE_LOG_ERROR("Failed to create descriptor pool. Error: {}", vk_result_to_string(result));
-        CHECK_VK_RESULT(result, "vkCreateDescriptorPool");
-    }
-
-    ENGINE_LOG_DEBUG("Created descriptor pool with {} sets and {} pool sizes", total_sets, pool_sizes.size());
+    if (image_binding == nullptr) {
+        return;
+    }
+
+    const VkDescriptorImageInfo image_info{
+        .sampler = sampler, .imageView = view, .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+    const VkWriteDescriptorSet write_descriptor_set{.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                                                    .dstSet = m_descriptor_sets[image_binding->set][image_index],
+                                                    .dstBinding = image_binding->binding,
+                                                    .dstArrayElement = 0,
+                                                    .descriptorCount = 1,
+                                                    .descriptorType = image_binding->type,
+                                                    .pImageInfo = &image_info};
+    vkUpdateDescriptorSets(p_device, 1, &write_descriptor_set, 0, nullptr);
+    ENGINE_PROFILE_COUNT(DESCRIPTOR_WRITES_COUNTER, 1);
 }
 
-void GraphicsPipeline::CreateDescriptorSets(const int number_of_images, const Vector<Buffer> &uniform_buffers,
-                                            const int uniform_data_size)
+// Private functions ---------------------------------------------------------------
+void GraphicsPipeline::CreateDescriptorSets(const int number_of_images, const bool write_texture_descriptors)
 {
-    CreateDescriptorPool(number_of_images);
     CreateDescriptorSetLayout();
     AllocateDescriptorSets(number_of_images);
-    UpdateDescriptorSets(number_of_images, uniform_buffers, uniform_data_size);
-    UpdateTextureDescriptors(number_of_images, m_renderer.GetTextures());
-    UpdateFontTextureDescriptors(number_of_images, m_renderer.GetFontTextures());
+    if (write_texture_descriptors) {
+        UpdateTextureDescriptors(number_of_images, m_renderer.GetTextures());
+
+        const Vector<std::unique_ptr<Texture>> &texture_arrays{m_renderer.GetTextureArrays()};
+        Vector<u32> array_ids(texture_arrays.size());
+        std::iota(array_ids.begin(), array_ids.end(), 0u);
+        UpdateTextureArrayDescriptors(number_of_images, texture_arrays, array_ids);
+    }
 }
 
 void GraphicsPipeline::CreateDescriptorSetLayout()
@@ -439,174 +479,183 @@ void GraphicsPipeline::CreateDescriptorSetLayout()
     }
     m_descriptor_set_layouts.resize(max_set + 1, VK_NULL_HANDLE);
 
+    LayoutCache &layout_cache{m_renderer.GetLayoutCache()};
     for (u32 set = 0; set <= max_set; ++set) {
-        Vector<VkDescriptorSetLayoutBinding> layout_bindings;
-        std::unordered_set<u32> seen_bindings;
+        SmallVector<DescriptorLayoutBinding, 8> layout_bindings;
         for (const auto &shader : {p_vertex_shader, p_fragment_shader}) {
             for (const auto &binding : shader->Reflection().descriptor_bindings) {
                 if (binding.set != set) {
                     continue;
                 }
-                if (!seen_bindings.insert(binding.binding).second) {
+                if (std::ranges::find(layout_bindings, binding.binding, &DescriptorLayoutBinding::binding) !=
+                    layout_bindings.end()) {
                     ENGINE_LOG_WARNING("Duplicate descriptor binding {} in set {} in shader stage {}", binding.binding,
                                        set, vk_shader_stage_as_string_view(shader->Stage()));
                     continue;
                 }
-                VkDescriptorSetLayoutBinding layout_binding{.binding = binding.binding,
-                                                            .descriptorType = binding.type,
-                                                            .descriptorCount = binding.count,
-                                                            .stageFlags = binding.stage_flags,
-                                                            .pImmutableSamplers = nullptr};
-                layout_bindings.push_back(layout_binding);
+                layout_bindings.push_back(
+                    {.binding = binding.binding,
+                     .type = binding.type,
+                     .count = GetDescriptorCount(binding),
+                     .stage_flags = binding.stage_flags,
+                     .flags = internal::is_bindless(binding) ? internal::bindless_binding_flags : 0});
             }
         }
 
-        VkDescriptorSetLayoutCreateInfo layout_info{.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
-                                                    .bindingCount = static_cast<u32>(layout_bindings.size()),
-                                                    .pBindings =
-                                                        layout_bindings.empty() ? nullptr : layout_bindings.data()};
-        if (const VkResult result{
-                vkCreateDescriptorSetLayout(p_device, &layout_info, nullptr, &m_descriptor_set_layouts[set])};
-            result != VK_SUCCESS) {
-            ENGINE_LOG_ERROR("Failed to create descriptor set layout for set {}. Error: {}", set,
-                             vk_result_to_string(result));
-            CHECK_VK_RESULT(result, "vkCreateDescriptorSetLayout");
-        }
-        ENGINE_LOG_DEBUG("Created descriptor set layout for set {} with {} bindings", set, layout_bindings.size());
+        // Sorted, the same bindings declared in another order or split differently between the stages match
+        std::ranges::sort(layout_bindings, {}, &DescriptorLayoutBinding::binding);
+        m_descriptor_set_layouts[set] = layout_cache.GetSetLayout(layout_bindings);
+        ENGINE_LOG_DEBUG("Descriptor set layout for set {} with {} bindings", set, layout_bindings.size());
     }
 }
 
 void GraphicsPipeline::AllocateDescriptorSets(const int number_of_images)
 {
     m_descriptor_sets.resize(m_descriptor_set_layouts.size());
+    m_descriptor_pools.resize(m_descriptor_set_layouts.size(), VK_NULL_HANDLE);
     for (size_t set = 0; set < m_descriptor_set_layouts.size(); ++set) {
         if (m_descriptor_set_layouts[set] == VK_NULL_HANDLE) {
             continue;
         }
-        Vector<VkDescriptorSetLayout> layouts(number_of_images, m_descriptor_set_layouts[set]);
-        VkDescriptorSetAllocateInfo alloc_info{.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
-                                               .descriptorPool = p_descriptor_pool,
-                                               .descriptorSetCount = static_cast<u32>(number_of_images),
-                                               .pSetLayouts = layouts.data()};
-        m_descriptor_sets[set].resize(number_of_images);
-        if (const VkResult result{vkAllocateDescriptorSets(p_device, &alloc_info, m_descriptor_sets[set].data())};
-            result != VK_SUCCESS) {
-            ENGINE_LOG_ERROR("Failed to allocate descriptor set {}. Error: {}", set, vk_result_to_string(result));
-            CHECK_VK_RESULT(result, "vkAllocateDescriptorSets");
+
+        // What one set of the layout takes, a new pool is sized for it when the shared ones have no room
+        SmallVector<VkDescriptorPoolSize, 4> set_sizes;
+        for (const auto &shader : {p_vertex_shader, p_fragment_shader}) {
+            for (const auto &binding : shader->Reflection().descriptor_bindings) {
+                if (binding.set != set) {
+                    continue;
+                }
+                const auto size{std::ranges::find(set_sizes, binding.type, &VkDescriptorPoolSize::type)};
+                if (size == set_sizes.end()) {
+                    set_sizes.push_back({.type = binding.type, .descriptorCount = GetDescriptorCount(binding)});
+                }
+                else {
+                    size->descriptorCount += GetDescriptorCount(binding);
+                }
+            }
         }
+
+        m_descriptor_sets[set].resize(number_of_images);
+        m_descriptor_pools[set] =
+            p_descriptor_allocator->Allocate(m_descriptor_set_layouts[set], set_sizes, m_descriptor_sets[set]);
     }
 }
 
-void GraphicsPipeline::UpdateDescriptorSets(const int number_of_images, const Vector<Buffer> &uniform_buffers,
-                                            const int uniform_data_size)
+void GraphicsPipeline::WriteImageDescriptors(const size_t first_image, const size_t image_count,
+                                             const u32 binding_index,
+                                             const Vector<std::unique_ptr<Texture>> &textures,
+                                             const std::span<const u32> texture_ids)
 {
-    ASSERT(uniform_buffers.size() >= static_cast<size_t>(number_of_images), "Not enough uniform buffers");
-
-    SmallVector<VkWriteDescriptorSet, 10, GrowthPolicyDouble> write_descriptor_sets;
-    SmallVector<std::unique_ptr<VkDescriptorBufferInfo>, 10> buffer_infos;
+    if (texture_ids.empty()) {
+        return;
+    }
 
-    for (u32 set = 0; set < m_descriptor_sets.size(); ++set) {
-        if (m_descriptor_sets[set].empty()) {
+    const ShaderDescriptorBinding *texture_binding{nullptr};
+    for (const auto &binding : p_fragment_shader->Reflection().descriptor_bindings) {
+        if (binding.type == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER && binding.binding == binding_index &&
+            binding.set < m_descriptor_sets.size() && !m_descriptor_sets[binding.set].empty()) {
+            texture_binding = &binding;
+            break;
+        }
+    }
+    if (texture_binding == nullptr) {
+        ENGINE_LOG_WARNING("No texture descriptor writes generated for pipeline type: {}. Expected binding={} in "
+                           "fragment shader.",
+                           pipeline_type_to_string(m_type), binding_index);
+        return;
+    }
+
+    // Slots that were never written stay unbound, the array is partially bound and nothing indexes them
+    const u32 descriptor_count{GetDescriptorCount(*texture_binding)};
+    Vector<VkDescriptorImageInfo> image_infos;
+    Vector<u32> array_elements;
+    image_infos.reserve(texture_ids.size());
+    array_elements.reserve(texture_ids.size());
+    for (const u32 texture_id : texture_ids) {
+        if (texture_id >= textures.size() || texture_id >= descriptor_count) {
+            ENGINE_LOG_WARNING("Texture id {} is outside the texture array ({} slots) at binding {}", texture_id,
+                               descriptor_count, binding_index);
             continue;
         }
-        for (int i = 0; i < number_of_images; ++i) {
-            for (const auto &shader : {p_vertex_shader, p_fragment_shader}) {
-                for (const auto &binding : shader->Reflection().descriptor_bindings) {
-                    if (binding.set != set) {
-                        continue;
-                    }
-                    VkWriteDescriptorSet write{.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-                                               .dstSet = m_descriptor_sets[set][i],
-                                               .dstBinding = binding.binding,
-                                               .dstArrayElement = 0,
-                                               .descriptorCount = binding.count,
-                                               .descriptorType = binding.type};
-                    if (binding.type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER) {
-                        if (binding.set == 0 && binding.binding == 0) {
-                            auto buffer_info = std::make_unique<VkDescriptorBufferInfo>(
-                                VkDescriptorBufferInfo{.buffer = uniform_buffers[i].p_buffer,
-                                                       .offset = 0,
-                                                       .range = static_cast<VkDeviceSize>(uniform_data_size)});
-                            write.pBufferInfo = buffer_info.get();
-                            buffer_infos.push_back(std::move(buffer_info));
-                        }
-                        else {
-                            ENGINE_LOG_WARNING("No uniform buffer mapped for set {}, binding {}", binding.set,
-                                               binding.binding);
-                            continue;
-                        }
-                    }
-                    else if (binding.type == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER) {
-                        continue;
-                    }
-                    else {
-                        ENGINE_LOG_WARNING("Unsupported descriptor type {} at set {}, binding {}",
-                                           vk_descriptor_type_to_string_view(binding.type), binding.set,
-                                           binding.binding);
-                        continue;
-                    }
-                    write_descriptor_sets.push_back(write);
-                }
-            }
+        const Texture *texture{textures[texture_id].get()};
+        image_infos.push_back({.sampler = texture->p_sampler,
+                               .imageView = texture->p_view,
+                               .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL});
+        array_elements.push_back(texture_id);
+    }
+
+    Vector<VkWriteDescriptorSet> write_descriptor_sets;
+    write_descriptor_sets.reserve(image_infos.size() * image_count);
+    for (size_t i = first_image; i < first_image + image_count && i < m_descriptor_sets[texture_binding->set].size();
+         ++i) {
+        for (size_t element = 0; element < image_infos.size(); ++element) {
+            write_descriptor_sets.push_back({.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                                             .dstSet = m_descriptor_sets[texture_binding->set][i],
+                                             .dstBinding = texture_binding->binding,
+                                             .dstArrayElement = array_elements[element],
+                                             .descriptorCount = 1,
+                                             .descriptorType = texture_binding->type,
+                                             .pImageInfo = &image_infos[element]});
         }
     }
 
     if (!write_descriptor_sets.empty()) {
         vkUpdateDescriptorSets(p_device, static_cast<u32>(write_descriptor_sets.size()), write_descriptor_sets.data(),
                                0, nullptr);
-        ENGINE_LOG_DEBUG("Updated {} uniform buffer descriptor writes", write_descriptor_sets.size());
-    }
-    else {
-        ENGINE_LOG_WARNING("No uniform buffer descriptor writes generated; expected set=0, binding=0");
+        ENGINE_PROFILE_COUNT(DESCRIPTOR_WRITES_COUNTER, write_descriptor_sets.size());
+        ENGINE_LOG_DEBUG("Updated {} texture descriptor writes at binding {} for pipeline type: {}",
+                         write_descriptor_sets.size(), binding_index, pipeline_type_to_string(m_type));
     }
 }
 
-std::array<VkPipelineShaderStageCreateInfo, 2> GraphicsPipeline::SetupShaderStages() const
+u32 GraphicsPipeline::GetDescriptorCount(const ShaderDescriptorBinding &binding) const
 {
-    SmallVector<VkSpecializationMapEntry, 4> spec_entries_vertex;
-    SmallVector<u8, 4> spec_data_vertex;
-    for (const auto &spec : p_vertex_shader->Reflection().specialization_constants) {
-        VkSpecializationMapEntry entry{.constantID = spec.constant_id,
-                                       .offset = static_cast<u32>(spec_data_vertex.size()),
-                                       .size = spec.default_value.size()};
-        spec_entries_vertex.push_back(entry);
-        spec_data_vertex.insert(spec_data_vertex.end(), spec.default_value.begin(), spec.default_value.end());
-    }
+    return binding.is_runtime_array ? m_max_textures : binding.count;
+}
 
-    SmallVector<VkSpecializationMapEntry, 4> spec_entries_fragment;
-    SmallVector<u8, 4> spec_data_fragment;
-    for (const auto &spec : p_fragment_shader->Reflection().specialization_constants) {
-        VkSpecializationMapEntry entry{.constantID = spec.constant_id,
-                                       .offset = static_cast<u32>(spec_data_fragment.size()),
-                                       .size = spec.default_value.size()};
-        spec_entries_fragment.push_back(entry);
-        spec_data_fragment.insert(spec_data_fragment.end(), spec.default_value.begin(), spec.default_value.end());
+void GraphicsPipeline::SetupSpecialization(const Shader &shader, StageSpecialization &specialization) const
+{
+    specialization.entries.clear();
+    specialization.data.clear();
+    for (const auto &spec : shader.Reflection().specialization_constants) {
+        const VkSpecializationMapEntry entry{.constantID = spec.constant_id,
+                                             .offset = static_cast<u32>(specialization.data.size()),
+                                             .size = spec.default_value.size()};
+        specialization.entries.push_back(entry);
+        specialization.data.insert(specialization.data.end(), spec.default_value.begin(), spec.default_value.end());
+        if (const std::optional<s32> value{m_constants.Find(spec.name)};
+            value && spec.type == VkConstantType::VK_CONSTANT_TYPE_INT) {
+            std::memcpy(specialization.data.data() + entry.offset, &*value, sizeof(s32));
+        }
     }
 
-    const VkSpecializationInfo spec_info_vertex{.mapEntryCount = static_cast<u32>(spec_entries_vertex.size()),
-                                                .pMapEntries =
-                                                    spec_entries_vertex.empty() ? nullptr : spec_entries_vertex.data(),
-                                                .dataSize = spec_data_vertex.size(),
-                                                .pData = spec_data_vertex.empty() ? nullptr : spec_data_vertex.data()};
+    specialization.info = VkSpecializationInfo{
+        .mapEntryCount = static_cast<u32>(specialization.entries.size()),
+        .pMapEntries = specialization.entries.empty() ? nullptr : specialization.entries.data(),
+        .dataSize = specialization.data.size(),
+        .pData = specialization.data.empty() ? nullptr : specialization.data.data()};
+}
 
-    const VkSpecializationInfo spec_info_fragment{.mapEntryCount = static_cast<u32>(spec_entries_fragment.size()),
-                                            .pMapEntries =
-                                                spec_entries_fragment.empty() ? nullptr : spec_entries_fragment.data(),
-                                            .dataSize = spec_data_fragment.size(),
-                                            .pData = spec_data_fragment.empty() ? nullptr : spec_data_fragment.data()};
+std::array<VkPipelineShaderStageCreateInfo, 2> GraphicsPipeline::SetupShaderStages()
+{
+    // The create infos point into the members, which outlive the vkCreateGraphicsPipelines call
+    SetupSpecialization(*p_vertex_shader, m_vertex_specialization);
+    SetupSpecialization(*p_fragment_shader, m_fragment_specialization);
 
     return {VkPipelineShaderStageCreateInfo{.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
                                             .stage = p_vertex_shader->Stage(),
                                             .module = p_vertex_shader->Get(),
                                             .pName = p_vertex_shader->Reflection().entry_point.c_str(),
-                                            .pSpecializationInfo =
-                                                spec_entries_vertex.empty() ? nullptr : &spec_info_vertex},
+                                            .pSpecializationInfo = m_vertex_specialization.entries.empty()
+                                                                       ? nullptr
+                                                                       : &m_vertex_specialization.info},
             VkPipelineShaderStageCreateInfo{.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
                                             .stage = p_fragment_shader->Stage(),
                                             .module = p_fragment_shader->Get(),
                                             .pName = p_fragment_shader->Reflection().entry_point.c_str(),
-                                            .pSpecializationInfo =
-                                                spec_entries_fragment.empty() ? nullptr : &spec_info_fragment}};
+                                            .pSpecializationInfo = m_fragment_specialization.entries.empty()
+                                                                       ? nullptr
+                                                                       : &m_fragment_specialization.info}};
 }
 
 VkPipelineVertexInputStateCreateInfo GraphicsPipeline::SetupVertexInput()
@@ -615,10 +664,12 @@ VkPipelineVertexInputStateCreateInfo GraphicsPipeline::SetupVertexInput()
     m_attribute_descriptions.clear();
     u32 attribute_index{0};
 
-    // Binding 0: Per-vertex data (Vertex struct)
-    m_binding_descriptions.push_back(
-        {.binding = 0, .stride = sizeof(Vertex), .inputRate = VK_VERTEX_INPUT_RATE_VERTEX});
-    ENGINE_LOG_DEBUG("Added vertex binding: binding=0, stride={}, inputRate=Vertex", sizeof(Vertex));
+    // Binding 0: Per-vertex data (Vertex struct), quads make their corners from the vertex index instead
+    if (!internal::is_quad_pipeline(m_type) && m_type != PipelineType::Upscale) {
+        m_binding_descriptions.push_back(
+            {.binding = 0, .stride = sizeof(Vertex), .inputRate = VK_VERTEX_INPUT_RATE_VERTEX});
+        ENGINE_LOG_DEBUG("Added vertex binding: binding=0, stride={}, inputRate=Vertex", sizeof(Vertex));
+    }
 
     for (const auto &[location, name, format, input_rate] : p_vertex_shader->Reflection().vertex_inputs) {
         if (input_rate != VK_VERTEX_INPUT_RATE_VERTEX) {
@@ -639,17 +690,18 @@ VkPipelineVertexInputStateCreateInfo GraphicsPipeline::SetupVertexInput()
     }
 
     // Binding 1: Per-instance data
-    if (m_type == PipelineType::Quad) {
+    if (internal::is_quad_pipeline(m_type)) {
         m_binding_descriptions.push_back(
-            {.binding = 1, .stride = sizeof(InstanceData), .inputRate = VK_VERTEX_INPUT_RATE_INSTANCE});
+            {.binding = 1, .stride = sizeof(QuadInstance), .inputRate = VK_VERTEX_INPUT_RATE_INSTANCE});
         ENGINE_LOG_DEBUG("Added instance binding (Quad): binding=1, stride={}, inputRate=Instance",
-                         sizeof(InstanceData));
-        for (const auto &[location, name, format, input_rate] : p_vertex_shader->Reflection().vertex_inputs) {
+                         sizeof(QuadInstance));
+        for (const auto &[location, name, shader_format, input_rate] : p_vertex_shader->Reflection().vertex_inputs) {
             if (input_rate != VK_VERTEX_INPUT_RATE_INSTANCE) {
                 continue;
             }
             bool success{false};
-            u32 offset = internal::get_struct_offset<InstanceData>(name, format, success);
+            VkFormat format{shader_format};
+            u32 offset = internal::get_quad_instance_offset(name, format, success);
             if (!success) {
                 ENGINE_LOG_WARNING("Unsupported instance input (Quad): name={}, format={}", name,
                                    vk_format_to_string_view(format));
@@ -662,28 +714,6 @@ VkPipelineVertexInputStateCreateInfo GraphicsPipeline::SetupVertexInput()
             attribute_index++;
         }
     }
-    else if (m_type == PipelineType::Text) {
-        m_binding_descriptions.push_back(
-            {.binding = 1, .stride = sizeof(TextData), .inputRate = VK_VERTEX_INPUT_RATE_INSTANCE});
-        ENGINE_LOG_DEBUG("Added instance binding (Text): binding=1, stride={}, inputRate=Instance", sizeof(TextData));
-        for (const auto &[location, name, format, input_rate] : p_vertex_shader->Reflection().vertex_inputs) {
-            if (input_rate != VK_VERTEX_INPUT_RATE_INSTANCE) {
-                continue;
-            }
-            bool success{false};
-            u32 offset = internal::get_struct_offset<TextData>(name, format, success);
-            if (!success) {
-                ENGINE_LOG_WARNING("Unsupported instance input (Text): name={}, format={}", name,
-                                   vk_format_to_string_view(format));
-                continue;
-            }
-            m_attribute_descriptions.push_back(
-                {.location = location, .binding = 1, .format = format, .offset = offset});
-            ENGINE_LOG_DEBUG("Added instance attribute (Text): name={}, location={}, format={}, offset={}", name,
-                             location, vk_format_to_string_view(format), offset);
-            attribute_index++;
-        }
-    }
     else if (m_type == PipelineType::Particle) {
         m_binding_descriptions.push_back(
             {.binding = 1, .stride = sizeof(ParticleData), .inputRate = VK_VERTEX_INPUT_RATE_INSTANCE});
@@ -733,6 +763,11 @@ VkPipelineVertexInputStateCreateInfo GraphicsPipeline::SetupVertexInput()
                          vk_format_to_string_view(attr.format));
     }
 
+    // The full screen triangle is made from the vertex index alone
+    if (m_type == PipelineType::Upscale) {
+        return VkPipelineVertexInputStateCreateInfo{.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO};
+    }
+
     if (m_binding_descriptions.empty()) {
         ENGINE_LOG_ERROR("No valid vertex bindings defined for pipeline type: {}", pipeline_type_to_string(m_type));
         ENGINE_THROW("Failed to create graphics pipeline: no valid vertex bindings");
@@ -761,6 +796,10 @@ VkPipelineVertexInputStateCreateInfo GraphicsPipeline::SetupVertexInput()
 
 GraphicsPipeline::PipelineStates GraphicsPipeline::SetupPipelineStates() const
 {
+    const bool depth_test{m_type != PipelineType::Upscale};
+    const bool opaque{m_type == PipelineType::Quad || m_type == PipelineType::QuadAlphaTest ||
+                      m_type == PipelineType::Upscale};
+
     PipelineStates states{};
     states.input_assembly = {.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO,
                              .topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST,
@@ -774,7 +813,7 @@ GraphicsPipeline::PipelineStates GraphicsPipeline::SetupPipelineStates() const
 
     states.rasterization = {.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO,
                             .polygonMode = VK_POLYGON_MODE_FILL,
-                            .cullMode = VK_CULL_MODE_BACK_BIT,
+                            .cullMode = m_type == PipelineType::Upscale ? VK_CULL_MODE_NONE : VK_CULL_MODE_BACK_BIT,
                             .frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE,
                             .lineWidth = 1.0f};
 
@@ -782,14 +821,15 @@ GraphicsPipeline::PipelineStates GraphicsPipeline::SetupPipelineStates() const
                           .rasterizationSamples = VK_SAMPLE_COUNT_1_BIT};
 
     states.depth_stencil = {.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO,
-                            .depthTestEnable = VK_TRUE,
-                            .depthWriteEnable = VK_TRUE,
+                            .depthTestEnable = depth_test ? VK_TRUE : VK_FALSE,
+                            .depthWriteEnable = depth_test && m_type != PipelineType::QuadTransparent ? VK_TRUE
+                                                                                                       : VK_FALSE,
                             .depthCompareOp = VK_COMPARE_OP_LESS,
                             .depthBoundsTestEnable = VK_FALSE,
                             .stencilTestEnable = VK_FALSE};
 
     states.blend_attachment = {
-        .blendEnable = m_type == PipelineType::Text || m_type == PipelineType::Particle ? VK_TRUE : VK_FALSE,
+        .blendEnable = opaque ? VK_FALSE : VK_TRUE,
         .colorWriteMask =
             VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT};
 
@@ -851,6 +891,96 @@ Vector<VkPushConstantRange> GraphicsPipeline::SetupPushConstants()
     return push_constant_ranges;
 }
 
+VkPipeline GraphicsPipeline::CreateLinkedPipeline(
+    PipelineLibraryCache &libraries, const VkPipelineRenderingCreateInfo &rendering_info,
+    const std::span<const VkPipelineShaderStageCreateInfo, 2> shader_stages,
+    const VkPipelineVertexInputStateCreateInfo &vertex_input, const PipelineStates &states) const
+{
+    ENGINE_PROFILE_SCOPE("Link graphics pipeline");
+
+    // The type picks the fixed function states. Parts built with a layout are only linked into pipelines whose layout
+    // is defined the same, which the layout derives from both shaders and the texture array size.
+    const u64 type_key{internal::hash_library_key(m_type, 0)};
+    const u64 rendering_key{internal::hash_rendering_info(rendering_info)};
+    const std::array<u64, 3> layout_values{p_vertex_shader->GetCodeHash(), p_fragment_shader->GetCodeHash(),
+                                           m_max_textures};
+    const u64 layout_key{internal::hash_library_key(std::span<const u64>{layout_values}, type_key)};
+
+    u64 vertex_input_key{internal::hash_library_key(std::span<const VkVertexInputBindingDescription>{
+                                                        m_binding_descriptions.data(), m_binding_descriptions.size()},
+                                                    type_key)};
+    vertex_input_key = internal::hash_library_key(
+        std::span<const VkVertexInputAttributeDescription>{m_attribute_descriptions.data(),
+                                                           m_attribute_descriptions.size()},
+        vertex_input_key);
+
+    const auto stage_key = [&](const StageSpecialization &specialization) {
+        const u64 key{internal::hash_library_key(
+            std::span<const VkSpecializationMapEntry>{specialization.entries.data(), specialization.entries.size()},
+            layout_key ^ rendering_key)};
+        return internal::hash_library_key(std::span<const u8>{specialization.data.data(), specialization.data.size()},
+                                          key);
+    };
+    const u64 pre_rasterization_key{stage_key(m_vertex_specialization)};
+    const u64 fragment_shader_key{stage_key(m_fragment_specialization)};
+    const u64 fragment_output_key{type_key ^ rendering_key};
+
+    // The parts that take the rendering info get a copy without whatever the caller chained to it
+    VkPipelineRenderingCreateInfo rendering{rendering_info};
+    rendering.pNext = nullptr;
+
+    const VkGraphicsPipelineCreateInfo vertex_input_info{.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+                                                         .pVertexInputState = &vertex_input,
+                                                         .pInputAssemblyState = &states.input_assembly};
+    const VkGraphicsPipelineCreateInfo pre_rasterization_info{
+        .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+        .pNext = &rendering,
+        .stageCount = 1,
+        .pStages = &shader_stages[0],
+        .pViewportState = &states.viewport,
+        .pRasterizationState = &states.rasterization,
+        .pDynamicState = &states.dynamic,
+        .layout = p_pipeline_layout};
+    const VkGraphicsPipelineCreateInfo fragment_shader_info{.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+                                                            .pNext = &rendering,
+                                                            .stageCount = 1,
+                                                            .pStages = &shader_stages[1],
+                                                            .pMultisampleState = &states.multisample,
+                                                            .pDepthStencilState = &states.depth_stencil,
+                                                            .layout = p_pipeline_layout};
+    const VkGraphicsPipelineCreateInfo fragment_output_info{.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+                                                            .pNext = &rendering,
+                                                            .pMultisampleState = &states.multisample,
+                                                            .pColorBlendState = &states.color_blend};
+
+    const std::array<VkPipeline, PIPELINE_LIBRARY_PART_COUNT> parts{
+        libraries.GetOrCreate(PipelineLibraryPart::VertexInput, vertex_input_key, vertex_input_info),
+        libraries.GetOrCreate(PipelineLibraryPart::PreRasterization, pre_rasterization_key, pre_rasterization_info),
+        libraries.GetOrCreate(PipelineLibraryPart::FragmentShader, fragment_shader_key, fragment_shader_info),
+        libraries.GetOrCreate(PipelineLibraryPart::FragmentOutput, fragment_output_key, fragment_output_info)};
+    if (std::ranges::find(parts, VK_NULL_HANDLE) != parts.end()) {
+        return VK_NULL_HANDLE;
+    }
+
+    // Linked without link time optimisation, the point is to take no longer than a frame has to spare
+    const VkPipelineLibraryCreateInfoKHR library_info{.sType = VK_STRUCTURE_TYPE_PIPELINE_LIBRARY_CREATE_INFO_KHR,
+                                                      .libraryCount = static_cast<u32>(parts.size()),
+                                                      .pLibraries = parts.data()};
+    const VkGraphicsPipelineCreateInfo pipeline_info{.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+                                                     .pNext = &library_info,
+                                                     .layout = p_pipeline_layout};
+
+    VkPipeline pipeline{VK_NULL_HANDLE};
+    if (const VkResult result{
+            vkCreateGraphicsPipelines(p_device, m_renderer.GetPipelineCache(), 1, &pipeline_info, nullptr, &pipeline)};
+        result != VK_SUCCESS) {
+        ENGINE_LOG_WARNING("Failed to link graphics pipeline for type {}, creating it whole: {}",
+                           pipeline_type_to_string(m_type), vk_result_to_string(result));
+        return VK_NULL_HANDLE;
+    }
+    return pipeline;
+}
+
 void GraphicsPipeline::PrintReflection() const
 {
     for (const auto &[location, name, format, input_rate] : p_vertex_shader->Reflection().vertex_inputs) {
@@ -0,0 +1,112 @@
+/**
+ * @file vk_ktx2.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine KTX2 texture container loading implementation
+ */
+#include "renderers/vulkan/vk_ktx2.hpp"
+
+#include <array>
+#include <cstring>
+#include <format>
+#include <type_traits>
+
+#include "utils/mapped_file.hpp"
+
+namespace gouda::vk {
+
+namespace internal {
+
+constexpr std::array<u8, 12> KTX2_IDENTIFIER{0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+constexpr u32 KTX2_SUPERCOMPRESSION_NONE{0};
+
+// Little endian as stored on disk, the level index follows directly behind it
+struct KTX2Header {
+    u8 identifier[12];
+    u32 vk_format;
+    u32 type_size;
+    u32 pixel_width;
+    u32 pixel_height;
+    u32 pixel_depth;
+    u32 layer_count;
+    u32 face_count;
+    u32 level_count;
+    u32 supercompression_scheme;
+    u32 dfd_byte_offset;
+    u32 dfd_byte_length;
+    u32 kvd_byte_offset;
+    u32 kvd_byte_length;
+    u64 sgd_byte_offset;
+    u64 sgd_byte_length;
+};
+
+struct KTX2LevelIndex {
+    u64 byte_offset;
+    u64 byte_length;
+    u64 uncompressed_byte_length;
+};
+
+static_assert(sizeof(KTX2Header) == 80 && std::is_trivially_copyable_v<KTX2Header>);
+static_assert(sizeof(KTX2LevelIndex) == 24 && std::is_trivially_copyable_v<KTX2LevelIndex>);
+
+} // namespace internal
+
+Expect<KTX2File, String> KTX2File::Load(StringView filepath)
+{
+    auto file_result{fs::MappedFile::Open(filepath)};
+    if (!file_result.has_value()) {
+        return std::unexpected(String{fs::error_to_string(file_result.error())});
+    }
+
+    KTX2File file;
+    file.m_file.emplace(std::move(file_result.value()));
+    const std::span<const std::byte> data{file.m_file->GetData()};
+
+    internal::KTX2Header header{};
+    if (data.size() < sizeof(header)) {
+        return std::unexpected("File is smaller than the KTX2 header");
+    }
+    std::memcpy(&header, data.data(), sizeof(header));
+
+    if (std::memcmp(header.identifier, internal::KTX2_IDENTIFIER.data(), internal::KTX2_IDENTIFIER.size()) != 0) {
+        return std::unexpected("Not a KTX2 file");
+    }
+    if (header.supercompression_scheme != internal::KTX2_SUPERCOMPRESSION_NONE) {
+        return std::unexpected(std::format("Unsupported supercompression scheme {}", header.supercompression_scheme));
+    }
+    if (header.vk_format == VK_FORMAT_UNDEFINED) {
+        return std::unexpected("Format is VK_FORMAT_UNDEFINED, Basis Universal data has to be transcoded first");
+    }
+    if (header.pixel_width == 0 || header.pixel_height == 0 || header.pixel_depth != 0 || header.face_count != 1) {
+        return std::unexpected("Only 2D textures and 2D texture arrays are supported");
+    }
+
+    // A level count of zero asks the loader to generate mips, the base level is then the only one stored
+    const u32 level_count{header.level_count == 0 ? 1 : header.level_count};
+    const u64 level_index_end{sizeof(header) + u64{level_count} * sizeof(internal::KTX2LevelIndex)};
+    if (data.size() < level_index_end) {
+        return std::unexpected("Level index is truncated");
+    }
+
+    file.m_levels.reserve(level_count);
+    for (u32 level = 0; level < level_count; ++level) {
+        internal::KTX2LevelIndex level_index{};
+        std::memcpy(&level_index, data.data() + sizeof(header) + level * sizeof(level_index), sizeof(level_index));
+
+        if (level_index.byte_length == 0 || level_index.byte_offset > data.size() ||
+            level_index.byte_length > data.size() - level_index.byte_offset) {
+            return std::unexpected(std::format("Level {} lies outside the file", level));
+        }
+        file.m_levels.push_back(KTX2Level{level_index.byte_offset, level_index.byte_length});
+    }
+
+    file.m_format = static_cast<VkFormat>(header.vk_format);
+    file.m_size = ImageSize{static_cast<int>(header.pixel_width), static_cast<int>(header.pixel_height)};
+    file.m_layer_count = header.layer_count == 0 ? 1 : header.layer_count;
+
+    return file;
+}
+
+bool KTX2File::IsKTX2Path(StringView filepath) { return FilePath{filepath}.extension() == ".ktx2"; }
+
+} // namespace gouda::vk
@@ -0,0 +1,153 @@
+/**
+ * @file vk_layout_cache.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine vulkan descriptor set and pipeline layout cache implementation
+ */
+#include "renderers/vulkan/vk_layout_cache.hpp"
+
+#include <algorithm>
+
+#include "debug/logger.hpp"
+#include "renderers/vulkan/vk_utils.hpp"
+#include "utils/hash.hpp"
+
+namespace gouda::vk {
+
+namespace internal {
+
+static bool is_same_range(const VkPushConstantRange &a, const VkPushConstantRange &b)
+{
+    return a.stageFlags == b.stageFlags && a.offset == b.offset && a.size == b.size;
+}
+
+} // namespace internal
+
+LayoutCache::LayoutCache(const VkDevice device) : p_device{device}, m_hit_count{0} {}
+
+LayoutCache::~LayoutCache()
+{
+    for (const PipelineLayoutEntry &entry : m_pipeline_layouts) {
+        vkDestroyPipelineLayout(p_device, entry.p_layout, nullptr);
+    }
+    for (const SetLayoutEntry &entry : m_set_layouts) {
+        vkDestroyDescriptorSetLayout(p_device, entry.p_layout, nullptr);
+    }
+    ENGINE_LOG_DEBUG("Layout cache destroyed with {} set and {} pipeline layouts, {} requests shared one.",
+                     m_set_layouts.size(), m_pipeline_layouts.size(), m_hit_count);
+}
+
+VkDescriptorSetLayout LayoutCache::GetSetLayout(const std::span<const DescriptorLayoutBinding> bindings)
+{
+    const u64 hash{utils::fnv1a(std::as_bytes(bindings))};
+
+    std::scoped_lock lock{m_mutex};
+    for (const SetLayoutEntry &entry : m_set_layouts) {
+        if (entry.hash == hash && std::ranges::equal(entry.bindings, bindings)) {
+            ++m_hit_count;
+            return entry.p_layout;
+        }
+    }
+
+    SmallVector<VkDescriptorSetLayoutBinding, 8> layout_bindings;
+    SmallVector<VkDescriptorBindingFlags, 8> binding_flags;
+    for (const DescriptorLayoutBinding &binding : bindings) {
+        layout_bindings.push_back({.binding = binding.binding,
+                                   .descriptorType = binding.type,
+                                   .descriptorCount = binding.count,
+                                   .stageFlags = binding.stage_flags,
+                                   .pImmutableSamplers = nullptr});
+        binding_flags.push_back(binding.flags);
+    }
+
+    const bool update_after_bind{
+        std::ranges::any_of(binding_flags, [](const VkDescriptorBindingFlags flags) { return flags != 0; })};
+    const VkDescriptorSetLayoutCreateFlags layout_flags{
+        update_after_bind
+            ? static_cast<VkDescriptorSetLayoutCreateFlags>(VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT)
+            : VkDescriptorSetLayoutCreateFlags{0}};
+    const VkDescriptorSetLayoutBindingFlagsCreateInfo binding_flags_info{
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO,
+        .bindingCount = static_cast<u32>(binding_flags.size()),
+        .pBindingFlags = binding_flags.empty() ? nullptr : binding_flags.data()};
+
+    const VkDescriptorSetLayoutCreateInfo layout_info{
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+        .pNext = update_after_bind ? &binding_flags_info : nullptr,
+        .flags = layout_flags,
+        .bindingCount = static_cast<u32>(layout_bindings.size()),
+        .pBindings = layout_bindings.empty() ? nullptr : layout_bindings.data()};
+
+    VkDescriptorSetLayout layout{VK_NULL_HANDLE};
+    if (const VkResult result{vkCreateDescriptorSetLayout(p_device, &layout_info, nullptr, &layout)};
+        result != VK_SUCCESS) {
+        ENGINE_LOG_ERROR("Failed to create descriptor set layout. Error: {}", vk_result_to_string(result));
+        CHECK_VK_RESULT(result, "vkCreateDescriptorSetLayout");
+    }
+
+    SetLayoutEntry &entry{m_set_layouts.emplace_back()};
+    entry.hash = hash;
+    entry.bindings.insert(entry.bindings.end(), bindings.begin(), bindings.end());
+    entry.p_layout = layout;
+    ENGINE_LOG_DEBUG("Descriptor set layout {} created with {} bindings.", m_set_layouts.size(), bindings.size());
+    return layout;
+}
+
+VkPipelineLayout LayoutCache::GetPipelineLayout(const std::span<const VkDescriptorSetLayout> set_layouts,
+                                                const std::span<const VkPushConstantRange> push_constant_ranges)
+{
+    const u64 hash{utils::fnv1a(std::as_bytes(push_constant_ranges), utils::fnv1a(std::as_bytes(set_layouts)))};
+
+    std::scoped_lock lock{m_mutex};
+    for (const PipelineLayoutEntry &entry : m_pipeline_layouts) {
+        if (entry.hash == hash && std::ranges::equal(entry.set_layouts, set_layouts) &&
+            std::ranges::equal(entry.push_constant_ranges, push_constant_ranges, internal::is_same_range)) {
+            ++m_hit_count;
+            return entry.p_layout;
+        }
+    }
+
+    const VkPipelineLayoutCreateInfo layout_info{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+        .setLayoutCount = static_cast<u32>(set_layouts.size()),
+        .pSetLayouts = set_layouts.empty() ? nullptr : set_layouts.data(),
+        .pushConstantRangeCount = static_cast<u32>(push_constant_ranges.size()),
+        .pPushConstantRanges = push_constant_ranges.empty() ? nullptr : push_constant_ranges.data()};
+
+    VkPipelineLayout layout{VK_NULL_HANDLE};
+    if (const VkResult result{vkCreatePipelineLayout(p_device, &layout_info, nullptr, &layout)};
+        result != VK_SUCCESS) {
+        ENGINE_LOG_ERROR("Failed to create pipeline layout. Error code: {}", vk_result_to_string(result));
+        CHECK_VK_RESULT(result, "vkCreatePipelineLayout");
+    }
+
+    PipelineLayoutEntry &entry{m_pipeline_layouts.emplace_back()};
+    entry.hash = hash;
+    entry.set_layouts.insert(entry.set_layouts.end(), set_layouts.begin(), set_layouts.end());
+    entry.push_constant_ranges.insert(entry.push_constant_ranges.end(), push_constant_ranges.begin(),
+                                      push_constant_ranges.end());
+    entry.p_layout = layout;
+    ENGINE_LOG_DEBUG("Pipeline layout {} created with {} sets and {} push constant ranges.", m_pipeline_layouts.size(),
+                     set_layouts.size(), push_constant_ranges.size());
+    return layout;
+}
+
+size_t LayoutCache::GetSetLayoutCount() const
+{
+    std::scoped_lock lock{m_mutex};
+    return m_set_layouts.size();
+}
+
+size_t LayoutCache::GetPipelineLayoutCount() const
+{
+    std::scoped_lock lock{m_mutex};
+    return m_pipeline_layouts.size();
+}
+
+u64 LayoutCache::GetHitCount() const
+{
+    std::scoped_lock lock{m_mutex};
+    return m_hit_count;
+}
+
+} // namespace gouda::vk
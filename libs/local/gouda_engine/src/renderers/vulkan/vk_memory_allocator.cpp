@@ -0,0 +1,411 @@
+/**
+ * @file vk_memory_allocator.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine vulkan device memory sub-allocator implementation
+ */
+#include "renderers/vulkan/vk_memory_allocator.hpp"
+
+#include <algorithm>
+#include <format>
+
+#include "debug/assert.hpp"
+#include "debug/logger.hpp"
+
+namespace gouda::vk {
+
+namespace internal {
+
+static VkDeviceSize align_memory_offset(const VkDeviceSize value, const VkDeviceSize alignment)
+{
+    return alignment > 1 ? (value + alignment - 1) / alignment * alignment : value;
+}
+
+static VkDeviceSize align_memory_offset_down(const VkDeviceSize value, const VkDeviceSize alignment)
+{
+    return alignment > 1 ? value / alignment * alignment : value;
+}
+
+} // namespace internal
+
+MemoryAllocation::MemoryAllocation()
+    : p_memory{VK_NULL_HANDLE},
+      m_offset{0},
+      m_size{0},
+      p_mapped{nullptr},
+      p_allocator{nullptr},
+      m_block_index{constants::u32_max},
+      m_memory_type{0}
+{
+}
+
+MemoryStatistics::MemoryStatistics()
+    : block_count{0},
+      dedicated_allocation_count{0},
+      allocation_count{0},
+      reserved_bytes{0},
+      used_bytes{0},
+      free_bytes{0},
+      largest_free_range{0},
+      fragmentation{0.0f}
+{
+}
+
+MemoryAllocator::MemoryAllocator(const VkDevice device, const VkPhysicalDeviceMemoryProperties &memory_properties,
+                                 const VkDeviceSize non_coherent_atom_size, const VkDeviceSize block_size)
+    : p_device{device},
+      m_memory_properties{memory_properties},
+      m_non_coherent_atom_size{std::max<VkDeviceSize>(non_coherent_atom_size, 1)},
+      m_block_size{block_size},
+      m_dedicated_allocation_count{0},
+      m_dedicated_bytes{0}
+{
+    ENGINE_LOG_DEBUG("Memory allocator created with {} byte blocks.", m_block_size);
+}
+
+MemoryAllocator::~MemoryAllocator()
+{
+    for (u32 i = 0; i < m_blocks.size(); ++i) {
+        if (m_blocks[i] && m_blocks[i]->m_allocation_count > 0) {
+            ENGINE_LOG_WARNING("Memory block {} destroyed with {} live allocations.", i,
+                               m_blocks[i]->m_allocation_count);
+        }
+        DestroyBlock(i);
+    }
+
+    if (m_dedicated_allocation_count > 0) {
+        ENGINE_LOG_WARNING("Memory allocator destroyed with {} live dedicated allocations.",
+                           m_dedicated_allocation_count);
+    }
+}
+
+Expect<MemoryAllocation, String> MemoryAllocator::Allocate(const VkMemoryRequirements &requirements,
+                                                           const u32 memory_type_index, const MemoryResourceKind kind)
+{
+    ASSERT(memory_type_index < m_memory_properties.memoryTypeCount, "Memory type index out of range.");
+    ASSERT(requirements.size > 0, "Cannot allocate zero bytes of device memory.");
+
+    std::lock_guard lock{m_mutex};
+
+    // Non coherent memory is flushed in whole atoms, allocations covering whole atoms keep every flush inside them
+    VkDeviceSize size{requirements.size};
+    VkDeviceSize alignment{std::max<VkDeviceSize>(requirements.alignment, 1)};
+    if (IsHostVisible(memory_type_index) && !IsHostCoherent(memory_type_index)) {
+        size = internal::align_memory_offset(size, m_non_coherent_atom_size);
+        alignment = std::max(alignment, m_non_coherent_atom_size);
+    }
+
+    MemoryAllocation allocation{};
+    allocation.p_allocator = this;
+    allocation.m_memory_type = memory_type_index;
+    allocation.m_size = size;
+
+    // Large resources would waste most of a block, give them their own memory
+    if (size > m_block_size / 2) {
+        void *mapped{nullptr};
+        auto memory{AllocateDeviceMemory(size, memory_type_index, &mapped)};
+        if (!memory) {
+            return std::unexpected(memory.error());
+        }
+
+        allocation.p_memory = *memory;
+        allocation.p_mapped = mapped;
+        ++m_dedicated_allocation_count;
+        m_dedicated_bytes += size;
+
+        return allocation;
+    }
+
+    for (u32 i = 0; i < m_blocks.size(); ++i) {
+        MemoryBlock *block{m_blocks[i].get()};
+        if (!block || block->m_memory_type != memory_type_index || block->m_kind != kind) {
+            continue;
+        }
+
+        if (const std::optional<VkDeviceSize> offset{AllocateFromBlock(*block, size, alignment)}) {
+            allocation.p_memory = block->p_memory;
+            allocation.m_offset = *offset;
+            allocation.m_block_index = i;
+            allocation.p_mapped = block->p_mapped ? static_cast<u8 *>(block->p_mapped) + *offset : nullptr;
+            return allocation;
+        }
+    }
+
+    // No block has room, create a new one
+    void *mapped{nullptr};
+    auto memory{AllocateDeviceMemory(m_block_size, memory_type_index, &mapped)};
+    if (!memory) {
+        return std::unexpected(memory.error());
+    }
+
+    auto block{std::make_unique<MemoryBlock>()};
+    block->p_memory = *memory;
+    block->m_size = m_block_size;
+    block->m_used = 0;
+    block->p_mapped = mapped;
+    block->m_memory_type = memory_type_index;
+    block->m_allocation_count = 0;
+    block->m_kind = kind;
+    block->m_free_ranges.push_back({0, m_block_size});
+
+    const std::optional<VkDeviceSize> offset{AllocateFromBlock(*block, size, alignment)};
+    ASSERT(offset.has_value(), "Fresh memory block could not satisfy allocation.");
+
+    // Reuse a slot left behind by a destroyed block so existing block indices stay valid
+    auto slot{std::ranges::find(m_blocks, nullptr)};
+    u32 block_index{0};
+    if (slot != m_blocks.end()) {
+        block_index = static_cast<u32>(std::distance(m_blocks.begin(), slot));
+        *slot = std::move(block);
+    }
+    else {
+        block_index = static_cast<u32>(m_blocks.size());
+        m_blocks.push_back(std::move(block));
+    }
+
+    ENGINE_LOG_DEBUG("Memory block {} created for memory type {}.", block_index, memory_type_index);
+
+    allocation.p_memory = *memory;
+    allocation.m_offset = *offset;
+    allocation.m_block_index = block_index;
+    allocation.p_mapped = mapped ? static_cast<u8 *>(mapped) + *offset : nullptr;
+
+    return allocation;
+}
+
+void MemoryAllocator::Free(MemoryAllocation &allocation)
+{
+    if (!allocation.IsValid()) {
+        return;
+    }
+
+    ASSERT(allocation.p_allocator == this, "Memory allocation freed through the wrong allocator.");
+
+    std::lock_guard lock{m_mutex};
+
+    if (allocation.IsDedicated()) {
+        if (allocation.p_mapped) {
+            vkUnmapMemory(p_device, allocation.p_memory);
+        }
+        vkFreeMemory(p_device, allocation.p_memory, nullptr);
+        --m_dedicated_allocation_count;
+        m_dedicated_bytes -= allocation.m_size;
+    }
+    else {
+        ASSERT(allocation.m_block_index < m_blocks.size() && m_blocks[allocation.m_block_index],
+               "Memory allocation refers to a destroyed block.");
+
+        MemoryBlock &block{*m_blocks[allocation.m_block_index]};
+        FreeToBlock(block, allocation.m_offset, allocation.m_size);
+
+        if (block.m_allocation_count == 0) {
+            // Keep one empty block per pool around to avoid churn when a resource is recreated
+            const bool has_sibling{std::ranges::any_of(m_blocks, [&](const std::unique_ptr<MemoryBlock> &other) {
+                return other && other.get() != &block && other->m_memory_type == block.m_memory_type &&
+                       other->m_kind == block.m_kind;
+            })};
+
+            if (has_sibling) {
+                DestroyBlock(allocation.m_block_index);
+            }
+        }
+    }
+
+    allocation = MemoryAllocation{};
+}
+
+MemoryStatistics MemoryAllocator::GetStatistics() const
+{
+    std::lock_guard lock{m_mutex};
+
+    MemoryStatistics statistics{};
+    statistics.dedicated_allocation_count = m_dedicated_allocation_count;
+    statistics.allocation_count = m_dedicated_allocation_count;
+    statistics.reserved_bytes = m_dedicated_bytes;
+    statistics.used_bytes = m_dedicated_bytes;
+
+    for (const auto &block : m_blocks) {
+        if (!block) {
+            continue;
+        }
+
+        ++statistics.block_count;
+        statistics.allocation_count += block->m_allocation_count;
+        statistics.reserved_bytes += block->m_size;
+        statistics.used_bytes += block->m_used;
+
+        for (const FreeRange &range : block->m_free_ranges) {
+            statistics.free_bytes += range.m_size;
+            statistics.largest_free_range = std::max(statistics.largest_free_range, range.m_size);
+        }
+    }
+
+    if (statistics.free_bytes > 0) {
+        statistics.fragmentation = 1.0f - static_cast<f32>(statistics.largest_free_range) /
+                                              static_cast<f32>(statistics.free_bytes);
+    }
+
+    return statistics;
+}
+
+void MemoryAllocator::Flush(const MemoryAllocation &allocation, const VkDeviceSize offset,
+                            const VkDeviceSize size) const
+{
+    if (const std::optional<VkMappedMemoryRange> range{GetMappedRange(allocation, offset, size)}) {
+        vkFlushMappedMemoryRanges(p_device, 1, &*range);
+    }
+}
+
+void MemoryAllocator::Invalidate(const MemoryAllocation &allocation, const VkDeviceSize offset,
+                                 const VkDeviceSize size) const
+{
+    if (const std::optional<VkMappedMemoryRange> range{GetMappedRange(allocation, offset, size)}) {
+        vkInvalidateMappedMemoryRanges(p_device, 1, &*range);
+    }
+}
+
+bool MemoryAllocator::IsHostCoherent(const u32 memory_type_index) const
+{
+    return (m_memory_properties.memoryTypes[memory_type_index].propertyFlags &
+            VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0;
+}
+
+std::optional<VkMappedMemoryRange> MemoryAllocator::GetMappedRange(const MemoryAllocation &allocation,
+                                                                   const VkDeviceSize offset,
+                                                                   VkDeviceSize size) const
+{
+    if (!allocation.p_mapped || size == 0 || IsHostCoherent(allocation.m_memory_type)) {
+        return std::nullopt;
+    }
+
+    // Widened to whole atoms, which never leaves the allocation since it was placed and sized in whole atoms
+    size = size == VK_WHOLE_SIZE ? allocation.m_size - offset : size;
+    const VkDeviceSize begin{
+        internal::align_memory_offset_down(allocation.m_offset + offset, m_non_coherent_atom_size)};
+    const VkDeviceSize end{
+        internal::align_memory_offset(allocation.m_offset + offset + size, m_non_coherent_atom_size)};
+    return VkMappedMemoryRange{.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE,
+                               .pNext = nullptr,
+                               .memory = allocation.p_memory,
+                               .offset = begin,
+                               .size = end - begin};
+}
+
+bool MemoryAllocator::IsHostVisible(const u32 memory_type_index) const
+{
+    return (m_memory_properties.memoryTypes[memory_type_index].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) !=
+           0;
+}
+
+Expect<VkDeviceMemory, String> MemoryAllocator::AllocateDeviceMemory(const VkDeviceSize size,
+                                                                     const u32 memory_type_index, void **mapped) const
+{
+    const VkMemoryAllocateInfo memory_allocate_info{.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+                                                    .pNext = nullptr,
+                                                    .allocationSize = size,
+                                                    .memoryTypeIndex = memory_type_index};
+
+    VkDeviceMemory memory{VK_NULL_HANDLE};
+    if (const VkResult result{vkAllocateMemory(p_device, &memory_allocate_info, nullptr, &memory)};
+        result != VK_SUCCESS) {
+        return std::unexpected(
+            std::format("vkAllocateMemory failed for {} bytes of memory type {} ({})", size, memory_type_index,
+                        static_cast<int>(result)));
+    }
+
+    *mapped = nullptr;
+    if (IsHostVisible(memory_type_index)) {
+        if (const VkResult result{vkMapMemory(p_device, memory, 0, VK_WHOLE_SIZE, 0, mapped)}; result != VK_SUCCESS) {
+            vkFreeMemory(p_device, memory, nullptr);
+            return std::unexpected(std::format("vkMapMemory failed for memory type {} ({})", memory_type_index,
+                                               static_cast<int>(result)));
+        }
+    }
+
+    return memory;
+}
+
+std::optional<VkDeviceSize> MemoryAllocator::AllocateFromBlock(MemoryBlock &block, const VkDeviceSize size,
+                                                               const VkDeviceSize alignment) const
+{
+    // First fit over the offset sorted free list
+    for (size_t i = 0; i < block.m_free_ranges.size(); ++i) {
+        FreeRange &range{block.m_free_ranges[i]};
+
+        const VkDeviceSize offset{internal::align_memory_offset(range.m_offset, alignment)};
+        const VkDeviceSize padding{offset - range.m_offset};
+        if (padding + size > range.m_size) {
+            continue;
+        }
+
+        const VkDeviceSize range_end{range.m_offset + range.m_size};
+        const VkDeviceSize allocation_end{offset + size};
+
+        // Alignment padding at the front stays free, as does any tail remainder
+        if (padding > 0 && allocation_end < range_end) {
+            range.m_size = padding;
+            block.m_free_ranges.insert(block.m_free_ranges.begin() + static_cast<std::ptrdiff_t>(i) + 1,
+                                       FreeRange{allocation_end, range_end - allocation_end});
+        }
+        else if (padding > 0) {
+            range.m_size = padding;
+        }
+        else if (allocation_end < range_end) {
+            range.m_offset = allocation_end;
+            range.m_size = range_end - allocation_end;
+        }
+        else {
+            block.m_free_ranges.erase(block.m_free_ranges.begin() + static_cast<std::ptrdiff_t>(i));
+        }
+
+        block.m_used += size;
+        ++block.m_allocation_count;
+
+        return offset;
+    }
+
+    return std::nullopt;
+}
+
+void MemoryAllocator::FreeToBlock(MemoryBlock &block, const VkDeviceSize offset, const VkDeviceSize size) const
+{
+    auto next{std::ranges::lower_bound(block.m_free_ranges, offset, {}, &FreeRange::m_offset)};
+    auto inserted{block.m_free_ranges.insert(next, FreeRange{offset, size})};
+
+    // Coalesce with the following range
+    if (auto following{inserted + 1};
+        following != block.m_free_ranges.end() && inserted->m_offset + inserted->m_size == following->m_offset) {
+        inserted->m_size += following->m_size;
+        block.m_free_ranges.erase(following);
+    }
+
+    // Coalesce with the preceding range
+    if (inserted != block.m_free_ranges.begin()) {
+        if (auto preceding{inserted - 1}; preceding->m_offset + preceding->m_size == inserted->m_offset) {
+            preceding->m_size += inserted->m_size;
+            block.m_free_ranges.erase(inserted);
+        }
+    }
+
+    block.m_used -= size;
+    --block.m_allocation_count;
+}
+
+void MemoryAllocator::DestroyBlock(const u32 block_index)
+{
+    std::unique_ptr<MemoryBlock> &block{m_blocks[block_index]};
+    if (!block) {
+        return;
+    }
+
+    if (block->p_mapped) {
+        vkUnmapMemory(p_device, block->p_memory);
+    }
+
+    vkFreeMemory(p_device, block->p_memory, nullptr);
+    block.reset();
+
+    ENGINE_LOG_DEBUG("Memory block {} destroyed.", block_index);
+}
+
+} // namespace gouda::vk
@@ -0,0 +1,173 @@
+/**
+ * @file vk_pipeline_cache.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine vulkan pipeline cache implementation
+ */
+#include "renderers/vulkan/vk_pipeline_cache.hpp"
+
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include "debug/logger.hpp"
+#include "renderers/vulkan/vk_device.hpp"
+#include "renderers/vulkan/vk_utils.hpp"
+#include "utils/filesystem.hpp"
+#include "utils/hash.hpp"
+#include "utils/mapped_file.hpp"
+
+namespace gouda::vk {
+
+namespace internal {
+
+// "GPCH", bump FILE_VERSION whenever the header layout changes
+constexpr u32 FILE_MAGIC{0x48435047};
+constexpr u32 FILE_VERSION{1};
+
+struct PipelineCacheFileHeader {
+    u32 magic;
+    u32 version;
+    u32 vendor_id;
+    u32 device_id;
+    u32 driver_version;
+    u8 pipeline_cache_uuid[VK_UUID_SIZE];
+    u32 _pad0;
+    u64 data_size;
+    u64 checksum; // FNV-1a of the driver data, catches truncated or partially written files
+};
+
+static_assert(std::is_trivially_copyable_v<PipelineCacheFileHeader>);
+
+static PipelineCacheFileHeader make_header(const VkPhysicalDeviceProperties &properties,
+                                           const std::span<const std::byte> data)
+{
+    PipelineCacheFileHeader header{};
+    header.magic = FILE_MAGIC;
+    header.version = FILE_VERSION;
+    header.vendor_id = properties.vendorID;
+    header.device_id = properties.deviceID;
+    header.driver_version = properties.driverVersion;
+    std::memcpy(header.pipeline_cache_uuid, properties.pipelineCacheUUID, VK_UUID_SIZE);
+    header.data_size = data.size();
+    header.checksum = utils::fnv1a(data);
+    return header;
+}
+
+} // namespace internal
+
+PipelineCache::PipelineCache(Device *device, StringView filepath)
+    : p_device{device}, m_filepath{filepath}, p_cache{VK_NULL_HANDLE}
+{
+    // Only needed until the driver has copied it into the cache object
+    const auto file{fs::MappedFile::Open(m_filepath)};
+    const std::span<const std::byte> file_data{file ? file->GetData() : std::span<const std::byte>{}};
+
+    // Anything that does not match this device and driver is dropped, the driver then starts from an empty cache
+    std::span<const std::byte> initial_data;
+    if (!file_data.empty()) {
+        if (IsValid(file_data)) {
+            initial_data = file_data.subspan(sizeof(internal::PipelineCacheFileHeader));
+            ENGINE_LOG_DEBUG("Pipeline cache loaded from '{}': {} bytes.", m_filepath, initial_data.size());
+        }
+        else {
+            ENGINE_LOG_WARNING("Pipeline cache '{}' is invalid or from another device/driver, ignoring it.",
+                               m_filepath);
+        }
+    }
+
+    const VkPipelineCacheCreateInfo create_info{.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+                                                .pNext = nullptr,
+                                                .flags = 0,
+                                                .initialDataSize = initial_data.size(),
+                                                .pInitialData = initial_data.empty() ? nullptr : initial_data.data()};
+
+    if (const VkResult result{vkCreatePipelineCache(p_device->GetDevice(), &create_info, nullptr, &p_cache)};
+        result != VK_SUCCESS) {
+        CHECK_VK_RESULT(result, "vkCreatePipelineCache");
+    }
+}
+
+PipelineCache::~PipelineCache()
+{
+    if (p_cache != VK_NULL_HANDLE) {
+        vkDestroyPipelineCache(p_device->GetDevice(), p_cache, nullptr);
+        ENGINE_LOG_DEBUG("Pipeline cache destroyed.");
+    }
+}
+
+bool PipelineCache::Save() const
+{
+    size_t data_size{0};
+    VkResult result{vkGetPipelineCacheData(p_device->GetDevice(), p_cache, &data_size, nullptr)};
+    if (result != VK_SUCCESS || data_size == 0) {
+        ENGINE_LOG_WARNING("Failed to query pipeline cache size. Error code: {}", vk_result_to_string(result));
+        return false;
+    }
+
+    // The engine header goes first, the driver writes its data straight behind it
+    constexpr size_t header_size{sizeof(internal::PipelineCacheFileHeader)};
+    std::vector<std::byte> file_data(header_size + data_size);
+    result = vkGetPipelineCacheData(p_device->GetDevice(), p_cache, &data_size, file_data.data() + header_size);
+    if (result != VK_SUCCESS) {
+        ENGINE_LOG_WARNING("Failed to read pipeline cache data. Error code: {}", vk_result_to_string(result));
+        return false;
+    }
+    file_data.resize(header_size + data_size);
+
+    const internal::PipelineCacheFileHeader header{internal::make_header(
+        p_device->GetSelectedPhysicalDevice().m_device_properties,
+        std::span<const std::byte>{file_data}.subspan(header_size))};
+    std::memcpy(file_data.data(), &header, header_size);
+
+    if (const FilePath directory{FilePath{m_filepath}.parent_path()}; !directory.empty()) {
+        if (auto directory_result = fs::EnsureDirectoryExists(directory, true); !directory_result.has_value()) {
+            ENGINE_LOG_WARNING("Failed to create pipeline cache directory: {}",
+                               fs::error_to_string(directory_result.error()));
+            return false;
+        }
+    }
+
+    if (auto write_result = fs::WriteBinaryFile(m_filepath, std::span<const std::byte>{file_data});
+        !write_result.has_value()) {
+        ENGINE_LOG_WARNING("Failed to write pipeline cache '{}': {}", m_filepath,
+                           fs::error_to_string(write_result.error()));
+        return false;
+    }
+
+    ENGINE_LOG_DEBUG("Pipeline cache saved to '{}': {} bytes.", m_filepath, data_size);
+    return true;
+}
+
+bool PipelineCache::IsValid(const std::span<const std::byte> file_data) const
+{
+    constexpr size_t header_size{sizeof(internal::PipelineCacheFileHeader)};
+    if (file_data.size() < header_size + sizeof(VkPipelineCacheHeaderVersionOne)) {
+        return false;
+    }
+
+    internal::PipelineCacheFileHeader header{};
+    std::memcpy(&header, file_data.data(), header_size);
+
+    const std::span<const std::byte> data{file_data.subspan(header_size)};
+    const VkPhysicalDeviceProperties &properties{p_device->GetSelectedPhysicalDevice().m_device_properties};
+    if (header.magic != internal::FILE_MAGIC || header.version != internal::FILE_VERSION ||
+        header.vendor_id != properties.vendorID || header.device_id != properties.deviceID ||
+        header.driver_version != properties.driverVersion ||
+        std::memcmp(header.pipeline_cache_uuid, properties.pipelineCacheUUID, VK_UUID_SIZE) != 0 ||
+        header.data_size != data.size() || header.checksum != utils::fnv1a(data)) {
+        return false;
+    }
+
+    // The driver data carries its own header, drivers are not required to reject a mismatching one themselves
+    VkPipelineCacheHeaderVersionOne cache_header{};
+    std::memcpy(&cache_header, data.data(), sizeof(cache_header));
+
+    return cache_header.headerSize >= sizeof(VkPipelineCacheHeaderVersionOne) &&
+           cache_header.headerSize <= data.size() &&
+           cache_header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+           cache_header.vendorID == properties.vendorID && cache_header.deviceID == properties.deviceID &&
+           std::memcmp(cache_header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
+
+} // namespace gouda::vk
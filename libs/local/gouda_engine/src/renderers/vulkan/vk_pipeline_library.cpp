@@ -0,0 +1,90 @@
+/**
+ * @file vk_pipeline_library.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine vulkan graphics pipeline library implementation
+ */
+#include "renderers/vulkan/vk_pipeline_library.hpp"
+
+#include "debug/logger.hpp"
+#include "debug/profiler.hpp"
+#include "renderers/vulkan/vk_utils.hpp"
+
+namespace gouda::vk {
+
+namespace internal {
+
+constexpr std::array<VkGraphicsPipelineLibraryFlagsEXT, PIPELINE_LIBRARY_PART_COUNT> LIBRARY_PART_FLAGS{
+    VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT,
+    VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT,
+    VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT,
+    VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT};
+
+constexpr std::array<StringView, PIPELINE_LIBRARY_PART_COUNT> LIBRARY_PART_NAMES{
+    "vertex input", "pre-rasterization", "fragment shader", "fragment output"};
+
+} // namespace internal
+
+PipelineLibraryCache::PipelineLibraryCache(const VkDevice device, const VkPipelineCache pipeline_cache)
+    : p_device{device}, p_pipeline_cache{pipeline_cache}
+{
+}
+
+PipelineLibraryCache::~PipelineLibraryCache()
+{
+    for (const FlatHashMap<u64, VkPipeline> &parts : m_parts) {
+        for (const auto &[key, pipeline] : parts) {
+            vkDestroyPipeline(p_device, pipeline, nullptr);
+        }
+    }
+}
+
+VkPipeline PipelineLibraryCache::GetOrCreate(const PipelineLibraryPart part, const u64 key,
+                                             const VkGraphicsPipelineCreateInfo &create_info)
+{
+    FlatHashMap<u64, VkPipeline> &parts{m_parts[static_cast<size_t>(part)]};
+    {
+        std::lock_guard lock{m_mutex};
+        if (const VkPipeline *pipeline{parts.get(key)}) {
+            return *pipeline;
+        }
+    }
+
+    ENGINE_PROFILE_SCOPE("Create pipeline library part");
+
+    const VkGraphicsPipelineLibraryCreateInfoEXT library_info{
+        .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_LIBRARY_CREATE_INFO_EXT,
+        .pNext = create_info.pNext,
+        .flags = internal::LIBRARY_PART_FLAGS[static_cast<size_t>(part)]};
+    VkGraphicsPipelineCreateInfo part_info{create_info};
+    part_info.pNext = &library_info;
+    part_info.flags |= VK_PIPELINE_CREATE_LIBRARY_BIT_KHR;
+
+    VkPipeline pipeline{VK_NULL_HANDLE};
+    if (const VkResult result{vkCreateGraphicsPipelines(p_device, p_pipeline_cache, 1, &part_info, nullptr, &pipeline)};
+        result != VK_SUCCESS) {
+        ENGINE_LOG_ERROR("Failed to create the {} pipeline library part: {}",
+                         internal::LIBRARY_PART_NAMES[static_cast<size_t>(part)], vk_result_to_string(result));
+        return VK_NULL_HANDLE;
+    }
+
+    // Another thread may have built the same part meanwhile, the first one in is kept
+    std::lock_guard lock{m_mutex};
+    const auto [it, is_inserted]{parts.try_emplace(key, pipeline)};
+    if (!is_inserted) {
+        vkDestroyPipeline(p_device, pipeline, nullptr);
+    }
+    return it->second;
+}
+
+size_t PipelineLibraryCache::GetPartCount() const
+{
+    std::lock_guard lock{m_mutex};
+    size_t count{0};
+    for (const FlatHashMap<u64, VkPipeline> &parts : m_parts) {
+        count += parts.size();
+    }
+    return count;
+}
+
+} // namespace gouda::vk
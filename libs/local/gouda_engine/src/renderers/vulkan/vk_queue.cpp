@@ -1,36 +1,80 @@
 #include "renderers/vulkan/vk_queue.hpp"
 
+#include <array>
+#include <utility>
+
 #include <vulkan/vulkan.h>
 
 #include "debug/assert.hpp"
 #include "debug/logger.hpp"
+#include "debug/throw.hpp"
 #include "renderers/vulkan/gouda_vk_wrapper.hpp"
 #include "renderers/vulkan/vk_device.hpp"
-#include "renderers/vulkan/vk_fence.hpp"
+#include "renderers/vulkan/vk_semaphore.hpp"
 #include "renderers/vulkan/vk_swapchain.hpp"
 #include "renderers/vulkan/vk_utils.hpp"
-#include "renderers/vulkan/vk_semaphore.hpp"
 
 namespace gouda::vk {
 
-Queue::Queue() : p_device{nullptr}, p_swapchain{nullptr}, p_queue{VK_NULL_HANDLE}
+Queue::Queue()
+    : p_device{nullptr},
+      p_swapchain{nullptr},
+      p_queue{VK_NULL_HANDLE},
+      m_queue_family{0},
+      m_frames_in_flight{0},
+      p_timeline_semaphore{nullptr},
+      m_timeline_value{NO_TIMELINE_VALUE},
+      m_present_id{0},
+      m_reported_suboptimal{false}
 {
 }
 
 Queue::~Queue() { Destroy(); }
 
-void Queue::Initialize(Device *device, Swapchain *swapchain, const u32 queue_family, const u32 queue_index)
+void Queue::Initialize(Device *device, Swapchain *swapchain, const u32 queue_family, const u32 queue_index,
+                       const u32 frames_in_flight)
 {
+    ASSERT(frames_in_flight > 0 && frames_in_flight <= MAX_FRAMES_IN_FLIGHT, "Frames in flight out of bounds!");
+
     p_device = device;
     p_swapchain = swapchain;
+    m_queue_family = queue_family;
+    m_frames_in_flight = frames_in_flight;
 
     vkGetDeviceQueue(device->GetDevice(), queue_family, queue_index, &p_queue);
 
-    p_present_complete_semaphores.resize(p_swapchain->GetImageCount());
-    p_render_complete_semaphores.resize(p_swapchain->GetImageCount());
     CreateSemaphores();
 }
 
+void Queue::Initialize(Device *device, const u32 queue_family, const u32 queue_index)
+{
+    p_device = device;
+    p_swapchain = nullptr;
+    m_queue_family = queue_family;
+    m_frames_in_flight = 0;
+
+    vkGetDeviceQueue(device->GetDevice(), queue_family, queue_index, &p_queue);
+
+    // No swapchain, so only the timeline semaphore is needed
+    CreateSemaphores();
+}
+
+void Queue::SetSwapchain(Swapchain *swapchain)
+{
+    p_swapchain = swapchain;
+    m_reported_suboptimal = false;
+
+    // The image count may change when the swapchain is recreated. Frames still in flight signal the old semaphores
+    // and their presents wait on them, so they are only destroyed once the queue has passed those frames.
+    if (p_render_complete_semaphores.size() != p_swapchain->GetImageCount()) {
+        if (!p_render_complete_semaphores.empty()) {
+            m_retired_semaphores.push_back({m_timeline_value, std::move(p_render_complete_semaphores)});
+            p_render_complete_semaphores.clear();
+        }
+        CreateRenderCompleteSemaphores();
+    }
+}
+
 void Queue::Destroy()
 {
     if (p_device) {
@@ -39,14 +83,17 @@ void Queue::Destroy()
             semaphore = VK_NULL_HANDLE;
         }
 
+        p_present_complete_semaphores.clear();
+
         ENGINE_LOG_DEBUG("Present complete semaphores destroyed");
 
-        for (auto &semaphore : p_render_complete_semaphores) {
-            vkDestroySemaphore(p_device->GetDevice(), semaphore, nullptr);
-            semaphore = VK_NULL_HANDLE;
-        }
+        DestroyRenderCompleteSemaphores();
+        DestroyRetiredSemaphores(true);
 
         ENGINE_LOG_DEBUG("Render complete semaphores destroyed");
+
+        p_timeline_semaphore.reset();
+        m_timeline_value = NO_TIMELINE_VALUE;
     }
 
     ENGINE_LOG_DEBUG("Queue destroyed.");
@@ -54,7 +101,8 @@ void Queue::Destroy()
 
 u32 Queue::AcquireNextImage(const u32 frame_index)
 {
-    ASSERT(frame_index < MAX_FRAMES_IN_FLIGHT, "Frame index out of bounds!");
+    ASSERT(p_swapchain, "Cannot acquire an image on a queue without a swapchain!");
+    ASSERT(frame_index < m_frames_in_flight, "Frame index out of bounds!");
 
     u32 image_index{0};
     const VkResult result{vkAcquireNextImageKHR(p_device->GetDevice(), *p_swapchain->Get(), constants::u64_max,
@@ -66,14 +114,16 @@ u32 Queue::AcquireNextImage(const u32 frame_index)
 
     if (result == VK_SUBOPTIMAL_KHR) {
         // Swapchain is still usable, but should be recreated soon
-        ENGINE_LOG_WARNING("vkAcquireNextImageKHR returned VK_SUBOPTIMAL_KHR. Consider recreating swapchain.");
+        if (!std::exchange(m_reported_suboptimal, true)) {
+            ENGINE_LOG_WARNING("vkAcquireNextImageKHR returned VK_SUBOPTIMAL_KHR. Consider recreating swapchain.");
+        }
         return image_index;
     }
 
     if (result == VK_ERROR_OUT_OF_DATE_KHR) {
-        // Swapchain is no longer valid and must be recreated
+        // Rendering stops until the swapchain is recreated, which is logged rather than each frame skipped
         ENGINE_LOG_WARNING("vkAcquireNextImageKHR returned VK_ERROR_OUT_OF_DATE_KHR. Swapchain recreation needed.");
-        // HandleSwapchainRecreation();
+        p_swapchain->SetInvalid();
         return constants::u32_max; // Special value indicating swapchain recreation is needed
     }
 
@@ -94,76 +144,211 @@ u32 Queue::AcquireNextImage(const u32 frame_index)
     return constants::u32_max; // Return invalid index to prevent further errors
 }
 
-void Queue::Submit(const VkCommandBuffer command_buffer, const u32 frame_index, const Fence *fence)
+u64 Queue::Submit(const VkCommandBuffer command_buffer, const u32 frame_index, const u32 image_index)
 {
-    ASSERT(frame_index < MAX_FRAMES_IN_FLIGHT, "Frame index out of bounds!");
+    return Submit(command_buffer, frame_index, image_index, VK_NULL_HANDLE, NO_TIMELINE_VALUE, 0);
+}
+
+u64 Queue::Submit(const VkCommandBuffer command_buffer, const u32 frame_index, const u32 image_index,
+                  const VkSemaphore wait_semaphore, const u64 wait_value, const VkPipelineStageFlags wait_stage)
+{
+    ASSERT(frame_index < m_frames_in_flight, "Frame index out of bounds!");
+    ASSERT(image_index < p_render_complete_semaphores.size(), "Image index out of bounds!");
+
+    const u64 signal_value{++m_timeline_value};
+
+    // Binary semaphores ignore their entry in the value arrays
+    const bool has_wait{wait_semaphore != VK_NULL_HANDLE && wait_value != NO_TIMELINE_VALUE};
+    const std::array<VkSemaphore, 2> wait_semaphores{p_present_complete_semaphores[frame_index], wait_semaphore};
+    const std::array<VkPipelineStageFlags, 2> wait_stages{VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, wait_stage};
+    const std::array<u64, 2> wait_values{0, wait_value};
+    const u32 wait_count{has_wait ? 2u : 1u};
+
+    const std::array<VkSemaphore, 2> signal_semaphores{p_render_complete_semaphores[image_index],
+                                                       p_timeline_semaphore->Get()};
+    const std::array<u64, 2> signal_values{0, signal_value};
+
+    const VkTimelineSemaphoreSubmitInfo timeline_info{.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+                                                      .pNext = nullptr,
+                                                      .waitSemaphoreValueCount = wait_count,
+                                                      .pWaitSemaphoreValues = wait_values.data(),
+                                                      .signalSemaphoreValueCount =
+                                                          static_cast<u32>(signal_values.size()),
+                                                      .pSignalSemaphoreValues = signal_values.data()};
 
-    constexpr VkPipelineStageFlags wait_stage{VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
     VkSubmitInfo submit_info{};
     submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    submit_info.pNext = nullptr;
-    submit_info.waitSemaphoreCount = 1;
-    submit_info.pWaitSemaphores = &p_present_complete_semaphores[frame_index];
-    submit_info.pWaitDstStageMask = &wait_stage;
+    submit_info.pNext = &timeline_info;
+    submit_info.waitSemaphoreCount = wait_count;
+    submit_info.pWaitSemaphores = wait_semaphores.data();
+    submit_info.pWaitDstStageMask = wait_stages.data();
     submit_info.commandBufferCount = 1;
     submit_info.pCommandBuffers = &command_buffer;
-    submit_info.signalSemaphoreCount = 1;
-    submit_info.pSignalSemaphores = &p_render_complete_semaphores[frame_index];
+    submit_info.signalSemaphoreCount = static_cast<u32>(signal_semaphores.size());
+    submit_info.pSignalSemaphores = signal_semaphores.data();
 
-    if (const VkResult result{vkQueueSubmit(p_queue, 1, &submit_info, fence->Get())}; result != VK_SUCCESS) {
+    if (const VkResult result{vkQueueSubmit(p_queue, 1, &submit_info, VK_NULL_HANDLE)}; result != VK_SUCCESS) {
         CHECK_VK_RESULT(result, "vkQueueSubmit");
     }
+
+    return signal_value;
 }
 
-void Queue::Submit(const VkCommandBuffer command_buffer, const Fence *fence) const
+u64 Queue::Submit(const VkCommandBuffer command_buffer)
 {
+    return Submit(command_buffer, VK_NULL_HANDLE, NO_TIMELINE_VALUE, 0);
+}
+
+u64 Queue::Submit(const VkCommandBuffer command_buffer, const VkSemaphore wait_semaphore, const u64 wait_value,
+                  const VkPipelineStageFlags wait_stage)
+{
+    const u64 signal_value{++m_timeline_value};
+    const VkSemaphore timeline_semaphore{p_timeline_semaphore->Get()};
+
+    // Waiting on the initial value is always satisfied, skip it entirely
+    const bool has_wait{wait_semaphore != VK_NULL_HANDLE && wait_value != NO_TIMELINE_VALUE};
+
+    const VkTimelineSemaphoreSubmitInfo timeline_info{.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+                                                      .pNext = nullptr,
+                                                      .waitSemaphoreValueCount = has_wait ? 1u : 0u,
+                                                      .pWaitSemaphoreValues = has_wait ? &wait_value : nullptr,
+                                                      .signalSemaphoreValueCount = 1,
+                                                      .pSignalSemaphoreValues = &signal_value};
+
     VkSubmitInfo submit_info{};
     submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    submit_info.pNext = nullptr;
-    submit_info.waitSemaphoreCount = 0;
-    submit_info.pWaitSemaphores = nullptr;
-    submit_info.pWaitDstStageMask = nullptr;
+    submit_info.pNext = &timeline_info;
+    submit_info.waitSemaphoreCount = has_wait ? 1u : 0u;
+    submit_info.pWaitSemaphores = has_wait ? &wait_semaphore : nullptr;
+    submit_info.pWaitDstStageMask = has_wait ? &wait_stage : nullptr;
     submit_info.commandBufferCount = 1;
     submit_info.pCommandBuffers = &command_buffer;
-    submit_info.signalSemaphoreCount = 0;
-    submit_info.pSignalSemaphores = nullptr;
+    submit_info.signalSemaphoreCount = 1;
+    submit_info.pSignalSemaphores = &timeline_semaphore;
 
-    if (const VkResult result{vkQueueSubmit(p_queue, 1, &submit_info, fence->Get())}; result != VK_SUCCESS) {
+    if (const VkResult result{vkQueueSubmit(p_queue, 1, &submit_info, VK_NULL_HANDLE)}; result != VK_SUCCESS) {
         CHECK_VK_RESULT(result, "vkQueueSubmit");
     }
+
+    return signal_value;
 }
 
-void Queue::Present(const u32 image_index, const u32 frame_index)
+void Queue::Present(const u32 image_index)
 {
-    ASSERT(frame_index < MAX_FRAMES_IN_FLIGHT, "Frame index out of bounds!");
+    ASSERT(p_swapchain, "Cannot present on a queue without a swapchain!");
+    ASSERT(image_index < p_render_complete_semaphores.size(), "Image index out of bounds!");
 
     VkPresentInfoKHR present_info{};
     present_info.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
     present_info.pNext = nullptr;
     present_info.waitSemaphoreCount = 1;
-    present_info.pWaitSemaphores = &p_render_complete_semaphores[frame_index];
+    present_info.pWaitSemaphores = &p_render_complete_semaphores[image_index];
     present_info.swapchainCount = 1;
     present_info.pSwapchains = p_swapchain->Get();
     present_info.pImageIndices = &image_index;
     present_info.pResults = nullptr;
 
-    if (const VkResult result{vkQueuePresentKHR(p_queue, &present_info)};
-        result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR) {
-        ENGINE_LOG_ERROR("Swapchain outdated after presentation, recreating...");
+    // Numbered so frame pacing can wait for this present to reach the screen
+    const u64 present_id{m_present_id + 1};
+    const VkPresentIdKHR present_id_info{.sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR,
+                                         .pNext = nullptr,
+                                         .swapchainCount = 1,
+                                         .pPresentIds = &present_id};
+    if (p_device->HasPresentWait()) {
+        present_info.pNext = &present_id_info;
+    }
+
+    const VkResult result{vkQueuePresentKHR(p_queue, &present_info)};
+    DestroyRetiredSemaphores(false);
+    if (p_device->HasPresentWait() && (result == VK_SUCCESS || result == VK_SUBOPTIMAL_KHR)) {
+        m_present_id = present_id;
+    }
+
+    if (result == VK_ERROR_OUT_OF_DATE_KHR) {
+        ENGINE_LOG_WARNING("Swapchain out of date after presentation, rendering paused until it is recreated.");
+        p_swapchain->SetInvalid();
+    }
+    else if (result == VK_SUBOPTIMAL_KHR) {
+        if (!std::exchange(m_reported_suboptimal, true)) {
+            ENGINE_LOG_WARNING("vkQueuePresentKHR returned VK_SUBOPTIMAL_KHR. Consider recreating swapchain.");
+        }
     }
     else {
         CHECK_VK_RESULT(result, "vkQueuePresentKHR");
     }
 }
 
+void Queue::WaitForValue(const u64 value, const u64 timeout) const
+{
+    ASSERT(value <= m_timeline_value, "Waiting on a timeline value that was never submitted!");
+
+    if (value == NO_TIMELINE_VALUE) {
+        return;
+    }
+
+    if (!p_timeline_semaphore->Wait(value, timeout)) {
+        ENGINE_LOG_WARNING("Timed out waiting for queue timeline value {} (completed: {}).", value,
+                           GetCompletedValue());
+    }
+}
+
+bool Queue::IsComplete(const u64 value) const { return value == NO_TIMELINE_VALUE || GetCompletedValue() >= value; }
+
+u64 Queue::GetCompletedValue() const { return p_timeline_semaphore->GetCounterValue(); }
+
+VkSemaphore Queue::GetTimelineSemaphore() const noexcept
+{
+    return p_timeline_semaphore ? p_timeline_semaphore->Get() : VK_NULL_HANDLE;
+}
+
 void Queue::WaitIdle() const { vkQueueWaitIdle(p_queue); }
 
 void Queue::CreateSemaphores()
 {
-    for (u32 i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
-        CreateSemaphore(p_device->GetDevice(), p_present_complete_semaphores[i]);
-        CreateSemaphore(p_device->GetDevice(), p_render_complete_semaphores[i]);
+    p_present_complete_semaphores.resize(m_frames_in_flight);
+    for (auto &semaphore : p_present_complete_semaphores) {
+        CreateSemaphore(p_device->GetDevice(), semaphore);
     }
+
+    CreateRenderCompleteSemaphores();
+
+    m_timeline_value = NO_TIMELINE_VALUE;
+    p_timeline_semaphore = std::make_unique<Semaphore>(p_device);
+    if (!p_timeline_semaphore->Create(VK_SEMAPHORE_TYPE_TIMELINE, m_timeline_value)) {
+        ENGINE_THROW("Failed to create queue timeline semaphore.");
+    }
+}
+
+void Queue::CreateRenderCompleteSemaphores()
+{
+    if (!p_swapchain) {
+        return;
+    }
+
+    p_render_complete_semaphores.resize(p_swapchain->GetImageCount());
+    for (auto &semaphore : p_render_complete_semaphores) {
+        CreateSemaphore(p_device->GetDevice(), semaphore);
+    }
+}
+
+void Queue::DestroyRetiredSemaphores(const bool destroy_all)
+{
+    while (!m_retired_semaphores.empty() && (destroy_all || IsComplete(m_retired_semaphores.front().timeline_value))) {
+        for (const VkSemaphore semaphore : m_retired_semaphores.front().semaphores) {
+            vkDestroySemaphore(p_device->GetDevice(), semaphore, nullptr);
+        }
+        m_retired_semaphores.pop_front();
+    }
+}
+
+void Queue::DestroyRenderCompleteSemaphores()
+{
+    for (auto &semaphore : p_render_complete_semaphores) {
+        vkDestroySemaphore(p_device->GetDevice(), semaphore, nullptr);
+        semaphore = VK_NULL_HANDLE;
+    }
+
+    p_render_complete_semaphores.clear();
 }
 
 } // namespace gouda::vk
\ No newline at end of file
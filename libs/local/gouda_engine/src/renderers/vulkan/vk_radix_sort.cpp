@@ -0,0 +1,135 @@
+/**
+ * @file vk_radix_sort.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine vulkan GPU radix sort implementation
+ */
+#include "renderers/vulkan/vk_radix_sort.hpp"
+
+#include "debug/assert.hpp"
+#include "debug/logger.hpp"
+#include "renderers/vulkan/vk_buffer_manager.hpp"
+#include "renderers/vulkan/vk_device.hpp"
+
+namespace gouda::vk {
+
+GpuRadixSort::GpuRadixSort(Renderer &renderer, Device *device, const BufferManager *buffer_manager,
+                           const Shader *histogram_shader, const Shader *scan_shader, const Shader *scatter_shader,
+                           const u32 max_count, const u32 frame_count, const std::span<const Buffer> count_buffers,
+                           const u32 count_offset, const std::span<const u32> queue_families)
+    : p_device{device},
+      m_max_count{max_count},
+      m_block_count{(max_count + BLOCK_SIZE - 1) / BLOCK_SIZE},
+      m_key_buffers{},
+      m_value_buffers{},
+      m_histogram_buffers{},
+      p_histogram_pipeline{nullptr},
+      p_scan_pipeline{nullptr},
+      p_scatter_pipeline{nullptr},
+      m_pass_params{}
+{
+    ASSERT(max_count > 0, "Radix sort needs room for at least one key.");
+    ASSERT(count_buffers.size() == 1 || count_buffers.size() == frame_count,
+           "Radix sort needs one shared count buffer or one per frame slot.");
+
+    // Only ever touched by the GPU
+    const VkDeviceSize buffer_size{GetBufferSize()};
+    const VkDeviceSize histogram_size{sizeof(u32) * (1u << RADIX_BITS) * static_cast<VkDeviceSize>(m_block_count)};
+    for (u32 i = 0; i < 2; ++i) {
+        m_key_buffers[i].resize(frame_count);
+        m_value_buffers[i].resize(frame_count);
+    }
+    m_histogram_buffers.resize(frame_count);
+    for (u32 frame = 0; frame < frame_count; ++frame) {
+        for (u32 i = 0; i < 2; ++i) {
+            m_key_buffers[i][frame] = buffer_manager->CreateBuffer(buffer_size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                                                   VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, queue_families);
+            m_value_buffers[i][frame] = buffer_manager->CreateBuffer(
+                buffer_size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, queue_families);
+        }
+        m_histogram_buffers[frame] = buffer_manager->CreateBuffer(
+            histogram_size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, queue_families);
+    }
+
+    // Descriptor set 2 * frame + parity, odd passes read what the even ones wrote. The arrays only carry the handles
+    // for the descriptor writes, the buffers are owned and destroyed above.
+    const u32 set_count{2 * frame_count};
+    Vector<Buffer> counts(set_count);
+    Vector<Buffer> keys_in(set_count);
+    Vector<Buffer> values_in(set_count);
+    Vector<Buffer> keys_out(set_count);
+    Vector<Buffer> values_out(set_count);
+    Vector<Buffer> histograms(set_count);
+    for (u32 set = 0; set < set_count; ++set) {
+        const u32 frame{set / 2};
+        const u32 parity{set % 2};
+        counts[set] = count_buffers[count_buffers.size() == 1 ? 0 : frame];
+        keys_in[set] = m_key_buffers[parity][frame];
+        values_in[set] = m_value_buffers[parity][frame];
+        keys_out[set] = m_key_buffers[1 - parity][frame];
+        values_out[set] = m_value_buffers[1 - parity][frame];
+        histograms[set] = m_histogram_buffers[frame];
+    }
+
+    const VkDeviceSize count_size{sizeof(u32) * (count_offset + 1)};
+    const std::array<ComputeBufferBinding, 3> histogram_bindings{{
+        {counts, count_size},
+        {keys_in, buffer_size},
+        {histograms, histogram_size},
+    }};
+    const std::array<ComputeBufferBinding, 1> scan_bindings{{
+        {histograms, histogram_size},
+    }};
+    const std::array<ComputeBufferBinding, 6> scatter_bindings{{
+        {counts, count_size},
+        {keys_in, buffer_size},
+        {values_in, buffer_size},
+        {keys_out, buffer_size},
+        {values_out, buffer_size},
+        {histograms, histogram_size},
+    }};
+    p_histogram_pipeline = std::make_unique<ComputePipeline>(renderer, device, histogram_shader, histogram_bindings);
+    p_scan_pipeline = std::make_unique<ComputePipeline>(renderer, device, scan_shader, scan_bindings);
+    p_scatter_pipeline = std::make_unique<ComputePipeline>(renderer, device, scatter_shader, scatter_bindings);
+
+    for (u32 pass = 0; pass < PASS_COUNT; ++pass) {
+        m_pass_params[pass] = {.shift = pass * RADIX_BITS, .count_offset = count_offset, .block_count = m_block_count};
+    }
+
+    ENGINE_LOG_DEBUG("GPU radix sort created for {} keys in {} blocks.", max_count, m_block_count);
+}
+
+GpuRadixSort::~GpuRadixSort()
+{
+    p_histogram_pipeline.reset();
+    p_scan_pipeline.reset();
+    p_scatter_pipeline.reset();
+
+    for (u32 i = 0; i < 2; ++i) {
+        for (Buffer &buffer : m_key_buffers[i]) {
+            buffer.Destroy(p_device->GetDevice());
+        }
+        for (Buffer &buffer : m_value_buffers[i]) {
+            buffer.Destroy(p_device->GetDevice());
+        }
+    }
+    for (Buffer &buffer : m_histogram_buffers) {
+        buffer.Destroy(p_device->GetDevice());
+    }
+}
+
+void GpuRadixSort::Record(VkCommandBuffer command_buffer, const u32 frame_index) const
+{
+    // Count, scan and scatter per pass, every dispatch waits for the one before. The scan is a single workgroup.
+    std::array<ComputeDispatch, PASS_COUNT * 3> dispatches{};
+    for (u32 pass = 0; pass < PASS_COUNT; ++pass) {
+        const u32 set_index{2 * frame_index + pass % 2};
+        const std::span<const std::byte> params{std::as_bytes(std::span{&m_pass_params[pass], 1})};
+        dispatches[3 * pass] = {p_histogram_pipeline.get(), set_index, {m_block_count, 1, 1}, params};
+        dispatches[3 * pass + 1] = {p_scan_pipeline.get(), set_index, {1, 1, 1}, params};
+        dispatches[3 * pass + 2] = {p_scatter_pipeline.get(), set_index, {m_block_count, 1, 1}, params};
+    }
+    record_compute_chain(command_buffer, dispatches);
+}
+
+} // namespace gouda::vk
@@ -0,0 +1,781 @@
+/**
+ * @file vk_render_graph.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine vulkan render graph module implementation
+ */
+#include "renderers/vulkan/vk_render_graph.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+#include "debug/assert.hpp"
+#include "debug/logger.hpp"
+#include "debug/throw.hpp"
+#include "renderers/vulkan/vk_buffer_manager.hpp"
+#include "renderers/vulkan/vk_device.hpp"
+#include "renderers/vulkan/vk_queue.hpp"
+#include "renderers/vulkan/vk_texture.hpp"
+#include "renderers/vulkan/vk_utils.hpp"
+
+namespace gouda::vk {
+
+namespace internal {
+
+constexpr VkAccessFlags WRITE_ACCESS_MASK{VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+                                          VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT |
+                                          VK_ACCESS_HOST_WRITE_BIT | VK_ACCESS_MEMORY_WRITE_BIT};
+
+struct UsageInfo {
+    VkPipelineStageFlags stages;
+    VkAccessFlags access;
+    VkImageLayout layout;
+    VkImageUsageFlags image_usage;
+    bool write;
+};
+
+static UsageInfo get_usage_info(const ResourceUsage usage)
+{
+    switch (usage) {
+        case ResourceUsage::None:
+            return {0, 0, VK_IMAGE_LAYOUT_UNDEFINED, 0, false};
+        case ResourceUsage::TransferRead:
+            return {VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                    VK_IMAGE_USAGE_TRANSFER_SRC_BIT, false};
+        case ResourceUsage::TransferWrite:
+            return {VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                    VK_IMAGE_USAGE_TRANSFER_DST_BIT, true};
+        case ResourceUsage::ComputeRead:
+            return {VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_GENERAL,
+                    VK_IMAGE_USAGE_STORAGE_BIT, false};
+        case ResourceUsage::ComputeWrite:
+            return {VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+                    VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_USAGE_STORAGE_BIT, true};
+        case ResourceUsage::ComputeSampled:
+            return {VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT,
+                    VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_USAGE_SAMPLED_BIT, false};
+        case ResourceUsage::IndirectRead:
+            return {VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT, VK_IMAGE_LAYOUT_UNDEFINED,
+                    0, false};
+        case ResourceUsage::VertexRead:
+            return {VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT, VK_IMAGE_LAYOUT_UNDEFINED,
+                    0, false};
+        case ResourceUsage::FragmentRead:
+            return {VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_GENERAL,
+                    VK_IMAGE_USAGE_STORAGE_BIT, false};
+        case ResourceUsage::FragmentSampled:
+            return {VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT,
+                    VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_USAGE_SAMPLED_BIT, false};
+        case ResourceUsage::ColourAttachment:
+            return {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                    VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                    VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT, true};
+        case ResourceUsage::DepthAttachment:
+            return {VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+                    VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                    VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
+                    true};
+        case ResourceUsage::Present:
+            return {VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, 0, false};
+    }
+    return {0, 0, VK_IMAGE_LAYOUT_UNDEFINED, 0, false};
+}
+
+// Writes that read what was there before keep its writers alive as well
+static bool reads_contents(const ResourceUsage usage)
+{
+    return !get_usage_info(usage).write || usage == ResourceUsage::ComputeWrite;
+}
+
+static bool is_depth_format(const VkFormat format)
+{
+    return format == VK_FORMAT_D16_UNORM || format == VK_FORMAT_X8_D24_UNORM_PACK32 || format == VK_FORMAT_D32_SFLOAT ||
+           format == VK_FORMAT_D16_UNORM_S8_UINT || has_stencil_component(format);
+}
+
+static VkImageAspectFlags get_barrier_aspect(const VkFormat format)
+{
+    if (has_stencil_component(format) || format == VK_FORMAT_D16_UNORM_S8_UINT) {
+        return VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+    }
+    return is_depth_format(format) ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT;
+}
+
+static bool lifetimes_overlap(const u32 first_a, const u32 last_a, const u32 first_b, const u32 last_b)
+{
+    return first_a <= last_b && first_b <= last_a;
+}
+
+} // namespace internal
+
+// PassBuilder implementation ---------------------------------------------------------------------------
+RenderGraph::PassBuilder &RenderGraph::PassBuilder::Read(const RenderGraphResource resource, const ResourceUsage usage)
+{
+    ASSERT(resource < p_graph->m_resources.size(), "Render graph resource {} does not exist.", resource);
+    ASSERT(!internal::get_usage_info(usage).write, "Pass reads with a writing usage.");
+
+    Resource &target{p_graph->m_resources[resource]};
+    target.usage |= internal::get_usage_info(usage).image_usage;
+    p_graph->m_passes[m_pass_index].accesses.push_back({resource, usage, false});
+    return *this;
+}
+
+RenderGraph::PassBuilder &RenderGraph::PassBuilder::Write(const RenderGraphResource resource, const ResourceUsage usage)
+{
+    ASSERT(resource < p_graph->m_resources.size(), "Render graph resource {} does not exist.", resource);
+    ASSERT(internal::get_usage_info(usage).write, "Pass writes with a reading usage.");
+
+    Resource &target{p_graph->m_resources[resource]};
+    target.usage |= internal::get_usage_info(usage).image_usage;
+    p_graph->m_passes[m_pass_index].accesses.push_back({resource, usage, true});
+    return *this;
+}
+
+RenderGraph::PassBuilder &RenderGraph::PassBuilder::SetColourAttachment(const RenderGraphResource resource,
+                                                                        const VkAttachmentLoadOp load_op,
+                                                                        const VkClearColorValue clear_colour)
+{
+    ASSERT(resource < p_graph->m_resources.size() && p_graph->m_resources[resource].kind == ResourceKind::Image,
+           "Colour attachment is not a render graph image.");
+
+    Write(resource, ResourceUsage::ColourAttachment);
+    Attachment &attachment{p_graph->m_passes[m_pass_index].colour_attachment};
+    attachment.resource = resource;
+    attachment.load_op = load_op;
+    attachment.clear_value.color = clear_colour;
+    return *this;
+}
+
+RenderGraph::PassBuilder &RenderGraph::PassBuilder::SetDepthAttachment(const RenderGraphResource resource,
+                                                                       const VkAttachmentLoadOp load_op,
+                                                                       const VkClearDepthStencilValue clear_value)
+{
+    ASSERT(resource < p_graph->m_resources.size() && p_graph->m_resources[resource].kind == ResourceKind::Image,
+           "Depth attachment is not a render graph image.");
+
+    Write(resource, ResourceUsage::DepthAttachment);
+    Attachment &attachment{p_graph->m_passes[m_pass_index].depth_attachment};
+    attachment.resource = resource;
+    attachment.load_op = load_op;
+    attachment.clear_value.depthStencil = clear_value;
+    return *this;
+}
+
+RenderGraph::PassBuilder &RenderGraph::PassBuilder::SetRenderingFlags(const VkRenderingFlags flags)
+{
+    p_graph->m_passes[m_pass_index].rendering_flags = flags;
+    return *this;
+}
+
+RenderGraph::PassBuilder &RenderGraph::PassBuilder::SetSideEffects()
+{
+    p_graph->m_passes[m_pass_index].side_effects = true;
+    return *this;
+}
+
+RenderGraph::PassBuilder &RenderGraph::PassBuilder::SetRecord(RecordFunction record)
+{
+    p_graph->m_passes[m_pass_index].record = std::move(record);
+    return *this;
+}
+
+// RenderGraph implementation ---------------------------------------------------------------------------
+RenderGraph::RenderGraph(Device *device, BufferManager *buffer_manager, const Queue *queue)
+    : p_device{device},
+      p_buffer_manager{buffer_manager},
+      p_queue{queue},
+      m_final_src_stages{0},
+      m_final_dst_stages{0},
+      m_culled_pass_count{0},
+      m_barrier_count{0},
+      m_transient_memory_size{0},
+      m_is_compiled{false}
+{
+    ASSERT(p_device, "Device cannot be a null pointer.");
+    ASSERT(p_buffer_manager, "Buffer manager cannot be a null pointer.");
+    ASSERT(p_queue, "Queue cannot be a null pointer.");
+}
+
+RenderGraph::~RenderGraph()
+{
+    DestroyRetired(true);
+    DestroyTransients(m_transients, m_memory_slots);
+}
+
+void RenderGraph::Reset()
+{
+    m_resources.clear();
+    m_passes.clear();
+    m_final_barriers.clear();
+    m_final_src_stages = 0;
+    m_final_dst_stages = 0;
+    m_is_compiled = false;
+}
+
+RenderGraphResource RenderGraph::ImportBuffer(StringView name, const VkBuffer buffer)
+{
+    return AddResource({.name = String{name},
+                        .kind = ResourceKind::Buffer,
+                        .imported = true,
+                        .buffer = buffer,
+                        .image = VK_NULL_HANDLE,
+                        .view = VK_NULL_HANDLE,
+                        .format = VK_FORMAT_UNDEFINED,
+                        .extent = {0, 0},
+                        .usage = 0,
+                        .final_usage = ResourceUsage::None,
+                        .state = {VK_IMAGE_LAYOUT_UNDEFINED, 0, 0, 0, 0},
+                        .first_pass = constants::u32_max,
+                        .last_pass = 0,
+                        .last_read_pass = 0,
+                        .transient_index = constants::u32_max});
+}
+
+RenderGraphResource RenderGraph::ImportImage(StringView name, const ImportedImage &image)
+{
+    // The last use outside the graph is treated like one of its passes, so the first one here waits on it
+    const internal::UsageInfo initial{internal::get_usage_info(image.initial_usage)};
+    ResourceState state{image.keep_contents ? initial.layout : VK_IMAGE_LAYOUT_UNDEFINED, 0, 0, 0, 0};
+    if (initial.write) {
+        state.write_stages = initial.stages;
+        state.write_access = initial.access & internal::WRITE_ACCESS_MASK;
+    }
+    else {
+        state.read_stages = initial.stages;
+        state.read_access = initial.access;
+    }
+
+    return AddResource({.name = String{name},
+                        .kind = ResourceKind::Image,
+                        .imported = true,
+                        .buffer = VK_NULL_HANDLE,
+                        .image = image.image,
+                        .view = image.view,
+                        .format = image.format,
+                        .extent = image.extent,
+                        .usage = 0,
+                        .final_usage = image.final_usage,
+                        .state = state,
+                        .first_pass = constants::u32_max,
+                        .last_pass = 0,
+                        .last_read_pass = 0,
+                        .transient_index = constants::u32_max});
+}
+
+RenderGraphResource RenderGraph::CreateTransientImage(StringView name, const VkFormat format, const VkExtent2D extent)
+{
+    ASSERT(extent.width > 0 && extent.height > 0, "Transient image '{}' has no size.", name);
+
+    return AddResource({.name = String{name},
+                        .kind = ResourceKind::Image,
+                        .imported = false,
+                        .buffer = VK_NULL_HANDLE,
+                        .image = VK_NULL_HANDLE,
+                        .view = VK_NULL_HANDLE,
+                        .format = format,
+                        .extent = extent,
+                        .usage = 0,
+                        .final_usage = ResourceUsage::None,
+                        .state = {VK_IMAGE_LAYOUT_UNDEFINED, 0, 0, 0, 0},
+                        .first_pass = constants::u32_max,
+                        .last_pass = 0,
+                        .last_read_pass = 0,
+                        .transient_index = constants::u32_max});
+}
+
+RenderGraph::PassBuilder RenderGraph::AddPass(StringView name)
+{
+    ASSERT(!m_is_compiled, "Passes cannot be added to a compiled render graph.");
+
+    m_passes.push_back({.name = String{name},
+                        .accesses = {},
+                        .colour_attachment = {},
+                        .depth_attachment = {},
+                        .rendering_flags = 0,
+                        .record = nullptr,
+                        .side_effects = false,
+                        .culled = false,
+                        .memory_src_stages = 0,
+                        .memory_dst_stages = 0,
+                        .memory_barrier = {},
+                        .image_src_stages = 0,
+                        .image_dst_stages = 0,
+                        .image_barriers = {}});
+    return PassBuilder{this, static_cast<u32>(m_passes.size() - 1)};
+}
+
+void RenderGraph::Compile(LinearAllocator &scratch)
+{
+    ASSERT(!m_is_compiled, "Render graph compiled twice without a reset.");
+
+    CullPasses(scratch);
+    PlaceTransients(scratch);
+    PlanBarriers();
+    m_is_compiled = true;
+}
+
+void RenderGraph::Execute(VkCommandBuffer command_buffer)
+{
+    ASSERT(m_is_compiled, "Render graph executed before it was compiled.");
+
+    for (Pass &pass : m_passes) {
+        if (!pass.culled) {
+            RecordPass(command_buffer, pass);
+        }
+    }
+
+    if (!m_final_barriers.empty()) {
+        vkCmdPipelineBarrier(command_buffer, m_final_src_stages, m_final_dst_stages, 0, 0, nullptr, 0, nullptr,
+                             static_cast<u32>(m_final_barriers.size()), m_final_barriers.data());
+    }
+}
+
+void RenderGraph::DestroyRetired(const bool destroy_all)
+{
+    while (!m_retired_transients.empty() &&
+           (destroy_all || p_queue->IsComplete(m_retired_transients.front().timeline_value))) {
+        RetiredTransients &retired{m_retired_transients.front()};
+        DestroyTransients(retired.images, retired.memory_slots);
+        m_retired_transients.pop_front();
+    }
+}
+
+VkImage RenderGraph::GetImage(const RenderGraphResource resource) const
+{
+    ASSERT(resource < m_resources.size() && m_resources[resource].kind == ResourceKind::Image,
+           "Render graph resource {} is not an image.", resource);
+    return m_resources[resource].image;
+}
+
+VkImageView RenderGraph::GetImageView(const RenderGraphResource resource) const
+{
+    ASSERT(resource < m_resources.size() && m_resources[resource].kind == ResourceKind::Image,
+           "Render graph resource {} is not an image.", resource);
+    return m_resources[resource].view;
+}
+
+u32 RenderGraph::AddResource(Resource &&resource)
+{
+    ASSERT(!m_is_compiled, "Resources cannot be added to a compiled render graph.");
+
+    m_resources.push_back(std::move(resource));
+    return static_cast<u32>(m_resources.size() - 1);
+}
+
+void RenderGraph::CullPasses(LinearAllocator &scratch)
+{
+    // Walked backwards, a pass is needed once a later surviving pass reads something it writes
+    const std::span<u8> needed{scratch.AllocateSpan<u8>(m_resources.size(), 0)};
+    m_culled_pass_count = 0;
+
+    for (u32 pass_index = static_cast<u32>(m_passes.size()); pass_index-- > 0;) {
+        Pass &pass{m_passes[pass_index]};
+
+        bool keep{pass.side_effects};
+        for (const Access &access : pass.accesses) {
+            if (access.write && (m_resources[access.resource].imported || needed[access.resource] != 0)) {
+                keep = true;
+            }
+        }
+
+        pass.culled = !keep;
+        if (pass.culled) {
+            ++m_culled_pass_count;
+            continue;
+        }
+
+        for (const Access &access : pass.accesses) {
+            if (internal::reads_contents(access.usage)) {
+                needed[access.resource] = 1;
+            }
+        }
+        for (const Attachment *attachment : {&pass.colour_attachment, &pass.depth_attachment}) {
+            if (attachment->resource != INVALID_RENDER_GRAPH_RESOURCE &&
+                attachment->load_op == VK_ATTACHMENT_LOAD_OP_LOAD) {
+                needed[attachment->resource] = 1;
+            }
+        }
+    }
+
+    // Lifetimes and the last reads over the surviving passes
+    for (u32 pass_index = 0; pass_index < m_passes.size(); ++pass_index) {
+        const Pass &pass{m_passes[pass_index]};
+        if (pass.culled) {
+            continue;
+        }
+
+        for (const Access &access : pass.accesses) {
+            Resource &resource{m_resources[access.resource]};
+            resource.first_pass = std::min(resource.first_pass, pass_index);
+            resource.last_pass = std::max(resource.last_pass, pass_index);
+            if (internal::reads_contents(access.usage)) {
+                resource.last_read_pass = std::max(resource.last_read_pass, pass_index);
+            }
+        }
+        for (const Attachment *attachment : {&pass.colour_attachment, &pass.depth_attachment}) {
+            if (attachment->resource != INVALID_RENDER_GRAPH_RESOURCE &&
+                attachment->load_op == VK_ATTACHMENT_LOAD_OP_LOAD) {
+                Resource &resource{m_resources[attachment->resource]};
+                resource.last_read_pass = std::max(resource.last_read_pass, pass_index);
+            }
+        }
+    }
+
+    // Nothing after the pass needs what it rendered unless the image leaves the graph in a later use
+    for (u32 pass_index = 0; pass_index < m_passes.size(); ++pass_index) {
+        Pass &pass{m_passes[pass_index]};
+        for (Attachment *attachment : {&pass.colour_attachment, &pass.depth_attachment}) {
+            if (attachment->resource == INVALID_RENDER_GRAPH_RESOURCE) {
+                continue;
+            }
+            const Resource &resource{m_resources[attachment->resource]};
+            const bool stored{resource.last_read_pass > pass_index ||
+                              (resource.imported && resource.final_usage != ResourceUsage::None)};
+            attachment->store_op = stored ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        }
+    }
+}
+
+void RenderGraph::PlaceTransients(LinearAllocator &scratch)
+{
+    // Compared against last frame's placement, which is only rebuilt when they differ
+    ArenaVector<TransientImage> wanted{ArenaAllocator<TransientImage>{scratch}};
+    for (u32 i = 0; i < m_resources.size(); ++i) {
+        Resource &resource{m_resources[i]};
+        if (resource.imported || resource.first_pass == constants::u32_max) {
+            continue; // Transients no surviving pass uses are never created
+        }
+
+        resource.transient_index = static_cast<u32>(wanted.size());
+        wanted.push_back({.format = resource.format,
+                          .extent = resource.extent,
+                          .usage = resource.usage,
+                          .first_pass = resource.first_pass,
+                          .last_pass = resource.last_pass,
+                          .image = VK_NULL_HANDLE,
+                          .view = VK_NULL_HANDLE,
+                          .memory_slot = constants::u32_max});
+    }
+
+    const bool matches{std::ranges::equal(wanted, m_transients, [](const TransientImage &a, const TransientImage &b) {
+        return a.format == b.format && a.extent.width == b.extent.width && a.extent.height == b.extent.height &&
+               a.usage == b.usage && a.first_pass == b.first_pass && a.last_pass == b.last_pass;
+    })};
+
+    if (!matches) {
+        // Earlier frames may still render to them, they go once the last submission so far completes
+        if (!m_transients.empty()) {
+            m_retired_transients.push_back(
+                {p_queue->GetLastSubmittedValue(), std::move(m_transients), std::move(m_memory_slots)});
+            m_transients.clear();
+            m_memory_slots.clear();
+        }
+
+        m_transients.insert(m_transients.end(), wanted.begin(), wanted.end());
+        CreateTransients(scratch);
+    }
+
+    for (Resource &resource : m_resources) {
+        if (resource.transient_index != constants::u32_max) {
+            const TransientImage &transient{m_transients[resource.transient_index]};
+            resource.image = transient.image;
+            resource.view = transient.view;
+        }
+    }
+}
+
+void RenderGraph::CreateTransients(LinearAllocator &scratch)
+{
+    const VkDevice device{p_device->GetDevice()};
+
+    ArenaVector<VkMemoryRequirements> requirements(m_transients.size(), ArenaAllocator<VkMemoryRequirements>{scratch});
+    for (size_t i = 0; i < m_transients.size(); ++i) {
+        TransientImage &transient{m_transients[i]};
+
+        const VkImageCreateInfo image_info{.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+                                           .imageType = VK_IMAGE_TYPE_2D,
+                                           .format = transient.format,
+                                           .extent = {transient.extent.width, transient.extent.height, 1},
+                                           .mipLevels = 1,
+                                           .arrayLayers = 1,
+                                           .samples = VK_SAMPLE_COUNT_1_BIT,
+                                           .tiling = VK_IMAGE_TILING_OPTIMAL,
+                                           .usage = transient.usage,
+                                           .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+                                           .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED};
+        if (const VkResult result{vkCreateImage(device, &image_info, nullptr, &transient.image)};
+            result != VK_SUCCESS) {
+            CHECK_VK_RESULT(result, "vkCreateImage");
+        }
+        vkGetImageMemoryRequirements(device, transient.image, &requirements[i]);
+    }
+
+    // Largest first, each image goes into the first slot whose occupants are all dead by the time it is needed
+    ArenaVector<u32> order(m_transients.size(), ArenaAllocator<u32>{scratch});
+    std::iota(order.begin(), order.end(), 0u);
+    std::ranges::stable_sort(order,
+                             [&](const u32 a, const u32 b) { return requirements[a].size > requirements[b].size; });
+
+    ArenaVector<VkMemoryRequirements> slot_requirements{ArenaAllocator<VkMemoryRequirements>{scratch}};
+    VkDeviceSize unaliased_size{0};
+    for (const u32 index : order) {
+        TransientImage &transient{m_transients[index]};
+        const VkMemoryRequirements &image_requirements{requirements[index]};
+        unaliased_size += image_requirements.size;
+
+        for (u32 slot = 0; slot < slot_requirements.size(); ++slot) {
+            if ((slot_requirements[slot].memoryTypeBits & image_requirements.memoryTypeBits) == 0) {
+                continue;
+            }
+            const bool free{std::ranges::none_of(m_transients, [&](const TransientImage &occupant) {
+                return occupant.memory_slot == slot &&
+                       internal::lifetimes_overlap(occupant.first_pass, occupant.last_pass, transient.first_pass,
+                                                   transient.last_pass);
+            })};
+            if (free) {
+                VkMemoryRequirements &shared{slot_requirements[slot]};
+                shared.size = std::max(shared.size, image_requirements.size);
+                shared.alignment = std::max(shared.alignment, image_requirements.alignment);
+                shared.memoryTypeBits &= image_requirements.memoryTypeBits;
+                transient.memory_slot = slot;
+                break;
+            }
+        }
+
+        if (transient.memory_slot == constants::u32_max) {
+            transient.memory_slot = static_cast<u32>(slot_requirements.size());
+            slot_requirements.push_back(image_requirements);
+        }
+    }
+
+    m_transient_memory_size = 0;
+    for (const VkMemoryRequirements &slot : slot_requirements) {
+        const auto memory_type_index{
+            p_buffer_manager->GetMemoryTypeIndex(slot.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)};
+        if (!memory_type_index) {
+            ENGINE_THROW("Render graph memory type selection failed: {}", memory_type_index.error());
+        }
+
+        auto allocation{p_device->GetAllocator()->Allocate(slot, *memory_type_index, MemoryResourceKind::Optimal)};
+        if (!allocation) {
+            ENGINE_THROW("Render graph transient memory allocation failed: {}", allocation.error());
+        }
+        m_memory_slots.push_back({*allocation, 0, 0});
+        m_transient_memory_size += slot.size;
+    }
+
+    for (TransientImage &transient : m_transients) {
+        const MemoryAllocation &allocation{m_memory_slots[transient.memory_slot].allocation};
+        if (const VkResult result{vkBindImageMemory(device, transient.image, allocation.p_memory, allocation.m_offset)};
+            result != VK_SUCCESS) {
+            CHECK_VK_RESULT(result, "vkBindImageMemory");
+        }
+
+        // Views select the depth aspect alone so depth images can be sampled
+        const VkImageAspectFlags aspect{internal::is_depth_format(transient.format) ? VK_IMAGE_ASPECT_DEPTH_BIT
+                                                                                     : VK_IMAGE_ASPECT_COLOR_BIT};
+        transient.view =
+            p_buffer_manager->CreateImageView(transient.image, transient.format, aspect, VK_IMAGE_VIEW_TYPE_2D, 1, 1);
+    }
+
+    if (!m_transients.empty()) {
+        ENGINE_LOG_DEBUG("Render graph placed {} transient image(s) in {} KiB, {} KiB without aliasing.",
+                         m_transients.size(), m_transient_memory_size / 1024, unaliased_size / 1024);
+    }
+}
+
+void RenderGraph::PlanBarriers()
+{
+    m_barrier_count = 0;
+
+    for (u32 pass_index = 0; pass_index < m_passes.size(); ++pass_index) {
+        Pass &pass{m_passes[pass_index]};
+        if (pass.culled) {
+            continue;
+        }
+
+        pass.memory_src_stages = 0;
+        pass.memory_dst_stages = 0;
+        pass.memory_barrier = {.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER, .srcAccessMask = 0, .dstAccessMask = 0};
+        pass.image_src_stages = 0;
+        pass.image_dst_stages = 0;
+        pass.image_barriers.clear();
+
+        for (const Access &access : pass.accesses) {
+            PlanAccess(pass, pass_index, access);
+        }
+
+        m_barrier_count += (pass.memory_dst_stages != 0 ? 1 : 0) + (pass.image_dst_stages != 0 ? 1 : 0);
+    }
+
+    // Imported images leave in the state whoever uses them next expects
+    for (const Resource &resource : m_resources) {
+        if (!resource.imported || resource.kind != ResourceKind::Image || resource.final_usage == ResourceUsage::None) {
+            continue;
+        }
+
+        const internal::UsageInfo final{internal::get_usage_info(resource.final_usage)};
+        if (resource.state.layout == final.layout) {
+            continue;
+        }
+
+        const VkPipelineStageFlags src_stages{resource.state.write_stages | resource.state.read_stages};
+        m_final_src_stages |= src_stages != 0 ? src_stages : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+        m_final_dst_stages |= final.stages;
+        m_final_barriers.push_back({.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+                                    .srcAccessMask = resource.state.write_access,
+                                    .dstAccessMask = final.access,
+                                    .oldLayout = resource.state.layout,
+                                    .newLayout = final.layout,
+                                    .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                                    .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                                    .image = resource.image,
+                                    .subresourceRange = {internal::get_barrier_aspect(resource.format), 0, 1, 0, 1}});
+    }
+    if (!m_final_barriers.empty()) {
+        ++m_barrier_count;
+    }
+}
+
+void RenderGraph::PlanAccess(Pass &pass, const u32 pass_index, const Access &access)
+{
+    Resource &resource{m_resources[access.resource]};
+    ResourceState &state{resource.state};
+    const internal::UsageInfo usage{internal::get_usage_info(access.usage)};
+
+    // A transient starts where the previous occupant of its memory, this frame or the last, left off
+    MemorySlot *slot{nullptr};
+    if (resource.transient_index != constants::u32_max) {
+        slot = &m_memory_slots[m_transients[resource.transient_index].memory_slot];
+        if (pass_index == resource.first_pass && state.layout == VK_IMAGE_LAYOUT_UNDEFINED) {
+            state = {VK_IMAGE_LAYOUT_UNDEFINED, slot->last_stages, slot->last_access, 0, 0};
+        }
+    }
+
+    const bool transition{resource.kind == ResourceKind::Image && state.layout != usage.layout};
+    if (transition) {
+        ASSERT(usage.layout != VK_IMAGE_LAYOUT_UNDEFINED, "Image '{}' is used as a buffer.", resource.name);
+
+        const VkPipelineStageFlags src_stages{state.write_stages | state.read_stages};
+        const VkImageAspectFlags aspect{internal::get_barrier_aspect(resource.format)};
+        pass.image_src_stages |= src_stages != 0 ? src_stages : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+        pass.image_dst_stages |= usage.stages;
+        pass.image_barriers.push_back({.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+                                       .srcAccessMask = state.write_access,
+                                       .dstAccessMask = usage.access,
+                                       .oldLayout = state.layout,
+                                       .newLayout = usage.layout,
+                                       .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                                       .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                                       .image = resource.image,
+                                       .subresourceRange = {aspect, 0, 1, 0, 1}});
+
+        // The transition counts as a write, later uses in other stages wait for it
+        state.layout = usage.layout;
+        state.write_stages = usage.stages;
+        state.write_access = usage.access & internal::WRITE_ACCESS_MASK;
+        state.read_stages = usage.write ? 0 : usage.stages;
+        state.read_access = usage.write ? 0 : usage.access;
+    }
+    else if (!usage.write) {
+        const bool visible{(usage.stages & ~state.read_stages) == 0 && (usage.access & ~state.read_access) == 0};
+        if (!visible && state.write_stages != 0) {
+            pass.memory_src_stages |= state.write_stages;
+            pass.memory_dst_stages |= usage.stages;
+            pass.memory_barrier.srcAccessMask |= state.write_access;
+            pass.memory_barrier.dstAccessMask |= usage.access;
+        }
+        state.read_stages |= usage.stages;
+        state.read_access |= usage.access;
+    }
+    else {
+        // Writes wait for the previous write and for every read of it, reads need no memory dependency
+        const VkPipelineStageFlags src_stages{state.write_stages | state.read_stages};
+        if (src_stages != 0) {
+            pass.memory_src_stages |= src_stages;
+            pass.memory_dst_stages |= usage.stages;
+            pass.memory_barrier.srcAccessMask |= state.write_access;
+            pass.memory_barrier.dstAccessMask |= state.write_access != 0 ? usage.access : 0;
+        }
+        state.write_stages = usage.stages;
+        state.write_access = usage.access & internal::WRITE_ACCESS_MASK;
+        state.read_stages = 0;
+        state.read_access = 0;
+    }
+
+    if (slot) {
+        slot->last_stages = state.write_stages | state.read_stages;
+        slot->last_access = state.write_access;
+    }
+}
+
+void RenderGraph::RecordPass(VkCommandBuffer command_buffer, Pass &pass) const
+{
+    if (pass.memory_dst_stages != 0) {
+        // Without accesses to order it is an execution dependency, such as a write after reads
+        const bool memory_dependency{pass.memory_barrier.srcAccessMask != 0 || pass.memory_barrier.dstAccessMask != 0};
+        vkCmdPipelineBarrier(command_buffer, pass.memory_src_stages, pass.memory_dst_stages, 0,
+                             memory_dependency ? 1 : 0, &pass.memory_barrier, 0, nullptr, 0, nullptr);
+    }
+    if (pass.image_dst_stages != 0) {
+        vkCmdPipelineBarrier(command_buffer, pass.image_src_stages, pass.image_dst_stages, 0, 0, nullptr, 0, nullptr,
+                             static_cast<u32>(pass.image_barriers.size()), pass.image_barriers.data());
+    }
+
+    const bool has_colour{pass.colour_attachment.resource != INVALID_RENDER_GRAPH_RESOURCE};
+    const bool has_depth{pass.depth_attachment.resource != INVALID_RENDER_GRAPH_RESOURCE};
+    if (!has_colour && !has_depth) {
+        if (pass.record) {
+            pass.record(command_buffer);
+        }
+        return;
+    }
+
+    const auto to_attachment_info = [&](const Attachment &attachment, const VkImageLayout layout) {
+        return VkRenderingAttachmentInfo{.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO,
+                                         .imageView = m_resources[attachment.resource].view,
+                                         .imageLayout = layout,
+                                         .loadOp = attachment.load_op,
+                                         .storeOp = attachment.store_op,
+                                         .clearValue = attachment.clear_value};
+    };
+
+    const VkRenderingAttachmentInfo colour_attachment{
+        has_colour ? to_attachment_info(pass.colour_attachment, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL)
+                   : VkRenderingAttachmentInfo{}};
+    const VkRenderingAttachmentInfo depth_attachment{
+        has_depth ? to_attachment_info(pass.depth_attachment, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL)
+                  : VkRenderingAttachmentInfo{}};
+
+    const VkExtent2D extent{m_resources[has_colour ? pass.colour_attachment.resource : pass.depth_attachment.resource]
+                                .extent};
+    const VkRenderingInfo rendering_info{.sType = VK_STRUCTURE_TYPE_RENDERING_INFO,
+                                         .flags = pass.rendering_flags,
+                                         .renderArea = {{0, 0}, extent},
+                                         .layerCount = 1,
+                                         .colorAttachmentCount = has_colour ? 1u : 0u,
+                                         .pColorAttachments = has_colour ? &colour_attachment : nullptr,
+                                         .pDepthAttachment = has_depth ? &depth_attachment : nullptr};
+
+    vkCmdBeginRendering(command_buffer, &rendering_info);
+    if (pass.record) {
+        pass.record(command_buffer);
+    }
+    vkCmdEndRendering(command_buffer);
+}
+
+void RenderGraph::DestroyTransients(Vector<TransientImage> &images, Vector<MemorySlot> &memory_slots) const
+{
+    for (const TransientImage &transient : images) {
+        vkDestroyImageView(p_device->GetDevice(), transient.view, nullptr);
+        vkDestroyImage(p_device->GetDevice(), transient.image, nullptr);
+    }
+    images.clear();
+
+    for (MemorySlot &slot : memory_slots) {
+        p_device->GetAllocator()->Free(slot.allocation);
+    }
+    memory_slots.clear();
+}
+
+} // namespace gouda::vk
@@ -6,40 +6,129 @@
  */
 #include "renderers/vulkan/vk_renderer.hpp"
 
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
 #include <cstring>
+#include <functional>
+#include <numeric>
 #include <thread>
 
 #include "imgui_impl_glfw.h"
 #include "imgui_impl_vulkan.h"
 
 #include "debug/debug.hpp"
+#include "debug/profiler_view.hpp"
 #include "math/random.hpp"
+#include "math/simd_kernels.hpp"
 #include "renderers/vulkan/vk_buffer_manager.hpp"
 #include "renderers/vulkan/vk_command_buffer_manager.hpp"
 #include "renderers/vulkan/vk_compute_pipeline.hpp"
 #include "renderers/vulkan/vk_depth_resources.hpp"
-#include "renderers/vulkan/vk_fence.hpp"
+#include "renderers/vulkan/vk_descriptor_allocator.hpp"
+#include "renderers/vulkan/vk_frame_capture.hpp"
+#include "renderers/vulkan/vk_glyph_cache.hpp"
 #include "renderers/vulkan/vk_graphics_pipeline.hpp"
 #include "renderers/vulkan/vk_instance.hpp"
+#include "renderers/vulkan/vk_layout_cache.hpp"
+#include "renderers/vulkan/vk_pipeline_cache.hpp"
+#include "renderers/vulkan/vk_pipeline_library.hpp"
+#include "renderers/vulkan/vk_radix_sort.hpp"
+#include "renderers/vulkan/vk_render_graph.hpp"
 #include "renderers/vulkan/vk_shader.hpp"
 #include "renderers/vulkan/vk_texture.hpp"
+#include "renderers/vulkan/vk_thumbnail_cache.hpp"
 #include "renderers/vulkan/vk_utils.hpp"
+#include "utils/filesystem.hpp"
+#include "utils/hash.hpp"
+#include "utils/utf8.hpp"
 
 // TODO: Remove this dependency
 #include "renderers/vulkan/gouda_vk_wrapper.hpp"
 
 namespace gouda::vk {
 
+static_assert(sizeof(QuadInstance) == 32, "quad_cull.comp mirrors the QuadInstance layout");
+static_assert(MAX_TEXTURES <= QuadInstance::texture_array_bit, "Quad instances hold 12 bit texture and array ids");
+static_assert(sizeof(UniformData) <= 128, "Camera data is pushed, 128 bytes is the smallest push constant limit");
+static_assert(sizeof(PointLight) == 32 && sizeof(LightParams) == 368, "The light shaders mirror the light layouts");
+static_assert(sizeof(CullParams) == 80, "quad_cull.comp mirrors the CullParams layout");
+
+namespace internal {
+
+#ifdef NDEBUG
+constexpr bool SHADER_HOT_RELOAD_DEFAULT{false};
+#else
+constexpr bool SHADER_HOT_RELOAD_DEFAULT{true};
+#endif
+
+#ifdef NDEBUG
+constexpr bool DEBUG_UI_VISIBLE_DEFAULT{false};
+#else
+constexpr bool DEBUG_UI_VISIBLE_DEFAULT{true};
+#endif
+
+// A file that is missing or being replaced reads as never modified, so it does not trigger a rebuild
+static FileTimeType last_write_time(StringView filepath)
+{
+    try {
+        return fs::GetLastWriteTime(filepath);
+    }
+    catch (const std::filesystem::filesystem_error &e) {
+        ENGINE_LOG_WARNING("Failed to check last modified time for '{}': {}", filepath, e.what());
+        return FileTimeType{};
+    }
+}
+
+// Same bounds as the CPU frustum test, min xy then max xy, ordered so they hold whichever way the projection flips y
+static Vec4 get_cull_view(const OrthographicCamera::FrustumData &frustum)
+{
+    const f32 top{frustum.top + frustum.position.y};
+    const f32 bottom{frustum.bottom + frustum.position.y};
+    return {frustum.left + frustum.position.x, math::min(top, bottom), frustum.right + frustum.position.x,
+            math::max(top, bottom)};
+}
+
+} // namespace internal
+
 RenderStatistics::RenderStatistics() :
     delta_time{0.0f},
+    fence_wait_time{0.0f},
+    present_latency{0.0f},
     quad_count{0},
+    quad_draw_count{0},
+    static_quad_count{0},
+    static_quad_update_count{0},
+    tile_count{0},
+    tile_chunk_count{0},
+    visible_tile_chunk_count{0},
+    viewport_count{1},
     vertex_count{0},
     index_count{0},
     particle_count{0},
+    particle_spawn_count{0},
+    light_count{0},
+    render_target_update_count{0},
+    render_scale{1.0f},
     glyph_count{0},
+    debug_draw_count{0},
     total_instances{0},
     texture_count{0},
-    font_count{0}
+    font_count{0},
+    cached_glyph_count{0},
+    thumbnail_count{0},
+    barrier_count{0},
+    culled_pass_count{0},
+    sampler_count{0},
+    descriptor_pool_count{0},
+    pipeline_layout_count{0},
+    transient_memory{0},
+    uploaded_bytes{0},
+    descriptor_write_count{0},
+    is_command_buffer_reused{false},
+    memory{},
+    gpu_timings{}
 {
 }
 
@@ -48,41 +137,104 @@ RenderStatistics::RenderStatistics() :
 Renderer::Renderer()
     : p_instance{nullptr},
       p_device{nullptr},
+      p_pipeline_cache{nullptr},
+      p_pipeline_libraries{nullptr},
       p_buffer_manager{nullptr},
       p_swapchain{nullptr},
       p_depth_resources{nullptr},
       p_command_buffer_manager{nullptr},
+      p_transfer_command_buffer_manager{nullptr},
+      p_compute_command_buffer_manager{nullptr},
       p_texture_manager{nullptr},
+      p_gpu_timer{nullptr},
+      p_render_graph{nullptr},
+      p_frame_capture{nullptr},
+      p_glyph_cache{nullptr},
+      p_thumbnail_cache{nullptr},
+      p_worker_pool{nullptr},
+      p_file_watcher{nullptr},
       p_quad_pipeline{nullptr},
-      p_text_pipeline{nullptr},
+      p_quad_alpha_test_pipeline{nullptr},
+      p_quad_transparent_pipeline{nullptr},
       p_particle_pipeline{nullptr},
+      p_upscale_pipeline{nullptr},
+      m_pipeline_variants{},
+      m_pending_variants{},
+      p_tile_pipeline{nullptr},
       p_particle_compute_pipeline{nullptr},
+      p_particle_emit_pipeline{nullptr},
+      p_quad_cull_pipeline{nullptr},
+      p_light_cull_pipeline{nullptr},
+      p_particle_gather_pipeline{nullptr},
+      p_particle_sort{nullptr},
       p_quad_vertex_buffer{nullptr},
       p_quad_index_buffer{nullptr},
       p_quad_vertex_shader{nullptr},
       p_quad_fragment_shader{nullptr},
-      p_text_vertex_shader{nullptr},
-      p_text_fragment_shader{nullptr},
       p_particle_vertex_shader{nullptr},
       p_particle_fragment_shader{nullptr},
       p_particle_compute_shader{nullptr},
+      p_particle_emit_shader{nullptr},
+      p_quad_cull_shader{nullptr},
+      p_light_cull_shader{nullptr},
+      p_upscale_vertex_shader{nullptr},
+      p_upscale_fragment_shader{nullptr},
+      p_radix_histogram_shader{nullptr},
+      p_radix_scan_shader{nullptr},
+      p_radix_scatter_shader{nullptr},
+      p_particle_gather_shader{nullptr},
       p_window{nullptr},
-      p_render_pass{VK_NULL_HANDLE},
+      m_colour_attachment_format{VK_FORMAT_UNDEFINED},
+      m_depth_attachment_format{VK_FORMAT_UNDEFINED},
       p_copy_command_buffer{VK_NULL_HANDLE},
       p_imgui_pool{VK_NULL_HANDLE},
+      p_upscale_sampler{VK_NULL_HANDLE},
+      m_particle_collider_version{0},
+      m_tile_buffer_capacity{0},
+      m_tile_count{0},
+      m_tile_texture_index{0},
+      m_viewport_tile_ranges{},
+      m_animation_version{0},
+      m_animation_time{0.0f},
+      m_retained_text_dirty{false},
+      m_shader_change_pending{false},
       m_framebuffer_size{0, 0},
+      m_frames_in_flight{DEFAULT_FRAMES_IN_FLIGHT},
       m_current_frame{0},
       m_simulation_params{{0.0f, constants::gravity, 0.0f}, 0.0f},
+      m_frame_allocator{FrameAllocator::DEFAULT_CAPACITY, FrameAllocator::DEFAULT_FRAME_COUNT, MemoryTag::Renderer},
+      m_scene_extent{0, 0},
+      m_render_scale{1.0f},
+      m_current_render_scale{1.0f},
+      m_upscale_sharpness{0.5f},
+      m_target_gpu_time{0.0f},
+      m_render_scale_cooldown{0},
       m_clear_colour{},
-      m_max_quad_instances{1000},
-      m_max_text_instances{1000},
-      m_max_particle_instances{1024}, // Multiple of 256 for compute
+      m_max_quad_instances{10240}, // Text glyphs included
+      m_quad_draw_counts{},
+      m_max_particle_instances{65536}, // Multiple of 256 for compute
+      m_max_static_quad_instances{65536},
+      m_particle_spawn_count{0},
+      m_particle_spawn_limit{MAX_PARTICLE_SPAWNS_PER_FRAME},
+      m_light_limit{MAX_LIGHTS},
       m_vsync_mode{VSyncMode::Disabled},
       m_vertex_count{0},
       m_index_count{0},
       m_is_initialized{false},
       m_use_compute_particles{false},
-      m_font_textures_dirty{true}
+      m_sort_particles{true},
+      m_use_async_compute{false},
+      m_use_gpu_culling{false},
+      m_reset_particle_pool{true},
+      m_particle_pool_active{false},
+      m_static_quad_textures_dirty{false},
+      m_shader_hot_reload{internal::SHADER_HOT_RELOAD_DEFAULT},
+      m_debug_ui_visible{internal::DEBUG_UI_VISIBLE_DEFAULT},
+      m_imgui_dirty{true},
+      p_imgui_draw_data{nullptr},
+      p_prebuilt_imgui_draw_data{nullptr},
+      m_is_imgui_prebuilt{false},
+      m_imgui_build_time{}
 {
 }
 
@@ -91,94 +243,223 @@ Renderer::~Renderer()
     ENGINE_LOG_DEBUG("Cleaning up Vulkan renderer.");
 
     if (m_is_initialized) {
-        DestroyBuffers();
-
-        for (const auto &texture : m_font_textures) {
-            texture->Destroy(p_device.get());
+        // A rebuild still in flight uses the device and the uniform buffers destroyed below
+        if (m_shader_reload.valid()) {
+            m_shader_reload.wait();
         }
-
-        if (p_render_pass != VK_NULL_HANDLE) {
-            vkDestroyRenderPass(p_device->GetDevice(), p_render_pass, nullptr);
-            p_render_pass = VK_NULL_HANDLE;
-            ENGINE_LOG_DEBUG("Render pass destroyed.");
+        for (const PendingVariant &pending : m_pending_variants) {
+            if (pending.pipeline.valid()) {
+                pending.pipeline.wait();
+            }
         }
 
-        DestroyFramebuffers();
+        p_pipeline_cache->Save();
+
+        DestroyRetiredSwapchains(true);
+        DestroyBuffers();
+        p_particle_sort.reset();
+
         DestroyImGUI();
 
+        // The device is idle, so every copy recorded so far is written out
+        p_frame_capture->Collect(m_queue);
+        p_frame_capture.reset();
+        p_glyph_cache.reset();
+        p_thumbnail_cache.reset();
+        p_render_graph.reset();
+        p_gpu_timer.reset();
+
         // Destroy in reverse order to ensure dependencies are cleaned up properly
         p_buffer_manager.reset();
         p_command_buffer_manager.reset();
+        p_transfer_command_buffer_manager.reset();
+        p_compute_command_buffer_manager.reset();
     }
 }
 
 void Renderer::Initialize(GLFWwindow *window_ptr, StringView app_name, const SemVer vulkan_api_version,
-                          const VSyncMode vsync_mode)
+                          const VSyncMode vsync_mode, const u32 frames_in_flight, StringView pipeline_cache_path,
+                          StringView preferred_device)
 {
     ASSERT(window_ptr, "Window pointer cannot be null.");
     ASSERT(!app_name.empty(), "Application name cannot be empty or null.");
+    ASSERT(frames_in_flight > 0, "Frames in flight cannot be zero.");
 
     ENGINE_PROFILE_SESSION("Gouda", "debug/profiling/results.json");
     ENGINE_PROFILE_SCOPE("Init renderer");
 
     m_vsync_mode = vsync_mode;
+    m_frames_in_flight = std::clamp(frames_in_flight, 1u, Queue::GetMaxFramesInFlight());
+    m_current_frame = 0;
+    m_pending_texture_descriptors.assign(m_frames_in_flight, {});
     m_particles_instances.clear();
+    m_pending_particle_spawns.clear();
 
-    InitializeCore(window_ptr, app_name, vulkan_api_version);
+    InitializeCore(window_ptr, app_name, vulkan_api_version, pipeline_cache_path, preferred_device);
     InitializeSwapchainAndQueue(vsync_mode);
     InitializeRenderResources();
     InitializeDefaultResources();
     InitializeImGUIIfEnabled();
 
     m_is_initialized = true;
-    ENGINE_LOG_DEBUG("Renderer initialized.");
+    ENGINE_LOG_DEBUG("Renderer initialized with {} frames in flight.", m_frames_in_flight);
+    ENGINE_LOG_DEBUG("CPU batch kernels: {}.", math::ToString(math::GetSimdKernels().type));
 }
 
-void Renderer::RecordCommandBuffer(VkCommandBuffer command_buffer, const u32 image_index, const u32 quad_instance_count,
-                                   const u32 text_instance_count, const u32 particle_instance_count,
-                                   ImDrawData *draw_data) const
+void Renderer::RecordCommandBuffer(VkCommandBuffer command_buffer, const u32 frame_index, const u32 image_index,
+                                   const std::span<const RenderViewport> viewports, const u32 quad_instance_count,
+                                   const u32 particle_instance_count, ImDrawData *draw_data,
+                                   const bool capture_frame) const
 {
     ENGINE_PROFILE_SCOPE("Record command buffer");
 
-    BeginCommandBuffer(command_buffer, VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+    // Not one time submit, Render submits it again while the frame structure stays the same
+    BeginCommandBuffer(command_buffer, 0);
+    p_gpu_timer->RecordReset(command_buffer, frame_index);
 
-    // Update Particles ---------------------------------------------
-    if (m_use_compute_particles && particle_instance_count > 0) {
-        // ENGINE_LOG_DEBUG("Compute dispatch: particle_count = {}, workgroup_count = [{}, {}, {}]",
-        //          particle_instance_count, (particle_instance_count + 255) / 256, 1, 1);
-        p_particle_compute_pipeline->Bind(command_buffer);
-        p_particle_compute_pipeline->BindDescriptors(command_buffer, image_index);
-        const u32 particle_count{math::min(particle_instance_count, m_max_particle_instances)};
-        const UVec3 workgroup_count{(particle_count + 255) / 256, 1, 1};
-        p_particle_compute_pipeline->Dispatch(command_buffer, workgroup_count);
-
-        // Barrier: Compute shader write to vertex attribute read
-        const VkBufferMemoryBarrier barrier{
-            .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
-            .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
-            .dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT,
-            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-            .buffer = m_particle_storage_buffers[image_index].p_buffer,
-            .offset = 0,
-            .size = sizeof(ParticleData) * particle_count,
-        };
-        vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
-                             0, 0, nullptr, 1, &barrier, 0, nullptr);
-    }
+    const bool gpu_particles{m_use_compute_particles && m_particle_pool_active};
+    const u32 static_quad_count{m_cull_params.instance_count};
+    const bool gpu_culling{m_use_gpu_culling && static_quad_count > 0};
+    const bool light_culling{m_light_params.light_count > 0};
+    const bool draw_tiles{!m_visible_tile_ranges.empty()};
 
-    // Begin Render pass
-    std::array<VkClearValue, 2> clear_values{};
-    clear_values[0].color = m_clear_colour;
-    clear_values[1].depthStencil = {1.0f, 0};
+    // A simulation on the async compute queue is waited for by the submit instead. The compute work on the graphics
+    // queue is timed as one scope, from the first of its passes to the last.
+    const bool graphics_particles{gpu_particles && !m_use_async_compute};
+
+    RenderGraph &graph{*p_render_graph};
+    graph.Reset();
 
     const VkExtent2D extent{p_swapchain->GetExtent()};
-    const VkRenderPassBeginInfo render_pass_begin_info{.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
-                                                       .renderPass = p_render_pass,
-                                                       .framebuffer = m_framebuffers[image_index],
-                                                       .renderArea = {{0, 0}, extent},
-                                                       .clearValueCount = static_cast<u32>(clear_values.size()),
-                                                       .pClearValues = clear_values.data()};
+    const bool scaled{m_scene_extent.width != extent.width || m_scene_extent.height != extent.height};
+
+    // Both attachments are cleared, so their previous contents are discarded. The colour write waits on the same stage
+    // as the image acquire semaphore, depth waits for the last frame that rendered to this image.
+    const Texture &depth_image{p_depth_resources->GetDepthImages()[image_index]};
+    const RenderGraphResource colour_target{graph.ImportImage("Swapchain image",
+                                                              {.image = p_swapchain->GetImages()[image_index],
+                                                               .view = p_swapchain->GetImageViews()[image_index],
+                                                               .format = m_colour_attachment_format,
+                                                               .extent = extent,
+                                                               .initial_usage = ResourceUsage::ColourAttachment,
+                                                               .final_usage = ResourceUsage::Present,
+                                                               .keep_contents = false})};
+    const RenderGraphResource depth_target{graph.ImportImage("Depth image",
+                                                             {.image = depth_image.p_image,
+                                                              .view = depth_image.p_view,
+                                                              .format = m_depth_attachment_format,
+                                                              .extent = extent,
+                                                              .initial_usage = ResourceUsage::DepthAttachment,
+                                                              .final_usage = ResourceUsage::None,
+                                                              .keep_contents = false})};
+
+    // A scaled world is drawn into its own targets and upscaled into the swapchain image by the scene pass, which
+    // draws ImGui over it at native resolution
+    const RenderGraphResource world_colour{
+        scaled ? graph.CreateTransientImage("Scaled scene colour", m_colour_attachment_format, m_scene_extent)
+               : colour_target};
+    const RenderGraphResource world_depth{
+        scaled ? graph.CreateTransientImage("Scaled scene depth", m_depth_attachment_format, m_scene_extent)
+               : depth_target};
+
+    const RenderGraphResource static_quads{graph.ImportBuffer("Static quads", m_static_quad_buffer.p_buffer)};
+    const RenderGraphResource visible_static_quads{
+        graph.ImportBuffer("Visible static quads", m_culled_quad_visible_buffers[frame_index].p_buffer)};
+    const RenderGraphResource static_quad_draw{
+        graph.ImportBuffer("Static quad draw", m_cull_indirect_buffers[frame_index].p_buffer)};
+    const RenderGraphResource tiles{
+        draw_tiles ? graph.ImportBuffer("Tiles", m_tile_buffer.p_buffer) : INVALID_RENDER_GRAPH_RESOURCE};
+    const RenderGraphResource particles{
+        graph.ImportBuffer("Compacted particles", m_compacted_particle_buffers[frame_index].p_buffer)};
+    const RenderGraphResource particle_draw{
+        graph.ImportBuffer("Particle draw", m_particle_indirect_buffers[frame_index].p_buffer)};
+    const RenderGraphResource light_tiles{
+        graph.ImportBuffer("Light tiles", m_light_tile_buffers[frame_index].p_buffer)};
+
+    // Update Particles, unless the simulation already ran on the async compute queue ----
+    if (graphics_particles) {
+        graph.AddPass("Particle simulation")
+            .Write(particles, ResourceUsage::ComputeWrite)
+            .Write(particle_draw, ResourceUsage::ComputeWrite)
+            .SetRecord([&](VkCommandBuffer pass_command_buffer) {
+                p_gpu_timer->RecordBegin(pass_command_buffer, frame_index, GpuScope::Compute);
+                RecordParticleCompute(pass_command_buffer, frame_index);
+                if (!gpu_culling && !light_culling) {
+                    p_gpu_timer->RecordEnd(pass_command_buffer, frame_index, GpuScope::Compute);
+                }
+            });
+    }
+
+    // Copy this frame's changes to the static quads before anything reads them
+    if (!m_static_quad_copies.empty()) {
+        graph.AddPass("Static quad updates")
+            .Write(static_quads, ResourceUsage::TransferWrite)
+            .SetRecord([&](VkCommandBuffer pass_command_buffer) {
+                RecordStaticQuadUpdates(pass_command_buffer, frame_index);
+            });
+    }
+
+    // Cull the static quads, the draw below only reads the instances that survived
+    if (gpu_culling) {
+        graph.AddPass("Static quad cull")
+            .Read(static_quads, ResourceUsage::ComputeRead)
+            .Write(visible_static_quads, ResourceUsage::ComputeWrite)
+            .Write(static_quad_draw, ResourceUsage::ComputeWrite)
+            .SetRecord([&](VkCommandBuffer pass_command_buffer) {
+                if (!graphics_particles) {
+                    p_gpu_timer->RecordBegin(pass_command_buffer, frame_index, GpuScope::Compute);
+                }
+                RecordQuadCull(pass_command_buffer, frame_index);
+                if (!light_culling) {
+                    p_gpu_timer->RecordEnd(pass_command_buffer, frame_index, GpuScope::Compute);
+                }
+            });
+    }
+
+    // Sort the lights into screen tiles, a lit fragment only reads the lights of its own tile
+    if (light_culling) {
+        graph.AddPass("Light cull")
+            .Write(light_tiles, ResourceUsage::ComputeWrite)
+            .SetRecord([&](VkCommandBuffer pass_command_buffer) {
+                if (!graphics_particles && !gpu_culling) {
+                    p_gpu_timer->RecordBegin(pass_command_buffer, frame_index, GpuScope::Compute);
+                }
+                RecordLightCull(pass_command_buffer, frame_index);
+                p_gpu_timer->RecordEnd(pass_command_buffer, frame_index, GpuScope::Compute);
+            });
+    }
+
+    // Render targets updated since the last frame are redrawn before the scene samples them. Their old contents are
+    // discarded, the previous frame's sampling is waited on by the transition to an attachment.
+    const std::span<RenderGraphResource> render_target_images{
+        m_frame_allocator.Get().AllocateSpan<RenderGraphResource>(m_render_target_draws.size())};
+    for (u32 i = 0; i < m_render_target_draws.size(); ++i) {
+        const RenderTarget &target{m_render_targets[m_render_target_draws[i].target_index]};
+        const Texture &texture{*p_texture_manager->GetTextures()[target.texture_id]};
+        render_target_images[i] = graph.ImportImage("Render target",
+                                                    {.image = texture.p_image,
+                                                     .view = texture.p_view,
+                                                     .format = m_colour_attachment_format,
+                                                     .extent = target.extent,
+                                                     .initial_usage = ResourceUsage::FragmentSampled,
+                                                     .final_usage = ResourceUsage::FragmentSampled,
+                                                     .keep_contents = false});
+        const RenderGraphResource target_depth{graph.ImportImage("Render target depth",
+                                                                 {.image = target.depth_image.p_image,
+                                                                  .view = target.depth_image.p_view,
+                                                                  .format = m_depth_attachment_format,
+                                                                  .extent = target.extent,
+                                                                  .initial_usage = ResourceUsage::DepthAttachment,
+                                                                  .final_usage = ResourceUsage::None,
+                                                                  .keep_contents = false})};
+
+        graph.AddPass("Render target")
+            .SetColourAttachment(render_target_images[i], VK_ATTACHMENT_LOAD_OP_CLEAR, target.clear_colour)
+            .SetDepthAttachment(target_depth, VK_ATTACHMENT_LOAD_OP_CLEAR)
+            .SetRecord([&, i](VkCommandBuffer pass_command_buffer) {
+                RecordRenderTargetDraws(pass_command_buffer, frame_index, i);
+            });
+    }
 
     const VkViewport viewport{.x = 0.0f,
                               .y = 0.0f,
@@ -189,355 +470,2287 @@ void Renderer::RecordCommandBuffer(VkCommandBuffer command_buffer, const u32 ima
 
     const VkRect2D scissor{{0, 0}, extent};
 
-    vkCmdBeginRenderPass(command_buffer, &render_pass_begin_info, VK_SUBPASS_CONTENTS_INLINE);
+    // The world passes are drawn once per viewport into its part of the world target
+    SmallVector<VkRect2D, MAX_VIEWPORTS> world_scissors;
+    SmallVector<VkViewport, MAX_VIEWPORTS> world_viewports;
+    for (const RenderViewport &render_viewport : viewports) {
+        const VkRect2D rect{GetViewportRect(render_viewport)};
+        world_scissors.push_back(rect);
+        world_viewports.push_back({.x = static_cast<f32>(rect.offset.x),
+                                   .y = static_cast<f32>(rect.offset.y),
+                                   .width = static_cast<f32>(rect.extent.width),
+                                   .height = static_cast<f32>(rect.extent.height),
+                                   .minDepth = 0.0f,
+                                   .maxDepth = 1.0f});
+    }
+
+    // Records the draws of one pass for one viewport, the viewport and scissor are already set. The quad pipelines
+    // share their layout and descriptors, switching between them leaves the sets bound.
+    const auto record_draws = [&](const DrawPass pass, VkCommandBuffer pass_command_buffer, const u32 viewport_index,
+                                  BoundDescriptorSets &bound_sets) {
+        const UniformData &uniform_data{viewports[viewport_index].camera};
+        switch (pass) {
+            case DrawPass::StaticQuads: {
+                p_quad_pipeline->Bind(pass_command_buffer, frame_index, &bound_sets);
+                p_quad_pipeline->PushConstants(pass_command_buffer, &uniform_data, sizeof(UniformData));
+                constexpr VkDeviceSize offset{0};
+                if (gpu_culling) {
+                    // Each viewport's survivors are in its own region of the visible buffer, counted by its own
+                    // command. The region is bound at an offset so the command needs no first instance.
+                    const VkDeviceSize visible_offset{sizeof(QuadInstance) * m_cull_params.visible_capacity *
+                                                      viewport_index};
+                    vkCmdBindVertexBuffers(pass_command_buffer, 1, 1,
+                                           &m_culled_quad_visible_buffers[frame_index].p_buffer, &visible_offset);
+                    vkCmdDrawIndirect(pass_command_buffer, m_cull_indirect_buffers[frame_index].p_buffer,
+                                      sizeof(VkDrawIndirectCommand) * viewport_index, 1, sizeof(VkDrawIndirectCommand));
+                }
+                else if (static_quad_count > 0) {
+                    vkCmdBindVertexBuffers(pass_command_buffer, 1, 1, &m_static_quad_buffer.p_buffer, &offset);
+                    vkCmdDraw(pass_command_buffer, QUAD_VERTEX_COUNT, static_quad_count, 0, 0);
+                }
+
+                // The visible chunks index straight into the tiles, nothing is copied or compacted
+                if (draw_tiles) {
+                    p_tile_pipeline->Bind(pass_command_buffer, frame_index, &bound_sets);
+                    p_tile_pipeline->PushConstants(pass_command_buffer, &uniform_data, sizeof(UniformData));
+                    vkCmdBindVertexBuffers(pass_command_buffer, 1, 1, &m_tile_buffer.p_buffer, &offset);
+                    const InstanceRange &viewport_ranges{m_viewport_tile_ranges[viewport_index]};
+                    for (u32 i = viewport_ranges.begin; i < viewport_ranges.end; ++i) {
+                        const InstanceRange &range{m_visible_tile_ranges[i]};
+                        vkCmdDraw(pass_command_buffer, QUAD_VERTEX_COUNT, range.end - range.begin, 0, range.begin);
+                    }
+                }
+                break;
+            }
+            case DrawPass::Quads: {
+                constexpr VkDeviceSize offset{0};
+                vkCmdBindVertexBuffers(pass_command_buffer, 1, 1, &m_quad_instance_buffers[frame_index].p_buffer,
+                                       &offset);
+
+                // One bind and one indirect draw per pipeline, however many batches the queue split the quads into.
+                // Opaque quads go first so the depth they write rejects the hidden fragments of everything after.
+                const std::array<GraphicsPipeline *, RenderQueue::PIPELINE_COUNT> quad_pipelines{
+                    p_quad_pipeline.get(), p_quad_alpha_test_pipeline.get(), p_quad_transparent_pipeline.get()};
+                u32 first_command{0};
+                for (u32 i = 0; i < RenderQueue::PIPELINE_COUNT; ++i) {
+                    if (m_quad_draw_counts[i] > 0) {
+                        quad_pipelines[i]->Bind(pass_command_buffer, frame_index, &bound_sets);
+                        quad_pipelines[i]->PushConstants(pass_command_buffer, &uniform_data, sizeof(UniformData));
+                        RecordQuadDraws(pass_command_buffer, frame_index, static_cast<BlendMode>(i), first_command,
+                                        m_quad_draw_counts[i]);
+                    }
+                    first_command += m_quad_draw_counts[i];
+                }
+                break;
+            }
+            case DrawPass::Particles: {
+                p_particle_pipeline->Bind(pass_command_buffer, frame_index, &bound_sets);
+                p_particle_pipeline->PushConstants(pass_command_buffer, &uniform_data, sizeof(UniformData));
+                // Only the compacted live particles are drawn on the compute path, their count never leaves the GPU
+                const VkBuffer instance_buffer{m_use_compute_particles
+                                                   ? m_compacted_particle_buffers[frame_index].p_buffer
+                                                   : m_particle_storage_buffers[frame_index].p_buffer};
+                const VkBuffer buffers[]{p_quad_vertex_buffer->p_buffer, instance_buffer};
+                constexpr VkDeviceSize offsets[]{0, 0};
+                vkCmdBindVertexBuffers(pass_command_buffer, 0, 2, buffers, offsets);
+                vkCmdBindIndexBuffer(pass_command_buffer, p_quad_index_buffer->p_buffer, 0, VK_INDEX_TYPE_UINT32);
+                if (m_use_compute_particles) {
+                    vkCmdDrawIndexedIndirect(pass_command_buffer, m_particle_indirect_buffers[frame_index].p_buffer,
+                                             0, 1, sizeof(VkDrawIndexedIndirectCommand));
+                }
+                else {
+                    vkCmdDrawIndexed(pass_command_buffer, m_index_count, particle_instance_count, 0, 0, 0);
+                }
+                break;
+            }
+            case DrawPass::ImGui:
+                ImGui_ImplVulkan_RenderDrawData(draw_data, pass_command_buffer);
+                break;
+            case DrawPass::Upscale: {
+                const UpscaleParams params{.texel_size = {1.0f / static_cast<f32>(m_scene_extent.width),
+                                                          1.0f / static_cast<f32>(m_scene_extent.height)},
+                                           .sharpness = m_upscale_sharpness};
+                p_upscale_pipeline->Bind(pass_command_buffer, frame_index, &bound_sets);
+                p_upscale_pipeline->PushConstants(pass_command_buffer, &params, sizeof(UpscaleParams));
+                vkCmdDraw(pass_command_buffer, 3, 1, 0, 0); // One triangle covering the target
+                break;
+            }
+        }
+    };
+
+    // Records one draw pass into its secondary command buffer, returns false when the pass has nothing to draw
+    const auto record_pass = [&](const DrawPass pass, VkCommandBuffer pass_command_buffer) -> bool {
+        switch (pass) {
+            case DrawPass::StaticQuads: // When culled on the GPU the visible count never leaves it
+                if (static_quad_count == 0 && !draw_tiles) {
+                    return false;
+                }
+                break;
+            case DrawPass::Quads:
+                if (quad_instance_count == 0) {
+                    return false;
+                }
+                break;
+            case DrawPass::Particles:
+                if (!p_particle_pipeline ||
+                    !(gpu_particles || (!m_use_compute_particles && particle_instance_count > 0))) {
+                    return false;
+                }
+                break;
+            case DrawPass::ImGui:
+                if (!draw_data || draw_data->TotalVtxCount == 0) {
+                    return false;
+                }
+                break;
+            case DrawPass::Upscale:
+                if (!scaled) {
+                    return false;
+                }
+                break;
+        }
+
+        const bool world_pass{pass == DrawPass::StaticQuads || pass == DrawPass::Quads || pass == DrawPass::Particles};
+        const VkCommandBufferInheritanceRenderingInfo inheritance_info{GetInheritanceRenderingInfo()};
+        BeginSecondaryCommandBuffer(pass_command_buffer, inheritance_info);
+
+        // GPU scopes follow the compute scope in pass order
+        const auto scope{static_cast<GpuScope>(static_cast<u32>(pass) + 1)};
+        p_gpu_timer->RecordBegin(pass_command_buffer, frame_index, scope);
+
+        // Every viewport draws the same instances with its own camera, the other passes cover the window once
+        BoundDescriptorSets bound_sets{};
+        if (world_pass) {
+            for (u32 viewport_index = 0; viewport_index < viewports.size(); ++viewport_index) {
+                vkCmdSetViewport(pass_command_buffer, 0, 1, &world_viewports[viewport_index]);
+                vkCmdSetScissor(pass_command_buffer, 0, 1, &world_scissors[viewport_index]);
+                record_draws(pass, pass_command_buffer, viewport_index, bound_sets);
+            }
+        }
+        else {
+            vkCmdSetViewport(pass_command_buffer, 0, 1, &viewport);
+            vkCmdSetScissor(pass_command_buffer, 0, 1, &scissor);
+            record_draws(pass, pass_command_buffer, 0, bound_sets);
+        }
+
+        p_gpu_timer->RecordEnd(pass_command_buffer, frame_index, scope);
+        EndCommandBuffer(pass_command_buffer);
+        return true;
+    };
+
+    // The passes are declared before anything is recorded, the upscale pass needs the view Compile gives the
+    // scaled colour target. Every draw is recorded into a secondary command buffer, the graph begins and ends
+    // rendering around them.
+    SmallVector<VkCommandBuffer, DRAW_PASS_COUNT> world_command_buffers;
+    SmallVector<VkCommandBuffer, DRAW_PASS_COUNT> scene_command_buffers;
+
+    RenderGraph::PassBuilder world{graph.AddPass(scaled ? "World" : "Scene")};
+    world.SetColourAttachment(world_colour, VK_ATTACHMENT_LOAD_OP_CLEAR, m_clear_colour)
+        .SetDepthAttachment(world_depth, VK_ATTACHMENT_LOAD_OP_CLEAR)
+        .SetRenderingFlags(VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT)
+        .SetRecord([&](VkCommandBuffer pass_command_buffer) {
+            if (!world_command_buffers.empty()) {
+                vkCmdExecuteCommands(pass_command_buffer, static_cast<u32>(world_command_buffers.size()),
+                                     world_command_buffers.data());
+            }
+        });
+    if (gpu_culling) {
+        world.Read(static_quad_draw, ResourceUsage::IndirectRead).Read(visible_static_quads, ResourceUsage::VertexRead);
+    }
+    else if (static_quad_count > 0) {
+        world.Read(static_quads, ResourceUsage::VertexRead);
+    }
+    if (draw_tiles) {
+        world.Read(tiles, ResourceUsage::VertexRead);
+    }
+    if (graphics_particles) {
+        world.Read(particle_draw, ResourceUsage::IndirectRead).Read(particles, ResourceUsage::VertexRead);
+    }
+    if (light_culling) {
+        world.Read(light_tiles, ResourceUsage::FragmentRead);
+    }
+    for (const RenderGraphResource render_target_image : render_target_images) {
+        world.Read(render_target_image, ResourceUsage::FragmentSampled);
+    }
+
+    // The upscale covers every pixel, the swapchain image's old contents need no clear
+    if (scaled) {
+        graph.AddPass("Scene")
+            .Read(world_colour, ResourceUsage::FragmentSampled)
+            .SetColourAttachment(colour_target, VK_ATTACHMENT_LOAD_OP_DONT_CARE)
+            .SetDepthAttachment(depth_target, VK_ATTACHMENT_LOAD_OP_CLEAR)
+            .SetRenderingFlags(VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT)
+            .SetRecord([&](VkCommandBuffer pass_command_buffer) {
+                vkCmdExecuteCommands(pass_command_buffer, static_cast<u32>(scene_command_buffers.size()),
+                                     scene_command_buffers.data());
+            });
+    }
+
+    // Last, the copy sees the finished image with ImGui on it
+    if (capture_frame) {
+        const VkImage capture_image{p_swapchain->GetImages()[image_index]};
+        graph.AddPass("Frame capture")
+            .Read(colour_target, ResourceUsage::TransferRead)
+            .SetSideEffects()
+            .SetRecord([this, capture_image](VkCommandBuffer pass_command_buffer) {
+                p_frame_capture->RecordCopy(pass_command_buffer, capture_image);
+            });
+    }
+
+    graph.Compile(m_frame_allocator.Get());
+    if (scaled) {
+        p_upscale_pipeline->UpdateImageDescriptor(frame_index, 0, graph.GetImageView(world_colour), p_upscale_sampler);
+    }
+
+    // Passes are spread over the recording threads, pass i always uses the command pool of thread i % thread_count.
+    // Every thread only writes its own passes' flags, the primary executes the recorded ones in pass order.
+    const u32 thread_count{p_command_buffer_manager->GetThreadPoolCount()};
+    const std::span pass_command_buffers{m_secondary_command_buffers.data() + frame_index * DRAW_PASS_COUNT,
+                                         DRAW_PASS_COUNT};
+    std::array<bool, DRAW_PASS_COUNT> pass_recorded{};
+
+    p_command_buffer_manager->ResetThreadPools(frame_index);
+    p_worker_pool->Run(thread_count, [&](const u32 thread_index) {
+        ENGINE_PROFILE_SCOPE("Record draw passes");
+        for (u32 pass = thread_index; pass < DRAW_PASS_COUNT; pass += thread_count) {
+            pass_recorded[pass] = record_pass(static_cast<DrawPass>(pass), pass_command_buffers[pass]);
+        }
+    });
+
+    // The upscale goes first in the scene pass, ImGui is drawn over it
+    if (pass_recorded[static_cast<u32>(DrawPass::Upscale)]) {
+        scene_command_buffers.push_back(pass_command_buffers[static_cast<u32>(DrawPass::Upscale)]);
+    }
+    for (u32 pass = 0; pass < static_cast<u32>(DrawPass::Upscale); ++pass) {
+        if (!pass_recorded[pass]) {
+            continue;
+        }
+        if (scaled && static_cast<DrawPass>(pass) == DrawPass::ImGui) {
+            scene_command_buffers.push_back(pass_command_buffers[pass]);
+        }
+        else {
+            world_command_buffers.push_back(pass_command_buffers[pass]);
+        }
+    }
+
+    graph.Execute(command_buffer);
+    EndCommandBuffer(command_buffer);
+}
+
+u64 Renderer::HashFrameStructure(const u32 image_index, const std::span<const RenderViewport> viewports,
+                                 const u32 quad_instance_count, const u32 particle_instance_count,
+                                 const ImDrawData *draw_data, const bool capture_frame) const
+{
+    // The same flags RecordCommandBuffer derives its passes from
+    const bool gpu_particles{m_use_compute_particles && m_particle_pool_active};
+    const bool graphics_particles{gpu_particles && !m_use_async_compute};
+
+    // Copies, redrawn render targets, the emitter's spawns and ImGui's vertices are recorded for one frame only
+    if (capture_frame || !m_static_quad_copies.empty() || !m_render_target_draws.empty() ||
+        (draw_data && draw_data->TotalVtxCount > 0) ||
+        (graphics_particles && (m_reset_particle_pool || m_particle_spawn_count > 0))) {
+        return NO_FRAME_STRUCTURE;
+    }
+
+    u64 hash{utils::FNV1A_OFFSET_BASIS};
+    const auto combine = [&hash]<typename T>(const T &value) {
+        hash = utils::fnv1a(std::as_bytes(std::span<const T>{&value, 1}), hash);
+    };
+    const auto combine_span = [&hash]<typename T>(const std::span<const T> values) {
+        hash = utils::fnv1a(std::as_bytes(values), hash);
+    };
+
+    combine(image_index);
+    combine(p_swapchain->GetExtent());
+    combine(m_scene_extent);
+    combine(m_clear_colour);
+    combine(m_upscale_sharpness);
+    combine(quad_instance_count);
+    combine(particle_instance_count);
+    combine(gpu_particles);
+    combine(graphics_particles);
+    combine(m_use_compute_particles);
+    combine(m_use_gpu_culling);
+    combine(m_simulation_params.sort_by_depth);
+    combine(m_index_count);
+    combine(m_cull_params.instance_count);
+    combine(m_cull_params.viewport_count);
+    combine(m_cull_params.visible_capacity);
+    combine(m_light_params.light_count);
+    combine(m_light_params.tile_count);
+    combine(m_quad_draw_counts);
+    combine(p_tile_pipeline);
+    combine_span(std::span<const InstanceRange>{m_visible_tile_ranges.data(), m_visible_tile_ranges.size()});
+    combine_span(std::span<const InstanceRange>{m_viewport_tile_ranges.data(), viewports.size()});
+    if (!p_device->GetCapabilities().multi_draw_indirect) {
+        for (const DrawBatch &batch : m_quad_queue.GetBatches()) {
+            combine(batch.blend_mode);
+            combine(batch.first_instance);
+            combine(batch.instance_count);
+        }
+    }
+
+    // The cameras are push constants, a moving camera records again
+    for (const RenderViewport &viewport : viewports) {
+        combine(viewport.camera);
+        combine(GetViewportRect(viewport));
+    }
+
+    // Never NO_FRAME_STRUCTURE, which reads as nothing to reuse
+    return hash != NO_FRAME_STRUCTURE ? hash : hash + 1;
+}
+
+void Renderer::DiscardRecordedFrames()
+{
+    std::ranges::fill(m_recorded_frame_structures, NO_FRAME_STRUCTURE);
+}
+
+void Renderer::Render(const f32 delta_time, const UniformData &uniform_data,
+                      const std::vector<InstanceData> &frame_quad_instances,
+                      const std::vector<ParticleData> &particle_instances)
+{
+    // The application recreates the swapchain, nothing can be drawn until it has
+    if (!p_swapchain->IsValid()) {
+        return;
+    }
+
+    m_frame_allocator.BeginFrame();
+    LinearAllocator &frame_allocator{m_frame_allocator.Get()};
+
+    ProcessFileChanges();
+    p_frame_capture->Collect(m_queue);
+    ApplyPipelineVariants();
+    ApplyShaderReload();
+    DestroyRetiredPipelines();
+    DestroyRetiredSwapchains(false);
+    p_render_graph->DestroyRetired(false);
+    UpdateGlyphCache();
+    p_thumbnail_cache->Update();
+
+    const std::span<const InstanceData> quad_instances{GatherQuadInstances(frame_quad_instances)};
+
+    // Residency follows what the CPU sees drawn, GPU culled static quads are pinned instead. Texture arrays are
+    // always resident.
+    for (const InstanceData &instance : quad_instances) {
+        if (instance.texture_layer == InstanceData::NO_TEXTURE_LAYER) {
+            p_texture_manager->MarkTextureUsed(instance.texture_index);
+        }
+    }
+    for (const ParticleData &particle : particle_instances) {
+        p_texture_manager->MarkTextureUsed(particle.texture_index);
+    }
+    for (const ParticleData &particle : m_pending_particle_spawns) {
+        p_texture_manager->MarkTextureUsed(particle.texture_index);
+    }
+    for (const RenderTarget &target : m_render_targets) {
+        if (target.update_pending) {
+            for (const InstanceData &instance : target.quads) {
+                if (instance.texture_layer == InstanceData::NO_TEXTURE_LAYER) {
+                    p_texture_manager->MarkTextureUsed(instance.texture_index);
+                }
+            }
+        }
+    }
+    if (m_static_quad_textures_dirty) {
+        m_static_quad_textures_dirty = false;
+        const size_t tile_texture_count{m_tile_count > 0 ? 1u : 0u};
+        const std::span<u32> pinned_textures{
+            frame_allocator.AllocateSpan<u32>(m_static_quad_instances.size() + tile_texture_count)};
+        // Array instances pin the default texture, which is pinned anyway
+        std::ranges::transform(m_static_quad_instances, pinned_textures.begin(), [](const InstanceData &instance) {
+            return instance.texture_layer == InstanceData::NO_TEXTURE_LAYER ? instance.texture_index : 0u;
+        });
+        if (tile_texture_count > 0) {
+            pinned_textures.back() = m_tile_texture_index;
+        }
+        std::ranges::sort(pinned_textures);
+        const auto [first, last] = std::ranges::unique(pinned_textures);
+        p_texture_manager->SetPinnedTextures({pinned_textures.begin(), first});
+    }
+    p_texture_manager->UpdateResidency(m_queue.GetLastSubmittedValue());
+
+    p_texture_manager->ProcessAsyncLoads(m_queue.GetLastSubmittedValue(), m_queue.GetCompletedValue());
+
+    // Submit any uploads recorded since the last frame so they are ordered before this frame's draws
+    p_buffer_manager->FlushUploads();
+    p_buffer_manager->RetireUploads();
+
+    const u32 frame_index{m_current_frame};
+
+    SteadyClock::time_point wait_start{SteadyClock::now()};
+
+    // Only wait for the GPU to finish the frame that last used this slot's resources. This also guarantees the
+    // compute pass that wrote this slot's particle buffers has retired before they are overwritten below.
+    m_queue.WaitForValue(m_frame_timeline_values[frame_index]);
+    FloatingPointMilliseconds fence_wait_time{SteadyClock::now() - wait_start};
+    m_frame_descriptor_allocators[frame_index]->Reset();
+    UpdateTextureDescriptors(frame_index);
+    p_gpu_timer->CollectResults(frame_index);
+
+    wait_start = SteadyClock::now();
+    const u32 image_index{m_queue.AcquireNextImage(frame_index)};
+    const FloatingPointMilliseconds acquire_time{SteadyClock::now() - wait_start};
+    if (image_index == constants::u32_max) {
+        return;
+    }
+
+    // The driver may hand back an image that a different frame slot is still rendering to
+    wait_start = SteadyClock::now();
+    m_queue.WaitForValue(m_image_timeline_values[image_index]);
+    fence_wait_time += FloatingPointMilliseconds{SteadyClock::now() - wait_start};
+
+    // Everything recorded below is sized to the world's extent
+    UpdateRenderScale();
+
+    // Particles beyond the storage buffer capacity are dropped
+    u32 particle_count{0};
+    if (m_use_compute_particles) {
+        // Compute path: only this frame's spawns are uploaded, the simulation state never leaves the GPU
+        m_particle_spawn_count = UploadParticleSpawns(frame_index);
+    }
+    else {
+        // CPU path: Use m_particles_instances directly
+        m_particles_instances = particle_instances; // Already updated in Scene::UpdateParticles
+        particle_count = static_cast<u32>(
+            math::min(particle_instances.size(), static_cast<size_t>(m_max_particle_instances)));
+        UpdateParticleStorageBuffer(frame_index, particle_instances);
+        m_particle_spawn_count = 0;
+    }
+
+    // Update compute uniform buffer
+    UpdateComputeUniformBuffer(frame_index, delta_time, m_particle_spawn_count);
+    if (m_use_compute_particles) {
+        UploadParticleColliders(frame_index);
+    }
+
+    // Stage the static quads changed since the last frame, the copies are recorded with this frame's commands
+    const u32 static_quad_update_count{UploadStaticQuadUpdates(frame_index)};
+
+    // One viewport over the whole window unless SetViewports split it, culled against SetCullFrustum's bounds
+    RenderViewport window_viewport;
+    window_viewport.camera = uniform_data;
+    const std::span<const RenderViewport> viewports{
+        m_viewports.empty() ? std::span<const RenderViewport>{&window_viewport, 1}
+                            : std::span<const RenderViewport>{m_viewports.data(), m_viewports.size()}};
+
+    if (m_use_gpu_culling) {
+        m_cull_uniform_buffers[frame_index].Update(&m_cull_params, sizeof(CullParams));
+    }
+    CullTileChunks();
+    if (!m_visible_tile_ranges.empty()) {
+        // Every tile is an opaque, unanimated atlas sprite drawn with camera effects
+        static const SpecializationConstants tile_constants{
+            SpecializationConstants{}
+                .Set("forced_flag_mask", QuadInstance::is_animated_bit | QuadInstance::is_atlas_bit |
+                                             QuadInstance::apply_camera_effects_bit)
+                .Set("forced_flags", QuadInstance::is_atlas_bit | QuadInstance::apply_camera_effects_bit)};
+        p_tile_pipeline = &GetPipelineVariant(PipelineType::Quad, tile_constants);
+    }
+    UpdateLights(frame_index, viewports);
+    UploadAnimationTables(frame_index);
+    const u32 render_target_update_count{UploadRenderTargetUpdates(frame_index)};
+
+    // Update quad instance data
+    ASSERT(quad_instances.size() <= m_max_quad_instances, "Quad instance count exceeds maximum buffer size.");
+    m_quad_queue.Build(quad_instances);
+    if (!quad_instances.empty()) {
+        m_quad_queue.WriteInstances(quad_instances,
+                                    static_cast<QuadInstance *>(m_mapped_quad_instance_data[frame_index]));
+        m_quad_instance_buffers[frame_index].Flush(0, sizeof(QuadInstance) * quad_instances.size());
+    }
+    WriteQuadDrawCommands(frame_index);
+
+    // TODO: Only update this in debug mode
+    m_render_statistics.delta_time = delta_time;
+    m_render_statistics.fence_wait_time = static_cast<f32>(fence_wait_time.count());
+    // Glyphs are quads too, counted apart
+    const u32 glyph_count{static_cast<u32>(std::ranges::count_if(
+        quad_instances, [](const InstanceData &instance) { return instance.distance_range > 0.0f; }))};
+    m_render_statistics.quad_count = static_cast<u32>(quad_instances.size()) - glyph_count;
+    m_render_statistics.quad_draw_count = static_cast<u32>(m_quad_queue.GetBatches().size());
+    m_render_statistics.static_quad_count = m_cull_params.instance_count;
+    m_render_statistics.static_quad_update_count = static_quad_update_count;
+    m_render_statistics.tile_count = m_tile_count;
+    m_render_statistics.tile_chunk_count = static_cast<u32>(m_tile_chunks.size());
+    m_render_statistics.viewport_count = static_cast<u32>(viewports.size());
+    m_render_statistics.vertex_count = m_vertex_count;
+    m_render_statistics.index_count = m_index_count;
+    m_render_statistics.particle_count = particle_count;
+    m_render_statistics.particle_spawn_count = m_particle_spawn_count;
+    m_render_statistics.light_count = m_light_params.light_count;
+    m_render_statistics.render_target_update_count = render_target_update_count;
+    m_render_statistics.render_scale = m_current_render_scale;
+    m_render_statistics.glyph_count = glyph_count;
+    m_render_statistics.texture_count = p_texture_manager->GetTextureCount();
+    m_render_statistics.font_count =
+        static_cast<u32>(std::ranges::count_if(m_fonts, [](const MSDFGlyphTable &font) { return !font.IsEmpty(); }));
+    m_render_statistics.cached_glyph_count = p_glyph_cache->GetGlyphCount();
+    m_render_statistics.thumbnail_count = p_thumbnail_cache->GetThumbnailCount();
+    m_render_statistics.total_instances = m_render_statistics.quad_count + m_render_statistics.particle_count + m_render_statistics.glyph_count;
+    m_render_statistics.memory = p_device->GetAllocator()->GetStatistics();
+    m_render_statistics.gpu_timings = p_gpu_timer->GetTimings();
+    ENGINE_PROFILE_GAUGE("Instances", m_render_statistics.total_instances);
+
+    // Sampled when the frame began, so these are of the frame before
+    gouda::internal::profiler::Profiler &profiler{gouda::internal::profiler::Profiler::Get()};
+    m_render_statistics.uploaded_bytes = static_cast<u64>(profiler.GetFrameCounterSample(UPLOADED_BYTES_COUNTER));
+    m_render_statistics.descriptor_write_count =
+        static_cast<u32>(profiler.GetFrameCounterSample(DESCRIPTOR_WRITES_COUNTER));
+
+    // Render ImGui, nothing is built or drawn while the debug UI is hidden
+    ImDrawData *imgui_draw_data{nullptr};
+#ifdef USE_IMGUI
+    imgui_draw_data = m_is_imgui_prebuilt ? p_prebuilt_imgui_draw_data : RenderImGUI();
+    m_is_imgui_prebuilt = false;
+#endif
+
+    // Kick the simulation off on the compute queue first. It overlaps with the previous frame still rendering on the
+    // graphics queue, and only the indirect draw and vertex input of this frame wait for it.
+    u64 compute_value{NO_TIMELINE_VALUE};
+    if (m_use_compute_particles && m_use_async_compute && m_particle_pool_active) {
+        compute_value = SubmitParticleCompute(frame_index);
+    }
+
+    const VkCommandBuffer command_buffer{m_command_buffers[frame_index]};
+    const bool capture_frame{p_swapchain->CanReadBack() &&
+                             p_frame_capture->BeginFrame(p_swapchain->GetExtent(), m_colour_attachment_format)};
+    const u64 frame_structure{HashFrameStructure(image_index, viewports, static_cast<u32>(quad_instances.size()),
+                                                 particle_count, imgui_draw_data, capture_frame)};
+    m_render_statistics.is_command_buffer_reused =
+        frame_structure != NO_FRAME_STRUCTURE && m_recorded_frame_structures[frame_index] == frame_structure;
+    if (!m_render_statistics.is_command_buffer_reused) {
+        vkResetCommandBuffer(command_buffer, 0);
+        RecordCommandBuffer(command_buffer, frame_index, image_index, viewports,
+                            static_cast<u32>(quad_instances.size()), particle_count, imgui_draw_data, capture_frame);
+
+        // Slots recorded for another structure may use transient images the graph just replaced
+        for (u64 &structure : m_recorded_frame_structures) {
+            if (structure != frame_structure) {
+                structure = NO_FRAME_STRUCTURE;
+            }
+        }
+        m_recorded_frame_structures[frame_index] = frame_structure;
+    }
+    m_render_statistics.barrier_count = p_render_graph->GetBarrierCount();
+    m_render_statistics.culled_pass_count = p_render_graph->GetCulledPassCount();
+    m_render_statistics.sampler_count = static_cast<u32>(p_buffer_manager->GetSamplerCache().GetSamplerCount());
+    m_render_statistics.descriptor_pool_count = static_cast<u32>(p_descriptor_allocator->GetPoolCount());
+    for (const std::unique_ptr<DescriptorAllocator> &allocator : m_frame_descriptor_allocators) {
+        m_render_statistics.descriptor_pool_count += static_cast<u32>(allocator->GetPoolCount());
+    }
+    m_render_statistics.pipeline_layout_count = static_cast<u32>(p_layout_cache->GetPipelineLayoutCount());
+    m_render_statistics.transient_memory = p_render_graph->GetTransientMemorySize();
+
+    const u64 submit_value{m_queue.Submit(command_buffer, frame_index, image_index,
+                                          m_compute_queue.GetTimelineSemaphore(), compute_value,
+                                          VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT)};
+    m_frame_timeline_values[frame_index] = submit_value;
+    m_image_timeline_values[image_index] = submit_value;
+    p_frame_capture->EndFrame(submit_value);
+    p_gpu_timer->MarkSubmitted(frame_index);
+    if (m_use_compute_particles && m_particle_pool_active) {
+        m_reset_particle_pool = false;
+    }
+
+    wait_start = SteadyClock::now();
+    m_queue.Present(image_index);
+    m_render_statistics.present_latency =
+        static_cast<f32>((acquire_time + FloatingPointMilliseconds{SteadyClock::now() - wait_start}).count());
+
+    m_current_frame = (m_current_frame + 1) % m_frames_in_flight;
+}
+
+void Renderer::UpdateComputeUniformBuffer(const u32 frame_index, const f32 delta_time, const u32 spawn_count)
+{
+    m_simulation_params.delta_time = delta_time;
+    m_simulation_params.spawn_count = spawn_count;
+    m_simulation_params.sort_by_depth = m_sort_particles && p_particle_sort ? 1 : 0;
+    if (m_simulation_params.turbulence_strength != 0.0f) {
+        m_simulation_params.turbulence_time =
+            std::fmod(m_simulation_params.turbulence_time + delta_time, PARTICLE_TURBULENCE_TIME_WRAP);
+    }
+    m_compute_uniform_buffers[frame_index].Update(&m_simulation_params, sizeof(SimulationParams));
+}
+
+void Renderer::UpdateParticleStorageBuffer(const u32 frame_index,
+                                           const std::vector<ParticleData> &particle_instances) const
+{
+    const VkDeviceSize particle_instance_size =
+        sizeof(ParticleData) * std::min(particle_instances.size(), static_cast<size_t>(m_max_particle_instances));
+
+    // Only update if there are particles
+    if (!particle_instances.empty()) {
+        memcpy(m_mapped_particle_storage_data[frame_index], particle_instances.data(), particle_instance_size);
+        m_particle_storage_buffers[frame_index].Flush(0, particle_instance_size);
+    }
+
+    // ENGINE_LOG_DEBUG("Updating particle storage buffer[{}]: {} particles, size = {} bytes",
+    //           frame_index, particle_instances.size(), particle_instance_size);
+}
+
+void Renderer::ClearParticleBuffers(const u32 frame_index) const
+{
+    const VkDeviceSize max_particle_instance_size{sizeof(ParticleData) * m_max_particle_instances};
+    memset(m_mapped_particle_storage_data[frame_index], 0, max_particle_instance_size);
+    m_particle_storage_buffers[frame_index].Flush(0, max_particle_instance_size);
+}
+
+void Renderer::EmitParticles(const std::span<const ParticleData> particles)
+{
+    m_pending_particle_spawns.insert(m_pending_particle_spawns.end(), particles.begin(), particles.end());
+}
+
+void Renderer::SetAsyncCompute(const bool enabled)
+{
+    if (enabled && !SupportsAsyncCompute()) {
+        ENGINE_LOG_WARNING("Async compute requested but the device has no separate compute queue.");
+        return;
+    }
+
+    // The particle pool is carried from frame to frame, make sure no step is still running on the other queue
+    if (enabled != m_use_async_compute) {
+        p_device->Wait();
+    }
+
+    m_use_async_compute = enabled;
+    ENGINE_LOG_DEBUG("Async compute {}.", m_use_async_compute ? "enabled" : "disabled");
+}
+
+u32 Renderer::UploadParticleSpawns(const u32 frame_index)
+{
+    if (m_pending_particle_spawns.empty()) {
+        return 0;
+    }
+
+    const u32 taken_count{static_cast<u32>(
+        math::min(m_pending_particle_spawns.size(), static_cast<size_t>(MAX_PARTICLE_SPAWNS_PER_FRAME)))};
+    const u32 spawn_count{math::min(taken_count, m_particle_spawn_limit)};
+    if (spawn_count == taken_count) {
+        memcpy(m_mapped_particle_spawn_data[frame_index], m_pending_particle_spawns.data(),
+               sizeof(ParticleData) * spawn_count);
+    }
+    else {
+        // Every emitter of the frame keeps its share, rather than the last ones queued losing all of theirs
+        auto *spawns{static_cast<ParticleData *>(m_mapped_particle_spawn_data[frame_index])};
+        for (u32 i = 0; i < spawn_count; ++i) {
+            spawns[i] = m_pending_particle_spawns[static_cast<size_t>(i) * taken_count / spawn_count];
+        }
+    }
+    m_pending_particle_spawns.erase(m_pending_particle_spawns.begin(),
+                                    m_pending_particle_spawns.begin() + static_cast<std::ptrdiff_t>(taken_count));
+    if (spawn_count == 0) {
+        return 0;
+    }
+    m_particle_spawn_buffers[frame_index].Flush(0, sizeof(ParticleData) * spawn_count);
+
+    m_particle_pool_active = true;
+    return spawn_count;
+}
+
+void Renderer::SetParticleTurbulence(const f32 strength, const f32 frequency)
+{
+    const bool is_enabled{strength != 0.0f && frequency > 0.0f};
+    m_simulation_params.turbulence_strength = is_enabled ? strength : 0.0f;
+    m_simulation_params.turbulence_frequency = is_enabled ? frequency : 0.0f;
+}
+
+void Renderer::SetParticleColliders(const std::span<const math::AABB2D> colliders, const f32 cell_size,
+                                    const f32 restitution)
+{
+    // An inside out box covers no cell, and would leave the cell maths below with a negative range
+    m_particle_colliders.clear();
+    for (const math::AABB2D &collider : colliders) {
+        if (!(collider.min.x <= collider.max.x && collider.min.y <= collider.max.y)) {
+            continue;
+        }
+        if (m_particle_colliders.size() == MAX_PARTICLE_COLLIDERS) {
+            ENGINE_LOG_WARNING("{} particle colliders given, only the first {} are used.", colliders.size(),
+                               MAX_PARTICLE_COLLIDERS);
+            break;
+        }
+        m_particle_colliders.push_back(collider);
+    }
+
+    const auto collider_count{static_cast<u32>(m_particle_colliders.size())};
+    m_particle_collision_cells.clear();
+    m_simulation_params.collider_count = collider_count;
+    m_simulation_params.restitution = restitution;
+    m_simulation_params.collision_cell_count = {0u, 0u};
+    ++m_particle_collider_version;
+    if (collider_count == 0) {
+        return;
+    }
+
+    math::AABB2D bounds{m_particle_colliders[0]};
+    for (const math::AABB2D &collider : m_particle_colliders) {
+        bounds.min = {math::min(bounds.min.x, collider.min.x), math::min(bounds.min.y, collider.min.y)};
+        bounds.max = {math::max(bounds.max.x, collider.max.x), math::max(bounds.max.y, collider.max.y)};
+    }
+
+    // Larger cells mean fewer cells and fewer colliders spanning several of them, one cell always fits
+    struct CellRange {
+        u32 min_x;
+        u32 min_y;
+        u32 max_x;
+        u32 max_y;
+    };
+    f32 size{math::max(cell_size, 1.0f)};
+    UVec2 cell_count{1u, 1u};
+    const auto cell_range = [&](const math::AABB2D &collider) {
+        const auto cell_x = [&](const f32 x) {
+            return static_cast<u32>(std::clamp((x - bounds.min.x) / size, 0.0f, static_cast<f32>(cell_count.x - 1)));
+        };
+        const auto cell_y = [&](const f32 y) {
+            return static_cast<u32>(std::clamp((y - bounds.min.y) / size, 0.0f, static_cast<f32>(cell_count.y - 1)));
+        };
+        return CellRange{cell_x(collider.min.x), cell_y(collider.min.y), cell_x(collider.max.x),
+                         cell_y(collider.max.y)};
+    };
+    while (true) {
+        cell_count = {math::max(static_cast<u32>(std::ceil((bounds.max.x - bounds.min.x) / size)), 1u),
+                      math::max(static_cast<u32>(std::ceil((bounds.max.y - bounds.min.y) / size)), 1u)};
+        if (static_cast<u64>(cell_count.x) * cell_count.y <= MAX_PARTICLE_COLLISION_CELLS) {
+            u64 entry_count{0};
+            for (const math::AABB2D &collider : m_particle_colliders) {
+                const CellRange range{cell_range(collider)};
+                entry_count += static_cast<u64>(range.max_x - range.min_x + 1) * (range.max_y - range.min_y + 1);
+            }
+            if (entry_count <= MAX_PARTICLE_COLLISION_ENTRIES) {
+                break;
+            }
+        }
+        size *= 2.0f;
+    }
+
+    // Counted into the offsets first, then filled through a cursor per cell
+    const u32 total_cells{cell_count.x * cell_count.y};
+    Vector<u32> offsets(total_cells + 1, 0u);
+    for (const math::AABB2D &collider : m_particle_colliders) {
+        const CellRange range{cell_range(collider)};
+        for (u32 y = range.min_y; y <= range.max_y; ++y) {
+            for (u32 x = range.min_x; x <= range.max_x; ++x) {
+                ++offsets[y * cell_count.x + x + 1];
+            }
+        }
+    }
+    for (u32 cell = 0; cell < total_cells; ++cell) {
+        offsets[cell + 1] += offsets[cell];
+    }
+
+    m_particle_collision_cells = offsets;
+    m_particle_collision_cells.resize(offsets.size() + offsets.back());
+    for (u32 collider = 0; collider < collider_count; ++collider) {
+        const CellRange range{cell_range(m_particle_colliders[collider])};
+        for (u32 y = range.min_y; y <= range.max_y; ++y) {
+            for (u32 x = range.min_x; x <= range.max_x; ++x) {
+                m_particle_collision_cells[offsets.size() + offsets[y * cell_count.x + x]++] = collider;
+            }
+        }
+    }
+
+    m_simulation_params.collision_origin = bounds.min;
+    m_simulation_params.collision_cell_count = cell_count;
+    m_simulation_params.collision_cell_size = size;
+}
+
+void Renderer::UploadParticleColliders(const u32 frame_index)
+{
+    if (m_particle_collider_frame_versions[frame_index] == m_particle_collider_version) {
+        return;
+    }
+    if (!m_particle_colliders.empty()) {
+        m_particle_collider_buffers[frame_index].Update(m_particle_colliders.data(),
+                                                        sizeof(math::AABB2D) * m_particle_colliders.size());
+        m_particle_collision_cell_buffers[frame_index].Update(m_particle_collision_cells.data(),
+                                                              sizeof(u32) * m_particle_collision_cells.size());
+    }
+    m_particle_collider_frame_versions[frame_index] = m_particle_collider_version;
+}
+
+void Renderer::RecordParticleCompute(VkCommandBuffer command_buffer, const u32 frame_index) const
+{
+    // The previous step on this queue wrote the pool and its free list
+    const VkMemoryBarrier previous_step_barrier{
+        .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT,
+    };
+    vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1,
+                         &previous_step_barrier, 0, nullptr, 0, nullptr);
+
+    // Zeroing the free count and high water mark empties the pool, stale slots are never visited again
+    if (m_reset_particle_pool) {
+        vkCmdFillBuffer(command_buffer, m_particle_pool_state_buffer.p_buffer, 0, 2 * sizeof(u32), 0);
+    }
+
+    // Reset the draw command so the compaction appends from zero
+    const VkDrawIndexedIndirectCommand draw_command{
+        .indexCount = m_index_count,
+        .instanceCount = 0,
+        .firstIndex = 0,
+        .vertexOffset = 0,
+        .firstInstance = 0,
+    };
+    vkCmdUpdateBuffer(command_buffer, m_particle_indirect_buffers[frame_index].p_buffer, 0, sizeof(draw_command),
+                      &draw_command);
+
+    const VkMemoryBarrier reset_barrier{
+        .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+    };
+    vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1,
+                         &reset_barrier, 0, nullptr, 0, nullptr);
+
+    // Emit places this frame's spawns in dead or untouched pool slots, then the simulation steps the pool.
+    // Simulation invocations past the pool's high water mark exit straight away.
+    SmallVector<ComputeDispatch, 2> dispatches;
+    if (m_particle_spawn_count > 0) {
+        dispatches.push_back({p_particle_emit_pipeline.get(), frame_index,
+                              p_particle_emit_pipeline->CalculateWorkGroupCount({m_particle_spawn_count, 1, 1}),
+                              {}});
+    }
+    dispatches.push_back({p_particle_compute_pipeline.get(), frame_index,
+                          p_particle_compute_pipeline->CalculateWorkGroupCount({m_max_particle_instances, 1, 1}),
+                          {}});
+    record_compute_chain(command_buffer, {dispatches.data(), dispatches.size()});
+
+    // Sorted, the simulation wrote depth keys and pool indices instead of the particles. The gather copies them to
+    // the compacted buffer in draw order, it covers the whole pool as the live count never leaves the GPU.
+    if (m_simulation_params.sort_by_depth != 0) {
+        record_compute_barrier(command_buffer);
+        p_particle_sort->Record(command_buffer, frame_index);
+        record_compute_barrier(command_buffer);
+        const UVec3 group_counts{p_particle_gather_pipeline->CalculateWorkGroupCount({m_max_particle_instances, 1, 1})};
+        const ComputeDispatch gather{p_particle_gather_pipeline.get(), frame_index, group_counts, {}};
+        record_compute_chain(command_buffer, {&gather, 1});
+    }
+}
+
+u64 Renderer::SubmitParticleCompute(const u32 frame_index)
+{
+    // The graphics frame that last used this slot has completed, and it waited on the previous compute submission
+    const VkCommandBuffer command_buffer{m_compute_command_buffers[frame_index]};
+    vkResetCommandBuffer(command_buffer, 0);
+    BeginCommandBuffer(command_buffer, VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+    RecordParticleCompute(command_buffer, frame_index);
+    EndCommandBuffer(command_buffer);
+
+    // The storage buffers are shared concurrently, the semaphore wait on the graphics side makes the writes visible
+    return m_compute_queue.Submit(command_buffer);
+}
+
+void Renderer::RecordQuadCull(VkCommandBuffer command_buffer, const u32 frame_index) const
+{
+    // Reset every viewport's draw command so the cull pass appends from zero
+    std::array<VkDrawIndirectCommand, MAX_VIEWPORTS> draw_commands;
+    draw_commands.fill({
+        .vertexCount = QUAD_VERTEX_COUNT,
+        .instanceCount = 0,
+        .firstVertex = 0,
+        .firstInstance = 0,
+    });
+    vkCmdUpdateBuffer(command_buffer, m_cull_indirect_buffers[frame_index].p_buffer, 0,
+                      sizeof(VkDrawIndirectCommand) * m_cull_params.viewport_count, draw_commands.data());
+
+    const VkMemoryBarrier reset_barrier{
+        .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+    };
+    vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1,
+                         &reset_barrier, 0, nullptr, 0, nullptr);
+
+    p_quad_cull_pipeline->Bind(command_buffer);
+    p_quad_cull_pipeline->BindDescriptors(command_buffer, frame_index);
+    // One row of workgroups per viewport, all of them cull the same instances
+    const UVec3 invocation_count{m_cull_params.instance_count, m_cull_params.viewport_count, 1};
+    p_quad_cull_pipeline->Dispatch(command_buffer, p_quad_cull_pipeline->CalculateWorkGroupCount(invocation_count));
+}
+
+void Renderer::UpdateRenderScale()
+{
+    // Steps of a few percent, held long enough for the timings to show what the last step did
+    constexpr f32 step{0.05f};
+    constexpr u32 cooldown_frames{30};
+    constexpr f32 raise_threshold{0.8f};
+
+    const f32 gpu_time{p_gpu_timer->GetTimings().frame_time};
+    if (m_target_gpu_time > 0.0f && gpu_time > 0.0f) {
+        if (m_render_scale_cooldown > 0) {
+            --m_render_scale_cooldown;
+        }
+        else if (gpu_time > m_target_gpu_time && m_current_render_scale > MIN_RENDER_SCALE) {
+            m_current_render_scale = math::max(m_current_render_scale - step, MIN_RENDER_SCALE);
+            m_render_scale_cooldown = cooldown_frames;
+        }
+        else if (gpu_time < m_target_gpu_time * raise_threshold && m_current_render_scale < m_render_scale) {
+            m_current_render_scale = math::min(m_current_render_scale + step, m_render_scale);
+            m_render_scale_cooldown = cooldown_frames;
+        }
+    }
+
+    const VkExtent2D extent{p_swapchain->GetExtent()};
+    if (m_current_render_scale >= 1.0f) {
+        m_scene_extent = extent;
+        return;
+    }
+    const auto scale_size = [this](const u32 size) {
+        return math::max(static_cast<u32>(std::lround(static_cast<f32>(size) * m_current_render_scale)), 1u);
+    };
+    m_scene_extent = {scale_size(extent.width), scale_size(extent.height)};
+}
+
+void Renderer::UpdateLights(const u32 frame_index, const std::span<const RenderViewport> viewports)
+{
+    // Tiles are sized to the world's extent every frame, so a resize or a new render scale needs nothing else
+    const VkExtent2D extent{m_scene_extent};
+    u32 tile_size{LIGHT_TILE_SIZE};
+    UVec2 tile_count{(extent.width + tile_size - 1) / tile_size, (extent.height + tile_size - 1) / tile_size};
+    while (tile_count.x * tile_count.y > MAX_LIGHT_TILES) {
+        tile_size *= 2;
+        tile_count = {(extent.width + tile_size - 1) / tile_size, (extent.height + tile_size - 1) / tile_size};
+    }
+
+    m_light_params.viewport_count = static_cast<u32>(viewports.size());
+    for (u32 i = 0; i < viewports.size(); ++i) {
+        const VkRect2D rect{GetViewportRect(viewports[i])};
+        m_light_params.viewport_wvps[i] = viewports[i].camera.wvp;
+        m_light_params.viewport_rects[i] = {static_cast<f32>(rect.offset.x), static_cast<f32>(rect.offset.y),
+                                            static_cast<f32>(rect.extent.width), static_cast<f32>(rect.extent.height)};
+    }
+    m_light_params.framebuffer_size = {static_cast<f32>(extent.width), static_cast<f32>(extent.height)};
+    m_light_params.tile_size = tile_size;
+    m_light_params.tile_count = tile_count;
+    m_light_params.light_count = static_cast<u32>(math::min(m_lights.size(), static_cast<size_t>(m_light_limit)));
+
+    // The fragment shaders read the parameters even without lights, to skip the tile lists
+    m_light_uniform_buffers[frame_index].Update(&m_light_params, sizeof(LightParams));
+    if (m_light_params.light_count > 0) {
+        m_light_buffers[frame_index].Update(m_lights.data(), sizeof(PointLight) * m_light_params.light_count);
+    }
+}
+
+VkRect2D Renderer::GetViewportRect(const RenderViewport &viewport) const
+{
+    // Edges are rounded to whole pixels of the world target on their own, so viewports sharing an edge meet without
+    // a gap or an overlap at any render scale
+    const auto to_pixels = [](const f32 fraction, const u32 size) {
+        return static_cast<u32>(std::round(math::clamp(fraction, 0.0f, 1.0f) * static_cast<f32>(size)));
+    };
+    const u32 x{math::min(to_pixels(viewport.offset.x, m_scene_extent.width), m_scene_extent.width - 1)};
+    const u32 y{math::min(to_pixels(viewport.offset.y, m_scene_extent.height), m_scene_extent.height - 1)};
+    const u32 right{to_pixels(viewport.offset.x + viewport.size.x, m_scene_extent.width)};
+    const u32 bottom{to_pixels(viewport.offset.y + viewport.size.y, m_scene_extent.height)};
+    return {{static_cast<s32>(x), static_cast<s32>(y)}, {math::max(right, x + 1) - x, math::max(bottom, y + 1) - y}};
+}
+
+void Renderer::RecordLightCull(VkCommandBuffer command_buffer, const u32 frame_index) const
+{
+    // One workgroup per tile, every tile's count is written so nothing stale is left from earlier frames
+    p_light_cull_pipeline->Bind(command_buffer);
+    p_light_cull_pipeline->BindDescriptors(command_buffer, frame_index);
+    const UVec3 workgroup_count{m_light_params.tile_count.x, m_light_params.tile_count.y, 1};
+    p_light_cull_pipeline->Dispatch(command_buffer, workgroup_count);
+}
+
+void Renderer::WriteLightDescriptors(GraphicsPipeline &pipeline) const
+{
+    // Bindings of the quad fragment shader, pipelines built from other shaders are left as they are
+    pipeline.UpdateBufferDescriptors(m_frames_in_flight, 4, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, m_light_uniform_buffers,
+                                     sizeof(LightParams));
+    pipeline.UpdateBufferDescriptors(m_frames_in_flight, 5, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, m_light_buffers,
+                                     sizeof(PointLight) * MAX_LIGHTS);
+    pipeline.UpdateBufferDescriptors(m_frames_in_flight, 6, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, m_light_tile_buffers,
+                                     sizeof(u32) * LIGHT_TILE_STRIDE * MAX_LIGHT_TILES);
+}
+
+void Renderer::UploadAnimationTables(const u32 frame_index)
+{
+    const AnimationHeader header{m_animation_time, static_cast<u32>(m_animation_clips.size())};
+    m_animation_clip_buffers[frame_index].Update(&header, sizeof(AnimationHeader));
+    if (m_animation_frame_versions[frame_index] == m_animation_version) {
+        return;
+    }
+    if (!m_animation_clips.empty()) {
+        m_animation_clip_buffers[frame_index].Update(m_animation_clips.data(),
+                                                     sizeof(AnimationClipData) * m_animation_clips.size(),
+                                                     sizeof(AnimationHeader));
+        m_animation_frame_buffers[frame_index].Update(m_animation_frames.data(),
+                                                      sizeof(AnimationFrameData) * m_animation_frames.size());
+    }
+    m_animation_frame_versions[frame_index] = m_animation_version;
+}
+
+void Renderer::WriteAnimationDescriptors(GraphicsPipeline &pipeline) const
+{
+    // Bindings of the quad vertex shader
+    pipeline.UpdateBufferDescriptors(m_frames_in_flight, 7, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, m_animation_clip_buffers,
+                                     sizeof(AnimationHeader) + sizeof(AnimationClipData) * MAX_ANIMATION_CLIPS);
+    pipeline.UpdateBufferDescriptors(m_frames_in_flight, 8, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                                     m_animation_frame_buffers, sizeof(AnimationFrameData) * MAX_ANIMATION_FRAMES);
+}
+
+void Renderer::WriteTextureArrayDescriptors(GraphicsPipeline &pipeline, const u32 first_array) const
+{
+    const Vector<std::unique_ptr<Texture>> &texture_arrays{p_texture_manager->GetTextureArrays()};
+    if (first_array >= texture_arrays.size()) {
+        return;
+    }
+
+    Vector<u32> array_ids(texture_arrays.size() - first_array);
+    std::iota(array_ids.begin(), array_ids.end(), first_array);
+    pipeline.UpdateTextureArrayDescriptors(m_frames_in_flight, texture_arrays, array_ids);
+}
+
+void Renderer::WriteQuadDrawCommands(const u32 frame_index)
+{
+    // Grouped by pipeline rather than in band order. Opaque and alpha tested quads write depth and alpha quads test
+    // against it, so drawing every depth writing batch first leaves the same image, and the alpha batches keep their
+    // back to front order.
+    const std::span<const DrawBatch> batches{m_quad_queue.GetBatches()};
+    ASSERT(batches.size() <= RenderQueue::MAX_BATCH_COUNT, "Quad batch count exceeds the indirect buffer size.");
+
+    auto *commands{static_cast<VkDrawIndirectCommand *>(m_quad_indirect_buffers[frame_index].GetMapped())};
+    u32 command_count{0};
+    for (u32 i = 0; i < RenderQueue::PIPELINE_COUNT; ++i) {
+        const u32 first_command{command_count};
+        const BlendMode blend_mode{static_cast<BlendMode>(i)};
+        for (const DrawBatch &batch : batches) {
+            if (batch.blend_mode == blend_mode) {
+                commands[command_count++] = {.vertexCount = QUAD_VERTEX_COUNT,
+                                             .instanceCount = batch.instance_count,
+                                             .firstVertex = 0,
+                                             .firstInstance = batch.first_instance};
+            }
+        }
+        m_quad_draw_counts[i] = command_count - first_command;
+    }
+
+    m_quad_indirect_buffers[frame_index].Flush(0, sizeof(VkDrawIndirectCommand) * command_count);
+}
+
+void Renderer::RecordQuadDraws(VkCommandBuffer command_buffer, const u32 frame_index, const BlendMode blend_mode,
+                               const u32 first_command, const u32 command_count) const
+{
+    if (p_device->GetCapabilities().multi_draw_indirect) {
+        vkCmdDrawIndirect(command_buffer, m_quad_indirect_buffers[frame_index].p_buffer,
+                          sizeof(VkDrawIndirectCommand) * first_command, command_count,
+                          sizeof(VkDrawIndirectCommand));
+        return;
+    }
+
+    // Without multiDrawIndirect and drawIndirectFirstInstance every batch is its own draw
+    for (const DrawBatch &batch : m_quad_queue.GetBatches()) {
+        if (batch.blend_mode == blend_mode) {
+            vkCmdDraw(command_buffer, QUAD_VERTEX_COUNT, batch.instance_count, 0, batch.first_instance);
+        }
+    }
+}
+
+u32 Renderer::UploadStaticQuadUpdates(const u32 frame_index)
+{
+    // The previous copies of this slot were recorded into a frame that has completed
+    m_static_quad_copies.clear();
+    if (m_dirty_static_quad_ranges.empty()) {
+        return 0;
+    }
+
+    auto *staging{static_cast<QuadInstance *>(m_mapped_static_quad_staging_data[frame_index])};
+    u32 staged_count{0};
+    size_t range_index{0};
+    for (; range_index < m_dirty_static_quad_ranges.size(); ++range_index) {
+        InstanceRange &range{m_dirty_static_quad_ranges[range_index]};
+        const u32 count{math::min(range.end - range.begin, MAX_STATIC_QUAD_UPDATES_PER_FRAME - staged_count)};
+        if (count == 0) {
+            break;
+        }
+
+        // Staged from the mirror, so a range that carried over still uploads the latest data
+        std::ranges::transform(std::span{m_static_quad_instances}.subspan(range.begin, count), staging + staged_count,
+                               [](const InstanceData &instance) { return QuadInstance{instance}; });
+        m_static_quad_copies.push_back({.srcOffset = sizeof(QuadInstance) * staged_count,
+                                        .dstOffset = sizeof(QuadInstance) * range.begin,
+                                        .size = sizeof(QuadInstance) * count});
+        staged_count += count;
+
+        // Ranges are uploaded in order and growth is always marked dirty, so everything below is resident now
+        m_cull_params.instance_count = math::max(m_cull_params.instance_count, range.begin + count);
+
+        if (range.begin + count < range.end) {
+            range.begin += count; // Out of staging space, the rest carries over to the next frame
+            break;
+        }
+    }
+
+    m_dirty_static_quad_ranges.erase(m_dirty_static_quad_ranges.begin(),
+                                     m_dirty_static_quad_ranges.begin() + static_cast<std::ptrdiff_t>(range_index));
+    return staged_count;
+}
+
+void Renderer::RecordStaticQuadUpdates(VkCommandBuffer command_buffer, const u32 frame_index) const
+{
+    // Earlier frames on this queue may still read the ranges being overwritten, as instances or in the cull pass. The
+    // render graph only orders the passes of this frame, and makes the copies visible to them.
+    const VkMemoryBarrier read_barrier{
+        .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        .srcAccessMask = 0,
+        .dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+    };
+    vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &read_barrier, 0, nullptr, 0, nullptr);
+
+    vkCmdCopyBuffer(command_buffer, m_static_quad_staging_buffers[frame_index].p_buffer, m_static_quad_buffer.p_buffer,
+                    static_cast<u32>(m_static_quad_copies.size()), m_static_quad_copies.data());
+}
+
+void Renderer::SetStaticQuadInstances(const std::span<const InstanceData> instances)
+{
+    const u32 instance_count{
+        static_cast<u32>(math::min(instances.size(), static_cast<size_t>(m_max_static_quad_instances)))};
+    if (instance_count < instances.size()) {
+        ENGINE_LOG_WARNING("Static quad set of {} instances exceeds the capacity of {}, the rest are dropped.",
+                           instances.size(), m_max_static_quad_instances);
+    }
+
+    m_static_quad_instances.assign(instances.begin(), instances.begin() + static_cast<std::ptrdiff_t>(instance_count));
+    m_dirty_static_quad_ranges.clear();
+    m_static_quad_textures_dirty = true;
+
+    // Frames in flight may still be reading the set, so it is only overwritten once they are done
+    m_queue.WaitForValue(m_queue.GetLastSubmittedValue());
+    if (instance_count > 0) {
+        std::vector<QuadInstance> packed_instances(m_static_quad_instances.begin(), m_static_quad_instances.end());
+        p_buffer_manager->UploadBufferData(m_static_quad_buffer.p_buffer, packed_instances.data(),
+                                           sizeof(QuadInstance) * instance_count);
+    }
+
+    m_cull_params.instance_count = instance_count;
+}
+
+void Renderer::UpdateStaticQuadInstances(const u32 first_instance, const std::span<const InstanceData> instances)
+{
+    const u32 old_count{static_cast<u32>(m_static_quad_instances.size())};
+    const size_t requested_end{static_cast<size_t>(first_instance) + instances.size()};
+    const u32 end{static_cast<u32>(math::min(requested_end, static_cast<size_t>(m_max_static_quad_instances)))};
+    if (end < requested_end) {
+        ENGINE_LOG_WARNING("Static quad update past the capacity of {}, the rest are dropped.",
+                           m_max_static_quad_instances);
+    }
+    if (first_instance >= end) {
+        return;
+    }
+
+    if (end > old_count) {
+        m_static_quad_instances.resize(end);
+    }
+    std::copy_n(instances.begin(), end - first_instance,
+                m_static_quad_instances.begin() + static_cast<std::ptrdiff_t>(first_instance));
+
+    // Growth is dirty from the old end on, so the resident instances stay a contiguous prefix
+    InstanceRange dirty{math::min(first_instance, old_count), end};
+
+    // Merge with every overlapping or adjacent range, keeping the list sorted
+    auto it{std::ranges::lower_bound(m_dirty_static_quad_ranges, dirty.begin, {}, &InstanceRange::end)};
+    while (it != m_dirty_static_quad_ranges.end() && it->begin <= dirty.end) {
+        dirty.begin = math::min(dirty.begin, it->begin);
+        dirty.end = math::max(dirty.end, it->end);
+        it = m_dirty_static_quad_ranges.erase(it);
+    }
+    m_dirty_static_quad_ranges.insert(it, dirty);
+    m_static_quad_textures_dirty = true;
+}
+
+void Renderer::SetCullFrustum(const OrthographicCamera::FrustumData &frustum)
+{
+    if (m_viewports.empty()) {
+        m_cull_params.views[0] = internal::get_cull_view(frustum);
+    }
+}
+
+void Renderer::SetViewports(const std::span<const RenderViewport> viewports)
+{
+    if (viewports.size() > MAX_VIEWPORTS) {
+        ENGINE_LOG_WARNING("{} viewports given, only the first {} are drawn.", viewports.size(), MAX_VIEWPORTS);
+    }
+    const size_t count{math::min(viewports.size(), static_cast<size_t>(MAX_VIEWPORTS))};
+    m_viewports.clear();
+    for (size_t i = 0; i < count; ++i) {
+        m_viewports.push_back(viewports[i]);
+        m_cull_params.views[i] = internal::get_cull_view(viewports[i].cull_frustum);
+    }
+    m_cull_params.viewport_count = static_cast<u32>(math::max(count, size_t{1}));
+}
+
+void Renderer::SetTilemap(const Tilemap &tilemap, const u32 chunk_size)
+{
+    std::vector<InstanceData> instances;
+    Vector<TilemapChunk> chunks;
+    tilemap.BuildChunks(chunk_size, instances, chunks);
+
+    // Frames in flight may still be drawing the old tiles
+    m_queue.WaitForValue(m_queue.GetLastSubmittedValue());
+    const u32 tile_count{static_cast<u32>(instances.size())};
+    if (tile_count > m_tile_buffer_capacity) {
+        m_tile_buffer.Destroy(p_device->GetDevice());
+        m_tile_buffer = p_buffer_manager->CreateBuffer(sizeof(QuadInstance) * static_cast<VkDeviceSize>(tile_count),
+                                                       VK_BUFFER_USAGE_VERTEX_BUFFER_BIT |
+                                                           VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                                       VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        m_tile_buffer_capacity = tile_count;
+    }
+    if (tile_count > 0) {
+        std::vector<QuadInstance> packed_instances(instances.begin(), instances.end());
+        p_buffer_manager->UploadBufferData(m_tile_buffer.p_buffer, packed_instances.data(),
+                                           sizeof(QuadInstance) * tile_count);
+    }
+
+    DiscardRecordedFrames();
+    m_tile_count = tile_count;
+    m_tile_texture_index = tilemap.GetTextureIndex();
+    m_tile_chunks = std::move(chunks);
+    m_visible_tile_ranges.clear();
+    m_static_quad_textures_dirty = true;
+    ENGINE_LOG_DEBUG("Tilemap of {} tiles built into {} chunks.", tile_count, m_tile_chunks.size());
+}
+
+void Renderer::ClearTilemap()
+{
+    m_queue.WaitForValue(m_queue.GetLastSubmittedValue());
+    m_tile_buffer.Destroy(p_device->GetDevice());
+    m_tile_buffer = Buffer{};
+    m_tile_buffer_capacity = 0;
+    DiscardRecordedFrames();
+    m_tile_count = 0;
+    m_tile_chunks.clear();
+    m_visible_tile_ranges.clear();
+    m_static_quad_textures_dirty = true;
+}
+
+void Renderer::CullTileChunks()
+{
+    // Chunks are in row major order, so the visible chunks of a row usually merge into a single draw. Every viewport
+    // gets its own runs, one after the other.
+    m_visible_tile_ranges.clear();
+    u32 visible_chunk_count{0};
+    for (u32 viewport = 0; viewport < m_cull_params.viewport_count; ++viewport) {
+        const Vec4 &bounds{m_cull_params.views[viewport]};
+        const math::AABB2D view{{bounds.x, bounds.y}, {bounds.z, bounds.w}};
+        const u32 first_range{static_cast<u32>(m_visible_tile_ranges.size())};
+        for (const TilemapChunk &chunk : m_tile_chunks) {
+            if (!chunk.bounds.Intersects(view)) {
+                continue;
+            }
+            ++visible_chunk_count;
+            const u32 end{chunk.first_instance + chunk.instance_count};
+            const bool adjacent{m_visible_tile_ranges.size() > first_range &&
+                                m_visible_tile_ranges.back().end == chunk.first_instance};
+            if (adjacent) {
+                m_visible_tile_ranges.back().end = end;
+            }
+            else {
+                m_visible_tile_ranges.push_back({chunk.first_instance, end});
+            }
+        }
+        m_viewport_tile_ranges[viewport] = {first_range, static_cast<u32>(m_visible_tile_ranges.size())};
+    }
+    m_render_statistics.visible_tile_chunk_count = visible_chunk_count;
+}
+
+void Renderer::SetLights(const std::span<const PointLight> lights)
+{
+    if (lights.size() > MAX_LIGHTS) {
+        ENGINE_LOG_WARNING("{} lights given, only the first {} are drawn.", lights.size(), MAX_LIGHTS);
+    }
+    m_lights.assign(lights.begin(), lights.end());
+}
+
+void Renderer::SetAmbientLight(const Colour<f32> &colour) { m_light_params.ambient = colour; }
+
+void Renderer::SetAnimationClips(const std::span<const AnimationClipData> clips,
+                                 const std::span<const AnimationFrameData> frames)
+{
+    // Clips index the frames, so a partial table would be wrong rather than short
+    if (clips.size() > MAX_ANIMATION_CLIPS || frames.size() > MAX_ANIMATION_FRAMES) {
+        ENGINE_LOG_WARNING("Animation tables of {} clips and {} frames exceed the capacity of {} and {}, dropped.",
+                           clips.size(), frames.size(), MAX_ANIMATION_CLIPS, MAX_ANIMATION_FRAMES);
+        m_animation_clips.clear();
+        m_animation_frames.clear();
+    }
+    else {
+        m_animation_clips.assign(clips.begin(), clips.end());
+        m_animation_frames.assign(frames.begin(), frames.end());
+    }
+    ++m_animation_version;
+}
+
+void Renderer::SetRenderScale(const f32 scale)
+{
+    m_render_scale = std::clamp(scale, MIN_RENDER_SCALE, 1.0f);
+    m_current_render_scale = m_render_scale;
+    m_render_scale_cooldown = 0;
+}
+
+void Renderer::SetUpscaleSharpness(const f32 sharpness) { m_upscale_sharpness = std::clamp(sharpness, 0.0f, 1.0f); }
+
+void Renderer::SetDynamicRenderScale(const f32 target_gpu_time)
+{
+    m_target_gpu_time = math::max(target_gpu_time, 0.0f);
+    m_current_render_scale = m_render_scale;
+    m_render_scale_cooldown = 0;
+}
+
+u32 Renderer::CreateRenderTarget(const u32 width, const u32 height)
+{
+    ASSERT(width > 0 && height > 0, "Render target size must be greater than 0!");
+
+    const ImageSize size{static_cast<int>(width), static_cast<int>(height)};
+    const u32 texture_id{
+        p_texture_manager->AddTexture(p_buffer_manager->CreateRenderTargetTexture(size, m_colour_attachment_format))};
+    if (texture_id == 0) {
+        return 0;
+    }
+
+    // Drawn with the quad pipelines, so the formats have to match the main pass
+    RenderTarget &target{m_render_targets.emplace_back()};
+    target.texture_id = texture_id;
+    target.extent = {width, height};
+    p_buffer_manager->CreateDepthImage(target.depth_image, size, m_depth_attachment_format);
+    target.depth_image.p_view =
+        p_buffer_manager->CreateImageView(target.depth_image.p_image, m_depth_attachment_format,
+                                          VK_IMAGE_ASPECT_DEPTH_BIT, VK_IMAGE_VIEW_TYPE_2D, 1, 1);
+    target.clear_colour = {{0.0f, 0.0f, 0.0f, 0.0f}};
+    target.update_pending = true; // Cleared before anything can sample it
+
+    ENGINE_LOG_DEBUG("Render target {} created: {}x{}", texture_id, width, height);
+    return texture_id;
+}
+
+void Renderer::UpdateRenderTarget(const u32 texture_id, const Mat4 &view_projection,
+                                  std::span<const InstanceData> quads, const Colour<f32> &clear_colour)
+{
+    const auto target{std::ranges::find(m_render_targets, texture_id, &RenderTarget::texture_id)};
+    if (target == m_render_targets.end()) {
+        ENGINE_LOG_ERROR("Texture {} is not a render target.", texture_id);
+        return;
+    }
+
+    if (quads.size() > MAX_RENDER_TARGET_QUADS_PER_FRAME) {
+        ENGINE_LOG_WARNING("Render target {} update of {} quads exceeds the maximum of {}, the rest are dropped.",
+                           texture_id, quads.size(), MAX_RENDER_TARGET_QUADS_PER_FRAME);
+        quads = quads.first(MAX_RENDER_TARGET_QUADS_PER_FRAME);
+    }
+
+    // Lighting follows the screen's tiles, which mean nothing inside a target
+    target->camera.wvp = view_projection;
+    target->camera.wvp_static = view_projection;
+    target->clear_colour = {{clear_colour.r, clear_colour.g, clear_colour.b, clear_colour.a}};
+    target->quads.assign(quads.begin(), quads.end());
+    for (InstanceData &quad : target->quads) {
+        quad.apply_camera_effects = 0;
+    }
+    target->update_pending = true;
+}
+
+u32 Renderer::UploadRenderTargetUpdates(const u32 frame_index)
+{
+    m_render_target_draws.clear();
+    m_render_target_batches.clear();
+
+    // Each target's quads are sorted on their own and written behind the previous target's
+    auto *instances{static_cast<QuadInstance *>(m_render_target_instance_buffers[frame_index].GetMapped())};
+    u32 instance_count{0};
+    for (u32 i = 0; i < m_render_targets.size(); ++i) {
+        RenderTarget &target{m_render_targets[i]};
+        const u32 quad_count{static_cast<u32>(target.quads.size())};
+        if (!target.update_pending || instance_count + quad_count > MAX_RENDER_TARGET_QUADS_PER_FRAME) {
+            continue;
+        }
+
+        m_render_target_queue.Build(target.quads);
+        m_render_target_queue.WriteInstances(target.quads, instances + instance_count);
+
+        const u32 first_batch{static_cast<u32>(m_render_target_batches.size())};
+        for (const DrawBatch &batch : m_render_target_queue.GetBatches()) {
+            m_render_target_batches.push_back(
+                DrawBatch{batch.blend_mode, instance_count + batch.first_instance, batch.instance_count});
+        }
+        m_render_target_draws.push_back(
+            RenderTargetDraw{i, first_batch, static_cast<u32>(m_render_target_batches.size()) - first_batch});
+
+        instance_count += quad_count;
+        target.quads.clear();
+        target.update_pending = false;
+    }
+
+    if (instance_count > 0) {
+        m_render_target_instance_buffers[frame_index].Flush(0, sizeof(QuadInstance) * instance_count);
+    }
+
+    return static_cast<u32>(m_render_target_draws.size());
+}
+
+void Renderer::RecordRenderTargetDraws(VkCommandBuffer command_buffer, const u32 frame_index,
+                                       const u32 draw_index) const
+{
+    const RenderTargetDraw &draw{m_render_target_draws[draw_index]};
+    const RenderTarget &target{m_render_targets[draw.target_index]};
+
+    const VkViewport viewport{.x = 0.0f,
+                              .y = 0.0f,
+                              .width = static_cast<f32>(target.extent.width),
+                              .height = static_cast<f32>(target.extent.height),
+                              .minDepth = 0.0f,
+                              .maxDepth = 1.0f};
+    const VkRect2D scissor{{0, 0}, target.extent};
     vkCmdSetViewport(command_buffer, 0, 1, &viewport);
     vkCmdSetScissor(command_buffer, 0, 1, &scissor);
 
-    // Quad/Sprite rendering
-    if (quad_instance_count > 0) {
-        p_quad_pipeline->Bind(command_buffer, image_index);
-        const VkBuffer buffers[]{p_quad_vertex_buffer->p_buffer, m_quad_instance_buffers[image_index].p_buffer};
-        constexpr VkDeviceSize offsets[]{0, 0};
-        vkCmdBindVertexBuffers(command_buffer, 0, 2, buffers, offsets);
-        vkCmdBindIndexBuffer(command_buffer, p_quad_index_buffer->p_buffer, 0, VK_INDEX_TYPE_UINT32);
-        vkCmdDrawIndexed(command_buffer, m_index_count, quad_instance_count, 0, 0, 0);
+    constexpr VkDeviceSize offset{0};
+    vkCmdBindVertexBuffers(command_buffer, 1, 1, &m_render_target_instance_buffers[frame_index].p_buffer, &offset);
+
+    // Batches are drawn in band order, few enough that every one is its own draw
+    const std::array<GraphicsPipeline *, RenderQueue::PIPELINE_COUNT> quad_pipelines{
+        p_quad_pipeline.get(), p_quad_alpha_test_pipeline.get(), p_quad_transparent_pipeline.get()};
+    const GraphicsPipeline *bound_pipeline{nullptr};
+    BoundDescriptorSets bound_sets{};
+    const std::span batches{m_render_target_batches.data() + draw.first_batch, draw.batch_count};
+    for (const DrawBatch &batch : batches) {
+        GraphicsPipeline *pipeline{quad_pipelines[static_cast<u32>(batch.blend_mode)]};
+        if (pipeline != bound_pipeline) {
+            pipeline->Bind(command_buffer, frame_index, &bound_sets);
+            pipeline->PushConstants(command_buffer, &target.camera, sizeof(UniformData));
+            bound_pipeline = pipeline;
+        }
+        vkCmdDraw(command_buffer, QUAD_VERTEX_COUNT, batch.instance_count, 0, batch.first_instance);
+    }
+}
+
+void Renderer::ToggleGpuCulling()
+{
+    m_use_gpu_culling = !m_use_gpu_culling;
+    ENGINE_LOG_DEBUG("GPU quad culling {}.", m_use_gpu_culling ? "enabled" : "disabled");
+}
+
+void Renderer::SetParticleDepthSort(const bool enabled)
+{
+    m_sort_particles = enabled;
+    ENGINE_LOG_DEBUG("Particle depth sort {}.", enabled ? "enabled" : "disabled");
+}
+
+void Renderer::ToggleComputeParticles()
+{
+    m_use_compute_particles = !m_use_compute_particles;
+    ENGINE_LOG_DEBUG("Compute particles {}.", m_use_compute_particles ? "enabled" : "disabled");
+
+    // Start the GPU pool over from the particles the CPU path was simulating
+    if (m_use_compute_particles) {
+        m_reset_particle_pool = true;
+        m_particle_pool_active = false;
+        m_pending_particle_spawns.clear();
+        EmitParticles(m_particles_instances);
     }
+}
 
-    // Text rendering
-    if (text_instance_count > 0 && p_text_pipeline) {
-        p_text_pipeline->Bind(command_buffer, image_index);
-        const VkBuffer buffers[]{p_quad_vertex_buffer->p_buffer, m_text_instance_buffers[image_index].p_buffer};
-        constexpr VkDeviceSize offsets[]{0, 0};
-        vkCmdBindVertexBuffers(command_buffer, 0, 2, buffers, offsets);
-        vkCmdBindIndexBuffer(command_buffer, p_quad_index_buffer->p_buffer, 0, VK_INDEX_TYPE_UINT32);
-        vkCmdDrawIndexed(command_buffer, m_index_count, text_instance_count, 0, 0, 0);
+void Renderer::DrawText(StringView text, const Vec3 &position, const Colour<f32> &colour, const f32 scale,
+                        const u32 font_id, std::vector<InstanceData> &quad_instances, const TextAlign alignment,
+                        bool apply_camera_effects)
+{
+    if (font_id >= m_fonts.size() || m_fonts[font_id].IsEmpty()) {
+        ENGINE_LOG_ERROR("Font ID {} not found when trying to render: {}.", font_id, text);
+        return;
     }
 
-    // Particle rendering
-    if (p_particle_pipeline && particle_instance_count > 0) {
-        // ENGINE_LOG_DEBUG("Particle draw: quad_count = {}", particle_instance_count);
-        p_particle_pipeline->Bind(command_buffer, image_index);
-        const VkBuffer buffers[]{p_quad_vertex_buffer->p_buffer, m_particle_storage_buffers[image_index].p_buffer};
-        constexpr VkDeviceSize offsets[]{0, 0};
-        vkCmdBindVertexBuffers(command_buffer, 0, 2, buffers, offsets);
-        vkCmdBindIndexBuffer(command_buffer, p_quad_index_buffer->p_buffer, 0, VK_INDEX_TYPE_UINT32);
-        vkCmdDrawIndexed(command_buffer, m_index_count, particle_instance_count, 0, 0, 0);
+    const TextLayout &layout{GetTextLayout(text, scale, font_id, alignment)};
+    if (!layout.glyph_cells.empty()) {
+        p_glyph_cache->Touch(layout.glyph_cells);
+    }
+    for (const InstanceData &glyph : layout.glyphs) {
+        InstanceData &instance{quad_instances.emplace_back(glyph)};
+        instance.position = {position.x + glyph.position.x, position.y + glyph.position.y, position.z};
+        instance.colour = colour;
+        instance.apply_camera_effects = apply_camera_effects ? 1 : 0;
+    }
+}
+
+const Renderer::TextLayout &Renderer::GetTextLayout(StringView text, const f32 scale, const u32 font_id,
+                                                    const TextAlign alignment)
+{
+    const u32 scale_bits{std::bit_cast<u32>(scale)};
+    u64 key{utils::fnv1a(text)};
+    key = utils::fnv1a(std::as_bytes(std::span{&font_id, 1}), key);
+    key = utils::fnv1a(std::as_bytes(std::span{&scale_bits, 1}), key);
+    key = utils::fnv1a(std::as_bytes(std::span{&alignment, 1}), key);
+
+    auto it{m_text_layouts.find(key)};
+    if (it != m_text_layouts.end()) {
+        const TextLayout &cached{it->second};
+        if (cached.font_id == font_id && std::bit_cast<u32>(cached.scale) == scale_bits &&
+            cached.alignment == alignment && cached.text == text) {
+            return cached;
+        }
+    }
+    else {
+        // Strings that change every frame (counters, timers) would grow the cache without bound
+        if (m_text_layouts.size() >= MAX_CACHED_TEXT_LAYOUTS) {
+            m_text_layouts.clear();
+        }
+        it = m_text_layouts.try_emplace(key).first;
+    }
+
+    TextLayout &layout{it->second};
+    layout.text = text;
+    layout.font_id = font_id;
+    layout.scale = scale;
+    layout.alignment = alignment;
+    layout.glyphs.clear();
+    layout.glyph_cells.clear();
+    layout.has_queued_glyphs = false;
+
+    const MSDFGlyphTable &glyphs{m_fonts[font_id]};
+    const MSDFAtlasParams &atlas_params{m_font_atlas_params[font_id]};
+    const MSDFGlyph *space_glyph{glyphs.Find(' ')};
+    const Vec2 atlas_size{atlas_params.atlas_size};
+
+    // Single pass from a pen at the origin, the alignment offset is applied once the full width is known
+    f32 pen_x{0.0f};
+    u32 previous_codepoint{0};
+    for (size_t offset = 0; offset < text.size();) {
+        const u32 codepoint{utils::decode_utf8(text, offset)};
+        if (previous_codepoint != 0) {
+            pen_x += glyphs.GetKerning(previous_codepoint, codepoint) * scale;
+        }
+        previous_codepoint = codepoint;
+
+        const MSDFGlyph *glyph{glyphs.Find(codepoint)};
+        u32 texture_id{m_font_texture_ids[font_id]};
+        Vec2 glyph_atlas_size{atlas_size};
+        const bool has_glyph_source{glyph == nullptr && p_glyph_cache->HasFont(font_id)};
+        if (has_glyph_source) {
+            // Glyphs the atlas lacks come from the glyph cache's pages, the layout is redone once they are placed
+            if (const GlyphCache::Glyph *cached{p_glyph_cache->Find(font_id, codepoint)}) {
+                glyph = &cached->metrics;
+                texture_id = cached->texture_id;
+                glyph_atlas_size = Vec2{static_cast<f32>(GlyphCache::PAGE_SIZE)};
+                if (cached->cell != GlyphCache::NO_CELL) {
+                    layout.glyph_cells.push_back(cached->cell);
+                }
+            }
+            else {
+                layout.has_queued_glyphs = true;
+            }
+        }
+        if (glyph == nullptr) {
+            // Missing glyphs advance like a space. Only logged when a string is laid out, not on every draw.
+            if (!has_glyph_source) {
+                ENGINE_LOG_WARNING("MSDFGlyph U+{:04X} not found in font {}.", codepoint, font_id);
+            }
+            if (space_glyph != nullptr) {
+                pen_x += space_glyph->advance * scale;
+            }
+            continue;
+        }
+
+        // Glyphs with empty plane bounds and spaces only advance the pen
+        if (!glyph->plane_bounds.IsZero() && codepoint != ' ') {
+            const Rect plane_bounds{glyph->plane_bounds};
+            const Rect atlas_bounds{glyph->atlas_bounds};
+
+            // Atlas bounds are in pixels from the bottom left, like the quad's texture coordinates
+            const Vec3 position{pen_x + plane_bounds.left * scale, plane_bounds.bottom * scale, 0.0f};
+            const Vec2 size{(plane_bounds.right - plane_bounds.left) * scale,
+                            (plane_bounds.top - plane_bounds.bottom) * scale};
+            const UVRect sprite_rect{atlas_bounds.left / glyph_atlas_size.x, atlas_bounds.bottom / glyph_atlas_size.y,
+                                     atlas_bounds.right / glyph_atlas_size.x, atlas_bounds.top / glyph_atlas_size.y};
+            InstanceData &instance{layout.glyphs.emplace_back(position, size, 0.0f, texture_id, Colour(1.0f),
+                                                              sprite_rect, 1, 1, BlendMode::Alpha)};
+            instance.distance_range = atlas_params.distance_range;
+        }
+        pen_x += glyph->advance * scale;
+    }
+
+    f32 alignment_offset{0.0f};
+    if (alignment == TextAlign::Center) {
+        alignment_offset = -pen_x * 0.5f;
+    }
+    else if (alignment == TextAlign::Right) {
+        alignment_offset = -pen_x;
+    }
+    // Left alignment: no adjustment needed
+    if (alignment_offset != 0.0f) {
+        for (InstanceData &instance : layout.glyphs) {
+            instance.position.x += alignment_offset;
+        }
+    }
+
+    return layout;
+}
+
+Renderer::TextHandle Renderer::CreateText(StringView text, const Vec3 &position, const Colour<f32> &colour,
+                                          const f32 scale, const u32 font_id, const TextAlign alignment,
+                                          const bool apply_camera_effects)
+{
+    const TextHandle handle{m_retained_texts.Emplace()};
+    RetainedText &retained{m_retained_texts[handle]};
+    retained.text = text;
+    retained.position = position;
+    retained.colour = colour;
+    retained.scale = scale;
+    retained.font_id = font_id;
+    retained.alignment = alignment;
+    retained.apply_camera_effects = apply_camera_effects;
+    retained.visible = true;
+    LayoutRetainedText(retained);
+
+    return handle;
+}
+
+void Renderer::UpdateText(const TextHandle handle, StringView text, const Vec3 &position, const Colour<f32> &colour,
+                          const f32 scale, const u32 font_id, const TextAlign alignment,
+                          const bool apply_camera_effects)
+{
+    if (!IsValidTextHandle(handle)) {
+        ENGINE_LOG_ERROR("Invalid text handle for update: {}:{}", handle.index, handle.generation);
+        return;
+    }
+
+    RetainedText &retained{m_retained_texts[handle]};
+    if (retained.text == text && retained.position == position && retained.colour == colour &&
+        retained.scale == scale && retained.font_id == font_id && retained.alignment == alignment &&
+        retained.apply_camera_effects == apply_camera_effects) {
+        return;
+    }
+
+    retained.text = text;
+    retained.position = position;
+    retained.colour = colour;
+    retained.scale = scale;
+    retained.font_id = font_id;
+    retained.alignment = alignment;
+    retained.apply_camera_effects = apply_camera_effects;
+    LayoutRetainedText(retained);
+}
+
+void Renderer::SetTextVisible(const TextHandle handle, const bool visible)
+{
+    if (!IsValidTextHandle(handle)) {
+        ENGINE_LOG_ERROR("Invalid text handle for visibility change: {}:{}", handle.index, handle.generation);
+        return;
+    }
+
+    RetainedText &retained{m_retained_texts[handle]};
+    if (retained.visible != visible) {
+        retained.visible = visible;
+        m_retained_text_dirty = true;
+    }
+}
+
+void Renderer::DestroyText(const TextHandle handle)
+{
+    if (!IsValidTextHandle(handle)) {
+        ENGINE_LOG_ERROR("Invalid text handle for destruction: {}:{}", handle.index, handle.generation);
+        return;
+    }
+
+    m_retained_texts.Erase(handle);
+    m_retained_text_dirty = true;
+}
+
+bool Renderer::IsValidTextHandle(const TextHandle handle) const
+{
+    return m_retained_texts.Contains(handle);
+}
+
+void Renderer::LayoutRetainedText(RetainedText &retained)
+{
+    retained.glyphs.clear();
+    DrawText(retained.text, retained.position, retained.colour, retained.scale, retained.font_id, retained.glyphs,
+             retained.alignment, retained.apply_camera_effects);
+    m_retained_text_dirty = true;
+
+    // Retained texts are not laid out again each frame, their cached glyphs are touched from here on
+    if (p_glyph_cache->HasFont(retained.font_id)) {
+        retained.glyph_cells =
+            GetTextLayout(retained.text, retained.scale, retained.font_id, retained.alignment).glyph_cells;
     }
-
-    // Render ImGui
-    if (draw_data) {
-        ImGui_ImplVulkan_RenderDrawData(draw_data, command_buffer);
+    else {
+        retained.glyph_cells.clear();
     }
-
-    vkCmdEndRenderPass(command_buffer);
-    EndCommandBuffer(command_buffer);
 }
 
-void Renderer::Render(const f32 delta_time, const UniformData &uniform_data,
-                      const std::vector<InstanceData> &quad_instances, const std::vector<TextData> &text_instances,
-                      const std::vector<ParticleData> &particle_instances)
+void Renderer::UpdateGlyphCache()
 {
-    while (!p_swapchain->IsValid()) {
-        std::this_thread::yield();
-        ENGINE_LOG_INFO("Rendering paused, waiting for valid swapchain");
+    for (const RetainedText &retained : m_retained_texts) {
+        if (retained.visible && !retained.glyph_cells.empty()) {
+            p_glyph_cache->Touch(retained.glyph_cells);
+        }
     }
 
-    UpdateTextureDescriptors();
-
-    m_frame_fences[m_current_frame].WaitFor(constants::u64_max);
-    m_frame_fences[m_current_frame].Reset();
-
-    const u32 image_index{m_queue.AcquireNextImage(m_current_frame)};
-    if (image_index == constants::u32_max) {
+    Vector<u32> changed_font_ids;
+    p_glyph_cache->Update(changed_font_ids);
+    if (changed_font_ids.empty()) {
         return;
     }
 
-    // Update compute uniform buffer
-    UpdateComputeUniformBuffer(image_index, delta_time);
-    UpdateParticleStorageBuffer(image_index, particle_instances);
-
-    // Update particle instances
-    if (m_use_compute_particles && !particle_instances.empty()) {
-        // ENGINE_LOG_DEBUG("Compute particles enabled");
-        const ParticleData *storage_particles =
-            static_cast<ParticleData *>(m_mapped_particle_storage_data[image_index]);
-        m_particles_instances.clear();
-        m_particles_instances.reserve(particle_instances.size());
-        for (size_t i = 0; i < particle_instances.size(); ++i) {
-            if (storage_particles[i].lifetime > 0.0f && storage_particles[i].size.x > 0.0f &&
-                storage_particles[i].size.y > 0.0f) {
-                m_particles_instances.push_back(storage_particles[i]);
-            }
+    // Layouts waiting for a glyph or drawing one that may have been evicted are rebuilt the next time they are drawn
+    const auto is_changed{[&changed_font_ids](const u32 font_id) {
+        return std::ranges::find(changed_font_ids, font_id) != changed_font_ids.end();
+    }};
+    for (auto it = m_text_layouts.begin(); it != m_text_layouts.end();) {
+        const TextLayout &layout{it->second};
+        if ((layout.has_queued_glyphs || !layout.glyph_cells.empty()) && is_changed(layout.font_id)) {
+            it = m_text_layouts.erase(it);
+        }
+        else {
+            ++it;
         }
     }
-    else {
-        // CPU path: Use m_particles_instances directly
-        m_particles_instances = particle_instances; // Already updated in Scene::UpdateParticles
+    for (RetainedText &retained : m_retained_texts) {
+        if (is_changed(retained.font_id)) {
+            LayoutRetainedText(retained);
+        }
     }
+}
 
-    // Update uniform buffer
-    m_uniform_buffers[image_index].Update(p_device->GetDevice(), &uniform_data, sizeof(uniform_data));
+std::span<const InstanceData> Renderer::GatherQuadInstances(const std::vector<InstanceData> &quad_instances)
+{
+    if (m_retained_text_dirty) {
+        m_retained_text_instances.clear();
+        for (const RetainedText &retained : m_retained_texts) {
+            if (retained.visible) {
+                m_retained_text_instances.insert(m_retained_text_instances.end(), retained.glyphs.begin(),
+                                                 retained.glyphs.end());
+            }
+        }
+        m_retained_text_dirty = false;
+    }
 
-    // Update quad instance data
-    const VkDeviceSize quad_instance_size{sizeof(InstanceData) * quad_instances.size()};
-    ASSERT(quad_instance_size <= sizeof(InstanceData) * m_max_quad_instances,
-           "Quad instance count exceeds maximum buffer size.");
-    if (quad_instance_size > 0) {
-        memcpy(m_mapped_quad_instance_data[image_index], quad_instances.data(), quad_instance_size);
+    m_debug_draw_instances.clear();
+#ifdef ENGINE_DEBUG_DRAW
+    m_debug_texts.clear();
+    DebugDraw &debug_draw{DebugDraw::Get()};
+    debug_draw.Flush(m_debug_draw_instances, m_debug_texts);
+    for (const DebugText &text : m_debug_texts) {
+        DrawText(text.text, {text.position.x, text.position.y, DebugDraw::DEPTH}, text.colour, text.scale,
+                 debug_draw.GetTextFont(), m_debug_draw_instances, TextAlign::Left, !text.screen_space);
     }
+#endif
+    m_render_statistics.debug_draw_count = static_cast<u32>(m_debug_draw_instances.size());
 
-    // Update text instance data
-    const VkDeviceSize text_instance_size{sizeof(TextData) * text_instances.size()};
-    ASSERT(text_instance_size <= sizeof(TextData) * m_max_text_instances,
-           "Text instance count exceeds maximum buffer size.");
-    if (text_instance_size > 0) {
-        memcpy(m_mapped_text_instance_data[image_index], text_instances.data(), text_instance_size);
+    if (m_retained_text_instances.empty() && m_debug_draw_instances.empty()) {
+        return quad_instances;
     }
 
-    // TODO: Only update this in debug mode
-    m_render_statistics.delta_time = delta_time;
-    m_render_statistics.quad_count = static_cast<u32>(quad_instances.size());
-    m_render_statistics.vertex_count = m_vertex_count;
-    m_render_statistics.index_count = m_index_count;
-    m_render_statistics.particle_count = static_cast<u32>(m_particles_instances.size());
-    m_render_statistics.glyph_count = static_cast<u32>(text_instances.size());
-    m_render_statistics.texture_count = p_texture_manager->GetTextureCount();
-    m_render_statistics.font_count = static_cast<u32>(m_fonts.size());
-    m_render_statistics.total_instances = m_render_statistics.quad_count + m_render_statistics.particle_count + m_render_statistics.glyph_count;
+    // Retained glyphs go behind the frame's quads and are sorted in with them. The debug overlay is dropped first when
+    // the instance buffer is full.
+    m_frame_quad_instances.assign(quad_instances.begin(), quad_instances.end());
+    m_frame_quad_instances.insert(m_frame_quad_instances.end(), m_retained_text_instances.begin(),
+                                  m_retained_text_instances.end());
+    const size_t debug_draw_count{
+        math::min(m_debug_draw_instances.size(),
+                  m_max_quad_instances - math::min(m_max_quad_instances, m_frame_quad_instances.size()))};
+    m_frame_quad_instances.insert(m_frame_quad_instances.end(), m_debug_draw_instances.begin(),
+                                  m_debug_draw_instances.begin() + static_cast<std::ptrdiff_t>(debug_draw_count));
+    return m_frame_quad_instances;
+}
 
-    // Render ImGui
-    ImDrawData *imgui_draw_data{nullptr};
-#ifdef USE_IMGUI
-    imgui_draw_data = RenderImGUI();
-#endif
+void Renderer::SetupPipelines(StringView quad_vertex_shader_path, StringView quad_fragment_shader_path,
+                              StringView particle_vertex_shader_path, StringView particle_fragment_shader_path,
+                              StringView particle_compute_shader_path, StringView particle_emit_shader_path,
+                              StringView quad_cull_shader_path, StringView light_cull_shader_path,
+                              StringView upscale_vertex_shader_path, StringView upscale_fragment_shader_path,
+                              StringView radix_histogram_shader_path, StringView radix_scan_shader_path,
+                              StringView radix_scatter_shader_path, StringView particle_gather_shader_path)
+{
+    // Shaders compile and reflect independently, glslang reference counts its process initialization
+    struct ShaderJob {
+        std::unique_ptr<Shader> *shader;
+        StringView filepath;
+    };
+    const std::array<ShaderJob, 14> shader_jobs{{
+        {&p_quad_vertex_shader, quad_vertex_shader_path},
+        {&p_quad_fragment_shader, quad_fragment_shader_path},
+        {&p_particle_vertex_shader, particle_vertex_shader_path},
+        {&p_particle_fragment_shader, particle_fragment_shader_path},
+        {&p_particle_compute_shader, particle_compute_shader_path},
+        {&p_particle_emit_shader, particle_emit_shader_path},
+        {&p_quad_cull_shader, quad_cull_shader_path},
+        {&p_light_cull_shader, light_cull_shader_path},
+        {&p_upscale_vertex_shader, upscale_vertex_shader_path},
+        {&p_upscale_fragment_shader, upscale_fragment_shader_path},
+        {&p_radix_histogram_shader, radix_histogram_shader_path},
+        {&p_radix_scan_shader, radix_scan_shader_path},
+        {&p_radix_scatter_shader, radix_scatter_shader_path},
+        {&p_particle_gather_shader, particle_gather_shader_path},
+    }};
+    p_worker_pool->Run(static_cast<u32>(shader_jobs.size()), [&](const u32 index) {
+        *shader_jobs[index].shader = std::make_unique<Shader>(*p_device, shader_jobs[index].filepath);
+    });
+
+    const VkPipelineRenderingCreateInfo rendering_info{GetPipelineRenderingInfo()};
+    const int frames_in_flight{static_cast<int>(m_frames_in_flight)};
 
-    vkResetCommandBuffer(m_command_buffers[image_index], 0);
-    RecordCommandBuffer(m_command_buffers[image_index], image_index, static_cast<u32>(quad_instances.size()),
-                        static_cast<u32>(text_instances.size()), static_cast<u32>(m_particles_instances.size()),
-                        imgui_draw_data);
+    const VkDeviceSize max_particle_instance_size{sizeof(ParticleData) * m_max_particle_instances};
+    const VkDeviceSize pool_state_size{sizeof(u32) * (2 + static_cast<VkDeviceSize>(m_max_particle_instances))};
 
-    m_queue.Submit(m_command_buffers[image_index], m_current_frame, &m_frame_fences[m_current_frame]);
-    m_queue.Present(image_index, m_current_frame);
+    // The live count is the instance count the simulation appends to, the sort buffers are shared with both queues
+    SmallVector<u32, 2> particle_queue_families{p_device->GetQueueFamily()};
+    if (p_device->HasAsyncComputeQueue()) {
+        particle_queue_families.push_back(p_device->GetComputeQueueFamily());
+    }
+    p_particle_sort = std::make_unique<GpuRadixSort>(
+        *this, p_device.get(), p_buffer_manager.get(), p_radix_histogram_shader.get(), p_radix_scan_shader.get(),
+        p_radix_scatter_shader.get(), m_max_particle_instances, m_frames_in_flight, m_particle_indirect_buffers, 1,
+        std::span<const u32>{particle_queue_families.data(), particle_queue_families.size()});
+
+    const VkDeviceSize sort_buffer_size{p_particle_sort->GetBufferSize()};
+    const std::array<ComputeBufferBinding, 9> particle_compute_bindings{{
+        {{&m_particle_pool_buffer, 1}, max_particle_instance_size},
+        {m_compute_uniform_buffers, sizeof(SimulationParams)},
+        {m_compacted_particle_buffers, max_particle_instance_size},
+        {m_particle_indirect_buffers, sizeof(VkDrawIndexedIndirectCommand)},
+        {{&m_particle_pool_state_buffer, 1}, pool_state_size},
+        {p_particle_sort->GetKeyBuffers(), sort_buffer_size},
+        {p_particle_sort->GetValueBuffers(), sort_buffer_size},
+        {m_particle_collider_buffers, sizeof(math::AABB2D) * MAX_PARTICLE_COLLIDERS},
+        {m_particle_collision_cell_buffers,
+         sizeof(u32) * (MAX_PARTICLE_COLLISION_CELLS + 1 + MAX_PARTICLE_COLLISION_ENTRIES)},
+    }};
+
+    const std::array<ComputeBufferBinding, 4> particle_gather_bindings{{
+        {{&m_particle_pool_buffer, 1}, max_particle_instance_size},
+        {m_particle_indirect_buffers, sizeof(VkDrawIndexedIndirectCommand)},
+        {p_particle_sort->GetValueBuffers(), sort_buffer_size},
+        {m_compacted_particle_buffers, max_particle_instance_size},
+    }};
+
+    const std::array<ComputeBufferBinding, 4> particle_emit_bindings{{
+        {{&m_particle_pool_buffer, 1}, max_particle_instance_size},
+        {m_compute_uniform_buffers, sizeof(SimulationParams)},
+        {{&m_particle_pool_state_buffer, 1}, pool_state_size},
+        {m_particle_spawn_buffers, sizeof(ParticleData) * MAX_PARTICLE_SPAWNS_PER_FRAME},
+    }};
+
+    const VkDeviceSize max_static_quad_instance_size{sizeof(QuadInstance) * m_max_static_quad_instances};
+    const std::array<ComputeBufferBinding, 4> quad_cull_bindings{{
+        {{&m_static_quad_buffer, 1}, max_static_quad_instance_size},
+        {m_cull_uniform_buffers, sizeof(CullParams)},
+        {m_culled_quad_visible_buffers, max_static_quad_instance_size * MAX_VIEWPORTS},
+        {m_cull_indirect_buffers, sizeof(VkDrawIndirectCommand) * MAX_VIEWPORTS},
+    }};
+
+    const std::array<ComputeBufferBinding, 3> light_cull_bindings{{
+        {m_light_uniform_buffers, sizeof(LightParams)},
+        {m_light_buffers, sizeof(PointLight) * MAX_LIGHTS},
+        {m_light_tile_buffers, sizeof(u32) * LIGHT_TILE_STRIDE * MAX_LIGHT_TILES},
+    }};
+
+    // Pipelines share layouts through the layout cache, it and the pipeline cache are internally synchronized
+    const std::array<std::function<void()>, 10> pipeline_jobs{{
+        [&] {
+            p_quad_pipeline = std::make_unique<GraphicsPipeline>(
+                *this, rendering_info, p_quad_vertex_shader.get(), p_quad_fragment_shader.get(), frames_in_flight,
+                PipelineType::Quad);
+        },
+        [&] {
+            p_quad_alpha_test_pipeline = std::make_unique<GraphicsPipeline>(
+                *this, rendering_info, p_quad_vertex_shader.get(), p_quad_fragment_shader.get(), frames_in_flight,
+                PipelineType::QuadAlphaTest);
+        },
+        [&] {
+            p_quad_transparent_pipeline = std::make_unique<GraphicsPipeline>(
+                *this, rendering_info, p_quad_vertex_shader.get(), p_quad_fragment_shader.get(), frames_in_flight,
+                PipelineType::QuadTransparent);
+        },
+        [&] {
+            p_particle_pipeline = std::make_unique<GraphicsPipeline>(
+                *this, rendering_info, p_particle_vertex_shader.get(), p_particle_fragment_shader.get(),
+                frames_in_flight, PipelineType::Particle);
+        },
+        [&] {
+            p_upscale_pipeline = std::make_unique<GraphicsPipeline>(
+                *this, rendering_info, p_upscale_vertex_shader.get(), p_upscale_fragment_shader.get(),
+                frames_in_flight, PipelineType::Upscale);
+        },
+        [&] {
+            p_particle_compute_pipeline = std::make_unique<ComputePipeline>(
+                *this, p_device.get(), p_particle_compute_shader.get(), particle_compute_bindings);
+        },
+        [&] {
+            p_particle_emit_pipeline = std::make_unique<ComputePipeline>(
+                *this, p_device.get(), p_particle_emit_shader.get(), particle_emit_bindings);
+        },
+        [&] {
+            p_quad_cull_pipeline = std::make_unique<ComputePipeline>(*this, p_device.get(), p_quad_cull_shader.get(),
+                                                                     quad_cull_bindings);
+        },
+        [&] {
+            p_light_cull_pipeline = std::make_unique<ComputePipeline>(*this, p_device.get(), p_light_cull_shader.get(),
+                                                                      light_cull_bindings);
+        },
+        [&] {
+            p_particle_gather_pipeline = std::make_unique<ComputePipeline>(
+                *this, p_device.get(), p_particle_gather_shader.get(), particle_gather_bindings);
+        },
+    }};
+    p_worker_pool->Run(static_cast<u32>(pipeline_jobs.size()), [&](const u32 index) { pipeline_jobs[index](); });
+
+    for (GraphicsPipeline *pipeline :
+         {p_quad_pipeline.get(), p_quad_alpha_test_pipeline.get(), p_quad_transparent_pipeline.get()}) {
+        WriteLightDescriptors(*pipeline);
+        WriteAnimationDescriptors(*pipeline);
+    }
 
-    m_current_frame = (m_current_frame + 1) % p_swapchain->GetImageCount();
+    ENGINE_LOG_DEBUG("Created {} shaders and {} pipelines on {} threads.", shader_jobs.size(), pipeline_jobs.size(),
+                     p_worker_pool->GetThreadCount());
+
+    // Only the graphics shaders are watched for hot reload
+    const auto watch = [](StringView vertex_path, StringView fragment_path,
+                          std::unique_ptr<Shader> Renderer::*vertex_shader,
+                          std::unique_ptr<Shader> Renderer::*fragment_shader,
+                          const std::initializer_list<PipelineType> pipeline_types) {
+        return ShaderWatch{.vertex_path = String{vertex_path},
+                           .fragment_path = String{fragment_path},
+                           .vertex_last_modified = internal::last_write_time(vertex_path),
+                           .fragment_last_modified = internal::last_write_time(fragment_path),
+                           .vertex_shader = vertex_shader,
+                           .fragment_shader = fragment_shader,
+                           .pipeline_types = pipeline_types};
+    };
+    m_shader_watches.clear();
+    m_shader_watches.push_back(watch(quad_vertex_shader_path, quad_fragment_shader_path,
+                                     &Renderer::p_quad_vertex_shader, &Renderer::p_quad_fragment_shader,
+                                     {PipelineType::Quad, PipelineType::QuadAlphaTest, PipelineType::QuadTransparent}));
+    m_shader_watches.push_back(watch(particle_vertex_shader_path, particle_fragment_shader_path,
+                                     &Renderer::p_particle_vertex_shader, &Renderer::p_particle_fragment_shader,
+                                     {PipelineType::Particle}));
+    m_shader_watches.push_back(watch(upscale_vertex_shader_path, upscale_fragment_shader_path,
+                                     &Renderer::p_upscale_vertex_shader, &Renderer::p_upscale_fragment_shader,
+                                     {PipelineType::Upscale}));
+
+    if (m_shader_hot_reload) {
+        StartFileWatcher();
+    }
 }
 
-void Renderer::UpdateComputeUniformBuffer(const u32 image_index, const f32 delta_time)
+bool Renderer::CheckShadersForUpdate()
 {
-    m_simulation_params.delta_time = delta_time;
-    m_compute_uniform_buffers[image_index].Update(p_device->GetDevice(), &m_simulation_params,
-                                                  sizeof(SimulationParams));
+    // Changes made while a rebuild runs are picked up by the first check after it was swapped in
+    if (m_shader_reload.valid()) {
+        return false;
+    }
+
+    for (size_t watch_index = 0; watch_index < m_shader_watches.size(); ++watch_index) {
+        ShaderWatch &watch{m_shader_watches[watch_index]};
+        const FileTimeType vertex_time{internal::last_write_time(watch.vertex_path)};
+        const FileTimeType fragment_time{internal::last_write_time(watch.fragment_path)};
+        if (vertex_time <= watch.vertex_last_modified && fragment_time <= watch.fragment_last_modified) {
+            continue;
+        }
+
+        // Recorded up front, a shader that fails to compile is only retried once its file is saved again
+        watch.vertex_last_modified = vertex_time;
+        watch.fragment_last_modified = fragment_time;
+        ENGINE_LOG_INFO("Shader '{}' or '{}' changed, rebuilding {} pipeline(s).", watch.vertex_path,
+                        watch.fragment_path, watch.pipeline_types.size());
+
+        // The watches are left alone while the job runs. Texture descriptors are written on the main thread at swap
+        // time, the texture list may change while the job runs.
+        m_shader_reload = std::async(std::launch::async, [this, watch_index] {
+            const ShaderWatch &reload_watch{m_shader_watches[watch_index]};
+            ShaderReload reload{.watch_index = watch_index,
+                                .vertex_shader = std::make_unique<Shader>(*p_device, reload_watch.vertex_path),
+                                .fragment_shader = std::make_unique<Shader>(*p_device, reload_watch.fragment_path),
+                                .pipelines = {}};
+
+            const VkPipelineRenderingCreateInfo rendering_info{GetPipelineRenderingInfo()};
+            for (const PipelineType type : reload_watch.pipeline_types) {
+                reload.pipelines.push_back(std::make_unique<GraphicsPipeline>(
+                    *this, rendering_info, reload.vertex_shader.get(), reload.fragment_shader.get(),
+                    static_cast<int>(m_frames_in_flight), type, false));
+            }
+            return reload;
+        });
+        return true;
+    }
+
+    return false;
 }
 
-void Renderer::UpdateParticleStorageBuffer(const u32 image_index,
-                                           const std::vector<ParticleData> &particle_instances) const
+void Renderer::SetShaderHotReload(const bool enabled)
 {
-    const VkDeviceSize particle_instance_size =
-        sizeof(ParticleData) * std::min(particle_instances.size(), static_cast<size_t>(m_max_particle_instances));
+    m_shader_hot_reload = enabled;
+    if (!m_is_initialized) {
+        return; // SetupPipelines starts the watcher
+    }
 
-    // Only update if there are particles
-    if (!particle_instances.empty()) {
-        memcpy(m_mapped_particle_storage_data[image_index], particle_instances.data(), particle_instance_size);
+    if (enabled) {
+        StartFileWatcher();
+        return;
     }
 
-    // ENGINE_LOG_DEBUG("Updating particle storage buffer[{}]: {} particles, size = {} bytes",
-    //           image_index, particle_instances.size(), particle_instance_size);
+    p_texture_manager->SetFileWatcher(nullptr);
+    p_file_watcher.reset();
+    m_shader_change_pending = false;
 }
 
-void Renderer::ClearParticleBuffers(const u32 image_index) const
+void Renderer::StartFileWatcher()
 {
-    const VkDeviceSize max_particle_instance_size{sizeof(ParticleData) * m_max_particle_instances};
-    memset(m_mapped_particle_storage_data[image_index], 0, max_particle_instance_size);
+    if (!p_file_watcher) {
+        p_file_watcher = std::make_unique<fs::FileWatcher>();
+    }
+
+    for (const ShaderWatch &watch : m_shader_watches) {
+        p_file_watcher->Watch(watch.vertex_path);
+        p_file_watcher->Watch(watch.fragment_path);
+    }
+    // Font atlas images are textures the texture manager watches, only their glyph metrics are left
+    for (const FontSource &source : m_font_sources) {
+        if (!source.json_filepath.empty()) {
+            p_file_watcher->Watch(source.json_filepath);
+        }
+    }
+    p_texture_manager->SetFileWatcher(p_file_watcher.get());
 }
 
-void Renderer::ToggleComputeParticles()
+void Renderer::ProcessFileChanges()
 {
-    m_use_compute_particles = !m_use_compute_particles;
-    ENGINE_LOG_DEBUG("Compute particles {}.", m_use_compute_particles ? "enabled" : "disabled");
+    if (p_file_watcher) {
+        if (const Vector<String> changed_files{p_file_watcher->PollChanges()}; !changed_files.empty()) {
+            const auto is_changed = [&changed_files](const String &filepath) {
+                return std::ranges::find(changed_files, filepath) != changed_files.end();
+            };
+            if (std::ranges::any_of(m_shader_watches, [&](const ShaderWatch &watch) {
+                    return is_changed(watch.vertex_path) || is_changed(watch.fragment_path);
+                })) {
+                m_shader_change_pending = true;
+            }
+            p_texture_manager->ReloadChangedTextures(changed_files);
+            for (u32 font_id = 0; font_id < m_font_sources.size(); ++font_id) {
+                const FontSource &source{m_font_sources[font_id]};
+                if (!source.json_filepath.empty() && is_changed(source.json_filepath)) {
+                    ReloadFont(font_id);
+                }
+            }
+
+            for (const String &filepath : changed_files) {
+                if (std::ranges::find(m_changed_files, filepath) == m_changed_files.end()) {
+                    m_changed_files.push_back(filepath);
+                }
+            }
+        }
+    }
 
-    // Sync storage buffers with current particle instances
-    for (size_t i = 0; i < p_swapchain->GetImageCount(); ++i) {
-        UpdateParticleStorageBuffer(i, m_particles_instances);
+    // One rebuild runs at a time, the check after it finished picks up any other watch that changed meanwhile
+    if (m_shader_change_pending && !m_shader_reload.valid()) {
+        m_shader_change_pending = CheckShadersForUpdate();
     }
 }
 
-void Renderer::DrawText(StringView text, const Vec3 &position, const Colour<f32> &colour, const f32 scale,
-                        const u32 font_id, std::vector<TextData> &text_instances, const TextAlign alignment,
-                        bool apply_camera_effects)
+void Renderer::ApplyShaderReload()
 {
-    if (m_font_textures.empty()) {
-        ENGINE_LOG_ERROR("No Fonts loaded when trying to render: {}, with font_id: {}.", text, font_id);
+    if (!m_shader_reload.valid() || m_shader_reload.wait_for(std::chrono::seconds{0}) != std::future_status::ready) {
         return;
     }
-
-    if (!m_fonts.contains(font_id) || !m_font_atlas_params.contains(font_id)) {
-        ENGINE_LOG_ERROR("Font ID {} not found!", font_id);
+    // Variant jobs still build from the shaders a reload may retire, it waits for them
+    const auto is_building = [](const PendingVariant &pending) { return pending.pipeline.valid(); };
+    if (std::ranges::any_of(m_pending_variants, is_building)) {
         return;
     }
 
-    const auto &glyphs = m_fonts[font_id];
-    const auto &atlas_params = m_font_atlas_params[font_id];
-    f32 overall_width{0.0f};
-
-    // First pass: Calculate overall width
-    for (char current_character : text) {
-        u32 unicode_char = static_cast<unsigned char>(current_character);
-        auto it = glyphs.find(current_character);
-        if (it == glyphs.end()) {
-            ENGINE_LOG_WARNING("MSDFGlyph '{}' (unicode={}) not found in font {}.", current_character, unicode_char,
-                               font_id);
-            // Fallback to space glyph's advance
-            if (auto space_it = glyphs.find(32); space_it != glyphs.end()) {
-                overall_width += space_it->second.advance * scale;
-            }
-            continue;
-        }
-
-        const MSDFGlyph &glyph = it->second;
-        overall_width += glyph.advance * scale;
+    ShaderReload reload{};
+    try {
+        reload = m_shader_reload.get();
+    }
+    catch (const std::exception &e) {
+        ENGINE_LOG_ERROR("Shader reload failed, keeping the current pipelines: {}", e.what());
+        return;
     }
 
-    // Adjust starting position based on alignment
-    Vec3 current_position = position;
-    if (alignment == TextAlign::Center) {
-        current_position.x -= overall_width * 0.5f;
+    // Every frame submitted so far may have been recorded with the replaced objects
+    const ShaderWatch &watch{m_shader_watches[reload.watch_index]};
+    RetiredPipelines retired{.timeline_value = m_queue.GetLastSubmittedValue(), .shaders = {}, .pipelines = {}};
+    for (size_t i = 0; i < reload.pipelines.size(); ++i) {
+        std::unique_ptr<GraphicsPipeline> &pipeline{reload.pipelines[i]};
+        pipeline->UpdateTextureDescriptors(m_frames_in_flight, p_texture_manager->GetTextures());
+        WriteTextureArrayDescriptors(*pipeline, 0);
+        WriteLightDescriptors(*pipeline);
+        WriteAnimationDescriptors(*pipeline);
+        retired.pipelines.push_back(std::exchange(GetGraphicsPipeline(watch.pipeline_types[i]), std::move(pipeline)));
     }
-    else if (alignment == TextAlign::Right) {
-        current_position.x -= overall_width;
+    const auto reloaded{std::ranges::partition(m_pipeline_variants, [&watch](const auto &variant) {
+        return std::ranges::find(watch.pipeline_types, variant->GetType()) == watch.pipeline_types.end();
+    })};
+    for (std::unique_ptr<GraphicsPipeline> &variant : reloaded) {
+        retired.pipelines.push_back(std::move(variant));
     }
-    // Left alignment: no adjustment needed
+    m_pipeline_variants.erase(reloaded.begin(), reloaded.end());
+    // Variants that failed to build are tried again with the new shaders
+    const auto failed{std::ranges::remove_if(m_pending_variants, [&watch](const PendingVariant &pending) {
+        return std::ranges::find(watch.pipeline_types, pending.type) != watch.pipeline_types.end();
+    })};
+    m_pending_variants.erase(failed.begin(), failed.end());
+    retired.shaders.push_back(std::exchange(this->*watch.vertex_shader, std::move(reload.vertex_shader)));
+    retired.shaders.push_back(std::exchange(this->*watch.fragment_shader, std::move(reload.fragment_shader)));
+    m_retired_pipelines.push_back(std::move(retired));
+    DiscardRecordedFrames();
+
+    ENGINE_LOG_INFO("Swapped in {} rebuilt pipeline(s) for '{}' and '{}'.", reload.pipelines.size(), watch.vertex_path,
+                    watch.fragment_path);
+}
 
-    // Second pass: Generate TextData instances
-    for (char current_character : text) {
-        auto unicode_char = static_cast<unsigned char>(current_character);
-        auto it = glyphs.find(current_character);
-        if (it == glyphs.end()) {
-            // Handle missing glyph (e.g., use space or skip)
-            ENGINE_LOG_WARNING("MSDFGlyph '{}' (unicode={}) not found in font {}.", current_character, unicode_char,
-                               font_id);
-            continue;
+void Renderer::ReloadFont(const u32 font_id)
+{
+    const FontSource &source{m_font_sources[font_id]};
+    ENGINE_LOG_INFO("Font '{}' changed, reloading the metrics of font {}.", source.json_filepath, font_id);
+
+    // The atlas image is reloaded by the texture manager, in place in its slot
+    m_fonts[font_id] = load_msdf_glyphs(source.json_filepath);
+    m_font_atlas_params[font_id] = load_msdf_atlas_params(source.json_filepath);
+    m_fonts[font_id].SetKerning(m_font_atlas_params[font_id].kerning);
+
+    // Cached layouts of every font go, they are rebuilt the next time they are drawn
+    m_text_layouts.clear();
+    for (RetainedText &retained : m_retained_texts) {
+        if (retained.font_id == font_id) {
+            LayoutRetainedText(retained);
         }
+    }
+}
 
-        const MSDFGlyph &glyph = it->second;
+void Renderer::DestroyRetiredPipelines()
+{
+    while (!m_retired_pipelines.empty() && m_queue.IsComplete(m_retired_pipelines.front().timeline_value)) {
+        m_retired_pipelines.pop_front();
+    }
+}
 
-        // Skip glyphs with empty plane bounds or current character is a space (32)
-        if (glyph.plane_bounds.IsZero() || unicode_char == 32) {
-            current_position.x += glyph.advance * scale;
-            continue;
+void Renderer::DestroyRetiredSwapchains(const bool destroy_all)
+{
+    while (!m_retired_swapchains.empty() &&
+           (destroy_all || m_queue.IsComplete(m_retired_swapchains.front().timeline_value))) {
+        RetiredSwapchainResources &retired{m_retired_swapchains.front()};
+        p_swapchain->DestroyRetired(retired.swapchain);
+        for (Texture &depth_image : retired.depth_images) {
+            depth_image.Destroy(p_device.get());
         }
+        m_retired_swapchains.pop_front();
+    }
+}
 
-        const Rect plane_bounds{glyph.plane_bounds};
-        const Rect atlas_bounds{glyph.atlas_bounds};
-        const Vec3 glyph_position{current_position.x + plane_bounds.left * scale,
-                                  current_position.y + plane_bounds.bottom * scale, position.z};
-        const Vec2 size{(plane_bounds.right - plane_bounds.left) * scale,
-                        (plane_bounds.top - plane_bounds.bottom) * scale};
-
-        TextData instance{};
-        instance.position = glyph_position;
-        instance.size = size;
-        instance.colour = colour;
-        instance.glyph_index = static_cast<u32>(unicode_char);
-        instance.sdf_params = UVRect{atlas_bounds.left, atlas_bounds.bottom, atlas_bounds.right, atlas_bounds.top};
-        instance.texture_index = font_id;
-        instance.atlas_size = atlas_params.atlas_size;
-        instance.px_range = atlas_params.distance_range;
-        instance.apply_camera_effects = apply_camera_effects;
-
-        text_instances.push_back(instance);
-        current_position.x += glyph.advance * scale;
+std::unique_ptr<GraphicsPipeline> &Renderer::GetGraphicsPipeline(const PipelineType type)
+{
+    switch (type) {
+        case PipelineType::Quad:
+            return p_quad_pipeline;
+        case PipelineType::QuadAlphaTest:
+            return p_quad_alpha_test_pipeline;
+        case PipelineType::QuadTransparent:
+            return p_quad_transparent_pipeline;
+        case PipelineType::Particle:
+            return p_particle_pipeline;
+        case PipelineType::Upscale:
+            return p_upscale_pipeline;
     }
+    ENGINE_THROW("Unknown graphics pipeline type");
 }
 
-void Renderer::SetupPipelines(StringView quad_vertex_shader_path, StringView quad_fragment_shader_path,
-                              StringView text_vertex_shader_path, StringView text_fragment_shader_path,
-                              StringView particle_vertex_shader_path, StringView particle_fragment_shader_path,
-                              StringView particle_compute_shader_path)
-{
-    p_quad_vertex_shader = std::make_unique<Shader>(*p_device, quad_vertex_shader_path);
-    p_quad_fragment_shader = std::make_unique<Shader>(*p_device, quad_fragment_shader_path);
-    p_quad_pipeline = std::make_unique<GraphicsPipeline>(*this, p_render_pass, p_quad_vertex_shader.get(),
-                                                         p_quad_fragment_shader.get(), p_swapchain->GetImageCount(),
-                                                         m_uniform_buffers, sizeof(UniformData), PipelineType::Quad);
-
-    p_text_vertex_shader = std::make_unique<Shader>(*p_device, text_vertex_shader_path);
-    p_text_fragment_shader = std::make_unique<Shader>(*p_device, text_fragment_shader_path);
-    p_text_pipeline = std::make_unique<GraphicsPipeline>(*this, p_render_pass, p_text_vertex_shader.get(),
-                                                         p_text_fragment_shader.get(), p_swapchain->GetImageCount(),
-                                                         m_uniform_buffers, sizeof(UniformData), PipelineType::Text);
-
-    p_particle_vertex_shader = std::make_unique<Shader>(*p_device, particle_vertex_shader_path);
-    p_particle_fragment_shader = std::make_unique<Shader>(*p_device, particle_fragment_shader_path);
-    p_particle_pipeline = std::make_unique<GraphicsPipeline>(
-        *this, p_render_pass, p_particle_vertex_shader.get(), p_particle_fragment_shader.get(),
-        p_swapchain->GetImageCount(), m_uniform_buffers, sizeof(UniformData), PipelineType::Particle);
-
-    p_particle_compute_shader = std::make_unique<Shader>(*p_device, particle_compute_shader_path);
-    p_particle_compute_pipeline = std::make_unique<ComputePipeline>(
-        *this, p_device.get(), p_particle_compute_shader.get(), m_particle_storage_buffers, m_compute_uniform_buffers,
-        sizeof(ParticleData) * m_max_particle_instances, sizeof(SimulationParams));
-}
-
-void Renderer::CreateFramebuffers()
-{
-    m_framebuffers.clear();
-    m_framebuffers.resize(p_swapchain->GetImages().size());
-
-    FrameBufferSize swapchain_size = p_swapchain->GetFramebufferSize();
-    ENGINE_LOG_DEBUG("Framebuffer size from swapchain: {}x{}", swapchain_size.width, swapchain_size.height);
-
-    ASSERT(m_framebuffer_size.area() > 0, "Framebuffer dimensions cannot be zero.");
-
-    for (size_t i = 0; i < p_swapchain->GetImages().size(); i++) {
-        Vector<VkImageView> attachments;
-        attachments.emplace_back(p_swapchain->GetImageViews()[i]);
-        attachments.emplace_back(p_depth_resources->GetDepthImages()[i].p_view);
-
-        VkFramebufferCreateInfo frame_buffer_create_info{};
-        frame_buffer_create_info.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-        frame_buffer_create_info.renderPass = p_render_pass;
-        frame_buffer_create_info.attachmentCount = static_cast<u32>(attachments.size());
-        frame_buffer_create_info.pAttachments = attachments.data();
-        frame_buffer_create_info.width = static_cast<u32>(swapchain_size.width);
-        frame_buffer_create_info.height = static_cast<u32>(swapchain_size.height);
-        frame_buffer_create_info.layers = 1;
-
-        const VkResult result{
-            vkCreateFramebuffer(p_device->GetDevice(), &frame_buffer_create_info, nullptr, &m_framebuffers[i])};
-        if (result != VK_SUCCESS) {
-            CHECK_VK_RESULT(result, "vkCreateFramebuffer");
+VkPipelineCache Renderer::GetPipelineCache() const { return p_pipeline_cache->GetCache(); }
+
+GraphicsPipeline &Renderer::GetPipelineVariant(const PipelineType type, const SpecializationConstants &constants)
+{
+    for (const std::unique_ptr<GraphicsPipeline> &variant : m_pipeline_variants) {
+        if (variant->GetType() == type && variant->GetConstants() == constants) {
+            return *variant;
         }
     }
 
-    ENGINE_LOG_DEBUG("Framebuffers created.");
+    // The type's own pipeline draws the same thing without the constants' shortcuts, a fine stand in for a few frames
+    GraphicsPipeline &fallback{*GetGraphicsPipeline(type)};
+    const auto pending{std::ranges::find_if(m_pending_variants, [&](const PendingVariant &variant) {
+        return variant.type == type && variant.constants == constants;
+    })};
+    if (pending != m_pending_variants.end()) {
+        return fallback;
+    }
+
+    // Built from the type's current shaders, which a reload keeps alive until the job is done. Texture descriptors are
+    // written on the main thread at swap time, the texture list may change while the job runs.
+    Shader *vertex_shader{fallback.GetVertexShader()};
+    Shader *fragment_shader{fallback.GetFragmentShader()};
+    m_pending_variants.push_back(
+        {.type = type,
+         .constants = constants,
+         .pipeline = std::async(std::launch::async, [this, vertex_shader, fragment_shader, type, constants] {
+             return std::make_unique<GraphicsPipeline>(*this, GetPipelineRenderingInfo(), vertex_shader,
+                                                       fragment_shader, static_cast<int>(m_frames_in_flight), type,
+                                                       false, constants);
+         })});
+    return fallback;
 }
 
-void Renderer::DestroyFramebuffers()
+void Renderer::ApplyPipelineVariants()
 {
-    for (const auto buffer : m_framebuffers) {
-        vkDestroyFramebuffer(p_device->GetDevice(), buffer, nullptr);
-    }
+    for (size_t i = 0; i < m_pending_variants.size();) {
+        PendingVariant &pending{m_pending_variants[i]};
+        if (!pending.pipeline.valid() ||
+            pending.pipeline.wait_for(std::chrono::seconds{0}) != std::future_status::ready) {
+            ++i;
+            continue;
+        }
 
-    m_framebuffers.clear();
+        std::unique_ptr<GraphicsPipeline> variant;
+        try {
+            variant = pending.pipeline.get();
+        }
+        catch (const std::exception &e) {
+            // Left pending without a job, so it is not built again every frame
+            ENGINE_LOG_ERROR("Pipeline variant of {} failed to build, drawing with the fallback: {}",
+                             static_cast<u32>(pending.type), e.what());
+            ++i;
+            continue;
+        }
 
-    ENGINE_LOG_DEBUG("Framebuffers destroyed.");
+        variant->UpdateTextureDescriptors(m_frames_in_flight, p_texture_manager->GetTextures());
+        WriteTextureArrayDescriptors(*variant, 0);
+        WriteLightDescriptors(*variant);
+        WriteAnimationDescriptors(*variant);
+        m_pipeline_variants.push_back(std::move(variant));
+        DiscardRecordedFrames();
+        m_pending_variants.swap_remove(m_pending_variants.begin() + static_cast<std::ptrdiff_t>(i));
+        ENGINE_LOG_DEBUG("Swapped in pipeline variant {} of {}.", m_pipeline_variants.size(),
+                         static_cast<u32>(m_pipeline_variants.back()->GetType()));
+    }
 }
 
 void Renderer::CreateCommandBuffers()
 {
     m_command_buffers.clear();
-    m_command_buffers.resize(p_swapchain->GetImageCount());
+    m_command_buffers.resize(m_frames_in_flight);
+    m_recorded_frame_structures.assign(m_frames_in_flight, NO_FRAME_STRUCTURE);
 
     p_command_buffer_manager->AllocateBuffers(static_cast<u32>(m_command_buffers.size()), m_command_buffers.data());
-}
 
-void Renderer::CreateUniformBuffers(const size_t data_size)
-{
-    m_uniform_buffers.clear();
-    m_uniform_buffers.reserve(p_swapchain->GetImages().size());
+    // No more recording threads than passes, a single thread records everything inline on the caller
+    const u32 recording_thread_count{std::clamp(p_worker_pool->GetThreadCount(), 1u, DRAW_PASS_COUNT)};
+    p_command_buffer_manager->CreateThreadPools(recording_thread_count, m_frames_in_flight);
+
+    m_secondary_command_buffers.clear();
+    m_secondary_command_buffers.resize(static_cast<size_t>(DRAW_PASS_COUNT) * m_frames_in_flight);
+    for (u32 frame = 0; frame < m_frames_in_flight; ++frame) {
+        for (u32 pass = 0; pass < DRAW_PASS_COUNT; ++pass) {
+            VkCommandBuffer &command_buffer{m_secondary_command_buffers[frame * DRAW_PASS_COUNT + pass]};
+            p_command_buffer_manager->AllocateSecondaryBuffers(pass % recording_thread_count, frame, 1,
+                                                               &command_buffer);
+        }
+    }
+    ENGINE_LOG_DEBUG("Recording {} draw passes on {} threads.", DRAW_PASS_COUNT, recording_thread_count);
 
-    for (size_t i = 0; i < p_swapchain->GetImages().size(); ++i) {
-        m_uniform_buffers.emplace_back(p_buffer_manager->CreateUniformBuffer(data_size));
+    if (p_compute_command_buffer_manager) {
+        m_compute_command_buffers.clear();
+        m_compute_command_buffers.resize(m_frames_in_flight);
+        p_compute_command_buffer_manager->AllocateBuffers(static_cast<u32>(m_compute_command_buffers.size()),
+                                                          m_compute_command_buffers.data());
     }
 }
 
@@ -549,9 +2762,49 @@ u32 Renderer::LoadAtlasTexture(StringView image_filepath, StringView json_filepa
     return p_texture_manager->LoadAtlasTexture(image_filepath, json_filepath);
 }
 
-const Sprite *Renderer::GetSprite(const u32 texture_id, StringView sprite_name) const
+u32 Renderer::LoadSingleTextureAsync(StringView filepath) const
+{
+    return p_texture_manager->LoadSingleTextureAsync(filepath);
+}
+
+u32 Renderer::LoadAtlasTextureAsync(StringView image_filepath, StringView json_filepath) const
+{
+    return p_texture_manager->LoadAtlasTextureAsync(image_filepath, json_filepath);
+}
+
+Task<u32> Renderer::LoadTextureAsync(JobSystem &job_system, String filepath) const
+{
+    return p_texture_manager->LoadTextureAsync(job_system, std::move(filepath));
+}
+
+Vector<u32> Renderer::LoadPackedAtlas(const std::span<const String> image_filepaths, const u32 page_size) const
 {
-    return p_texture_manager->GetSprite(texture_id, sprite_name);
+    return p_texture_manager->LoadPackedAtlas(image_filepaths, page_size);
+}
+
+u32 Renderer::LoadTextureArray(const std::span<const String> image_filepaths)
+{
+    // Ids from this call on are new and read by no frame in flight, so every frame's set is written straight away
+    const u32 first_new_array{static_cast<u32>(p_texture_manager->GetTextureArrays().size())};
+    const u32 array_id{p_texture_manager->LoadTextureArray(image_filepaths)};
+    for (GraphicsPipeline *pipeline : {p_quad_pipeline.get(), p_quad_alpha_test_pipeline.get(),
+                                       p_quad_transparent_pipeline.get()}) {
+        WriteTextureArrayDescriptors(*pipeline, first_new_array);
+    }
+    for (const std::unique_ptr<GraphicsPipeline> &variant : m_pipeline_variants) {
+        WriteTextureArrayDescriptors(*variant, first_new_array);
+    }
+    return array_id;
+}
+
+const Sprite *Renderer::GetSprite(const u32 texture_id, const StringId sprite_id) const
+{
+    return p_texture_manager->GetSprite(texture_id, sprite_id);
+}
+
+u32 Renderer::FindSpriteTexture(const StringId sprite_id) const
+{
+    return p_texture_manager->FindSpriteTexture(sprite_id);
 }
 
 const TextureMetadata &Renderer::GetTextureMetadata(const u32 texture_id) const
@@ -564,8 +2817,8 @@ u32 Renderer::GetTextureCount() const { return p_texture_manager->GetTextureCoun
 
 u32 Renderer::LoadTexture(StringView filepath, const std::optional<StringView> &json_filepath) const
 {
-    if (p_texture_manager->GetTextureCount() >= MAX_TEXTURES) {
-        ENGINE_LOG_ERROR("Cannot load texture '{}': max textures ({}) reached", filepath, MAX_TEXTURES);
+    if (p_texture_manager->GetTextureCount() >= p_device->GetMaxTextures()) {
+        ENGINE_LOG_ERROR("Cannot load texture '{}': max textures ({}) reached", filepath, p_device->GetMaxTextures());
         return 0;
     }
 
@@ -582,26 +2835,61 @@ u32 Renderer::LoadTexture(StringView filepath, const std::optional<StringView> &
 
 u32 Renderer::LoadMSDFFont(StringView image_filepath, StringView json_filepath)
 {
-    if (m_font_textures.size() == MAX_TEXTURES) {
-        ENGINE_LOG_ERROR("Cannot load font '{}': max font textures ({}) reached", image_filepath, MAX_TEXTURES);
+    // The atlas is an ordinary bindless texture, glyphs are drawn by the quad pipelines
+    const u32 texture_id{LoadTexture(image_filepath)};
+    if (texture_id == 0) {
+        ENGINE_LOG_ERROR("Cannot load font '{}': its atlas could not be loaded.", image_filepath);
         return 0;
     }
 
-    const u32 font_id{static_cast<u32>(m_font_textures.size())};
-    m_font_textures.push_back(p_buffer_manager->CreateTexture(image_filepath));
+    const u32 font_id{static_cast<u32>(m_font_texture_ids.size())};
+    m_font_texture_ids.push_back(texture_id);
+    m_fonts.resize(m_font_texture_ids.size());
+    m_font_atlas_params.resize(m_font_texture_ids.size());
+    m_font_sources.resize(m_font_texture_ids.size());
+    m_font_sources[font_id] = FontSource{String{image_filepath}, String{json_filepath}};
+    if (p_file_watcher) {
+        p_file_watcher->Watch(json_filepath);
+    }
     m_fonts[font_id] = load_msdf_glyphs(json_filepath);
     m_font_atlas_params[font_id] = load_msdf_atlas_params(json_filepath);
+    m_fonts[font_id].SetKerning(m_font_atlas_params[font_id].kerning);
 
     // ENGINE_LOG_DEBUG("Atlas params: {}", m_font_atlas_params[font_id].ToString());
 
-    m_font_textures_dirty = true;
-
     return font_id;
 }
 
+const Thumbnail *Renderer::FindThumbnail(StringView image_filepath, const UVRect<f32> &source_rect)
+{
+    return p_thumbnail_cache->Find(image_filepath, source_rect);
+}
+
+bool Renderer::SetFontGlyphSource(const u32 font_id, StringView font_filepath)
+{
+    if (font_id >= m_fonts.size() || m_fonts[font_id].IsEmpty()) {
+        ENGINE_LOG_ERROR("Cannot set the glyph source '{}' of font {}: font not found.", font_filepath, font_id);
+        return false;
+    }
+
+    if (!p_glyph_cache->AddFont(font_id, font_filepath, m_font_atlas_params[font_id])) {
+        return false;
+    }
+
+    // Layouts done so far skipped the glyphs the atlas lacks
+    m_text_layouts.clear();
+    for (RetainedText &retained : m_retained_texts) {
+        if (retained.font_id == font_id) {
+            LayoutRetainedText(retained);
+        }
+    }
+    return true;
+}
+
 void Renderer::SetClearColour(const Colour<f32> &colour) { m_clear_colour = {colour.r, colour.g, colour.b, colour.a}; }
 
-void Renderer::InitializeCore(GLFWwindow *window_ptr, StringView app_name, SemVer vulkan_api_version)
+void Renderer::InitializeCore(GLFWwindow *window_ptr, StringView app_name, SemVer vulkan_api_version,
+                              StringView pipeline_cache_path, StringView preferred_device)
 {
     p_window = window_ptr;
     CacheFrameBufferSize();
@@ -609,13 +2897,50 @@ void Renderer::InitializeCore(GLFWwindow *window_ptr, StringView app_name, SemVe
     p_instance = std::make_unique<Instance>(app_name, vulkan_api_version, p_window);
     ENGINE_LOG_DEBUG("VulkanInstance initialized.");
 
-    p_device = std::make_unique<Device>(*p_instance, VK_QUEUE_GRAPHICS_BIT);
+    p_device = std::make_unique<Device>(*p_instance, VK_QUEUE_GRAPHICS_BIT, preferred_device);
     ENGINE_LOG_DEBUG("VulkanDevice initialized.");
 
+    // Created before any pipeline, so every pipeline built from here on is seeded from and recorded into it
+    p_pipeline_cache = std::make_unique<PipelineCache>(p_device.get(), pipeline_cache_path);
+    if (p_device->GetCapabilities().graphics_pipeline_library) {
+        p_pipeline_libraries =
+            std::make_unique<PipelineLibraryCache>(p_device->GetDevice(), p_pipeline_cache->GetCache());
+    }
+
+    // Bindless sets need update after bind pools, the other pipeline sets share them
+    p_descriptor_allocator = std::make_unique<DescriptorAllocator>(
+        p_device->GetDevice(),
+        VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT | VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT);
+    m_frame_descriptor_allocators.clear();
+    for (u32 frame = 0; frame < m_frames_in_flight; ++frame) {
+        m_frame_descriptor_allocators.push_back(std::make_unique<DescriptorAllocator>(p_device->GetDevice(), 0));
+    }
+    p_layout_cache = std::make_unique<LayoutCache>(p_device->GetDevice());
+
     p_command_buffer_manager =
         std::make_unique<CommandBufferManager>(p_device.get(), &m_queue, p_device->GetQueueFamily());
 
-    p_buffer_manager = std::make_unique<BufferManager>(p_device.get(), &m_queue, p_command_buffer_manager.get());
+    // Staging copies run on the transfer queue when there is one, in parallel with rendering
+    Queue *transfer_queue{nullptr};
+    if (p_device->HasDedicatedTransferQueue()) {
+        m_transfer_queue.Initialize(p_device.get(), p_device->GetTransferQueueFamily(), 0);
+        p_transfer_command_buffer_manager = std::make_unique<CommandBufferManager>(
+            p_device.get(), &m_transfer_queue, p_device->GetTransferQueueFamily());
+        transfer_queue = &m_transfer_queue;
+        ENGINE_LOG_DEBUG("Transfer queue initialized.");
+    }
+
+    p_buffer_manager = std::make_unique<BufferManager>(p_device.get(), &m_queue, p_command_buffer_manager.get(),
+                                                       transfer_queue, p_transfer_command_buffer_manager.get());
+
+    if (p_device->HasAsyncComputeQueue()) {
+        m_compute_queue.Initialize(p_device.get(), p_device->GetComputeQueueFamily(),
+                                   p_device->GetComputeQueueIndex());
+        p_compute_command_buffer_manager = std::make_unique<CommandBufferManager>(
+            p_device.get(), &m_compute_queue, p_device->GetComputeQueueFamily());
+        m_use_async_compute = true;
+        ENGINE_LOG_DEBUG("Compute queue initialized.");
+    }
     ENGINE_LOG_DEBUG("Buffer manager initialized.");
 }
 
@@ -625,15 +2950,14 @@ void Renderer::InitializeSwapchainAndQueue(VSyncMode vsync_mode)
         std::make_unique<Swapchain>(p_window, p_device.get(), p_instance.get(), p_buffer_manager.get(), vsync_mode);
     ENGINE_LOG_DEBUG("Swapchain initialized.");
 
-    m_queue.Initialize(p_device.get(), p_swapchain.get(), p_device->GetQueueFamily(), 0);
+    m_queue.Initialize(p_device.get(), p_swapchain.get(), p_device->GetQueueFamily(), 0, m_frames_in_flight);
     ENGINE_LOG_DEBUG("Queue initialized.");
 }
 
 void Renderer::InitializeDefaultResources()
 {
-    auto default_font_texture = p_buffer_manager->CreateDefaultTexture();
-    m_font_textures.push_back(std::move(default_font_texture));
-    ENGINE_LOG_DEBUG("Default font texture created and added to font textures at index 0.");
+    // Font 0 has no glyphs and draws nothing, its atlas is the default texture
+    m_font_texture_ids.assign(1, 0);
 
     const Vector<Vertex> quad_vertices{{{0.0f, 0.0f, 0.0f}, {0.0f, 0.0f}},
                                        {{1.0f, 0.0f, 0.0f}, {1.0f, 0.0f}},
@@ -654,116 +2978,67 @@ void Renderer::InitializeDefaultResources()
 
 void Renderer::InitializeRenderResources()
 {
-    CreateFences();
+    CreateFrameSyncValues();
     CreateInstanceBuffers();
 
+    p_worker_pool = std::make_unique<WorkerPool>(std::max(std::thread::hardware_concurrency(), 1u), "Render worker",
+                                                 ThreadPriority::Render);
+
     p_command_buffer_manager->AllocateBuffers(1, &p_copy_command_buffer);
     CreateCommandBuffers();
 
     p_texture_manager = std::make_unique<TextureManager>(p_buffer_manager.get(), p_device.get());
+    p_gpu_timer = std::make_unique<GpuTimer>(p_device.get(), m_frames_in_flight);
 
     p_depth_resources =
         std::make_unique<DepthResources>(p_device.get(), p_instance.get(), p_buffer_manager.get(), p_swapchain.get());
+    p_render_graph = std::make_unique<RenderGraph>(p_device.get(), p_buffer_manager.get(), &m_queue);
+    p_frame_capture = std::make_unique<FrameCapture>(p_device.get(), p_buffer_manager.get());
+    p_glyph_cache = std::make_unique<GlyphCache>(p_buffer_manager.get(), p_texture_manager.get());
+    p_thumbnail_cache = std::make_unique<ThumbnailCache>(p_buffer_manager.get(), p_texture_manager.get());
 
-    p_render_pass = CreateRenderPass();
-    CreateFramebuffers();
+    m_colour_attachment_format = p_swapchain->GetSurfaceFormat().format;
+    m_depth_attachment_format = p_device->GetSelectedPhysicalDevice().m_depth_format;
+    p_upscale_sampler = p_buffer_manager->GetTextureSampler(VK_FILTER_LINEAR, VK_FILTER_LINEAR,
+                                                            VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE);
 
     SetClearColour({0.0f, 0.0f, 0.0f, 0.0f});
 }
 
-VkRenderPass Renderer::CreateRenderPass() const
-{
-    ENGINE_PROFILE_SCOPE("Create render passes");
-
-    VkAttachmentDescription colour_attachment_description{};
-    colour_attachment_description.flags = 0;
-    colour_attachment_description.format = p_swapchain->GetSurfaceFormat().format;
-    colour_attachment_description.samples = VK_SAMPLE_COUNT_1_BIT;
-    colour_attachment_description.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-    colour_attachment_description.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-    colour_attachment_description.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-    colour_attachment_description.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-    colour_attachment_description.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    colour_attachment_description.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-
-    constexpr VkAttachmentReference colour_attachment_reference{.attachment = 0,
-                                                                .layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
-
-    const VkFormat depth_format{p_device->GetSelectedPhysicalDevice().m_depth_format};
-
-    VkAttachmentDescription depth_attachment_description{};
-    depth_attachment_description.format = depth_format;
-    depth_attachment_description.samples = VK_SAMPLE_COUNT_1_BIT;
-    depth_attachment_description.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-    depth_attachment_description.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-    depth_attachment_description.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-    depth_attachment_description.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-    depth_attachment_description.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    depth_attachment_description.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
-
-    constexpr VkAttachmentReference depth_attachment_reference{
-        .attachment = 1, .layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL};
-
-    const Vector<VkSubpassDependency> subpass_dependencies{
-        {.srcSubpass = VK_SUBPASS_EXTERNAL,
-         .dstSubpass = 0,
-         .srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT,
-         .dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT,
-         .srcAccessMask = 0,
-         .dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
-         .dependencyFlags = 0}};
-
-    VkSubpassDescription subpass_description{};
-    subpass_description.flags = 0;
-    subpass_description.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
-    subpass_description.inputAttachmentCount = 0;
-    subpass_description.pInputAttachments = nullptr;
-    subpass_description.colorAttachmentCount = 1;
-    subpass_description.pColorAttachments = &colour_attachment_reference;
-    subpass_description.pResolveAttachments = nullptr;
-    subpass_description.pDepthStencilAttachment = &depth_attachment_reference;
-    subpass_description.preserveAttachmentCount = 0;
-    subpass_description.pPreserveAttachments = nullptr;
-
-    SmallVector<VkAttachmentDescription, 2> attachment_descriptions;
-    attachment_descriptions.push_back(colour_attachment_description);
-    attachment_descriptions.push_back(depth_attachment_description);
-
-    VkRenderPassCreateInfo render_pass_create_info{};
-    render_pass_create_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-    render_pass_create_info.pNext = nullptr;
-    render_pass_create_info.flags = 0;
-    render_pass_create_info.attachmentCount = static_cast<u32>(attachment_descriptions.size());
-    render_pass_create_info.pAttachments = attachment_descriptions.data();
-    render_pass_create_info.subpassCount = 1;
-    render_pass_create_info.pSubpasses = &subpass_description;
-    render_pass_create_info.dependencyCount = static_cast<u32>(subpass_dependencies.size());
-    render_pass_create_info.pDependencies = subpass_dependencies.data();
-
-    VkRenderPass render_pass{VK_NULL_HANDLE};
-    if (const VkResult result{
-            vkCreateRenderPass(p_device->GetDevice(), &render_pass_create_info, nullptr, &render_pass)};
-        result != VK_SUCCESS) {
-        CHECK_VK_RESULT(result, "vkCreateRenderPass\n");
-    }
-
-    ENGINE_LOG_DEBUG("Render pass created.");
-
-    return render_pass;
-}
-
-void Renderer::CreateFences()
-{
-    constexpr VkFenceCreateFlags fence_flags{VK_FENCE_CREATE_SIGNALED_BIT};
-
-    for (u32 i = 0; i < p_swapchain->GetImageCount(); i++) {
-        m_frame_fences.emplace_back(p_device.get()); // Construct the fence and pass the device
-        if (!m_frame_fences[i].Create(fence_flags)) {
-            ENGINE_THROW("Could not create frame fence {} in renderer.", i);
-        }
-    }
+VkPipelineRenderingCreateInfo Renderer::GetPipelineRenderingInfo() const
+{
+    // Only the depth aspect is attached, so the stencil format stays undefined even for combined formats
+    return {.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO,
+            .colorAttachmentCount = 1,
+            .pColorAttachmentFormats = &m_colour_attachment_format,
+            .depthAttachmentFormat = m_depth_attachment_format,
+            .stencilAttachmentFormat = VK_FORMAT_UNDEFINED};
+}
+
+VkCommandBufferInheritanceRenderingInfo Renderer::GetInheritanceRenderingInfo() const
+{
+    return {.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO,
+            .colorAttachmentCount = 1,
+            .pColorAttachmentFormats = &m_colour_attachment_format,
+            .depthAttachmentFormat = m_depth_attachment_format,
+            .stencilAttachmentFormat = VK_FORMAT_UNDEFINED,
+            .rasterizationSamples = VK_SAMPLE_COUNT_1_BIT};
+}
+
+void Renderer::CreateFrameSyncValues()
+{
+    m_frame_timeline_values.clear();
+    m_frame_timeline_values.resize(m_frames_in_flight, NO_TIMELINE_VALUE);
+
+    ResetImageSyncValues();
 
-    ENGINE_LOG_DEBUG("Frame fences created.");
+    ENGINE_LOG_DEBUG("Frame sync values created.");
+}
+
+void Renderer::ResetImageSyncValues()
+{
+    m_image_timeline_values.clear();
+    m_image_timeline_values.resize(p_swapchain->GetImageCount(), NO_TIMELINE_VALUE);
 }
 
 void Renderer::CacheFrameBufferSize()
@@ -773,44 +3048,167 @@ void Renderer::CacheFrameBufferSize()
 
 void Renderer::ReCreateSwapchain()
 {
-    DestroyFramebuffers();
-
-    p_swapchain->Recreate();
+    // Frames already submitted keep rendering to and presenting the old images, which go once those frames retire
+    const u64 timeline_value{m_queue.GetLastSubmittedValue()};
+    RetiredSwapchain retired_swapchain{p_swapchain->Recreate()};
     m_queue.SetSwapchain(p_swapchain.get());
+    ResetImageSyncValues();
     CacheFrameBufferSize();
-    p_depth_resources->Recreate();
+    m_imgui_dirty = true; // The last ImGui frame was laid out for the old size
+    DiscardRecordedFrames();
+    m_retired_swapchains.push_back({timeline_value, std::move(retired_swapchain), p_depth_resources->Recreate()});
+}
+
+void Renderer::CaptureScreenshot(const StringView filepath)
+{
+    if (!p_swapchain->CanReadBack()) {
+        ENGINE_LOG_WARNING("Cannot take screenshot '{}', the swapchain images cannot be copied from.", filepath);
+        return;
+    }
+    p_frame_capture->RequestScreenshot(String{filepath});
+}
+
+void Renderer::StartFrameCapture(const StringView directory)
+{
+    if (!p_swapchain->CanReadBack()) {
+        ENGINE_LOG_WARNING("Cannot capture frames to '{}', the swapchain images cannot be copied from.", directory);
+        return;
+    }
+    p_frame_capture->StartCapture(String{directory});
+}
+
+void Renderer::StopFrameCapture() { p_frame_capture->StopCapture(); }
 
-    CreateFramebuffers();
+bool Renderer::IsCapturingFrames() const { return p_frame_capture->IsCapturing(); }
+
+bool Renderer::WaitForLastPresent(const u64 timeout) const
+{
+    if (!p_swapchain->IsValid()) {
+        return false;
+    }
+    return p_device->WaitForPresent(*p_swapchain->Get(), m_queue.GetLastPresentId(), timeout);
 }
 
 void Renderer::CreateInstanceBuffers()
 {
-    const VkDeviceSize max_quad_instance_size{sizeof(InstanceData) * m_max_quad_instances};
-    const VkDeviceSize max_text_instance_size{sizeof(TextData) * m_max_text_instances};
+    const VkDeviceSize max_quad_instance_size{sizeof(QuadInstance) * m_max_quad_instances};
     const VkDeviceSize max_particle_instance_size{sizeof(ParticleData) * m_max_particle_instances};
 
-    m_quad_instance_buffers.resize(p_swapchain->GetImageCount());
-    m_text_instance_buffers.resize(p_swapchain->GetImageCount());
-    m_particle_storage_buffers.resize(p_swapchain->GetImageCount());
-    m_compute_uniform_buffers.resize(p_swapchain->GetImageCount());
-
-    m_mapped_quad_instance_data.resize(p_swapchain->GetImageCount());
-    m_mapped_text_instance_data.resize(p_swapchain->GetImageCount());
-    m_mapped_particle_storage_data.resize(p_swapchain->GetImageCount());
+    m_quad_instance_buffers.resize(m_frames_in_flight);
+    m_quad_indirect_buffers.resize(m_frames_in_flight);
+    m_particle_storage_buffers.resize(m_frames_in_flight);
+    m_particle_spawn_buffers.resize(m_frames_in_flight);
+    m_compacted_particle_buffers.resize(m_frames_in_flight);
+    m_particle_indirect_buffers.resize(m_frames_in_flight);
+    m_particle_collider_buffers.resize(m_frames_in_flight);
+    m_particle_collision_cell_buffers.resize(m_frames_in_flight);
+    m_particle_collider_frame_versions.assign(m_frames_in_flight, constants::u64_max);
+    m_compute_uniform_buffers.resize(m_frames_in_flight);
+    m_culled_quad_visible_buffers.resize(m_frames_in_flight);
+    m_cull_indirect_buffers.resize(m_frames_in_flight);
+    m_cull_uniform_buffers.resize(m_frames_in_flight);
+    m_light_uniform_buffers.resize(m_frames_in_flight);
+    m_light_buffers.resize(m_frames_in_flight);
+    m_light_tile_buffers.resize(m_frames_in_flight);
+    m_animation_clip_buffers.resize(m_frames_in_flight);
+    m_animation_frame_buffers.resize(m_frames_in_flight);
+    m_animation_frame_versions.assign(m_frames_in_flight, constants::u64_max);
+    m_render_target_instance_buffers.resize(m_frames_in_flight);
+    m_static_quad_staging_buffers.resize(m_frames_in_flight);
+    m_mapped_static_quad_staging_data.resize(m_frames_in_flight);
+
+    m_mapped_quad_instance_data.resize(m_frames_in_flight);
+    m_mapped_particle_storage_data.resize(m_frames_in_flight);
+    m_mapped_particle_spawn_data.resize(m_frames_in_flight);
+
+    // Particle simulation data is touched by both queues when async compute is available
+    SmallVector<u32, 2> particle_queue_families{p_device->GetQueueFamily()};
+    if (p_device->HasAsyncComputeQueue()) {
+        particle_queue_families.push_back(p_device->GetComputeQueueFamily());
+    }
 
-    for (size_t i = 0; i < p_swapchain->GetImageCount(); ++i) {
+    // The pool persists across frames and is only ever touched by the GPU
+    m_particle_pool_buffer = p_buffer_manager->CreateBuffer(max_particle_instance_size,
+                                                            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                                            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                                            particle_queue_families);
+    m_particle_pool_state_buffer = p_buffer_manager->CreateBuffer(
+        sizeof(u32) * (2 + static_cast<VkDeviceSize>(m_max_particle_instances)),
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        particle_queue_families);
+    m_reset_particle_pool = true;
+
+    // Static quads are drawn directly or read by the cull pass, and only written by copies on the graphics queue
+    // after a full upload
+    const VkDeviceSize max_static_quad_instance_size{sizeof(QuadInstance) * m_max_static_quad_instances};
+    m_static_quad_buffer = p_buffer_manager->CreateBuffer(max_static_quad_instance_size,
+                                                          VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                                                              VK_BUFFER_USAGE_VERTEX_BUFFER_BIT |
+                                                              VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                                          VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    m_cull_params.visible_capacity = m_max_static_quad_instances;
+
+    for (u32 i = 0; i < m_frames_in_flight; ++i) {
         m_quad_instance_buffers[i] = p_buffer_manager->CreateDynamicVertexBuffer(max_quad_instance_size);
-        m_mapped_quad_instance_data[i] = m_quad_instance_buffers[i].MapPersistent(p_device->GetDevice());
-
-        m_text_instance_buffers[i] = p_buffer_manager->CreateDynamicVertexBuffer(max_text_instance_size);
-        m_mapped_text_instance_data[i] = m_text_instance_buffers[i].MapPersistent(p_device->GetDevice());
+        m_mapped_quad_instance_data[i] = m_quad_instance_buffers[i].GetMapped();
+        m_quad_indirect_buffers[i] = p_buffer_manager->CreateDynamicIndirectBuffer(
+            sizeof(VkDrawIndirectCommand) * RenderQueue::MAX_BATCH_COUNT);
 
         // Create storage buffer with vertex buffer usage
-        m_particle_storage_buffers[i] =
-            p_buffer_manager->CreateStorageBuffer(max_particle_instance_size, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
-        m_mapped_particle_storage_data[i] = m_particle_storage_buffers[i].MapPersistent(p_device->GetDevice());
-
-        m_compute_uniform_buffers[i] = p_buffer_manager->CreateUniformBuffer(sizeof(SimulationParams));
+        m_particle_storage_buffers[i] = p_buffer_manager->CreateStorageBuffer(
+            max_particle_instance_size, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, particle_queue_families);
+        m_mapped_particle_storage_data[i] = m_particle_storage_buffers[i].GetMapped();
+
+        m_particle_spawn_buffers[i] = p_buffer_manager->CreateStorageBuffer(
+            sizeof(ParticleData) * MAX_PARTICLE_SPAWNS_PER_FRAME, 0, particle_queue_families);
+        m_mapped_particle_spawn_data[i] = m_particle_spawn_buffers[i].GetMapped();
+
+        // Compaction output is only touched by the GPU
+        m_compacted_particle_buffers[i] = p_buffer_manager->CreateBuffer(
+            max_particle_instance_size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, particle_queue_families);
+        m_particle_indirect_buffers[i] = p_buffer_manager->CreateBuffer(
+            sizeof(VkDrawIndexedIndirectCommand),
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, particle_queue_families);
+
+        m_compute_uniform_buffers[i] =
+            p_buffer_manager->CreateUniformBuffer(sizeof(SimulationParams), particle_queue_families);
+        m_particle_collider_buffers[i] = p_buffer_manager->CreateStorageBuffer(
+            sizeof(math::AABB2D) * MAX_PARTICLE_COLLIDERS, 0, particle_queue_families);
+        m_particle_collision_cell_buffers[i] = p_buffer_manager->CreateStorageBuffer(
+            sizeof(u32) * (MAX_PARTICLE_COLLISION_CELLS + 1 + MAX_PARTICLE_COLLISION_ENTRIES), 0,
+            particle_queue_families);
+
+        // A region of every static quad per viewport, each viewport culls into its own
+        m_culled_quad_visible_buffers[i] = p_buffer_manager->CreateBuffer(
+            max_static_quad_instance_size * MAX_VIEWPORTS,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        m_cull_indirect_buffers[i] = p_buffer_manager->CreateBuffer(
+            sizeof(VkDrawIndirectCommand) * MAX_VIEWPORTS,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        m_cull_uniform_buffers[i] = p_buffer_manager->CreateUniformBuffer(sizeof(CullParams));
+
+        m_light_uniform_buffers[i] = p_buffer_manager->CreateUniformBuffer(sizeof(LightParams));
+        m_light_buffers[i] = p_buffer_manager->CreateStorageBuffer(sizeof(PointLight) * MAX_LIGHTS);
+        m_light_tile_buffers[i] = p_buffer_manager->CreateBuffer(sizeof(u32) * LIGHT_TILE_STRIDE * MAX_LIGHT_TILES,
+                                                                 VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                                                 VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+        m_animation_clip_buffers[i] = p_buffer_manager->CreateStorageBuffer(
+            sizeof(AnimationHeader) + sizeof(AnimationClipData) * MAX_ANIMATION_CLIPS);
+        m_animation_frame_buffers[i] =
+            p_buffer_manager->CreateStorageBuffer(sizeof(AnimationFrameData) * MAX_ANIMATION_FRAMES);
+
+        m_render_target_instance_buffers[i] =
+            p_buffer_manager->CreateDynamicVertexBuffer(sizeof(QuadInstance) * MAX_RENDER_TARGET_QUADS_PER_FRAME);
+
+        m_static_quad_staging_buffers[i] = p_buffer_manager->CreateBuffer(
+            sizeof(QuadInstance) * MAX_STATIC_QUAD_UPDATES_PER_FRAME, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+        m_mapped_static_quad_staging_data[i] = m_static_quad_staging_buffers[i].GetMapped();
     }
 }
 
@@ -837,8 +3235,8 @@ void Renderer::InitializeImGUIIfEnabled()
                                                 {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1000},
                                                 {VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER, 1000},
                                                 {VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER, 1000},
-                                                {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1000},
-                                                {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1000},
+                                                {1000},
+                                                {1000},
                                                 {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1000},
                                                 {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 1000},
                                                 {VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, 1000}};
@@ -865,9 +3263,10 @@ void Renderer::InitializeImGUIIfEnabled()
     init_info.Device = p_device->GetDevice();
     init_info.QueueFamily = p_device->GetQueueFamily();
     init_info.Queue = graphics_queue;
-    init_info.PipelineCache = VK_NULL_HANDLE;
+    init_info.PipelineCache = p_pipeline_cache->GetCache();
     init_info.DescriptorPool = p_imgui_pool;
-    init_info.RenderPass = p_render_pass;
+    init_info.UseDynamicRendering = true;
+    init_info.PipelineRenderingCreateInfo = GetPipelineRenderingInfo();
     init_info.Allocator = nullptr;
     init_info.MinImageCount = min_image_count;
     init_info.ImageCount = p_swapchain->GetImageCount();
@@ -879,16 +3278,38 @@ void Renderer::InitializeImGUIIfEnabled()
 #endif
 }
 
-ImDrawData *Renderer::RenderImGUI() const
+void Renderer::BuildDebugUI()
+{
+#ifdef USE_IMGUI
+    p_prebuilt_imgui_draw_data = RenderImGUI();
+    m_is_imgui_prebuilt = true;
+#endif
+}
+
+ImDrawData *Renderer::RenderImGUI()
 {
 #ifdef USE_IMGUI
+    if (!m_debug_ui_visible) {
+        m_imgui_dirty = true;
+        return nullptr;
+    }
+
+    // Hovering or typing into a window updates it every frame, otherwise the stats are refreshed at a readable rate
+    // and the frames in between draw the last ImGui frame again
+    const SteadyClock::time_point now{SteadyClock::now()};
+    const ImGuiIO &io{ImGui::GetIO()};
+    if (!m_imgui_dirty && p_imgui_draw_data && !io.WantCaptureMouse && !io.WantCaptureKeyboard &&
+        now - m_imgui_build_time < DEBUG_UI_REFRESH_INTERVAL) {
+        return p_imgui_draw_data;
+    }
+    m_imgui_dirty = false;
+    m_imgui_build_time = now;
+
     ImGui_ImplVulkan_NewFrame();
     ImGui_ImplGlfw_NewFrame();
     ImGui::NewFrame();
 
     static int location{0};
-    static bool open{true};
-    const ImGuiIO &io{ImGui::GetIO()};
     ImGuiWindowFlags window_flags{ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_AlwaysAutoResize |
                                   ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoFocusOnAppearing |
                                   ImGuiWindowFlags_NoNav};
@@ -911,7 +3332,7 @@ ImDrawData *Renderer::RenderImGUI() const
         window_flags |= ImGuiWindowFlags_NoMove;
     }
     ImGui::SetNextWindowBgAlpha(0.35f);
-    if (ImGui::Begin("Stats for nerds", &open, window_flags)) {
+    if (ImGui::Begin("Stats for nerds", nullptr, window_flags)) {
 
         ImGui::Text("Stats for nerds.");
         ImGui::Separator();
@@ -919,14 +3340,36 @@ ImDrawData *Renderer::RenderImGUI() const
         ImGui::Text("FPS: %f", m_render_statistics.delta_time > 0.0f ? 1.0f / m_render_statistics.delta_time : 0.0f);
         ImGui::Separator();
         ImGui::Text("Quads: %u / %u", m_render_statistics.quad_count, m_max_quad_instances);
+        ImGui::Text("Quad batches: %u", m_render_statistics.quad_draw_count);
+        ImGui::Text("Static quads: %u (uploaded: %u)", m_render_statistics.static_quad_count,
+                    m_render_statistics.static_quad_update_count);
+        ImGui::Text("Tiles: %u (chunks visible: %u / %u)", m_render_statistics.tile_count,
+                    m_render_statistics.visible_tile_chunk_count, m_render_statistics.tile_chunk_count);
+        ImGui::Text("Viewports: %u / %u", m_render_statistics.viewport_count, MAX_VIEWPORTS);
         ImGui::Text("Vertices: %u (per instance: %u)", m_render_statistics.vertex_count * m_render_statistics.quad_count, m_render_statistics.vertex_count);
         ImGui::Text("Indices: %u (per instance: %u)", m_render_statistics.index_count * m_render_statistics.quad_count, m_render_statistics.index_count);
         ImGui::Text("Particles: %u", m_render_statistics.particle_count);
+        ImGui::Text("Particle spawns: %u", m_render_statistics.particle_spawn_count);
+        ImGui::Text("Lights: %u / %u", m_render_statistics.light_count, MAX_LIGHTS);
+        ImGui::Text("Render target updates: %u", m_render_statistics.render_target_update_count);
+        ImGui::Text("Render scale: %.2f", static_cast<f64>(m_render_statistics.render_scale));
         ImGui::Text("Glyphs: %u", m_render_statistics.glyph_count);
+        ImGui::Text("Cached glyphs: %u / %u", m_render_statistics.cached_glyph_count,
+                    GlyphCache::CELLS_PER_PAGE * GlyphCache::MAX_PAGE_COUNT);
+        ImGui::Text("Thumbnails: %u / %u", m_render_statistics.thumbnail_count,
+                    ThumbnailCache::CELLS_PER_PAGE * ThumbnailCache::MAX_PAGE_COUNT);
+        ImGui::Text("Debug draw instances: %u", m_render_statistics.debug_draw_count);
         ImGui::Text("Total instances: %u", m_render_statistics.total_instances);
         ImGui::Text("Textures: %u", m_render_statistics.texture_count);
         ImGui::Text("Fonts: %u", m_render_statistics.font_count);
-        ImGui::Text("Compute: %u", m_use_compute_particles);
+        ImGui::Text("Compute: %u (async: %u)", m_use_compute_particles, m_use_async_compute);
+        ImGui::Separator();
+        ImGui::Text("Memory blocks: %u (dedicated: %u)", m_render_statistics.memory.block_count,
+                    m_render_statistics.memory.dedicated_allocation_count);
+        ImGui::Text("Memory used: %.2f MiB / free: %.2f MiB",
+                    static_cast<f64>(m_render_statistics.memory.used_bytes) / (1024.0 * 1024.0),
+                    static_cast<f64>(m_render_statistics.memory.free_bytes) / (1024.0 * 1024.0));
+        ImGui::Text("Memory fragmentation: %.1f%%", static_cast<f64>(m_render_statistics.memory.fragmentation) * 100.0);
         ImGui::Separator();
 
         if (ImGui::IsMousePosValid()) {
@@ -949,16 +3392,18 @@ ImDrawData *Renderer::RenderImGUI() const
                 location = 2;
             if (ImGui::MenuItem("Bottom-right", nullptr, location == 3))
                 location = 3;
-            if (open && ImGui::MenuItem("Close"))
-                open = false;
+            if (ImGui::MenuItem("Close"))
+                m_debug_ui_visible = false;
             ImGui::EndPopup();
         }
     }
     ImGui::End();
 
+    gouda::internal::profiler::DrawProfilerView();
+
     ImGui::Render();
-    ImDrawData *draw_data{ImGui::GetDrawData()};
-    return draw_data;
+    p_imgui_draw_data = ImGui::GetDrawData();
+    return p_imgui_draw_data;
 #else
     return nullptr;
 #endif
@@ -976,27 +3421,37 @@ void Renderer::DestroyImGUI() const
 #endif
 }
 
-void Renderer::UpdateTextureDescriptors()
+void Renderer::UpdateTextureDescriptors(const u32 frame_index)
 {
+    // Every slot gets the changed ids, but only the slot that just retired is written. The others may still be read by
+    // their frames, a reloaded texture keeps its slot and its old image stays alive until they complete.
     if (p_texture_manager->IsDirty()) {
-        p_quad_pipeline->UpdateTextureDescriptors(p_swapchain->GetImageCount(), p_texture_manager->GetTextures());
-        p_particle_pipeline->UpdateTextureDescriptors(p_swapchain->GetImageCount(), p_texture_manager->GetTextures());
+        for (Vector<u32> &pending : m_pending_texture_descriptors) {
+            for (const u32 texture_id : p_texture_manager->GetDirtyTextureIds()) {
+                pending.push_back(texture_id);
+            }
+        }
         p_texture_manager->SetClean();
     }
 
-    if (m_font_textures_dirty) {
-        p_text_pipeline->UpdateFontTextureDescriptors(p_swapchain->GetImageCount(), m_font_textures);
-        m_font_textures_dirty = false;
+    Vector<u32> &texture_ids{m_pending_texture_descriptors[frame_index]};
+    if (!texture_ids.empty()) {
+        std::ranges::sort(texture_ids);
+        texture_ids.erase(std::ranges::unique(texture_ids).begin(), texture_ids.end());
+        const Vector<std::unique_ptr<Texture>> &textures{p_texture_manager->GetTextures()};
+        p_quad_pipeline->UpdateFrameTextureDescriptors(frame_index, textures, texture_ids);
+        p_quad_alpha_test_pipeline->UpdateFrameTextureDescriptors(frame_index, textures, texture_ids);
+        p_quad_transparent_pipeline->UpdateFrameTextureDescriptors(frame_index, textures, texture_ids);
+        p_particle_pipeline->UpdateFrameTextureDescriptors(frame_index, textures, texture_ids);
+        for (const std::unique_ptr<GraphicsPipeline> &variant : m_pipeline_variants) {
+            variant->UpdateFrameTextureDescriptors(frame_index, textures, texture_ids);
+        }
+        texture_ids.clear();
     }
 }
 
 void Renderer::DestroyBuffers()
 {
-    for (auto &buffer : m_uniform_buffers) {
-        buffer.Destroy(p_device->GetDevice());
-    }
-    ENGINE_LOG_DEBUG("Uniform buffers destroyed.");
-
     for (auto &buffer : m_compute_uniform_buffers) {
         buffer.Destroy(p_device->GetDevice());
     }
@@ -1005,17 +3460,82 @@ void Renderer::DestroyBuffers()
     for (auto &buffer : m_quad_instance_buffers) {
         buffer.Destroy(p_device->GetDevice());
     }
-    ENGINE_LOG_DEBUG("Quad instance buffers destroyed.");
-
-    for (auto &buffer : m_text_instance_buffers) {
+    for (auto &buffer : m_quad_indirect_buffers) {
         buffer.Destroy(p_device->GetDevice());
     }
-    ENGINE_LOG_DEBUG("Text instance buffers destroyed.");
+    ENGINE_LOG_DEBUG("Quad instance buffers destroyed.");
+
     for (auto &buffer : m_particle_storage_buffers) {
         buffer.Destroy(p_device->GetDevice());
     }
     ENGINE_LOG_DEBUG("Particle storage buffers destroyed.");
 
+    for (auto &buffer : m_particle_spawn_buffers) {
+        buffer.Destroy(p_device->GetDevice());
+    }
+    m_particle_pool_buffer.Destroy(p_device->GetDevice());
+    m_particle_pool_state_buffer.Destroy(p_device->GetDevice());
+    ENGINE_LOG_DEBUG("Particle pool buffers destroyed.");
+
+    for (auto &buffer : m_compacted_particle_buffers) {
+        buffer.Destroy(p_device->GetDevice());
+    }
+    for (auto &buffer : m_particle_indirect_buffers) {
+        buffer.Destroy(p_device->GetDevice());
+    }
+    ENGINE_LOG_DEBUG("Particle compaction buffers destroyed.");
+
+    for (auto &buffer : m_particle_collider_buffers) {
+        buffer.Destroy(p_device->GetDevice());
+    }
+    for (auto &buffer : m_particle_collision_cell_buffers) {
+        buffer.Destroy(p_device->GetDevice());
+    }
+    ENGINE_LOG_DEBUG("Particle collision buffers destroyed.");
+
+    m_static_quad_buffer.Destroy(p_device->GetDevice());
+    m_tile_buffer.Destroy(p_device->GetDevice());
+    for (auto &buffer : m_static_quad_staging_buffers) {
+        buffer.Destroy(p_device->GetDevice());
+    }
+    for (auto &buffer : m_culled_quad_visible_buffers) {
+        buffer.Destroy(p_device->GetDevice());
+    }
+    for (auto &buffer : m_cull_indirect_buffers) {
+        buffer.Destroy(p_device->GetDevice());
+    }
+    for (auto &buffer : m_cull_uniform_buffers) {
+        buffer.Destroy(p_device->GetDevice());
+    }
+    ENGINE_LOG_DEBUG("Static quad buffers destroyed.");
+
+    for (auto &buffer : m_light_uniform_buffers) {
+        buffer.Destroy(p_device->GetDevice());
+    }
+    for (auto &buffer : m_light_buffers) {
+        buffer.Destroy(p_device->GetDevice());
+    }
+    for (auto &buffer : m_light_tile_buffers) {
+        buffer.Destroy(p_device->GetDevice());
+    }
+    ENGINE_LOG_DEBUG("Light buffers destroyed.");
+
+    for (auto &buffer : m_animation_clip_buffers) {
+        buffer.Destroy(p_device->GetDevice());
+    }
+    for (auto &buffer : m_animation_frame_buffers) {
+        buffer.Destroy(p_device->GetDevice());
+    }
+    ENGINE_LOG_DEBUG("Animation buffers destroyed.");
+
+    for (auto &buffer : m_render_target_instance_buffers) {
+        buffer.Destroy(p_device->GetDevice());
+    }
+    for (auto &target : m_render_targets) {
+        target.depth_image.Destroy(p_device.get());
+    }
+    ENGINE_LOG_DEBUG("Render target resources destroyed.");
+
     if (p_quad_vertex_buffer != nullptr) {
         p_quad_vertex_buffer->Destroy(p_device->GetDevice());
         ENGINE_LOG_DEBUG("Quad vertex buffer destroyed.");
@@ -0,0 +1,76 @@
+/**
+ * @file vk_sampler_cache.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine vulkan sampler cache implementation
+ */
+#include "renderers/vulkan/vk_sampler_cache.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#include "debug/logger.hpp"
+#include "debug/throw.hpp"
+
+namespace gouda::vk {
+
+SamplerCache::SamplerCache(const VkDevice device) : p_device{device}, m_hit_count{0} {}
+
+SamplerCache::~SamplerCache()
+{
+    for (const Entry &entry : m_samplers) {
+        vkDestroySampler(p_device, entry.p_sampler, nullptr);
+    }
+    ENGINE_LOG_DEBUG("Sampler cache destroyed with {} samplers, {} requests shared one.", m_samplers.size(),
+                     m_hit_count);
+}
+
+VkSampler SamplerCache::Get(const SamplerState &state)
+{
+    std::scoped_lock lock{m_mutex};
+    if (const auto entry{std::ranges::find(m_samplers, state, &Entry::state)}; entry != m_samplers.end()) {
+        ++m_hit_count;
+        return entry->p_sampler;
+    }
+
+    const VkSamplerCreateInfo sampler_info{.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
+                                           .magFilter = state.mag_filter,
+                                           .minFilter = state.min_filter,
+                                           .mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR,
+                                           .addressModeU = state.address_mode,
+                                           .addressModeV = state.address_mode,
+                                           .addressModeW = state.address_mode,
+                                           .mipLodBias = 0.0f,
+                                           .anisotropyEnable = VK_FALSE,
+                                           .maxAnisotropy = 1.0f,
+                                           .compareEnable = VK_FALSE,
+                                           .compareOp = VK_COMPARE_OP_ALWAYS,
+                                           .minLod = 0.0f,
+                                           .maxLod = VK_LOD_CLAMP_NONE,
+                                           .borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK,
+                                           .unnormalizedCoordinates = VK_FALSE};
+
+    VkSampler sampler{VK_NULL_HANDLE};
+    if (const VkResult result{vkCreateSampler(p_device, &sampler_info, nullptr, &sampler)}; result != VK_SUCCESS) {
+        ENGINE_THROW("Failed to create texture sampler in SamplerCache");
+    }
+    m_samplers.push_back(Entry{state, sampler});
+    ENGINE_LOG_DEBUG("Sampler {} created, filters {}/{}, address mode {}.", m_samplers.size(),
+                     std::to_underlying(state.min_filter), std::to_underlying(state.mag_filter),
+                     std::to_underlying(state.address_mode));
+    return sampler;
+}
+
+size_t SamplerCache::GetSamplerCount() const
+{
+    std::scoped_lock lock{m_mutex};
+    return m_samplers.size();
+}
+
+u64 SamplerCache::GetHitCount() const
+{
+    std::scoped_lock lock{m_mutex};
+    return m_hit_count;
+}
+
+} // namespace gouda::vk
@@ -14,14 +14,14 @@
 
 namespace gouda::vk {
 
-Semaphore::Semaphore(Device *device) : p_semaphore{VK_NULL_HANDLE}, p_device{device}
+Semaphore::Semaphore(Device *device) : p_semaphore{VK_NULL_HANDLE}, p_device{device}, m_type{VK_SEMAPHORE_TYPE_BINARY}
 {
     ASSERT(device, "Device cannot be a null pointer when creating a semaphore.");
 }
 
 Semaphore::~Semaphore() { Destroy(); }
 
-bool Semaphore::Create()
+bool Semaphore::Create(const VkSemaphoreType type, const u64 initial_value)
 {
     if (!p_device) {
         ENGINE_LOG_ERROR("Cannot create a semaphore with an invalid/null device pointer.");
@@ -33,8 +33,14 @@ bool Semaphore::Create()
         return false;
     }
 
+    const VkSemaphoreTypeCreateInfo type_create_info{.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+                                                     .pNext = nullptr,
+                                                     .semaphoreType = type,
+                                                     .initialValue = initial_value};
+
     VkSemaphoreCreateInfo semaphore_create_info{};
     semaphore_create_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    semaphore_create_info.pNext = &type_create_info;
 
     if (const VkResult result{vkCreateSemaphore(p_device->GetDevice(), &semaphore_create_info, nullptr, &p_semaphore)};
         result != VK_SUCCESS) {
@@ -42,9 +48,59 @@ bool Semaphore::Create()
         return false;
     }
 
+    m_type = type;
+
     return true;
 }
 
+u64 Semaphore::GetCounterValue() const
+{
+    ASSERT(IsTimeline(), "Only timeline semaphores have a counter value.");
+
+    u64 value{0};
+    if (const VkResult result{vkGetSemaphoreCounterValue(p_device->GetDevice(), p_semaphore, &value)};
+        result != VK_SUCCESS) {
+        CHECK_VK_RESULT(result, "vkGetSemaphoreCounterValue");
+    }
+
+    return value;
+}
+
+bool Semaphore::Wait(const u64 value, const u64 timeout) const
+{
+    ASSERT(IsTimeline(), "Only timeline semaphores can be waited on from the host.");
+
+    const VkSemaphoreWaitInfo wait_info{.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+                                        .pNext = nullptr,
+                                        .flags = 0,
+                                        .semaphoreCount = 1,
+                                        .pSemaphores = &p_semaphore,
+                                        .pValues = &value};
+
+    const VkResult result{vkWaitSemaphores(p_device->GetDevice(), &wait_info, timeout)};
+    if (result == VK_TIMEOUT) {
+        return false;
+    }
+
+    if (result != VK_SUCCESS) {
+        CHECK_VK_RESULT(result, "vkWaitSemaphores");
+    }
+
+    return result == VK_SUCCESS;
+}
+
+void Semaphore::Signal(const u64 value) const
+{
+    ASSERT(IsTimeline(), "Only timeline semaphores can be signalled from the host.");
+
+    const VkSemaphoreSignalInfo signal_info{
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SIGNAL_INFO, .pNext = nullptr, .semaphore = p_semaphore, .value = value};
+
+    if (const VkResult result{vkSignalSemaphore(p_device->GetDevice(), &signal_info)}; result != VK_SUCCESS) {
+        CHECK_VK_RESULT(result, "vkSignalSemaphore");
+    }
+}
+
 void Semaphore::Destroy()
 {
     if (p_device && p_semaphore != VK_NULL_HANDLE) {
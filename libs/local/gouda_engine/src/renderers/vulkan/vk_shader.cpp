@@ -7,7 +7,10 @@
 #include "renderers/vulkan/vk_shader.hpp"
 
 #include <cstring>
+#include <format>
 #include <ranges>
+#include <span>
+#include <type_traits>
 #include <utility>
 
 #include <glslang/Include/glslang_c_interface.h>
@@ -21,6 +24,8 @@
 #include "renderers/vulkan/vk_device.hpp"
 #include "renderers/vulkan/vk_utils.hpp"
 #include "utils/filesystem.hpp"
+#include "utils/hash.hpp"
+#include "utils/mapped_file.hpp"
 
 namespace std {
 // Hash function for std::pair
@@ -211,13 +216,13 @@ void print_shader_source(std::string_view text) noexcept
     ENGINE_LOG_INFO("--------------------------------------");
 }
 
-ShaderReflection reflect_shader(const std::vector<u32> &spirv, VkShaderStageFlagBits stage)
+ShaderReflection reflect_shader(const std::span<const u32> spirv, VkShaderStageFlagBits stage)
 {
     ShaderReflection reflection;
     reflection.entry_point = "main";
 
     try {
-        spirv_cross::Compiler compiler(spirv);
+        spirv_cross::Compiler compiler(spirv.data(), spirv.size());
         spirv_cross::ShaderResources resources{compiler.get_shader_resources()};
 
         // Get the shaders entry
@@ -235,6 +240,7 @@ ShaderReflection reflect_shader(const std::vector<u32> &spirv, VkShaderStageFlag
             binding.stage_flags = stage;
             const auto &type_info = compiler.get_type(resource.type_id);
             binding.count = type_info.array.empty() ? 1 : type_info.array[0];
+            binding.is_runtime_array = !type_info.array.empty() && type_info.array[0] == 0;
 
             // Basic validation
             if (binding.set == ~0u || binding.binding == ~0u) {
@@ -253,7 +259,8 @@ ShaderReflection reflect_shader(const std::vector<u32> &spirv, VkShaderStageFlag
             }
 
             // Validate array size for samplers
-            if (binding.type == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER && binding.count > MAX_TEXTURES) {
+            if (binding.type == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER && !binding.is_runtime_array &&
+                binding.count > MAX_TEXTURES) {
                 ENGINE_LOG_WARNING("Descriptor binding '{}' in stage {} has count={} exceeding MAX_TEXTURES={}",
                                    binding.name.empty() ? "(unnamed)" : binding.name,
                                    vk_shader_stage_as_string_view(stage), binding.count, MAX_TEXTURES);
@@ -349,6 +356,13 @@ ShaderReflection reflect_shader(const std::vector<u32> &spirv, VkShaderStageFlag
             reflection.specialization_constants.push_back(constant);
         }
 
+        // Workgroup size, compute dispatches are sized from it
+        if (stage == VK_SHADER_STAGE_COMPUTE_BIT) {
+            for (u32 i = 0; i < 3; ++i) {
+                reflection.local_size[i] = compiler.get_execution_mode_argument(spv::ExecutionModeLocalSize, i);
+            }
+        }
+
         // Vertex Inputs
         if (stage == VK_SHADER_STAGE_VERTEX_BIT) {
             for (const auto &input : resources.stage_inputs) {
@@ -375,6 +389,22 @@ ShaderReflection reflect_shader(const std::vector<u32> &spirv, VkShaderStageFlag
     return reflection;
 }
 
+// Keys what is built from a module, such as pipeline library parts, by content rather than by Shader address
+u64 shader_code_hash(const VkShaderStageFlagBits stage, const std::span<const u32> spirv)
+{
+    return utils::fnv1a(std::as_bytes(spirv), utils::mix64(static_cast<u64>(stage)));
+}
+
+VkResult create_shader_module(const VkDevice device, const std::span<const u32> spirv, VkShaderModule &shader_module)
+{
+    VkShaderModuleCreateInfo shader_create_info{};
+    shader_create_info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    shader_create_info.codeSize = spirv.size_bytes();
+    shader_create_info.pCode = spirv.data();
+
+    return vkCreateShaderModule(device, &shader_create_info, nullptr, &shader_module);
+}
+
 size_t compile_shader(const VkDevice device, const glslang_stage_t stage, StringView shader_code,
                       ShaderModule &shader_module) noexcept
 {
@@ -425,12 +455,7 @@ size_t compile_shader(const VkDevice device, const glslang_stage_t stage, String
         ENGINE_LOG_ERROR("Shader error message: {}", spirv_messages);
     }
 
-    VkShaderModuleCreateInfo shader_create_info{};
-    shader_create_info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-    shader_create_info.codeSize = shader_module.m_spirv.size() * sizeof(u32);
-    shader_create_info.pCode = shader_module.m_spirv.data();
-
-    if (const VkResult result{vkCreateShaderModule(device, &shader_create_info, nullptr, &shader_module.p_shader_module)};
+    if (const VkResult result{create_shader_module(device, shader_module.m_spirv, shader_module.p_shader_module)};
         result != VK_SUCCESS) {
         ENGINE_LOG_ERROR("vkCreateShaderModule failed: {}", vk_result_to_string(result));
         return 0;
@@ -439,6 +464,269 @@ size_t compile_shader(const VkDevice device, const glslang_stage_t stage, String
     return shader_module.m_spirv.size();
 }
 
+// SPIR-V cache ----------------------------------------------------------------------------------
+// Runtime compiled GLSL is cached by a hash of its source and the compile settings, together with its reflection, so
+// unchanged shaders skip both glslang and SPIRV-Cross. The source is the complete compiler input: the runtime path
+// has no include callbacks or injected defines, those have to be folded into the key once it gets them.
+
+// "GSPV", bump SHADER_CACHE_VERSION whenever the file layout, the reflection data or the compile settings change
+constexpr u32 SHADER_CACHE_MAGIC{0x56505347};
+constexpr u32 SHADER_CACHE_VERSION{2};
+constexpr StringView SHADER_CACHE_DIRECTORY{"cache/shaders"};
+
+struct ShaderCacheHeader {
+    u32 magic;
+    u32 version;
+    u64 key;
+    u64 payload_size;
+    u64 checksum; // FNV-1a of the payload
+};
+
+static_assert(std::is_trivially_copyable_v<ShaderCacheHeader>);
+
+u64 shader_cache_key(const glslang_stage_t stage, const StringView shader_code)
+{
+    // Matches the glslang_input_t set up in compile_shader
+    const String settings{std::format("stage={};client=vulkan1.1;target=spv1.3;version={}",
+                                      static_cast<int>(stage), SHADER_CACHE_VERSION)};
+    return utils::fnv1a(shader_code, utils::fnv1a(settings));
+}
+
+String shader_cache_path(const u64 key) { return std::format("{}/{:016x}.bin", SHADER_CACHE_DIRECTORY, key); }
+
+class CacheWriter {
+public:
+    template <typename T>
+        requires std::is_trivially_copyable_v<T>
+    void Write(const T &value)
+    {
+        const auto *bytes{reinterpret_cast<const std::byte *>(&value)};
+        m_data.insert(m_data.end(), bytes, bytes + sizeof(T));
+    }
+
+    void Write(const StringView text)
+    {
+        Write(static_cast<u32>(text.size()));
+        const auto *bytes{reinterpret_cast<const std::byte *>(text.data())};
+        m_data.insert(m_data.end(), bytes, bytes + text.size());
+    }
+
+    template <typename T>
+        requires std::is_trivially_copyable_v<T>
+    void Write(const std::span<const T> values)
+    {
+        Write(static_cast<u32>(values.size()));
+        const auto *bytes{reinterpret_cast<const std::byte *>(values.data())};
+        m_data.insert(m_data.end(), bytes, bytes + values.size_bytes());
+    }
+
+    [[nodiscard]] std::vector<std::byte> &Data() noexcept { return m_data; }
+
+private:
+    std::vector<std::byte> m_data;
+};
+
+// Every read is bounds checked, a truncated or corrupt payload only flips the failed flag
+class CacheReader {
+public:
+    explicit CacheReader(const std::span<const std::byte> data) : m_data{data}, m_offset{0}, m_failed{false} {}
+
+    template <typename T>
+        requires std::is_trivially_copyable_v<T>
+    void Read(T &value)
+    {
+        if (const std::span<const std::byte> bytes{Take(sizeof(T))}; !bytes.empty()) {
+            std::memcpy(&value, bytes.data(), sizeof(T));
+        }
+    }
+
+    void Read(std::string &text)
+    {
+        u32 size{0};
+        Read(size);
+        const std::span<const std::byte> bytes{Take(size)};
+        text.assign(reinterpret_cast<const char *>(bytes.data()), bytes.size());
+    }
+
+    template <typename T>
+        requires std::is_trivially_copyable_v<T>
+    void Read(std::vector<T> &values)
+    {
+        u32 count{0};
+        Read(count);
+        const std::span<const std::byte> bytes{Take(static_cast<size_t>(count) * sizeof(T))};
+        values.resize(bytes.size() / sizeof(T));
+        if (!bytes.empty()) {
+            std::memcpy(values.data(), bytes.data(), bytes.size());
+        }
+    }
+
+    // Element counts of the reflection arrays, rejected early so a corrupt count cannot trigger a huge allocation
+    [[nodiscard]] u32 ReadCount()
+    {
+        u32 count{0};
+        Read(count);
+        if (count > m_data.size() - m_offset) {
+            m_failed = true;
+            return 0;
+        }
+        return count;
+    }
+
+    [[nodiscard]] bool IsValid() const noexcept { return !m_failed && m_offset == m_data.size(); }
+
+private:
+    [[nodiscard]] std::span<const std::byte> Take(const size_t size)
+    {
+        if (m_failed || size > m_data.size() - m_offset) {
+            m_failed = true;
+            return {};
+        }
+        const std::span<const std::byte> bytes{m_data.subspan(m_offset, size)};
+        m_offset += size;
+        return bytes;
+    }
+
+private:
+    std::span<const std::byte> m_data;
+    size_t m_offset;
+    bool m_failed;
+};
+
+void write_reflection(CacheWriter &writer, const ShaderReflection &reflection)
+{
+    writer.Write(static_cast<u32>(reflection.descriptor_bindings.size()));
+    for (const ShaderDescriptorBinding &binding : reflection.descriptor_bindings) {
+        writer.Write(StringView{binding.name});
+        writer.Write(binding.set);
+        writer.Write(binding.binding);
+        writer.Write(binding.type);
+        writer.Write(binding.stage_flags);
+        writer.Write(binding.count);
+        writer.Write(static_cast<u8>(binding.is_runtime_array));
+    }
+
+    writer.Write(std::span<const ShaderPushConstantRange>{reflection.push_constants});
+
+    writer.Write(static_cast<u32>(reflection.specialization_constants.size()));
+    for (const ShaderSpecializationConstant &constant : reflection.specialization_constants) {
+        writer.Write(constant.constant_id);
+        writer.Write(StringView{constant.name});
+        writer.Write(constant.type);
+        writer.Write(std::span<const u8>{constant.default_value});
+    }
+
+    writer.Write(static_cast<u32>(reflection.vertex_inputs.size()));
+    for (const ShaderVertexInput &input : reflection.vertex_inputs) {
+        writer.Write(input.location);
+        writer.Write(StringView{input.name});
+        writer.Write(input.format);
+        writer.Write(input.input_rate);
+    }
+
+    writer.Write(reflection.local_size);
+    writer.Write(StringView{reflection.entry_point});
+}
+
+void read_reflection(CacheReader &reader, ShaderReflection &reflection)
+{
+    reflection.descriptor_bindings.resize(reader.ReadCount());
+    for (ShaderDescriptorBinding &binding : reflection.descriptor_bindings) {
+        u8 is_runtime_array{0};
+        reader.Read(binding.name);
+        reader.Read(binding.set);
+        reader.Read(binding.binding);
+        reader.Read(binding.type);
+        reader.Read(binding.stage_flags);
+        reader.Read(binding.count);
+        reader.Read(is_runtime_array);
+        binding.is_runtime_array = is_runtime_array != 0;
+    }
+
+    reader.Read(reflection.push_constants);
+
+    reflection.specialization_constants.resize(reader.ReadCount());
+    for (ShaderSpecializationConstant &constant : reflection.specialization_constants) {
+        reader.Read(constant.constant_id);
+        reader.Read(constant.name);
+        reader.Read(constant.type);
+        reader.Read(constant.default_value);
+    }
+
+    reflection.vertex_inputs.resize(reader.ReadCount());
+    for (ShaderVertexInput &input : reflection.vertex_inputs) {
+        reader.Read(input.location);
+        reader.Read(input.name);
+        reader.Read(input.format);
+        reader.Read(input.input_rate);
+    }
+
+    reader.Read(reflection.local_size);
+    reader.Read(reflection.entry_point);
+}
+
+bool load_cached_shader(const u64 key, std::vector<u32> &spirv, ShaderReflection &reflection)
+{
+    const String path{shader_cache_path(key)};
+    const auto file_result{fs::MappedFile::Open(path)};
+    if (!file_result) {
+        return false;
+    }
+
+    const std::span<const std::byte> file_data{file_result->GetData()};
+    ShaderCacheHeader header{};
+    if (file_data.size() < sizeof(header)) {
+        return false;
+    }
+    std::memcpy(&header, file_data.data(), sizeof(header));
+
+    const std::span<const std::byte> payload{file_data.subspan(sizeof(header))};
+    if (header.magic != SHADER_CACHE_MAGIC || header.version != SHADER_CACHE_VERSION || header.key != key ||
+        header.payload_size != payload.size() || header.checksum != utils::fnv1a(payload)) {
+        ENGINE_LOG_WARNING("Ignoring invalid shader cache entry '{}'", path);
+        return false;
+    }
+
+    CacheReader reader{payload};
+    reader.Read(spirv);
+    read_reflection(reader, reflection);
+    if (!reader.IsValid() || spirv.empty()) {
+        ENGINE_LOG_WARNING("Ignoring corrupt shader cache entry '{}'", path);
+        spirv.clear();
+        reflection = {};
+        return false;
+    }
+
+    return true;
+}
+
+void store_cached_shader(const u64 key, const std::span<const u32> spirv, const ShaderReflection &reflection)
+{
+    CacheWriter payload;
+    payload.Write(spirv);
+    write_reflection(payload, reflection);
+
+    const ShaderCacheHeader header{.magic = SHADER_CACHE_MAGIC,
+                                   .version = SHADER_CACHE_VERSION,
+                                   .key = key,
+                                   .payload_size = payload.Data().size(),
+                                   .checksum = utils::fnv1a(payload.Data())};
+
+    CacheWriter file;
+    file.Write(header);
+    file.Data().insert(file.Data().end(), payload.Data().begin(), payload.Data().end());
+
+    if (auto directory_result = fs::EnsureDirectoryExists(FilePath{SHADER_CACHE_DIRECTORY}, true); !directory_result) {
+        ENGINE_LOG_WARNING("Failed to create shader cache directory: {}", error_to_string(directory_result.error()));
+        return;
+    }
+
+    const String path{shader_cache_path(key)};
+    if (!fs::WriteBinaryFile(path, std::span<const std::byte>{file.Data()})) {
+        ENGINE_LOG_WARNING("Failed to write shader cache entry '{}'", path);
+    }
+}
+
 } // namespace internal
 
 [[nodiscard]] constexpr std::string_view vk_shader_stage_as_string_view(VkShaderStageFlagBits stage) noexcept
@@ -504,7 +792,9 @@ Shader::Shader(Shader &&other) noexcept
     : m_device(other.m_device),
       p_module(std::exchange(other.p_module, VK_NULL_HANDLE)),
       m_format(other.m_format),
-      m_stage(other.m_stage)
+      m_stage(other.m_stage),
+      m_reflection(std::move(other.m_reflection)),
+      m_code_hash(other.m_code_hash)
 {
 }
 
@@ -516,6 +806,8 @@ Shader &Shader::operator=(Shader &&other) noexcept
         p_module = std::exchange(other.p_module, VK_NULL_HANDLE);
         m_format = other.m_format;
         m_stage = other.m_stage;
+        m_reflection = std::move(other.m_reflection);
+        m_code_hash = other.m_code_hash;
     }
     return *this;
 }
@@ -527,27 +819,28 @@ Expect<VkShaderModule, ShaderError> Shader::CreateShaderModuleFromBinary(std::st
 {
     ENGINE_PROFILE_SCOPE("Create shader from binary");
 
-    auto file_result = fs::ReadBinaryFile(file_name);
+    // Mapped rather than read, the module and the reflection are both built straight from the file's pages
+    const auto file_result{fs::MappedFile::Open(file_name)};
     if (!file_result) {
         ENGINE_LOG_ERROR("Failed to read binary file '{}': {}", file_name, error_to_string(file_result.error()));
         return std::unexpected(file_result.error() == fs::Error::FileNotFound ? ShaderError::FileNotFound
                                                                               : ShaderError::FileReadError);
     }
 
-    const std::span<const std::byte> shader_code{*file_result};
+    const std::span<const std::byte> shader_code{file_result->GetData()};
     if (shader_code.empty()) {
         ENGINE_LOG_ERROR("Shader code is empty: {}", file_name);
         return std::unexpected(ShaderError::FileReadError);
     }
 
-    // Reinterpret byte data to u32 vector (SPIR-V format)
+    // The mapping is page aligned, so the words can be viewed in place
     if (shader_code.size() % sizeof(u32) != 0) {
         ENGINE_LOG_ERROR("SPIR-V binary size is not aligned: {}", file_name);
         return std::unexpected(ShaderError::FileReadError);
     }
 
-    const std::vector<u32> spirv(reinterpret_cast<const u32 *>(shader_code.data()),
-                           reinterpret_cast<const u32 *>(shader_code.data() + shader_code.size()));
+    const std::span<const u32> spirv{reinterpret_cast<const u32 *>(shader_code.data()),
+                                     shader_code.size() / sizeof(u32)};
 
     VkShaderModuleCreateInfo shader_create_info{};
     shader_create_info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
@@ -562,6 +855,7 @@ Expect<VkShaderModule, ShaderError> Shader::CreateShaderModuleFromBinary(std::st
     }
 
     m_reflection = internal::reflect_shader(spirv, m_stage);
+    m_code_hash = internal::shader_code_hash(m_stage, spirv);
 
     ENGINE_LOG_DEBUG("Successfully created {} shader from binary: {}", vk_shader_stage_as_string_view(m_stage),
                      file_name);
@@ -574,6 +868,7 @@ Expect<VkShaderModule, ShaderError> Shader::CreateShaderModuleFromText(std::stri
 
     ENGINE_LOG_INFO("Creating shader from text file: {}", file_name);
 
+    // Read rather than mapped, glslang takes the source as a null terminated string
     auto file_result = fs::ReadFile(file_name);
     if (!file_result) {
         ENGINE_LOG_ERROR("Failed to read shader file '{}': {}", file_name, error_to_string(file_result.error()));
@@ -581,9 +876,25 @@ Expect<VkShaderModule, ShaderError> Shader::CreateShaderModuleFromText(std::stri
                                                                               : ShaderError::FileReadError);
     }
 
-    glslang_initialize_process();
-    internal::ShaderModule shader;
     const glslang_stage_t shader_stage{internal::glslang_shader_stage_from_filename(file_name)};
+    const u64 cache_key{internal::shader_cache_key(shader_stage, *file_result)};
+
+    internal::ShaderModule shader;
+    if (internal::load_cached_shader(cache_key, shader.m_spirv, m_reflection)) {
+        if (const VkResult result{
+                internal::create_shader_module(m_device.GetDevice(), shader.m_spirv, shader.p_shader_module)};
+            result != VK_SUCCESS) {
+            ENGINE_LOG_ERROR("vkCreateShaderModule failed for cached '{}': {}", file_name, vk_result_to_string(result));
+            return std::unexpected(ShaderError::VulkanError);
+        }
+        m_code_hash = internal::shader_code_hash(m_stage, shader.m_spirv);
+
+        ENGINE_LOG_DEBUG("Loaded {} shader '{}' from the SPIR-V cache", vk_shader_stage_as_string_view(m_stage),
+                         file_name);
+        return shader.p_shader_module;
+    }
+
+    glslang_initialize_process();
     const size_t shader_size{internal::compile_shader(m_device.GetDevice(), shader_stage, *file_result, shader)};
 
     if (shader_size == 0) {
@@ -593,6 +904,8 @@ Expect<VkShaderModule, ShaderError> Shader::CreateShaderModuleFromText(std::stri
     }
 
     m_reflection = internal::reflect_shader(shader.m_spirv, m_stage);
+    internal::store_cached_shader(cache_key, shader.m_spirv, m_reflection);
+    m_code_hash = internal::shader_code_hash(m_stage, shader.m_spirv);
 
     VkShaderModule shader_module{shader.p_shader_module};
     std::string binary_filename{std::string(file_name) + ".spv"};
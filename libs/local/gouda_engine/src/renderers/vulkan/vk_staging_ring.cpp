@@ -0,0 +1,126 @@
+/**
+ * @file vk_staging_ring.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine vulkan staging ring buffer implementation
+ */
+#include "renderers/vulkan/vk_staging_ring.hpp"
+
+#include "debug/assert.hpp"
+#include "debug/logger.hpp"
+#include "debug/throw.hpp"
+#include "renderers/vulkan/vk_queue.hpp"
+
+namespace gouda::vk {
+
+namespace internal {
+
+static VkDeviceSize align_up(const VkDeviceSize value, const VkDeviceSize alignment)
+{
+    return alignment > 1 ? (value + alignment - 1) / alignment * alignment : value;
+}
+
+} // namespace internal
+
+StagingRing::StagingRing(const VkDevice device, const Buffer buffer)
+    : p_device{device},
+      m_buffer{buffer},
+      p_mapped{nullptr},
+      m_capacity{buffer.m_allocation_size},
+      m_head{0},
+      m_tail{0},
+      m_used_bytes{0},
+      m_unretired_bytes{0}
+{
+    p_mapped = static_cast<u8 *>(m_buffer.GetMapped());
+    if (!p_mapped) {
+        ENGINE_THROW("Failed to map staging ring buffer.");
+    }
+
+    ENGINE_LOG_DEBUG("Staging ring created with {} bytes.", m_capacity);
+}
+
+StagingRing::~StagingRing()
+{
+    // The mapping belongs to the allocation and goes away with it
+    p_mapped = nullptr;
+    m_buffer.Destroy(p_device);
+}
+
+std::optional<StagingAllocation> StagingRing::Allocate(const VkDeviceSize size, const VkDeviceSize alignment)
+{
+    if (size == 0 || size > m_capacity) {
+        return std::nullopt;
+    }
+
+    if (m_used_bytes == 0) {
+        // Nothing in flight, start from the beginning to keep allocations contiguous
+        m_head = 0;
+        m_tail = 0;
+    }
+
+    VkDeviceSize offset{internal::align_up(m_head, alignment)};
+    VkDeviceSize consumed{0};
+
+    if (m_used_bytes == 0 || m_head > m_tail) {
+        // Live data is in [tail, head), free space is [head, capacity) and [0, tail)
+        if (offset + size <= m_capacity) {
+            consumed = offset + size - m_head;
+        }
+        else if (size <= m_tail) {
+            // Wrap around, the skipped tail end is owned by this allocation until it retires
+            offset = 0;
+            consumed = m_capacity - m_head + size;
+        }
+        else {
+            return std::nullopt;
+        }
+    }
+    else if (m_head < m_tail) {
+        // Live data wraps, free space is [head, tail)
+        if (offset + size > m_tail) {
+            return std::nullopt;
+        }
+        consumed = offset + size - m_head;
+    }
+    else {
+        // head == tail with live data means the ring is full
+        return std::nullopt;
+    }
+
+    m_head = offset + size;
+    m_used_bytes += consumed;
+    m_unretired_bytes += consumed;
+
+    return StagingAllocation{m_buffer.p_buffer, offset, size, p_mapped + offset};
+}
+
+void StagingRing::Retire(const u64 timeline_value)
+{
+    if (m_unretired_bytes == 0) {
+        return;
+    }
+
+    ASSERT(m_retired_regions.empty() || m_retired_regions.back().m_timeline_value <= timeline_value,
+           "Staging ring regions must be retired in submission order.");
+
+    m_retired_regions.push_back({m_head, m_unretired_bytes, timeline_value});
+    m_unretired_bytes = 0;
+}
+
+void StagingRing::Reclaim(const u64 completed_value)
+{
+    while (!m_retired_regions.empty() && m_retired_regions.front().m_timeline_value <= completed_value) {
+        const RetiredRegion &region{m_retired_regions.front()};
+        m_tail = region.m_end;
+        m_used_bytes -= region.m_bytes;
+        m_retired_regions.pop_front();
+    }
+}
+
+u64 StagingRing::GetOldestPendingValue() const
+{
+    return m_retired_regions.empty() ? NO_TIMELINE_VALUE : m_retired_regions.front().m_timeline_value;
+}
+
+} // namespace gouda::vk
@@ -6,6 +6,8 @@
  */
 #include "renderers/vulkan/vk_swapchain.hpp"
 
+#include <utility>
+
 #include <GLFW/glfw3.h>
 
 #include "debug/logger.hpp"
@@ -75,6 +77,13 @@ static VkSurfaceFormatKHR ChooseSurfaceFormatAndColorSpace(const std::vector<VkS
     return surface_formats[0];
 }
 
+// Transfer source lets FrameCapture copy frames out, where the surface allows it
+static VkImageUsageFlags choose_image_usage(const VkSurfaceCapabilitiesKHR &capabilities)
+{
+    return VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT |
+           (capabilities.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_SRC_BIT);
+}
+
 static VkExtent2D ChooseSwapExtent(const VkSurfaceCapabilitiesKHR &capabilities, const VkExtent2D extent)
 {
     if (capabilities.currentExtent.width != constants::u32_max) {
@@ -98,7 +107,8 @@ Swapchain::Swapchain(GLFWwindow *window, Device *device, Instance *instance, Buf
       p_device{device},
       p_instance{instance},
       p_buffer_manager{buffer_manager},
-      m_extent{0, 0}
+      m_extent{0, 0},
+      m_image_usage{0}
 {
     m_is_valid.store(false, std::memory_order_release);
 
@@ -139,6 +149,7 @@ void Swapchain::CreateSwapchain()
 
     ENGINE_LOG_DEBUG("Selected swapchain extent: {}x{}.", extent.width, extent.height);
 
+    m_image_usage = choose_image_usage(surface_capabilities);
     const VkSwapchainCreateInfoKHR swap_chain_create_info{
         .sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR,
         .pNext = nullptr,
@@ -149,7 +160,7 @@ void Swapchain::CreateSwapchain()
         .imageColorSpace = m_surface_format.colorSpace,
         .imageExtent = extent,
         .imageArrayLayers = 1,
-        .imageUsage = (VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT),
+        .imageUsage = m_image_usage,
         .imageSharingMode = VK_SHARING_MODE_EXCLUSIVE,
         .queueFamilyIndexCount = 1,
         .pQueueFamilyIndices = &m_queue_family,
@@ -232,14 +243,12 @@ void Swapchain::DestroySwapchainImageViews()
     ENGINE_LOG_DEBUG("Swap chain images destroyed.");
 }
 
-void Swapchain::Recreate()
+RetiredSwapchain Swapchain::Recreate()
 {
     m_is_valid.store(false, std::memory_order_release);
 
     UpdateExtent();
 
-    DestroySwapchainImageViews();
-
     VkSurfaceCapabilitiesKHR surface_capabilities;
     vkGetPhysicalDeviceSurfaceCapabilitiesKHR(p_device->GetPhysicalDevice(), p_instance->GetSurface(),
                                               &surface_capabilities);
@@ -280,7 +289,8 @@ void Swapchain::Recreate()
     swap_chain_create_info.imageColorSpace = m_surface_format.colorSpace;
     swap_chain_create_info.imageExtent = extent;
     swap_chain_create_info.imageArrayLayers = 1;
-    swap_chain_create_info.imageUsage = (VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT);
+    m_image_usage = choose_image_usage(surface_capabilities);
+    swap_chain_create_info.imageUsage = m_image_usage;
     swap_chain_create_info.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE;
     swap_chain_create_info.queueFamilyIndexCount = 1;
     swap_chain_create_info.pQueueFamilyIndices = &m_queue_family;
@@ -297,12 +307,9 @@ void Swapchain::Recreate()
         CHECK_VK_RESULT(result, "vkCreateSwapchainKHR\n");
     }
 
-    // Destroy the old swapchain after the new one is created
-    if (p_swap_chain != VK_NULL_HANDLE) {
-        ENGINE_LOG_DEBUG("Destroying old swapchain: {}.", reinterpret_cast<void *>(p_swap_chain));
-        vkDestroySwapchainKHR(p_device->GetDevice(), p_swap_chain, nullptr);
-    }
-    p_swap_chain = new_swap_chain;
+    // Retired rather than destroyed, frames in flight may still render to and present the old images
+    RetiredSwapchain retired{std::exchange(p_swap_chain, new_swap_chain), std::exchange(m_image_views, {})};
+    m_images.clear();
     ENGINE_LOG_DEBUG("New swapchain handle: {}.", reinterpret_cast<void *>(p_swap_chain));
 
     ENGINE_LOG_DEBUG("Swap chain recreated with V-Sync mode: {}.",
@@ -313,6 +320,21 @@ void Swapchain::Recreate()
     CreateSwapchainImageViews();
 
     m_is_valid.store(true, std::memory_order_release);
+    return retired;
+}
+
+void Swapchain::DestroyRetired(RetiredSwapchain &retired) const
+{
+    for (const VkImageView image_view : retired.image_views) {
+        vkDestroyImageView(p_device->GetDevice(), image_view, nullptr);
+    }
+    retired.image_views.clear();
+
+    if (retired.swapchain != VK_NULL_HANDLE) {
+        ENGINE_LOG_DEBUG("Destroying old swapchain: {}.", reinterpret_cast<void *>(retired.swapchain));
+        vkDestroySwapchainKHR(p_device->GetDevice(), retired.swapchain, nullptr);
+        retired.swapchain = VK_NULL_HANDLE;
+    }
 }
 
 void Swapchain::UpdateExtent()
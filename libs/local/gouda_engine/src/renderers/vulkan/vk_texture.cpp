@@ -16,17 +16,15 @@ namespace gouda::vk {
 Sprite::Sprite() : looping{true} {}
 
 Texture::Texture()
-    : p_image{VK_NULL_HANDLE}, p_memory{VK_NULL_HANDLE}, p_view{VK_NULL_HANDLE}, p_sampler{VK_NULL_HANDLE}
+    : p_image{VK_NULL_HANDLE}, m_allocation{}, p_view{VK_NULL_HANDLE}, p_sampler{VK_NULL_HANDLE}
 {
 }
 
 void Texture::Destroy(const Device *device)
 {
     if (device) {
-        if (p_sampler != VK_NULL_HANDLE) {
-            vkDestroySampler(device->GetDevice(), p_sampler, nullptr);
-            p_sampler = VK_NULL_HANDLE;
-        }
+        // Samplers are shared through the buffer manager's cache, which destroys them
+        p_sampler = VK_NULL_HANDLE;
 
         if (p_view != VK_NULL_HANDLE) {
             vkDestroyImageView(device->GetDevice(), p_view, nullptr);
@@ -38,14 +36,13 @@ void Texture::Destroy(const Device *device)
             p_image = VK_NULL_HANDLE;
         }
 
-        if (p_memory != VK_NULL_HANDLE) {
-            vkFreeMemory(device->GetDevice(), p_memory, nullptr);
-            p_memory = VK_NULL_HANDLE;
+        if (m_allocation.p_allocator) {
+            m_allocation.p_allocator->Free(m_allocation);
         }
     }
 }
 
-TextureMetadata::TextureMetadata() : is_atlas{false}, texture{nullptr}, version{0,0,0,0} {}
+TextureMetadata::TextureMetadata() : is_atlas{false}, is_packed{false}, texture{nullptr}, version{0,0,0,0} {}
 TextureMetadata::~TextureMetadata() { sprites.clear(); }
 
 // Function declarations --------------------------------------------------------------
@@ -6,17 +6,31 @@
  */
 #include "renderers/vulkan/vk_texture_manager.hpp"
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
 #include <filesystem>
-#include <fstream>
+#include <format>
+#include <functional>
+#include <optional>
+#include <ranges>
+#include <type_traits>
 
 #include <nlohmann/json.hpp>
 
 #include "debug/logger.hpp"
 #include "debug/throw.hpp"
+#include "math/math.hpp"
 #include "renderers/vulkan/vk_buffer_manager.hpp"
 #include "renderers/vulkan/vk_device.hpp"
 #include "renderers/vulkan/vk_texture.hpp"
+#include "utils/file_watcher.hpp"
 #include "utils/filesystem.hpp"
+#include "utils/hash.hpp"
+#include "utils/image.hpp"
+#include "utils/mapped_file.hpp"
+#include "utils/rect_packer.hpp"
 
 namespace gouda::vk {
 
@@ -56,13 +70,209 @@ static SemVer parse_sem_ver(const std::string &str)
     // Any unspecified fields remain as default (0)
     return version;
 }
+
+// Decodes running at once, more only compete for the disk and keep finished images waiting in memory
+constexpr u32 MAX_ASYNC_DECODES{4};
+
+// Frames between budget checks, and how long a texture has to go undrawn before it may be evicted. The idle time also
+// covers GPU simulated particles, whose textures are only seen when they spawn.
+constexpr u64 RESIDENCY_CHECK_INTERVAL{30};
+constexpr u64 MIN_IDLE_FRAMES{600};
+constexpr VkDeviceSize DEVICE_BUDGET_TENTHS{8}; // Share of the VK_EXT_memory_budget budget the engine plans with
+
+// Edge pixels repeated around each packed image, keeps linear filtering and the first mip levels from bleeding in
+// the neighbouring sprites
+constexpr int ATLAS_PADDING{2};
+
+static FileTimeType last_write_time(StringView filepath)
+{
+    try {
+        return fs::GetLastWriteTime(filepath);
+    }
+    catch (const std::filesystem::filesystem_error &e) {
+        ENGINE_LOG_WARNING("Failed to get last modified time for '{}': {}", filepath, e.what());
+        return FileTimeType{};
+    }
+}
+
+// Parsed atlas metadata is cached by a hash of the JSON and the image it has to name, so an edited atlas or a
+// renamed image parses again under a new key. Entries are never evicted, deleting the directory is safe.
+
+// "GATL", bump ATLAS_CACHE_VERSION whenever the file layout or the parser output changes
+constexpr u32 ATLAS_CACHE_MAGIC{0x4C544147};
+constexpr u32 ATLAS_CACHE_VERSION{1};
+constexpr StringView ATLAS_CACHE_DIRECTORY{"cache/atlases"};
+
+// Followed by the sprite table, every sprite's frames, every sprite's durations and the sprite names
+struct AtlasCacheHeader {
+    u32 magic;
+    u32 version;
+    u64 key;
+    u32 sprite_count;
+    u32 frame_count;
+    u32 duration_count;
+    u32 name_size;
+    u32 atlas_version[4]; // major, minor, patch and variant
+    u32 has_atlas_version;
+    u32 reserved[3];
+};
+
+struct AtlasCacheSprite {
+    u32 name_offset;
+    u32 name_size;
+    u32 first_frame;
+    u32 frame_count;
+    u32 first_duration;
+    u32 duration_count;
+    u32 looping;
+    u32 reserved;
+};
+
+static_assert(sizeof(AtlasCacheHeader) == 64 && std::is_trivially_copyable_v<AtlasCacheHeader>);
+static_assert(sizeof(AtlasCacheSprite) == 32 && std::is_trivially_copyable_v<AtlasCacheSprite>);
+static_assert(std::is_trivially_copyable_v<SpriteFrame>);
+
+static u64 atlas_cache_key(const std::span<const std::byte> json, StringView image_filename)
+{
+    const String settings{std::format("image={};version={}", image_filename, ATLAS_CACHE_VERSION)};
+    return utils::fnv1a(json, utils::fnv1a(settings));
+}
+
+static String atlas_cache_path(const u64 key) { return std::format("{}/{:016x}.bin", ATLAS_CACHE_DIRECTORY, key); }
+
+// Fills metadata from a cache entry and returns false, with no sprites added, when there is no valid entry
+static bool load_cached_atlas(const u64 key, TextureMetadata &metadata)
+{
+    const auto file{fs::MappedFile::Open(atlas_cache_path(key))};
+    AtlasCacheHeader header{};
+    if (!file || file->GetSize() < sizeof(header)) {
+        return false;
+    }
+    const std::span<const std::byte> data{file->GetData()};
+    std::memcpy(&header, data.data(), sizeof(header));
+
+    const u64 frames_offset{sizeof(header) + static_cast<u64>(header.sprite_count) * sizeof(AtlasCacheSprite)};
+    const u64 durations_offset{frames_offset + static_cast<u64>(header.frame_count) * sizeof(SpriteFrame)};
+    const u64 names_offset{durations_offset + static_cast<u64>(header.duration_count) * sizeof(f32)};
+    if (header.magic != ATLAS_CACHE_MAGIC || header.version != ATLAS_CACHE_VERSION || header.key != key ||
+        names_offset + header.name_size != data.size()) {
+        ENGINE_LOG_WARNING("Ignoring invalid atlas cache entry '{}'", atlas_cache_path(key));
+        return false;
+    }
+
+    metadata.sprites.reserve(header.sprite_count);
+    for (u32 i = 0; i < header.sprite_count; ++i) {
+        AtlasCacheSprite entry{};
+        std::memcpy(&entry, data.data() + sizeof(header) + i * sizeof(entry), sizeof(entry));
+        if (static_cast<u64>(entry.first_frame) + entry.frame_count > header.frame_count ||
+            static_cast<u64>(entry.first_duration) + entry.duration_count > header.duration_count ||
+            static_cast<u64>(entry.name_offset) + entry.name_size > header.name_size) {
+            ENGINE_LOG_WARNING("Ignoring invalid atlas cache entry '{}'", atlas_cache_path(key));
+            metadata.sprites.clear();
+            return false;
+        }
+
+        Sprite sprite;
+        sprite.looping = entry.looping != 0;
+        sprite.frames.resize(entry.frame_count);
+        sprite.frame_durations.resize(entry.duration_count);
+        std::memcpy(sprite.frames.data(), data.data() + frames_offset + entry.first_frame * sizeof(SpriteFrame),
+                    entry.frame_count * sizeof(SpriteFrame));
+        std::memcpy(sprite.frame_durations.data(), data.data() + durations_offset + entry.first_duration * sizeof(f32),
+                    entry.duration_count * sizeof(f32));
+
+        const StringView name{reinterpret_cast<const char *>(data.data() + names_offset + entry.name_offset),
+                              entry.name_size};
+        metadata.sprites.emplace(StringId::Register(name), std::move(sprite));
+    }
+
+    if (header.has_atlas_version != 0) {
+        metadata.version = SemVer{header.atlas_version[0], header.atlas_version[1], header.atlas_version[2],
+                                  header.atlas_version[3]};
+    }
+    return true;
+}
+
+// Sprite ids are hashes, so the names come from the parser, one per sprite added to metadata
+static void store_cached_atlas(const u64 key, const TextureMetadata &metadata, const std::span<const String> names,
+                               const bool has_atlas_version)
+{
+    AtlasCacheHeader header{.magic = ATLAS_CACHE_MAGIC,
+                            .version = ATLAS_CACHE_VERSION,
+                            .key = key,
+                            .sprite_count = 0,
+                            .frame_count = 0,
+                            .duration_count = 0,
+                            .name_size = 0,
+                            .atlas_version = {},
+                            .has_atlas_version = has_atlas_version ? 1u : 0u,
+                            .reserved = {}};
+    if (has_atlas_version) {
+        const SemVer &version{metadata.version};
+        std::ranges::copy(std::array{version.major, version.minor, version.patch, version.variant},
+                          header.atlas_version);
+    }
+
+    std::vector<AtlasCacheSprite> entries;
+    std::vector<std::byte> frames;
+    std::vector<std::byte> durations;
+    String name_data;
+    entries.reserve(names.size());
+    for (const String &name : names) {
+        const Sprite *sprite{metadata.sprites.get(StringId{name})};
+        if (sprite == nullptr) {
+            continue;
+        }
+
+        entries.push_back({.name_offset = static_cast<u32>(name_data.size()),
+                           .name_size = static_cast<u32>(name.size()),
+                           .first_frame = header.frame_count,
+                           .frame_count = static_cast<u32>(sprite->frames.size()),
+                           .first_duration = header.duration_count,
+                           .duration_count = static_cast<u32>(sprite->frame_durations.size()),
+                           .looping = sprite->looping ? 1u : 0u,
+                           .reserved = 0});
+        const auto *frame_bytes{reinterpret_cast<const std::byte *>(sprite->frames.data())};
+        const auto *duration_bytes{reinterpret_cast<const std::byte *>(sprite->frame_durations.data())};
+        frames.insert(frames.end(), frame_bytes, frame_bytes + sprite->frames.size() * sizeof(SpriteFrame));
+        durations.insert(durations.end(), duration_bytes,
+                         duration_bytes + sprite->frame_durations.size() * sizeof(f32));
+        name_data += name;
+        header.frame_count += entries.back().frame_count;
+        header.duration_count += entries.back().duration_count;
+    }
+    header.sprite_count = static_cast<u32>(entries.size());
+    header.name_size = static_cast<u32>(name_data.size());
+
+    std::vector<std::byte> file_data(sizeof(header) + entries.size() * sizeof(AtlasCacheSprite));
+    std::memcpy(file_data.data(), &header, sizeof(header));
+    std::memcpy(file_data.data() + sizeof(header), entries.data(), entries.size() * sizeof(AtlasCacheSprite));
+    file_data.insert(file_data.end(), frames.begin(), frames.end());
+    file_data.insert(file_data.end(), durations.begin(), durations.end());
+    const auto *name_bytes{reinterpret_cast<const std::byte *>(name_data.data())};
+    file_data.insert(file_data.end(), name_bytes, name_bytes + name_data.size());
+
+    if (auto directory_result = fs::EnsureDirectoryExists(FilePath{ATLAS_CACHE_DIRECTORY}, true); !directory_result) {
+        ENGINE_LOG_WARNING("Failed to create atlas cache directory: {}", fs::error_to_string(directory_result.error()));
+        return;
+    }
+
+    if (!fs::WriteBinaryFile(atlas_cache_path(key), std::span<const std::byte>{file_data})) {
+        ENGINE_LOG_WARNING("Failed to write atlas cache entry '{}'", atlas_cache_path(key));
+    }
+}
 }
 
 TextureManager::TextureManager(BufferManager *buffer_manager, Device *device)
-    : p_buffer_manager{buffer_manager}, p_device{device}, m_textures_dirty{true}
+    : p_buffer_manager{buffer_manager},
+      p_device{device},
+      p_file_watcher{nullptr},
+      m_residency_frame{0},
+      m_texture_memory_budget{0}
 {
-    m_textures.reserve(MAX_TEXTURES);
-    m_metadata.reserve(MAX_TEXTURES);
+    m_textures.reserve(p_device->GetMaxTextures());
+    m_metadata.reserve(p_device->GetMaxTextures());
+    m_residency.reserve(p_device->GetMaxTextures());
     CreateDefaultTexture();
 }
 
@@ -71,20 +281,27 @@ TextureManager::~TextureManager()
     for (const auto &texture : m_textures) {
         texture->Destroy(p_device);
     }
+    for (const auto &retired : m_retired_textures) {
+        retired.texture->Destroy(p_device);
+    }
+    for (const auto &texture_array : m_texture_arrays) {
+        texture_array->Destroy(p_device);
+    }
 }
 
 u32 TextureManager::LoadSingleTexture(StringView filepath)
 {
-    ASSERT(m_textures.size() <= MAX_TEXTURES, "Could not create texture. Loaded textures exceeds max textures.");
+    ASSERT(m_textures.size() <= p_device->GetMaxTextures(),
+           "Could not create texture. Loaded textures exceeds max textures.");
 
-    if (m_textures.size() >= MAX_TEXTURES) {
+    if (m_textures.size() >= p_device->GetMaxTextures()) {
         ENGINE_LOG_ERROR("Could not create texture for '{}'. Loaded textures exceeds max textures: {}.", filepath,
-                         MAX_TEXTURES);
+                         p_device->GetMaxTextures());
         return 0; // Return default texture index as fallback
     }
 
     ENGINE_LOG_DEBUG("Loading texture: image={}", filepath);
-    auto texture = p_buffer_manager->CreateTexture(filepath);
+    auto texture = p_buffer_manager->CreateTexture(filepath, FULL_MIP_CHAIN);
     const u32 texture_id{static_cast<u32>(m_textures.size())};
 
     TextureMetadata metadata;
@@ -102,24 +319,26 @@ u32 TextureManager::LoadSingleTexture(StringView filepath)
 
     m_textures.push_back(std::move(texture));
     m_metadata.push_back(std::move(metadata));
-    m_textures_dirty = true;
+    m_residency.push_back(TextureResidency{m_residency_frame, false, false});
+    WatchTextureFiles(m_metadata.back());
+    m_dirty_texture_ids.push_back(texture_id);
 
     return texture_id;
 }
 
 u32 TextureManager::LoadAtlasTexture(StringView image_filepath, StringView json_filepath)
 {
-    ASSERT(m_textures.size() <= MAX_TEXTURES,
+    ASSERT(m_textures.size() <= p_device->GetMaxTextures(),
            "Could not create the atlas texture. Loaded textures exceeds max textures.");
 
-    if (m_textures.size() >= MAX_TEXTURES) {
+    if (m_textures.size() >= p_device->GetMaxTextures()) {
         ENGINE_LOG_ERROR("Could not create atlas texture for '{}'. Loaded textures exceeds max textures: {}.",
-                         image_filepath, MAX_TEXTURES);
+                         image_filepath, p_device->GetMaxTextures());
         return 0; // Return default texture index as fallback
     }
 
     ENGINE_LOG_DEBUG("Loading atlas: image={}, json={}", image_filepath, json_filepath);
-    auto texture = p_buffer_manager->CreateTexture(image_filepath);
+    auto texture = p_buffer_manager->CreateTexture(image_filepath, FULL_MIP_CHAIN);
     const u32 texture_id{static_cast<u32>(m_textures.size())};
 
     TextureMetadata metadata;
@@ -146,10 +365,393 @@ u32 TextureManager::LoadAtlasTexture(StringView image_filepath, StringView json_
 
     m_textures.push_back(std::move(texture));
     m_metadata.push_back(std::move(metadata));
-    m_textures_dirty = true;
+    m_residency.push_back(TextureResidency{m_residency_frame, false, false});
+    WatchTextureFiles(m_metadata.back());
+    m_dirty_texture_ids.push_back(texture_id);
+
+    return texture_id;
+}
+
+Vector<u32> TextureManager::LoadPackedAtlas(const std::span<const String> image_filepaths, const u32 page_size)
+{
+    struct PackedImage {
+        String sprite_name;
+        Image image;
+        PackedRect rect; // Including the padding
+        size_t page_index;
+    };
+
+    ENGINE_LOG_DEBUG("Packing {} images into {}x{} atlas pages.", image_filepaths.size(), page_size, page_size);
+
+    Vector<PackedImage> images;
+    images.reserve(image_filepaths.size());
+    for (const String &filepath : image_filepaths) {
+        auto image_result = Image::Load(filepath);
+        if (!image_result.has_value()) {
+            ENGINE_LOG_ERROR("Failed to load image '{}' for packing: {}", filepath, image_result.error());
+            continue;
+        }
+        images.push_back(PackedImage{fs::GetFileName(filepath), std::move(image_result.value()), {}, 0});
+    }
+
+    std::ranges::sort(images, std::greater{}, [](const PackedImage &packed) { return packed.image.GetHeight(); });
+
+    // First fit over the open pages, a new page is only started when none has room left
+    Vector<RectPacker> pages;
+    const int page_side{static_cast<int>(page_size)};
+    for (PackedImage &packed : images) {
+        const int width{packed.image.GetWidth() + 2 * internal::ATLAS_PADDING};
+        const int height{packed.image.GetHeight() + 2 * internal::ATLAS_PADDING};
+
+        bool is_placed{false};
+        for (size_t page_index = 0; page_index < pages.size() && !is_placed; ++page_index) {
+            if (const auto rect = pages[page_index].Insert(width, height)) {
+                packed.rect = *rect;
+                packed.page_index = page_index;
+                is_placed = true;
+            }
+        }
+
+        if (!is_placed) {
+            pages.emplace_back(ImageSize{math::max(page_side, width), math::max(page_side, height)});
+            packed.rect = pages.back().Insert(width, height).value();
+            packed.page_index = pages.size() - 1;
+        }
+    }
+
+    Vector<u32> page_ids;
+    page_ids.reserve(pages.size());
+    for (size_t page_index = 0; page_index < pages.size(); ++page_index) {
+        if (m_textures.size() >= p_device->GetMaxTextures()) {
+            ENGINE_LOG_ERROR("Could not create atlas page {} of {}. Loaded textures exceeds max textures: {}.",
+                             page_index, pages.size(), p_device->GetMaxTextures());
+            break;
+        }
+
+        const ImageSize size{pages[page_index].GetSize()};
+        Image page_image{Image::Blank(size)};
+        for (const PackedImage &packed : images) {
+            if (packed.page_index == page_index) {
+                page_image.Blit(packed.image, packed.rect.x + internal::ATLAS_PADDING,
+                                packed.rect.y + internal::ATLAS_PADDING, internal::ATLAS_PADDING);
+            }
+        }
+
+        auto texture = p_buffer_manager->CreateTextureFromImage(page_image, FULL_MIP_CHAIN);
+        const u32 texture_id{static_cast<u32>(m_textures.size())};
+
+        TextureMetadata metadata;
+        metadata.is_atlas = true;
+        metadata.is_packed = true;
+        metadata.texture = texture.get();
+
+        // Images are stored bottom row first, the sprite rects are top down like the ones of a JSON atlas
+        const AtlasSize atlas_size{static_cast<f32>(size.width), static_cast<f32>(size.height)};
+        for (const PackedImage &packed : images) {
+            if (packed.page_index != page_index) {
+                continue;
+            }
+
+            const int x{packed.rect.x + internal::ATLAS_PADDING};
+            const int y{size.height - (packed.rect.y + internal::ATLAS_PADDING) - packed.image.GetHeight()};
+            const SpriteRect sprite_rect{static_cast<f32>(x), static_cast<f32>(y),
+                                         static_cast<f32>(packed.image.GetWidth()),
+                                         static_cast<f32>(packed.image.GetHeight())};
+            Sprite sprite;
+            SpriteFrame frame;
+            frame.uv_rect = NormalizeRect(sprite_rect, atlas_size);
+            sprite.frames.push_back(frame);
+            if (!metadata.sprites.emplace(StringId::Register(packed.sprite_name), std::move(sprite)).second) {
+                ENGINE_LOG_WARNING("Duplicate packed sprite name '{}' on atlas page {}, keeping the first.",
+                                   packed.sprite_name, texture_id);
+            }
+        }
+
+        ENGINE_LOG_DEBUG("Packed atlas page {}: {} sprites, {} occupied.", texture_id, metadata.sprites.size(),
+                         pages[page_index].GetOccupancy());
+
+        m_textures.push_back(std::move(texture));
+        m_metadata.push_back(std::move(metadata));
+        m_residency.push_back(TextureResidency{m_residency_frame, false, false});
+        m_dirty_texture_ids.push_back(texture_id);
+        page_ids.push_back(texture_id);
+    }
+
+    return page_ids;
+}
+
+u32 TextureManager::LoadTextureArray(const std::span<const String> image_filepaths)
+{
+    if (m_texture_arrays.empty()) {
+        // Array 0, what failed loads return
+        const Image blank_layer{Image::Blank(ImageSize{1, 1})};
+        m_texture_arrays.push_back(p_buffer_manager->CreateTextureArray({&blank_layer, 1}));
+        m_texture_array_layer_counts.push_back(1);
+    }
+
+    // Quad instances carry the layer in 16 bits
+    const u32 max_layers{math::min(p_device->GetSelectedPhysicalDevice().m_device_properties.limits.maxImageArrayLayers,
+                                   u32{constants::u16_max} + 1)};
+    if (m_texture_arrays.size() >= p_device->GetMaxTextures()) {
+        ENGINE_LOG_ERROR("Could not create texture array. Loaded texture arrays exceeds max textures: {}.",
+                         p_device->GetMaxTextures());
+        return 0;
+    }
+    if (image_filepaths.empty() || image_filepaths.size() > max_layers) {
+        ENGINE_LOG_ERROR("Could not create texture array of {} layers, the device allows 1 to {}.",
+                         image_filepaths.size(), max_layers);
+        return 0;
+    }
+
+    ENGINE_LOG_DEBUG("Loading texture array of {} layers.", image_filepaths.size());
+
+    // The first image that loads sets the layer size, the layers without a usable image are blanked afterwards
+    Vector<Image> layers;
+    layers.reserve(image_filepaths.size());
+    std::optional<ImageSize> layer_size;
+    for (size_t layer = 0; layer < image_filepaths.size(); ++layer) {
+        auto image_result = Image::Load(image_filepaths[layer]);
+        if (!image_result.has_value()) {
+            ENGINE_LOG_ERROR("Failed to load image '{}' for texture array layer {}: {}", image_filepaths[layer], layer,
+                             image_result.error());
+            layers.push_back(Image::Blank(ImageSize{0, 0}));
+            continue;
+        }
+
+        const ImageSize size{image_result.value().GetSize()};
+        if (layer_size.has_value() && size != *layer_size) {
+            ENGINE_LOG_ERROR("Image '{}' is {}x{}, the layers of its texture array are {}x{}. Leaving layer {} blank.",
+                             image_filepaths[layer], size.width, size.height, layer_size->width, layer_size->height,
+                             layer);
+            layers.push_back(Image::Blank(ImageSize{0, 0}));
+            continue;
+        }
+        layer_size = size;
+        layers.push_back(std::move(image_result.value()));
+    }
+
+    if (!layer_size.has_value()) {
+        ENGINE_LOG_ERROR("Could not create texture array, none of its {} images loaded.", image_filepaths.size());
+        return 0;
+    }
+    for (Image &layer : layers) {
+        if (layer.GetSize() != *layer_size) {
+            layer = Image::Blank(*layer_size);
+        }
+    }
+
+    const u32 array_id{static_cast<u32>(m_texture_arrays.size())};
+    m_texture_arrays.push_back(p_buffer_manager->CreateTextureArray(layers, FULL_MIP_CHAIN));
+    m_texture_array_layer_counts.push_back(static_cast<u32>(layers.size()));
+
+    ENGINE_LOG_DEBUG("Texture array {} created: {} layers of {}x{}.", array_id, layers.size(), layer_size->width,
+                     layer_size->height);
+    return array_id;
+}
+
+u32 TextureManager::AddTexture(std::unique_ptr<Texture> texture)
+{
+    if (m_textures.size() >= p_device->GetMaxTextures()) {
+        ENGINE_LOG_ERROR("Could not add texture. Loaded textures exceeds max textures: {}.",
+                         p_device->GetMaxTextures());
+        texture->Destroy(p_device);
+        return 0;
+    }
+
+    const u32 texture_id{static_cast<u32>(m_textures.size())};
+
+    TextureMetadata metadata;
+    metadata.is_atlas = false;
+    metadata.is_packed = true;
+    metadata.texture = texture.get();
+
+    m_textures.push_back(std::move(texture));
+    m_metadata.push_back(std::move(metadata));
+    m_residency.push_back(TextureResidency{m_residency_frame, false, false}); // Packed textures are never evicted
+    m_dirty_texture_ids.push_back(texture_id);
 
     return texture_id;
 }
+
+u32 TextureManager::LoadSingleTextureAsync(StringView filepath)
+{
+    ENGINE_LOG_DEBUG("Queueing async texture load: image={}", filepath);
+
+    TextureMetadata metadata;
+    metadata.is_atlas = false;
+    metadata.image_filepath = filepath;
+    metadata.image_last_modified = internal::last_write_time(filepath);
+
+    return QueueAsyncLoad(std::move(metadata));
+}
+
+u32 TextureManager::LoadAtlasTextureAsync(StringView image_filepath, StringView json_filepath)
+{
+    ENGINE_LOG_DEBUG("Queueing async atlas load: image={}, json={}", image_filepath, json_filepath);
+
+    TextureMetadata metadata;
+    metadata.is_atlas = true;
+    metadata.image_filepath = image_filepath;
+    metadata.json_filepath = json_filepath;
+    metadata.image_last_modified = internal::last_write_time(image_filepath);
+    metadata.json_last_modified = internal::last_write_time(json_filepath);
+
+    // The sprite UVs only depend on the atlas size stored in the JSON, not on the decoded image
+    ParseAtlasJson(json_filepath, metadata);
+
+    return QueueAsyncLoad(std::move(metadata));
+}
+
+void TextureManager::ProcessAsyncLoads(const u64 submitted_value, const u64 completed_value)
+{
+    while (!m_retired_textures.empty() && m_retired_textures.front().timeline_value <= completed_value) {
+        m_retired_textures.front().texture->Destroy(p_device);
+        m_retired_textures.pop_front();
+    }
+
+    // Started decodes form the front of the queue, the first load without a future ends the scan
+    for (auto it = m_async_loads.begin(); it != m_async_loads.end() && it->source.valid();) {
+        if (it->source.wait_for(std::chrono::seconds{0}) != std::future_status::ready) {
+            ++it;
+            continue;
+        }
+
+        const u32 texture_id{it->texture_id};
+        if (const auto source_result = it->source.get(); source_result) {
+            // The upload lands in the current batch, which is flushed before this frame's draws
+            auto texture = p_buffer_manager->CreateTextureFromSource(source_result.value(), FULL_MIP_CHAIN);
+            m_metadata[texture_id].texture = texture.get();
+
+            // Frames already submitted may still sample the placeholder
+            m_retired_textures.push_back(RetiredTexture{submitted_value, std::move(m_textures[texture_id])});
+            m_textures[texture_id] = std::move(texture);
+            m_dirty_texture_ids.push_back(texture_id);
+
+            ENGINE_LOG_DEBUG("Async texture load finished: id={}, image={}", texture_id, it->filepath);
+        }
+        else {
+            ENGINE_LOG_ERROR("Failed to load texture: {} ({}). Keeping the default texture for id {}.", it->filepath,
+                             source_result.error(), texture_id);
+        }
+
+        it = m_async_loads.erase(it);
+    }
+
+    StartAsyncDecodes();
+}
+
+void TextureManager::SetPinnedTextures(const std::span<const u32> texture_ids)
+{
+    for (auto &residency : m_residency | std::views::drop(1)) {
+        residency.pinned = false;
+    }
+    for (const u32 texture_id : texture_ids) {
+        if (texture_id < m_residency.size()) {
+            m_residency[texture_id].pinned = true;
+            m_residency[texture_id].last_used_frame = m_residency_frame;
+        }
+    }
+}
+
+void TextureManager::UpdateResidency(const u64 submitted_value)
+{
+    const u64 frame{m_residency_frame++};
+
+    // Evicted textures drawn this frame go back through the async path, the placeholder stays bound meanwhile
+    for (u32 texture_id = 1; texture_id < m_residency.size(); ++texture_id) {
+        TextureResidency &residency{m_residency[texture_id]};
+        if (residency.evicted && (residency.last_used_frame == frame || residency.pinned)) {
+            residency.evicted = false;
+            m_async_loads.push_back(AsyncTextureLoad{texture_id, m_metadata[texture_id].image_filepath, {}});
+            ENGINE_LOG_DEBUG("Streaming texture_id {} back in: image={}", texture_id,
+                             m_metadata[texture_id].image_filepath);
+        }
+    }
+    StartAsyncDecodes();
+
+    // Released textures go whether or not the budget is exceeded, what is drawn again this frame is kept
+    for (const u32 texture_id : m_released_texture_ids) {
+        const TextureResidency &residency{m_residency[texture_id]};
+        if (!residency.pinned && !residency.evicted && residency.last_used_frame != frame && !IsLoading(texture_id) &&
+            !m_metadata[texture_id].is_packed) {
+            EvictTexture(texture_id, submitted_value);
+        }
+    }
+    m_released_texture_ids.clear();
+
+    // Querying the device budget is not free, and eviction only has to keep up with level streaming, not with
+    // individual frames
+    if (frame % internal::RESIDENCY_CHECK_INTERVAL != 0) {
+        return;
+    }
+
+    const VkDeviceSize texture_usage{GetTextureMemoryUsage()};
+    const VkDeviceSize budget{GetEffectiveTextureBudget(texture_usage)};
+    if (budget == 0 || texture_usage <= budget) {
+        return;
+    }
+
+    Vector<u32> candidates;
+    for (u32 texture_id = 1; texture_id < m_residency.size(); ++texture_id) {
+        const TextureResidency &residency{m_residency[texture_id]};
+        if (!residency.pinned && !residency.evicted && residency.last_used_frame + internal::MIN_IDLE_FRAMES <= frame &&
+            !IsLoading(texture_id) && !m_metadata[texture_id].is_packed) {
+            candidates.push_back(texture_id);
+        }
+    }
+    std::ranges::sort(candidates, {}, [this](const u32 texture_id) { return m_residency[texture_id].last_used_frame; });
+
+    VkDeviceSize evicted_usage{texture_usage};
+    u32 evicted_count{0};
+    for (const u32 texture_id : candidates) {
+        if (evicted_usage <= budget) {
+            break;
+        }
+        evicted_usage -= math::min(evicted_usage, m_textures[texture_id]->m_allocation.m_size);
+        EvictTexture(texture_id, submitted_value);
+        ++evicted_count;
+    }
+
+    ENGINE_LOG_DEBUG("Texture memory {} bytes over the {} byte budget, evicted {} textures.", texture_usage - budget,
+                     budget, evicted_count);
+}
+
+void TextureManager::ReleaseTexture(const u32 texture_id)
+{
+    // The default texture in slot 0 is what every placeholder falls back to
+    if (texture_id == 0 || texture_id >= m_residency.size()) {
+        return;
+    }
+    m_released_texture_ids.push_back(texture_id);
+}
+
+VkDeviceSize TextureManager::GetTextureMemoryUsage() const
+{
+    VkDeviceSize usage{0};
+    for (const auto &texture : m_textures) {
+        usage += texture->m_allocation.m_size;
+    }
+    return usage;
+}
+
+Task<u32> TextureManager::LoadTextureAsync(JobSystem &job_system, const String filepath)
+{
+    co_await SwitchToMainThread(job_system);
+    const u32 texture_id{LoadSingleTextureAsync(filepath)};
+
+    // ProcessAsyncLoads swaps finished decodes in once per frame
+    while (IsLoading(texture_id)) {
+        co_await NextFrame(job_system);
+    }
+    co_return texture_id;
+}
+
+bool TextureManager::IsLoading(const u32 texture_id) const
+{
+    return std::ranges::any_of(m_async_loads,
+                               [texture_id](const AsyncTextureLoad &load) { return load.texture_id == texture_id; });
+}
+
 bool TextureManager::ReloadTexture(u32 texture_id, const bool force)
 {
     if (texture_id >= m_textures.size()) {
@@ -157,6 +759,21 @@ bool TextureManager::ReloadTexture(u32 texture_id, const bool force)
         return false;
     }
 
+    if (IsLoading(texture_id)) {
+        ENGINE_LOG_DEBUG("Skipping reload of texture_id {}, its async load has not finished.", texture_id);
+        return true;
+    }
+
+    if (IsEvicted(texture_id)) {
+        ENGINE_LOG_DEBUG("Skipping reload of evicted texture_id {}, it is reloaded from disk when drawn.", texture_id);
+        return true;
+    }
+
+    if (m_metadata[texture_id].is_packed) {
+        ENGINE_LOG_DEBUG("Skipping reload of packed atlas page texture_id {}, it has no image file.", texture_id);
+        return true;
+    }
+
     if (texture_id == 0) {
         if (!force) {
             ENGINE_LOG_DEBUG("Skipping default texture reloading (texture_id 0).");
@@ -181,7 +798,7 @@ bool TextureManager::ReloadTexture(u32 texture_id, const bool force)
     }
 
     // Recreate texture
-    auto new_texture = p_buffer_manager->CreateTexture(metadata.image_filepath);
+    auto new_texture = p_buffer_manager->CreateTexture(metadata.image_filepath, FULL_MIP_CHAIN);
     if (!new_texture) {
         ENGINE_LOG_ERROR("Failed to recreate texture from '{}'.", metadata.image_filepath);
         return false;
@@ -211,7 +828,7 @@ bool TextureManager::ReloadTexture(u32 texture_id, const bool force)
         }
     }
 
-    m_textures_dirty = true;
+    m_dirty_texture_ids.push_back(texture_id);
 
     ENGINE_LOG_DEBUG("Reloaded texture_id {}: image={}", texture_id, metadata.image_filepath);
     return true;
@@ -267,21 +884,79 @@ bool TextureManager::CheckTextureForUpdate(u32 texture_id)
     return false;
 }
 
-const Sprite *TextureManager::GetSprite(u32 texture_id, StringView sprite_name) const
+void TextureManager::SetFileWatcher(fs::FileWatcher *file_watcher)
+{
+    p_file_watcher = file_watcher;
+    for (const TextureMetadata &metadata : m_metadata | std::views::drop(1)) {
+        WatchTextureFiles(metadata);
+    }
+}
+
+u32 TextureManager::ReloadChangedTextures(const std::span<const String> changed_files)
+{
+    const auto is_changed = [changed_files](const String &filepath) {
+        return std::ranges::find(changed_files, filepath) != changed_files.end();
+    };
+
+    u32 reload_count{0};
+    for (u32 texture_id = 1; texture_id < m_metadata.size(); ++texture_id) {
+        TextureMetadata &metadata{m_metadata[texture_id]};
+        const bool image_changed{is_changed(metadata.image_filepath)};
+        const bool json_changed{metadata.is_atlas && metadata.json_filepath && is_changed(*metadata.json_filepath)};
+        if (!image_changed && !json_changed) {
+            continue;
+        }
+
+        // Two loads for one slot could finish out of order and leave the older image bound
+        if (IsLoading(texture_id)) {
+            ENGINE_LOG_DEBUG("Skipping hot reload of texture_id {}, its async load has not finished.", texture_id);
+            continue;
+        }
+
+        if (json_changed) {
+            metadata.sprites.clear();
+            ParseAtlasJson(*metadata.json_filepath, metadata);
+            metadata.json_last_modified = internal::last_write_time(*metadata.json_filepath);
+        }
+
+        // An evicted texture reads its image from disk when it is drawn again anyway
+        if (image_changed && !IsEvicted(texture_id)) {
+            metadata.image_last_modified = internal::last_write_time(metadata.image_filepath);
+            m_async_loads.push_back(AsyncTextureLoad{texture_id, metadata.image_filepath, {}});
+        }
+
+        ENGINE_LOG_DEBUG("Hot reloading texture_id {}: image={}", texture_id, metadata.image_filepath);
+        ++reload_count;
+    }
+
+    StartAsyncDecodes();
+    return reload_count;
+}
+
+u32 TextureManager::FindSpriteTexture(const StringId sprite_id) const
+{
+    for (u32 texture_id = 1; texture_id < m_metadata.size(); ++texture_id) {
+        if (m_metadata[texture_id].sprites.contains(sprite_id)) {
+            return texture_id;
+        }
+    }
+    return 0;
+}
+
+const Sprite *TextureManager::GetSprite(const u32 texture_id, const StringId sprite_id) const
 {
     if (texture_id >= m_metadata.size()) {
         ENGINE_LOG_ERROR("Invalid texture_id: {}", texture_id);
         return nullptr;
     }
 
-    const auto &sprites = m_metadata[texture_id].sprites;
-    const auto it = sprites.find(String(sprite_name));
-    if (it == sprites.end()) {
-        ENGINE_LOG_ERROR("Sprite not found: {}", sprite_name);
-        return nullptr;
+    const Sprite *sprite{m_metadata[texture_id].sprites.get(sprite_id)};
+    if (sprite == nullptr) {
+        ENGINE_LOG_ERROR("Sprite not found in texture {}: '{}' ({:#018x})", texture_id, sprite_id.GetName(),
+                         sprite_id.GetHash());
     }
 
-    return &it->second;
+    return sprite;
 }
 
 void TextureManager::ParseAtlasJson(StringView json_filepath, TextureMetadata &metadata)
@@ -289,15 +964,22 @@ void TextureManager::ParseAtlasJson(StringView json_filepath, TextureMetadata &m
     metadata.sprites.clear();
     ENGINE_LOG_DEBUG("Parsing atlas metadata: {}", json_filepath);
 
-    std::ifstream file{String{json_filepath}};
-    if (!file.is_open()) {
+    const auto file{fs::MappedFile::Open(json_filepath)};
+    if (!file) {
         ENGINE_LOG_ERROR("Failed to open JSON file: {}", json_filepath);
         return;
     }
 
+    const String image_filename{FilePath(metadata.image_filepath).filename().string()};
+    const u64 cache_key{internal::atlas_cache_key(file->GetData(), image_filename)};
+    if (internal::load_cached_atlas(cache_key, metadata)) {
+        ENGINE_LOG_DEBUG("Loaded {} sprites from the atlas cache: {}", metadata.sprites.size(), json_filepath);
+        return;
+    }
+
     nlohmann::json json;
     try {
-        file >> json;
+        json = nlohmann::json::parse(file->GetText());
     }
     catch (const std::exception &e) {
         ENGINE_LOG_ERROR("JSON parsing error: {}", e.what());
@@ -313,14 +995,14 @@ void TextureManager::ParseAtlasJson(StringView json_filepath, TextureMetadata &m
     const AtlasSize atlas_size{json["meta"]["size"]["w"].get<f32>(), json["meta"]["size"]["h"].get<f32>()};
     ENGINE_LOG_DEBUG("Atlas size: {}:{}", atlas_size.width, atlas_size.height);
 
-    if (json["meta"].contains("version") && json["meta"]["version"].is_string()) {
+    const bool has_version{json["meta"].contains("version") && json["meta"]["version"].is_string()};
+    if (has_version) {
         metadata.version = internal::parse_sem_ver(json["meta"]["version"]);
         ENGINE_LOG_DEBUG("Atlas Version: {}", metadata.version.ToString());
     }
 
     if (json["meta"].contains("image_file") && json["meta"]["image_file"].is_string()) {
-        if (String image_filename = FilePath(metadata.image_filepath).filename().string();
-            json["meta"]["image_file"].get<String>() != image_filename) {
+        if (json["meta"]["image_file"].get<String>() != image_filename) {
             ENGINE_LOG_ERROR("Atlas metadata does not match atlas image name: {}", image_filename);
             return;
         }
@@ -341,6 +1023,9 @@ void TextureManager::ParseAtlasJson(StringView json_filepath, TextureMetadata &m
     metadata.sprites.reserve(sprite_count);
     ENGINE_LOG_DEBUG("Reserved {} slots for sprites", sprite_count);
 
+    Vector<String> sprite_names; // For the cache, which only sees the hashed ids in metadata
+    sprite_names.reserve(sprite_count);
+
     for (const auto &sprite_group : json["sprites"].items()) {
         const auto group_name = String{sprite_group.key()};                  // Copy to avoid temporary
         if (const auto &group = sprite_group.value(); group.contains("x")) { // Single sprite
@@ -358,7 +1043,8 @@ void TextureManager::ParseAtlasJson(StringView json_filepath, TextureMetadata &m
             sprite.frames.push_back(frame);
             ENGINE_LOG_DEBUG("Adding single sprite: {} pre-normal=({}), normal=({})", group_name,
                              sprite_rect.ToString(), frame.uv_rect.ToString());
-            metadata.sprites.emplace(group_name, std::move(sprite));
+            metadata.sprites.emplace(StringId::Register(group_name), std::move(sprite));
+            sprite_names.push_back(group_name);
         }
         else { // Animation group
             ENGINE_LOG_DEBUG("Animation group: {}", group_name);
@@ -423,13 +1109,15 @@ void TextureManager::ParseAtlasJson(StringView json_filepath, TextureMetadata &m
                     ENGINE_LOG_ERROR("Frame count does not match frame timing count.");
                 }
 
-                String key{std::format("{}.{}", group_name, anim_name)};
+                const String key{std::format("{}.{}", group_name, anim_name)};
                 ENGINE_LOG_DEBUG("Adding animation sprite: {}", key);
-                metadata.sprites.emplace(key, std::move(sprite));
+                metadata.sprites.emplace(StringId::Register(key), std::move(sprite));
+                sprite_names.push_back(key);
             }
         }
     }
 
+    internal::store_cached_atlas(cache_key, metadata, sprite_names, has_version);
     ENGINE_LOG_DEBUG("Loaded sprite: {}", json_filepath);
 }
 
@@ -468,12 +1156,13 @@ UVRect<f32> TextureManager::NormalizeRect(const SpriteRect sprite_rect, const At
 
 void TextureManager::CreateDefaultTexture()
 {
-    ASSERT(m_textures.size() <= MAX_TEXTURES,
+    ASSERT(m_textures.size() <= p_device->GetMaxTextures(),
            "Could not create default texture. Loaded textures exceeds max textures.");
     ASSERT(m_textures.empty(), "Could not create default texture. Texture already exists at index 0.");
 
-    if (m_textures.size() >= MAX_TEXTURES) {
-        ENGINE_LOG_ERROR("Could not create default texture. Loaded textures exceeds max textures: {}.", MAX_TEXTURES);
+    if (m_textures.size() >= p_device->GetMaxTextures()) {
+        ENGINE_LOG_ERROR("Could not create default texture. Loaded textures exceeds max textures: {}.",
+                         p_device->GetMaxTextures());
         return;
     }
 
@@ -493,10 +1182,96 @@ void TextureManager::CreateDefaultTexture()
 
     m_textures.push_back(std::move(default_texture));
     m_metadata.push_back(std::move(metadata));
+    m_residency.push_back(TextureResidency{m_residency_frame, true, false}); // The fallback for everything else
 
-    m_textures_dirty = true; // Ensure textures are set dirty
+    m_dirty_texture_ids.push_back(texture_id);
 
     ENGINE_LOG_DEBUG("Default texture created and added to textures at id: {}.", texture_id);
 }
 
+u32 TextureManager::QueueAsyncLoad(TextureMetadata metadata)
+{
+    if (m_textures.size() >= p_device->GetMaxTextures()) {
+        ENGINE_LOG_ERROR("Could not create texture for '{}'. Loaded textures exceeds max textures: {}.",
+                         metadata.image_filepath, p_device->GetMaxTextures());
+        return 0; // Return default texture index as fallback
+    }
+
+    // Every slot owns its texture, so each pending load gets its own 1x1 default texture to sample meanwhile
+    auto placeholder = p_buffer_manager->CreateDefaultTexture();
+    const u32 texture_id{static_cast<u32>(m_textures.size())};
+    metadata.texture = placeholder.get();
+
+    m_async_loads.push_back(AsyncTextureLoad{texture_id, metadata.image_filepath, {}});
+    m_textures.push_back(std::move(placeholder));
+    m_metadata.push_back(std::move(metadata));
+    m_residency.push_back(TextureResidency{m_residency_frame, false, false});
+    WatchTextureFiles(m_metadata.back());
+    m_dirty_texture_ids.push_back(texture_id);
+
+    StartAsyncDecodes();
+
+    return texture_id;
+}
+
+void TextureManager::WatchTextureFiles(const TextureMetadata &metadata)
+{
+    if (!p_file_watcher || metadata.is_packed) {
+        return;
+    }
+
+    p_file_watcher->Watch(metadata.image_filepath);
+    if (metadata.is_atlas && metadata.json_filepath) {
+        p_file_watcher->Watch(*metadata.json_filepath);
+    }
+}
+
+VkDeviceSize TextureManager::GetEffectiveTextureBudget(const VkDeviceSize texture_usage) const
+{
+    if (m_texture_memory_budget != 0 || !p_device->HasMemoryBudget()) {
+        return m_texture_memory_budget;
+    }
+
+    // Everything that is not a texture or reusable free space inside allocator blocks stays where it is, textures get
+    // the remainder of the share of the device budget the engine allows itself
+    const MemoryBudget device_budget{p_device->GetMemoryBudget()};
+    const VkDeviceSize free_block_bytes{p_device->GetAllocator()->GetStatistics().free_bytes};
+    const VkDeviceSize other_usage{device_budget.usage -
+                                   math::min(device_budget.usage, texture_usage + free_block_bytes)};
+    const VkDeviceSize usable_budget{device_budget.budget / 10 * internal::DEVICE_BUDGET_TENTHS};
+
+    // Nothing left for textures still has to read as a budget, so every idle texture gets evicted
+    return usable_budget > other_usage ? usable_budget - other_usage : 1;
+}
+
+void TextureManager::EvictTexture(const u32 texture_id, const u64 submitted_value)
+{
+    auto placeholder = p_buffer_manager->CreateDefaultTexture();
+    m_metadata[texture_id].texture = placeholder.get();
+
+    // Frames already submitted may still sample the texture
+    m_retired_textures.push_back(RetiredTexture{submitted_value, std::move(m_textures[texture_id])});
+    m_textures[texture_id] = std::move(placeholder);
+    m_residency[texture_id].evicted = true;
+    m_dirty_texture_ids.push_back(texture_id);
+
+    ENGINE_LOG_DEBUG("Evicted texture_id {}: image={}", texture_id, m_metadata[texture_id].image_filepath);
+}
+
+void TextureManager::StartAsyncDecodes()
+{
+    u32 decode_count{0};
+    for (auto &load : m_async_loads) {
+        if (!load.source.valid()) {
+            if (decode_count >= internal::MAX_ASYNC_DECODES) {
+                break;
+            }
+            load.source = std::async(std::launch::async, [buffer_manager = p_buffer_manager, filepath = load.filepath] {
+                return buffer_manager->LoadTextureSource(filepath);
+            });
+        }
+        ++decode_count;
+    }
+}
+
 } // namespace gouda::vk
@@ -0,0 +1,361 @@
+/**
+ * @file vk_thumbnail_cache.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine vulkan background thumbnail generation module implementation
+ */
+#include "renderers/vulkan/vk_thumbnail_cache.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <format>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "debug/logger.hpp"
+#include "debug/profiler.hpp"
+#include "renderers/vulkan/vk_buffer_manager.hpp"
+#include "renderers/vulkan/vk_texture.hpp"
+#include "renderers/vulkan/vk_texture_manager.hpp"
+#include "utils/filesystem.hpp"
+#include "utils/hash.hpp"
+#include "utils/image.hpp"
+#include "utils/mapped_file.hpp"
+#include "utils/thread.hpp"
+
+namespace gouda::vk {
+
+namespace internal {
+
+constexpr VkFormat THUMBNAIL_PAGE_FORMAT{VK_FORMAT_R8G8B8A8_UNORM};
+constexpr u32 THUMBNAIL_PIXEL_SIZE{4};
+
+// Thumbnails are cached by a hash of the image file, the source rect and the thumbnail size, so an edited image or
+// another sprite of it is made again under a new key. Entries are never evicted, deleting the directory is safe.
+
+// "GTHB", bump THUMBNAIL_CACHE_VERSION whenever the file layout or the filtering changes
+constexpr u32 THUMBNAIL_CACHE_MAGIC{0x42485447};
+constexpr u32 THUMBNAIL_CACHE_VERSION{1};
+constexpr StringView THUMBNAIL_CACHE_DIRECTORY{"cache/thumbnails"};
+
+struct ThumbnailCacheHeader {
+    u32 magic;
+    u32 version;
+    u64 key;
+    s32 width;
+    s32 height;
+    u32 reserved[2];
+};
+
+static_assert(sizeof(ThumbnailCacheHeader) == 32 && std::is_trivially_copyable_v<ThumbnailCacheHeader>);
+
+static u64 thumbnail_key(StringView image_filepath, const UVRect<f32> &source_rect)
+{
+    return utils::fnv1a(std::as_bytes(std::span{&source_rect, 1}), utils::fnv1a(image_filepath));
+}
+
+static u64 thumbnail_cache_key(const u64 file_hash, const UVRect<f32> &source_rect)
+{
+    const String settings{std::format("rect={},{},{},{};size={};version={}", source_rect.u_min, source_rect.v_min,
+                                      source_rect.u_max, source_rect.v_max, ThumbnailCache::THUMBNAIL_SIZE,
+                                      THUMBNAIL_CACHE_VERSION)};
+    return utils::fnv1a(settings, file_hash);
+}
+
+static String thumbnail_cache_path(const u64 key)
+{
+    return std::format("{}/{:016x}.bin", THUMBNAIL_CACHE_DIRECTORY, key);
+}
+
+// The size check catches entries cut short by a crash while writing, the key already covers the source
+static bool find_cached_thumbnail(const u64 key, Vector<u8> &pixels, ImageSize &size)
+{
+    auto file{fs::MappedFile::Open(thumbnail_cache_path(key))};
+    ThumbnailCacheHeader header{};
+    if (!file || file->GetSize() < sizeof(header)) {
+        return false;
+    }
+    std::memcpy(&header, file->GetData().data(), sizeof(header));
+
+    const u64 pixel_size{static_cast<u64>(header.width) * static_cast<u64>(header.height) * THUMBNAIL_PIXEL_SIZE};
+    if (header.magic != THUMBNAIL_CACHE_MAGIC || header.version != THUMBNAIL_CACHE_VERSION || header.key != key ||
+        header.width <= 0 || header.height <= 0 || header.width > static_cast<s32>(ThumbnailCache::THUMBNAIL_SIZE) ||
+        header.height > static_cast<s32>(ThumbnailCache::THUMBNAIL_SIZE) ||
+        file->GetSize() - sizeof(header) != pixel_size) {
+        ENGINE_LOG_WARNING("Ignoring invalid thumbnail cache entry '{}'", thumbnail_cache_path(key));
+        return false;
+    }
+
+    pixels.resize_uninitialized(static_cast<size_t>(pixel_size));
+    std::memcpy(pixels.data(), file->GetData().data() + sizeof(header), pixels.size());
+    size = ImageSize{header.width, header.height};
+    return true;
+}
+
+static void store_cached_thumbnail(const u64 key, const std::span<const u8> pixels, const ImageSize size)
+{
+    const ThumbnailCacheHeader header{.magic = THUMBNAIL_CACHE_MAGIC,
+                                      .version = THUMBNAIL_CACHE_VERSION,
+                                      .key = key,
+                                      .width = size.width,
+                                      .height = size.height,
+                                      .reserved = {0, 0}};
+
+    std::vector<std::byte> file_data(sizeof(header) + pixels.size());
+    std::memcpy(file_data.data(), &header, sizeof(header));
+    std::memcpy(file_data.data() + sizeof(header), pixels.data(), pixels.size());
+
+    if (auto directory_result = fs::EnsureDirectoryExists(FilePath{THUMBNAIL_CACHE_DIRECTORY}, true);
+        !directory_result) {
+        ENGINE_LOG_WARNING("Failed to create thumbnail cache directory: {}",
+                           fs::error_to_string(directory_result.error()));
+        return;
+    }
+
+    if (!fs::WriteBinaryFile(thumbnail_cache_path(key), std::span<const std::byte>{file_data})) {
+        ENGINE_LOG_WARNING("Failed to write thumbnail cache entry '{}'", thumbnail_cache_path(key));
+    }
+}
+
+} // namespace internal
+
+struct ThumbnailCache::SourceImage {
+    String image_filepath;
+    u64 file_hash{0};
+    std::optional<Image> image; // Decoded on the first cache miss only
+    bool is_readable{false};
+};
+
+ThumbnailCache::ThumbnailCache(BufferManager *buffer_manager, TextureManager *texture_manager)
+    : p_buffer_manager{buffer_manager},
+      p_texture_manager{texture_manager},
+      m_thumbnails{},
+      m_pages{},
+      m_used_cell_count{0},
+      m_is_full_warned{false},
+      m_requests{},
+      m_results{},
+      m_thread{MakeThread("Thumbnails", ThreadPriority::IO,
+                          [this](const std::stop_token &stop_token) { Run(stop_token); })}
+{
+}
+
+ThumbnailCache::~ThumbnailCache()
+{
+    m_thread.request_stop();
+    m_thread.join();
+}
+
+const Thumbnail *ThumbnailCache::Find(StringView image_filepath, const UVRect<f32> &source_rect)
+{
+    const u64 key{internal::thumbnail_key(image_filepath, source_rect)};
+    if (Entry *entry{m_thumbnails.get(key)}) {
+        if (entry->state != ThumbnailState::Placed) {
+            return nullptr;
+        }
+        // A page whose texture could not be added draws nothing
+        entry->thumbnail.texture_id = m_pages[entry->cell / CELLS_PER_PAGE].texture_id;
+        return entry->thumbnail.texture_id != 0 ? &entry->thumbnail : nullptr;
+    }
+
+    m_thumbnails.try_emplace(key, Entry{Thumbnail{0, UVRect{0.0f, 0.0f, 0.0f, 0.0f}, ImageSize{0, 0}}, 0,
+                                        ThumbnailState::Queued});
+    {
+        std::lock_guard lock{m_mutex};
+        m_requests.push_back(Request{key, String{image_filepath}, source_rect});
+    }
+    m_condition.notify_one();
+    return nullptr;
+}
+
+void ThumbnailCache::Update()
+{
+    Vector<Generated> generated;
+    {
+        std::lock_guard lock{m_mutex};
+        generated.swap(m_results);
+    }
+
+    constexpr u32 cell_count{CELLS_PER_PAGE * MAX_PAGE_COUNT};
+    for (const Generated &thumbnail : generated) {
+        Entry &entry{*m_thumbnails.get(thumbnail.key)};
+        if (thumbnail.is_failed) {
+            entry.state = ThumbnailState::Failed;
+            continue;
+        }
+        if (m_used_cell_count >= cell_count) {
+            if (!m_is_full_warned) {
+                ENGINE_LOG_WARNING("Every one of the {} thumbnail cells is taken, further thumbnails are not made.",
+                                   cell_count);
+                m_is_full_warned = true;
+            }
+            entry.state = ThumbnailState::Failed;
+            continue;
+        }
+
+        const u32 cell{m_used_cell_count++};
+        if (cell / CELLS_PER_PAGE >= m_pages.size()) {
+            Page &page{m_pages.emplace_back()};
+            page.pixels.resize(static_cast<size_t>(PAGE_SIZE) * PAGE_SIZE * internal::THUMBNAIL_PIXEL_SIZE, 0);
+        }
+        Place(thumbnail, cell, entry.thumbnail);
+        entry.cell = cell;
+        entry.state = ThumbnailState::Placed;
+    }
+
+    UploadPages();
+}
+
+void ThumbnailCache::Place(const Generated &generated, const u32 cell, Thumbnail &thumbnail)
+{
+    Page &page{m_pages[cell / CELLS_PER_PAGE]};
+    const auto width{static_cast<u32>(generated.size.width)};
+    const auto height{static_cast<u32>(generated.size.height)};
+
+    // Centred in the cell, whose rest stays transparent
+    const u32 x{cell % CELLS_PER_PAGE % CELLS_PER_ROW * THUMBNAIL_SIZE + (THUMBNAIL_SIZE - width) / 2};
+    const u32 y{cell % CELLS_PER_PAGE / CELLS_PER_ROW * THUMBNAIL_SIZE + (THUMBNAIL_SIZE - height) / 2};
+    constexpr size_t pixel_size{internal::THUMBNAIL_PIXEL_SIZE};
+    for (u32 row = 0; row < height; ++row) {
+        std::memcpy(page.pixels.data() + (static_cast<size_t>(y + row) * PAGE_SIZE + x) * pixel_size,
+                    generated.pixels.data() + static_cast<size_t>(row) * width * pixel_size, width * pixel_size);
+    }
+    page.dirty_first_row = std::min(page.dirty_first_row, y);
+    page.dirty_last_row = std::max(page.dirty_last_row, y + height);
+
+    constexpr f32 page_size{static_cast<f32>(PAGE_SIZE)};
+    thumbnail.uv_rect = UVRect{static_cast<f32>(x) / page_size, static_cast<f32>(y) / page_size,
+                               static_cast<f32>(x + width) / page_size, static_cast<f32>(y + height) / page_size};
+    thumbnail.size = generated.size;
+}
+
+void ThumbnailCache::UploadPages()
+{
+    const ImageSize page_size{static_cast<int>(PAGE_SIZE), static_cast<int>(PAGE_SIZE)};
+    for (Page &page : m_pages) {
+        if (page.dirty_first_row >= page.dirty_last_row) {
+            continue;
+        }
+
+        if (page.texture_id == 0) {
+            // A new page goes up whole with its first thumbnails, rows are only updated in later batches
+            auto texture{std::make_unique<Texture>()};
+            p_buffer_manager->CreateTextureImageFromData(*texture, page.pixels.data(), page_size,
+                                                         internal::THUMBNAIL_PAGE_FORMAT, 1, 0);
+            texture->p_view = p_buffer_manager->CreateImageView(texture->p_image, internal::THUMBNAIL_PAGE_FORMAT,
+                                                                VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_VIEW_TYPE_2D, 1, 1);
+            texture->p_sampler = p_buffer_manager->GetTextureSampler(VK_FILTER_LINEAR, VK_FILTER_LINEAR,
+                                                                     VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE);
+            page.texture_id = p_texture_manager->AddTexture(std::move(texture));
+        }
+        else {
+            const size_t row_offset{static_cast<size_t>(page.dirty_first_row) * PAGE_SIZE *
+                                    internal::THUMBNAIL_PIXEL_SIZE};
+            p_buffer_manager->UpdateTextureRows(*p_texture_manager->GetTextures()[page.texture_id], page_size,
+                                                internal::THUMBNAIL_PAGE_FORMAT, page.dirty_first_row,
+                                                page.dirty_last_row - page.dirty_first_row,
+                                                page.pixels.data() + row_offset);
+        }
+        page.dirty_first_row = PAGE_SIZE;
+        page.dirty_last_row = 0;
+    }
+}
+
+ThumbnailCache::Generated ThumbnailCache::Generate(const Request &request, SourceImage &source)
+{
+    ENGINE_PROFILE_SCOPE("Generate thumbnail");
+
+    Generated generated{.key = request.key, .pixels = {}, .size = ImageSize{0, 0}, .is_failed = true};
+    if (source.image_filepath != request.image_filepath) {
+        source = SourceImage{};
+        source.image_filepath = request.image_filepath;
+        if (auto file{fs::MappedFile::Open(request.image_filepath)}) {
+            source.file_hash = utils::fnv1a(file->GetData());
+            source.is_readable = true;
+        }
+        else {
+            ENGINE_LOG_WARNING("Cannot make thumbnails of '{}': {}", request.image_filepath,
+                               fs::error_to_string(file.error()));
+        }
+    }
+    if (!source.is_readable) {
+        return generated;
+    }
+
+    const u64 cache_key{internal::thumbnail_cache_key(source.file_hash, request.source_rect)};
+    if (internal::find_cached_thumbnail(cache_key, generated.pixels, generated.size)) {
+        generated.is_failed = false;
+        return generated;
+    }
+
+    if (!source.image) {
+        auto image_result{Image::Load(request.image_filepath)};
+        if (!image_result) {
+            ENGINE_LOG_WARNING("Cannot make thumbnails of '{}': {}", request.image_filepath, image_result.error());
+            source.is_readable = false;
+            return generated;
+        }
+        source.image = std::move(*image_result);
+    }
+
+    // The pixels the rect covers, rounded outwards, then halved until they fit
+    const Image &image{*source.image};
+    const UVRect<f32> &rect{request.source_rect};
+    const auto to_pixel{[](const f32 coordinate, const int extent, const bool round_up) {
+        const f32 pixel{coordinate * static_cast<f32>(extent)};
+        return std::clamp(static_cast<int>(round_up ? std::ceil(pixel) : std::floor(pixel)), 0, extent);
+    }};
+    const int first_column{to_pixel(std::min(rect.u_min, rect.u_max), image.GetWidth(), false)};
+    const int last_column{to_pixel(std::max(rect.u_min, rect.u_max), image.GetWidth(), true)};
+    const int first_row{to_pixel(std::min(rect.v_min, rect.v_max), image.GetHeight(), false)};
+    const int last_row{to_pixel(std::max(rect.v_min, rect.v_max), image.GetHeight(), true)};
+    if (last_column <= first_column || last_row <= first_row || image.GetChannels() != 4) {
+        ENGINE_LOG_WARNING("Cannot make a thumbnail of an empty rect of '{}'.", request.image_filepath);
+        return generated;
+    }
+
+    Image thumbnail{Image::Blank(ImageSize{last_column - first_column, last_row - first_row})};
+    thumbnail.Blit(image, -first_column, -first_row);
+    constexpr int thumbnail_size{static_cast<int>(THUMBNAIL_SIZE)};
+    while (thumbnail.GetWidth() > thumbnail_size || thumbnail.GetHeight() > thumbnail_size) {
+        thumbnail = thumbnail.Downsample();
+    }
+
+    const std::span<const stbi_uc> pixels{thumbnail.data()};
+    generated.pixels.resize_uninitialized(pixels.size());
+    std::memcpy(generated.pixels.data(), pixels.data(), pixels.size());
+    generated.size = thumbnail.GetSize();
+    generated.is_failed = false;
+    internal::store_cached_thumbnail(cache_key, generated.pixels, generated.size);
+    return generated;
+}
+
+void ThumbnailCache::Run(const std::stop_token &stop_token)
+{
+    Vector<Request> requests;
+    SourceImage source;
+    while (true) {
+        {
+            std::unique_lock lock{m_mutex};
+            if (!m_condition.wait(lock, stop_token, [this] { return !m_requests.empty(); })) {
+                return;
+            }
+            requests.swap(m_requests);
+        }
+
+        for (const Request &request : requests) {
+            if (stop_token.stop_requested()) {
+                return;
+            }
+            Generated generated{Generate(request, source)};
+            std::lock_guard lock{m_mutex};
+            m_results.push_back(std::move(generated));
+        }
+        requests.clear();
+        source.image.reset(); // Only reused within a batch, a decoded atlas is too large to keep around idle
+    }
+}
+
+} // namespace gouda::vk
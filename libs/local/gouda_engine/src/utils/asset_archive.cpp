@@ -0,0 +1,296 @@
+/**
+ * @file utils/asset_archive.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine packed asset archive implementation
+ */
+#include "utils/asset_archive.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+#include <vector>
+
+#include "containers/small_vector.hpp"
+#include "debug/logger.hpp"
+#include "utils/hash.hpp"
+#include "utils/lz4.hpp"
+
+namespace gouda::fs {
+
+namespace internal {
+
+constexpr u32 ARCHIVE_MAGIC{0x4B415047}; // "GPAK"
+constexpr u32 ARCHIVE_VERSION{1};
+
+enum class ArchiveCompression : u8 { None, LZ4 };
+
+struct ArchiveHeader {
+    u32 magic;
+    u32 version;
+    u32 entry_count;
+    u32 reserved;
+    u64 index_offset; // The entries, then their paths
+    u64 index_size;
+};
+
+static_assert(sizeof(ArchiveHeader) == 32 && std::is_trivially_copyable_v<ArchiveHeader>);
+
+// In mount order, the last one mounted is searched first
+static Vector<AssetArchive> &mounted_archives()
+{
+    static Vector<AssetArchive> archives;
+    return archives;
+}
+
+static u64 align_up(const u64 value, const u64 alignment) { return (value + alignment - 1) / alignment * alignment; }
+
+} // namespace internal
+
+// AssetArchive implementation ---------------------------------------------------------------------
+
+AssetArchive::AssetArchive(MappedFile file, StringView filepath, const std::span<const Entry> entries,
+                           StringView paths)
+    : m_file{std::move(file)}, m_filepath{filepath}, m_entries{entries}, m_paths{paths}
+{
+}
+
+Expect<AssetArchive, Error> AssetArchive::Open(StringView filepath)
+{
+    static_assert(sizeof(Entry) == 48 && std::is_trivially_copyable_v<Entry>);
+
+    auto file{MappedFile::Open(filepath)};
+    if (!file) {
+        return std::unexpected(file.error());
+    }
+
+    const std::span<const std::byte> data{file->GetData()};
+    internal::ArchiveHeader header{};
+    if (data.size() < sizeof(header)) {
+        ENGINE_LOG_ERROR("Asset archive '{}' is truncated.", filepath);
+        return std::unexpected(Error::FileReadError);
+    }
+    std::memcpy(&header, data.data(), sizeof(header));
+
+    if (header.magic != internal::ARCHIVE_MAGIC || header.version != internal::ARCHIVE_VERSION) {
+        ENGINE_LOG_ERROR("'{}' is not a version {} asset archive.", filepath, internal::ARCHIVE_VERSION);
+        return std::unexpected(Error::FileReadError);
+    }
+
+    const u64 entries_size{u64{header.entry_count} * sizeof(Entry)};
+    if (header.index_offset % alignof(Entry) != 0 || header.index_offset > data.size() ||
+        header.index_size > data.size() - header.index_offset || entries_size > header.index_size) {
+        ENGINE_LOG_ERROR("Asset archive '{}' has a corrupt index.", filepath);
+        return std::unexpected(Error::FileReadError);
+    }
+
+    // Mappings and read buffers are both aligned well beyond an entry, so the index is used where it lies
+    const std::span<const Entry> entries{reinterpret_cast<const Entry *>(data.data() + header.index_offset),
+                                         header.entry_count};
+    const StringView paths{reinterpret_cast<const char *>(data.data() + header.index_offset + entries_size),
+                           static_cast<size_t>(header.index_size - entries_size)};
+
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const Entry &entry{entries[i]};
+        const bool is_compression_valid{
+            entry.compression == static_cast<u8>(internal::ArchiveCompression::LZ4) ||
+            (entry.compression == static_cast<u8>(internal::ArchiveCompression::None) &&
+             entry.stored_size == entry.size)};
+        if (entry.offset > header.index_offset || entry.stored_size > header.index_offset - entry.offset ||
+            entry.path_offset > paths.size() || entry.path_length > paths.size() - entry.path_offset ||
+            !is_compression_valid || (i > 0 && entries[i - 1].path_hash > entry.path_hash)) {
+            ENGINE_LOG_ERROR("Asset archive '{}' has a corrupt entry {}.", filepath, i);
+            return std::unexpected(Error::FileReadError);
+        }
+    }
+
+    ENGINE_LOG_DEBUG("Opened asset archive '{}': {} entries.", filepath, entries.size());
+    return AssetArchive{std::move(*file), filepath, entries, paths};
+}
+
+Expect<void, Error> AssetArchive::Write(StringView output_filepath, const std::span<const ArchiveSource> sources,
+                                        const bool compress)
+{
+    if (output_filepath.empty()) {
+        return std::unexpected(Error::EmptyFileName);
+    }
+
+    std::ofstream output{FilePath{output_filepath}, std::ios::binary | std::ios::trunc};
+    if (!output) {
+        return std::unexpected(Error::FileWriteError);
+    }
+
+    struct PendingEntry {
+        Entry entry;
+        String path;
+    };
+
+    // Written again once the index is known
+    internal::ArchiveHeader header{};
+    output.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    Vector<PendingEntry> pending;
+    pending.reserve(sources.size());
+    u64 position{sizeof(internal::ArchiveHeader)};
+    u64 total_size{0};
+    std::vector<std::byte> compressed;
+
+    for (const ArchiveSource &source : sources) {
+        String path{NormalizePath(source.path)};
+        if (std::ranges::any_of(pending, [&path](const PendingEntry &other) { return other.path == path; })) {
+            ENGINE_LOG_WARNING("Skipping '{}', the archive already holds '{}'.", source.filepath.string(), path);
+            continue;
+        }
+
+        auto contents{ReadBinaryFile(source.filepath.string())};
+        if (!contents) {
+            // Loose empty files fail to open the same way, so leaving them out changes nothing for the loaders
+            if (contents.error() == Error::FileReadError && std::filesystem::is_regular_file(source.filepath)) {
+                ENGINE_LOG_WARNING("Skipping empty file '{}'.", source.filepath.string());
+                continue;
+            }
+            ENGINE_LOG_ERROR("Cannot pack '{}': {}", source.filepath.string(), error_to_string(contents.error()));
+            return std::unexpected(contents.error());
+        }
+
+        std::span<const std::byte> stored{*contents};
+        auto compression{internal::ArchiveCompression::None};
+        if (compress) {
+            compressed.resize(utils::lz4_compress_bound(contents->size()));
+            const size_t compressed_size{utils::lz4_compress(*contents, compressed)};
+            if (compressed_size != 0 && compressed_size <= contents->size() - contents->size() / 8) {
+                stored = std::span<const std::byte>{compressed}.first(compressed_size);
+                compression = internal::ArchiveCompression::LZ4;
+            }
+        }
+
+        const u64 offset{internal::align_up(position, ENTRY_ALIGNMENT)};
+        const std::array<char, ENTRY_ALIGNMENT> padding{};
+        output.write(padding.data(), static_cast<std::streamsize>(offset - position));
+        output.write(reinterpret_cast<const char *>(stored.data()), static_cast<std::streamsize>(stored.size()));
+        position = offset + stored.size();
+        total_size += contents->size();
+
+        Entry entry{};
+        entry.path_hash = utils::fnv1a(path);
+        entry.offset = offset;
+        entry.stored_size = stored.size();
+        entry.size = contents->size();
+        entry.compression = static_cast<u8>(compression);
+        pending.push_back(PendingEntry{entry, std::move(path)});
+    }
+
+    // Equal hashes keep the order they were packed in, Find checks the path of every one of them
+    std::ranges::stable_sort(pending, {}, [](const PendingEntry &pending_entry) {
+        return pending_entry.entry.path_hash;
+    });
+
+    String paths;
+    for (PendingEntry &pending_entry : pending) {
+        pending_entry.entry.path_offset = static_cast<u32>(paths.size());
+        pending_entry.entry.path_length = static_cast<u32>(pending_entry.path.size());
+        paths += pending_entry.path;
+    }
+
+    const u64 index_offset{internal::align_up(position, alignof(Entry))};
+    const std::array<char, alignof(Entry)> padding{};
+    output.write(padding.data(), static_cast<std::streamsize>(index_offset - position));
+    for (const PendingEntry &pending_entry : pending) {
+        output.write(reinterpret_cast<const char *>(&pending_entry.entry), sizeof(Entry));
+    }
+    output.write(paths.data(), static_cast<std::streamsize>(paths.size()));
+
+    header = {.magic = internal::ARCHIVE_MAGIC,
+              .version = internal::ARCHIVE_VERSION,
+              .entry_count = static_cast<u32>(pending.size()),
+              .reserved = 0,
+              .index_offset = index_offset,
+              .index_size = pending.size() * sizeof(Entry) + paths.size()};
+    output.seekp(0);
+    output.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    if (!output.flush()) {
+        return std::unexpected(Error::FileWriteError);
+    }
+
+    constexpr f64 bytes_per_mib{1024.0 * 1024.0};
+    ENGINE_LOG_INFO("Packed {} files into '{}': {:.2f} MiB, {:.2f} MiB unpacked.", pending.size(), output_filepath,
+                    static_cast<f64>(index_offset) / bytes_per_mib, static_cast<f64>(total_size) / bytes_per_mib);
+    return {};
+}
+
+String AssetArchive::NormalizePath(StringView path) { return FilePath{path}.lexically_normal().generic_string(); }
+
+Expect<MappedFile, Error> AssetArchive::Read(StringView path) const
+{
+    const Entry *entry{Find(NormalizePath(path))};
+    if (entry == nullptr) {
+        return std::unexpected(Error::FileNotFound);
+    }
+    if (entry->size == 0) {
+        return std::unexpected(Error::FileReadError); // Matches MappedFile::Open on an empty loose file
+    }
+
+    const std::span<const std::byte> stored{m_file.GetData().subspan(entry->offset, entry->stored_size)};
+    if (entry->compression == static_cast<u8>(internal::ArchiveCompression::None)) {
+        return MappedFile::FromView(stored);
+    }
+
+    std::vector<std::byte> buffer(entry->size);
+    if (!utils::lz4_decompress(stored, buffer)) {
+        ENGINE_LOG_ERROR("Entry '{}' of asset archive '{}' is corrupt.", path, m_filepath);
+        return std::unexpected(Error::FileReadError);
+    }
+    return MappedFile::FromBuffer(std::move(buffer));
+}
+
+const AssetArchive::Entry *AssetArchive::Find(StringView normalized_path) const
+{
+    const u64 hash{utils::fnv1a(normalized_path)};
+    auto entry{std::ranges::lower_bound(m_entries, hash, {}, &Entry::path_hash)};
+    for (; entry != m_entries.end() && entry->path_hash == hash; ++entry) {
+        if (GetPath(*entry) == normalized_path) {
+            return &*entry;
+        }
+    }
+    return nullptr;
+}
+
+StringView AssetArchive::GetPath(const Entry &entry) const
+{
+    return m_paths.substr(entry.path_offset, entry.path_length);
+}
+
+// Mounted archives -------------------------------------------------------------------------------
+
+Expect<void, Error> MountArchive(StringView filepath)
+{
+    auto archive{AssetArchive::Open(filepath)};
+    if (!archive) {
+        return std::unexpected(archive.error());
+    }
+
+    ENGINE_LOG_INFO("Mounted asset archive '{}' with {} entries.", filepath, archive->GetEntryCount());
+    internal::mounted_archives().push_back(std::move(*archive));
+    return {};
+}
+
+void UnmountArchives() { internal::mounted_archives().clear(); }
+
+const AssetArchive *FindMountedArchive(StringView path)
+{
+    const Vector<AssetArchive> &archives{internal::mounted_archives()};
+    if (archives.empty()) {
+        return nullptr; // Loose files only, no need to normalize the path
+    }
+
+    for (auto archive{archives.rbegin()}; archive != archives.rend(); ++archive) {
+        if (archive->Contains(path)) {
+            return &*archive;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace gouda::fs
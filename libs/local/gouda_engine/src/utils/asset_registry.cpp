@@ -0,0 +1,318 @@
+/**
+ * @file utils/asset_registry.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine deduplicated, reference counted asset handles implementation
+ */
+#include "utils/asset_registry.hpp"
+
+#include <algorithm>
+
+#include "debug/assert.hpp"
+#include "debug/logger.hpp"
+#include "renderers/vulkan/vk_renderer.hpp"
+#include "renderers/vulkan/vk_texture_manager.hpp"
+#include "utils/asset_archive.hpp"
+#include "utils/hash.hpp"
+
+namespace gouda {
+
+namespace internal {
+
+// Paths are normalized like the archives store them, so a file is found under one key mounted or loose
+[[nodiscard]] static u64 asset_key(const AssetType type, const String &filepath, u64 seed = utils::FNV1A_OFFSET_BASIS)
+{
+    return utils::mix64(utils::fnv1a(filepath, seed) ^ static_cast<u64>(type));
+}
+
+[[nodiscard]] static u64 asset_key(const AssetType type, const String &image_filepath, const String &json_filepath)
+{
+    return asset_key(type, json_filepath, utils::fnv1a(image_filepath));
+}
+
+[[nodiscard]] static constexpr StringView asset_type_name(const AssetType type) noexcept
+{
+    switch (type) {
+        case AssetType::Texture:
+            return "texture";
+        case AssetType::Atlas:
+            return "atlas";
+        case AssetType::Font:
+            return "font";
+        case AssetType::Sound:
+            return "sound";
+        case AssetType::Music:
+            return "music";
+    }
+    return "asset";
+}
+
+} // namespace internal
+
+AssetRegistry::AssetRegistry(vk::Renderer *renderer, audio::SoundBank *sound_bank)
+    : p_renderer{renderer},
+      p_sound_bank{sound_bank},
+      m_frame{0},
+      m_unload_delay_frames{DEFAULT_UNLOAD_DELAY_FRAMES},
+      m_deduplicated_load_count{0}
+{
+}
+
+AssetRegistry::~AssetRegistry() = default;
+
+TextureHandle AssetRegistry::LoadTexture(StringView filepath)
+{
+    const String normalized{fs::AssetArchive::NormalizePath(filepath)};
+    const u64 key{internal::asset_key(AssetType::Texture, normalized)};
+    if (const u32 index{Acquire(key)}; index != INVALID_INDEX) {
+        return TextureHandle{index};
+    }
+    const u32 texture_id{p_renderer->LoadSingleTextureAsync(filepath)};
+    return TextureHandle{Register(key, normalized, {}, AssetType::Texture, texture_id)};
+}
+
+AtlasHandle AssetRegistry::LoadAtlas(StringView image_filepath, StringView json_filepath)
+{
+    const String normalized{fs::AssetArchive::NormalizePath(image_filepath)};
+    const String normalized_json{fs::AssetArchive::NormalizePath(json_filepath)};
+    const u64 key{internal::asset_key(AssetType::Atlas, normalized, normalized_json)};
+    if (const u32 index{Acquire(key)}; index != INVALID_INDEX) {
+        return AtlasHandle{index};
+    }
+    const u32 texture_id{p_renderer->LoadAtlasTextureAsync(image_filepath, json_filepath)};
+    return AtlasHandle{Register(key, normalized, normalized_json, AssetType::Atlas, texture_id)};
+}
+
+FontHandle AssetRegistry::LoadFont(StringView image_filepath, StringView json_filepath)
+{
+    const String normalized{fs::AssetArchive::NormalizePath(image_filepath)};
+    const String normalized_json{fs::AssetArchive::NormalizePath(json_filepath)};
+    const u64 key{internal::asset_key(AssetType::Font, normalized, normalized_json)};
+    if (const u32 index{Acquire(key)}; index != INVALID_INDEX) {
+        return FontHandle{index};
+    }
+    const u32 font_id{p_renderer->LoadMSDFFont(image_filepath, json_filepath)};
+    return FontHandle{Register(key, normalized, normalized_json, AssetType::Font, font_id)};
+}
+
+SoundHandle AssetRegistry::LoadSound(StringView filepath)
+{
+    const String normalized{fs::AssetArchive::NormalizePath(filepath)};
+    const u64 key{internal::asset_key(AssetType::Sound, normalized)};
+    if (const u32 index{Acquire(key)}; index != INVALID_INDEX) {
+        return SoundHandle{index};
+    }
+    return SoundHandle{Register(key, normalized, {}, AssetType::Sound, p_sound_bank->Load(filepath))};
+}
+
+MusicHandle AssetRegistry::LoadMusic(StringView filepath)
+{
+    const String normalized{fs::AssetArchive::NormalizePath(filepath)};
+    const u64 key{internal::asset_key(AssetType::Music, normalized)};
+    if (const u32 index{Acquire(key)}; index != INVALID_INDEX) {
+        return MusicHandle{index};
+    }
+
+    // A track that fails to open is still registered, like a sound that fails to decode, so it is not retried
+    auto track = std::make_unique<audio::MusicTrack>();
+    if (!track->Load(filepath)) {
+        ENGINE_LOG_ERROR("Failed to load music track '{}'.", filepath);
+    }
+    const u32 track_index{static_cast<u32>(m_music.size())};
+    m_music.push_back(std::move(track));
+    return MusicHandle{Register(key, normalized, {}, AssetType::Music, track_index)};
+}
+
+void AssetRegistry::RemoveDependent(const AssetDependentID dependent) { m_dependents.Erase(dependent); }
+
+void AssetRegistry::Update()
+{
+    ++m_frame;
+
+    FindChangedEntries();
+    if (!m_changed_entries.empty()) {
+        RederiveDependents();
+    }
+
+    for (size_t i = 0; i < m_released_entries.size();) {
+        Entry &entry{m_entries[m_released_entries[i]]};
+        if (entry.reference_count > 0 || !entry.resident) {
+            m_released_entries[i] = m_released_entries.back();
+            m_released_entries.pop_back();
+            continue;
+        }
+        if (entry.released_frame + m_unload_delay_frames > m_frame) {
+            ++i;
+            continue;
+        }
+        Unload(entry);
+        m_released_entries[i] = m_released_entries.back();
+        m_released_entries.pop_back();
+    }
+}
+
+u32 AssetRegistry::GetTextureID(const TextureHandle handle) const
+{
+    return GetEntry(handle.GetIndex(), AssetType::Texture).id;
+}
+
+u32 AssetRegistry::GetTextureID(const AtlasHandle handle) const
+{
+    return GetEntry(handle.GetIndex(), AssetType::Atlas).id;
+}
+
+u32 AssetRegistry::GetFontID(const FontHandle handle) const { return GetEntry(handle.GetIndex(), AssetType::Font).id; }
+
+audio::SoundID AssetRegistry::GetSoundID(const SoundHandle handle) const
+{
+    return GetEntry(handle.GetIndex(), AssetType::Sound).id;
+}
+
+audio::MusicTrack &AssetRegistry::GetMusic(const MusicHandle handle) const
+{
+    return *m_music[GetEntry(handle.GetIndex(), AssetType::Music).id];
+}
+
+u32 AssetRegistry::Acquire(const u64 key)
+{
+    const u32 *index{m_entry_indices.get(key)};
+    if (index == nullptr) {
+        return INVALID_INDEX;
+    }
+
+    Entry &entry{m_entries[*index]};
+    ++entry.reference_count;
+    ++m_deduplicated_load_count;
+
+    // Unloaded textures come back through the residency streaming, the slot still knows its file
+    if (!entry.resident) {
+        entry.resident = true;
+        ENGINE_LOG_DEBUG("Reloading {} '{}'.", internal::asset_type_name(entry.type), entry.filepath);
+    }
+    return *index;
+}
+
+u32 AssetRegistry::Register(const u64 key, StringView filepath, StringView json_filepath, const AssetType type,
+                            const u32 id)
+{
+    const u32 index{static_cast<u32>(m_entries.size())};
+    m_entries.push_back(Entry{String{filepath}, String{json_filepath}, type, id, 1, 0, true});
+    m_entry_indices.insert_or_assign(key, index);
+    return index;
+}
+
+AssetDependentID AssetRegistry::AddDependentOf(std::function<void()> rederive,
+                                              const std::initializer_list<u32> entry_indices)
+{
+    Dependent dependent{std::move(rederive), {}};
+    for (const u32 index : entry_indices) {
+        dependent.entry_indices.push_back(index);
+    }
+    return m_dependents.Insert(std::move(dependent));
+}
+
+void AssetRegistry::FindChangedEntries()
+{
+    if (p_renderer == nullptr) {
+        return;
+    }
+    const Vector<String> changed_files{p_renderer->TakeChangedFiles()};
+    if (changed_files.empty()) {
+        return;
+    }
+
+    // The watcher reports paths as they were loaded, the entries hold them normalized
+    Vector<String> normalized_files;
+    normalized_files.reserve(changed_files.size());
+    for (const String &filepath : changed_files) {
+        normalized_files.push_back(fs::AssetArchive::NormalizePath(filepath));
+    }
+    const auto is_changed = [&normalized_files](const String &filepath) {
+        return !filepath.empty() && std::ranges::find(normalized_files, filepath) != normalized_files.end();
+    };
+
+    for (u32 index = 0; index < m_entries.size(); ++index) {
+        const Entry &entry{m_entries[index]};
+        if (is_changed(entry.filepath) || is_changed(entry.json_filepath)) {
+            ENGINE_LOG_DEBUG("{} '{}' changed.", internal::asset_type_name(entry.type), entry.filepath);
+            m_changed_entries.push_back(index);
+        }
+    }
+}
+
+void AssetRegistry::RederiveDependents()
+{
+    // Collected up front, callbacks may add or remove dependents while they run
+    Vector<AssetDependentID> affected;
+    for (size_t i = 0; i < m_dependents.Size(); ++i) {
+        const Dependent &dependent{m_dependents.Data()[i]};
+        if (std::ranges::any_of(dependent.entry_indices, [this](const u32 index) {
+                return std::ranges::find(m_changed_entries, index) != m_changed_entries.end();
+            })) {
+            affected.push_back(m_dependents.GetHandle(i));
+        }
+    }
+    m_changed_entries.clear();
+
+    for (const AssetDependentID id : affected) {
+        if (const Dependent *dependent{m_dependents.Get(id)}; dependent != nullptr) {
+            const std::function<void()> rederive{dependent->rederive}; // Survives the callback removing itself
+            rederive();
+        }
+    }
+    ENGINE_LOG_DEBUG("Derived the data of {} asset dependent(s) again.", affected.size());
+}
+
+void AssetRegistry::AddReference(const u32 index, const AssetType type)
+{
+    if (index == INVALID_INDEX) {
+        return;
+    }
+    GetEntry(index, type);
+    ++m_entries[index].reference_count;
+}
+
+void AssetRegistry::Release(const u32 index, const AssetType type)
+{
+    if (index == INVALID_INDEX) {
+        return;
+    }
+    GetEntry(index, type);
+
+    Entry &entry{m_entries[index]};
+    ASSERT(entry.reference_count > 0, "Asset '{}' released more often than it was loaded.", entry.filepath);
+    if (--entry.reference_count == 0) {
+        entry.released_frame = m_frame;
+        // Only textures have an unload, the other owners keep what they loaded until shutdown
+        if (entry.resident && (entry.type == AssetType::Texture || entry.type == AssetType::Atlas)) {
+            m_released_entries.push_back(index);
+        }
+    }
+}
+
+void AssetRegistry::Unload(Entry &entry)
+{
+    ENGINE_LOG_DEBUG("Unloading {} '{}'.", internal::asset_type_name(entry.type), entry.filepath);
+    p_renderer->GetTextureManager()->ReleaseTexture(entry.id);
+    entry.resident = false;
+}
+
+u32 AssetRegistry::FindEntry(const AssetType type, const u32 id) const
+{
+    for (u32 index = 0; index < m_entries.size(); ++index) {
+        if (m_entries[index].type == type && m_entries[index].id == id) {
+            return index;
+        }
+    }
+    return INVALID_INDEX;
+}
+
+const AssetRegistry::Entry &AssetRegistry::GetEntry(const u32 index, const AssetType type) const
+{
+    ASSERT(index < m_entries.size(), "Asset handle {} is not registered.", index);
+    ASSERT(m_entries[index].type == type, "Asset handle {} is a {}, not a {}.", index,
+           internal::asset_type_name(m_entries[index].type), internal::asset_type_name(type));
+    return m_entries[index];
+}
+
+} // namespace gouda
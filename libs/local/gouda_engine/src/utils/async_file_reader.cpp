@@ -0,0 +1,634 @@
+/**
+ * @file utils/async_file_reader.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine asynchronous whole file reads implementation
+ */
+#include "utils/async_file_reader.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <format>
+#include <utility>
+
+#include "debug/logger.hpp"
+#include "math/math.hpp"
+#include "utils/thread.hpp"
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define ASYNC_READ_IO_URING
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#elif defined(_WIN32)
+#define ASYNC_READ_IOCP
+#include <windows.h>
+#endif
+
+namespace gouda::fs {
+
+namespace internal {
+
+// Larger files are read in several chunks, both APIs take 32 bit lengths
+constexpr size_t MAX_CHUNK_SIZE{size_t{1} << 30};
+
+// Tags the completion that wakes the service thread, read completions carry their slot index
+constexpr u64 WAKE_TAG{constants::u64_max};
+
+} // namespace internal
+
+#if defined(ASYNC_READ_IO_URING)
+
+namespace internal {
+
+constexpr AsyncReadBackend PLATFORM_BACKEND{AsyncReadBackend::IoUring};
+
+// Raw system calls, so there is no dependency on liburing
+static int ring_setup(const u32 entries, io_uring_params &params)
+{
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+}
+
+static int ring_enter(const int ring, const u32 to_submit, const u32 min_complete)
+{
+    return static_cast<int>(
+        syscall(__NR_io_uring_enter, ring, to_submit, min_complete, IORING_ENTER_GETEVENTS, nullptr, 0));
+}
+
+} // namespace internal
+
+// io_uring implementation --------------------------------------------------------------------------
+
+struct AsyncFileReader::PlatformQueue {
+    struct InFlightRead {
+        Request request;
+        std::vector<std::byte> data;
+        size_t offset{0};
+        int file{-1};
+    };
+
+    PlatformQueue() = default;
+    PlatformQueue(const PlatformQueue &) = delete;
+    PlatformQueue &operator=(const PlatformQueue &) = delete;
+
+    ~PlatformQueue()
+    {
+        if (p_sqes != MAP_FAILED) {
+            munmap(p_sqes, m_sqes_size);
+        }
+        if (p_cq_ring != MAP_FAILED && p_cq_ring != p_sq_ring) {
+            munmap(p_cq_ring, m_cq_ring_size);
+        }
+        if (p_sq_ring != MAP_FAILED) {
+            munmap(p_sq_ring, m_sq_ring_size);
+        }
+        if (m_ring >= 0) {
+            close(m_ring);
+        }
+        if (m_wake_event >= 0) {
+            close(m_wake_event);
+        }
+    }
+
+    bool Open(const u32 max_reads)
+    {
+        // One entry more than reads in flight, for the wake poll
+        io_uring_params params{};
+        m_ring = internal::ring_setup(max_reads + 1, params);
+        if (m_ring < 0) {
+            ENGINE_LOG_WARNING("io_uring is unavailable: {}", std::strerror(errno));
+            return false;
+        }
+
+        m_sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(u32);
+        m_cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool is_single_mmap{(params.features & IORING_FEAT_SINGLE_MMAP) != 0};
+        if (is_single_mmap) {
+            m_sq_ring_size = std::max(m_sq_ring_size, m_cq_ring_size);
+        }
+
+        p_sq_ring = mmap(nullptr, m_sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ring,
+                         IORING_OFF_SQ_RING);
+        if (p_sq_ring == MAP_FAILED) {
+            return false;
+        }
+        p_cq_ring = is_single_mmap ? p_sq_ring
+                                   : mmap(nullptr, m_cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                          m_ring, IORING_OFF_CQ_RING);
+        m_sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+        p_sqes = mmap(nullptr, m_sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ring, IORING_OFF_SQES);
+        m_wake_event = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        if (p_cq_ring == MAP_FAILED || p_sqes == MAP_FAILED || m_wake_event < 0) {
+            return false;
+        }
+
+        auto *sq{static_cast<std::byte *>(p_sq_ring)};
+        p_sq_head = reinterpret_cast<u32 *>(sq + params.sq_off.head);
+        p_sq_tail = reinterpret_cast<u32 *>(sq + params.sq_off.tail);
+        p_sq_array = reinterpret_cast<u32 *>(sq + params.sq_off.array);
+        m_sq_mask = *reinterpret_cast<const u32 *>(sq + params.sq_off.ring_mask);
+        m_sq_entries = params.sq_entries;
+
+        auto *cq{static_cast<std::byte *>(p_cq_ring)};
+        p_cq_head = reinterpret_cast<u32 *>(cq + params.cq_off.head);
+        p_cq_tail = reinterpret_cast<u32 *>(cq + params.cq_off.tail);
+        p_cqes = reinterpret_cast<const io_uring_cqe *>(cq + params.cq_off.cqes);
+        m_cq_mask = *reinterpret_cast<const u32 *>(cq + params.cq_off.ring_mask);
+
+        // The kernel may round the ring up, the extra entries are not used
+        m_reads.resize(max_reads);
+        m_free_reads.reserve(max_reads);
+        for (u32 i = max_reads; i > 0; --i) {
+            m_free_reads.push_back(i - 1);
+        }
+        return true;
+    }
+
+    void Wake() const { eventfd_write(m_wake_event, 1); }
+
+    void Run(AsyncFileReader &reader)
+    {
+        QueueWakePoll();
+
+        u32 active_reads{0};
+        while (true) {
+            Request request;
+            while (!m_free_reads.empty() && reader.TakeRequest(request)) {
+                if (StartRead(reader, request)) {
+                    ++active_reads;
+                }
+            }
+            if (active_reads == 0 && reader.m_is_stopping.load(std::memory_order_acquire)) {
+                break;
+            }
+
+            const int submitted{internal::ring_enter(m_ring, m_unsubmitted, 1)};
+            if (submitted >= 0) {
+                m_unsubmitted -= static_cast<u32>(submitted);
+            }
+            else if (errno != EINTR) {
+                ENGINE_LOG_ERROR("io_uring_enter failed: {}", std::strerror(errno));
+            }
+
+            u32 head{*p_cq_head};
+            const u32 tail{std::atomic_ref{*p_cq_tail}.load(std::memory_order_acquire)};
+            for (; head != tail; ++head) {
+                const io_uring_cqe cqe{p_cqes[head & m_cq_mask]};
+                if (cqe.user_data == internal::WAKE_TAG) {
+                    eventfd_t value;
+                    eventfd_read(m_wake_event, &value);
+                    QueueWakePoll();
+                    continue;
+                }
+
+                const auto slot{static_cast<u32>(cqe.user_data)};
+                InFlightRead &read{m_reads[slot]};
+                if (cqe.res == -EINTR || cqe.res == -EAGAIN) {
+                    QueueRead(slot);
+                    continue;
+                }
+
+                // Zero bytes before the end means the file shrank since it was opened
+                if (cqe.res > 0) {
+                    read.offset += static_cast<size_t>(cqe.res);
+                    if (read.offset < read.data.size()) {
+                        QueueRead(slot);
+                        continue;
+                    }
+                }
+                FinishRead(reader, slot, cqe.res > 0);
+                --active_reads;
+            }
+            std::atomic_ref{*p_cq_head}.store(head, std::memory_order_release);
+        }
+    }
+
+private:
+    bool StartRead(AsyncFileReader &reader, Request &request)
+    {
+        const int file{open(request.filepath.c_str(), O_RDONLY | O_CLOEXEC)};
+        if (file < 0) {
+            reader.Complete(request, std::unexpected(Error::FileNotFound));
+            return false;
+        }
+
+        struct stat status{};
+        if (fstat(file, &status) != 0 || status.st_size <= 0) {
+            close(file);
+            reader.Complete(request, std::unexpected(Error::FileReadError));
+            return false;
+        }
+
+        const u32 slot{m_free_reads.back()};
+        m_free_reads.pop_back();
+        InFlightRead &read{m_reads[slot]};
+        read.request = std::move(request);
+        read.data.resize(static_cast<size_t>(status.st_size));
+        read.offset = 0;
+        read.file = file;
+
+        if (!QueueRead(slot)) {
+            FinishRead(reader, slot, false);
+            return false;
+        }
+        return true;
+    }
+
+    void FinishRead(AsyncFileReader &reader, const u32 slot, const bool is_success)
+    {
+        InFlightRead &read{m_reads[slot]};
+        close(read.file);
+        read.file = -1;
+
+        AsyncReadResult result{std::unexpected(Error::FileReadError)};
+        if (is_success) {
+            result = std::move(read.data);
+        }
+        read.data = {};
+        reader.Complete(read.request, std::move(result));
+        m_free_reads.push_back(slot);
+    }
+
+    bool QueueRead(const u32 slot)
+    {
+        InFlightRead &read{m_reads[slot]};
+        io_uring_sqe sqe{};
+        sqe.opcode = IORING_OP_READ;
+        sqe.fd = read.file;
+        sqe.off = read.offset;
+        sqe.addr = reinterpret_cast<u64>(read.data.data() + read.offset);
+        sqe.len = static_cast<u32>(std::min(read.data.size() - read.offset, internal::MAX_CHUNK_SIZE));
+        sqe.user_data = slot;
+        return Push(sqe);
+    }
+
+    bool QueueWakePoll()
+    {
+        io_uring_sqe sqe{};
+        sqe.opcode = IORING_OP_POLL_ADD;
+        sqe.fd = m_wake_event;
+        sqe.poll32_events = POLLIN;
+        sqe.user_data = internal::WAKE_TAG;
+        return Push(sqe);
+    }
+
+    // Only the service thread writes the tail, the kernel reads the entries on the next io_uring_enter
+    bool Push(const io_uring_sqe &sqe)
+    {
+        const u32 tail{*p_sq_tail};
+        if (tail - std::atomic_ref{*p_sq_head}.load(std::memory_order_acquire) == m_sq_entries) {
+            return false;
+        }
+
+        const u32 index{tail & m_sq_mask};
+        static_cast<io_uring_sqe *>(p_sqes)[index] = sqe;
+        p_sq_array[index] = index;
+        std::atomic_ref{*p_sq_tail}.store(tail + 1, std::memory_order_release);
+        ++m_unsubmitted;
+        return true;
+    }
+
+private:
+    int m_ring{-1};
+    int m_wake_event{-1};
+
+    void *p_sq_ring{MAP_FAILED};
+    void *p_cq_ring{MAP_FAILED};
+    void *p_sqes{MAP_FAILED};
+    size_t m_sq_ring_size{0};
+    size_t m_cq_ring_size{0};
+    size_t m_sqes_size{0};
+
+    u32 *p_sq_head{nullptr};
+    u32 *p_sq_tail{nullptr};
+    u32 *p_sq_array{nullptr};
+    u32 m_sq_mask{0};
+    u32 m_sq_entries{0};
+    u32 m_unsubmitted{0}; // Entries pushed since the last io_uring_enter
+
+    u32 *p_cq_head{nullptr};
+    u32 *p_cq_tail{nullptr};
+    const io_uring_cqe *p_cqes{nullptr};
+    u32 m_cq_mask{0};
+
+    Vector<InFlightRead> m_reads;
+    Vector<u32> m_free_reads;
+};
+
+#elif defined(ASYNC_READ_IOCP)
+
+namespace internal {
+
+constexpr AsyncReadBackend PLATFORM_BACKEND{AsyncReadBackend::CompletionPort};
+
+} // namespace internal
+
+// I/O completion port implementation ---------------------------------------------------------------
+
+struct AsyncFileReader::PlatformQueue {
+    struct InFlightRead {
+        Request request;
+        std::vector<std::byte> data;
+        size_t offset{0};
+        HANDLE file{INVALID_HANDLE_VALUE};
+    };
+
+    PlatformQueue() = default;
+    PlatformQueue(const PlatformQueue &) = delete;
+    PlatformQueue &operator=(const PlatformQueue &) = delete;
+
+    ~PlatformQueue()
+    {
+        if (m_port != nullptr) {
+            CloseHandle(m_port);
+        }
+    }
+
+    bool Open(const u32 max_reads)
+    {
+        m_port = CreateIoCompletionPort(INVALID_HANDLE_VALUE, nullptr, 0, 1);
+        if (m_port == nullptr) {
+            ENGINE_LOG_WARNING("Cannot create an I/O completion port: error {}", GetLastError());
+            return false;
+        }
+
+        m_reads.resize(max_reads);
+        m_overlapped.resize(max_reads);
+        m_free_reads.reserve(max_reads);
+        for (u32 i = max_reads; i > 0; --i) {
+            m_free_reads.push_back(i - 1);
+        }
+        return true;
+    }
+
+    void Wake() const { PostQueuedCompletionStatus(m_port, 0, static_cast<ULONG_PTR>(internal::WAKE_TAG), nullptr); }
+
+    void Run(AsyncFileReader &reader)
+    {
+        u32 active_reads{0};
+        while (true) {
+            Request request;
+            while (!m_free_reads.empty() && reader.TakeRequest(request)) {
+                if (StartRead(reader, request)) {
+                    ++active_reads;
+                }
+            }
+            if (active_reads == 0 && reader.m_is_stopping.load(std::memory_order_acquire)) {
+                break;
+            }
+
+            DWORD bytes{0};
+            ULONG_PTR key{0};
+            OVERLAPPED *p_completed{nullptr};
+            const BOOL is_success{GetQueuedCompletionStatus(m_port, &bytes, &key, &p_completed, INFINITE)};
+            if (p_completed == nullptr) {
+                if (is_success == 0) {
+                    ENGINE_LOG_ERROR("GetQueuedCompletionStatus failed: error {}", GetLastError());
+                }
+                continue; // Woken up
+            }
+
+            const auto slot{static_cast<u32>(p_completed - m_overlapped.data())};
+            InFlightRead &read{m_reads[slot]};
+
+            // Zero bytes before the end means the file shrank since it was opened
+            if (is_success != 0 && bytes > 0) {
+                read.offset += bytes;
+                if (read.offset < read.data.size() && QueueRead(slot)) {
+                    continue;
+                }
+            }
+            FinishRead(reader, slot, is_success != 0 && read.offset == read.data.size());
+            --active_reads;
+        }
+    }
+
+private:
+    bool StartRead(AsyncFileReader &reader, Request &request)
+    {
+        const HANDLE file{CreateFileW(FilePath{request.filepath}.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                      OPEN_EXISTING, FILE_FLAG_OVERLAPPED | FILE_FLAG_SEQUENTIAL_SCAN, nullptr)};
+        if (file == INVALID_HANDLE_VALUE) {
+            reader.Complete(request, std::unexpected(Error::FileNotFound));
+            return false;
+        }
+
+        LARGE_INTEGER file_size{};
+        if (GetFileSizeEx(file, &file_size) == 0 || file_size.QuadPart <= 0 ||
+            CreateIoCompletionPort(file, m_port, 0, 0) == nullptr) {
+            CloseHandle(file);
+            reader.Complete(request, std::unexpected(Error::FileReadError));
+            return false;
+        }
+
+        const u32 slot{m_free_reads.back()};
+        m_free_reads.pop_back();
+        InFlightRead &read{m_reads[slot]};
+        read.request = std::move(request);
+        read.data.resize(static_cast<size_t>(file_size.QuadPart));
+        read.offset = 0;
+        read.file = file;
+
+        if (!QueueRead(slot)) {
+            FinishRead(reader, slot, false);
+            return false;
+        }
+        return true;
+    }
+
+    void FinishRead(AsyncFileReader &reader, const u32 slot, const bool is_success)
+    {
+        InFlightRead &read{m_reads[slot]};
+        CloseHandle(read.file);
+        read.file = INVALID_HANDLE_VALUE;
+
+        AsyncReadResult result{std::unexpected(Error::FileReadError)};
+        if (is_success) {
+            result = std::move(read.data);
+        }
+        read.data = {};
+        reader.Complete(read.request, std::move(result));
+        m_free_reads.push_back(slot);
+    }
+
+    // Completes through the port even when ReadFile finishes straight away
+    bool QueueRead(const u32 slot)
+    {
+        InFlightRead &read{m_reads[slot]};
+        OVERLAPPED &overlapped{m_overlapped[slot]};
+        overlapped = OVERLAPPED{};
+        overlapped.Offset = static_cast<DWORD>(read.offset);
+        overlapped.OffsetHigh = static_cast<DWORD>(static_cast<u64>(read.offset) >> 32);
+
+        const auto size{static_cast<DWORD>(std::min(read.data.size() - read.offset, internal::MAX_CHUNK_SIZE))};
+        return ReadFile(read.file, read.data.data() + read.offset, size, nullptr, &overlapped) != 0 ||
+               GetLastError() == ERROR_IO_PENDING;
+    }
+
+private:
+    HANDLE m_port{nullptr};
+    Vector<InFlightRead> m_reads;
+    Vector<OVERLAPPED> m_overlapped; // Parallel to m_reads, written by the kernel until the read completes
+    Vector<u32> m_free_reads;
+};
+
+#else
+
+namespace internal {
+
+constexpr AsyncReadBackend PLATFORM_BACKEND{AsyncReadBackend::ThreadPool};
+
+} // namespace internal
+
+// Without a platform queue every read goes to the pool threads
+struct AsyncFileReader::PlatformQueue {
+    bool Open(u32) { return false; }
+    void Wake() const {}
+    void Run(AsyncFileReader &) {}
+};
+
+#endif
+
+// AsyncFileReader implementation ------------------------------------------------------------------
+
+AsyncFileReader::AsyncFileReader(const u32 max_reads_in_flight, const u32 fallback_thread_count)
+    : m_backend{AsyncReadBackend::ThreadPool},
+      m_max_reads_in_flight{math::max(max_reads_in_flight, 1u)},
+      p_queue{std::make_unique<PlatformQueue>()},
+      m_pending_count{0},
+      m_is_stopping{false}
+{
+    if (p_queue->Open(m_max_reads_in_flight)) {
+        m_backend = internal::PLATFORM_BACKEND;
+        m_threads.push_back(MakeThread("File reader", ThreadPriority::IO, [this] { ServiceLoop(); }));
+    }
+    else {
+        p_queue.reset();
+        const u32 thread_count{math::max(fallback_thread_count, 1u)};
+        m_threads.reserve(thread_count);
+        for (u32 i = 0; i < thread_count; ++i) {
+            m_threads.push_back(MakeThread(std::format("File reader {}", i + 1), ThreadPriority::IO,
+                                           [this](const std::stop_token &stop_token) { PoolLoop(stop_token); }));
+        }
+    }
+
+    ENGINE_LOG_DEBUG("Async file reader started: {}, {} reads in flight.", GetAsyncReadBackendName(m_backend),
+                     p_queue ? m_max_reads_in_flight : static_cast<u32>(m_threads.size()));
+}
+
+AsyncFileReader::~AsyncFileReader()
+{
+    std::deque<Request> cancelled;
+    {
+        std::lock_guard lock{m_mutex};
+        m_is_stopping.store(true, std::memory_order_release);
+        cancelled = std::exchange(m_requests, {});
+    }
+    for (Request &request : cancelled) {
+        Complete(request, std::unexpected(Error::ReadCancelled));
+    }
+
+    // Pool threads wake up on the stop request, the service thread once its reads in flight completed
+    for (auto &thread : m_threads) {
+        thread.request_stop();
+    }
+    if (p_queue) {
+        p_queue->Wake();
+    }
+    m_threads.clear();
+}
+
+void AsyncFileReader::Read(StringView filepath, Callback callback)
+{
+    m_pending_count.fetch_add(1, std::memory_order_relaxed);
+    {
+        std::lock_guard lock{m_mutex};
+        m_requests.push_back(Request{String{filepath}, std::move(callback)});
+    }
+    Wake();
+}
+
+std::future<AsyncReadResult> AsyncFileReader::Read(StringView filepath)
+{
+    auto promise{std::make_shared<std::promise<AsyncReadResult>>()};
+    std::future<AsyncReadResult> future{promise->get_future()};
+    Read(filepath, [promise](AsyncReadResult result) { promise->set_value(std::move(result)); });
+    return future;
+}
+
+void AsyncFileReader::ServiceLoop() { p_queue->Run(*this); }
+
+void AsyncFileReader::PoolLoop(const std::stop_token &stop_token)
+{
+    while (true) {
+        Request request;
+        {
+            std::unique_lock lock{m_mutex};
+            if (!m_request_condition.wait(lock, stop_token, [this] { return !m_requests.empty(); })) {
+                return;
+            }
+            request = std::move(m_requests.front());
+            m_requests.pop_front();
+        }
+        Complete(request, ReadBinaryFile(request.filepath));
+    }
+}
+
+void AsyncFileReader::Wake()
+{
+    if (p_queue) {
+        p_queue->Wake();
+    }
+    else {
+        m_request_condition.notify_one();
+    }
+}
+
+bool AsyncFileReader::TakeRequest(Request &request)
+{
+    std::lock_guard lock{m_mutex};
+    if (m_requests.empty()) {
+        return false;
+    }
+    request = std::move(m_requests.front());
+    m_requests.pop_front();
+    return true;
+}
+
+void AsyncFileReader::Complete(Request &request, AsyncReadResult result)
+{
+    try {
+        request.callback(std::move(result));
+    }
+    catch (const std::exception &error) {
+        ENGINE_LOG_ERROR("Read callback for '{}' failed: {}", request.filepath, error.what());
+    }
+    catch (...) {
+        ENGINE_LOG_ERROR("Read callback for '{}' failed with an unknown exception.", request.filepath);
+    }
+    request = {};
+    m_pending_count.fetch_sub(1, std::memory_order_release);
+}
+
+StringView GetAsyncReadBackendName(const AsyncReadBackend backend)
+{
+    switch (backend) {
+        case AsyncReadBackend::IoUring:
+            return "io_uring";
+        case AsyncReadBackend::CompletionPort:
+            return "I/O completion port";
+        case AsyncReadBackend::ThreadPool:
+            return "Thread pool";
+    }
+    return "Unknown";
+}
+
+} // namespace gouda::fs
@@ -0,0 +1,44 @@
+/**
+ * @file utils/event_bus.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine typed event bus implementation
+ */
+#include "utils/event_bus.hpp"
+
+namespace gouda {
+
+EventBus::~EventBus() = default;
+
+void EventBus::Unsubscribe(const EventSubscription subscription)
+{
+    if (const u32 *index{m_queue_indices.get(subscription.type)}) {
+        m_queues[*index]->Unsubscribe(subscription.id);
+    }
+}
+
+void EventBus::Dispatch()
+{
+    // Indexed, a handler may emit a type seen for the first time, whose queue waits for the next dispatch anyway
+    for (size_t i = 0; i < m_queues.size(); ++i) {
+        m_queues[i]->Dispatch();
+    }
+}
+
+void EventBus::Clear()
+{
+    for (const std::unique_ptr<QueueBase> &queue : m_queues) {
+        queue->Clear();
+    }
+}
+
+size_t EventBus::GetPendingCount() const
+{
+    size_t count{0};
+    for (const std::unique_ptr<QueueBase> &queue : m_queues) {
+        count += queue->GetPendingCount();
+    }
+    return count;
+}
+
+} // namespace gouda
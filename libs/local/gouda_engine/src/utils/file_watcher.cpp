@@ -0,0 +1,187 @@
+/**
+ * @file utils/file_watcher.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine background file change watcher implementation
+ */
+#include "utils/file_watcher.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <utility>
+
+#include "debug/logger.hpp"
+#include "utils/thread.hpp"
+
+#if defined(__linux__)
+#define FILE_WATCHER_INOTIFY
+#include <cerrno>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace gouda::fs {
+
+namespace internal {
+
+constexpr auto POLL_INTERVAL{std::chrono::milliseconds{250}}; // Between write time checks when polling
+#if defined(FILE_WATCHER_INOTIFY)
+constexpr int NOTIFY_TIMEOUT_MS{100}; // Longest wait for a notification, bounds how long shutdown takes
+#endif
+
+} // namespace internal
+
+FileWatcher::FileWatcher() : m_has_changes{false}, m_notify_handle{-1}
+{
+#if defined(FILE_WATCHER_INOTIFY)
+    m_notify_handle = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_notify_handle < 0) {
+        ENGINE_LOG_WARNING("inotify unavailable ({}), polling watched files instead.", std::strerror(errno));
+    }
+#endif
+
+    m_thread = MakeThread("File watcher", ThreadPriority::IO,
+                          [this](const std::stop_token &stop_token) { WatchLoop(stop_token); });
+    ENGINE_LOG_DEBUG("File watcher started, {}.", IsNative() ? "using inotify" : "polling write times");
+}
+
+FileWatcher::~FileWatcher()
+{
+    m_thread.request_stop();
+    m_stop_condition.notify_all();
+    m_thread.join();
+
+#if defined(FILE_WATCHER_INOTIFY)
+    if (m_notify_handle >= 0) {
+        close(m_notify_handle); // Removes all watches with it
+    }
+#endif
+}
+
+bool FileWatcher::Watch(StringView filepath)
+{
+    std::lock_guard lock{m_mutex};
+    if (std::ranges::any_of(m_files, [&](const WatchedFile &file) { return file.filepath == filepath; })) {
+        return true;
+    }
+
+    std::error_code error;
+    FilePath path{std::filesystem::absolute(FilePath{filepath}, error)};
+    if (error) {
+        ENGINE_LOG_WARNING("Cannot watch '{}': {}", filepath, error.message());
+        return false;
+    }
+    path = path.lexically_normal();
+
+    // A missing file reads as the minimum time, so creating it later counts as a change
+    WatchedFile file{.filepath = String{filepath},
+                     .file_name = path.filename().string(),
+                     .last_write_time = std::filesystem::last_write_time(path, error),
+                     .watch_handle = -1};
+
+#if defined(FILE_WATCHER_INOTIFY)
+    if (m_notify_handle >= 0) {
+        // Watching the same directory again returns its existing handle
+        file.watch_handle =
+            inotify_add_watch(m_notify_handle, path.parent_path().c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+        if (file.watch_handle < 0) {
+            ENGINE_LOG_WARNING("Cannot watch '{}': {}", filepath, std::strerror(errno));
+            return false;
+        }
+    }
+#endif
+
+    m_files.push_back(std::move(file));
+    return true;
+}
+
+Vector<String> FileWatcher::PollChanges()
+{
+    if (!m_has_changes.load(std::memory_order_acquire)) {
+        return {};
+    }
+
+    std::lock_guard lock{m_mutex};
+    m_has_changes.store(false, std::memory_order_relaxed);
+    return std::exchange(m_changes, {});
+}
+
+void FileWatcher::WatchLoop(const std::stop_token &stop_token)
+{
+    while (!stop_token.stop_requested()) {
+        if (IsNative()) {
+            ReadNotifications();
+            continue;
+        }
+
+        PollWriteTimes();
+        std::unique_lock lock{m_mutex};
+        m_stop_condition.wait_for(lock, stop_token, internal::POLL_INTERVAL, [] { return false; });
+    }
+}
+
+void FileWatcher::ReadNotifications()
+{
+#if defined(FILE_WATCHER_INOTIFY)
+    pollfd poll_fd{.fd = m_notify_handle, .events = POLLIN, .revents = 0};
+    if (poll(&poll_fd, 1, internal::NOTIFY_TIMEOUT_MS) <= 0) {
+        return;
+    }
+
+    alignas(inotify_event) std::array<char, 4096> buffer;
+    const ssize_t length{read(m_notify_handle, buffer.data(), buffer.size())};
+    if (length <= 0) {
+        return;
+    }
+
+    std::lock_guard lock{m_mutex};
+    for (size_t offset = 0; offset < static_cast<size_t>(length);) {
+        inotify_event event{};
+        std::memcpy(&event, buffer.data() + offset, sizeof(event));
+
+        // The name is null terminated inside its padded length
+        const StringView name{event.len > 0 ? StringView{buffer.data() + offset + sizeof(event)} : StringView{}};
+        offset += sizeof(event) + event.len;
+
+        if ((event.mask & IN_Q_OVERFLOW) != 0) {
+            // Events were dropped, every file may have changed
+            for (const WatchedFile &file : m_files) {
+                PushChange(file.filepath);
+            }
+            continue;
+        }
+
+        for (const WatchedFile &file : m_files) {
+            if (file.watch_handle == event.wd && file.file_name == name) {
+                PushChange(file.filepath);
+            }
+        }
+    }
+#endif
+}
+
+void FileWatcher::PollWriteTimes()
+{
+    std::lock_guard lock{m_mutex};
+    for (WatchedFile &file : m_files) {
+        std::error_code error;
+        if (const FileTimeType write_time{std::filesystem::last_write_time(file.filepath, error)};
+            !error && write_time > file.last_write_time) {
+            file.last_write_time = write_time;
+            PushChange(file.filepath);
+        }
+    }
+}
+
+void FileWatcher::PushChange(const String &filepath)
+{
+    if (std::ranges::find(m_changes, filepath) == m_changes.end()) {
+        m_changes.push_back(filepath);
+    }
+    m_has_changes.store(true, std::memory_order_release);
+}
+
+} // namespace gouda::fs
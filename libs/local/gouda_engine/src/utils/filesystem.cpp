@@ -4,6 +4,7 @@
 
 #include "debug/logger.hpp"
 #include "debug/throw.hpp"
+#include "utils/asset_archive.hpp"
 
 
 namespace gouda::fs {
@@ -43,6 +44,14 @@ Expect<void, Error> EnsureDirectoryExists(const FilePath &path, const bool creat
 // Read an entire file into a string
 Expect<std::string, Error> ReadFile(StringView file_name)
 {
+    if (const AssetArchive *archive{FindMountedArchive(file_name)}) {
+        const auto entry{archive->Read(file_name)};
+        if (!entry) {
+            return std::unexpected(entry.error());
+        }
+        return String{entry->GetText()};
+    }
+
     FilePath file_path(file_name);
     std::ifstream file(file_path, std::ios::in);
 
@@ -74,8 +83,34 @@ Expect<void, Error> WriteFile(StringView file_name, const String &data)
     return {}; // Success
 }
 
+Expect<void, Error> AppendFile(StringView file_name, const String &data)
+{
+    if (file_name.empty()) {
+        return std::unexpected(Error::EmptyFileName);
+    }
+
+    std::ofstream file(FilePath(file_name), std::ios::out | std::ios::app);
+    if (!file) {
+        return std::unexpected(Error::FileWriteError);
+    }
+
+    file << data;
+    if (!file.flush()) {
+        return std::unexpected(Error::FileWriteError);
+    }
+    return {};
+}
+
 Expect<std::vector<std::byte>, Error> ReadBinaryFile(StringView file_name)
 {
+    if (const AssetArchive *archive{FindMountedArchive(file_name)}) {
+        const auto entry{archive->Read(file_name)};
+        if (!entry) {
+            return std::unexpected(entry.error());
+        }
+        return std::vector<std::byte>{entry->GetData().begin(), entry->GetData().end()};
+    }
+
     FilePath file_path(file_name);
     std::ifstream file(file_path, std::ios::binary | std::ios::ate); // Open at end
 
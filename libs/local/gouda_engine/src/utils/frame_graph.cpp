@@ -0,0 +1,127 @@
+/**
+ * @file utils/frame_graph.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine per frame task dependency graph implementation
+ */
+#include "utils/frame_graph.hpp"
+
+#include "debug/assert.hpp"
+#include "debug/logger.hpp"
+#include "debug/profiler.hpp"
+#include "utils/job_system.hpp"
+
+namespace gouda {
+
+FrameGraph::FrameGraph() : p_job_system{nullptr}, m_remaining_tasks{0} {}
+
+FrameGraph::TaskId FrameGraph::AddTask(const StringView name, Task task,
+                                       const std::initializer_list<TaskId> dependencies, const TaskThread thread)
+{
+    const auto id{static_cast<TaskId>(m_tasks.size())};
+    for (const TaskId dependency : dependencies) {
+        ASSERT(dependency < id, "Frame tasks can only depend on tasks added before them.");
+        m_tasks[dependency].dependants.push_back(id);
+    }
+    m_tasks.push_back(TaskEntry{.name = name,
+                                .task = std::move(task),
+                                .thread = thread,
+                                .dependants = {},
+                                .dependency_count = static_cast<u32>(dependencies.size()),
+                                .pending_dependencies = 0});
+    m_main_thread_ready.reserve(m_tasks.size()); // So running a frame never allocates
+    return id;
+}
+
+void FrameGraph::Run(JobSystem *job_system)
+{
+    // Without workers nothing else would run the tasks, in the order added every dependency ran before them
+    if (job_system == nullptr || job_system->GetWorkerCount() == 0) {
+        for (TaskEntry &entry : m_tasks) {
+            ENGINE_PROFILE_SCOPE(entry.name);
+            entry.task();
+        }
+        return;
+    }
+
+    ASSERT(job_system->IsMainThread(), "Frame graphs run from the main thread.");
+    p_job_system = job_system;
+    m_remaining_tasks = static_cast<u32>(m_tasks.size());
+    m_exception = nullptr;
+    for (TaskEntry &entry : m_tasks) {
+        entry.pending_dependencies = entry.dependency_count;
+    }
+
+    for (TaskId id = 0; id < m_tasks.size(); ++id) {
+        if (m_tasks[id].dependency_count == 0) {
+            Dispatch(id);
+        }
+    }
+
+    // The main thread only runs its own tasks, the workers take the rest
+    std::unique_lock lock{m_mutex};
+    while (true) {
+        m_condition.wait(lock, [this] { return !m_main_thread_ready.empty() || m_remaining_tasks == 0; });
+        if (m_main_thread_ready.empty()) {
+            break;
+        }
+        const TaskId id{m_main_thread_ready.front()};
+        m_main_thread_ready.erase(m_main_thread_ready.begin());
+        lock.unlock();
+        Execute(id);
+        lock.lock();
+    }
+    lock.unlock();
+
+    p_job_system = nullptr;
+    if (m_exception) {
+        std::rethrow_exception(m_exception);
+    }
+}
+
+void FrameGraph::Dispatch(const TaskId id)
+{
+    if (m_tasks[id].thread == TaskThread::Main) {
+        {
+            const std::lock_guard lock{m_mutex};
+            m_main_thread_ready.push_back(id);
+        }
+        m_condition.notify_one();
+        return;
+    }
+    // Small enough a capture for the job not to allocate
+    p_job_system->Schedule([this, id] { Execute(id); });
+}
+
+void FrameGraph::Execute(const TaskId id)
+{
+    TaskEntry &entry{m_tasks[id]};
+    try {
+        ENGINE_PROFILE_SCOPE(entry.name);
+        entry.task();
+    }
+    catch (...) {
+        ENGINE_LOG_ERROR("Frame task '{}' failed.", entry.name);
+        const std::lock_guard lock{m_mutex};
+        if (!m_exception) {
+            m_exception = std::current_exception();
+        }
+    }
+
+    SmallVector<TaskId, 4> ready;
+    {
+        const std::lock_guard lock{m_mutex};
+        for (const TaskId dependant : entry.dependants) {
+            if (--m_tasks[dependant].pending_dependencies == 0) {
+                ready.push_back(dependant);
+            }
+        }
+        --m_remaining_tasks;
+    }
+    for (const TaskId dependant : ready) {
+        Dispatch(dependant);
+    }
+    m_condition.notify_one();
+}
+
+} // namespace gouda
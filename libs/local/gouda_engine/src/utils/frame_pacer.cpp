@@ -0,0 +1,132 @@
+/**
+ * @file utils/frame_pacer.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine frame pacing implementation
+ */
+#include "utils/frame_pacer.hpp"
+
+#include <algorithm>
+#include <thread>
+
+namespace gouda::utils {
+
+namespace internal {
+
+// Sleeps are requested in slices this long, so the deadline is checked again after each one
+constexpr FloatingPointMilliseconds SLEEP_SLICE{1.0};
+constexpr FloatingPointMilliseconds MAX_PERIOD{1000.0};
+
+// Rises straight to a higher sample and moves a fraction of the way towards a lower one
+static FloatingPointMilliseconds track_peak(const FloatingPointMilliseconds estimate,
+                                            const FloatingPointMilliseconds sample, const f64 fall_rate)
+{
+    return sample > estimate ? sample : estimate + (sample - estimate) * fall_rate;
+}
+
+static SteadyClock::duration to_period(const f32 rate)
+{
+    const FloatingPointMilliseconds period{std::min(MAX_PERIOD.count(), 1000.0 / static_cast<f64>(rate))};
+    return std::chrono::duration_cast<SteadyClock::duration>(period);
+}
+
+} // namespace internal
+
+FramePacer::FramePacer()
+    : m_mode{PacingMode::Uncapped},
+      m_period{SteadyClock::duration::zero()},
+      m_next_frame_start{SteadyClock::now()},
+      m_frame_start{m_next_frame_start},
+      m_safety_margin{DEFAULT_SAFETY_MARGIN},
+      m_work_estimate{0.0},
+      m_sleep_overshoot{0.0},
+      m_last_wait_time{0.0}
+{
+}
+
+void FramePacer::SetTargetFrameRate(const f32 target_fps)
+{
+    m_present_wait = nullptr;
+    if (target_fps <= 0.0f) {
+        m_mode = PacingMode::Uncapped;
+        m_period = SteadyClock::duration::zero();
+        return;
+    }
+
+    m_mode = PacingMode::FrameRate;
+    m_period = internal::to_period(target_fps);
+    m_next_frame_start = SteadyClock::now();
+}
+
+void FramePacer::SetPresentWait(PresentWait present_wait, const f32 refresh_rate)
+{
+    if (!present_wait || refresh_rate <= 0.0f) {
+        SetTargetFrameRate(0.0f);
+        return;
+    }
+
+    m_mode = PacingMode::PresentWait;
+    m_present_wait = std::move(present_wait);
+    m_period = internal::to_period(refresh_rate);
+}
+
+void FramePacer::WaitForFrameStart()
+{
+    const SteadyClock::time_point wait_start{SteadyClock::now()};
+
+    if (m_mode == PacingMode::PresentWait) {
+        if (m_present_wait()) {
+            // The previous frame went on screen just now, this one has until the following refresh
+            const auto work{std::chrono::duration_cast<SteadyClock::duration>(m_work_estimate + m_safety_margin)};
+            WaitUntil(SteadyClock::now() + m_period - work);
+        }
+    }
+    else if (m_mode == PacingMode::FrameRate) {
+        // Starts are a whole number of periods apart, so the rate holds however the sleeps land. A frame that ran long
+        // moves them on rather than having the following frames rush to catch up.
+        if (m_next_frame_start < wait_start) {
+            m_next_frame_start = wait_start;
+        }
+        WaitUntil(m_next_frame_start);
+        m_next_frame_start += m_period;
+    }
+
+    m_frame_start = SteadyClock::now();
+    m_last_wait_time = m_frame_start - wait_start;
+}
+
+void FramePacer::EndFrame(const f32 gpu_time)
+{
+    const FloatingPointMilliseconds work{FloatingPointMilliseconds{SteadyClock::now() - m_frame_start} +
+                                         FloatingPointMilliseconds{static_cast<f64>(gpu_time)}};
+    m_work_estimate = internal::track_peak(m_work_estimate, work, 0.05);
+}
+
+void FramePacer::WaitUntil(const SteadyClock::time_point deadline)
+{
+    while (true) {
+        const FloatingPointMilliseconds remaining{deadline - SteadyClock::now()};
+        if (remaining <= m_sleep_overshoot + internal::SLEEP_SLICE) {
+            break;
+        }
+
+        if (m_idle_callback) {
+            m_idle_callback();
+            if (FloatingPointMilliseconds{deadline - SteadyClock::now()} <= m_sleep_overshoot + internal::SLEEP_SLICE) {
+                break; // It took long enough to leave no room for another slice
+            }
+        }
+
+        const SteadyClock::time_point sleep_start{SteadyClock::now()};
+        std::this_thread::sleep_for(internal::SLEEP_SLICE);
+        const FloatingPointMilliseconds overshoot{FloatingPointMilliseconds{SteadyClock::now() - sleep_start} -
+                                                  internal::SLEEP_SLICE};
+        m_sleep_overshoot = internal::track_peak(m_sleep_overshoot, overshoot, 0.01);
+    }
+
+    while (SteadyClock::now() < deadline) {
+        std::this_thread::yield();
+    }
+}
+
+} // namespace gouda::utils
@@ -6,23 +6,352 @@
  */
 #include "utils/image.hpp"
 
+#include <algorithm>
+#include <cstring>
+#include <format>
+#include <type_traits>
+
 #include "stb_image_resize.h"
 #include "stb_image_write.h"
 
+#include "debug/logger.hpp"
+#include "math/simd.hpp"
+#include "utils/filesystem.hpp"
+#include "utils/hash.hpp"
+
 namespace gouda {
 
+namespace internal {
+
+// Decoded pixels are cached by a hash of the encoded file and the load settings, so an edited image or a different
+// channel count or flip decodes again under a new key. Entries are never evicted, deleting the directory is safe.
+
+// "GIMG", bump IMAGE_CACHE_VERSION whenever the file layout or the decoder output changes
+constexpr u32 IMAGE_CACHE_MAGIC{0x474D4947};
+constexpr u32 IMAGE_CACHE_VERSION{1};
+constexpr StringView IMAGE_CACHE_DIRECTORY{"cache/images"};
+
+struct ImageCacheHeader {
+    u32 magic;
+    u32 version;
+    u64 key;
+    s32 width;
+    s32 height;
+    s32 channels;
+    u32 reserved;
+};
+
+static_assert(sizeof(ImageCacheHeader) == 32 && std::is_trivially_copyable_v<ImageCacheHeader>);
+
+static u64 image_cache_key(const std::span<const std::byte> encoded, const int desired_channels, const bool flip)
+{
+    const String settings{std::format("channels={};flip={};version={}", desired_channels, flip, IMAGE_CACHE_VERSION)};
+    return utils::fnv1a(encoded, utils::fnv1a(settings));
+}
+
+static String image_cache_path(const u64 key) { return std::format("{}/{:016x}.bin", IMAGE_CACHE_DIRECTORY, key); }
+
+// The pixels are not checksummed, hashing them would cost about as much as the decode being skipped. The key already
+// covers the source, the size check catches entries cut short by a crash while writing.
+static std::optional<fs::MappedFile> find_cached_image(const u64 key)
+{
+    auto file{fs::MappedFile::Open(image_cache_path(key))};
+    ImageCacheHeader header{};
+    if (!file || file->GetSize() < sizeof(header)) {
+        return std::nullopt;
+    }
+    std::memcpy(&header, file->GetData().data(), sizeof(header));
+
+    const u64 pixel_size{static_cast<u64>(header.width) * static_cast<u64>(header.height) *
+                         static_cast<u64>(header.channels)};
+    if (header.magic != IMAGE_CACHE_MAGIC || header.version != IMAGE_CACHE_VERSION || header.key != key ||
+        header.width <= 0 || header.height <= 0 || header.channels <= 0 ||
+        file->GetSize() - sizeof(header) != pixel_size) {
+        ENGINE_LOG_WARNING("Ignoring invalid image cache entry '{}'", image_cache_path(key));
+        return std::nullopt;
+    }
+    return std::move(*file);
+}
+
+static void store_cached_image(const u64 key, const std::span<const stbi_uc> pixels, const ImageSize size,
+                               const int channels)
+{
+    const ImageCacheHeader header{.magic = IMAGE_CACHE_MAGIC,
+                                  .version = IMAGE_CACHE_VERSION,
+                                  .key = key,
+                                  .width = size.width,
+                                  .height = size.height,
+                                  .channels = channels,
+                                  .reserved = 0};
+
+    std::vector<std::byte> file_data(sizeof(header) + pixels.size());
+    std::memcpy(file_data.data(), &header, sizeof(header));
+    std::memcpy(file_data.data() + sizeof(header), pixels.data(), pixels.size());
+
+    if (auto directory_result = fs::EnsureDirectoryExists(FilePath{IMAGE_CACHE_DIRECTORY}, true); !directory_result) {
+        ENGINE_LOG_WARNING("Failed to create image cache directory: {}", fs::error_to_string(directory_result.error()));
+        return;
+    }
+
+    if (!fs::WriteBinaryFile(image_cache_path(key), std::span<const std::byte>{file_data})) {
+        ENGINE_LOG_WARNING("Failed to write image cache entry '{}'", image_cache_path(key));
+    }
+}
+
+// Pixel kernels ---------------------------------------------------------------------------------------------------
+// For 4 channel images, which are all the engine loads textures as. Picked once for the CPU like math::GetSimdKernels,
+// each SIMD kernel matches its scalar one byte for byte.
+
+constexpr size_t RGBA_PIXEL_SIZE{4};
+
+struct ImageKernels {
+    void (*reverse_pixels)(u8 *pixels, size_t count);
+    void (*swap_red_blue)(u8 *pixels, size_t count);
+    void (*premultiply_alpha)(u8 *pixels, size_t count);
+    // Averages the 2x2 blocks of two rows into out_count pixels, each row holds twice as many
+    void (*downsample_rows)(const u8 *row0, const u8 *row1, u8 *out, size_t out_count);
+};
+
+// round(colour * alpha / 255) without a division
+static constexpr u32 premultiply(const u32 colour, const u32 alpha)
+{
+    const u32 product{colour * alpha + 128};
+    return (product + (product >> 8)) >> 8;
+}
+
+// Any channel count, for the images the kernels do not cover
+static void reverse_pixels(u8 *pixels, const size_t count, const size_t pixel_size)
+{
+    for (size_t front = 0, back = count; front + 1 < back; ++front) {
+        --back;
+        std::swap_ranges(pixels + front * pixel_size, pixels + (front + 1) * pixel_size, pixels + back * pixel_size);
+    }
+}
+
+static void reverse_pixels_scalar(u8 *pixels, const size_t count) { reverse_pixels(pixels, count, RGBA_PIXEL_SIZE); }
+
+static void swap_red_blue_scalar(u8 *pixels, const size_t count)
+{
+    for (size_t i = 0; i < count * RGBA_PIXEL_SIZE; i += RGBA_PIXEL_SIZE) {
+        std::swap(pixels[i], pixels[i + 2]);
+    }
+}
+
+static void premultiply_alpha_scalar(u8 *pixels, const size_t count)
+{
+    for (size_t i = 0; i < count * RGBA_PIXEL_SIZE; i += RGBA_PIXEL_SIZE) {
+        const u32 alpha{pixels[i + 3]};
+        pixels[i] = static_cast<u8>(premultiply(pixels[i], alpha));
+        pixels[i + 1] = static_cast<u8>(premultiply(pixels[i + 1], alpha));
+        pixels[i + 2] = static_cast<u8>(premultiply(pixels[i + 2], alpha));
+    }
+}
+
+static void downsample_rows_scalar(const u8 *row0, const u8 *row1, u8 *out, const size_t out_count)
+{
+    for (size_t i = 0; i < out_count * RGBA_PIXEL_SIZE; ++i) {
+        const size_t left{(i / RGBA_PIXEL_SIZE) * RGBA_PIXEL_SIZE * 2 + i % RGBA_PIXEL_SIZE};
+        const u32 sum{static_cast<u32>(row0[left]) + row0[left + RGBA_PIXEL_SIZE] + row1[left] +
+                      row1[left + RGBA_PIXEL_SIZE]};
+        out[i] = static_cast<u8>((sum + 2) >> 2);
+    }
+}
+
+// SSE4.1 ----------------------------------------------------------------------------------------------------------
+GOUDA_SIMD_TARGET("sse4.1")
+static void reverse_pixels_sse41(u8 *pixels, const size_t count)
+{
+    // Blocks of four from both ends trade places reversed, the middle left over is reversed on its own
+    size_t front{0};
+    size_t back{count};
+    while (back - front >= 8) {
+        back -= 4;
+        auto *head{reinterpret_cast<__m128i *>(pixels + front * RGBA_PIXEL_SIZE)};
+        auto *tail{reinterpret_cast<__m128i *>(pixels + back * RGBA_PIXEL_SIZE)};
+        const __m128i head_pixels{_mm_loadu_si128(head)};
+        const __m128i tail_pixels{_mm_loadu_si128(tail)};
+        _mm_storeu_si128(head, _mm_shuffle_epi32(tail_pixels, _MM_SHUFFLE(0, 1, 2, 3)));
+        _mm_storeu_si128(tail, _mm_shuffle_epi32(head_pixels, _MM_SHUFFLE(0, 1, 2, 3)));
+        front += 4;
+    }
+    reverse_pixels_scalar(pixels + front * RGBA_PIXEL_SIZE, back - front);
+}
+
+GOUDA_SIMD_TARGET("sse4.1")
+static void swap_red_blue_sse41(u8 *pixels, const size_t count)
+{
+    const __m128i shuffle{_mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15)};
+    size_t i{0};
+    for (; i + 4 <= count; i += 4) {
+        auto *block{reinterpret_cast<__m128i *>(pixels + i * RGBA_PIXEL_SIZE)};
+        _mm_storeu_si128(block, _mm_shuffle_epi8(_mm_loadu_si128(block), shuffle));
+    }
+    swap_red_blue_scalar(pixels + i * RGBA_PIXEL_SIZE, count - i);
+}
+
+// Two pixels widened to 16 bits, see premultiply
+GOUDA_SIMD_TARGET("sse4.1")
+static __m128i premultiply_sse41(const __m128i colour, const __m128i alpha_shuffle)
+{
+    const __m128i alpha{_mm_shuffle_epi8(colour, alpha_shuffle)};
+    const __m128i product{_mm_add_epi16(_mm_mullo_epi16(colour, alpha), _mm_set1_epi16(128))};
+    return _mm_srli_epi16(_mm_add_epi16(product, _mm_srli_epi16(product, 8)), 8);
+}
+
+GOUDA_SIMD_TARGET("sse4.1")
+static void premultiply_alpha_sse41(u8 *pixels, const size_t count)
+{
+    const __m128i alpha_shuffle{_mm_setr_epi8(6, 7, 6, 7, 6, 7, 6, 7, 14, 15, 14, 15, 14, 15, 14, 15)};
+    const __m128i alpha_mask{_mm_set1_epi32(static_cast<int>(0xFF000000))};
+    size_t i{0};
+    for (; i + 4 <= count; i += 4) {
+        auto *block{reinterpret_cast<__m128i *>(pixels + i * RGBA_PIXEL_SIZE)};
+        const __m128i source{_mm_loadu_si128(block)};
+        const __m128i low{premultiply_sse41(_mm_cvtepu8_epi16(source), alpha_shuffle)};
+        const __m128i high{premultiply_sse41(_mm_unpackhi_epi8(source, _mm_setzero_si128()), alpha_shuffle)};
+        _mm_storeu_si128(block, _mm_blendv_epi8(_mm_packus_epi16(low, high), source, alpha_mask));
+    }
+    premultiply_alpha_scalar(pixels + i * RGBA_PIXEL_SIZE, count - i);
+}
+
+GOUDA_SIMD_TARGET("sse4.1")
+static void downsample_rows_sse41(const u8 *row0, const u8 *row1, u8 *out, const size_t out_count)
+{
+    // Four source pixels of each row make two, the pairs are summed in 16 bit lanes
+    const __m128i zero{_mm_setzero_si128()};
+    const __m128i rounding{_mm_set1_epi16(2)};
+    size_t i{0};
+    for (; i + 2 <= out_count; i += 2) {
+        const __m128i top{_mm_loadu_si128(reinterpret_cast<const __m128i *>(row0 + i * RGBA_PIXEL_SIZE * 2))};
+        const __m128i bottom{_mm_loadu_si128(reinterpret_cast<const __m128i *>(row1 + i * RGBA_PIXEL_SIZE * 2))};
+        const __m128i low{_mm_add_epi16(_mm_unpacklo_epi8(top, zero), _mm_unpacklo_epi8(bottom, zero))};
+        const __m128i high{_mm_add_epi16(_mm_unpackhi_epi8(top, zero), _mm_unpackhi_epi8(bottom, zero))};
+        const __m128i sums{_mm_unpacklo_epi64(_mm_add_epi16(low, _mm_srli_si128(low, 8)),
+                                              _mm_add_epi16(high, _mm_srli_si128(high, 8)))};
+        const __m128i average{_mm_srli_epi16(_mm_add_epi16(sums, rounding), 2)};
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(out + i * RGBA_PIXEL_SIZE), _mm_packus_epi16(average, zero));
+    }
+    downsample_rows_scalar(row0 + i * RGBA_PIXEL_SIZE * 2, row1 + i * RGBA_PIXEL_SIZE * 2, out + i * RGBA_PIXEL_SIZE,
+                           out_count - i);
+}
+
+// AVX2 ------------------------------------------------------------------------------------------------------------
+GOUDA_SIMD_TARGET("avx2")
+static void reverse_pixels_avx2(u8 *pixels, const size_t count)
+{
+    const __m256i reversed{_mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0)};
+    size_t front{0};
+    size_t back{count};
+    while (back - front >= 16) {
+        back -= 8;
+        auto *head{reinterpret_cast<__m256i *>(pixels + front * RGBA_PIXEL_SIZE)};
+        auto *tail{reinterpret_cast<__m256i *>(pixels + back * RGBA_PIXEL_SIZE)};
+        const __m256i head_pixels{_mm256_loadu_si256(head)};
+        const __m256i tail_pixels{_mm256_loadu_si256(tail)};
+        _mm256_storeu_si256(head, _mm256_permutevar8x32_epi32(tail_pixels, reversed));
+        _mm256_storeu_si256(tail, _mm256_permutevar8x32_epi32(head_pixels, reversed));
+        front += 8;
+    }
+    reverse_pixels_sse41(pixels + front * RGBA_PIXEL_SIZE, back - front);
+}
+
+GOUDA_SIMD_TARGET("avx2")
+static void swap_red_blue_avx2(u8 *pixels, const size_t count)
+{
+    const __m256i shuffle{_mm256_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15, 2, 1, 0, 3, 6, 5, 4,
+                                           7, 10, 9, 8, 11, 14, 13, 12, 15)};
+    size_t i{0};
+    for (; i + 8 <= count; i += 8) {
+        auto *block{reinterpret_cast<__m256i *>(pixels + i * RGBA_PIXEL_SIZE)};
+        _mm256_storeu_si256(block, _mm256_shuffle_epi8(_mm256_loadu_si256(block), shuffle));
+    }
+    swap_red_blue_scalar(pixels + i * RGBA_PIXEL_SIZE, count - i);
+}
+
+// Four pixels widened to 16 bits, see premultiply
+GOUDA_SIMD_TARGET("avx2")
+static __m256i premultiply_avx2(const __m256i colour, const __m256i alpha_shuffle)
+{
+    const __m256i alpha{_mm256_shuffle_epi8(colour, alpha_shuffle)};
+    const __m256i product{_mm256_add_epi16(_mm256_mullo_epi16(colour, alpha), _mm256_set1_epi16(128))};
+    return _mm256_srli_epi16(_mm256_add_epi16(product, _mm256_srli_epi16(product, 8)), 8);
+}
+
+GOUDA_SIMD_TARGET("avx2")
+static void premultiply_alpha_avx2(u8 *pixels, const size_t count)
+{
+    const __m256i alpha_shuffle{_mm256_setr_epi8(6, 7, 6, 7, 6, 7, 6, 7, 14, 15, 14, 15, 14, 15, 14, 15, 6, 7, 6, 7, 6,
+                                                 7, 6, 7, 14, 15, 14, 15, 14, 15, 14, 15)};
+    const __m256i alpha_mask{_mm256_set1_epi32(static_cast<int>(0xFF000000))};
+    size_t i{0};
+    for (; i + 8 <= count; i += 8) {
+        auto *block{reinterpret_cast<__m256i *>(pixels + i * RGBA_PIXEL_SIZE)};
+        const __m256i source{_mm256_loadu_si256(block)};
+        const __m256i low{premultiply_avx2(_mm256_cvtepu8_epi16(_mm256_castsi256_si128(source)), alpha_shuffle)};
+        const __m256i high{
+            premultiply_avx2(_mm256_cvtepu8_epi16(_mm256_extracti128_si256(source, 1)), alpha_shuffle)};
+        // The pack works within 128 bit lanes, the permute puts the pixels back in order
+        const __m256i packed{_mm256_permute4x64_epi64(_mm256_packus_epi16(low, high), _MM_SHUFFLE(3, 1, 2, 0))};
+        _mm256_storeu_si256(block, _mm256_blendv_epi8(packed, source, alpha_mask));
+    }
+    premultiply_alpha_sse41(pixels + i * RGBA_PIXEL_SIZE, count - i);
+}
+
+static constexpr ImageKernels scalar_image_kernels{reverse_pixels_scalar, swap_red_blue_scalar,
+                                                   premultiply_alpha_scalar, downsample_rows_scalar};
+static constexpr ImageKernels sse41_image_kernels{reverse_pixels_sse41, swap_red_blue_sse41, premultiply_alpha_sse41,
+                                                  downsample_rows_sse41};
+// Downsampling reads two rows for every one it writes and is bound by memory already, it keeps the SSE4.1 kernel
+static constexpr ImageKernels avx2_image_kernels{reverse_pixels_avx2, swap_red_blue_avx2, premultiply_alpha_avx2,
+                                                 downsample_rows_sse41};
+
+static const ImageKernels &get_image_kernels()
+{
+    static const ImageKernels &kernels{[]() -> const ImageKernels & {
+        switch (math::GetSimdType()) {
+            case math::SimdType::AVX2:
+                return avx2_image_kernels;
+            case math::SimdType::SSE4_1:
+                return sse41_image_kernels;
+            default:
+                return scalar_image_kernels;
+        }
+    }()};
+    return kernels;
+}
+
+} // namespace internal
+
 Expect<Image, String> Image::Load(StringView filename, const int desired_channels, const bool flip_horizontally)
 {
     int actual_channels{0};
     ImageSize size{0, 0};
 
-    // Enable vertical flipping for loading
-    stbi_set_flip_vertically_on_load(flip_horizontally); // Flip image so bottom row is first
+    // Decoded from memory, so images packed into a mounted archive load the same as loose files
+    const auto file{fs::MappedFile::Open(filename)};
+    if (!file) {
+        return std::unexpected(String{fs::error_to_string(file.error())});
+    }
+
+    const u64 cache_key{internal::image_cache_key(file->GetData(), desired_channels, flip_horizontally)};
+    if (auto cache_file{internal::find_cached_image(cache_key)}) {
+        internal::ImageCacheHeader header{};
+        std::memcpy(&header, cache_file->GetData().data(), sizeof(header));
+        const std::span<const std::byte> pixels{cache_file->GetData().subspan(sizeof(header))};
+        return Image(std::move(*cache_file), {reinterpret_cast<const stbi_uc *>(pixels.data()), pixels.size()},
+                     ImageSize{header.width, header.height}, header.channels);
+    }
+
+    // Enable vertical flipping for loading. The per thread setting keeps concurrent decodes on worker threads from
+    // flipping each other's images.
+    stbi_set_flip_vertically_on_load_thread(flip_horizontally); // Flip image so bottom row is first
 
     // Load image with the desired number of channels
-    stbi_uc *data{stbi_load(filename.data(), &size.width, &size.height, &actual_channels, desired_channels)};
+    stbi_uc *data{stbi_load_from_memory(reinterpret_cast<const stbi_uc *>(file->GetData().data()),
+                                        static_cast<int>(file->GetSize()), &size.width, &size.height,
+                                        &actual_channels, desired_channels)};
     if (!data) {
-        stbi_set_flip_vertically_on_load(0); // Reset to avoid affecting other loads
+        stbi_set_flip_vertically_on_load_thread(0); // Reset to avoid affecting other loads
         return std::unexpected("Failed to load image");
     }
 
@@ -34,7 +363,9 @@ Expect<Image, String> Image::Load(StringView filename, const int desired_channel
     stbi_image_free(data);
 
     // Reset flip setting to avoid affecting other image loads
-    stbi_set_flip_vertically_on_load(0);
+    stbi_set_flip_vertically_on_load_thread(0);
+
+    internal::store_cached_image(cache_key, image_data, size, stored_channels);
 
     // Return the Image object with the loaded data
     return Image(std::move(image_data), ImageSize{size.width, size.height}, stored_channels);
@@ -42,7 +373,7 @@ Expect<Image, String> Image::Load(StringView filename, const int desired_channel
 
 bool Image::Save(StringView filename) const
 {
-    return stbi_write_png(filename.data(), m_size.width, m_size.height, m_channels, p_data.data(),
+    return stbi_write_png(filename.data(), m_size.width, m_size.height, m_channels, data().data(),
                           m_size.width * m_channels);
 }
 
@@ -62,27 +393,114 @@ Image Image::ToGrayscale() const
 
 void Image::FlipHorizontal()
 {
-    const int row_size = m_size.width * m_channels;
-    for (int y = 0; y < m_size.height; ++y) {
-        std::reverse(p_data.begin() + y * row_size, p_data.begin() + (y + 1) * row_size);
+    own_pixels();
+    const auto channel_count{static_cast<size_t>(m_channels)};
+    const auto width{static_cast<size_t>(m_size.width)};
+    const auto row_size{width * channel_count};
+    for (size_t y = 0; y < static_cast<size_t>(m_size.height); ++y) {
+        u8 *row{p_data.data() + y * row_size};
+        if (channel_count == internal::RGBA_PIXEL_SIZE) {
+            internal::get_image_kernels().reverse_pixels(row, width);
+        }
+        else {
+            internal::reverse_pixels(row, width, channel_count);
+        }
+    }
+}
+
+void Image::FlipVertical()
+{
+    own_pixels();
+    const auto row_size{static_cast<size_t>(m_size.width) * static_cast<size_t>(m_channels)};
+    std::vector<stbi_uc> scratch(row_size);
+    for (size_t top = 0, bottom = static_cast<size_t>(m_size.height); top + 1 < bottom; ++top) {
+        --bottom;
+        u8 *top_row{p_data.data() + top * row_size};
+        u8 *bottom_row{p_data.data() + bottom * row_size};
+        std::memcpy(scratch.data(), top_row, row_size);
+        std::memcpy(top_row, bottom_row, row_size);
+        std::memcpy(bottom_row, scratch.data(), row_size);
+    }
+}
+
+void Image::SwapRedBlue()
+{
+    if (m_channels < 3) {
+        return;
+    }
+    own_pixels();
+    if (m_channels == static_cast<int>(internal::RGBA_PIXEL_SIZE)) {
+        internal::get_image_kernels().swap_red_blue(p_data.data(), static_cast<size_t>(GetArea()));
+        return;
+    }
+    for (size_t i = 0; i < p_data.size(); i += static_cast<size_t>(m_channels)) {
+        std::swap(p_data[i], p_data[i + 2]);
+    }
+}
+
+void Image::PremultiplyAlpha()
+{
+    if (m_channels != static_cast<int>(internal::RGBA_PIXEL_SIZE)) {
+        return;
     }
+    own_pixels();
+    internal::get_image_kernels().premultiply_alpha(p_data.data(), static_cast<size_t>(GetArea()));
 }
 
 Image Image::Rotate90() const
 {
+    // Whole pixels are copied, a column of the source becomes a row of the result
+    const auto channel_count{static_cast<size_t>(m_channels)};
+    const std::span<const stbi_uc> source{data()};
     Image rotated({}, ImageSize{m_size.height, m_size.width}, m_channels);
-    rotated.p_data.resize(m_size.width * m_size.height * m_channels);
+    rotated.p_data.resize(source.size());
     for (int y = 0; y < m_size.height; ++y) {
+        const stbi_uc *source_row{source.data() + static_cast<size_t>(y * m_size.width) * channel_count};
+        const auto column{static_cast<size_t>(m_size.height - y - 1)};
         for (int x = 0; x < m_size.width; ++x) {
-            for (int c = 0; c < m_channels; ++c) {
-                rotated.p_data[(x * m_size.height + (m_size.height - y - 1)) * m_channels + c] =
-                    p_data[(y * m_size.width + x) * m_channels + c];
-            }
+            std::memcpy(rotated.p_data.data() + (static_cast<size_t>(x * m_size.height) + column) * channel_count,
+                        source_row + static_cast<size_t>(x) * channel_count, channel_count);
         }
     }
     return rotated;
 }
 
+Image Image::Downsample() const
+{
+    const ImageSize half_size{std::max(m_size.width / 2, 1), std::max(m_size.height / 2, 1)};
+    const auto channel_count{static_cast<size_t>(m_channels)};
+    const auto source_row_size{static_cast<size_t>(m_size.width) * channel_count};
+    const auto row_size{static_cast<size_t>(half_size.width) * channel_count};
+    const std::span<const stbi_uc> source{data()};
+
+    Image half({}, half_size, m_channels);
+    half.p_data.resize(row_size * static_cast<size_t>(half_size.height));
+    if (source.empty()) {
+        return half;
+    }
+
+    // A dimension of one pixel averages the pixel with itself, odd sizes drop their last row or column
+    for (int y = 0; y < half_size.height; ++y) {
+        const stbi_uc *row0{source.data() + static_cast<size_t>(std::min(y * 2, m_size.height - 1)) * source_row_size};
+        const stbi_uc *row1{source.data() +
+                            static_cast<size_t>(std::min(y * 2 + 1, m_size.height - 1)) * source_row_size};
+        u8 *out{half.p_data.data() + static_cast<size_t>(y) * row_size};
+        if (channel_count == internal::RGBA_PIXEL_SIZE && m_size.width > 1) {
+            internal::get_image_kernels().downsample_rows(row0, row1, out, static_cast<size_t>(half_size.width));
+            continue;
+        }
+        for (int x = 0; x < half_size.width; ++x) {
+            const size_t left{static_cast<size_t>(std::min(x * 2, m_size.width - 1)) * channel_count};
+            const size_t right{static_cast<size_t>(std::min(x * 2 + 1, m_size.width - 1)) * channel_count};
+            for (size_t c = 0; c < channel_count; ++c) {
+                const u32 sum{static_cast<u32>(row0[left + c]) + row0[right + c] + row1[left + c] + row1[right + c]};
+                out[static_cast<size_t>(x) * channel_count + c] = static_cast<u8>((sum + 2) >> 2);
+            }
+        }
+    }
+    return half;
+}
+
 Expect<Image, String> Image::Resize(const int new_width, const int new_height) const
 {
     if (new_width <= 0 || new_height <= 0) {
@@ -91,7 +509,7 @@ Expect<Image, String> Image::Resize(const int new_width, const int new_height) c
 
     const size_t new_size{static_cast<size_t>(new_width * new_height * m_channels)};
     std::vector<stbi_uc> resized_data(new_size);
-    if (!stbir_resize_uint8(p_data.data(), m_size.width, m_size.height, 0, resized_data.data(), new_width, new_height,
+    if (!stbir_resize_uint8(data().data(), m_size.width, m_size.height, 0, resized_data.data(), new_width, new_height,
                             0, m_channels)) {
         return std::unexpected("Failed to resize image.");
     }
@@ -99,8 +517,64 @@ Expect<Image, String> Image::Resize(const int new_width, const int new_height) c
     return Image(std::move(resized_data), ImageSize{new_width, new_height}, m_channels);
 }
 
+Image Image::Blank(const ImageSize size, const int channels)
+{
+    std::vector<stbi_uc> blank_data(static_cast<size_t>(size.width) * static_cast<size_t>(size.height) *
+                                    static_cast<size_t>(channels));
+    return Image(std::move(blank_data), size, channels);
+}
+
+void Image::Blit(const Image &source, const int x, const int y, const int border)
+{
+    if (source.m_channels != m_channels || source.m_size.area() == 0) {
+        return;
+    }
+    own_pixels();
+
+    const int first_column{std::max(x - border, 0)};
+    const int last_column{std::min(x + source.m_size.width + border, m_size.width)}; // Exclusive
+    const int first_row{std::max(y - border, 0)};
+    const int last_row{std::min(y + source.m_size.height + border, m_size.height)};
+    if (first_column >= last_column || first_row >= last_row) {
+        return;
+    }
+
+    // Columns [first_inner_column, last_inner_column) come straight from the source, the rest repeat its edges
+    const int first_inner_column{std::clamp(x, first_column, last_column)};
+    const int last_inner_column{std::clamp(x + source.m_size.width, first_inner_column, last_column)};
+
+    const auto channel_count{static_cast<size_t>(m_channels)};
+    const auto pixel_offset = [channel_count](const Image &image, const int column, const int row) {
+        return static_cast<size_t>(row * image.m_size.width + column) * channel_count;
+    };
+
+    for (int row = first_row; row < last_row; ++row) {
+        const int source_row{std::clamp(row - y, 0, source.m_size.height - 1)};
+        const auto copy_edge_pixel = [&](const int column) {
+            const int source_column{std::clamp(column - x, 0, source.m_size.width - 1)};
+            std::memcpy(p_data.data() + pixel_offset(*this, column, row),
+                        source.data().data() + pixel_offset(source, source_column, source_row), channel_count);
+        };
+
+        for (int column = first_column; column < first_inner_column; ++column) {
+            copy_edge_pixel(column);
+        }
+        if (first_inner_column < last_inner_column) {
+            std::memcpy(p_data.data() + pixel_offset(*this, first_inner_column, row),
+                        source.data().data() + pixel_offset(source, first_inner_column - x, source_row),
+                        static_cast<size_t>(last_inner_column - first_inner_column) * channel_count);
+        }
+        for (int column = last_inner_column; column < last_column; ++column) {
+            copy_edge_pixel(column);
+        }
+    }
+}
+
 std::span<const stbi_uc> Image::data() const
 {
+    if (m_cache_file) {
+        return m_mapped_pixels;
+    }
     return {p_data.data(), static_cast<size_t>(m_size.width * m_size.height * m_channels)};
 }
 
@@ -115,16 +589,22 @@ Image::Image(std::vector<stbi_uc> data, const ImageSize size, const int channels
 {
 }
 
+Image::Image(fs::MappedFile cache_file, const std::span<const stbi_uc> pixels, const ImageSize size, const int channels)
+    : m_cache_file(std::move(cache_file)), m_mapped_pixels(pixels), m_size(size), m_channels(channels)
+{
+}
+
+// Copies always own their pixels, the mapping is not shared
 Image::Image(const Image &other) : m_size(other.m_size), m_channels(other.m_channels)
 {
-    p_data = other.p_data; // Simple vector copy
+    p_data.assign(other.data().begin(), other.data().end());
 }
 
 Image &Image::operator=(const Image &other)
 {
     if (this != &other) {
         reset();
-        p_data = other.p_data; // Simple vector copy
+        p_data.assign(other.data().begin(), other.data().end());
         m_size = other.m_size;
         m_channels = other.m_channels;
     }
@@ -132,7 +612,8 @@ Image &Image::operator=(const Image &other)
 }
 
 Image::Image(Image &&other) noexcept
-    : p_data(std::move(other.p_data)), m_size(other.m_size), m_channels(other.m_channels)
+    : p_data(std::move(other.p_data)), m_cache_file(std::move(other.m_cache_file)),
+      m_mapped_pixels(other.m_mapped_pixels), m_size(other.m_size), m_channels(other.m_channels)
 {
     other.reset();
 }
@@ -141,6 +622,8 @@ Image &Image::operator=(Image &&other) noexcept
 {
     if (this != &other) {
         p_data.swap(other.p_data); // Efficient move for vectors
+        m_cache_file = std::move(other.m_cache_file);
+        m_mapped_pixels = other.m_mapped_pixels;
         m_size = other.m_size;
         m_channels = other.m_channels;
         other.reset();
@@ -150,9 +633,20 @@ Image &Image::operator=(Image &&other) noexcept
 
 Image::~Image() { reset(); }
 
+void Image::own_pixels()
+{
+    if (m_cache_file) {
+        p_data.assign(m_mapped_pixels.begin(), m_mapped_pixels.end());
+        m_cache_file.reset();
+        m_mapped_pixels = {};
+    }
+}
+
 void Image::reset()
 {
     p_data.clear();
+    m_cache_file.reset();
+    m_mapped_pixels = {};
     m_size = ImageSize{0, 0};
     m_channels = 0;
 }
@@ -0,0 +1,127 @@
+/**
+ * @file utils/interned_string.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine global string interning pool implementation
+ */
+#include "utils/interned_string.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <memory>
+#include <mutex>
+
+#include "containers/small_vector.hpp"
+#include "debug/assert.hpp"
+
+namespace gouda {
+
+namespace internal {
+
+constexpr u32 STRING_POOL_PAGE_BITS{12}; // Views per page
+constexpr u32 STRING_POOL_PAGE_SIZE{1u << STRING_POOL_PAGE_BITS};
+constexpr u32 STRING_POOL_MAX_PAGES{1024};
+constexpr size_t STRING_POOL_BLOCK_SIZE{16 * 1024}; // Text is copied into blocks of this, longer names get their own
+
+struct StringPoolHash {
+    using is_avalanching = void;
+
+    [[nodiscard]] size_t operator()(const StringView text) const noexcept { return utils::mix64(utils::fnv1a(text)); }
+};
+
+// The views by id are kept in pages that never move once allocated, so a thread holding an id reads its view
+// without the lock. It can only have the id from the interning that stored the view, or from a thread that had.
+struct StringPool {
+    std::mutex mutex;
+    FlatHashMap<StringView, u32, StringPoolHash> ids; // Keys view the blocks
+    std::array<std::unique_ptr<StringView[]>, STRING_POOL_MAX_PAGES> pages;
+    u32 count{1}; // Id 0 is the empty string
+    Vector<std::unique_ptr<char[]>> blocks;
+    char *p_block_cursor{nullptr};
+    size_t block_left{0};
+    size_t bytes{0};
+};
+
+static StringPool &get_string_pool()
+{
+    static StringPool pool;
+    return pool;
+}
+
+// Copies text into the pool's blocks, the copies stay where they are
+static StringView store_text(StringPool &pool, const StringView text)
+{
+    if (text.size() > pool.block_left) {
+        const size_t block_size{std::max(text.size(), STRING_POOL_BLOCK_SIZE)};
+        pool.blocks.push_back(std::make_unique<char[]>(block_size));
+        // A long name fills a block of its own, the current one keeps its space for the names after
+        if (block_size > STRING_POOL_BLOCK_SIZE) {
+            std::memcpy(pool.blocks.back().get(), text.data(), text.size());
+            return {pool.blocks.back().get(), text.size()};
+        }
+        pool.p_block_cursor = pool.blocks.back().get();
+        pool.block_left = block_size;
+    }
+
+    char *const copy{pool.p_block_cursor};
+    std::memcpy(copy, text.data(), text.size());
+    pool.p_block_cursor += text.size();
+    pool.block_left -= text.size();
+    return {copy, text.size()};
+}
+
+} // namespace internal
+
+InternedString::InternedString(const StringView text) : m_id{0}
+{
+    if (text.empty()) {
+        return;
+    }
+
+    internal::StringPool &pool{internal::get_string_pool()};
+    const std::scoped_lock lock{pool.mutex};
+    if (const u32 *id{pool.ids.get(text)}) {
+        m_id = *id;
+        return;
+    }
+
+    ASSERT(pool.count < internal::STRING_POOL_PAGE_SIZE * internal::STRING_POOL_MAX_PAGES,
+           "The string pool is full.");
+    const u32 id{pool.count++};
+    std::unique_ptr<StringView[]> &page{pool.pages[id >> internal::STRING_POOL_PAGE_BITS]};
+    if (!page) {
+        page = std::make_unique<StringView[]>(internal::STRING_POOL_PAGE_SIZE);
+    }
+
+    const StringView stored{internal::store_text(pool, text)};
+    page[id & (internal::STRING_POOL_PAGE_SIZE - 1)] = stored;
+    pool.ids.emplace(stored, id);
+    pool.bytes += stored.size();
+    m_id = id;
+}
+
+StringView InternedString::GetView() const noexcept
+{
+    if (m_id == 0) {
+        return {};
+    }
+    const internal::StringPool &pool{internal::get_string_pool()};
+    return pool.pages[m_id >> internal::STRING_POOL_PAGE_BITS][m_id & (internal::STRING_POOL_PAGE_SIZE - 1)];
+}
+
+size_t InternedString::GetPoolCount()
+{
+    internal::StringPool &pool{internal::get_string_pool()};
+    const std::scoped_lock lock{pool.mutex};
+    return pool.count - 1;
+}
+
+size_t InternedString::GetPoolBytes()
+{
+    internal::StringPool &pool{internal::get_string_pool()};
+    const std::scoped_lock lock{pool.mutex};
+    return pool.bytes;
+}
+
+} // namespace gouda
@@ -0,0 +1,265 @@
+/**
+ * @file utils/job_system.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine work stealing job system implementation
+ */
+#include "utils/job_system.hpp"
+
+#include <exception>
+#include <format>
+#include <utility>
+
+#include "debug/logger.hpp"
+#include "math/math.hpp"
+#include "utils/thread.hpp"
+
+namespace gouda {
+
+namespace internal {
+
+constexpr u32 NO_QUEUE{constants::u32_max};
+
+// Queue owned by the calling thread, only meaningful when t_job_system is the system asking
+thread_local const JobSystem *t_job_system{nullptr};
+thread_local u32 t_queue_index{NO_QUEUE};
+
+} // namespace internal
+
+JobCounter::JobCounter() : m_pending{0} {}
+
+JobSystem::JobSystem(const u32 worker_count) : m_main_thread_id{std::this_thread::get_id()}, m_queued_jobs{0}
+{
+    internal::t_job_system = this;
+    internal::t_queue_index = 0;
+
+    m_queues.reserve(worker_count + 1);
+    for (u32 i = 0; i <= worker_count; ++i) {
+        m_queues.push_back(std::make_unique<WorkQueue>());
+    }
+
+    m_threads.reserve(worker_count);
+    for (u32 i = 0; i < worker_count; ++i) {
+        m_threads.push_back(
+            MakeThread(std::format("Job worker {}", i + 1), ThreadPriority::Jobs,
+                       [this, i](const std::stop_token &stop_token) { WorkerLoop(stop_token, i + 1); }));
+    }
+
+    ENGINE_LOG_DEBUG("Job system started with {} workers.", worker_count);
+}
+
+JobSystem::~JobSystem()
+{
+    for (auto &thread : m_threads) {
+        thread.request_stop();
+    }
+    m_wake_condition.notify_all();
+    m_threads.clear();
+
+    if (internal::t_job_system == this) {
+        internal::t_job_system = nullptr;
+        internal::t_queue_index = internal::NO_QUEUE;
+    }
+}
+
+void JobSystem::Schedule(Job job, JobCounter *counter)
+{
+    if (counter != nullptr) {
+        counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+    }
+    Push(QueuedJob{std::move(job), counter});
+}
+
+void JobSystem::ScheduleAfter(JobCounter &dependency, Job job, JobCounter *counter)
+{
+    if (counter != nullptr) {
+        counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    {
+        // Finish takes the continuations under the same lock it drops the count to zero with
+        std::lock_guard lock{dependency.m_mutex};
+        if (!dependency.IsDone()) {
+            dependency.m_continuations.push_back(JobCounter::Continuation{std::move(job), counter});
+            return;
+        }
+    }
+
+    Push(QueuedJob{std::move(job), counter});
+}
+
+void JobSystem::ScheduleOnMainThread(Job job, JobCounter *counter)
+{
+    if (counter != nullptr) {
+        counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::lock_guard lock{m_main_thread_mutex};
+    m_main_thread_jobs.push_back(QueuedJob{std::move(job), counter});
+}
+
+void JobSystem::RunMainThreadJobs()
+{
+    if (!IsMainThread()) {
+        return;
+    }
+
+    Vector<QueuedJob> jobs;
+    {
+        std::lock_guard lock{m_main_thread_mutex};
+        jobs = std::exchange(m_main_thread_jobs, {});
+    }
+
+    for (QueuedJob &job : jobs) {
+        Execute(job);
+    }
+}
+
+void JobSystem::Wait(JobCounter &counter)
+{
+    const bool is_main_thread{IsMainThread()};
+    while (!counter.IsDone()) {
+        QueuedJob job;
+        if (TryTake(job)) {
+            Execute(job);
+            continue;
+        }
+
+        // A worker job may be waiting on a main thread job, so the main thread must keep draining its queue
+        if (is_main_thread) {
+            RunMainThreadJobs();
+        }
+        std::this_thread::yield();
+    }
+
+    // The last job may still be inside Finish, holding the counter's lock
+    std::lock_guard lock{counter.m_mutex};
+}
+
+void JobSystem::ParallelFor(const u32 count, const u32 grain_size, const RangeJob &job)
+{
+    if (count == 0) {
+        return;
+    }
+
+    const u32 grain{math::max(grain_size, 1u)};
+    if (count <= grain || m_threads.empty()) {
+        job(0, count);
+        return;
+    }
+
+    // Every range is queued here, the waiting thread then works through them alongside the workers
+    JobCounter counter;
+    for (u32 begin = 0; begin < count; begin += math::min(grain, count - begin)) {
+        const u32 end{begin + math::min(grain, count - begin)};
+        Schedule([&job, begin, end] { job(begin, end); }, &counter);
+    }
+    Wait(counter);
+}
+
+void JobSystem::WorkerLoop(const std::stop_token &stop_token, const u32 queue_index)
+{
+    internal::t_job_system = this;
+    internal::t_queue_index = queue_index;
+
+    while (!stop_token.stop_requested()) {
+        QueuedJob job;
+        if (TryTake(job)) {
+            Execute(job);
+            continue;
+        }
+
+        std::unique_lock lock{m_sleep_mutex};
+        m_wake_condition.wait(lock, stop_token, [this] { return m_queued_jobs.load(std::memory_order_relaxed) > 0; });
+    }
+}
+
+void JobSystem::Push(QueuedJob job)
+{
+    // Workers keep their own jobs, everyone else hands them to the main thread's queue for the workers to steal
+    const u32 queue_index{internal::t_job_system == this ? internal::t_queue_index : 0};
+    {
+        WorkQueue &queue{*m_queues[queue_index]};
+        std::lock_guard lock{queue.mutex};
+        queue.jobs.push_back(std::move(job));
+    }
+
+    {
+        std::lock_guard lock{m_sleep_mutex};
+        m_queued_jobs.fetch_add(1, std::memory_order_relaxed);
+    }
+    m_wake_condition.notify_one();
+}
+
+bool JobSystem::TryTake(QueuedJob &job)
+{
+    const u32 queue_count{static_cast<u32>(m_queues.size())};
+    const u32 own_index{internal::t_job_system == this ? internal::t_queue_index : internal::NO_QUEUE};
+
+    if (own_index != internal::NO_QUEUE) {
+        WorkQueue &queue{*m_queues[own_index]};
+        std::lock_guard lock{queue.mutex};
+        if (!queue.jobs.empty()) {
+            job = std::move(queue.jobs.back());
+            queue.jobs.pop_back();
+            m_queued_jobs.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    // Steal the oldest job of another queue, starting past our own so thieves spread out
+    const u32 first{own_index == internal::NO_QUEUE ? 0 : own_index + 1};
+    for (u32 offset = 0; offset < queue_count; ++offset) {
+        const u32 index{(first + offset) % queue_count};
+        if (index == own_index) {
+            continue;
+        }
+
+        WorkQueue &queue{*m_queues[index]};
+        std::lock_guard lock{queue.mutex};
+        if (!queue.jobs.empty()) {
+            job = std::move(queue.jobs.front());
+            queue.jobs.pop_front();
+            m_queued_jobs.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void JobSystem::Execute(QueuedJob &job)
+{
+    try {
+        job.job();
+    }
+    catch (const std::exception &error) {
+        ENGINE_LOG_ERROR("Job failed: {}", error.what());
+    }
+    catch (...) {
+        ENGINE_LOG_ERROR("Job failed with an unknown exception.");
+    }
+
+    if (job.counter != nullptr) {
+        Finish(*job.counter);
+    }
+}
+
+void JobSystem::Finish(JobCounter &counter)
+{
+    Vector<JobCounter::Continuation> continuations;
+    {
+        std::lock_guard lock{counter.m_mutex};
+        if (counter.m_pending.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+            return;
+        }
+        continuations = std::exchange(counter.m_continuations, {});
+    }
+
+    // The counter may be gone from here on, a waiter can return as soon as the lock is released
+    for (JobCounter::Continuation &continuation : continuations) {
+        Push(QueuedJob{std::move(continuation.job), continuation.counter});
+    }
+}
+
+} // namespace gouda
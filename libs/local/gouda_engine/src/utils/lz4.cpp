@@ -0,0 +1,209 @@
+/**
+ * @file utils/lz4.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine LZ4 block compression implementation
+ */
+#include "utils/lz4.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <memory>
+
+namespace gouda::utils {
+
+namespace internal {
+
+constexpr size_t MIN_MATCH{4};
+constexpr size_t LAST_LITERALS{5};     // The block always ends with at least this many literals
+constexpr size_t MATCH_FIND_LIMIT{12}; // No match may start within this many bytes of the end
+constexpr size_t MAX_OFFSET{65535};
+constexpr u32 HASH_BITS{14};
+
+static u32 read_u32(const std::byte *p)
+{
+    u32 value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static u32 hash_sequence(const u32 sequence) { return (sequence * 2654435761u) >> (32 - HASH_BITS); }
+
+// Writes the 255 continuation bytes of a literal or match length that did not fit in its token nibble
+static bool write_length(std::byte *&out, const std::byte *out_end, size_t length)
+{
+    for (; length >= 255; length -= 255) {
+        if (out == out_end) {
+            return false;
+        }
+        *out++ = std::byte{255};
+    }
+    if (out == out_end) {
+        return false;
+    }
+    *out++ = static_cast<std::byte>(length);
+    return true;
+}
+
+static bool read_length(const std::byte *&in, const std::byte *in_end, size_t &length)
+{
+    u8 byte{255};
+    while (byte == 255) {
+        if (in == in_end) {
+            return false;
+        }
+        byte = static_cast<u8>(*in++);
+        length += byte;
+    }
+    return true;
+}
+
+// One sequence: a token, the literals since the last match, then the match unless this is the final sequence
+static bool write_sequence(std::byte *&out, const std::byte *out_end, const std::span<const std::byte> literals,
+                           const size_t offset, const size_t match_length)
+{
+    if (out == out_end) {
+        return false;
+    }
+    std::byte *token{out++};
+    const size_t literal_count{literals.size()};
+    const size_t match_code{match_length == 0 ? 0 : match_length - MIN_MATCH};
+    *token = static_cast<std::byte>((std::min<size_t>(literal_count, 15) << 4) | std::min<size_t>(match_code, 15));
+
+    if (literal_count >= 15 && !write_length(out, out_end, literal_count - 15)) {
+        return false;
+    }
+    if (static_cast<size_t>(out_end - out) < literal_count) {
+        return false;
+    }
+    if (literal_count > 0) {
+        std::memcpy(out, literals.data(), literal_count);
+        out += literal_count;
+    }
+
+    if (match_length == 0) {
+        return true;
+    }
+    if (out_end - out < 2) {
+        return false;
+    }
+    *out++ = static_cast<std::byte>(offset & 0xFF);
+    *out++ = static_cast<std::byte>(offset >> 8);
+    return match_code < 15 || write_length(out, out_end, match_code - 15);
+}
+
+} // namespace internal
+
+size_t lz4_compress(const std::span<const std::byte> data, const std::span<std::byte> output)
+{
+    const std::byte *source{data.data()};
+    const size_t size{data.size()};
+    std::byte *out{output.data()};
+    const std::byte *out_end{out + output.size()};
+
+    // Positions plus one, zero marks an empty slot
+    const auto table{std::make_unique<std::array<u32, size_t{1} << internal::HASH_BITS>>()};
+
+    size_t anchor{0};
+    if (size > internal::MATCH_FIND_LIMIT) {
+        const size_t match_start_limit{size - internal::MATCH_FIND_LIMIT};
+        const size_t match_end_limit{size - internal::LAST_LITERALS};
+
+        size_t position{0};
+        while (position < match_start_limit) {
+            const u32 sequence{internal::read_u32(source + position)};
+            u32 &slot{(*table)[internal::hash_sequence(sequence)]};
+            const size_t candidate{static_cast<size_t>(slot) - 1};
+            const bool has_candidate{slot != 0 && position - candidate <= internal::MAX_OFFSET};
+            slot = static_cast<u32>(position + 1);
+
+            if (!has_candidate || internal::read_u32(source + candidate) != sequence) {
+                ++position;
+                continue;
+            }
+
+            size_t match_length{internal::MIN_MATCH};
+            while (position + match_length < match_end_limit &&
+                   source[candidate + match_length] == source[position + match_length]) {
+                ++match_length;
+            }
+
+            if (!internal::write_sequence(out, out_end, data.subspan(anchor, position - anchor),
+                                          position - candidate, match_length)) {
+                return 0;
+            }
+            position += match_length;
+            anchor = position;
+        }
+    }
+
+    if (!internal::write_sequence(out, out_end, data.subspan(anchor), 0, 0)) {
+        return 0;
+    }
+    return static_cast<size_t>(out - output.data());
+}
+
+bool lz4_decompress(const std::span<const std::byte> data, const std::span<std::byte> output)
+{
+    const std::byte *in{data.data()};
+    const std::byte *in_end{in + data.size()};
+    std::byte *out{output.data()};
+    std::byte *out_end{out + output.size()};
+
+    while (in != in_end) {
+        const auto token{static_cast<u8>(*in++)};
+
+        size_t literal_count{static_cast<size_t>(token >> 4)};
+        if (literal_count == 15 && !internal::read_length(in, in_end, literal_count)) {
+            return false;
+        }
+        if (static_cast<size_t>(in_end - in) < literal_count || static_cast<size_t>(out_end - out) < literal_count) {
+            return false;
+        }
+        if (literal_count > 0) {
+            std::memcpy(out, in, literal_count);
+            in += literal_count;
+            out += literal_count;
+        }
+
+        // The final sequence has no match
+        if (in == in_end) {
+            break;
+        }
+
+        if (in_end - in < 2) {
+            return false;
+        }
+        const size_t offset{static_cast<size_t>(in[0]) | static_cast<size_t>(in[1]) << 8};
+        in += 2;
+        if (offset == 0 || offset > static_cast<size_t>(out - output.data())) {
+            return false;
+        }
+
+        size_t match_length{static_cast<size_t>(token & 0x0F)};
+        if (match_length == 15 && !internal::read_length(in, in_end, match_length)) {
+            return false;
+        }
+        match_length += internal::MIN_MATCH;
+        if (static_cast<size_t>(out_end - out) < match_length) {
+            return false;
+        }
+
+        // Overlapping matches repeat the last offset bytes, so they are copied forwards one byte at a time
+        const std::byte *match{out - offset};
+        if (offset >= match_length) {
+            std::memcpy(out, match, match_length);
+            out += match_length;
+        }
+        else {
+            for (size_t i = 0; i < match_length; ++i) {
+                *out++ = match[i];
+            }
+        }
+    }
+
+    return out == out_end;
+}
+
+} // namespace gouda::utils
@@ -0,0 +1,160 @@
+/**
+ * @file utils/mapped_file.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine read only memory mapped file implementation
+ */
+#include "utils/mapped_file.hpp"
+
+#include <utility>
+
+#include "debug/logger.hpp"
+#include "utils/asset_archive.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define MAPPED_FILE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#elif defined(_WIN32)
+#define MAPPED_FILE_WINDOWS
+#include <windows.h>
+#endif
+
+namespace gouda::fs {
+
+MappedFile::MappedFile() : p_data{nullptr}, m_size{0}, m_is_view{false} {}
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+    : p_data{std::exchange(other.p_data, nullptr)},
+      m_size{std::exchange(other.m_size, 0)},
+      m_buffer{std::move(other.m_buffer)},
+      m_is_view{std::exchange(other.m_is_view, false)}
+{
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept
+{
+    if (this != &other) {
+        Release();
+        p_data = std::exchange(other.p_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+        m_buffer = std::move(other.m_buffer);
+        m_is_view = std::exchange(other.m_is_view, false);
+    }
+    return *this;
+}
+
+MappedFile::~MappedFile() { Release(); }
+
+Expect<MappedFile, Error> MappedFile::Open(StringView filepath)
+{
+    if (const AssetArchive *archive{FindMountedArchive(filepath)}) {
+        return archive->Read(filepath);
+    }
+
+    MappedFile file;
+
+#if defined(MAPPED_FILE_MMAP)
+    const String path{filepath};
+    const int handle{open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+    if (handle < 0) {
+        return std::unexpected(Error::FileNotFound);
+    }
+
+    struct stat status{};
+    if (fstat(handle, &status) != 0 || status.st_size <= 0) {
+        close(handle);
+        return std::unexpected(Error::FileReadError);
+    }
+
+    // The mapping keeps its own reference to the file, the handle is not needed past this point
+    const size_t size{static_cast<size_t>(status.st_size)};
+    void *mapping{mmap(nullptr, size, PROT_READ, MAP_PRIVATE, handle, 0)};
+    close(handle);
+
+    if (mapping != MAP_FAILED) {
+        file.p_data = static_cast<const std::byte *>(mapping);
+        file.m_size = size;
+        return file;
+    }
+    ENGINE_LOG_WARNING("Cannot map '{}', reading it instead.", filepath);
+
+#elif defined(MAPPED_FILE_WINDOWS)
+    const HANDLE handle{CreateFileW(FilePath{filepath}.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                    FILE_ATTRIBUTE_NORMAL, nullptr)};
+    if (handle == INVALID_HANDLE_VALUE) {
+        return std::unexpected(Error::FileNotFound);
+    }
+
+    LARGE_INTEGER file_size{};
+    if (GetFileSizeEx(handle, &file_size) == 0 || file_size.QuadPart <= 0) {
+        CloseHandle(handle);
+        return std::unexpected(Error::FileReadError);
+    }
+
+    // The mapping object keeps the file open and the view keeps the mapping object, neither handle is needed after
+    const size_t size{static_cast<size_t>(file_size.QuadPart)};
+    const HANDLE mapping{CreateFileMappingW(handle, nullptr, PAGE_READONLY, 0, 0, nullptr)};
+    CloseHandle(handle);
+
+    if (mapping != nullptr) {
+        const void *view{MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0)};
+        CloseHandle(mapping);
+        if (view != nullptr) {
+            file.p_data = static_cast<const std::byte *>(view);
+            file.m_size = size;
+            return file;
+        }
+    }
+    ENGINE_LOG_WARNING("Cannot map '{}', reading it instead.", filepath);
+#endif
+
+    auto contents{ReadBinaryFile(filepath)};
+    if (!contents) {
+        return std::unexpected(contents.error());
+    }
+    if (contents->empty()) {
+        return std::unexpected(Error::FileReadError); // Matches the mapped path, which cannot map an empty file
+    }
+    return FromBuffer(std::move(*contents));
+}
+
+MappedFile MappedFile::FromView(const std::span<const std::byte> data)
+{
+    MappedFile file;
+    file.p_data = data.data();
+    file.m_size = data.size();
+    file.m_is_view = true;
+    return file;
+}
+
+MappedFile MappedFile::FromBuffer(std::vector<std::byte> buffer)
+{
+    MappedFile file;
+    file.m_buffer = std::move(buffer);
+    file.p_data = file.m_buffer.data();
+    file.m_size = file.m_buffer.size();
+    return file;
+}
+
+void MappedFile::Release() noexcept
+{
+#if defined(MAPPED_FILE_MMAP)
+    if (p_data != nullptr && m_buffer.empty() && !m_is_view) {
+        munmap(const_cast<std::byte *>(p_data), m_size);
+    }
+#elif defined(MAPPED_FILE_WINDOWS)
+    if (p_data != nullptr && m_buffer.empty() && !m_is_view) {
+        UnmapViewOfFile(p_data);
+    }
+#endif
+    p_data = nullptr;
+    m_size = 0;
+    m_buffer.clear();
+    m_is_view = false;
+}
+
+} // namespace gouda::fs
@@ -0,0 +1,147 @@
+/**
+ * @file utils/quality_governor.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine adaptive quality governor implementation
+ */
+#include "utils/quality_governor.hpp"
+
+#include <algorithm>
+
+#include "debug/logger.hpp"
+
+namespace gouda::utils {
+
+namespace internal {
+
+struct GpuLevel {
+    f32 render_scale;
+    f32 particle_spawn_scale;
+    f32 light_scale;
+};
+
+// Resolution goes first, it buys the most GPU time for the least visible loss
+constexpr std::array<GpuLevel, 5> GPU_LEVELS{{
+    {1.0f, 1.0f, 1.0f},
+    {0.85f, 1.0f, 0.75f},
+    {0.75f, 0.75f, 0.5f},
+    {0.65f, 0.5f, 0.35f},
+    {0.5f, 0.25f, 0.25f},
+}};
+
+constexpr std::array<u32, 4> CPU_LEVELS{1, 2, 3, 4}; // Animation intervals
+
+} // namespace internal
+
+QualityGovernor::QualityGovernor() : m_budget{0.0f}, m_cpu{}, m_gpu{}, m_settings{}
+{
+    m_cpu.level_count = static_cast<u32>(internal::CPU_LEVELS.size());
+    m_gpu.level_count = static_cast<u32>(internal::GPU_LEVELS.size());
+}
+
+void QualityGovernor::SetFrameBudget(const f32 budget)
+{
+    m_budget = std::max(budget, 0.0f);
+    Reset();
+}
+
+bool QualityGovernor::AddFrame(const f32 cpu_time, const f32 gpu_time)
+{
+    if (!IsEnabled()) {
+        return false;
+    }
+
+    bool is_changed{UpdateAxis(m_cpu, cpu_time)};
+    if (gpu_time > 0.0f) {
+        is_changed |= UpdateAxis(m_gpu, gpu_time);
+    }
+    if (!is_changed) {
+        return false;
+    }
+
+    ApplyLevels();
+    ENGINE_LOG_DEBUG("Quality governor at CPU level {} ({:.2f} ms) and GPU level {} ({:.2f} ms), budget {:.2f} ms.",
+                     m_cpu.level, m_cpu.GetMean(), m_gpu.level, m_gpu.GetMean(), m_budget);
+    return true;
+}
+
+void QualityGovernor::Reset()
+{
+    for (Axis *axis : {&m_cpu, &m_gpu}) {
+        axis->ClearWindow();
+        axis->level = 0;
+        axis->settle_frames = 0;
+        axis->raise_frames = RAISE_FRAMES;
+        axis->frames_since_raise = 0;
+        axis->was_raised = false;
+    }
+    ApplyLevels();
+}
+
+void QualityGovernor::Axis::ClearWindow()
+{
+    sum = 0.0f;
+    next_sample = 0;
+    sample_count = 0;
+    over_frames = 0;
+    under_frames = 0;
+}
+
+bool QualityGovernor::UpdateAxis(Axis &axis, const f32 sample) const
+{
+    ++axis.frames_since_raise;
+    if (axis.settle_frames > 0) {
+        --axis.settle_frames;
+        return false;
+    }
+
+    // The sum is kept running, the oldest sample leaves it as the newest comes in
+    if (axis.sample_count == WINDOW_SIZE) {
+        axis.sum -= axis.samples[axis.next_sample];
+    }
+    else {
+        ++axis.sample_count;
+    }
+    axis.samples[axis.next_sample] = sample;
+    axis.sum += sample;
+    axis.next_sample = (axis.next_sample + 1) % WINDOW_SIZE;
+
+    const f32 mean{axis.GetMean()};
+    axis.over_frames = mean > m_budget ? axis.over_frames + 1 : 0;
+    axis.under_frames = mean < m_budget * RAISE_THRESHOLD ? axis.under_frames + 1 : 0;
+
+    u32 level{axis.level};
+    if (axis.over_frames >= LOWER_FRAMES && level + 1 < axis.level_count) {
+        // A raise that did not hold makes the next one wait longer
+        if (axis.was_raised && axis.frames_since_raise < axis.raise_frames) {
+            axis.raise_frames = std::min(axis.raise_frames * 2, MAX_RAISE_FRAMES);
+        }
+        axis.was_raised = false;
+        ++level;
+    }
+    else if (axis.under_frames >= axis.raise_frames && level > 0) {
+        axis.was_raised = true;
+        axis.frames_since_raise = 0;
+        --level;
+    }
+    else {
+        return false;
+    }
+
+    // Judged afresh at the new level, once its effect has reached the timings
+    axis.ClearWindow();
+    axis.level = level;
+    axis.settle_frames = SETTLE_FRAMES;
+    return true;
+}
+
+void QualityGovernor::ApplyLevels()
+{
+    const internal::GpuLevel &gpu{internal::GPU_LEVELS[m_gpu.level]};
+    m_settings = {.render_scale = gpu.render_scale,
+                  .particle_spawn_scale = gpu.particle_spawn_scale,
+                  .light_scale = gpu.light_scale,
+                  .animation_interval = internal::CPU_LEVELS[m_cpu.level]};
+}
+
+} // namespace gouda::utils
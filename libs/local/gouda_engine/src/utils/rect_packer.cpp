@@ -0,0 +1,113 @@
+/**
+ * @file utils/rect_packer.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine skyline rectangle packer implementation
+ */
+#include "utils/rect_packer.hpp"
+
+#include <limits>
+
+#include "math/math.hpp"
+
+namespace gouda {
+
+RectPacker::RectPacker(const ImageSize size) : m_size{size}, m_used_area{0} { Reset(); }
+
+std::optional<PackedRect> RectPacker::Insert(const int width, const int height)
+{
+    if (width <= 0 || height <= 0) {
+        return std::nullopt;
+    }
+
+    size_t best_index{m_skyline.size()};
+    int best_y{0};
+    int best_top{std::numeric_limits<int>::max()};
+    int best_segment_width{std::numeric_limits<int>::max()};
+    for (size_t segment_index = 0; segment_index < m_skyline.size(); ++segment_index) {
+        const int y{FitAt(segment_index, width, height)};
+        if (y < 0) {
+            continue;
+        }
+
+        // Lowest top edge first, on ties the narrower segment keeps the wider gaps open
+        const int top{y + height};
+        if (top < best_top || (top == best_top && m_skyline[segment_index].width < best_segment_width)) {
+            best_index = segment_index;
+            best_y = y;
+            best_top = top;
+            best_segment_width = m_skyline[segment_index].width;
+        }
+    }
+
+    if (best_index == m_skyline.size()) {
+        return std::nullopt;
+    }
+
+    const PackedRect rect{m_skyline[best_index].x, best_y, width, height};
+    m_skyline.insert(m_skyline.begin() + static_cast<std::ptrdiff_t>(best_index),
+                     SkylineSegment{rect.x, best_top, width});
+
+    // Segments under the new one are shadowed by it, the last one may only be partly covered
+    const int right{rect.x + width};
+    for (size_t segment_index = best_index + 1;
+         segment_index < m_skyline.size() && m_skyline[segment_index].x < right;) {
+        SkylineSegment &segment{m_skyline[segment_index]};
+        const int segment_right{segment.x + segment.width};
+        if (segment_right <= right) {
+            m_skyline.erase(m_skyline.begin() + static_cast<std::ptrdiff_t>(segment_index));
+            continue;
+        }
+        segment.x = right;
+        segment.width = segment_right - right;
+        break;
+    }
+
+    for (size_t segment_index = 0; segment_index + 1 < m_skyline.size();) {
+        if (m_skyline[segment_index].y == m_skyline[segment_index + 1].y) {
+            m_skyline[segment_index].width += m_skyline[segment_index + 1].width;
+            m_skyline.erase(m_skyline.begin() + static_cast<std::ptrdiff_t>(segment_index + 1));
+        }
+        else {
+            ++segment_index;
+        }
+    }
+
+    m_used_area += s64{width} * height;
+    return rect;
+}
+
+void RectPacker::Reset()
+{
+    m_skyline.clear();
+    m_skyline.push_back(SkylineSegment{0, 0, m_size.width});
+    m_used_area = 0;
+}
+
+f32 RectPacker::GetOccupancy() const noexcept
+{
+    const s64 area{s64{m_size.width} * m_size.height};
+    return area > 0 ? static_cast<f32>(m_used_area) / static_cast<f32>(area) : 0.0f;
+}
+
+int RectPacker::FitAt(const size_t segment_index, const int width, const int height) const
+{
+    const int x{m_skyline[segment_index].x};
+    if (x + width > m_size.width) {
+        return -1;
+    }
+
+    // The skyline spans the full width, so the segments to the right always cover x + width
+    int y{0};
+    int remaining_width{width};
+    for (size_t index = segment_index; remaining_width > 0; ++index) {
+        y = math::max(y, m_skyline[index].y);
+        if (y + height > m_size.height) {
+            return -1;
+        }
+        remaining_width -= m_skyline[index].width;
+    }
+    return y;
+}
+
+} // namespace gouda
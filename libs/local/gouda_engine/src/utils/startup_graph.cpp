@@ -0,0 +1,146 @@
+/**
+ * @file utils/startup_graph.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine startup task dependency graph implementation
+ */
+#include "utils/startup_graph.hpp"
+
+#include <algorithm>
+
+#include "debug/assert.hpp"
+#include "debug/logger.hpp"
+#include "utils/job_system.hpp"
+
+namespace gouda {
+
+StartupGraph::StartupGraph() : m_remaining_tasks{0} {}
+
+StartupGraph::TaskId StartupGraph::AddTask(const StringView name, Task task,
+                                           const std::initializer_list<TaskId> dependencies, const TaskThread thread)
+{
+    const auto id{static_cast<TaskId>(m_tasks.size())};
+    TaskEntry entry{.name = String{name},
+                    .task = std::move(task),
+                    .thread = thread,
+                    .dependencies = {},
+                    .dependants = {},
+                    .pending_dependencies = static_cast<u32>(dependencies.size()),
+                    .start = {},
+                    .end = {},
+                    .ran_on_main_thread = false};
+    for (const TaskId dependency : dependencies) {
+        ASSERT(dependency < id, "Startup tasks can only depend on tasks added before them.");
+        entry.dependencies.push_back(dependency);
+        m_tasks[dependency].dependants.push_back(id);
+    }
+    m_tasks.push_back(std::move(entry));
+    return id;
+}
+
+void StartupGraph::Run(JobSystem &job_system)
+{
+    ASSERT(job_system.IsMainThread(), "Startup graphs run from the main thread.");
+    m_start_time = SteadyClock::now();
+    m_remaining_tasks = static_cast<u32>(m_tasks.size());
+    m_exception = nullptr;
+
+    for (TaskId id = 0; id < m_tasks.size(); ++id) {
+        if (m_tasks[id].pending_dependencies == 0) {
+            Dispatch(job_system, id);
+        }
+    }
+
+    // The main thread only runs its own tasks, the workers take the rest
+    std::unique_lock lock{m_mutex};
+    while (true) {
+        m_condition.wait(lock, [this] { return !m_main_thread_ready.empty() || m_remaining_tasks == 0; });
+        if (m_main_thread_ready.empty()) {
+            break;
+        }
+        const TaskId id{m_main_thread_ready.front()};
+        m_main_thread_ready.erase(m_main_thread_ready.begin());
+        lock.unlock();
+        Execute(job_system, id);
+        lock.lock();
+    }
+    lock.unlock();
+
+    LogTimeline();
+    if (m_exception) {
+        std::rethrow_exception(m_exception);
+    }
+}
+
+void StartupGraph::Dispatch(JobSystem &job_system, const TaskId id)
+{
+    // Without workers nothing else would ever run the task
+    if (m_tasks[id].thread == TaskThread::Main || job_system.GetWorkerCount() == 0) {
+        {
+            const std::lock_guard lock{m_mutex};
+            m_main_thread_ready.push_back(id);
+        }
+        m_condition.notify_one();
+        return;
+    }
+    job_system.Schedule([this, &job_system, id] { Execute(job_system, id); });
+}
+
+void StartupGraph::Execute(JobSystem &job_system, const TaskId id)
+{
+    TaskEntry &entry{m_tasks[id]};
+    entry.ran_on_main_thread = job_system.IsMainThread();
+    entry.start = SteadyClock::now() - m_start_time;
+    try {
+        entry.task();
+    }
+    catch (...) {
+        ENGINE_LOG_ERROR("Startup task '{}' failed.", entry.name);
+        const std::lock_guard lock{m_mutex};
+        if (!m_exception) {
+            m_exception = std::current_exception();
+        }
+    }
+    entry.end = SteadyClock::now() - m_start_time;
+
+    SmallVector<TaskId, 4> ready;
+    {
+        const std::lock_guard lock{m_mutex};
+        for (const TaskId dependant : entry.dependants) {
+            if (--m_tasks[dependant].pending_dependencies == 0) {
+                ready.push_back(dependant);
+            }
+        }
+        --m_remaining_tasks;
+    }
+    for (const TaskId dependant : ready) {
+        Dispatch(job_system, dependant);
+    }
+    m_condition.notify_one();
+}
+
+void StartupGraph::LogTimeline() const
+{
+    // Dependencies come before their dependants, so one pass in order finds the longest chain ending at each task
+    Vector<f64> chain_ends(m_tasks.size(), 0.0);
+    f64 longest_chain{0.0};
+    f64 total{0.0};
+    for (TaskId id = 0; id < m_tasks.size(); ++id) {
+        const TaskEntry &entry{m_tasks[id]};
+        f64 chain_start{0.0};
+        for (const TaskId dependency : entry.dependencies) {
+            chain_start = std::max(chain_start, chain_ends[dependency]);
+        }
+        chain_ends[id] = chain_start + (entry.end - entry.start).count();
+        longest_chain = std::max(longest_chain, chain_ends[id]);
+        total = std::max(total, entry.end.count());
+    }
+
+    ENGINE_LOG_INFO("Startup took {:.2f} ms, its longest dependency chain {:.2f} ms.", total, longest_chain);
+    for ([[maybe_unused]] const TaskEntry &entry : m_tasks) {
+        ENGINE_LOG_DEBUG("  {:<16} {:8.2f} ms to {:8.2f} ms on {}", entry.name, entry.start.count(), entry.end.count(),
+                         entry.ran_on_main_thread ? "the main thread" : "a worker");
+    }
+}
+
+} // namespace gouda
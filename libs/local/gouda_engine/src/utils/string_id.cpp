@@ -0,0 +1,66 @@
+/**
+ * @file utils/string_id.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine hashed string identifiers implementation
+ */
+#include "utils/string_id.hpp"
+
+#include <deque>
+#include <mutex>
+
+#include "debug/logger.hpp"
+
+namespace gouda {
+
+#ifndef NDEBUG
+namespace internal {
+
+// Names by hash, a deque so the StringViews handed out stay valid as it grows
+struct StringIdNames {
+    std::mutex mutex;
+    FlatHashMap<u64, u32> indices;
+    std::deque<String> names;
+};
+
+static StringIdNames &get_string_id_names()
+{
+    static StringIdNames names;
+    return names;
+}
+
+} // namespace internal
+#endif
+
+StringId StringId::Register(const StringView name)
+{
+    const StringId id{name};
+#ifndef NDEBUG
+    internal::StringIdNames &table{internal::get_string_id_names()};
+    std::scoped_lock lock{table.mutex};
+    if (const u32 *index{table.indices.get(id.m_hash)}) {
+        if (table.names[*index] != name) {
+            ENGINE_LOG_ERROR("String id collision: '{}' and '{}' both hash to {:#018x}.", table.names[*index], name,
+                             id.m_hash);
+        }
+        return id;
+    }
+    table.indices.emplace(id.m_hash, static_cast<u32>(table.names.size()));
+    table.names.emplace_back(name);
+#endif
+    return id;
+}
+
+StringView StringId::GetName() const
+{
+#ifndef NDEBUG
+    internal::StringIdNames &table{internal::get_string_id_names()};
+    std::scoped_lock lock{table.mutex};
+    if (const u32 *index{table.indices.get(m_hash)}) {
+        return table.names[*index];
+    }
+#endif
+    return {};
+}
+
+} // namespace gouda
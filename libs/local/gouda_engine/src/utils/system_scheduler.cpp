@@ -0,0 +1,93 @@
+/**
+ * @file utils/system_scheduler.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine parallel system update scheduler implementation
+ */
+#include "utils/system_scheduler.hpp"
+
+#include <utility>
+
+#include "debug/logger.hpp"
+#include "math/math.hpp"
+#include "utils/worker_pool.hpp"
+
+namespace gouda {
+
+SystemScheduler::SystemScheduler(WorkerPool *worker_pool) : p_worker_pool{worker_pool}, m_stages_dirty{false} {}
+
+void SystemScheduler::AddSystem(StringView name, const SystemResources reads, const SystemResources writes,
+                                System system, const u32 interval)
+{
+    // The head start staggers the systems sharing an interval
+    const u32 ticks_per_run{math::max(interval, 1u)};
+    m_systems.push_back(SystemEntry{String{name}, reads | writes, writes, std::move(system), ticks_per_run,
+                                    static_cast<u32>(m_systems.size()) % ticks_per_run, 0.0f, false});
+    m_stages_dirty = true;
+}
+
+void SystemScheduler::Run(const f32 delta_time)
+{
+    if (m_stages_dirty) {
+        BuildStages();
+    }
+
+    for (SystemEntry &system : m_systems) {
+        system.elapsed_delta_time += delta_time;
+        system.is_due = ++system.elapsed_ticks >= system.interval;
+    }
+
+    u32 stage_begin{0};
+    for (const u32 stage_end : m_stage_ends) {
+        p_worker_pool->Run(stage_end - stage_begin, [&](const u32 task_index) {
+            SystemEntry &system{m_systems[m_stage_systems[stage_begin + task_index]]};
+            if (system.is_due) {
+                system.system(system.elapsed_delta_time);
+                system.elapsed_ticks = 0;
+                system.elapsed_delta_time = 0.0f;
+            }
+        });
+        stage_begin = stage_end;
+    }
+}
+
+size_t SystemScheduler::GetStageCount()
+{
+    if (m_stages_dirty) {
+        BuildStages();
+    }
+    return m_stage_ends.size();
+}
+
+void SystemScheduler::BuildStages()
+{
+    // A system has to follow every earlier system it conflicts with, anything else it can run beside
+    Vector<u32> system_stages(m_systems.size(), 0);
+    u32 stage_count{0};
+    for (size_t i = 0; i < m_systems.size(); ++i) {
+        const SystemEntry &system{m_systems[i]};
+        for (size_t earlier = 0; earlier < i; ++earlier) {
+            const SystemEntry &other{m_systems[earlier]};
+            if ((system.writes & other.reads) != 0 || (system.reads & other.writes) != 0) {
+                system_stages[i] = math::max(system_stages[i], system_stages[earlier] + 1);
+            }
+        }
+        stage_count = math::max(stage_count, system_stages[i] + 1);
+    }
+
+    m_stage_systems.clear();
+    m_stage_ends.clear();
+    for (u32 stage = 0; stage < stage_count; ++stage) {
+        for (size_t i = 0; i < m_systems.size(); ++i) {
+            if (system_stages[i] == stage) {
+                m_stage_systems.push_back(static_cast<u32>(i));
+                ENGINE_LOG_DEBUG("System '{}' runs in stage {}.", m_systems[i].name, stage);
+            }
+        }
+        m_stage_ends.push_back(static_cast<u32>(m_stage_systems.size()));
+    }
+
+    m_stages_dirty = false;
+}
+
+} // namespace gouda
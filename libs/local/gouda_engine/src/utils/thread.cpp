@@ -0,0 +1,250 @@
+/**
+ * @file utils/thread.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine named threads with priority classes and core affinity implementation
+ */
+#include "utils/thread.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+#include "containers/small_vector.hpp"
+#include "debug/logger.hpp"
+#include "debug/profiler.hpp"
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#elif defined(__APPLE__)
+#include <pthread.h>
+#endif
+
+namespace gouda {
+
+namespace {
+
+#if defined(_WIN32)
+using NativeThreadId = DWORD;
+#elif defined(__linux__)
+using NativeThreadId = pid_t;
+#else
+using NativeThreadId = u64;
+#endif
+
+constexpr size_t MAX_THREAD_NAME_LENGTH{15}; // pthread names hold 16 bytes with the terminator
+
+struct RegisteredThread {
+    NativeThreadId id;
+    ThreadPriority priority;
+    bool is_main;
+};
+
+// Function static, threads may be set up during static initialisation
+struct ThreadRegistry {
+    std::mutex mutex;
+    ThreadSettings settings;
+    Vector<RegisteredThread> threads;
+};
+
+ThreadRegistry &get_registry()
+{
+    static ThreadRegistry registry;
+    return registry;
+}
+
+// With the registry's mutex held
+void unregister_thread(ThreadRegistry &registry, const NativeThreadId id)
+{
+    const auto it{std::ranges::find(registry.threads, id, &RegisteredThread::id)};
+    if (it != registry.threads.end()) {
+        registry.threads.swap_remove(it);
+    }
+}
+
+// Removes the thread from the registry when it exits
+struct ThreadRegistration {
+    bool is_registered{false};
+    NativeThreadId id{};
+
+    ~ThreadRegistration()
+    {
+        if (is_registered) {
+            ThreadRegistry &registry{get_registry()};
+            std::lock_guard lock{registry.mutex};
+            unregister_thread(registry, id);
+        }
+    }
+};
+
+thread_local ThreadRegistration t_registration;
+
+NativeThreadId get_native_thread_id()
+{
+#if defined(_WIN32)
+    return GetCurrentThreadId();
+#elif defined(__linux__)
+    return gettid();
+#else
+    return 0;
+#endif
+}
+
+u64 get_all_cores_mask()
+{
+    const u32 core_count{std::clamp(std::thread::hardware_concurrency(), 1u, 64u)};
+    return core_count == 64 ? constants::u64_max : (u64{1} << core_count) - 1;
+}
+
+// Cores a thread may run on, 0 for any
+u64 get_affinity_mask(const ThreadSettings &settings, const ThreadPriority priority, const bool is_main)
+{
+    const u64 all_cores{get_all_cores_mask()};
+    const u32 core_count{static_cast<u32>(std::popcount(all_cores))};
+    const bool is_reserving{settings.reserve_main_core && core_count > 1 &&
+                            core_count <= ThreadSettings::RESERVED_CORE_MAX_CORES};
+    if (is_main && is_reserving) {
+        return 1;
+    }
+
+    const u64 mask{settings.affinity_masks[static_cast<size_t>(priority)] & all_cores};
+    if (mask == 0 && is_reserving &&
+        (priority == ThreadPriority::Jobs || priority == ThreadPriority::IO || priority == ThreadPriority::Logging)) {
+        return all_cores & ~u64{1};
+    }
+    return mask;
+}
+
+bool apply_affinity(const NativeThreadId id, const u64 mask)
+{
+    const u64 cores{mask != 0 ? mask : get_all_cores_mask()}; // Any core, undoing an earlier mask
+#if defined(_WIN32)
+    const HANDLE thread{OpenThread(THREAD_SET_INFORMATION | THREAD_QUERY_INFORMATION, FALSE, id)};
+    if (thread == nullptr) {
+        return false;
+    }
+    const bool applied{SetThreadAffinityMask(thread, static_cast<DWORD_PTR>(cores)) != 0};
+    CloseHandle(thread);
+    return applied;
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (u32 core = 0; core < 64; ++core) {
+        if ((cores >> core) & 1) {
+            CPU_SET(core, &set);
+        }
+    }
+    return sched_setaffinity(id, sizeof(set), &set) == 0;
+#else
+    // No affinity on macOS, the scheduler only takes hints through the priority
+    std::ignore = id;
+    std::ignore = cores;
+    return true;
+#endif
+}
+
+void apply_priority(const ThreadPriority priority)
+{
+#if defined(_WIN32)
+    constexpr std::array<int, THREAD_PRIORITY_COUNT> levels{THREAD_PRIORITY_HIGHEST, THREAD_PRIORITY_ABOVE_NORMAL,
+                                                            THREAD_PRIORITY_NORMAL, THREAD_PRIORITY_BELOW_NORMAL,
+                                                            THREAD_PRIORITY_LOWEST};
+    SetThreadPriority(GetCurrentThread(), levels[static_cast<size_t>(priority)]);
+#elif defined(__linux__)
+    // Nice values per thread, raising one above the default fails without CAP_SYS_NICE and then keeps the default
+    constexpr std::array<int, THREAD_PRIORITY_COUNT> nice_values{-4, -2, 0, 2, 4};
+    const int nice_value{nice_values[static_cast<size_t>(priority)]};
+    if (setpriority(PRIO_PROCESS, static_cast<id_t>(gettid()), nice_value) != 0 && nice_value < 0) {
+        setpriority(PRIO_PROCESS, static_cast<id_t>(gettid()), 0);
+    }
+#elif defined(__APPLE__)
+    constexpr std::array<qos_class_t, THREAD_PRIORITY_COUNT> classes{
+        QOS_CLASS_USER_INTERACTIVE, QOS_CLASS_USER_INTERACTIVE, QOS_CLASS_USER_INITIATED, QOS_CLASS_UTILITY,
+        QOS_CLASS_UTILITY};
+    constexpr std::array<int, THREAD_PRIORITY_COUNT> relative{0, -1, 0, 0, -1};
+    pthread_set_qos_class_self_np(classes[static_cast<size_t>(priority)], relative[static_cast<size_t>(priority)]);
+#else
+    std::ignore = priority;
+#endif
+}
+
+void apply_name(const StringView name)
+{
+#if defined(_WIN32)
+    std::wstring wide_name(name.begin(), name.end()); // Thread names are ASCII
+    SetThreadDescription(GetCurrentThread(), wide_name.c_str());
+#elif defined(__linux__)
+    const String short_name{name.substr(0, MAX_THREAD_NAME_LENGTH)};
+    pthread_setname_np(pthread_self(), short_name.c_str());
+#elif defined(__APPLE__)
+    const String short_name{name.substr(0, MAX_THREAD_NAME_LENGTH)};
+    pthread_setname_np(short_name.c_str());
+#else
+    std::ignore = name;
+#endif
+}
+
+// Nothing here logs, the loggers' own writer threads come through here
+void set_current_thread(const StringView name, const ThreadPriority priority, const bool is_main)
+{
+    apply_name(name);
+    apply_priority(priority);
+    internal::profiler::Profiler::Get().SetThreadName(name);
+
+    const NativeThreadId id{get_native_thread_id()};
+    ThreadRegistry &registry{get_registry()};
+    std::lock_guard lock{registry.mutex};
+    if (t_registration.is_registered) {
+        unregister_thread(registry, id);
+    }
+    registry.threads.push_back({id, priority, is_main});
+    t_registration.is_registered = true;
+    t_registration.id = id;
+    apply_affinity(id, get_affinity_mask(registry.settings, priority, is_main));
+}
+
+} // namespace
+
+void SetThreadSettings(const ThreadSettings &settings)
+{
+    ThreadRegistry &registry{get_registry()};
+    u32 failed_count{0};
+    size_t thread_count{0};
+    {
+        std::lock_guard lock{registry.mutex};
+        registry.settings = settings;
+        for (const RegisteredThread &thread : registry.threads) {
+            if (!apply_affinity(thread.id, get_affinity_mask(settings, thread.priority, thread.is_main))) {
+                ++failed_count;
+            }
+        }
+        thread_count = registry.threads.size();
+    }
+
+    if (failed_count > 0) {
+        ENGINE_LOG_WARNING("Could not set the core affinity of {} of {} threads.", failed_count, thread_count);
+    }
+}
+
+ThreadSettings GetThreadSettings()
+{
+    ThreadRegistry &registry{get_registry()};
+    std::lock_guard lock{registry.mutex};
+    return registry.settings;
+}
+
+void SetMainThread(const StringView name) { set_current_thread(name, ThreadPriority::Render, true); }
+
+void SetCurrentThread(const StringView name, const ThreadPriority priority)
+{
+    set_current_thread(name, priority, false);
+}
+
+} // namespace gouda
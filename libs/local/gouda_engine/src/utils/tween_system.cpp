@@ -0,0 +1,189 @@
+/**
+ * @file utils/tween_system.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine batched tweens implementation
+ */
+#include "utils/tween_system.hpp"
+
+#include "debug/profiler.hpp"
+
+namespace gouda {
+
+namespace {
+
+// One tight loop per easing type, the easing is a template argument so it inlines into the loop rather than being
+// picked per tween
+template <typename Ease>
+void evaluate_group(const size_t count, f32 *elapsed, const f32 *inverse_duration, const f32 *from, const f32 *to,
+                    f32 *value, const f32 delta_time, const Ease ease)
+{
+    for (size_t i = 0; i < count; ++i) {
+        elapsed[i] += delta_time;
+        const f32 t{ease(math::min(elapsed[i] * inverse_duration[i], 1.0f))};
+        value[i] = from[i] * (1.0f - t) + to[i] * t;
+    }
+}
+
+} // namespace
+
+TweenSystem::TweenSystem() : m_free_head{constants::u32_max}, m_active_count{0} {}
+
+TweenHandle TweenSystem::Add(const f32 from, const f32 to, const f32 duration, const math::easing::EasingType easing,
+                             f32 *target)
+{
+    u32 slot_index{m_free_head};
+    if (slot_index != constants::u32_max) {
+        m_free_head = m_slots[slot_index].dense_index;
+    }
+    else {
+        slot_index = static_cast<u32>(m_slots.size());
+        m_slots.push_back({0, 0, NO_GROUP});
+    }
+
+    const u8 group_index{static_cast<u8>(easing)};
+    TweenGroup &group{m_groups[group_index]};
+    Slot &slot{m_slots[slot_index]};
+    slot.dense_index = static_cast<u32>(group.elapsed.size());
+    slot.group = group_index;
+
+    group.elapsed.push_back(0.0f);
+    group.inverse_duration.push_back(duration > 0.0f ? 1.0f / duration : constants::f32_max);
+    group.from.push_back(from);
+    group.to.push_back(to);
+    group.value.push_back(from);
+    group.targets.push_back(target);
+    group.slots.push_back(slot_index);
+    ++m_active_count;
+
+    if (target != nullptr) {
+        *target = from;
+    }
+    return {slot_index, slot.generation};
+}
+
+bool TweenSystem::Remove(const TweenHandle handle)
+{
+    if (!IsActive(handle)) {
+        return false;
+    }
+
+    const Slot &slot{m_slots[handle.index]};
+    RemoveAt(slot.group, slot.dense_index);
+    return true;
+}
+
+void TweenSystem::Update(const f32 delta_time)
+{
+    if (m_active_count == 0) {
+        return;
+    }
+    ENGINE_PROFILE_SCOPE("Tweens");
+
+    using math::easing::EasingType;
+    for (size_t group_index = 0; group_index < m_groups.size(); ++group_index) {
+        TweenGroup &group{m_groups[group_index]};
+        const size_t count{group.elapsed.size()};
+        if (count == 0) {
+            continue;
+        }
+
+        f32 *elapsed{group.elapsed.data()};
+        const f32 *inverse_duration{group.inverse_duration.data()};
+        const f32 *from{group.from.data()};
+        const f32 *to{group.to.data()};
+        f32 *value{group.value.data()};
+        switch (static_cast<EasingType>(group_index)) {
+            case EasingType::Linear:
+                evaluate_group(count, elapsed, inverse_duration, from, to, value, delta_time,
+                               [](const f32 t) { return math::easing::Linear(t); });
+                break;
+            case EasingType::EaseInQuad:
+                evaluate_group(count, elapsed, inverse_duration, from, to, value, delta_time,
+                               [](const f32 t) { return math::easing::EaseInQuad(t); });
+                break;
+            case EasingType::EaseOutQuad:
+                evaluate_group(count, elapsed, inverse_duration, from, to, value, delta_time,
+                               [](const f32 t) { return math::easing::EaseOutQuad(t); });
+                break;
+            case EasingType::EaseInOutQuad:
+                evaluate_group(count, elapsed, inverse_duration, from, to, value, delta_time,
+                               [](const f32 t) { return math::easing::EaseInOutQuad(t); });
+                break;
+            case EasingType::SmoothStep:
+                evaluate_group(count, elapsed, inverse_duration, from, to, value, delta_time,
+                               [](const f32 t) { return math::easing::SmoothStep(t); });
+                break;
+            case EasingType::EaseInOutCubic:
+                evaluate_group(count, elapsed, inverse_duration, from, to, value, delta_time,
+                               [](const f32 t) { return math::easing::EaseInOutCubic(t); });
+                break;
+            case EasingType::EaseOutElastic:
+                evaluate_group(count, elapsed, inverse_duration, from, to, value, delta_time,
+                               [](const f32 t) { return math::easing::EaseOutElastic(t); });
+                break;
+            case EasingType::EaseOutBounce:
+                evaluate_group(count, elapsed, inverse_duration, from, to, value, delta_time,
+                               [](const f32 t) { return math::easing::EaseOutBounce(t); });
+                break;
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            if (f32 *target{group.targets[i]}) {
+                *target = value[i];
+            }
+        }
+
+        // Backwards, a removal swaps in the last tween, which has been checked already
+        for (size_t i = count; i > 0; --i) {
+            if (elapsed[i - 1] * inverse_duration[i - 1] >= 1.0f) {
+                RemoveAt(static_cast<u8>(group_index), static_cast<u32>(i - 1));
+            }
+        }
+    }
+}
+
+void TweenSystem::Clear()
+{
+    for (size_t group_index = 0; group_index < m_groups.size(); ++group_index) {
+        for (size_t i = m_groups[group_index].elapsed.size(); i > 0; --i) {
+            RemoveAt(static_cast<u8>(group_index), static_cast<u32>(i - 1));
+        }
+    }
+}
+
+std::optional<f32> TweenSystem::GetValue(const TweenHandle handle) const
+{
+    if (!IsActive(handle)) {
+        return std::nullopt;
+    }
+
+    const Slot &slot{m_slots[handle.index]};
+    return m_groups[slot.group].value[slot.dense_index];
+}
+
+// Private functions -------------------------------------------------------------------------------------
+void TweenSystem::RemoveAt(const u8 group_index, const u32 dense_index)
+{
+    TweenGroup &group{m_groups[group_index]};
+    const u32 slot_index{group.slots[dense_index]};
+    const u32 moved_slot{group.slots.back()};
+
+    group.elapsed.swap_remove(group.elapsed.begin() + dense_index);
+    group.inverse_duration.swap_remove(group.inverse_duration.begin() + dense_index);
+    group.from.swap_remove(group.from.begin() + dense_index);
+    group.to.swap_remove(group.to.begin() + dense_index);
+    group.value.swap_remove(group.value.begin() + dense_index);
+    group.targets.swap_remove(group.targets.begin() + dense_index);
+    group.slots.swap_remove(group.slots.begin() + dense_index);
+    m_slots[moved_slot].dense_index = dense_index;
+
+    Slot &slot{m_slots[slot_index]};
+    ++slot.generation;
+    slot.group = NO_GROUP;
+    slot.dense_index = m_free_head;
+    m_free_head = slot_index;
+    --m_active_count;
+}
+
+} // namespace gouda
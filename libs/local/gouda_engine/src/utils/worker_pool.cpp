@@ -0,0 +1,109 @@
+/**
+ * @file utils/worker_pool.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Engine worker thread pool implementation
+ */
+#include "utils/worker_pool.hpp"
+
+#include <format>
+#include <utility>
+
+#include "math/math.hpp"
+
+namespace gouda {
+
+WorkerPool::WorkerPool(const u32 thread_count, const StringView name, const ThreadPriority priority)
+    : p_task{nullptr}, m_task_count{0}, m_generation{0}, m_active_workers{0}, m_next_task{0}
+{
+    const u32 worker_count{math::max(thread_count, 1u) - 1};
+    m_threads.reserve(worker_count);
+    for (u32 i = 0; i < worker_count; ++i) {
+        m_threads.push_back(MakeThread(std::format("{} {}", name, i + 1), priority,
+                                       [this](const std::stop_token &stop_token) { WorkerLoop(stop_token); }));
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    for (auto &thread : m_threads) {
+        thread.request_stop();
+    }
+    m_start_condition.notify_all();
+    m_threads.clear();
+}
+
+void WorkerPool::Run(const u32 task_count, const Task &task)
+{
+    if (task_count == 0) {
+        return;
+    }
+
+    if (m_threads.empty() || task_count == 1) {
+        // Exceptions propagate straight to the caller here
+        for (u32 i = 0; i < task_count; ++i) {
+            task(i);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard lock{m_mutex};
+        p_task = &task;
+        m_task_count = task_count;
+        m_next_task.store(0, std::memory_order_relaxed);
+        m_active_workers = static_cast<u32>(m_threads.size());
+        ++m_generation;
+    }
+    m_start_condition.notify_all();
+
+    RunTasks();
+
+    // The batch state stays alive until every worker left RunTasks, not just until the last task finished
+    std::unique_lock lock{m_mutex};
+    m_done_condition.wait(lock, [this] { return m_active_workers == 0; });
+    p_task = nullptr;
+
+    if (m_exception) {
+        std::rethrow_exception(std::exchange(m_exception, nullptr));
+    }
+}
+
+void WorkerPool::WorkerLoop(const std::stop_token &stop_token)
+{
+    u64 seen_generation{0};
+    while (true) {
+        {
+            std::unique_lock lock{m_mutex};
+            if (!m_start_condition.wait(lock, stop_token, [&] { return m_generation != seen_generation; })) {
+                return;
+            }
+            seen_generation = m_generation;
+        }
+
+        RunTasks();
+
+        std::lock_guard lock{m_mutex};
+        if (--m_active_workers == 0) {
+            m_done_condition.notify_one();
+        }
+    }
+}
+
+void WorkerPool::RunTasks()
+{
+    for (u32 index{m_next_task.fetch_add(1, std::memory_order_relaxed)}; index < m_task_count;
+         index = m_next_task.fetch_add(1, std::memory_order_relaxed)) {
+        try {
+            (*p_task)(index);
+        }
+        catch (...) {
+            std::lock_guard lock{m_mutex};
+            if (!m_exception) {
+                m_exception = std::current_exception();
+            }
+        }
+    }
+}
+
+} // namespace gouda
@@ -6,46 +6,86 @@
  */
 #include "application.hpp"
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <format>
+#include <thread>
 #include <utility>
 
 #include "backends/event_types.hpp"
 #include "backends/glfw/glfw_backend.hpp"
+#include "backends/input_recording.hpp"
+#include "debug/debug_draw.hpp"
 #include "debug/logger.hpp"
+#include "debug/profiler.hpp"
 #include "math/vector.hpp"
+#include "memory/memory_tracker.hpp"
+#include "utils/startup_graph.hpp"
+#include "utils/thread.hpp"
 #include "utils/timer.hpp"
 
 #include "core/constants.hpp"
 #include "core/state_stack.hpp"
 #include "states/intro_state.hpp"
 
-Application::Application()
-    : p_window{nullptr},
+Application::Application(const LaunchOptions &options)
+    : m_launch_options{options},
+      p_job_system{std::make_unique<gouda::JobSystem>(std::max(std::thread::hardware_concurrency(), 2u) - 1)},
+      p_window{nullptr},
       p_input_handler{nullptr},
       m_settings_manager{"config/settings.json", true, true},
+      p_render_thread{nullptr},
+      m_frame_packet{},
+      m_is_packet_pending{false},
+      m_is_packet_submitted{false},
       p_context{nullptr},
       p_state_stack{nullptr},
       m_is_iconified{false},
+      m_is_focused{true},
+      m_redraw_requested{true},
+      m_last_render_time{},
       m_framebuffer_size{0, 0},
-      p_scene_camera{nullptr}
+      p_scene_camera{nullptr},
+      m_scene_camera_version{0},
+      m_ui_camera_version{0},
+      m_render_scale{1.0f},
+      m_sound_bank{p_job_system.get()},
+      m_asset_registry{&m_renderer, &m_sound_bank}
 {
     APP_LOG_INFO("Initializing");
 
     const ApplicationSettings settings{m_settings_manager.GetSettings()};
+    gouda::SetThreadSettings(settings.thread_settings); // The job system's workers are already running
     SetupTimerSettings(settings);
-    SetupWindow(settings);
-    SetupRenderer();
 
-    m_framebuffer_size = m_renderer.GetFramebufferSize();
-
-    SetupInputSystem();
-    SetupCamera();
-    SetupAudio(settings);
-
-    LoadTextures();
-    LoadFonts();
-
-    CreateSharedContext();
-    LoadInitialState();
+    // GLFW and the renderer are main thread only, so their chain stays there while audio initializes and decodes on a
+    // worker. Texture decodes are already asynchronous and the renderer compiles its shaders on its own pool.
+    using TaskThread = gouda::StartupGraph::TaskThread;
+    gouda::StartupGraph startup;
+    const auto window{startup.AddTask("Window", [&] { SetupWindow(settings); }, {}, TaskThread::Main)};
+    const auto renderer{startup.AddTask(
+        "Renderer",
+        [&] {
+            SetupRenderer(settings);
+            m_framebuffer_size = m_renderer.GetFramebufferSize();
+        },
+        {window}, TaskThread::Main)};
+    const auto camera{startup.AddTask("Camera", [this] { SetupCamera(); }, {renderer})};
+    const auto input{startup.AddTask("Input", [this] { SetupInputSystem(); }, {window, camera}, TaskThread::Main)};
+    const auto audio{startup.AddTask("Audio", [&] { SetupAudio(settings); })};
+    const auto audio_assets{startup.AddTask("Audio assets", [this] { LoadAudio(); }, {audio}, TaskThread::Main)};
+    const auto textures{startup.AddTask("Textures", [this] { LoadTextures(); }, {renderer}, TaskThread::Main)};
+    const auto fonts{startup.AddTask("Fonts", [this] { LoadFonts(); }, {renderer}, TaskThread::Main)};
+    startup.AddTask(
+        "Initial state",
+        [this] {
+            CreateSharedContext();
+            SetupInputCapture(); // Before the first state, so a replay starts from the same one its recording did
+            LoadInitialState();
+        },
+        {input, audio_assets, textures, fonts}, TaskThread::Main);
+    startup.Run(*p_job_system);
 
     APP_LOG_DEBUG("Application initialization success");
 }
@@ -53,16 +93,68 @@ Application::Application()
 Application::~Application()
 {
     APP_LOG_INFO("Cleaning up application");
+    p_render_thread.reset(); // Run may have let an exception through with a packet still being drawn
     m_renderer.DeviceWait(); // Ensure GPU is idle before cleanup
+    p_state_stack.reset();   // States release their assets into the registry, which is destroyed before the stack
 }
 
 void Application::Update(const f32 delta_time)
 {
+    // A frame that moves an eased value is drawn, including the one that writes its end value
+    if (!m_tweens.IsEmpty()) {
+        m_tweens.Update(delta_time);
+        m_redraw_requested = true;
+    }
+
     p_scene_camera->Update(delta_time);
     p_ui_camera->Update(delta_time);
 
-    m_uniform_data.wvp = p_scene_camera->GetViewProjectionMatrix();
-    m_uniform_data.wvp_static = p_ui_camera->GetViewProjectionMatrix();
+    // Camera versions start at 1, so the first frame always fills the uniforms
+    if (p_scene_camera->GetVersion() != m_scene_camera_version) {
+        m_uniform_data.wvp = p_scene_camera->GetViewProjectionMatrix();
+        m_scene_camera_version = p_scene_camera->GetVersion();
+        m_redraw_requested = true;
+    }
+    if (p_ui_camera->GetVersion() != m_ui_camera_version) {
+        m_uniform_data.wvp_static = p_ui_camera->GetViewProjectionMatrix();
+        m_ui_camera_version = p_ui_camera->GetVersion();
+        m_redraw_requested = true;
+    }
+}
+
+bool Application::ShouldRenderFrame(const SteadyClock::time_point now, const bool is_replaying) const
+{
+    if (is_replaying) {
+        return true; // Every recorded frame is drawn, so replays of a recording measure the same frames
+    }
+
+    const f64 since_last_render{std::chrono::duration<f64>{now - m_last_render_time}.count()};
+    if (!m_is_focused && m_time_settings.background_fps > 0.0f &&
+        since_last_render < 1.0 / m_time_settings.background_fps) {
+        return false;
+    }
+    if (!m_time_settings.idle_frame_skipping) {
+        return true;
+    }
+
+    // The last presented image stays on screen, a frame is only drawn when it would show something else
+    return m_redraw_requested || p_input_handler->GetFrameEventCount() > 0 || p_input_handler->IsAnyInputHeld() ||
+           p_state_stack->IsAnimating() || m_renderer.GetTextureManager()->GetPendingLoadCount() > 0 ||
+           since_last_render >= app_constants::idle_redraw_interval;
+}
+
+void Application::WaitForRedraw(const SteadyClock::time_point now) const
+{
+    // Until the next frame that could be drawn without any input, a window event ends the wait early
+    f64 frame_interval{m_time_settings.idle_frame_skipping ? app_constants::idle_redraw_interval : 0.0};
+    if (!m_is_focused && m_time_settings.background_fps > 0.0f) {
+        frame_interval = std::max(frame_interval, 1.0 / m_time_settings.background_fps);
+    }
+
+    const f64 since_last_render{std::chrono::duration<f64>{now - m_last_render_time}.count()};
+    if (since_last_render < frame_interval) {
+        gouda::glfw::wait_events(frame_interval - since_last_render);
+    }
 }
 
 void Application::Run()
@@ -72,17 +164,28 @@ void Application::Run()
     f32 delta_time{0.0f};
 
     gouda::utils::FrameTimer frame_timer;
-    gouda::utils::FixedTimer physics_timer(m_time_settings.fixed_timestep);
+    // Updates that would run the frame past its interval wait for the next one, so a long frame cannot make the
+    // following ones longer with the updates it left to catch up
+    gouda::utils::FixedTimer physics_timer(m_time_settings.fixed_timestep, m_time_settings.max_updates_per_frame);
+    physics_timer.SetMaxDebt(m_time_settings.max_accumulator);
+    physics_timer.SetStepBudget(1.0f / m_time_settings.target_fps);
     gouda::utils::GameClock game_clock;
 
-    // Only use FPS limiter if V-Sync is disabled
-    std::optional<gouda::utils::FrameRateLimiter> fps_limiter;
-    if (m_time_settings.vsync_mode == gouda::vk::VSyncMode::Disabled) {
-        fps_limiter.emplace(m_time_settings.target_fps);
-    }
+    gouda::utils::FramePacer frame_pacer;
+    SetupFramePacing(frame_pacer);
 
     m_audio_manager.PlayMusic(true);
 
+    // The packet built after a frame's simulation is drawn while the next frame simulates. The renderer is only called
+    // from this thread while the render thread is idle, input, events and state changes included, so the overlap is
+    // the fixed updates and the per frame update, which leave the renderer alone.
+    if (m_time_settings.pipelined_rendering) {
+        m_frame_packet.draw_list.quad_instances.reserve(app_constants::max_quads + app_constants::max_glyphs);
+        m_frame_packet.draw_list.particle_instances.reserve(app_constants::max_particles);
+        p_render_thread = std::make_unique<RenderThread>(m_renderer);
+        APP_LOG_INFO("Pipelined rendering: frames are drawn on the render thread");
+    }
+
     while (!p_window->ShouldClose()) {
 
         if (m_is_iconified) {
@@ -93,42 +196,221 @@ void Application::Run()
             continue; // Skip rendering while minimized
         }
 
-        p_input_handler->Update();
+        // Out of date without a resize, or the resize has not arrived yet. Recreating it here covers the first case,
+        // the window's events the second, without spinning through frames that cannot be drawn.
+        if (!m_renderer.IsSwapchainValid()) {
+            constexpr f64 wait_duration{0.005};
+            gouda::glfw::wait_events(wait_duration);
+            p_input_handler->Update();
+            if (!m_renderer.IsSwapchainValid() && m_framebuffer_size.area() != 0) {
+                OnFramebufferResize(p_window->GetWindow(), m_framebuffer_size);
+            }
+            continue;
+        }
+
+        ENGINE_PROFILE_FRAME(); // Closes the previous frame's capture
+        gouda::MemoryTracker::Get().BeginFrame();
+
+        {
+            ENGINE_PROFILE_SCOPE("Frame pacing");
+            frame_pacer.WaitForFrameStart(); // Right before input is sampled, so the frame starts from the latest
+        }
+
+        p_input_handler->PollEvents(); // Applied below, in step with the fixed updates
+        const SteadyClock::time_point input_time{SteadyClock::now()};
         m_audio_manager.Update();
+        m_sound_bank.Update(); // Uploads sounds decoded in the background
+        m_asset_registry.Update();
+        p_job_system->RunMainThreadJobs(); // Window and GLFW work handed over by jobs
 
         frame_timer.Update();
-        delta_time = frame_timer.GetDeltaTime();
-        delta_time = game_clock.ApplyTimeScale(delta_time); // Apply time scaling
 
-        p_state_stack->HandleInput(); // Handle state input
+        // A replay advances by the recorded times rather than the measured ones, so every frame sees the same input,
+        // delta and ticks it did when recorded. Only the measured times reach the frame statistics.
+        const gouda::RecordedFrame *replay_frame{p_input_handler->GetReplayFrame()};
+        const f32 frame_time{replay_frame ? replay_frame->delta_time : frame_timer.GetDeltaTime()};
+        delta_time = game_clock.ApplyTimeScale(frame_time); // Apply time scaling
+
+        // Pipelined, input bindings may call into the renderer, so the frame's events are all applied before the
+        // render thread starts on the last frame's packet, as a replay applies them
+        const bool is_pipelined{p_render_thread != nullptr};
+        if (is_pipelined) {
+            p_input_handler->DispatchEvents();
+            p_state_stack->HandleInput();
+            if (m_is_packet_pending) {
+                p_render_thread->Submit(m_frame_packet);
+                m_is_packet_pending = false;
+                m_is_packet_submitted = true;
+            }
+        }
 
         // Update physics at a fixed timestep
-        physics_timer.UpdateAccumulator(delta_time);
-        while (physics_timer.ShouldUpdate()) {
-            p_state_stack->Update(physics_timer.GetFixedTimeStep());
-            physics_timer.Advance();
+        u32 tick_count{0};
+        if (replay_frame) {
+            if (!is_pipelined) {
+                p_input_handler->DispatchEvents(); // Recorded by frame, so a replay applies them all up front
+            }
+            for (; tick_count < replay_frame->tick_count; ++tick_count) {
+                p_state_stack->Update(physics_timer.GetFixedTimeStep());
+            }
+        }
+        else {
+            physics_timer.UpdateAccumulator(delta_time);
+            while (physics_timer.ShouldUpdate()) {
+                // A step simulates up to the time the accumulator left after it lags the input by, the events that
+                // arrived by then are applied first
+                if (!is_pipelined) {
+                    const f32 time_scale{game_clock.GetTimeScale()};
+                    const f32 lag{(physics_timer.GetAccumulator() - physics_timer.GetFixedTimeStep()) /
+                                  (time_scale > 0.0f ? time_scale : 1.0f)};
+                    p_input_handler->DispatchEvents(
+                        input_time -
+                        std::chrono::duration_cast<SteadyClock::duration>(std::chrono::duration<f32>(lag)));
+                }
+
+                p_state_stack->Update(physics_timer.GetFixedTimeStep());
+                physics_timer.Advance();
+                ++tick_count;
+            }
+        }
+
+        if (is_pipelined) {
+            Update(delta_time);
+
+            // The renderer is this thread's again from here
+            if (m_is_packet_submitted) {
+                ENGINE_PROFILE_SCOPE("Wait for render thread");
+                p_render_thread->Wait();
+                m_is_packet_submitted = false;
+                EndRenderedFrame(frame_timer.GetDeltaTime(), frame_pacer);
+            }
         }
+        else {
+            p_input_handler->DispatchEvents(); // Whatever arrived after the last step
+            p_state_stack->HandleInput();      // Handle state input
+        }
+
+        // Gameplay events of this frame's updates and input, handled before the frame is drawn
+        m_redraw_requested |= m_event_bus.GetPendingCount() > 0;
+        m_event_bus.Dispatch();
+
+        // Drawn part way from the last fixed update to the next, so motion stays smooth at any update rate. A replay
+        // does not run the accumulator and draws the latest update as is.
+        p_context->interpolation_factor = replay_frame ? 1.0f : physics_timer.GetInterpolationFactor();
 
-        Update(delta_time);
-        p_state_stack->Render(delta_time);
+        if (!is_pipelined) {
+            Update(delta_time);
+        }
+
+        // A skipped frame still updates, only drawing and presenting it are left out
+        const bool render_frame{ShouldRenderFrame(SteadyClock::now(), replay_frame != nullptr)};
+        if (render_frame) {
+            if (is_pipelined) {
+                BuildFramePacket(delta_time);
+            }
+            else {
+                p_state_stack->Render(delta_time, m_renderer, m_uniform_data);
+                EndRenderedFrame(frame_timer.GetDeltaTime(), frame_pacer);
+            }
+            m_last_render_time = SteadyClock::now();
+            m_redraw_requested = false;
+        }
 
+        m_redraw_requested |= p_state_stack->HasPendingChanges();
+        if (is_pipelined && p_state_stack->HasPendingChanges()) {
+            m_is_packet_pending = false; // May draw what the leaving states release, the next frame redraws
+        }
         p_state_stack->ApplyPendingChanges(); // Apply any changes to the state stack
 
-        // Apply FPS limiter only if V-Sync is off
-        if (fps_limiter) {
-            fps_limiter->Limit(delta_time);
+        p_input_handler->EndFrame(frame_time, tick_count);
+        if (p_input_handler->IsReplayFinished()) {
+            FinishReplay();
+        }
+
+        // The pacer only waits on presented frames, without this an idle screen would spin
+        if (!render_frame) {
+            WaitForRedraw(SteadyClock::now());
         }
     }
 
+    // A packet built on the last iteration is never drawn, the window is closing
+    p_render_thread.reset();
+
+    if (p_input_handler->GetMode() == gouda::InputMode::Recording) {
+        p_input_handler->StopRecording().Save(m_launch_options.record_filepath);
+    }
+
     m_renderer.DeviceWait();
 }
 
 // Private ---------------------------------------------------------------------------------------------
+void Application::BuildFramePacket(const f32 delta_time)
+{
+    ENGINE_PROFILE_SCOPE("Build frame packet");
+
+    // While the render thread is idle, the states and the debug UI both call into the renderer
+    p_state_stack->BuildDrawList(delta_time, m_frame_packet.draw_list);
+    m_renderer.BuildDebugUI();
+    m_frame_packet.uniform_data = m_uniform_data;
+    m_frame_packet.delta_time = delta_time;
+    m_is_packet_pending = true;
+}
+
+void Application::EndRenderedFrame(const f32 frame_time, gouda::utils::FramePacer &frame_pacer)
+{
+    const gouda::vk::RenderStatistics render_statistics{m_renderer.GetRenderStatistics()};
+    m_frame_statistics.AddFrame({frame_time * 1000.0f, render_statistics.gpu_timings.frame_time,
+                                 render_statistics.present_latency, render_statistics.fence_wait_time});
+
+    // The CPU time leaves out the waits on the GPU, the swapchain and the pacer, which are the frame's slack
+    const f32 cpu_time{frame_time * 1000.0f - render_statistics.fence_wait_time - render_statistics.present_latency -
+                       frame_pacer.GetLastWaitTime().count()};
+    if (m_quality_governor.AddFrame(std::max(cpu_time, 0.0f), render_statistics.gpu_timings.frame_time)) {
+        ApplyQualitySettings(m_quality_governor.GetSettings());
+    }
+
+    frame_pacer.EndFrame(render_statistics.gpu_timings.frame_time);
+}
+
+void Application::ApplyQualitySettings(const gouda::utils::QualitySettings &quality)
+{
+    // Under a dynamic scale this is the most it may scale up to
+    m_renderer.SetRenderScale(m_render_scale * quality.render_scale);
+    m_renderer.SetParticleSpawnLimit(static_cast<u32>(
+        static_cast<f32>(gouda::vk::Renderer::MAX_PARTICLE_SPAWNS_PER_FRAME) * quality.particle_spawn_scale));
+    m_renderer.SetLightLimit(
+        std::max(static_cast<u32>(static_cast<f32>(gouda::vk::Renderer::MAX_LIGHTS) * quality.light_scale), 1u));
+}
+
 void Application::SetupTimerSettings(const ApplicationSettings &settings)
 {
     m_time_settings.target_fps = settings.refresh_rate;
-    m_time_settings.fixed_timestep = 1.0f / static_cast<f32>(settings.refresh_rate);
+    m_time_settings.fixed_timestep = 1.0f / static_cast<f32>(settings.update_rate);
     m_time_settings.vsync_mode = settings.vsync ? gouda::vk::VSyncMode::Enabled : gouda::vk::VSyncMode::Disabled;
+    m_time_settings.idle_frame_skipping = settings.idle_frame_skipping;
+    m_time_settings.background_fps = static_cast<f32>(settings.background_frame_rate);
+    m_time_settings.pipelined_rendering = settings.pipelined_rendering;
+}
+
+void Application::SetupFramePacing(gouda::utils::FramePacer &frame_pacer)
+{
+    // Without V-Sync the target rate caps the frames. With FIFO V-Sync the swapchain caps them, but the CPU can run
+    // frames ahead into it, so where present wait is available frames are also held back until the last one is shown.
+    if (m_time_settings.vsync_mode == gouda::vk::VSyncMode::Disabled) {
+        frame_pacer.SetTargetFrameRate(m_time_settings.target_fps);
+    }
+    else if (m_time_settings.vsync_mode == gouda::vk::VSyncMode::Enabled && m_renderer.SupportsPresentWait()) {
+        constexpr u64 present_wait_timeout{100'000'000}; // Nanoseconds, presents stall while the window is hidden
+        frame_pacer.SetPresentWait([this] { return m_renderer.WaitForLastPresent(present_wait_timeout); },
+                                   m_time_settings.target_fps);
+    }
+
+    // Input arriving while the pacer waits is pumped every slice, so it keeps the time it arrived at
+    frame_pacer.SetIdleCallback([this] { p_input_handler->PumpEvents(); });
+
+    APP_LOG_INFO("Frame pacing: {}", frame_pacer.GetMode() == gouda::utils::PacingMode::PresentWait ? "present wait"
+                                     : frame_pacer.GetMode() == gouda::utils::PacingMode::FrameRate ? "frame rate"
+                                                                                                      : "uncapped");
 }
 
 void Application::SetupWindow(const ApplicationSettings &settings)
@@ -148,39 +430,52 @@ void Application::SetupWindow(const ApplicationSettings &settings)
     p_window->SetIcon(filepath::application_icon);
 }
 
-void Application::SetupRenderer()
+void Application::SetupRenderer(const ApplicationSettings &settings)
 {
     // Initialize Vulkan
-    m_renderer.Initialize(p_window->GetWindow(), "Gouda renderer", SemVer{1, 4, 0, 0}, m_time_settings.vsync_mode);
-
-    m_renderer.CreateUniformBuffers(sizeof(gouda::UniformData));
-
-    m_renderer.SetupPipelines(filepath::quad_vertex_shader, filepath::quad_frag_shader, filepath::text_vertex_shader,
-                              filepath::text_frag_shader, filepath::particle_vertex_shader,
-                              filepath::particle_frag_shader, filepath::particle_compute_shader);
+    m_renderer.Initialize(p_window->GetWindow(), "Gouda renderer", SemVer{1, 4, 0, 0}, m_time_settings.vsync_mode,
+                          gouda::vk::Renderer::DEFAULT_FRAMES_IN_FLIGHT,
+                          gouda::vk::Renderer::DEFAULT_PIPELINE_CACHE_PATH, settings.gpu);
+
+    m_renderer.SetupPipelines(filepath::quad_vertex_shader, filepath::quad_frag_shader,
+                              filepath::particle_vertex_shader, filepath::particle_frag_shader,
+                              filepath::particle_compute_shader, filepath::particle_emit_shader,
+                              filepath::quad_cull_shader, filepath::light_cull_shader,
+                              filepath::upscale_vertex_shader, filepath::upscale_frag_shader,
+                              filepath::radix_histogram_shader, filepath::radix_scan_shader,
+                              filepath::radix_scatter_shader, filepath::particle_gather_shader);
+
+    // A dynamic scale aims for the GPU to finish each frame within one refresh
+    m_render_scale = settings.render_scale;
+    m_renderer.SetRenderScale(m_render_scale);
+    if (settings.dynamic_render_scale) {
+        m_renderer.SetDynamicRenderScale(1000.0f / static_cast<f32>(settings.refresh_rate));
+    }
+    if (settings.quality_governor) {
+        m_quality_governor.SetFrameBudget(1000.0f / static_cast<f32>(settings.refresh_rate));
+        APP_LOG_INFO("Quality governor: {:.2f} ms frame budget", 1000.0f / static_cast<f32>(settings.refresh_rate));
+    }
 }
 
 void Application::SetupAudio(const ApplicationSettings &settings)
 {
     m_audio_manager.Initialize(settings.audio_settings.sound_volume, settings.audio_settings.music_volume);
+}
 
+void Application::LoadAudio()
+{
     // TODO: Consider storing these filepaths as constant strings for easier change and locating
-    m_laser_1.Load("assets/audio/sound_effects/laser1.wav");
-    m_laser_2.Load("assets/audio/sound_effects/laser2.wav");
-
-    m_music2.Load("assets/audio/music_tracks/moonlight.wav");
-    m_music.Load("assets/audio/music_tracks/track.mp3");
-    m_music3.Load("assets/audio/music_tracks/blondie.mp3");
-    m_music4.Load("assets/audio/music_tracks/half.mp3");
-    m_music5.Load("assets/audio/music_tracks/the.mp3");
-    m_music6.Load("assets/audio/music_tracks/robin.mp3");
-
-    m_audio_manager.QueueMusic(m_music3);
-    m_audio_manager.QueueMusic(m_music2);
-    m_audio_manager.QueueMusic(m_music);
-    m_audio_manager.QueueMusic(m_music4);
-    m_audio_manager.QueueMusic(m_music5);
-    m_audio_manager.QueueMusic(m_music6);
+    m_laser_1 = m_asset_registry.LoadSound("assets/audio/sound_effects/laser1.wav");
+    m_laser_2 = m_asset_registry.LoadSound("assets/audio/sound_effects/laser2.wav");
+
+    // In the order they play
+    constexpr std::array<StringView, 6> music_filepaths{
+        "assets/audio/music_tracks/blondie.mp3", "assets/audio/music_tracks/moonlight.wav",
+        "assets/audio/music_tracks/track.mp3",   "assets/audio/music_tracks/half.mp3",
+        "assets/audio/music_tracks/the.mp3",     "assets/audio/music_tracks/robin.mp3"};
+    for (const StringView filepath : music_filepaths) {
+        m_audio_manager.QueueMusic(m_asset_registry.GetMusic(m_asset_registry.LoadMusic(filepath)));
+    }
 }
 
 void Application::SetupCamera()
@@ -210,36 +505,56 @@ void Application::SetCameraProjections(const gouda::Vec2 &framebuffer_size) cons
                                framebuffer_size.y, 0.0f);
 }
 
-void Application::LoadTextures() const
+void Application::LoadTextures()
 {
+    // The application holds these for its lifetime, states refer to them by texture id
     // TODO: Consider storing these filepaths as constant strings for easier change and locating
-    u32 checkerboard_id = m_renderer.LoadSingleTexture("assets/textures/checkerboard.png");
-    u32 checkerboard_2_id = m_renderer.LoadSingleTexture("assets/textures/checkerboard2.png");
-    u32 checkerboard_3_id = m_renderer.LoadSingleTexture("assets/textures/checkerboard3.png");
-    u32 checkerboard_4_id = m_renderer.LoadSingleTexture("assets/textures/checkerboard4.png");
-
-    APP_LOG_DEBUG("Loaded textures: {},{},{},{}", checkerboard_id, checkerboard_2_id, checkerboard_3_id,
-                  checkerboard_4_id);
+    constexpr std::array<StringView, 4> texture_filepaths{
+        "assets/textures/checkerboard.png", "assets/textures/checkerboard2.png", "assets/textures/checkerboard3.png",
+        "assets/textures/checkerboard4.png"};
+    for (const StringView filepath : texture_filepaths) {
+        const gouda::TextureHandle texture{m_asset_registry.LoadTexture(filepath)};
+        APP_LOG_DEBUG("Loaded texture {}: {}", m_asset_registry.GetTextureID(texture), filepath);
+    }
 
-    u32 atlas_id{m_renderer.LoadAtlasTexture(filepath::texture_atlas, filepath::texture_atlas_metadata)};
-    APP_LOG_DEBUG("Atlas ID: {}", atlas_id);
+    const gouda::AtlasHandle atlas{
+        m_asset_registry.LoadAtlas(filepath::texture_atlas, filepath::texture_atlas_metadata)};
+    APP_LOG_DEBUG("Atlas ID: {}", m_asset_registry.GetTextureID(atlas));
 }
 
 void Application::LoadFonts()
 {
-    m_renderer.LoadMSDFFont(filepath::primary_font_atlas, filepath::primary_font_metadata);
-    m_renderer.LoadMSDFFont(filepath::secondary_font_atlas, filepath::secondary_font_metadata);
+    const gouda::FontHandle primary_font{
+        m_asset_registry.LoadFont(filepath::primary_font_atlas, filepath::primary_font_metadata)};
+    const gouda::FontHandle secondary_font{
+        m_asset_registry.LoadFont(filepath::secondary_font_atlas, filepath::secondary_font_metadata)};
+
+    // Characters outside the baked charset, player names and pasted text, are rasterized from the TrueType files
+    m_renderer.SetFontGlyphSource(m_asset_registry.GetFontID(primary_font), filepath::primary_font_source);
+    m_renderer.SetFontGlyphSource(m_asset_registry.GetFontID(secondary_font), filepath::secondary_font_source);
+#ifdef ENGINE_DEBUG_DRAW
+    gouda::DebugDraw::Get().SetTextFont(m_asset_registry.GetFontID(primary_font));
+#endif
 }
 void Application::CreateSharedContext()
 {
     p_context = std::make_unique<SharedContext>();
+    p_context->job_system = p_job_system.get();
     p_context->renderer = &m_renderer;
     p_context->window = p_window.get();
     p_context->input_handler = p_input_handler.get();
     p_context->texture_manager = m_renderer.GetTextureManager();
+    p_context->audio_manager = &m_audio_manager;
+    p_context->sound_bank = &m_sound_bank;
+    p_context->asset_registry = &m_asset_registry;
+    p_context->event_bus = &m_event_bus;
+    p_context->tweens = &m_tweens;
     p_context->scene_camera = p_scene_camera.get();
     p_context->ui_camera = p_ui_camera.get();
     p_context->uniform_data = &m_uniform_data;
+    p_context->frame_statistics = &m_frame_statistics;
+    p_context->quality_governor = &m_quality_governor;
+    p_context->interpolation_factor = 1.0f;
 }
 
 void Application::LoadInitialState()
@@ -282,7 +597,8 @@ void Application::SetupInputSystem()
 
     // Window focus callback
     p_input_handler->SetWindowFocusCallback([this](const bool focused) {
-        m_is_iconified = !focused; // Align with your existing logic
+        m_is_focused = focused; // Unfocused windows keep drawing, throttled to the background frame rate
+        m_redraw_requested = true;
         // APP_LOG_DEBUG("Window {} focus", focused ? "gained" : "lost");
     });
 
@@ -303,6 +619,53 @@ void Application::SetupInputSystem()
         [this](const bool iconified) { OnWindowIconify(p_window->GetWindow(), iconified); });
 }
 
+void Application::SetupInputCapture()
+{
+    if (!m_launch_options.replay_filepath.empty()) {
+        std::optional<gouda::InputRecording> recording{gouda::InputRecording::Load(m_launch_options.replay_filepath)};
+        if (!recording) {
+            APP_LOG_ERROR("Running with live input, the recording '{}' could not be loaded.",
+                          m_launch_options.replay_filepath);
+            return;
+        }
+
+        if (recording->GetFixedTimestep() != m_time_settings.fixed_timestep) {
+            APP_LOG_WARNING("Recording '{}' was made at a fixed step of {}s, updates now run at {}s and may diverge.",
+                            m_launch_options.replay_filepath, recording->GetFixedTimestep(),
+                            m_time_settings.fixed_timestep);
+        }
+
+        p_input_handler->StartReplay(std::move(*recording));
+
+        // The replay's frame times go to their own capture, for comparing runs of the same recording
+        const String stem{FilePath{m_launch_options.replay_filepath}.stem().string()};
+        const auto now{std::chrono::floor<std::chrono::seconds>(std::chrono::system_clock::now())};
+        m_frame_statistics.Clear();
+        m_frame_statistics.StartCsvCapture(
+            std::format("{}/replay_{}_{:%Y%m%d_%H%M%S}.csv", filepath::frame_statistics_directory, stem, now));
+        return;
+    }
+
+    if (!m_launch_options.record_filepath.empty()) {
+        p_input_handler->StartRecording(m_time_settings.fixed_timestep);
+    }
+}
+
+void Application::FinishReplay()
+{
+    m_frame_statistics.StopCsvCapture();
+    p_input_handler->StopRecording();
+
+    for (const gouda::FrameMetric metric : {gouda::FrameMetric::CpuFrameTime, gouda::FrameMetric::GpuFrameTime}) {
+        const gouda::FrameMetricSummary &summary{m_frame_statistics.GetSummary(metric)};
+        APP_LOG_INFO("Replay {} over the last {} frames: p50 {:.3f}ms, p95 {:.3f}ms, p99 {:.3f}ms, max {:.3f}ms",
+                     gouda::FrameStatistics::GetMetricName(metric), m_frame_statistics.GetSampleCount(), summary.p50,
+                     summary.p95, summary.p99, summary.max);
+    }
+
+    p_window->Close();
+}
+
 void Application::OnFramebufferResize([[maybe_unused]] GLFWwindow *window, FrameBufferSize new_size)
 {
     if (new_size.width == 0 || new_size.height == 0) {
@@ -312,16 +675,14 @@ void Application::OnFramebufferResize([[maybe_unused]] GLFWwindow *window, Frame
 
     APP_LOG_INFO("Framebuffer resized: {}x{}, swapchain is now invalid", new_size.width, new_size.height);
 
-    // Ensure no commands are running before destruction
-    m_renderer.DeviceWait();
-
-    // Cleanup and Recreate swapchain, swapchain image views, and depth resources.
+    // Recreate swapchain, swapchain image views, and depth resources, the old ones go once frames in flight finish
     m_renderer.ReCreateSwapchain();
 
     const gouda::Vec2 float_size{static_cast<f32>(new_size.width), static_cast<f32>(new_size.height)};
     SetCameraProjections(float_size);
 
     p_state_stack->OnFrameBufferResize(float_size); // Resize the current states
+    m_redraw_requested = true;
 
     APP_LOG_DEBUG("Swapchain and framebuffers recreated successfully. States updated.");
 }
@@ -338,4 +699,5 @@ void Application::OnWindowResize([[maybe_unused]] GLFWwindow *window, WindowSize
 void Application::OnWindowIconify([[maybe_unused]] GLFWwindow *window, const bool iconified)
 {
     m_is_iconified = iconified;
+    m_redraw_requested = true;
 }
\ No newline at end of file
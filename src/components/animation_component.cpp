@@ -6,78 +6,157 @@
  */
 #include "components/animation_component.hpp"
 
-#include <utility>
+#include <cmath>
 
 #include "debug/logger.hpp"
 
-Animation::Animation(StringView name_, gouda::Vector<UVRect<f32>> frames_,
-                     const gouda::Vector<f32> &frame_durations_, bool looping_)
-    : name{name_}, frames{std::move(frames_)}, frame_durations{frame_durations_}, looping{looping_}
+AnimationClipID AnimationLibrary::AddClip(StringView name, const std::span<const UVRect<f32>> frames,
+                                          const std::span<const f32> frame_durations, const bool looping)
 {
+    if (frames.empty() || frames.size() != frame_durations.size()) {
+        APP_LOG_WARNING("Animation clip '{}' has {} frames and {} durations.", name, frames.size(),
+                        frame_durations.size());
+        return INVALID_ANIMATION_CLIP;
+    }
+
+    f32 duration{0.0f};
+    for (const f32 frame_duration : frame_durations) {
+        if (frame_duration < 0.0f) {
+            APP_LOG_WARNING("Animation clip '{}' has a negative frame duration.", name);
+            return INVALID_ANIMATION_CLIP;
+        }
+        duration += frame_duration;
+    }
+    if (duration <= 0.0f) {
+        APP_LOG_WARNING("Animation clip '{}' has no duration.", name);
+        return INVALID_ANIMATION_CLIP;
+    }
+
+    // A replaced clip's old frames stay in the arrays until the library is cleared, clips are set up once per level
+    const AnimationClip clip{static_cast<u32>(m_frame_rects.size()), static_cast<u32>(frames.size()), duration,
+                             INVALID_ANIMATION_CLIP, looping};
+
+    f32 frame_end{0.0f};
+    for (size_t i = 0; i < frames.size(); ++i) {
+        frame_end += frame_durations[i];
+        m_frame_rects.push_back(frames[i]);
+        m_frame_ends.push_back(frame_end);
+    }
+
+    const gouda::StringId name_id{gouda::StringId::Register(name)};
+    if (const auto it{m_clip_ids.find(name_id)}; it != m_clip_ids.end()) {
+        const AnimationClipID next_clip{m_clips[it->second].next_clip};
+        m_clips[it->second] = clip;
+        m_clips[it->second].next_clip = next_clip;
+        ++m_version;
+        return it->second;
+    }
+
+    ++m_version;
+    const auto id{static_cast<AnimationClipID>(m_clips.size())};
+    m_clips.push_back(clip);
+    m_clip_names.emplace_back(name);
+    m_clip_ids.emplace(name_id, id);
+    return id;
 }
 
-void AnimationComponent::Update(const f32 delta_time, gouda::InstanceData &render_data) {
-    if (animations.empty() || !animations.contains(current_animation)) {
-        return;
+void AnimationLibrary::SetNextClip(const AnimationClipID clip, const AnimationClipID next)
+{
+    m_clips[clip].next_clip = next;
+    ++m_version;
+}
+
+AnimationClipID AnimationLibrary::FindClip(const gouda::StringId name) const
+{
+    const AnimationClipID *id{m_clip_ids.get(name)};
+    return id == nullptr ? INVALID_ANIMATION_CLIP : *id;
+}
+
+void AnimationLibrary::Clear()
+{
+    m_clips.clear();
+    m_clip_names.clear();
+    m_clip_ids.clear();
+    m_frame_rects.clear();
+    m_frame_ends.clear();
+    ++m_version;
+}
+
+void AnimationLibrary::WriteGpuTables(gouda::Vector<gouda::AnimationClipData> &clips,
+                                      gouda::Vector<gouda::AnimationFrameData> &frames) const
+{
+    clips.clear();
+    clips.reserve(m_clips.size());
+    for (const AnimationClip &clip : m_clips) {
+        clips.push_back({.first_frame = clip.first_frame,
+                         .frame_count = clip.frame_count,
+                         .duration = clip.duration,
+                         .next_clip = clip.next_clip,
+                         .looping = clip.looping ? 1u : 0u});
     }
 
-    auto &anim = animations.at(current_animation);
-    if (anim.frames.empty() || anim.frame_durations.empty()) {
-        return;
+    frames.clear();
+    frames.reserve(m_frame_rects.size());
+    for (size_t i = 0; i < m_frame_rects.size(); ++i) {
+        frames.push_back({.sprite_rect = m_frame_rects[i], .end = m_frame_ends[i]});
     }
+}
 
-    // Advance animation time
-    animation_time += delta_time;
+void AnimationComponent::Play(const AnimationClipID next_clip)
+{
+    if (next_clip == clip) {
+        return;
+    }
+    clip = next_clip;
+    time = 0.0f;
+    frame = 0;
+    on_gpu = false;
+}
 
-    // Calculate total duration of one loop
-    f32 total_duration = 0.0f;
-    for (const auto duration : anim.frame_durations) {
-        total_duration += duration;
+void AnimationComponent::Update(const f32 delta_time, const AnimationLibrary &library, UVRect<f32> &sprite_rect,
+                                const bool is_atlas)
+{
+    if (clip >= library.GetClipCount()) {
+        return;
     }
 
-    // Handle looping or clamp to last frame
-    if (animation_time >= total_duration) {
-        if (anim.looping) {
-            animation_time = std::fmod(animation_time, total_duration);
-        } else {
-            animation_time = total_duration;
-            current_frame = static_cast<int>(anim.frames.size()) - 1;
-            if (animations.contains("idle")) {
-                current_animation = "idle";
-                animation_time = 0.0f;
-                current_frame = 0;
-            }
-            if (render_data.is_atlas) {
-                render_data.sprite_rect = anim.frames[current_frame];
-            } else {
-                render_data.sprite_rect = UVRect{0.0f, 0.0f, 1.0f, 1.0f}; // Full texture for non-atlas
-            }
-            return;
-        }
+    const AnimationClip *current{&library.GetClip(clip)};
+    if (frame >= current->frame_count) {
+        frame = 0; // The clip was replaced with fewer frames
     }
 
-    // Find current frame based on accumulated time
-    f32 accumulated_time{0.0f};
-    current_frame = 0;
-    for (size_t i = 0; i < anim.frame_durations.size() && i < anim.frames.size(); ++i) {
-        accumulated_time += anim.frame_durations[i];
-        if (animation_time < accumulated_time) {
-            current_frame = static_cast<int>(i);
-            break;
+    time += delta_time;
+    if (time >= current->duration) {
+        if (current->looping) {
+            time = std::fmod(time, current->duration);
+            frame = 0;
+        }
+        else if (current->next_clip != INVALID_ANIMATION_CLIP) {
+            clip = current->next_clip;
+            time = 0.0f;
+            frame = 0;
+            current = &library.GetClip(clip);
+        }
+        else {
+            time = current->duration;
         }
     }
 
-    // Ensure current_frame is valid
-    current_frame = gouda::math::min(current_frame, static_cast<int>(anim.frames.size()) - 1);
+    // Time only moves forward within a pass, so the frame is found by stepping on from the last one
+    while (frame + 1 < current->frame_count && time >= library.GetFrameEnd(current->first_frame + frame)) {
+        ++frame;
+    }
 
-    // Update render data with current frame's UV rect
-    if (render_data.is_atlas) {
-        render_data.sprite_rect = anim.frames[current_frame];
-    } else {
-        render_data.sprite_rect = UVRect{0.0f, 0.0f, 1.0f, 1.0f}; // Full texture for non-atlas
+    if (is_atlas) {
+        sprite_rect = library.GetFrameRect(current->first_frame + frame);
     }
+    else {
+        sprite_rect = UVRect{0.0f, 0.0f, 1.0f, 1.0f}; // Full texture for non-atlas
+    }
+}
 
-    APP_LOG_DEBUG("animation: {}, frame: {}, rect: {}:{}:{}:{}", current_animation, current_frame,
-                  render_data.sprite_rect.u_min, render_data.sprite_rect.v_min, render_data.sprite_rect.u_max,
-                  render_data.sprite_rect.v_max);
-}
\ No newline at end of file
+void AnimationComponent::Update(const f32 delta_time, const AnimationLibrary &library,
+                                gouda::InstanceData &render_data)
+{
+    Update(delta_time, library, render_data.sprite_rect, render_data.is_atlas != 0);
+}
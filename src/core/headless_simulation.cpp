@@ -0,0 +1,147 @@
+/**
+ * @file core/headless_simulation.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Application headless simulation module implementation
+ */
+#include "core/headless_simulation.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include "debug/logger.hpp"
+#include "debug/profiler.hpp"
+#include "math/math.hpp"
+
+#include "scenes/scene.hpp"
+
+// The camera stands where a window of this size would show the scene, the moving entities stay within the area
+constexpr f32 HEADLESS_VIEW_WIDTH{1920.0f};
+constexpr f32 HEADLESS_VIEW_HEIGHT{1080.0f};
+constexpr f32 HEADLESS_WORLD_EXTENT{4096.0f};
+constexpr f32 HEADLESS_ENTITY_SPEED{150.0f};
+constexpr f32 HEADLESS_PARTICLE_LIFETIME{2.0f};
+
+// Every run of the same options simulates the same thing, spread along the golden angle instead of at random
+static gouda::Vec2 GoldenAngleDirection(const size_t index)
+{
+    constexpr f32 golden_angle{2.39996323f};
+    const f32 angle{golden_angle * static_cast<f32>(index)};
+    return {std::cos(angle), std::sin(angle)};
+}
+
+static f32 TickPercentile(const gouda::Vector<f32> &sorted_times, const f32 percentile)
+{
+    const auto index{static_cast<size_t>(percentile * static_cast<f32>(sorted_times.size() - 1))};
+    return sorted_times[index];
+}
+
+HeadlessSimulation::HeadlessSimulation(const HeadlessOptions &options)
+    : m_options{options},
+      m_scene_camera{0.0f, HEADLESS_VIEW_WIDTH, HEADLESS_VIEW_HEIGHT, 0.0f, -1.0f, 1.0f, 1.0f, 0.0f, 0.0f},
+      m_ui_camera{0.0f, HEADLESS_VIEW_WIDTH, HEADLESS_VIEW_HEIGHT, 0.0f, -1.0f, 1.0f, 1.0f, 0.0f, 0.0f},
+      p_scene{nullptr}
+{
+    m_options.update_rate = std::max<u16>(m_options.update_rate, 1);
+}
+
+HeadlessSimulation::~HeadlessSimulation() = default;
+
+int HeadlessSimulation::Run()
+{
+    APP_LOG_INFO("Running headless: {} ticks at {} Hz, {} moving entities, {} particles per tick", m_options.tick_count,
+                 m_options.update_rate, m_options.entity_count, m_options.particles_per_tick);
+
+    p_scene = std::make_unique<Scene>(&m_scene_camera, &m_ui_camera, nullptr);
+    if (!m_options.level_filepath.empty() && !p_scene->LoadLevel(m_options.level_filepath)) {
+        APP_LOG_ERROR("Headless run cannot load level '{}'", m_options.level_filepath);
+        return 1;
+    }
+    AddMovingEntities();
+
+    const f32 fixed_timestep{1.0f / static_cast<f32>(m_options.update_rate)};
+    gouda::Vector<f32> tick_times; // Milliseconds
+    tick_times.reserve(m_options.tick_count);
+
+    const auto run_start{std::chrono::steady_clock::now()};
+    for (u32 tick = 0; tick < m_options.tick_count; ++tick) {
+        ENGINE_PROFILE_FRAME();
+        const auto tick_start{std::chrono::steady_clock::now()};
+
+        MoveEntities(fixed_timestep);
+        SpawnParticles(tick);
+        p_scene->Update(fixed_timestep);
+        p_scene->SpawnPendingParticles();
+
+        tick_times.push_back(
+            std::chrono::duration<f32, std::milli>(std::chrono::steady_clock::now() - tick_start).count());
+    }
+    const f64 run_time{std::chrono::duration<f64>(std::chrono::steady_clock::now() - run_start).count()};
+
+    if (tick_times.empty()) {
+        return 0;
+    }
+
+    std::ranges::sort(tick_times);
+    const CollisionStatistics &collisions{p_scene->GetCollisionStatistics()};
+    APP_LOG_INFO("Headless: {} ticks in {:.3f} s, {:.1f} ticks per second", tick_times.size(), run_time,
+                 static_cast<f64>(tick_times.size()) / run_time);
+    APP_LOG_INFO("Headless: tick ms p50 {:.3f} p95 {:.3f} p99 {:.3f} max {:.3f}", TickPercentile(tick_times, 0.5f),
+                 TickPercentile(tick_times, 0.95f), TickPercentile(tick_times, 0.99f), tick_times.back());
+    APP_LOG_INFO("Headless: {} bodies, {} broadphase pairs and {} contacts on the last tick, {} particles live",
+                 collisions.dynamic_body_count, collisions.broadphase_pair_count, collisions.contact_count,
+                 p_scene->GetParticleCount());
+    return 0;
+}
+
+void HeadlessSimulation::AddMovingEntities()
+{
+    m_moving_entities.reserve(m_options.entity_count);
+    m_velocities.reserve(m_options.entity_count);
+    for (u32 i = 0; i < m_options.entity_count; ++i) {
+        // Spread over a disc by the square root of the index, so they start evenly apart
+        const f32 radius{HEADLESS_WORLD_EXTENT * std::sqrt((static_cast<f32>(i) + 0.5f) /
+                                                           static_cast<f32>(m_options.entity_count))};
+        const gouda::Vec2 direction{GoldenAngleDirection(i)};
+        const gouda::InstanceData instance{{direction.x * radius, direction.y * radius, -0.5f}, {32.0f, 32.0f}, 0.0f,
+                                           0};
+        m_moving_entities.push_back(p_scene->AddEntity(Entity{instance, EntityType::Quad}));
+        m_velocities.push_back(GoldenAngleDirection(i + m_options.entity_count) * HEADLESS_ENTITY_SPEED);
+    }
+}
+
+void HeadlessSimulation::MoveEntities(const f32 delta_time)
+{
+    ENGINE_PROFILE_SCOPE("Move headless entities");
+
+    const EntityStore &entities{p_scene->GetEntities()};
+    for (size_t i = 0; i < m_moving_entities.size(); ++i) {
+        const size_t entity{m_moving_entities[i]};
+        gouda::Vec2 &velocity{m_velocities[i]};
+        gouda::Vec3 position{entities.GetPositions()[entity]};
+        position.x += velocity.x * delta_time;
+        position.y += velocity.y * delta_time;
+
+        // Bounced back off the edges of the area
+        if (std::abs(position.x) > HEADLESS_WORLD_EXTENT) {
+            velocity.x = -velocity.x;
+            position.x = std::clamp(position.x, -HEADLESS_WORLD_EXTENT, HEADLESS_WORLD_EXTENT);
+        }
+        if (std::abs(position.y) > HEADLESS_WORLD_EXTENT) {
+            velocity.y = -velocity.y;
+            position.y = std::clamp(position.y, -HEADLESS_WORLD_EXTENT, HEADLESS_WORLD_EXTENT);
+        }
+        p_scene->MoveEntity(entity, position);
+    }
+}
+
+void HeadlessSimulation::SpawnParticles(const u32 tick)
+{
+    const gouda::Vec3 origin{HEADLESS_VIEW_WIDTH * 0.5f, HEADLESS_VIEW_HEIGHT * 0.5f, -0.3f};
+    for (u32 i = 0; i < m_options.particles_per_tick; ++i) {
+        const gouda::Vec2 direction{GoldenAngleDirection(static_cast<size_t>(tick) * m_options.particles_per_tick + i)};
+        p_scene->SpawnParticle(origin, {4.0f, 4.0f}, {direction.x * 100.0f, direction.y * 100.0f, 0.0f},
+                               HEADLESS_PARTICLE_LIFETIME);
+    }
+}
@@ -0,0 +1,78 @@
+/**
+ * @file core/render_thread.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Application render thread module implementation
+ */
+#include "core/render_thread.hpp"
+
+#include <utility>
+
+#include "debug/profiler.hpp"
+#include "utils/thread.hpp"
+
+RenderThread::RenderThread(gouda::vk::Renderer &renderer)
+    : m_renderer{renderer},
+      p_packet{nullptr},
+      m_exception{nullptr},
+      m_thread{gouda::MakeThread("Render", gouda::ThreadPriority::Render,
+                                 [this](const std::stop_token &stop_token) { Run(stop_token); })}
+{
+}
+
+RenderThread::~RenderThread()
+{
+    {
+        std::unique_lock lock{m_mutex};
+        m_condition.wait(lock, [this] { return p_packet == nullptr; });
+    }
+    m_thread.request_stop();
+}
+
+void RenderThread::Submit(const FramePacket &packet)
+{
+    {
+        std::lock_guard lock{m_mutex};
+        p_packet = &packet;
+    }
+    m_condition.notify_all();
+}
+
+void RenderThread::Wait()
+{
+    std::unique_lock lock{m_mutex};
+    m_condition.wait(lock, [this] { return p_packet == nullptr; });
+    if (m_exception) {
+        std::rethrow_exception(std::exchange(m_exception, nullptr));
+    }
+}
+
+void RenderThread::Run(const std::stop_token &stop_token)
+{
+    while (true) {
+        const FramePacket *packet{nullptr};
+        {
+            std::unique_lock lock{m_mutex};
+            if (!m_condition.wait(lock, stop_token, [this] { return p_packet != nullptr; })) {
+                return; // Stopped with nothing submitted
+            }
+            packet = p_packet;
+        }
+
+        try {
+            ENGINE_PROFILE_SCOPE("Render packet");
+            m_renderer.Render(packet->delta_time, packet->uniform_data, packet->draw_list.quad_instances,
+                              packet->draw_list.particle_instances);
+        }
+        catch (...) {
+            std::lock_guard lock{m_mutex};
+            m_exception = std::current_exception();
+        }
+
+        {
+            std::lock_guard lock{m_mutex};
+            p_packet = nullptr;
+        }
+        m_condition.notify_all();
+    }
+}
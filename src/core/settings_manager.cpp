@@ -6,10 +6,62 @@
  */
 #include "core/settings_manager.hpp"
 
+#include <algorithm>
+#include <array>
+#include <fstream>
 #include <utility>
 
 #include "debug/logger.hpp"
 
+namespace {
+
+// Keys of ThreadSettings::affinity_masks, in ThreadPriority order
+constexpr std::array<const char *, gouda::THREAD_PRIORITY_COUNT> THREAD_CLASS_NAMES{"render", "audio", "jobs", "io",
+                                                                                    "logging"};
+
+// Writes beside the file and renames over it, so the file always holds a complete write
+bool write_settings_file(const FilePath &filepath, const ApplicationSettings &settings)
+{
+    String contents;
+    try {
+        const nlohmann::json json_data = settings; // Should be a JSON object
+        contents = json_data.dump(4);              // Pretty print with indentation
+    }
+    catch (const std::exception &e) {
+        APP_LOG_ERROR("Failed to save settings file '{}'. Reason: {}.", filepath.string(), e.what());
+        return false;
+    }
+
+    FilePath temporary_filepath{filepath};
+    temporary_filepath += ".tmp";
+    {
+        std::ofstream file{temporary_filepath, std::ios::binary | std::ios::trunc};
+        if (!file.is_open()) {
+            APP_LOG_ERROR("Could not open settings file '{}' for saving.", temporary_filepath.string());
+            return false;
+        }
+        file.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+        file.close();
+        if (file.fail()) {
+            APP_LOG_ERROR("Failed to write settings file '{}'.", temporary_filepath.string());
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(temporary_filepath, filepath, ec);
+    if (ec) {
+        APP_LOG_ERROR("Failed to replace settings file '{}'. Error: {}", filepath.string(), ec.message());
+        std::filesystem::remove(temporary_filepath, ec);
+        return false;
+    }
+
+    APP_LOG_INFO("Settings saved to '{}'", filepath.string());
+    return true;
+}
+
+} // namespace
+
 // Definition of to_json and from_json for WindowSize
 void to_json(nlohmann::json &json_data, const WindowSize &window_size)
 {
@@ -38,9 +90,24 @@ void to_json(nlohmann::json &json_data, const ApplicationSettings &settings)
 {
     json_data = nlohmann::json{{"size", settings.size},
                                {"refresh_rate", settings.refresh_rate},
+                               {"update_rate", settings.update_rate},
                                {"fullscreen", settings.fullscreen},
                                {"vsync", settings.vsync},
+                               {"gpu", settings.gpu},
+                               {"render_scale", settings.render_scale},
+                               {"dynamic_render_scale", settings.dynamic_render_scale},
+                               {"quality_governor", settings.quality_governor},
+                               {"idle_frame_skipping", settings.idle_frame_skipping},
+                               {"background_frame_rate", settings.background_frame_rate},
+                               {"pipelined_rendering", settings.pipelined_rendering},
                                {"audio", settings.audio_settings}};
+
+    nlohmann::json affinity_masks;
+    for (size_t i = 0; i < THREAD_CLASS_NAMES.size(); ++i) {
+        affinity_masks[THREAD_CLASS_NAMES[i]] = settings.thread_settings.affinity_masks[i];
+    }
+    json_data["threads"] = nlohmann::json{{"reserve_main_core", settings.thread_settings.reserve_main_core},
+                                          {"affinity_masks", affinity_masks}};
 }
 
 void from_json(const nlohmann::json &json_data, ApplicationSettings &settings)
@@ -53,7 +120,18 @@ void from_json(const nlohmann::json &json_data, ApplicationSettings &settings)
 
     settings.fullscreen = json_data.value("fullscreen", false);
     settings.vsync = json_data.value("vsync", false);
+    settings.gpu = json_data.value("gpu", String{});
     settings.refresh_rate = json_data.value("refresh_rate", 60);
+    settings.update_rate = json_data.value("update_rate", 60);
+    if (settings.update_rate == 0) {
+        settings.update_rate = 60; // The fixed timestep is its inverse
+    }
+    settings.render_scale = json_data.value("render_scale", 1.0f);
+    settings.dynamic_render_scale = json_data.value("dynamic_render_scale", false);
+    settings.quality_governor = json_data.value("quality_governor", false);
+    settings.idle_frame_skipping = json_data.value("idle_frame_skipping", true);
+    settings.background_frame_rate = json_data.value("background_frame_rate", 15);
+    settings.pipelined_rendering = json_data.value("pipelined_rendering", false);
 
     // Handle the nested WindowSize structure manually
     if (json_data.contains("audio") && json_data["audio"].is_object()) {
@@ -61,10 +139,29 @@ void from_json(const nlohmann::json &json_data, ApplicationSettings &settings)
             json_data["audio"].value("sound_volume", 0.5f); // Default value if missing
         settings.audio_settings.music_volume = json_data["audio"].value("music_volume", 0.5f);
     }
+
+    // Masks are bits per core, 0 lets a class run anywhere
+    if (json_data.contains("threads") && json_data["threads"].is_object()) {
+        const nlohmann::json &threads{json_data["threads"]};
+        settings.thread_settings.reserve_main_core = threads.value("reserve_main_core", true);
+        if (threads.contains("affinity_masks") && threads["affinity_masks"].is_object()) {
+            for (size_t i = 0; i < THREAD_CLASS_NAMES.size(); ++i) {
+                settings.thread_settings.affinity_masks[i] =
+                    threads["affinity_masks"].value(THREAD_CLASS_NAMES[i], u64{0});
+            }
+        }
+    }
 }
 
 SettingsManager::SettingsManager(FilePath filepath, const bool auto_save, const bool auto_load)
-    : m_filepath{std::move(filepath)}, m_auto_save{auto_save}, m_is_valid{false}
+    : m_filepath{std::move(filepath)},
+      m_auto_save{auto_save},
+      m_is_valid{false},
+      m_pending_settings{},
+      m_first_change_time{},
+      m_last_change_time{},
+      m_thread{gouda::MakeThread("Settings", gouda::ThreadPriority::IO,
+                                 [this](const std::stop_token &stop_token) { Run(stop_token); })}
 {
     if (auto_load) {
         Load();
@@ -73,6 +170,9 @@ SettingsManager::SettingsManager(FilePath filepath, const bool auto_save, const
 
 SettingsManager::~SettingsManager()
 {
+    m_thread.request_stop();
+    m_thread.join();
+
     if (m_auto_save) {
         Save(); // Save settings on destruction
     }
@@ -129,24 +229,14 @@ void SettingsManager::Load()
     APP_LOG_DEBUG("Settings loaded from '{}'.", m_filepath.string());
 }
 
-void SettingsManager::Save() const
+void SettingsManager::Save()
 {
-    std::ofstream file(m_filepath);
-    if (!file.is_open()) {
-        APP_LOG_ERROR("Could not open settings file '{}' for saving.", m_filepath.string());
-        return;
+    std::lock_guard write_lock{m_write_mutex};
+    {
+        std::lock_guard lock{m_mutex};
+        m_pending_settings.reset();
     }
-
-    try {
-        const nlohmann::json json_data = m_settings; // Should be a JSON object
-        file << json_data.dump(4);             // Pretty print with indentation
-    }
-    catch (const std::exception &e) {
-        APP_LOG_ERROR("Failed to save settings file '{}'. Reason: {}.", m_filepath.string(), e.what());
-        return;
-    }
-
-    APP_LOG_INFO("Settings saved to '{}", m_filepath.string());
+    write_settings_file(m_filepath, m_settings);
 }
 
 ApplicationSettings SettingsManager::GetSettings() const { return m_settings; }
@@ -160,9 +250,7 @@ void SettingsManager::SetSettings(const ApplicationSettings &new_settings)
     }
 
     m_settings = new_settings;
-    if (m_auto_save) {
-        Save();
-    }
+    ScheduleSave();
 }
 
 void SettingsManager::SetWindowSize(WindowSize new_size)
@@ -173,25 +261,19 @@ void SettingsManager::SetWindowSize(WindowSize new_size)
     }
 
     m_settings.size = new_size;
-    if (m_auto_save) {
-        Save();
-        ENGINE_LOG_DEBUG("Saved new window size {}x{}", new_size.width, new_size.height);
-    }
+    ScheduleSave();
 }
 
 void SettingsManager::SetFullScreen(const bool enabled)
 {
     m_settings.fullscreen = enabled;
-    if (m_auto_save) {
-        Save();
-    }
+    ScheduleSave();
 }
+
 void SettingsManager::SetVsync(const bool enabled)
 {
     m_settings.vsync = enabled;
-    if (m_auto_save) {
-        Save();
-    }
+    ScheduleSave();
 }
 
 void SettingsManager::SetRefreshRate(const u16 rate)
@@ -202,7 +284,105 @@ void SettingsManager::SetRefreshRate(const u16 rate)
     }
 
     m_settings.refresh_rate = rate;
-    if (m_auto_save) {
-        Save();
+    ScheduleSave();
+}
+
+void SettingsManager::SetUpdateRate(const u16 rate)
+{
+    if (rate == 0) {
+        APP_LOG_ERROR("New update rate cannot be zero.");
+        return;
+    }
+
+    m_settings.update_rate = rate;
+    ScheduleSave();
+}
+
+void SettingsManager::SetRenderScale(const f32 scale)
+{
+    if (scale <= 0.0f || scale > 1.0f) {
+        APP_LOG_ERROR("New render scale must be in (0, 1].");
+        return;
+    }
+
+    m_settings.render_scale = scale;
+    ScheduleSave();
+}
+
+void SettingsManager::SetDynamicRenderScale(const bool enabled)
+{
+    m_settings.dynamic_render_scale = enabled;
+    ScheduleSave();
+}
+
+void SettingsManager::SetQualityGovernor(const bool enabled)
+{
+    m_settings.quality_governor = enabled;
+    ScheduleSave();
+}
+
+void SettingsManager::SetIdleFrameSkipping(const bool enabled)
+{
+    m_settings.idle_frame_skipping = enabled;
+    ScheduleSave();
+}
+
+void SettingsManager::SetBackgroundFrameRate(const u16 rate)
+{
+    m_settings.background_frame_rate = rate;
+    ScheduleSave();
+}
+
+void SettingsManager::ScheduleSave()
+{
+    if (!m_auto_save) {
+        return;
+    }
+
+    const Clock::time_point now{Clock::now()};
+    {
+        std::lock_guard lock{m_mutex};
+        if (!m_pending_settings) {
+            m_first_change_time = now;
+        }
+        m_pending_settings = m_settings;
+        m_last_change_time = now;
+    }
+    m_condition.notify_all();
+}
+
+void SettingsManager::Run(const std::stop_token &stop_token)
+{
+    while (true) {
+        {
+            std::unique_lock lock{m_mutex};
+            if (!m_condition.wait(lock, stop_token, [this] { return m_pending_settings.has_value(); })) {
+                return;
+            }
+
+            // Every change pushes the write back, up to the maximum delay from the first one
+            while (m_pending_settings) {
+                const Clock::time_point deadline{
+                    std::min(m_last_change_time + SAVE_DEBOUNCE, m_first_change_time + SAVE_MAX_DELAY)};
+                if (Clock::now() >= deadline) {
+                    break;
+                }
+                m_condition.wait_until(lock, stop_token, deadline, [] { return false; });
+                if (stop_token.stop_requested()) {
+                    return; // The destructor writes what is pending
+                }
+            }
+        }
+
+        // A Save on the main thread in between took the snapshot and wrote it already
+        std::lock_guard write_lock{m_write_mutex};
+        std::optional<ApplicationSettings> settings;
+        {
+            std::lock_guard lock{m_mutex};
+            settings.swap(m_pending_settings);
+        }
+        if (settings) {
+            write_settings_file(m_filepath, *settings);
+        }
     }
 }
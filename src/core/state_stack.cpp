@@ -8,8 +8,15 @@
 
 #include <ranges>
 
+#include "core/constants.hpp"
 #include "states/state.hpp"
 
+StateStack::StateStack()
+{
+    m_draw_list.quad_instances.reserve(app_constants::max_quads + app_constants::max_glyphs);
+    m_draw_list.particle_instances.reserve(app_constants::max_particles);
+}
+
 StateStack::~StateStack()
 {
     if (!m_states.empty()) {
@@ -42,6 +49,24 @@ void StateStack::Replace(std::unique_ptr<State> state)  {
     m_pending_changes.push_back({Action::Replace, std::move(state)});
 }
 
+void StateStack::Preload(std::unique_ptr<State> state)
+{
+    if (!state) {
+        throw std::invalid_argument("Cannot preload null state");
+    }
+
+    state->PreloadAssets();
+    p_preloaded_state = std::move(state);
+}
+
+std::unique_ptr<State> StateStack::TakePreloaded(const State::StateID id)
+{
+    if (!p_preloaded_state || p_preloaded_state->GetID() != id) {
+        return nullptr;
+    }
+    return std::move(p_preloaded_state);
+}
+
 void StateStack::HandleInput() {
     for (const auto & m_state : std::ranges::reverse_view(m_states)) {
         m_state->HandleInput();
@@ -91,23 +116,54 @@ void StateStack::ApplyPendingChanges() {
     m_pending_changes.clear();
 }
 
-void StateStack::Render(const f32 delta_time) const
+void StateStack::Render(const f32 delta_time, gouda::vk::Renderer &renderer, const gouda::UniformData &uniform_data)
 {
-    for (const auto &m_state : m_states) {
-        m_state->Render(delta_time);
-        if (m_state->IsOpaque()) {
-            break;
-        }
+    BuildDrawList(delta_time, m_draw_list);
+    renderer.Render(delta_time, uniform_data, m_draw_list.quad_instances, m_draw_list.particle_instances);
+}
+
+void StateStack::BuildDrawList(const f32 delta_time, FrameDrawList &draw_list)
+{
+    // Everything under the topmost opaque state is hidden, the rest draws bottom first so overlays end up on top
+    draw_list.Clear();
+    for (size_t i = GetFirstVisibleState(); i < m_states.size(); ++i) {
+        m_states[i]->Render(delta_time, draw_list);
     }
 }
+
 void StateStack::OnFrameBufferResize(const gouda::Vec2 &new_framebuffer_size)
 {
     for (const auto &m_state : std::ranges::reverse_view(m_states)) {
         m_state->OnFrameBufferResize(new_framebuffer_size);
     }
+    if (p_preloaded_state) {
+        p_preloaded_state->OnFrameBufferResize(new_framebuffer_size);
+    }
 }
 
 State::StateID StateStack::GetTopStateID() const {
     return m_states.empty() ? "" : m_states.back()->GetID();
 }
 
+bool StateStack::IsAnimating() const
+{
+    for (size_t i = GetFirstVisibleState(); i < m_states.size(); ++i) {
+        if (m_states[i]->IsAnimating()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Private ---------------------------------------------------------------------------------------------
+size_t StateStack::GetFirstVisibleState() const
+{
+    size_t first_visible{m_states.size()};
+    while (first_visible > 0) {
+        --first_visible;
+        if (m_states[first_visible]->IsOpaque()) {
+            break;
+        }
+    }
+    return first_visible;
+}
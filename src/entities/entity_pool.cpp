@@ -0,0 +1,55 @@
+/**
+ * @file entity_pool.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Application pooled entity module implementation
+ */
+#include "entities/entity_pool.hpp"
+
+#include <algorithm>
+
+EntityPool::EntityPool(const Entity &prototype, const u32 first, const u32 capacity)
+    : m_prototype{prototype}, m_first{first}, m_capacity{capacity}
+{
+    // Reversed so the first slot is taken first and a fresh pool fills in store order
+    m_free.reserve(capacity);
+    for (u32 i = capacity; i > 0; --i) {
+        m_free.push_back(first + i - 1);
+    }
+    m_active.assign(capacity, 0);
+}
+
+std::optional<u32> EntityPool::Acquire()
+{
+    if (m_free.empty()) {
+        return std::nullopt;
+    }
+
+    const u32 index{m_free.back()};
+    m_free.pop_back();
+    m_active[index - m_first] = 1;
+    return index;
+}
+
+bool EntityPool::Release(const size_t index)
+{
+    if (!IsActive(index)) {
+        return false;
+    }
+
+    m_active[index - m_first] = 0;
+    m_free.push_back(static_cast<u32>(index));
+    return true;
+}
+
+bool EntityPool::IsConsistent() const
+{
+    if (m_active.size() != m_capacity || m_free.size() > m_capacity) {
+        return false;
+    }
+
+    const auto inactive_count{static_cast<size_t>(std::ranges::count(m_active, u8{0}))};
+    return inactive_count == m_free.size() && std::ranges::all_of(m_free, [this](const u32 index) {
+               return Owns(index) && m_active[index - m_first] == 0;
+           });
+}
@@ -0,0 +1,218 @@
+/**
+ * @file entity_store.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Application entity storage module implementation
+ */
+#include "entities/entity_store.hpp"
+
+#include <algorithm>
+#include <utility>
+
+static gouda::math::AABB2D MakeBounds(const gouda::Vec3 &position, const gouda::Vec2 &size)
+{
+    return {{position.x, position.y}, {position.x + size.x, position.y + size.y}};
+}
+
+static EntityAppearance MakeAppearance(const gouda::InstanceData &render_data)
+{
+    return {render_data.rotation, render_data.texture_index, render_data.colour, render_data.sprite_rect,
+            render_data.is_atlas, render_data.apply_camera_effects, render_data.blend_mode};
+}
+
+// Inside out, so every overlap test against it fails, while staying finite for the code that takes its extent
+static const gouda::math::AABB2D PARKED_BOUNDS{{constants::f32_max, constants::f32_max},
+                                               {-constants::f32_max, -constants::f32_max}};
+
+size_t EntityStore::Add(const Entity &entity)
+{
+    const gouda::InstanceData &render_data{entity.render_data};
+
+    m_positions.push_back(render_data.position);
+    m_previous_positions.push_back(render_data.position);
+    m_sizes.push_back(render_data.size);
+    m_bounds.push_back(MakeBounds(render_data.position, render_data.size));
+
+    m_types.push_back(entity.type);
+    m_appearances.push_back(MakeAppearance(render_data));
+
+    m_animations.Add(entity.animation_component);
+    m_health.Add(entity.health_component);
+
+    return m_positions.size() - 1;
+}
+
+size_t EntityStore::AddParked(const Entity &prototype, const size_t count)
+{
+    const size_t first{Size()};
+    Reserve(first + count);
+    for (size_t i = 0; i < count; ++i) {
+        Park(Add(prototype));
+    }
+    return first;
+}
+
+void EntityStore::Respawn(const size_t index, const Entity &prototype, const gouda::Vec3 &position)
+{
+    const gouda::InstanceData &render_data{prototype.render_data};
+
+    m_positions[index] = position;
+    m_previous_positions[index] = position;
+    m_sizes[index] = render_data.size;
+    m_bounds[index] = MakeBounds(position, render_data.size);
+
+    m_types[index] = prototype.type;
+    m_appearances[index] = MakeAppearance(render_data);
+
+    m_animations.Reset(index, prototype.animation_component);
+    m_health.Reset(index, prototype.health_component);
+}
+
+void EntityStore::Park(const size_t index) { m_bounds[index] = PARKED_BOUNDS; }
+
+bool EntityStore::AssignColumns(gouda::Vector<gouda::Vec3> positions, gouda::Vector<gouda::Vec2> sizes,
+                                gouda::Vector<gouda::math::AABB2D> bounds, gouda::Vector<EntityType> types,
+                                gouda::Vector<EntityAppearance> appearances)
+{
+    Clear();
+
+    const size_t count{positions.size()};
+    if (sizes.size() != count || bounds.size() != count || types.size() != count || appearances.size() != count) {
+        return false;
+    }
+
+    m_positions = std::move(positions);
+    m_previous_positions = m_positions;
+    m_sizes = std::move(sizes);
+    m_bounds = std::move(bounds);
+    m_types = std::move(types);
+    m_appearances = std::move(appearances);
+    m_animations.slots.assign(count, SparseComponents<AnimationComponent>::NO_COMPONENT);
+    m_health.slots.assign(count, SparseComponents<HealthComponent>::NO_COMPONENT);
+    return true;
+}
+
+bool EntityStore::IsConsistent() const
+{
+    const size_t count{m_positions.size()};
+    if (m_sizes.size() != count || m_bounds.size() != count || m_previous_positions.size() != count ||
+        m_types.size() != count || m_appearances.size() != count || m_animations.slots.size() != count ||
+        m_health.slots.size() != count) {
+        return false;
+    }
+
+    const auto is_slot_valid{[](const u32 slot, const size_t value_count) {
+        return slot == SparseComponents<AnimationComponent>::NO_COMPONENT || slot < value_count;
+    }};
+    return std::ranges::all_of(m_moved_entities, [count](const u32 index) { return index < count; }) &&
+           std::ranges::all_of(m_animations.slots,
+                               [&](const u32 slot) { return is_slot_valid(slot, m_animations.values.size()); }) &&
+           std::ranges::all_of(m_health.slots,
+                               [&](const u32 slot) { return is_slot_valid(slot, m_health.values.size()); });
+}
+
+void EntityStore::Reserve(const size_t count)
+{
+    m_positions.reserve(count);
+    m_previous_positions.reserve(count);
+    m_sizes.reserve(count);
+    m_bounds.reserve(count);
+    m_types.reserve(count);
+    m_appearances.reserve(count);
+    m_animations.slots.reserve(count);
+    m_health.slots.reserve(count);
+}
+
+void EntityStore::Clear()
+{
+    m_positions.clear();
+    m_previous_positions.clear();
+    m_moved_entities.clear();
+    m_sizes.clear();
+    m_bounds.clear();
+    m_types.clear();
+    m_appearances.clear();
+    m_animations.Clear();
+    m_health.Clear();
+}
+
+void EntityStore::SetPosition(const size_t index, const gouda::Vec3 &position)
+{
+    m_positions[index] = position;
+    m_bounds[index] = MakeBounds(position, m_sizes[index]);
+    m_moved_entities.push_back(static_cast<u32>(index));
+}
+
+void EntityStore::SetSize(const size_t index, const gouda::Vec2 &size)
+{
+    m_sizes[index] = size;
+    m_bounds[index] = MakeBounds(m_positions[index], size);
+}
+
+void EntityStore::BeginStep()
+{
+    for (const u32 index : m_moved_entities) {
+        m_previous_positions[index] = m_positions[index];
+    }
+    m_moved_entities.clear();
+}
+
+gouda::Vec3 EntityStore::GetInterpolatedPosition(const size_t index, const f32 interpolation_factor) const
+{
+    const gouda::Vec3 &previous{m_previous_positions[index]};
+    return previous + (m_positions[index] - previous) * interpolation_factor;
+}
+
+void EntityStore::UpdateAnimations(const f32 delta_time, const f32 time, const AnimationLibrary &library)
+{
+    for (size_t i = 0; i < m_animations.slots.size(); ++i) {
+        if (m_animations.slots[i] == SparseComponents<AnimationComponent>::NO_COMPONENT) {
+            continue;
+        }
+        AnimationComponent &animation{m_animations.values[m_animations.slots[i]]};
+        EntityAppearance &appearance{m_appearances[i]};
+        if (animation.on_gpu) {
+            continue;
+        }
+
+        // Picked up where the CPU would have taken it this step, the vertex shader only needs the start
+        if (appearance.is_atlas != 0 && animation.clip < library.GetClipCount() &&
+            library.GetClip(animation.clip).looping) {
+            animation.start_time = time - (animation.time + delta_time);
+            animation.on_gpu = true;
+            continue;
+        }
+        animation.Update(delta_time, library, appearance.sprite_rect, appearance.is_atlas != 0);
+    }
+}
+
+gouda::InstanceData EntityStore::BuildInstance(const size_t index) const
+{
+    const EntityAppearance &appearance{m_appearances[index]};
+    gouda::InstanceData instance{m_positions[index],
+                                 m_sizes[index],
+                                 appearance.rotation,
+                                 appearance.texture_index,
+                                 appearance.colour,
+                                 appearance.sprite_rect,
+                                 appearance.is_atlas,
+                                 appearance.apply_camera_effects,
+                                 appearance.blend_mode};
+    if (const AnimationComponent *animation{m_animations.Get(index)}; animation != nullptr && animation->on_gpu) {
+        instance.animation_clip = animation->clip;
+        instance.animation_start_time = animation->start_time;
+    }
+    return instance;
+}
+
+Entity EntityStore::BuildEntity(const size_t index) const
+{
+    Entity entity{BuildInstance(index), m_types[index]};
+    if (const AnimationComponent *animation{m_animations.Get(index)}) {
+        entity.animation_component = *animation;
+    }
+    if (const HealthComponent *health{m_health.Get(index)}) {
+        entity.health_component = *health;
+    }
+    return entity;
+}
@@ -8,7 +8,10 @@
 #include "entities/player.hpp"
 
 Player::Player(const gouda::InstanceData &instance_data, const gouda::Vec2 velocity_, const f32 speed_)
-    : Entity{instance_data, EntityType::Player}, velocity{velocity_}, speed{speed_}
+    : Entity{instance_data, EntityType::Player},
+      velocity{velocity_},
+      speed{speed_},
+      previous_position{instance_data.position}
 {
 }
 
@@ -1,7 +1,90 @@
 #include "application.hpp"
 
-int main()
+#include <charconv>
+
+#include "core/constants.hpp"
+#include "debug/logger.hpp"
+#include "memory/memory_tracker.hpp"
+#include "utils/asset_archive.hpp"
+#include "utils/defer.hpp"
+#include "utils/thread.hpp"
+
+// Counts that do not parse leave the default
+static u32 parse_count(const StringView text, const u32 fallback)
 {
-    Application app;
-    app.Run();
+    u32 value{fallback};
+    if (const auto [end, error]{std::from_chars(text.data(), text.data() + text.size(), value)};
+        error != std::errc{} || end != text.data() + text.size()) {
+        APP_LOG_WARNING("Ignoring '{}', expected a count", text);
+        return fallback;
+    }
+    return value;
+}
+
+// --record file.ginp records the session's input, --replay file.ginp plays it back and exits when it ends.
+// --headless ticks simulates that many ticks without a window and exits, with --entities, --particles per tick and
+// --level file.glvl setting what it simulates.
+static LaunchOptions parse_launch_options(const int argc, char **argv)
+{
+    LaunchOptions options;
+    for (int i = 1; i < argc; ++i) {
+        const StringView argument{argv[i]};
+        if ((argument == "--record" || argument == "--replay") && i + 1 < argc) {
+            (argument == "--record" ? options.record_filepath : options.replay_filepath) = argv[++i];
+        }
+        else if (argument == "--headless" && i + 1 < argc) {
+            options.headless.tick_count = parse_count(argv[++i], 0);
+        }
+        else if (argument == "--entities" && i + 1 < argc) {
+            options.headless.entity_count = parse_count(argv[++i], options.headless.entity_count);
+        }
+        else if (argument == "--particles" && i + 1 < argc) {
+            options.headless.particles_per_tick = parse_count(argv[++i], options.headless.particles_per_tick);
+        }
+        else if (argument == "--level" && i + 1 < argc) {
+            options.headless.level_filepath = argv[++i];
+        }
+        else {
+            APP_LOG_WARNING("Ignoring unknown command line argument '{}'", argument);
+        }
+    }
+    return options;
+}
+
+int main(const int argc, char **argv)
+{
+    gouda::SetMainThread();
+
+    // Lines are formatted and written by background threads, keeping logging off the frame time
+    gouda::EngineLogger::GetInstance().SetAsync(true);
+    gouda::AppLogger::GetInstance().SetAsync(true);
+
+    // The loggers are never destroyed, so what is still queued has to be written before exiting
+    const gouda::utils::Defer stop_async_logging{[] {
+        gouda::AppLogger::GetInstance().SetAsync(false);
+        gouda::EngineLogger::GetInstance().SetAsync(false);
+    }};
+
+    // Packed builds read every asset from one mapping, the loose files remain the fallback
+    if (std::filesystem::exists(filepath::asset_archive)) {
+        if (const auto result{gouda::fs::MountArchive(filepath::asset_archive)}; !result) {
+            APP_LOG_WARNING("Cannot mount '{}', loading loose assets: {}", filepath::asset_archive,
+                            gouda::fs::error_to_string(result.error()));
+        }
+    }
+    const gouda::utils::Defer unmount_archives{[] { gouda::fs::UnmountArchives(); }};
+
+    const LaunchOptions options{parse_launch_options(argc, argv)};
+    int exit_code{0};
+    if (options.headless.tick_count > 0) {
+        exit_code = HeadlessSimulation{options.headless}.Run();
+    }
+    else {
+        Application app{options};
+        app.Run();
+    }
+
+    // Whatever is still live once the application is gone was leaked or belongs to a global
+    gouda::MemoryTracker::Get().LogSummary();
+    return exit_code;
 }
@@ -0,0 +1,211 @@
+/**
+ * @file level_file.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Application binary level file module implementation
+ */
+#include "scenes/level_file.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#include "debug/logger.hpp"
+#include "utils/filesystem.hpp"
+#include "utils/mapped_file.hpp"
+
+constexpr std::array<char, 4> LEVEL_FILE_MAGIC{'G', 'L', 'V', 'L'};
+constexpr u64 LEVEL_SECTION_ALIGNMENT{16};
+
+enum class LevelSection : u32 {
+    Positions = 0,
+    Sizes,
+    Bounds,
+    Types,
+    Appearances,
+    TreeNodes,
+    TreeEntityOrder,
+    TreeEntityBounds,
+    TexturePaths, // Null terminated paths back to back
+    Count
+};
+
+struct LevelFileHeader {
+    std::array<char, 4> magic;
+    u32 version;
+    u32 section_count;
+    u32 reserved;
+};
+
+struct LevelSectionEntry {
+    u32 type;
+    u32 element_size; // Guards against a type changing size without a version bump
+    u64 count;
+    u64 offset; // From the start of the file
+};
+
+using TreeNode = gouda::math::BoundingVolumeHierarchy::Node;
+
+// Sections are copied as raw bytes in both directions
+static_assert(std::is_trivially_copyable_v<gouda::Vec3> && std::is_trivially_copyable_v<gouda::Vec2>);
+static_assert(std::is_trivially_copyable_v<gouda::math::AABB2D> && std::is_trivially_copyable_v<EntityType>);
+static_assert(std::is_trivially_copyable_v<EntityAppearance> && std::is_trivially_copyable_v<TreeNode>);
+
+static u64 AlignSectionOffset(const u64 offset)
+{
+    return (offset + LEVEL_SECTION_ALIGNMENT - 1) & ~(LEVEL_SECTION_ALIGNMENT - 1);
+}
+
+template <typename T>
+static void AppendSection(std::vector<std::byte> &bytes, LevelSectionEntry &entry, const LevelSection type,
+                          const std::span<const T> values)
+{
+    const u64 offset{AlignSectionOffset(bytes.size())};
+    entry = LevelSectionEntry{static_cast<u32>(type), static_cast<u32>(sizeof(T)), values.size(), offset};
+
+    bytes.resize(offset + values.size_bytes());
+    if (!values.empty()) {
+        std::memcpy(bytes.data() + offset, values.data(), values.size_bytes());
+    }
+}
+
+template <typename T>
+static bool ReadSection(const std::span<const std::byte> file, const LevelSectionEntry &entry,
+                        gouda::Vector<T> &values)
+{
+    if (entry.element_size != sizeof(T) || entry.offset > file.size() ||
+        entry.count > (file.size() - entry.offset) / sizeof(T)) {
+        return false;
+    }
+
+    // The mapping is page aligned and so is every section, but the vectors own the data so the columns can still
+    // grow after loading. One copy per section is all loading costs.
+    values.resize(entry.count);
+    if (entry.count > 0) {
+        std::memcpy(values.data(), file.data() + entry.offset, entry.count * sizeof(T));
+    }
+    return true;
+}
+
+bool SaveLevelFile(StringView filepath, const EntityStore &entities, const gouda::math::BoundingVolumeHierarchy &tree,
+                   const std::span<const String> texture_paths)
+{
+    constexpr size_t section_count{static_cast<size_t>(LevelSection::Count)};
+    std::array<LevelSectionEntry, section_count> sections{};
+
+    std::vector<std::byte> bytes(sizeof(LevelFileHeader) + sizeof(sections));
+    AppendSection(bytes, sections[0], LevelSection::Positions, entities.GetPositions());
+    AppendSection(bytes, sections[1], LevelSection::Sizes, entities.GetSizes());
+    AppendSection(bytes, sections[2], LevelSection::Bounds, entities.GetBounds());
+    AppendSection(bytes, sections[3], LevelSection::Types, entities.GetTypes());
+    AppendSection(bytes, sections[4], LevelSection::Appearances, entities.GetAppearances());
+    AppendSection(bytes, sections[5], LevelSection::TreeNodes, tree.GetNodes());
+    AppendSection(bytes, sections[6], LevelSection::TreeEntityOrder, tree.GetEntityOrder());
+    AppendSection(bytes, sections[7], LevelSection::TreeEntityBounds, tree.GetEntityBounds());
+
+    String path_chars;
+    for (const String &path : texture_paths) {
+        path_chars.append(path);
+        path_chars.push_back('\0');
+    }
+    AppendSection(bytes, sections[8], LevelSection::TexturePaths, std::span<const char>{path_chars});
+
+    const LevelFileHeader header{LEVEL_FILE_MAGIC, LEVEL_FILE_VERSION, static_cast<u32>(section_count), 0};
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    std::memcpy(bytes.data() + sizeof(header), sections.data(), sizeof(sections));
+
+    if (const auto result{gouda::fs::WriteBinaryFile(filepath, bytes)}; !result) {
+        APP_LOG_ERROR("Failed to write level file '{}': {}", filepath, gouda::fs::error_to_string(result.error()));
+        return false;
+    }
+    return true;
+}
+
+bool LoadLevelFile(StringView filepath, EntityStore &entities, gouda::math::BoundingVolumeHierarchy &tree,
+                   gouda::Vector<String> *texture_paths)
+{
+    entities.Clear();
+    tree.Clear();
+    if (texture_paths != nullptr) {
+        texture_paths->clear();
+    }
+
+    const auto file{gouda::fs::MappedFile::Open(filepath)};
+    if (!file) {
+        APP_LOG_ERROR("Failed to open level file '{}': {}", filepath, gouda::fs::error_to_string(file.error()));
+        return false;
+    }
+
+    constexpr size_t section_count{static_cast<size_t>(LevelSection::Count)};
+    const std::span<const std::byte> data{file->GetData()};
+    if (data.size() < sizeof(LevelFileHeader) + sizeof(LevelSectionEntry) * section_count) {
+        APP_LOG_ERROR("Level file '{}' is truncated.", filepath);
+        return false;
+    }
+
+    LevelFileHeader header;
+    std::memcpy(&header, data.data(), sizeof(header));
+    if (header.magic != LEVEL_FILE_MAGIC || header.section_count != section_count) {
+        APP_LOG_ERROR("'{}' is not a level file.", filepath);
+        return false;
+    }
+    if (header.version != LEVEL_FILE_VERSION) {
+        APP_LOG_WARNING("Level file '{}' is version {}, expected {}. Re-export it from JSON.", filepath,
+                        header.version, LEVEL_FILE_VERSION);
+        return false;
+    }
+
+    std::array<LevelSectionEntry, section_count> sections;
+    std::memcpy(sections.data(), data.data() + sizeof(header), sizeof(sections));
+    for (size_t i = 0; i < section_count; ++i) {
+        if (sections[i].type != i) {
+            APP_LOG_ERROR("Level file '{}' has an unexpected section table.", filepath);
+            return false;
+        }
+    }
+
+    gouda::Vector<gouda::Vec3> positions;
+    gouda::Vector<gouda::Vec2> sizes;
+    gouda::Vector<gouda::math::AABB2D> bounds;
+    gouda::Vector<EntityType> types;
+    gouda::Vector<EntityAppearance> appearances;
+    gouda::Vector<TreeNode> nodes;
+    gouda::Vector<u32> entity_order;
+    gouda::Vector<gouda::math::AABB2D> entity_bounds;
+    gouda::Vector<char> path_chars;
+
+    const bool is_read{ReadSection(data, sections[0], positions) && ReadSection(data, sections[1], sizes) &&
+                       ReadSection(data, sections[2], bounds) && ReadSection(data, sections[3], types) &&
+                       ReadSection(data, sections[4], appearances) && ReadSection(data, sections[5], nodes) &&
+                       ReadSection(data, sections[6], entity_order) && ReadSection(data, sections[7], entity_bounds) &&
+                       ReadSection(data, sections[8], path_chars)};
+    if (!is_read) {
+        APP_LOG_ERROR("Level file '{}' has a section outside the file.", filepath);
+        return false;
+    }
+
+    const size_t entity_count{positions.size()};
+    if (!entities.AssignColumns(std::move(positions), std::move(sizes), std::move(bounds), std::move(types),
+                                std::move(appearances)) ||
+        !tree.Assign(std::move(nodes), std::move(entity_order), std::move(entity_bounds), entity_count)) {
+        entities.Clear();
+        tree.Clear();
+        APP_LOG_ERROR("Level file '{}' is malformed.", filepath);
+        return false;
+    }
+
+    if (texture_paths != nullptr) {
+        for (size_t begin = 0; begin < path_chars.size();) {
+            const auto end{std::find(path_chars.begin() + static_cast<std::ptrdiff_t>(begin), path_chars.end(), '\0')};
+            const auto end_index{static_cast<size_t>(end - path_chars.begin())};
+            texture_paths->emplace_back(path_chars.data() + begin, end_index - begin);
+            begin = end_index + 1;
+        }
+    }
+
+    APP_LOG_DEBUG("Loaded {} entities from level file '{}' ({}).", entity_count, filepath,
+                  file->IsMapped() ? "mapped" : "read");
+    return true;
+}
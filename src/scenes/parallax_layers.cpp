@@ -0,0 +1,86 @@
+/**
+ * @file parallax_layers.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Application parallax background layer module implementation
+ */
+#include "scenes/parallax_layers.hpp"
+
+#include <cmath>
+
+#include "debug/assert.hpp"
+
+ParallaxLayerID ParallaxLayers::AddLayer(const ParallaxLayerDesc &desc)
+{
+    ASSERT(desc.repeat_width >= 0.0f, "Parallax layer repeat width must not be negative");
+
+    Layer &layer{m_layers.emplace_back()};
+    layer.desc = desc;
+    return static_cast<ParallaxLayerID>(m_layers.size() - 1);
+}
+
+void ParallaxLayers::AddTile(const ParallaxLayerID layer_id, const gouda::InstanceData &tile)
+{
+    ASSERT(layer_id < m_layers.size(), "Parallax layer id out of range");
+
+    Layer &layer{m_layers[layer_id]};
+    gouda::InstanceData &added{layer.tiles.emplace_back(tile)};
+    added.position.z = layer.desc.depth;
+    if (layer.desc.repeat_width > 0.0f) {
+        const f32 width{layer.desc.repeat_width};
+        added.position.x -= std::floor(added.position.x / width) * width;
+    }
+    layer.bounds.PushBack({{added.position.x, added.position.y},
+                           {added.position.x + added.size.x, added.position.y + added.size.y}});
+}
+
+void ParallaxLayers::ClearTiles(const ParallaxLayerID layer_id)
+{
+    ASSERT(layer_id < m_layers.size(), "Parallax layer id out of range");
+
+    Layer &layer{m_layers[layer_id]};
+    layer.tiles.clear();
+    layer.bounds.Clear();
+}
+
+void ParallaxLayers::CollectVisible(const gouda::OrthographicCamera::FrustumData &view,
+                                    std::vector<gouda::InstanceData> &instances)
+{
+    for (Layer &layer : m_layers) {
+        layer.range = {instances.size(), 0};
+        if (layer.tiles.empty()) {
+            continue;
+        }
+
+        // A tile at p in layer space is drawn at p + offset, so it is visible when p overlaps the view less offset
+        const gouda::Vec2 offset{view.position.x * (1.0f - layer.desc.scroll_factor.x),
+                                 view.position.y * (1.0f - layer.desc.scroll_factor.y)};
+        const gouda::math::AABB2D layer_view{
+            {view.left + view.position.x - offset.x, view.top + view.position.y - offset.y},
+            {view.right + view.position.x - offset.x, view.bottom + view.position.y - offset.y}};
+
+        // Repeating layers are culled once per repeat the view overlaps, tiles were wrapped into [0, repeat_width)
+        // but may stick out past its end, so the repeat before the view is checked too
+        s64 first_repeat{0};
+        s64 last_repeat{0};
+        const f32 width{layer.desc.repeat_width};
+        if (width > 0.0f) {
+            first_repeat = static_cast<s64>(std::floor(layer_view.min.x / width)) - 1;
+            last_repeat = static_cast<s64>(std::floor(layer_view.max.x / width));
+        }
+
+        for (s64 repeat = first_repeat; repeat <= last_repeat; ++repeat) {
+            const f32 shift{static_cast<f32>(repeat) * width};
+            const gouda::math::AABB2D repeat_view{{layer_view.min.x - shift, layer_view.min.y},
+                                                  {layer_view.max.x - shift, layer_view.max.y}};
+            m_hits.clear();
+            gouda::math::intersect_aabbs(layer.bounds, repeat_view, m_hits);
+            for (const u32 hit : m_hits) {
+                gouda::InstanceData &instance{instances.emplace_back(layer.tiles[hit])};
+                instance.position.x += offset.x + shift;
+                instance.position.y += offset.y;
+            }
+        }
+        layer.range.count = instances.size() - layer.range.first;
+    }
+}
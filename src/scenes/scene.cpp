@@ -1,47 +1,176 @@
 #include "scenes/scene.hpp"
 
+#include <algorithm>
+#include <array>
 #include <fstream>
-#include <unordered_map>
-#include <unordered_set>
+#include <thread>
+#include <type_traits>
 
 #include <nlohmann/json.hpp>
 
 #include "containers/small_vector.hpp"
 #include "core/types.hpp"
+#include "debug/debug_draw.hpp"
 #include "debug/logger.hpp"
+#include "debug/profiler.hpp"
 #include "math/collision.hpp"
+#include "math/simd_kernels.hpp"
 #include "math/vector.hpp"
 
-struct GridRange {
-    int min_x;
-    int max_x;
-    int min_y;
-    int max_y;
-};
+#include "core/constants.hpp"
+#include "scenes/level_file.hpp"
+
+constexpr f32 SPATIAL_GRID_CELL_SIZE{500.0f};
+constexpr u32 MAX_UPDATE_THREADS{4}; // The update systems are few and short, more threads would mostly idle
+constexpr f32 OCCLUSION_PER_OCCLUDER{0.5f}; // Two entities between a sound and the listener block it fully
+
+// Resources the update systems declare, systems that share none of them run in parallel
+constexpr gouda::SystemResources RESOURCE_SCENE_CAMERA{u64{1} << 0};
+constexpr gouda::SystemResources RESOURCE_PARTICLES{u64{1} << 1};
+constexpr gouda::SystemResources RESOURCE_PLAYER{u64{1} << 2};
+constexpr gouda::SystemResources RESOURCE_ENTITIES{u64{1} << 3};
+constexpr gouda::SystemResources RESOURCE_SPATIAL_INDEX{u64{1} << 4}; // Written by queries, the grid stamps results
+constexpr gouda::SystemResources RESOURCE_VISIBLE_INSTANCES{u64{1} << 5};
 
-GridRange GetGridRange(const Rect<f32> &bounds, const f32 cell_size)
+static gouda::math::AABB2D GetEntityAABB(const Entity &entity)
 {
-    return {(gouda::math::floor(bounds.left / cell_size)), (gouda::math::floor(bounds.right / cell_size)),
-            (gouda::math::floor(bounds.bottom / cell_size)), (gouda::math::floor(bounds.top / cell_size))};
+    const gouda::Vec3 &position{entity.render_data.position};
+    const gouda::Vec2 &size{entity.render_data.size};
+    return {{position.x, position.y}, {position.x + size.x, position.y + size.y}};
 }
 
-bool IsInFrustum(const gouda::Vec3 &position, const gouda::Vec2 &size,
-                 const gouda::OrthographicCamera::FrustumData &frustum)
+// Sprites are atlas sprite names, looked up in the texture's metadata, or UV rects. Tiles are palette indices, a
+// negative index leaves the tile empty.
+static gouda::Tilemap ParseTilemap(const nlohmann::json &tilemap_data, const gouda::vk::TextureManager *texture_manager,
+                                   gouda::Vector<String> &sprite_names)
 {
-    const gouda::math::AABB2D frustum_bounds{{frustum.left + frustum.position.x, frustum.top + frustum.position.y},
-                                             {frustum.right + frustum.position.x, frustum.bottom + frustum.position.y}};
-    const gouda::math::AABB2D object_bounds{{position.x, position.y}, {position.x + size.x, position.y + size.y}};
+    sprite_names.clear();
+    const auto tile_size{tilemap_data.at("tile_size").get<std::array<f32, 2>>()};
+    const auto origin{tilemap_data.value("origin", std::array<f32, 3>{0.0f, 0.0f, 0.0f})};
+    const u32 texture_index{tilemap_data.value("texture_index", 0u)};
+    gouda::Tilemap tilemap{tilemap_data.at("width").get<u32>(), tilemap_data.at("height").get<u32>(),
+                           {tile_size[0], tile_size[1]}, {origin[0], origin[1], origin[2]}, texture_index};
+
+    for (const nlohmann::json &sprite_data : tilemap_data.at("sprites")) {
+        if (sprite_data.is_string()) {
+            const auto name{sprite_data.get<String>()};
+            sprite_names.push_back(name);
+            const gouda::vk::Sprite *sprite{texture_manager->GetSprite(texture_index, gouda::StringId{name})};
+            if (sprite == nullptr) {
+                APP_LOG_WARNING("Tilemap sprite '{}' is not in texture {}, its tiles are drawn blank.", name,
+                                texture_index);
+                tilemap.AddSprite(gouda::UVRect<f32>{});
+                continue;
+            }
+            tilemap.AddSprite(*sprite);
+        }
+        else {
+            const auto rect{sprite_data.get<std::array<f32, 4>>()};
+            sprite_names.emplace_back();
+            tilemap.AddSprite(gouda::UVRect<f32>{rect[0], rect[1], rect[2], rect[3]});
+        }
+    }
+
+    const nlohmann::json &tiles{tilemap_data.at("tiles")};
+    const size_t sprite_count{tilemap.GetSprites().size()};
+    for (u32 y = 0; y < tilemap.GetHeight(); ++y) {
+        for (u32 x = 0; x < tilemap.GetWidth(); ++x) {
+            const size_t index{static_cast<size_t>(y) * tilemap.GetWidth() + x};
+            const s32 sprite{index < tiles.size() ? tiles[index].get<s32>() : -1};
+            if (sprite >= 0 && static_cast<size_t>(sprite) < sprite_count) {
+                tilemap.SetTile(x, y, static_cast<u16>(sprite));
+            }
+        }
+    }
+    return tilemap;
+}
+
+static nlohmann::json WriteTilemap(const gouda::Tilemap &tilemap)
+{
+    nlohmann::json sprites = nlohmann::json::array();
+    for (const gouda::UVRect<f32> &rect : tilemap.GetSprites()) {
+        sprites.push_back({rect.u_min, rect.v_min, rect.u_max, rect.v_max});
+    }
+    nlohmann::json tiles = nlohmann::json::array();
+    for (const u16 tile : tilemap.GetTiles()) {
+        tiles.push_back(tile == gouda::Tilemap::EMPTY_TILE ? -1 : static_cast<s32>(tile));
+    }
+
+    const gouda::Vec2 &tile_size{tilemap.GetTileSize()};
+    const gouda::Vec3 &origin{tilemap.GetOrigin()};
+    return {{"width", tilemap.GetWidth()},
+            {"height", tilemap.GetHeight()},
+            {"tile_size", {tile_size.x, tile_size.y}},
+            {"origin", {origin.x, origin.y, origin.z}},
+            {"texture_index", tilemap.GetTextureIndex()},
+            {"sprites", sprites},
+            {"tiles", tiles}};
+}
+
+// The player as snapshots store it, Player itself is not trivially copyable
+struct PlayerSnapshot {
+    gouda::InstanceData render_data;
+    gouda::Vec3 previous_position;
+    gouda::Vec2 velocity;
+    f32 speed;
+    AnimationComponent animation;
+    HealthComponent health;
+    u8 has_animation;
+    u8 has_health;
+};
 
-    return object_bounds.Intersects(frustum_bounds);
+static_assert(std::is_trivially_copyable_v<PlayerSnapshot>);
+
+static PlayerSnapshot MakePlayerSnapshot(const Player &player)
+{
+    return PlayerSnapshot{player.render_data,
+                          player.previous_position,
+                          player.velocity,
+                          player.speed,
+                          player.animation_component.value_or(AnimationComponent{}),
+                          player.health_component.value_or(HealthComponent{}),
+                          static_cast<u8>(player.animation_component.has_value()),
+                          static_cast<u8>(player.health_component.has_value())};
+}
+
+static void ApplyPlayerSnapshot(const PlayerSnapshot &snapshot, Player &player)
+{
+    player.render_data = snapshot.render_data;
+    player.previous_position = snapshot.previous_position;
+    player.velocity = snapshot.velocity;
+    player.speed = snapshot.speed;
+    player.animation_component =
+        snapshot.has_animation != 0 ? std::optional{snapshot.animation} : std::optional<AnimationComponent>{};
+    player.health_component =
+        snapshot.has_health != 0 ? std::optional{snapshot.health} : std::optional<HealthComponent>{};
 }
+
 // Scene ---------------------------------------------------------------------------------------
-Scene::Scene(gouda::OrthographicCamera *scene_camera, gouda::OrthographicCamera *ui_camera, gouda::vk::TextureManager *texture_manager)
+Scene::Scene(gouda::OrthographicCamera *scene_camera, gouda::OrthographicCamera *ui_camera,
+             gouda::vk::TextureManager *texture_manager, gouda::AssetRegistry *asset_registry)
     : p_scene_camera{scene_camera},
       p_ui_camera{ui_camera},
       p_texture_manager{texture_manager},
+      p_asset_registry{asset_registry},
+      p_audio_manager{nullptr},
+      p_job_system{nullptr},
+      m_player_atlas_dependent{gouda::INVALID_SLOT_HANDLE},
+      m_tilemap_atlas_dependent{gouda::INVALID_SLOT_HANDLE},
       m_player{gouda::InstanceData{}, {0.0f}, 0.0f},
+      m_animation_time{0.0f},
+      m_animation_interval{1},
+      m_animation_update_count{0},
+      m_animation_delta_time{0.0f},
+      m_animation_tables_version{constants::u64_max},
       m_instances_dirty{true},
-      m_font_id{1}
+      m_particle_colliders_dirty{true},
+      m_tilemap{},
+      m_tilemap_dirty{false},
+      m_font_id{1},
+      m_spatial_grid{SPATIAL_GRID_CELL_SIZE},
+      p_worker_pool{std::make_unique<gouda::WorkerPool>(
+          std::clamp(std::thread::hardware_concurrency(), 1u, MAX_UPDATE_THREADS))},
+      m_systems{p_worker_pool.get()}
 {
     ////*
     const gouda::Vector<gouda::InstanceData> instances = {
@@ -100,9 +229,9 @@ Scene::Scene(gouda::OrthographicCamera *scene_camera, gouda::OrthographicCamera
 };
 
 
-    m_entities.reserve(instances.size());
+    m_entities.Reserve(instances.size());
     for (const auto &instance : instances) {
-        m_entities.emplace_back(instance, EntityType::Quad);
+        m_entities.Add(Entity{instance, EntityType::Quad});
     }
 
     ///*/
@@ -113,155 +242,427 @@ Scene::Scene(gouda::OrthographicCamera *scene_camera, gouda::OrthographicCamera
     SetupUI();
 
     m_visible_quad_instances.reserve(instances.size() + 1);
-    BuildSpatialGrid();
+    BuildSpatialIndex();
+    SetupSystems();
+    SetupRenderGraph();
 
-    m_particles_instances.reserve(1024); // Reserve space for particles
+    m_particles.Reserve(1024); // Reserve space for particles
+    m_particles_instances.reserve(1024);
+}
+
+Scene::~Scene()
+{
+    if (p_asset_registry != nullptr) {
+        p_asset_registry->RemoveDependent(m_player_atlas_dependent);
+        p_asset_registry->RemoveDependent(m_tilemap_atlas_dependent);
+    }
 }
 
 void Scene::Update(const f32 delta_time)
 {
-    p_scene_camera->Update(delta_time);
-    p_ui_camera->Update(delta_time);
+    // What the last update left is where this one starts from, rendering interpolates between the two
+    m_entities.BeginStep();
+    m_player.previous_position = m_player.render_data.position;
 
-    UpdateParticles(delta_time);
+    // Streaming requests textures, which only the main thread may do, so it stays out of the scheduled systems
+    if (p_world_streamer) {
+        p_world_streamer->Update(*p_scene_camera, delta_time);
+    }
+    m_systems.Run(delta_time);
 
-    // Early exit for no movement
-    if (m_player.velocity.x == 0 && m_player.velocity.y == 0) {
-        UpdateVisibleInstances();
-        UpdateUI(delta_time);
+    // Counters may only be written from the main thread, the systems leave their counts behind
+    ENGINE_PROFILE_COUNTER("Collision pairs", m_collision_statistics.broadphase_pair_count);
+    ENGINE_PROFILE_COUNTER("Collision contacts",
+                           m_collision_statistics.contact_count + m_collision_statistics.player_contact_count);
+}
+
+void Scene::Render([[maybe_unused]] const f32 delta_time, const f32 interpolation_factor,
+                   gouda::vk::Renderer &renderer, FrameDrawList &draw_list)
+{
+    m_render_frame = {.renderer = &renderer,
+                      .draw_list = &draw_list,
+                      .interpolation_factor = interpolation_factor,
+                      .use_compute_particles = renderer.UseComputeParticles()};
+
+    // Compute particles are simulated on the GPU, only new spawns are handed over. Before the graph, the particle
+    // task would otherwise race the clear.
+    if (m_render_frame.use_compute_particles) {
+        renderer.EmitParticles(m_particle_spawns);
+        m_particles.Clear();
+        m_particle_spawns.clear();
+    }
+
+    m_render_graph.Run(p_job_system);
+    m_render_frame = {};
+}
+
+void Scene::DrawUI(gouda::vk::Renderer &renderer, FrameDrawList &draw_list)
+{
+    DrawUIInstances(renderer, draw_list.quad_instances);
+}
+
+void Scene::DrawUIInstances(gouda::vk::Renderer &renderer, std::vector<gouda::InstanceData> &quad_instances)
+{
+    // Moves with the camera, so it is world text rather than UI
+    renderer.DrawText("GOUDA RENDERER", {100.0f, 100.0f, -0.5}, {0.0f, 1.0f, 0.0f, 1.0f}, 20.0f, m_font_id,
+                      quad_instances, gouda::TextAlign::Center, true);
+
+    for (size_t i = 0; i < m_ui_elements.size(); ++i) {
+        m_ui_batcher.AddQuad(i, m_ui_elements[i]);
+    }
+    m_ui_batcher.AddText(m_ui_elements.size(), renderer, "GOUDA RENDERER", {200.0f, 200.0f, -0.1},
+                         {0.0f, 1.0f, 0.0f, 1.0f}, 50.0f, 2);
+    m_ui_batcher.Flush(quad_instances);
+}
+
+void Scene::LoadFromJSON(std::string_view filepath)
+{
+    std::ifstream file{String{filepath}};
+    if (!file.is_open()) {
+        APP_LOG_ERROR("Failed to open scene file '{}'.", filepath);
         return;
     }
 
-    // Calculate new position
-    gouda::Vec3 new_position{};
-    new_position.x = m_player.render_data.position.x + m_player.velocity.x * delta_time;
-    new_position.y = m_player.render_data.position.y + m_player.velocity.y * delta_time,
-    new_position.z = m_player.render_data.position.z;
+    try {
+        const nlohmann::json json_data{nlohmann::json::parse(file)};
 
-    // Player collision bounds
-    const Rect<f32> player_bounds{new_position.x, new_position.x + m_player.render_data.size.x, new_position.y,
-                                  new_position.y + m_player.render_data.size.y};
+        EntityStore entities;
+        const nlohmann::json &entity_array{json_data.at("entities")};
+        entities.Reserve(entity_array.size());
+        for (const nlohmann::json &entity_data : entity_array) {
+            const auto position{entity_data.at("position").get<std::array<f32, 3>>()};
+            const auto size{entity_data.at("size").get<std::array<f32, 2>>()};
+            const auto colour{entity_data.value("colour", std::array<f32, 4>{1.0f, 1.0f, 1.0f, 1.0f})};
 
-    // Spatial grid query for collision
-    static constexpr f32 cell_size{500.0f};
-    auto [min_x, max_x, min_y, max_y] = GetGridRange(player_bounds, cell_size);
-
-    static std::unordered_set<size_t> nearby_entities;
-    nearby_entities.clear();
-    for (int x = min_x; x <= max_x; ++x) {
-        for (int y = min_y; y <= max_y; ++y) {
-            if (auto it = m_spatial_grid.find(GridPos{x, y}); it != m_spatial_grid.end()) {
-                nearby_entities.insert(it->second.begin(), it->second.end());
-            }
+            const gouda::InstanceData instance{{position[0], position[1], position[2]},
+                                               {size[0], size[1]},
+                                               entity_data.value("rotation", 0.0f),
+                                               entity_data.value("texture_index", 0u),
+                                               gouda::Colour<f32>{colour[0], colour[1], colour[2], colour[3]}};
+            entities.Add(Entity{instance, static_cast<EntityType>(entity_data.value("type", u8{0}))});
         }
+
+        gouda::Tilemap tilemap;
+        gouda::Vector<String> sprite_names;
+        if (const auto tilemap_data{json_data.find("tilemap")}; tilemap_data != json_data.end()) {
+            tilemap = ParseTilemap(*tilemap_data, p_texture_manager, sprite_names);
+        }
+
+        m_entities = std::move(entities);
+        m_entity_pools.clear();
+        ClearAttachments();
+        SetTilemap(std::move(tilemap));
+        m_tilemap_sprite_names = std::move(sprite_names);
+        WatchAtlas(m_tilemap_atlas_dependent, m_tilemap.GetTextureIndex(), [this] { DeriveTilemapSprites(); });
+    }
+    catch (const std::exception &error) {
+        APP_LOG_ERROR("Failed to parse scene file '{}'. Error: {}", filepath, error.what());
+        return;
     }
 
-    // Collision detection and resolution
-    for (const size_t entity_idx : nearby_entities) {
-        auto &entity = m_entities[entity_idx];
-        if (const gouda::Vec2 & entity_size{entity.render_data.size};
-            check_collision(new_position, m_player.render_data.size, entity.render_data.position, entity_size)) {
+    m_visible_quad_instances.reserve(m_entities.Size() + 1);
+    m_instances_dirty = true;
+    BuildSpatialIndex();
+}
 
-            const Rect<f32> entity_bounds{entity.render_data.position.x, entity.render_data.position.x + entity_size.x,
-                                          entity.render_data.position.y, entity.render_data.position.y + entity_size.y};
+void Scene::SaveToJSON(std::string_view filepath)
+{
+    nlohmann::json entity_array = nlohmann::json::array();
+    for (size_t i = 0; i < m_entities.Size(); ++i) {
+        if (IsPooledEntity(i)) {
+            continue;
+        }
+        const gouda::Vec3 &position{m_entities.GetPositions()[i]};
+        const gouda::Vec2 &size{m_entities.GetSizes()[i]};
+        const EntityAppearance &appearance{m_entities.GetAppearance(i)};
+        const gouda::Colour<f32> &colour{appearance.colour};
 
-            const Rect<f32> penetration_bounds{
-                player_bounds.right - entity_bounds.left, entity_bounds.right - player_bounds.left,
-                player_bounds.top - entity_bounds.bottom, entity_bounds.top - player_bounds.bottom};
+        entity_array.push_back({{"type", static_cast<u8>(m_entities.GetType(i))},
+                                {"position", {position.x, position.y, position.z}},
+                                {"size", {size.x, size.y}},
+                                {"rotation", appearance.rotation},
+                                {"texture_index", appearance.texture_index},
+                                {"colour", {colour.r, colour.g, colour.b, colour.a}}});
+    }
 
-            f32 min_penetration{constants::f32_max};
-            enum class Direction : u8 { None, Left, Right, Bottom, Top } resolve_dir = Direction::None;
+    std::ofstream file{String{filepath}};
+    if (!file.is_open()) {
+        APP_LOG_ERROR("Failed to open scene file '{}' for writing.", filepath);
+        return;
+    }
+    nlohmann::json scene_data{{"entities", entity_array}};
+    if (!m_tilemap.IsEmpty()) {
+        scene_data["tilemap"] = WriteTilemap(m_tilemap);
+    }
+    file << scene_data.dump(4);
+}
 
-            if (penetration_bounds.left > 0 && m_player.velocity.x > 0) {
-                if (penetration_bounds.left < min_penetration) {
-                    min_penetration = penetration_bounds.left;
-                    resolve_dir = Direction::Left;
-                }
-            }
-            if (penetration_bounds.right > 0 && m_player.velocity.x < 0) {
-                if (penetration_bounds.right < min_penetration) {
-                    min_penetration = penetration_bounds.right;
-                    resolve_dir = Direction::Right;
-                }
-            }
-            if (penetration_bounds.bottom > 0 && m_player.velocity.y > 0) {
-                if (penetration_bounds.bottom < min_penetration) {
-                    min_penetration = penetration_bounds.bottom;
-                    resolve_dir = Direction::Bottom;
-                }
-            }
-            if (penetration_bounds.top > 0 && m_player.velocity.y < 0) {
-                if (penetration_bounds.top < min_penetration) {
-                    min_penetration = penetration_bounds.top;
-                    resolve_dir = Direction::Top;
-                }
+void Scene::SetTilemap(gouda::Tilemap tilemap)
+{
+    m_tilemap = std::move(tilemap);
+    m_tilemap_dirty = true;
+    m_tilemap_sprite_names.clear();
+    if (p_asset_registry != nullptr) {
+        p_asset_registry->RemoveDependent(m_tilemap_atlas_dependent);
+        m_tilemap_atlas_dependent = gouda::INVALID_SLOT_HANDLE;
+    }
+}
+
+bool Scene::LoadLevel(const StringView filepath)
+{
+    // The tree comes from the file, only the grid of moved entities starts over
+    m_entity_pools.clear();
+    ClearAttachments();
+    if (!LoadLevelFile(filepath, m_entities, m_level_bvh)) {
+        BuildSpatialIndex();
+        return false;
+    }
+
+    m_spatial_grid.Clear();
+    m_entity_in_grid.assign(m_entities.Size(), 0);
+    m_broadphase.Clear();
+    m_visible_quad_instances.reserve(m_entities.Size() + 1);
+    m_instances_dirty = true;
+    m_particle_colliders_dirty = true;
+    return true;
+}
+
+void Scene::SaveSnapshot(const StringView filepath, const bool compress)
+{
+    ENGINE_PROFILE_SCOPE("Capture snapshot");
+
+    SnapshotCapture capture{m_snapshot};
+    m_entities.VisitColumns(capture);
+    m_particles.VisitColumns(capture);
+    capture.Value(MakePlayerSnapshot(m_player));
+    capture.Value(m_animation_time);
+    capture.Value(static_cast<u32>(m_entity_pools.size()));
+    for (const EntityPool &pool : m_entity_pools) {
+        pool.VisitColumns(capture);
+    }
+
+    if (!p_snapshot_writer) {
+        p_snapshot_writer = std::make_unique<SnapshotWriter>();
+    }
+    p_snapshot_writer->Queue(String{filepath}, m_snapshot, compress);
+}
+
+bool Scene::LoadSnapshot(const StringView filepath)
+{
+    // A quick load straight after a quick save reads the file that save is writing
+    if (p_snapshot_writer) {
+        p_snapshot_writer->Wait();
+    }
+    if (!ReadSnapshotFile(filepath, m_snapshot)) {
+        return false;
+    }
+
+    // Restored into copies, so a snapshot that does not fit changes nothing
+    SnapshotRestore restore{m_snapshot};
+    EntityStore entities;
+    entities.VisitColumns(restore);
+    gouda::ParticleStore particles{m_particles.GetFadeTime()};
+    particles.VisitColumns(restore);
+    PlayerSnapshot player{};
+    restore.Value(player);
+    f32 animation_time{0.0f};
+    restore.Value(animation_time);
+    u32 pool_count{0};
+    restore.Value(pool_count);
+    gouda::Vector<EntityPool> pools{m_entity_pools};
+    if (pool_count == pools.size()) {
+        for (EntityPool &pool : pools) {
+            pool.VisitColumns(restore);
+        }
+    }
+
+    const bool are_pools_valid{pool_count == pools.size() && std::ranges::all_of(pools, [&](const EntityPool &pool) {
+                                   return pool.IsConsistent() &&
+                                          static_cast<size_t>(pool.GetFirst()) + pool.GetCapacity() <= entities.Size();
+                               })};
+    if (!restore.IsComplete() || !entities.IsConsistent() || !particles.IsConsistent() || !are_pools_valid) {
+        APP_LOG_ERROR("Snapshot '{}' does not fit this scene, it was taken with other entity pools or is malformed.",
+                      filepath);
+        return false;
+    }
+
+    m_entities = std::move(entities);
+    m_particles = std::move(particles);
+    m_entity_pools = std::move(pools);
+    ApplyPlayerSnapshot(player, m_player);
+    m_animation_time = animation_time;
+
+    // Pooled slots are looked up in the grid only, as they are once spawned
+    BuildSpatialIndex();
+    for (const EntityPool &pool : m_entity_pools) {
+        for (u32 index = pool.GetFirst(); index < pool.GetFirst() + pool.GetCapacity(); ++index) {
+            m_entity_in_grid[index] = 1;
+            if (pool.IsActive(index)) {
+                m_spatial_grid.Insert(index, m_entities.GetBounds()[index]);
             }
+        }
+    }
+    m_visible_quad_instances.reserve(m_entities.Size() + 1);
+    m_instances_dirty = true;
 
-            switch (resolve_dir) {
-                case Direction::Left:
-                    new_position.x = entity_bounds.left - m_player.render_data.size.x - 0.001f;
-                    m_player.velocity.x = 0;
-                    break;
-                case Direction::Right:
-                    new_position.x = entity_bounds.right + 0.001f;
-                    m_player.velocity.x = 0;
-                    break;
-                case Direction::Bottom:
-                    new_position.y = entity_bounds.bottom - m_player.render_data.size.y - 0.001f;
-                    m_player.velocity.y = 0;
-                    break;
-                case Direction::Top:
-                    new_position.y = entity_bounds.top + 0.001f;
-                    m_player.velocity.y = 0;
-                    break;
-                case Direction::None:
-                    break;
+    APP_LOG_DEBUG("Restored {} entities and {} particles from snapshot '{}'.", m_entities.Size(), m_particles.Size(),
+                  filepath);
+    return true;
+}
+
+void Scene::EnableStreaming(const StringView directory, gouda::JobSystem *job_system,
+                            const WorldStreamingSettings &settings)
+{
+    p_world_streamer.reset(); // Waits for the loads of a previous world first
+    p_world_streamer = std::make_unique<WorldStreamer>(directory, settings, job_system, p_texture_manager);
+}
+
+bool Scene::SaveLevel(const StringView filepath) const
+{
+    // Pooled entities are gameplay state rather than level geometry, the level is saved from a copy without them
+    if (!m_entity_pools.empty()) {
+        EntityStore level_entities;
+        level_entities.Reserve(m_entities.Size());
+        for (size_t i = 0; i < m_entities.Size(); ++i) {
+            if (!IsPooledEntity(i)) {
+                level_entities.Add(m_entities.BuildEntity(i));
             }
-            break; // Early exit after first collision
         }
+        gouda::math::BoundingVolumeHierarchy tree;
+        tree.Build(level_entities.GetBounds());
+        return SaveLevelFile(filepath, level_entities, tree);
     }
 
-    m_player.render_data.position = new_position;
+    // Moved entities are saved where they are now, which the tree built at load no longer matches
+    if (std::ranges::any_of(m_entity_in_grid, [](const u8 in_grid) { return in_grid != 0; })) {
+        gouda::math::BoundingVolumeHierarchy tree;
+        tree.Build(m_entities.GetBounds());
+        return SaveLevelFile(filepath, m_entities, tree);
+    }
+    return SaveLevelFile(filepath, m_entities, m_level_bvh);
+}
+
+size_t Scene::AddEntity(const Entity &entity)
+{
+    const size_t index{m_entities.Add(entity)};
+    m_entity_in_grid.push_back(1);
+    m_spatial_grid.Insert(static_cast<u32>(index), m_entities.GetBounds()[index]);
+    m_instances_dirty = true;
+    m_particle_colliders_dirty = true;
+    return index;
+}
 
-    // Update visible instances without spatial grid
-    UpdateVisibleInstances();
-    UpdateUI(delta_time);
+void Scene::MoveEntity(const size_t index, const gouda::Vec3 &position)
+{
+    m_entities.SetPosition(index, position);
+    m_entity_in_grid[index] = 1;
+    m_spatial_grid.Move(static_cast<u32>(index), m_entities.GetBounds()[index]);
+    m_broadphase.Move(static_cast<u32>(index), m_entities.GetBounds()[index]);
+    m_instances_dirty = true;
+    m_particle_colliders_dirty = true;
 }
 
-void Scene::Render(const f32 delta_time, gouda::vk::Renderer &renderer, gouda::UniformData &uniform_data)
+void Scene::AttachEntity(const size_t entity, const size_t parent, const gouda::Vec2 &offset, const f32 rotation)
 {
-    DrawUI(renderer);
+    if (entity >= m_entities.Size() || parent >= m_entities.Size() || entity == parent) {
+        APP_LOG_WARNING("Entity {} cannot be attached to entity {}.", entity, parent);
+        return;
+    }
 
-    uniform_data.wvp = p_scene_camera->GetViewProjectionMatrix();
-    uniform_data.wvp_static = p_ui_camera->GetViewProjectionMatrix();
-    renderer.Render(delta_time, uniform_data, m_visible_quad_instances, m_text_instances, m_particles_instances);
+    const gouda::math::TransformID parent_transform{GetEntityTransform(parent)};
+    const gouda::math::TransformID transform{GetEntityTransform(entity)};
+    if (!m_transforms.SetParent(transform, parent_transform)) {
+        return; // The parent is attached to the entity
+    }
+    m_transforms.SetLocal(transform, {offset, rotation, gouda::Vec2{1.0f}});
+    m_root_transform_entities.erase(
+        std::remove(m_root_transform_entities.begin(), m_root_transform_entities.end(), static_cast<u32>(entity)),
+        m_root_transform_entities.end());
 }
-void Scene::UpdateUI([[maybe_unused]]const f32 delta_time)
+
+void Scene::DetachEntity(const size_t entity)
 {
-    for (auto element : m_ui_elements) {
-        m_visible_quad_instances.push_back(element);
+    if (entity >= m_entity_transforms.size() || m_entity_transforms[entity] == gouda::math::INVALID_TRANSFORM) {
+        return;
     }
+
+    const gouda::math::TransformID transform{m_entity_transforms[entity]};
+    if (m_transforms.GetParent(transform) == gouda::math::INVALID_TRANSFORM) {
+        return;
+    }
+    m_transforms.SetParent(transform, gouda::math::INVALID_TRANSFORM);
+    m_root_transform_entities.push_back(static_cast<u32>(entity)); // Read back from the entity by the next update
 }
 
-void Scene::DrawUI(gouda::vk::Renderer &renderer)
+gouda::math::TransformID Scene::GetEntityTransform(const size_t entity)
 {
-    m_text_instances.clear();
+    if (entity >= m_entity_transforms.size()) {
+        m_entity_transforms.resize(m_entities.Size(), gouda::math::INVALID_TRANSFORM);
+    }
+    if (m_entity_transforms[entity] != gouda::math::INVALID_TRANSFORM) {
+        return m_entity_transforms[entity];
+    }
 
-    renderer.DrawText("GOUDA RENDERER", {100.0f, 100.0f, -0.5}, {0.0f, 1.0f, 0.0f, 1.0f}, 20.0f, m_font_id,
-                      m_text_instances, gouda::TextAlign::Center, true);
+    // New nodes start as roots where the entity is
+    const gouda::Vec3 &position{m_entities.GetPositions()[entity]};
+    const gouda::math::TransformID transform{
+        m_transforms.Add({{position.x, position.y}, m_entities.GetAppearance(entity).rotation, gouda::Vec2{1.0f}})};
+    if (transform >= m_transform_entities.size()) {
+        m_transform_entities.resize(transform + 1);
+    }
+    m_transform_entities[transform] = static_cast<u32>(entity);
+    m_entity_transforms[entity] = transform;
+    m_root_transform_entities.push_back(static_cast<u32>(entity));
+    return transform;
+}
 
+void Scene::ClearAttachments()
+{
+    m_transforms.Clear();
+    m_entity_transforms.clear();
+    m_transform_entities.clear();
+    m_root_transform_entities.clear();
+}
 
-    renderer.DrawText("GOUDA RENDERER", {200.0f, 200.0f, -0.1}, {0.0f, 1.0f, 0.0f, 1.0f}, 50.0f, 2,
-                  m_text_instances);
+EntityPoolID Scene::CreateEntityPool(const Entity &prototype, const u32 capacity)
+{
+    // Parked slots are in neither the tree nor the grid, spawning puts them in the grid like AddEntity
+    const size_t first{m_entities.AddParked(prototype, capacity)};
+    m_entity_in_grid.resize(m_entities.Size(), 1);
+    m_visible_quad_instances.reserve(m_entities.Size() + 1);
+    m_entity_pools.emplace_back(prototype, static_cast<u32>(first), capacity);
+    return static_cast<EntityPoolID>(m_entity_pools.size() - 1);
 }
 
-void Scene::LoadFromJSON(std::string_view filepath)
+std::optional<size_t> Scene::SpawnPooledEntity(const EntityPoolID pool, const gouda::Vec3 &position)
 {
-    m_instances_dirty = true; // Trigger grid rebuild
-    BuildSpatialGrid();
+    EntityPool &entity_pool{m_entity_pools[pool]};
+    const std::optional<u32> index{entity_pool.Acquire()};
+    if (!index) {
+        return std::nullopt;
+    }
+
+    m_entities.Respawn(*index, entity_pool.GetPrototype(), position);
+    m_entity_in_grid[*index] = 1; // The tree may still hold where the slot was when the index was last built
+    m_spatial_grid.Insert(*index, m_entities.GetBounds()[*index]);
+    m_instances_dirty = true;
+    m_particle_colliders_dirty = true;
+    return *index;
 }
 
-void Scene::SaveToJSON(std::string_view filepath) {}
+void Scene::DespawnPooledEntity(const EntityPoolID pool, const size_t index)
+{
+    if (!m_entity_pools[pool].Release(index)) {
+        APP_LOG_WARNING("Entity {} is not spawned from entity pool {}.", index, pool);
+        return;
+    }
+
+    m_entities.Park(index);
+    m_spatial_grid.Remove(static_cast<u32>(index));
+    m_broadphase.Remove(static_cast<u32>(index));
+    m_instances_dirty = true;
+    m_particle_colliders_dirty = true;
+}
 
 void Scene::SpawnParticle(const gouda::Vec3 &position, const gouda::Vec2 &size, const gouda::Vec3 &velocity,
                           const f32 lifetime, const u32 texture_index, const gouda::Vec4 &colour)
@@ -271,7 +672,15 @@ void Scene::SpawnParticle(const gouda::Vec3 &position, const gouda::Vec2 &size,
         return;
     }
 
-    m_particles_instances.emplace_back(position, size, lifetime, velocity, colour, texture_index);
+    m_particle_spawns.emplace_back(position, size, lifetime, velocity, colour, texture_index);
+}
+
+void Scene::SpawnPendingParticles()
+{
+    for (const auto &particle : m_particle_spawns) {
+        m_particles.Spawn(particle);
+    }
+    m_particle_spawns.clear();
 }
 
 // Private ---------------------------------------------------------------------------------
@@ -283,22 +692,83 @@ void Scene::SetupPlayer()
     // yet?????
     m_player.render_data.position = {500.0f, 500.0f, -0.4f};
     m_player.render_data.size = {32.0f, 32.0f};
-    m_player.render_data.texture_index = 5;
+    m_player.render_data.texture_index =
+        p_texture_manager != nullptr ? p_texture_manager->FindSpriteTexture(sprite_ids::player_walk) : 0;
     m_player.render_data.colour = {1.0f, 1.0f, 1.0f, 0.0f};
     m_player.velocity = {0.0f};
     m_player.speed = 200.0f;
     m_player.render_data.is_atlas = true;
 
-    const auto sprite = p_texture_manager->GetSprite(5, "player.walk");
+    DerivePlayerClips();
+    m_player.animation_component = AnimationComponent{m_animations.FindClip(animation_ids::player_idle)};
+    WatchAtlas(m_player_atlas_dependent, m_player.render_data.texture_index, [this] { DerivePlayerClips(); });
+}
+
+void Scene::DerivePlayerClips()
+{
+    // The sprite is looked up every time, a reloaded atlas JSON replaces the sprites earlier pointers referred to
+    if (p_texture_manager == nullptr) {
+        return; // Headless, nothing is drawn
+    }
+    const auto sprite = p_texture_manager->GetSprite(m_player.render_data.texture_index, sprite_ids::player_walk);
+    if (sprite == nullptr || sprite->frames.size() < 2) {
+        APP_LOG_WARNING("The player atlas has no walk sprite, the player is not animated.");
+        return;
+    }
     const auto frame = sprite->frames.at(1);
 
     // Currently hardcoded
     m_player.render_data.sprite_rect =
         UVRect{frame.uv_rect.u_min, frame.uv_rect.v_min, frame.uv_rect.u_max, frame.uv_rect.v_max};
 
-    // Add animation component to player
-    m_player.animation_component = AnimationComponent{};
-    m_player.animation_component->current_animation = "idle";
+    // Walking plays the sprite's frames, idle holds the frame the player was drawn with. Replacing a clip keeps its id,
+    // so the player's component still plays the same clips.
+    gouda::Vector<UVRect<f32>> walk_frames;
+    walk_frames.reserve(sprite->frames.size());
+    for (const auto &walk_frame : sprite->frames) {
+        walk_frames.push_back(walk_frame.uv_rect);
+    }
+    m_animations.AddClip("player.walk", walk_frames, sprite->frame_durations, sprite->looping);
+
+    constexpr f32 idle_duration{1.0f};
+    m_animations.AddClip("player.idle", std::span{&m_player.render_data.sprite_rect, 1}, std::span{&idle_duration, 1},
+                         true);
+}
+
+void Scene::DeriveTilemapSprites()
+{
+    if (p_texture_manager == nullptr) {
+        return;
+    }
+
+    const u32 texture_index{m_tilemap.GetTextureIndex()};
+    for (size_t i = 0; i < m_tilemap_sprite_names.size(); ++i) {
+        if (m_tilemap_sprite_names[i].empty()) {
+            continue;
+        }
+        const gouda::vk::Sprite *sprite{
+            p_texture_manager->GetSprite(texture_index, gouda::StringId{m_tilemap_sprite_names[i]})};
+        if (sprite == nullptr || sprite->frames.empty()) {
+            APP_LOG_WARNING("Tilemap sprite '{}' is no longer in texture {}, its tiles are drawn blank.",
+                            m_tilemap_sprite_names[i], texture_index);
+            m_tilemap.SetSprite(static_cast<u16>(i), gouda::UVRect<f32>{});
+            continue;
+        }
+        m_tilemap.SetSprite(static_cast<u16>(i), sprite->frames.front().uv_rect);
+    }
+    m_tilemap_dirty = true;
+}
+
+void Scene::WatchAtlas(gouda::AssetDependentID &dependent, const u32 texture_id, std::function<void()> rederive)
+{
+    if (p_asset_registry == nullptr) {
+        return;
+    }
+    p_asset_registry->RemoveDependent(dependent);
+    dependent = gouda::INVALID_SLOT_HANDLE;
+    if (const gouda::AtlasHandle atlas{p_asset_registry->FindAtlas(texture_id)}; atlas.IsValid()) {
+        dependent = p_asset_registry->AddDependent(std::move(rederive), atlas);
+    }
 }
 void Scene::SetupUI()
 {
@@ -319,51 +789,509 @@ void Scene::SetupUI()
     m_ui_elements.push_back(menu);
 }
 
-void Scene::BuildSpatialGrid()
+void Scene::SetupSystems()
+{
+    // The cameras are updated once per frame by the application, after the ticks, so follows see the moved player
+    m_systems.AddSystem("particles", 0, RESOURCE_PARTICLES,
+                        [this](const f32 delta_time) { UpdateParticles(delta_time); });
+    m_systems.AddSystem("animations", 0, RESOURCE_ENTITIES | RESOURCE_PLAYER,
+                        [this](const f32 delta_time) { UpdateAnimations(delta_time); });
+    m_systems.AddSystem("player", RESOURCE_ENTITIES, RESOURCE_PLAYER | RESOURCE_SPATIAL_INDEX,
+                        [this](const f32 delta_time) { UpdatePlayer(delta_time); });
+    m_systems.AddSystem("collisions", 0, RESOURCE_ENTITIES | RESOURCE_SPATIAL_INDEX,
+                        [this](const f32) { UpdateCollisions(); });
+    m_systems.AddSystem("attachments", 0, RESOURCE_ENTITIES | RESOURCE_SPATIAL_INDEX,
+                        [this](const f32) { UpdateAttachments(); });
+    m_systems.AddSystem("visibility", RESOURCE_SCENE_CAMERA | RESOURCE_PLAYER | RESOURCE_ENTITIES,
+                        RESOURCE_SPATIAL_INDEX | RESOURCE_VISIBLE_INSTANCES,
+                        [this](const f32) { UpdateVisibleInstances(); });
+    // The audio manager asks a few times a second, so every third tick answers soon enough
+    m_systems.AddSystem("audio occlusion", RESOURCE_ENTITIES, RESOURCE_SPATIAL_INDEX,
+                        [this](const f32) { UpdateAudioOcclusion(); }, 3);
+}
+
+void Scene::SetupRenderGraph()
 {
-    m_spatial_grid.clear();
-    static constexpr f32 cell_size{500.0f};
+    using TaskThread = gouda::FrameGraph::TaskThread;
 
-    for (size_t i = 0; i < m_entities.size(); ++i) {
-        const auto &entity = m_entities[i];
-        Rect bounds{entity.render_data.position.x, entity.render_data.position.x + entity.render_data.size.x,
-                    entity.render_data.position.y, entity.render_data.position.y + entity.render_data.size.y};
+    // The instances hold the positions of the last update, they are drawn part way there from the one before
+    const auto interpolate{m_render_graph.AddTask("Interpolate instances", [this] {
+        const f32 factor{m_render_frame.interpolation_factor};
+        for (size_t i = 0; i < m_visible_entities.size(); ++i) {
+            m_visible_quad_instances[i].position = m_entities.GetInterpolatedPosition(m_visible_entities[i], factor);
+        }
+        if (m_player_instance_index) {
+            const gouda::Vec3 &previous{m_player.previous_position};
+            m_visible_quad_instances[*m_player_instance_index].position =
+                previous + (m_player.render_data.position - previous) * factor;
+        }
+    })};
+
+    // Parallax offsets follow the camera as drawn, culling them with the entities would lag it by an update
+    const auto parallax{m_render_graph.AddTask("Parallax layers", [this] {
+        m_parallax_instances.clear();
+        if (!m_parallax_layers.IsEmpty()) {
+            m_parallax_layers.CollectVisible(p_scene_camera->GetFrustumData(), m_parallax_instances);
+        }
+    })};
+
+    // Text is laid out through the renderer's glyph cache, so it stays on the main thread beside the workers
+    const auto ui{m_render_graph.AddTask(
+        "Scene text and UI",
+        [this] {
+            m_ui_instances.clear();
+            DrawUIInstances(*m_render_frame.renderer, m_ui_instances);
+        },
+        {}, TaskThread::Main)};
+
+    const auto particles{m_render_graph.AddTask("Particle instances", [this] {
+        if (!m_render_frame.use_compute_particles) {
+            SpawnPendingParticles();
+        }
+        m_particles.WriteRenderData(m_particles_instances);
+    })};
+
+    m_render_graph.AddTask(
+        "Renderer uploads",
+        [this] {
+            gouda::vk::Renderer &renderer{*m_render_frame.renderer};
+
+            // Looping entity animations run in the quad vertex shader, the tables only change with the clips
+            if (m_animation_tables_version != m_animations.GetVersion()) {
+                gouda::Vector<gouda::AnimationClipData> clips;
+                gouda::Vector<gouda::AnimationFrameData> frames;
+                m_animations.WriteGpuTables(clips, frames);
+                renderer.SetAnimationClips(clips, frames);
+                m_animation_tables_version = m_animations.GetVersion();
+            }
+            renderer.SetAnimationTime(m_animation_time);
+
+            // Tiles are uploaded once, after that the renderer only culls their chunks against the scene camera
+            if (m_tilemap_dirty) {
+                if (m_tilemap.IsEmpty()) {
+                    renderer.ClearTilemap();
+                }
+                else {
+                    renderer.SetTilemap(m_tilemap);
+                }
+                m_tilemap_dirty = false;
+            }
+            if (!m_tilemap.IsEmpty()) {
+                renderer.SetCullFrustum(p_scene_camera->GetFrustumData());
+            }
 
-        auto [min_x, max_x, min_y, max_y] = GetGridRange(bounds, cell_size);
-        for (int x = min_x; x <= max_x; ++x) {
-            for (int y = min_y; y <= max_y; ++y) {
-                m_spatial_grid[GridPos{x, y}].push_back(i);
+            // The entities are the level geometry, compute particles collide with them without the CPU touching a
+            // particle
+            if (m_particle_colliders_dirty) {
+                // Parked pool slots are inside out, they collide with nothing
+                gouda::Vector<gouda::math::AABB2D> colliders;
+                colliders.reserve(m_entities.Size());
+                for (size_t i = 0; i < m_entities.Size(); ++i) {
+                    if (!m_entities.IsParked(i)) {
+                        colliders.push_back(m_entities.GetBounds()[i]);
+                    }
+                }
+                renderer.SetParticleColliders(colliders, SPATIAL_GRID_CELL_SIZE);
+                m_particle_colliders_dirty = false;
             }
+        },
+        {}, TaskThread::Main);
+
+    m_render_graph.AddTask(
+        "Append instances",
+        [this] {
+            FrameDrawList &draw_list{*m_render_frame.draw_list};
+            draw_list.quad_instances.insert(draw_list.quad_instances.end(), m_visible_quad_instances.begin(),
+                                            m_visible_quad_instances.end());
+            draw_list.quad_instances.insert(draw_list.quad_instances.end(), m_parallax_instances.begin(),
+                                            m_parallax_instances.end());
+            draw_list.quad_instances.insert(draw_list.quad_instances.end(), m_ui_instances.begin(),
+                                            m_ui_instances.end());
+            draw_list.particle_instances.insert(draw_list.particle_instances.end(), m_particles_instances.begin(),
+                                                m_particles_instances.end());
+        },
+        {interpolate, parallax, ui, particles});
+}
+
+void Scene::BuildSpatialIndex()
+{
+    // Parked pool slots are inside out, the tree would grow them to the whole plane and visit them on every query
+    gouda::Vector<u32> level_entities;
+    level_entities.reserve(m_entities.Size());
+    for (u32 i = 0; i < m_entities.Size(); ++i) {
+        if (!m_entities.IsParked(i)) {
+            level_entities.push_back(i);
         }
     }
+    m_level_bvh.Build(m_entities.GetBounds(), level_entities);
+    m_spatial_grid.Clear();
+    m_entity_in_grid.assign(m_entities.Size(), 0);
+    m_broadphase.Clear();
+    m_particle_colliders_dirty = true;
+}
+
+bool Scene::IsPooledEntity(const size_t index) const
+{
+    return std::ranges::any_of(m_entity_pools, [index](const EntityPool &pool) { return pool.Owns(index); });
+}
+
+void Scene::QueryEntities(const gouda::math::AABB2D &bounds, gouda::Vector<u32> &entities)
+{
+    // Moved entities still sit in the tree at their load position, the grid has them where they are now
+    const size_t first{entities.size()};
+    m_level_bvh.Query(bounds, entities);
+    const auto moved{std::remove_if(entities.begin() + static_cast<std::ptrdiff_t>(first), entities.end(),
+                                    [&](const u32 entity) { return m_entity_in_grid[entity] != 0; })};
+    entities.erase(moved, entities.end());
+
+    m_spatial_grid.Query(bounds, entities);
 }
 
 void Scene::UpdateVisibleInstances()
 {
     m_visible_quad_instances.clear();
+    m_visible_entities.clear();
+    m_player_instance_index.reset();
     const auto &frustum = p_scene_camera->GetFrustumData();
-    for (const auto &entity : m_entities) {
-        if (IsInFrustum(entity.render_data.position, entity.render_data.size, frustum)) {
-            m_visible_quad_instances.push_back(entity.render_data);
-        }
+    const gouda::math::AABB2D frustum_bounds{{frustum.left + frustum.position.x, frustum.top + frustum.position.y},
+                                             {frustum.right + frustum.position.x, frustum.bottom + frustum.position.y}};
+
+    // Only entities near the view are candidates, sorted so they draw in scene order
+    m_visible_candidates.clear();
+    QueryEntities(frustum_bounds, m_visible_candidates);
+    std::ranges::sort(m_visible_candidates);
+
+    // Candidates are culled in one batch through the SIMD kernels, which hand back only the visible ones
+    const std::span<const gouda::math::AABB2D> entity_bounds{m_entities.GetBounds()};
+    m_visible_candidate_bounds.Clear();
+    for (const u32 candidate : m_visible_candidates) {
+        m_visible_candidate_bounds.PushBack(entity_bounds[candidate]);
+    }
+    m_visible_candidate_hits.clear();
+    gouda::math::intersect_aabbs(m_visible_candidate_bounds, frustum_bounds, m_visible_candidate_hits);
+
+    for (const u32 hit : m_visible_candidate_hits) {
+        m_visible_quad_instances.push_back(m_entities.BuildInstance(m_visible_candidates[hit]));
+        m_visible_entities.push_back(m_visible_candidates[hit]);
+    }
+    if (p_world_streamer) {
+        p_world_streamer->CollectVisible(frustum_bounds, m_visible_quad_instances);
     }
-    if (IsInFrustum(m_player.render_data.position, m_player.render_data.size, frustum)) {
+    if (GetEntityAABB(m_player).Intersects(frustum_bounds)) {
+        m_player_instance_index = m_visible_quad_instances.size();
         m_visible_quad_instances.push_back(m_player.render_data);
     }
 }
 
-void Scene::UpdateParticles(const f32 delta_time)
+void Scene::UpdateAnimations(const f32 delta_time)
 {
-    for (auto it = m_particles_instances.begin(); it != m_particles_instances.end();) {
-        it->velocity += gouda::Vec3{0.0f, constants::gravity, 0.0f} * delta_time;
-        it->position += it->velocity * delta_time;
-        it->lifetime -= delta_time;
-        if (it->lifetime <= 0.0f) {
-            it = m_particles_instances.erase(it);
+    m_animation_time += delta_time;
+    m_animation_delta_time += delta_time;
+    if (++m_animation_update_count < m_animation_interval) {
+        return;
+    }
+
+    const f32 animation_delta_time{m_animation_delta_time};
+    m_animation_update_count = 0;
+    m_animation_delta_time = 0.0f;
+    m_entities.UpdateAnimations(animation_delta_time, m_animation_time, m_animations);
+    if (m_player.animation_component.has_value()) {
+        m_player.animation_component->Update(animation_delta_time, m_animations, m_player.render_data);
+    }
+}
+
+void Scene::UpdateAttachments()
+{
+    if (m_transforms.IsEmpty()) {
+        return;
+    }
+
+    // Only roots whose entities moved mark their subtrees, attachments to static entities cost nothing
+    const std::span<const gouda::Vec3> positions{m_entities.GetPositions()};
+    for (const u32 entity : m_root_transform_entities) {
+        const gouda::math::TransformID transform{m_entity_transforms[entity]};
+        const gouda::math::Transform2D local{m_transforms.GetLocal(transform)};
+        const gouda::Vec2 position{positions[entity].x, positions[entity].y};
+        const f32 rotation{m_entities.GetAppearance(entity).rotation};
+        if (local.position.x != position.x || local.position.y != position.y || local.rotation != rotation) {
+            m_transforms.SetLocal(transform, {position, rotation, local.scale});
+        }
+    }
+    m_transforms.Update();
+
+    for (const gouda::math::TransformID transform : m_transforms.GetUpdated()) {
+        const u32 entity{m_transform_entities[transform]};
+        if (m_transforms.GetParent(transform) == gouda::math::INVALID_TRANSFORM || m_entities.IsParked(entity)) {
+            continue; // Despawned pooled entities stay parked
+        }
+        const gouda::math::Transform2D world{m_transforms.GetWorld(transform)};
+        m_entities.SetRotation(entity, world.rotation);
+        MoveEntity(entity, {world.position.x, world.position.y, positions[entity].z});
+    }
+}
+
+bool Scene::SweepEntities(const gouda::math::AABB2D &bounds, const gouda::Vec2 &displacement,
+                          gouda::math::SweepHit &hit)
+{
+    // Everything the box can touch on the way lies within the bounds of the whole move
+    const gouda::Vec2 moved_min{bounds.min + displacement};
+    const gouda::Vec2 moved_max{bounds.max + displacement};
+    m_nearby_entities.clear();
+    QueryEntities(gouda::math::AABB2D{{std::min(bounds.min.x, moved_min.x), std::min(bounds.min.y, moved_min.y)},
+                                      {std::max(bounds.max.x, moved_max.x), std::max(bounds.max.y, moved_max.y)}},
+                  m_nearby_entities);
+
+    // The earliest time of impact wins
+    bool found{false};
+    const std::span<const gouda::math::AABB2D> entity_bounds{m_entities.GetBounds()};
+    for (const u32 entity_idx : m_nearby_entities) {
+        gouda::math::SweepHit entity_hit{};
+        if (gouda::math::sweep_aabb(bounds, displacement, entity_bounds[entity_idx], entity_hit) &&
+            (!found || entity_hit.time < hit.time)) {
+            hit = entity_hit;
+            found = true;
+        }
+    }
+    return found;
+}
+
+void Scene::UpdatePlayer(const f32 delta_time)
+{
+    // Early exit for no movement
+    if (m_player.velocity.x == 0 && m_player.velocity.y == 0) {
+        return;
+    }
+
+    // The move is swept first so long steps stop at the first surface instead of passing through thin platforms. A
+    // hit clips the motion into the surface and the rest slides along it, so two hits leave nothing to move.
+    const gouda::Vec2 &player_size{m_player.render_data.size};
+    gouda::Vec2 position{m_player.render_data.position.x, m_player.render_data.position.y};
+    gouda::Vec2 displacement{m_player.velocity * delta_time};
+    u32 sweep_hit_count{0};
+    for (u32 i = 0; i < 2 && (displacement.x != 0.0f || displacement.y != 0.0f); ++i) {
+        gouda::math::SweepHit hit{};
+        if (!SweepEntities(gouda::math::AABB2D{position, position + player_size}, displacement, hit)) {
+            position += displacement;
+            break;
+        }
+        ++sweep_hit_count;
+        position += displacement * hit.time + hit.normal * 0.001f;
+        displacement *= 1.0f - hit.time;
+        if (hit.normal.x != 0.0f) {
+            displacement.x = 0.0f;
+            m_player.velocity.x = 0;
         }
         else {
-            it->colour.w = it->lifetime / 5.0f; // Fade over 5s
-            ++it;
+            displacement.y = 0.0f;
+            m_player.velocity.y = 0;
+        }
+    }
+    m_collision_statistics.player_sweep_hit_count = sweep_hit_count;
+
+    // Anything the player started out overlapping is still pushed out of at the end position
+    gouda::Vec3 new_position{position.x, position.y, m_player.render_data.position.z};
+
+    // Player collision bounds
+    Rect<f32> player_bounds{new_position.x, new_position.x + m_player.render_data.size.x, new_position.y,
+                                  new_position.y + m_player.render_data.size.y};
+
+    // Spatial grid query for collision
+    m_nearby_entities.clear();
+    QueryEntities(gouda::math::AABB2D{{player_bounds.left, player_bounds.bottom},
+                                      {player_bounds.right, player_bounds.top}},
+                  m_nearby_entities);
+
+    // The grid's candidates are filtered in one batch, only entities the player touches are left to resolve
+    const std::span<const gouda::math::AABB2D> entity_bounds{m_entities.GetBounds()};
+    m_nearby_bounds.Clear();
+    for (const u32 entity_idx : m_nearby_entities) {
+        m_nearby_bounds.PushBack(entity_bounds[entity_idx]);
+    }
+    m_nearby_hits.clear();
+    gouda::math::intersect_aabbs(m_nearby_bounds,
+                                 gouda::math::AABB2D{{player_bounds.left, player_bounds.bottom},
+                                                     {player_bounds.right, player_bounds.top}},
+                                 m_nearby_hits);
+
+    // Collision detection and resolution, every contact is resolved in turn from where the last one left the player
+    u32 contact_count{0};
+    const std::span<const gouda::Vec3> entity_positions{m_entities.GetPositions()};
+    const std::span<const gouda::Vec2> entity_sizes{m_entities.GetSizes()};
+    for (const u32 hit : m_nearby_hits) {
+        const u32 entity_idx{m_nearby_entities[hit]};
+        const gouda::Vec3 &entity_position{entity_positions[entity_idx]};
+        if (const gouda::Vec2 & entity_size{entity_sizes[entity_idx]};
+            check_collision(new_position, m_player.render_data.size, entity_position, entity_size)) {
+
+            const Rect<f32> entity_bounds{entity_position.x, entity_position.x + entity_size.x, entity_position.y,
+                                          entity_position.y + entity_size.y};
+
+            const Rect<f32> penetration_bounds{
+                player_bounds.right - entity_bounds.left, entity_bounds.right - player_bounds.left,
+                player_bounds.top - entity_bounds.bottom, entity_bounds.top - player_bounds.bottom};
+
+            f32 min_penetration{constants::f32_max};
+            enum class Direction : u8 { None, Left, Right, Bottom, Top } resolve_dir = Direction::None;
+
+            if (penetration_bounds.left > 0 && m_player.velocity.x > 0) {
+                if (penetration_bounds.left < min_penetration) {
+                    min_penetration = penetration_bounds.left;
+                    resolve_dir = Direction::Left;
+                }
+            }
+            if (penetration_bounds.right > 0 && m_player.velocity.x < 0) {
+                if (penetration_bounds.right < min_penetration) {
+                    min_penetration = penetration_bounds.right;
+                    resolve_dir = Direction::Right;
+                }
+            }
+            if (penetration_bounds.bottom > 0 && m_player.velocity.y > 0) {
+                if (penetration_bounds.bottom < min_penetration) {
+                    min_penetration = penetration_bounds.bottom;
+                    resolve_dir = Direction::Bottom;
+                }
+            }
+            if (penetration_bounds.top > 0 && m_player.velocity.y < 0) {
+                if (penetration_bounds.top < min_penetration) {
+                    min_penetration = penetration_bounds.top;
+                    resolve_dir = Direction::Top;
+                }
+            }
+
+            switch (resolve_dir) {
+                case Direction::Left:
+                    new_position.x = entity_bounds.left - m_player.render_data.size.x - 0.001f;
+                    m_player.velocity.x = 0;
+                    break;
+                case Direction::Right:
+                    new_position.x = entity_bounds.right + 0.001f;
+                    m_player.velocity.x = 0;
+                    break;
+                case Direction::Bottom:
+                    new_position.y = entity_bounds.bottom - m_player.render_data.size.y - 0.001f;
+                    m_player.velocity.y = 0;
+                    break;
+                case Direction::Top:
+                    new_position.y = entity_bounds.top + 0.001f;
+                    m_player.velocity.y = 0;
+                    break;
+                case Direction::None:
+                    break;
+            }
+            if (resolve_dir != Direction::None) {
+                ++contact_count;
+                player_bounds = Rect<f32>{new_position.x, new_position.x + m_player.render_data.size.x,
+                                          new_position.y, new_position.y + m_player.render_data.size.y};
+            }
+        }
+    }
+
+    m_player.render_data.position = new_position;
+    m_collision_statistics.player_contact_count = contact_count;
+}
+
+void Scene::UpdateCollisions()
+{
+    // Only entities that have moved can be pushing into each other, the level they load with never overlaps itself
+    m_collision_pairs.clear();
+    m_broadphase.FindPairs(m_collision_pairs);
+
+    u32 contact_count{0};
+    for (const auto &[first, second] : m_collision_pairs) {
+        contact_count += ResolveEntityContact(first, second) ? 1u : 0u;
+    }
+
+    m_collision_statistics.dynamic_body_count = m_broadphase.GetBodyCount();
+    m_collision_statistics.broadphase_pair_count = static_cast<u32>(m_collision_pairs.size());
+    m_collision_statistics.sort_swap_count = m_broadphase.GetLastSwapCount();
+    m_collision_statistics.contact_count = contact_count;
+}
+
+bool Scene::ResolveEntityContact(const u32 first, const u32 second)
+{
+    // The bounds are read again, an earlier contact this tick may have moved either entity
+    const gouda::math::AABB2D &first_bounds{m_entities.GetBounds()[first]};
+    const gouda::math::AABB2D &second_bounds{m_entities.GetBounds()[second]};
+    const f32 overlap_x{std::min(first_bounds.max.x, second_bounds.max.x) -
+                        std::max(first_bounds.min.x, second_bounds.min.x)};
+    const f32 overlap_y{std::min(first_bounds.max.y, second_bounds.max.y) -
+                        std::max(first_bounds.min.y, second_bounds.min.y)};
+    if (overlap_x <= 0.0f || overlap_y <= 0.0f) {
+        return false;
+    }
+
+#ifdef ENGINE_DEBUG_DRAW
+    const gouda::Vec2 contact_min{std::max(first_bounds.min.x, second_bounds.min.x),
+                                  std::max(first_bounds.min.y, second_bounds.min.y)};
+    DEBUG_DRAW_BOX({contact_min, contact_min + gouda::Vec2{overlap_x, overlap_y}}, {1.0f, 0.2f, 0.2f, 1.0f});
+#endif
+
+    // Both are pushed half way out along the shallower axis, away from each other's centre
+    gouda::Vec3 push{0.0f};
+    if (overlap_x < overlap_y) {
+        const bool first_left{first_bounds.min.x + first_bounds.max.x < second_bounds.min.x + second_bounds.max.x};
+        push.x = (first_left ? -0.5f : 0.5f) * overlap_x;
+    }
+    else {
+        const bool first_below{first_bounds.min.y + first_bounds.max.y < second_bounds.min.y + second_bounds.max.y};
+        push.y = (first_below ? -0.5f : 0.5f) * overlap_y;
+    }
+
+    const std::span<const gouda::Vec3> positions{m_entities.GetPositions()};
+    MoveEntity(first, positions[first] + push);
+    MoveEntity(second, positions[second] - push);
+    return true;
+}
+
+void Scene::UpdateParticles(const f32 delta_time)
+{
+    m_particles.Update(delta_time, gouda::Vec3{0.0f, constants::gravity, 0.0f}); // Fades out over the last 5s
+}
+
+void Scene::UpdateAudioOcclusion()
+{
+    // The audio manager posts a batch of its loudest sounds a few times a second, most ticks there is nothing to do
+    gouda::Vec3 listener{0.0f};
+    if (p_audio_manager == nullptr || !p_audio_manager->TakeOcclusionQueries(m_occlusion_queries, listener)) {
+        return;
+    }
+    ENGINE_PROFILE_SCOPE("Audio occlusion");
+
+    const std::span<const gouda::math::AABB2D> bounds{m_entities.GetBounds()};
+    const gouda::Vec2 to{listener.x, listener.y};
+    const auto contains{[](const gouda::math::AABB2D &box, const gouda::Vec2 &point) {
+        return point.x >= box.min.x && point.x <= box.max.x && point.y >= box.min.y && point.y <= box.max.y;
+    }};
+
+    m_occlusion_results.clear();
+    for (const gouda::audio::OcclusionQuery &query : m_occlusion_queries) {
+        const gouda::Vec2 from{query.position.x, query.position.y};
+
+        // The tree is walked along the segment, the grid has no such query so its hits over the segment's bounds are
+        // tested against it
+        m_occluder_candidates.clear();
+        m_level_bvh.QuerySegment(from, to, m_occluder_candidates);
+        const auto moved{std::remove_if(m_occluder_candidates.begin(), m_occluder_candidates.end(),
+                                        [&](const u32 entity) { return m_entity_in_grid[entity] != 0; })};
+        m_occluder_candidates.erase(moved, m_occluder_candidates.end());
+        const size_t first_grid_hit{m_occluder_candidates.size()};
+        m_spatial_grid.Query({{std::min(from.x, to.x), std::min(from.y, to.y)},
+                              {std::max(from.x, to.x), std::max(from.y, to.y)}},
+                             m_occluder_candidates);
+
+        // An entity around either end is the sound's emitter or where the listener stands, not something between
+        u32 occluders{0};
+        for (size_t i = 0; i < m_occluder_candidates.size(); ++i) {
+            const gouda::math::AABB2D &box{bounds[m_occluder_candidates[i]]};
+            if (i >= first_grid_hit && !gouda::math::segment_intersects_aabb(from, to, box)) {
+                continue;
+            }
+            if (!contains(box, from) && !contains(box, to)) {
+                ++occluders;
+            }
         }
+        m_occlusion_results.push_back(
+            {query.voice, std::min(static_cast<f32>(occluders) * OCCLUSION_PER_OCCLUDER, 1.0f)});
     }
+    p_audio_manager->SubmitOcclusionResults(m_occlusion_results);
 }
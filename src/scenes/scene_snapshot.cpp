@@ -0,0 +1,260 @@
+/**
+ * @file scene_snapshot.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Application binary scene snapshot module implementation
+ */
+#include "scenes/scene_snapshot.hpp"
+
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <utility>
+
+#include "debug/logger.hpp"
+#include "debug/profiler.hpp"
+#include "utils/filesystem.hpp"
+#include "utils/lz4.hpp"
+#include "utils/mapped_file.hpp"
+#include "utils/thread.hpp"
+
+constexpr std::array<char, 4> SNAPSHOT_FILE_MAGIC{'G', 'S', 'N', 'P'};
+constexpr u64 SNAPSHOT_BLOCK_ALIGNMENT{16};
+
+enum class SnapshotCompression : u32 { None, LZ4 };
+
+struct SnapshotFileHeader {
+    std::array<char, 4> magic;
+    u32 version;
+    u64 block_count;
+};
+
+struct SnapshotBlockEntry {
+    u32 element_size;
+    u32 compression;
+    u64 count;
+    u64 offset; // From the start of the file
+    u64 stored_size;
+};
+
+static u64 AlignBlockOffset(const u64 offset)
+{
+    return (offset + SNAPSHOT_BLOCK_ALIGNMENT - 1) & ~(SNAPSHOT_BLOCK_ALIGNMENT - 1);
+}
+
+SceneSnapshot::Block &SnapshotCapture::NextBlock()
+{
+    if (m_snapshot.block_count == m_snapshot.blocks.size()) {
+        m_snapshot.blocks.emplace_back();
+    }
+    return m_snapshot.blocks[m_snapshot.block_count++];
+}
+
+const SceneSnapshot::Block *SnapshotRestore::NextBlock(const size_t element_size)
+{
+    if (m_next_block >= m_snapshot.block_count) {
+        m_is_failed = true;
+        return nullptr;
+    }
+
+    const SceneSnapshot::Block &block{m_snapshot.blocks[m_next_block++]};
+    if (block.element_size != element_size) {
+        m_is_failed = true;
+        return nullptr;
+    }
+    return &block;
+}
+
+bool WriteSnapshotFile(const StringView filepath, const SceneSnapshot &snapshot, const bool compress)
+{
+    ENGINE_PROFILE_SCOPE("Write snapshot");
+
+    const size_t block_count{snapshot.block_count};
+    gouda::Vector<SnapshotBlockEntry> entries;
+    entries.resize(block_count);
+
+    std::vector<std::byte> bytes(sizeof(SnapshotFileHeader) + sizeof(SnapshotBlockEntry) * block_count);
+    gouda::Vector<std::byte> compressed;
+    for (size_t i = 0; i < block_count; ++i) {
+        const SceneSnapshot::Block &block{snapshot.blocks[i]};
+        std::span<const std::byte> stored{block.bytes};
+        auto compression{SnapshotCompression::None};
+        if (compress && !block.bytes.empty()) {
+            compressed.resize_uninitialized(gouda::utils::lz4_compress_bound(block.bytes.size()));
+            const size_t compressed_size{gouda::utils::lz4_compress(block.bytes, compressed)};
+            if (compressed_size != 0 && compressed_size <= block.bytes.size() - block.bytes.size() / 8) {
+                stored = std::span<const std::byte>{compressed}.first(compressed_size);
+                compression = SnapshotCompression::LZ4;
+            }
+        }
+
+        const u64 offset{AlignBlockOffset(bytes.size())};
+        entries[i] = SnapshotBlockEntry{block.element_size, static_cast<u32>(compression), block.count, offset,
+                                        stored.size()};
+        bytes.resize(offset + stored.size());
+        if (!stored.empty()) {
+            std::memcpy(bytes.data() + offset, stored.data(), stored.size());
+        }
+    }
+
+    const SnapshotFileHeader header{SNAPSHOT_FILE_MAGIC, SCENE_SNAPSHOT_VERSION, block_count};
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    if (block_count > 0) {
+        std::memcpy(bytes.data() + sizeof(header), entries.data(), sizeof(SnapshotBlockEntry) * block_count);
+    }
+
+    FilePath temporary_filepath{filepath};
+    temporary_filepath += ".tmp";
+    if (const auto result{gouda::fs::WriteBinaryFile(temporary_filepath.string(), bytes)}; !result) {
+        APP_LOG_ERROR("Failed to write snapshot '{}': {}", temporary_filepath.string(),
+                      gouda::fs::error_to_string(result.error()));
+        return false;
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(temporary_filepath, FilePath{filepath}, ec);
+    if (ec) {
+        APP_LOG_ERROR("Failed to replace snapshot '{}': {}", filepath, ec.message());
+        return false;
+    }
+
+    APP_LOG_DEBUG("Wrote snapshot '{}', {} blocks in {} bytes.", filepath, block_count, bytes.size());
+    return true;
+}
+
+bool ReadSnapshotFile(const StringView filepath, SceneSnapshot &snapshot)
+{
+    ENGINE_PROFILE_SCOPE("Read snapshot");
+
+    snapshot.block_count = 0;
+    const auto file{gouda::fs::MappedFile::Open(filepath)};
+    if (!file) {
+        APP_LOG_ERROR("Failed to open snapshot '{}': {}", filepath, gouda::fs::error_to_string(file.error()));
+        return false;
+    }
+
+    const std::span<const std::byte> data{file->GetData()};
+    if (data.size() < sizeof(SnapshotFileHeader)) {
+        APP_LOG_ERROR("Snapshot '{}' is truncated.", filepath);
+        return false;
+    }
+
+    SnapshotFileHeader header;
+    std::memcpy(&header, data.data(), sizeof(header));
+    if (header.magic != SNAPSHOT_FILE_MAGIC) {
+        APP_LOG_ERROR("'{}' is not a snapshot.", filepath);
+        return false;
+    }
+    if (header.version != SCENE_SNAPSHOT_VERSION) {
+        APP_LOG_WARNING("Snapshot '{}' is version {}, expected {}.", filepath, header.version,
+                        SCENE_SNAPSHOT_VERSION);
+        return false;
+    }
+    if (header.block_count > (data.size() - sizeof(header)) / sizeof(SnapshotBlockEntry)) {
+        APP_LOG_ERROR("Snapshot '{}' is truncated.", filepath);
+        return false;
+    }
+
+    const auto block_count{static_cast<size_t>(header.block_count)};
+    if (snapshot.blocks.size() < block_count) {
+        snapshot.blocks.resize(block_count);
+    }
+    for (size_t i = 0; i < block_count; ++i) {
+        SnapshotBlockEntry entry;
+        std::memcpy(&entry, data.data() + sizeof(header) + sizeof(SnapshotBlockEntry) * i, sizeof(entry));
+        if (entry.element_size == 0 || entry.offset > data.size() || entry.stored_size > data.size() - entry.offset ||
+            entry.count > constants::u64_max / entry.element_size) {
+            APP_LOG_ERROR("Snapshot '{}' has a block outside the file.", filepath);
+            return false;
+        }
+
+        SceneSnapshot::Block &block{snapshot.blocks[i]};
+        const std::span<const std::byte> stored{data.subspan(entry.offset, entry.stored_size)};
+        const u64 size{entry.count * entry.element_size};
+        block.element_size = entry.element_size;
+        block.count = entry.count;
+        if (entry.compression == static_cast<u32>(SnapshotCompression::LZ4)) {
+            // A compressed block expands at most 255 times, anything claiming more is corrupt
+            if (size / 255 > stored.size()) {
+                APP_LOG_ERROR("Snapshot '{}' is malformed.", filepath);
+                return false;
+            }
+            block.bytes.resize_uninitialized(size);
+            if (!gouda::utils::lz4_decompress(stored, block.bytes)) {
+                APP_LOG_ERROR("Snapshot '{}' has a corrupt block.", filepath);
+                return false;
+            }
+        }
+        else if (entry.compression == static_cast<u32>(SnapshotCompression::None) && stored.size() == size) {
+            block.bytes.resize_uninitialized(size);
+            if (size > 0) {
+                std::memcpy(block.bytes.data(), stored.data(), size);
+            }
+        }
+        else {
+            APP_LOG_ERROR("Snapshot '{}' is malformed.", filepath);
+            return false;
+        }
+    }
+
+    snapshot.block_count = block_count;
+    return true;
+}
+
+SnapshotWriter::SnapshotWriter()
+    : m_jobs{},
+      m_is_writing{false},
+      m_spare{},
+      m_thread{gouda::MakeThread("Snapshot writer", gouda::ThreadPriority::IO,
+                                 [this](const std::stop_token &stop_token) { Run(stop_token); })}
+{
+}
+
+SnapshotWriter::~SnapshotWriter()
+{
+    Wait();
+    m_thread.request_stop();
+    m_thread.join();
+}
+
+void SnapshotWriter::Queue(String filepath, SceneSnapshot &snapshot, const bool compress)
+{
+    {
+        std::lock_guard lock{m_mutex};
+        Job &job{m_jobs.emplace_back(Job{std::move(filepath), {}, compress})};
+        std::swap(job.snapshot, snapshot);
+        std::swap(snapshot, m_spare);
+    }
+    m_condition.notify_all();
+}
+
+void SnapshotWriter::Wait()
+{
+    std::unique_lock lock{m_mutex};
+    m_condition.wait(lock, [this] { return m_jobs.empty() && !m_is_writing; });
+}
+
+void SnapshotWriter::Run(const std::stop_token &stop_token)
+{
+    while (true) {
+        Job job;
+        {
+            std::unique_lock lock{m_mutex};
+            if (!m_condition.wait(lock, stop_token, [this] { return !m_jobs.empty(); })) {
+                return;
+            }
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+            m_is_writing = true;
+        }
+
+        WriteSnapshotFile(job.filepath, job.snapshot, job.compress);
+
+        {
+            std::lock_guard lock{m_mutex};
+            std::swap(m_spare, job.snapshot);
+            m_is_writing = false;
+        }
+        m_condition.notify_all();
+    }
+}
@@ -0,0 +1,374 @@
+/**
+ * @file world_streamer.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Application world chunk streaming module implementation
+ */
+#include "scenes/world_streamer.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <filesystem>
+#include <format>
+
+#include "debug/logger.hpp"
+#include "math/math.hpp"
+#include "utils/filesystem.hpp"
+
+#include "scenes/level_file.hpp"
+
+constexpr StringView CHUNK_FILE_PREFIX{"chunk_"};
+constexpr StringView CHUNK_FILE_EXTENSION{".glvl"};
+constexpr f32 CAMERA_VELOCITY_SMOOTHING{0.2f}; // Weight of the latest frame, damps jitter in the lookahead
+
+static u64 PackChunkKey(const s32 x, const s32 y)
+{
+    return (u64{static_cast<u32>(x)} << 32) | u64{static_cast<u32>(y)};
+}
+
+static String GetChunkFilename(const s32 x, const s32 y)
+{
+    return std::format("{}{}_{}{}", CHUNK_FILE_PREFIX, x, y, CHUNK_FILE_EXTENSION);
+}
+
+// Reads the coordinates back out of a name written by GetChunkFilename
+static bool ParseChunkFilename(const StringView filename, s32 &x, s32 &y)
+{
+    if (!filename.starts_with(CHUNK_FILE_PREFIX) || !filename.ends_with(CHUNK_FILE_EXTENSION)) {
+        return false;
+    }
+
+    const char *begin{filename.data() + CHUNK_FILE_PREFIX.size()};
+    const char *end{filename.data() + filename.size() - CHUNK_FILE_EXTENSION.size()};
+    const auto [x_end, x_error] = std::from_chars(begin, end, x);
+    if (x_error != std::errc{} || x_end == end || *x_end != '_') {
+        return false;
+    }
+    const auto [y_end, y_error] = std::from_chars(x_end + 1, end, y);
+    return y_error == std::errc{} && y_end == end;
+}
+
+static gouda::math::AABB2D GetChunkCell(const s32 x, const s32 y, const f32 chunk_size)
+{
+    const gouda::Vec2 min{static_cast<f32>(x) * chunk_size, static_cast<f32>(y) * chunk_size};
+    return {min, gouda::Vec2{min.x + chunk_size, min.y + chunk_size}};
+}
+
+static f32 GetDistanceSquared(const gouda::math::AABB2D &bounds, const gouda::Vec2 &point)
+{
+    const f32 dx{gouda::math::max(gouda::math::max(bounds.min.x - point.x, point.x - bounds.max.x), 0.0f)};
+    const f32 dy{gouda::math::max(gouda::math::max(bounds.min.y - point.y, point.y - bounds.max.y), 0.0f)};
+    return dx * dx + dy * dy;
+}
+
+bool SaveWorldChunks(const StringView directory, const EntityStore &entities,
+                     const std::span<const String> texture_paths, const f32 chunk_size)
+{
+    if (const auto result{gouda::fs::EnsureDirectoryExists(FilePath{directory}, true)}; !result) {
+        APP_LOG_ERROR("Failed to create world directory '{}': {}", directory,
+                      gouda::fs::error_to_string(result.error()));
+        return false;
+    }
+
+    // Stale chunks from an earlier save would otherwise be indexed along with the new ones
+    std::error_code error;
+    for (const auto &entry : std::filesystem::directory_iterator{FilePath{directory}, error}) {
+        s32 x{0};
+        s32 y{0};
+        if (ParseChunkFilename(entry.path().filename().string(), x, y)) {
+            std::filesystem::remove(entry.path(), error);
+        }
+    }
+
+    std::unordered_map<u64, gouda::Vector<size_t>> chunk_entities;
+    const std::span<const gouda::Vec3> positions{entities.GetPositions()};
+    for (size_t i = 0; i < entities.Size(); ++i) {
+        const s32 x{gouda::math::floor(positions[i].x / chunk_size)};
+        const s32 y{gouda::math::floor(positions[i].y / chunk_size)};
+        chunk_entities[PackChunkKey(x, y)].push_back(i);
+    }
+
+    const FilePath directory_path{directory};
+    for (const auto &[key, indices] : chunk_entities) {
+        // Texture indices are rewritten to index the chunk's own list, holding only what the chunk draws
+        EntityStore chunk;
+        chunk.Reserve(indices.size());
+        gouda::Vector<String> chunk_textures;
+        for (const size_t index : indices) {
+            Entity entity{entities.BuildEntity(index)};
+            u32 &texture_index{entity.render_data.texture_index};
+            const String &path{texture_index < texture_paths.size() ? texture_paths[texture_index] : String{}};
+            const auto found{std::ranges::find(chunk_textures, path)};
+            texture_index = static_cast<u32>(found - chunk_textures.begin());
+            if (found == chunk_textures.end()) {
+                chunk_textures.push_back(path);
+            }
+            chunk.Add(entity);
+        }
+
+        gouda::math::BoundingVolumeHierarchy tree;
+        tree.Build(chunk.GetBounds());
+
+        const auto x{static_cast<s32>(static_cast<u32>(key >> 32))};
+        const auto y{static_cast<s32>(static_cast<u32>(key))};
+        const String filepath{(directory_path / GetChunkFilename(x, y)).string()};
+        if (!SaveLevelFile(filepath, chunk, tree, chunk_textures)) {
+            return false;
+        }
+    }
+
+    APP_LOG_INFO("Saved {} entities as {} world chunks to '{}'.", entities.Size(), chunk_entities.size(), directory);
+    return true;
+}
+
+// WorldStreamer ---------------------------------------------------------------------------------------
+WorldStreamer::WorldStreamer(const StringView directory, const WorldStreamingSettings &settings,
+                             gouda::JobSystem *job_system, gouda::vk::TextureManager *texture_manager)
+    : m_settings{settings},
+      p_job_system{job_system},
+      p_texture_manager{texture_manager},
+      m_last_camera_position{0.0f},
+      m_camera_velocity{0.0f},
+      m_has_camera_position{false},
+      m_frame{0},
+      m_resident_count{0},
+      m_resident_bytes{0},
+      m_loads_in_flight{0}
+{
+    IndexChunks(directory);
+}
+
+WorldStreamer::~WorldStreamer()
+{
+    // Load jobs write into their chunk, so none may outlive it
+    for (auto &[key, chunk] : m_chunks) {
+        if (chunk.state == ChunkState::Loading && p_job_system != nullptr) {
+            p_job_system->Wait(*chunk.p_counter);
+        }
+    }
+}
+
+void WorldStreamer::Update(const gouda::OrthographicCamera &camera, const f32 delta_time)
+{
+    ++m_frame;
+
+    for (auto &[key, chunk] : m_chunks) {
+        if (chunk.state == ChunkState::Loading && chunk.p_counter->IsDone()) {
+            FinishLoad(chunk);
+        }
+    }
+
+    const gouda::math::AABB2D area{GetStreamingArea(camera, delta_time)};
+    const gouda::Vec2 centre{camera.GetPosition().x, camera.GetPosition().y};
+
+    // Only chunk files that exist are candidates, so the area is walked cell by cell rather than probing the disk
+    const s32 min_x{gouda::math::floor(area.min.x / m_settings.chunk_size)};
+    const s32 max_x{gouda::math::floor(area.max.x / m_settings.chunk_size)};
+    const s32 min_y{gouda::math::floor(area.min.y / m_settings.chunk_size)};
+    const s32 max_y{gouda::math::floor(area.max.y / m_settings.chunk_size)};
+    m_load_order.clear();
+    for (s32 y = min_y; y <= max_y; ++y) {
+        for (s32 x = min_x; x <= max_x; ++x) {
+            const auto found{m_chunks.find(PackChunkKey(x, y))};
+            if (found == m_chunks.end()) {
+                continue;
+            }
+            found->second.last_wanted_frame = m_frame;
+            if (found->second.state == ChunkState::Unloaded) {
+                m_load_order.push_back(&found->second);
+            }
+        }
+    }
+
+    std::ranges::sort(m_load_order, [&](const Chunk *a, const Chunk *b) {
+        return GetDistanceSquared(GetChunkCell(a->x, a->y, m_settings.chunk_size), centre) <
+               GetDistanceSquared(GetChunkCell(b->x, b->y, m_settings.chunk_size), centre);
+    });
+    for (Chunk *chunk : m_load_order) {
+        if (m_loads_in_flight >= m_settings.max_concurrent_loads) {
+            break;
+        }
+        StartLoad(*chunk);
+    }
+
+    if (m_resident_bytes <= m_settings.memory_budget) {
+        return;
+    }
+
+    // Over budget, cached chunks outside the area go farthest first. Wanted chunks stay even past the budget, dropping
+    // them would only reload them next frame.
+    m_load_order.clear();
+    for (auto &[key, chunk] : m_chunks) {
+        if (chunk.state == ChunkState::Resident && chunk.last_wanted_frame != m_frame) {
+            m_load_order.push_back(&chunk);
+        }
+    }
+    std::ranges::sort(m_load_order, [&](const Chunk *a, const Chunk *b) {
+        return GetDistanceSquared(a->bounds, centre) > GetDistanceSquared(b->bounds, centre);
+    });
+    for (Chunk *chunk : m_load_order) {
+        if (m_resident_bytes <= m_settings.memory_budget) {
+            break;
+        }
+        Evict(*chunk);
+    }
+}
+
+void WorldStreamer::CollectVisible(const gouda::math::AABB2D &bounds, std::vector<gouda::InstanceData> &instances)
+{
+    const gouda::math::AABB2D view{{gouda::math::min(bounds.min.x, bounds.max.x),
+                                    gouda::math::min(bounds.min.y, bounds.max.y)},
+                                   {gouda::math::max(bounds.min.x, bounds.max.x),
+                                    gouda::math::max(bounds.min.y, bounds.max.y)}};
+
+    for (auto &[key, chunk] : m_chunks) {
+        if (chunk.state != ChunkState::Resident || !chunk.bounds.Intersects(view)) {
+            continue;
+        }
+
+        m_query_results.clear();
+        chunk.p_data->tree.Query(view, m_query_results);
+        std::ranges::sort(m_query_results); // Draw in the order the chunk was saved in
+
+        const EntityStore &entities{chunk.p_data->entities};
+        for (const u32 entity : m_query_results) {
+            gouda::InstanceData instance{entities.BuildInstance(entity)};
+            const u32 texture_index{instance.texture_index};
+            instance.texture_index = texture_index < chunk.texture_ids.size() ? chunk.texture_ids[texture_index] : 0;
+            instances.push_back(instance);
+        }
+    }
+}
+
+void WorldStreamer::IndexChunks(const StringView directory)
+{
+    std::error_code error;
+    for (const auto &entry : std::filesystem::directory_iterator{FilePath{directory}, error}) {
+        s32 x{0};
+        s32 y{0};
+        if (!entry.is_regular_file(error) || !ParseChunkFilename(entry.path().filename().string(), x, y)) {
+            continue;
+        }
+
+        const u64 size_bytes{entry.file_size(error)};
+        m_chunks.emplace(PackChunkKey(x, y), Chunk{.filepath = entry.path().string(),
+                                                   .x = x,
+                                                   .y = y,
+                                                   .state = ChunkState::Unloaded,
+                                                   .size_bytes = size_bytes,
+                                                   .bounds = GetChunkCell(x, y, m_settings.chunk_size),
+                                                   .p_data = nullptr,
+                                                   .p_counter = nullptr,
+                                                   .texture_ids = {},
+                                                   .last_wanted_frame = 0});
+    }
+
+    if (error) {
+        APP_LOG_ERROR("Failed to read world directory '{}': {}", directory, error.message());
+    }
+    APP_LOG_DEBUG("Indexed {} world chunks in '{}'.", m_chunks.size(), directory);
+}
+
+void WorldStreamer::StartLoad(Chunk &chunk)
+{
+    chunk.state = ChunkState::Loading;
+    chunk.p_data = std::make_unique<ChunkData>();
+    chunk.p_counter = std::make_unique<gouda::JobCounter>();
+    ++m_loads_in_flight;
+
+    // The job only touches the chunk's own data, which the main thread leaves alone until the counter is done
+    ChunkData *data{chunk.p_data.get()};
+    auto load = [data, filepath = chunk.filepath] {
+        data->is_loaded = LoadLevelFile(filepath, data->entities, data->tree, &data->texture_paths);
+    };
+
+    if (p_job_system == nullptr || p_job_system->GetWorkerCount() == 0) {
+        load();
+        FinishLoad(chunk);
+        return;
+    }
+    p_job_system->Schedule(std::move(load), chunk.p_counter.get());
+}
+
+void WorldStreamer::FinishLoad(Chunk &chunk)
+{
+    --m_loads_in_flight;
+    if (p_job_system != nullptr) {
+        p_job_system->Wait(*chunk.p_counter); // Returns at once, but the job may still be releasing the counter
+    }
+    chunk.p_counter.reset();
+
+    if (!chunk.p_data->is_loaded) {
+        chunk.p_data.reset();
+        chunk.state = ChunkState::Failed; // Retrying would fail again every frame the chunk is wanted
+        return;
+    }
+
+    // Entities may overhang their cell, culling tests the chunk against what it actually covers
+    const std::span<const gouda::math::AABB2D> entity_bounds{chunk.p_data->entities.GetBounds()};
+    chunk.bounds = GetChunkCell(chunk.x, chunk.y, m_settings.chunk_size);
+    for (const gouda::math::AABB2D &bounds : entity_bounds) {
+        chunk.bounds.min = {gouda::math::min(chunk.bounds.min.x, bounds.min.x),
+                            gouda::math::min(chunk.bounds.min.y, bounds.min.y)};
+        chunk.bounds.max = {gouda::math::max(chunk.bounds.max.x, bounds.max.x),
+                            gouda::math::max(chunk.bounds.max.y, bounds.max.y)};
+    }
+
+    chunk.texture_ids.clear();
+    for (const String &path : chunk.p_data->texture_paths) {
+        chunk.texture_ids.push_back(GetTextureID(path));
+    }
+
+    chunk.state = ChunkState::Resident;
+    ++m_resident_count;
+    m_resident_bytes += chunk.size_bytes;
+}
+
+void WorldStreamer::Evict(Chunk &chunk)
+{
+    chunk.p_data.reset();
+    chunk.texture_ids.clear();
+    chunk.state = ChunkState::Unloaded;
+    --m_resident_count;
+    m_resident_bytes -= chunk.size_bytes;
+}
+
+gouda::math::AABB2D WorldStreamer::GetStreamingArea(const gouda::OrthographicCamera &camera, const f32 delta_time)
+{
+    const gouda::Vec3 position{camera.GetPosition()};
+    if (m_has_camera_position && delta_time > 0.0f) {
+        const gouda::Vec2 frame_velocity{(position.x - m_last_camera_position.x) / delta_time,
+                                         (position.y - m_last_camera_position.y) / delta_time};
+        m_camera_velocity = m_camera_velocity * (1.0f - CAMERA_VELOCITY_SMOOTHING) +
+                            frame_velocity * CAMERA_VELOCITY_SMOOTHING;
+    }
+    m_last_camera_position = position;
+    m_has_camera_position = true;
+
+    // Same bounds the scene culls with, grown by the prefetch margin and then swept along the motion
+    const auto frustum{camera.GetFrustumData()};
+    const f32 margin{m_settings.prefetch_distance};
+    gouda::math::AABB2D area{
+        {position.x + gouda::math::min(frustum.left, frustum.right) - margin,
+         position.y + gouda::math::min(frustum.bottom, frustum.top) - margin},
+        {position.x + gouda::math::max(frustum.left, frustum.right) + margin,
+         position.y + gouda::math::max(frustum.bottom, frustum.top) + margin}};
+
+    const gouda::Vec2 lookahead{m_camera_velocity * m_settings.lookahead_time};
+    area.min = {area.min.x + gouda::math::min(lookahead.x, 0.0f), area.min.y + gouda::math::min(lookahead.y, 0.0f)};
+    area.max = {area.max.x + gouda::math::max(lookahead.x, 0.0f), area.max.y + gouda::math::max(lookahead.y, 0.0f)};
+    return area;
+}
+
+u32 WorldStreamer::GetTextureID(const String &filepath)
+{
+    if (filepath.empty() || p_texture_manager == nullptr) {
+        return 0; // The default texture
+    }
+
+    const auto [found, is_new] = m_texture_ids.try_emplace(filepath, 0);
+    if (is_new) {
+        found->second = p_texture_manager->LoadSingleTextureAsync(filepath);
+    }
+    return found->second;
+}
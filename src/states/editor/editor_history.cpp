@@ -0,0 +1,145 @@
+/**
+ * @file states/editor/editor_history.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Application editor undo history module implementation
+ */
+#include "states/editor_history.hpp"
+
+#include <algorithm>
+
+EditorHistory::EditorHistory(const size_t memory_budget)
+    : m_applied{0},
+      m_memory_budget{memory_budget},
+      m_memory_used{0},
+      m_merge_key{0},
+      m_merge_cursor{0},
+      m_is_recording{false},
+      m_is_command_open{false},
+      m_is_extending{false},
+      m_can_merge{false}
+{
+}
+
+void EditorHistory::BeginCommand(const u64 merge_key)
+{
+    m_merge_key = merge_key;
+    m_is_recording = true;
+}
+
+void EditorHistory::EndCommand()
+{
+    if (m_is_command_open) {
+        m_memory_used += GetCommandMemory(m_commands.back());
+        EnforceBudget();
+        m_can_merge = true;
+    }
+
+    m_is_recording = false;
+    m_is_command_open = false;
+    m_is_extending = false;
+}
+
+void EditorHistory::Record(const EntityEdit &edit)
+{
+    if (!m_is_recording) {
+        BeginCommand();
+        Record(edit);
+        EndCommand();
+        return;
+    }
+
+    // The command is only created by its first edit, so beginning one and recording nothing leaves no empty step
+    if (!m_is_command_open) {
+        DropRedo();
+        m_is_extending = m_merge_key != 0 && m_can_merge && !m_commands.empty() &&
+                         m_commands.back().merge_key == m_merge_key;
+        if (m_is_extending) {
+            m_memory_used -= GetCommandMemory(m_commands.back()); // Counted again once it ends
+            m_merge_cursor = 0;
+        }
+        else {
+            m_commands.push_back(Command{{}, m_merge_key});
+            ++m_applied;
+        }
+        m_is_command_open = true;
+    }
+
+    gouda::Vector<EntityEdit> &edits{m_commands.back().edits};
+    if (!m_is_extending) {
+        edits.push_back(edit);
+        return;
+    }
+
+    // Each frame of a drag records the same fields in the same order, so the next one expected is tried first
+    const auto matches{[&edit](const EntityEdit &other) {
+        return other.entity == edit.entity && other.field == edit.field;
+    }};
+    size_t match{m_merge_cursor};
+    if (match >= edits.size() || !matches(edits[match])) {
+        match = static_cast<size_t>(std::ranges::find_if(edits, matches) - edits.begin());
+    }
+
+    if (match == edits.size()) {
+        edits.push_back(edit);
+    }
+    else {
+        edits[match].after = edit.after; // The before value stays the one from when the command began
+    }
+    m_merge_cursor = match + 1;
+}
+
+std::span<const EntityEdit> EditorHistory::Undo()
+{
+    if (m_is_recording || !CanUndo()) {
+        return {};
+    }
+
+    m_can_merge = false;
+    --m_applied;
+    return m_commands[m_applied].edits;
+}
+
+std::span<const EntityEdit> EditorHistory::Redo()
+{
+    if (m_is_recording || !CanRedo()) {
+        return {};
+    }
+
+    m_can_merge = false;
+    ++m_applied;
+    return m_commands[m_applied - 1].edits;
+}
+
+void EditorHistory::Clear()
+{
+    m_commands.clear();
+    m_applied = 0;
+    m_memory_used = 0;
+    m_is_recording = false;
+    m_is_command_open = false;
+    m_is_extending = false;
+    m_can_merge = false;
+}
+
+size_t EditorHistory::GetCommandMemory(const Command &command)
+{
+    return sizeof(Command) + command.edits.capacity() * sizeof(EntityEdit);
+}
+
+void EditorHistory::DropRedo()
+{
+    while (m_commands.size() > m_applied) {
+        m_memory_used -= GetCommandMemory(m_commands.back());
+        m_commands.pop_back();
+    }
+}
+
+void EditorHistory::EnforceBudget()
+{
+    while (m_memory_used > m_memory_budget && m_commands.size() > 1) {
+        m_memory_used -= GetCommandMemory(m_commands.front());
+        m_commands.pop_front();
+        --m_applied;
+    }
+}
@@ -6,15 +6,59 @@
  */
 #include "states/editor_state.hpp"
 
+#include <array>
+#include <bit>
+#include <format>
+#include <ranges>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
 #include <nlohmann/json.hpp>
 
 #include "debug/logger.hpp"
+#include "debug/profiler.hpp"
 #include "ui/editor_popups.hpp"
 
+// Scene files hold {"generation": n, "entities": [...]}. Their journal holds one record per line, the entity at
+// "index" as it was saved, tagged with the generation of the scene file it amends.
+static String GetJournalPath(StringView scene_file_path) { return String{scene_file_path} + ".journal"; }
+
+// Throws nlohmann::json exceptions for missing or mistyped fields
+static void ParseEntity(const nlohmann::json &entity_data, gouda::InstanceData &instance, EntityType &type)
+{
+    const auto position{entity_data.at("position").get<std::array<f32, 3>>()};
+    const auto size{entity_data.at("size").get<std::array<f32, 2>>()};
+    const auto colour{entity_data.value("colour", std::array<f32, 4>{1.0f, 1.0f, 1.0f, 1.0f})};
+
+    instance = gouda::InstanceData{{position[0], position[1], position[2]},
+                                   {size[0], size[1]},
+                                   entity_data.value("rotation", 0.0f),
+                                   entity_data.value("texture_index", 0u),
+                                   gouda::Colour<f32>{colour[0], colour[1], colour[2], colour[3]}};
+    type = static_cast<EntityType>(entity_data.value("type", u8{0}));
+}
+
+static nlohmann::json EntityToJSON(const EntityStore &entities, const size_t index)
+{
+    const gouda::Vec3 &position{entities.GetPositions()[index]};
+    const gouda::Vec2 &size{entities.GetSizes()[index]};
+    const EntityAppearance &appearance{entities.GetAppearance(index)};
+    const gouda::Colour<f32> &colour{appearance.colour};
+
+    return {{"type", static_cast<u8>(entities.GetType(index))},
+            {"position", {position.x, position.y, position.z}},
+            {"size", {size.x, size.y}},
+            {"rotation", appearance.rotation},
+            {"texture_index", appearance.texture_index},
+            {"colour", {colour.r, colour.g, colour.b, colour.a}}};
+}
+
 // TODO: Sort constructor ordering for panels/menus to be similar as possible.
 EditorState::EditorState(SharedContext &context, StateStack &state_stack)
     : State(context, state_stack, "EditorState"),
     p_current_scene{nullptr},
+    p_scene_load{nullptr},
     m_top_menu{context,
                  28.0f,
                  colours::editor_panel_colour,
@@ -30,16 +74,17 @@ EditorState::EditorState(SharedContext &context, StateStack &state_stack)
                    1,
                    colours::editor_panel_primary_font_colour,
                    50.0F},
-      m_debug_panel{context, {250.0f, 250.0f}, colours::debug_panel_colour, 1, 20.0f},
+      m_debug_panel{context, {250.0f, 380.0f}, colours::debug_panel_colour, 1, 20.0f},
+      m_drag_mouse_position{0.0f, 0.0f},
+      m_drag_count{0},
       m_ui_manager{context},
       m_auto_save{false},
+      m_auto_save_elapsed{0.0f},
       m_scene_modified{true},
       m_exit_requested{false},
-      m_show_entity_popups{true}
+      m_show_entity_popups{true},
+      m_show_grid{true}
 {
-    m_quad_instances.reserve(app_constants::max_quads);
-    m_text_instances.reserve(app_constants::max_glyphs);
-
     // TODO: Load Editor settings
 
     LoadScene("new_scene.json");
@@ -48,92 +93,197 @@ EditorState::EditorState(SharedContext &context, StateStack &state_stack)
     m_debug_panel.instance.position.y -= m_top_menu.GetSize().y;
 }
 
+EditorState::~EditorState()
+{
+    // The load job writes into the load, so it may not outlive it
+    if (p_scene_load && m_context.job_system != nullptr) {
+        m_context.job_system->Wait(p_scene_load->counter);
+    }
+}
+
+void EditorState::EditorScene::EditEntity(const size_t index, const EntityField field, const std::array<f32, 4> &value)
+{
+    history.Record(EntityEdit{static_cast<u32>(index), field, GetEntityField(index, field), value});
+    ApplyEntityField(index, field, value);
+}
+
+void EditorState::EditorScene::ApplyEntityField(const size_t index, const EntityField field,
+                                                const std::array<f32, 4> &value)
+{
+    switch (field) {
+        case EntityField::Position:
+            editor_entities.SetPosition(index, {value[0], value[1], value[2]});
+            break;
+        case EntityField::Size:
+            editor_entities.SetSize(index, {value[0], value[1]});
+            break;
+        case EntityField::TextureIndex:
+            editor_entities.SetTextureIndex(index, std::bit_cast<u32>(value[0]));
+            break;
+        case EntityField::Colour:
+            editor_entities.SetColour(index, {value[0], value[1], value[2], value[3]});
+            break;
+    }
+
+    if (!entity_tree_dirty && (field == EntityField::Position || field == EntityField::Size)) {
+        MarkEntityMoved(index);
+    }
+    scene_changed = true;
+    MarkEntityDirty(index);
+}
+
+std::array<f32, 4> EditorState::EditorScene::GetEntityField(const size_t index, const EntityField field) const
+{
+    switch (field) {
+        case EntityField::Position: {
+            const gouda::Vec3 &position{editor_entities.GetPositions()[index]};
+            return {position.x, position.y, position.z, 0.0f};
+        }
+        case EntityField::Size: {
+            const gouda::Vec2 &size{editor_entities.GetSizes()[index]};
+            return {size.x, size.y, 0.0f, 0.0f};
+        }
+        case EntityField::TextureIndex:
+            return {std::bit_cast<f32>(editor_entities.GetAppearance(index).texture_index), 0.0f, 0.0f, 0.0f};
+        case EntityField::Colour: {
+            const gouda::Colour<f32> &colour{editor_entities.GetAppearance(index).colour};
+            return {colour.r, colour.g, colour.b, colour.a};
+        }
+    }
+    return {};
+}
+
 void EditorState::HandleInput()
 {
 
     // TODO: Move this into buttons. But do we keep keys too?
     if (m_exit_requested) {
-        if (m_context.input_handler->IsKeyPressed(gouda::Key::Y)) {
+        if (WasActionPressed(EditorAction::ConfirmExit)) {
             // Confirm exit
             m_context.window->Close();
         }
-        else if (m_context.input_handler->IsKeyPressed(gouda::Key::N)) {
+        else if (WasActionPressed(EditorAction::CancelExit)) {
             // Cancel exit
             m_exit_requested = false;
         }
         return; // Exit early to prevent other input from being processed
     }
 
-    static std::unordered_map<gouda::Key, bool> key_was_pressed;
-
-    auto handle_toggle = [&](const gouda::Key key, auto &&action) {
-        const bool is_pressed{m_context.input_handler->IsKeyPressed(key)};
-        bool &was_pressed{key_was_pressed[key]};
+    if (WasActionPressed(EditorAction::ToggleSidePanel)) {
+        m_side_panel.ToggleVisibility();
+    }
+    if (WasActionPressed(EditorAction::ToggleEntityPopups)) {
+        ToggleSelectedEntityPopups();
+    }
+    if (WasActionPressed(EditorAction::ToggleDebugPanel)) {
+        m_debug_panel.ToggleVisibility();
+    }
+    if (WasActionPressed(EditorAction::ToggleDebugUI)) {
+        m_context.renderer->ToggleDebugUI();
+    }
+    if (WasActionPressed(EditorAction::ToggleGrid)) {
+        m_show_grid = !m_show_grid;
+    }
+    if (WasActionPressed(EditorAction::ToggleCsvCapture)) {
+        m_debug_panel.ToggleCsvCapture();
+    }
+    if (WasActionPressed(EditorAction::ToggleProfilerFreeze)) {
+        ENGINE_PROFILE_TOGGLE_FREEZE();
+    }
+    if (WasActionPressed(EditorAction::CaptureProfilerFrame)) {
+        ENGINE_PROFILE_CAPTURE_FRAME();
+    }
+    if (WasActionPressed(EditorAction::TakeScreenshot)) {
+        m_debug_panel.TakeScreenshot();
+    }
+    if (WasActionPressed(EditorAction::ToggleFrameCapture)) {
+        m_debug_panel.ToggleFrameCapture();
+    }
+    if (p_current_scene != nullptr) {
+        HandleMarqueeSelection();
+        HandleSelectionDrag();
 
-        if (is_pressed && !was_pressed) {
-            action(); // Perform action on key press
+        const bool is_modifier_down{m_context.input_handler->IsActionDown(std::to_underlying(EditorAction::Modifier))};
+        if (is_modifier_down && WasActionPressed(EditorAction::Undo)) {
+            UndoEdit();
         }
-
-        was_pressed = is_pressed;
-    };
-
-    handle_toggle(gouda::Key::P, [&] { m_side_panel.ToggleVisibility(); });
-    handle_toggle(gouda::Key::L, [&] { ToggleSelectedEntityPopups(); });
-    handle_toggle(gouda::Key::F3, [&] { m_debug_panel.ToggleVisibility(); });
+        else if (is_modifier_down && WasActionPressed(EditorAction::Redo)) {
+            RedoEdit();
+        }
+    }
 }
 
 void EditorState::Update(const f32 delta_time)
 {
-    // TODO: Handle multi-select
-    m_top_menu.Update(delta_time);
+    // Swapped in between frames, nothing holds on to the old scene's entities across one
+    if (p_scene_load && p_scene_load->counter.IsDone()) {
+        FinishSceneLoad();
+    }
+
+    if (p_current_scene != nullptr) {
+        p_current_scene->editor_entities.BeginStep(); // The editor draws current positions, nothing interpolates
+
+        if (m_auto_save && m_scene_modified) {
+            m_auto_save_elapsed += delta_time;
+            if (m_auto_save_elapsed >= app_constants::editor_auto_save_interval) {
+                SaveScene(p_current_scene->scene_file_path);
+                m_auto_save_elapsed = 0.0f;
+            }
+        }
+    }
 
     // Check if entities are hovered
-    if (!m_exit_requested) {
-        m_side_panel.Update(delta_time);
+    if (!m_exit_requested && p_current_scene != nullptr) {
         const gouda::Vec2 mouse_position{m_context.input_handler->GetMousePositionFloat()};
         p_current_scene->selected_entity = PickTopEntityAt(mouse_position);
     }
 }
 
-void EditorState::Render(const f32 delta_time)
+void EditorState::Render([[maybe_unused]] const f32 delta_time, FrameDrawList &draw_list)
 {
     // TODO: Figure out a document laying once and for all
 
     // Render the scene visible in the scene camera frustum.
     const auto &frustum = m_context.scene_camera->GetFrustumData();
 
-    for (const auto &entity : p_current_scene->editor_entities) {
-        if (IsInFrustum(entity.render_data.position, entity.render_data.size, frustum)) {
-            m_quad_instances.push_back(entity.render_data);
-        }
+    // Entities are static quads resident on the GPU, only the ones changed since the last frame are uploaded
+    if (p_current_scene != nullptr) {
+        UploadStaticInstances();
+    }
+    m_context.renderer->SetCullFrustum(frustum);
+    if (m_show_grid) {
+        DrawGrid(draw_list, frustum);
     }
 
     // Draw UI
-    m_top_menu.Draw(m_quad_instances, m_text_instances);
-    m_debug_panel.Draw(m_quad_instances, m_text_instances);
+    m_top_menu.Draw(m_ui_batcher);
+    m_debug_panel.Draw(m_ui_batcher);
+    if (p_scene_load) {
+        DrawSceneLoadProgress(draw_list);
+    }
 
     // Handle exit confirmation or side panel
     if (m_scene_modified && m_exit_requested) {
-        DrawExitConfirmationPopup();
+        DrawExitConfirmationPopup(draw_list);
     }
     else {
-        m_side_panel.Draw(m_quad_instances, m_text_instances);
+        m_side_panel.Draw(m_ui_batcher);
+        DrawMarqueeSelection(draw_list);
 
         // Handle selected entity outline and popup
-        if (p_current_scene->selected_entity != nullptr) {
-            m_quad_instances.emplace_back(SelectionOutline{p_current_scene->selected_entity->render_data}.instance);
+        if (p_current_scene != nullptr && p_current_scene->selected_entity.has_value()) {
+            const gouda::InstanceData selected_instance{
+                p_current_scene->editor_entities.BuildInstance(*p_current_scene->selected_entity)};
+            draw_list.quad_instances.emplace_back(SelectionOutline{selected_instance}.instance);
 
             if (m_show_entity_popups) {
-                DrawEntityPopup();
+                DrawEntityPopup(draw_list);
             }
         }
     }
 
-    // Perform the final render
-    m_context.renderer->Render(delta_time, *m_context.uniform_data, m_quad_instances, m_text_instances,
-                               m_particles_instances);
-
-    ClearInstances();
+    // The panels go in as one range, rebuilt only where they changed
+    m_ui_batcher.Flush(draw_list.quad_instances);
 }
 
 void EditorState::OnFrameBufferResize(const gouda::Vec2 &new_framebuffer_size)
@@ -172,73 +322,322 @@ void EditorState::OnEnter()
          [this] { m_context.scene_camera->ClearMovementFlag(gouda::CameraMovement::ZoomOut); }},
         {gouda::Key::Space, gouda::ActionState::Pressed, [this] { m_context.scene_camera->Shake(10.0f, 0.5f); }},
         {gouda::Key::C, gouda::ActionState::Pressed, [this] { m_context.renderer->ToggleComputeParticles(); }},
+        {gouda::Key::G, gouda::ActionState::Pressed, [this] { m_context.renderer->ToggleGpuCulling(); }},
     };
 
-    m_context.input_handler->LoadStateBindings(m_state_id, editor_bindings);
-    m_context.input_handler->SetActiveState(m_state_id);
+    gouda::InputHandler &input{*m_context.input_handler};
+    input.LoadStateBindings(m_state_id, editor_bindings);
+
+    constexpr std::array<std::pair<EditorAction, gouda::InputHandler::InputType>, 18> editor_actions{{
+        {EditorAction::ConfirmExit, gouda::Key::Y},
+        {EditorAction::CancelExit, gouda::Key::N},
+        {EditorAction::ToggleSidePanel, gouda::Key::P},
+        {EditorAction::ToggleEntityPopups, gouda::Key::L},
+        {EditorAction::ToggleDebugPanel, gouda::Key::F3},
+        {EditorAction::ToggleDebugUI, gouda::Key::F2},
+        {EditorAction::ToggleGrid, gouda::Key::H},
+        {EditorAction::ToggleCsvCapture, gouda::Key::F4},
+        {EditorAction::ToggleProfilerFreeze, gouda::Key::F5},
+        {EditorAction::CaptureProfilerFrame, gouda::Key::F6},
+        {EditorAction::TakeScreenshot, gouda::Key::F7},
+        {EditorAction::ToggleFrameCapture, gouda::Key::F8},
+        {EditorAction::Select, gouda::MouseButton::Left},
+        {EditorAction::Drag, gouda::MouseButton::Right},
+        {EditorAction::Undo, gouda::Key::Z},
+        {EditorAction::Redo, gouda::Key::Y},
+        {EditorAction::Modifier, gouda::Key::LeftControl},
+        {EditorAction::Modifier, gouda::Key::RightControl},
+    }};
+
+    const gouda::InputHandler::StateID input_state{input.InternState(m_state_id)};
+    input.UnbindActions(input_state);
+    for (const auto &[action, input_type] : editor_actions) {
+        input.BindAction(input_state, std::to_underlying(action), input_type);
+    }
+    input.SetActiveState(input_state);
 }
 
 void EditorState::OnExit()
 {
-    // TODO: Figure out how we are going to set and get the scene name/filename
-    if (m_auto_save && m_scene_modified) {
-        //SaveScene("new_scene.json");
+    if (m_auto_save && m_scene_modified && p_current_scene != nullptr) {
+        SaveScene(p_current_scene->scene_file_path);
     }
 
     m_context.input_handler->UnloadStateBindings(m_state_id);
+    m_context.input_handler->UnbindActions(m_context.input_handler->InternState(m_state_id));
+}
+
+bool EditorState::WasActionPressed(const EditorAction action) const
+{
+    return m_context.input_handler->WasActionPressed(std::to_underlying(action));
 }
 
 void EditorState::LoadScene(StringView scene_file_path)
 {
-    /*// Ensure the scene directory exists
-    FilePath scene_path{scene_file_path};
-    FilePath scenes_directory{scene_path.parent_path()};
+    if (p_scene_load) {
+        APP_LOG_WARNING("Scene '{}' is still loading, not loading '{}'.", p_scene_load->scene.scene_file_path,
+                        scene_file_path);
+        return;
+    }
+
     std::error_code error_code;
-    if (!std::filesystem::exists(scenes_directory, error_code)) {
-        if (!std::filesystem::create_directories(scenes_directory, error_code)) {
-            APP_LOG_ERROR("Failed to create scenes directory '{}'. Error: {}", scenes_directory.string(),
-    error_code.message()); return;
-        }
+    if (!std::filesystem::exists(FilePath{scene_file_path}, error_code)) {
+        APP_LOG_WARNING("Scene file '{}' does not exist, creating with default settings.", scene_file_path);
+        AddDefaultScene(scene_file_path);
+        return;
     }
 
-    // Check if the scene file exists
-    if (!std::filesystem::exists(scene_path, error_code)) {
-        APP_LOG_WARNING("Scene file '{}' does not exist, creating with default settings.", scenes_directory.string());
+    p_scene_load = std::make_unique<SceneLoad>(scene_file_path);
+
+    // The job only touches the load, which the main thread leaves alone apart from the progress until it is done
+    SceneLoad *load{p_scene_load.get()};
+    gouda::JobSystem *job_system{m_context.job_system};
+    auto job = [load, job_system] { LoadSceneFile(*load, job_system); };
+
+    if (job_system == nullptr || job_system->GetWorkerCount() == 0) {
+        job();
+        FinishSceneLoad();
         return;
     }
+    job_system->Schedule(std::move(job), &load->counter);
+}
 
-    // Check if the scene file is empty
-    if (std::filesystem::file_size(scene_path, error_code) == 0) {
-        APP_LOG_WARNING("Scene file '{}' is empty, using default settings.", scene_path.string());
+void EditorState::SaveScene(StringView scene_file_path)
+{
+    // Return early for no scene changes
+    if (!m_scene_modified || p_current_scene == nullptr) {
         return;
     }
 
-    std::ifstream file(scene_path);
-    if (!file.is_open()) {
-        APP_LOG_ERROR("Failed to open settings file '{}'.", scene_path.string());
+    // Loading replays the journal on top of the file, so it is folded in before it takes longer than the file
+    constexpr size_t min_journal_records{256};
+    EditorScene &scene{*p_current_scene};
+    const size_t journal_limit{std::max(scene.editor_entities.Size(), min_journal_records)};
+    const bool is_journaled{scene.has_saved_file && scene_file_path == scene.scene_file_path &&
+                            scene.journal_records + scene.unsaved_entities.size() <= journal_limit};
+
+    std::ranges::sort(scene.unsaved_entities); // Added entities are replayed onto the end, in the order they were added
+    const size_t saved_count{is_journaled ? scene.unsaved_entities.size() : scene.editor_entities.Size()};
+    if (!(is_journaled ? AppendSceneJournal(scene) : WriteSceneFile(scene, scene_file_path))) {
         return;
     }
 
+    for (const u32 index : scene.unsaved_entities) {
+        scene.entity_unsaved[index] = 0;
+    }
+    scene.unsaved_entities.clear();
+    APP_LOG_DEBUG("Scene saved to '{}', {} {} written.", scene_file_path, saved_count,
+                  is_journaled ? "journaled entities" : "entities");
+
+    // Unflag the scene as changed
+    m_scene_modified = false;
+}
+
+// Private functions ----------------------------------------------------
+void EditorState::LoadSceneFile(SceneLoad &load, gouda::JobSystem *job_system)
+{
+    constexpr u32 entities_per_job{1024};
+    const StringView filepath{load.scene.scene_file_path};
+
+    const auto contents{gouda::fs::ReadFile(filepath)};
+    if (!contents) {
+        APP_LOG_ERROR("Failed to read scene file '{}': {}", filepath, gouda::fs::error_to_string(contents.error()));
+        return;
+    }
+
+    load.stage = SceneLoad::Stage::Parsing;
+    nlohmann::json json_data;
     try {
-        nlohmann::json json_data;
-        file >> json_data;
+        json_data = nlohmann::json::parse(*contents);
+        if (!json_data.is_object() || !json_data.contains("entities") || !json_data.at("entities").is_array()) {
+            throw std::runtime_error("Invalid JSON format (no entities array).");
+        }
+    }
+    catch (const std::exception &error) {
+        APP_LOG_ERROR("Failed to parse scene file '{}'. Error: {}", filepath, error.what());
+        return;
+    }
 
-        if (!json_data.is_object()) {
-            throw std::runtime_error("Invalid JSON format (not an object).");
+    // Converting the entities is most of the work, the chunks read the document without writing to it
+    const nlohmann::json &entity_array{json_data.at("entities")};
+    const u32 entity_count{static_cast<u32>(entity_array.size())};
+    load.entity_count = entity_count;
+    load.stage = SceneLoad::Stage::Building;
+
+    std::vector<gouda::InstanceData> instances(entity_count);
+    std::vector<EntityType> types(entity_count);
+    std::atomic<bool> is_valid{true};
+    const auto build_entities = [&](const u32 begin, const u32 end) {
+        try {
+            for (u32 i = begin; i < end; ++i) {
+                ParseEntity(entity_array[i], instances[i], types[i]);
+            }
+        }
+        catch (const std::exception &error) {
+            APP_LOG_ERROR("Invalid entity in scene file '{}'. Error: {}", filepath, error.what());
+            is_valid.store(false, std::memory_order_relaxed);
         }
+        load.entities_built.fetch_add(end - begin, std::memory_order_relaxed);
+    };
 
-        // json_data.get_to(m_settings);
+    if (job_system != nullptr) {
+        job_system->ParallelFor(entity_count, entities_per_job, build_entities);
+    }
+    else {
+        build_entities(0, entity_count);
+    }
+    if (!is_valid.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    EditorScene &scene{load.scene};
+    scene.journal_generation = json_data.value("generation", 0u);
+    scene.has_saved_file = true;
+    ReplaySceneJournal(scene, instances, types);
+
+    scene.editor_entities.Reserve(instances.size());
+    for (size_t i = 0; i < instances.size(); ++i) {
+        scene.editor_entities.Add(Entity{instances[i], types[i]});
+    }
+    scene.UpdateEntityTree(); // Picking needs it on the first frame, built here rather than on the main thread
+    load.is_loaded = true;
+}
+
+void EditorState::ReplaySceneJournal(EditorScene &scene, std::vector<gouda::InstanceData> &instances,
+                                     std::vector<EntityType> &types)
+{
+    const String journal_path{GetJournalPath(scene.scene_file_path)};
+    if (!gouda::fs::IsFileExists(journal_path)) {
+        return;
+    }
+
+    const auto journal{gouda::fs::ReadFile(journal_path)};
+    if (!journal) {
+        APP_LOG_WARNING("Failed to read scene journal '{}': {}", journal_path,
+                        gouda::fs::error_to_string(journal.error()));
+        scene.has_saved_file = false; // The next save writes the file in full, leaving the journal stale
+        return;
+    }
+
+    // Records amend the file in the order they were saved, those of another generation are already folded into it
+    for (const auto line_range : std::views::split(*journal, '\n')) {
+        const StringView line{line_range.begin(), line_range.end()};
+        if (line.empty()) {
+            continue;
+        }
+
+        try {
+            const nlohmann::json record{nlohmann::json::parse(line)};
+            if (record.at("generation").get<u32>() != scene.journal_generation) {
+                continue;
+            }
+
+            const size_t index{record.at("index").get<size_t>()};
+            if (index > instances.size()) {
+                throw std::runtime_error("Entity index out of range.");
+            }
+            if (index == instances.size()) {
+                instances.emplace_back();
+                types.emplace_back();
+            }
+            ParseEntity(record, instances[index], types[index]);
+            ++scene.journal_records;
+        }
+        catch (const std::exception &error) {
+            // Most likely the last record, cut short by a crash while saving
+            APP_LOG_WARNING("Stopped replaying scene journal '{}'. Error: {}", journal_path, error.what());
+            scene.has_saved_file = false;
+            return;
+        }
+    }
+}
+
+bool EditorState::WriteSceneFile(EditorScene &scene, StringView scene_file_path)
+{
+    const EntityStore &entities{scene.editor_entities};
+    nlohmann::json entity_array = nlohmann::json::array();
+    for (size_t i = 0; i < entities.Size(); ++i) {
+        entity_array.push_back(EntityToJSON(entities, i));
+    }
+
+    // A new generation leaves the records in the old journal stale, even if it cannot be removed below
+    const u32 generation{scene.journal_generation + 1};
+    const nlohmann::json json_data{{"generation", generation}, {"entities", std::move(entity_array)}};
+
+    // Written beside the scene and renamed over it, so a failed save leaves the last one intact
+    const String temporary_path{String{scene_file_path} + ".tmp"};
+    if (const auto result{gouda::fs::WriteFile(temporary_path, json_data.dump(4))}; !result) {
+        APP_LOG_ERROR("Could not write scene file '{}': {}", temporary_path,
+                      gouda::fs::error_to_string(result.error()));
+        return false;
+    }
+
+    std::error_code error_code;
+    std::filesystem::rename(FilePath{temporary_path}, FilePath{scene_file_path}, error_code);
+    if (error_code) {
+        APP_LOG_ERROR("Could not replace scene file '{}'. Error: {}", scene_file_path, error_code.message());
+        return false;
+    }
+    std::filesystem::remove(FilePath{GetJournalPath(scene_file_path)}, error_code);
+
+    if (scene.scene_file_path != scene_file_path) {
+        scene.scene_file_path = scene_file_path;
+    }
+    scene.journal_generation = generation;
+    scene.journal_records = 0;
+    scene.has_saved_file = true;
+    return true;
+}
+
+bool EditorState::AppendSceneJournal(EditorScene &scene)
+{
+    String records;
+    for (const u32 index : scene.unsaved_entities) {
+        nlohmann::json record{EntityToJSON(scene.editor_entities, index)};
+        record["generation"] = scene.journal_generation;
+        record["index"] = index;
+        records += record.dump();
+        records += '\n';
+    }
+
+    const String journal_path{GetJournalPath(scene.scene_file_path)};
+    if (const auto result{gouda::fs::AppendFile(journal_path, records)}; !result) {
+        APP_LOG_ERROR("Could not append to scene journal '{}': {}", journal_path,
+                      gouda::fs::error_to_string(result.error()));
+        scene.has_saved_file = false; // The journal may end in part of a record, the next save starts over
+        return false;
     }
-    catch (const std::exception &error) {
-        APP_LOG_WARNING("Failed to parse settings file '{}'. Error: {}, using default settings.", scene_path.string(),
-                        error.what());
-    }*/
 
-    EditorScene scene(scene_file_path);
-    m_editor_scenes.emplace_back(scene);
+    scene.journal_records += scene.unsaved_entities.size();
+    return true;
+}
+
+void EditorState::FinishSceneLoad()
+{
+    if (m_context.job_system != nullptr) {
+        m_context.job_system->Wait(p_scene_load->counter); // Returns at once, the job may still hold the counter
+    }
+
+    const std::unique_ptr<SceneLoad> load{std::move(p_scene_load)};
+    if (!load->is_loaded) {
+        if (p_current_scene == nullptr) {
+            AddDefaultScene(load->scene.scene_file_path);
+        }
+        return;
+    }
+
+    APP_LOG_INFO("Loaded scene '{}' with {} entities.", load->scene.scene_file_path,
+                 load->scene.editor_entities.Size());
+    m_editor_scenes.push_back(std::move(load->scene));
+    p_current_scene = &m_editor_scenes.back();
+    m_scene_modified = false;
+}
+
+void EditorState::AddDefaultScene(StringView scene_file_path)
+{
+    m_editor_scenes.emplace_back(scene_file_path);
     p_current_scene = &m_editor_scenes.back();
 
-    // TODO: Load scene from file
     const gouda::Vector<gouda::InstanceData> instances{
         {{100.0f, 304.8f, -0.522f}, {81.9f, 453.95f}, 0.0f, 4},
         {{200.0f, 200.8f, -0.587f}, {281.9f, 453.95f}, 0.0f, 4},
@@ -246,45 +645,43 @@ void EditorState::LoadScene(StringView scene_file_path)
         {{634.96f, 45.58f, -0.503f}, {246.26f, 227.67f}, 0.0f, 4},
     };
 
-    p_current_scene->editor_entities.reserve(instances.size());
+    p_current_scene->editor_entities.Reserve(instances.size());
     for (const auto &instance : instances) {
-        p_current_scene->editor_entities.emplace_back(instance, EntityType::Quad);
+        p_current_scene->editor_entities.Add(Entity{instance, EntityType::Quad});
     }
 
     m_scene_modified = true;
 }
-void EditorState::SaveScene(StringView scene_file_path)
-{
-    // Return early for no scene changes
-    if (!m_scene_modified) {
-        return;
-    }
 
-    /*if (std::ofstream file(scene_file_path.data()); !file.is_open()) {
-        APP_LOG_ERROR("Could not open scene file '{}' for saving.", scene_file_path.data());
-        return;
-    }
-
-    try {
-        //const nlohmann::json json_data = m_settings; // Should be a JSON object
-        //file << json_data.dump(4);             // Pretty print with indentation
-    }
-    catch (const std::exception &e) {
-        APP_LOG_ERROR("Failed to save scene file '{}'. Reason: {}.", scene_file_path.data(), e.what());
-        return;
+void EditorState::DrawSceneLoadProgress(FrameDrawList &draw_list)
+{
+    const String scene_name{p_scene_load->scene.GetSceneName()};
+    String text;
+    switch (p_scene_load->stage.load()) {
+        case SceneLoad::Stage::Reading:
+            text = std::format("Reading {}", scene_name);
+            break;
+        case SceneLoad::Stage::Parsing:
+            text = std::format("Parsing {}", scene_name);
+            break;
+        case SceneLoad::Stage::Building: {
+            const u32 entity_count{std::max(p_scene_load->entity_count.load(), 1u)};
+            text = std::format("Loading {}: {}%", scene_name, p_scene_load->entities_built.load() * 100 / entity_count);
+            break;
+        }
     }
 
-    APP_LOG_DEBUG("Scene saved to '{}", scene_file_path.data());*/
-
-    // Unflag the scene as changed
-    m_scene_modified = false;
+    const gouda::Vec3 position{m_framebuffer_size.x * 0.5f, m_framebuffer_size.y * 0.5f, -0.1f};
+    m_context.renderer->DrawText(text, position, colours::editor_panel_primary_font_colour, 20.0f, 1,
+                                 draw_list.quad_instances, gouda::TextAlign::Center);
 }
 
-// Private functions ----------------------------------------------------
-void EditorState::DrawEntityPopup()
+void EditorState::DrawEntityPopup(FrameDrawList &draw_list)
 {
+    // The popup only reads the entity, a copy assembled from the store outlives it
+    Entity selected_entity{p_current_scene->editor_entities.BuildEntity(*p_current_scene->selected_entity)};
     EntityPopup popup{m_context,
-                      p_current_scene->selected_entity,
+                      &selected_entity,
                       {300.0f, 300.0f},
                       colours::editor_panel_colour,
                       0,
@@ -293,10 +690,10 @@ void EditorState::DrawEntityPopup()
                       20.0f,
                       colours::editor_panel_primary_font_colour};
 
-    popup.Draw(m_quad_instances, m_text_instances);
+    popup.Draw(draw_list.quad_instances);
 }
 
-void EditorState::DrawExitConfirmationPopup()
+void EditorState::DrawExitConfirmationPopup(FrameDrawList &draw_list)
 {
     ExitConfirmationPopup{m_context,
                           {100.0f, 100.0f, -0.1111f},
@@ -307,38 +704,167 @@ void EditorState::DrawExitConfirmationPopup()
                           1,
                           20.0f,
                           colours::editor_panel_primary_font_colour}
-        .Draw(m_quad_instances, m_text_instances);
+        .Draw(draw_list.quad_instances);
 }
 
-Entity *EditorState::PickTopEntityAt(const gouda::Vec2 &mouse_position) const
+std::optional<size_t> EditorState::PickTopEntityAt(const gouda::Vec2 &mouse_position) const
 {
-    Entity *top_entity{nullptr};
+    std::optional<size_t> top_entity;
     f32 max_z{-constants::infinity};
 
-    for (auto &entity : p_current_scene->editor_entities) {
-        if (entity.GetBounds().Contains(mouse_position.x, mouse_position.y)) {
-            const f32 z_position{entity.render_data.position.z};
+    gouda::Vector<u32> &candidates{p_current_scene->query_results};
+    candidates.clear();
+    p_current_scene->QueryEntities(gouda::math::AABB2D{mouse_position, mouse_position}, candidates);
 
-            // Skip NaN just in case
-            if (std::isnan(z_position)) {
-                continue;
-            }
+    // Walked in entity order so the later of two entities at the same depth still wins
+    std::ranges::sort(candidates);
+    const std::span<const gouda::Vec3> positions{p_current_scene->editor_entities.GetPositions()};
+    for (const u32 index : candidates) {
+        const f32 z_position{positions[index].z};
 
-            if (z_position >= max_z) {
-                max_z = z_position;
-                top_entity = &entity;
-            }
+        // Skip NaN just in case
+        if (std::isnan(z_position)) {
+            continue;
+        }
+
+        if (z_position >= max_z) {
+            max_z = z_position;
+            top_entity = index;
         }
     }
 
     return top_entity;
 }
+void EditorState::HandleMarqueeSelection()
+{
+    const gouda::Vec2 mouse_position{m_context.input_handler->GetMousePositionFloat()};
+    if (WasActionPressed(EditorAction::Select)) {
+        m_selection_tool.BeginSelection(mouse_position);
+    }
+    if (!m_selection_tool.IsSelecting()) {
+        return;
+    }
+
+    m_selection_tool.UpdateSelection(mouse_position);
+    if (m_context.input_handler->IsActionDown(std::to_underlying(EditorAction::Select))) {
+        return;
+    }
+
+    // A click without a drag selects the entity on top, a drag everything the box touches
+    const gouda::math::AABB2D box{m_selection_tool.EndSelection()};
+    gouda::Vector<u32> &selection{p_current_scene->marquee_selection};
+    selection.clear();
+    constexpr f32 click_tolerance{2.0f};
+    if (box.max.x - box.min.x <= click_tolerance && box.max.y - box.min.y <= click_tolerance) {
+        if (const std::optional<size_t> top_entity{PickTopEntityAt(mouse_position)}) {
+            selection.push_back(static_cast<u32>(*top_entity));
+        }
+        return;
+    }
+
+    p_current_scene->QueryEntities(box, selection);
+    std::ranges::sort(selection);
+}
+
+void EditorState::HandleSelectionDrag()
+{
+    const gouda::Vec2 mouse_position{m_context.input_handler->GetMousePositionFloat()};
+    if (WasActionPressed(EditorAction::Drag)) {
+        m_drag_mouse_position = mouse_position;
+        ++m_drag_count;
+    }
+    if (!m_context.input_handler->IsActionDown(std::to_underlying(EditorAction::Drag))) {
+        return;
+    }
+
+    const gouda::Vec2 offset{mouse_position - m_drag_mouse_position};
+    if (p_current_scene->marquee_selection.empty() || (offset.x == 0.0f && offset.y == 0.0f)) {
+        return;
+    }
+    m_drag_mouse_position = mouse_position;
+
+    // Every frame of the drag merges into its first, the history keeps one position pair per entity
+    EditorScene &scene{*p_current_scene};
+    scene.history.BeginCommand(m_drag_count);
+    for (const u32 index : scene.marquee_selection) {
+        const gouda::Vec3 &position{scene.editor_entities.GetPositions()[index]};
+        scene.MoveEntity(index, {position.x + offset.x, position.y + offset.y, position.z});
+    }
+    scene.history.EndCommand();
+    m_scene_modified = true;
+}
+
+void EditorState::UndoEdit()
+{
+    const std::span<const EntityEdit> edits{p_current_scene->history.Undo()};
+    for (auto edit{edits.rbegin()}; edit != edits.rend(); ++edit) {
+        p_current_scene->ApplyEntityField(edit->entity, edit->field, edit->before);
+    }
+    m_scene_modified = m_scene_modified || !edits.empty();
+}
+
+void EditorState::RedoEdit()
+{
+    const std::span<const EntityEdit> edits{p_current_scene->history.Redo()};
+    for (const EntityEdit &edit : edits) {
+        p_current_scene->ApplyEntityField(edit.entity, edit.field, edit.after);
+    }
+    m_scene_modified = m_scene_modified || !edits.empty();
+}
+
+void EditorState::DrawMarqueeSelection(FrameDrawList &draw_list)
+{
+    m_selection_tool.Draw(draw_list.quad_instances);
+    if (p_current_scene == nullptr) {
+        return;
+    }
+
+    for (const u32 index : p_current_scene->marquee_selection) {
+        if (index < p_current_scene->editor_entities.Size()) {
+            draw_list.quad_instances.emplace_back(
+                SelectionOutline{p_current_scene->editor_entities.BuildInstance(index)}.instance);
+        }
+    }
+}
+
 void EditorState::AddEntity(const Entity &entity)
 {
-    p_current_scene->editor_entities.emplace_back(entity);
+    if (p_current_scene == nullptr) {
+        return;
+    }
+    p_current_scene->AddEntity(entity);
     m_scene_modified = true;
 }
 
+void EditorState::DrawGrid(FrameDrawList &draw_list, const gouda::OrthographicCamera::FrustumData &frustum) const
+{
+    // The grid and the world axes are three quads at any zoom, the grid's lines are found by its fragment shader
+    const f32 left{frustum.left + frustum.position.x};
+    const f32 right{frustum.right + frustum.position.x};
+    const f32 bottom{gouda::math::min(frustum.top, frustum.bottom) + frustum.position.y};
+    const f32 top{gouda::math::max(frustum.top, frustum.bottom) + frustum.position.y};
+    if (right <= left || top <= bottom || m_framebuffer_size.x <= 0.0f) {
+        return;
+    }
+
+    // Behind every entity, so they hide it where they are opaque
+    constexpr f32 grid_depth{0.95f};
+    draw_list.quad_instances.emplace_back(gouda::make_grid_shape(
+        {left, bottom, grid_depth}, {right - left, top - bottom}, app_constants::editor_grid_cell_size,
+        colours::editor_grid_colour, app_constants::editor_grid_major_interval));
+
+    // Two pixels wide whatever the zoom, drawn only while they are in view
+    const f32 axis_width{2.0f * (right - left) / m_framebuffer_size.x};
+    if (bottom <= 0.0f && top >= 0.0f) {
+        draw_list.quad_instances.emplace_back(gouda::make_line_shape(
+            {left, 0.0f}, {right, 0.0f}, grid_depth - 0.01f, axis_width, colours::editor_x_axis_colour, true));
+    }
+    if (left <= 0.0f && right >= 0.0f) {
+        draw_list.quad_instances.emplace_back(gouda::make_line_shape(
+            {0.0f, bottom}, {0.0f, top}, grid_depth - 0.01f, axis_width, colours::editor_y_axis_colour, true));
+    }
+}
+
 void EditorState::ToggleSelectedEntityPopups() { m_show_entity_popups = !m_show_entity_popups; }
 void EditorState::RequestExit()
 {
@@ -351,9 +877,31 @@ void EditorState::RequestExit()
 }
 void EditorState::ToggleExitRequested() { m_exit_requested = !m_exit_requested; }
 
-void EditorState::ClearInstances()
+void EditorState::UploadStaticInstances()
 {
-    m_quad_instances.clear();
-    m_text_instances.clear();
-    m_particles_instances.clear();
-}
\ No newline at end of file
+    EditorScene &scene{*p_current_scene};
+    if (scene.gpu_instances_dirty) {
+        scene.gpu_dirty_begin = 0;
+        scene.gpu_dirty_end = scene.editor_entities.Size();
+    }
+    if (scene.gpu_dirty_begin == scene.gpu_dirty_end) {
+        return;
+    }
+
+    m_static_instances.clear();
+    m_static_instances.reserve(scene.gpu_dirty_end - scene.gpu_dirty_begin);
+    for (size_t i = scene.gpu_dirty_begin; i < scene.gpu_dirty_end; ++i) {
+        m_static_instances.push_back(scene.editor_entities.BuildInstance(i));
+    }
+
+    if (scene.gpu_instances_dirty) {
+        m_context.renderer->SetStaticQuadInstances(m_static_instances);
+    }
+    else {
+        m_context.renderer->UpdateStaticQuadInstances(static_cast<u32>(scene.gpu_dirty_begin), m_static_instances);
+    }
+
+    scene.gpu_instances_dirty = false;
+    scene.gpu_dirty_begin = 0;
+    scene.gpu_dirty_end = 0;
+}
@@ -14,7 +14,7 @@ void GameState::HandleInput() {}
 
 void GameState::Update(const f32 delta_time) {}
 
-void GameState::Render(const f32 delta_time) {}
+void GameState::Render(const f32 delta_time, FrameDrawList &draw_list) {}
 
 void GameState::OnFrameBufferResize(const gouda::Vec2 &new_framebuffer_size)
 {
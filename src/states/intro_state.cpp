@@ -12,7 +12,7 @@
 #include "states/main_menu_state.hpp"
 
 IntroState::IntroState(SharedContext &context, StateStack &state_stack)
-    : State(context, state_stack, "IntroState"), m_current_time{0.0f}
+    : State(context, state_stack, "IntroState"), m_current_time{0.0f}, m_title_dependent{gouda::INVALID_SLOT_HANDLE}
 {
     gouda::InstanceData background;
     background.position = {0.f, 0.f, -0.599f};
@@ -21,32 +21,37 @@ IntroState::IntroState(SharedContext &context, StateStack &state_stack)
     background.texture_index = 1;
     m_quad_instances.push_back(background);
 
-    gouda::Vec3 text_position;
-    text_position.x = m_framebuffer_size.x / 2;
-    text_position.y = m_framebuffer_size.y / 2;
-    text_position.z = -0.1f;
-
-    m_context.renderer->DrawText("GOUDA RENDERER", text_position, {0.0f, 1.0f, 0.0f, 1.0f}, 50.0f, 2, m_text_instances,
-                                 gouda::TextAlign::Center, false);
+    LayoutTitle();
+    if (m_context.asset_registry != nullptr) {
+        if (const gouda::FontHandle font{m_context.asset_registry->FindFont(TITLE_FONT_ID)}; font.IsValid()) {
+            m_title_dependent = m_context.asset_registry->AddDependent([this] { LayoutTitle(); }, font);
+        }
+    }
 }
 
-void IntroState::HandleInput()
+IntroState::~IntroState()
 {
-    // All Input is handled by input handler for intro state
+    if (m_context.asset_registry != nullptr) {
+        m_context.asset_registry->RemoveDependent(m_title_dependent);
+    }
 }
 
-void IntroState::Update(const f32 delta_time)
+void IntroState::HandleInput()
 {
-    m_current_time += delta_time;
+    // All Input is handled by input handler for intro state. The switch waits for the device, which Update may not
+    // touch while a render thread draws the last frame.
     if (m_current_time >= 3.0f) { // TODO: Change to a decent time (Set for debug)
         TransitionToMainMenu();
     }
 }
 
-void IntroState::Render(const f32 delta_time)
+void IntroState::Update(const f32 delta_time) { m_current_time += delta_time; }
+
+void IntroState::Render([[maybe_unused]] const f32 delta_time, FrameDrawList &draw_list)
 {
-    m_context.renderer->Render(delta_time, *m_context.uniform_data, m_quad_instances, m_text_instances,
-                               m_particles_instances);
+    // Built once when the state is created, only copied into the frame
+    draw_list.quad_instances.insert(draw_list.quad_instances.end(), m_quad_instances.begin(), m_quad_instances.end());
+    draw_list.quad_instances.insert(draw_list.quad_instances.end(), m_text_instances.begin(), m_text_instances.end());
 }
 void IntroState::OnFrameBufferResize(const gouda::Vec2 &new_framebuffer_size)
 {
@@ -61,6 +66,9 @@ void IntroState::OnEnter()
 
     m_context.input_handler->LoadStateBindings(m_state_id, intro_bindings);
     m_context.input_handler->SetActiveState(m_state_id);
+
+    // Built while the intro plays, so its scene is loading before the switch
+    m_state_stack.Preload(std::make_unique<EditorState>(m_context, m_state_stack));
 }
 
 void IntroState::OnExit()
@@ -68,9 +76,25 @@ void IntroState::OnExit()
     m_context.input_handler->UnloadStateBindings(m_state_id);
 }
 
+void IntroState::LayoutTitle()
+{
+    gouda::Vec3 text_position;
+    text_position.x = m_framebuffer_size.x / 2;
+    text_position.y = m_framebuffer_size.y / 2;
+    text_position.z = -0.1f;
+
+    m_text_instances.clear();
+    m_context.renderer->DrawText("GOUDA RENDERER", text_position, {0.0f, 1.0f, 0.0f, 1.0f}, 50.0f, TITLE_FONT_ID,
+                                 m_text_instances, gouda::TextAlign::Center, false);
+}
+
 void IntroState::TransitionToMainMenu() const
 {
     m_context.renderer->DeviceWait();
     // m_state_stack.Replace(std::make_unique<MainMenuState>(m_context, m_state_stack));
-    m_state_stack.Replace(std::make_unique<EditorState>(m_context, m_state_stack));
+    std::unique_ptr<State> next_state{m_state_stack.TakePreloaded("EditorState")};
+    if (!next_state) {
+        next_state = std::make_unique<EditorState>(m_context, m_state_stack);
+    }
+    m_state_stack.Replace(std::move(next_state));
 }
\ No newline at end of file
@@ -86,10 +86,11 @@ void MainMenuState::HandleInput() {}
 
 void MainMenuState::Update(const f32 delta_time) {}
 
-void MainMenuState::Render(const f32 delta_time)
+void MainMenuState::Render([[maybe_unused]] const f32 delta_time, FrameDrawList &draw_list)
 {
-    m_context.renderer->Render(delta_time, *m_context.uniform_data, m_quad_instances, m_text_instances,
-                               m_particles_instances);
+    // Built once when the state is created, only copied into the frame
+    draw_list.quad_instances.insert(draw_list.quad_instances.end(), m_quad_instances.begin(), m_quad_instances.end());
+    draw_list.quad_instances.insert(draw_list.quad_instances.end(), m_text_instances.begin(), m_text_instances.end());
 }
 
 void MainMenuState::OnFrameBufferResize(const gouda::Vec2 &new_framebuffer_size)
@@ -8,7 +8,7 @@ void SettingsState::HandleInput() {}
 
 void SettingsState::Update(const f32 delta_time) {}
 
-void SettingsState::Render(const f32 delta_time) {}
+void SettingsState::Render(const f32 delta_time, FrameDrawList &draw_list) {}
 
 void SettingsState::OnFrameBufferResize(const gouda::Vec2 &new_framebuffer_size)
 {
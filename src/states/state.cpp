@@ -14,3 +14,32 @@ State::State(SharedContext &context, StateStack &state_stack, StringView identif
     m_framebuffer_size = {static_cast<f32>(m_context.renderer->GetFramebufferSize().width),
                           static_cast<f32>(m_context.renderer->GetFramebufferSize().height)};
 }
+
+State::~State()
+{
+    if (m_context.asset_registry == nullptr) {
+        return;
+    }
+    for (const gouda::TextureHandle texture : m_manifest_textures) {
+        m_context.asset_registry->Release(texture);
+    }
+    for (const gouda::SoundHandle sound : m_manifest_sounds) {
+        m_context.asset_registry->Release(sound);
+    }
+}
+
+void State::PreloadAssets()
+{
+    if (m_context.asset_registry == nullptr || !m_manifest_textures.empty() || !m_manifest_sounds.empty()) {
+        return;
+    }
+
+    // Assets the current state holds as well are only referenced again, not loaded twice
+    const StateAssetManifest manifest{GetAssetManifest()};
+    for (const String &filepath : manifest.textures) {
+        m_manifest_textures.push_back(m_context.asset_registry->LoadTexture(filepath));
+    }
+    for (const String &filepath : manifest.sounds) {
+        m_manifest_sounds.push_back(m_context.asset_registry->LoadSound(filepath));
+    }
+}
@@ -43,8 +43,7 @@ ExitConfirmationPopup::ExitConfirmationPopup(SharedContext &shared_context, cons
     // TODO: Setup buttons
 }
 
-void ExitConfirmationPopup::Draw(std::vector<gouda::InstanceData> &quad_instances,
-                                 std::vector<gouda::TextData> &text_instances)
+void ExitConfirmationPopup::Draw(std::vector<gouda::InstanceData> &quad_instances)
 {
     quad_instances.emplace_back(instance);
 
@@ -70,7 +69,7 @@ void EntityPopup::HandleInput() {}
 
 void EntityPopup::Update(f32 delta_time) {}
 
-void EntityPopup::Draw(std::vector<gouda::InstanceData> &quad_instances, std::vector<gouda::TextData> &text_instances)
+void EntityPopup::Draw(std::vector<gouda::InstanceData> &quad_instances)
 {
     if (!entity) {
         APP_LOG_INFO("entity is null");
@@ -91,6 +90,6 @@ void EntityPopup::Draw(std::vector<gouda::InstanceData> &quad_instances, std::ve
     for (const auto &line : lines) {
         current_position_y -= font_scale + padding.y;
         const gouda::Vec3 position{instance.position.x + padding.x, current_position_y - padding.y, -0.1f};
-        shared_context.renderer->DrawText(line, position, font_colour, font_scale, font_id, text_instances);
+        shared_context.renderer->DrawText(line, position, font_colour, font_scale, font_id, quad_instances);
     }
 }
@@ -6,7 +6,14 @@
  */
 #include "ui/side_panel.hpp"
 
+#include <algorithm>
+
 #include "math/easing.hpp"
+#include "renderers/vulkan/vk_texture.hpp"
+#include "renderers/vulkan/vk_thumbnail_cache.hpp"
+#include "utils/hash.hpp"
+
+constexpr gouda::Colour<f32> THUMBNAIL_PLACEHOLDER_COLOUR{0.2f, 0.2f, 0.2f, 1.0f};
 
 SidePanel::SidePanel(SharedContext &shared_context, const gouda::Vec2 &size, const gouda::Vec2 &padding,
                      const gouda::Colour<f32> &colour, StringView title, const u32 font_id,
@@ -25,26 +32,26 @@ SidePanel::SidePanel(SharedContext &shared_context, const gouda::Vec2 &size, con
     m_size = {m_screen_size.x * size.x, m_screen_size.y * size.y};
     m_padding = padding;
 
-    m_instance_data.size = m_size;
-    m_instance_data.position = {m_screen_size.x, 0.0f, -0.99f}; // Start off-screen
-    m_instance_data.texture_index = 0;
-    m_instance_data.colour = colour;
-    m_instance_data.apply_camera_effects = 0;
+    // Start off-screen, a rounded rect shape drawn without a texture
+    m_instance_data = gouda::make_rect_shape({m_screen_size.x, 0.0f, -0.99f}, m_size, colour, CORNER_RADIUS);
 
     m_text_colour = title_colour;
     m_text_scale = title_scale;
     m_title = title;
 
-    m_title_position.x = m_instance_data.position.x + m_padding.x;
     m_title_position.y = m_size.y - m_text_scale - m_padding.y;
     m_title_position.z = m_instance_data.position.z - -0.01f;
 }
 
+SidePanel::~SidePanel() { m_shared_context.tweens->Remove(m_slide_tween); }
+
 void SidePanel::ToggleVisibility()
 {
+    // Starts from wherever the panel is, so toggling mid slide turns it around
     m_is_open = !m_is_open;
-    m_is_animating = true;
-    m_animation_timer = 0.0f;
+    m_shared_context.tweens->Remove(m_slide_tween);
+    m_slide_tween = m_shared_context.tweens->Add(m_instance_data.position.x, m_is_open ? GetOpenX() : GetClosedX(),
+                                                 m_transition_time, m_easing_type, &m_instance_data.position.x);
 }
 
 void SidePanel::SetSide(const PanelSide side)
@@ -53,40 +60,112 @@ void SidePanel::SetSide(const PanelSide side)
         m_panel_side = side;
 
         // Snap to the correct closed/open position immediately
-        m_is_animating = false;
-        m_animation_timer = 0.0f;
-        UpdatePosition(1.0f); // Force update to final position
+        m_shared_context.tweens->Remove(m_slide_tween);
+        m_instance_data.position.x = m_is_open ? GetOpenX() : GetClosedX();
     }
 }
 
 void SidePanel::ToggleSide() { SetSide(m_panel_side == PanelSide::Left ? PanelSide::Right : PanelSide::Left); }
 
-void SidePanel::Update(const f32 delta_time)
+void SidePanel::Draw(UIBatcher &batcher)
 {
-    if (!m_is_animating) {
+    if (!m_is_open && !IsAnimating()) {
         return;
     }
 
-    m_animation_timer += delta_time;
-
-    f32 t = gouda::math::min(m_animation_timer / m_transition_time, 1.0f);
-    t = gouda::math::easing::ApplyEasing(t, m_easing_type);
-
-    UpdatePosition(t);
+    constexpr u64 panel_id{gouda::utils::fnv1a("side_panel")};
+    batcher.AddQuad(panel_id, m_instance_data);
+
+    // While the panel slides the title is cut at the screen edge with it
+    const gouda::Vec3 &position{m_instance_data.position};
+    batcher.PushClipRect({{position.x, position.y}, {position.x + m_size.x, position.y + m_size.y}});
+    batcher.AddText(panel_id + 1, *m_shared_context.renderer, m_title,
+                    {position.x + m_padding.x, m_title_position.y, m_title_position.z}, m_text_colour, m_text_scale,
+                    m_font_id);
+    DrawAssets(batcher, panel_id + 2);
+    batcher.PopClipRect();
+}
 
-    if (m_animation_timer >= m_transition_time) {
-        m_is_animating = false;
-        UpdatePosition(1.0f); // Snap to final position
+void SidePanel::RefreshAssets()
+{
+    const gouda::vk::Renderer &renderer{*m_shared_context.renderer};
+    m_asset_texture_count = renderer.GetTextureCount();
+    m_assets.clear();
+
+    // Texture 0 is the default one, packed pages and textures made at runtime have no image file of their own
+    for (u32 texture_id = 1; texture_id < m_asset_texture_count; ++texture_id) {
+        const gouda::vk::TextureMetadata &metadata{renderer.GetTextureMetadata(texture_id)};
+        if (metadata.is_packed || metadata.image_filepath.empty()) {
+            continue;
+        }
+        if (!metadata.is_atlas || metadata.sprites.empty()) {
+            m_assets.push_back(BrowserAsset{metadata.image_filepath, {0.0f, 0.0f, 1.0f, 1.0f}});
+            continue;
+        }
+
+        // In reading order, the sprites of an atlas come in no order of their own
+        const size_t first{m_assets.size()};
+        for (const auto &[sprite_id, sprite] : metadata.sprites) {
+            if (!sprite.frames.empty()) {
+                m_assets.push_back(BrowserAsset{metadata.image_filepath, sprite.frames.front().uv_rect});
+            }
+        }
+        std::sort(m_assets.begin() + static_cast<std::ptrdiff_t>(first), m_assets.end(),
+                  [](const BrowserAsset &lhs, const BrowserAsset &rhs) {
+                      const gouda::UVRect<f32> &left{lhs.source_rect};
+                      const gouda::UVRect<f32> &right{rhs.source_rect};
+                      return left.v_max != right.v_max ? left.v_max > right.v_max : left.u_min < right.u_min;
+                  });
     }
 }
 
-void SidePanel::Draw(std::vector<gouda::InstanceData> &quad_instances,
-                       std::vector<gouda::TextData> &text_instances) const
+void SidePanel::DrawAssets(UIBatcher &batcher, const u64 first_id)
 {
-    if (m_is_open || m_is_animating) {
-        quad_instances.push_back(m_instance_data);
-        m_shared_context.renderer->DrawText(m_title, m_title_position, m_text_colour, m_text_scale, m_font_id,
-                                            text_instances, gouda::TextAlign::Left, false);
+    if (m_asset_texture_count != m_shared_context.renderer->GetTextureCount()) {
+        RefreshAssets();
+    }
+
+    // A grid of slots under the title, as many as fit in the panel. Only the slots shown ask for a thumbnail.
+    const gouda::Vec3 &position{m_instance_data.position};
+    constexpr f32 slot_stride{THUMBNAIL_SLOT_SIZE + THUMBNAIL_SLOT_GAP};
+    const f32 content_width{m_size.x - m_padding.x * 2.0f};
+    const auto column_count{static_cast<size_t>(std::max((content_width + THUMBNAIL_SLOT_GAP) / slot_stride, 1.0f))};
+    const f32 top{m_title_position.y - THUMBNAIL_SLOT_GAP};
+    const f32 bottom{position.y + m_padding.y};
+
+    for (size_t i = 0; i < m_assets.size(); ++i) {
+        const f32 slot_x{position.x + m_padding.x + static_cast<f32>(i % column_count) * slot_stride};
+        const f32 slot_y{top - static_cast<f32>(i / column_count + 1) * slot_stride + THUMBNAIL_SLOT_GAP};
+        if (slot_y < bottom) {
+            break;
+        }
+
+        const BrowserAsset &asset{m_assets[i]};
+        const gouda::vk::Thumbnail *thumbnail{
+            m_shared_context.renderer->FindThumbnail(asset.image_filepath, asset.source_rect)};
+        const u64 id{first_id + i};
+        if (thumbnail == nullptr) {
+            batcher.AddQuad(id, gouda::make_rect_shape({slot_x, slot_y, m_title_position.z},
+                                                       {THUMBNAIL_SLOT_SIZE, THUMBNAIL_SLOT_SIZE},
+                                                       THUMBNAIL_PLACEHOLDER_COLOUR, CORNER_RADIUS * 0.5f));
+            continue;
+        }
+
+        // Scaled to fit the slot and centred in it, keeping the source's aspect
+        const f32 scale{THUMBNAIL_SLOT_SIZE /
+                        static_cast<f32>(std::max(thumbnail->size.width, thumbnail->size.height))};
+        const gouda::Vec2 size{static_cast<f32>(thumbnail->size.width) * scale,
+                               static_cast<f32>(thumbnail->size.height) * scale};
+        batcher.AddQuad(id, gouda::InstanceData{{slot_x + (THUMBNAIL_SLOT_SIZE - size.x) * 0.5f,
+                                                 slot_y + (THUMBNAIL_SLOT_SIZE - size.y) * 0.5f, m_title_position.z},
+                                                size,
+                                                0.0f,
+                                                thumbnail->texture_id,
+                                                gouda::Colour(1.0f),
+                                                thumbnail->uv_rect,
+                                                1,
+                                                0,
+                                                gouda::BlendMode::Alpha});
     }
 }
 
@@ -96,31 +175,10 @@ void SidePanel::OnFramebufferResize(const gouda::Vec2 &new_size)
 
     m_size = {m_screen_size.x * m_size.x, m_screen_size.y * m_size.y};
 
+    m_shared_context.tweens->Remove(m_slide_tween);
     m_instance_data.size = m_size;
     m_instance_data.position = {m_screen_size.x, 0.0f, -0.99f}; // Start off-screen
 
-    m_title_position.x = m_instance_data.position.x + m_padding.x;
     m_title_position.y = m_size.y - m_text_scale - m_padding.y;
     m_title_position.z = m_instance_data.position.z - -0.01f;
 }
-
-void SidePanel::UpdatePosition(const f32 delta_time)
-{
-    f32 closed_x{0.0f};
-    f32 open_x{0.0f};
-
-    if (m_panel_side == PanelSide::Right) {
-        closed_x = m_screen_size.x;          // Off-screen right
-        open_x = m_screen_size.x - m_size.x; // On-screen right
-    }
-    else {
-        closed_x = -m_size.x; // Off-screen left
-        open_x = 0.0f;        // On-screen left
-    }
-
-    const f32 new_x{m_is_open ? gouda::math::lerp(closed_x, open_x, delta_time)
-                              : gouda::math::lerp(open_x, closed_x, delta_time)};
-
-    m_instance_data.position.x = new_x;
-    m_title_position.x = m_instance_data.position.x + m_padding.x;
-}
@@ -0,0 +1,225 @@
+/**
+ * @file ui/ui_batcher.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Application immediate mode ui batcher module implementation
+ */
+#include "ui/ui_batcher.hpp"
+
+#include <algorithm>
+#include <span>
+
+#include "renderers/vulkan/vk_renderer.hpp"
+#include "utils/hash.hpp"
+
+// Fields are hashed one by one, the structs have padding bytes nothing initializes
+template <typename T>
+static u64 HashValue(const T &value, const u64 seed)
+{
+    return gouda::utils::fnv1a(std::as_bytes(std::span{&value, 1}), seed);
+}
+
+static u64 HashQuad(const gouda::InstanceData &quad, u64 seed)
+{
+    seed = HashValue(quad.position, seed);
+    seed = HashValue(quad.size, seed);
+    seed = HashValue(quad.rotation, seed);
+    seed = HashValue(quad.texture_index, seed);
+    seed = HashValue(quad.colour, seed);
+    seed = HashValue(quad.sprite_rect, seed);
+    seed = HashValue(quad.is_atlas, seed);
+    seed = HashValue(quad.apply_camera_effects, seed);
+    seed = HashValue(quad.shape, seed);
+    seed = HashValue(quad.corner_radius, seed);
+    seed = HashValue(quad.stroke_width, seed);
+    return HashValue(quad.blend_mode, seed);
+}
+
+static bool IsInside(const gouda::math::AABB2D &inner, const gouda::math::AABB2D &outer)
+{
+    return inner.min.x >= outer.min.x && inner.min.y >= outer.min.y && inner.max.x <= outer.max.x &&
+           inner.max.y <= outer.max.y;
+}
+
+UIBatcher::UIBatcher()
+    : m_cursor{0},
+      m_quad_cursor{0},
+      m_rebuilding_widget_count{0},
+      m_rebuilt_widget_count{0}
+{
+}
+
+void UIBatcher::PushClipRect(const gouda::math::AABB2D &rect)
+{
+    if (m_clip_rects.empty()) {
+        m_clip_rects.push_back(rect);
+        return;
+    }
+
+    // An empty intersection is kept inverted, nothing is inside it
+    const gouda::math::AABB2D &outer{m_clip_rects.back()};
+    m_clip_rects.push_back({{gouda::math::max(rect.min.x, outer.min.x), gouda::math::max(rect.min.y, outer.min.y)},
+                            {gouda::math::min(rect.max.x, outer.max.x), gouda::math::min(rect.max.y, outer.max.y)}});
+}
+
+void UIBatcher::PopClipRect()
+{
+    if (!m_clip_rects.empty()) {
+        m_clip_rects.pop_back();
+    }
+}
+
+void UIBatcher::AddQuad(const u64 id, const gouda::InstanceData &quad)
+{
+    u64 input_hash{HashQuad(quad, gouda::utils::FNV1A_OFFSET_BASIS)};
+    if (!m_clip_rects.empty()) {
+        input_hash = HashValue(m_clip_rects.back(), input_hash);
+    }
+    if (!BeginWidget(id, input_hash)) {
+        return;
+    }
+
+    const gouda::math::AABB2D bounds{{quad.position.x, quad.position.y},
+                                     {quad.position.x + quad.size.x, quad.position.y + quad.size.y}};
+    if (m_clip_rects.empty() || IsInside(bounds, m_clip_rects.back())) {
+        m_widget_quads.push_back(quad);
+    }
+    else if (const gouda::math::AABB2D &clip{m_clip_rects.back()}; bounds.Intersects(clip)) {
+        const gouda::math::AABB2D clipped{
+            {gouda::math::max(bounds.min.x, clip.min.x), gouda::math::max(bounds.min.y, clip.min.y)},
+            {gouda::math::min(bounds.max.x, clip.max.x), gouda::math::min(bounds.max.y, clip.max.y)}};
+
+        gouda::InstanceData &clipped_quad{m_widget_quads.emplace_back(quad)};
+        clipped_quad.position.x = clipped.min.x;
+        clipped_quad.position.y = clipped.min.y;
+        clipped_quad.size = {clipped.max.x - clipped.min.x, clipped.max.y - clipped.min.y};
+
+        // The sprite rect spans the quad, it is cut at the same fractions
+        if (quad.is_atlas != 0 && quad.size.x > 0.0f && quad.size.y > 0.0f) {
+            const UVRect<f32> &uv{quad.sprite_rect};
+            const auto u_at{[&](const f32 x) {
+                return gouda::math::lerp(uv.u_min, uv.u_max, (x - bounds.min.x) / quad.size.x);
+            }};
+            const auto v_at{[&](const f32 y) {
+                return gouda::math::lerp(uv.v_min, uv.v_max, (y - bounds.min.y) / quad.size.y);
+            }};
+            clipped_quad.sprite_rect = UVRect<f32>{u_at(clipped.min.x), v_at(clipped.min.y), u_at(clipped.max.x),
+                                                   v_at(clipped.max.y)};
+        }
+    }
+
+    EndWidget();
+}
+
+void UIBatcher::AddText(const u64 id, gouda::vk::Renderer &renderer, StringView text, const gouda::Vec3 &position,
+                        const gouda::Colour<f32> &colour, const f32 scale, const u32 font_id,
+                        const gouda::TextAlign alignment)
+{
+    u64 input_hash{gouda::utils::fnv1a(text)};
+    input_hash = HashValue(position, input_hash);
+    input_hash = HashValue(colour, input_hash);
+    input_hash = HashValue(scale, input_hash);
+    input_hash = HashValue(font_id, input_hash);
+    input_hash = HashValue(alignment, input_hash);
+    if (!m_clip_rects.empty()) {
+        input_hash = HashValue(m_clip_rects.back(), input_hash);
+    }
+    if (!BeginWidget(id, input_hash)) {
+        return;
+    }
+
+    renderer.DrawText(text, position, colour, scale, font_id, m_widget_quads, alignment, false);
+    if (!m_clip_rects.empty()) {
+        const gouda::math::AABB2D &clip{m_clip_rects.back()};
+        std::erase_if(m_widget_quads, [&clip](const gouda::InstanceData &glyph) {
+            const gouda::math::AABB2D bounds{{glyph.position.x, glyph.position.y},
+                                             {glyph.position.x + glyph.size.x, glyph.position.y + glyph.size.y}};
+            return !IsInside(bounds, clip);
+        });
+    }
+
+    EndWidget();
+}
+
+void UIBatcher::Flush(std::vector<gouda::InstanceData> &quad_instances)
+{
+    EraseWidgets(m_cursor, m_widgets.size());
+
+    quad_instances.insert(quad_instances.end(), m_quads.begin(), m_quads.end());
+
+    m_cursor = 0;
+    m_quad_cursor = 0;
+    m_rebuilt_widget_count = m_rebuilding_widget_count;
+    m_rebuilding_widget_count = 0;
+    m_clip_rects.clear(); // Unbalanced pushes do not leak into the next frame
+}
+
+void UIBatcher::Clear()
+{
+    m_widgets.clear();
+    m_quads.clear();
+    m_cursor = 0;
+    m_quad_cursor = 0;
+}
+
+bool UIBatcher::BeginWidget(const u64 id, const u64 input_hash)
+{
+    // The widgets skipped over were not drawn this frame, a widget that is not found is new
+    if (m_cursor < m_widgets.size() && m_widgets[m_cursor].id != id) {
+        const auto found{std::find_if(m_widgets.begin() + static_cast<std::ptrdiff_t>(m_cursor + 1), m_widgets.end(),
+                                      [id](const Widget &widget) { return widget.id == id; })};
+        if (found != m_widgets.end()) {
+            EraseWidgets(m_cursor, static_cast<size_t>(found - m_widgets.begin()));
+        }
+        else {
+            m_widgets.insert(m_widgets.begin() + static_cast<std::ptrdiff_t>(m_cursor), Widget{id, 0, 0});
+        }
+    }
+    else if (m_cursor == m_widgets.size()) {
+        m_widgets.push_back(Widget{id, 0, 0});
+    }
+
+    Widget &widget{m_widgets[m_cursor]};
+    if (widget.input_hash == input_hash && input_hash != 0) {
+        m_quad_cursor += widget.quad_count;
+        ++m_cursor;
+        return false;
+    }
+
+    widget.input_hash = input_hash;
+    m_widget_quads.clear();
+    return true;
+}
+
+void UIBatcher::EndWidget()
+{
+    Widget &widget{m_widgets[m_cursor]};
+
+    // Same sized widgets are overwritten in place, the rest of the range only moves when a widget grows or shrinks
+    const auto begin{m_quads.begin() + static_cast<std::ptrdiff_t>(m_quad_cursor)};
+    if (widget.quad_count == m_widget_quads.size()) {
+        std::ranges::copy(m_widget_quads, begin);
+    }
+    else {
+        m_quads.insert(m_quads.erase(begin, begin + widget.quad_count), m_widget_quads.begin(), m_widget_quads.end());
+    }
+
+    widget.quad_count = static_cast<u32>(m_widget_quads.size());
+    m_quad_cursor += widget.quad_count;
+    ++m_cursor;
+    ++m_rebuilding_widget_count;
+}
+
+void UIBatcher::EraseWidgets(const size_t first, const size_t last)
+{
+    // Only ever called with first at the cursor, the quads of the widgets from there start at the quad cursor
+    size_t quad_count{0};
+    for (size_t i = first; i < last; ++i) {
+        quad_count += m_widgets[i].quad_count;
+    }
+
+    const auto quads{m_quads.begin() + static_cast<std::ptrdiff_t>(m_quad_cursor)};
+    m_quads.erase(quads, quads + static_cast<std::ptrdiff_t>(quad_count));
+    m_widgets.erase(m_widgets.begin() + static_cast<std::ptrdiff_t>(first),
+                    m_widgets.begin() + static_cast<std::ptrdiff_t>(last));
+}
@@ -16,11 +16,10 @@ void UIManager::Update(const f32 delta_time)
         element->Update(delta_time);
     }
 }
-void UIManager::Draw(gouda::vk::Renderer &renderer, std::vector<gouda::InstanceData> &quad_instances,
-                     std::vector<gouda::TextData> &text_instances)
+void UIManager::Draw(gouda::vk::Renderer &renderer, std::vector<gouda::InstanceData> &quad_instances)
 {
     for (const auto &element : m_elements) {
-     element->Draw(quad_instances, text_instances);
+     element->Draw(quad_instances);
     }
 }
 
@@ -0,0 +1,78 @@
+/**
+ * @file asset_packer.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Packs asset directories into an archive the application mounts at startup
+ *
+ * Usage: gouda_asset_packer <output.gpak> <root> <directory>... [--lz4]
+ *
+ * Every regular file under root/directory is packed under its path relative to root, so running it from the build
+ * directory with "assets" packs "assets/textures/sprite_sheet.png" as exactly the path the loaders ask for.
+ */
+#include <algorithm>
+#include <print>
+#include <system_error>
+
+#include "containers/small_vector.hpp"
+#include "core/types.hpp"
+#include "utils/asset_archive.hpp"
+
+namespace internal {
+
+static bool collect_sources(const FilePath &root, const FilePath &directory,
+                            gouda::Vector<gouda::fs::ArchiveSource> &sources)
+{
+    std::error_code error;
+    std::filesystem::recursive_directory_iterator iterator{root / directory, error};
+    if (error) {
+        std::println(stderr, "Cannot read '{}': {}", (root / directory).string(), error.message());
+        return false;
+    }
+
+    for (const std::filesystem::directory_entry &entry : iterator) {
+        if (entry.is_regular_file()) {
+            sources.push_back({entry.path().lexically_relative(root).generic_string(), entry.path()});
+        }
+    }
+    return true;
+}
+
+} // namespace internal
+
+int main(const int argc, char **argv)
+{
+    bool compress{false};
+    gouda::Vector<StringView> arguments;
+    for (int i = 1; i < argc; ++i) {
+        const StringView argument{argv[i]};
+        if (argument == "--lz4") {
+            compress = true;
+        }
+        else {
+            arguments.push_back(argument);
+        }
+    }
+
+    if (arguments.size() < 3) {
+        std::println(stderr, "Usage: gouda_asset_packer <output.gpak> <root> <directory>... [--lz4]");
+        return 1;
+    }
+
+    const FilePath root{arguments[1]};
+    gouda::Vector<gouda::fs::ArchiveSource> sources;
+    for (size_t i = 2; i < arguments.size(); ++i) {
+        if (!internal::collect_sources(root, FilePath{arguments[i]}, sources)) {
+            return 1;
+        }
+    }
+
+    // Directory iteration order is unspecified, sorting keeps the archive the same from one build to the next
+    std::ranges::sort(sources, {}, &gouda::fs::ArchiveSource::path);
+
+    if (const auto result{gouda::fs::AssetArchive::Write(arguments[0], sources, compress)}; !result) {
+        std::println(stderr, "Cannot write '{}': {}", arguments[0], gouda::fs::error_to_string(result.error()));
+        return 1;
+    }
+
+    std::println("Packed {} files into '{}'", sources.size(), arguments[0]);
+}
@@ -0,0 +1,32 @@
+/**
+ * @file trace_converter.cpp
+ * @author GoudaCheeseburgers
+ * @date 2026-10-14
+ * @brief Converts binary profiler traces to Chrome trace JSON
+ *
+ * Usage: gouda_trace_converter <input.gtrace> [output.json]
+ *
+ * The output defaults to the input with a .json extension, open it in Perfetto or chrome://tracing.
+ */
+#include <print>
+
+#include "core/types.hpp"
+#include "debug/trace_file.hpp"
+
+int main(const int argc, char **argv)
+{
+    if (argc < 2 || argc > 3) {
+        std::println(stderr, "Usage: gouda_trace_converter <input.gtrace> [output.json]");
+        return 1;
+    }
+
+    const StringView input{argv[1]};
+    const String output{argc == 3 ? String{argv[2]} : FilePath{input}.replace_extension(".json").string()};
+    if (const auto result{gouda::internal::profiler::ConvertTraceToJson(input, output)}; !result) {
+        std::println(stderr, "Cannot convert '{}' to '{}': {}", input, output,
+                     gouda::fs::error_to_string(result.error()));
+        return 1;
+    }
+
+    std::println("Converted '{}' to '{}'", input, output);
+}